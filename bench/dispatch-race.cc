@@ -0,0 +1,96 @@
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <cpuinfo.h>
+
+
+/* Candidate implementations of a dot product: the race picks the fastest one on every microarchitecture */
+
+static float dot_scalar(const float* a, const float* b, size_t n) {
+	float sum = 0.0f;
+	for (size_t i = 0; i < n; i++) {
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+static float dot_unrolled2(const float* a, const float* b, size_t n) {
+	float sum0 = 0.0f, sum1 = 0.0f;
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		sum0 += a[i] * b[i];
+		sum1 += a[i + 1] * b[i + 1];
+	}
+	for (; i < n; i++) {
+		sum0 += a[i] * b[i];
+	}
+	return sum0 + sum1;
+}
+
+static float dot_unrolled8(const float* a, const float* b, size_t n) {
+	float sums[8] = { 0.0f };
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		for (size_t j = 0; j < 8; j++) {
+			sums[j] += a[i + j] * b[i + j];
+		}
+	}
+	for (; i < n; i++) {
+		sums[0] += a[i] * b[i];
+	}
+	return ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+}
+
+typedef float (*dot_function)(const float*, const float*, size_t);
+
+struct dot_workload {
+	std::vector<float> a;
+	std::vector<float> b;
+	volatile float result;
+};
+
+static void run_dot(cpuinfo_dispatch_function implementation, void* context) {
+	dot_workload* workload = static_cast<dot_workload*>(context);
+	workload->result = ((dot_function) implementation)(workload->a.data(), workload->b.data(), workload->a.size());
+}
+
+int main(int argc, char** argv) {
+	if (!cpuinfo_initialize()) {
+		fprintf(stderr, "failed to initialize CPU information\n");
+		exit(EXIT_FAILURE);
+	}
+
+	static const char* names[] = { "scalar", "unrolled x2", "unrolled x8" };
+	cpuinfo_dispatch_table table = {};
+	cpuinfo_dispatch_table_add(&table, (cpuinfo_dispatch_function) dot_scalar, nullptr, cpuinfo_uarch_unknown);
+	cpuinfo_dispatch_table_add(&table, (cpuinfo_dispatch_function) dot_unrolled2, nullptr, cpuinfo_uarch_unknown);
+	cpuinfo_dispatch_table_add(&table, (cpuinfo_dispatch_function) dot_unrolled8, nullptr, cpuinfo_uarch_unknown);
+
+	/* 16 KB of inputs fit in L1 data cache on all microarchitectures */
+	dot_workload workload;
+	workload.a.assign(2048, 1.0f);
+	workload.b.assign(2048, 0.5f);
+	cpuinfo_dispatch_race_result results[CPUINFO_DISPATCH_MAX_UARCHS];
+	/* Results are not recorded in the tuning cache: the bench must measure on every run */
+	if (!cpuinfo_dispatch_table_race(&table, nullptr, run_dot, &workload, 101, results)) {
+		fprintf(stderr, "failed to benchmark all microarchitectures\n");
+	}
+
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count() && i < CPUINFO_DISPATCH_MAX_UARCHS; i++) {
+		const cpuinfo_dispatch_race_result& result = results[i];
+		if (result.winner == UINT32_MAX) {
+			printf("uarch %" PRIu32 ": not benchmarked\n", i);
+			continue;
+		}
+		printf("uarch %" PRIu32 " (processor %" PRIu32 "): winner %s\n",
+			i, result.processor_index, names[result.winner]);
+		for (uint32_t j = 0; j < table.candidates_count; j++) {
+			printf("\t%-12s median %8" PRIu64 " ns, p90 %8" PRIu64 " ns\n",
+				names[j], result.median_ns[j], result.tail_ns[j]);
+		}
+	}
+	return 0;
+}
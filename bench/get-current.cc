@@ -2,6 +2,24 @@
 
 #include <cpuinfo.h>
 
+#ifdef __linux__
+	#include <stddef.h>
+	#include <dlfcn.h>
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+
+	/* Exported by glibc 2.35+ */
+	extern "C" const ptrdiff_t __rseq_offset __attribute__((__weak__));
+	extern "C" const unsigned int __rseq_size __attribute__((__weak__));
+
+	#if defined(__has_builtin)
+		#if __has_builtin(__builtin_thread_pointer)
+			#define HAVE_BUILTIN_THREAD_POINTER 1
+		#endif
+	#endif
+#endif
+
 
 static void cpuinfo_get_current_processor(benchmark::State& state) {
 	cpuinfo_initialize();
@@ -39,4 +57,114 @@ static void cpuinfo_get_current_uarch_index_with_default(benchmark::State& state
 }
 BENCHMARK(cpuinfo_get_current_uarch_index_with_default)->Unit(benchmark::kNanosecond);
 
+static void cpuinfo_get_current_location(benchmark::State& state) {
+	cpuinfo_initialize();
+	while (state.KeepRunning()) {
+		struct cpuinfo_location location;
+		cpuinfo_get_current_location(&location);
+		benchmark::DoNotOptimize(location);
+	}
+}
+BENCHMARK(cpuinfo_get_current_location)->Unit(benchmark::kNanosecond);
+
+static void cpuinfo_get_current_slot(benchmark::State& state) {
+	cpuinfo_initialize();
+	while (state.KeepRunning()) {
+		const uint32_t slot = cpuinfo_get_current_slot();
+		benchmark::DoNotOptimize(slot);
+	}
+}
+BENCHMARK(cpuinfo_get_current_slot)->Unit(benchmark::kNanosecond);
+
+#ifdef __linux__
+static void getcpu_syscall(benchmark::State& state) {
+	while (state.KeepRunning()) {
+		unsigned cpu = 0;
+		syscall(__NR_getcpu, &cpu, NULL, NULL);
+		benchmark::DoNotOptimize(cpu);
+	}
+}
+BENCHMARK(getcpu_syscall)->Unit(benchmark::kNanosecond);
+
+static void getcpu_vdso(benchmark::State& state) {
+	void* vdso = dlopen("linux-vdso.so.1", RTLD_LAZY | RTLD_LOCAL | RTLD_NOLOAD);
+	void* function = NULL;
+	if (vdso != NULL) {
+		function = dlsym(vdso, "__vdso_getcpu");
+		if (function == NULL) {
+			function = dlsym(vdso, "__kernel_getcpu");
+		}
+	}
+	if (function == NULL) {
+		state.SkipWithError("vDSO does not implement getcpu");
+		return;
+	}
+
+	typedef int (*getcpu_function)(unsigned*, unsigned*, void*);
+	const getcpu_function getcpu = (getcpu_function) function;
+	while (state.KeepRunning()) {
+		unsigned cpu = 0;
+		getcpu(&cpu, NULL, NULL);
+		benchmark::DoNotOptimize(cpu);
+	}
+}
+BENCHMARK(getcpu_vdso)->Unit(benchmark::kNanosecond);
+
+#if defined(HAVE_BUILTIN_THREAD_POINTER)
+static void getcpu_rseq(benchmark::State& state) {
+	if (&__rseq_size == NULL || __rseq_size < 8) {
+		state.SkipWithError("rseq is not registered");
+		return;
+	}
+
+	const volatile int* cpu_id = (const volatile int*) ((const char*) __builtin_thread_pointer() + __rseq_offset + 4);
+	while (state.KeepRunning()) {
+		const int cpu = *cpu_id;
+		benchmark::DoNotOptimize(cpu);
+	}
+}
+BENCHMARK(getcpu_rseq)->Unit(benchmark::kNanosecond);
+#endif
+
+static void sched_getcpu_libc(benchmark::State& state) {
+	while (state.KeepRunning()) {
+		const int cpu = sched_getcpu();
+		benchmark::DoNotOptimize(cpu);
+	}
+}
+BENCHMARK(sched_getcpu_libc)->Unit(benchmark::kNanosecond);
+#endif
+
+#if (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && (defined(__GNUC__) || defined(__clang__))
+static void rdpid(benchmark::State& state) {
+	cpuinfo_initialize();
+	if (!cpuinfo_has_x86_rdpid()) {
+		state.SkipWithError("RDPID is not supported");
+		return;
+	}
+
+	while (state.KeepRunning()) {
+		unsigned long tsc_aux;
+		__asm__ __volatile__(".byte 0xF3, 0x0F, 0xC7, 0xF8" : "=a" (tsc_aux));
+		benchmark::DoNotOptimize(tsc_aux);
+	}
+}
+BENCHMARK(rdpid)->Unit(benchmark::kNanosecond);
+
+static void rdtscp(benchmark::State& state) {
+	cpuinfo_initialize();
+	if (!cpuinfo_has_x86_rdtscp()) {
+		state.SkipWithError("RDTSCP is not supported");
+		return;
+	}
+
+	while (state.KeepRunning()) {
+		unsigned int tsc_low, tsc_high, tsc_aux;
+		__asm__ __volatile__("rdtscp" : "=a" (tsc_low), "=d" (tsc_high), "=c" (tsc_aux));
+		benchmark::DoNotOptimize(tsc_aux);
+	}
+}
+BENCHMARK(rdtscp)->Unit(benchmark::kNanosecond);
+#endif
+
 BENCHMARK_MAIN();
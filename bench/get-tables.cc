@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <cpuinfo.h>
+
+
+/*
+ * Getters are called from 1..N threads, spread round-robin across clusters. Every thread migrates to a processor in
+ * the next cluster after a batch of calls, so that the measured calls include those right after a migration, when
+ * globals in the library and the thread-local state of the caller are no longer in the caches of the processor.
+ */
+static const uint32_t calls_per_migration = 1024;
+
+static const cpuinfo_processor* thread_processor(uint32_t thread_index, uint32_t migration) {
+	const uint32_t clusters_count = cpuinfo_get_clusters_count();
+	const cpuinfo_cluster* cluster = cpuinfo_get_cluster((thread_index + migration) % clusters_count);
+	return cpuinfo_get_processor(cluster->processor_start + (thread_index / clusters_count) % cluster->processor_count);
+}
+
+template <class Getter>
+static void run_getter(benchmark::State& state, Getter getter) {
+	const uint32_t thread_index = (uint32_t) state.thread_index();
+	uint32_t migration = 0;
+	cpuinfo_pin_current_thread_to_processor(thread_processor(thread_index, migration));
+	uint32_t calls = 0;
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(getter());
+		if (++calls == calls_per_migration) {
+			state.PauseTiming();
+			cpuinfo_pin_current_thread_to_processor(thread_processor(thread_index, ++migration));
+			calls = 0;
+			state.ResumeTiming();
+		}
+	}
+}
+
+template <class Getter>
+static void register_getter(const char* name, Getter getter) {
+	benchmark::RegisterBenchmark(name, run_getter<Getter>, getter)
+		->ThreadRange(1, (int) cpuinfo_get_processors_count())
+		->UseRealTime()
+		->Unit(benchmark::kNanosecond);
+}
+
+#define REGISTER_GETTER(call) register_getter(#call, []() { return call; })
+
+int main(int argc, char** argv) {
+	if (!cpuinfo_initialize()) {
+		fprintf(stderr, "failed to initialize CPU information\n");
+		exit(EXIT_FAILURE);
+	}
+
+	REGISTER_GETTER(cpuinfo_get_processors());
+	REGISTER_GETTER(cpuinfo_get_cores());
+	REGISTER_GETTER(cpuinfo_get_clusters());
+	REGISTER_GETTER(cpuinfo_get_packages());
+	REGISTER_GETTER(cpuinfo_get_uarchs());
+	REGISTER_GETTER(cpuinfo_get_l1i_caches());
+	REGISTER_GETTER(cpuinfo_get_l1d_caches());
+	REGISTER_GETTER(cpuinfo_get_l2_caches());
+	REGISTER_GETTER(cpuinfo_get_l3_caches());
+	REGISTER_GETTER(cpuinfo_get_l4_caches());
+	REGISTER_GETTER(cpuinfo_get_processor(0));
+	REGISTER_GETTER(cpuinfo_get_core(0));
+	REGISTER_GETTER(cpuinfo_get_cluster(0));
+	REGISTER_GETTER(cpuinfo_get_package(0));
+	REGISTER_GETTER(cpuinfo_get_uarch(0));
+	REGISTER_GETTER(cpuinfo_get_l1i_cache(0));
+	REGISTER_GETTER(cpuinfo_get_l1d_cache(0));
+	REGISTER_GETTER(cpuinfo_get_l2_cache(0));
+	REGISTER_GETTER(cpuinfo_get_l3_cache(0));
+	REGISTER_GETTER(cpuinfo_get_l4_cache(0));
+	REGISTER_GETTER(cpuinfo_get_processors_count());
+	REGISTER_GETTER(cpuinfo_get_cores_count());
+	REGISTER_GETTER(cpuinfo_get_clusters_count());
+	REGISTER_GETTER(cpuinfo_get_packages_count());
+	REGISTER_GETTER(cpuinfo_get_uarchs_count());
+	REGISTER_GETTER(cpuinfo_get_l1i_caches_count());
+	REGISTER_GETTER(cpuinfo_get_l1d_caches_count());
+	REGISTER_GETTER(cpuinfo_get_l2_caches_count());
+	REGISTER_GETTER(cpuinfo_get_l3_caches_count());
+	REGISTER_GETTER(cpuinfo_get_l4_caches_count());
+	REGISTER_GETTER(cpuinfo_get_max_cache_size());
+	REGISTER_GETTER(cpuinfo_get_llc_domain(0));
+	REGISTER_GETTER(cpuinfo_get_numa_node(0));
+	REGISTER_GETTER(cpuinfo_get_usable_processor(0));
+	REGISTER_GETTER(cpuinfo_get_current_processor());
+	REGISTER_GETTER(cpuinfo_get_current_core());
+	REGISTER_GETTER(cpuinfo_get_current_uarch_index());
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	REGISTER_GETTER(cpuinfo_has_x86_sse2());
+	REGISTER_GETTER(cpuinfo_has_x86_avx2());
+	REGISTER_GETTER(cpuinfo_has_x86_fma3());
+	REGISTER_GETTER(cpuinfo_has_x86_avx512f());
+	REGISTER_GETTER(cpuinfo_has_x86_avx512vnni());
+#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+	REGISTER_GETTER(cpuinfo_has_arm_neon());
+	REGISTER_GETTER(cpuinfo_has_arm_neon_fp16_arith());
+	REGISTER_GETTER(cpuinfo_has_arm_neon_dot());
+	REGISTER_GETTER(cpuinfo_has_arm_i8mm());
+	REGISTER_GETTER(cpuinfo_has_arm_sve());
+#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+	REGISTER_GETTER(cpuinfo_has_riscv_v());
+#endif
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	cpuinfo_deinitialize();
+}
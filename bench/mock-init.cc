@@ -0,0 +1,264 @@
+#include <benchmark/benchmark.h>
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <deque>
+#include <vector>
+
+#include <cpuinfo.h>
+#include <cpuinfo-mock.h>
+
+#include <mock-init.h>
+
+
+/*
+ * Allocation counters, incremented by wrappers of the allocation functions.
+ * The benchmark is linked with -Wl,--wrap for malloc, calloc, realloc, and posix_memalign.
+ */
+static size_t allocations = 0;
+static size_t allocated_bytes = 0;
+
+extern "C" {
+	void* __real_malloc(size_t size);
+	void* __real_calloc(size_t count, size_t size);
+	void* __real_realloc(void* pointer, size_t size);
+	int __real_posix_memalign(void** pointer, size_t alignment, size_t size);
+
+	void* __wrap_malloc(size_t size) {
+		allocations += 1;
+		allocated_bytes += size;
+		return __real_malloc(size);
+	}
+
+	void* __wrap_calloc(size_t count, size_t size) {
+		allocations += 1;
+		allocated_bytes += count * size;
+		return __real_calloc(count, size);
+	}
+
+	void* __wrap_realloc(void* pointer, size_t size) {
+		allocations += 1;
+		allocated_bytes += size;
+		return __real_realloc(pointer, size);
+	}
+
+	int __wrap_posix_memalign(void** pointer, size_t alignment, size_t size) {
+		allocations += 1;
+		allocated_bytes += size;
+		return __real_posix_memalign(pointer, alignment, size);
+	}
+}
+
+/*
+ * Recorded budget of file accesses in one initialization on a mock device, or zeros if it wasn't recorded.
+ * Initialization cost is dominated by file accesses, so a parsing change which adds per-processor reads must raise
+ * the budget explicitly.
+ */
+struct file_budget {
+	uint32_t opens;
+	uint32_t reads;
+	uint64_t read_bytes;
+};
+
+/* Set when any device exceeds its budget, and makes the benchmark fail */
+static bool budget_exceeded = false;
+
+/* Recorded mock device with the setup from its test, or a synthetic system */
+struct mock_device {
+	const char* name;
+	void (*setup)();
+	const struct cpuinfo_mock_system* system;
+	struct file_budget budget;
+};
+
+/* Full initialization and deinitialization of cpuinfo on the mock filesystem of the device */
+static void mock_initialize(benchmark::State& state, const struct mock_device* device) {
+	if (device->setup != NULL) {
+		device->setup();
+	} else {
+		cpuinfo_mock_filesystem(device->system->files);
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		cpuinfo_mock_set_cpuid(device->system->cpuid_dump, device->system->cpuid_entries);
+	#endif
+	}
+
+	const size_t initial_allocations = allocations;
+	const size_t initial_allocated_bytes = allocated_bytes;
+	while (state.KeepRunning()) {
+		if (!cpuinfo_initialize()) {
+			state.SkipWithError("cpuinfo initialization failed");
+			break;
+		}
+		cpuinfo_deinitialize();
+	}
+	state.counters["allocations"] = benchmark::Counter(
+		(double) (allocations - initial_allocations), benchmark::Counter::kAvgIterations);
+	state.counters["allocated_bytes"] = benchmark::Counter(
+		(double) (allocated_bytes - initial_allocated_bytes), benchmark::Counter::kAvgIterations);
+
+	struct cpuinfo_mock_file_stats file_stats;
+	cpuinfo_mock_get_file_stats(&file_stats);
+	const uint64_t iterations = state.iterations() != 0 ? (uint64_t) state.iterations() : 1;
+	const struct file_budget usage = {
+		.opens = (uint32_t) (file_stats.opens / iterations),
+		.reads = (uint32_t) (file_stats.reads / iterations),
+		.read_bytes = file_stats.read_bytes / iterations,
+	};
+	state.counters["opens"] = benchmark::Counter((double) usage.opens);
+	state.counters["reads"] = benchmark::Counter((double) usage.reads);
+	state.counters["read_bytes"] = benchmark::Counter((double) usage.read_bytes);
+	const struct file_budget& budget = device->budget;
+	if (budget.opens != 0 &&
+		(usage.opens > budget.opens || usage.reads > budget.reads || usage.read_bytes > budget.read_bytes))
+	{
+		budget_exceeded = true;
+		state.SkipWithError("file accesses exceed the recorded budget");
+	}
+}
+
+/*
+ * Recorded mock devices, registered by the sources which CMake generates from the mock tests.
+ * The registry is constructed on first use because registration runs during static initialization.
+ */
+static std::vector<struct mock_device>& mock_devices() {
+	static std::vector<struct mock_device> devices;
+	return devices;
+}
+
+bool register_mock_device(const char* name, void (*setup)()) {
+	struct mock_device device = { };
+	device.name = name;
+	device.setup = setup;
+	mock_devices().push_back(device);
+	return true;
+}
+
+/* Budgets of file accesses recorded for mock devices; devices without a recorded budget are not checked */
+static const struct {
+	const char* name;
+	struct file_budget budget;
+} mock_device_budgets[] = {
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	{ "alldocube-iwork8", { .opens = 162, .reads = 123, .read_bytes = 400 } },
+	{ "leagoo-t5c", { .opens = 134, .reads = 77, .read_bytes = 270 } },
+	{ "memo-pad-7", { .opens = 162, .reads = 125, .read_bytes = 408 } },
+	{ "zenfone-c", { .opens = 159, .reads = 121, .read_bytes = 622 } },
+	{ "zenfone-2", { .opens = 162, .reads = 125, .read_bytes = 388 } },
+	{ "zenfone-2e", { .opens = 124, .reads = 91, .read_bytes = 286 } },
+#endif
+	{ NULL, { } },
+};
+
+/*
+ * Synthetic systems, used to check that initialization time scales linearly with the number of processors, and to
+ * cover topologies without a recorded device: multi-socket servers with sub-NUMA clusters, hybrid x86 processors,
+ * and tri-cluster ARM SoCs.
+ */
+struct synthetic_device {
+	const char* name;
+	struct cpuinfo_mock_topology topology;
+	struct file_budget budget;
+};
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+static const struct synthetic_device synthetic_devices[] = {
+	{
+		.name = "synthetic-1024",
+		.topology = { .packages = 8, .nodes_per_package = 1, .clusters_count = 1, .clusters = {
+			{ .cores = 64, .threads_per_core = 2, .max_frequency = 3500000 },
+		} },
+		.budget = { .opens = 9879, .reads = 6759, .read_bytes = 28691 },
+	},
+	{
+		.name = "synthetic-4096",
+		.topology = { .packages = 8, .nodes_per_package = 1, .clusters_count = 1, .clusters = {
+			{ .cores = 256, .threads_per_core = 2, .max_frequency = 3500000 },
+		} },
+		.budget = { .opens = 39063, .reads = 26727, .read_bytes = 120353 },
+	},
+	{
+		.name = "synthetic-snc4",
+		.topology = { .packages = 2, .nodes_per_package = 4, .clusters_count = 1, .clusters = {
+			{ .cores = 56, .threads_per_core = 2, .max_frequency = 3800000 },
+		} },
+		.budget = { .opens = 2213, .reads = 1511, .read_bytes = 6380 },
+	},
+	{
+		.name = "synthetic-hybrid",
+		.topology = { .packages = 1, .nodes_per_package = 1, .clusters_count = 2, .clusters = {
+			{ .cores = 8, .threads_per_core = 2, .max_frequency = 5200000 },
+			{ .cores = 16, .threads_per_core = 1, .max_frequency = 3900000, .efficiency = true },
+		} },
+		.budget = { .opens = 387, .reads = 254, .read_bytes = 1060 },
+	},
+};
+#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+static const struct synthetic_device synthetic_devices[] = {
+	{
+		.name = "synthetic-1024",
+		.topology = { .packages = 8, .nodes_per_package = 1, .clusters_count = 1, .clusters = {
+			{ .cores = 128, .threads_per_core = 1, .max_frequency = 3000000, .midr = UINT32_C(0x410FD0C1) },
+		} },
+	},
+	{
+		.name = "synthetic-4096",
+		.topology = { .packages = 8, .nodes_per_package = 1, .clusters_count = 1, .clusters = {
+			{ .cores = 512, .threads_per_core = 1, .max_frequency = 3000000, .midr = UINT32_C(0x410FD0C1) },
+		} },
+	},
+	{
+		.name = "synthetic-nps4",
+		.topology = { .packages = 2, .nodes_per_package = 4, .clusters_count = 1, .clusters = {
+			{ .cores = 64, .threads_per_core = 1, .max_frequency = 3000000, .midr = UINT32_C(0x410FD0C1) },
+		} },
+	},
+	{
+		.name = "synthetic-tri-cluster",
+		.topology = { .packages = 1, .nodes_per_package = 1, .clusters_count = 3, .clusters = {
+			{ .cores = 1, .threads_per_core = 1, .max_frequency = 3000000, .midr = UINT32_C(0x411FD441) },
+			{ .cores = 3, .threads_per_core = 1, .max_frequency = 2400000, .midr = UINT32_C(0x411FD411) },
+			{ .cores = 4, .threads_per_core = 1, .max_frequency = 1800000, .midr = UINT32_C(0x412FD050) },
+		} },
+	},
+};
+#endif
+
+int main(int argc, char* argv[]) {
+	for (struct mock_device& device : mock_devices()) {
+		for (size_t i = 0; mock_device_budgets[i].name != NULL; i++) {
+			if (strcmp(mock_device_budgets[i].name, device.name) == 0) {
+				device.budget = mock_device_budgets[i].budget;
+			}
+		}
+		benchmark::RegisterBenchmark(device.name, mock_initialize, &device)->Unit(benchmark::kMicrosecond);
+	}
+
+	/* Generated devices stay alive until the benchmarks finish */
+	static std::deque<struct cpuinfo_mock_system> synthetic_systems;
+	static std::deque<struct mock_device> synthetic_mock_devices;
+	for (const struct synthetic_device& synthetic : synthetic_devices) {
+		struct cpuinfo_mock_system system;
+		if (!cpuinfo_mock_generate_system(&synthetic.topology, &system)) {
+			fprintf(stderr, "failed to generate synthetic device %s\n", synthetic.name);
+			return EXIT_FAILURE;
+		}
+		synthetic_systems.push_back(system);
+		struct mock_device device = { };
+		device.name = synthetic.name;
+		device.system = &synthetic_systems.back();
+		device.budget = synthetic.budget;
+		synthetic_mock_devices.push_back(device);
+		benchmark::RegisterBenchmark(synthetic.name, mock_initialize, &synthetic_mock_devices.back())
+			->Unit(benchmark::kMillisecond);
+	}
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	for (struct cpuinfo_mock_system& system : synthetic_systems) {
+		cpuinfo_mock_release_system(&system);
+	}
+	return budget_exceeded ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/*
+ * Registers a recorded mock device for the initialization benchmark. The setup function installs the mock filesystem,
+ * Android properties, hwcaps, or CPUID dump of the device; it is called before each benchmark run on the device.
+ * Sources which register devices are generated by CMake from the mock tests in test/mock.
+ */
+bool register_mock_device(const char* name, void (*setup)());
@@ -23,12 +23,13 @@ def main(args):
     build.export_cpath("include", ["cpuinfo.h"])
 
     with build.options(source_dir="src", macros=macros, extra_include_dirs="src", deps=build.deps.clog):
-        sources = ["api.c", "init.c", "cache.c"]
+        sources = ["affinity.c", "api.c", "arena.c", "blocking.c", "init.c", "cache.c", "capability.c", "columns.c", "costmodel.c", "counters.c", "devices.c", "dispatch.c", "energy.c", "epoch.c", "export.c", "features.c", "frequency.c", "hotplug.c", "hugepages.c", "hypervisor.c", "instructions.c", "latency.c", "lists.c", "mte.c", "numa.c", "percpu.c", "performance.c", "pitfalls.c", "placement.c", "pmu.c", "prefetchers.c", "probe.c", "resctrl.c", "sampler.c", "snapshot.c", "spinwait.c", "stats.c", "threads.c", "throughput.c", "tlb.c", "tsc.c", "tsx.c", "tuning.c", "uarch-table.c", "usable.c", "utilization.c", "vector.c", "vulnerabilities.c", "xstate.c"]
         if build.target.is_x86 or build.target.is_x86_64:
             sources += [
-                "x86/init.c", "x86/info.c", "x86/isa.c", "x86/vendor.c",
+                "x86/init.c", "x86/cpuid.c", "x86/info.c", "x86/isa.c", "x86/vendor.c",
                 "x86/uarch.c", "x86/name.c", "x86/topology.c",
-                "x86/cache/init.c", "x86/cache/descriptor.c", "x86/cache/deterministic.c",
+                "x86/cache/init.c", "x86/cache/descriptor.c", "x86/cache/deterministic.c", "x86/cache/rdt.c",
+                "x86/cache/tlb.c",
             ]
             if build.target.is_macos:
                 sources += ["x86/mach/init.c"]
@@ -38,7 +39,7 @@ def main(args):
                     "x86/linux/cpuinfo.c",
                 ]
         if build.target.is_arm or build.target.is_arm64:
-            sources += ["arm/uarch.c", "arm/cache.c"]
+            sources += ["arm/uarch.c", "arm/cache.c", "arm/tlb.c"]
             if build.target.is_linux or build.target.is_android:
                 sources += [
                     "arm/linux/init.c",
@@ -46,6 +47,7 @@ def main(args):
                     "arm/linux/clusters.c",
                     "arm/linux/midr.c",
                     "arm/linux/chipset.c",
+                    "arm/linux/accelerators.c",
                     "arm/linux/hwcap.c",
                 ]
                 if build.target.is_arm:
@@ -54,6 +56,7 @@ def main(args):
                     sources.append("arm/linux/aarch64-isa.c")
                 if build.target.is_android:
                     sources += [
+                        "arm/android/chipset-cache.c",
                         "arm/android/properties.c",
                     ]
 
@@ -61,19 +64,29 @@ def main(args):
             sources += ["mach/topology.c"]
         if build.target.is_linux or build.target.is_android:
             sources += [
+                "linux/cgroup.c",
                 "linux/cpulist.c",
+                "linux/current.c",
+                "linux/files.c",
                 "linux/smallfile.c",
                 "linux/multiline.c",
                 "linux/processors.c",
+                "linux/sysfs.c",
             ]
             if options.mock:
-                sources += ["linux/mockfile.c"]
+                sources += ["linux/mockfile.c", "linux/mocksynthetic.c"]
         build.static_library("cpuinfo", map(build.cc, sources))
 
     with build.options(source_dir="tools", deps=[build, build.deps.clog]):
         build.executable("cpu-info", build.cc("cpu-info.c"))
         build.executable("isa-info", build.cc("isa-info.c"))
         build.executable("cache-info", build.cc("cache-info.c"))
+        build.executable("memory-info", build.cc("memory-info.c"))
+        build.executable("core-latency", build.cc("core-latency.c"))
+        build.executable("instruction-info", build.cc("instruction-info.c"))
+        build.executable("thread-schedule", build.cc("thread-schedule.c"))
+        build.executable("cpuinfo-advise", build.cc("cpuinfo-advise.c"))
+        build.executable("topology-dump", build.cc("topology-dump.c"))
 
     if build.target.is_x86_64:
         with build.options(source_dir="tools", include_dirs=["src", "include"]):
@@ -93,6 +106,7 @@ def main(args):
     if not options.mock:
         with build.options(source_dir="bench", deps=[build, build.deps.clog, build.deps.googlebenchmark]):
             build.benchmark("init-bench", build.cxx("init.cc"))
+            build.benchmark("get-tables-bench", build.cxx("get-tables.cc"))
             if not build.target.is_macos:
                 build.benchmark("get-current-bench", build.cxx("get-current.cc"))
 
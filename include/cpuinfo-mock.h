@@ -47,6 +47,16 @@ struct cpuinfo_mock_file {
 	size_t offset;
 };
 
+/* Counters of file accesses through the mock filesystem, used to keep the cost of initialization in check */
+struct cpuinfo_mock_file_stats {
+	/* Calls to cpuinfo_mock_open, including those for files missing in the mock filesystem */
+	uint32_t opens;
+	/* Calls to cpuinfo_mock_read */
+	uint32_t reads;
+	/* Bytes returned by cpuinfo_mock_read */
+	uint64_t read_bytes;
+};
+
 struct cpuinfo_mock_property {
 	const char* key;
 	const char* value;
@@ -57,6 +67,57 @@ struct cpuinfo_mock_property {
 	int CPUINFO_ABI cpuinfo_mock_open(const char* path, int oflag);
 	int CPUINFO_ABI cpuinfo_mock_close(int fd);
 	ssize_t CPUINFO_ABI cpuinfo_mock_read(int fd, void* buffer, size_t capacity);
+	/* Counters are reset by cpuinfo_mock_filesystem */
+	void CPUINFO_ABI cpuinfo_mock_get_file_stats(struct cpuinfo_mock_file_stats* stats);
+
+	/* Limits of synthetic systems */
+	#define CPUINFO_MOCK_PACKAGES_MAX 8
+	#define CPUINFO_MOCK_CLUSTERS_MAX 3
+	#define CPUINFO_MOCK_PROCESSORS_MAX 4096
+
+	/* Cores of the same type in every package of a synthetic system */
+	struct cpuinfo_mock_cluster {
+		uint32_t cores;
+		/* 1 to 4 */
+		uint32_t threads_per_core;
+		/* Maximum frequency, in KHz */
+		uint32_t max_frequency;
+		/* Value of Main ID Register of the cores on ARM */
+		uint32_t midr;
+		/* Efficiency (Atom) cores of a hybrid x86 processor */
+		bool efficiency;
+	};
+
+	/* Topology of a synthetic system, with identical packages */
+	struct cpuinfo_mock_topology {
+		uint32_t packages;
+		/* NUMA nodes per package, e.g. sub-NUMA clusters (SNC) on Intel and NPS on AMD, with contiguous cores */
+		uint32_t nodes_per_package;
+		uint32_t clusters_count;
+		struct cpuinfo_mock_cluster clusters[CPUINFO_MOCK_CLUSTERS_MAX];
+	};
+
+	/* Mock filesystem and CPUID dump of a synthetic system, owned by the caller */
+	struct cpuinfo_mock_system {
+		/* Terminated by a file with NULL path, for cpuinfo_mock_filesystem */
+		struct cpuinfo_mock_file* files;
+		uint32_t processors_count;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* CPUID of the first processor, for cpuinfo_mock_set_cpuid */
+		struct cpuinfo_mock_cpuid* cpuid_dump;
+		size_t cpuid_entries;
+	#endif
+	};
+
+	/*
+	 * Generate the sysfs and procfs files of a synthetic system, for scale tests on topologies without a recorded
+	 * device. Logical processors are numbered like Linux on x86 servers: first threads of all cores, then second
+	 * threads. Returns false if the topology exceeds the limits of synthetic systems.
+	 */
+	bool CPUINFO_ABI cpuinfo_mock_generate_system(
+		const struct cpuinfo_mock_topology* topology,
+		struct cpuinfo_mock_system* system);
+	void CPUINFO_ABI cpuinfo_mock_release_system(struct cpuinfo_mock_system* system);
 
 	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
 		void CPUINFO_ABI cpuinfo_set_hwcap(uint32_t hwcap);
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef CPUINFO_THREADPOOL_H
+#define CPUINFO_THREADPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Pool of worker threads placed on logical processors by cpuinfo_plan_workers, built as the separate
+ * cpuinfo_threadpool library on top of the public cpuinfo API.
+ *
+ * Workers of every last-level cache domain share a run queue of chunks. Workers which drain their queue steal chunks
+ * from other queues in the topology order of cpuinfo_get_steal_order, so that chunks move to the nearest idle cores
+ * first. The thread which calls cpuinfo_threadpool_parallel_for works as worker 0, and keeps its affinity.
+ */
+struct cpuinfo_threadpool;
+
+/**
+ * Function which processes items [start, end) of the range of cpuinfo_threadpool_parallel_for.
+ *
+ * @param context - context pointer passed to cpuinfo_threadpool_parallel_for.
+ * @param start - index of the first item of the chunk.
+ * @param end - index after the last item of the chunk.
+ */
+typedef void (*cpuinfo_threadpool_task)(void* context, size_t start, size_t end);
+
+/**
+ * Create a thread pool, and pin its worker threads to the logical processors which cpuinfo_plan_workers chooses for
+ * the placement policy. Initializes cpuinfo if it is not initialized yet.
+ *
+ * Workers which the OS doesn't allow to pin still run unpinned, and work-stealing keeps them busy.
+ *
+ * @param threads_count - number of threads, including the calling thread, or 0 for one thread per logical processor
+ *                        which the policy admits.
+ * @param policy - placement policy, as for cpuinfo_plan_workers.
+ * @returns the thread pool, or NULL if cpuinfo failed to initialize, the policy admits no processors, or threads could
+ *          not be created.
+ */
+struct cpuinfo_threadpool* CPUINFO_ABI cpuinfo_threadpool_create(uint32_t threads_count,
+	enum cpuinfo_worker_policy policy);
+
+/** Stop and join the worker threads, and release the thread pool. NULL is ignored. */
+void CPUINFO_ABI cpuinfo_threadpool_destroy(struct cpuinfo_threadpool* threadpool);
+
+/** Returns the number of threads of the pool, including the thread which calls cpuinfo_threadpool_parallel_for */
+uint32_t CPUINFO_ABI cpuinfo_threadpool_get_threads_count(const struct cpuinfo_threadpool* threadpool);
+
+/** Returns the number of run queues of the pool: the number of last-level cache domains of its workers */
+uint32_t CPUINFO_ABI cpuinfo_threadpool_get_queues_count(const struct cpuinfo_threadpool* threadpool);
+
+/**
+ * Returns the number of items in chunks of a parallel loop.
+ *
+ * Items which touch item_size bytes each are grouped into chunks which fit the L2 cache share of a worker, as the
+ * kc x mc block of cpuinfo_get_uarch_blocking_hint, on the microarchitecture of the workers with the smallest blocks.
+ * Without the item size, or without caches, every worker gets several chunks to balance load. Chunks never exceed
+ * the share of the range of one worker, so that all workers participate.
+ *
+ * @param range - number of items of the loop.
+ * @param item_size - bytes of data which processing of one item touches, or 0 if unknown.
+ * @returns the number of items in a chunk, at least 1, or 0 if the range is empty.
+ */
+size_t CPUINFO_ABI cpuinfo_threadpool_get_chunk_size(const struct cpuinfo_threadpool* threadpool, size_t range,
+	size_t item_size);
+
+/**
+ * Process items [0, range) in parallel on the threads of the pool, in chunks of cpuinfo_threadpool_get_chunk_size
+ * items, and return after all chunks are processed. Chunks of the range are distributed between the run queues in
+ * proportion to their workers, in contiguous order, so that neighbouring chunks run under the same last-level cache.
+ *
+ * Calls from several threads are serialized. Tasks must not call cpuinfo_threadpool_parallel_for on the same pool.
+ *
+ * @param task - function which processes a chunk of items.
+ * @param context - pointer passed to the task as is.
+ * @param range - number of items.
+ * @param item_size - bytes of data which processing of one item touches, or 0 if unknown.
+ */
+void CPUINFO_ABI cpuinfo_threadpool_parallel_for(struct cpuinfo_threadpool* threadpool, cpuinfo_threadpool_task task,
+	void* context, size_t range, size_t item_size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CPUINFO_THREADPOOL_H */
@@ -10,7 +10,9 @@
 	#include <TargetConditionals.h>
 #endif
 
+#include <stdarg.h>
 #include <stdint.h>
+#include <stddef.h>
 
 /* Identify architecture and define corresponding macro */
 
@@ -34,6 +36,18 @@
 	#define CPUINFO_ARCH_PPC64 1
 #endif
 
+#if defined(__riscv)
+	#if __riscv_xlen == 32
+		#define CPUINFO_ARCH_RISCV32 1
+	#elif __riscv_xlen == 64
+		#define CPUINFO_ARCH_RISCV64 1
+	#endif
+#endif
+
+#if defined(__loongarch64) || (defined(__loongarch__) && __loongarch_grlen == 64)
+	#define CPUINFO_ARCH_LOONGARCH64 1
+#endif
+
 #if defined(__asmjs__)
 	#define CPUINFO_ARCH_ASMJS 1
 #endif
@@ -68,6 +82,18 @@
 	#define CPUINFO_ARCH_PPC64 0
 #endif
 
+#ifndef CPUINFO_ARCH_RISCV32
+	#define CPUINFO_ARCH_RISCV32 0
+#endif
+
+#ifndef CPUINFO_ARCH_RISCV64
+	#define CPUINFO_ARCH_RISCV64 0
+#endif
+
+#ifndef CPUINFO_ARCH_LOONGARCH64
+	#define CPUINFO_ARCH_LOONGARCH64 0
+#endif
+
 #ifndef CPUINFO_ARCH_ASMJS
 	#define CPUINFO_ARCH_ASMJS 0
 #endif
@@ -88,9 +114,36 @@
 	#define CPUINFO_ABI
 #endif
 
+/*
+ * Compile-time upper bound on the destructive interference size: the minimum offset between objects which threads
+ * modify concurrently to avoid false sharing. Includes cache lines which prefetchers fetch in pairs, as the spatial
+ * prefetcher of Intel cores does. Use cpuinfo_get_destructive_interference_size for the value of the running system.
+ */
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM64 || CPUINFO_ARCH_PPC64
+	#define CPUINFO_DESTRUCTIVE_INTERFERENCE_SIZE 128
+#else
+	#define CPUINFO_DESTRUCTIVE_INTERFERENCE_SIZE 64
+#endif
+
+/*
+ * Compile-time lower bound on the constructive interference size: the maximum size of contiguous memory which is
+ * fetched together, so objects accessed together should fit into it. Use cpuinfo_get_constructive_interference_size
+ * for the value of the running system.
+ */
+#if (CPUINFO_ARCH_ARM64 && defined(__APPLE__)) || CPUINFO_ARCH_PPC64
+	#define CPUINFO_CONSTRUCTIVE_INTERFERENCE_SIZE 128
+#elif CPUINFO_ARCH_ARM
+	#define CPUINFO_CONSTRUCTIVE_INTERFERENCE_SIZE 32
+#else
+	#define CPUINFO_CONSTRUCTIVE_INTERFERENCE_SIZE 64
+#endif
+
 #define CPUINFO_CACHE_UNIFIED          0x00000001
 #define CPUINFO_CACHE_INCLUSIVE        0x00000002
 #define CPUINFO_CACHE_COMPLEX_INDEXING 0x00000004
+#define CPUINFO_CACHE_WRITE_THROUGH    0x00000008
+/** Exclusive (victim) cache: filled with lines evicted from the cache level below, which it doesn't duplicate */
+#define CPUINFO_CACHE_EXCLUSIVE        0x00000010
 
 struct cpuinfo_cache {
 	/** Cache size in bytes */
@@ -104,9 +157,9 @@ struct cpuinfo_cache {
 	/** Line size in bytes */
 	uint32_t line_size;
 	/**
-	 * Binary characteristics of the cache (unified cache, inclusive cache, cache with complex indexing).
+	 * Binary characteristics of the cache (unified cache, inclusive or exclusive cache, cache with complex indexing).
 	 *
-	 * @see CPUINFO_CACHE_UNIFIED, CPUINFO_CACHE_INCLUSIVE, CPUINFO_CACHE_COMPLEX_INDEXING
+	 * @see CPUINFO_CACHE_UNIFIED, CPUINFO_CACHE_INCLUSIVE, CPUINFO_CACHE_EXCLUSIVE, CPUINFO_CACHE_COMPLEX_INDEXING
 	 */
 	uint32_t flags;
 	/** Index of the first logical processor that shares this cache */
@@ -120,16 +173,24 @@ struct cpuinfo_trace_cache {
 	uint32_t associativity;
 };
 
-#define CPUINFO_PAGE_SIZE_4KB  0x1000
-#define CPUINFO_PAGE_SIZE_1MB  0x100000
-#define CPUINFO_PAGE_SIZE_2MB  0x200000
-#define CPUINFO_PAGE_SIZE_4MB  0x400000
-#define CPUINFO_PAGE_SIZE_16MB 0x1000000
-#define CPUINFO_PAGE_SIZE_1GB  0x40000000
-
+#define CPUINFO_PAGE_SIZE_4KB   0x1000
+#define CPUINFO_PAGE_SIZE_16KB  0x4000
+#define CPUINFO_PAGE_SIZE_64KB  0x10000
+#define CPUINFO_PAGE_SIZE_1MB   0x100000
+#define CPUINFO_PAGE_SIZE_2MB   0x200000
+#define CPUINFO_PAGE_SIZE_4MB   0x400000
+#define CPUINFO_PAGE_SIZE_16MB  0x1000000
+#define CPUINFO_PAGE_SIZE_32MB  0x2000000
+#define CPUINFO_PAGE_SIZE_512MB 0x20000000
+#define CPUINFO_PAGE_SIZE_1GB   0x40000000
+
+/** Translation lookaside buffer */
 struct cpuinfo_tlb {
+	/** Number of translations in the TLB */
 	uint32_t entries;
+	/** Number of ways of associativity, equal to the number of entries for fully-associative TLBs */
 	uint32_t associativity;
+	/** Bitmask of CPUINFO_PAGE_SIZE_* constants for sizes of pages which the TLB caches */
 	uint64_t pages;
 };
 
@@ -188,6 +249,16 @@ enum cpuinfo_vendor {
 	 * Processors are variants of AMD cores.
 	 */
 	cpuinfo_vendor_hygon    = 16,
+	/** SiFive, Inc. Vendor of RISC-V processor microarchitectures. */
+	cpuinfo_vendor_sifive   = 17,
+	/**
+	 * T-Head Semiconductor Co., Ltd. Vendor of RISC-V processor microarchitectures.
+	 *
+	 * T-Head is a subsidiary of Alibaba Group.
+	 */
+	cpuinfo_vendor_thead    = 18,
+	/** Loongson Technology Corporation Limited. Vendor of LoongArch processor microarchitectures. */
+	cpuinfo_vendor_loongson = 19,
 
 	/* Active vendors of embedded CPUs */
 
@@ -300,6 +371,12 @@ enum cpuinfo_uarch {
 	cpuinfo_uarch_palm_cove    = 0x0010020B,
 	/** Intel Sunny Cove microarchitecture (10 nm, Ice Lake). */
 	cpuinfo_uarch_sunny_cove   = 0x0010020C,
+	/** Intel Golden Cove microarchitecture (Intel 7, Alder Lake P-cores, Sapphire Rapids, including Raptor Cove). */
+	cpuinfo_uarch_golden_cove  = 0x0010020D,
+	/** Intel Redwood Cove microarchitecture (Intel 4/3, Meteor Lake P-cores, Granite Rapids). */
+	cpuinfo_uarch_redwood_cove = 0x0010020E,
+	/** Intel Lion Cove microarchitecture (Arrow Lake and Lunar Lake P-cores). */
+	cpuinfo_uarch_lion_cove    = 0x0010020F,
 
 	/** Pentium 4 with Willamette, Northwood, or Foster cores. */
 	cpuinfo_uarch_willamette = 0x00100300,
@@ -318,6 +395,14 @@ enum cpuinfo_uarch {
 	cpuinfo_uarch_goldmont      = 0x00100404,
 	/** Intel Goldmont Plus microarchitecture (Gemini Lake). */
 	cpuinfo_uarch_goldmont_plus = 0x00100405,
+	/** Intel Tremont microarchitecture (Elkhart Lake, Jasper Lake, Snow Ridge, Lakefield E-cores). */
+	cpuinfo_uarch_tremont       = 0x00100406,
+	/** Intel Gracemont microarchitecture (Alder Lake and Raptor Lake E-cores, Alder Lake-N). */
+	cpuinfo_uarch_gracemont     = 0x00100407,
+	/** Intel Crestmont microarchitecture (Meteor Lake E-cores, Sierra Forest). */
+	cpuinfo_uarch_crestmont     = 0x00100408,
+	/** Intel Skymont microarchitecture (Arrow Lake and Lunar Lake E-cores). */
+	cpuinfo_uarch_skymont       = 0x00100409,
 
 	/** Intel Knights Ferry HPC boards. */
 	cpuinfo_uarch_knights_ferry   = 0x00100500,
@@ -442,6 +527,8 @@ enum cpuinfo_uarch {
 
 	/** ARM Cortex-A510. */
 	cpuinfo_uarch_cortex_a510  = 0x00300551,
+	/** ARM Cortex-A520. */
+	cpuinfo_uarch_cortex_a520  = 0x00300552,
 	/** ARM Cortex-A710. */
 	cpuinfo_uarch_cortex_a710  = 0x00300571,
 	/** ARM Cortex-A715. */
@@ -536,6 +623,31 @@ enum cpuinfo_uarch {
 
 	/** HiSilicon TaiShan v110 (Huawei Kunpeng 920 series processors). */
 	cpuinfo_uarch_taishan_v110 = 0x00C00100,
+
+	/** SiFive U54. */
+	cpuinfo_uarch_sifive_u54  = 0x01100100,
+	/** SiFive U74 (StarFive JH7110). */
+	cpuinfo_uarch_sifive_u74  = 0x01100101,
+	/** SiFive Performance P550. */
+	cpuinfo_uarch_sifive_p550 = 0x01100102,
+	/** SiFive Intelligence X280. */
+	cpuinfo_uarch_sifive_x280 = 0x01100103,
+
+	/** T-Head XuanTie C906. */
+	cpuinfo_uarch_thead_c906 = 0x01200100,
+	/** T-Head XuanTie C910. */
+	cpuinfo_uarch_thead_c910 = 0x01200101,
+	/** T-Head XuanTie C920 (Sophgo SG2042). */
+	cpuinfo_uarch_thead_c920 = 0x01200102,
+
+	/** Loongson LA264 (Loongson 2K1000LA). */
+	cpuinfo_uarch_loongson_la264 = 0x01300100,
+	/** Loongson LA364 (Loongson 2K2000). */
+	cpuinfo_uarch_loongson_la364 = 0x01300101,
+	/** Loongson LA464 (Loongson 3A5000, 3C5000). */
+	cpuinfo_uarch_loongson_la464 = 0x01300102,
+	/** Loongson LA664 (Loongson 3A6000). */
+	cpuinfo_uarch_loongson_la664 = 0x01300103,
 };
 
 struct cpuinfo_processor {
@@ -547,6 +659,31 @@ struct cpuinfo_processor {
 	const struct cpuinfo_cluster* cluster;
 	/** Physical package containing this logical processor */
 	const struct cpuinfo_package* package;
+	/** NUMA node containing this logical processor */
+	const struct cpuinfo_numa_node* numa_node;
+	/** Frequency domain containing this logical processor */
+	const struct cpuinfo_frequency_domain* frequency_domain;
+	/**
+	 * Whether the process may run threads on this logical processor: the processor is in the affinity mask of
+	 * the thread which initialized cpuinfo and, on Linux, in the effective CPUs of the cpuset cgroup.
+	 */
+	bool usable;
+	/**
+	 * Whether the logical processor is isolated from load balancing of the scheduler: on Linux, it is listed in
+	 * /sys/devices/system/cpu/isolated, i.e. in the isolcpus kernel parameter or in an isolated cpuset partition.
+	 */
+	bool isolated;
+	/**
+	 * Whether the kernel stops the scheduling-clock tick on the logical processor while it runs a single task:
+	 * on Linux, it is listed in /sys/devices/system/cpu/nohz_full.
+	 */
+	bool nohz_full;
+	/**
+	 * Whether the logical processor was online at initialization: on Linux, it is listed in
+	 * /sys/devices/system/cpu/online. Offline processors, e.g. SMT siblings turned off by the SMT control, are
+	 * not usable.
+	 */
+	bool online;
 #if defined(__linux__)
 	/**
 	 * Linux-specific ID for the logical processor:
@@ -563,6 +700,11 @@ struct cpuinfo_processor {
 	 * - Bit <windows_processor_id> in the KAFFINITY mask identifies this logical processor within its group.
 	 */
 	uint16_t windows_processor_id;
+	/**
+	 * Windows-specific ID of the CPU set of the logical processor, as in GetSystemCpuSetInformation and
+	 * SetThreadSelectedCpuSets, or 0 if the OS doesn't support CPU sets (before Windows 10).
+	 */
+	uint32_t windows_cpu_set_id;
 #endif
 #if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
 	/** APIC ID (unique x86-specific ID of the logical processor) */
@@ -577,16 +719,27 @@ struct cpuinfo_processor {
 		const struct cpuinfo_cache* l2;
 		/** Level 3 unified or data cache */
 		const struct cpuinfo_cache* l3;
-		/** Level 4 unified or data cache */
+		/**
+		 * Level 4 unified or data cache. On ARM, this is the system-level cache of the SoC, which all processors
+		 * share with other devices. Caches in front of memory of a NUMA node are reported as memory-side caches.
+		 */
 		const struct cpuinfo_cache* l4;
 	} cache;
 };
 
+/** Capacity of the highest-capacity cores in cpuinfo_core.capacity and cpuinfo_cluster.capacity */
+#define CPUINFO_CAPACITY_SCALE 1024
+
 struct cpuinfo_core {
 	/** Index of the first logical processor on this core. */
 	uint32_t processor_start;
 	/** Number of logical processors on this core */
 	uint32_t processor_count;
+	/**
+	 * Number of usable logical processors on this core, i.e. processors which are online and which the process may
+	 * run threads on. This is the number of hardware threads of the core available for workers.
+	 */
+	uint32_t usable_processor_count;
 	/** Core ID within a package */
 	uint32_t core_id;
 	/** Cluster containing this core */
@@ -600,12 +753,43 @@ struct cpuinfo_core {
 #if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
 	/** Value of CPUID leaf 1 EAX register for this core */
 	uint32_t cpuid;
+	/**
+	 * Revision of the microcode loaded on this core, or 0 if unknown. On Linux, this is the microcode field in
+	 * /proc/cpuinfo, or microcode/version in sysfs. Cores of a system normally have the same revision, and mixed
+	 * revisions suggest a failed update.
+	 */
+	uint32_t microcode_revision;
 #elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
 	/** Value of Main ID Register (MIDR) for this core */
 	uint32_t midr;
 #endif
 	/** Clock rate (non-Turbo) of the core, in Hz */
 	uint64_t frequency;
+	/** Maximum Turbo clock rate of the core, in Hz, or 0 if unknown */
+	uint64_t max_turbo_frequency;
+	/**
+	 * Highest performance of the core reported by the OS, or 0 if unknown. On Linux, this is the amd_pstate
+	 * preferred core ranking, the ACPI CPPC highest performance, or the maximum frequency in KHz, whichever is
+	 * available first. On Windows, this is the maximum frequency in KHz if it is known for all cores, or the efficiency
+	 * class plus 1 otherwise. Values are comparable only between cores of the same system.
+	 */
+	uint32_t performance;
+	/** Rank of the core by performance: 0 for the highest-performance cores; cores of equal performance share a rank */
+	uint32_t performance_rank;
+	/**
+	 * Compute capacity of the core relative to the highest-capacity core, which has capacity CPUINFO_CAPACITY_SCALE.
+	 * On ARM Linux this is the kernel capacity (cpu_capacity), or the maximum frequency relative to the highest one.
+	 * On other platforms all cores have capacity CPUINFO_CAPACITY_SCALE.
+	 */
+	uint32_t capacity;
+#if defined(_WIN32) || defined(__CYGWIN__)
+	/**
+	 * Windows-specific efficiency class of the core: cores with higher classes have higher performance and lower
+	 * efficiency, e.g. 1 for P-cores and 0 for E-cores of hybrid Intel processors. All cores of homogeneous systems
+	 * have class 0.
+	 */
+	uint8_t windows_efficiency_class;
+#endif
 };
 
 struct cpuinfo_cluster {
@@ -634,6 +818,11 @@ struct cpuinfo_cluster {
 #endif
 	/** Clock rate (non-Turbo) of the cores in the cluster, in Hz */
 	uint64_t frequency;
+	/**
+	 * Compute capacity of every core in the cluster, relative to CPUINFO_CAPACITY_SCALE for the highest-capacity core.
+	 * Work split between clusters in proportion to capacity times core_count keeps all cores busy for equal time.
+	 */
+	uint32_t capacity;
 };
 
 #define CPUINFO_PACKAGE_NAME_MAX 48
@@ -655,6 +844,364 @@ struct cpuinfo_package {
 	uint32_t cluster_count;
 };
 
+/** Family of an integrated GPU */
+enum cpuinfo_gpu_family {
+	/** GPU is unknown, or the chipset tables don't describe it */
+	cpuinfo_gpu_family_unknown = 0,
+	/** Qualcomm Adreno */
+	cpuinfo_gpu_family_adreno = 1,
+	/** Arm Mali */
+	cpuinfo_gpu_family_mali = 2,
+	/** Arm Immortalis: flagship configurations of Mali with hardware ray tracing */
+	cpuinfo_gpu_family_immortalis = 3,
+	/** Imagination PowerVR */
+	cpuinfo_gpu_family_powervr = 4,
+	/** Samsung Xclipse, based on AMD RDNA */
+	cpuinfo_gpu_family_xclipse = 5,
+};
+
+#define CPUINFO_GPU_NAME_MAX 32
+
+/** GPU integrated in the SoC, identified from the decoded chipset without a graphics context */
+struct cpuinfo_integrated_gpu {
+	enum cpuinfo_gpu_family family;
+	/** Model number within the family, e.g. 740 for Adreno 740, 78 for Mali-G78, and 715 for Immortalis-G715 */
+	uint32_t model;
+	/**
+	 * Leading digit of the model number, which groups GPUs of the same tier across generations of a family: 7 for
+	 * Adreno 7xx, Mali-G7x, Mali-G7xx and Immortalis-G7xx.
+	 */
+	uint32_t series;
+	/** Number of shader cores, as in the MP or MC suffix of Mali, or 0 if unknown */
+	uint32_t cores;
+	/** Marketing name, e.g. "Adreno 740" or "Mali-G710 MC10" */
+	char name[CPUINFO_GPU_NAME_MAX];
+};
+
+/** Family of a neural processing unit */
+enum cpuinfo_npu_family {
+	/** SoC has no known NPU */
+	cpuinfo_npu_family_unknown = 0,
+	/** Qualcomm Hexagon DSP with a tensor accelerator */
+	cpuinfo_npu_family_hexagon = 1,
+	/** MediaTek AI Processing Unit (APU) */
+	cpuinfo_npu_family_mediatek_apu = 2,
+	/** Samsung Exynos NPU */
+	cpuinfo_npu_family_samsung = 3,
+	/** HiSilicon Kirin NPU */
+	cpuinfo_npu_family_hisilicon = 4,
+};
+
+#define CPUINFO_NPU_NAME_MAX 32
+
+/** Neural processing unit integrated in the SoC, identified from the decoded chipset */
+struct cpuinfo_npu {
+	enum cpuinfo_npu_family family;
+	/** Name, e.g. "Hexagon" or "MediaTek APU" */
+	char name[CPUINFO_NPU_NAME_MAX];
+};
+
+/**
+ * NUMA node: logical processors and memory with the same memory access latency.
+ * If the operating system doesn't report NUMA nodes, all logical processors and memory belong to a single node.
+ */
+struct cpuinfo_numa_node {
+	/** NUMA node ID reported by the operating system */
+	uint32_t node_id;
+	/**
+	 * Index of the first logical processor on this NUMA node.
+	 * Nodes with memory but without logical processors have processor_start and processor_count of 0.
+	 */
+	uint32_t processor_start;
+	/**
+	 * Number of logical processors from processor_start to the last logical processor on this NUMA node, inclusive.
+	 * If the operating system interleaves NUMA nodes within a package, the range also contains logical processors
+	 * of other nodes: use the numa_node member of cpuinfo_processor to check if a processor is on this node.
+	 */
+	uint32_t processor_count;
+	/** Memory on this NUMA node, in bytes, or 0 if unknown. On Windows, this is the memory available at initialization */
+	uint64_t memory_size;
+	/**
+	 * Row of the NUMA distance matrix for this node, with cpuinfo_get_numa_nodes_count() entries indexed by node index.
+	 * Distances are relative, with 10 for local access. If the operating system doesn't report distances, as on
+	 * Windows, remote access has distance 20.
+	 */
+	const uint32_t* distances;
+	/**
+	 * ID of the memory tier of the node memory, or UINT32_MAX if unknown. Tiers with lower IDs are faster: on Linux,
+	 * the ID is the abstract distance of the memory divided into chunks, and DRAM is in tier 4 while CXL-attached or
+	 * persistent memory is in higher tiers. Memory-only nodes, such as HBM or CXL nodes, have processor_count of 0.
+	 */
+	uint32_t memory_tier;
+	/** Index of the first memory-side cache of this node, as for cpuinfo_get_memory_side_cache */
+	uint32_t memory_side_cache_start;
+	/** Number of memory-side caches of this node, from the closest to processors */
+	uint32_t memory_side_cache_count;
+};
+
+/**
+ * Memory-side cache: cache in front of the memory of a NUMA node, such as HBM or DRAM which caches slower memory.
+ * Unlike processor caches, memory-side caches are shared by all accesses to the memory of the node.
+ */
+struct cpuinfo_memory_side_cache {
+	/** Size of the cache in bytes */
+	uint64_t size;
+	/** Level of the cache, starting from 1 for the cache closest to processors */
+	uint32_t level;
+	/** Cache line size in bytes, or 0 if unknown */
+	uint32_t line_size;
+	/** Binary characteristics of the cache: CPUINFO_CACHE_COMPLEX_INDEXING and CPUINFO_CACHE_WRITE_THROUGH */
+	uint32_t flags;
+	/** NUMA node whose memory the cache holds */
+	const struct cpuinfo_numa_node* numa_node;
+};
+
+/**
+ * Cache allocation capabilities of a cache level: Intel RDT Cache Allocation Technology (CAT), or AMD PQoS L3 cache
+ * allocation enforcement. Classes of service partition ways of every cache at the level with capacity bitmasks.
+ */
+struct cpuinfo_cache_allocation {
+	/** Number of classes of service (CLOS), or 0 if cache allocation is not supported */
+	uint32_t classes_count;
+	/** Number of bits in capacity bitmasks */
+	uint32_t capacity_mask_length;
+	/** Bitmask of capacity units which other agents, such as the GPU or I/O devices, may also use */
+	uint32_t shared_mask;
+	/** Whether classes of service can have separate bitmasks for code and data (CDP) */
+	bool code_data_prioritization;
+	/** Whether capacity bitmasks can have non-contiguous bits set */
+	bool noncontiguous_masks;
+};
+
+/**
+ * Capabilities to monitor and to partition shared caches and memory bandwidth between workloads: Intel Resource
+ * Director Technology (RDT), or AMD Platform Quality of Service (PQoS). On Linux, they are controlled through the
+ * resctrl file system.
+ */
+struct cpuinfo_resource_control {
+	/** Allocation of L2 caches; classes_count is 0 if not supported */
+	struct cpuinfo_cache_allocation l2_allocation;
+	/** Allocation of L3 caches; classes_count is 0 if not supported */
+	struct cpuinfo_cache_allocation l3_allocation;
+	/** Number of classes of service for memory bandwidth allocation (MBA), or 0 if not supported */
+	uint32_t memory_bandwidth_classes_count;
+	/** Maximum throttling value of memory bandwidth allocation, in percents on Intel, or 0 if unknown */
+	uint32_t memory_bandwidth_max_throttling;
+	/** Whether memory bandwidth throttling values are linear */
+	bool memory_bandwidth_linear;
+	/** Whether the occupancy of L3 caches can be monitored (CMT) */
+	bool l3_occupancy_monitoring;
+	/** Whether the total and the local memory bandwidth can be monitored (MBM) */
+	bool total_memory_bandwidth_monitoring;
+	bool local_memory_bandwidth_monitoring;
+	/** Number of resource monitoring IDs (RMID) for L3 monitoring, or 0 if monitoring is not supported */
+	uint32_t monitoring_ids_count;
+	/** Conversion factor from monitoring counter values to bytes */
+	uint32_t monitoring_scale;
+	/** On Linux, whether the resctrl file system is mounted at /sys/fs/resctrl */
+	bool resctrl_mounted;
+};
+
+/** Number of XSAVE state components which cpuinfo reports: the bits of XCR0 defined to date */
+#define CPUINFO_X86_XSAVE_COMPONENTS_MAX 32
+
+/** Location of an XSAVE state component in the standard (non-compacted) format of the XSAVE area */
+struct cpuinfo_x86_xsave_component {
+	/** Offset in bytes from the start of the XSAVE area */
+	uint32_t offset;
+	/** Size in bytes, or 0 if the OS doesn't enable the component */
+	uint32_t size;
+};
+
+/** x86 vector and register file extensions which need the OS to enable their state components in XCR0 */
+enum cpuinfo_x86_vector_extension {
+	/** AVX: upper halves of YMM registers */
+	cpuinfo_x86_vector_extension_avx = 0,
+	/** AVX-512 and AVX10: opmask registers, upper halves of ZMM0-ZMM15 and ZMM16-ZMM31 */
+	cpuinfo_x86_vector_extension_avx512,
+	/** AMX: tile configuration and tile data */
+	cpuinfo_x86_vector_extension_amx,
+	/** APX: extended general-purpose registers R16-R31 */
+	cpuinfo_x86_vector_extension_apx,
+	/** Number of extensions, not a valid extension */
+	cpuinfo_x86_vector_extension_max,
+};
+
+/** Reason why an x86 vector extension can't be used */
+enum cpuinfo_x86_vector_extension_reason {
+	/** The extension is supported by the processor and enabled by the OS */
+	cpuinfo_x86_vector_extension_reason_enabled = 0,
+	/** The processor doesn't report the extension in CPUID, e.g. it is not implemented or fused off */
+	cpuinfo_x86_vector_extension_reason_unsupported,
+	/** The OS didn't enable XSAVE, so none of the extended state can be used */
+	cpuinfo_x86_vector_extension_reason_xsave_disabled,
+	/** The processor doesn't report the state components of the extension in CPUID leaf 0xD */
+	cpuinfo_x86_vector_extension_reason_state_unsupported,
+	/** The OS or hypervisor didn't enable the state components of the extension in XCR0 */
+	cpuinfo_x86_vector_extension_reason_state_disabled,
+};
+
+/** Support of an x86 vector extension by the processor, and its state as enabled by the OS */
+struct cpuinfo_x86_vector_extension_state {
+	/** State components the extension needs in XCR0: bit N is set if it needs component N */
+	uint64_t state_components;
+	/** Whether the processor reports the extension in CPUID, regardless of the OS */
+	bool supported;
+	/** Whether the extension can be used: supported by the processor and its state components enabled by the OS */
+	bool enabled;
+	/** Why the extension can't be used, or cpuinfo_x86_vector_extension_reason_enabled if it can */
+	enum cpuinfo_x86_vector_extension_reason reason;
+};
+
+/** Extended processor state which XSAVE saves for threads, as configured by the OS in XCR0 */
+struct cpuinfo_x86_xsave_state {
+	/** State components enabled in XCR0: bit N is set if component N, e.g. 5-7 for AVX-512, is enabled */
+	uint64_t features;
+	/** Size in bytes of the XSAVE area for the enabled components, including the legacy region and header */
+	uint32_t size;
+	/** Components indexed by their number: 0 for x87 state, 1 for SSE state, 2 for upper halves of YMM, and so on */
+	struct cpuinfo_x86_xsave_component components[CPUINFO_X86_XSAVE_COMPONENTS_MAX];
+	/**
+	 * Extensions indexed by enum cpuinfo_x86_vector_extension. Unlike cpuinfo_has_x86_* functions, which report
+	 * only enabled extensions, these tell extensions the processor lacks from ones the OS or hypervisor masked.
+	 */
+	struct cpuinfo_x86_vector_extension_state extensions[cpuinfo_x86_vector_extension_max];
+};
+
+/** Pool of huge pages of one size, reserved by the operating system (on Linux, hugetlbfs pages) */
+struct cpuinfo_huge_page_pool {
+	/** Size of the pages, in bytes */
+	uint64_t page_size;
+	/** Number of pages in the pool */
+	uint64_t total_pages;
+	/** Number of pages in the pool not yet allocated, including reserved pages */
+	uint64_t free_pages;
+	/** Number of free pages reserved for mappings which didn't touch them yet; 0 for pools of NUMA nodes */
+	uint64_t reserved_pages;
+};
+
+/** Policy of the operating system for backing anonymous memory with transparent huge pages */
+enum cpuinfo_transparent_huge_pages_mode {
+	/** Transparent huge pages are not supported, or the policy is unknown */
+	cpuinfo_transparent_huge_pages_mode_unknown = 0,
+	/** Transparent huge pages are disabled */
+	cpuinfo_transparent_huge_pages_mode_never,
+	/** Only memory regions advised with madvise(MADV_HUGEPAGE) are backed with transparent huge pages */
+	cpuinfo_transparent_huge_pages_mode_madvise,
+	/** All suitable anonymous memory regions are backed with transparent huge pages */
+	cpuinfo_transparent_huge_pages_mode_always,
+};
+
+/** Policy of the operating system for compacting memory when a transparent huge page can't be allocated */
+enum cpuinfo_transparent_huge_pages_defrag {
+	/** Defragmentation policy is unknown */
+	cpuinfo_transparent_huge_pages_defrag_unknown = 0,
+	/** Page faults fall back to regular pages without compaction */
+	cpuinfo_transparent_huge_pages_defrag_never,
+	/** Page faults in regions advised with madvise(MADV_HUGEPAGE) stall for compaction, others don't */
+	cpuinfo_transparent_huge_pages_defrag_madvise,
+	/** Page faults fall back to regular pages and wake up background compaction */
+	cpuinfo_transparent_huge_pages_defrag_defer,
+	/** As defer, but page faults in regions advised with madvise(MADV_HUGEPAGE) stall for compaction */
+	cpuinfo_transparent_huge_pages_defrag_defer_madvise,
+	/** All page faults stall for compaction */
+	cpuinfo_transparent_huge_pages_defrag_always,
+};
+
+/** Transparent huge pages configuration of the operating system */
+struct cpuinfo_transparent_huge_pages {
+	enum cpuinfo_transparent_huge_pages_mode mode;
+	enum cpuinfo_transparent_huge_pages_defrag defrag;
+	/** Size of transparent huge pages mapped by one page table entry of the middle level, in bytes, or 0 if unknown */
+	uint64_t page_size;
+};
+
+#define CPUINFO_GOVERNOR_NAME_MAX 16
+#define CPUINFO_FREQUENCY_DRIVER_NAME_MAX 16
+
+/**
+ * Energy-performance preference (EPP) of a frequency domain: the hint which the hardware-controlled P-states of
+ * intel_pstate and amd-pstate in active mode trade energy for performance by. Preferences closer to performance
+ * raise the frequency faster under bursty load.
+ */
+enum cpuinfo_energy_performance_preference {
+	/** The driver doesn't report energy-performance preferences */
+	cpuinfo_energy_performance_preference_unknown = 0,
+	/** Preference programmed by the firmware */
+	cpuinfo_energy_performance_preference_default = 1,
+	cpuinfo_energy_performance_preference_performance = 2,
+	cpuinfo_energy_performance_preference_balance_performance = 3,
+	cpuinfo_energy_performance_preference_balance_power = 4,
+	cpuinfo_energy_performance_preference_power = 5,
+	/** Raw value without a name, e.g. written as a number to intel_pstate */
+	cpuinfo_energy_performance_preference_custom = 6,
+};
+
+/**
+ * Frequency domain: logical processors which change frequency together, i.e. a cpufreq policy on Linux.
+ * Load concentrated on fewer domains lets the other domains drop to lower frequencies or idle.
+ * If the operating system doesn't report frequency domains, all logical processors belong to a single domain.
+ */
+struct cpuinfo_frequency_domain {
+	/**
+	 * ID of the frequency domain: on Linux, the lowest processor ID in the cpufreq policy, which is also the N in
+	 * the name of its /sys/devices/system/cpu/cpufreq/policyN directory on most systems. Logical processors without
+	 * a cpufreq policy share a domain with ID UINT32_MAX.
+	 */
+	uint32_t domain_id;
+	/** Index of the first logical processor in this frequency domain */
+	uint32_t processor_start;
+	/**
+	 * Number of logical processors from processor_start to the last logical processor in this domain, inclusive.
+	 * Use the frequency_domain member of cpuinfo_processor to check if a processor in the range is in this domain.
+	 */
+	uint32_t processor_count;
+	/** Number of entries in frequencies */
+	uint32_t frequencies_count;
+	/** Minimum frequency supported by the hardware, in Hz, or 0 if unknown */
+	uint64_t min_frequency;
+	/** Maximum frequency supported by the hardware, including boost frequencies, in Hz, or 0 if unknown */
+	uint64_t max_frequency;
+	/** Frequencies which the driver may select, in Hz, in increasing order, or NULL if the driver doesn't list them */
+	const uint64_t* frequencies;
+	/** Name of the frequency scaling governor, e.g. "schedutil", or empty string if unknown */
+	char governor[CPUINFO_GOVERNOR_NAME_MAX];
+	/** Whether boost (turbo) frequencies above the sustainable maximum are enabled */
+	bool boost;
+	/** Name of the frequency scaling driver, e.g. "intel_pstate" or "amd-pstate-epp", or empty string if unknown */
+	char driver[CPUINFO_FREQUENCY_DRIVER_NAME_MAX];
+	/** Energy-performance preference at initialization; on Linux, cpufreq/energy_performance_preference */
+	enum cpuinfo_energy_performance_preference energy_performance_preference;
+	/**
+	 * Preferences which the driver accepts, as bits (1 << preference), or 0 if the driver doesn't list them; on
+	 * Linux, cpufreq/energy_performance_available_preferences.
+	 */
+	uint32_t energy_performance_preferences;
+};
+
+/**
+ * Uncore frequency domain: the interconnect mesh or ring, last-level cache, and memory controllers of a die, which
+ * run at their own frequency. On Linux, the intel_uncore_frequency driver controls the frequency of every package and
+ * die of Intel processors in /sys/devices/system/cpu/intel_uncore_frequency/package_XX_die_YY. Latency of accesses to
+ * the last-level cache and memory depends on the uncore frequency.
+ */
+struct cpuinfo_uncore_domain {
+	/** Package of the die, or NULL if no package of the tables has the physical package ID */
+	const struct cpuinfo_package* package;
+	/** Physical package ID reported by the operating system */
+	uint32_t package_id;
+	/** ID of the die within the package */
+	uint32_t die_id;
+	/** Minimum uncore frequency supported by the hardware, in Hz, or 0 if unknown (initial_min_freq_khz) */
+	uint64_t min_frequency;
+	/** Maximum uncore frequency supported by the hardware, in Hz, or 0 if unknown (initial_max_freq_khz) */
+	uint64_t max_frequency;
+	/** Lower limit of uncore frequency scaling at initialization, in Hz, or 0 if unknown (min_freq_khz) */
+	uint64_t limit_min_frequency;
+	/** Upper limit of uncore frequency scaling at initialization, in Hz, or 0 if unknown (max_freq_khz) */
+	uint64_t limit_max_frequency;
+};
+
 struct cpuinfo_uarch_info {
 	/** Type of CPU microarchitecture */
 	enum cpuinfo_uarch uarch;
@@ -677,1266 +1224,6234 @@ extern "C" {
 
 bool CPUINFO_ABI cpuinfo_initialize(void);
 
-void CPUINFO_ABI cpuinfo_deinitialize(void);
+/** Initialize instruction set information (cpuinfo_has_* functions) */
+#define CPUINFO_INIT_ISA           UINT32_C(0x00000001)
+/** Initialize logical processors, cores, clusters, and packages */
+#define CPUINFO_INIT_TOPOLOGY      UINT32_C(0x00000002)
+/** Initialize cache descriptions */
+#define CPUINFO_INIT_CACHES        UINT32_C(0x00000004)
+/** Initialize package (SoC or processor chip) names */
+#define CPUINFO_INIT_PACKAGE_NAMES UINT32_C(0x00000008)
+/** Initialize microarchitecture descriptions */
+#define CPUINFO_INIT_UARCHS        UINT32_C(0x00000010)
+/** Initialize all subsystems, equivalent to cpuinfo_initialize() */
+#define CPUINFO_INIT_ALL           UINT32_C(0x0000001F)
+/**
+ * Read per-processor OS information (e.g. Linux sysfs) on several threads during initialization.
+ * This flag does not select a subsystem, and is only a hint to speed up initialization on systems with many processors.
+ */
+#define CPUINFO_INIT_PARALLEL_PROBING UINT32_C(0x00000100)
+/**
+ * Make cpuinfo_get_* functions wait for completion of background initialization started by cpuinfo_initialize_async.
+ * Without this flag, calling cpuinfo_get_* functions before initialization completes is an error.
+ */
+#define CPUINFO_INIT_WAIT_IN_GETTERS UINT32_C(0x00000200)
+/**
+ * Query CPUID on every logical processor rather than only on the initializing one, and decode caches, topology, and
+ * microarchitecture separately for each distinct CPUID signature. Instruction set information is then limited to
+ * the instructions supported on all processors. Only x86 Linux supports this flag; hybrid x86 processors are always
+ * queried on every logical processor.
+ */
+#define CPUINFO_INIT_PER_PROCESSOR_CPUID UINT32_C(0x00000400)
+/**
+ * Release tables replaced by cpuinfo_reinitialize as soon as no snapshot acquired with cpuinfo_snapshot_acquire
+ * refers to them, rather than at cpuinfo_deinitialize. With this flag, pointers returned by cpuinfo_get_* functions
+ * are valid only until the next re-initialization: threads which use them concurrently with re-initialization must
+ * acquire a snapshot instead.
+ */
+#define CPUINFO_INIT_RECLAIM_RETIRED_TABLES UINT32_C(0x00000800)
 
-#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-	/* This structure is not a part of stable API. Use cpuinfo_has_x86_* functions instead. */
-	struct cpuinfo_x86_isa {
-		#if CPUINFO_ARCH_X86
-			bool rdtsc;
-		#endif
-		bool rdtscp;
-		bool rdpid;
-		bool sysenter;
-		#if CPUINFO_ARCH_X86
-			bool syscall;
-		#endif
-		bool msr;
-		bool clzero;
-		bool clflush;
-		bool clflushopt;
-		bool mwait;
-		bool mwaitx;
-		#if CPUINFO_ARCH_X86
-			bool emmx;
-		#endif
-		bool fxsave;
-		bool xsave;
-		#if CPUINFO_ARCH_X86
-			bool fpu;
-			bool mmx;
-			bool mmx_plus;
-		#endif
-		bool three_d_now;
-		bool three_d_now_plus;
-		#if CPUINFO_ARCH_X86
-			bool three_d_now_geode;
-		#endif
-		bool prefetch;
-		bool prefetchw;
-		bool prefetchwt1;
-		#if CPUINFO_ARCH_X86
-			bool daz;
-			bool sse;
-			bool sse2;
-		#endif
-		bool sse3;
-		bool ssse3;
-		bool sse4_1;
-		bool sse4_2;
-		bool sse4a;
-		bool misaligned_sse;
-		bool avx;
-		bool fma3;
-		bool fma4;
-		bool xop;
-		bool f16c;
-		bool avx2;
-		bool avx512f;
-		bool avx512pf;
-		bool avx512er;
-		bool avx512cd;
-		bool avx512dq;
-		bool avx512bw;
-		bool avx512vl;
-		bool avx512ifma;
-		bool avx512vbmi;
-		bool avx512vbmi2;
-		bool avx512bitalg;
-		bool avx512vpopcntdq;
-		bool avx512vnni;
-		bool avx512bf16;
-		bool avx512fp16;
-		bool avx512vp2intersect;
-		bool avx512_4vnniw;
-		bool avx512_4fmaps;
-		bool hle;
-		bool rtm;
-		bool xtest;
-		bool mpx;
-		#if CPUINFO_ARCH_X86
-			bool cmov;
-			bool cmpxchg8b;
-		#endif
-		bool cmpxchg16b;
-		bool clwb;
-		bool movbe;
-		#if CPUINFO_ARCH_X86_64
-			bool lahf_sahf;
-		#endif
-		bool fs_gs_base;
-		bool lzcnt;
-		bool popcnt;
-		bool tbm;
-		bool bmi;
-		bool bmi2;
-		bool adx;
-		bool aes;
-		bool vaes;
-		bool pclmulqdq;
-		bool vpclmulqdq;
-		bool gfni;
-		bool rdrand;
-		bool rdseed;
-		bool sha;
-		bool rng;
-		bool ace;
-		bool ace2;
-		bool phe;
-		bool pmm;
-		bool lwp;
-	};
+/**
+ * Initialize only the requested subsystems of cpuinfo.
+ *
+ * Subsystems which were not requested are initialized on the first call to a cpuinfo_get_* function.
+ * If the platform can not initialize the requested subsystems separately, all subsystems are initialized eagerly.
+ *
+ * @param flags - bitwise combination of CPUINFO_INIT_* flags.
+ * @returns true if the requested subsystems were successfully initialized.
+ */
+bool CPUINFO_ABI cpuinfo_initialize_ex(uint32_t flags);
 
-	extern struct cpuinfo_x86_isa cpuinfo_isa;
-#endif
+/**
+ * Start initialization of all subsystems of cpuinfo on a background thread, and return without waiting for it.
+ *
+ * Use cpuinfo_is_ready to check if initialization completed, and cpuinfo_wait to wait for its completion.
+ * If the background thread can not be created, cpuinfo is initialized on the calling thread.
+ *
+ * @param flags - bitwise combination of CPUINFO_INIT_PARALLEL_PROBING, CPUINFO_INIT_PER_PROCESSOR_CPUID, and
+ *                CPUINFO_INIT_WAIT_IN_GETTERS flags.
+ *                Subsystem flags are ignored: all subsystems are initialized.
+ * @returns true if initialization was started, or already completed successfully.
+ */
+bool CPUINFO_ABI cpuinfo_initialize_async(uint32_t flags);
+
+/**
+ * Check if cpuinfo is initialized, and cpuinfo_get_* functions can be called without waiting.
+ * This function is cheap, and can be called on the hot path.
+ */
+bool CPUINFO_ABI cpuinfo_is_ready(void);
+
+/**
+ * Wait for completion of initialization started by cpuinfo_initialize_async.
+ * If no initialization was started, cpuinfo is initialized on the calling thread.
+ *
+ * @returns true if cpuinfo was successfully initialized.
+ */
+bool CPUINFO_ABI cpuinfo_wait(void);
+
+/**
+ * Re-detect processor topology, caches, and microarchitectures, e.g. after processors were brought online or offline.
+ *
+ * Threads may keep calling cpuinfo_get_* functions during re-initialization: they observe either the previous or
+ * the new tables. Pointers to the previous tables remain valid until cpuinfo_deinitialize, or, with
+ * CPUINFO_INIT_RECLAIM_RETIRED_TABLES flag, until the snapshots which refer to them are released. This holds for
+ * re-initialization by topology change notifications too. If re-initialization fails, the previous tables remain in
+ * use.
+ *
+ * @returns true if the tables were successfully re-detected.
+ */
+bool CPUINFO_ABI cpuinfo_reinitialize(void);
+
+/**
+ * Returns the generation of the tables: a number which increases every time initialization or re-initialization
+ * publishes new tables. Readers which cache pointers or values from the tables can compare the generation with the
+ * cached one to cheaply detect that the topology changed.
+ */
+uint64_t CPUINFO_ABI cpuinfo_get_topology_generation(void);
+
+/** Maximum number of callbacks registered with cpuinfo_register_topology_callback at the same time */
+#define CPUINFO_MAX_TOPOLOGY_CALLBACKS 16
+
+/**
+ * Callback for changes of the topology.
+ *
+ * @param generation - generation of the new tables, as returned by cpuinfo_get_topology_generation.
+ * @param context - context pointer passed to cpuinfo_register_topology_callback.
+ */
+typedef void (*cpuinfo_topology_callback)(uint64_t generation, void* context);
+
+/**
+ * Register a callback to be called when processors are brought online or offline, e.g. when vCPUs are hot-added, or
+ * when cores are taken offline under thermal pressure.
+ *
+ * The first registered callback starts a background thread which watches kernel uevents for processors and the list
+ * of online processors (the latter is checked every second, because uevents don't reach most containers). When the
+ * list of online processors changes, the thread re-initializes cpuinfo as cpuinfo_reinitialize does, and then calls
+ * all registered callbacks with the new generation. Callbacks are called on the background thread, and must not
+ * register or unregister callbacks, or deinitialize cpuinfo.
+ *
+ * Tables replaced by each topology change are kept until cpuinfo_deinitialize, so that pointers returned by
+ * cpuinfo_get_* functions stay valid, and memory grows with every change. Long-running processes which expect
+ * frequent changes can bound it with CPUINFO_INIT_RECLAIM_RETIRED_TABLES flag: replaced tables are then released
+ * once no snapshot acquired with cpuinfo_snapshot_acquire refers to them, and threads must hold snapshots rather
+ * than pointers.
+ *
+ * Topology change notifications are supported only on Linux.
+ *
+ * @returns true if the callback was registered, and false if cpuinfo is not initialized, the platform is not
+ *          supported, or CPUINFO_MAX_TOPOLOGY_CALLBACKS callbacks are already registered.
+ */
+bool CPUINFO_ABI cpuinfo_register_topology_callback(cpuinfo_topology_callback callback, void* context);
+
+/**
+ * Unregister a callback registered with the same context by cpuinfo_register_topology_callback.
+ * Unregistering the last callback stops the background thread, and waits for its callbacks to return.
+ * cpuinfo_deinitialize unregisters all callbacks.
+ *
+ * @returns true if the callback was registered.
+ */
+bool CPUINFO_ABI cpuinfo_unregister_topology_callback(cpuinfo_topology_callback callback, void* context);
+
+/**
+ * Immutable view of one generation of the topology tables.
+ * All pointers in the view, and the pointers reachable from them, stay valid until the view is released.
+ */
+struct cpuinfo_topology_snapshot {
+	/** Generation of the tables, as returned by cpuinfo_get_topology_generation */
+	uint64_t generation;
+	const struct cpuinfo_processor* processors;
+	const struct cpuinfo_core* cores;
+	const struct cpuinfo_cluster* clusters;
+	const struct cpuinfo_package* packages;
+	uint32_t processors_count;
+	uint32_t cores_count;
+	uint32_t clusters_count;
+	uint32_t packages_count;
+};
+
+/**
+ * Acquire a consistent view of the current topology tables without taking any lock.
+ *
+ * The view keeps its tables alive across cpuinfo_reinitialize, including re-initialization by the topology
+ * monitor, until it is released with cpuinfo_snapshot_release. Acquiring and releasing a view costs a few atomic
+ * operations, and never waits for re-initialization. Views must be released before cpuinfo_deinitialize.
+ *
+ * @returns pointer to the view, or NULL if cpuinfo is not initialized.
+ */
+const struct cpuinfo_topology_snapshot* CPUINFO_ABI cpuinfo_snapshot_acquire(void);
+
+/**
+ * Release a view acquired with cpuinfo_snapshot_acquire. Its tables are released by a later re-initialization if
+ * they were replaced and no other view refers to them, and cpuinfo was initialized with
+ * CPUINFO_INIT_RECLAIM_RETIRED_TABLES flag.
+ *
+ * @param snapshot - view returned by cpuinfo_snapshot_acquire, or NULL.
+ */
+void CPUINFO_ABI cpuinfo_snapshot_release(const struct cpuinfo_topology_snapshot* snapshot);
+
+/**
+ * Release all memory allocated by cpuinfo, and return it to the uninitialized state.
+ *
+ * All pointers returned by cpuinfo_get_* functions are invalidated, including the ones to tables replaced by
+ * cpuinfo_reinitialize. This function must not be called concurrently with any other cpuinfo function.
+ * Background initialization of cpuinfo_initialize_async which did not start yet is cancelled.
+ * cpuinfo can be initialized again after this call.
+ */
+void CPUINFO_ABI cpuinfo_deinitialize(void);
+
+/**
+ * Save the detected processor topology, caches, microarchitectures, and ISA into a binary snapshot file.
+ *
+ * The snapshot is tied to the current boot of the system and the set of processors visible to the kernel.
+ * The file is written atomically: it is created under a temporary name and then renamed to the specified path.
+ * Snapshots are supported only on Linux.
+ *
+ * @param path - path of the snapshot file. An existing file is replaced.
+ * @returns true if the snapshot file was successfully written.
+ */
+bool CPUINFO_ABI cpuinfo_save_snapshot(const char* path);
+
+/**
+ * Initialize cpuinfo from a snapshot file produced by cpuinfo_save_snapshot.
+ *
+ * The snapshot file is mapped into memory in place of parsing sysfs and /proc/cpuinfo. If the snapshot is missing,
+ * corrupted, produced by an incompatible version of cpuinfo, or does not match the current system (e.g. after a
+ * reboot or a change in the set of online processors), cpuinfo falls back to cpuinfo_initialize().
+ * This function must not be called concurrently with cpuinfo_initialize.
+ *
+ * @param path - path of the snapshot file.
+ * @returns true if cpuinfo was successfully initialized, either from the snapshot or from the system.
+ */
+bool CPUINFO_ABI cpuinfo_initialize_from_snapshot(const char* path);
+
+/**
+ * Initialize cpuinfo from a snapshot shared between processes in a named POSIX shared memory segment.
+ *
+ * The first process to call this function detects the topology with cpuinfo_initialize() and publishes its snapshot
+ * under the specified name. Later processes attach to the published segment without modifying it, and validate its
+ * version, checksum, and fingerprint of the system as cpuinfo_initialize_from_snapshot does. A stale or corrupted
+ * segment is replaced after the topology is detected again, and so is a segment left unpublished for 10 seconds by a
+ * publisher which died. Processes which map the segment at the same address as
+ * the publisher share its memory, except for the pages of the processor and core tables, which get per-process
+ * properties such as usable processors. Shared snapshots are supported only on Linux, excluding Android, and other
+ * platforms fall back to cpuinfo_initialize(). This function must not be called concurrently with cpuinfo_initialize.
+ *
+ * @param name - name of the shared memory segment, as accepted by shm_open, e.g. "/cpuinfo".
+ * @returns true if cpuinfo was successfully initialized, either from the shared snapshot or from the system.
+ */
+bool CPUINFO_ABI cpuinfo_initialize_shared(const char* name);
+
+/**
+ * Initialize cpuinfo from a capture of another system: a snapshot file produced by cpuinfo_save_snapshot on that
+ * system, e.g. a production host, for offline planning of thread placement and tile sizes in regular builds.
+ *
+ * Unlike cpuinfo_initialize_from_snapshot, the snapshot is not checked against the current system, and there is no
+ * fallback to cpuinfo_initialize. The capture must come from a build of cpuinfo of the same version for the same
+ * architecture and pointer width. Processors of the captured system are all usable, and belong to a single NUMA node
+ * and a single frequency domain, as the capture doesn't include them. Getters of the current processor, samplers,
+ * and placement functions still observe the current system. Captures are supported only on Linux.
+ *
+ * @param path - path of the snapshot file.
+ * @returns true if cpuinfo was initialized from the capture, and false if the capture is missing or incompatible,
+ *          or cpuinfo is already initialized.
+ */
+bool CPUINFO_ABI cpuinfo_initialize_from_capture(const char* path);
+
+/**
+ * Query the size of the buffer for cpuinfo_initialize_into. The query runs one initialization on the heap to measure
+ * the tables and the temporary arrays of initialization, then discards it, so cpuinfo remains uninitialized.
+ * Initialization into a buffer is supported only on Linux.
+ *
+ * @returns the size of the buffer in bytes, or 0 if initialization failed, cpuinfo is already initialized, or the
+ *          operating system is not supported.
+ */
+size_t CPUINFO_ABI cpuinfo_query_buffer_size(void);
+
+/**
+ * Initialize cpuinfo without heap allocations: all tables and temporary arrays of initialization are carved from the
+ * caller-provided buffer, e.g. a static array in firmware or a sandbox without malloc. The buffer must stay valid until
+ * cpuinfo_deinitialize returns, and the caller frees it afterwards.
+ *
+ * Re-initialization, for example by cpuinfo_reinitialize, keeps the previous tables in the buffer for concurrent
+ * readers, and needs additional space of the size reported by cpuinfo_query_buffer_size. Parallel probing with
+ * CPUINFO_INIT_PARALLEL_PROBING allocates thread stacks, and the topology monitor, samplers, and memory performance
+ * probes keep using the heap. Initialization into a buffer is supported only on Linux.
+ *
+ * @param buffer - memory for the tables, aligned to any boundary.
+ * @param size - size of the buffer in bytes, at least the size returned by cpuinfo_query_buffer_size.
+ * @returns true if cpuinfo was initialized in the buffer, and false if the buffer is too small, cpuinfo is already
+ *          initialized, or the operating system is not supported.
+ */
+bool CPUINFO_ABI cpuinfo_initialize_into(void* buffer, size_t size);
+
+/**
+ * Set the directory where initialization caches the decoded chipset and the MIDR of every processor, e.g. the cache
+ * directory of an Android application. Chipset detection on Android combines /proc/cpuinfo, several system properties,
+ * and heuristics for MIDRs of offline cores, yet gives the same result until the system is updated. Later
+ * initializations read the cache instead, as long as ro.build.fingerprint and the number of processors are unchanged.
+ * The cache is used only on Android, and the directory is ignored elsewhere.
+ *
+ * The function is not thread-safe, and should be called before cpuinfo_initialize.
+ *
+ * @param path - path of an existing directory, or NULL to disable the cache.
+ * @returns true on success, or false if the path is longer than the supported length.
+ */
+bool CPUINFO_ABI cpuinfo_set_chipset_cache_directory(const char* path);
+
+/** Maximum number of entries registered with cpuinfo_register_uarch_table, and with cpuinfo_register_x86_uarch_table */
+#define CPUINFO_UARCH_TABLE_MAX 64
+
+/**
+ * Register microarchitectures and cache parameters of ARM cores by their Main ID Register (MIDR) values, to describe
+ * cores which are newer than this version of cpuinfo, or to correct the built-in tables. Registered entries take
+ * priority over the built-in tables, and entries registered later take priority over earlier ones.
+ *
+ * The table is text with an entry per line, and comments from # to the end of the line:
+ *   <midr> <midr mask> <vendor> <uarch> [<l1i> <l1d> <l2> <l3>]
+ * Numbers are decimal, or hexadecimal with a 0x prefix. An entry matches processors with MIDR bits in the mask equal
+ * to those of the midr value. Vendor and uarch are the values of enum cpuinfo_vendor and enum cpuinfo_uarch.
+ * Caches are size/associativity/line size in bytes, with K or M suffix allowed on the size, or - for no cache. Without
+ * caches, the entry uses the built-in cache parameters of the uarch. For example, to describe Cortex-X925 cores as
+ * Cortex-X3 with their own caches:
+ *   0x410FD850 0xFF0FFFF0 3 0x00300503 64K/4/64 64K/4/64 2M/8/64 -
+ *
+ * The entries are used only on ARM, and only by initialization: the function is not thread-safe, and should be called
+ * before cpuinfo_initialize.
+ *
+ * @param table - text of the table, or NULL to remove all registered entries.
+ * @param size - size of the text in bytes.
+ * @returns true if all entries were registered, or false if the table is malformed or would exceed
+ *          CPUINFO_UARCH_TABLE_MAX entries, and then no entries are registered.
+ */
+bool CPUINFO_ABI cpuinfo_register_uarch_table(const char* table, size_t size);
+
+/**
+ * Register microarchitectures and cache parameters of ARM cores from a file in the format of
+ * cpuinfo_register_uarch_table.
+ *
+ * @param path - path of the file.
+ * @returns true if all entries were registered, or false if the file can't be read or is malformed.
+ */
+bool CPUINFO_ABI cpuinfo_register_uarch_table_file(const char* path);
+
+/**
+ * Register microarchitectures of x86 processors by vendor, family, model, and stepping, to describe processors which
+ * are newer than this version of cpuinfo, or to correct the built-in table. Registered entries take priority over the
+ * built-in table, and entries registered later take priority over earlier ones.
+ *
+ * The table is text with an entry per line, and comments from # to the end of the line:
+ *   <vendor> <family> <models> <steppings> <uarch>
+ * Numbers are decimal, or hexadecimal with a 0x prefix. Vendor and uarch are the values of enum cpuinfo_vendor and
+ * enum cpuinfo_uarch, and family and model include the extended family and model of CPUID. Models and steppings are
+ * a number, or an inclusive range of numbers separated by -. For example, to describe Panther Lake as Lion Cove:
+ *   1 0x06 0xCC 0-15 0x0010020F
+ *
+ * The entries are used only on x86, and only by initialization: the function is not thread-safe, and should be called
+ * before cpuinfo_initialize. On hybrid processors, the entries describe all cores of the models which cpuinfo does not
+ * know.
+ *
+ * @param table - text of the table, or NULL to remove all registered entries.
+ * @param size - size of the text in bytes.
+ * @returns true if all entries were registered, or false if the table is malformed or would exceed
+ *          CPUINFO_UARCH_TABLE_MAX entries, and then no entries are registered.
+ */
+bool CPUINFO_ABI cpuinfo_register_x86_uarch_table(const char* table, size_t size);
+
+/**
+ * Register microarchitectures of x86 processors from a file in the format of cpuinfo_register_x86_uarch_table.
+ *
+ * @param path - path of the file.
+ * @returns true if all entries were registered, or false if the file can't be read or is malformed.
+ */
+bool CPUINFO_ABI cpuinfo_register_x86_uarch_table_file(const char* path);
+
+/** Maximum number of entries registered with cpuinfo_register_chipset_table */
+#define CPUINFO_CHIPSET_TABLE_MAX 64
+
+/**
+ * Register chipsets by the platform identifiers which Linux and Android report for them, to name chipsets which are
+ * newer than this version of cpuinfo, or to correct the built-in decoding. Registered entries take priority over the
+ * built-in signatures and their fixups, and entries registered later take priority over earlier ones.
+ *
+ * The table is text with an entry per line, and comments from # to the end of the line:
+ *   <identifier> <chipset>
+ * The identifier matches, ignoring case, a word of the /proc/cpuinfo Hardware string, or on Android the whole value of
+ * ro.product.board, ro.board.platform, ro.mediatek.platform, ro.arch, ro.chipname, or ro.hardware.chipname. The
+ * chipset is the name of the package as cpuinfo reports it: a known vendor and series, followed by the model number
+ * and an optional suffix of up to 8 characters. For example, to name the SM8750 chipset by its board platform:
+ *   sun Qualcomm Snapdragon 8750
+ *
+ * The entries are used only on ARM Linux and Android, and only by initialization: the function is not thread-safe, and
+ * should be called before cpuinfo_initialize. Vendor and series of the chipset are checked only on ARM Linux and
+ * Android. A chipset saved with cpuinfo_set_chipset_cache_directory is used instead of the entries until the system
+ * is updated.
+ *
+ * @param table - text of the table, or NULL to remove all registered entries.
+ * @param size - size of the text in bytes.
+ * @returns true if all entries were registered, or false if the table is malformed or would exceed
+ *          CPUINFO_CHIPSET_TABLE_MAX entries, and then no entries are registered.
+ */
+bool CPUINFO_ABI cpuinfo_register_chipset_table(const char* table, size_t size);
+
+/**
+ * Register chipsets from a file in the format of cpuinfo_register_chipset_table.
+ *
+ * @param path - path of the file.
+ * @returns true if all entries were registered, or false if the file can't be read or is malformed.
+ */
+bool CPUINFO_ABI cpuinfo_register_chipset_table_file(const char* path);
+
+/** Memory allocator for the tables and the temporary arrays of initialization */
+struct cpuinfo_allocator {
+	/**
+	 * Allocate size bytes aligned to alignment, a power of 2, and return NULL on failure. The memory doesn't need to
+	 * be initialized.
+	 */
+	void* (*allocate)(void* context, size_t size, size_t alignment);
+	/** Free memory returned by allocate; never called with NULL */
+	void (*deallocate)(void* context, void* memory);
+	/** Context passed to the callbacks, e.g. an accounting domain of the subsystem */
+	void* context;
+};
+
+/**
+ * Route memory allocations of initialization through the allocator: the arena of the tables, the temporary arrays of
+ * Linux initialization, and the tables of macOS, Windows, and Emscripten initialization. Samplers, monitors, and
+ * probes created after initialization keep using malloc.
+ *
+ * The allocator can not be changed while cpuinfo is initialized, partially initialized by cpuinfo_initialize_ex,
+ * or being initialized by cpuinfo_initialize_async, since memory of the tables is freed with the allocator which
+ * allocated it.
+ *
+ * @param allocator - allocator with both callbacks set, or NULL to restore the default allocator. The structure is
+ *                    copied.
+ * @returns true on success, or false if cpuinfo is initialized or being initialized, or a callback is missing.
+ */
+bool CPUINFO_ABI cpuinfo_set_allocator(const struct cpuinfo_allocator* allocator);
+
+/** File operations on files of procfs and sysfs, e.g. forwarded to a broker of a sandbox */
+struct cpuinfo_file_ops {
+	/** Open a file by absolute path with open() flags, and return its descriptor, or -1 with errno set on failure */
+	int (*open)(void* context, const char* path, int flags);
+	/** Read up to size bytes, and return the number of bytes read, 0 at the end of file, or -1 with errno set */
+	ptrdiff_t (*read)(void* context, int file, void* buffer, size_t size);
+	/** Close a descriptor returned by open */
+	void (*close)(void* context, int file);
+	/** Context passed to the callbacks */
+	void* context;
+};
+
+/**
+ * Route reads of procfs and sysfs files during Linux initialization through the file operations, including the
+ * per-processor files of /sys/devices/system/cpu, which are then opened by absolute path rather than relative to
+ * cached directory descriptors. Listings of directories and the auxiliary vector still use the system. With
+ * CPUINFO_INIT_PARALLEL_PROBING, the callbacks are invoked concurrently from several threads.
+ * cpuinfo_set_energy_performance_preference also opens its sysfs file through the file operations, and writes to the
+ * returned descriptor.
+ *
+ * File operations can not be changed while cpuinfo is initialized, partially initialized by
+ * cpuinfo_initialize_ex, or being initialized by cpuinfo_initialize_async. File operations are ignored on other
+ * operating systems.
+ *
+ * @param ops - file operations with all callbacks set, or NULL to restore the system calls. The structure is copied.
+ * @returns true on success, or false if cpuinfo is initialized or being initialized, or a callback is missing.
+ */
+bool CPUINFO_ABI cpuinfo_set_file_ops(const struct cpuinfo_file_ops* ops);
+
+/** Severity of a log message of cpuinfo */
+enum cpuinfo_log_level {
+	/** No messages */
+	cpuinfo_log_level_none = 0,
+	/** Errors after which cpuinfo aborts the process */
+	cpuinfo_log_level_fatal = 1,
+	/** Failures which leave some information undetected */
+	cpuinfo_log_level_error = 2,
+	/** Unexpected data which cpuinfo worked around */
+	cpuinfo_log_level_warning = 3,
+	/** Notable facts about the system */
+	cpuinfo_log_level_info = 4,
+	/** Details of parsing and detection */
+	cpuinfo_log_level_debug = 5,
+};
+
+/**
+ * Receiver of log messages. The message is delivered unformatted, as a printf format and its arguments, so that the
+ * receiver decides whether and where to format it. The arguments are valid only during the call: a receiver which
+ * defers the work, e.g. to an asynchronous logger, must format or copy them before returning. The callback may be
+ * invoked concurrently from several threads, and must not call cpuinfo functions.
+ */
+typedef void (*cpuinfo_log_callback)(void* context, enum cpuinfo_log_level level, const char* format, va_list args);
+
+/**
+ * Set the most verbose level of messages which cpuinfo logs. Messages above the level are dropped before any
+ * formatting. Levels above the CPUINFO_LOG_LEVEL which cpuinfo was built with have no effect, as messages above it
+ * are not compiled in. The default level is CPUINFO_LOG_LEVEL.
+ *
+ * The function is not thread-safe with concurrent logging, and should be called before cpuinfo_initialize.
+ *
+ * @param level - the most verbose level to log.
+ * @returns true on success, or false if the level is not a valid cpuinfo_log_level.
+ */
+bool CPUINFO_ABI cpuinfo_set_log_level(enum cpuinfo_log_level level);
+
+/**
+ * Deliver log messages to the callback instead of the standard output and error streams, or the Android log. Only
+ * messages within the level set by cpuinfo_set_log_level reach the callback. Fatal messages abort the process after
+ * the callback returns.
+ *
+ * The function is not thread-safe with concurrent logging, and should be called before cpuinfo_initialize.
+ *
+ * @param callback - receiver of messages, or NULL to restore the default output.
+ * @param context - context passed to the callback.
+ */
+void CPUINFO_ABI cpuinfo_set_log_callback(cpuinfo_log_callback callback, void* context);
+
+/**
+ * If non-zero, cpuinfo_has_* functions return constant true for ISA features which the compiler targets in the
+ * translation unit, e.g. for AVX2 with -mavx2, or for dot product with -march=armv8.2-a+dotprod. Code compiled for
+ * these features can't run on processors without them anyway, and checks for them fold away. Define to 0 before
+ * including cpuinfo.h to always return the detected features.
+ */
+#ifndef CPUINFO_COMPILE_TIME_ISA
+	#define CPUINFO_COMPILE_TIME_ISA 1
+#endif
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* This structure is not a part of stable API. Use cpuinfo_has_x86_* functions instead. */
+	struct cpuinfo_x86_isa {
+		#if CPUINFO_ARCH_X86
+			bool rdtsc;
+		#endif
+		bool rdtscp;
+		bool rdpid;
+		bool sysenter;
+		#if CPUINFO_ARCH_X86
+			bool syscall;
+		#endif
+		bool msr;
+		bool clzero;
+		bool clflush;
+		bool clflushopt;
+		bool mwait;
+		bool mwaitx;
+		bool waitpkg;
+		#if CPUINFO_ARCH_X86
+			bool emmx;
+		#endif
+		bool fxsave;
+		bool xsave;
+		#if CPUINFO_ARCH_X86
+			bool fpu;
+			bool mmx;
+			bool mmx_plus;
+		#endif
+		bool three_d_now;
+		bool three_d_now_plus;
+		#if CPUINFO_ARCH_X86
+			bool three_d_now_geode;
+		#endif
+		bool prefetch;
+		bool prefetchw;
+		bool prefetchwt1;
+		#if CPUINFO_ARCH_X86
+			bool daz;
+			bool sse;
+			bool sse2;
+		#endif
+		bool sse3;
+		bool ssse3;
+		bool sse4_1;
+		bool sse4_2;
+		bool sse4a;
+		bool misaligned_sse;
+		bool avx;
+		bool fma3;
+		bool fma4;
+		bool xop;
+		bool f16c;
+		bool avx2;
+		bool avxvnni;
+		bool avxvnniint8;
+		bool avxvnniint16;
+		bool avxifma;
+		bool avxneconvert;
+		bool avx512f;
+		bool avx512pf;
+		bool avx512er;
+		bool avx512cd;
+		bool avx512dq;
+		bool avx512bw;
+		bool avx512vl;
+		bool avx512ifma;
+		bool avx512vbmi;
+		bool avx512vbmi2;
+		bool avx512bitalg;
+		bool avx512vpopcntdq;
+		bool avx512vnni;
+		bool avx512bf16;
+		bool avx512fp16;
+		#if CPUINFO_ARCH_X86_64
+			bool amx_tile;
+			bool amx_int8;
+			bool amx_bf16;
+			bool amx_fp16;
+			bool amx_complex;
+			bool apx;
+		#endif
+		bool avx512vp2intersect;
+		bool avx512_4vnniw;
+		bool avx512_4fmaps;
+		bool hle;
+		bool rtm;
+		bool xtest;
+		bool mpx;
+		#if CPUINFO_ARCH_X86
+			bool cmov;
+			bool cmpxchg8b;
+		#endif
+		bool cmpxchg16b;
+		bool clwb;
+		bool cldemote;
+		bool movdiri;
+		bool movdir64b;
+		bool enqcmd;
+		bool serialize;
+		bool hreset;
+		bool uintr;
+		bool movbe;
+		bool erms;
+		bool fsrm;
+		bool fzrm;
+		bool fsrs;
+		bool fsrc;
+		#if CPUINFO_ARCH_X86_64
+			bool lahf_sahf;
+		#endif
+		bool fs_gs_base;
+		bool lzcnt;
+		bool popcnt;
+		bool tbm;
+		bool bmi;
+		bool bmi2;
+		bool adx;
+		bool aes;
+		bool vaes;
+		bool pclmulqdq;
+		bool vpclmulqdq;
+		bool gfni;
+		bool rdrand;
+		bool rdseed;
+		bool sha;
+		bool rng;
+		bool ace;
+		bool ace2;
+		bool phe;
+		bool pmm;
+		bool lwp;
+		uint32_t avx10_version;
+		uint32_t avx10_max_vector_bits;
+		uint32_t x86_64_level;
+	};
+
+	extern struct cpuinfo_x86_isa cpuinfo_isa;
+#endif
+
+/** Returns the version of AVX10 instructions supported by the processor and the OS, or 0 if AVX10 is unsupported */
+static inline uint32_t cpuinfo_get_x86_avx10_version(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx10_version;
+	#else
+		return 0;
+	#endif
+}
+
+/**
+ * Returns the maximum vector width in bits (128, 256, or 512) of AVX10 instructions, or 0 if AVX10 is unsupported.
+ * AVX512 functions return false on processors whose AVX10 is limited to 256-bit vectors.
+ */
+static inline uint32_t cpuinfo_get_x86_avx10_max_vector_bits(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx10_max_vector_bits;
+	#else
+		return 0;
+	#endif
+}
+
+/**
+ * Requests permission to use AMX tile data registers in the process. On Linux, which disables the tile data state
+ * through XFD until the process requests it, this calls arch_prctl(ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) unless
+ * the permission was already granted. On other systems no permission is needed.
+ *
+ * @returns true if the processor supports AMX and the process can use it, false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_request_x86_amx_permission(void);
+
+/**
+ * Returns the highest x86-64 microarchitecture level (1 for x86-64 baseline, 2 for x86-64-v2, 3 for x86-64-v3, 4 for
+ * x86-64-v4 as defined in the x86-64 psABI) which the processor and the operating system support, or 0 on processors
+ * without x86-64 support and on other architectures. Levels 3 and 4 require the OS to enable AVX and AVX-512 state.
+ */
+static inline uint32_t cpuinfo_get_x86_64_level(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.x86_64_level;
+	#else
+		return 0;
+	#endif
+}
+
+/** Checks if the processor and the operating system support the x86-64 microarchitecture level, from 1 to 4 */
+static inline bool cpuinfo_has_x86_64_level(uint32_t level) {
+	return level != 0 && cpuinfo_get_x86_64_level() >= level;
+}
+
+static inline bool cpuinfo_has_x86_rdtsc(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__)
+			return true;
+		#else
+			return cpuinfo_isa.rdtsc;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_rdtscp(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.rdtscp;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_rdpid(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.rdpid;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_clzero(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.clzero;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_mwait(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.mwait;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_mwaitx(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.mwaitx;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_waitpkg(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.waitpkg;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fxsave(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.fxsave;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_xsave(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.xsave;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fpu(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__)
+			return true;
+		#else
+			return cpuinfo_isa.fpu;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_mmx(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__)
+			return true;
+		#else
+			return cpuinfo_isa.mmx;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_mmx_plus(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__)
+			return true;
+		#else
+			return cpuinfo_isa.mmx_plus;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_3dnow(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.three_d_now;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_3dnow_plus(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.three_d_now_plus;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_3dnow_geode(void) {
+	#if CPUINFO_ARCH_X86_64
+		return false;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__)
+			return false;
+		#else
+			return cpuinfo_isa.three_d_now_geode;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_prefetch(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.prefetch;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_prefetchw(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.prefetchw;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_prefetchwt1(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.prefetchwt1;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_daz(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__)
+			return true;
+		#else
+			return cpuinfo_isa.daz;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sse(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__SSE__))
+			return true;
+		#else
+			return cpuinfo_isa.sse;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sse2(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__SSE2__))
+			return true;
+		#else
+			return cpuinfo_isa.sse2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sse3(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__SSE3__))
+			return true;
+		#else
+			return cpuinfo_isa.sse3;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_ssse3(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__SSSE3__))
+			return true;
+		#else
+			return cpuinfo_isa.ssse3;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sse4_1(void) {
+	#if CPUINFO_ARCH_X86_64
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__SSE4_1__))
+			return true;
+		#else
+			return cpuinfo_isa.sse4_1;
+		#endif
+	#elif CPUINFO_ARCH_X86
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__SSE4_1__)
+			return true;
+		#else
+			return cpuinfo_isa.sse4_1;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sse4_2(void) {
+	#if CPUINFO_ARCH_X86_64
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__SSE4_2__))
+			return true;
+		#else
+			return cpuinfo_isa.sse4_2;
+		#endif
+	#elif CPUINFO_ARCH_X86
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__SSE4_2__)
+			return true;
+		#else
+			return cpuinfo_isa.sse4_2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sse4a(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.sse4a;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_misaligned_sse(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.misaligned_sse;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX__)
+			return true;
+		#else
+			return cpuinfo_isa.avx;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fma3(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__FMA__)
+			return true;
+		#else
+			return cpuinfo_isa.fma3;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fma4(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.fma4;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_xop(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.xop;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_f16c(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__F16C__)
+			return true;
+		#else
+			return cpuinfo_isa.f16c;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx2(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX2__)
+			return true;
+		#else
+			return cpuinfo_isa.avx2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avxvnni(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVXVNNI__)
+			return true;
+		#else
+			return cpuinfo_isa.avxvnni;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avxvnniint8(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avxvnniint8;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avxvnniint16(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avxvnniint16;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avxifma(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avxifma;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avxneconvert(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avxneconvert;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512f(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512F__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512f;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512pf(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx512pf;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512er(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx512er;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512cd(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512CD__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512cd;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512dq(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512DQ__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512dq;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512bw(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512BW__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512bw;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512vl(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512VL__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512vl;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512ifma(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512IFMA__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512ifma;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512vbmi(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512VBMI__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512vbmi;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512vbmi2(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512VBMI2__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512vbmi2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512bitalg(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512BITALG__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512bitalg;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512vpopcntdq(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512VPOPCNTDQ__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512vpopcntdq;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512vnni(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512VNNI__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512vnni;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512bf16(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512BF16__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512bf16;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512fp16(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AVX512FP16__)
+			return true;
+		#else
+			return cpuinfo_isa.avx512fp16;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_apx(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.apx;
+	#else
+		return false;
+	#endif
+}
+
+/**
+ * AMX functions check that the processor supports the instructions, and that the OS enabled tile state in XCR0.
+ * On Linux, processes must also call cpuinfo_request_x86_amx_permission before using tile data registers.
+ */
+static inline bool cpuinfo_has_x86_amx_tile(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.amx_tile;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_amx_int8(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.amx_int8;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_amx_bf16(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.amx_bf16;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_amx_fp16(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.amx_fp16;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_amx_complex(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.amx_complex;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512vp2intersect(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx512vp2intersect;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512_4vnniw(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx512_4vnniw;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_avx512_4fmaps(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.avx512_4fmaps;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_hle(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.hle;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_rtm(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.rtm;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_xtest(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.xtest;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_mpx(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.mpx;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_cmov(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		return cpuinfo_isa.cmov;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_cmpxchg8b(void) {
+	#if CPUINFO_ARCH_X86_64
+		return true;
+	#elif CPUINFO_ARCH_X86
+		return cpuinfo_isa.cmpxchg8b;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_cmpxchg16b(void) {
+	#if CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.cmpxchg16b;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_clwb(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.clwb;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_cldemote(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.cldemote;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_movdiri(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.movdiri;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_movdir64b(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.movdir64b;
+	#else
+		return false;
+	#endif
+}
+
+/**
+ * Returns true if the processor supports ENQCMD. Submission to a shared work queue also needs a PASID of the process,
+ * which Linux allocates when the process binds a device through the IOMMU SVA API, e.g. by opening an idxd device.
+ */
+static inline bool cpuinfo_has_x86_enqcmd(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.enqcmd;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_serialize(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.serialize;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_hreset(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.hreset;
+	#else
+		return false;
+	#endif
+}
+
+/**
+ * Returns true if the processor supports user interrupts. Receiving and sending them also needs support of the kernel,
+ * which enables the UINTR state component of XSAVE and provides the system calls to register handlers and targets.
+ */
+static inline bool cpuinfo_has_x86_uintr(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.uintr;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_movbe(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__MOVBE__)
+			return true;
+		#else
+			return cpuinfo_isa.movbe;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_erms(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.erms;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fsrm(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.fsrm;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fzrm(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.fzrm;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fsrs(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.fsrs;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_fsrc(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.fsrc;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_lahf_sahf(void) {
+	#if CPUINFO_ARCH_X86
+		return true;
+	#elif CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.lahf_sahf;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_lzcnt(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__LZCNT__)
+			return true;
+		#else
+			return cpuinfo_isa.lzcnt;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_popcnt(void) {
+	#if CPUINFO_ARCH_X86_64
+		#if defined(__ANDROID__) || (CPUINFO_COMPILE_TIME_ISA && defined(__POPCNT__))
+			return true;
+		#else
+			return cpuinfo_isa.popcnt;
+		#endif
+	#elif CPUINFO_ARCH_X86
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__POPCNT__)
+			return true;
+		#else
+			return cpuinfo_isa.popcnt;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_tbm(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_isa.tbm;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_bmi(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__BMI__)
+			return true;
+		#else
+			return cpuinfo_isa.bmi;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_bmi2(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__BMI2__)
+			return true;
+		#else
+			return cpuinfo_isa.bmi2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_adx(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ADX__)
+			return true;
+		#else
+			return cpuinfo_isa.adx;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_aes(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__AES__)
+			return true;
+		#else
+			return cpuinfo_isa.aes;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_vaes(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__VAES__)
+			return true;
+		#else
+			return cpuinfo_isa.vaes;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_pclmulqdq(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__PCLMUL__)
+			return true;
+		#else
+			return cpuinfo_isa.pclmulqdq;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_vpclmulqdq(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__VPCLMULQDQ__)
+			return true;
+		#else
+			return cpuinfo_isa.vpclmulqdq;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_gfni(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__GFNI__)
+			return true;
+		#else
+			return cpuinfo_isa.gfni;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_rdrand(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__RDRND__)
+			return true;
+		#else
+			return cpuinfo_isa.rdrand;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_rdseed(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__RDSEED__)
+			return true;
+		#else
+			return cpuinfo_isa.rdseed;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_x86_sha(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__SHA__)
+			return true;
+		#else
+			return cpuinfo_isa.sha;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+	/* This structure is not a part of stable API. Use cpuinfo_has_arm_* functions instead. */
+	struct cpuinfo_arm_isa {
+		#if CPUINFO_ARCH_ARM
+			bool thumb;
+			bool thumb2;
+			bool thumbee;
+			bool jazelle;
+			bool armv5e;
+			bool armv6;
+			bool armv6k;
+			bool armv7;
+			bool armv7mp;
+			bool armv8;
+			bool idiv;
+
+			bool vfpv2;
+			bool vfpv3;
+			bool d32;
+			bool fp16;
+			bool fma;
+
+			bool wmmx;
+			bool wmmx2;
+			bool neon;
+		#endif
+		#if CPUINFO_ARCH_ARM64
+			bool atomics;
+			bool lse2;
+			bool lse128;
+			bool rcpc;
+			bool rcpc2;
+			bool rcpc3;
+			bool wfxt;
+			bool mte;
+			bool mte2;
+			bool mte3;
+			bool pauth;
+			bool bti;
+			bool bf16;
+			bool sve;
+			bool sve2;
+			bool i8mm;
+			bool sme;
+			bool sme2;
+			bool sme_f64f64;
+			bool sme_i16i64;
+			bool sme_fa64;
+			bool sha3;
+			bool sha512;
+			bool sm3;
+			bool sm4;
+			bool rng;
+		#endif
+		bool rdm;
+		bool fp16arith;
+		bool dot;
+		bool jscvt;
+		bool fcma;
+		bool fhm;
+
+		bool aes;
+		bool sha1;
+		bool sha2;
+		bool pmull;
+		bool crc32;
+	};
+
+	extern struct cpuinfo_arm_isa cpuinfo_isa;
+#endif
+
+static inline bool cpuinfo_has_arm_thumb(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.thumb;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_thumb2(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.thumb2;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_v5e(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.armv5e;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_v6(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.armv6;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_v6k(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.armv6k;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_v7(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.armv7;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_v7mp(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.armv7mp;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_v8(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.armv8;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_idiv(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.idiv;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv2(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv2;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv3(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv3;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv3_d32(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv3 && cpuinfo_isa.d32;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv3_fp16(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fp16;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv3_fp16_d32(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fp16 && cpuinfo_isa.d32;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv4(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fma;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_vfpv4_d32(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fma && cpuinfo_isa.d32;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_fp16_arith(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_FP16_SCALAR_ARITHMETIC)
+			return true;
+		#else
+			return cpuinfo_isa.fp16arith;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_bf16(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_BF16_SCALAR_ARITHMETIC)
+			return true;
+		#else
+			return cpuinfo_isa.bf16;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_wmmx(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.wmmx;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_wmmx2(void) {
+	#if CPUINFO_ARCH_ARM
+		return cpuinfo_isa.wmmx2;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_NEON)
+			return true;
+		#else
+			return cpuinfo_isa.neon;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon_fp16(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.neon && cpuinfo_isa.fp16;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon_fma(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_NEON) && defined(__ARM_FEATURE_FMA)
+			return true;
+		#else
+			return cpuinfo_isa.neon && cpuinfo_isa.fma;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon_v8(void) {
+	#if CPUINFO_ARCH_ARM64
+		return true;
+	#elif CPUINFO_ARCH_ARM
+		return cpuinfo_isa.neon && cpuinfo_isa.armv8;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_atomics(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_ATOMICS)
+			return true;
+		#else
+			return cpuinfo_isa.atomics;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_lse2(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.lse2;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_lse128(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.lse128;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_rcpc(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.rcpc;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_rcpc2(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.rcpc2;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_rcpc3(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.rcpc3;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_wfxt(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.wfxt;
+	#else
+		return false;
+	#endif
+}
+
+/** Checks if the processor supports MTE instructions (FEAT_MTE), which don't check tags without FEAT_MTE2 */
+static inline bool cpuinfo_has_arm_mte(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.mte;
+	#else
+		return false;
+	#endif
+}
+
+/** Checks if the processor and the OS support memory tagging with tag checks (FEAT_MTE2), i.e. HWCAP2_MTE on Linux */
+static inline bool cpuinfo_has_arm_mte2(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.mte2;
+	#else
+		return false;
+	#endif
+}
+
+/** Checks if the processor supports asymmetric tag checks of MTE (FEAT_MTE3) */
+static inline bool cpuinfo_has_arm_mte3(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.mte3;
+	#else
+		return false;
+	#endif
+}
+
+/** Checks if the processor supports pointer authentication of addresses (FEAT_PAuth), e.g. PACIASP and AUTIASP */
+static inline bool cpuinfo_has_arm_pauth(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.pauth;
+	#else
+		return false;
+	#endif
+}
+
+/** Checks if the processor supports branch target identification (FEAT_BTI) */
+static inline bool cpuinfo_has_arm_bti(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.bti;
+	#else
+		return false;
+	#endif
+}
+
+/** Size of memory regions which share an allocation tag of MTE, in bytes */
+#define CPUINFO_ARM_MTE_GRANULE_SIZE 16
+
+/** Tag check mode of the Memory Tagging Extension for a thread */
+enum cpuinfo_arm_mte_mode {
+	/** Tag checks are unavailable: no FEAT_MTE2, no OS support, or tagged addresses are disabled in the thread */
+	cpuinfo_arm_mte_mode_unavailable = 0,
+	/** Tagged addresses are enabled, but tag check faults are ignored */
+	cpuinfo_arm_mte_mode_none = 1,
+	/** Tag check faults are raised precisely on the faulting access, which costs the most throughput */
+	cpuinfo_arm_mte_mode_sync = 2,
+	/** Tag check faults are accumulated and reported later, on the next entry to the kernel */
+	cpuinfo_arm_mte_mode_async = 3,
+	/** Loads check tags synchronously and stores asynchronously (FEAT_MTE3) */
+	cpuinfo_arm_mte_mode_asymmetric = 4,
+};
+
+/**
+ * Returns the tag check mode of MTE in the calling thread, which Linux reports in prctl(PR_GET_TAGGED_ADDR_CTRL).
+ * If the thread allows several modes, Linux applies the preferred mode of the processor in
+ * /sys/devices/system/cpu/cpu<N>/mte_tcf_preferred, and the mode of the current processor is returned.
+ *
+ * @returns the tag check mode, or cpuinfo_arm_mte_mode_unavailable on other systems and architectures.
+ */
+enum cpuinfo_arm_mte_mode CPUINFO_ABI cpuinfo_get_arm_mte_mode(void);
+
+static inline bool cpuinfo_has_arm_neon_rdm(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_QRDMX)
+			return true;
+		#else
+			return cpuinfo_isa.rdm;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon_fp16_arith(void) {
+	#if CPUINFO_ARCH_ARM
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+			return true;
+		#else
+			return cpuinfo_isa.neon && cpuinfo_isa.fp16arith;
+		#endif
+	#elif CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+			return true;
+		#else
+			return cpuinfo_isa.fp16arith;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_fhm(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_FP16_FML)
+			return true;
+		#else
+			return cpuinfo_isa.fhm;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon_dot(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_DOTPROD)
+			return true;
+		#else
+			return cpuinfo_isa.dot;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_neon_bf16(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_BF16_VECTOR_ARITHMETIC)
+			return true;
+		#else
+			return cpuinfo_isa.bf16;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_jscvt(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_JCVT)
+			return true;
+		#else
+			return cpuinfo_isa.jscvt;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_fcma(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_COMPLEX)
+			return true;
+		#else
+			return cpuinfo_isa.fcma;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_i8mm(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_MATMUL_INT8)
+			return true;
+		#else
+			return cpuinfo_isa.i8mm;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_aes(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+			return true;
+		#else
+			return cpuinfo_isa.aes;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sha1(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+			return true;
+		#else
+			return cpuinfo_isa.sha1;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sha2(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+			return true;
+		#else
+			return cpuinfo_isa.sha2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_pmull(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+			return true;
+		#else
+			return cpuinfo_isa.pmull;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sha3(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SHA3)
+			return true;
+		#else
+			return cpuinfo_isa.sha3;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sha512(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SHA512)
+			return true;
+		#else
+			return cpuinfo_isa.sha512;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sm3(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SM3)
+			return true;
+		#else
+			return cpuinfo_isa.sm3;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sm4(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SM4)
+			return true;
+		#else
+			return cpuinfo_isa.sm4;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_rng(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_RNG)
+			return true;
+		#else
+			return cpuinfo_isa.rng;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_crc32(void) {
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_CRC32)
+			return true;
+		#else
+			return cpuinfo_isa.crc32;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sve(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SVE)
+			return true;
+		#else
+			return cpuinfo_isa.sve;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sve_bf16(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.sve && cpuinfo_isa.bf16;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sve2(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SVE2)
+			return true;
+		#else
+			return cpuinfo_isa.sve2;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sme(void) {
+	#if CPUINFO_ARCH_ARM64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__ARM_FEATURE_SME)
+			return true;
+		#else
+			return cpuinfo_isa.sme;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sme2(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.sme2;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sme_f64f64(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.sme_f64f64;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sme_i16i64(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.sme_i16i64;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_arm_sme_fa64(void) {
+	#if CPUINFO_ARCH_ARM64
+		return cpuinfo_isa.sme_fa64;
+	#else
+		return false;
+	#endif
+}
+
+#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+	/* This structure is not a part of stable API. Use cpuinfo_has_riscv_* functions instead. */
+	struct cpuinfo_riscv_isa {
+		bool i;
+		bool m;
+		bool a;
+		bool f;
+		bool d;
+		bool c;
+		bool v;
+
+		bool zba;
+		bool zbb;
+		bool zbc;
+		bool zbs;
+		bool zicboz;
+		bool zicond;
+
+		bool zfh;
+		bool zfhmin;
+
+		bool zvbb;
+		bool zvbc;
+		bool zvfh;
+	};
+
+	extern struct cpuinfo_riscv_isa cpuinfo_isa;
+#endif
+
+static inline bool cpuinfo_has_riscv_i(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.i;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_m(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.m;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_a(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.a;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_f(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.f;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_d(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.d;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_c(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.c;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_v(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__riscv_v)
+			return true;
+		#else
+			return cpuinfo_isa.v;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zba(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zba;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zbb(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zbb;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zbc(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zbc;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zbs(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zbs;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zicboz(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zicboz;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zicond(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zicond;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zfh(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zfh;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zfhmin(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zfhmin;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zvbb(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zvbb;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zvbc(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zvbc;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_riscv_zvfh(void) {
+	#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_isa.zvfh;
+	#else
+		return false;
+	#endif
+}
+
+#if CPUINFO_ARCH_LOONGARCH64
+	/* This structure is not a part of stable API. Use cpuinfo_has_loongarch_* functions instead. */
+	struct cpuinfo_loongarch_isa {
+		bool fpu;
+		bool lsx;
+		bool lasx;
+
+		bool crc32;
+		bool lam;
+		bool lam_bh;
+		bool ual;
+
+		bool complex;
+		bool crypto;
+		bool frecipe;
+
+		bool lbt_x86;
+		bool lbt_arm;
+		bool lbt_mips;
+	};
+
+	extern struct cpuinfo_loongarch_isa cpuinfo_isa;
+#endif
+
+static inline bool cpuinfo_has_loongarch_fpu(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.fpu;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lsx(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__loongarch_sx)
+			return true;
+		#else
+			return cpuinfo_isa.lsx;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lasx(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		#if CPUINFO_COMPILE_TIME_ISA && defined(__loongarch_asx)
+			return true;
+		#else
+			return cpuinfo_isa.lasx;
+		#endif
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_crc32(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.crc32;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lam(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.lam;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lam_bh(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.lam_bh;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_ual(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.ual;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_complex(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.complex;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_crypto(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.crypto;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_frecipe(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.frecipe;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lbt_x86(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.lbt_x86;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lbt_arm(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.lbt_arm;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_loongarch_lbt_mips(void) {
+	#if CPUINFO_ARCH_LOONGARCH64
+		return cpuinfo_isa.lbt_mips;
+	#else
+		return false;
+	#endif
+}
+
+#if CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+	/*
+	 * This structure is not a part of stable API. Use cpuinfo_has_wasm_* functions instead.
+	 * Features are probed at run time, and may differ from the features which the module was compiled for.
+	 */
+	struct cpuinfo_wasm_isa {
+		bool simd128;
+		bool relaxed_simd;
+		bool threads;
+		bool memory64;
+	};
+
+	extern struct cpuinfo_wasm_isa cpuinfo_isa;
+#endif
+
+static inline bool cpuinfo_has_wasm_simd128(void) {
+	#if CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+		return cpuinfo_isa.simd128;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_wasm_relaxed_simd(void) {
+	#if CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+		return cpuinfo_isa.relaxed_simd;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_wasm_threads(void) {
+	#if CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+		return cpuinfo_isa.threads;
+	#else
+		return false;
+	#endif
+}
+
+static inline bool cpuinfo_has_wasm_memory64(void) {
+	#if CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+		return cpuinfo_isa.memory64;
+	#else
+		return false;
+	#endif
+}
+
+/**
+ * Identifiers of ISA features in cpuinfo_isa_features bitsets. Every cpuinfo_has_x86_* and cpuinfo_has_arm_* function
+ * has an identifier. Identifiers are stable: new features get new values, and values are never reused.
+ */
+enum cpuinfo_isa_feature {
+	cpuinfo_isa_feature_x86_rdtsc = 0,
+	cpuinfo_isa_feature_x86_rdtscp,
+	cpuinfo_isa_feature_x86_rdpid,
+	cpuinfo_isa_feature_x86_clzero,
+	cpuinfo_isa_feature_x86_mwait,
+	cpuinfo_isa_feature_x86_mwaitx,
+	cpuinfo_isa_feature_x86_fxsave,
+	cpuinfo_isa_feature_x86_xsave,
+	cpuinfo_isa_feature_x86_fpu,
+	cpuinfo_isa_feature_x86_mmx,
+	cpuinfo_isa_feature_x86_mmx_plus,
+	cpuinfo_isa_feature_x86_3dnow,
+	cpuinfo_isa_feature_x86_3dnow_plus,
+	cpuinfo_isa_feature_x86_3dnow_geode,
+	cpuinfo_isa_feature_x86_prefetch,
+	cpuinfo_isa_feature_x86_prefetchw,
+	cpuinfo_isa_feature_x86_prefetchwt1,
+	cpuinfo_isa_feature_x86_daz,
+	cpuinfo_isa_feature_x86_sse,
+	cpuinfo_isa_feature_x86_sse2,
+	cpuinfo_isa_feature_x86_sse3,
+	cpuinfo_isa_feature_x86_ssse3,
+	cpuinfo_isa_feature_x86_sse4_1,
+	cpuinfo_isa_feature_x86_sse4_2,
+	cpuinfo_isa_feature_x86_sse4a,
+	cpuinfo_isa_feature_x86_misaligned_sse,
+	cpuinfo_isa_feature_x86_avx,
+	cpuinfo_isa_feature_x86_fma3,
+	cpuinfo_isa_feature_x86_fma4,
+	cpuinfo_isa_feature_x86_xop,
+	cpuinfo_isa_feature_x86_f16c,
+	cpuinfo_isa_feature_x86_avx2,
+	cpuinfo_isa_feature_x86_avx512f,
+	cpuinfo_isa_feature_x86_avx512pf,
+	cpuinfo_isa_feature_x86_avx512er,
+	cpuinfo_isa_feature_x86_avx512cd,
+	cpuinfo_isa_feature_x86_avx512dq,
+	cpuinfo_isa_feature_x86_avx512bw,
+	cpuinfo_isa_feature_x86_avx512vl,
+	cpuinfo_isa_feature_x86_avx512ifma,
+	cpuinfo_isa_feature_x86_avx512vbmi,
+	cpuinfo_isa_feature_x86_avx512vbmi2,
+	cpuinfo_isa_feature_x86_avx512bitalg,
+	cpuinfo_isa_feature_x86_avx512vpopcntdq,
+	cpuinfo_isa_feature_x86_avx512vnni,
+	cpuinfo_isa_feature_x86_avx512bf16,
+	cpuinfo_isa_feature_x86_avx512fp16,
+	cpuinfo_isa_feature_x86_apx,
+	cpuinfo_isa_feature_x86_amx_tile,
+	cpuinfo_isa_feature_x86_amx_int8,
+	cpuinfo_isa_feature_x86_amx_bf16,
+	cpuinfo_isa_feature_x86_amx_fp16,
+	cpuinfo_isa_feature_x86_amx_complex,
+	cpuinfo_isa_feature_x86_avx512vp2intersect,
+	cpuinfo_isa_feature_x86_avx512_4vnniw,
+	cpuinfo_isa_feature_x86_avx512_4fmaps,
+	cpuinfo_isa_feature_x86_hle,
+	cpuinfo_isa_feature_x86_rtm,
+	cpuinfo_isa_feature_x86_xtest,
+	cpuinfo_isa_feature_x86_mpx,
+	cpuinfo_isa_feature_x86_cmov,
+	cpuinfo_isa_feature_x86_cmpxchg8b,
+	cpuinfo_isa_feature_x86_cmpxchg16b,
+	cpuinfo_isa_feature_x86_clwb,
+	cpuinfo_isa_feature_x86_movbe,
+	cpuinfo_isa_feature_x86_erms,
+	cpuinfo_isa_feature_x86_fsrm,
+	cpuinfo_isa_feature_x86_fzrm,
+	cpuinfo_isa_feature_x86_fsrs,
+	cpuinfo_isa_feature_x86_fsrc,
+	cpuinfo_isa_feature_x86_lahf_sahf,
+	cpuinfo_isa_feature_x86_lzcnt,
+	cpuinfo_isa_feature_x86_popcnt,
+	cpuinfo_isa_feature_x86_tbm,
+	cpuinfo_isa_feature_x86_bmi,
+	cpuinfo_isa_feature_x86_bmi2,
+	cpuinfo_isa_feature_x86_adx,
+	cpuinfo_isa_feature_x86_aes,
+	cpuinfo_isa_feature_x86_vaes,
+	cpuinfo_isa_feature_x86_pclmulqdq,
+	cpuinfo_isa_feature_x86_vpclmulqdq,
+	cpuinfo_isa_feature_x86_gfni,
+	cpuinfo_isa_feature_x86_rdrand,
+	cpuinfo_isa_feature_x86_rdseed,
+	cpuinfo_isa_feature_x86_sha,
+	cpuinfo_isa_feature_x86_avxvnni,
+	cpuinfo_isa_feature_x86_avxvnniint8,
+	cpuinfo_isa_feature_x86_avxvnniint16,
+	cpuinfo_isa_feature_x86_avxifma,
+	cpuinfo_isa_feature_x86_avxneconvert,
+	cpuinfo_isa_feature_x86_waitpkg,
+	cpuinfo_isa_feature_x86_cldemote,
+	cpuinfo_isa_feature_x86_movdiri,
+	cpuinfo_isa_feature_x86_movdir64b,
+	cpuinfo_isa_feature_x86_enqcmd,
+	cpuinfo_isa_feature_x86_serialize,
+	cpuinfo_isa_feature_x86_hreset,
+	cpuinfo_isa_feature_x86_uintr,
+	cpuinfo_isa_feature_arm_thumb = 128,
+	cpuinfo_isa_feature_arm_thumb2,
+	cpuinfo_isa_feature_arm_v5e,
+	cpuinfo_isa_feature_arm_v6,
+	cpuinfo_isa_feature_arm_v6k,
+	cpuinfo_isa_feature_arm_v7,
+	cpuinfo_isa_feature_arm_v7mp,
+	cpuinfo_isa_feature_arm_v8,
+	cpuinfo_isa_feature_arm_idiv,
+	cpuinfo_isa_feature_arm_vfpv2,
+	cpuinfo_isa_feature_arm_vfpv3,
+	cpuinfo_isa_feature_arm_vfpv3_d32,
+	cpuinfo_isa_feature_arm_vfpv3_fp16,
+	cpuinfo_isa_feature_arm_vfpv3_fp16_d32,
+	cpuinfo_isa_feature_arm_vfpv4,
+	cpuinfo_isa_feature_arm_vfpv4_d32,
+	cpuinfo_isa_feature_arm_fp16_arith,
+	cpuinfo_isa_feature_arm_bf16,
+	cpuinfo_isa_feature_arm_wmmx,
+	cpuinfo_isa_feature_arm_wmmx2,
+	cpuinfo_isa_feature_arm_neon,
+	cpuinfo_isa_feature_arm_neon_fp16,
+	cpuinfo_isa_feature_arm_neon_fma,
+	cpuinfo_isa_feature_arm_neon_v8,
+	cpuinfo_isa_feature_arm_atomics,
+	cpuinfo_isa_feature_arm_neon_rdm,
+	cpuinfo_isa_feature_arm_neon_fp16_arith,
+	cpuinfo_isa_feature_arm_fhm,
+	cpuinfo_isa_feature_arm_neon_dot,
+	cpuinfo_isa_feature_arm_neon_bf16,
+	cpuinfo_isa_feature_arm_jscvt,
+	cpuinfo_isa_feature_arm_fcma,
+	cpuinfo_isa_feature_arm_i8mm,
+	cpuinfo_isa_feature_arm_aes,
+	cpuinfo_isa_feature_arm_sha1,
+	cpuinfo_isa_feature_arm_sha2,
+	cpuinfo_isa_feature_arm_pmull,
+	cpuinfo_isa_feature_arm_crc32,
+	cpuinfo_isa_feature_arm_sve,
+	cpuinfo_isa_feature_arm_sve_bf16,
+	cpuinfo_isa_feature_arm_sve2,
+	cpuinfo_isa_feature_arm_sme,
+	cpuinfo_isa_feature_arm_sme2,
+	cpuinfo_isa_feature_arm_sme_f64f64,
+	cpuinfo_isa_feature_arm_sme_i16i64,
+	cpuinfo_isa_feature_arm_sme_fa64,
+	cpuinfo_isa_feature_arm_lse2,
+	cpuinfo_isa_feature_arm_lse128,
+	cpuinfo_isa_feature_arm_rcpc,
+	cpuinfo_isa_feature_arm_rcpc2,
+	cpuinfo_isa_feature_arm_rcpc3,
+	cpuinfo_isa_feature_arm_wfxt,
+	cpuinfo_isa_feature_arm_sha3,
+	cpuinfo_isa_feature_arm_sha512,
+	cpuinfo_isa_feature_arm_sm3,
+	cpuinfo_isa_feature_arm_sm4,
+	cpuinfo_isa_feature_arm_rng,
+	cpuinfo_isa_feature_arm_mte,
+	cpuinfo_isa_feature_arm_mte2,
+	cpuinfo_isa_feature_arm_mte3,
+	cpuinfo_isa_feature_arm_pauth,
+	cpuinfo_isa_feature_arm_bti,
+	/** Upper bound on identifiers of ISA features */
+	cpuinfo_isa_feature_max = 256,
+};
+
+/** Number of 64-bit words in cpuinfo_isa_features bitsets */
+#define CPUINFO_ISA_FEATURE_WORDS 4
+
+/** Set of ISA features: bit (feature % 64) of word (feature / 64) is set for every feature in the set */
+struct cpuinfo_isa_features {
+	uint64_t words[CPUINFO_ISA_FEATURE_WORDS];
+};
+
+/** Adds the feature to the set, e.g. to build requirements of a kernel */
+static inline void cpuinfo_isa_features_add(struct cpuinfo_isa_features* features, enum cpuinfo_isa_feature feature) {
+	features->words[(uint32_t) feature / 64] |= UINT64_C(1) << ((uint32_t) feature % 64);
+}
+
+/** Checks if the feature is in the set */
+static inline bool cpuinfo_isa_features_contain(const struct cpuinfo_isa_features* features,
+	enum cpuinfo_isa_feature feature)
+{
+	return (features->words[(uint32_t) feature / 64] >> ((uint32_t) feature % 64)) & 1;
+}
+
+/** Checks if all features in the required set are available: (required & ~available) == 0 */
+static inline bool cpuinfo_isa_features_include(const struct cpuinfo_isa_features* available,
+	const struct cpuinfo_isa_features* required)
+{
+	uint64_t missing = 0;
+	for (uint32_t i = 0; i < CPUINFO_ISA_FEATURE_WORDS; i++) {
+		missing |= required->words[i] & ~available->words[i];
+	}
+	return missing == 0;
+}
+
+/** Returns the set of ISA features which the processor and the OS support, as reported by cpuinfo_has_* functions */
+const struct cpuinfo_isa_features* CPUINFO_ABI cpuinfo_get_isa_features(void);
+
+/**
+ * Checks if the processor and the OS support all features in the required set.
+ *
+ * @param required - set of required features, built with cpuinfo_isa_features_add.
+ */
+bool CPUINFO_ABI cpuinfo_has_isa_features(const struct cpuinfo_isa_features* required);
+
+/**
+ * Returns a 64-bit hash of the supported ISA features, including AVX10 version and vector width, for cache keys of JIT
+ * compilers and autotuners. Fingerprints of the same cpuinfo version are equal on systems with the same features.
+ */
+uint64_t CPUINFO_ABI cpuinfo_isa_fingerprint(void);
+
+/**
+ * Returns a 64-bit hash of the hardware which autotuned parameters depend on: the ISA fingerprint, microarchitectures
+ * of cores with their counts, sizes and associativities of caches, and names of packages.
+ */
+uint64_t CPUINFO_ABI cpuinfo_hardware_fingerprint(void);
+
+/** 128-bit fingerprint of the topology, as computed by cpuinfo_get_topology_fingerprint */
+struct cpuinfo_topology_fingerprint {
+	uint64_t words[2];
+};
+
+/**
+ * Compute a 128-bit hash of the structure of packages, clusters, cores, and logical processors, microarchitectures
+ * of cores with their CPUID signatures or MIDRs, geometry and sharing of caches, and supported ISA features, for
+ * grouping of systems into cohorts with equal performance and keys of tuning data. Names, frequencies, and OS
+ * processor IDs are excluded. Fingerprints of systems with the same hardware are equal for the same version of
+ * cpuinfo, and may change when a new version detects more properties of the hardware.
+ *
+ * @returns true on success, or false if fingerprint is NULL.
+ */
+bool CPUINFO_ABI cpuinfo_get_topology_fingerprint(struct cpuinfo_topology_fingerprint* fingerprint);
+
+/** Version of the schema of documents written by cpuinfo_export, incremented on incompatible changes */
+#define CPUINFO_EXPORT_SCHEMA_VERSION 1
+
+/** Formats of documents written by cpuinfo_export */
+enum cpuinfo_export_format {
+	/** JSON text, without a terminating null character */
+	cpuinfo_export_format_json = 1,
+	/** CBOR (RFC 8949) encoding of the same document, with indefinite-length maps and arrays */
+	cpuinfo_export_format_cbor = 2,
+};
+
+/**
+ * Serialize the detected topology into a document for inventories of many systems: packages, clusters, cores,
+ * logical processors, caches, microarchitectures, frequency domains, ISA features, and the hardware and ISA
+ * fingerprints.
+ *
+ * The document is an object with members "schema_version", "hardware_fingerprint", "topology_fingerprint",
+ * "packages", "clusters", "cores", "processors", "caches", "uarchs", "frequency_domains", and "isa". Tables are
+ * arrays of objects with members named as the fields of the corresponding cpuinfo structures, and pointers to other
+ * objects are replaced with their indices in the tables, or null. Vendors, microarchitectures, and ISA features are
+ * values of the cpuinfo_vendor, cpuinfo_uarch, and cpuinfo_isa_feature enums, which keep their values across
+ * versions. Fingerprints are strings of hexadecimal digits, 16 for 64-bit and 32 for 128-bit fingerprints, with the
+ * high word of cpuinfo_topology_fingerprint first. New members may be added without changes of
+ * CPUINFO_EXPORT_SCHEMA_VERSION.
+ *
+ * @param format - format of the document.
+ * @param buffer - buffer for the document, or NULL to compute its size.
+ * @param size - size of the buffer in bytes. If the document is larger, only its first size bytes are written.
+ * @returns the size of the whole document in bytes, or 0 if the format is not supported.
+ */
+size_t CPUINFO_ABI cpuinfo_export(enum cpuinfo_export_format format, void* buffer, size_t size);
+
+/** Maximum length of keys of tuning results, including the terminating null character */
+#define CPUINFO_TUNING_KEY_MAX 256
+/** Maximum size of a tuning result in bytes */
+#define CPUINFO_TUNING_VALUE_MAX 65536
+
+/**
+ * Set the directory of the persistent cache of tuning results, e.g. the cache directory of an Android application.
+ * By default the cache is in $XDG_CACHE_HOME/cpuinfo, or in $HOME/.cache/cpuinfo. The cache keeps a file for every
+ * hardware fingerprint, so results tuned on other hardware, e.g. in a shared home directory, are never returned.
+ *
+ * The function is not thread-safe, and should be called before other cpuinfo_tuning_* functions.
+ *
+ * @param path - path of the directory, or NULL to restore the default directory.
+ * @returns true on success, or false if the path is longer than the supported length.
+ */
+bool CPUINFO_ABI cpuinfo_set_tuning_cache_directory(const char* path);
+
+/**
+ * Look up a tuning result in the persistent cache.
+ *
+ * @param key - null-terminated key of the result, shorter than CPUINFO_TUNING_KEY_MAX.
+ * @param[out] value - buffer for the result, or NULL to query the size only.
+ * @param[in,out] size - size of the buffer in bytes on input; size of the result in bytes on output, if found.
+ * @returns true if the result was found and copied to the buffer, and false if it was not found or doesn't fit.
+ */
+bool CPUINFO_ABI cpuinfo_tuning_get(const char* key, void* value, size_t* size);
+
+/**
+ * Store a tuning result in the persistent cache, replacing the previous result with the same key. The cache file is
+ * replaced atomically: concurrent readers see either the old or the new file, and of concurrent writers the last one
+ * wins.
+ *
+ * @param key - null-terminated key of the result, shorter than CPUINFO_TUNING_KEY_MAX.
+ * @param value - result to store.
+ * @param size - size of the result in bytes, at most CPUINFO_TUNING_VALUE_MAX.
+ * @returns true if the result was stored, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_tuning_put(const char* key, const void* value, size_t size);
+
+/**
+ * Returns the ISA features which cores of a microarchitecture support, for code which pins threads to these cores. On
+ * ARM Linux the kernel reports only features common to all cores, and this function adds NEON features known from the
+ * MIDR of the cores, e.g. dot product on big cores of SoCs with older little cores. Elsewhere the set is equal to
+ * cpuinfo_get_isa_features(), which remains the safe choice for threads which may migrate between cores.
+ *
+ * @param uarch_index - index of the microarchitecture, less than cpuinfo_get_uarchs_count().
+ * @param[out] features - set of features to fill in.
+ * @returns true on success, false if the index is invalid.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_isa_features(uint32_t uarch_index, struct cpuinfo_isa_features* features);
+
+/** Checks if cores of the microarchitecture support the feature, see cpuinfo_get_uarch_isa_features */
+bool CPUINFO_ABI cpuinfo_has_uarch_isa_feature(uint32_t uarch_index, enum cpuinfo_isa_feature feature);
+
+static inline bool cpuinfo_has_arm_neon_rdm_on_uarch(uint32_t uarch_index) {
+	return cpuinfo_has_uarch_isa_feature(uarch_index, cpuinfo_isa_feature_arm_neon_rdm);
+}
+
+static inline bool cpuinfo_has_arm_neon_fp16_arith_on_uarch(uint32_t uarch_index) {
+	return cpuinfo_has_uarch_isa_feature(uarch_index, cpuinfo_isa_feature_arm_neon_fp16_arith);
+}
+
+static inline bool cpuinfo_has_arm_neon_dot_on_uarch(uint32_t uarch_index) {
+	return cpuinfo_has_uarch_isa_feature(uarch_index, cpuinfo_isa_feature_arm_neon_dot);
+}
+
+static inline bool cpuinfo_has_arm_fhm_on_uarch(uint32_t uarch_index) {
+	return cpuinfo_has_uarch_isa_feature(uarch_index, cpuinfo_isa_feature_arm_fhm);
+}
+
+static inline bool cpuinfo_has_arm_i8mm_on_uarch(uint32_t uarch_index) {
+	return cpuinfo_has_uarch_isa_feature(uarch_index, cpuinfo_isa_feature_arm_i8mm);
+}
+
+static inline bool cpuinfo_has_arm_neon_bf16_on_uarch(uint32_t uarch_index) {
+	return cpuinfo_has_uarch_isa_feature(uarch_index, cpuinfo_isa_feature_arm_neon_bf16);
+}
+
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_processors(void);
+const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_cores(void);
+const struct cpuinfo_cluster* CPUINFO_ABI cpuinfo_get_clusters(void);
+const struct cpuinfo_package* CPUINFO_ABI cpuinfo_get_packages(void);
+const struct cpuinfo_uarch_info* CPUINFO_ABI cpuinfo_get_uarchs(void);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1i_caches(void);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1d_caches(void);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l2_caches(void);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l3_caches(void);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l4_caches(void);
+
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_processor(uint32_t index);
+const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_core(uint32_t index);
+const struct cpuinfo_cluster* CPUINFO_ABI cpuinfo_get_cluster(uint32_t index);
+const struct cpuinfo_package* CPUINFO_ABI cpuinfo_get_package(uint32_t index);
+const struct cpuinfo_uarch_info* CPUINFO_ABI cpuinfo_get_uarch(uint32_t index);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1i_cache(uint32_t index);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1d_cache(uint32_t index);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l2_cache(uint32_t index);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l3_cache(uint32_t index);
+const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l4_cache(uint32_t index);
+
+uint32_t CPUINFO_ABI cpuinfo_get_processors_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_cores_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_clusters_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_packages_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_uarchs_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_l1i_caches_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_l1d_caches_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_l2_caches_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_l3_caches_count(void);
+uint32_t CPUINFO_ABI cpuinfo_get_l4_caches_count(void);
+
+/**
+ * Tables which the inline accessors of CPUINFO_INLINE_ACCESSORS mode read, in one cache line at the start of the
+ * published tables. The contents are immutable: re-initialization publishes another header.
+ */
+struct cpuinfo_hot_tables {
+	const struct cpuinfo_processor* processors;
+	const struct cpuinfo_core* cores;
+	const struct cpuinfo_cluster* clusters;
+	const struct cpuinfo_package* packages;
+	const struct cpuinfo_uarch_info* uarchs;
+	uint32_t processors_count;
+	uint32_t cores_count;
+	uint32_t clusters_count;
+	uint32_t packages_count;
+	uint32_t uarchs_count;
+};
+
+/**
+ * Header of the published tables, stored with release semantics, or NULL before initialization. Use the accessors
+ * rather than this pointer, and never write it.
+ */
+extern const struct cpuinfo_hot_tables* cpuinfo_published_hot_tables;
+
+/*
+ * With CPUINFO_INLINE_ACCESSORS defined before including the header, getters of the topology tables and their counts
+ * are inline loads from cpuinfo_published_hot_tables, and call the library only before initialization. The mode
+ * requires GCC-compatible atomic builtins, and data exported without import declarations, i.e. not Windows DLLs.
+ */
+#if defined(CPUINFO_INLINE_ACCESSORS) && defined(__GNUC__) && !defined(_WIN32) && !defined(__CYGWIN__)
+	static inline const struct cpuinfo_hot_tables* cpuinfo_load_hot_tables(void) {
+		return __atomic_load_n(&cpuinfo_published_hot_tables, __ATOMIC_ACQUIRE);
+	}
+
+	#define CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS(type, table, object, objects) \
+		static inline const struct type* cpuinfo_inline_get_##objects(void) { \
+			const struct cpuinfo_hot_tables* hot_tables = cpuinfo_load_hot_tables(); \
+			if (__builtin_expect(hot_tables == NULL, 0)) { \
+				return cpuinfo_get_##objects(); \
+			} \
+			return hot_tables->table; \
+		} \
+		static inline const struct type* cpuinfo_inline_get_##object(uint32_t index) { \
+			const struct cpuinfo_hot_tables* hot_tables = cpuinfo_load_hot_tables(); \
+			if (__builtin_expect(hot_tables == NULL, 0)) { \
+				return cpuinfo_get_##object(index); \
+			} \
+			return index < hot_tables->table##_count ? &hot_tables->table[index] : (const struct type*) 0; \
+		} \
+		static inline uint32_t cpuinfo_inline_get_##objects##_count(void) { \
+			const struct cpuinfo_hot_tables* hot_tables = cpuinfo_load_hot_tables(); \
+			if (__builtin_expect(hot_tables == NULL, 0)) { \
+				return cpuinfo_get_##objects##_count(); \
+			} \
+			return hot_tables->table##_count; \
+		}
+
+	CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS(cpuinfo_processor, processors, processor, processors)
+	CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS(cpuinfo_core, cores, core, cores)
+	CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS(cpuinfo_cluster, clusters, cluster, clusters)
+	CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS(cpuinfo_package, packages, package, packages)
+	CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS(cpuinfo_uarch_info, uarchs, uarch, uarchs)
+	#undef CPUINFO_DEFINE_INLINE_TABLE_ACCESSORS
+
+	#define cpuinfo_get_processors() cpuinfo_inline_get_processors()
+	#define cpuinfo_get_processor(index) cpuinfo_inline_get_processor(index)
+	#define cpuinfo_get_processors_count() cpuinfo_inline_get_processors_count()
+	#define cpuinfo_get_cores() cpuinfo_inline_get_cores()
+	#define cpuinfo_get_core(index) cpuinfo_inline_get_core(index)
+	#define cpuinfo_get_cores_count() cpuinfo_inline_get_cores_count()
+	#define cpuinfo_get_clusters() cpuinfo_inline_get_clusters()
+	#define cpuinfo_get_cluster(index) cpuinfo_inline_get_cluster(index)
+	#define cpuinfo_get_clusters_count() cpuinfo_inline_get_clusters_count()
+	#define cpuinfo_get_packages() cpuinfo_inline_get_packages()
+	#define cpuinfo_get_package(index) cpuinfo_inline_get_package(index)
+	#define cpuinfo_get_packages_count() cpuinfo_inline_get_packages_count()
+	#define cpuinfo_get_uarchs() cpuinfo_inline_get_uarchs()
+	#define cpuinfo_get_uarch(index) cpuinfo_inline_get_uarch(index)
+	#define cpuinfo_get_uarchs_count() cpuinfo_inline_get_uarchs_count()
+#endif
+
+/**
+ * Returns upper bound on cache size.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_max_cache_size(void);
+
+/**
+ * Returns upper bound on the size of caches which the logical processor can reach, i.e. of its last level cache.
+ * On hybrid and big.LITTLE systems, this is smaller for processors of little cores than cpuinfo_get_max_cache_size.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_max_cache_size(const struct cpuinfo_processor* processor);
+
+/**
+ * Returns the size of the largest data or unified cache which the core of the logical processor doesn't share with
+ * other cores, e.g. L2 cache on most x86 processors, or 0 if all its caches are shared.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_private_cache_size(const struct cpuinfo_processor* processor);
+
+/**
+ * Returns the GPU integrated in the SoC, mapped from the chipset decoded during initialization, or NULL if the
+ * chipset tables don't describe it. Unlike the renderer string of an EGL context, this doesn't load graphics
+ * drivers, and it is available on ARM Linux and Android only.
+ */
+const struct cpuinfo_integrated_gpu* CPUINFO_ABI cpuinfo_get_integrated_gpu(void);
+
+/**
+ * Returns the neural processing unit integrated in the SoC, mapped from the decoded chipset like
+ * cpuinfo_get_integrated_gpu, or NULL if the SoC has no known NPU.
+ */
+const struct cpuinfo_npu* CPUINFO_ABI cpuinfo_get_npu(void);
+
+/** Memory used by cpuinfo tables, in bytes */
+struct cpuinfo_memory_usage {
+	/** Table of logical processors */
+	size_t processors;
+	/** Table of cores */
+	size_t cores;
+	/** Table of clusters */
+	size_t clusters;
+	/** Table of packages */
+	size_t packages;
+	/** Tables of caches of all levels */
+	size_t caches;
+	/** Tables of microarchitectures and their TLBs, unless a single microarchitecture is stored inline */
+	size_t uarchs;
+	/** Maps from Linux processor IDs to logical processors, cores, and microarchitectures */
+	size_t linux_cpu_maps;
+	/** Structure-of-arrays view of logical processors with 16-bit indices, see cpuinfo_get_processor_column */
+	size_t processor_columns;
+	/** Sum of the sizes above */
+	size_t total;
+	/**
+	 * Temporary arrays allocated by the last initialization, e.g. the per-processor scratch arrays of Linux
+	 * initialization, all freed before initialization completes. This is an upper bound of their peak usage, and
+	 * the peak usage itself with cpuinfo_initialize_into, where temporary arrays are released together.
+	 */
+	size_t transient;
+};
+
+/**
+ * Report the memory used by the tables of the current initialization, and the transient memory of initialization.
+ * Sizes don't include padding between tables in the arena, nor tables of other detected properties, such as NUMA
+ * nodes or frequency domains.
+ *
+ * @param[out] usage - memory usage to fill in.
+ */
+void CPUINFO_ABI cpuinfo_get_memory_usage(struct cpuinfo_memory_usage* usage);
+
+/**
+ * Returns the effective per-core capacity of the cache level (1 for L1 data cache, up to 4) of the logical processor:
+ * the cache size divided by the number of cores which share it, plus the effective capacity of the level below if
+ * the cache is exclusive (CPUINFO_CACHE_EXCLUSIVE). Returns 0 if the processor has no cache of the level.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_effective_cache_size(
+	const struct cpuinfo_processor* processor, uint32_t level);
+
+/**
+ * Returns the destructive interference size of the system: the minimum offset between objects which threads modify
+ * concurrently to avoid false sharing. This is the largest line size of L1 data and L2 caches, doubled on Intel cores
+ * whose L2 spatial prefetcher fetches 128-byte aligned pairs of lines, unless cpuinfo_get_prefetchers reports it
+ * disabled by registers.
+ * Returns CPUINFO_DESTRUCTIVE_INTERFERENCE_SIZE if cache line sizes are unknown.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_destructive_interference_size(void);
+
+/**
+ * Returns the constructive interference size of the system: the smallest line size of L1 data caches, which objects
+ * accessed together should fit into. Returns CPUINFO_CONSTRUCTIVE_INTERFERENCE_SIZE if cache line sizes are unknown.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_constructive_interference_size(void);
+
+/**
+ * Parameters of cache maintenance after writing instructions, e.g. by a JIT compiler: clean the data cache to the point
+ * of unification in steps of dcache_line_size, then invalidate the instruction cache in steps of icache_line_size.
+ */
+struct cpuinfo_code_cache_maintenance {
+	/** Line size in bytes of instruction cache invalidation (IC IVAU on ARM64), or 0 if unknown */
+	uint32_t icache_line_size;
+	/** Line size in bytes of data cache cleaning (DC CVAU on ARM64), or 0 if unknown */
+	uint32_t dcache_line_size;
+	/** Whether instruction cache invalidation is not required for data to instruction coherence (CTR_EL0.DIC) */
+	bool icache_invalidation_not_required;
+	/** Whether data cache cleaning is not required for data to instruction coherence (CTR_EL0.IDC) */
+	bool dcache_clean_not_required;
+	/** Value of the ARM64 CTR_EL0 register, or 0 if it was not read */
+	uint64_t cache_type_register;
+};
+
+/**
+ * Returns the code cache maintenance parameters of the system, detected at initialization. On ARM64 Linux, they are
+ * decoded from CTR_EL0, which the kernel reports with the smallest line sizes of all cores, and DIC and IDC only if
+ * all cores have them, when cores differ. Elsewhere, line sizes are the smallest line sizes of L1 instruction and data
+ * caches, and x86 reports both kinds of maintenance not required because its instruction caches are coherent.
+ *
+ * @param[out] maintenance - parameters to fill in.
+ */
+void CPUINFO_ABI cpuinfo_get_code_cache_maintenance(struct cpuinfo_code_cache_maintenance* maintenance);
+
+/**
+ * Returns the code cache maintenance parameters of cores of a microarchitecture: the line sizes of their L1 caches,
+ * or the system line sizes if the caches are unknown. Whether maintenance is required is a property of the system,
+ * since code may migrate between cores. Use cpuinfo_get_code_cache_maintenance for code which runs on all cores.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] maintenance - parameters to fill in.
+ * @returns true if the parameters are filled in, and false if the index is invalid.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_code_cache_maintenance(uint32_t uarch_index,
+	struct cpuinfo_code_cache_maintenance* maintenance);
+
+/** Returns cpuinfo_get_processor_max_cache_size of cores of the microarchitecture, or 0 if the index is invalid */
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_max_cache_size(uint32_t uarch_index);
+
+/** Returns cpuinfo_get_processor_private_cache_size of cores of the microarchitecture, or 0 if the index is invalid */
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_private_cache_size(uint32_t uarch_index);
+
+/**
+ * Returns the recommended size in bytes of copies and fills on cores of the microarchitecture above which
+ * non-temporal stores are faster than regular ones. This is a fraction, tuned for the microarchitecture, of the
+ * capacity of the last level cache domain of the cores. Returns 0 if the index is invalid or caches are unknown.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_non_temporal_threshold(uint32_t uarch_index);
+
+/**
+ * Returns the recommended distance in bytes ahead of the current position for software prefetches in streaming
+ * loops on cores of the microarchitecture, or 0 if the index is invalid. The distance is doubled if
+ * cpuinfo_get_prefetchers reports the L2 streamer disabled by registers.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_prefetch_distance(uint32_t uarch_index);
+
+/**
+ * Source of the reported state of hardware prefetchers.
+ */
+enum cpuinfo_prefetchers_source {
+	/** The state is unknown: the microarchitecture doesn't document its prefetchers to cpuinfo */
+	cpuinfo_prefetchers_source_unknown = 0,
+	/** Documented defaults of the microarchitecture, because prefetcher controls are not readable */
+	cpuinfo_prefetchers_source_defaults = 1,
+	/** Prefetcher control model-specific registers, read through /dev/cpu/<linux_id>/msr */
+	cpuinfo_prefetchers_source_msr = 2,
+};
+
+/**
+ * Hardware prefetchers which are enabled. Firmware tuned for latency often disables the L2 prefetchers, which
+ * increases the useful distance of software prefetches and removes the pairing of lines by the adjacent-line
+ * prefetcher.
+ */
+struct cpuinfo_prefetchers {
+	/** Source of the state; all prefetchers are reported disabled if the state is unknown */
+	enum cpuinfo_prefetchers_source source;
+	/** L2 streamer, which fetches ahead of sequential accesses (Intel L2 hardware prefetcher, AMD L2Stream) */
+	bool l2_stream;
+	/** L2 spatial prefetcher, which completes 128-byte aligned pairs of lines (Intel adjacent cache line prefetcher) */
+	bool l2_adjacent_line;
+	/** L2 prefetcher of the next or previous line by access history (AMD UpDown) */
+	bool l2_up_down;
+	/** L1 data cache streamer, which fetches the next line (Intel DCU prefetcher, AMD L1Stream) */
+	bool l1d_stream;
+	/** L1 data cache prefetcher of strides by instruction address (Intel DCU IP prefetcher, AMD L1Stride) */
+	bool l1d_stride;
+	/** L1 data cache prefetcher of regions by access patterns (AMD L1Region) */
+	bool l1d_region;
+};
+
+/**
+ * Reads the state of hardware prefetchers of a core. The state comes from prefetcher control model-specific
+ * registers when /dev/cpu/<linux_id>/msr of a logical processor of the core is readable (which requires the msr
+ * driver and CAP_SYS_RAWIO), and from the documented defaults of the microarchitecture otherwise.
+ *
+ * @param core_index - index of the core, below cpuinfo_get_cores_count().
+ * @param[out] prefetchers - state of prefetchers to fill in.
+ *
+ * @returns true if the state is filled in, and false if the index is invalid.
+ */
+bool CPUINFO_ABI cpuinfo_get_core_prefetchers(uint32_t core_index, struct cpuinfo_prefetchers* prefetchers);
+
+/**
+ * Returns the state of hardware prefetchers of the system, detected during initialization over cores with a known
+ * state: a prefetcher is reported enabled if it is enabled on any such core, and the source is
+ * cpuinfo_prefetchers_source_msr only if registers of all such cores were read. The destructive interference size
+ * and the recommended prefetch distances account for this state.
+ *
+ * @param[out] prefetchers - state of prefetchers to fill in.
+ */
+void CPUINFO_ABI cpuinfo_get_prefetchers(struct cpuinfo_prefetchers* prefetchers);
+
+/**
+ * Hypervisor which runs the operating system.
+ */
+enum cpuinfo_hypervisor {
+	/** No hypervisor detected: the system runs on bare metal, or the hypervisor hides itself */
+	cpuinfo_hypervisor_none = 0,
+	/** A hypervisor was detected, but not identified */
+	cpuinfo_hypervisor_unknown = 1,
+	/** Linux KVM, including cloud hypervisors based on KVM other than AWS Nitro */
+	cpuinfo_hypervisor_kvm = 2,
+	/** Microsoft Hyper-V, including Azure */
+	cpuinfo_hypervisor_hyperv = 3,
+	/** VMware ESXi or VMware Workstation */
+	cpuinfo_hypervisor_vmware = 4,
+	/** Xen */
+	cpuinfo_hypervisor_xen = 5,
+	/** QEMU, with emulation (TCG), or with an accelerator which the guest can't identify */
+	cpuinfo_hypervisor_qemu = 6,
+	/** Oracle VirtualBox */
+	cpuinfo_hypervisor_virtualbox = 7,
+	/** Parallels Desktop */
+	cpuinfo_hypervisor_parallels = 8,
+	/** Project ACRN */
+	cpuinfo_hypervisor_acrn = 9,
+	/** FreeBSD bhyve */
+	cpuinfo_hypervisor_bhyve = 10,
+	/** AWS Nitro, the KVM-based hypervisor of Amazon EC2 virtual instances */
+	cpuinfo_hypervisor_nitro = 11,
+};
+
+/**
+ * Returns the hypervisor which runs the operating system, as identified at initialization from the CPUID leaf
+ * 0x40000000 signature on x86, and from DMI (SMBIOS) and the device tree on Linux.
+ */
+enum cpuinfo_hypervisor CPUINFO_ABI cpuinfo_get_hypervisor(void);
+
+/**
+ * Returns true if the topology (SMT siblings, cores, clusters, packages, cache sharing, and NUMA nodes) is presented
+ * by a hypervisor, and may be synthetic: virtual processors may be scheduled on arbitrary physical processors, and
+ * reported siblings may not share any hardware. Placement logic should then prefer measurements, e.g. of
+ * communication latency between processors, to the reported topology.
+ *
+ * Returns false on bare metal, and in the Hyper-V root partition, whose virtual processors map to logical
+ * processors with the same topology.
+ */
+bool CPUINFO_ABI cpuinfo_is_topology_synthetic(void);
+
+/**
+ * Returns the capabilities to allocate shared caches and memory bandwidth, and to monitor their use, as detected at
+ * initialization from CPUID leaves 0x7, 0xF and 0x10, and 0x80000020 on AMD. All capabilities are reported as not
+ * supported on other architectures.
+ */
+const struct cpuinfo_resource_control* CPUINFO_ABI cpuinfo_get_resource_control(void);
+
+/**
+ * Returns the extended processor state of threads, as detected at initialization from XCR0 and CPUID leaf 0xD. The
+ * size is what context switches, signal frames and green thread switches which use XSAVE pay for. All sizes are 0 on
+ * processors and operating systems without XSAVE support, and on other architectures.
+ *
+ * Vector extensions are reported as unsupported on other architectures. On Linux, AMX tile data additionally needs
+ * cpuinfo_request_x86_amx_permission before first use, even when the extension is enabled.
+ */
+const struct cpuinfo_x86_xsave_state* CPUINFO_ABI cpuinfo_get_x86_xsave_state(void);
+
+/**
+ * Returns the cache allocation capabilities of the cache, or NULL if cache allocation is not supported at its level.
+ *
+ * @param cache - L2 or L3 cache, as returned by cpuinfo_get_l2_cache or cpuinfo_get_l3_cache.
+ */
+const struct cpuinfo_cache_allocation* CPUINFO_ABI cpuinfo_get_cache_allocation(const struct cpuinfo_cache* cache);
+
+/**
+ * Returns the frequency, in Hz, of the timestamp counter: TSC read by RDTSC on x86, or the virtual counter
+ * (CNTVCT_EL0) on ARM64, whose frequency is CNTFRQ_EL0. Returns 0 if the frequency is unknown, e.g. on x86 processors
+ * which do not enumerate it in CPUID; then the counter has to be calibrated against a clock.
+ *
+ * Elapsed time in nanoseconds is (counter delta) * 1000000000 / cpuinfo_get_tsc_frequency().
+ */
+uint64_t CPUINFO_ABI cpuinfo_get_tsc_frequency(void);
+
+/**
+ * Returns true if the timestamp counter ticks at a constant rate in all P-, C-, and T-states, as indicated by the
+ * invariant TSC bit on x86. The system counter on ARM64 has a constant rate by the architecture.
+ */
+bool CPUINFO_ABI cpuinfo_has_invariant_tsc(void);
+
+/** Counter which cpuinfo_read_timestamp reads */
+enum cpuinfo_timestamp_source {
+	/** Monotonic clock of the OS: clock_gettime, mach_absolute_time, or QueryPerformanceCounter */
+	cpuinfo_timestamp_source_os_clock = 0,
+	/** TSC of x86, read by RDTSC; ordered reads use LFENCE before RDTSC */
+	cpuinfo_timestamp_source_x86_rdtsc = 1,
+	/** TSC of x86, read by RDTSC; ordered reads use RDTSCP */
+	cpuinfo_timestamp_source_x86_rdtscp = 2,
+	/** Virtual counter of ARM64 (CNTVCT_EL0); ordered reads use ISB before the read */
+	cpuinfo_timestamp_source_arm64_cntvct = 3,
+};
+
+/**
+ * Source of cpuinfo_read_timestamp, selected at initialization: the timestamp counter if it is invariant and its
+ * frequency is known, or the OS clock otherwise, and before initialization. Use cpuinfo_get_timestamp_source rather
+ * than this variable, and never write it.
+ */
+extern uint32_t cpuinfo_selected_timestamp_source;
+
+/** Returns the source of cpuinfo_read_timestamp */
+enum cpuinfo_timestamp_source CPUINFO_ABI cpuinfo_get_timestamp_source(void);
+
+/**
+ * Returns the frequency, in Hz, of the ticks of cpuinfo_read_timestamp: cpuinfo_get_tsc_frequency for the timestamp
+ * counter, or the resolution of the OS clock. Elapsed time in nanoseconds is
+ * (timestamp delta) * 1000000000 / cpuinfo_get_timestamp_frequency().
+ */
+uint64_t CPUINFO_ABI cpuinfo_get_timestamp_frequency(void);
+
+/** Read the OS clock which cpuinfo_read_timestamp falls back to */
+uint64_t CPUINFO_ABI cpuinfo_read_os_timestamp(void);
+
+/** Read the selected source without inline assembly; cpuinfo_read_timestamp calls it on other compilers */
+uint64_t CPUINFO_ABI cpuinfo_read_timestamp_uninlined(bool ordered);
+
+/*
+ * Timestamps are inline reads of the counter with GCC-compatible compilers, and data exported without import
+ * declarations, i.e. not Windows DLLs.
+ */
+#if defined(__GNUC__) && !defined(_WIN32) && !defined(__CYGWIN__) && \
+	(CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM64)
+	#define CPUINFO_INLINE_TIMESTAMP 1
+#else
+	#define CPUINFO_INLINE_TIMESTAMP 0
+#endif
+
+/**
+ * Read a timestamp in ticks of cpuinfo_get_timestamp_frequency, at the cost of a few cycles with the timestamp
+ * counter. The read is not ordered with respect to the instructions around it. Timestamps are comparable only if they
+ * were both read before initialization or both after it.
+ */
+static inline uint64_t cpuinfo_read_timestamp(void) {
+#if CPUINFO_INLINE_TIMESTAMP
+	if (__builtin_expect(__atomic_load_n(&cpuinfo_selected_timestamp_source, __ATOMIC_RELAXED) !=
+		cpuinfo_timestamp_source_os_clock, 1))
+	{
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		uint32_t low, high;
+		__asm__ __volatile__("rdtsc" : "=a" (low), "=d" (high));
+		return ((uint64_t) high << 32) | (uint64_t) low;
+	#else
+		uint64_t counter;
+		__asm__ __volatile__("mrs %0, cntvct_el0" : "=r" (counter));
+		return counter;
+	#endif
+	}
+	return cpuinfo_read_os_timestamp();
+#else
+	return cpuinfo_read_timestamp_uninlined(false);
+#endif
+}
+
+/**
+ * Read a timestamp as cpuinfo_read_timestamp does, but after all previous instructions complete locally, to time the
+ * end of a measured region.
+ */
+static inline uint64_t cpuinfo_read_timestamp_ordered(void) {
+#if CPUINFO_INLINE_TIMESTAMP
+	const uint32_t source = __atomic_load_n(&cpuinfo_selected_timestamp_source, __ATOMIC_RELAXED);
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		uint32_t low, high, aux;
+		if (__builtin_expect(source == cpuinfo_timestamp_source_x86_rdtscp, 1)) {
+			__asm__ __volatile__("rdtscp" : "=a" (low), "=d" (high), "=c" (aux) : : "memory");
+			return ((uint64_t) high << 32) | (uint64_t) low;
+		} else if (source == cpuinfo_timestamp_source_x86_rdtsc) {
+			__asm__ __volatile__("lfence\n\trdtsc" : "=a" (low), "=d" (high) : : "memory");
+			return ((uint64_t) high << 32) | (uint64_t) low;
+		}
+	#else
+		if (__builtin_expect(source == cpuinfo_timestamp_source_arm64_cntvct, 1)) {
+			uint64_t counter;
+			__asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r" (counter) : : "memory");
+			return counter;
+		}
+	#endif
+	return cpuinfo_read_os_timestamp();
+#else
+	return cpuinfo_read_timestamp_uninlined(true);
+#endif
+}
+
+/**
+ * Identify the logical processor that executes the current thread.
+ *
+ * There is no guarantee that the thread will stay on the same logical processor for any time.
+ * Callers should treat the result as only a hint, and be prepared to handle NULL return value.
+ */
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_current_processor(void);
+
+/**
+ * Identify the core that executes the current thread.
+ *
+ * There is no guarantee that the thread will stay on the same core for any time.
+ * Callers should treat the result as only a hint, and be prepared to handle NULL return value.
+ */
+const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_current_core(void);
+
+/**
+ * Identify the microarchitecture index of the core that executes the current thread.
+ * If the system does not support such identification, the function returns 0.
+ *
+ * There is no guarantee that the thread will stay on the same type of core for any time.
+ * Callers should treat the result as only a hint.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index(void);
+
+/**
+ * Identify the microarchitecture index of the core that executes the current thread.
+ * If the system does not support such identification, the function returns the user-specified default value.
+ *
+ * There is no guarantee that the thread will stay on the same type of core for any time.
+ * Callers should treat the result as only a hint.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index_with_default(uint32_t default_uarch_index);
+
+/**
+ * Guard against migration of the current thread between cores of different microarchitectures during a long
+ * operation, such as a kernel tuned for the microarchitecture which processes many tiles. Initialize the guard with
+ * cpuinfo_migration_guard_enter, and check it at tile boundaries with cpuinfo_migration_guard_check.
+ */
+struct cpuinfo_migration_guard {
+	/** Microarchitecture index of the core at entry, or at the last check which reported a migration */
+	uint32_t uarch_index;
+	/** Processor number of the operating system at the last identification, or UINT32_MAX if unknown */
+	uint32_t cpu_number;
+};
+
+/**
+ * Initialize a migration guard with the microarchitecture of the core that executes the current thread.
+ *
+ * @param[out] guard - guard to initialize.
+ * @returns the microarchitecture index of the core, as cpuinfo_get_current_uarch_index.
+ */
+uint32_t CPUINFO_ABI cpuinfo_migration_guard_enter(struct cpuinfo_migration_guard* guard);
+
+/**
+ * Check whether the current thread migrated to a core of another microarchitecture since the entry or the last check
+ * which reported a migration, and record the new microarchitecture index in the guard.
+ *
+ * On systems with a single microarchitecture, the check returns false without identifying the processor. Otherwise,
+ * it reads the processor number, which is a load of the cpu_id field of the rseq area of the thread on Linux with
+ * restartable sequences, and compares it with the processor of the last check, so checks without migrations don't
+ * look up tables. Migrations between checks which return to the same processor are not reported, and the result is
+ * a hint, as the thread may migrate right after the check.
+ *
+ * @returns true if the microarchitecture index in the guard changed, and false otherwise, including if the processor
+ *          can't be identified.
+ */
+bool CPUINFO_ABI cpuinfo_migration_guard_check(struct cpuinfo_migration_guard* guard);
+
+/** Maximum number of implementations in a cpuinfo_dispatch_table */
+#define CPUINFO_DISPATCH_MAX_CANDIDATES 16
+/** Maximum number of microarchitectures with own implementations in a cpuinfo_dispatch_table */
+#define CPUINFO_DISPATCH_MAX_UARCHS 8
+
+/** Generic function pointer type of implementations: callers cast it to and from the actual type */
+typedef void (*cpuinfo_dispatch_function)(void);
+
+/** Implementation of a function registered in a cpuinfo_dispatch_table */
+struct cpuinfo_dispatch_candidate {
+	cpuinfo_dispatch_function function;
+	/** ISA features which the implementation requires */
+	struct cpuinfo_isa_features required;
+	/** Microarchitecture which the implementation is tuned for, or cpuinfo_uarch_unknown if it suits any */
+	enum cpuinfo_uarch preferred_uarch;
+};
+
+/**
+ * Table of implementations of a function for different ISA features, resolved once to the best supported one.
+ * Zero-initialized tables are empty. Tables are owned by the caller, e.g. as static variables, and don't need to be
+ * released.
+ */
+struct cpuinfo_dispatch_table {
+	uint32_t candidates_count;
+	/** Candidates in the order of registration, which is the order of preference */
+	struct cpuinfo_dispatch_candidate candidates[CPUINFO_DISPATCH_MAX_CANDIDATES];
+	/** Implementation for threads which may run on any core, or NULL before resolution or if none is supported */
+	cpuinfo_dispatch_function function;
+	/** Implementations for threads on cores of every microarchitecture, indexed by microarchitecture index */
+	cpuinfo_dispatch_function uarch_functions[CPUINFO_DISPATCH_MAX_UARCHS];
+};
+
+/**
+ * Register an implementation in the table. Register the most specialized implementations first: resolution picks
+ * the first supported one, so a portable implementation without requirements should be registered last.
+ *
+ * @param table - table to add the implementation to.
+ * @param function - implementation, cast to cpuinfo_dispatch_function.
+ * @param required - ISA features which the implementation requires, or NULL if it has no requirements.
+ * @param preferred_uarch - microarchitecture which the implementation is tuned for, or cpuinfo_uarch_unknown.
+ *                          Such implementations are picked only on cores of that microarchitecture, and take
+ *                          precedence over other supported implementations there.
+ * @returns true if the implementation was added, and false if the table is full or the function is NULL.
+ */
+bool CPUINFO_ABI cpuinfo_dispatch_table_add(
+	struct cpuinfo_dispatch_table* table,
+	cpuinfo_dispatch_function function,
+	const struct cpuinfo_isa_features* required,
+	enum cpuinfo_uarch preferred_uarch);
 
-static inline bool cpuinfo_has_x86_rdtsc(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.rdtsc;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Resolve the implementations of the table for the current system: the implementation for threads which may run on
+ * any core uses only ISA features which all cores support, and the implementation for every microarchitecture
+ * uses features of its cores, as reported by cpuinfo_get_uarch_isa_features. Must be called after
+ * cpuinfo_initialize, and again after cpuinfo_reinitialize if the set of microarchitectures may change.
+ *
+ * @returns true if some implementation is supported on all cores, i.e. the function member of the table is not NULL.
+ */
+bool CPUINFO_ABI cpuinfo_dispatch_table_resolve(struct cpuinfo_dispatch_table* table);
 
-static inline bool cpuinfo_has_x86_rdtscp(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.rdtscp;
-	#else
-		return false;
-	#endif
+/**
+ * Returns the resolved implementation for cores of the microarchitecture. Implementations for microarchitectures with
+ * indices of CPUINFO_DISPATCH_MAX_UARCHS and above are the implementation for any core.
+ */
+static inline cpuinfo_dispatch_function cpuinfo_dispatch_table_get(const struct cpuinfo_dispatch_table* table,
+	uint32_t uarch_index)
+{
+	return uarch_index < CPUINFO_DISPATCH_MAX_UARCHS ? table->uarch_functions[uarch_index] : table->function;
 }
 
-static inline bool cpuinfo_has_x86_rdpid(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.rdpid;
-	#else
-		return false;
-	#endif
+/**
+ * Returns the resolved implementation for the core which executes the current thread. The thread may migrate to a
+ * core of another microarchitecture at any time, so use this function only for threads pinned to cores of one
+ * microarchitecture, and the function member of the table otherwise.
+ */
+static inline cpuinfo_dispatch_function cpuinfo_dispatch_table_get_current(const struct cpuinfo_dispatch_table* table) {
+	return cpuinfo_dispatch_table_get(table, cpuinfo_get_current_uarch_index_with_default(UINT32_MAX));
 }
 
-static inline bool cpuinfo_has_x86_clzero(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.clzero;
-	#else
-		return false;
-	#endif
-}
+/** Maximum number of timed runs of every implementation in cpuinfo_dispatch_table_race */
+#define CPUINFO_DISPATCH_RACE_MAX_ITERATIONS 1024
 
-static inline bool cpuinfo_has_x86_mwait(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.mwait;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Runs one iteration of a benchmark with an implementation from a dispatch table. The function casts the
+ * implementation to its actual type, and calls it on the workload described by the context.
+ */
+typedef void (*cpuinfo_dispatch_race_function)(cpuinfo_dispatch_function implementation, void* context);
+
+/** Results of cpuinfo_dispatch_table_race for a microarchitecture */
+struct cpuinfo_dispatch_race_result {
+	/** Index of the fastest candidate in the table, or UINT32_MAX if the microarchitecture was not benchmarked */
+	uint32_t winner;
+	/** Index of the logical processor which ran the benchmark */
+	uint32_t processor_index;
+	/** Median time of an iteration of every candidate in nanoseconds, or 0 if the candidate was not benchmarked */
+	uint64_t median_ns[CPUINFO_DISPATCH_MAX_CANDIDATES];
+	/** 90th percentile of time of an iteration of every candidate in nanoseconds, or 0 if not benchmarked */
+	uint64_t tail_ns[CPUINFO_DISPATCH_MAX_CANDIDATES];
+};
 
-static inline bool cpuinfo_has_x86_mwaitx(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.mwaitx;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Resolve the table, then benchmark its candidates on every microarchitecture, and use the fastest one on its cores.
+ * The calling thread is pinned in turn to a usable logical processor of the first cluster of every microarchitecture,
+ * where every supported candidate runs once to warm up, and then for the given number of timed iterations. The
+ * candidate with the lowest median time wins, and is recorded in the persistent tuning cache under the name, to be
+ * applied without benchmarks by cpuinfo_dispatch_table_load_race in later processes. Candidates tuned for another
+ * microarchitecture don't take part. The affinity of the thread is restored afterwards.
+ *
+ * @param table - table with registered candidates.
+ * @param name - name of the function, unique among tables, for keys in the tuning cache; or NULL to not record.
+ * @param run - function which runs one iteration of the benchmark with a candidate.
+ * @param context - context passed to the run function.
+ * @param iterations - number of timed iterations of every candidate, at most CPUINFO_DISPATCH_RACE_MAX_ITERATIONS.
+ * @param[out] results - array of CPUINFO_DISPATCH_MAX_UARCHS results, indexed by microarchitecture, or NULL.
+ * @returns true if the table was resolved and every microarchitecture was benchmarked, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_dispatch_table_race(
+	struct cpuinfo_dispatch_table* table,
+	const char* name,
+	cpuinfo_dispatch_race_function run,
+	void* context,
+	uint32_t iterations,
+	struct cpuinfo_dispatch_race_result* results);
 
-static inline bool cpuinfo_has_x86_fxsave(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.fxsave;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Resolve the table, then apply the winners of earlier cpuinfo_dispatch_table_race calls from the tuning cache.
+ * Recorded winners are ignored if the number of candidates in the table changed since the race.
+ *
+ * @returns true if the table was resolved and winners for all microarchitectures were found, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_dispatch_table_load_race(struct cpuinfo_dispatch_table* table, const char* name);
 
-static inline bool cpuinfo_has_x86_xsave(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.xsave;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Last-level cache domain: group of logical processors which share the last-level cache.
+ * Logical processors and cores of a domain are consecutive in cpuinfo tables.
+ */
+struct cpuinfo_llc_domain {
+	/** Index of the first logical processor in the domain */
+	uint32_t processor_start;
+	/** Number of logical processors in the domain */
+	uint32_t processor_count;
+	/** Index of the first core in the domain */
+	uint32_t core_start;
+	/** Number of cores in the domain */
+	uint32_t core_count;
+	/** Last-level cache shared by the logical processors, or NULL if cpuinfo could not detect caches */
+	const struct cpuinfo_cache* cache;
+	/** Size of the last-level cache, in bytes, or 0 if cpuinfo could not detect caches */
+	uint32_t size;
+};
 
-static inline bool cpuinfo_has_x86_fpu(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.fpu;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the last-level cache domains, sorted by index of their first logical processor.
+ * If cpuinfo could not detect caches, all logical processors belong to a single domain.
+ */
+const struct cpuinfo_llc_domain* CPUINFO_ABI cpuinfo_get_llc_domains(void);
+uint32_t CPUINFO_ABI cpuinfo_get_llc_domains_count(void);
+const struct cpuinfo_llc_domain* CPUINFO_ABI cpuinfo_get_llc_domain(uint32_t index);
 
-static inline bool cpuinfo_has_x86_mmx(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.mmx;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the index of the last-level cache domain of the logical processor, or UINT32_MAX if the logical processor
+ * is not from cpuinfo tables.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_llc_domain_index(const struct cpuinfo_processor* processor);
+
+/**
+ * Cache cluster: group of clusters whose logical processors share an L3 cache, e.g. a DynamIQ Shared Unit on ARM, or a
+ * core complex on x86. Unlike clusters, which group cores of the same microarchitecture and frequency, a cache cluster
+ * may span cores of different types. If logical processors have no L3 cache, every cluster is a cache cluster.
+ * Logical processors and cores of a cache cluster are consecutive in cpuinfo tables.
+ *
+ * Cache clusters of one processor may be asymmetric: e.g. on AMD Ryzen 7950X3D and 9950X3D, one core complex die has
+ * 3D V-Cache with a 96 MB L3 cache, while the other has a 32 MB L3 cache and reaches higher frequencies. Cache-hungry
+ * workers should run on cache clusters with large_l3, and frequency-hungry workers on those with high_frequency.
+ */
+struct cpuinfo_cache_cluster {
+	/** Index of the first logical processor in the cache cluster */
+	uint32_t processor_start;
+	/** Number of logical processors in the cache cluster */
+	uint32_t processor_count;
+	/** Index of the first core in the cache cluster */
+	uint32_t core_start;
+	/** Number of cores in the cache cluster */
+	uint32_t core_count;
+	/** Index of the first cluster with logical processors in the cache cluster */
+	uint32_t cluster_start;
+	/** Number of clusters with logical processors in the cache cluster */
+	uint32_t cluster_count;
+	/** L3 cache shared by the logical processors, or NULL if they have no L3 cache */
+	const struct cpuinfo_cache* l3;
+	/** Whether the L3 cache is the largest, and other cache clusters have smaller or no L3 caches */
+	bool large_l3;
+	/**
+	 * Whether cores of the cache cluster have the highest maximum frequency, and cores of other cache clusters have
+	 * lower maximum frequencies. Cache clusters with unknown frequencies are never flagged.
+	 */
+	bool high_frequency;
+};
+
+/**
+ * Returns the cache clusters, sorted by index of their first logical processor.
+ */
+const struct cpuinfo_cache_cluster* CPUINFO_ABI cpuinfo_get_cache_clusters(void);
+uint32_t CPUINFO_ABI cpuinfo_get_cache_clusters_count(void);
+const struct cpuinfo_cache_cluster* CPUINFO_ABI cpuinfo_get_cache_cluster(uint32_t index);
+
+/**
+ * Returns the index of the cache cluster of the logical processor, or UINT32_MAX if the logical processor is not from
+ * cpuinfo tables.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_cache_cluster_index(const struct cpuinfo_processor* processor);
+
+/**
+ * Returns the group of cores which share the vector (NEON and SVE) execution units with the core.
+ *
+ * Cortex-A510 and Cortex-A520 cores may be implemented as merged-core complexes: pairs of cores which share the L2
+ * cache and the vector datapath. Two threads with vector-heavy code on the cores of one complex run at about half the
+ * speed they would on different complexes. A pair of these cores which share an L2 cache, and no other cores, is
+ * detected as a complex; all other cores have private vector units.
+ *
+ * @param[in] core - core from cpuinfo tables.
+ * @param[out] core_start - index of the first core of the group.
+ * @param[out] core_count - number of cores in the group: 2 for merged cores, 1 for cores with private vector units.
+ *
+ * @returns true on success, or false if the core is not from cpuinfo tables.
+ */
+bool CPUINFO_ABI cpuinfo_get_core_vector_unit_group(const struct cpuinfo_core* core,
+	uint32_t* core_start, uint32_t* core_count);
+
+/**
+ * Identify the last-level cache domain of the logical processor that executes the current thread.
+ *
+ * There is no guarantee that the thread will stay in the same domain for any time.
+ * Callers should treat the result as only a hint, and be prepared to handle NULL return value.
+ */
+const struct cpuinfo_llc_domain* CPUINFO_ABI cpuinfo_get_current_llc_domain(void);
+
+/**
+ * Returns the number of logical processors which the process may use, as determined at initialization.
+ * Thread pools should be sized after this number rather than cpuinfo_get_processors_count().
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_usable_processors_count(void);
+/**
+ * Returns the recommended number of threads for CPU-bound work: the number of usable logical processors, limited by
+ * the CPU bandwidth quota of the cgroup on Linux (cpu.max in cgroup v2, cpu.cfs_quota_us / cpu.cfs_period_us in
+ * cgroup v1), rounded up. For example, a quota of 400000 us per 100000 us period limits the parallelism to 4.
+ * Quota is determined at initialization.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_effective_parallelism(void);
+/** Returns the indices of the usable logical processors, in increasing order */
+const uint32_t* CPUINFO_ABI cpuinfo_get_usable_processor_indices(void);
+/** Returns the usable logical processor with the index in the list of usable processors */
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_usable_processor(uint32_t index);
+/**
+ * Returns the indices of the usable logical processors, sorted by decreasing performance of their cores.
+ * Among processors of equal performance, the first logical processors of all cores precede their SMT siblings,
+ * so the first entries are the best processors for single-threaded latency-critical work.
+ * The list has cpuinfo_get_usable_processors_count() entries and is determined at initialization.
+ */
+const uint32_t* CPUINFO_ABI cpuinfo_get_usable_processor_indices_by_performance(void);
+/** Returns the usable logical processor with the index in the list of usable processors sorted by performance */
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_usable_processor_by_performance(uint32_t index);
+
+/** Maximum length of the path of an Android cpuset group, including the terminating null character */
+#define CPUINFO_ANDROID_CPUSET_PATH_MAX 64
+
+/** Cpuset groups which Android assigns to processes by their importance */
+enum cpuinfo_android_cpuset_group {
+	/** The group is not one of the standard groups below */
+	cpuinfo_android_cpuset_group_other = 0,
+	/** Root cpuset, with all processors */
+	cpuinfo_android_cpuset_group_root,
+	/** Application in the foreground which the user interacts with */
+	cpuinfo_android_cpuset_group_top_app,
+	/** Foreground services and visible applications */
+	cpuinfo_android_cpuset_group_foreground,
+	/** Background applications, usually on little cores */
+	cpuinfo_android_cpuset_group_background,
+	/** Background system services */
+	cpuinfo_android_cpuset_group_system_background,
+	/** Applications which the system restricts, e.g. when the screen is off */
+	cpuinfo_android_cpuset_group_restricted,
+};
+
+/** Current cpuset group of the process on Android, and the logical processors which the group allows */
+struct cpuinfo_android_cpuset {
+	/** Path of the group in the cpuset hierarchy, e.g. "/top-app", as in /proc/self/cpuset */
+	char path[CPUINFO_ANDROID_CPUSET_PATH_MAX];
+	/** Group identified by the path */
+	enum cpuinfo_android_cpuset_group group;
+	/** Number of online logical processors in the cpus of the group */
+	uint32_t processors_count;
+	/** Number of clusters with logical processors in the cpus of the group */
+	uint32_t clusters_count;
+};
+
+/**
+ * Read the current cpuset group of the process from /proc/self/cpuset and the processors of the group from the cpus
+ * file of the group in /dev/cpuset.
+ *
+ * Android moves applications between groups as their importance changes, e.g. an application which goes to the
+ * background loses its big cores, so the group is read on every call rather than at initialization. Usable
+ * processors of cpuinfo_get_usable_processors_count are restricted to the group at initialization.
+ *
+ * @param[out] cpuset - the group and the number of its processors and clusters.
+ * @param[out] clusters - optional array of cpuinfo_get_clusters_count() entries, which receives the clusters with
+ *                        processors in the group in the order of cpuinfo_get_cluster, or NULL.
+ * @returns true on success, or false if cpusets are unavailable, as on platforms other than Android.
+ */
+bool CPUINFO_ABI cpuinfo_get_android_cpuset(struct cpuinfo_android_cpuset* cpuset,
+	const struct cpuinfo_cluster** clusters);
+
+/** Simultaneous multithreading control of the OS, on Linux in /sys/devices/system/cpu/smt/control */
+enum cpuinfo_smt_control {
+	/** The OS doesn't report the control */
+	cpuinfo_smt_control_unknown = 0,
+	/** Sibling hardware threads are online */
+	cpuinfo_smt_control_on,
+	/** Sibling hardware threads are offline, and may be brought online again */
+	cpuinfo_smt_control_off,
+	/** Sibling hardware threads are offline until reboot */
+	cpuinfo_smt_control_forceoff,
+	/** The processor doesn't support simultaneous multithreading */
+	cpuinfo_smt_control_not_supported,
+	/** The kernel doesn't implement the control of simultaneous multithreading */
+	cpuinfo_smt_control_not_implemented,
+};
+
+/**
+ * Returns the simultaneous multithreading control of the OS at initialization. Sibling hardware threads which the
+ * control turned off, or which were taken offline individually, are not online and not usable.
+ */
+enum cpuinfo_smt_control CPUINFO_ABI cpuinfo_get_smt_control(void);
+/**
+ * Returns true if any core had more than one online hardware thread at initialization: on Linux, as reported by
+ * /sys/devices/system/cpu/smt/active, or as detected from the online processors on kernels without the file.
+ */
+bool CPUINFO_ABI cpuinfo_is_smt_active(void);
+
+/**
+ * Returns the number of logical processors reserved for latency-critical work: processors which are isolated or
+ * nohz_full. Placement policies other than cpuinfo_worker_policy_isolated avoid these processors.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_isolated_processors_count(void);
+/** Returns the indices of the isolated or nohz_full logical processors, in increasing order */
+const uint32_t* CPUINFO_ABI cpuinfo_get_isolated_processor_indices(void);
+/** Returns the logical processor with the index in the list of isolated or nohz_full processors */
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_isolated_processor(uint32_t index);
+
+/**
+ * Returns the index of the first SMT sibling, i.e. the logical processor with the lowest SMT ID, of every core.
+ * The list has cpuinfo_get_cores_count() entries in the order of cores, so iterating it visits each physical core once.
+ */
+const uint32_t* CPUINFO_ABI cpuinfo_get_core_primary_processor_indices(void);
+/**
+ * Returns the indices of the logical processors with a microarchitecture, in increasing order.
+ *
+ * @param index - index of the microarchitecture, as for cpuinfo_get_uarch.
+ * @param[out] count - number of logical processors in the list, or 0 if the index is out of range.
+ * @returns pointer to the list, or NULL if the index is out of range.
+ */
+const uint32_t* CPUINFO_ABI cpuinfo_get_uarch_processor_indices(uint32_t index, uint32_t* count);
+/**
+ * Returns the indices of the logical processors of a cluster, sorted by decreasing capacity of their cores. Among
+ * processors of equal capacity, the first logical processors of all cores precede their SMT siblings.
+ *
+ * @param index - index of the cluster, as for cpuinfo_get_cluster.
+ * @param[out] count - number of logical processors in the list, or 0 if the index is out of range.
+ * @returns pointer to the list, or NULL if the index is out of range.
+ */
+const uint32_t* CPUINFO_ABI cpuinfo_get_cluster_processor_indices(uint32_t index, uint32_t* count);
+/**
+ * Innermost level of the topology shared by two logical processors, from the nearest to the farthest. Levels below
+ * cpuinfo_distance_level_numa_node apply only to processors on the same NUMA node: processors which share an L3 cache
+ * across NUMA nodes, e.g. with sub-NUMA clustering, are at the package level.
+ */
+enum cpuinfo_distance_level {
+	/** The same logical processor */
+	cpuinfo_distance_level_processor = 0,
+	/** SMT siblings of the same core */
+	cpuinfo_distance_level_core = 1,
+	/** Processors which share an L2 cache */
+	cpuinfo_distance_level_l2 = 2,
+	/** Processors which share an L3 cache */
+	cpuinfo_distance_level_l3 = 3,
+	/** Processors of the same cluster of cores, e.g. of the same die or module on x86 */
+	cpuinfo_distance_level_cluster = 4,
+	/** Processors of the same NUMA node */
+	cpuinfo_distance_level_numa_node = 5,
+	/** Processors of the same package on different NUMA nodes */
+	cpuinfo_distance_level_package = 6,
+	/** Processors of different packages */
+	cpuinfo_distance_level_remote = 7,
+	cpuinfo_distance_level_max = 8,
+};
+
+/**
+ * Returns the innermost level of the topology shared by two logical processors, in constant time from indices of
+ * their topology objects determined at initialization.
+ *
+ * @param processor_index - index of the first logical processor, as for cpuinfo_get_processor.
+ * @param other_processor_index - index of the second logical processor, as for cpuinfo_get_processor.
+ * @param[out] numa_distance - optional pointer to the distance between the NUMA nodes of the processors, as in
+ *                             cpuinfo_get_numa_distances, or 0 if an index is out of range.
+ * @returns level of the topology, or cpuinfo_distance_level_max if an index is out of range.
+ */
+enum cpuinfo_distance_level CPUINFO_ABI cpuinfo_get_processor_distance(uint32_t processor_index,
+	uint32_t other_processor_index, uint32_t* numa_distance);
+/**
+ * Returns the victims of a work-stealing thread on a logical processor: the indices of the usable logical processors
+ * other than this one, ordered by their distance level from it, as in cpuinfo_get_processor_distance. Processors of
+ * other NUMA nodes are also ordered by increasing NUMA distance. Processors at the same level follow this one in the
+ * rotated order of usable processors, so that thieves of a domain start at different victims. The lists are
+ * determined at initialization.
+ *
+ * @param processor_index - index of the logical processor of the thief, as for cpuinfo_get_processor.
+ * @param[out] count - number of victims in the list, or 0 if the index is out of range.
+ * @returns pointer to the list, or NULL if the index is out of range or there are no victims.
+ */
+const uint32_t* CPUINFO_ABI cpuinfo_get_steal_order(uint32_t processor_index, uint32_t* count);
+
+/** Value of processor columns for a logical processor without the object, e.g. without L3 cache */
+#define CPUINFO_COLUMN_INDEX_NONE UINT16_C(0xFFFF)
+
+/**
+ * Columns of the structure-of-arrays view of logical processors: every column holds, for each logical processor, the
+ * 16-bit index of a related object in its cpuinfo table.
+ */
+enum cpuinfo_processor_column {
+	/** Index of the core, as for cpuinfo_get_core */
+	cpuinfo_processor_column_core = 0,
+	/** Index of the cluster, as for cpuinfo_get_cluster */
+	cpuinfo_processor_column_cluster = 1,
+	/** Index of the package, as for cpuinfo_get_package */
+	cpuinfo_processor_column_package = 2,
+	/** Index of the NUMA node, as for cpuinfo_get_numa_node */
+	cpuinfo_processor_column_numa_node = 3,
+	/** Index of the frequency domain, as for cpuinfo_get_frequency_domain */
+	cpuinfo_processor_column_frequency_domain = 4,
+	/** Index of the last-level cache domain, as for cpuinfo_get_llc_domain */
+	cpuinfo_processor_column_llc_domain = 5,
+	/** Index of the microarchitecture, as for cpuinfo_get_uarch */
+	cpuinfo_processor_column_uarch = 6,
+	/** Index of the L1 instruction cache, as for cpuinfo_get_l1i_cache */
+	cpuinfo_processor_column_l1i = 7,
+	/** Index of the L1 data cache, as for cpuinfo_get_l1d_cache */
+	cpuinfo_processor_column_l1d = 8,
+	/** Index of the L2 cache, as for cpuinfo_get_l2_cache */
+	cpuinfo_processor_column_l2 = 9,
+	/** Index of the L3 cache, as for cpuinfo_get_l3_cache */
+	cpuinfo_processor_column_l3 = 10,
+	/** Index of the L4 cache, as for cpuinfo_get_l4_cache */
+	cpuinfo_processor_column_l4 = 11,
+	/** Number of columns */
+	cpuinfo_processor_column_max = 12,
+};
+
+/**
+ * Returns a column of the structure-of-arrays view of logical processors: cpuinfo_get_processors_count() 16-bit
+ * indices, or CPUINFO_COLUMN_INDEX_NONE for processors without the object. Scanning a column touches 2 bytes per
+ * logical processor rather than a cpuinfo_processor structure.
+ *
+ * @returns pointer to the column, or NULL if the column is out of range, or the view is not available because some
+ *          table has 65535 or more entries.
+ */
+const uint16_t* CPUINFO_ABI cpuinfo_get_processor_column(enum cpuinfo_processor_column column);
+
+/**
+ * Returns the memory of all processor columns: column c starts at 16-bit entry c * cpuinfo_get_processors_count().
+ * The memory contains only indices and no pointers, so it can be copied or shared with other processes as is.
+ *
+ * @param[out] size - size of the memory in bytes, or 0 if the view is not available.
+ * @returns pointer to the memory, or NULL if the view is not available.
+ */
+const void* CPUINFO_ABI cpuinfo_get_processor_columns(uint32_t* size);
+
+/** Returns the NUMA nodes, sorted by node ID */
+const struct cpuinfo_numa_node* CPUINFO_ABI cpuinfo_get_numa_nodes(void);
+uint32_t CPUINFO_ABI cpuinfo_get_numa_nodes_count(void);
+const struct cpuinfo_numa_node* CPUINFO_ABI cpuinfo_get_numa_node(uint32_t index);
+
+/**
+ * Returns the NUMA distance matrix: cpuinfo_get_numa_nodes_count() squared entries, where the entry at
+ * (i * cpuinfo_get_numa_nodes_count() + j) is the distance from node i to node j.
+ */
+const uint32_t* CPUINFO_ABI cpuinfo_get_numa_distances(void);
+
+/**
+ * Returns the memory-side caches of all NUMA nodes, ordered by node and then by level. Memory-side caches are reported
+ * only on Linux, which reads them from the Heterogeneous Memory Attribute Table (HMAT) of ACPI firmware.
+ */
+const struct cpuinfo_memory_side_cache* CPUINFO_ABI cpuinfo_get_memory_side_caches(void);
+uint32_t CPUINFO_ABI cpuinfo_get_memory_side_caches_count(void);
+const struct cpuinfo_memory_side_cache* CPUINFO_ABI cpuinfo_get_memory_side_cache(uint32_t index);
+
+/**
+ * Identify the NUMA node of the logical processor that executes the current thread.
+ *
+ * There is no guarantee that the thread will stay on the same NUMA node for any time.
+ * Callers should treat the result as only a hint, and be prepared to handle NULL return value.
+ */
+const struct cpuinfo_numa_node* CPUINFO_ABI cpuinfo_get_current_numa_node(void);
+
+/** Locality of an I/O device, e.g. a NIC, an NVMe drive or a GPU, as reported by the operating system */
+struct cpuinfo_device_locality {
+	/** NUMA node of the device, or NULL if the device is not attached to a NUMA node */
+	const struct cpuinfo_numa_node* numa_node;
+	/** Number of logical processors local to the device, including the ones which are not usable */
+	uint32_t processors_count;
+	/** Number of usable logical processors local to the device */
+	uint32_t usable_processors_count;
+};
+
+/**
+ * Find the logical processors local to an I/O device, e.g. for its polling and interrupt-handling threads.
+ *
+ * On Linux, the device is the name of a network interface, block device, NVMe controller, InfiniBand device, DRM
+ * card or PCI device, e.g. eth0, nvme0n1, mlx5_0, card0 or 0000:3b:00.0, or a path of its sysfs directory. Locality
+ * comes from local_cpulist and numa_node of the device or of its nearest parent device which reports them, usually
+ * the PCI device. Devices without locality, e.g. virtual network interfaces, are not found. The function reads sysfs
+ * on every call. Other operating systems are not supported.
+ *
+ * @param device - name or sysfs path of the device.
+ * @param[out] locality - locality of the device.
+ * @param max_count - number of elements in processor_indices.
+ * @param[out] processor_indices - optional array to be filled with the indices of the first max_count logical
+ *                                 processors local to the device, in increasing order, as for cpuinfo_get_processor.
+ * @returns true if the locality of the device was found, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_get_device_local_processors(const char* device, struct cpuinfo_device_locality* locality,
+	uint32_t max_count, uint32_t* processor_indices);
+
+/**
+ * Returns the pools of huge pages of the system, sorted by page size, with the numbers of pages at initialization.
+ * Pools are reported only on Linux. Use cpuinfo_query_huge_page_pool to get the current numbers of pages.
+ */
+const struct cpuinfo_huge_page_pool* CPUINFO_ABI cpuinfo_get_huge_page_pools(void);
+uint32_t CPUINFO_ABI cpuinfo_get_huge_page_pools_count(void);
+const struct cpuinfo_huge_page_pool* CPUINFO_ABI cpuinfo_get_huge_page_pool(uint32_t index);
+
+/**
+ * Get the part of a pool of huge pages on a NUMA node, with the numbers of pages at initialization.
+ *
+ * @param numa_node_index - index of the NUMA node, as in cpuinfo_get_numa_node.
+ * @param pool_index - index of the pool, as in cpuinfo_get_huge_page_pool.
+ * @returns pointer to the pool of the node, or NULL if either index is invalid or the OS doesn't report the pools of
+ *          NUMA nodes.
+ */
+const struct cpuinfo_huge_page_pool* CPUINFO_ABI cpuinfo_get_numa_node_huge_page_pool(
+	uint32_t numa_node_index, uint32_t pool_index);
+
+/**
+ * Read the current numbers of pages in a pool of huge pages from the operating system.
+ *
+ * @param pool_index - index of the pool, as in cpuinfo_get_huge_page_pool.
+ * @param numa_node_index - index of the NUMA node, as in cpuinfo_get_numa_node, or UINT32_MAX for the whole pool.
+ * @param[out] pool - current state of the pool.
+ * @returns true on success, or false if an index is invalid or the numbers of pages can't be read.
+ */
+bool CPUINFO_ABI cpuinfo_query_huge_page_pool(uint32_t pool_index, uint32_t numa_node_index,
+	struct cpuinfo_huge_page_pool* pool);
+
+/** Returns the transparent huge pages configuration at initialization */
+const struct cpuinfo_transparent_huge_pages* CPUINFO_ABI cpuinfo_get_transparent_huge_pages(void);
+
+/** Returns the frequency domains, in the order of their first logical processors */
+const struct cpuinfo_frequency_domain* CPUINFO_ABI cpuinfo_get_frequency_domains(void);
+uint32_t CPUINFO_ABI cpuinfo_get_frequency_domains_count(void);
+const struct cpuinfo_frequency_domain* CPUINFO_ABI cpuinfo_get_frequency_domain(uint32_t index);
+
+/** Returns the uncore frequency domains, in the order of their packages and dies, or NULL if there are none */
+const struct cpuinfo_uncore_domain* CPUINFO_ABI cpuinfo_get_uncore_domains(void);
+uint32_t CPUINFO_ABI cpuinfo_get_uncore_domains_count(void);
+const struct cpuinfo_uncore_domain* CPUINFO_ABI cpuinfo_get_uncore_domain(uint32_t index);
+/**
+ * Returns the uncore frequency domains of the dies of a package.
+ *
+ * @param package - package from the current tables, as from cpuinfo_get_package.
+ * @param[out] count - number of uncore domains of the package, which follow the returned one.
+ * @returns the first uncore domain of the package, or NULL if the package is invalid or has no uncore domains.
+ */
+const struct cpuinfo_uncore_domain* CPUINFO_ABI cpuinfo_get_package_uncore_domains(
+	const struct cpuinfo_package* package, uint32_t* count);
+
+/** Settings which make benchmark results noisy or unrepresentative, as bits in a mask */
+enum cpuinfo_environment_warning {
+	/** The frequency scaling governor is not "performance" */
+	cpuinfo_environment_warning_governor = 0x01,
+	/** Boost (turbo) frequencies are enabled */
+	cpuinfo_environment_warning_boost = 0x02,
+	/** The current maximum frequency is below the maximum frequency of the hardware */
+	cpuinfo_environment_warning_frequency_cap = 0x04,
+	/** Simultaneous multithreading is enabled */
+	cpuinfo_environment_warning_smt = 0x08,
+	/** No logical processors are isolated from load balancing of the scheduler */
+	cpuinfo_environment_warning_no_isolated_processors = 0x10,
+	/** The governor or the current frequency limits of the frequency domain can't be read */
+	cpuinfo_environment_warning_unknown_frequency = 0x20,
+	/** The energy-performance preference is known and is not "performance" */
+	cpuinfo_environment_warning_energy_performance_preference = 0x40,
+};
+
+/** Current frequency scaling settings of a frequency domain */
+struct cpuinfo_frequency_domain_environment {
+	/** Name of the frequency scaling governor, or empty string if unknown */
+	char governor[CPUINFO_GOVERNOR_NAME_MAX];
+	/** Whether boost (turbo) frequencies are enabled */
+	bool boost;
+	/** Current lower limit of frequency scaling, in Hz, or 0 if unknown (on Linux, cpufreq/scaling_min_freq) */
+	uint64_t min_frequency;
+	/** Current upper limit of frequency scaling, in Hz, or 0 if unknown (on Linux, cpufreq/scaling_max_freq) */
+	uint64_t max_frequency;
+	/** Current maximum frequency of the hardware, in Hz, or 0 if unknown (on Linux, cpufreq/cpuinfo_max_freq) */
+	uint64_t hardware_max_frequency;
+	/** Current energy-performance preference; on Linux, cpufreq/energy_performance_preference */
+	enum cpuinfo_energy_performance_preference energy_performance_preference;
+	/** Mask of cpuinfo_environment_warning bits for the frequency domain */
+	uint32_t warnings;
+};
+
+/** Settings of the system which affect the stability of benchmark results */
+struct cpuinfo_benchmark_environment {
+	/** Simultaneous multithreading control of the OS */
+	enum cpuinfo_smt_control smt_control;
+	/** Number of logical processors isolated from load balancing, as in cpuinfo_get_isolated_processors_count */
+	uint32_t isolated_processors_count;
+	/** Mask of cpuinfo_environment_warning bits for the system, including the bits of all frequency domains */
+	uint32_t warnings;
+};
+
+/**
+ * Read the current settings of the system which affect the stability of benchmark results. The settings are read
+ * from small OS files on every call, so that benchmark harnesses can reject or annotate a run before it starts.
+ *
+ * @param[out] environment - settings of the whole system.
+ * @param[out] domains - either NULL, or an array of cpuinfo_get_frequency_domains_count() entries for the settings
+ *                       of frequency domains, in the order of cpuinfo_get_frequency_domains.
+ * @returns true on success, or false if environment is NULL.
+ */
+bool CPUINFO_ABI cpuinfo_check_benchmark_environment(struct cpuinfo_benchmark_environment* environment,
+	struct cpuinfo_frequency_domain_environment* domains);
+
+/**
+ * Read the current energy-performance preference of a frequency domain. Unlike the energy_performance_preference
+ * member of the domain, the preference is read on every call, and reflects changes by power management daemons.
+ *
+ * @param domain - frequency domain from the current tables, as from cpuinfo_get_frequency_domain.
+ * @returns the preference, or cpuinfo_energy_performance_preference_unknown if the domain is invalid or the driver
+ *          doesn't support preferences.
+ */
+enum cpuinfo_energy_performance_preference CPUINFO_ABI cpuinfo_get_energy_performance_preference(
+	const struct cpuinfo_frequency_domain* domain);
+
+/**
+ * Set the energy-performance preference of a frequency domain, e.g. to "performance" for latency-critical services.
+ *
+ * On Linux the preference is written to cpufreq/energy_performance_preference of the policy, which requires write
+ * access to sysfs, usually root. intel_pstate accepts only "performance" while the governor is "performance".
+ *
+ * @param domain - frequency domain from the current tables, as from cpuinfo_get_frequency_domain.
+ * @param preference - one of the named preferences, from default to power.
+ * @returns true if the driver accepted the preference, or false if the domain is invalid, the preference is not in
+ *          energy_performance_preferences of the domain, or the OS denied the change.
+ */
+bool CPUINFO_ABI cpuinfo_set_energy_performance_preference(const struct cpuinfo_frequency_domain* domain,
+	enum cpuinfo_energy_performance_preference preference);
+
+/**
+ * Sampler of current frequencies: keeps the OS files with frequencies and performance counters open, so that every
+ * sample costs only a read per frequency domain or core. Samplers are not thread-safe.
+ */
+struct cpuinfo_frequency_sampler;
 
-static inline bool cpuinfo_has_x86_mmx_plus(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.mmx_plus;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a sampler for the frequency domains, uncore domains, cores, and clusters of the current tables.
+ *
+ * @returns the sampler, or NULL if it could not be allocated.
+ */
+struct cpuinfo_frequency_sampler* CPUINFO_ABI cpuinfo_create_frequency_sampler(void);
+void CPUINFO_ABI cpuinfo_destroy_frequency_sampler(struct cpuinfo_frequency_sampler* sampler);
 
-static inline bool cpuinfo_has_x86_3dnow(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.three_d_now;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample current frequencies, in Hz, of domain_count frequency domains starting at domain_start, as selected by the
+ * frequency scaling driver (scaling_cur_freq on Linux). Frequencies of domains without the information are 0.
+ *
+ * @returns true if the frequency of at least one domain was sampled, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_domain_frequencies(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t domain_start,
+	uint32_t domain_count,
+	uint64_t* frequencies);
 
-static inline bool cpuinfo_has_x86_3dnow_plus(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.three_d_now_plus;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample current uncore frequencies, in Hz, of domain_count uncore domains starting at domain_start, in the order of
+ * cpuinfo_get_uncore_domains (current_freq_khz of intel_uncore_frequency on Linux). Frequencies of domains without
+ * the information are 0.
+ *
+ * @returns true if the frequency of at least one uncore domain was sampled, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_uncore_frequencies(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t domain_start,
+	uint32_t domain_count,
+	uint64_t* frequencies);
 
-static inline bool cpuinfo_has_x86_3dnow_geode(void) {
-	#if CPUINFO_ARCH_X86_64
-		return false;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return false;
-		#else
-			return cpuinfo_isa.three_d_now_geode;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample effective frequencies, in Hz, of core_count cores starting at core_start: the average clock rate of every
+ * core while it was not idle since its previous sample, measured with APERF and MPERF counters on x86 Linux.
+ * Throttled cores report effective frequencies below their nominal frequencies. The first sample of a core, and
+ * samples of cores without accessible counters, report 0.
+ *
+ * Counters are read through /dev/cpu/N/msr, which requires the msr driver and CAP_SYS_RAWIO, or else through the
+ * msr PMU of perf_event, which requires CAP_PERFMON or perf_event_paranoid of at most 0.
+ *
+ * @returns true if the counters are accessible, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_core_frequencies(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t core_start,
+	uint32_t core_count,
+	uint64_t* frequencies);
+
+/** Current limits on the capacity of a cluster, as sampled by cpuinfo_sample_cluster_capacities */
+struct cpuinfo_cluster_capacity {
+	/**
+	 * Current upper limit on the frequency of the cluster, in Hz, set by thermal, power, or user space policies
+	 * (scaling_max_freq of the cpufreq policy on Linux), or 0 if unknown.
+	 */
+	uint64_t max_frequency;
+	/** Number of logical processors of the cluster which are online */
+	uint32_t online_processors;
+	/**
+	 * Current state of the thermal cooling device which caps the frequency of the cluster, from 0 (not throttled) to
+	 * max_cooling_state. Both are 0 if the cluster has no such device.
+	 */
+	uint32_t cooling_state;
+	uint32_t max_cooling_state;
+	/**
+	 * Capacity of the cluster which is available now, relative to CPUINFO_CAPACITY_SCALE for all of its logical
+	 * processors online at the maximum frequency of the hardware: the fraction of online processors, scaled by the
+	 * ratio of max_frequency to the maximum frequency of the frequency domain. Multiply by capacity and core_count of
+	 * the cluster to compare clusters.
+	 */
+	uint32_t capacity_scale;
+};
 
-static inline bool cpuinfo_has_x86_prefetch(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.prefetch;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample current capacity limits of cluster_count clusters starting at cluster_start: frequency caps, online
+ * processors, and states of thermal cooling devices. A sample costs a few reads of sysfs files, and is cheap enough
+ * to poll every few hundred milliseconds while work is throttled on phones.
+ *
+ * On Linux, cooling devices are the cpufreq cooling devices of the thermal framework, /sys/class/thermal/
+ * cooling_deviceN with type "cpufreq-cpuM", which thermal zones bind to their trip points. Elsewhere, clusters report
+ * all processors online and capacity_scale of CPUINFO_CAPACITY_SCALE.
+ *
+ * @returns true if any limit was sampled, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_cluster_capacities(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t cluster_start,
+	uint32_t cluster_count,
+	struct cpuinfo_cluster_capacity* capacities);
+
+/** Location of the logical processor in the topology, as reported by cpuinfo_get_current_location */
+struct cpuinfo_location {
+	/** Logical processor that executes the current thread */
+	const struct cpuinfo_processor* processor;
+	/** Core that contains the logical processor */
+	const struct cpuinfo_core* core;
+	/** Cluster that contains the core */
+	const struct cpuinfo_cluster* cluster;
+	/** Package that contains the cluster */
+	const struct cpuinfo_package* package;
+	/** Last-level cache of the logical processor, or NULL if cpuinfo could not detect caches */
+	const struct cpuinfo_cache* last_level_cache;
+	/** Last-level cache domain of the logical processor */
+	const struct cpuinfo_llc_domain* llc_domain;
+	/** Microarchitecture index of the core, as returned by cpuinfo_get_current_uarch_index */
+	uint32_t uarch_index;
+	/** Dense index of the logical processor among usable processors, as returned by cpuinfo_get_current_slot */
+	uint32_t slot;
+	/** Dense index of the last-level cache domain, as returned by cpuinfo_get_current_llc_slot */
+	uint32_t llc_slot;
+};
 
-static inline bool cpuinfo_has_x86_prefetchw(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.prefetchw;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Identify the logical processor that executes the current thread, together with its core, cluster, package,
+ * microarchitecture index and last-level cache.
+ *
+ * Unlike separate calls to cpuinfo_get_current_processor, cpuinfo_get_current_core and
+ * cpuinfo_get_current_uarch_index, this function reads the processor number only once, so all fields describe the
+ * same logical processor. Same as for the other functions, the thread may migrate to another processor at any time,
+ * and callers should treat the result as only a hint.
+ *
+ * @param[out] location - pointer to the structure to be filled with the location of the current logical processor.
+ * @returns true if the location was identified, and false if the system does not support such identification.
+ *          On failure, all pointers in the location are NULL and the microarchitecture index is 0.
+ */
+bool CPUINFO_ABI cpuinfo_get_current_location(struct cpuinfo_location* location);
 
-static inline bool cpuinfo_has_x86_prefetchwt1(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.prefetchwt1;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns a dense index of the logical processor that executes the current thread, for indexing per-processor shards
+ * of counters, free lists and statistics in compact arrays with cpuinfo_get_usable_processors_count() entries.
+ *
+ * Usable processors have distinct slots in [0, cpuinfo_get_usable_processors_count()), in the order of their indices.
+ * Processors which were not usable at initialization share the slots of usable processors, and slot 0 is returned if
+ * the processor can't be identified, so the result is always a valid index, but shards must tolerate concurrent
+ * updates from threads which migrate or run outside the usable processors. The slot is read from a table indexed by
+ * the processor number which cpuinfo_get_current_processor uses, and costs the same.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_current_slot(void);
 
-static inline bool cpuinfo_has_x86_daz(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.daz;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns a dense index of the last-level cache domain of the logical processor that executes the current thread,
+ * for sharding data structures per last-level cache in compact arrays with cpuinfo_get_llc_slots_count() entries.
+ *
+ * Domains with usable processors have distinct slots, in the order of their first logical processors. Other domains
+ * share their slots, and slot 0 is returned if the processor can't be identified.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_current_llc_slot(void);
 
-static inline bool cpuinfo_has_x86_sse(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.sse;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/** Returns the number of last-level cache slots: the number of last-level cache domains with usable processors */
+uint32_t CPUINFO_ABI cpuinfo_get_llc_slots_count(void);
 
-static inline bool cpuinfo_has_x86_sse2(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.sse2;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Counter sharded per logical processor, for statistics which many threads update and few read. On x86-64 Linux with
+ * restartable sequences registered by the C library, every usable processor has its own shard, which threads update
+ * in an rseq critical section without atomic instructions. Otherwise, and for threads on processors which were not
+ * usable when the counter was created, threads add atomically to the shards of their last-level cache domains.
+ * Counters are thread-safe.
+ */
+struct cpuinfo_percpu_counter;
 
-static inline bool cpuinfo_has_x86_sse3(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.sse3;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a counter with value 0, with shards for the usable processors and last-level cache domains of the current
+ * tables.
+ *
+ * @returns the counter, or NULL if memory allocation failed or cpuinfo is not initialized.
+ */
+struct cpuinfo_percpu_counter* CPUINFO_ABI cpuinfo_create_percpu_counter(void);
+void CPUINFO_ABI cpuinfo_destroy_percpu_counter(struct cpuinfo_percpu_counter* counter);
 
-static inline bool cpuinfo_has_x86_ssse3(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.ssse3;
-		#endif
-	#else
-		return false;
-	#endif
-}
+/** Add a value, which may be negative, to the shard of the processor that executes the current thread */
+void CPUINFO_ABI cpuinfo_percpu_counter_add(struct cpuinfo_percpu_counter* counter, int64_t value);
 
-static inline bool cpuinfo_has_x86_sse4_1(void) {
-	#if CPUINFO_ARCH_X86_64
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.sse4_1;
-		#endif
-	#elif CPUINFO_ARCH_X86
-		return cpuinfo_isa.sse4_1;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the sum of all shards. Additions which run concurrently with the read may or may not be included, so the
+ * sum is exact only when no thread updates the counter.
+ */
+int64_t CPUINFO_ABI cpuinfo_percpu_counter_read(const struct cpuinfo_percpu_counter* counter);
 
-static inline bool cpuinfo_has_x86_sse4_2(void) {
-	#if CPUINFO_ARCH_X86_64
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.sse4_2;
-		#endif
-	#elif CPUINFO_ARCH_X86
-		return cpuinfo_isa.sse4_2;
-	#else
-		return false;
-	#endif
-}
+/** Node of a per-processor free list, embedded by the caller in the free objects */
+struct cpuinfo_percpu_freelist_node {
+	struct cpuinfo_percpu_freelist_node* next;
+};
 
-static inline bool cpuinfo_has_x86_sse4a(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.sse4a;
-	#else
-		return false;
-	#endif
-}
+/**
+ * LIFO free list sharded per logical processor, for caching free objects close to the processors which reuse them.
+ * Shards are the same as of struct cpuinfo_percpu_counter: per usable processor and updated in rseq critical sections
+ * on x86-64 Linux, or per last-level cache domain and protected by spin locks otherwise. Pops take a node from the
+ * shard of the current processor, else from the shards of last-level cache domains, but never from the shards of
+ * other processors, so callers should allocate new objects when a pop returns NULL. Free lists are thread-safe.
+ */
+struct cpuinfo_percpu_freelist;
 
-static inline bool cpuinfo_has_x86_misaligned_sse(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.misaligned_sse;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create an empty free list with shards for the usable processors and last-level cache domains of the current tables.
+ *
+ * @returns the free list, or NULL if memory allocation failed or cpuinfo is not initialized.
+ */
+struct cpuinfo_percpu_freelist* CPUINFO_ABI cpuinfo_create_percpu_freelist(void);
 
-static inline bool cpuinfo_has_x86_avx(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx;
-	#else
-		return false;
-	#endif
-}
+/** Destroy a free list. Nodes which remain in the list are not touched, and remain owned by the caller. */
+void CPUINFO_ABI cpuinfo_destroy_percpu_freelist(struct cpuinfo_percpu_freelist* freelist);
 
-static inline bool cpuinfo_has_x86_fma3(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.fma3;
-	#else
-		return false;
-	#endif
-}
+/** Push a node to the shard of the processor that executes the current thread */
+void CPUINFO_ABI cpuinfo_percpu_freelist_push(struct cpuinfo_percpu_freelist* freelist,
+	struct cpuinfo_percpu_freelist_node* node);
 
-static inline bool cpuinfo_has_x86_fma4(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.fma4;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Pop the node which was pushed last to the shard of the processor that executes the current thread.
+ *
+ * @returns the node, or NULL if the shards available to the current processor are empty.
+ */
+struct cpuinfo_percpu_freelist_node* CPUINFO_ABI cpuinfo_percpu_freelist_pop(struct cpuinfo_percpu_freelist* freelist);
 
-static inline bool cpuinfo_has_x86_xop(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.xop;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns true if per-processor counters and free lists update per-processor shards in restartable sequences, and
+ * false if they fall back to atomic updates of per-LLC shards.
+ */
+bool CPUINFO_ABI cpuinfo_percpu_is_restartable(void);
+
+/** Phases of cpuinfo initialization, timed separately in struct cpuinfo_init_stats */
+enum cpuinfo_init_phase {
+	/** Parsing of the lists of possible and present processors */
+	cpuinfo_init_phase_cpulists = 0,
+	/** Parsing of /proc/cpuinfo */
+	cpuinfo_init_phase_proc_cpuinfo = 1,
+	/** Reading of per-processor sysfs attributes, such as frequencies and siblings */
+	cpuinfo_init_phase_sysfs = 2,
+	/** Decoding of CPUID or MIDR values into vendor, microarchitecture, and ISA */
+	cpuinfo_init_phase_decode = 3,
+	/** Decoding of cache parameters */
+	cpuinfo_init_phase_caches = 4,
+	/** Detection of the chipset */
+	cpuinfo_init_phase_chipset = 5,
+	/** Assembly of processor, core, cluster, package, and cache tables */
+	cpuinfo_init_phase_tables = 6,
+	/** Maximum value of cpuinfo_init_phase */
+	cpuinfo_init_phase_max = 7,
+};
 
-static inline bool cpuinfo_has_x86_f16c(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.f16c;
-	#else
-		return false;
-	#endif
-}
+/** Timing and I/O statistics of the last initialization */
+struct cpuinfo_init_stats {
+	/**
+	 * Wall time spent in each phase of the initialization, in nanoseconds.
+	 * Phases which are not separately instrumented on the platform are reported as 0.
+	 */
+	uint64_t phase_time_ns[cpuinfo_init_phase_max];
+	/** Wall time of the whole initialization, in nanoseconds */
+	uint64_t total_time_ns;
+	/** Number of files opened by cpuinfo during initialization */
+	uint32_t files_opened;
+	/** Number of bytes read from the files opened by cpuinfo during initialization */
+	uint64_t bytes_read;
+	/**
+	 * Number of CPUID instructions executed to detect the initializing processor (x86 only). Every CPUID exits to
+	 * the hypervisor in virtual machines, so cpuinfo executes every leaf once, and records its values.
+	 */
+	uint32_t cpuid_executed;
+	/** Number of CPUID queries answered from the recorded leaves instead of re-executing CPUID (x86 only) */
+	uint32_t cpuid_cached;
+};
 
-static inline bool cpuinfo_has_x86_avx2(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx2;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Retrieve timing and I/O statistics of the last initialization, e.g. to identify systems with slow kernel interfaces.
+ *
+ * The statistics describe the last detection of the system, by cpuinfo_initialize, cpuinfo_initialize_ex, or
+ * cpuinfo_reinitialize. Initialization from a snapshot does not change the statistics.
+ *
+ * @param[out] stats - pointer to the structure to be filled with the statistics.
+ * @returns true if the statistics are available, and false if cpuinfo did not detect the system yet.
+ */
+bool CPUINFO_ABI cpuinfo_get_init_stats(struct cpuinfo_init_stats* stats);
 
-static inline bool cpuinfo_has_x86_avx512f(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512f;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Affinity of a topology object: the set of its logical processors in the native representation of the operating
+ * system. Affinities are precomputed during initialization, and remain valid as long as the topology object.
+ */
+struct cpuinfo_affinity {
+	/** Index of the first logical processor of the topology object */
+	uint32_t processor_start;
+	/**
+	 * Number of logical processors in the topology object. Logical processors of a microarchitecture may be not
+	 * contiguous: use processor_mask to enumerate them.
+	 */
+	uint32_t processor_count;
+	/** Number of 64-bit words in processor_mask, the same for all affinities, see cpuinfo_get_processor_mask_words */
+	uint32_t processor_mask_words;
+	/**
+	 * Mask over indices of logical processors in cpuinfo tables: bit (i % 64) of word (i / 64) is set for logical
+	 * processor i of the topology object. Masks of different objects can be combined with bitwise operations, and
+	 * converted to the native representation with cpuinfo_processor_mask_to_* functions.
+	 */
+	const uint64_t* processor_mask;
+#if defined(__linux__)
+	/** Size of the CPU mask in bytes, as CPU_ALLOC_SIZE for the maximum Linux processor ID */
+	uint32_t linux_cpu_set_size;
+	/**
+	 * CPU mask with bits set for Linux IDs of the logical processors, compatible with cpu_set_t allocated by CPU_ALLOC:
+	 * - Pass it together with linux_cpu_set_size to sched_setaffinity or pthread_setaffinity_np.
+	 */
+	const unsigned long* linux_cpu_set;
+#endif
+#if defined(_WIN32) || defined(__CYGWIN__)
+	/**
+	 * Affinity layout-compatible with GROUP_AFFINITY structure, to be passed to SetThreadGroupAffinity.
+	 * A group affinity can't span several processor groups: if the topology object does, only the logical processors
+	 * in the group of its first logical processor are included.
+	 */
+	struct {
+		/** KAFFINITY mask of the logical processors within the group */
+		uintptr_t mask;
+		/** Processor group */
+		uint16_t group;
+		uint16_t reserved[3];
+	} windows_group_affinity;
+#endif
+#if defined(__MACH__) && defined(__APPLE__)
+	/**
+	 * Tag for THREAD_AFFINITY_POLICY: XNU tries to schedule threads with the same tag on processors that share L2 cache.
+	 * The tag is 1 + index of the L2 cache of the first logical processor, or 0 (no affinity) if L2 cache is unknown.
+	 */
+	int32_t mach_affinity_tag;
+#endif
+};
 
-static inline bool cpuinfo_has_x86_avx512pf(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512pf;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Get the precomputed affinity of a topology object.
+ *
+ * The topology object must come from the tables of the current cpuinfo initialization.
+ *
+ * @returns pointer to the affinity of the topology object, or NULL if the object is not from cpuinfo tables.
+ */
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_processor_affinity(const struct cpuinfo_processor* processor);
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_core_affinity(const struct cpuinfo_core* core);
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_cluster_affinity(const struct cpuinfo_cluster* cluster);
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_package_affinity(const struct cpuinfo_package* package);
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_cache_affinity(const struct cpuinfo_cache* cache);
 
-static inline bool cpuinfo_has_x86_avx512er(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512er;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Get the precomputed affinity of the logical processors with a microarchitecture.
+ *
+ * @param index - index of the microarchitecture, as for cpuinfo_get_uarch.
+ * @returns pointer to the affinity of the microarchitecture, or NULL if the index is out of range.
+ */
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_uarch_affinity(uint32_t index);
 
-static inline bool cpuinfo_has_x86_avx512cd(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512cd;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Get the number of 64-bit words in processor masks of affinities, i.e. the number of logical processors rounded up
+ * to a multiple of 64, divided by 64.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_mask_words(void);
 
-static inline bool cpuinfo_has_x86_avx512dq(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512dq;
-	#else
-		return false;
-	#endif
-}
+#if defined(__linux__)
+/**
+ * Convert a processor mask, e.g. a combination of processor_mask fields of affinities, to a CPU mask with bits set
+ * for Linux IDs of the logical processors, compatible with cpu_set_t allocated by CPU_ALLOC.
+ *
+ * @param[in] processor_mask - mask of cpuinfo_get_processor_mask_words() words over indices of logical processors.
+ * @param[out] cpu_set - CPU mask to be cleared and filled.
+ * @param cpu_set_size - size of the CPU mask in bytes, at least the linux_cpu_set_size of affinities.
+ * @returns true if the mask was converted, and false if the CPU mask is too small.
+ */
+bool CPUINFO_ABI cpuinfo_processor_mask_to_linux_cpu_set(const uint64_t* processor_mask, unsigned long* cpu_set,
+	uint32_t cpu_set_size);
+#endif
 
-static inline bool cpuinfo_has_x86_avx512bw(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512bw;
-	#else
-		return false;
-	#endif
-}
+#if defined(_WIN32) || defined(__CYGWIN__)
+/**
+ * Convert a processor mask, e.g. a combination of processor_mask fields of affinities, to the KAFFINITY mask of the
+ * logical processors within a processor group, as in GROUP_AFFINITY structure.
+ *
+ * @param[in] processor_mask - mask of cpuinfo_get_processor_mask_words() words over indices of logical processors.
+ * @param group - processor group.
+ * @param[out] group_mask - KAFFINITY mask of the logical processors of the processor mask within the group.
+ * @returns true if any logical processor of the processor mask is in the group.
+ */
+bool CPUINFO_ABI cpuinfo_processor_mask_to_windows_group_affinity(const uint64_t* processor_mask, uint16_t group,
+	uintptr_t* group_mask);
+
+/** State of the CPU set of a logical processor, as reported by GetSystemCpuSetInformation */
+struct cpuinfo_windows_cpu_set_state {
+	/** Whether the OS parked the logical processor to save power: threads avoid it until it is unparked */
+	bool parked;
+	/** Whether the logical processor is allocated to a process, e.g. a game, for exclusive use */
+	bool allocated;
+	/** Whether the logical processor is allocated to the current process */
+	bool allocated_to_current_process;
+	/** Whether the logical processor is reserved for real-time threads, and doesn't run other threads */
+	bool realtime;
+	/** Efficiency class of the core, as windows_efficiency_class of cpuinfo_core */
+	uint8_t efficiency_class;
+	/** Scheduling class of the logical processor: the OS prefers processors of higher classes */
+	uint8_t scheduling_class;
+};
 
-static inline bool cpuinfo_has_x86_avx512vl(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512vl;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Query the current state of the CPU set of a logical processor. The state changes at runtime, e.g. the OS parks
+ * processors under light load.
+ *
+ * @param processor - logical processor from the tables of the current cpuinfo initialization.
+ * @param[out] state - state of the CPU set.
+ * @returns true on success, or false if the processor is not from cpuinfo tables or the OS doesn't support CPU sets.
+ */
+bool CPUINFO_ABI cpuinfo_get_windows_cpu_set_state(const struct cpuinfo_processor* processor,
+	struct cpuinfo_windows_cpu_set_state* state);
 
-static inline bool cpuinfo_has_x86_avx512ifma(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512ifma;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Select the CPU sets of the logical processors in the affinity for the calling thread with SetThreadSelectedCpuSets.
+ * Unlike group affinities, selected CPU sets can span processor groups, and the OS may still run the thread elsewhere
+ * if the selected processors are allocated to another process. The function allocates a temporary array of IDs.
+ *
+ * @param affinity - affinity of a topology object, or NULL to clear the selection.
+ * @returns true if the selection was changed, and false if the OS doesn't support CPU sets or the call failed.
+ */
+bool CPUINFO_ABI cpuinfo_select_current_thread_cpu_sets(const struct cpuinfo_affinity* affinity);
+#endif
 
-static inline bool cpuinfo_has_x86_avx512vbmi(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512vbmi;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Restrict the calling thread to the logical processors in the affinity.
+ *
+ * On Linux and Windows the thread is pinned to the logical processors. On Apple platforms, the affinity is only a
+ * scheduling hint via THREAD_AFFINITY_POLICY, which is not supported on Apple Silicon.
+ * The functions don't allocate memory, and are safe to call on hot paths.
+ *
+ * @returns true if the affinity of the thread was changed, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_set_current_thread_affinity(const struct cpuinfo_affinity* affinity);
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_processor(const struct cpuinfo_processor* processor);
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_core(const struct cpuinfo_core* core);
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_cluster(const struct cpuinfo_cluster* cluster);
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_package(const struct cpuinfo_package* package);
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_cache(const struct cpuinfo_cache* cache);
+
+/** Preference of a thread for the cores of heterogeneous systems, see cpuinfo_set_current_thread_core_preference */
+enum cpuinfo_core_preference {
+	/** No preference: the OS may run the thread on any core */
+	cpuinfo_core_preference_none = 0,
+	/** Prefer the highest-performance cores, e.g. for latency-sensitive work */
+	cpuinfo_core_preference_performance = 1,
+	/** Prefer the most power-efficient cores, e.g. for background work */
+	cpuinfo_core_preference_efficiency = 2,
+};
 
-static inline bool cpuinfo_has_x86_avx512vbmi2(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512vbmi2;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Express the preference of the calling thread for big or efficiency cores with the mechanism of the platform:
+ * - On Apple platforms, which don't support pinning, the QoS class of the thread: QOS_CLASS_USER_INITIATED for
+ *   performance, QOS_CLASS_BACKGROUND for efficiency, and QOS_CLASS_DEFAULT without preference.
+ * - On Windows, power throttling of the thread: disabled for performance, enabled for efficiency, and managed by the
+ *   OS without preference. On Windows 10 and later, the CPU sets of the microarchitecture with the highest or lowest
+ *   efficiency class are also selected, and the selection is cleared without preference.
+ * - On Linux, affinity to the logical processors of the microarchitecture with the highest or lowest capacity and
+ *   performance, or to all usable logical processors without preference.
+ * On systems with a single microarchitecture, affinities and CPU sets include all logical processors.
+ *
+ * @returns true if the mechanism of the platform was applied, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_set_current_thread_core_preference(enum cpuinfo_core_preference preference);
 
-static inline bool cpuinfo_has_x86_avx512bitalg(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512bitalg;
-	#else
-		return false;
-	#endif
-}
+/** Number of Linux processor IDs which cpuinfo_thread_affinity_state can store, as the largest NR_CPUS of Linux */
+#define CPUINFO_THREAD_AFFINITY_MAX_LINUX_CPUS 8192
 
-static inline bool cpuinfo_has_x86_avx512vpopcntdq(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512vpopcntdq;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Affinity of a thread in the native representation of the operating system, saved to be restored after temporary
+ * pinning. The state is stored inline, and saving or restoring it doesn't allocate memory.
+ */
+struct cpuinfo_thread_affinity_state {
+	/** Whether the state was saved successfully, and can be restored */
+	bool valid;
+#if defined(__linux__)
+	/** CPU mask as returned by sched_getaffinity */
+	unsigned long linux_cpu_set[CPUINFO_THREAD_AFFINITY_MAX_LINUX_CPUS / (sizeof(unsigned long) * 8)];
+#endif
+#if defined(_WIN32) || defined(__CYGWIN__)
+	/** Affinity layout-compatible with GROUP_AFFINITY structure, as returned by GetThreadGroupAffinity */
+	struct {
+		uintptr_t mask;
+		uint16_t group;
+		uint16_t reserved[3];
+	} windows_group_affinity;
+#endif
+#if defined(__MACH__) && defined(__APPLE__)
+	/** Tag of THREAD_AFFINITY_POLICY of the thread */
+	int32_t mach_affinity_tag;
+#endif
+};
 
-static inline bool cpuinfo_has_x86_avx512vnni(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512vnni;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Save the affinity of the calling thread, to restore it later with cpuinfo_restore_current_thread_affinity.
+ *
+ * @param[out] state - state to fill in; on failure its valid field is cleared.
+ * @returns true if the affinity was saved, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_save_current_thread_affinity(struct cpuinfo_thread_affinity_state* state);
 
-static inline bool cpuinfo_has_x86_avx512bf16(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512bf16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Restore the affinity of the calling thread saved by cpuinfo_save_current_thread_affinity.
+ *
+ * @returns true if the affinity was restored, and false if the state is not valid or the OS call failed.
+ */
+bool CPUINFO_ABI cpuinfo_restore_current_thread_affinity(const struct cpuinfo_thread_affinity_state* state);
 
-static inline bool cpuinfo_has_x86_avx512fp16(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512fp16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Policies for placement of worker threads on logical processors by cpuinfo_plan_workers.
+ *
+ * All policies except cpuinfo_worker_policy_isolated avoid isolated and nohz_full logical processors, unless every
+ * usable processor is isolated or nohz_full.
+ */
+enum cpuinfo_worker_policy {
+	/**
+	 * Pack workers on adjacent logical processors: SMT siblings of a core, then other cores of the same cluster,
+	 * then other clusters. Cores with higher performance come first on heterogeneous ARM systems.
+	 */
+	cpuinfo_worker_policy_compact = 0,
+	/**
+	 * Spread workers round-robin across groups of logical processors which share the last-level cache.
+	 * Within a group, physical cores are used before their SMT siblings.
+	 */
+	cpuinfo_worker_policy_scatter_llc = 1,
+	/**
+	 * Spread workers round-robin across physical packages.
+	 * Within a package, physical cores are used before their SMT siblings.
+	 */
+	cpuinfo_worker_policy_scatter_package = 2,
+	/** Use only the first logical processor of every core, in the order of cores */
+	cpuinfo_worker_policy_physical_cores = 3,
+	/**
+	 * Use cores with higher frequency first, and physical cores before their SMT siblings.
+	 * Cores with equal frequency, e.g. when frequency is unknown, are used in the same order as with the compact policy.
+	 */
+	cpuinfo_worker_policy_big_cores_first = 4,
+	/**
+	 * Use only isolated and nohz_full logical processors, in the order of processors, e.g. for polling threads.
+	 * The plan is empty if there are no such processors.
+	 */
+	cpuinfo_worker_policy_isolated = 5,
+};
 
-static inline bool cpuinfo_has_x86_avx512vp2intersect(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512vp2intersect;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Choose logical processors for worker threads according to a placement policy.
+ *
+ * If there are more workers than the logical processors admitted by the policy, the assignment wraps around,
+ * and several workers are placed on a logical processor.
+ *
+ * @param workers_count - number of worker threads to place.
+ * @param policy - placement policy.
+ * @param[out] processors - array of workers_count elements to be filled with the logical processors for each worker.
+ * @returns the number of distinct logical processors in the plan, or 0 if the policy is not supported or the plan
+ *          could not be computed.
+ */
+uint32_t CPUINFO_ABI cpuinfo_plan_workers(uint32_t workers_count, enum cpuinfo_worker_policy policy,
+	const struct cpuinfo_processor** processors);
 
-static inline bool cpuinfo_has_x86_avx512_4vnniw(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512_4vnniw;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Choose logical processors for the stages of a pipeline, or of another small graph of threads which hand buffers to
+ * each other, so that stages with heavy traffic share the nearest caches, as in cpuinfo_get_processor_distance, and
+ * don't communicate across NUMA nodes and packages.
+ *
+ * Stages are placed on usable logical processors, leaving out isolated and nohz_full processors unless no others
+ * remain, and on distinct cores if there are enough cores. If there are more stages than processors, several stages
+ * share a processor. The placement minimizes the traffic weighted by the distance between processors with a greedy
+ * search and local improvements rather than exhaustively, and is meant for graphs of up to a few dozen stages.
+ *
+ * @param stage_count - number of stages.
+ * @param edge_weights - matrix of stage_count squared relative traffic weights, where the entry at
+ *                       (i * stage_count + j) is the traffic from stage i to stage j, e.g. non-zero only for j = i + 1
+ *                       in a linear pipeline. Both directions of a pair of stages count the same.
+ * @param[out] processors - array of stage_count elements to be filled with the logical processors for each stage.
+ * @returns the number of distinct logical processors in the placement, or 0 if the arguments are invalid or the
+ *          placement could not be computed.
+ */
+uint32_t CPUINFO_ABI cpuinfo_place_pipeline(uint32_t stage_count, const uint32_t* edge_weights,
+	const struct cpuinfo_processor** processors);
 
-static inline bool cpuinfo_has_x86_avx512_4fmaps(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.avx512_4fmaps;
-	#else
-		return false;
-	#endif
-}
+/** Items [start, end) of a range assigned to one logical processor by cpuinfo_partition */
+struct cpuinfo_partition_range {
+	uint64_t start;
+	uint64_t end;
+};
 
-static inline bool cpuinfo_has_x86_hle(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.hle;
-	#else
-		return false;
-	#endif
-}
+struct cpuinfo_capability_monitor;
 
-static inline bool cpuinfo_has_x86_rtm(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.rtm;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Split items [0, range) into contiguous ranges for logical processors, in proportion to the compute capacity of their
+ * cores, so that workers of a statically scheduled loop finish together on heterogeneous systems.
+ *
+ * Capacity of a core is, in order of preference:
+ * - its HFI performance capability from the monitor, if the monitor has capabilities of all participating cores;
+ * - the capacity field of the core, if it differs between participating cores, e.g. cpu_capacity on ARM Linux;
+ * - the peak FP32 throughput of cpuinfo_get_core_peak_throughput, i.e. the cost model times the frequency, if it is
+ *   known for all participating cores, e.g. for P-cores and E-cores of hybrid x86 processors;
+ * - equal capacity otherwise.
+ * Logical processors of the same core split its capacity evenly. Processors with zero capacity, e.g. cores which HFI
+ * asks to avoid, get empty ranges, unless all processors have zero capacity.
+ *
+ * @param range - number of items to split.
+ * @param processors_count - number of participating logical processors.
+ * @param processors - participating logical processors from the current tables, e.g. from cpuinfo_plan_workers. A
+ *                     processor may appear several times, and every appearance gets its own range.
+ * @param monitor - optional monitor of core capabilities, or NULL.
+ * @param[out] ranges - array of processors_count ranges, which cover [0, range) in the order of processors.
+ * @returns true on success, or false if an argument is invalid.
+ */
+bool CPUINFO_ABI cpuinfo_partition(uint64_t range, uint32_t processors_count,
+	const struct cpuinfo_processor** processors, const struct cpuinfo_capability_monitor* monitor,
+	struct cpuinfo_partition_range* ranges);
+
+/** Shapes of the subtrees within topology domains of reduction trees built by cpuinfo_build_reduction_tree */
+enum cpuinfo_tree_fanout {
+	/** The first member of a domain is the parent of all other members, for the shallowest tree */
+	cpuinfo_tree_fanout_flat = 0,
+	/** Members of a domain form a binary tree, for a bounded number of children of every participant */
+	cpuinfo_tree_fanout_binary = 1,
+	/** Members of a domain form a tree with up to 4 children of every participant */
+	cpuinfo_tree_fanout_quaternary = 2,
+};
 
-static inline bool cpuinfo_has_x86_xtest(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.xtest;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Build a tree of participants of a barrier or a reduction, e.g. threads on the logical processors, which follows the
+ * topology: participants which share a core are siblings at the leaves, and the roots of their subtrees join the
+ * participants which share the L2 cache, then the L3 cache, the cluster, the NUMA node, the package, and the system,
+ * as the levels of cpuinfo_get_processor_distance. Every level combines subtrees of the next inner level, so that
+ * only one participant of every domain exchanges cache lines with other domains.
+ *
+ * Members of every domain are ordered by the index of their logical processor, and by their index among participants
+ * on the same processor; the first of them is the root of the subtree of the domain.
+ *
+ * @param participants_count - number of participants.
+ * @param processors - logical processors of the participants, from the current tables. Several participants may share a
+ *                     logical processor.
+ * @param fanout - shape of the subtrees within every domain.
+ * @param[out] parents - array of participants_count elements to be filled with the index of the parent of every
+ *                       participant, or UINT32_MAX for the root of the tree.
+ * @returns true on success, and false if the arguments are invalid or a processor is not in the current tables.
+ */
+bool CPUINFO_ABI cpuinfo_build_reduction_tree(uint32_t participants_count,
+	const struct cpuinfo_processor** processors, enum cpuinfo_tree_fanout fanout, uint32_t* parents);
 
-static inline bool cpuinfo_has_x86_mpx(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.mpx;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Cache blocking parameters for GEMM-like kernels which compute mr x nr tiles of C from packed panels of A and B.
+ *
+ * Parameters follow the analytical model of BLIS: a kc x nr micro-panel of B stays in L1 data cache while mr x kc
+ * micro-panels of A stream through it, an mc x kc block of A stays in L2, and a kc x nc block of B stays in L3.
+ * Every level reserves one way of the cache for streaming data, e.g. tiles of C, and splits the rest of the cache
+ * between logical processors which share it. Caches with unknown associativity are treated as 8-way.
+ */
+struct cpuinfo_blocking_hint {
+	/** Depth of micro-panels of A and B, in elements */
+	uint32_t kc;
+	/** Rows of the block of A which stays in L2 cache, a multiple of mr, or 0 if there is no L2 cache */
+	uint32_t mc;
+	/** Columns of the block of B which stays in L3 cache, a multiple of nr, or 0 if there is no L3 cache */
+	uint32_t nc;
+	/** Line size of L1 data cache, in bytes, to align the packed panels */
+	uint32_t line_size;
+};
 
-static inline bool cpuinfo_has_x86_cmov(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		return cpuinfo_isa.cmov;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Compute cache blocking parameters for cores of a microarchitecture.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param element_size - size of matrix elements, in bytes.
+ * @param mr - rows of the micro-tile of C computed by the kernel.
+ * @param nr - columns of the micro-tile of C computed by the kernel.
+ * @param[out] hint - blocking parameters.
+ * @returns true on success, or false if the arguments are invalid or cores of the microarchitecture have no L1 data
+ *          cache.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_blocking_hint(uint32_t uarch_index, uint32_t element_size, uint32_t mr,
+	uint32_t nr, struct cpuinfo_blocking_hint* hint);
 
-static inline bool cpuinfo_has_x86_cmpxchg8b(void) {
-	#if CPUINFO_ARCH_X86_64
-		return true;
-	#elif CPUINFO_ARCH_X86
-		return cpuinfo_isa.cmpxchg8b;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Compute cache blocking parameters for cores of the microarchitecture of the current processor, or of the first
+ * microarchitecture if the current processor can't be identified. See cpuinfo_get_uarch_blocking_hint.
+ */
+bool CPUINFO_ABI cpuinfo_get_blocking_hint(uint32_t element_size, uint32_t mr, uint32_t nr,
+	struct cpuinfo_blocking_hint* hint);
+
+/** Width of vectors to use in vectorized kernels on cores of a microarchitecture */
+struct cpuinfo_vector_hint {
+	/** Widest vectors, in bits, which the cores and the OS support: 512 for AVX-512, 256 for AVX, 128 for SSE */
+	uint32_t max_width;
+	/** Widest vectors, in bits, which kernels should use: max_width, or narrower if wider vectors are slow */
+	uint32_t preferred_width;
+	/**
+	 * Expected reduction of core frequency, in percent, while heavy instructions on 512-bit vectors run, or 0 if the
+	 * cores don't support 512-bit vectors or keep their frequency, e.g. 20 on Skylake-SP and 5 on Ice Lake.
+	 */
+	uint32_t wide_vector_frequency_penalty;
+};
 
-static inline bool cpuinfo_has_x86_cmpxchg16b(void) {
-	#if CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.cmpxchg16b;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Compute vector width hints for cores of a microarchitecture.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] hint - vector width hints.
+ * @returns true on success, or false if the index is invalid or the ISA has no vector instructions.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_vector_hint(uint32_t uarch_index, struct cpuinfo_vector_hint* hint);
 
-static inline bool cpuinfo_has_x86_clwb(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.clwb;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Vector instructions of cores of a microarchitecture, in the same terms on all architectures: SSE, AVX and AVX-512
+ * on x86, NEON, SVE and SME on ARM, V on RISC-V, LSX and LASX on LoongArch, and SIMD128 on WebAssembly.
+ */
+struct cpuinfo_vector_info {
+	/**
+	 * Widest vectors, in bits, which kernels should use: the preferred width of struct cpuinfo_vector_hint, which
+	 * avoids 512-bit vectors on x86 cores with large frequency penalties, or the current vector length of SVE and RVV
+	 */
+	uint32_t preferred_bits;
+	/** Widest vectors, in bits, which the cores and the OS support, including the current SVE and RVV vector length */
+	uint32_t max_bits;
+	/** Number of architectural vector registers, or 0 if the ISA has no register file (WebAssembly) */
+	uint32_t registers_count;
+	/** Number of architectural predicate registers: 8 opmask registers of AVX-512 and AVX10, 16 of SVE, else 0 */
+	uint32_t predicate_registers_count;
+	/** Vector instructions can execute under a mask: AVX-512 and AVX10 opmasks, SVE predicates, RVV masks in v0 */
+	bool predication;
+	/** The vector length is chosen at run time rather than by the instructions: SVE and RVV */
+	bool scalable;
+	/** Expected reduction of core frequency, in percent, while heavy instructions on 512-bit vectors run */
+	uint32_t wide_vector_frequency_penalty;
+};
 
-static inline bool cpuinfo_has_x86_movbe(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.movbe;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Describe vector instructions of cores of a microarchitecture. Widths of SVE and RVV are the vector length of the
+ * calling thread, which may change with cpuinfo_set_arm_sve_vector_length.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] info - description of vector instructions.
+ * @returns true on success, or false if the index is invalid or the ISA has no vector instructions.
+ */
+bool CPUINFO_ABI cpuinfo_get_vector_info(uint32_t uarch_index, struct cpuinfo_vector_info* info);
+
+/** Tiers of instructions for a data type of machine learning kernels, ordered from the least to the most capable */
+enum cpuinfo_ml_tier {
+	/** No instructions for the type: kernels convert or widen it with general instructions */
+	cpuinfo_ml_tier_none = 0,
+	/** Conversions only, for the type as a storage format: F16C, AVX-NE-CONVERT, ARM NEON FP16, RISC-V Zfhmin */
+	cpuinfo_ml_tier_convert = 1,
+	/**
+	 * Arithmetic on the type: dot products of AVX-VNNI, AVX512-VNNI and ARM DotProd for INT8, AVX512-BF16 for BF16,
+	 * AVX512-FP16, ARM FP16 arithmetic and RISC-V Zfh and Zvfh for FP16
+	 */
+	cpuinfo_ml_tier_arithmetic = 2,
+	/** Matrix multiplication of small blocks in vector registers: ARM I8MM for INT8, ARM BF16 (BFMMLA) for BF16 */
+	cpuinfo_ml_tier_vector_matmul = 3,
+	/** Matrix engine: AMX-INT8, AMX-BF16 and AMX-FP16 tiles, or outer products of ARM SME */
+	cpuinfo_ml_tier_matrix = 4,
+};
 
-static inline bool cpuinfo_has_x86_lahf_sahf(void) {
-	#if CPUINFO_ARCH_X86
-		return true;
-	#elif CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.lahf_sahf;
-	#else
-		return false;
-	#endif
-}
+/** Tiers of machine learning data types on cores of a microarchitecture */
+struct cpuinfo_ml_capabilities {
+	/** Tier of 8-bit integer products accumulated in 32-bit integers; never cpuinfo_ml_tier_convert */
+	enum cpuinfo_ml_tier int8;
+	/** Tier of bfloat16 */
+	enum cpuinfo_ml_tier bf16;
+	/** Tier of IEEE half precision */
+	enum cpuinfo_ml_tier fp16;
+	/** Width of vectors for the vector tiers, as the preferred width of cpuinfo_get_vector_info */
+	uint32_t vector_bits;
+};
 
-static inline bool cpuinfo_has_x86_lzcnt(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.lzcnt;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Classify the instructions for machine learning data types which cores of a microarchitecture support, so that
+ * runtimes choose kernels from the same tiers. Tiers use cpuinfo_get_uarch_isa_features, so they include features of
+ * big cores which the kernel doesn't report for all cores of ARM SoCs.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] capabilities - tiers to fill in.
+ * @returns true on success, or false if the index is invalid. Microarchitectures without vector instructions have
+ *          all tiers cpuinfo_ml_tier_none.
+ */
+bool CPUINFO_ABI cpuinfo_get_ml_capabilities(uint32_t uarch_index, struct cpuinfo_ml_capabilities* capabilities);
+
+/** PDEP and PEXT instructions are microcoded and much slower than software emulation, as on AMD Zen 1 and Zen 2 */
+#define CPUINFO_PITFALL_X86_SLOW_PDEP_PEXT     0x00000001
+/** VPGATHER instructions are slower than scalar loads: microcoded, or serialized by Downfall microcode mitigations */
+#define CPUINFO_PITFALL_X86_SLOW_GATHER        0x00000002
+/** Mixing SSE and dirty upper halves of AVX registers is slow: AVX code must end with VZEROUPPER */
+#define CPUINFO_PITFALL_X86_AVX_SSE_TRANSITION 0x00000004
+/** VZEROUPPER is slow and unnecessary, and AVX code should avoid it, as on Knights Landing */
+#define CPUINFO_PITFALL_X86_SLOW_VZEROUPPER    0x00000008
+/** 256-bit instructions are split in two 128-bit halves, and run at the throughput of 128-bit ones */
+#define CPUINFO_PITFALL_X86_SPLIT_256BIT       0x00000010
 
-static inline bool cpuinfo_has_x86_popcnt(void) {
-	#if CPUINFO_ARCH_X86_64
-		#if defined(__ANDROID__)
-			return true;
-		#else
-			return cpuinfo_isa.popcnt;
-		#endif
-	#elif CPUINFO_ARCH_X86
-		return cpuinfo_isa.popcnt;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns performance pitfalls of cores of a microarchitecture: instructions which the cores support, but which
+ * dispatchers should avoid, as a combination of CPUINFO_PITFALL_X86_* flags. On Linux, CPUINFO_PITFALL_X86_SLOW_GATHER
+ * is reported for Intel cores only if the kernel reports the microcode mitigation of Gather Data Sampling. Returns 0
+ * if the index is invalid or the microarchitecture has no known pitfalls.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_pitfalls(uint32_t uarch_index);
+
+/** Methods to compute checksums, ordered from the slowest to the fastest */
+enum cpuinfo_checksum_method {
+	/** Lookup tables, e.g. slicing-by-8 */
+	cpuinfo_checksum_method_software = 0,
+	/** CRC instructions on 64-bit words: SSE4.2 CRC32 for CRC32C only, ARMv8 CRC32 and CRC32C */
+	cpuinfo_checksum_method_crc_instruction = 1,
+	/**
+	 * Folding of 128-bit blocks with carry-less multiplication (PCLMULQDQ, ARM PMULL), interleaved with CRC
+	 * instructions where they exist for the polynomial
+	 */
+	cpuinfo_checksum_method_clmul = 2,
+	/** Folding with PMULL and three-way exclusive OR (EOR3 of the ARM SHA3 extension) */
+	cpuinfo_checksum_method_clmul_eor3 = 3,
+	/** Folding of vectors of clmul_bits bits with VPCLMULQDQ */
+	cpuinfo_checksum_method_vector_clmul = 4,
+};
 
-static inline bool cpuinfo_has_x86_tbm(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.tbm;
-	#else
-		return false;
-	#endif
-}
+/** Fastest methods for checksums and widths of AES instructions on cores of a microarchitecture */
+struct cpuinfo_checksum_capabilities {
+	/** Method for CRC32C (Castagnoli polynomial, as in iSCSI, ext4 and SCTP) */
+	enum cpuinfo_checksum_method crc32c;
+	/** Method for CRC32 with the IEEE polynomial, as in Ethernet, gzip and PNG */
+	enum cpuinfo_checksum_method crc32;
+	/** Method for CRC64 and for the GHASH and POLYVAL hashes, which only carry-less multiplication accelerates */
+	enum cpuinfo_checksum_method crc64;
+	/** Width of vectors for carry-less multiplication in bits: 128, 256 or 512 with VPCLMULQDQ, or 0 if unsupported */
+	uint32_t clmul_bits;
+	/** Width of vectors for AES rounds in bits: 128 for AES-NI and ARM AES, 256 or 512 with VAES, or 0 if unsupported */
+	uint32_t aes_bits;
+};
 
-static inline bool cpuinfo_has_x86_bmi(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.bmi;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Choose methods for checksums and AES on cores of a microarchitecture from their ISA features and pitfalls. Vector
+ * widths are limited to the preferred width of cpuinfo_get_uarch_vector_hint, and to 128 bits on cores which split
+ * 256-bit instructions (CPUINFO_PITFALL_X86_SPLIT_256BIT).
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] capabilities - methods and widths to fill in.
+ * @returns true on success, or false if the index is invalid.
+ */
+bool CPUINFO_ABI cpuinfo_get_checksum_capabilities(uint32_t uarch_index,
+	struct cpuinfo_checksum_capabilities* capabilities);
+
+/** Speculative execution vulnerabilities which Linux reports in /sys/devices/system/cpu/vulnerabilities */
+enum cpuinfo_vulnerability {
+	/** Spectre variant 1: bounds check bypass (spectre_v1) */
+	cpuinfo_vulnerability_spectre_v1 = 0,
+	/** Spectre variant 2: branch target injection (spectre_v2), mitigated with retpolines, IBRS or eIBRS */
+	cpuinfo_vulnerability_spectre_v2,
+	/** Meltdown: rogue data cache load (meltdown), mitigated with page table isolation */
+	cpuinfo_vulnerability_meltdown,
+	/** Speculative store bypass (spec_store_bypass) */
+	cpuinfo_vulnerability_spec_store_bypass,
+	/** L1 terminal fault (l1tf) */
+	cpuinfo_vulnerability_l1tf,
+	/** Microarchitectural data sampling (mds), mitigated with buffer clearing on kernel exit */
+	cpuinfo_vulnerability_mds,
+	/** TSX asynchronous abort (tsx_async_abort) */
+	cpuinfo_vulnerability_tsx_async_abort,
+	/** Machine check on instruction fetch from changed huge pages (itlb_multihit) */
+	cpuinfo_vulnerability_itlb_multihit,
+	/** Special register buffer data sampling (srbds), mitigated in microcode which slows RDRAND and RDSEED */
+	cpuinfo_vulnerability_srbds,
+	/** Processor MMIO stale data (mmio_stale_data) */
+	cpuinfo_vulnerability_mmio_stale_data,
+	/** Return stack buffer underflow (retbleed) */
+	cpuinfo_vulnerability_retbleed,
+	/** Gather data sampling, or Downfall (gather_data_sampling), mitigated in microcode which slows gathers */
+	cpuinfo_vulnerability_gather_data_sampling,
+	/** Speculative return stack overflow, or Inception (spec_rstack_overflow) */
+	cpuinfo_vulnerability_spec_rstack_overflow,
+	/** Register file data sampling (reg_file_data_sampling) */
+	cpuinfo_vulnerability_reg_file_data_sampling,
+	/** Number of vulnerabilities, not a valid vulnerability */
+	cpuinfo_vulnerability_max,
+};
 
-static inline bool cpuinfo_has_x86_bmi2(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.bmi2;
-	#else
-		return false;
-	#endif
-}
+/** Status of a speculative execution vulnerability on the system */
+enum cpuinfo_vulnerability_status {
+	/** The OS doesn't report the vulnerability, e.g. it is older than the vulnerability or not Linux */
+	cpuinfo_vulnerability_status_unknown = 0,
+	/** Processors are not affected */
+	cpuinfo_vulnerability_status_not_affected,
+	/** Processors are affected, and the OS doesn't mitigate the vulnerability */
+	cpuinfo_vulnerability_status_vulnerable,
+	/** Processors are affected, and the OS mitigates the vulnerability, possibly with a performance cost */
+	cpuinfo_vulnerability_status_mitigated,
+};
 
-static inline bool cpuinfo_has_x86_adx(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.adx;
-	#else
-		return false;
-	#endif
-}
+/** Maximum length of the description of a vulnerability status, including the terminating null character */
+#define CPUINFO_VULNERABILITY_DESCRIPTION_MAX 128
+
+/** Status of a speculative execution vulnerability and its mitigation */
+struct cpuinfo_vulnerability_state {
+	/** Status of the vulnerability */
+	enum cpuinfo_vulnerability_status status;
+	/** Whether the mitigation relies on microcode, e.g. "Mitigation: Microcode" for Gather Data Sampling */
+	bool microcode_mitigation;
+	/** Status of the vulnerability as reported by the OS, e.g. "Mitigation: Retpolines; IBPB: conditional", or empty */
+	char description[CPUINFO_VULNERABILITY_DESCRIPTION_MAX];
+};
 
-static inline bool cpuinfo_has_x86_aes(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.aes;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the current status of a speculative execution vulnerability, and how the OS mitigates it. Mitigations
+ * change the cost of system calls, indirect branches and returns, and of some instructions, e.g. gathers under the
+ * microcode mitigation of Gather Data Sampling. The status is read anew on every call.
+ *
+ * @param vulnerability - the vulnerability to query.
+ * @param state - the status of the vulnerability. Status is cpuinfo_vulnerability_status_unknown if the OS doesn't
+ *                report the vulnerability.
+ *
+ * @returns true if the OS reports the vulnerability, and false otherwise, or if the vulnerability is invalid or
+ *          state is NULL.
+ */
+bool CPUINFO_ABI cpuinfo_get_vulnerability_state(enum cpuinfo_vulnerability vulnerability,
+	struct cpuinfo_vulnerability_state* state);
+
+/** Whether x86 Restricted Transactional Memory (RTM) transactions can commit */
+enum cpuinfo_x86_rtm_status {
+	/** CPUID doesn't report RTM: the processor lacks TSX, or microcode or the OS hides it from CPUID, e.g. tsx=off */
+	cpuinfo_x86_rtm_status_unsupported = 0,
+	/** Transactions can commit */
+	cpuinfo_x86_rtm_status_usable = 1,
+	/**
+	 * RTM instructions execute, but every transaction aborts: CPUID reports RTM_ALWAYS_ABORT, the OS disabled TSX to
+	 * mitigate TSX Asynchronous Abort without clearing the CPUID bit, or no probe transaction committed
+	 */
+	cpuinfo_x86_rtm_status_always_aborts = 2,
+};
 
-static inline bool cpuinfo_has_x86_vaes(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.vaes;
-	#else
-		return false;
-	#endif
-}
+/** Mode of TSX which the tsx= parameter of the Linux kernel selects */
+enum cpuinfo_x86_tsx_mode {
+	/** The kernel command line doesn't set the mode, or the OS is not Linux */
+	cpuinfo_x86_tsx_mode_unknown = 0,
+	/** tsx=on: TSX is enabled */
+	cpuinfo_x86_tsx_mode_on = 1,
+	/** tsx=off: TSX is disabled, on processors which support disabling it */
+	cpuinfo_x86_tsx_mode_off = 2,
+	/** tsx=auto: TSX is disabled on processors affected by TSX Asynchronous Abort, and enabled otherwise */
+	cpuinfo_x86_tsx_mode_auto = 3,
+};
 
-static inline bool cpuinfo_has_x86_pclmulqdq(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.pclmulqdq;
-	#else
-		return false;
-	#endif
-}
+/** Effective state of Intel TSX, which decides whether locks should be elided with transactions */
+struct cpuinfo_x86_tsx_state {
+	/** Whether RTM transactions can commit */
+	enum cpuinfo_x86_rtm_status rtm_status;
+	/**
+	 * Whether XACQUIRE and XRELEASE prefixes elide locks: CPUID reports HLE, and RTM transactions are usable.
+	 * Otherwise processors ignore the prefixes, and take the locks.
+	 */
+	bool hle_usable;
+	/** Whether CPUID reports RTM_ALWAYS_ABORT, i.e. microcode forces all transactions to abort */
+	bool rtm_always_abort;
+	/** Whether a probe transaction was executed, and whether one of its attempts committed */
+	bool probed;
+	bool probe_committed;
+	/** TSX mode of the Linux kernel command line */
+	enum cpuinfo_x86_tsx_mode kernel_mode;
+	/** Status of TSX Asynchronous Abort, as cpuinfo_get_vulnerability_state reports it */
+	enum cpuinfo_vulnerability_status taa_status;
+	/** Whether the OS reports that it disabled TSX to mitigate TSX Asynchronous Abort */
+	bool taa_tsx_disabled;
+};
 
-static inline bool cpuinfo_has_x86_vpclmulqdq(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.vpclmulqdq;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the effective state of Intel TSX: RTM and HLE support in CPUID, combined with the TSX mode of the kernel
+ * and the mitigation of TSX Asynchronous Abort on Linux. The state is determined anew on every call.
+ *
+ * @param probe - whether to confirm that RTM is usable with a few transactions, each with an empty body. The probe
+ *                runs only if the other sources report RTM as usable.
+ * @param[out] state - the state of TSX.
+ *
+ * @returns true on x86 systems, and false on other architectures or if state is NULL.
+ */
+bool CPUINFO_ABI cpuinfo_get_x86_tsx_state(bool probe, struct cpuinfo_x86_tsx_state* state);
+
+/** Latency class of the spin-loop hint instruction: PAUSE on x86, YIELD on ARM */
+enum cpuinfo_pause_latency {
+	/** Latency is unknown for the microarchitecture */
+	cpuinfo_pause_latency_unknown = 0,
+	/** A few to about 10 cycles, as on Intel cores before Sky Lake, Intel Atom cores, AMD cores, and ARM cores */
+	cpuinfo_pause_latency_short = 1,
+	/** About 140 cycles, as on Intel Sky Lake and later big cores: spin loops need far fewer iterations */
+	cpuinfo_pause_latency_long = 2,
+};
 
-static inline bool cpuinfo_has_x86_gfni(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.gfni;
-	#else
-		return false;
-	#endif
-}
+/** Parameters of spin-wait loops, e.g. of locks and queues, on cores of a microarchitecture */
+struct cpuinfo_spin_wait_hint {
+	/** Latency class of the spin-loop hint instruction */
+	enum cpuinfo_pause_latency pause_latency;
+	/** Approximate latency of the spin-loop hint instruction in cycles, or 0 if unknown */
+	uint32_t pause_cycles;
+	/**
+	 * Recommended iterations of a spin loop with the hint instruction before yielding or blocking, which spin for
+	 * about 4000 cycles, or 1-2 microseconds
+	 */
+	uint32_t spin_iterations;
+	/** UMONITOR/UMWAIT/TPAUSE (WAITPKG) can wait in user mode for a store to a monitored line or for a deadline */
+	bool x86_waitpkg;
+	/** MONITORX/MWAITX can wait in user mode for a store to a monitored line, with an optional timeout */
+	bool x86_mwaitx;
+	/** WFE can wait in user mode for an event, such as the loss of an exclusive monitor set by LDXR */
+	bool arm_wfe;
+	/** WFET can wait in user mode for an event with a timeout (FEAT_WFxT) */
+	bool arm_wfet;
+};
 
-static inline bool cpuinfo_has_x86_rdrand(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.rdrand;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Compute parameters of spin-wait loops for cores of a microarchitecture, from the decoded microarchitecture and the
+ * ISA features: the latency of the spin-loop hint instruction, and the instructions which wait without spinning.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] hint - parameters of spin-wait loops.
+ * @returns true on success, or false if the index is invalid.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_spin_wait_hint(uint32_t uarch_index, struct cpuinfo_spin_wait_hint* hint);
 
-static inline bool cpuinfo_has_x86_rdseed(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.rdseed;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Static parameters of the pipeline of a microarchitecture, from vendor optimization guides and published
+ * measurements, for priors of autotuners and cost models of kernel selection. Fields are 0 where the value is unknown.
+ */
+struct cpuinfo_uarch_cost_model {
+	/** Microarchitecture which the parameters describe */
+	enum cpuinfo_uarch uarch;
+	/** Instructions decoded per cycle by the instruction decoders, excluding micro-op caches */
+	uint32_t decode_width;
+	/** Micro-operations renamed and dispatched to execution units per cycle */
+	uint32_t issue_width;
+	/** Number of pipes which execute vector or floating-point fused multiply-add, 0 without FMA or if unknown */
+	uint32_t fma_units;
+	/** Latency of vector fused multiply-add in cycles */
+	uint32_t fma_latency;
+	/** Number of pipes which execute vector arithmetic */
+	uint32_t vector_pipes;
+	/** Width of the vector pipes in bits: wider instructions are split in several operations */
+	uint32_t vector_pipe_width;
+	/** Loads per cycle */
+	uint32_t load_ports;
+	/** Stores per cycle */
+	uint32_t store_ports;
+	/** Entries in the reorder buffer, 0 for in-order cores and if unknown */
+	uint32_t rob_size;
+	/** Load-to-use latency of L1 data cache in cycles for simple addressing modes */
+	uint32_t l1d_latency;
+};
 
-static inline bool cpuinfo_has_x86_sha(void) {
-	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-		return cpuinfo_isa.sha;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the static cost model of a microarchitecture, e.g. cpuinfo_get_uarch(i)->uarch. The table covers common
+ * microarchitectures of the target architecture of the library, and doesn't need initialization of cpuinfo.
+ *
+ * @returns pointer to the cost model, or NULL if the table has no data for the microarchitecture.
+ */
+const struct cpuinfo_uarch_cost_model* CPUINFO_ABI cpuinfo_get_uarch_cost_model(enum cpuinfo_uarch uarch);
 
-#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-	/* This structure is not a part of stable API. Use cpuinfo_has_arm_* functions instead. */
-	struct cpuinfo_arm_isa {
-		#if CPUINFO_ARCH_ARM
-			bool thumb;
-			bool thumb2;
-			bool thumbee;
-			bool jazelle;
-			bool armv5e;
-			bool armv6;
-			bool armv6k;
-			bool armv7;
-			bool armv7mp;
-			bool armv8;
-			bool idiv;
+/**
+ * Peak theoretical arithmetic throughput of a topology object, estimated from the cost model of its cores, their ISA
+ * features, and their maximum frequencies. A fused multiply-add counts as 2 operations. Throughput of a data type is 0
+ * if the cores can't compute on it natively, or the cost model of a core lacks the parameters. Cores without a cost
+ * model take the instruction throughputs measured by cpuinfo_probe_instruction_performance instead, if it ran.
+ */
+struct cpuinfo_peak_throughput {
+	/** Single-precision floating-point operations per cycle, summed over the cores */
+	uint32_t fp32_ops_per_cycle;
+	/** Half-precision floating-point operations per cycle, summed over the cores */
+	uint32_t fp16_ops_per_cycle;
+	/** 8-bit integer operations per cycle with dot product or widening multiply-accumulate instructions */
+	uint32_t int8_ops_per_cycle;
+	/**
+	 * Single-precision floating-point operations per second: operations per cycle of every core times its maximum
+	 * Turbo frequency, or its base frequency if the former is unknown. Zero if frequencies are unknown.
+	 */
+	uint64_t fp32_ops_per_second;
+	/** Half-precision floating-point operations per second, as fp32_ops_per_second */
+	uint64_t fp16_ops_per_second;
+	/** 8-bit integer operations per second, as fp32_ops_per_second */
+	uint64_t int8_ops_per_second;
+};
 
-			bool vfpv2;
-			bool vfpv3;
-			bool d32;
-			bool fp16;
-			bool fma;
+/**
+ * Estimate the peak throughput of a core, of all cores of a cluster, or of all cores of a physical package.
+ * Schedulers can split work between clusters of heterogeneous systems in proportion to their throughput.
+ *
+ * The topology object must come from the tables of the current cpuinfo initialization.
+ *
+ * @param[out] throughput - peak throughput of the object.
+ * @returns true on success, or false if the object is not from cpuinfo tables.
+ */
+bool CPUINFO_ABI cpuinfo_get_core_peak_throughput(const struct cpuinfo_core* core,
+	struct cpuinfo_peak_throughput* throughput);
+bool CPUINFO_ABI cpuinfo_get_cluster_peak_throughput(const struct cpuinfo_cluster* cluster,
+	struct cpuinfo_peak_throughput* throughput);
+bool CPUINFO_ABI cpuinfo_get_package_peak_throughput(const struct cpuinfo_package* package,
+	struct cpuinfo_peak_throughput* throughput);
+
+/** Unhalted core cycles */
+#define CPUINFO_PMU_EVENT_CYCLES              0x00000001
+/** Retired instructions */
+#define CPUINFO_PMU_EVENT_INSTRUCTIONS        0x00000002
+/** Unhalted reference cycles, at a constant frequency */
+#define CPUINFO_PMU_EVENT_REF_CYCLES          0x00000004
+/** References to the last level cache */
+#define CPUINFO_PMU_EVENT_LLC_REFERENCES      0x00000008
+/** Misses in the last level cache */
+#define CPUINFO_PMU_EVENT_LLC_MISSES          0x00000010
+/** Retired branch instructions */
+#define CPUINFO_PMU_EVENT_BRANCH_INSTRUCTIONS 0x00000020
+/** Mispredicted retired branch instructions */
+#define CPUINFO_PMU_EVENT_BRANCH_MISSES       0x00000040
+/** Issue slots for top-down analysis: TOPDOWN.SLOTS on x86, STALL_SLOT on ARM */
+#define CPUINFO_PMU_EVENT_TOPDOWN_SLOTS       0x00000080
 
-			bool wmmx;
-			bool wmmx2;
-			bool neon;
-		#endif
-		#if CPUINFO_ARCH_ARM64
-			bool atomics;
-			bool bf16;
-			bool sve;
-			bool sve2;
-			bool i8mm;
-		#endif
-		bool rdm;
-		bool fp16arith;
-		bool dot;
-		bool jscvt;
-		bool fcma;
-		bool fhm;
+/**
+ * Performance monitoring unit of the cores of a microarchitecture. Profilers can open up to general_counters events
+ * on general-purpose counters in a group without multiplexing, and count the events of fixed counters in addition.
+ */
+struct cpuinfo_pmu_info {
+	/** Version of the architectural performance monitoring: CPUID leaf 0xA on Intel, or 0 if unknown */
+	uint32_t version;
+	/** General-purpose counters per logical processor, or 0 if unknown */
+	uint32_t general_counters;
+	/** Width of general-purpose counters, in bits, or 0 if unknown */
+	uint32_t general_counter_width;
+	/** Fixed-function counters per logical processor: fixed counters of Intel, or the cycle counter of ARM */
+	uint32_t fixed_counters;
+	/** Width of fixed-function counters, in bits, or 0 if unknown */
+	uint32_t fixed_counter_width;
+	/**
+	 * Combination of CPUINFO_PMU_EVENT_* flags for events which the PMU architecture defines on these cores: the
+	 * architectural events of Intel, or common events of ARM known to Linux. Zero on AMD, which has no such events.
+	 */
+	uint32_t architectural_events;
+	/** Value of /proc/sys/kernel/perf_event_paranoid, or INT32_MAX if it can't be read */
+	int32_t perf_event_paranoid;
+	/**
+	 * Whether unprivileged processes can count events of their threads in user mode with perf_event_open, i.e. the
+	 * kernel supports perf_event and perf_event_paranoid is at most 2
+	 */
+	bool perf_event_allowed;
+};
 
-		bool aes;
-		bool sha1;
-		bool sha2;
-		bool pmull;
-		bool crc32;
-	};
+/**
+ * Query the performance monitoring unit of cores of a microarchitecture.
+ *
+ * On x86, counters are decoded from CPUID leaves 0xA and 0x23 on Intel, and 0x80000022 on AMD. If there are several
+ * microarchitectures, the calling thread is briefly pinned to a processor of the microarchitecture, and its affinity
+ * is restored afterwards.
+ *
+ * On ARM Linux, PMCR_EL0 is not readable in user mode: the PMU device of the cores is found by its cpus list in
+ * /sys/bus/event_source/devices, and general-purpose counters are counted by opening the largest group of events
+ * which perf_event accepts. The count is 0 if perf_event_allowed is false.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] info - description of the performance monitoring unit.
+ * @returns true on success, or false if the index is invalid or the PMU can't be queried.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_pmu_info(uint32_t uarch_index, struct cpuinfo_pmu_info* info);
+
+/** Intel Processor Trace (CPUID leaf 0x14) */
+#define CPUINFO_TRACE_INTEL_PT          0x00000001
+/** Last branch records: model-specific LBR of Intel known to perf_event, or architectural LBR */
+#define CPUINFO_TRACE_LBR               0x00000002
+/** Architectural LBR of Intel, enumerated in CPUID leaf 0x1C */
+#define CPUINFO_TRACE_ARCHITECTURAL_LBR 0x00000004
+/** Last branch record stack version 2 of AMD (CPUID leaf 0x80000022) */
+#define CPUINFO_TRACE_AMD_LBR_V2        0x00000008
+/** Branch sampling of AMD Zen 3 (BRS) */
+#define CPUINFO_TRACE_AMD_BRS           0x00000010
+/** ARM Statistical Profiling Extension, as an arm_spe device of perf_event which covers the cores */
+#define CPUINFO_TRACE_ARM_SPE           0x00000020
+/** ARM Embedded Trace Extension or Embedded Trace Macrocell, as a CoreSight tracer of perf_event for the cores */
+#define CPUINFO_TRACE_ARM_ETE           0x00000040
+
+/** Intel PT: filtering by CR3 */
+#define CPUINFO_INTEL_PT_CR3_FILTERING      0x00000001
+/** Intel PT: configurable PSB frequency, and cycle-accurate mode */
+#define CPUINFO_INTEL_PT_CYCLE_ACCURATE     0x00000002
+/** Intel PT: filtering by instruction pointer ranges, TraceStop */
+#define CPUINFO_INTEL_PT_IP_FILTERING       0x00000004
+/** Intel PT: mini time counter (MTC) timing packets */
+#define CPUINFO_INTEL_PT_MTC                0x00000008
+/** Intel PT: PTWRITE instruction */
+#define CPUINFO_INTEL_PT_PTWRITE            0x00000010
+/** Intel PT: power event trace */
+#define CPUINFO_INTEL_PT_POWER_EVENTS       0x00000020
+/** Intel PT: PSB and PMI preservation */
+#define CPUINFO_INTEL_PT_PMI_PRESERVATION   0x00000040
+/** Intel PT: event trace */
+#define CPUINFO_INTEL_PT_EVENT_TRACE        0x00000080
+/** Intel PT: disabling of TNT packets */
+#define CPUINFO_INTEL_PT_TNT_DISABLE        0x00000100
+/** Intel PT: output to tables of physical addresses (ToPA) */
+#define CPUINFO_INTEL_PT_TOPA_OUTPUT        0x00010000
+/** Intel PT: ToPA tables with more than one output entry */
+#define CPUINFO_INTEL_PT_TOPA_MULTIPLE      0x00020000
+/** Intel PT: output to a single contiguous range */
+#define CPUINFO_INTEL_PT_SINGLE_RANGE       0x00040000
 
-	extern struct cpuinfo_arm_isa cpuinfo_isa;
-#endif
+/**
+ * Facilities of the cores of a microarchitecture to record branches and to trace execution, for profilers which
+ * choose the sampling mechanism with the least overhead.
+ */
+struct cpuinfo_trace_info {
+	/** Combination of CPUINFO_TRACE_* flags for facilities of the cores */
+	uint32_t facilities;
+	/** Entries in the branch record stack: LBR of Intel, LBRv2 or BRS of AMD; 0 if none or unknown */
+	uint32_t branch_records;
+	/** Combination of CPUINFO_INTEL_PT_* flags, if facilities include CPUINFO_TRACE_INTEL_PT */
+	uint32_t intel_pt_capabilities;
+	/** Number of configurable address ranges of Intel PT for IP filtering */
+	uint32_t intel_pt_address_ranges;
+	/**
+	 * On Linux, perf_event type of the device of the instruction trace of the cores (intel_pt or cs_etm), or
+	 * UINT32_MAX if there is none.
+	 */
+	uint32_t trace_perf_type;
+	/** On Linux, perf_event type of the arm_spe device of the cores, or UINT32_MAX if there is none */
+	uint32_t sampling_perf_type;
+};
 
-static inline bool cpuinfo_has_arm_thumb(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.thumb;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Query the branch record and trace facilities of cores of a microarchitecture.
+ *
+ * On x86, facilities are decoded from CPUID leaves 0x7, 0x14, 0x1C, 0x80000008, and 0x80000022, pinning the calling
+ * thread as cpuinfo_get_uarch_pmu_info does. The depth of model-specific LBR is read from caps/branches of the cpu
+ * device of perf_event on Linux. On ARM Linux, SPE and ETE are found by the devices of perf_event which cover the
+ * processors of the microarchitecture, since the kernel hides the trace fields of ID_AA64DFR0_EL1 from user space.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param[out] info - description of the trace facilities.
+ * @returns true on success, or false if the index is invalid or the facilities can't be queried.
+ */
+bool CPUINFO_ABI cpuinfo_get_uarch_trace_info(uint32_t uarch_index, struct cpuinfo_trace_info* info);
 
-static inline bool cpuinfo_has_arm_thumb2(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.thumb2;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Counts of hardware events since the creation of a counter sampler, summed over logical processors. If the kernel
+ * multiplexed the counters of a processor, its counts are scaled by the ratio of the enabled and running times.
+ */
+struct cpuinfo_counter_sample {
+	/** Combination of CPUINFO_PMU_EVENT_* flags for events which were counted on at least one processor */
+	uint32_t events;
+	/** Number of logical processors whose counters were read */
+	uint32_t processors_count;
+	uint64_t cycles;
+	uint64_t instructions;
+	uint64_t ref_cycles;
+	uint64_t llc_references;
+	uint64_t llc_misses;
+	uint64_t branch_instructions;
+	uint64_t branch_misses;
+	/** Time, in nanoseconds, while the counters were enabled, summed over processors */
+	uint64_t time_enabled_ns;
+	/** Time, in nanoseconds, while the counters were counting, summed over processors */
+	uint64_t time_running_ns;
+};
 
-static inline bool cpuinfo_has_arm_v5e(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.armv5e;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sampler of hardware event counters: keeps a perf_event group open on every logical processor of a range, so that
+ * every sample costs one read per processor. Samplers are not thread-safe.
+ */
+struct cpuinfo_counter_sampler;
 
-static inline bool cpuinfo_has_arm_v6(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.armv6;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a sampler which counts events in all processes on processor_count logical processors starting at
+ * processor_start, e.g. the processors of a cluster, a package, or a cache. Events count since the creation.
+ *
+ * Counting events of all processes requires CAP_PERFMON or perf_event_paranoid of at most 0. Events which the PMU of
+ * a processor doesn't support are not counted on it.
+ *
+ * @param events - combination of CPUINFO_PMU_EVENT_* flags, except CPUINFO_PMU_EVENT_TOPDOWN_SLOTS.
+ * @returns the sampler, or NULL if the arguments are invalid or counters could not be opened on any processor.
+ */
+struct cpuinfo_counter_sampler* CPUINFO_ABI cpuinfo_create_counter_sampler(uint32_t events,
+	uint32_t processor_start, uint32_t processor_count);
+void CPUINFO_ABI cpuinfo_destroy_counter_sampler(struct cpuinfo_counter_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_v6k(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.armv6k;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Read and sum the counters of processor_count logical processors starting at processor_start, e.g. the processors of
+ * a cluster within a sampler of its package. Processors outside of the range of the sampler are ignored.
+ *
+ * @param[out] sample - counts of the events summed over the processors.
+ * @returns true if the counters of at least one processor were read, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_counters(struct cpuinfo_counter_sampler* sampler,
+	uint32_t processor_start, uint32_t processor_count, struct cpuinfo_counter_sample* sample);
+
+/** Power domain of a package with an energy counter */
+enum cpuinfo_energy_domain {
+	/** Whole package, including cores, uncore, and on some processors DRAM controllers */
+	cpuinfo_energy_domain_package = 0,
+	/** Cores of the package (RAPL PP0) */
+	cpuinfo_energy_domain_cores = 1,
+	/** Uncore of the package, e.g. integrated graphics on client processors (RAPL PP1) */
+	cpuinfo_energy_domain_uncore = 2,
+	/** DRAM attached to the package */
+	cpuinfo_energy_domain_dram = 3,
+	cpuinfo_energy_domain_max = 4,
+};
 
-static inline bool cpuinfo_has_arm_v7(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.armv7;
-	#else
-		return false;
-	#endif
-}
+/** Energy consumed by the domains of a package since the creation of an energy sampler */
+struct cpuinfo_energy_sample {
+	/** Bit mask of (1 << cpuinfo_energy_domain) for the domains with counters */
+	uint32_t domains;
+	/** Energy in microjoules, indexed by cpuinfo_energy_domain, or 0 for domains without counters */
+	uint64_t energy_uj[cpuinfo_energy_domain_max];
+};
 
-static inline bool cpuinfo_has_arm_v7mp(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.armv7mp;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sampler of energy counters of packages: keeps the RAPL counters of every package open, so that every sample costs
+ * one read per domain. On Linux, counters are the zones of the powercap framework, or the events of the power PMU of
+ * perf_event where powercap doesn't describe the package, e.g. on AMD processors with older kernels. Counters are
+ * accumulated across wraparounds of the hardware registers if the sampler reads them at least once per wraparound,
+ * i.e. every few minutes under full load. Samplers are not thread-safe.
+ */
+struct cpuinfo_energy_sampler;
 
-static inline bool cpuinfo_has_arm_v8(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.armv8;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a sampler for the energy counters of all packages of the current tables. Reading powercap counters
+ * requires root on kernels which restrict energy_uj, and the power PMU requires CAP_PERFMON or perf_event_paranoid
+ * of at most 0.
+ *
+ * @returns the sampler, or NULL if no package has energy counters which the process may read, as on operating
+ *          systems other than Linux.
+ */
+struct cpuinfo_energy_sampler* CPUINFO_ABI cpuinfo_create_energy_sampler(void);
+void CPUINFO_ABI cpuinfo_destroy_energy_sampler(struct cpuinfo_energy_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_idiv(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.idiv;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Read the energy counters of a package.
+ *
+ * @param package_index - index of the package, as in cpuinfo_get_package.
+ * @param[out] sample - energy of the domains of the package since the creation of the sampler.
+ * @returns true if at least one counter of the package was read, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_package_energy(struct cpuinfo_energy_sampler* sampler,
+	uint32_t package_index, struct cpuinfo_energy_sample* sample);
+
+/** Events of resctrl monitoring of a last-level cache domain */
+enum cpuinfo_llc_monitoring_event {
+	/** Bytes of the L3 cache which the monitored group occupies (llc_occupancy) */
+	cpuinfo_llc_monitoring_event_occupancy = 0,
+	/** Bytes of memory traffic of the group from all memory (mbm_total_bytes) */
+	cpuinfo_llc_monitoring_event_total_bandwidth = 1,
+	/** Bytes of memory traffic of the group from the memory of the local NUMA node (mbm_local_bytes) */
+	cpuinfo_llc_monitoring_event_local_bandwidth = 2,
+	cpuinfo_llc_monitoring_event_max = 3,
+};
 
-static inline bool cpuinfo_has_arm_vfpv2(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv2;
-	#else
-		return false;
-	#endif
-}
+/** Occupancy of an L3 cache, and memory traffic through it since the previous sample of an LLC monitoring sampler */
+struct cpuinfo_llc_monitoring_sample {
+	/** Bit mask of (1 << cpuinfo_llc_monitoring_event) for the events which were read */
+	uint32_t events;
+	/** Occupancy of the cache at the sample, in bytes */
+	uint64_t occupancy;
+	/** Bytes of total and local memory traffic since the previous sample, or since the creation of the sampler */
+	uint64_t total_bytes;
+	uint64_t local_bytes;
+	/** Total and local memory bandwidth over the interval, in bytes per second */
+	uint64_t total_bandwidth;
+	uint64_t local_bandwidth;
+	/** Time since the previous sample, in nanoseconds */
+	uint64_t interval_ns;
+};
 
-static inline bool cpuinfo_has_arm_vfpv3(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv3;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sampler of cache occupancy (CMT) and memory bandwidth (MBM) monitoring of L3 caches, as Linux reports them in the
+ * mon_data/mon_L3_XX directories of a resctrl group for the L3 cache with ID XX. Keeps the files of every L3 cache
+ * open, and computes differences of bandwidth counters between samples. Samplers are not thread-safe.
+ */
+struct cpuinfo_llc_monitoring_sampler;
 
-static inline bool cpuinfo_has_arm_vfpv3_d32(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv3 && cpuinfo_isa.d32;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a sampler for the L3 caches of the current tables, and take the initial values of the bandwidth counters.
+ *
+ * @param group - path of the resctrl group relative to /sys/fs/resctrl, e.g. "mon_groups/batch", or NULL for the
+ *                default group, which monitors the whole system.
+ * @returns the sampler, or NULL if resctrl is not mounted, the group doesn't exist, no L3 cache has monitoring data,
+ *          or on operating systems other than Linux.
+ */
+struct cpuinfo_llc_monitoring_sampler* CPUINFO_ABI cpuinfo_create_llc_monitoring_sampler(const char* group);
+void CPUINFO_ABI cpuinfo_destroy_llc_monitoring_sampler(struct cpuinfo_llc_monitoring_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_vfpv3_fp16(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fp16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample monitoring data of an L3 cache.
+ *
+ * @param l3_index - index of the cache, as in cpuinfo_get_l3_cache.
+ * @param[out] sample - occupancy of the cache, and memory traffic since the previous sample of this cache.
+ * @returns true if at least one event of the cache was read, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_sample_llc_monitoring(struct cpuinfo_llc_monitoring_sampler* sampler,
+	uint32_t l3_index, struct cpuinfo_llc_monitoring_sample* sample);
 
-static inline bool cpuinfo_has_arm_vfpv3_fp16_d32(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fp16 && cpuinfo_isa.d32;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Times of logical processors between the two latest samples of a utilization sampler, summed over the processors.
+ * The busy, idle, and steal ratios are the times divided by their sum.
+ */
+struct cpuinfo_utilization {
+	/** Number of logical processors with times in both samples, i.e. online during both samples */
+	uint32_t processors_count;
+	/** Time running user code, including guests, and the kernel, including interrupts, in nanoseconds */
+	uint64_t busy_ns;
+	/** Time idle, including waits for I/O, in nanoseconds */
+	uint64_t idle_ns;
+	/** Time while the hypervisor ran other virtual processors instead, in nanoseconds */
+	uint64_t steal_ns;
+};
 
-static inline bool cpuinfo_has_arm_vfpv4(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fma;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sampler of processor utilization: keeps /proc/stat open on Linux, and parses only its per-processor cpuN lines at
+ * every sample, so that a sample costs a few reads even on systems with thousands of logical processors. Samplers are
+ * not thread-safe.
+ */
+struct cpuinfo_utilization_sampler;
 
-static inline bool cpuinfo_has_arm_vfpv4_d32(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.vfpv3 && cpuinfo_isa.fma && cpuinfo_isa.d32;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a sampler for all logical processors of the current tables, and take its initial sample.
+ *
+ * @returns the sampler, or NULL if it could not be allocated, or utilization can't be read, as on operating systems
+ *          other than Linux.
+ */
+struct cpuinfo_utilization_sampler* CPUINFO_ABI cpuinfo_create_utilization_sampler(void);
+void CPUINFO_ABI cpuinfo_destroy_utilization_sampler(struct cpuinfo_utilization_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_fp16_arith(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.fp16arith;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample times of all logical processors, and compute their differences from the previous sample, which the
+ * cpuinfo_get_*_utilization functions then report.
+ *
+ * @returns true on success, and false if the times can't be read.
+ */
+bool CPUINFO_ABI cpuinfo_sample_utilization(struct cpuinfo_utilization_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_bf16(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.bf16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sum times between the two latest samples of processor_count logical processors starting at processor_start, e.g. the
+ * processors of a core, a cluster, or a package. The range is clipped to the logical processors of the sampler.
+ *
+ * @param[out] utilization - times summed over the processors.
+ * @returns true if any processor of the range has times in both samples, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_get_processors_utilization(const struct cpuinfo_utilization_sampler* sampler,
+	uint32_t processor_start, uint32_t processor_count, struct cpuinfo_utilization* utilization);
 
-static inline bool cpuinfo_has_arm_wmmx(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.wmmx;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sum times between the two latest samples of the logical processors of a last-level cache domain.
+ *
+ * @param llc_domain_index - index of the domain, as in cpuinfo_get_llc_domain.
+ * @param[out] utilization - times summed over the processors of the domain.
+ * @returns true if any processor of the domain has times in both samples, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_get_llc_domain_utilization(const struct cpuinfo_utilization_sampler* sampler,
+	uint32_t llc_domain_index, struct cpuinfo_utilization* utilization);
 
-static inline bool cpuinfo_has_arm_wmmx2(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.wmmx2;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sum times between the two latest samples of the logical processors of a NUMA node, including nodes whose
+ * processors interleave with other nodes.
+ *
+ * @param numa_node_index - index of the NUMA node, as in cpuinfo_get_numa_node.
+ * @param[out] utilization - times summed over the processors of the node.
+ * @returns true if any processor of the node has times in both samples, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_get_numa_node_utilization(const struct cpuinfo_utilization_sampler* sampler,
+	uint32_t numa_node_index, struct cpuinfo_utilization* utilization);
+
+/** Maximum length of thread names in cpuinfo_thread_schedule, including the terminating NUL */
+#define CPUINFO_THREAD_NAME_MAX 16
+
+/** Scheduling of a thread of a process, as of the latest sample of a thread schedule sampler */
+struct cpuinfo_thread_schedule {
+	/** Thread ID of the operating system */
+	uint32_t thread_id;
+	/** Name of the thread when the sampler found it, NUL-terminated */
+	char name[CPUINFO_THREAD_NAME_MAX];
+	/** Whether the thread existed at the latest sample; threads which exited are removed at the next sample */
+	bool alive;
+	/** Logical processor which ran the thread last before the latest sample, or NULL if unknown */
+	const struct cpuinfo_processor* processor;
+	/** Time running on logical processors between the two latest samples, in nanoseconds */
+	uint64_t run_ns;
+	/** Time waiting on run queues while runnable between the two latest samples, in nanoseconds */
+	uint64_t wait_ns;
+	/** Number of times the thread was scheduled on a logical processor between the two latest samples */
+	uint64_t timeslices;
+	/** Time running on logical processors since the sampler found the thread, in nanoseconds */
+	uint64_t total_run_ns;
+	/** Time waiting on run queues since the sampler found the thread, in nanoseconds */
+	uint64_t total_wait_ns;
+	/**
+	 * Number of samples since the sampler found the thread at which it had moved to another logical processor. This is
+	 * a lower bound of migrations: several migrations between two samples count as one, or as none if the thread
+	 * returned to the same processor.
+	 */
+	uint32_t migrations;
+};
 
-static inline bool cpuinfo_has_arm_neon(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.neon;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sampler of scheduling of the threads of a process: keeps the schedstat and stat files of every thread open on
+ * Linux, and reads them at every sample, finding new threads in the task directory of the process. Run time between
+ * samples is attributed to the core of the logical processor which ran the thread last at the sample, so attribution
+ * to cores, clusters and microarchitectures is accurate when threads migrate less often than the sampling interval.
+ * Samplers are not thread-safe.
+ */
+struct cpuinfo_thread_schedule_sampler;
 
-static inline bool cpuinfo_has_arm_neon_fp16(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.neon && cpuinfo_isa.fp16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a sampler for the threads of a process, and take its initial sample.
+ *
+ * @param process_id - process ID of the operating system, or 0 for the current process.
+ * @returns the sampler, or NULL if it could not be allocated, or the threads of the process can't be read, as on
+ *          operating systems other than Linux.
+ */
+struct cpuinfo_thread_schedule_sampler* CPUINFO_ABI cpuinfo_create_thread_schedule_sampler(uint32_t process_id);
+void CPUINFO_ABI cpuinfo_destroy_thread_schedule_sampler(struct cpuinfo_thread_schedule_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_neon_fma(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.neon && cpuinfo_isa.fma;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sample scheduling of all threads of the process, and compute the differences from the previous sample. Thread indices
+ * of the sampler are valid until the next sample.
+ *
+ * @returns true on success, and false if the task directory of the process can't be read, e.g. after it exited.
+ */
+bool CPUINFO_ABI cpuinfo_sample_thread_schedules(struct cpuinfo_thread_schedule_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_neon_v8(void) {
-	#if CPUINFO_ARCH_ARM64
-		return true;
-	#elif CPUINFO_ARCH_ARM
-		return cpuinfo_isa.neon && cpuinfo_isa.armv8;
-	#else
-		return false;
-	#endif
-}
+/** Returns the number of threads of the latest sample, including the threads which exited since the previous one */
+uint32_t CPUINFO_ABI cpuinfo_get_thread_schedules_count(const struct cpuinfo_thread_schedule_sampler* sampler);
 
-static inline bool cpuinfo_has_arm_atomics(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.atomics;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the scheduling of a thread as of the latest sample.
+ *
+ * @param thread_index - index of the thread in the sampler, below cpuinfo_get_thread_schedules_count.
+ * @returns pointer to the scheduling of the thread, valid until the next sample, or NULL if the index is invalid.
+ */
+const struct cpuinfo_thread_schedule* CPUINFO_ABI cpuinfo_get_thread_schedule(
+	const struct cpuinfo_thread_schedule_sampler* sampler, uint32_t thread_index);
 
-static inline bool cpuinfo_has_arm_neon_rdm(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.rdm;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sum the run time of a thread since the sampler found it on core_count cores starting at core_start, e.g. the cores of
+ * a cluster or a package. The range is clipped to the cores of the current tables.
+ *
+ * @param thread_index - index of the thread in the sampler, below cpuinfo_get_thread_schedules_count.
+ * @returns the run time attributed to the cores in nanoseconds, or 0 if the index is invalid.
+ */
+uint64_t CPUINFO_ABI cpuinfo_get_thread_cores_run_time(const struct cpuinfo_thread_schedule_sampler* sampler,
+	uint32_t thread_index, uint32_t core_start, uint32_t core_count);
 
-static inline bool cpuinfo_has_arm_neon_fp16_arith(void) {
-	#if CPUINFO_ARCH_ARM
-		return cpuinfo_isa.neon && cpuinfo_isa.fp16arith;
-	#elif CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.fp16arith;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sum the run time of a thread since the sampler found it on the cores of a microarchitecture, e.g. to find the share
+ * of time of a worker on little cores.
+ *
+ * @param thread_index - index of the thread in the sampler, below cpuinfo_get_thread_schedules_count.
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @returns the run time attributed to the microarchitecture in nanoseconds, or 0 if an index is invalid.
+ */
+uint64_t CPUINFO_ABI cpuinfo_get_thread_uarch_run_time(const struct cpuinfo_thread_schedule_sampler* sampler,
+	uint32_t thread_index, uint32_t uarch_index);
 
-static inline bool cpuinfo_has_arm_fhm(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.fhm;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Performance and energy efficiency capability of a core, as published by the hardware feedback interface (HFI)
+ * of hybrid Intel processors. Capabilities change at runtime with thermal and power limits, and are relative:
+ * the OS scales them to 0..1023 across the cores of the system, and 0 asks the OS to avoid the core.
+ */
+struct cpuinfo_core_capability {
+	/** Relative performance capability */
+	uint32_t performance;
+	/** Relative energy efficiency capability */
+	uint32_t efficiency;
+	/** Number of updates received for the core, or 0 if the capability is not known yet */
+	uint32_t updates_count;
+};
 
-static inline bool cpuinfo_has_arm_neon_dot(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.dot;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Monitor of core capabilities: on Linux subscribes to CPU capability events of the thermal netlink family, which
+ * the kernel sends only when capabilities change. Monitors are not thread-safe.
+ */
+struct cpuinfo_capability_monitor;
 
-static inline bool cpuinfo_has_arm_neon_bf16(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.bf16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Create a monitor of capabilities of the cores of the current tables.
+ *
+ * @returns the monitor, or NULL if it could not be allocated, or the events are unavailable: on operating systems
+ *          other than Linux, on kernels without thermal netlink, and on some kernels without CAP_NET_ADMIN.
+ */
+struct cpuinfo_capability_monitor* CPUINFO_ABI cpuinfo_create_capability_monitor(void);
+void CPUINFO_ABI cpuinfo_destroy_capability_monitor(struct cpuinfo_capability_monitor* monitor);
 
-static inline bool cpuinfo_has_arm_jscvt(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.jscvt;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Get the file descriptor of the monitor, which becomes readable when capability events are pending, e.g. to wait for
+ * them with poll or epoll.
+ *
+ * @returns the file descriptor, or -1 if the monitor is NULL.
+ */
+int CPUINFO_ABI cpuinfo_get_capability_monitor_fd(const struct cpuinfo_capability_monitor* monitor);
 
-static inline bool cpuinfo_has_arm_fcma(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.fcma;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Apply the pending capability events to the capabilities of the monitor without blocking.
+ *
+ * @returns the number of capabilities of logical processors updated by the events.
+ */
+uint32_t CPUINFO_ABI cpuinfo_update_core_capabilities(struct cpuinfo_capability_monitor* monitor);
 
-static inline bool cpuinfo_has_arm_i8mm(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.i8mm;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Get the latest capability of a core. Logical processors of a core share its capability.
+ *
+ * @param core - core in the current tables.
+ * @param[out] capability - latest capability of the core, with updates_count of 0 until the first event for the core.
+ * @returns true if the core is valid, and false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_get_core_capability(const struct cpuinfo_capability_monitor* monitor,
+	const struct cpuinfo_core* core, struct cpuinfo_core_capability* capability);
 
-static inline bool cpuinfo_has_arm_aes(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.aes;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the SVE vector length of the calling thread in bytes, e.g. 16 on Neoverse N2, 32 on Graviton 3, and 64 on
+ * A64FX, or 0 if SVE is unsupported. Linux requires all cores to support the same vector lengths, so the length is the
+ * same on all cores of heterogeneous systems, but it may differ between threads after
+ * cpuinfo_set_arm_sve_vector_length.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_arm_sve_vector_length(void);
 
-static inline bool cpuinfo_has_arm_sha1(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.sha1;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Sets the SVE vector length of the calling thread through prctl(PR_SVE_SET_VL). The kernel picks the largest
+ * supported length which doesn't exceed the requested one. Supported only on Linux.
+ *
+ * @param vector_length - vector length in bytes: a multiple of 16 between 16 and 256.
+ * @returns true if the vector length of the thread is now equal to the requested one, false otherwise.
+ */
+bool CPUINFO_ABI cpuinfo_set_arm_sve_vector_length(uint32_t vector_length);
 
-static inline bool cpuinfo_has_arm_sha2(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.sha2;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the streaming SVE vector length of the calling thread in bytes, i.e. the vector length in SME streaming
+ * mode, which is independent of the SVE vector length, or 0 if SME is unsupported.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_arm_sme_vector_length(void);
 
-static inline bool cpuinfo_has_arm_pmull(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.pmull;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Returns the length of RISC-V vector registers in bytes (VLEN / 8), read from the vlenb CSR, or 0 if the V extension
+ * is unsupported. Kernels for the vector extension are usually vector-length agnostic, but may pick strip sizes and
+ * LMUL from the length. Linux disables the V extension if cores have different vector lengths.
+ */
+uint32_t CPUINFO_ABI cpuinfo_get_riscv_vector_length(void);
 
-static inline bool cpuinfo_has_arm_crc32(void) {
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.crc32;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Memory hierarchy performance of cores of a microarchitecture, measured by cpuinfo_probe_memory_performance.
+ *
+ * Latencies are measured by chasing pointers in a random cyclic permutation of cache lines, and bandwidths by
+ * streaming reads, in working sets sized between the capacity of the preceding cache level and the measured level.
+ * Measurements of a level are 0 if cores of the microarchitecture have no cache at that level.
+ */
+struct cpuinfo_memory_performance {
+	/** Latency of dependent loads from L1 data cache, in picoseconds */
+	uint32_t l1d_latency;
+	/** Latency of dependent loads from L2 cache, in picoseconds */
+	uint32_t l2_latency;
+	/** Latency of dependent loads from L3 cache, in picoseconds */
+	uint32_t l3_latency;
+	/** Latency of dependent loads from memory, in picoseconds */
+	uint32_t memory_latency;
+	/** Read bandwidth of one core from L1 data cache, in bytes per second */
+	uint64_t l1d_bandwidth;
+	/** Read bandwidth of one core from L2 cache, in bytes per second */
+	uint64_t l2_bandwidth;
+	/** Read bandwidth of one core from L3 cache, in bytes per second */
+	uint64_t l3_bandwidth;
+	/** Read bandwidth of one core from memory, in bytes per second */
+	uint64_t memory_bandwidth;
+	/** Total read bandwidth from memory with all cores of the microarchitecture reading, in bytes per second */
+	uint64_t all_cores_memory_bandwidth;
+};
 
-static inline bool cpuinfo_has_arm_sve(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.sve;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Measure latency and bandwidth of caches and memory for every microarchitecture, with threads pinned to its cores.
+ *
+ * The probe is opt-in because it takes up to a few seconds and disturbs other work on the system. Measurements are
+ * kept until the topology is re-detected, and are saved in snapshot files by cpuinfo_save_snapshot and restored by
+ * cpuinfo_initialize_from_snapshot, so that the probe runs once per host. With measurements already available,
+ * the function returns immediately.
+ *
+ * @returns true if the measurements are available, or false if the probe failed or is not supported on the platform.
+ */
+bool CPUINFO_ABI cpuinfo_probe_memory_performance(void);
 
-static inline bool cpuinfo_has_arm_sve_bf16(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.sve && cpuinfo_isa.bf16;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Get the memory hierarchy performance of cores of a microarchitecture.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @returns pointer to the measurements, or NULL if the index is invalid or cpuinfo_probe_memory_performance didn't run.
+ */
+const struct cpuinfo_memory_performance* CPUINFO_ABI cpuinfo_get_uarch_memory_performance(uint32_t uarch_index);
 
-static inline bool cpuinfo_has_arm_sve2(void) {
-	#if CPUINFO_ARCH_ARM64
-		return cpuinfo_isa.sve2;
-	#else
-		return false;
-	#endif
-}
+/**
+ * Measured timing of an instruction, in core cycles as estimated from a chain of dependent integer additions.
+ * Both fields are 0 if the instruction was not measured.
+ */
+struct cpuinfo_instruction_timing {
+	/** Cycles between a dependent pair of instructions, in hundredths of a cycle */
+	uint32_t latency;
+	/** Independent instructions completed per 100 cycles, e.g. 200 for 2 instructions per cycle */
+	uint32_t throughput;
+};
 
-const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_processors(void);
-const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_cores(void);
-const struct cpuinfo_cluster* CPUINFO_ABI cpuinfo_get_clusters(void);
-const struct cpuinfo_package* CPUINFO_ABI cpuinfo_get_packages(void);
-const struct cpuinfo_uarch_info* CPUINFO_ABI cpuinfo_get_uarchs(void);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1i_caches(void);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1d_caches(void);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l2_caches(void);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l3_caches(void);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l4_caches(void);
+/**
+ * Throughput and latency of key instructions of compute kernels on cores of a microarchitecture, measured by
+ * cpuinfo_probe_instruction_performance, to validate the static cost model of cpuinfo_get_uarch_cost_model, and to
+ * replace it on cores which it doesn't cover.
+ *
+ * Vector instructions operate on vector_width-bit vectors: on x86-64 AVX2 and FMA3 forms, on ARM64 NEON forms.
+ */
+struct cpuinfo_instruction_performance {
+	/** Clock frequency of the core during measurements, in Hz */
+	uint64_t frequency;
+	/** Width of vector operands of the measured instructions in bits, or 0 if vector instructions were not measured */
+	uint32_t vector_width;
+	/**
+	 * Whether int8_dot measured a dot product instruction: VPDPBUSD on x86-64 and SDOT on ARM64. Otherwise, it measured
+	 * the widening multiply-accumulate which kernels use without dot products: VPMADDUBSW on x86-64 and SMLAL on ARM64.
+	 */
+	bool native_int8_dot;
+	/** Fused multiply-add of single-precision vectors: VFMADD231PS on x86-64 and FMLA on ARM64 */
+	struct cpuinfo_instruction_timing fma;
+	/** Multiply-accumulate of 8-bit integer vectors */
+	struct cpuinfo_instruction_timing int8_dot;
+	/** Byte shuffle with a vector of indices: VPSHUFB on x86-64 and TBL on ARM64 */
+	struct cpuinfo_instruction_timing shuffle;
+	/** Gather of 32-bit elements from L1 data cache: VPGATHERDD on x86-64, not measured on ARM64 */
+	struct cpuinfo_instruction_timing gather;
+	/** Vector loads from L1 data cache; the latency is of dependent 64-bit loads by pointer chasing */
+	struct cpuinfo_instruction_timing load;
+};
 
-const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_processor(uint32_t index);
-const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_core(uint32_t index);
-const struct cpuinfo_cluster* CPUINFO_ABI cpuinfo_get_cluster(uint32_t index);
-const struct cpuinfo_package* CPUINFO_ABI cpuinfo_get_package(uint32_t index);
-const struct cpuinfo_uarch_info* CPUINFO_ABI cpuinfo_get_uarch(uint32_t index);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1i_cache(uint32_t index);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1d_cache(uint32_t index);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l2_cache(uint32_t index);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l3_cache(uint32_t index);
-const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l4_cache(uint32_t index);
+/**
+ * Measure instruction performance for every microarchitecture, with a thread pinned to a logical processor of the
+ * first cluster of the microarchitecture running prebuilt loops of the instructions.
+ *
+ * The probe is opt-in because it takes a fraction of a second per microarchitecture and disturbs other work on the
+ * system. Measurements are stored in the persistent tuning cache of cpuinfo_tuning_put, and the probe takes them from
+ * the cache rather than measuring again on later runs on the same hardware. With measurements already available,
+ * the function returns immediately. After the probe, cpuinfo_get_core_peak_throughput and related functions use the
+ * measurements for cores without a cost model.
+ *
+ * @returns true if the measurements are available, or false if the probe failed or is not supported on the platform.
+ */
+bool CPUINFO_ABI cpuinfo_probe_instruction_performance(void);
 
-uint32_t CPUINFO_ABI cpuinfo_get_processors_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_cores_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_clusters_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_packages_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_uarchs_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_l1i_caches_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_l1d_caches_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_l2_caches_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_l3_caches_count(void);
-uint32_t CPUINFO_ABI cpuinfo_get_l4_caches_count(void);
+/**
+ * Get the instruction performance of cores of a microarchitecture.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @returns pointer to the measurements, or NULL if the index is invalid or cpuinfo_probe_instruction_performance
+ *          didn't run.
+ */
+const struct cpuinfo_instruction_performance* CPUINFO_ABI cpuinfo_get_uarch_instruction_performance(
+	uint32_t uarch_index);
 
 /**
- * Returns upper bound on cache size.
+ * Measure latencies of cache line transfers between cores, with a pair of threads pinned to the first logical
+ * processors of every pair of cores bouncing a cache line.
+ *
+ * The probe is opt-in because it takes time quadratic in the number of cores and disturbs other work on the system.
+ * One logical processor represents every core, which bounds the cost on machines with SMT. Like memory performance,
+ * the measurements are kept until the topology is re-detected, and are saved in and restored from snapshot files.
+ * With measurements already available, the function returns immediately.
+ *
+ * @returns true if the measurements are available, or false if the probe failed or is not supported on the platform.
  */
-uint32_t CPUINFO_ABI cpuinfo_get_max_cache_size(void);
+bool CPUINFO_ABI cpuinfo_probe_core_latencies(void);
 
 /**
- * Identify the logical processor that executes the current thread.
+ * Get the measured latencies between cores.
  *
- * There is no guarantee that the thread will stay on the same logical processor for any time.
- * Callers should treat the result as only a hint, and be prepared to handle NULL return value.
+ * @returns pointer to a cpuinfo_get_cores_count() x cpuinfo_get_cores_count() row-major matrix of one-way latencies in
+ *          picoseconds, or NULL if cpuinfo_probe_core_latencies didn't run. Entries on the diagonal are latencies
+ *          between the first two logical processors of the core, or 0 for cores with one logical processor.
  */
-const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_current_processor(void);
+const uint32_t* CPUINFO_ABI cpuinfo_get_core_latencies(void);
 
 /**
- * Identify the core that executes the current thread.
+ * Get the measured latency of cache line transfers between cores of two logical processors.
  *
- * There is no guarantee that the thread will stay on the same core for any time.
- * Callers should treat the result as only a hint, and be prepared to handle NULL return value.
+ * @param source - the logical processor which writes the cache line.
+ * @param target - the logical processor which reads the cache line.
+ * @returns latency in picoseconds, or 0 if the processors are the same, invalid, or the latencies are not measured.
  */
-const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_current_core(void);
+uint32_t CPUINFO_ABI cpuinfo_get_processor_latency(const struct cpuinfo_processor* source,
+	const struct cpuinfo_processor* target);
 
 /**
- * Identify the microarchitecture index of the core that executes the current thread.
- * If the system does not support such identification, the function returns 0.
+ * Number of threads which saturate the memory bandwidth of a NUMA node or a package, to cap parallelism of
+ * bandwidth-bound work such as streaming reductions, copies, and embedding lookups.
  *
- * There is no guarantee that the thread will stay on the same type of core for any time.
- * Callers should treat the result as only a hint.
+ * After cpuinfo_probe_memory_performance, bandwidths come from its measurements: the all-core bandwidth of every
+ * microarchitecture is split between domains in proportion to their cores of the microarchitecture. Otherwise
+ * bandwidths are estimated: a core keeps one cache line in flight per 16 entries of the reorder buffer of
+ * cpuinfo_get_uarch_cost_model, between 8 and 32 lines, with 100 ns memory latency, and a package has one 25.6 GB/s
+ * memory channel per 4 cores, between 2 and 12 channels. Estimates are coarse, and only the ratio of the bandwidths
+ * matters for the thread count.
  */
-uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index(void);
+struct cpuinfo_bandwidth_hint {
+	/** Number of threads, one per core, which saturate the memory bandwidth of the domain, between 1 and cores_count */
+	uint32_t saturating_threads;
+	/** Number of cores of the domain */
+	uint32_t cores_count;
+	/** Memory read bandwidth of the domain with all of its cores reading, in bytes per second */
+	uint64_t memory_bandwidth;
+	/** Memory read bandwidth of one thread, averaged over cores of the domain, in bytes per second */
+	uint64_t thread_bandwidth;
+	/** Whether the bandwidths are measured by cpuinfo_probe_memory_performance rather than estimated */
+	bool measured;
+};
 
 /**
- * Identify the microarchitecture index of the core that executes the current thread.
- * If the system does not support such identification, the function returns the user-specified default value.
+ * Get the number of threads which saturate the memory bandwidth of a NUMA node with its own cores.
  *
- * There is no guarantee that the thread will stay on the same type of core for any time.
- * Callers should treat the result as only a hint.
+ * @param numa_node - NUMA node from the current tables, as from cpuinfo_get_numa_node.
+ * @param[out] hint - the thread count and the bandwidths it is derived from.
+ * @returns true on success, or false if the node is invalid or has no logical processors.
  */
-uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index_with_default(uint32_t default_uarch_index);
+bool CPUINFO_ABI cpuinfo_get_numa_node_bandwidth_hint(const struct cpuinfo_numa_node* numa_node,
+	struct cpuinfo_bandwidth_hint* hint);
+
+/**
+ * Get the number of threads which saturate the memory bandwidth of a package. See
+ * cpuinfo_get_numa_node_bandwidth_hint.
+ */
+bool CPUINFO_ABI cpuinfo_get_package_bandwidth_hint(const struct cpuinfo_package* package,
+	struct cpuinfo_bandwidth_hint* hint);
+
+/**
+ * Get the L1 instruction TLB which caches translations of pages of the specified size on cores of a
+ * microarchitecture.
+ *
+ * Some cores have separate TLBs for pages of different sizes: the returned TLB is the one which caches pages of the
+ * specified size. Larger pages may be cached as several smaller pages, and such TLBs are not reported for them.
+ *
+ * @param uarch_index - index of the microarchitecture, as in cpuinfo_get_uarch.
+ * @param page_size - size of the pages, one of CPUINFO_PAGE_SIZE_* constants.
+ * @returns pointer to the TLB, or NULL if the index is invalid, cores have no such TLB, or it is unknown.
+ */
+const struct cpuinfo_tlb* CPUINFO_ABI cpuinfo_get_l1i_tlb(uint32_t uarch_index, uint64_t page_size);
+
+/**
+ * Get the L1 data TLB which caches translations of pages of the specified size on cores of a microarchitecture.
+ * See cpuinfo_get_l1i_tlb.
+ */
+const struct cpuinfo_tlb* CPUINFO_ABI cpuinfo_get_l1d_tlb(uint32_t uarch_index, uint64_t page_size);
+
+/**
+ * Get the second-level TLB which caches translations of pages of the specified size on cores of a microarchitecture.
+ * On x86 this is the shared TLB for data and instructions, or the L2 data TLB if the L2 TLBs are split.
+ * See cpuinfo_get_l1i_tlb.
+ */
+const struct cpuinfo_tlb* CPUINFO_ABI cpuinfo_get_l2_tlb(uint32_t uarch_index, uint64_t page_size);
 
 #ifdef __cplusplus
 } /* extern "C" */
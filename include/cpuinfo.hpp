@@ -0,0 +1,273 @@
+#pragma once
+#ifndef CPUINFO_HPP
+#define CPUINFO_HPP
+
+/*
+ * Header-only C++ interface to cpuinfo: views over the tables of topology objects, views of related objects, ISA
+ * requirements, and scoped thread pinning. All functions are inline wrappers over the C API of cpuinfo.h, which
+ * don't allocate memory. Requires C++14, and uses std::span when the standard library provides it.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#if defined(__has_include)
+	#if __has_include(<version>)
+		#include <version>
+	#endif
+#endif
+#if defined(__cpp_lib_span) && __cpp_lib_span >= 202002L
+	#include <span>
+#endif
+
+#include <cpuinfo.h>
+
+
+namespace cpuinfo {
+
+#if defined(__cpp_lib_span) && __cpp_lib_span >= 202002L
+	template <class T>
+	using span = std::span<T>;
+#else
+	/** Contiguous view over elements of cpuinfo tables, a subset of std::span for standard libraries before C++20 */
+	template <class T>
+	class span {
+	public:
+		using element_type = T;
+		using size_type = std::size_t;
+		using iterator = T*;
+
+		constexpr span() noexcept : data_(nullptr), size_(0) {}
+		constexpr span(T* data, size_type size) noexcept : data_(data), size_(size) {}
+
+		constexpr T* data() const noexcept { return data_; }
+		constexpr size_type size() const noexcept { return size_; }
+		constexpr bool empty() const noexcept { return size_ == 0; }
+		constexpr T& operator[](size_type index) const noexcept { return data_[index]; }
+		constexpr T& front() const noexcept { return data_[0]; }
+		constexpr T& back() const noexcept { return data_[size_ - 1]; }
+		constexpr iterator begin() const noexcept { return data_; }
+		constexpr iterator end() const noexcept { return data_ + size_; }
+		constexpr span subspan(size_type offset, size_type count) const noexcept {
+			return span(data_ + offset, count);
+		}
+
+	private:
+		T* data_;
+		size_type size_;
+	};
+#endif
+
+namespace detail {
+	template <class T>
+	inline span<const T> make_span(const T* table, uint32_t start, uint32_t count) noexcept {
+		/* Tables are NULL before initialization and on failure */
+		return table == nullptr ? span<const T>() : span<const T>(table + start, static_cast<std::size_t>(count));
+	}
+} /* namespace detail */
+
+/** Initializes cpuinfo, see cpuinfo_initialize. Returns true on success. */
+inline bool initialize() noexcept {
+	return cpuinfo_initialize();
+}
+
+/* Views over whole tables, equivalent to cpuinfo_get_<objects>() and cpuinfo_get_<objects>_count() */
+
+inline span<const cpuinfo_processor> processors() noexcept {
+	return detail::make_span(cpuinfo_get_processors(), 0, cpuinfo_get_processors_count());
+}
+
+inline span<const cpuinfo_core> cores() noexcept {
+	return detail::make_span(cpuinfo_get_cores(), 0, cpuinfo_get_cores_count());
+}
+
+inline span<const cpuinfo_cluster> clusters() noexcept {
+	return detail::make_span(cpuinfo_get_clusters(), 0, cpuinfo_get_clusters_count());
+}
+
+inline span<const cpuinfo_package> packages() noexcept {
+	return detail::make_span(cpuinfo_get_packages(), 0, cpuinfo_get_packages_count());
+}
+
+inline span<const cpuinfo_uarch_info> uarchs() noexcept {
+	return detail::make_span(cpuinfo_get_uarchs(), 0, cpuinfo_get_uarchs_count());
+}
+
+inline span<const cpuinfo_cache> l1i_caches() noexcept {
+	return detail::make_span(cpuinfo_get_l1i_caches(), 0, cpuinfo_get_l1i_caches_count());
+}
+
+inline span<const cpuinfo_cache> l1d_caches() noexcept {
+	return detail::make_span(cpuinfo_get_l1d_caches(), 0, cpuinfo_get_l1d_caches_count());
+}
+
+inline span<const cpuinfo_cache> l2_caches() noexcept {
+	return detail::make_span(cpuinfo_get_l2_caches(), 0, cpuinfo_get_l2_caches_count());
+}
+
+inline span<const cpuinfo_cache> l3_caches() noexcept {
+	return detail::make_span(cpuinfo_get_l3_caches(), 0, cpuinfo_get_l3_caches_count());
+}
+
+inline span<const cpuinfo_cache> l4_caches() noexcept {
+	return detail::make_span(cpuinfo_get_l4_caches(), 0, cpuinfo_get_l4_caches_count());
+}
+
+/*
+ * Views of related objects. Logical processors, cores and clusters of a topology object are contiguous in cpuinfo
+ * tables, so the views are subranges of the tables defined by the *_start and *_count fields of the object.
+ */
+
+inline span<const cpuinfo_processor> processors_of(const cpuinfo_core& core) noexcept {
+	return detail::make_span(cpuinfo_get_processors(), core.processor_start, core.processor_count);
+}
+
+inline span<const cpuinfo_processor> processors_of(const cpuinfo_cluster& cluster) noexcept {
+	return detail::make_span(cpuinfo_get_processors(), cluster.processor_start, cluster.processor_count);
+}
+
+inline span<const cpuinfo_processor> processors_of(const cpuinfo_package& package) noexcept {
+	return detail::make_span(cpuinfo_get_processors(), package.processor_start, package.processor_count);
+}
+
+inline span<const cpuinfo_core> cores_of(const cpuinfo_cluster& cluster) noexcept {
+	return detail::make_span(cpuinfo_get_cores(), cluster.core_start, cluster.core_count);
+}
+
+inline span<const cpuinfo_core> cores_of(const cpuinfo_package& package) noexcept {
+	return detail::make_span(cpuinfo_get_cores(), package.core_start, package.core_count);
+}
+
+inline span<const cpuinfo_cluster> clusters_of(const cpuinfo_package& package) noexcept {
+	return detail::make_span(cpuinfo_get_clusters(), package.cluster_start, package.cluster_count);
+}
+
+/** Logical processors which share the cache */
+inline span<const cpuinfo_processor> sharing(const cpuinfo_cache& cache) noexcept {
+	return detail::make_span(cpuinfo_get_processors(), cache.processor_start, cache.processor_count);
+}
+
+/**
+ * Set of ISA features required by a code path, e.g. a kernel. Requirements can be built in constant expressions:
+ *
+ *   constexpr cpuinfo::isa_requirement avx2_fma{cpuinfo_isa_feature_x86_avx2, cpuinfo_isa_feature_x86_fma3};
+ *   if (avx2_fma.supported()) { ... }
+ */
+class isa_requirement {
+public:
+	constexpr isa_requirement() noexcept : words_{} {}
+
+	constexpr isa_requirement(std::initializer_list<cpuinfo_isa_feature> features) noexcept : words_{} {
+		for (cpuinfo_isa_feature feature : features) {
+			words_[static_cast<uint32_t>(feature) / 64] |= UINT64_C(1) << (static_cast<uint32_t>(feature) % 64);
+		}
+	}
+
+	/** Returns a copy of the requirement with the feature added */
+	constexpr isa_requirement operator|(cpuinfo_isa_feature feature) const noexcept {
+		isa_requirement result = *this;
+		result.words_[static_cast<uint32_t>(feature) / 64] |= UINT64_C(1) << (static_cast<uint32_t>(feature) % 64);
+		return result;
+	}
+
+	/** Returns the union of the requirements */
+	constexpr isa_requirement operator|(const isa_requirement& other) const noexcept {
+		isa_requirement result = *this;
+		for (uint32_t i = 0; i < CPUINFO_ISA_FEATURE_WORDS; i++) {
+			result.words_[i] |= other.words_[i];
+		}
+		return result;
+	}
+
+	constexpr bool contains(cpuinfo_isa_feature feature) const noexcept {
+		return ((words_[static_cast<uint32_t>(feature) / 64] >> (static_cast<uint32_t>(feature) % 64)) & 1) != 0;
+	}
+
+	constexpr bool empty() const noexcept {
+		uint64_t any = 0;
+		for (uint32_t i = 0; i < CPUINFO_ISA_FEATURE_WORDS; i++) {
+			any |= words_[i];
+		}
+		return any == 0;
+	}
+
+	/** Returns the requirement as the C bitset of cpuinfo_isa_features_* functions */
+	cpuinfo_isa_features features() const noexcept {
+		cpuinfo_isa_features result;
+		for (uint32_t i = 0; i < CPUINFO_ISA_FEATURE_WORDS; i++) {
+			result.words[i] = words_[i];
+		}
+		return result;
+	}
+
+	/** Checks if the processor and the OS support all required features, as cpuinfo_has_isa_features */
+	bool supported() const noexcept {
+		const cpuinfo_isa_features* available = cpuinfo_get_isa_features();
+		if (available == nullptr) {
+			return false;
+		}
+		const cpuinfo_isa_features required = features();
+		return cpuinfo_isa_features_include(available, &required);
+	}
+
+	/** Checks if cores of the microarchitecture support all required features, see cpuinfo_get_uarch_isa_features */
+	bool supported_on_uarch(uint32_t uarch_index) const noexcept {
+		cpuinfo_isa_features available;
+		if (!cpuinfo_get_uarch_isa_features(uarch_index, &available)) {
+			return false;
+		}
+		const cpuinfo_isa_features required = features();
+		return cpuinfo_isa_features_include(&available, &required);
+	}
+
+private:
+	uint64_t words_[CPUINFO_ISA_FEATURE_WORDS];
+};
+
+/**
+ * Pins the calling thread to the logical processors of a topology object for the lifetime of the guard, and
+ * restores the previous affinity of the thread on destruction. The guard must be destroyed on the thread which
+ * created it. If the thread could not be pinned, pinned() returns false and the destructor leaves the affinity as is.
+ */
+class thread_pin_guard {
+public:
+	explicit thread_pin_guard(const cpuinfo_affinity* affinity) noexcept {
+		pinned_ = cpuinfo_save_current_thread_affinity(&saved_) && cpuinfo_set_current_thread_affinity(affinity);
+	}
+
+	explicit thread_pin_guard(const cpuinfo_processor& processor) noexcept :
+		thread_pin_guard(cpuinfo_get_processor_affinity(&processor)) {}
+
+	explicit thread_pin_guard(const cpuinfo_core& core) noexcept :
+		thread_pin_guard(cpuinfo_get_core_affinity(&core)) {}
+
+	explicit thread_pin_guard(const cpuinfo_cluster& cluster) noexcept :
+		thread_pin_guard(cpuinfo_get_cluster_affinity(&cluster)) {}
+
+	explicit thread_pin_guard(const cpuinfo_package& package) noexcept :
+		thread_pin_guard(cpuinfo_get_package_affinity(&package)) {}
+
+	explicit thread_pin_guard(const cpuinfo_cache& cache) noexcept :
+		thread_pin_guard(cpuinfo_get_cache_affinity(&cache)) {}
+
+	~thread_pin_guard() {
+		if (pinned_) {
+			cpuinfo_restore_current_thread_affinity(&saved_);
+		}
+	}
+
+	thread_pin_guard(const thread_pin_guard&) = delete;
+	thread_pin_guard& operator=(const thread_pin_guard&) = delete;
+
+	/** Whether the thread was pinned, and its affinity will be restored */
+	bool pinned() const noexcept { return pinned_; }
+
+private:
+	cpuinfo_thread_affinity_state saved_;
+	bool pinned_;
+};
+
+} /* namespace cpuinfo */
+
+#endif /* CPUINFO_HPP */
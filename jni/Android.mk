@@ -3,23 +3,77 @@ LOCAL_PATH := $(call my-dir)/..
 include $(CLEAR_VARS)
 LOCAL_MODULE := cpuinfo
 LOCAL_SRC_FILES := \
-	src/init.c \
+	src/affinity.c \
 	src/api.c \
+	src/arena.c \
+	src/blocking.c \
 	src/cache.c \
-	src/linux/processors.c \
+	src/capability.c \
+	src/columns.c \
+	src/costmodel.c \
+	src/counters.c \
+	src/devices.c \
+	src/dispatch.c \
+	src/energy.c \
+	src/epoch.c \
+	src/export.c \
+	src/features.c \
+	src/frequency.c \
+	src/hotplug.c \
+	src/hugepages.c \
+	src/hypervisor.c \
+	src/init.c \
+	src/instructions.c \
+	src/latency.c \
+	src/lists.c \
+	src/log.c \
+	src/mte.c \
+	src/numa.c \
+	src/performance.c \
+	src/percpu.c \
+	src/pitfalls.c \
+	src/placement.c \
+	src/pmu.c \
+	src/prefetchers.c \
+	src/probe.c \
+	src/resctrl.c \
+	src/sampler.c \
+	src/snapshot.c \
+	src/spinwait.c \
+	src/stats.c \
+	src/threads.c \
+	src/throughput.c \
+	src/tlb.c \
+	src/tsc.c \
+	src/tsx.c \
+	src/tuning.c \
+	src/uarch-table.c \
+	src/usable.c \
+	src/utilization.c \
+	src/vector.c \
+	src/vulnerabilities.c \
+	src/xstate.c \
+	src/linux/files.c \
 	src/linux/smallfile.c \
+	src/linux/cgroup.c \
 	src/linux/multiline.c \
-	src/linux/cpulist.c
+	src/linux/cpulist.c \
+	src/linux/current.c \
+	src/linux/processors.c \
+	src/linux/sysfs.c
 ifeq ($(TARGET_ARCH_ABI),$(filter $(TARGET_ARCH_ABI),armeabi-v7a arm64-v8a))
 LOCAL_SRC_FILES += \
 	src/arm/uarch.c \
 	src/arm/cache.c \
+	src/arm/tlb.c \
 	src/arm/linux/init.c \
 	src/arm/linux/cpuinfo.c \
 	src/arm/linux/clusters.c \
+	src/arm/linux/accelerators.c \
 	src/arm/linux/chipset.c \
 	src/arm/linux/midr.c \
 	src/arm/linux/hwcap.c \
+	src/arm/android/chipset-cache.c \
 	src/arm/android/properties.c
 ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
 LOCAL_SRC_FILES += src/arm/linux/aarch32-isa.c
@@ -31,19 +85,23 @@ endif # armeabi-v7a, or arm64-v8a
 ifeq ($(TARGET_ARCH_ABI),$(filter $(TARGET_ARCH_ABI),x86 x86_64))
 LOCAL_SRC_FILES += \
 	src/x86/init.c \
+	src/x86/cpuid.c \
 	src/x86/info.c \
-	src/x86/name.c \
-	src/x86/isa.c \
 	src/x86/vendor.c \
 	src/x86/uarch.c \
+	src/x86/name.c \
 	src/x86/topology.c \
+	src/x86/isa.c \
 	src/x86/cache/init.c \
 	src/x86/cache/descriptor.c \
 	src/x86/cache/deterministic.c \
-	src/x86/linux/cpuinfo.c \
-	src/x86/linux/init.c
+	src/x86/cache/rdt.c \
+	src/x86/cache/tlb.c \
+	src/x86/linux/init.c \
+	src/x86/linux/cpuinfo.c
 endif # x86 or x86_64
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/include
+LOCAL_EXPORT_LDLIBS := -llog
 LOCAL_C_INCLUDES := $(LOCAL_EXPORT_C_INCLUDES) $(LOCAL_PATH)/src
 LOCAL_CFLAGS := -std=c99 -Wall -D_GNU_SOURCE=1
 ifeq (,$(findstring 4.9,$(NDK_TOOLCHAIN)))
@@ -58,9 +116,12 @@ LOCAL_CFLAGS += -DCPUINFO_LOG_LEVEL=5
 else
 LOCAL_CFLAGS += -DCPUINFO_LOG_LEVEL=0
 endif
-LOCAL_STATIC_LIBRARIES := clog
 include $(BUILD_STATIC_LIBRARY)
 
-$(call import-add-path,$(LOCAL_PATH)/deps)
-
-$(call import-module,clog/jni)
+# JNI bindings for org.pytorch.cpuinfo.CpuInfo in jni/java
+include $(CLEAR_VARS)
+LOCAL_MODULE := cpuinfo_jni
+LOCAL_SRC_FILES := jni/cpuinfo-jni.c
+LOCAL_CFLAGS := -std=c99 -Wall -Os
+LOCAL_STATIC_LIBRARIES := cpuinfo
+include $(BUILD_SHARED_LIBRARY)
@@ -0,0 +1,123 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jni.h>
+
+#include <cpuinfo.h>
+
+
+/*
+ * JNI bindings of org.pytorch.cpuinfo.CpuInfo. Natives are registered in JNI_OnLoad, so calls don't look up symbols
+ * or classes. Tables are exposed as direct buffers over the memory of cpuinfo, without copies: cpuinfo keeps tables
+ * which reinitialization replaced until deinitialization unless initialized with CPUINFO_INIT_RECLAIM_RETIRED_TABLES
+ * flag, and the bindings neither pass the flag nor deinitialize cpuinfo.
+ */
+
+#define CPUINFO_JNI_CLASS_NAME "org/pytorch/cpuinfo/CpuInfo"
+
+static jboolean initialize(JNIEnv* env, jclass clazz) {
+	(void) env;
+	(void) clazz;
+	return cpuinfo_initialize() ? JNI_TRUE : JNI_FALSE;
+}
+
+static jint get_processors_count(JNIEnv* env, jclass clazz) {
+	(void) env;
+	(void) clazz;
+	return (jint) cpuinfo_get_processors_count();
+}
+
+static jint get_cores_count(JNIEnv* env, jclass clazz) {
+	(void) env;
+	(void) clazz;
+	return (jint) cpuinfo_get_cores_count();
+}
+
+static jint get_clusters_count(JNIEnv* env, jclass clazz) {
+	(void) env;
+	(void) clazz;
+	return (jint) cpuinfo_get_clusters_count();
+}
+
+static jint get_uarchs_count(JNIEnv* env, jclass clazz) {
+	(void) env;
+	(void) clazz;
+	return (jint) cpuinfo_get_uarchs_count();
+}
+
+static jint get_uarch(JNIEnv* env, jclass clazz, jint index) {
+	(void) env;
+	(void) clazz;
+	const struct cpuinfo_uarch_info* uarch_info = cpuinfo_get_uarch((uint32_t) index);
+	return uarch_info != NULL ? (jint) uarch_info->uarch : (jint) cpuinfo_uarch_unknown;
+}
+
+static jobject get_processor_columns(JNIEnv* env, jclass clazz) {
+	(void) clazz;
+	uint32_t size = 0;
+	const void* columns = cpuinfo_get_processor_columns(&size);
+	if (columns == NULL) {
+		return NULL;
+	}
+	/* Java wraps the buffer into a read-only view */
+	return (*env)->NewDirectByteBuffer(env, (void*) columns, (jlong) size);
+}
+
+static jobject get_steal_order(JNIEnv* env, jclass clazz, jint processor_index) {
+	(void) clazz;
+	uint32_t count = 0;
+	const uint32_t* victims = cpuinfo_get_steal_order((uint32_t) processor_index, &count);
+	if (victims == NULL) {
+		return NULL;
+	}
+	return (*env)->NewDirectByteBuffer(env, (void*) victims, (jlong) count * (jlong) sizeof(uint32_t));
+}
+
+/*
+ * Natives of @CriticalNative methods take neither JNIEnv nor jclass. Runtimes before Android 8.0 ignore the annotation
+ * and pass both, which these functions without parameters safely ignore in all calling conventions of Android ABIs.
+ */
+static jint get_current_uarch_index(void) {
+	return (jint) cpuinfo_get_current_uarch_index();
+}
+
+static jint get_current_slot(void) {
+	return (jint) cpuinfo_get_current_slot();
+}
+
+static jint get_current_llc_slot(void) {
+	return (jint) cpuinfo_get_current_llc_slot();
+}
+
+static const JNINativeMethod methods[] = {
+	{ "nativeInitialize", "()Z", (void*) initialize },
+	{ "getProcessorsCount", "()I", (void*) get_processors_count },
+	{ "getCoresCount", "()I", (void*) get_cores_count },
+	{ "getClustersCount", "()I", (void*) get_clusters_count },
+	{ "getUarchsCount", "()I", (void*) get_uarchs_count },
+	{ "getUarch", "(I)I", (void*) get_uarch },
+	{ "nativeGetProcessorColumns", "()Ljava/nio/ByteBuffer;", (void*) get_processor_columns },
+	{ "nativeGetStealOrder", "(I)Ljava/nio/ByteBuffer;", (void*) get_steal_order },
+	{ "getCurrentUarchIndex", "()I", (void*) get_current_uarch_index },
+	{ "getCurrentSlot", "()I", (void*) get_current_slot },
+	{ "getCurrentLlcSlot", "()I", (void*) get_current_llc_slot },
+};
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+	(void) reserved;
+	JNIEnv* env = NULL;
+	if ((*vm)->GetEnv(vm, (void**) &env, JNI_VERSION_1_6) != JNI_OK) {
+		return JNI_ERR;
+	}
+	jclass clazz = (*env)->FindClass(env, CPUINFO_JNI_CLASS_NAME);
+	if (clazz == NULL) {
+		return JNI_ERR;
+	}
+	const jint status = (*env)->RegisterNatives(env, clazz, methods, (jint) (sizeof(methods) / sizeof(methods[0])));
+	(*env)->DeleteLocalRef(env, clazz);
+	if (status != JNI_OK) {
+		return JNI_ERR;
+	}
+	return JNI_VERSION_1_6;
+}
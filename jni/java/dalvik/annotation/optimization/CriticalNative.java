@@ -0,0 +1,15 @@
+package dalvik.annotation.optimization;
+
+import java.lang.annotation.ElementType;
+import java.lang.annotation.Retention;
+import java.lang.annotation.RetentionPolicy;
+import java.lang.annotation.Target;
+
+/**
+ * Copy of the annotation of the Android runtime, which the public SDK doesn't export. The runtime recognizes the
+ * annotation by name on Android 8.0 and later, and older runtimes ignore it.
+ */
+@Retention(RetentionPolicy.CLASS)
+@Target(ElementType.METHOD)
+public @interface CriticalNative {
+}
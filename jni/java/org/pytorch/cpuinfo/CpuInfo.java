@@ -0,0 +1,118 @@
+package org.pytorch.cpuinfo;
+
+import dalvik.annotation.optimization.CriticalNative;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.IntBuffer;
+import java.nio.ShortBuffer;
+
+/**
+ * Bindings of the cpuinfo library, implemented in jni/cpuinfo-jni.c of the cpuinfo repository.
+ *
+ * Tables are returned as read-only buffers over the memory of the native library, without copies, and stay valid
+ * for the lifetime of the process.
+ */
+public final class CpuInfo {
+	/** Column of core indices in {@link #getProcessorColumns}, as cpuinfo_processor_column_core */
+	public static final int COLUMN_CORE = 0;
+	/** Column of cluster indices, as cpuinfo_processor_column_cluster */
+	public static final int COLUMN_CLUSTER = 1;
+	/** Column of package indices, as cpuinfo_processor_column_package */
+	public static final int COLUMN_PACKAGE = 2;
+	/** Column of NUMA node indices, as cpuinfo_processor_column_numa_node */
+	public static final int COLUMN_NUMA_NODE = 3;
+	/** Column of frequency domain indices, as cpuinfo_processor_column_frequency_domain */
+	public static final int COLUMN_FREQUENCY_DOMAIN = 4;
+	/** Column of last-level cache domain indices, as cpuinfo_processor_column_llc_domain */
+	public static final int COLUMN_LLC_DOMAIN = 5;
+	/** Column of microarchitecture indices, as cpuinfo_processor_column_uarch */
+	public static final int COLUMN_UARCH = 6;
+	/** Column of L1 instruction cache indices, as cpuinfo_processor_column_l1i */
+	public static final int COLUMN_L1I = 7;
+	/** Column of L1 data cache indices, as cpuinfo_processor_column_l1d */
+	public static final int COLUMN_L1D = 8;
+	/** Column of L2 cache indices, as cpuinfo_processor_column_l2 */
+	public static final int COLUMN_L2 = 9;
+	/** Column of L3 cache indices, as cpuinfo_processor_column_l3 */
+	public static final int COLUMN_L3 = 10;
+	/** Column of L4 cache indices, as cpuinfo_processor_column_l4 */
+	public static final int COLUMN_L4 = 11;
+	/** Number of columns, as cpuinfo_processor_column_max */
+	public static final int COLUMNS_COUNT = 12;
+	/** Column entry of a logical processor without the object, as CPUINFO_COLUMN_INDEX_NONE */
+	public static final int COLUMN_INDEX_NONE = 0xFFFF;
+
+	private static boolean initialized;
+
+	static {
+		System.loadLibrary("cpuinfo_jni");
+	}
+
+	private CpuInfo() {
+	}
+
+	/**
+	 * Initializes cpuinfo, as cpuinfo_initialize. Other methods require a successful initialization.
+	 *
+	 * @return true on success.
+	 */
+	public static synchronized boolean initialize() {
+		if (!initialized) {
+			initialized = nativeInitialize();
+		}
+		return initialized;
+	}
+
+	public static native int getProcessorsCount();
+	public static native int getCoresCount();
+	public static native int getClustersCount();
+	public static native int getUarchsCount();
+
+	/** Returns the microarchitecture with the index, as the uarch member of cpuinfo_get_uarch */
+	public static native int getUarch(int index);
+
+	/**
+	 * Returns the structure-of-arrays view of logical processors, as cpuinfo_get_processor_columns: column c of
+	 * unsigned 16-bit indices starts at entry c * getProcessorsCount(). Use Short.toUnsignedInt to read entries.
+	 *
+	 * @return read-only view of the native memory, or null if the view is not available.
+	 */
+	public static ShortBuffer getProcessorColumns() {
+		final ByteBuffer columns = nativeGetProcessorColumns();
+		if (columns == null) {
+			return null;
+		}
+		/* Views of a buffer reset its byte order, so the order is set on the last byte buffer */
+		return columns.asReadOnlyBuffer().order(ByteOrder.nativeOrder()).asShortBuffer();
+	}
+
+	/**
+	 * Returns the victims of a work-stealing thread on a logical processor, as cpuinfo_get_steal_order.
+	 *
+	 * @return read-only view of the native memory, or null if the index is out of range or there are no victims.
+	 */
+	public static IntBuffer getStealOrder(int processorIndex) {
+		final ByteBuffer victims = nativeGetStealOrder(processorIndex);
+		if (victims == null) {
+			return null;
+		}
+		return victims.asReadOnlyBuffer().order(ByteOrder.nativeOrder()).asIntBuffer();
+	}
+
+	/** Returns the microarchitecture index of the core of the current thread, as cpuinfo_get_current_uarch_index */
+	@CriticalNative
+	public static native int getCurrentUarchIndex();
+
+	/** Returns the dense slot of the logical processor that executes the current thread, as cpuinfo_get_current_slot */
+	@CriticalNative
+	public static native int getCurrentSlot();
+
+	/** Returns the dense slot of the last-level cache domain of the current thread, as cpuinfo_get_current_llc_slot */
+	@CriticalNative
+	public static native int getCurrentLlcSlot();
+
+	private static native boolean nativeInitialize();
+	private static native ByteBuffer nativeGetProcessorColumns();
+	private static native ByteBuffer nativeGetStealOrder(int processorIndex);
+}
@@ -0,0 +1,726 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <sched.h>
+#elif defined(__MACH__) && defined(__APPLE__)
+	#include <pthread.h>
+	#include <pthread/qos.h>
+	#include <mach/mach.h>
+	#include <mach/thread_policy.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define CPU_SET_WORD_BITS (sizeof(unsigned long) * CHAR_BIT)
+#endif
+
+#define PROCESSOR_MASK_WORD_BITS 64
+
+struct affinity_builder {
+	const struct cpuinfo_tables* tables;
+	/* Storage for processor masks of the next objects */
+	uint64_t* processor_masks;
+	uint32_t processor_mask_words;
+#if defined(__linux__)
+	/* Storage for CPU masks of the next objects */
+	unsigned long* linux_cpu_sets;
+	uint32_t linux_cpu_set_words;
+#endif
+};
+
+static inline bool is_processor_in_mask(const uint64_t* processor_mask, uint32_t processor_index) {
+	const uint64_t word = processor_mask[processor_index / PROCESSOR_MASK_WORD_BITS];
+	return (word >> (processor_index % PROCESSOR_MASK_WORD_BITS)) & 1;
+}
+
+static uint64_t* get_processor_mask(struct affinity_builder builder[restrict static 1]) {
+	uint64_t* processor_mask = builder->processor_masks;
+	builder->processor_masks += builder->processor_mask_words;
+	return processor_mask;
+}
+
+/*
+ * Fill the affinity from the processor mask of the topology object.
+ * The mask may have bits set only for logical processors in [processor_start, processor_end).
+ */
+static void init_affinity(struct affinity_builder builder[restrict static 1], struct cpuinfo_affinity* affinity,
+	const uint64_t* processor_mask, uint32_t processor_start, uint32_t processor_end)
+{
+	const struct cpuinfo_processor* processors = builder->tables->processors;
+	affinity->processor_mask = processor_mask;
+	affinity->processor_mask_words = builder->processor_mask_words;
+	uint32_t processor_count = 0;
+	for (uint32_t i = processor_start; i < processor_end; i++) {
+		if (is_processor_in_mask(processor_mask, i)) {
+			if (processor_count++ == 0) {
+				processor_start = i;
+			}
+		}
+	}
+	affinity->processor_start = processor_start;
+	affinity->processor_count = processor_count;
+	if (processor_count == 0) {
+		return;
+	}
+
+	#if defined(__linux__)
+		unsigned long* linux_cpu_set = builder->linux_cpu_sets;
+		builder->linux_cpu_sets += builder->linux_cpu_set_words;
+		for (uint32_t i = processor_start; i < processor_end; i++) {
+			if (is_processor_in_mask(processor_mask, i)) {
+				const uint32_t linux_id = (uint32_t) processors[i].linux_id;
+				linux_cpu_set[linux_id / CPU_SET_WORD_BITS] |= 1ul << (linux_id % CPU_SET_WORD_BITS);
+			}
+		}
+		affinity->linux_cpu_set = linux_cpu_set;
+		affinity->linux_cpu_set_size = builder->linux_cpu_set_words * sizeof(unsigned long);
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		const uint16_t group = processors[processor_start].windows_group_id;
+		uintptr_t mask = 0;
+		for (uint32_t i = processor_start; i < processor_end; i++) {
+			if (is_processor_in_mask(processor_mask, i) && processors[i].windows_group_id == group) {
+				mask |= (uintptr_t) 1 << processors[i].windows_processor_id;
+			}
+		}
+		affinity->windows_group_affinity.group = group;
+		affinity->windows_group_affinity.mask = mask;
+	#elif defined(__MACH__) && defined(__APPLE__)
+		const struct cpuinfo_cache* l2 = processors[processor_start].cache.l2;
+		const struct cpuinfo_cache* l2_table = builder->tables->cache[cpuinfo_cache_level_2];
+		if (l2 != NULL && l2_table != NULL) {
+			affinity->mach_affinity_tag = (int32_t) (l2 - l2_table) + 1;
+		}
+	#else
+		(void) processors;
+	#endif
+}
+
+/* Fill the affinity of a topology object with contiguous logical processors */
+static void init_range_affinity(struct affinity_builder builder[restrict static 1], struct cpuinfo_affinity* affinity,
+	uint32_t processor_start, uint32_t processor_count)
+{
+	uint64_t* processor_mask = get_processor_mask(builder);
+	for (uint32_t i = processor_start; i < processor_start + processor_count; i++) {
+		processor_mask[i / PROCESSOR_MASK_WORD_BITS] |= UINT64_C(1) << (i % PROCESSOR_MASK_WORD_BITS);
+	}
+	init_affinity(builder, affinity, processor_mask, processor_start, processor_start + processor_count);
+}
+
+bool cpuinfo_build_affinities(struct cpuinfo_tables* tables) {
+	uint32_t objects_count = tables->processors_count + tables->cores_count +
+		tables->clusters_count + tables->packages_count + tables->uarchs_count;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		objects_count += tables->cache_count[level];
+	}
+	const uint32_t processor_mask_words =
+		(tables->processors_count + (PROCESSOR_MASK_WORD_BITS - 1)) / PROCESSOR_MASK_WORD_BITS;
+
+	struct cpuinfo_arena arena = { 0 };
+	const size_t processor_affinities_offset =
+		cpuinfo_arena_reserve(&arena, tables->processors_count, sizeof(struct cpuinfo_affinity));
+	const size_t core_affinities_offset =
+		cpuinfo_arena_reserve(&arena, tables->cores_count, sizeof(struct cpuinfo_affinity));
+	const size_t cluster_affinities_offset =
+		cpuinfo_arena_reserve(&arena, tables->clusters_count, sizeof(struct cpuinfo_affinity));
+	const size_t package_affinities_offset =
+		cpuinfo_arena_reserve(&arena, tables->packages_count, sizeof(struct cpuinfo_affinity));
+	size_t cache_affinities_offset[cpuinfo_cache_level_max];
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cache_affinities_offset[level] =
+			cpuinfo_arena_reserve(&arena, tables->cache_count[level], sizeof(struct cpuinfo_affinity));
+	}
+	const size_t uarch_affinities_offset =
+		cpuinfo_arena_reserve(&arena, tables->uarchs_count, sizeof(struct cpuinfo_affinity));
+	const size_t processor_masks_offset =
+		cpuinfo_arena_reserve(&arena, (size_t) objects_count * processor_mask_words, sizeof(uint64_t));
+	#if defined(__linux__)
+		/* Masks are sized as CPU_ALLOC_SIZE for the maximum Linux processor ID */
+		uint32_t linux_cpu_count = 0;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const uint32_t linux_id = (uint32_t) tables->processors[i].linux_id;
+			if (linux_id >= linux_cpu_count) {
+				linux_cpu_count = linux_id + 1;
+			}
+		}
+		const uint32_t linux_cpu_set_words = (linux_cpu_count + (CPU_SET_WORD_BITS - 1)) / CPU_SET_WORD_BITS;
+		const size_t linux_cpu_sets_offset =
+			cpuinfo_arena_reserve(&arena, (size_t) objects_count * linux_cpu_set_words, sizeof(unsigned long));
+	#endif
+	tables->processor_mask_words = processor_mask_words;
+	if (objects_count == 0) {
+		return true;
+	}
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return false;
+	}
+
+	struct affinity_builder builder = {
+		.tables = tables,
+		.processor_masks =
+			cpuinfo_arena_get(&arena, processor_masks_offset, (size_t) objects_count * processor_mask_words),
+		.processor_mask_words = processor_mask_words,
+	#if defined(__linux__)
+		.linux_cpu_sets = cpuinfo_arena_get(&arena, linux_cpu_sets_offset, (size_t) objects_count * linux_cpu_set_words),
+		.linux_cpu_set_words = linux_cpu_set_words,
+	#endif
+	};
+
+	struct cpuinfo_affinity* processor_affinities =
+		cpuinfo_arena_get(&arena, processor_affinities_offset, tables->processors_count);
+	for (uint32_t i = 0; i < tables->processors_count; i++) {
+		init_range_affinity(&builder, &processor_affinities[i], i, 1);
+	}
+	struct cpuinfo_affinity* core_affinities =
+		cpuinfo_arena_get(&arena, core_affinities_offset, tables->cores_count);
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		init_range_affinity(&builder, &core_affinities[i],
+			tables->cores[i].processor_start, tables->cores[i].processor_count);
+	}
+	struct cpuinfo_affinity* cluster_affinities =
+		cpuinfo_arena_get(&arena, cluster_affinities_offset, tables->clusters_count);
+	for (uint32_t i = 0; i < tables->clusters_count; i++) {
+		init_range_affinity(&builder, &cluster_affinities[i],
+			tables->clusters[i].processor_start, tables->clusters[i].processor_count);
+	}
+	struct cpuinfo_affinity* package_affinities =
+		cpuinfo_arena_get(&arena, package_affinities_offset, tables->packages_count);
+	for (uint32_t i = 0; i < tables->packages_count; i++) {
+		init_range_affinity(&builder, &package_affinities[i],
+			tables->packages[i].processor_start, tables->packages[i].processor_count);
+	}
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		struct cpuinfo_affinity* cache_affinities =
+			cpuinfo_arena_get(&arena, cache_affinities_offset[level], tables->cache_count[level]);
+		for (uint32_t i = 0; i < tables->cache_count[level]; i++) {
+			init_range_affinity(&builder, &cache_affinities[i],
+				tables->cache[level][i].processor_start, tables->cache[level][i].processor_count);
+		}
+		tables->cache_affinities[level] = cache_affinities;
+	}
+
+	/* Logical processors of a microarchitecture may be not contiguous, e.g. on x86 hybrid processors */
+	struct cpuinfo_affinity* uarch_affinities =
+		cpuinfo_arena_get(&arena, uarch_affinities_offset, tables->uarchs_count);
+	for (uint32_t uarch_index = 0; uarch_index < tables->uarchs_count; uarch_index++) {
+		uint64_t* processor_mask = get_processor_mask(&builder);
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			if (cpuinfo_get_processor_uarch_index(tables, &tables->processors[i]) == uarch_index) {
+				processor_mask[i / PROCESSOR_MASK_WORD_BITS] |= UINT64_C(1) << (i % PROCESSOR_MASK_WORD_BITS);
+			}
+		}
+		init_affinity(&builder, &uarch_affinities[uarch_index], processor_mask, 0, tables->processors_count);
+	}
+
+	tables->processor_affinities = processor_affinities;
+	tables->core_affinities = core_affinities;
+	tables->cluster_affinities = cluster_affinities;
+	tables->package_affinities = package_affinities;
+	tables->uarch_affinities = uarch_affinities;
+	tables->affinity_memory = arena.memory;
+	return true;
+}
+
+#if defined(__linux__)
+	bool CPUINFO_ABI cpuinfo_processor_mask_to_linux_cpu_set(const uint64_t* processor_mask, unsigned long* cpu_set,
+		uint32_t cpu_set_size)
+	{
+		const struct cpuinfo_tables* tables = cpuinfo_get_tables("processor_mask_to_linux_cpu_set");
+		if (processor_mask == NULL || cpu_set == NULL) {
+			return false;
+		}
+		const size_t cpu_set_words = cpu_set_size / sizeof(unsigned long);
+		for (size_t i = 0; i < cpu_set_words; i++) {
+			cpu_set[i] = 0;
+		}
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			if (!is_processor_in_mask(processor_mask, i)) {
+				continue;
+			}
+			const uint32_t linux_id = (uint32_t) tables->processors[i].linux_id;
+			if (linux_id / CPU_SET_WORD_BITS >= cpu_set_words) {
+				return false;
+			}
+			cpu_set[linux_id / CPU_SET_WORD_BITS] |= 1ul << (linux_id % CPU_SET_WORD_BITS);
+		}
+		return true;
+	}
+#elif defined(_WIN32) || defined(__CYGWIN__)
+	bool CPUINFO_ABI cpuinfo_processor_mask_to_windows_group_affinity(const uint64_t* processor_mask, uint16_t group,
+		uintptr_t* group_mask)
+	{
+		const struct cpuinfo_tables* tables = cpuinfo_get_tables("processor_mask_to_windows_group_affinity");
+		if (processor_mask == NULL || group_mask == NULL) {
+			return false;
+		}
+		uintptr_t mask = 0;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			if (is_processor_in_mask(processor_mask, i) && processor->windows_group_id == group) {
+				mask |= (uintptr_t) 1 << processor->windows_processor_id;
+			}
+		}
+		*group_mask = mask;
+		return mask != 0;
+	}
+
+	/* Layout of SYSTEM_CPU_SET_INFORMATION of Windows 10, which SDK headers don't declare for Windows 7 targets */
+	struct windows_cpu_set_information {
+		DWORD size;
+		DWORD type;
+		DWORD id;
+		WORD group;
+		BYTE logical_processor_index;
+		BYTE core_index;
+		BYTE last_level_cache_index;
+		BYTE numa_node_index;
+		BYTE efficiency_class;
+		BYTE flags;
+		BYTE scheduling_class;
+		BYTE reserved[3];
+		DWORD64 allocation_tag;
+	};
+
+	/* CpuSetInformation value of CPU_SET_INFORMATION_TYPE, and bits of AllFlags */
+	#define WINDOWS_CPU_SET_INFORMATION 0
+	#define WINDOWS_CPU_SET_FLAG_PARKED                      0x01
+	#define WINDOWS_CPU_SET_FLAG_ALLOCATED                   0x02
+	#define WINDOWS_CPU_SET_FLAG_ALLOCATED_TO_TARGET_PROCESS 0x04
+	#define WINDOWS_CPU_SET_FLAG_REALTIME                    0x08
+
+	typedef BOOL (WINAPI* get_system_cpu_set_information_function)(PVOID, ULONG, PULONG, HANDLE, ULONG);
+	typedef BOOL (WINAPI* set_thread_selected_cpu_sets_function)(HANDLE, const ULONG*, ULONG);
+
+	/* Look up a function of Windows 10 in kernel32.dll: cpuinfo also supports Windows 7 */
+	static void (*get_kernel32_function(const char* name))(void) {
+		HMODULE kernel32 = GetModuleHandleW(L"kernel32.dll");
+		return kernel32 != NULL ? (void (*)(void)) GetProcAddress(kernel32, name) : NULL;
+	}
+
+	/*
+	 * Query CPU sets of the system into a buffer allocated on the process heap, which the caller must free.
+	 * Returns NULL if the OS doesn't support CPU sets.
+	 */
+	static struct windows_cpu_set_information* query_cpu_sets(HANDLE heap, ULONG size[restrict static 1]) {
+		const get_system_cpu_set_information_function get_system_cpu_set_information =
+			(get_system_cpu_set_information_function) get_kernel32_function("GetSystemCpuSetInformation");
+		if (get_system_cpu_set_information == NULL) {
+			cpuinfo_log_debug("GetSystemCpuSetInformation is not supported");
+			return NULL;
+		}
+		*size = 0;
+		if (!get_system_cpu_set_information(NULL, 0, size, GetCurrentProcess(), 0) &&
+			GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+		{
+			cpuinfo_log_warning("failed to query size of CPU sets information: error %"PRIu32,
+				(uint32_t) GetLastError());
+			return NULL;
+		}
+		struct windows_cpu_set_information* cpu_sets = HeapAlloc(heap, 0, *size);
+		if (cpu_sets == NULL) {
+			cpuinfo_log_error("failed to allocate %"PRIu32" bytes for CPU sets information", (uint32_t) *size);
+			return NULL;
+		}
+		if (!get_system_cpu_set_information(cpu_sets, *size, size, GetCurrentProcess(), 0)) {
+			cpuinfo_log_warning("failed to query CPU sets information: error %"PRIu32, (uint32_t) GetLastError());
+			HeapFree(heap, 0, cpu_sets);
+			return NULL;
+		}
+		return cpu_sets;
+	}
+
+	static const struct windows_cpu_set_information* next_cpu_set(const struct windows_cpu_set_information* cpu_set) {
+		return (const struct windows_cpu_set_information*) ((uintptr_t) cpu_set + cpu_set->size);
+	}
+
+	void cpuinfo_windows_detect_cpu_sets(struct cpuinfo_processor* processors, uint32_t processors_count) {
+		HANDLE heap = GetProcessHeap();
+		ULONG size = 0;
+		struct windows_cpu_set_information* cpu_sets = query_cpu_sets(heap, &size);
+		if (cpu_sets == NULL) {
+			return;
+		}
+		const struct windows_cpu_set_information* cpu_sets_end =
+			(const struct windows_cpu_set_information*) ((uintptr_t) cpu_sets + size);
+		for (const struct windows_cpu_set_information* cpu_set = cpu_sets; cpu_set < cpu_sets_end;
+			cpu_set = next_cpu_set(cpu_set))
+		{
+			if (cpu_set->type != WINDOWS_CPU_SET_INFORMATION) {
+				continue;
+			}
+			for (uint32_t i = 0; i < processors_count; i++) {
+				if (processors[i].windows_group_id == cpu_set->group &&
+					processors[i].windows_processor_id == cpu_set->logical_processor_index)
+				{
+					processors[i].windows_cpu_set_id = (uint32_t) cpu_set->id;
+					break;
+				}
+			}
+		}
+		HeapFree(heap, 0, cpu_sets);
+	}
+
+	bool CPUINFO_ABI cpuinfo_get_windows_cpu_set_state(const struct cpuinfo_processor* processor,
+		struct cpuinfo_windows_cpu_set_state* state)
+	{
+		const struct cpuinfo_tables* tables = cpuinfo_get_tables("windows_cpu_set_state");
+		uint32_t index;
+		if (state == NULL || !cpuinfo_get_table_index(processor, tables->processors, tables->processors_count,
+				sizeof(struct cpuinfo_processor), &index) || processor->windows_cpu_set_id == 0)
+		{
+			return false;
+		}
+
+		HANDLE heap = GetProcessHeap();
+		ULONG size = 0;
+		struct windows_cpu_set_information* cpu_sets = query_cpu_sets(heap, &size);
+		if (cpu_sets == NULL) {
+			return false;
+		}
+		bool found = false;
+		const struct windows_cpu_set_information* cpu_sets_end =
+			(const struct windows_cpu_set_information*) ((uintptr_t) cpu_sets + size);
+		for (const struct windows_cpu_set_information* cpu_set = cpu_sets; cpu_set < cpu_sets_end && !found;
+			cpu_set = next_cpu_set(cpu_set))
+		{
+			if (cpu_set->type == WINDOWS_CPU_SET_INFORMATION && cpu_set->id == processor->windows_cpu_set_id) {
+				*state = (struct cpuinfo_windows_cpu_set_state) {
+					.parked = (cpu_set->flags & WINDOWS_CPU_SET_FLAG_PARKED) != 0,
+					.allocated = (cpu_set->flags & WINDOWS_CPU_SET_FLAG_ALLOCATED) != 0,
+					.allocated_to_current_process =
+						(cpu_set->flags & WINDOWS_CPU_SET_FLAG_ALLOCATED_TO_TARGET_PROCESS) != 0,
+					.realtime = (cpu_set->flags & WINDOWS_CPU_SET_FLAG_REALTIME) != 0,
+					.efficiency_class = cpu_set->efficiency_class,
+					.scheduling_class = cpu_set->scheduling_class,
+				};
+				found = true;
+			}
+		}
+		HeapFree(heap, 0, cpu_sets);
+		return found;
+	}
+
+	bool CPUINFO_ABI cpuinfo_select_current_thread_cpu_sets(const struct cpuinfo_affinity* affinity) {
+		const struct cpuinfo_tables* tables = cpuinfo_get_tables("select_current_thread_cpu_sets");
+		const set_thread_selected_cpu_sets_function set_thread_selected_cpu_sets =
+			(set_thread_selected_cpu_sets_function) get_kernel32_function("SetThreadSelectedCpuSets");
+		if (set_thread_selected_cpu_sets == NULL) {
+			return false;
+		}
+		if (affinity == NULL) {
+			return set_thread_selected_cpu_sets(GetCurrentThread(), NULL, 0) != FALSE;
+		}
+		if (affinity->processor_count == 0) {
+			return false;
+		}
+
+		HANDLE heap = GetProcessHeap();
+		ULONG* cpu_set_ids = HeapAlloc(heap, 0, affinity->processor_count * sizeof(ULONG));
+		if (cpu_set_ids == NULL) {
+			cpuinfo_log_error("failed to allocate CPU set IDs of %"PRIu32" processors", affinity->processor_count);
+			return false;
+		}
+		ULONG cpu_set_ids_count = 0;
+		bool status = true;
+		for (uint32_t i = 0; i < tables->processors_count && cpu_set_ids_count < affinity->processor_count; i++) {
+			if (is_processor_in_mask(affinity->processor_mask, i)) {
+				if (tables->processors[i].windows_cpu_set_id == 0) {
+					status = false;
+					break;
+				}
+				cpu_set_ids[cpu_set_ids_count++] = (ULONG) tables->processors[i].windows_cpu_set_id;
+			}
+		}
+		if (status && !set_thread_selected_cpu_sets(GetCurrentThread(), cpu_set_ids, cpu_set_ids_count)) {
+			cpuinfo_log_debug("failed to select CPU sets of processors %"PRIu32"-%"PRIu32": error %"PRIu32,
+				affinity->processor_start, affinity->processor_start + affinity->processor_count - 1,
+				(uint32_t) GetLastError());
+			status = false;
+		}
+		HeapFree(heap, 0, cpu_set_ids);
+		return status;
+	}
+
+	/* Layout of THREAD_POWER_THROTTLING_STATE of Windows 10, and ThreadPowerThrottling of THREAD_INFORMATION_CLASS */
+	struct windows_thread_power_throttling_state {
+		ULONG version;
+		ULONG control_mask;
+		ULONG state_mask;
+	};
+
+	#define WINDOWS_THREAD_POWER_THROTTLING 3
+	#define WINDOWS_THREAD_POWER_THROTTLING_CURRENT_VERSION 1
+	#define WINDOWS_THREAD_POWER_THROTTLING_EXECUTION_SPEED 0x1
+
+	typedef BOOL (WINAPI* set_thread_information_function)(HANDLE, int, PVOID, DWORD);
+
+	static bool set_current_thread_power_throttling(enum cpuinfo_core_preference preference) {
+		const set_thread_information_function set_thread_information =
+			(set_thread_information_function) get_kernel32_function("SetThreadInformation");
+		if (set_thread_information == NULL) {
+			return false;
+		}
+		/* Without control of execution speed, the OS decides whether to throttle the thread */
+		struct windows_thread_power_throttling_state state = {
+			.version = WINDOWS_THREAD_POWER_THROTTLING_CURRENT_VERSION,
+		};
+		if (preference != cpuinfo_core_preference_none) {
+			state.control_mask = WINDOWS_THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+		}
+		if (preference == cpuinfo_core_preference_efficiency) {
+			state.state_mask = WINDOWS_THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+		}
+		if (!set_thread_information(GetCurrentThread(), WINDOWS_THREAD_POWER_THROTTLING, &state, sizeof(state))) {
+			cpuinfo_log_debug("failed to set power throttling of the current thread: error %"PRIu32,
+				(uint32_t) GetLastError());
+			return false;
+		}
+		return true;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_set_current_thread_affinity(const struct cpuinfo_affinity* affinity) {
+	if (affinity == NULL || affinity->processor_count == 0) {
+		return false;
+	}
+
+	#if defined(__linux__)
+		const cpu_set_t* cpu_set = (const cpu_set_t*) affinity->linux_cpu_set;
+		if (sched_setaffinity(0, (size_t) affinity->linux_cpu_set_size, cpu_set) != 0) {
+			cpuinfo_log_debug("failed to set affinity of the current thread to processors %"PRIu32"-%"PRIu32,
+				affinity->processor_start, affinity->processor_start + affinity->processor_count - 1);
+			return false;
+		}
+		return true;
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		GROUP_AFFINITY group_affinity = {
+			.Mask = (KAFFINITY) affinity->windows_group_affinity.mask,
+			.Group = (WORD) affinity->windows_group_affinity.group,
+		};
+		if (!SetThreadGroupAffinity(GetCurrentThread(), &group_affinity, NULL)) {
+			cpuinfo_log_debug(
+				"failed to set affinity of the current thread to processors %"PRIu32"-%"PRIu32": error %"PRIu32,
+				affinity->processor_start, affinity->processor_start + affinity->processor_count - 1,
+				(uint32_t) GetLastError());
+			return false;
+		}
+		return true;
+	#elif defined(__MACH__) && defined(__APPLE__)
+		thread_affinity_policy_data_t policy = { .affinity_tag = (integer_t) affinity->mach_affinity_tag };
+		const kern_return_t status = thread_policy_set(pthread_mach_thread_np(pthread_self()),
+			THREAD_AFFINITY_POLICY, (thread_policy_t) &policy, THREAD_AFFINITY_POLICY_COUNT);
+		if (status != KERN_SUCCESS) {
+			cpuinfo_log_debug("failed to set affinity tag %"PRId32" of the current thread: error %d",
+				affinity->mach_affinity_tag, (int) status);
+			return false;
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_processor(const struct cpuinfo_processor* processor) {
+	return cpuinfo_set_current_thread_affinity(cpuinfo_get_processor_affinity(processor));
+}
+
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_core(const struct cpuinfo_core* core) {
+	return cpuinfo_set_current_thread_affinity(cpuinfo_get_core_affinity(core));
+}
+
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_cluster(const struct cpuinfo_cluster* cluster) {
+	return cpuinfo_set_current_thread_affinity(cpuinfo_get_cluster_affinity(cluster));
+}
+
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_package(const struct cpuinfo_package* package) {
+	return cpuinfo_set_current_thread_affinity(cpuinfo_get_package_affinity(package));
+}
+
+bool CPUINFO_ABI cpuinfo_pin_current_thread_to_cache(const struct cpuinfo_cache* cache) {
+	return cpuinfo_set_current_thread_affinity(cpuinfo_get_cache_affinity(cache));
+}
+
+bool CPUINFO_ABI cpuinfo_save_current_thread_affinity(struct cpuinfo_thread_affinity_state* state) {
+	if (state == NULL) {
+		return false;
+	}
+	state->valid = false;
+
+	#if defined(__linux__)
+		if (sched_getaffinity(0, sizeof(state->linux_cpu_set), (cpu_set_t*) state->linux_cpu_set) != 0) {
+			cpuinfo_log_debug("failed to get affinity of the current thread");
+			return false;
+		}
+		state->valid = true;
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		GROUP_AFFINITY group_affinity;
+		if (!GetThreadGroupAffinity(GetCurrentThread(), &group_affinity)) {
+			cpuinfo_log_debug("failed to get affinity of the current thread: error %"PRIu32,
+				(uint32_t) GetLastError());
+			return false;
+		}
+		state->windows_group_affinity.mask = (uintptr_t) group_affinity.Mask;
+		state->windows_group_affinity.group = (uint16_t) group_affinity.Group;
+		state->valid = true;
+	#elif defined(__MACH__) && defined(__APPLE__)
+		thread_affinity_policy_data_t policy = { .affinity_tag = THREAD_AFFINITY_TAG_NULL };
+		mach_msg_type_number_t count = THREAD_AFFINITY_POLICY_COUNT;
+		boolean_t get_default = FALSE;
+		const kern_return_t status = thread_policy_get(pthread_mach_thread_np(pthread_self()),
+			THREAD_AFFINITY_POLICY, (thread_policy_t) &policy, &count, &get_default);
+		if (status != KERN_SUCCESS) {
+			cpuinfo_log_debug("failed to get affinity tag of the current thread: error %d", (int) status);
+			return false;
+		}
+		state->mach_affinity_tag = (int32_t) policy.affinity_tag;
+		state->valid = true;
+	#endif
+	return state->valid;
+}
+
+bool CPUINFO_ABI cpuinfo_restore_current_thread_affinity(const struct cpuinfo_thread_affinity_state* state) {
+	if (state == NULL || !state->valid) {
+		return false;
+	}
+
+	#if defined(__linux__)
+		if (sched_setaffinity(0, sizeof(state->linux_cpu_set), (const cpu_set_t*) state->linux_cpu_set) != 0) {
+			cpuinfo_log_debug("failed to restore affinity of the current thread");
+			return false;
+		}
+		return true;
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		GROUP_AFFINITY group_affinity = {
+			.Mask = (KAFFINITY) state->windows_group_affinity.mask,
+			.Group = (WORD) state->windows_group_affinity.group,
+		};
+		if (!SetThreadGroupAffinity(GetCurrentThread(), &group_affinity, NULL)) {
+			cpuinfo_log_debug("failed to restore affinity of the current thread: error %"PRIu32,
+				(uint32_t) GetLastError());
+			return false;
+		}
+		return true;
+	#elif defined(__MACH__) && defined(__APPLE__)
+		thread_affinity_policy_data_t policy = { .affinity_tag = (integer_t) state->mach_affinity_tag };
+		const kern_return_t status = thread_policy_set(pthread_mach_thread_np(pthread_self()),
+			THREAD_AFFINITY_POLICY, (thread_policy_t) &policy, THREAD_AFFINITY_POLICY_COUNT);
+		if (status != KERN_SUCCESS) {
+			cpuinfo_log_debug("failed to restore affinity tag %"PRId32" of the current thread: error %d",
+				state->mach_affinity_tag, (int) status);
+			return false;
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+#if defined(__linux__) || defined(_WIN32) || defined(__CYGWIN__)
+	/* Whether core a has higher performance than core b */
+	static bool is_faster_core(const struct cpuinfo_core* a, const struct cpuinfo_core* b) {
+		#if defined(_WIN32) || defined(__CYGWIN__)
+			if (a->windows_efficiency_class != b->windows_efficiency_class) {
+				return a->windows_efficiency_class > b->windows_efficiency_class;
+			}
+		#endif
+		if (a->capacity != b->capacity) {
+			return a->capacity > b->capacity;
+		}
+		return a->performance > b->performance;
+	}
+
+	/* Affinity of the microarchitecture with the fastest or the slowest cores */
+	static const struct cpuinfo_affinity* get_preferred_uarch_affinity(const struct cpuinfo_tables* tables,
+		enum cpuinfo_core_preference preference)
+	{
+		if (tables->uarch_affinities == NULL) {
+			return NULL;
+		}
+		const struct cpuinfo_core* preferred_core = NULL;
+		uint32_t preferred_uarch_index = 0;
+		for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+			const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, i);
+			if (processor == NULL) {
+				continue;
+			}
+			if (preferred_core == NULL || (preference == cpuinfo_core_preference_performance ?
+				is_faster_core(processor->core, preferred_core) : is_faster_core(preferred_core, processor->core)))
+			{
+				preferred_core = processor->core;
+				preferred_uarch_index = i;
+			}
+		}
+		return preferred_core != NULL ? &tables->uarch_affinities[preferred_uarch_index] : NULL;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_set_current_thread_core_preference(enum cpuinfo_core_preference preference) {
+	if (preference != cpuinfo_core_preference_none && preference != cpuinfo_core_preference_performance &&
+		preference != cpuinfo_core_preference_efficiency)
+	{
+		return false;
+	}
+
+	#if defined(__linux__)
+		const struct cpuinfo_tables* tables = cpuinfo_get_tables("set_current_thread_core_preference");
+		if (preference != cpuinfo_core_preference_none) {
+			return cpuinfo_set_current_thread_affinity(get_preferred_uarch_affinity(tables, preference));
+		}
+
+		unsigned long cpu_set[CPUINFO_THREAD_AFFINITY_MAX_LINUX_CPUS / CPU_SET_WORD_BITS] = { 0 };
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			const uint32_t linux_id = (uint32_t) processor->linux_id;
+			if (processor->usable && linux_id < CPUINFO_THREAD_AFFINITY_MAX_LINUX_CPUS) {
+				cpu_set[linux_id / CPU_SET_WORD_BITS] |= 1ul << (linux_id % CPU_SET_WORD_BITS);
+			}
+		}
+		if (sched_setaffinity(0, sizeof(cpu_set), (const cpu_set_t*) cpu_set) != 0) {
+			cpuinfo_log_debug("failed to set affinity of the current thread to all usable processors");
+			return false;
+		}
+		return true;
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		const struct cpuinfo_tables* tables = cpuinfo_get_tables("set_current_thread_core_preference");
+		const bool throttling_set = set_current_thread_power_throttling(preference);
+		const struct cpuinfo_affinity* affinity = NULL;
+		if (preference != cpuinfo_core_preference_none) {
+			affinity = get_preferred_uarch_affinity(tables, preference);
+			if (affinity == NULL) {
+				return throttling_set;
+			}
+		}
+		const bool cpu_sets_selected = cpuinfo_select_current_thread_cpu_sets(affinity);
+		return throttling_set || cpu_sets_selected;
+	#elif defined(__MACH__) && defined(__APPLE__)
+		qos_class_t qos_class = QOS_CLASS_DEFAULT;
+		switch (preference) {
+			case cpuinfo_core_preference_performance:
+				qos_class = QOS_CLASS_USER_INITIATED;
+				break;
+			case cpuinfo_core_preference_efficiency:
+				/* The only class which keeps threads on efficiency cores of Apple Silicon */
+				qos_class = QOS_CLASS_BACKGROUND;
+				break;
+			default:
+				break;
+		}
+		const int error = pthread_set_qos_class_self_np(qos_class, 0);
+		if (error != 0) {
+			cpuinfo_log_debug("failed to set QoS class %d of the current thread: error %d", (int) qos_class, error);
+			return false;
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
@@ -1,5 +1,7 @@
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <inttypes.h>
 
 #include <cpuinfo.h>
 #include <cpuinfo/internal-api.h>
@@ -13,9 +15,31 @@
 	#if !defined(__NR_getcpu)
 		#include <asm-generic/unistd.h>
 	#endif
+
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#include <x86/linux/api.h>
+	#endif
+#elif defined(__MACH__) && defined(__APPLE__)
+	#include <Availability.h>
+	#include <pthread.h>
+
+	/* XNU versions before pthread_cpu_number_np keep the CPU number in the low bits of TPIDRRO_EL0 */
+	#define CPUINFO_MACH_TPIDRRO_EL0_CPU_MASK UINT64_C(0x7)
+#elif defined(__FreeBSD__)
+	#include <sched.h>
 #endif
 
 bool cpuinfo_is_initialized = false;
+bool cpuinfo_isa_is_initialized = false;
+bool cpuinfo_parallel_probing = false;
+bool cpuinfo_wait_in_getters = false;
+bool cpuinfo_per_processor_cpuid = false;
+bool cpuinfo_reclaim_retired_tables = false;
+bool cpuinfo_replaying_capture = false;
+char cpuinfo_chipset_cache_directory[CPUINFO_CHIPSET_CACHE_DIRECTORY_MAX] = { 0 };
+struct cpuinfo_allocator cpuinfo_allocator = { 0 };
+struct cpuinfo_file_ops cpuinfo_file_ops = { 0 };
+void* cpuinfo_arena_memory = NULL;
 
 struct cpuinfo_processor* cpuinfo_processors = NULL;
 struct cpuinfo_core* cpuinfo_cores = NULL;
@@ -29,382 +53,1487 @@ uint32_t cpuinfo_clusters_count = 0;
 uint32_t cpuinfo_packages_count = 0;
 uint32_t cpuinfo_cache_count[cpuinfo_cache_level_max] = { 0 };
 uint32_t cpuinfo_max_cache_size = 0;
+struct cpuinfo_integrated_gpu cpuinfo_integrated_gpu = { 0 };
+struct cpuinfo_npu cpuinfo_npu = { 0 };
 
-#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-	struct cpuinfo_uarch_info* cpuinfo_uarchs = NULL;
-	uint32_t cpuinfo_uarchs_count = 0;
-#else
+struct cpuinfo_uarch_info* cpuinfo_uarchs = NULL;
+uint32_t cpuinfo_uarchs_count = 0;
+const struct cpuinfo_uarch_tlbs* cpuinfo_uarch_tlbs = NULL;
+#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
 	struct cpuinfo_uarch_info cpuinfo_global_uarch = { cpuinfo_uarch_unknown };
+	struct cpuinfo_uarch_tlbs cpuinfo_global_uarch_tlbs = { { { 0 } } };
 #endif
 
 #ifdef __linux__
 	uint32_t cpuinfo_linux_cpu_max = 0;
+	uint32_t cpuinfo_linux_current_cpu_method = cpuinfo_linux_current_cpu_method_syscall;
 	const struct cpuinfo_processor** cpuinfo_linux_cpu_to_processor_map = NULL;
 	const struct cpuinfo_core** cpuinfo_linux_cpu_to_core_map = NULL;
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		const uint32_t* cpuinfo_linux_cpu_to_uarch_index_map = NULL;
-	#endif
+	const uint32_t* cpuinfo_linux_cpu_to_uarch_index_map = NULL;
 #endif
 
+struct cpuinfo_tables* cpuinfo_tables = NULL;
+const struct cpuinfo_hot_tables* cpuinfo_published_hot_tables = NULL;
+/* Generation of the last published tables; never reset, so that generations increase across deinitialization */
+static uint64_t tables_generation = 0;
 
-const struct cpuinfo_processor* cpuinfo_get_processors(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "processors");
+
+static void release_tables(struct cpuinfo_tables* tables) {
+	cpuinfo_arena_free(tables->huge_page_memory);
+	cpuinfo_arena_free(tables->current_location_map);
+	cpuinfo_arena_free(tables->llc_domain_memory);
+	cpuinfo_arena_free(tables->numa_memory);
+	cpuinfo_arena_free(tables->frequency_memory);
+	cpuinfo_arena_free(tables->usable_processor_indices);
+	cpuinfo_arena_free(tables->performance_processor_indices);
+	cpuinfo_arena_free(tables->affinity_memory);
+	cpuinfo_arena_free(tables->processor_list_memory);
+	cpuinfo_arena_free(tables->processor_columns);
+	cpuinfo_arena_free(tables->arena_memory);
+	cpuinfo_unmap_snapshot(tables->snapshot_mapping, tables->snapshot_mapping_size);
+	free(tables->memory_performance_memory);
+	free(tables->core_latencies_memory);
+	free(tables->instruction_performance_memory);
+	cpuinfo_arena_free(tables);
+}
+
+uint32_t cpuinfo_get_processor_uarch_index(const struct cpuinfo_tables* tables,
+	const struct cpuinfo_processor* processor)
+{
+	#ifdef __linux__
+		if (tables->linux_cpu_to_uarch_index_map != NULL) {
+			return tables->linux_cpu_to_uarch_index_map[processor->linux_id];
+		}
+	#endif
+	const struct cpuinfo_core* core = processor->core;
+	for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+		#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			if (tables->uarchs[i].uarch == core->uarch && tables->uarchs[i].midr == core->midr) {
+				return i;
+			}
+		#elif CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			if (tables->uarchs[i].uarch == core->uarch && tables->uarchs[i].cpuid == core->cpuid) {
+				return i;
+			}
+		#else
+			if (tables->uarchs[i].uarch == core->uarch) {
+				return i;
+			}
+		#endif
 	}
-	return cpuinfo_processors;
+	return 0;
 }
 
-const struct cpuinfo_core* cpuinfo_get_cores(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "core");
+/* Processor number of the operating system for the logical processor, see current_location_map in cpuinfo_tables */
+static uint32_t get_location_index(const struct cpuinfo_tables* tables, uint32_t processor_index) {
+	#if defined(__linux__)
+		return (uint32_t) tables->processors[processor_index].linux_id;
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		const struct cpuinfo_processor* processor = &tables->processors[processor_index];
+		return (uint32_t) processor->windows_group_id * CPUINFO_WINDOWS_GROUP_SIZE + processor->windows_processor_id;
+	#elif defined(__MACH__) && defined(__APPLE__) && (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+		/*
+		 * Processors are sorted by decreasing performance, but XNU numbers CPUs starting with the efficiency cluster:
+		 * CPU numbers are assigned to clusters in reverse order, and to processors within a cluster in order.
+		 */
+		const struct cpuinfo_cluster* cluster = tables->processors[processor_index].cluster;
+		uint32_t location_index = processor_index - cluster->processor_start;
+		for (uint32_t i = cluster->cluster_id + 1; i < tables->clusters_count; i++) {
+			location_index += tables->clusters[i].processor_count;
+		}
+		return location_index;
+	#else
+		(void) tables;
+		return processor_index;
+	#endif
+}
+
+/* Key of the cache cluster of a logical processor: its L3 cache, or its cluster if it has no L3 cache */
+static const void* get_cache_cluster_key(const struct cpuinfo_processor* processor) {
+	if (processor->cache.l3 != NULL) {
+		return processor->cache.l3;
 	}
-	return cpuinfo_cores;
+	return processor->cluster;
 }
 
-const struct cpuinfo_cluster* cpuinfo_get_clusters(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "clusters");
+/* Highest maximum frequency of cores of a cache cluster, or 0 if it is unknown */
+static uint64_t get_cache_cluster_max_frequency(const struct cpuinfo_tables* tables,
+	const struct cpuinfo_cache_cluster cache_cluster[restrict static 1])
+{
+	uint64_t max_frequency = 0;
+	for (uint32_t i = cache_cluster->core_start; i < cache_cluster->core_start + cache_cluster->core_count; i++) {
+		const struct cpuinfo_core* core = &tables->cores[i];
+		const uint64_t frequency = core->max_turbo_frequency != 0 ? core->max_turbo_frequency : core->frequency;
+		if (frequency > max_frequency) {
+			max_frequency = frequency;
+		}
 	}
-	return cpuinfo_clusters;
+	return max_frequency;
 }
 
-const struct cpuinfo_package* cpuinfo_get_packages(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "packages");
+/*
+ * Flag cache clusters which stand out among asymmetric ones by the size of L3 cache or by frequency, e.g. core complex
+ * dies with and without 3D V-Cache on AMD processors. Symmetric cache clusters get no flags.
+ */
+static void flag_asymmetric_cache_clusters(const struct cpuinfo_tables* tables, uint32_t cache_clusters_count,
+	struct cpuinfo_cache_cluster cache_clusters[restrict static cache_clusters_count])
+{
+	uint32_t min_l3_size = UINT32_MAX, max_l3_size = 0;
+	uint64_t min_frequency = UINT64_MAX, max_frequency = 0;
+	for (uint32_t i = 0; i < cache_clusters_count; i++) {
+		const uint32_t l3_size = cache_clusters[i].l3 != NULL ? cache_clusters[i].l3->size : 0;
+		min_l3_size = min_l3_size < l3_size ? min_l3_size : l3_size;
+		max_l3_size = max_l3_size > l3_size ? max_l3_size : l3_size;
+		const uint64_t frequency = get_cache_cluster_max_frequency(tables, &cache_clusters[i]);
+		if (frequency != 0) {
+			min_frequency = min_frequency < frequency ? min_frequency : frequency;
+			max_frequency = max_frequency > frequency ? max_frequency : frequency;
+		}
+	}
+	for (uint32_t i = 0; i < cache_clusters_count; i++) {
+		const uint32_t l3_size = cache_clusters[i].l3 != NULL ? cache_clusters[i].l3->size : 0;
+		cache_clusters[i].large_l3 = min_l3_size != max_l3_size && l3_size == max_l3_size;
+		cache_clusters[i].high_frequency = min_frequency < max_frequency &&
+			get_cache_cluster_max_frequency(tables, &cache_clusters[i]) == max_frequency;
 	}
-	return cpuinfo_packages;
 }
 
-const struct cpuinfo_uarch_info* cpuinfo_get_uarchs() {
-	if (!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "uarchs");
+/*
+ * Group consecutive logical processors with the same last-level cache into domains, and with the same L3 cache into
+ * cache clusters. Both groupings are allocated in one arena.
+ */
+static bool build_llc_domains(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	uint32_t domains_count = 0, cache_clusters_count = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		if (i == 0 || cpuinfo_get_last_level_cache(&tables->processors[i]) !=
+			cpuinfo_get_last_level_cache(&tables->processors[i - 1]))
+		{
+			domains_count++;
+		}
+		if (i == 0 || get_cache_cluster_key(&tables->processors[i]) !=
+			get_cache_cluster_key(&tables->processors[i - 1]))
+		{
+			cache_clusters_count++;
+		}
+	}
+	if (domains_count == 0) {
+		return true;
+	}
+
+	struct cpuinfo_arena arena = { 0 };
+	const size_t domains_offset = cpuinfo_arena_reserve(&arena, domains_count, sizeof(struct cpuinfo_llc_domain));
+	const size_t domain_index_offset = cpuinfo_arena_reserve(&arena, processors_count, sizeof(uint32_t));
+	const size_t cache_clusters_offset =
+		cpuinfo_arena_reserve(&arena, cache_clusters_count, sizeof(struct cpuinfo_cache_cluster));
+	const size_t cache_cluster_index_offset = cpuinfo_arena_reserve(&arena, processors_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return false;
+	}
+	struct cpuinfo_llc_domain* domains = cpuinfo_arena_get(&arena, domains_offset, domains_count);
+	uint32_t* processor_domain_index = cpuinfo_arena_get(&arena, domain_index_offset, processors_count);
+	struct cpuinfo_cache_cluster* cache_clusters =
+		cpuinfo_arena_get(&arena, cache_clusters_offset, cache_clusters_count);
+	uint32_t* processor_cache_cluster_index = cpuinfo_arena_get(&arena, cache_cluster_index_offset, processors_count);
+
+	uint32_t domain_index = UINT32_MAX, cache_cluster_index = UINT32_MAX;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		const struct cpuinfo_cache* cache = cpuinfo_get_last_level_cache(processor);
+		const uint32_t core_index = (uint32_t) (processor->core - tables->cores);
+		if (i == 0 || cache != domains[domain_index].cache) {
+			domains[++domain_index] = (struct cpuinfo_llc_domain) {
+				.processor_start = i,
+				.core_start = core_index,
+				.cache = cache,
+				.size = cache != NULL ? cache->size : 0,
+			};
+		}
+		struct cpuinfo_llc_domain* domain = &domains[domain_index];
+		domain->processor_count += 1;
+		if (core_index >= domain->core_start + domain->core_count) {
+			domain->core_count = core_index + 1 - domain->core_start;
+		}
+		processor_domain_index[i] = domain_index;
+
+		const uint32_t cluster_index = (uint32_t) (processor->cluster - tables->clusters);
+		if (i == 0 || get_cache_cluster_key(processor) != get_cache_cluster_key(&tables->processors[i - 1])) {
+			cache_clusters[++cache_cluster_index] = (struct cpuinfo_cache_cluster) {
+				.processor_start = i,
+				.core_start = core_index,
+				.cluster_start = cluster_index,
+				.l3 = processor->cache.l3,
+			};
+		}
+		struct cpuinfo_cache_cluster* cache_cluster = &cache_clusters[cache_cluster_index];
+		cache_cluster->processor_count += 1;
+		if (core_index >= cache_cluster->core_start + cache_cluster->core_count) {
+			cache_cluster->core_count = core_index + 1 - cache_cluster->core_start;
+		}
+		if (cluster_index >= cache_cluster->cluster_start + cache_cluster->cluster_count) {
+			cache_cluster->cluster_count = cluster_index + 1 - cache_cluster->cluster_start;
+		}
+		processor_cache_cluster_index[i] = cache_cluster_index;
 	}
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_uarchs;
+	flag_asymmetric_cache_clusters(tables, cache_clusters_count, cache_clusters);
+
+	tables->llc_domains = domains;
+	tables->llc_domains_count = domains_count;
+	tables->processor_llc_domain_index = processor_domain_index;
+	tables->cache_clusters = cache_clusters;
+	tables->cache_clusters_count = cache_clusters_count;
+	tables->processor_cache_cluster_index = processor_cache_cluster_index;
+	tables->llc_domain_memory = arena.memory;
+	return true;
+}
+
+/* Precompute the locations of logical processors for the current processor getters */
+static bool build_location_map(struct cpuinfo_tables* tables) {
+	#if defined(__linux__) || defined(_WIN32) || defined(__CYGWIN__) || (defined(__MACH__) && defined(__APPLE__)) || \
+		defined(__FreeBSD__)
+		uint32_t location_count = 0;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const uint32_t location_index = get_location_index(tables, i);
+			if (location_index >= location_count) {
+				location_count = location_index + 1;
+			}
+		}
+		if (location_count == 0) {
+			return true;
+		}
+
+		/* Slots of last-level cache domains: distinct for domains with usable processors, and shared by other domains */
+		uint32_t* llc_slots = cpuinfo_allocate_temporary(tables->llc_domains_count, sizeof(uint32_t));
+		if (llc_slots == NULL && tables->llc_domains_count != 0) {
+			cpuinfo_log_error("failed to allocate %zu bytes for slots of %"PRIu32" last-level cache domains",
+				tables->llc_domains_count * sizeof(uint32_t), tables->llc_domains_count);
+			return false;
+		}
+		uint32_t llc_slots_count = 0;
+		for (uint32_t i = 0; i < tables->llc_domains_count; i++) {
+			const struct cpuinfo_llc_domain* llc_domain = &tables->llc_domains[i];
+			bool usable = false;
+			for (uint32_t j = 0; j < llc_domain->processor_count; j++) {
+				usable |= tables->processors[llc_domain->processor_start + j].usable;
+			}
+			llc_slots[i] = usable ? llc_slots_count++ : UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < tables->llc_domains_count; i++) {
+			if (llc_slots[i] == UINT32_MAX) {
+				llc_slots[i] = llc_slots_count != 0 ? i % llc_slots_count : 0;
+			}
+		}
+
+		struct cpuinfo_arena arena = { 0 };
+		cpuinfo_arena_reserve(&arena, location_count, sizeof(union cpuinfo_location_record));
+		if (!cpuinfo_arena_allocate(&arena)) {
+			cpuinfo_free_temporary(llc_slots);
+			return false;
+		}
+		/* Locations of processor numbers without a valid processor remain zero-initialized */
+		union cpuinfo_location_record* location_map = arena.memory;
+		const uint32_t usable_count = tables->usable_processors_count;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			const uint32_t llc_domain_index = tables->processor_llc_domain_index[i];
+			location_map[get_location_index(tables, i)].location = (struct cpuinfo_location) {
+				.processor = processor,
+				.core = processor->core,
+				.cluster = processor->cluster,
+				.package = processor->package,
+				.last_level_cache = cpuinfo_get_last_level_cache(processor),
+				.llc_domain = &tables->llc_domains[llc_domain_index],
+				.uarch_index = cpuinfo_get_processor_uarch_index(tables, processor),
+				/* Processors which are not usable share the slots of usable ones */
+				.slot = usable_count != 0 ? i % usable_count : 0,
+				.llc_slot = llc_slots[llc_domain_index],
+			};
+		}
+		for (uint32_t i = 0; i < usable_count; i++) {
+			const uint32_t processor_index = tables->usable_processor_indices[i];
+			location_map[get_location_index(tables, processor_index)].location.slot = i;
+		}
+		cpuinfo_free_temporary(llc_slots);
+		tables->current_location_map = location_map;
+		tables->current_location_count = location_count;
+		tables->llc_slots_count = llc_slots_count;
 	#else
-		return &cpuinfo_global_uarch;
+		(void) tables;
 	#endif
+	return true;
 }
 
-const struct cpuinfo_processor* cpuinfo_get_processor(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "processor");
+/* Release retired tables which no acquired snapshot may refer to; must be called with initialization lock held */
+static void reclaim_retired_tables(struct cpuinfo_tables* tables) {
+	const uint64_t min_pinned_generation = cpuinfo_get_min_pinned_generation();
+	struct cpuinfo_tables** link = &tables->retired;
+	while (*link != NULL) {
+		struct cpuinfo_tables* retired = *link;
+		if (retired->generation < min_pinned_generation) {
+			cpuinfo_log_debug("releasing retired tables of generation %"PRIu64, retired->generation);
+			*link = retired->retired;
+			release_tables(retired);
+		} else {
+			link = &retired->retired;
+		}
 	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_processors_count) {
-		return NULL;
+}
+
+bool cpuinfo_publish_tables(void) {
+	/* Allocated as an arena, so that tables land in the caller's buffer of cpuinfo_initialize_into */
+	struct cpuinfo_arena tables_arena = { 0 };
+	cpuinfo_arena_reserve(&tables_arena, 1, sizeof(struct cpuinfo_tables));
+	if (!cpuinfo_arena_allocate(&tables_arena)) {
+		cpuinfo_log_error("failed to allocate %zu bytes for published tables", sizeof(struct cpuinfo_tables));
+		return false;
+	}
+	struct cpuinfo_tables* tables = tables_arena.memory;
+
+	*tables = (struct cpuinfo_tables) {
+		.processors = cpuinfo_processors,
+		.cores = cpuinfo_cores,
+		.clusters = cpuinfo_clusters,
+		.packages = cpuinfo_packages,
+		.processors_count = cpuinfo_processors_count,
+		.cores_count = cpuinfo_cores_count,
+		.clusters_count = cpuinfo_clusters_count,
+		.packages_count = cpuinfo_packages_count,
+		.max_cache_size = cpuinfo_max_cache_size,
+		.integrated_gpu = cpuinfo_integrated_gpu,
+		.npu = cpuinfo_npu,
+		.uarchs = cpuinfo_uarchs,
+		.uarchs_count = cpuinfo_uarchs_count,
+		.uarch_tlbs = cpuinfo_uarch_tlbs,
+	#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+		.global_uarch = cpuinfo_global_uarch,
+		.global_uarch_tlbs = cpuinfo_global_uarch_tlbs,
+	#endif
+	#ifdef __linux__
+		.linux_cpu_max = cpuinfo_linux_cpu_max,
+		.linux_current_cpu_method = cpuinfo_linux_current_cpu_method,
+		.linux_cpu_to_processor_map = cpuinfo_linux_cpu_to_processor_map,
+		.linux_cpu_to_core_map = cpuinfo_linux_cpu_to_core_map,
+		.linux_cpu_to_uarch_index_map = cpuinfo_linux_cpu_to_uarch_index_map,
+	#endif
+		.arena_memory = cpuinfo_arena_memory,
+		.snapshot_mapping = cpuinfo_snapshot_mapping,
+		.snapshot_mapping_size = cpuinfo_snapshot_mapping_size,
+		.memory_performance = cpuinfo_memory_performance,
+		.core_latencies = cpuinfo_core_latencies,
+		.retired = cpuinfo_tables,
+		.generation = tables_generation + 1,
+	};
+	for (uint32_t i = 0; i < cpuinfo_cache_level_max; i++) {
+		tables->cache[i] = cpuinfo_cache[i];
+		tables->cache_count[i] = cpuinfo_cache_count[i];
 	}
-	return &cpuinfo_processors[index];
+	#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+		if (tables->uarchs == NULL) {
+			tables->uarchs = &tables->global_uarch;
+			tables->uarchs_count = 1;
+			tables->uarch_tlbs = &tables->global_uarch_tlbs;
+		}
+	#endif
+	cpuinfo_detect_tsc(tables);
+	cpuinfo_detect_hypervisor(tables);
+	cpuinfo_detect_resource_control(tables);
+	cpuinfo_detect_xsave_state(tables);
+	cpuinfo_detect_isa_features(tables);
+	cpuinfo_detect_prefetchers(tables);
+	cpuinfo_detect_code_cache_maintenance(tables);
+	if (!build_llc_domains(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_numa_nodes(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_frequency_domains(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_usable_processors(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_performance_ranking(tables)) {
+		goto cleanup;
+	}
+	if (!build_location_map(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_affinities(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_processor_lists(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_processor_columns(tables)) {
+		goto cleanup;
+	}
+	if (!cpuinfo_build_huge_pages(tables)) {
+		goto cleanup;
+	}
+
+	/* Ownership of the memory passes to the published tables */
+	cpuinfo_arena_memory = NULL;
+	cpuinfo_snapshot_mapping = NULL;
+	cpuinfo_snapshot_mapping_size = 0;
+	cpuinfo_memory_performance = NULL;
+	cpuinfo_core_latencies = NULL;
+
+	tables->topology_snapshot = (struct cpuinfo_topology_snapshot) {
+		.generation = tables->generation,
+		.processors = tables->processors,
+		.cores = tables->cores,
+		.clusters = tables->clusters,
+		.packages = tables->packages,
+		.processors_count = tables->processors_count,
+		.cores_count = tables->cores_count,
+		.clusters_count = tables->clusters_count,
+		.packages_count = tables->packages_count,
+	};
+
+	tables->hot.tables = (struct cpuinfo_hot_tables) {
+		.processors = tables->processors,
+		.cores = tables->cores,
+		.clusters = tables->clusters,
+		.packages = tables->packages,
+		.uarchs = tables->uarchs,
+		.processors_count = tables->processors_count,
+		.cores_count = tables->cores_count,
+		.clusters_count = tables->clusters_count,
+		.packages_count = tables->packages_count,
+		.uarchs_count = tables->uarchs_count,
+	};
+
+	/* Contents of the tables must be visible to other threads before the pointer to them */
+	tables_generation = tables->generation;
+	cpuinfo_store_tables(tables);
+	cpuinfo_publish_epoch(tables->generation);
+	if (cpuinfo_reclaim_retired_tables) {
+		reclaim_retired_tables(tables);
+	}
+	return true;
+
+cleanup:
+	/* Members are NULL until their step allocates them */
+	cpuinfo_arena_free(tables->processor_columns);
+	cpuinfo_arena_free(tables->processor_list_memory);
+	cpuinfo_arena_free(tables->affinity_memory);
+	cpuinfo_arena_free(tables->current_location_map);
+	cpuinfo_arena_free(tables->performance_processor_indices);
+	cpuinfo_arena_free(tables->usable_processor_indices);
+	cpuinfo_arena_free(tables->frequency_memory);
+	cpuinfo_arena_free(tables->numa_memory);
+	cpuinfo_arena_free(tables->llc_domain_memory);
+	cpuinfo_arena_free(tables);
+	return false;
 }
 
-const struct cpuinfo_core* cpuinfo_get_core(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "core");
+void cpuinfo_release_tables(void) {
+	struct cpuinfo_tables* tables = cpuinfo_tables;
+	cpuinfo_store_tables(NULL);
+	while (tables != NULL) {
+		struct cpuinfo_tables* retired = tables->retired;
+		release_tables(tables);
+		tables = retired;
+	}
+
+	/* Memory of tables which were never published */
+	cpuinfo_arena_free(cpuinfo_arena_memory);
+	cpuinfo_arena_memory = NULL;
+	cpuinfo_unmap_snapshot(cpuinfo_snapshot_mapping, cpuinfo_snapshot_mapping_size);
+	cpuinfo_snapshot_mapping = NULL;
+	cpuinfo_snapshot_mapping_size = 0;
+	cpuinfo_memory_performance = NULL;
+	cpuinfo_core_latencies = NULL;
+
+	cpuinfo_is_initialized = false;
+	cpuinfo_isa_is_initialized = false;
+	cpuinfo_processors = NULL;
+	cpuinfo_cores = NULL;
+	cpuinfo_clusters = NULL;
+	cpuinfo_packages = NULL;
+	for (uint32_t i = 0; i < cpuinfo_cache_level_max; i++) {
+		cpuinfo_cache[i] = NULL;
+		cpuinfo_cache_count[i] = 0;
+	}
+	cpuinfo_processors_count = 0;
+	cpuinfo_cores_count = 0;
+	cpuinfo_clusters_count = 0;
+	cpuinfo_packages_count = 0;
+	cpuinfo_max_cache_size = 0;
+	cpuinfo_integrated_gpu = (struct cpuinfo_integrated_gpu) { cpuinfo_gpu_family_unknown };
+	cpuinfo_npu = (struct cpuinfo_npu) { cpuinfo_npu_family_unknown };
+	cpuinfo_uarchs = NULL;
+	cpuinfo_uarchs_count = 0;
+	cpuinfo_uarch_tlbs = NULL;
+	#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+		cpuinfo_global_uarch = (struct cpuinfo_uarch_info) { cpuinfo_uarch_unknown };
+		cpuinfo_global_uarch_tlbs = (struct cpuinfo_uarch_tlbs) { { { 0 } } };
+	#endif
+	#ifdef __linux__
+		cpuinfo_linux_cpu_max = 0;
+		cpuinfo_linux_current_cpu_method = cpuinfo_linux_current_cpu_method_syscall;
+		cpuinfo_linux_cpu_to_processor_map = NULL;
+		cpuinfo_linux_cpu_to_core_map = NULL;
+		cpuinfo_linux_cpu_to_uarch_index_map = NULL;
+	#endif
+}
+
+static inline const struct cpuinfo_tables* get_tables(const char* getter_name) {
+	const struct cpuinfo_tables* tables = cpuinfo_load_tables();
+	if CPUINFO_UNLIKELY(tables == NULL) {
+		if (cpuinfo_initialize_deferred()) {
+			tables = cpuinfo_load_tables();
+		}
+		if (tables == NULL) {
+			cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", getter_name);
+		}
 	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_cores_count) {
+	return tables;
+}
+
+const struct cpuinfo_llc_domain* CPUINFO_ABI cpuinfo_get_llc_domains(void) {
+	const struct cpuinfo_tables* tables = get_tables("llc_domains");
+	return tables->llc_domains;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_llc_domains_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("llc_domains_count");
+	return tables->llc_domains_count;
+}
+
+const struct cpuinfo_llc_domain* CPUINFO_ABI cpuinfo_get_llc_domain(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("llc_domain");
+	if CPUINFO_UNLIKELY(index >= tables->llc_domains_count) {
 		return NULL;
 	}
-	return &cpuinfo_cores[index];
+	return &tables->llc_domains[index];
 }
 
-const struct cpuinfo_cluster* cpuinfo_get_cluster(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "cluster");
+const struct cpuinfo_cache_cluster* CPUINFO_ABI cpuinfo_get_cache_clusters(void) {
+	const struct cpuinfo_tables* tables = get_tables("cache_clusters");
+	return tables->cache_clusters;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_cache_clusters_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("cache_clusters_count");
+	return tables->cache_clusters_count;
+}
+
+const struct cpuinfo_cache_cluster* CPUINFO_ABI cpuinfo_get_cache_cluster(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("cache_cluster");
+	if CPUINFO_UNLIKELY(index >= tables->cache_clusters_count) {
+		return NULL;
 	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_clusters_count) {
+	return &tables->cache_clusters[index];
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_usable_processors_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("usable_processors_count");
+	return tables->usable_processors_count;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_effective_parallelism(void) {
+	const struct cpuinfo_tables* tables = get_tables("effective_parallelism");
+	return tables->effective_parallelism;
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_usable_processor_indices(void) {
+	const struct cpuinfo_tables* tables = get_tables("usable_processor_indices");
+	return tables->usable_processor_indices;
+}
+
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_usable_processor(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("usable_processor");
+	if CPUINFO_UNLIKELY(index >= tables->usable_processors_count) {
 		return NULL;
 	}
-	return &cpuinfo_clusters[index];
+	return &tables->processors[tables->usable_processor_indices[index]];
 }
 
-const struct cpuinfo_package* cpuinfo_get_package(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "package");
+enum cpuinfo_smt_control CPUINFO_ABI cpuinfo_get_smt_control(void) {
+	const struct cpuinfo_tables* tables = get_tables("smt_control");
+	return tables->smt_control;
+}
+
+bool CPUINFO_ABI cpuinfo_is_smt_active(void) {
+	const struct cpuinfo_tables* tables = get_tables("smt_active");
+	return tables->smt_active;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_isolated_processors_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("isolated_processors_count");
+	return tables->isolated_processors_count;
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_isolated_processor_indices(void) {
+	const struct cpuinfo_tables* tables = get_tables("isolated_processor_indices");
+	return tables->isolated_processor_indices;
+}
+
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_isolated_processor(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("isolated_processor");
+	if CPUINFO_UNLIKELY(index >= tables->isolated_processors_count) {
+		return NULL;
 	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_packages_count) {
+	return &tables->processors[tables->isolated_processor_indices[index]];
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_core_primary_processor_indices(void) {
+	const struct cpuinfo_tables* tables = get_tables("core_primary_processor_indices");
+	return tables->core_primary_processor_indices;
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_uarch_processor_indices(uint32_t index, uint32_t* count) {
+	const struct cpuinfo_tables* tables = get_tables("uarch_processor_indices");
+	if CPUINFO_UNLIKELY(index >= tables->uarchs_count || tables->uarch_processor_offsets == NULL) {
+		*count = 0;
 		return NULL;
 	}
-	return &cpuinfo_packages[index];
+	const uint32_t start = tables->uarch_processor_offsets[index];
+	*count = tables->uarch_processor_offsets[index + 1] - start;
+	return &tables->uarch_processor_indices[start];
 }
 
-const struct cpuinfo_uarch_info* cpuinfo_get_uarch(uint32_t index) {
-	if (!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "uarch");
+const uint32_t* CPUINFO_ABI cpuinfo_get_cluster_processor_indices(uint32_t index, uint32_t* count) {
+	const struct cpuinfo_tables* tables = get_tables("cluster_processor_indices");
+	if CPUINFO_UNLIKELY(index >= tables->clusters_count || tables->cluster_processor_indices == NULL) {
+		*count = 0;
+		return NULL;
 	}
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		if CPUINFO_UNLIKELY(index >= cpuinfo_uarchs_count) {
-			return NULL;
+	*count = tables->clusters[index].processor_count;
+	return &tables->cluster_processor_indices[tables->clusters[index].processor_start];
+}
+
+enum cpuinfo_distance_level CPUINFO_ABI cpuinfo_get_processor_distance(uint32_t processor_index,
+	uint32_t other_processor_index, uint32_t* numa_distance)
+{
+	const struct cpuinfo_tables* tables = get_tables("processor_distance");
+	if CPUINFO_UNLIKELY(processor_index >= tables->processors_count ||
+		other_processor_index >= tables->processors_count || tables->processor_domains == NULL)
+	{
+		if (numa_distance != NULL) {
+			*numa_distance = 0;
 		}
-		return &cpuinfo_uarchs[index];
-	#else
-		if CPUINFO_UNLIKELY(index != 0) {
-			return NULL;
+		return cpuinfo_distance_level_max;
+	}
+	const struct cpuinfo_processor_domains* domains = &tables->processor_domains[processor_index];
+	const struct cpuinfo_processor_domains* other_domains = &tables->processor_domains[other_processor_index];
+	if (numa_distance != NULL) {
+		*numa_distance =
+			tables->numa_distances[(size_t) domains->numa_node * tables->numa_nodes_count + other_domains->numa_node];
+	}
+	if (processor_index == other_processor_index) {
+		return cpuinfo_distance_level_processor;
+	}
+	return cpuinfo_get_domains_distance_level(domains, other_domains);
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_steal_order(uint32_t processor_index, uint32_t* count) {
+	const struct cpuinfo_tables* tables = get_tables("steal_order");
+	if CPUINFO_UNLIKELY(processor_index >= tables->processors_count || tables->steal_orders == NULL) {
+		*count = 0;
+		return NULL;
+	}
+	const uint32_t usable_count = tables->usable_processors_count;
+	/* Usable processors are not their own victims, and rows of other processors hold all usable processors */
+	*count = usable_count - (uint32_t) (tables->processors[processor_index].usable ? 1 : 0);
+	if (*count == 0) {
+		return NULL;
+	}
+	return &tables->steal_orders[(size_t) processor_index * usable_count];
+}
+
+const uint16_t* CPUINFO_ABI cpuinfo_get_processor_column(enum cpuinfo_processor_column column) {
+	const struct cpuinfo_tables* tables = get_tables("processor_column");
+	if CPUINFO_UNLIKELY((uint32_t) column >= cpuinfo_processor_column_max || tables->processor_columns == NULL) {
+		return NULL;
+	}
+	return &tables->processor_columns[(size_t) column * tables->processors_count];
+}
+
+const void* CPUINFO_ABI cpuinfo_get_processor_columns(uint32_t* size) {
+	const struct cpuinfo_tables* tables = get_tables("processor_columns");
+	*size = tables->processor_columns != NULL ?
+		(uint32_t) (cpuinfo_processor_column_max * tables->processors_count * sizeof(uint16_t)) : 0;
+	return tables->processor_columns;
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_usable_processor_indices_by_performance(void) {
+	const struct cpuinfo_tables* tables = get_tables("usable_processor_indices_by_performance");
+	return tables->performance_processor_indices;
+}
+
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_usable_processor_by_performance(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("usable_processor_by_performance");
+	if CPUINFO_UNLIKELY(index >= tables->usable_processors_count) {
+		return NULL;
+	}
+	return &tables->processors[tables->performance_processor_indices[index]];
+}
+
+const struct cpuinfo_numa_node* CPUINFO_ABI cpuinfo_get_numa_nodes(void) {
+	const struct cpuinfo_tables* tables = get_tables("numa_nodes");
+	return tables->numa_nodes;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_numa_nodes_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("numa_nodes_count");
+	return tables->numa_nodes_count;
+}
+
+const struct cpuinfo_numa_node* CPUINFO_ABI cpuinfo_get_numa_node(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("numa_node");
+	if CPUINFO_UNLIKELY(index >= tables->numa_nodes_count) {
+		return NULL;
+	}
+	return &tables->numa_nodes[index];
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_numa_distances(void) {
+	const struct cpuinfo_tables* tables = get_tables("numa_distances");
+	return tables->numa_distances;
+}
+
+const struct cpuinfo_memory_side_cache* CPUINFO_ABI cpuinfo_get_memory_side_caches(void) {
+	const struct cpuinfo_tables* tables = get_tables("memory_side_caches");
+	return tables->memory_side_caches;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_memory_side_caches_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("memory_side_caches_count");
+	return tables->memory_side_caches_count;
+}
+
+const struct cpuinfo_memory_side_cache* CPUINFO_ABI cpuinfo_get_memory_side_cache(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("memory_side_cache");
+	if CPUINFO_UNLIKELY(index >= tables->memory_side_caches_count) {
+		return NULL;
+	}
+	return &tables->memory_side_caches[index];
+}
+
+const struct cpuinfo_frequency_domain* CPUINFO_ABI cpuinfo_get_frequency_domains(void) {
+	const struct cpuinfo_tables* tables = get_tables("frequency_domains");
+	return tables->frequency_domains;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_frequency_domains_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("frequency_domains_count");
+	return tables->frequency_domains_count;
+}
+
+const struct cpuinfo_frequency_domain* CPUINFO_ABI cpuinfo_get_frequency_domain(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("frequency_domain");
+	if CPUINFO_UNLIKELY(index >= tables->frequency_domains_count) {
+		return NULL;
+	}
+	return &tables->frequency_domains[index];
+}
+
+const struct cpuinfo_uncore_domain* CPUINFO_ABI cpuinfo_get_uncore_domains(void) {
+	const struct cpuinfo_tables* tables = get_tables("uncore_domains");
+	return tables->uncore_domains;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_uncore_domains_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("uncore_domains_count");
+	return tables->uncore_domains_count;
+}
+
+const struct cpuinfo_uncore_domain* CPUINFO_ABI cpuinfo_get_uncore_domain(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("uncore_domain");
+	if CPUINFO_UNLIKELY(index >= tables->uncore_domains_count) {
+		return NULL;
+	}
+	return &tables->uncore_domains[index];
+}
+
+const struct cpuinfo_uncore_domain* CPUINFO_ABI cpuinfo_get_package_uncore_domains(
+	const struct cpuinfo_package* package, uint32_t* count)
+{
+	const struct cpuinfo_tables* tables = get_tables("package_uncore_domains");
+	uint32_t index;
+	if (count != NULL) {
+		*count = 0;
+	}
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(package, tables->packages, tables->packages_count,
+			sizeof(struct cpuinfo_package), &index))
+	{
+		return NULL;
+	}
+	/* Uncore domains are sorted by package */
+	const struct cpuinfo_uncore_domain* first_domain = NULL;
+	uint32_t domains_count = 0;
+	for (uint32_t i = 0; i < tables->uncore_domains_count; i++) {
+		if (tables->uncore_domains[i].package == package) {
+			if (first_domain == NULL) {
+				first_domain = &tables->uncore_domains[i];
+			}
+			domains_count += 1;
 		}
-		return &cpuinfo_global_uarch;
-	#endif
+	}
+	if (count != NULL) {
+		*count = domains_count;
+	}
+	return first_domain;
 }
 
-uint32_t cpuinfo_get_processors_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "processors_count");
+const struct cpuinfo_tables* cpuinfo_get_tables(const char* getter_name) {
+	return get_tables(getter_name);
+}
+
+const struct cpuinfo_processor* cpuinfo_get_processors(void) {
+	const struct cpuinfo_tables* tables = get_tables("processors");
+	return tables->processors;
+}
+
+const struct cpuinfo_core* cpuinfo_get_cores(void) {
+	const struct cpuinfo_tables* tables = get_tables("core");
+	return tables->cores;
+}
+
+const struct cpuinfo_cluster* cpuinfo_get_clusters(void) {
+	const struct cpuinfo_tables* tables = get_tables("clusters");
+	return tables->clusters;
+}
+
+const struct cpuinfo_package* cpuinfo_get_packages(void) {
+	const struct cpuinfo_tables* tables = get_tables("packages");
+	return tables->packages;
+}
+
+const struct cpuinfo_uarch_info* cpuinfo_get_uarchs() {
+	const struct cpuinfo_tables* tables = get_tables("uarchs");
+	return tables->uarchs;
+}
+
+const struct cpuinfo_processor* cpuinfo_get_processor(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("processor");
+	if CPUINFO_UNLIKELY(index >= tables->processors_count) {
+		return NULL;
 	}
-	return cpuinfo_processors_count;
+	return &tables->processors[index];
 }
 
-uint32_t cpuinfo_get_cores_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "cores_count");
+const struct cpuinfo_core* cpuinfo_get_core(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("core");
+	if CPUINFO_UNLIKELY(index >= tables->cores_count) {
+		return NULL;
 	}
-	return cpuinfo_cores_count;
+	return &tables->cores[index];
 }
 
-uint32_t cpuinfo_get_clusters_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "clusters_count");
+const struct cpuinfo_cluster* cpuinfo_get_cluster(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("cluster");
+	if CPUINFO_UNLIKELY(index >= tables->clusters_count) {
+		return NULL;
 	}
-	return cpuinfo_clusters_count;
+	return &tables->clusters[index];
 }
 
-uint32_t cpuinfo_get_packages_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "packages_count");
+const struct cpuinfo_package* cpuinfo_get_package(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("package");
+	if CPUINFO_UNLIKELY(index >= tables->packages_count) {
+		return NULL;
 	}
-	return cpuinfo_packages_count;
+	return &tables->packages[index];
 }
 
-uint32_t cpuinfo_get_uarchs_count(void) {
-	if (!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "uarchs_count");
+const struct cpuinfo_uarch_info* cpuinfo_get_uarch(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("uarch");
+	if CPUINFO_UNLIKELY(index >= tables->uarchs_count) {
+		return NULL;
 	}
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		return cpuinfo_uarchs_count;
-	#else
-		return 1;
-	#endif
+	return &tables->uarchs[index];
+}
+
+uint32_t cpuinfo_get_processors_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("processors_count");
+	return tables->processors_count;
+}
+
+uint32_t cpuinfo_get_cores_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("cores_count");
+	return tables->cores_count;
+}
+
+uint32_t cpuinfo_get_clusters_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("clusters_count");
+	return tables->clusters_count;
+}
+
+uint32_t cpuinfo_get_packages_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("packages_count");
+	return tables->packages_count;
+}
+
+uint32_t cpuinfo_get_uarchs_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("uarchs_count");
+	return tables->uarchs_count;
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1i_caches(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l1i_caches");
-	}
-	return cpuinfo_cache[cpuinfo_cache_level_1i];
+	const struct cpuinfo_tables* tables = get_tables("l1i_caches");
+	return tables->cache[cpuinfo_cache_level_1i];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1d_caches(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l1d_caches");
-	}
-	return cpuinfo_cache[cpuinfo_cache_level_1d];
+	const struct cpuinfo_tables* tables = get_tables("l1d_caches");
+	return tables->cache[cpuinfo_cache_level_1d];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l2_caches(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l2_caches");
-	}
-	return cpuinfo_cache[cpuinfo_cache_level_2];
+	const struct cpuinfo_tables* tables = get_tables("l2_caches");
+	return tables->cache[cpuinfo_cache_level_2];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l3_caches(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l3_caches");
-	}
-	return cpuinfo_cache[cpuinfo_cache_level_3];
+	const struct cpuinfo_tables* tables = get_tables("l3_caches");
+	return tables->cache[cpuinfo_cache_level_3];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l4_caches(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l4_caches");
-	}
-	return cpuinfo_cache[cpuinfo_cache_level_4];
+	const struct cpuinfo_tables* tables = get_tables("l4_caches");
+	return tables->cache[cpuinfo_cache_level_4];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1i_cache(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l1i_cache");
-	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_cache_count[cpuinfo_cache_level_1i]) {
+	const struct cpuinfo_tables* tables = get_tables("l1i_cache");
+	if CPUINFO_UNLIKELY(index >= tables->cache_count[cpuinfo_cache_level_1i]) {
 		return NULL;
 	}
-	return &cpuinfo_cache[cpuinfo_cache_level_1i][index];
+	return &tables->cache[cpuinfo_cache_level_1i][index];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l1d_cache(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l1d_cache");
-	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_cache_count[cpuinfo_cache_level_1d]) {
+	const struct cpuinfo_tables* tables = get_tables("l1d_cache");
+	if CPUINFO_UNLIKELY(index >= tables->cache_count[cpuinfo_cache_level_1d]) {
 		return NULL;
 	}
-	return &cpuinfo_cache[cpuinfo_cache_level_1d][index];
+	return &tables->cache[cpuinfo_cache_level_1d][index];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l2_cache(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l2_cache");
-	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_cache_count[cpuinfo_cache_level_2]) {
+	const struct cpuinfo_tables* tables = get_tables("l2_cache");
+	if CPUINFO_UNLIKELY(index >= tables->cache_count[cpuinfo_cache_level_2]) {
 		return NULL;
 	}
-	return &cpuinfo_cache[cpuinfo_cache_level_2][index];
+	return &tables->cache[cpuinfo_cache_level_2][index];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l3_cache(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l3_cache");
-	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_cache_count[cpuinfo_cache_level_3]) {
+	const struct cpuinfo_tables* tables = get_tables("l3_cache");
+	if CPUINFO_UNLIKELY(index >= tables->cache_count[cpuinfo_cache_level_3]) {
 		return NULL;
 	}
-	return &cpuinfo_cache[cpuinfo_cache_level_3][index];
+	return &tables->cache[cpuinfo_cache_level_3][index];
 }
 
 const struct cpuinfo_cache* CPUINFO_ABI cpuinfo_get_l4_cache(uint32_t index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l4_cache");
-	}
-	if CPUINFO_UNLIKELY(index >= cpuinfo_cache_count[cpuinfo_cache_level_4]) {
+	const struct cpuinfo_tables* tables = get_tables("l4_cache");
+	if CPUINFO_UNLIKELY(index >= tables->cache_count[cpuinfo_cache_level_4]) {
 		return NULL;
 	}
-	return &cpuinfo_cache[cpuinfo_cache_level_4][index];
+	return &tables->cache[cpuinfo_cache_level_4][index];
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_l1i_caches_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l1i_caches_count");
-	}
-	return cpuinfo_cache_count[cpuinfo_cache_level_1i];
+	const struct cpuinfo_tables* tables = get_tables("l1i_caches_count");
+	return tables->cache_count[cpuinfo_cache_level_1i];
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_l1d_caches_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l1d_caches_count");
-	}
-	return cpuinfo_cache_count[cpuinfo_cache_level_1d];
+	const struct cpuinfo_tables* tables = get_tables("l1d_caches_count");
+	return tables->cache_count[cpuinfo_cache_level_1d];
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_l2_caches_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l2_caches_count");
-	}
-	return cpuinfo_cache_count[cpuinfo_cache_level_2];
+	const struct cpuinfo_tables* tables = get_tables("l2_caches_count");
+	return tables->cache_count[cpuinfo_cache_level_2];
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_l3_caches_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l3_caches_count");
-	}
-	return cpuinfo_cache_count[cpuinfo_cache_level_3];
+	const struct cpuinfo_tables* tables = get_tables("l3_caches_count");
+	return tables->cache_count[cpuinfo_cache_level_3];
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_l4_caches_count(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "l4_caches_count");
+	const struct cpuinfo_tables* tables = get_tables("l4_caches_count");
+	return tables->cache_count[cpuinfo_cache_level_4];
+}
+
+uint64_t CPUINFO_ABI cpuinfo_get_topology_generation(void) {
+	const struct cpuinfo_tables* tables = get_tables("topology_generation");
+	return tables->generation;
+}
+
+enum cpuinfo_hypervisor CPUINFO_ABI cpuinfo_get_hypervisor(void) {
+	const struct cpuinfo_tables* tables = get_tables("hypervisor");
+	return tables->hypervisor;
+}
+
+bool CPUINFO_ABI cpuinfo_is_topology_synthetic(void) {
+	const struct cpuinfo_tables* tables = get_tables("topology_synthetic");
+	return tables->topology_synthetic;
+}
+
+const struct cpuinfo_resource_control* CPUINFO_ABI cpuinfo_get_resource_control(void) {
+	const struct cpuinfo_tables* tables = get_tables("resource_control");
+	return &tables->resource_control;
+}
+
+const struct cpuinfo_cache_allocation* CPUINFO_ABI cpuinfo_get_cache_allocation(const struct cpuinfo_cache* cache) {
+	const struct cpuinfo_tables* tables = get_tables("cache_allocation");
+	const struct cpuinfo_cache* l2 = tables->cache[cpuinfo_cache_level_2];
+	const struct cpuinfo_cache* l3 = tables->cache[cpuinfo_cache_level_3];
+	const struct cpuinfo_cache_allocation* allocation = NULL;
+	if (cache != NULL && l2 != NULL && cache >= l2 && cache < l2 + tables->cache_count[cpuinfo_cache_level_2]) {
+		allocation = &tables->resource_control.l2_allocation;
+	} else if (cache != NULL && l3 != NULL && cache >= l3 && cache < l3 + tables->cache_count[cpuinfo_cache_level_3]) {
+		allocation = &tables->resource_control.l3_allocation;
 	}
-	return cpuinfo_cache_count[cpuinfo_cache_level_4];
+	return allocation != NULL && allocation->classes_count != 0 ? allocation : NULL;
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_max_cache_size(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "max_cache_size");
+	const struct cpuinfo_tables* tables = get_tables("max_cache_size");
+	return tables->max_cache_size;
+}
+
+const struct cpuinfo_integrated_gpu* CPUINFO_ABI cpuinfo_get_integrated_gpu(void) {
+	const struct cpuinfo_tables* tables = get_tables("integrated_gpu");
+	if (tables->integrated_gpu.family == cpuinfo_gpu_family_unknown) {
+		return NULL;
 	}
-	return cpuinfo_max_cache_size;
+	return &tables->integrated_gpu;
 }
 
-const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_current_processor(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "current_processor");
+const struct cpuinfo_npu* CPUINFO_ABI cpuinfo_get_npu(void) {
+	const struct cpuinfo_tables* tables = get_tables("npu");
+	if (tables->npu.family == cpuinfo_npu_family_unknown) {
+		return NULL;
+	}
+	return &tables->npu;
+}
+
+void CPUINFO_ABI cpuinfo_get_memory_usage(struct cpuinfo_memory_usage* usage) {
+	const struct cpuinfo_tables* tables = get_tables("memory_usage");
+	*usage = (struct cpuinfo_memory_usage) {
+		.processors = (size_t) tables->processors_count * sizeof(struct cpuinfo_processor),
+		.cores = (size_t) tables->cores_count * sizeof(struct cpuinfo_core),
+		.clusters = (size_t) tables->clusters_count * sizeof(struct cpuinfo_cluster),
+		.packages = (size_t) tables->packages_count * sizeof(struct cpuinfo_package),
+		.transient = cpuinfo_arena_get_transient_size(),
+	};
+	for (uint32_t i = 0; i < cpuinfo_cache_level_max; i++) {
+		usage->caches += (size_t) tables->cache_count[i] * sizeof(struct cpuinfo_cache);
+	}
+	#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+		const bool inline_uarch = tables->uarchs == &tables->global_uarch;
+	#else
+		const bool inline_uarch = false;
+	#endif
+	if (!inline_uarch) {
+		usage->uarchs = (size_t) tables->uarchs_count * sizeof(struct cpuinfo_uarch_info);
+		if (tables->uarch_tlbs != NULL) {
+			usage->uarchs += (size_t) tables->uarchs_count * sizeof(struct cpuinfo_uarch_tlbs);
+		}
 	}
 	#ifdef __linux__
-		/* Initializing this variable silences a MemorySanitizer error. */
-		unsigned cpu = 0;
-		if CPUINFO_UNLIKELY(syscall(__NR_getcpu, &cpu, NULL, NULL) != 0) {
-			return 0;
+		if (tables->linux_cpu_to_processor_map != NULL) {
+			usage->linux_cpu_maps += (size_t) tables->linux_cpu_max * sizeof(const struct cpuinfo_processor*);
 		}
-		if CPUINFO_UNLIKELY((uint32_t) cpu >= cpuinfo_linux_cpu_max) {
-			return 0;
+		if (tables->linux_cpu_to_core_map != NULL) {
+			usage->linux_cpu_maps += (size_t) tables->linux_cpu_max * sizeof(const struct cpuinfo_core*);
+		}
+		if (tables->linux_cpu_to_uarch_index_map != NULL) {
+			usage->linux_cpu_maps += (size_t) tables->linux_cpu_max * sizeof(uint32_t);
 		}
-		return cpuinfo_linux_cpu_to_processor_map[cpu];
-	#else
-		return NULL;
 	#endif
+	if (tables->processor_columns != NULL) {
+		usage->processor_columns =
+			(size_t) cpuinfo_processor_column_max * tables->processors_count * sizeof(uint16_t);
+	}
+	usage->total = usage->processors + usage->cores + usage->clusters + usage->packages + usage->caches +
+		usage->uarchs + usage->linux_cpu_maps + usage->processor_columns;
 }
 
-const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_current_core(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "current_core");
+uint64_t CPUINFO_ABI cpuinfo_get_tsc_frequency(void) {
+	const struct cpuinfo_tables* tables = get_tables("tsc_frequency");
+	return tables->tsc_frequency;
+}
+
+bool CPUINFO_ABI cpuinfo_has_invariant_tsc(void) {
+	const struct cpuinfo_tables* tables = get_tables("has_invariant_tsc");
+	return tables->tsc_invariant;
+}
+
+#ifdef __linux__
+/* Get the Linux processor number the calling thread runs on, using the cheapest method validated at initialization */
+static inline bool get_current_cpu(const struct cpuinfo_tables* tables, unsigned cpu[restrict static 1]) {
+	if (tables->linux_current_cpu_method == cpuinfo_linux_current_cpu_method_rseq) {
+		const int32_t cpu_id = cpuinfo_linux_read_rseq_cpu_id();
+		if CPUINFO_LIKELY(cpu_id >= 0) {
+			*cpu = (unsigned) cpu_id;
+			return true;
+		}
+		/* rseq registration may fail for individual threads */
 	}
-	#ifdef __linux__
+	#if (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && !CPUINFO_MOCK
+		switch (tables->linux_current_cpu_method) {
+			case cpuinfo_linux_current_cpu_method_rdpid:
+				*cpu = cpuinfo_x86_linux_read_tsc_aux_rdpid() & CPUINFO_X86_LINUX_TSC_AUX_CPU_MASK;
+				return true;
+			case cpuinfo_linux_current_cpu_method_rdtscp:
+				*cpu = cpuinfo_x86_linux_read_tsc_aux_rdtscp() & CPUINFO_X86_LINUX_TSC_AUX_CPU_MASK;
+				return true;
+			default:
+				break;
+		}
+	#endif
+	if (cpuinfo_linux_vdso_getcpu != NULL) {
+		return cpuinfo_linux_vdso_getcpu(cpu, NULL, NULL) == 0;
+	}
+	return syscall(__NR_getcpu, cpu, NULL, NULL) == 0;
+}
+#endif
+
+#if defined(__MACH__) && defined(__APPLE__)
+/* Get the XNU CPU number the calling thread runs on */
+static inline bool get_mach_cpu_number(uint32_t cpu_number[restrict static 1]) {
+	#if defined(__MAC_11_0) || defined(__IPHONE_14_2)
+		if (__builtin_available(macOS 11.0, iOS 14.2, tvOS 14.2, watchOS 7.1, *)) {
+			size_t pthread_cpu_number = 0;
+			if CPUINFO_UNLIKELY(pthread_cpu_number_np(&pthread_cpu_number) != 0) {
+				return false;
+			}
+			*cpu_number = (uint32_t) pthread_cpu_number;
+			return true;
+		}
+	#endif
+	#if CPUINFO_ARCH_ARM64
+		uint64_t tpidrro_el0;
+		__asm__ ("mrs %0, tpidrro_el0" : "=r" (tpidrro_el0));
+		*cpu_number = (uint32_t) (tpidrro_el0 & CPUINFO_MACH_TPIDRRO_EL0_CPU_MASK);
+		return true;
+	#else
+		return false;
+	#endif
+}
+#endif
+
+/* Read the processor number of the operating system for the logical processor the calling thread runs on */
+static inline bool get_current_location_index(const struct cpuinfo_tables* tables,
+	uint32_t location_index[restrict static 1])
+{
+	#if defined(__linux__)
 		/* Initializing this variable silences a MemorySanitizer error. */
 		unsigned cpu = 0;
-		if CPUINFO_UNLIKELY(syscall(__NR_getcpu, &cpu, NULL, NULL) != 0) {
-			return 0;
+		if CPUINFO_UNLIKELY(!get_current_cpu(tables, &cpu)) {
+			return false;
 		}
-		if CPUINFO_UNLIKELY((uint32_t) cpu >= cpuinfo_linux_cpu_max) {
-			return 0;
+		*location_index = (uint32_t) cpu;
+		return true;
+	#elif defined(_WIN32) || defined(__CYGWIN__)
+		(void) tables;
+		PROCESSOR_NUMBER processor_number;
+		GetCurrentProcessorNumberEx(&processor_number);
+		*location_index = (uint32_t) processor_number.Group * CPUINFO_WINDOWS_GROUP_SIZE + processor_number.Number;
+		return true;
+	#elif defined(__MACH__) && defined(__APPLE__)
+		(void) tables;
+		return get_mach_cpu_number(location_index);
+	#elif defined(__FreeBSD__)
+		(void) tables;
+		/* FreeBSD numbers processors in the order of kern.sched.topology_spec, as cpuinfo does */
+		const int cpu = sched_getcpu();
+		if CPUINFO_UNLIKELY(cpu < 0) {
+			return false;
 		}
-		return cpuinfo_linux_cpu_to_core_map[cpu];
+		*location_index = (uint32_t) cpu;
+		return true;
 	#else
-		return NULL;
+		(void) tables;
+		(void) location_index;
+		return false;
 	#endif
 }
 
-uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index(void) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "current_uarch_index");
-	}
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		#ifdef __linux__
-			if (cpuinfo_linux_cpu_to_uarch_index_map == NULL) {
-				/* Special case: avoid syscall on systems with only a single type of cores */
-				return 0;
-			}
+/* Identify the location of the logical processor the calling thread runs on, or return NULL if not supported */
+static inline const struct cpuinfo_location* get_current_location(const struct cpuinfo_tables* tables) {
+	uint32_t location_index = 0;
+	if CPUINFO_UNLIKELY(!get_current_location_index(tables, &location_index)) {
+		return NULL;
+	}
+	if CPUINFO_UNLIKELY(location_index >= tables->current_location_count) {
+		return NULL;
+	}
+	return &tables->current_location_map[location_index].location;
+}
 
-			/* General case */
-			/* Initializing this variable silences a MemorySanitizer error. */
-			unsigned cpu = 0;
-			if CPUINFO_UNLIKELY(syscall(__NR_getcpu, &cpu, NULL, NULL) != 0) {
-				return 0;
-			}
-			if CPUINFO_UNLIKELY((uint32_t) cpu >= cpuinfo_linux_cpu_max) {
-				return 0;
-			}
-			return cpuinfo_linux_cpu_to_uarch_index_map[cpu];
-		#else
-			/* Fallback: pretend to be on the big core. */
-			return 0;
-		#endif
-	#else
-		/* Only ARM/ARM64 processors may include cores of different types in the same package. */
+const struct cpuinfo_processor* CPUINFO_ABI cpuinfo_get_current_processor(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_processor");
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL) {
+		return NULL;
+	}
+	return location->processor;
+}
+
+const struct cpuinfo_core* CPUINFO_ABI cpuinfo_get_current_core(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_core");
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL) {
+		return NULL;
+	}
+	return location->core;
+}
+
+static inline uint32_t get_current_uarch_index(const struct cpuinfo_tables* tables, uint32_t default_uarch_index) {
+	if (tables->uarchs_count <= 1) {
+		/* Special case: avoid identifying the processor on systems with only a single type of cores */
 		return 0;
-	#endif
+	}
+
+	/* General case */
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL || location->processor == NULL) {
+		return default_uarch_index;
+	}
+	return location->uarch_index;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_uarch_index");
+	return get_current_uarch_index(tables, 0);
 }
 
 uint32_t CPUINFO_ABI cpuinfo_get_current_uarch_index_with_default(uint32_t default_uarch_index) {
-	if CPUINFO_UNLIKELY(!cpuinfo_is_initialized) {
-		cpuinfo_log_fatal("cpuinfo_get_%s called before cpuinfo is initialized", "current_uarch_index_with_default");
-	}
-	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-		#ifdef __linux__
-			if (cpuinfo_linux_cpu_to_uarch_index_map == NULL) {
-				/* Special case: avoid syscall on systems with only a single type of cores */
-				return 0;
-			}
+	const struct cpuinfo_tables* tables = get_tables("current_uarch_index_with_default");
+	return get_current_uarch_index(tables, default_uarch_index);
+}
 
-			/* General case */
-			/* Initializing this variable silences a MemorySanitizer error. */
-			unsigned cpu = 0;
-			if CPUINFO_UNLIKELY(syscall(__NR_getcpu, &cpu, NULL, NULL) != 0) {
-				return default_uarch_index;
-			}
-			if CPUINFO_UNLIKELY((uint32_t) cpu >= cpuinfo_linux_cpu_max) {
-				return default_uarch_index;
-			}
-			return cpuinfo_linux_cpu_to_uarch_index_map[cpu];
-		#else
-			/* Fallback: no API to query current core, use default uarch index. */
-			return default_uarch_index;
-		#endif
-	#else
-		/* Only ARM/ARM64 processors may include cores of different types in the same package. */
+uint32_t CPUINFO_ABI cpuinfo_migration_guard_enter(struct cpuinfo_migration_guard* guard) {
+	const struct cpuinfo_tables* tables = get_tables("migration_guard_enter");
+	*guard = (struct cpuinfo_migration_guard) { .uarch_index = 0, .cpu_number = UINT32_MAX };
+	if (tables->uarchs_count <= 1) {
 		return 0;
-	#endif
+	}
+	uint32_t location_index = UINT32_MAX;
+	if CPUINFO_LIKELY(get_current_location_index(tables, &location_index) &&
+		location_index < tables->current_location_count)
+	{
+		const struct cpuinfo_location* location = &tables->current_location_map[location_index].location;
+		if CPUINFO_LIKELY(location->processor != NULL) {
+			guard->uarch_index = location->uarch_index;
+			guard->cpu_number = location_index;
+		}
+	}
+	return guard->uarch_index;
+}
+
+bool CPUINFO_ABI cpuinfo_migration_guard_check(struct cpuinfo_migration_guard* guard) {
+	const struct cpuinfo_tables* tables = get_tables("migration_guard_check");
+	if (tables->uarchs_count <= 1) {
+		return false;
+	}
+	uint32_t location_index = UINT32_MAX;
+	if CPUINFO_UNLIKELY(!get_current_location_index(tables, &location_index)) {
+		return false;
+	}
+	if CPUINFO_LIKELY(location_index == guard->cpu_number) {
+		/* Fast path: the thread still runs on the processor of the last check */
+		return false;
+	}
+	if CPUINFO_UNLIKELY(location_index >= tables->current_location_count) {
+		return false;
+	}
+	const struct cpuinfo_location* location = &tables->current_location_map[location_index].location;
+	if CPUINFO_UNLIKELY(location->processor == NULL) {
+		return false;
+	}
+	guard->cpu_number = location_index;
+	if (location->uarch_index == guard->uarch_index) {
+		return false;
+	}
+	guard->uarch_index = location->uarch_index;
+	return true;
+}
+
+const struct cpuinfo_llc_domain* CPUINFO_ABI cpuinfo_get_current_llc_domain(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_llc_domain");
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL) {
+		return NULL;
+	}
+	return location->llc_domain;
+}
+
+const struct cpuinfo_numa_node* CPUINFO_ABI cpuinfo_get_current_numa_node(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_numa_node");
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL || location->processor == NULL) {
+		return NULL;
+	}
+	return location->processor->numa_node;
+}
+
+bool CPUINFO_ABI cpuinfo_get_current_location(struct cpuinfo_location* location) {
+	const struct cpuinfo_tables* tables = get_tables("current_location");
+	const struct cpuinfo_location* current_location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(current_location == NULL || current_location->processor == NULL) {
+		*location = (struct cpuinfo_location) { 0 };
+		return false;
+	}
+	*location = *current_location;
+	return true;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_current_slot(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_slot");
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL) {
+		return 0;
+	}
+	return location->slot;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_current_llc_slot(void) {
+	const struct cpuinfo_tables* tables = get_tables("current_llc_slot");
+	const struct cpuinfo_location* location = get_current_location(tables);
+	if CPUINFO_UNLIKELY(location == NULL) {
+		return 0;
+	}
+	return location->llc_slot;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_llc_slots_count(void) {
+	const struct cpuinfo_tables* tables = get_tables("llc_slots_count");
+	return tables->llc_slots_count;
+}
+
+/* Find the index of an object in a table, or return false if the object doesn't belong to the table */
+uint32_t CPUINFO_ABI cpuinfo_get_processor_mask_words(void) {
+	const struct cpuinfo_tables* tables = get_tables("processor_mask_words");
+	return tables->processor_mask_words;
+}
+
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_processor_affinity(const struct cpuinfo_processor* processor) {
+	const struct cpuinfo_tables* tables = get_tables("processor_affinity");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(processor, tables->processors, tables->processors_count,
+			sizeof(struct cpuinfo_processor), &index))
+	{
+		return NULL;
+	}
+	return &tables->processor_affinities[index];
+}
+
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_core_affinity(const struct cpuinfo_core* core) {
+	const struct cpuinfo_tables* tables = get_tables("core_affinity");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(core, tables->cores, tables->cores_count,
+			sizeof(struct cpuinfo_core), &index))
+	{
+		return NULL;
+	}
+	return &tables->core_affinities[index];
+}
+
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_cluster_affinity(const struct cpuinfo_cluster* cluster) {
+	const struct cpuinfo_tables* tables = get_tables("cluster_affinity");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(cluster, tables->clusters, tables->clusters_count,
+			sizeof(struct cpuinfo_cluster), &index))
+	{
+		return NULL;
+	}
+	return &tables->cluster_affinities[index];
+}
+
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_package_affinity(const struct cpuinfo_package* package) {
+	const struct cpuinfo_tables* tables = get_tables("package_affinity");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(package, tables->packages, tables->packages_count,
+			sizeof(struct cpuinfo_package), &index))
+	{
+		return NULL;
+	}
+	return &tables->package_affinities[index];
+}
+
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_uarch_affinity(uint32_t index) {
+	const struct cpuinfo_tables* tables = get_tables("uarch_affinity");
+	if CPUINFO_UNLIKELY(index >= tables->uarchs_count) {
+		return NULL;
+	}
+	return &tables->uarch_affinities[index];
+}
+
+const struct cpuinfo_affinity* CPUINFO_ABI cpuinfo_get_cache_affinity(const struct cpuinfo_cache* cache) {
+	const struct cpuinfo_tables* tables = get_tables("cache_affinity");
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		uint32_t index;
+		if (cpuinfo_get_table_index(cache, tables->cache[level], tables->cache_count[level],
+				sizeof(struct cpuinfo_cache), &index))
+		{
+			return &tables->cache_affinities[level][index];
+		}
+	}
+	return NULL;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_processor_llc_domain_index(const struct cpuinfo_processor* processor) {
+	const struct cpuinfo_tables* tables = get_tables("processor_llc_domain_index");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(processor, tables->processors, tables->processors_count,
+			sizeof(struct cpuinfo_processor), &index))
+	{
+		return UINT32_MAX;
+	}
+	return tables->processor_llc_domain_index[index];
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_processor_cache_cluster_index(const struct cpuinfo_processor* processor) {
+	const struct cpuinfo_tables* tables = get_tables("processor_cache_cluster_index");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(processor, tables->processors, tables->processors_count,
+			sizeof(struct cpuinfo_processor), &index))
+	{
+		return UINT32_MAX;
+	}
+	return tables->processor_cache_cluster_index[index];
+}
+
+bool CPUINFO_ABI cpuinfo_get_core_vector_unit_group(const struct cpuinfo_core* core,
+	uint32_t* core_start, uint32_t* core_count)
+{
+	const struct cpuinfo_tables* tables = get_tables("core_vector_unit_group");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(core_start == NULL || core_count == NULL ||
+		!cpuinfo_get_table_index(core, tables->cores, tables->cores_count, sizeof(struct cpuinfo_core), &index))
+	{
+		return false;
+	}
+	*core_start = index;
+	*core_count = 1;
+	if (core->uarch != cpuinfo_uarch_cortex_a510 && core->uarch != cpuinfo_uarch_cortex_a520) {
+		return true;
+	}
+	const struct cpuinfo_cache* l2 = tables->processors[core->processor_start].cache.l2;
+	if (l2 == NULL || l2->processor_count <= core->processor_count) {
+		return true;
+	}
+	/* A merged-core complex is a pair of cores of the same microarchitecture with an L2 cache of their own */
+	const struct cpuinfo_core* first_core = tables->processors[l2->processor_start].core;
+	const struct cpuinfo_core* last_core = tables->processors[l2->processor_start + l2->processor_count - 1].core;
+	if (last_core != first_core + 1 || first_core->uarch != last_core->uarch ||
+		first_core->processor_count + last_core->processor_count != l2->processor_count)
+	{
+		return true;
+	}
+	*core_start = (uint32_t) (first_core - tables->cores);
+	*core_count = 2;
+	return true;
 }
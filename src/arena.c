@@ -0,0 +1,221 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	#include <malloc.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Tables start on a cache line boundary to avoid false sharing with unrelated data and between tables */
+#define ARENA_ALIGNMENT 64
+/* Alignment of other allocations through a custom allocator, at least the alignment of malloc */
+#define ALLOCATION_ALIGNMENT 16
+
+static inline size_t align_size(size_t size) {
+	return (size + (ARENA_ALIGNMENT - 1)) & ~(size_t) (ARENA_ALIGNMENT - 1);
+}
+
+/*
+ * Caller-provided memory of cpuinfo_initialize_into: tables are carved from its start, and temporary arrays of an
+ * initialization from its end. When only measuring, memory comes from the heap, and its total size is counted.
+ */
+static struct {
+	char* memory;
+	size_t size;
+	size_t tables_size;
+	size_t temporary_size;
+	bool measuring;
+	size_t measured_size;
+} buffer;
+
+/* Total size of temporary arrays of the initialization in progress, and of the last completed initialization */
+static size_t transient_size = 0;
+static size_t last_transient_size = 0;
+
+static inline bool is_in_buffer(const void* memory) {
+	return buffer.memory != NULL && (uintptr_t) memory >= (uintptr_t) buffer.memory &&
+		(uintptr_t) memory < (uintptr_t) buffer.memory + buffer.size;
+}
+
+void cpuinfo_arena_attach_buffer(void* memory, size_t size) {
+	/* Offsets in the buffer keep the alignment of the memory */
+	const uintptr_t address = (uintptr_t) memory;
+	const uintptr_t aligned_address = (address + (ARENA_ALIGNMENT - 1)) & ~(uintptr_t) (ARENA_ALIGNMENT - 1);
+	const size_t padding = (size_t) (aligned_address - address);
+	buffer.memory = (char*) aligned_address;
+	buffer.size = size > padding ? (size - padding) & ~(size_t) (ARENA_ALIGNMENT - 1) : 0;
+	buffer.tables_size = 0;
+	buffer.temporary_size = 0;
+	buffer.measuring = false;
+}
+
+void cpuinfo_arena_measure_buffer(void) {
+	buffer.memory = NULL;
+	buffer.size = 0;
+	buffer.measuring = true;
+	buffer.measured_size = 0;
+	buffer.tables_size = 0;
+	buffer.temporary_size = 0;
+}
+
+size_t cpuinfo_arena_detach_buffer(void) {
+	const size_t used_size = buffer.measuring ?
+		buffer.measured_size + ARENA_ALIGNMENT /* for alignment of the caller's memory */ : buffer.tables_size;
+	buffer.memory = NULL;
+	buffer.size = 0;
+	buffer.measuring = false;
+	return used_size;
+}
+
+void cpuinfo_arena_release_temporary(void) {
+	if (buffer.measuring) {
+		const size_t total_size = buffer.tables_size + buffer.temporary_size;
+		if (total_size > buffer.measured_size) {
+			buffer.measured_size = total_size;
+		}
+	}
+	buffer.temporary_size = 0;
+	last_transient_size = transient_size;
+	transient_size = 0;
+}
+
+size_t cpuinfo_arena_get_transient_size(void) {
+	return last_transient_size;
+}
+
+/* Carve memory from the start of the buffer for tables, or from its end for temporary arrays */
+static void* allocate_from_buffer(size_t size, bool temporary) {
+	size = align_size(size);
+	if (buffer.measuring) {
+		if (temporary) {
+			buffer.temporary_size += size;
+		} else {
+			buffer.tables_size += size;
+		}
+		return NULL;
+	}
+	if (size > buffer.size - buffer.tables_size - buffer.temporary_size) {
+		cpuinfo_log_error("failed to allocate %zu bytes in the buffer of %zu bytes: %zu bytes are in use",
+			size, buffer.size, buffer.tables_size + buffer.temporary_size);
+		return NULL;
+	}
+	void* memory;
+	if (temporary) {
+		buffer.temporary_size += size;
+		memory = buffer.memory + buffer.size - buffer.temporary_size;
+	} else {
+		memory = buffer.memory + buffer.tables_size;
+		buffer.tables_size += size;
+	}
+	memset(memory, 0, size);
+	return memory;
+}
+
+void* cpuinfo_allocate(size_t count, size_t entry_size) {
+	if (cpuinfo_allocator.allocate == NULL) {
+		return calloc(count, entry_size);
+	}
+	if (entry_size != 0 && count > SIZE_MAX / entry_size) {
+		return NULL;
+	}
+	const size_t size = count * entry_size;
+	void* memory = cpuinfo_allocator.allocate(cpuinfo_allocator.context, size, ALLOCATION_ALIGNMENT);
+	if (memory != NULL) {
+		memset(memory, 0, size);
+	}
+	return memory;
+}
+
+void cpuinfo_deallocate(void* memory) {
+	if (cpuinfo_allocator.deallocate == NULL) {
+		free(memory);
+	} else if (memory != NULL) {
+		cpuinfo_allocator.deallocate(cpuinfo_allocator.context, memory);
+	}
+}
+
+void* cpuinfo_allocate_temporary(size_t count, size_t entry_size) {
+	transient_size += count * entry_size;
+	if (buffer.memory != NULL) {
+		return allocate_from_buffer(count * entry_size, true);
+	}
+	if (buffer.measuring) {
+		allocate_from_buffer(count * entry_size, true);
+	}
+	return cpuinfo_allocate(count, entry_size);
+}
+
+void cpuinfo_free_temporary(void* memory) {
+	/* Temporary arrays in the buffer are released together when initialization completes */
+	if (!is_in_buffer(memory)) {
+		cpuinfo_deallocate(memory);
+	}
+}
+
+size_t cpuinfo_arena_reserve(struct cpuinfo_arena arena[restrict static 1], size_t count, size_t entry_size) {
+	const size_t offset = (arena->size + (ARENA_ALIGNMENT - 1)) & ~(size_t) (ARENA_ALIGNMENT - 1);
+	arena->size = offset + count * entry_size;
+	return offset;
+}
+
+bool cpuinfo_arena_allocate(struct cpuinfo_arena arena[restrict static 1]) {
+	const size_t size = align_size(arena->size);
+	if (buffer.memory != NULL) {
+		arena->memory = allocate_from_buffer(size, false);
+		return arena->memory != NULL;
+	}
+	if (buffer.measuring) {
+		allocate_from_buffer(size, false);
+	}
+	void* memory = NULL;
+	if (cpuinfo_allocator.allocate != NULL) {
+		memory = cpuinfo_allocator.allocate(cpuinfo_allocator.context, size, ARENA_ALIGNMENT);
+	} else {
+		#if defined(_WIN32) || defined(__CYGWIN__)
+			memory = _aligned_malloc(size, ARENA_ALIGNMENT);
+		#else
+			if (posix_memalign(&memory, ARENA_ALIGNMENT, size) != 0) {
+				memory = NULL;
+			}
+		#endif
+	}
+	if (memory == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for topology tables", size);
+		return false;
+	}
+	memset(memory, 0, size);
+	arena->memory = memory;
+	return true;
+}
+
+void* cpuinfo_arena_get(const struct cpuinfo_arena arena[restrict static 1], size_t offset, size_t count) {
+	if (count == 0) {
+		return NULL;
+	}
+	return (void*) ((char*) arena->memory + offset);
+}
+
+void cpuinfo_arena_free(void* memory) {
+	/* Tables in the buffer are released together when cpuinfo is deinitialized */
+	if (is_in_buffer(memory)) {
+		return;
+	}
+	if (cpuinfo_allocator.deallocate != NULL) {
+		if (memory != NULL) {
+			cpuinfo_allocator.deallocate(cpuinfo_allocator.context, memory);
+		}
+		return;
+	}
+	#if defined(_WIN32) || defined(__CYGWIN__)
+		_aligned_free(memory);
+	#else
+		free(memory);
+	#endif
+}
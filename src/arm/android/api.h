@@ -18,3 +18,15 @@ enum cpuinfo_android_chipset_property {
 
 CPUINFO_INTERNAL void cpuinfo_arm_android_parse_properties(
 	struct cpuinfo_android_properties properties[restrict static 1]);
+
+CPUINFO_INTERNAL bool cpuinfo_arm_android_load_chipset_cache(
+	const char fingerprint[restrict static CPUINFO_BUILD_PROP_VALUE_MAX],
+	uint32_t max_processors_count,
+	struct cpuinfo_arm_linux_processor processors[restrict static max_processors_count],
+	struct cpuinfo_arm_chipset chipset[restrict static 1]);
+
+CPUINFO_INTERNAL void cpuinfo_arm_android_save_chipset_cache(
+	const char fingerprint[restrict static CPUINFO_BUILD_PROP_VALUE_MAX],
+	uint32_t max_processors_count,
+	const struct cpuinfo_arm_linux_processor processors[restrict static max_processors_count],
+	const struct cpuinfo_arm_chipset chipset[restrict static 1]);
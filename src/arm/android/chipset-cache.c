@@ -0,0 +1,184 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <arm/android/api.h>
+#include <arm/linux/api.h>
+#include <linux/api.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#define CHIPSET_CACHE_VERSION 1
+#define CHIPSET_CACHE_FILENAME "/chipset.bin"
+#define CHIPSET_CACHE_PATH_MAX (CPUINFO_CHIPSET_CACHE_DIRECTORY_MAX + sizeof(CHIPSET_CACHE_FILENAME))
+
+/* Layout of a cache file: header, followed by MIDR of every possible processor, or 0 for invalid processors */
+struct chipset_cache_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t processors_count;
+	/* ro.build.fingerprint of the system the chipset was detected on */
+	char fingerprint[CPUINFO_BUILD_PROP_VALUE_MAX];
+	struct cpuinfo_arm_chipset chipset;
+};
+
+static const char chipset_cache_magic[8] = { 'C', 'P', 'U', 'I', 'N', 'F', 'O', 'C' };
+
+static inline bool bitmask_all(uint32_t bitfield, uint32_t mask) {
+	return (bitfield & mask) == mask;
+}
+
+static bool get_cache_path(char path[restrict static CHIPSET_CACHE_PATH_MAX]) {
+	if (cpuinfo_chipset_cache_directory[0] == '\0') {
+		return false;
+	}
+	const size_t length = strnlen(cpuinfo_chipset_cache_directory, CPUINFO_CHIPSET_CACHE_DIRECTORY_MAX);
+	memcpy(path, cpuinfo_chipset_cache_directory, length);
+	memcpy(path + length, CHIPSET_CACHE_FILENAME, sizeof(CHIPSET_CACHE_FILENAME));
+	return true;
+}
+
+bool cpuinfo_arm_android_load_chipset_cache(
+	const char fingerprint[restrict static CPUINFO_BUILD_PROP_VALUE_MAX],
+	uint32_t max_processors_count,
+	struct cpuinfo_arm_linux_processor processors[restrict static max_processors_count],
+	struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	char path[CHIPSET_CACHE_PATH_MAX];
+	if (fingerprint[0] == '\0' || !get_cache_path(path)) {
+		return false;
+	}
+	const int file = open(path, O_RDONLY | O_CLOEXEC);
+	if (file == -1) {
+		cpuinfo_log_debug("no chipset cache file %s: %s", path, strerror(errno));
+		return false;
+	}
+
+	bool status = false;
+	const size_t size = sizeof(struct chipset_cache_header) + max_processors_count * sizeof(uint32_t);
+	char* buffer = cpuinfo_allocate_temporary(size + 1, sizeof(char));
+	if (buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for chipset cache file %s", size, path);
+		goto cleanup;
+	}
+	/* Read one byte more than expected, so that a longer file is detected as invalid */
+	size_t bytes_read = 0;
+	while (bytes_read <= size) {
+		const ssize_t result = read(file, buffer + bytes_read, size + 1 - bytes_read);
+		if (result <= 0) {
+			if (result < 0 && errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		bytes_read += (size_t) result;
+	}
+
+	struct chipset_cache_header header;
+	if (bytes_read != size) {
+		cpuinfo_log_warning("ignoring chipset cache file %s of unexpected size", path);
+		goto cleanup;
+	}
+	memcpy(&header, buffer, sizeof(header));
+	if (memcmp(header.magic, chipset_cache_magic, sizeof(chipset_cache_magic)) != 0 ||
+		header.version != CHIPSET_CACHE_VERSION || header.processors_count != max_processors_count)
+	{
+		cpuinfo_log_warning("ignoring chipset cache file %s with unexpected header", path);
+		goto cleanup;
+	}
+	if (strncmp(header.fingerprint, fingerprint, CPUINFO_BUILD_PROP_VALUE_MAX) != 0) {
+		cpuinfo_log_info("ignoring chipset cache file %s of build \"%.*s\"",
+			path, CPUINFO_BUILD_PROP_VALUE_MAX, header.fingerprint);
+		goto cleanup;
+	}
+
+	for (uint32_t i = 0; i < max_processors_count; i++) {
+		uint32_t midr;
+		memcpy(&midr, buffer + sizeof(header) + i * sizeof(uint32_t), sizeof(midr));
+		if (midr != 0 && bitmask_all(processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			processors[i].midr = midr;
+			processors[i].flags |= CPUINFO_ARM_LINUX_VALID_MIDR;
+		}
+	}
+	*chipset = header.chipset;
+	cpuinfo_log_debug("loaded chipset and MIDRs of %"PRIu32" processors from cache file %s",
+		max_processors_count, path);
+	status = true;
+
+cleanup:
+	cpuinfo_free_temporary(buffer);
+	close(file);
+	return status;
+}
+
+void cpuinfo_arm_android_save_chipset_cache(
+	const char fingerprint[restrict static CPUINFO_BUILD_PROP_VALUE_MAX],
+	uint32_t max_processors_count,
+	const struct cpuinfo_arm_linux_processor processors[restrict static max_processors_count],
+	const struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	char path[CHIPSET_CACHE_PATH_MAX];
+	if (fingerprint[0] == '\0' || !get_cache_path(path)) {
+		return;
+	}
+
+	const size_t size = sizeof(struct chipset_cache_header) + max_processors_count * sizeof(uint32_t);
+	char* buffer = cpuinfo_allocate_temporary(size, sizeof(char));
+	if (buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for chipset cache file %s", size, path);
+		return;
+	}
+	struct chipset_cache_header header = {
+		.version = CHIPSET_CACHE_VERSION,
+		.processors_count = max_processors_count,
+		.chipset = *chipset,
+	};
+	memcpy(header.magic, chipset_cache_magic, sizeof(chipset_cache_magic));
+	strncpy(header.fingerprint, fingerprint, CPUINFO_BUILD_PROP_VALUE_MAX);
+	memcpy(buffer, &header, sizeof(header));
+	for (uint32_t i = 0; i < max_processors_count; i++) {
+		if (bitmask_all(processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_ARM_LINUX_VALID_MIDR)) {
+			memcpy(buffer + sizeof(header) + i * sizeof(uint32_t), &processors[i].midr, sizeof(uint32_t));
+		}
+	}
+
+	/* Write into a temporary file and rename it, so that concurrent launches never read a partial file */
+	char temp_path[sizeof(path) + sizeof(".XXXXXX")];
+	snprintf(temp_path, sizeof(temp_path), "%s.XXXXXX", path);
+	const int file = mkstemp(temp_path);
+	if (file == -1) {
+		cpuinfo_log_warning("failed to create temporary chipset cache file %s: %s", temp_path, strerror(errno));
+		cpuinfo_free_temporary(buffer);
+		return;
+	}
+	size_t bytes_written = 0;
+	while (bytes_written < size) {
+		const ssize_t result = write(file, buffer + bytes_written, size - bytes_written);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			cpuinfo_log_warning("failed to write chipset cache file %s: %s", temp_path, strerror(errno));
+			break;
+		}
+		bytes_written += (size_t) result;
+	}
+	close(file);
+	cpuinfo_free_temporary(buffer);
+	if (bytes_written != size || rename(temp_path, path) != 0) {
+		if (bytes_written == size) {
+			cpuinfo_log_warning("failed to rename chipset cache file %s to %s: %s", temp_path, path, strerror(errno));
+		}
+		unlink(temp_path);
+		return;
+	}
+	cpuinfo_log_debug("saved chipset and MIDRs of %"PRIu32" processors to cache file %s", max_processors_count, path);
+}
@@ -11,6 +11,22 @@
 #include <arm/linux/api.h>
 #include <cpuinfo/log.h>
 
+/* Properties in the order of fields of struct cpuinfo_android_properties */
+static const struct {
+	const char* key;
+	size_t offset;
+} android_properties[] = {
+	{ "ro.product.board", offsetof(struct cpuinfo_android_properties, ro_product_board) },
+	{ "ro.board.platform", offsetof(struct cpuinfo_android_properties, ro_board_platform) },
+	{ "ro.mediatek.platform", offsetof(struct cpuinfo_android_properties, ro_mediatek_platform) },
+	{ "ro.arch", offsetof(struct cpuinfo_android_properties, ro_arch) },
+	{ "ro.chipname", offsetof(struct cpuinfo_android_properties, ro_chipname) },
+	{ "ro.hardware.chipname", offsetof(struct cpuinfo_android_properties, ro_hardware_chipname) },
+	{ "ro.build.fingerprint", offsetof(struct cpuinfo_android_properties, ro_build_fingerprint) },
+};
+
+#define ANDROID_PROPERTIES_COUNT (sizeof(android_properties) / sizeof(android_properties[0]))
+
 #if CPUINFO_MOCK
 	#include <cpuinfo-mock.h>
 
@@ -21,10 +37,13 @@
 		cpuinfo_mock_properties = properties;
 	}
 
-	static int cpuinfo_android_property_get(const char* key, char* value) {
+	static void cpuinfo_android_resolve_properties(void) {
+	}
+
+	static int cpuinfo_android_property_get(uint32_t index, char* value) {
 		if (cpuinfo_mock_properties != NULL) {
 			for (const struct cpuinfo_mock_property* prop = cpuinfo_mock_properties; prop->key != NULL; prop++) {
-				if (strncmp(key, prop->key, CPUINFO_BUILD_PROP_NAME_MAX) == 0) {
+				if (strncmp(android_properties[index].key, prop->key, CPUINFO_BUILD_PROP_NAME_MAX) == 0) {
 					strncpy(value, prop->value, CPUINFO_BUILD_PROP_VALUE_MAX);
 					return (int) strnlen(prop->value, CPUINFO_BUILD_PROP_VALUE_MAX);
 				}
@@ -34,34 +53,36 @@
 		return 0;
 	}
 #else
-	static inline int cpuinfo_android_property_get(const char* key, char* value) {
-		return __system_property_get(key, value);
+	/*
+	 * Handles of read-only properties stay valid for the lifetime of the process, so the property trie in shared
+	 * memory is searched only by the first initialization, and later ones read the values directly.
+	 */
+	static const prop_info* property_handles[ANDROID_PROPERTIES_COUNT];
+	static bool property_handles_resolved = false;
+
+	static void cpuinfo_android_resolve_properties(void) {
+		if (!property_handles_resolved) {
+			for (uint32_t i = 0; i < ANDROID_PROPERTIES_COUNT; i++) {
+				property_handles[i] = __system_property_find(android_properties[i].key);
+			}
+			property_handles_resolved = true;
+		}
+	}
+
+	static int cpuinfo_android_property_get(uint32_t index, char* value) {
+		if (property_handles[index] == NULL) {
+			*value = '\0';
+			return 0;
+		}
+		return __system_property_read(property_handles[index], NULL, value);
 	}
 #endif
 
 void cpuinfo_arm_android_parse_properties(struct cpuinfo_android_properties properties[restrict static 1]) {
-	const int ro_product_board_length =
-		cpuinfo_android_property_get("ro.product.board", properties->ro_product_board);
-	cpuinfo_log_debug("read ro.product.board = \"%.*s\"", ro_product_board_length, properties->ro_product_board);
-
-	const int ro_board_platform_length =
-		cpuinfo_android_property_get("ro.board.platform", properties->ro_board_platform);
-	cpuinfo_log_debug("read ro.board.platform = \"%.*s\"", ro_board_platform_length, properties->ro_board_platform);
-
-	const int ro_mediatek_platform_length =
-		cpuinfo_android_property_get("ro.mediatek.platform", properties->ro_mediatek_platform);
-	cpuinfo_log_debug("read ro.mediatek.platform = \"%.*s\"",
-		ro_mediatek_platform_length, properties->ro_mediatek_platform);
-
-	const int ro_arch_length =
-		cpuinfo_android_property_get("ro.arch", properties->ro_arch);
-	cpuinfo_log_debug("read ro.arch = \"%.*s\"", ro_arch_length, properties->ro_arch);
-
-	const int ro_chipname_length =
-		cpuinfo_android_property_get("ro.chipname", properties->ro_chipname);
-	cpuinfo_log_debug("read ro.chipname = \"%.*s\"", ro_chipname_length, properties->ro_chipname);
-
-	const int ro_hardware_chipname_length =
-		cpuinfo_android_property_get("ro.hardware.chipname", properties->ro_hardware_chipname);
-	cpuinfo_log_debug("read ro.hardware.chipname = \"%.*s\"", ro_hardware_chipname_length, properties->ro_hardware_chipname);
+	cpuinfo_android_resolve_properties();
+	for (uint32_t i = 0; i < ANDROID_PROPERTIES_COUNT; i++) {
+		char* value = (char*) properties + android_properties[i].offset;
+		const int length = cpuinfo_android_property_get(i, value);
+		cpuinfo_log_debug("read %s = \"%.*s\"", android_properties[i].key, length, value);
+	}
 }
@@ -82,6 +82,12 @@ struct cpuinfo_arm_chipset {
 		const struct cpuinfo_arm_chipset chipset[restrict static 1],
 		char name[restrict static CPUINFO_ARM_CHIPSET_NAME_MAX]);
 
+	/* Parse a chipset name in the format of cpuinfo_arm_chipset_to_string, with a non-zero model */
+	CPUINFO_INTERNAL bool cpuinfo_arm_chipset_from_string(
+		const char* name,
+		size_t length,
+		struct cpuinfo_arm_chipset chipset[restrict static 1]);
+
 	CPUINFO_INTERNAL void cpuinfo_arm_fixup_chipset(
 		struct cpuinfo_arm_chipset chipset[restrict static 1], uint32_t cores, uint32_t max_cpu_freq_max);
 
@@ -105,6 +111,11 @@ struct cpuinfo_arm_chipset {
 		struct cpuinfo_cache l2[restrict static 1],
 		struct cpuinfo_cache l3[restrict static 1]);
 
+	/* Describe the system-level cache of the SoC shared by processors and other devices, or leave it empty if none */
+	CPUINFO_INTERNAL void cpuinfo_arm_decode_system_cache(
+		const struct cpuinfo_arm_chipset chipset[restrict static 1],
+		struct cpuinfo_cache l4[restrict static 1]);
+
 	CPUINFO_INTERNAL uint32_t cpuinfo_arm_compute_max_cache_size(
 		const struct cpuinfo_processor processor[restrict static 1]);
 #else /* defined(__cplusplus) */
@@ -119,4 +130,26 @@ struct cpuinfo_arm_chipset {
 		struct cpuinfo_cache l1d[1],
 		struct cpuinfo_cache l2[1],
 		struct cpuinfo_cache l3[1]);
+
+	CPUINFO_INTERNAL void cpuinfo_arm_decode_system_cache(
+		const struct cpuinfo_arm_chipset chipset[1],
+		struct cpuinfo_cache l4[1]);
 #endif
+
+struct cpuinfo_uarch_streaming_hints;
+
+/* Describe tuning of streaming copies and fills for the microarchitecture, or return defaults if unknown */
+CPUINFO_INTERNAL struct cpuinfo_uarch_streaming_hints cpuinfo_arm_decode_streaming_hints(enum cpuinfo_uarch uarch);
+
+struct cpuinfo_uarch_tlbs;
+
+/* Describe TLBs of the microarchitecture from its Technical Reference Manual, or leave them empty if unknown */
+CPUINFO_INTERNAL void cpuinfo_arm_decode_tlb(enum cpuinfo_uarch uarch, struct cpuinfo_uarch_tlbs* tlbs);
+
+/*
+ * Add user-space features which all cores of the microarchitecture implement to the set, even if the kernel doesn't
+ * report them because other cores in the system lack them
+ */
+CPUINFO_INTERNAL void cpuinfo_arm_add_uarch_isa_features(
+	enum cpuinfo_uarch uarch,
+	struct cpuinfo_isa_features features[restrict static 1]);
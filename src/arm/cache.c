@@ -19,6 +19,15 @@ void cpuinfo_arm_decode_cache(
 	struct cpuinfo_cache l2[restrict static 1],
 	struct cpuinfo_cache l3[restrict static 1])
 {
+	const struct cpuinfo_uarch_table_entry* entry = cpuinfo_find_uarch_table_entry(midr);
+	if (entry != NULL && entry->l1d.size != 0) {
+		*l1i = entry->l1i;
+		*l1d = entry->l1d;
+		*l2 = entry->l2;
+		*l3 = entry->l3;
+		return;
+	}
+
 	switch (uarch) {
 #if CPUINFO_ARCH_ARM && !defined(__ARM_ARCH_7A__) && !defined(__ARM_ARCH_8A__)
 		case cpuinfo_uarch_xscale:
@@ -740,6 +749,7 @@ void cpuinfo_arm_decode_cache(
 					.size = l3_size,
 					.associativity = 16,
 					.line_size = 64,
+					.flags = CPUINFO_CACHE_EXCLUSIVE,
 				};
 			} else {
 				/* Standard Cortex-A55 */
@@ -783,6 +793,7 @@ void cpuinfo_arm_decode_cache(
 						/* DynamIQ */
 						.associativity = 16,
 						.line_size = 64,
+						.flags = CPUINFO_CACHE_EXCLUSIVE,
 					};
 				}
 			}
@@ -890,6 +901,7 @@ void cpuinfo_arm_decode_cache(
 				/* DynamIQ */
 				.associativity = 16,
 				.line_size = 64,
+				.flags = CPUINFO_CACHE_EXCLUSIVE,
 			};
 			break;
 		}
@@ -1110,7 +1122,8 @@ void cpuinfo_arm_decode_cache(
 			*l3 = (struct cpuinfo_cache) {
 				.size = l3_size,
 				.associativity = 16,
-				.line_size = 64
+				.line_size = 64,
+				.flags = CPUINFO_CACHE_EXCLUSIVE,
 			};
 			break;
 		}
@@ -1184,6 +1197,7 @@ void cpuinfo_arm_decode_cache(
 				.size = l3_size,
 				.associativity = 16,
 				.line_size = 64,
+				.flags = CPUINFO_CACHE_EXCLUSIVE,
 			};
 			break;
 		}
@@ -1235,6 +1249,7 @@ void cpuinfo_arm_decode_cache(
 				.size = l3_size,
 				.associativity = 16,
 				.line_size = 64,
+				.flags = CPUINFO_CACHE_EXCLUSIVE,
 			};
 			break;
 		}
@@ -1611,6 +1626,59 @@ void cpuinfo_arm_decode_cache(
 	}
 }
 
+void cpuinfo_arm_decode_system_cache(
+	const struct cpuinfo_arm_chipset chipset[restrict static 1],
+	struct cpuinfo_cache l4[restrict static 1])
+{
+	/*
+	 * Qualcomm Snapdragon SoCs since Snapdragon 845 have a system-level cache (LLCC) behind the DynamIQ L3 cache,
+	 * shared by processors, GPU, DSPs and other devices. Linux partitions it into slices for devices, and doesn't
+	 * describe it in processor caches in sysfs.
+	 *
+	 *  +--------------------+-----------+------+
+	 *  | Processor model    | LLCC size | Ways |
+	 *  +--------------------+-----------+------+
+	 *  | Snapdragon 845     |    3M     |  12  |
+	 *  | Snapdragon 855     |    3M     |  12  |
+	 *  | Snapdragon 865     |    3M     |  12  |
+	 *  | Snapdragon 888     |    3M     |  12  |
+	 *  | Snapdragon 8 Gen 1 |    4M     |  16  |
+	 *  +--------------------+-----------+------+
+	 *
+	 * Sizes are from Qualcomm product announcements, and ways are from bit masks of slice configurations in the
+	 * Linux LLCC driver (drivers/soc/qcom/llcc-qcom.c).
+	 */
+	uint32_t size = 0, associativity = 0;
+	if (chipset->series == cpuinfo_arm_chipset_series_qualcomm_snapdragon) {
+		switch (chipset->model) {
+			case 845:
+			case 8150:
+			case 8250:
+			case 8350:
+				size = 3 * 1024 * 1024;
+				associativity = 12;
+				break;
+			case 8450:
+				size = 4 * 1024 * 1024;
+				associativity = 16;
+				break;
+			default:
+				break;
+		}
+	}
+
+	*l4 = (struct cpuinfo_cache) { 0 };
+	if (size != 0) {
+		*l4 = (struct cpuinfo_cache) {
+			.size = size,
+			.associativity = associativity,
+			.sets = size / (associativity * 64),
+			.partitions = 1,
+			.line_size = 64,
+		};
+	}
+}
+
 uint32_t cpuinfo_arm_compute_max_cache_size(const struct cpuinfo_processor* processor) {
 	/*
 	 * There is no precise way to detect cache size on ARM/ARM64, and cache size reported by cpuinfo
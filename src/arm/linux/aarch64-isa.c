@@ -1,12 +1,85 @@
 #include <stdint.h>
+#include <inttypes.h>
 
 #include <arm/linux/api.h>
 #include <cpuinfo/log.h>
 
 
+#if !CPUINFO_MOCK && defined(__GNUC__)
+	/* Read an ID register through its generic name, which assemblers accept even without knowing the register */
+	#define READ_ID_REGISTER(name) \
+		({ uint64_t value; __asm__ __volatile__("mrs %0, " name : "=r" (value)); value; })
+
+	/* 4-bit field of an ID register */
+	static inline uint32_t id_field(uint64_t value, uint32_t shift) {
+		return (uint32_t) (value >> shift) & UINT32_C(0xF);
+	}
+
+	/*
+	 * Decode ISA features from the ID registers, which Linux exposes to user space by emulating MRS when HWCAP_CPUID
+	 * is set. The kernel reports the values sanitized to the features common to all cores, and zeroes fields it
+	 * doesn't know, so the registers only fill in features which the kernel knows but doesn't report in hwcaps.
+	 */
+	static void decode_isa_from_id_registers(struct cpuinfo_arm_isa isa[restrict static 1]) {
+		const uint64_t isar0 = READ_ID_REGISTER("S3_0_C0_C6_0");  /* ID_AA64ISAR0_EL1 */
+		const uint64_t isar1 = READ_ID_REGISTER("S3_0_C0_C6_1");  /* ID_AA64ISAR1_EL1 */
+		const uint64_t isar2 = READ_ID_REGISTER("S3_0_C0_C6_2");  /* ID_AA64ISAR2_EL1 */
+		const uint64_t pfr0 = READ_ID_REGISTER("S3_0_C0_C4_0");   /* ID_AA64PFR0_EL1 */
+		const uint64_t pfr1 = READ_ID_REGISTER("S3_0_C0_C4_1");   /* ID_AA64PFR1_EL1 */
+		const uint64_t zfr0 = READ_ID_REGISTER("S3_0_C0_C4_4");   /* ID_AA64ZFR0_EL1 */
+		cpuinfo_log_debug("ID_AA64ISAR0/1/2_EL1 = 0x%016"PRIx64", 0x%016"PRIx64", 0x%016"PRIx64,
+			isar0, isar1, isar2);
+		cpuinfo_log_debug("ID_AA64PFR0/1_EL1 = 0x%016"PRIx64", 0x%016"PRIx64", ID_AA64ZFR0_EL1 = 0x%016"PRIx64,
+			pfr0, pfr1, zfr0);
+
+		isa->aes |= id_field(isar0, 4) >= 1;
+		isa->pmull |= id_field(isar0, 4) >= 2;
+		isa->sha1 |= id_field(isar0, 8) >= 1;
+		isa->sha2 |= id_field(isar0, 12) >= 1;
+		isa->sha512 |= id_field(isar0, 12) >= 2;
+		isa->crc32 |= id_field(isar0, 16) >= 1;
+		isa->atomics |= id_field(isar0, 20) >= 2;
+		isa->lse128 |= id_field(isar0, 20) >= 3;
+		isa->rdm |= id_field(isar0, 28) >= 1;
+		isa->sha3 |= id_field(isar0, 32) >= 1;
+		isa->sm3 |= id_field(isar0, 36) >= 1;
+		isa->sm4 |= id_field(isar0, 40) >= 1;
+		isa->dot |= id_field(isar0, 44) >= 1;
+		isa->fhm |= id_field(isar0, 48) >= 1;
+		isa->rng |= id_field(isar0, 60) >= 1;
+
+		isa->jscvt |= id_field(isar1, 12) >= 1;
+		isa->fcma |= id_field(isar1, 16) >= 1;
+		isa->rcpc |= id_field(isar1, 20) >= 1;
+		isa->rcpc2 |= id_field(isar1, 20) >= 2;
+		isa->rcpc3 |= id_field(isar1, 20) >= 3;
+		isa->bf16 |= id_field(isar1, 44) >= 1;
+		isa->i8mm |= id_field(isar1, 52) >= 1;
+
+		isa->wfxt |= id_field(isar2, 0) >= 2;
+		isa->pauth |= id_field(isar1, 4) >= 1 || id_field(isar1, 8) >= 1 || id_field(isar2, 12) >= 1;
+
+		isa->bti |= id_field(pfr1, 0) >= 1;
+		isa->mte |= id_field(pfr1, 8) >= 1;
+		/* Tag checks need the kernel support which HWCAP2_MTE reports */
+		isa->mte3 |= isa->mte2 && id_field(pfr1, 8) >= 3;
+
+		/* AdvSIMD field is signed: 0xF means no Advanced SIMD, 1 means Advanced SIMD with half-precision */
+		isa->fp16arith |= id_field(pfr0, 20) == 1;
+		if (id_field(pfr0, 32) >= 1) {
+			isa->sve = true;
+			isa->sve2 |= id_field(zfr0, 0) >= 1;
+		}
+
+		isa->sme |= id_field(pfr1, 24) >= 1;
+		isa->sme2 |= id_field(pfr1, 24) >= 2;
+	}
+#endif
+
+
 void cpuinfo_arm64_linux_decode_isa_from_proc_cpuinfo(
 	uint32_t features,
-	uint32_t features2,
+	uint64_t features2,
 	uint32_t midr,
 	const struct cpuinfo_arm_chipset chipset[restrict static 1],
 	struct cpuinfo_arm_isa isa[restrict static 1])
@@ -26,9 +99,56 @@ void cpuinfo_arm64_linux_decode_isa_from_proc_cpuinfo(
 	if (features & CPUINFO_ARM_LINUX_FEATURE_CRC32) {
 		isa->crc32 = true;
 	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_SHA3) {
+		isa->sha3 = true;
+	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_SHA512) {
+		isa->sha512 = true;
+	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_SM3) {
+		isa->sm3 = true;
+	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_SM4) {
+		isa->sm4 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_RNG) {
+		isa->rng = true;
+	}
 	if (features & CPUINFO_ARM_LINUX_FEATURE_ATOMICS) {
 		isa->atomics = true;
 	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_USCAT) {
+		isa->lse2 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_LSE128) {
+		isa->lse128 = true;
+	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_LRCPC) {
+		isa->rcpc = true;
+	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_ILRCPC) {
+		isa->rcpc2 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_LRCPC3) {
+		isa->rcpc3 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_WFXT) {
+		isa->wfxt = true;
+	}
+	if (features & CPUINFO_ARM_LINUX_FEATURE_PACA) {
+		isa->pauth = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_BTI) {
+		isa->bti = true;
+	}
+	/* HWCAP2_MTE reports FEAT_MTE2, and requires a kernel which supports tag checks in user space */
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_MTE) {
+		isa->mte = true;
+		isa->mte2 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_MTE3) {
+		isa->mte3 = true;
+	}
 
 	/*
 	 * Some phones ship with an old kernel configuration that doesn't report NEON FP16 compute extension and SQRDMLAH/SQRDMLSH/UQRDMLAH/UQRDMLSH instructions.
@@ -134,6 +254,21 @@ void cpuinfo_arm64_linux_decode_isa_from_proc_cpuinfo(
 	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_SVE2) {
 		isa->sve2 = true;
 	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_SME) {
+		isa->sme = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_SME2) {
+		isa->sme2 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_SME_F64F64) {
+		isa->sme_f64f64 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_SME_I16I64) {
+		isa->sme_i16i64 = true;
+	}
+	if (features2 & CPUINFO_ARM_LINUX_FEATURE2_SME_FA64) {
+		isa->sme_fa64 = true;
+	}
 	// SVEBF16 is set iff SVE and BF16 are both supported, but the SVEBF16 feature flag
 	// was added in Linux kernel before the BF16 feature flag, so we check for either.
 	if (features2 & (CPUINFO_ARM_LINUX_FEATURE2_BF16 | CPUINFO_ARM_LINUX_FEATURE2_SVEBF16)) {
@@ -142,5 +277,11 @@ void cpuinfo_arm64_linux_decode_isa_from_proc_cpuinfo(
 	if (features & CPUINFO_ARM_LINUX_FEATURE_ASIMDFHM) {
 		isa->fhm = true;
 	}
+
+	#if !CPUINFO_MOCK && defined(__GNUC__)
+		if (features & CPUINFO_ARM_LINUX_FEATURE_CPUID) {
+			decode_isa_from_id_registers(isa);
+		}
+	#endif
 }
 
@@ -0,0 +1,218 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#include <arm/api.h>
+#include <arm/linux/api.h>
+#include <cpuinfo/log.h>
+
+
+/*
+ * GPU and NPU of a chipset model. Qualcomm shader core counts are not published, and are 0.
+ * Names as in product announcements of the SoC vendors: MP or MC suffixes of Mali follow the vendor of the SoC.
+ */
+struct accelerators_entry {
+	uint8_t series;
+	uint8_t gpu_family;
+	uint8_t npu_family;
+	uint8_t gpu_cores;
+	uint16_t model;
+	uint16_t gpu_model;
+	char gpu_name[20];
+};
+
+static const struct accelerators_entry accelerators_table[] = {
+	{ cpuinfo_arm_chipset_series_qualcomm_apq, cpuinfo_gpu_family_adreno, 0, 0, 8064, 320, "Adreno 320" },
+	{ cpuinfo_arm_chipset_series_qualcomm_apq, cpuinfo_gpu_family_adreno, 0, 0, 8084, 420, "Adreno 420" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8916, 306, "Adreno 306" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8917, 308, "Adreno 308" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8937, 505, "Adreno 505" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8939, 405, "Adreno 405" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8940, 505, "Adreno 505" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8952, 405, "Adreno 405" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8953, 506, "Adreno 506" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8956, 510, "Adreno 510" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8960, 225, "Adreno 225" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8974, 330, "Adreno 330" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8976, 510, "Adreno 510" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8992, 418, "Adreno 418" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8994, 430, "Adreno 430" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8996, 530, "Adreno 530" },
+	{ cpuinfo_arm_chipset_series_qualcomm_msm, cpuinfo_gpu_family_adreno, 0, 0, 8998, 540, "Adreno 540" },
+	/* SDMxxx chipsets have 3-digit models, and SMxxxx chipsets have 4-digit models */
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 450, 506, "Adreno 506" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 630, 508, "Adreno 508" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 636, 509, "Adreno 509" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 660, 512, "Adreno 512" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 670, 615, "Adreno 615" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 710, 616, "Adreno 616" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 712, 616, "Adreno 616" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 845, 630, "Adreno 630" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 6115, 610, "Adreno 610" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 6125, 610, "Adreno 610" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 6150, 612, "Adreno 612" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 6350, 619, "Adreno 619L" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 6375, 619, "Adreno 619" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 7125, 618, "Adreno 618" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 7150, 618, "Adreno 618" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno, 0, 0, 7225, 619, "Adreno 619" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 7250, 620, "Adreno 620" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 7325, 642, "Adreno 642L" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 7450, 644, "Adreno 644" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 7475, 725, "Adreno 725" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8150, 640, "Adreno 640" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8250, 650, "Adreno 650" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8350, 660, "Adreno 660" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8450, 730, "Adreno 730" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8475, 730, "Adreno 730" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8550, 740, "Adreno 740" },
+	{ cpuinfo_arm_chipset_series_qualcomm_snapdragon, cpuinfo_gpu_family_adreno,
+		cpuinfo_npu_family_hexagon, 0, 8650, 750, "Adreno 750" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 1, 6580, 400, "Mali-400 MP" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 2, 6582, 400, "Mali-400 MP2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 4, 6592, 450, "Mali-450 MP4" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_powervr, 0, 0, 6595, 6200, "PowerVR G6200" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 2, 6735, 720, "Mali-T720 MP2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 2, 6737, 720, "Mali-T720 MP2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 2, 6750, 860, "Mali-T860 MP2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 3, 6753, 720, "Mali-T720 MP3" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 2, 6755, 860, "Mali-T860 MP2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 2, 6757, 880, "Mali-T880 MP2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_powervr, 0, 0, 6762, 8320, "PowerVR GE8320" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_powervr, 0, 0, 6765, 8320, "PowerVR GE8320" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 3, 6771, 72, "Mali-G72 MP3" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 4, 6785, 76, "Mali-G76 MC4" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_powervr, 0, 0, 6795, 6200, "PowerVR G6200" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali, 0, 4, 6797, 880, "Mali-T880 MP4" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 2, 6833, 57, "Mali-G57 MC2" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 3, 6853, 57, "Mali-G57 MC3" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 4, 6877, 68, "Mali-G68 MC4" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 9, 6885, 77, "Mali-G77 MC9" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 9, 6889, 77, "Mali-G77 MC9" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 9, 6891, 77, "Mali-G77 MC9" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 9, 6893, 77, "Mali-G77 MC9" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_mediatek_apu, 10, 6983, 710, "Mali-G710 MC10" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_immortalis,
+		cpuinfo_npu_family_mediatek_apu, 11, 6985, 715, "Immortalis-G715 MC11" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_immortalis,
+		cpuinfo_npu_family_mediatek_apu, 12, 6989, 720, "Immortalis-G720 MC12" },
+	{ cpuinfo_arm_chipset_series_mediatek_mt, cpuinfo_gpu_family_powervr, 0, 0, 8173, 6250, "PowerVR GX6250" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 5, 980, 76, "Mali-G76 MP5" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 11, 990, 77, "Mali-G77 MP11" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 10, 1080, 78, "Mali-G78 MP10" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 4, 1280, 68, "Mali-G68 MP4" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 5, 1380, 68, "Mali-G68 MP5" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 14, 2100, 78, "Mali-G78 MP14" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_xclipse,
+		cpuinfo_npu_family_samsung, 0, 2200, 920, "Xclipse 920" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_xclipse,
+		cpuinfo_npu_family_samsung, 0, 2400, 940, "Xclipse 940" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 8, 7420, 760, "Mali-T760 MP8" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 2, 7870, 830, "Mali-T830 MP2" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 3, 7880, 830, "Mali-T830 MP3" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 2, 7885, 71, "Mali-G71 MP2" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 12, 8890, 880, "Mali-T880 MP12" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 20, 8895, 71, "Mali-G71 MP20" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 3, 9610, 72, "Mali-G72 MP3" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 3, 9611, 72, "Mali-G72 MP3" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali, 0, 18, 9810, 72, "Mali-G72 MP18" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 12, 9820, 76, "Mali-G76 MP12" },
+	{ cpuinfo_arm_chipset_series_samsung_exynos, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_samsung, 12, 9825, 76, "Mali-G76 MP12" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 2, 650, 830, "Mali-T830 MP2" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 2, 655, 830, "Mali-T830 MP2" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 2, 659, 830, "Mali-T830 MP2" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 710, 51, "Mali-G51 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 6, 810, 52, "Mali-G52 MP6" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 6, 820, 57, "Mali-G57 MC6" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 920, 628, "Mali-T628 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 925, 628, "Mali-T628 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 930, 628, "Mali-T628 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 935, 628, "Mali-T628 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 950, 880, "Mali-T880 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 4, 955, 880, "Mali-T880 MP4" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali, 0, 8, 960, 71, "Mali-G71 MP8" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 12, 970, 72, "Mali-G72 MP12" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 10, 980, 76, "Mali-G76 MP10" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 8, 985, 77, "Mali-G77 MP8" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 16, 990, 76, "Mali-G76 MP16" },
+	{ cpuinfo_arm_chipset_series_hisilicon_kirin, cpuinfo_gpu_family_mali,
+		cpuinfo_npu_family_hisilicon, 24, 9000, 78, "Mali-G78 MP24" },
+	{ cpuinfo_arm_chipset_series_rockchip_rk, cpuinfo_gpu_family_mali, 0, 4, 3288, 760, "Mali-T760 MP4" },
+	{ cpuinfo_arm_chipset_series_rockchip_rk, cpuinfo_gpu_family_mali, 0, 4, 3399, 860, "Mali-T860 MP4" },
+	{ cpuinfo_arm_chipset_series_rockchip_rk, cpuinfo_gpu_family_mali, 0, 4, 3588, 610, "Mali-G610 MP4" },
+};
+
+static const char* npu_names[] = {
+	[cpuinfo_npu_family_hexagon] = "Hexagon",
+	[cpuinfo_npu_family_mediatek_apu] = "MediaTek APU",
+	[cpuinfo_npu_family_samsung] = "Samsung NPU",
+	[cpuinfo_npu_family_hisilicon] = "HiSilicon NPU",
+};
+
+static uint32_t leading_digit(uint32_t number) {
+	while (number >= 10) {
+		number /= 10;
+	}
+	return number;
+}
+
+void cpuinfo_arm_linux_decode_accelerators(
+	const struct cpuinfo_arm_chipset chipset[restrict static 1],
+	struct cpuinfo_integrated_gpu gpu[restrict static 1],
+	struct cpuinfo_npu npu[restrict static 1])
+{
+	*gpu = (struct cpuinfo_integrated_gpu) { 0 };
+	*npu = (struct cpuinfo_npu) { 0 };
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(accelerators_table); i++) {
+		const struct accelerators_entry* entry = &accelerators_table[i];
+		if (entry->series == (uint8_t) chipset->series && entry->model == chipset->model) {
+			*gpu = (struct cpuinfo_integrated_gpu) {
+				.family = (enum cpuinfo_gpu_family) entry->gpu_family,
+				.model = entry->gpu_model,
+				.series = leading_digit(entry->gpu_model),
+				.cores = entry->gpu_cores,
+			};
+			strncpy(gpu->name, entry->gpu_name, CPUINFO_GPU_NAME_MAX - 1);
+			if (entry->npu_family != cpuinfo_npu_family_unknown) {
+				npu->family = (enum cpuinfo_npu_family) entry->npu_family;
+				strncpy(npu->name, npu_names[entry->npu_family], CPUINFO_NPU_NAME_MAX - 1);
+			}
+			cpuinfo_log_debug("integrated GPU %s, NPU %s", gpu->name, npu->name[0] != '\0' ? npu->name : "none");
+			return;
+		}
+	}
+}
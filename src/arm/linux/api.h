@@ -5,6 +5,7 @@
 
 #include <cpuinfo.h>
 #include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
 #include <arm/midr.h>
 #include <arm/api.h>
 #include <linux/api.h>
@@ -27,6 +28,7 @@
 		char ro_arch[CPUINFO_BUILD_PROP_VALUE_MAX];
 		char ro_chipname[CPUINFO_BUILD_PROP_VALUE_MAX];
 		char ro_hardware_chipname[CPUINFO_BUILD_PROP_VALUE_MAX];
+		char ro_build_fingerprint[CPUINFO_BUILD_PROP_VALUE_MAX];
 	};
 #endif
 
@@ -133,6 +135,16 @@ struct cpuinfo_arm_linux_proc_cpuinfo_cache {
 	#define CPUINFO_ARM_LINUX_FEATURE2_DGH        UINT32_C(0x00008000)
 	#define CPUINFO_ARM_LINUX_FEATURE2_RNG        UINT32_C(0x00010000)
 	#define CPUINFO_ARM_LINUX_FEATURE2_BTI        UINT32_C(0x00020000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_MTE        UINT32_C(0x00040000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_MTE3       UINT32_C(0x00400000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_SME        UINT32_C(0x00800000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_SME_I16I64 UINT32_C(0x01000000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_SME_F64F64 UINT32_C(0x02000000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_SME_FA64   UINT32_C(0x40000000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_WFXT       UINT32_C(0x80000000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_SME2       UINT64_C(0x0000002000000000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_LRCPC3     UINT64_C(0x0000400000000000)
+	#define CPUINFO_ARM_LINUX_FEATURE2_LSE128     UINT64_C(0x0000800000000000)
 #endif
 
 #define CPUINFO_ARM_LINUX_VALID_ARCHITECTURE UINT32_C(0x00010000)
@@ -203,8 +215,21 @@ struct cpuinfo_arm_linux_processor {
 	 * If failed to read or parse the file, the value is 0.
 	 */
 	uint32_t min_frequency;
+	/**
+	 * Capacity of the processor relative to the highest-capacity processor in the system, which has capacity 1024.
+	 * The value is parsed from /sys/devices/system/cpu/cpu<N>/cpu_capacity
+	 * If failed to read or parse the file, the value is 0.
+	 */
+	uint32_t capacity;
 	/** Linux processor ID */
 	uint32_t system_processor_id;
+	/**
+	 * Bitmask of /sys/devices/system/cpu/cpu<N>/cache/index<K> directories which were parsed for this processor,
+	 * either directly or as a sibling in shared_cpu_list of another processor.
+	 */
+	uint32_t sysfs_cache_indices;
+	/** Index plus one of the cache described in sysfs at every cache level, or 0 if sysfs describes no such cache */
+	uint32_t sysfs_cache[cpuinfo_cache_level_max];
 	uint32_t flags;
 };
 
@@ -220,6 +245,12 @@ static inline bool cpuinfo_arm_linux_processor_equals(
 {
 	const uint32_t joint_flags = processor_i->flags & processor_j->flags;
 
+	if (joint_flags & CPUINFO_LINUX_FLAG_CAPACITY) {
+		if (processor_i->capacity != processor_j->capacity) {
+			return false;
+		}
+	}
+
 	bool same_max_frequency = false;
 	if (joint_flags & CPUINFO_LINUX_FLAG_MAX_FREQUENCY) {
 		if (processor_i->max_frequency != processor_j->max_frequency) {
@@ -258,6 +289,12 @@ static inline bool cpuinfo_arm_linux_processor_not_equals(
 {
 	const uint32_t joint_flags = processor_i->flags & processor_j->flags;
 
+	if (joint_flags & CPUINFO_LINUX_FLAG_CAPACITY) {
+		if (processor_i->capacity != processor_j->capacity) {
+			return true;
+		}
+	}
+
 	if (joint_flags & CPUINFO_LINUX_FLAG_MAX_FREQUENCY) {
 		if (processor_i->max_frequency != processor_j->max_frequency) {
 			return true;
@@ -304,11 +341,11 @@ CPUINFO_INTERNAL bool cpuinfo_arm_linux_parse_proc_cpuinfo(
 #elif CPUINFO_ARCH_ARM64
 	CPUINFO_INTERNAL void cpuinfo_arm_linux_hwcap_from_getauxval(
 		uint32_t hwcap[restrict static 1],
-		uint32_t hwcap2[restrict static 1]);
+		uint64_t hwcap2[restrict static 1]);
 
 	CPUINFO_INTERNAL void cpuinfo_arm64_linux_decode_isa_from_proc_cpuinfo(
 		uint32_t features,
-		uint32_t features2,
+		uint64_t features2,
 		uint32_t midr,
 		const struct cpuinfo_arm_chipset chipset[restrict static 1],
 		struct cpuinfo_arm_isa isa[restrict static 1]);
@@ -329,6 +366,12 @@ CPUINFO_INTERNAL bool cpuinfo_arm_linux_parse_proc_cpuinfo(
 			uint32_t max_cpu_freq_max);
 #endif
 
+/* Map the decoded chipset to its integrated GPU and NPU, or zero them if the tables don't describe the chipset */
+CPUINFO_INTERNAL void cpuinfo_arm_linux_decode_accelerators(
+	const struct cpuinfo_arm_chipset chipset[restrict static 1],
+	struct cpuinfo_integrated_gpu gpu[restrict static 1],
+	struct cpuinfo_npu npu[restrict static 1]);
+
 CPUINFO_INTERNAL struct cpuinfo_arm_chipset
 	cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_hardware(
 		const char proc_cpuinfo_hardware[restrict static CPUINFO_HARDWARE_VALUE_MAX],
@@ -380,5 +423,4 @@ CPUINFO_INTERNAL uint32_t cpuinfo_arm_linux_detect_cluster_midr(
 	uint32_t usable_processors,
 	struct cpuinfo_arm_linux_processor processors[restrict static max_processors]);
 
-extern CPUINFO_INTERNAL const uint32_t* cpuinfo_linux_cpu_to_uarch_index_map;
 extern CPUINFO_INTERNAL uint32_t cpuinfo_linux_cpu_to_uarch_index_map_entries;
@@ -1753,6 +1753,310 @@ static bool is_tegra(const char* start, const char* end) {
 	return (length == 5 || start[5] == '3');
 }
 
+/* Platform identifiers which chipset signatures are matched against */
+#define CHIPSET_SOURCE_HARDWARE_WORD     UINT8_C(0x01) /* any word in /proc/cpuinfo Hardware string */
+#define CHIPSET_SOURCE_HARDWARE          UINT8_C(0x02) /* whole /proc/cpuinfo Hardware string */
+#define CHIPSET_SOURCE_RO_PRODUCT_BOARD  UINT8_C(0x04)
+#define CHIPSET_SOURCE_RO_BOARD_PLATFORM UINT8_C(0x08)
+#define CHIPSET_SOURCE_RO_CHIPNAME       UINT8_C(0x10)
+
+enum chipset_signature_matcher {
+	chipset_signature_matcher_msm_apq,
+	chipset_signature_matcher_sdm,
+	chipset_signature_matcher_sm,
+	chipset_signature_matcher_samsung_exynos,
+	chipset_signature_matcher_exynos,
+	chipset_signature_matcher_universal,
+	chipset_signature_matcher_smdk,
+	chipset_signature_matcher_mt,
+	chipset_signature_matcher_kirin,
+	chipset_signature_matcher_rk,
+	chipset_signature_matcher_sc,
+	chipset_signature_matcher_lc,
+	chipset_signature_matcher_pxa,
+	chipset_signature_matcher_bcm,
+	chipset_signature_matcher_omap,
+	chipset_signature_matcher_sunxi,
+	chipset_signature_matcher_wmt,
+	chipset_signature_matcher_tcc,
+};
+
+struct chipset_signature {
+	/* The first letter of the signature, in lower case */
+	char initial;
+	/* Parser of the signature, one of chipset_signature_matcher values */
+	uint8_t matcher;
+	/* Sources of platform identifiers the signature is matched against, combination of CHIPSET_SOURCE_* flags */
+	uint8_t sources;
+	/* Name of the signature in log messages */
+	const char* name;
+};
+
+/*
+ * Chipset signatures, dispatched by the first letter of the platform identifier.
+ * Signatures with the same initial letter are tried in the order of this table.
+ */
+static const struct chipset_signature chipset_signatures[] = {
+	{
+		.initial = 'm',
+		.matcher = chipset_signature_matcher_msm_apq,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD | CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_BOARD_PLATFORM |
+			CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "Qualcomm MSM/APQ",
+	},
+	{
+		.initial = 'a',
+		.matcher = chipset_signature_matcher_msm_apq,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD | CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_BOARD_PLATFORM |
+			CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "Qualcomm MSM/APQ",
+	},
+	{
+		.initial = 's',
+		.matcher = chipset_signature_matcher_sdm,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD,
+		.name = "Qualcomm SDM",
+	},
+	{
+		.initial = 's',
+		.matcher = chipset_signature_matcher_sm,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD | CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "Qualcomm SM",
+	},
+	{
+		.initial = 'm',
+		.matcher = chipset_signature_matcher_mt,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD | CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_BOARD_PLATFORM |
+			CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "MediaTek MT",
+	},
+	{
+		.initial = 'k',
+		.matcher = chipset_signature_matcher_kirin,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD | CHIPSET_SOURCE_RO_BOARD_PLATFORM,
+		.name = "HiSilicon Kirin",
+	},
+	{
+		.initial = 'r',
+		.matcher = chipset_signature_matcher_rk,
+		.sources = CHIPSET_SOURCE_HARDWARE_WORD | CHIPSET_SOURCE_RO_BOARD_PLATFORM,
+		.name = "Rockchip RK",
+	},
+	{
+		.initial = 's',
+		.matcher = chipset_signature_matcher_samsung_exynos,
+		.sources = CHIPSET_SOURCE_HARDWARE,
+		.name = "Samsung Exynos",
+	},
+	{
+		.initial = 'e',
+		.matcher = chipset_signature_matcher_exynos,
+		.sources = CHIPSET_SOURCE_RO_BOARD_PLATFORM | CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "exynosXXXX (Samsung Exynos)",
+	},
+	{
+		.initial = 'u',
+		.matcher = chipset_signature_matcher_universal,
+		.sources = CHIPSET_SOURCE_HARDWARE | CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "UNIVERSAL (Samsung Exynos)",
+	},
+#if CPUINFO_ARCH_ARM
+	{
+		.initial = 's',
+		.matcher = chipset_signature_matcher_smdk,
+		.sources = CHIPSET_SOURCE_HARDWARE | CHIPSET_SOURCE_RO_PRODUCT_BOARD,
+		.name = "SMDK (Samsung Exynos)",
+	},
+#endif /* CPUINFO_ARCH_ARM */
+	{
+		.initial = 's',
+		.matcher = chipset_signature_matcher_sc,
+		.sources = CHIPSET_SOURCE_HARDWARE | CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_BOARD_PLATFORM |
+			CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "Spreadtrum SC",
+	},
+#if CPUINFO_ARCH_ARM
+	{
+		.initial = 'p',
+		.matcher = chipset_signature_matcher_pxa,
+		.sources = CHIPSET_SOURCE_HARDWARE | CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_CHIPNAME,
+		.name = "Marvell PXA",
+	},
+	{
+		.initial = 'l',
+		.matcher = chipset_signature_matcher_lc,
+		.sources = CHIPSET_SOURCE_RO_PRODUCT_BOARD | CHIPSET_SOURCE_RO_BOARD_PLATFORM,
+		.name = "Leadcore LC",
+	},
+#endif /* CPUINFO_ARCH_ARM */
+	{
+		.initial = 's',
+		.matcher = chipset_signature_matcher_sunxi,
+		.sources = CHIPSET_SOURCE_HARDWARE,
+		.name = "sunxi (Allwinner Ax)",
+	},
+	{
+		.initial = 'b',
+		.matcher = chipset_signature_matcher_bcm,
+		.sources = CHIPSET_SOURCE_HARDWARE,
+		.name = "Broadcom BCM",
+	},
+#if CPUINFO_ARCH_ARM
+	{
+		.initial = 'o',
+		.matcher = chipset_signature_matcher_omap,
+		.sources = CHIPSET_SOURCE_HARDWARE,
+		.name = "Texas Instruments OMAP",
+	},
+	{
+		.initial = 'w',
+		.matcher = chipset_signature_matcher_wmt,
+		.sources = CHIPSET_SOURCE_HARDWARE,
+		.name = "WonderMedia WMT",
+	},
+#endif /* CPUINFO_ARCH_ARM */
+	{
+		.initial = 't',
+		.matcher = chipset_signature_matcher_tcc,
+		.sources = CHIPSET_SOURCE_HARDWARE,
+		.name = "Telechips TCC",
+	},
+};
+
+static bool match_signature(
+	enum chipset_signature_matcher matcher, const char* start, const char* end,
+	uint32_t cores, uint32_t max_cpu_freq_max,
+	struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	switch (matcher) {
+		case chipset_signature_matcher_msm_apq:
+			return match_msm_apq(start, end, chipset);
+		case chipset_signature_matcher_sdm:
+			return match_sdm(start, end, chipset);
+		case chipset_signature_matcher_sm:
+			return match_sm(start, end, chipset);
+		case chipset_signature_matcher_samsung_exynos:
+			return match_samsung_exynos(start, end, chipset);
+		case chipset_signature_matcher_exynos:
+			return match_exynos(start, end, chipset);
+		case chipset_signature_matcher_universal:
+			return match_universal(start, end, chipset);
+		case chipset_signature_matcher_mt:
+			return match_mt(start, end, true, chipset);
+		case chipset_signature_matcher_kirin:
+			return match_kirin(start, end, chipset);
+		case chipset_signature_matcher_rk:
+			return match_rk(start, end, chipset);
+		case chipset_signature_matcher_sc:
+			return match_sc(start, end, chipset);
+		case chipset_signature_matcher_bcm:
+			return match_bcm(start, end, chipset);
+		case chipset_signature_matcher_sunxi:
+			return match_and_parse_sunxi(start, end, cores, chipset);
+		case chipset_signature_matcher_tcc:
+			return match_tcc(start, end, chipset);
+#if CPUINFO_ARCH_ARM
+		case chipset_signature_matcher_smdk:
+			return match_and_parse_smdk(start, end, cores, chipset);
+		case chipset_signature_matcher_lc:
+			return match_lc(start, end, chipset);
+		case chipset_signature_matcher_pxa:
+			return match_pxa(start, end, chipset);
+		case chipset_signature_matcher_omap:
+			return match_omap(start, end, chipset);
+		case chipset_signature_matcher_wmt:
+			return match_and_parse_wmt(start, end, cores, max_cpu_freq_max, chipset);
+#endif /* CPUINFO_ARCH_ARM */
+		default:
+			return false;
+	}
+}
+
+/*
+ * Matches a platform identifier against the chipset signatures which start with the same letter.
+ * Only signatures which apply to the \p source of the identifier are considered.
+ *
+ * @param start - start of the platform identifier to match.
+ * @param end - end of the platform identifier to match.
+ * @param source - source of the platform identifier, one of CHIPSET_SOURCE_* flags.
+ * @param cores - number of cores in the chipset.
+ * @param max_cpu_freq_max - maximum of /sys/devices/system/cpu/cpu<number>/cpofreq/cpu_freq_max values.
+ * @param[out] chipset - location where chipset information will be stored upon a successful match.
+ *
+ * @returns The matched signature, or NULL if no signature matched.
+ */
+static const struct chipset_signature* match_chipset_signature(
+	const char* start, const char* end, uint8_t source,
+	uint32_t cores, uint32_t max_cpu_freq_max,
+	struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	if (start == end || !is_ascii_alphabetic(*start)) {
+		return NULL;
+	}
+
+	const char initial = *start | '\x20';
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(chipset_signatures); i++) {
+		const struct chipset_signature* signature = &chipset_signatures[i];
+		if (signature->initial == initial && (signature->sources & source) != 0 &&
+			match_signature(signature->matcher, start, end, cores, max_cpu_freq_max, chipset))
+		{
+			return signature;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Matches a platform identifier against the chipsets registered with cpuinfo_register_chipset_table.
+ *
+ * @param start - start of the platform identifier to match.
+ * @param end - end of the platform identifier to match.
+ * @param[out] chipset - location where chipset information will be stored upon a successful match.
+ *
+ * @returns true if a registered chipset matched, false otherwise.
+ */
+static bool match_registered_chipset(
+	const char* start, const char* end,
+	struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	const struct cpuinfo_chipset_table_entry* entry = cpuinfo_find_chipset_table_entry(start, (size_t) (end - start));
+	if (entry == NULL) {
+		return false;
+	}
+	cpuinfo_log_debug("matched registered chipset \"%s\" for platform identifier \"%.*s\"",
+		entry->name, (int) (end - start), start);
+	/* Names of the entries are validated on registration */
+	return cpuinfo_arm_chipset_from_string(entry->name, strlen(entry->name), chipset);
+}
+
+/*
+ * Matches every word of /proc/cpuinfo Hardware string against the chipsets registered with
+ * cpuinfo_register_chipset_table, in a single pass over the string.
+ *
+ * @param[in] hardware - /proc/cpuinfo Hardware string.
+ * @param[out] chipset - location where chipset information will be stored upon a successful match.
+ *
+ * @returns true if a registered chipset matched a word, false otherwise.
+ */
+static bool match_registered_chipset_in_hardware(
+	const char hardware[restrict static CPUINFO_HARDWARE_VALUE_MAX],
+	struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	const char* hardware_end = hardware + strnlen(hardware, CPUINFO_HARDWARE_VALUE_MAX);
+	const char* word_start = hardware;
+	for (const char* pos = hardware; ; pos++) {
+		if (pos == hardware_end || *pos == ' ' || *pos == '\t' || *pos == ',') {
+			if (pos != word_start && match_registered_chipset(word_start, pos, chipset)) {
+				return true;
+			}
+			if (pos == hardware_end) {
+				return false;
+			}
+			word_start = pos + 1;
+		}
+	}
+}
+
 struct special_map_entry {
 	const char* platform;
 	uint16_t model;
@@ -2271,51 +2575,13 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 					break;
 				default:
 					if (word_start && is_ascii_alphabetic(c)) {
-						/* Check Qualcomm MSM/APQ signature */
-						if (match_msm_apq(pos, hardware_end, &chipset)) {
-							cpuinfo_log_debug(
-								"matched Qualcomm MSM/APQ signature in /proc/cpuinfo Hardware string \"%.*s\"",
-								(int) hardware_length, hardware);
-							return chipset;
-						}
-
-						/* Check SDMxxx (Qualcomm Snapdragon) signature */
-						if (match_sdm(pos, hardware_end, &chipset)) {
-							cpuinfo_log_debug(
-								"matched Qualcomm SDM signature in /proc/cpuinfo Hardware string \"%.*s\"",
-								(int) hardware_length, hardware);
-							return chipset;
-						}
-
-						/* Check SMxxxx (Qualcomm Snapdragon) signature */
-						if (match_sm(pos, hardware_end, &chipset)) {
+						/* Check signatures which may appear in any word of the string */
+						const struct chipset_signature* signature = match_chipset_signature(
+							pos, hardware_end, CHIPSET_SOURCE_HARDWARE_WORD, cores, max_cpu_freq_max, &chipset);
+						if (signature != NULL) {
 							cpuinfo_log_debug(
-								"matched Qualcomm SM signature in /proc/cpuinfo Hardware string \"%.*s\"",
-								(int) hardware_length, hardware);
-							return chipset;
-						}
-
-						/* Check MediaTek MT signature */
-						if (match_mt(pos, hardware_end, true, &chipset)) {
-							cpuinfo_log_debug(
-								"matched MediaTek MT signature in /proc/cpuinfo Hardware string \"%.*s\"",
-								(int) hardware_length, hardware);
-							return chipset;
-						}
-
-						/* Check HiSilicon Kirin signature */
-						if (match_kirin(pos, hardware_end, &chipset)) {
-							cpuinfo_log_debug(
-								"matched HiSilicon Kirin signature in /proc/cpuinfo Hardware string \"%.*s\"",
-								(int) hardware_length, hardware);
-							return chipset;
-						}
-
-						/* Check Rockchip RK signature */
-						if (match_rk(pos, hardware_end, &chipset)) {
-							cpuinfo_log_debug(
-								"matched Rockchip RK signature in /proc/cpuinfo Hardware string \"%.*s\"",
-								(int) hardware_length, hardware);
+								"matched %s signature in /proc/cpuinfo Hardware string \"%.*s\"",
+								signature->name, (int) hardware_length, hardware);
 							return chipset;
 						}
 					}
@@ -2324,90 +2590,13 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 			}
 		}
 
-		/* Check Samsung Exynos signature */
-		if (match_samsung_exynos(hardware, hardware_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Samsung Exynos signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) hardware_length, hardware);
-			return chipset;
-		}
-
-		/* Check universalXXXX (Samsung Exynos) signature */
-		if (match_universal(hardware, hardware_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched UNIVERSAL (Samsung Exynos) signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) hardware_length, hardware);
-			return chipset;
-		}
-
-		#if CPUINFO_ARCH_ARM
-			/* Match /SMDK(4410|4x12)$/ */
-			if (match_and_parse_smdk(hardware, hardware_end, cores, &chipset)) {
-				cpuinfo_log_debug(
-					"matched SMDK (Samsung Exynos) signature in /proc/cpuinfo Hardware string \"%.*s\"",
-					(int) hardware_length, hardware);
-				return chipset;
-			}
-		#endif
-
-		/* Check Spreadtrum SC signature */
-		if (match_sc(hardware, hardware_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Spreadtrum SC signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) hardware_length, hardware);
-			return chipset;
-		}
-
-		#if CPUINFO_ARCH_ARM
-			/* Check Marvell PXA signature */
-			if (match_pxa(hardware, hardware_end, &chipset)) {
-				cpuinfo_log_debug(
-					"matched Marvell PXA signature in /proc/cpuinfo Hardware string \"%.*s\"",
-					(int) hardware_length, hardware);
-				return chipset;
-			}
-		#endif
-
-		/* Match /sun\d+i/ signature and map to Allwinner chipset name */
-		if (match_and_parse_sunxi(hardware, hardware_end, cores, &chipset)) {
-			cpuinfo_log_debug(
-				"matched sunxi (Allwinner Ax) signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) hardware_length, hardware);
-			return chipset;
-		}
-
-		/* Check Broadcom BCM signature */
-		if (match_bcm(hardware, hardware_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Broadcom BCM signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) hardware_length, hardware);
-			return chipset;
-		}
-
-		#if CPUINFO_ARCH_ARM
-			/* Check Texas Instruments OMAP signature */
-			if (match_omap(hardware, hardware_end, &chipset)) {
-				cpuinfo_log_debug(
-					"matched Texas Instruments OMAP signature in /proc/cpuinfo Hardware string \"%.*s\"",
-					(int) hardware_length, hardware);
-				return chipset;
-			}
-
-			/* Check WonderMedia WMT signature and decode chipset from frequency and number of cores  */
-			if (match_and_parse_wmt(hardware, hardware_end, cores, max_cpu_freq_max, &chipset)) {
-				cpuinfo_log_debug(
-					"matched WonderMedia WMT signature in /proc/cpuinfo Hardware string \"%.*s\"",
-					(int) hardware_length, hardware);
-				return chipset;
-			}
-
-		#endif
-
-		/* Check Telechips TCC signature */
-		if (match_tcc(hardware, hardware_end, &chipset)) {
+		/* Check signatures of the whole string */
+		const struct chipset_signature* signature = match_chipset_signature(
+			hardware, hardware_end, CHIPSET_SOURCE_HARDWARE, cores, max_cpu_freq_max, &chipset);
+		if (signature != NULL) {
 			cpuinfo_log_debug(
-				"matched Telechips TCC signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) hardware_length, hardware);
+				"matched %s signature in /proc/cpuinfo Hardware string \"%.*s\"",
+				signature->name, (int) hardware_length, hardware);
 			return chipset;
 		}
 
@@ -2580,64 +2769,17 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 		const size_t board_length = strnlen(ro_product_board, CPUINFO_BUILD_PROP_VALUE_MAX);
 		const char* board_end = ro_product_board + board_length;
 
-		/* Check Qualcomm MSM/APQ signature */
-		if (match_msm_apq(board, board_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Qualcomm MSM/APQ signature in ro.product.board string \"%.*s\"", (int) board_length, board);
-			return chipset;
-		}
-
-		/* Check universaXXXX (Samsung Exynos) signature */
-		if (match_universal(board, board_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched UNIVERSAL (Samsung Exynos) signature in ro.product.board string \"%.*s\"",
-				(int) board_length, board);
-			return chipset;
-		}
-
-		#if CPUINFO_ARCH_ARM
-			/* Check SMDK (Samsung Exynos) signature */
-			if (match_and_parse_smdk(board, board_end, cores, &chipset)) {
-				cpuinfo_log_debug(
-					"matched SMDK (Samsung Exynos) signature in ro.product.board string \"%.*s\"",
-					(int) board_length, board);
-				return chipset;
-			}
-		#endif
-
-		/* Check MediaTek MT signature */
-		if (match_mt(board, board_end, true, &chipset)) {
-			cpuinfo_log_debug(
-				"matched MediaTek MT signature in ro.product.board string \"%.*s\"",
-				(int) board_length, board);
-			return chipset;
-		}
-
-		/* Check Spreadtrum SC signature */
-		if (match_sc(board, board_end, &chipset)) {
+		/* Check vendor signatures */
+		const struct chipset_signature* signature = match_chipset_signature(
+			board, board_end, CHIPSET_SOURCE_RO_PRODUCT_BOARD, cores, max_cpu_freq_max, &chipset);
+		if (signature != NULL) {
 			cpuinfo_log_debug(
-				"matched Spreadtrum SC signature in ro.product.board string \"%.*s\"",
-				(int) board_length, board);
+				"matched %s signature in ro.product.board string \"%.*s\"",
+				signature->name, (int) board_length, board);
 			return chipset;
 		}
 
 		#if CPUINFO_ARCH_ARM
-			/* Check Marvell PXA signature */
-			if (match_pxa(board, board_end, &chipset)) {
-				cpuinfo_log_debug(
-					"matched Marvell PXA signature in ro.product.board string \"%.*s\"",
-					(int) board_length, board);
-				return chipset;
-			}
-
-			/* Check Leadcore LCxxxx signature */
-			if (match_lc(board, board_end, &chipset)) {
-				cpuinfo_log_debug(
-					"matched Leadcore LC signature in ro.product.board string \"%.*s\"",
-					(int) board_length, board);
-				return chipset;
-			}
-
 			/*
 			 * Compare to tabulated ro.product.board values for Broadcom chipsets and decode chipset from frequency and
 			 * number of cores.
@@ -2867,59 +3009,16 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 		const size_t platform_length = strnlen(platform, CPUINFO_BUILD_PROP_VALUE_MAX);
 		const char* platform_end = platform + platform_length;
 
-		/* Check Qualcomm MSM/APQ signature */
-		if (match_msm_apq(platform, platform_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Qualcomm MSM/APQ signature in ro.board.platform string \"%.*s\"",
-				(int) platform_length, platform);
-			return chipset;
-		}
-
-		/* Check exynosXXXX (Samsung Exynos) signature */
-		if (match_exynos(platform, platform_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched exynosXXXX (Samsung Exynos) signature in ro.board.platform string \"%.*s\"",
-				(int) platform_length, platform);
-			return chipset;
-		}
-
-		/* Check MediaTek MT signature */
-		if (match_mt(platform, platform_end, true, &chipset)) {
-			cpuinfo_log_debug(
-				"matched MediaTek MT signature in ro.board.platform string \"%.*s\"", (int) platform_length, platform);
-			return chipset;
-		}
-
-		/* Check HiSilicon Kirin signature */
-		if (match_kirin(platform, platform_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched HiSilicon Kirin signature in ro.board.platform string \"%.*s\"", (int) platform_length, platform);
-			return chipset;
-		}
-
-		/* Check Spreadtrum SC signature */
-		if (match_sc(platform, platform_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Spreadtrum SC signature in ro.board.platform string \"%.*s\"", (int) platform_length, platform);
-			return chipset;
-		}
-
-		/* Check Rockchip RK signature */
-		if (match_rk(platform, platform_end, &chipset)) {
+		/* Check vendor signatures */
+		const struct chipset_signature* signature = match_chipset_signature(
+			platform, platform_end, CHIPSET_SOURCE_RO_BOARD_PLATFORM, cores, max_cpu_freq_max, &chipset);
+		if (signature != NULL) {
 			cpuinfo_log_debug(
-				"matched Rockchip RK signature in ro.board.platform string \"%.*s\"", (int) platform_length, platform);
+				"matched %s signature in ro.board.platform string \"%.*s\"",
+				signature->name, (int) platform_length, platform);
 			return chipset;
 		}
 
-		#if CPUINFO_ARCH_ARM
-			/* Check Leadcore LCxxxx signature */
-			if (match_lc(platform, platform_end, &chipset)) {
-				cpuinfo_log_debug(
-					"matched Leadcore LC signature in ro.board.platform string \"%.*s\"", (int) platform_length, platform);
-				return chipset;
-			}
-		#endif
-
 		/* Compare to tabulated ro.board.platform values for Huawei devices which don't report chipset elsewhere */
 		if (match_and_parse_huawei(platform, platform_end, &chipset)) {
 			cpuinfo_log_debug(
@@ -3079,63 +3178,17 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 		const size_t chipname_length = strnlen(chipname, CPUINFO_BUILD_PROP_VALUE_MAX);
 		const char* chipname_end = chipname + chipname_length;
 
-		/* Check Qualcomm MSM/APQ signatures */
-		if (match_msm_apq(chipname, chipname_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Qualcomm MSM/APQ signature in ro.chipname string \"%.*s\"",
-				(int) chipname_length, chipname);
-			return chipset;
-		}
-
-		/* Check SMxxxx (Qualcomm Snapdragon) signature */
-		if (match_sm(chipname, chipname_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched Qualcomm SM signature in /proc/cpuinfo Hardware string \"%.*s\"",
-				(int) chipname_length, chipname);
-			return chipset;
-		}
-
-		/* Check exynosXXXX (Samsung Exynos) signature */
-		if (match_exynos(chipname, chipname_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched exynosXXXX (Samsung Exynos) signature in ro.chipname string \"%.*s\"",
-				(int) chipname_length, chipname);
-			return chipset;
-		}
-
-		/* Check universalXXXX (Samsung Exynos) signature */
-		if (match_universal(chipname, chipname_end, &chipset)) {
-			cpuinfo_log_debug(
-				"matched UNIVERSAL (Samsung Exynos) signature in ro.chipname Hardware string \"%.*s\"",
-				(int) chipname_length, chipname);
-			return chipset;
-		}
-
-		/* Check MediaTek MT signature */
-		if (match_mt(chipname, chipname_end, true, &chipset)) {
-			cpuinfo_log_debug(
-				"matched MediaTek MT signature in ro.chipname string \"%.*s\"",
-				(int) chipname_length, chipname);
-			return chipset;
-		}
-
-		/* Check Spreadtrum SC signature */
-		if (match_sc(chipname, chipname_end, &chipset)) {
+		/* Check vendor signatures */
+		const struct chipset_signature* signature = match_chipset_signature(
+			chipname, chipname_end, CHIPSET_SOURCE_RO_CHIPNAME, 0, 0, &chipset);
+		if (signature != NULL) {
 			cpuinfo_log_debug(
-				"matched Spreadtrum SC signature in ro.chipname string \"%.*s\"",
-				(int) chipname_length, chipname);
+				"matched %s signature in ro.chipname string \"%.*s\"",
+				signature->name, (int) chipname_length, chipname);
 			return chipset;
 		}
 
 		#if CPUINFO_ARCH_ARM
-			/* Check Marvell PXA signature */
-			if (match_pxa(chipname, chipname_end, &chipset)) {
-				cpuinfo_log_debug(
-					"matched Marvell PXA signature in ro.chipname string \"%.*s\"",
-					(int) chipname_length, chipname);
-				return chipset;
-			}
-
 			/* Compare to ro.chipname value ("mp523x") for Renesas MP5232 which can't be otherwise detected */
 			if (chipname_length == 6 && memcmp(chipname, "mp523x", 6) == 0) {
 				cpuinfo_log_debug(
@@ -3157,6 +3210,190 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 	}
 #endif /* __ANDROID__ */
 
+/* Map from ARM chipset vendor ID to its string representation */
+static const char* chipset_vendor_string[cpuinfo_arm_chipset_vendor_max] = {
+	[cpuinfo_arm_chipset_vendor_unknown]           = "Unknown",
+	[cpuinfo_arm_chipset_vendor_qualcomm]          = "Qualcomm",
+	[cpuinfo_arm_chipset_vendor_mediatek]          = "MediaTek",
+	[cpuinfo_arm_chipset_vendor_samsung]           = "Samsung",
+	[cpuinfo_arm_chipset_vendor_hisilicon]         = "HiSilicon",
+	[cpuinfo_arm_chipset_vendor_actions]           = "Actions",
+	[cpuinfo_arm_chipset_vendor_allwinner]         = "Allwinner",
+	[cpuinfo_arm_chipset_vendor_amlogic]           = "Amlogic",
+	[cpuinfo_arm_chipset_vendor_broadcom]          = "Broadcom",
+	[cpuinfo_arm_chipset_vendor_lg]                = "LG",
+	[cpuinfo_arm_chipset_vendor_leadcore]          = "Leadcore",
+	[cpuinfo_arm_chipset_vendor_marvell]           = "Marvell",
+	[cpuinfo_arm_chipset_vendor_mstar]             = "MStar",
+	[cpuinfo_arm_chipset_vendor_novathor]          = "NovaThor",
+	[cpuinfo_arm_chipset_vendor_nvidia]            = "Nvidia",
+	[cpuinfo_arm_chipset_vendor_pinecone]          = "Pinecone",
+	[cpuinfo_arm_chipset_vendor_renesas]           = "Renesas",
+	[cpuinfo_arm_chipset_vendor_rockchip]          = "Rockchip",
+	[cpuinfo_arm_chipset_vendor_spreadtrum]        = "Spreadtrum",
+	[cpuinfo_arm_chipset_vendor_telechips]         = "Telechips",
+	[cpuinfo_arm_chipset_vendor_texas_instruments] = "Texas Instruments",
+	[cpuinfo_arm_chipset_vendor_wondermedia]       = "WonderMedia",
+};
+
+/* Map from ARM chipset series ID to its string representation */
+static const char* chipset_series_string[cpuinfo_arm_chipset_series_max] = {
+	[cpuinfo_arm_chipset_series_unknown]                = NULL,
+	[cpuinfo_arm_chipset_series_qualcomm_qsd]           = "QSD",
+	[cpuinfo_arm_chipset_series_qualcomm_msm]           = "MSM",
+	[cpuinfo_arm_chipset_series_qualcomm_apq]           = "APQ",
+	[cpuinfo_arm_chipset_series_qualcomm_snapdragon]    = "Snapdragon ",
+	[cpuinfo_arm_chipset_series_mediatek_mt]            = "MT",
+	[cpuinfo_arm_chipset_series_samsung_exynos]         = "Exynos ",
+	[cpuinfo_arm_chipset_series_hisilicon_k3v]          = "K3V",
+	[cpuinfo_arm_chipset_series_hisilicon_hi]           = "Hi",
+	[cpuinfo_arm_chipset_series_hisilicon_kirin]        = "Kirin ",
+	[cpuinfo_arm_chipset_series_actions_atm]            = "ATM",
+	[cpuinfo_arm_chipset_series_allwinner_a]            = "A",
+	[cpuinfo_arm_chipset_series_amlogic_aml]            = "AML",
+	[cpuinfo_arm_chipset_series_amlogic_s]              = "S",
+	[cpuinfo_arm_chipset_series_broadcom_bcm]           = "BCM",
+	[cpuinfo_arm_chipset_series_lg_nuclun]              = "Nuclun ",
+	[cpuinfo_arm_chipset_series_leadcore_lc]            = "LC",
+	[cpuinfo_arm_chipset_series_marvell_pxa]            = "PXA",
+	[cpuinfo_arm_chipset_series_mstar_6a]               = "6A",
+	[cpuinfo_arm_chipset_series_novathor_u]             = "U",
+	[cpuinfo_arm_chipset_series_nvidia_tegra_t]         = "Tegra T",
+	[cpuinfo_arm_chipset_series_nvidia_tegra_ap]        = "Tegra AP",
+	[cpuinfo_arm_chipset_series_nvidia_tegra_sl]        = "Tegra SL",
+	[cpuinfo_arm_chipset_series_pinecone_surge_s]       = "Surge S",
+	[cpuinfo_arm_chipset_series_renesas_mp]             = "MP",
+	[cpuinfo_arm_chipset_series_rockchip_rk]            = "RK",
+	[cpuinfo_arm_chipset_series_spreadtrum_sc]          = "SC",
+	[cpuinfo_arm_chipset_series_telechips_tcc]          = "TCC",
+	[cpuinfo_arm_chipset_series_texas_instruments_omap] = "OMAP",
+	[cpuinfo_arm_chipset_series_wondermedia_wm]         = "WM",
+};
+
+struct chipset_fixup_entry {
+	/* Reported chipset model */
+	uint16_t model;
+	/* Model the chipset is reinterpreted as */
+	uint16_t fixed_model;
+	/* Reported chipset series */
+	uint8_t series;
+	/* Series the chipset is reinterpreted as */
+	uint8_t fixed_series;
+	/* Number of cores in the reported chipset, or 0 if the chipset is reinterpreted regardless of the number of cores */
+	uint8_t cores;
+	/* Number of cores in the chipset the reported chipset is reinterpreted as */
+	uint8_t fixed_cores;
+	/* Whether the fixup applies only to chipsets reported without suffix */
+	bool no_suffix;
+};
+
+/* Renames and common misreports of chipset models, detected from the number of cores */
+static const struct chipset_fixup_entry chipset_fixup_entries[] = {
+	{
+		/* MSM8216 was renamed to MSM8916 */
+		.series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.model = 8216,
+		.fixed_series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.fixed_model = 8916,
+		.no_suffix = true,
+	},
+	{
+		/* Common bug: MSM8939 (Octa-core) reported as MSM8916 (Quad-core) */
+		.series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.model = 8916,
+		.cores = 4,
+		.fixed_series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.fixed_model = 8939,
+		.fixed_cores = 8,
+		.no_suffix = true,
+	},
+	{
+		/* Common bug: MSM8917 (Quad-core) reported as MSM8937 (Octa-core) */
+		.series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.model = 8937,
+		.cores = 8,
+		.fixed_series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.fixed_model = 8917,
+		.fixed_cores = 4,
+		.no_suffix = true,
+	},
+	{
+		/* Common bug: APQ8064 (Quad-core) reported as MSM8960 (Dual-core) */
+		.series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.model = 8960,
+		.cores = 2,
+		.fixed_series = cpuinfo_arm_chipset_series_qualcomm_apq,
+		.fixed_model = 8064,
+		.fixed_cores = 4,
+		.no_suffix = true,
+	},
+	{
+		/* Common bug: MSM8994 (Octa-core) reported as MSM8996 (Quad-core) */
+		.series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.model = 8996,
+		.cores = 4,
+		.fixed_series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.fixed_model = 8994,
+		.fixed_cores = 8,
+		.no_suffix = true,
+	},
+#if CPUINFO_ARCH_ARM
+	{
+		/* Common bug: MSM8612 (Quad-core) reported as MSM8610 (Dual-core) */
+		.series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.model = 8610,
+		.cores = 2,
+		.fixed_series = cpuinfo_arm_chipset_series_qualcomm_msm,
+		.fixed_model = 8612,
+		.fixed_cores = 4,
+		.no_suffix = true,
+	},
+	{
+		/* Exynos 4410 was renamed to Exynos 4412 */
+		.series = cpuinfo_arm_chipset_series_samsung_exynos,
+		.model = 4410,
+		.fixed_series = cpuinfo_arm_chipset_series_samsung_exynos,
+		.fixed_model = 4412,
+	},
+	{
+		/* Common bug: Exynos 5260 (Hexa-core) reported as Exynos 5420 (Quad-core) */
+		.series = cpuinfo_arm_chipset_series_samsung_exynos,
+		.model = 5420,
+		.cores = 4,
+		.fixed_series = cpuinfo_arm_chipset_series_samsung_exynos,
+		.fixed_model = 5260,
+		.fixed_cores = 6,
+	},
+#endif /* CPUINFO_ARCH_ARM */
+	{
+		/* Common bug: Exynos 7578 (Quad-core) reported as Exynos 7580 (Octa-core) */
+		.series = cpuinfo_arm_chipset_series_samsung_exynos,
+		.model = 7580,
+		.cores = 8,
+		.fixed_series = cpuinfo_arm_chipset_series_samsung_exynos,
+		.fixed_model = 7578,
+		.fixed_cores = 4,
+	},
+	{
+		/* Common bug: MT6732 (Quad-core) reported as MT6752 (Octa-core) */
+		.series = cpuinfo_arm_chipset_series_mediatek_mt,
+		.model = 6752,
+		.cores = 8,
+		.fixed_series = cpuinfo_arm_chipset_series_mediatek_mt,
+		.fixed_model = 6732,
+		.fixed_cores = 4,
+	},
+	{
+		/* Common bug: Rockchip RK3399 (Hexa-core) always reported as RK3288 (Quad-core) */
+		.series = cpuinfo_arm_chipset_series_rockchip_rk,
+		.model = 3288,
+		.cores = 4,
+		.fixed_series = cpuinfo_arm_chipset_series_rockchip_rk,
+		.fixed_model = 3399,
+		.fixed_cores = 6,
+	},
+};
+
 /*
  * Fix common bugs, typos, and renames in chipset name.
  *
@@ -3167,98 +3404,41 @@ struct cpuinfo_arm_chipset cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_ha
 void cpuinfo_arm_fixup_chipset(
 	struct cpuinfo_arm_chipset chipset[restrict static 1], uint32_t cores, uint32_t max_cpu_freq_max)
 {
+	/* Fix renamed and misreported models */
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(chipset_fixup_entries); i++) {
+		const struct chipset_fixup_entry* entry = &chipset_fixup_entries[i];
+		if (chipset->series != entry->series || chipset->model != entry->model ||
+			(entry->no_suffix && chipset->suffix[0] != 0))
+		{
+			continue;
+		}
+
+		const char* series_string = chipset_series_string[entry->series];
+		const char* fixed_series_string = chipset_series_string[entry->fixed_series];
+		if (entry->cores == 0) {
+			cpuinfo_log_info("reinterpreted %s%"PRIu32" chipset as %s%"PRIu32,
+				series_string, chipset->model, fixed_series_string, (uint32_t) entry->fixed_model);
+		} else if (cores == entry->fixed_cores) {
+			cpuinfo_log_info("reinterpreted %s%"PRIu32" chipset with %"PRIu32" cores as %s%"PRIu32,
+				series_string, chipset->model, cores, fixed_series_string, (uint32_t) entry->fixed_model);
+		} else {
+			if (cores != entry->cores) {
+				cpuinfo_log_warning("system reported invalid %"PRIu32"-core %s%"PRIu32" chipset",
+					cores, series_string, chipset->model);
+				chipset->model = 0;
+			}
+			break;
+		}
+		chipset->series = (enum cpuinfo_arm_chipset_series) entry->fixed_series;
+		chipset->model = entry->fixed_model;
+		break;
+	}
+
+	/* Normalize suffixes */
 	switch (chipset->series) {
 		case cpuinfo_arm_chipset_series_qualcomm_msm:
-			/* Check if there is suffix */
-			if (chipset->suffix[0] == 0) {
-				/* No suffix, but the model may be misreported */
-				switch (chipset->model) {
-					case 8216:
-						/* MSM8216 was renamed to MSM8916 */
-						cpuinfo_log_info("reinterpreted MSM8216 chipset as MSM8916");
-						chipset->model = 8916;
-						break;
-					case 8916:
-						/* Common bug: MSM8939 (Octa-core) reported as MSM8916 (Quad-core) */
-						switch (cores) {
-							case 4:
-								break;
-							case 8:
-								cpuinfo_log_info("reinterpreted MSM8916 chipset with 8 cores as MSM8939");
-								chipset->model = 8939;
-								break;
-							default:
-								cpuinfo_log_warning("system reported invalid %"PRIu32"-core MSM%"PRIu32" chipset",
-									cores, chipset->model);
-								chipset->model = 0;
-						}
-						break;
-					case 8937:
-						/* Common bug: MSM8917 (Quad-core) reported as MSM8937 (Octa-core) */
-						switch (cores) {
-							case 4:
-								cpuinfo_log_info("reinterpreted MSM8937 chipset with 4 cores as MSM8917");
-								chipset->model = 8917;
-								break;
-							case 8:
-								break;
-							default:
-								cpuinfo_log_warning("system reported invalid %"PRIu32"-core MSM%"PRIu32" chipset",
-									cores, chipset->model);
-								chipset->model = 0;
-						}
-						break;
-					case 8960:
-						/* Common bug: APQ8064 (Quad-core) reported as MSM8960 (Dual-core) */
-						switch (cores) {
-							case 2:
-								break;
-							case 4:
-								cpuinfo_log_info("reinterpreted MSM8960 chipset with 4 cores as APQ8064");
-								chipset->series = cpuinfo_arm_chipset_series_qualcomm_apq;
-								chipset->model = 8064;
-								break;
-							default:
-								cpuinfo_log_warning("system reported invalid %"PRIu32"-core MSM%"PRIu32" chipset",
-									cores, chipset->model);
-								chipset->model = 0;
-						}
-						break;
-					case 8996:
-						/* Common bug: MSM8994 (Octa-core) reported as MSM8996 (Quad-core) */
-						switch (cores) {
-							case 4:
-								break;
-							case 8:
-								cpuinfo_log_info("reinterpreted MSM8996 chipset with 8 cores as MSM8994");
-								chipset->model = 8994;
-								break;
-							default:
-								cpuinfo_log_warning("system reported invalid %"PRIu32"-core MSM%"PRIu32" chipset",
-									cores, chipset->model);
-								chipset->model = 0;
-						}
-						break;
-#if CPUINFO_ARCH_ARM
-					case 8610:
-						/* Common bug: MSM8612 (Quad-core) reported as MSM8610 (Dual-core) */
-						switch (cores) {
-							case 2:
-								break;
-							case 4:
-								cpuinfo_log_info("reinterpreted MSM8610 chipset with 4 cores as MSM8612");
-								chipset->model = 8612;
-								break;
-							default:
-								cpuinfo_log_warning("system reported invalid %"PRIu32"-core MSM%"PRIu32" chipset",
-									cores, chipset->model);
-								chipset->model = 0;
-						}
-						break;
-#endif /* CPUINFO_ARCH_ARM */
-				}
-			} else {
-				/* Suffix may need correction */
+			/* Suffix may need correction */
+			if (chipset->suffix[0] != 0) {
 				const uint32_t suffix_word = load_u32le(chipset->suffix);
 				if (suffix_word == UINT32_C(0x004D534D) /* "\0MSM" = reverse("MSM\0") */) {
 					/*
@@ -3305,59 +3485,7 @@ void cpuinfo_arm_fixup_chipset(
 			}
 			break;
 		}
-		case cpuinfo_arm_chipset_series_samsung_exynos:
-			switch (chipset->model) {
-#if CPUINFO_ARCH_ARM
-				case 4410:
-					/* Exynos 4410 was renamed to Exynos 4412 */
-					chipset->model = 4412;
-					break;
-				case 5420:
-					/* Common bug: Exynos 5260 (Hexa-core) reported as Exynos 5420 (Quad-core) */
-					switch (cores) {
-						case 4:
-							break;
-						case 6:
-							cpuinfo_log_info("reinterpreted Exynos 5420 chipset with 6 cores as Exynos 5260");
-							chipset->model = 5260;
-							break;
-						default:
-							cpuinfo_log_warning("system reported invalid %"PRIu32"-core Exynos 5420 chipset", cores);
-							chipset->model = 0;
-					}
-					break;
-#endif /* CPUINFO_ARCH_ARM */
-				case 7580:
-					/* Common bug: Exynos 7578 (Quad-core) reported as Exynos 7580 (Octa-core) */
-					switch (cores) {
-						case 4:
-							cpuinfo_log_info("reinterpreted Exynos 7580 chipset with 4 cores as Exynos 7578");
-							chipset->model = 7578;
-							break;
-						case 8:
-							break;
-						default:
-							cpuinfo_log_warning("system reported invalid %"PRIu32"-core Exynos 7580 chipset", cores);
-							chipset->model = 0;
-					}
-					break;
-			}
-			break;
 		case cpuinfo_arm_chipset_series_mediatek_mt:
-			if (chipset->model == 6752) {
-				/* Common bug: MT6732 (Quad-core) reported as MT6752 (Octa-core) */
-				switch (cores) {
-					case 4:
-						cpuinfo_log_info("reinterpreted MT6752 chipset with 4 cores as MT6732");
-						chipset->model = 6732;
-						break;
-					case 8:
-						break;
-					default:
-						cpuinfo_log_warning("system reported invalid %"PRIu32"-core MT6752 chipset", cores);
-						chipset->model = 0;
-				}
-			}
 			if (chipset->suffix[0] == 'T') {
 				/* Normalization: "TURBO" and "TRUBO" (apparently a typo) -> "T" */
 				const uint32_t suffix_word = load_u32le(chipset->suffix + 1);
@@ -3374,87 +3502,11 @@ void cpuinfo_arm_fixup_chipset(
 				}
 			}
 			break;
-		case cpuinfo_arm_chipset_series_rockchip_rk:
-			if (chipset->model == 3288) {
-				/* Common bug: Rockchip RK3399 (Hexa-core) always reported as RK3288 (Quad-core) */
-				switch (cores) {
-					case 4:
-						break;
-					case 6:
-						cpuinfo_log_info("reinterpreted RK3288 chipset with 6 cores as RK3399");
-						chipset->model = 3399;
-						break;
-					default:
-						cpuinfo_log_warning("system reported invalid %"PRIu32"-core RK3288 chipset", cores);
-						chipset->model = 0;
-				}
-			}
-			break;
 		default:
 			break;
 	}
 }
 
-/* Map from ARM chipset vendor ID to its string representation */
-static const char* chipset_vendor_string[cpuinfo_arm_chipset_vendor_max] = {
-	[cpuinfo_arm_chipset_vendor_unknown]           = "Unknown",
-	[cpuinfo_arm_chipset_vendor_qualcomm]          = "Qualcomm",
-	[cpuinfo_arm_chipset_vendor_mediatek]          = "MediaTek",
-	[cpuinfo_arm_chipset_vendor_samsung]           = "Samsung",
-	[cpuinfo_arm_chipset_vendor_hisilicon]         = "HiSilicon",
-	[cpuinfo_arm_chipset_vendor_actions]           = "Actions",
-	[cpuinfo_arm_chipset_vendor_allwinner]         = "Allwinner",
-	[cpuinfo_arm_chipset_vendor_amlogic]           = "Amlogic",
-	[cpuinfo_arm_chipset_vendor_broadcom]          = "Broadcom",
-	[cpuinfo_arm_chipset_vendor_lg]                = "LG",
-	[cpuinfo_arm_chipset_vendor_leadcore]          = "Leadcore",
-	[cpuinfo_arm_chipset_vendor_marvell]           = "Marvell",
-	[cpuinfo_arm_chipset_vendor_mstar]             = "MStar",
-	[cpuinfo_arm_chipset_vendor_novathor]          = "NovaThor",
-	[cpuinfo_arm_chipset_vendor_nvidia]            = "Nvidia",
-	[cpuinfo_arm_chipset_vendor_pinecone]          = "Pinecone",
-	[cpuinfo_arm_chipset_vendor_renesas]           = "Renesas",
-	[cpuinfo_arm_chipset_vendor_rockchip]          = "Rockchip",
-	[cpuinfo_arm_chipset_vendor_spreadtrum]        = "Spreadtrum",
-	[cpuinfo_arm_chipset_vendor_telechips]         = "Telechips",
-	[cpuinfo_arm_chipset_vendor_texas_instruments] = "Texas Instruments",
-	[cpuinfo_arm_chipset_vendor_wondermedia]       = "WonderMedia",
-};
-
-/* Map from ARM chipset series ID to its string representation */
-static const char* chipset_series_string[cpuinfo_arm_chipset_series_max] = {
-	[cpuinfo_arm_chipset_series_unknown]                = NULL,
-	[cpuinfo_arm_chipset_series_qualcomm_qsd]           = "QSD",
-	[cpuinfo_arm_chipset_series_qualcomm_msm]           = "MSM",
-	[cpuinfo_arm_chipset_series_qualcomm_apq]           = "APQ",
-	[cpuinfo_arm_chipset_series_qualcomm_snapdragon]    = "Snapdragon ",
-	[cpuinfo_arm_chipset_series_mediatek_mt]            = "MT",
-	[cpuinfo_arm_chipset_series_samsung_exynos]         = "Exynos ",
-	[cpuinfo_arm_chipset_series_hisilicon_k3v]          = "K3V",
-	[cpuinfo_arm_chipset_series_hisilicon_hi]           = "Hi",
-	[cpuinfo_arm_chipset_series_hisilicon_kirin]        = "Kirin ",
-	[cpuinfo_arm_chipset_series_actions_atm]            = "ATM",
-	[cpuinfo_arm_chipset_series_allwinner_a]            = "A",
-	[cpuinfo_arm_chipset_series_amlogic_aml]            = "AML",
-	[cpuinfo_arm_chipset_series_amlogic_s]              = "S",
-	[cpuinfo_arm_chipset_series_broadcom_bcm]           = "BCM",
-	[cpuinfo_arm_chipset_series_lg_nuclun]              = "Nuclun ",
-	[cpuinfo_arm_chipset_series_leadcore_lc]            = "LC",
-	[cpuinfo_arm_chipset_series_marvell_pxa]            = "PXA",
-	[cpuinfo_arm_chipset_series_mstar_6a]               = "6A",
-	[cpuinfo_arm_chipset_series_novathor_u]             = "U",
-	[cpuinfo_arm_chipset_series_nvidia_tegra_t]         = "Tegra T",
-	[cpuinfo_arm_chipset_series_nvidia_tegra_ap]        = "Tegra AP",
-	[cpuinfo_arm_chipset_series_nvidia_tegra_sl]        = "Tegra SL",
-	[cpuinfo_arm_chipset_series_pinecone_surge_s]       = "Surge S",
-	[cpuinfo_arm_chipset_series_renesas_mp]             = "MP",
-	[cpuinfo_arm_chipset_series_rockchip_rk]            = "RK",
-	[cpuinfo_arm_chipset_series_spreadtrum_sc]          = "SC",
-	[cpuinfo_arm_chipset_series_telechips_tcc]          = "TCC",
-	[cpuinfo_arm_chipset_series_texas_instruments_omap] = "OMAP",
-	[cpuinfo_arm_chipset_series_wondermedia_wm]         = "WM",
-};
-
 /* Convert chipset name represented by cpuinfo_arm_chipset structure to a string representation */
 void cpuinfo_arm_chipset_to_string(
 	const struct cpuinfo_arm_chipset chipset[restrict static 1],
@@ -3485,6 +3537,62 @@ void cpuinfo_arm_chipset_to_string(
 	}
 }
 
+bool cpuinfo_arm_chipset_from_string(
+	const char* name,
+	size_t length,
+	struct cpuinfo_arm_chipset chipset[restrict static 1])
+{
+	/* Find the series with the longest vendor and series prefix of the name */
+	enum cpuinfo_arm_chipset_series series = cpuinfo_arm_chipset_series_unknown;
+	size_t prefix_length = 0;
+	for (uint32_t i = cpuinfo_arm_chipset_series_unknown + 1; i < cpuinfo_arm_chipset_series_max; i++) {
+		const char* vendor_string = chipset_vendor_string[chipset_series_vendor[i]];
+		const char* series_string = chipset_series_string[i];
+		const size_t vendor_length = strlen(vendor_string);
+		const size_t series_length = strlen(series_string);
+		const size_t series_prefix_length = vendor_length + 1 + series_length;
+		if (series_prefix_length <= prefix_length || series_prefix_length > length) {
+			continue;
+		}
+		if (memcmp(name, vendor_string, vendor_length) == 0 && name[vendor_length] == ' ' &&
+			memcmp(name + vendor_length + 1, series_string, series_length) == 0)
+		{
+			series = (enum cpuinfo_arm_chipset_series) i;
+			prefix_length = series_prefix_length;
+		}
+	}
+	if (series == cpuinfo_arm_chipset_series_unknown) {
+		return false;
+	}
+
+	const char* pos = name + prefix_length;
+	const char* end = name + length;
+	uint32_t model = 0;
+	for (; pos != end && is_ascii_numeric(*pos); pos++) {
+		if (model > (UINT32_MAX - 9) / 10) {
+			return false;
+		}
+		model = model * 10 + (uint32_t) (*pos - '0');
+	}
+	const size_t suffix_length = (size_t) (end - pos);
+	if (model == 0 || suffix_length > CPUINFO_ARM_CHIPSET_SUFFIX_MAX) {
+		return false;
+	}
+	for (size_t i = 0; i < suffix_length; i++) {
+		if (is_ascii_whitespace(pos[i])) {
+			return false;
+		}
+	}
+
+	*chipset = (struct cpuinfo_arm_chipset) {
+		.vendor = chipset_series_vendor[series],
+		.series = series,
+		.model = model,
+	};
+	memcpy(chipset->suffix, pos, suffix_length);
+	return true;
+}
+
 #ifdef __ANDROID__
 	static inline struct cpuinfo_arm_chipset disambiguate_qualcomm_chipset(
 		const struct cpuinfo_arm_chipset proc_cpuinfo_hardware_chipset[restrict static 1],
@@ -3626,6 +3734,26 @@ void cpuinfo_arm_chipset_to_string(
 			.series = cpuinfo_arm_chipset_series_unknown,
 		};
 
+		/* Registered chipsets take priority over the built-in signatures and their fixups */
+		if (match_registered_chipset_in_hardware(properties->proc_cpuinfo_hardware, &chipset)) {
+			return chipset;
+		}
+		const char* registered_chipset_properties[] = {
+			properties->ro_product_board,
+			properties->ro_board_platform,
+			properties->ro_mediatek_platform,
+			properties->ro_arch,
+			properties->ro_chipname,
+			properties->ro_hardware_chipname,
+		};
+		for (size_t i = 0; i < CPUINFO_COUNT_OF(registered_chipset_properties); i++) {
+			const char* property = registered_chipset_properties[i];
+			const char* property_end = property + strnlen(property, CPUINFO_BUILD_PROP_VALUE_MAX);
+			if (match_registered_chipset(property, property_end, &chipset)) {
+				return chipset;
+			}
+		}
+
 		const bool tegra_platform = is_tegra(
 			properties->ro_board_platform,
 			properties->ro_board_platform + strnlen(properties->ro_board_platform, CPUINFO_BUILD_PROP_VALUE_MAX));
@@ -3843,9 +3971,14 @@ void cpuinfo_arm_chipset_to_string(
 		uint32_t cores,
 		uint32_t max_cpu_freq_max)
 	{
-		struct cpuinfo_arm_chipset chipset =
-			cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_hardware(
-				hardware, cores, max_cpu_freq_max, false);
+		struct cpuinfo_arm_chipset chipset;
+		/* Registered chipsets take priority over the built-in signatures and their fixups */
+		if (match_registered_chipset_in_hardware(hardware, &chipset)) {
+			return chipset;
+		}
+
+		chipset = cpuinfo_arm_linux_decode_chipset_from_proc_cpuinfo_hardware(
+			hardware, cores, max_cpu_freq_max, false);
 		if (chipset.vendor == cpuinfo_arm_chipset_vendor_unknown) {
 			cpuinfo_log_warning(
 				"chipset detection failed: /proc/cpuinfo Hardware string did not match known signatures");
@@ -647,7 +647,7 @@ struct proc_cpuinfo_parser_state {
 };
 
 /*
- *	Decode a single line of /proc/cpuinfo information.
+ *	Decode a single key/value pair of /proc/cpuinfo information.
  *	Lines have format <words-with-spaces>[ ]*:[ ]<space-separated words>
  *	An example of /proc/cpuinfo (from Pandaboard-ES):
  *
@@ -670,66 +670,13 @@ struct proc_cpuinfo_parser_state {
  *		Serial          : 0000000000000000
  */
 static bool parse_line(
-	const char* line_start,
-	const char* line_end,
+	const char* key_start,
+	const char* key_end,
+	const char* value_start,
+	const char* value_end,
 	struct proc_cpuinfo_parser_state state[restrict static 1],
 	uint64_t line_number)
 {
-	/* Empty line. Skip. */
-	if (line_start == line_end) {
-		return true;
-	}
-
-	/* Search for ':' on the line. */
-	const char* separator = line_start;
-	for (; separator != line_end; separator++) {
-		if (*separator == ':') {
-			break;
-		}
-	}
-	/* Skip line if no ':' separator was found. */
-	if (separator == line_end) {
-		cpuinfo_log_info("Line %.*s in /proc/cpuinfo is ignored: key/value separator ':' not found",
-			(int) (line_end - line_start), line_start);
-		return true;
-	}
-
-	/* Skip trailing spaces in key part. */
-	const char* key_end = separator;
-	for (; key_end != line_start; key_end--) {
-		if (key_end[-1] != ' ' && key_end[-1] != '\t') {
-			break;
-		}
-	}
-	/* Skip line if key contains nothing but spaces. */
-	if (key_end == line_start) {
-		cpuinfo_log_info("Line %.*s in /proc/cpuinfo is ignored: key contains only spaces",
-			(int) (line_end - line_start), line_start);
-		return true;
-	}
-
-	/* Skip leading spaces in value part. */
-	const char* value_start = separator + 1;
-	for (; value_start != line_end; value_start++) {
-		if (*value_start != ' ') {
-			break;
-		}
-	}
-	/* Value part contains nothing but spaces. Skip line. */
-	if (value_start == line_end) {
-		cpuinfo_log_info("Line %.*s in /proc/cpuinfo is ignored: value contains only spaces",
-			(int) (line_end - line_start), line_start);
-		return true;
-	}
-
-	/* Skip trailing spaces in value part (if any) */
-	const char* value_end = line_end;
-	for (; value_end != value_start; value_end--) {
-		if (value_end[-1] != ' ') {
-			break;
-		}
-	}
-
 	const uint32_t processor_index      = state->processor_index;
 	const uint32_t max_processors_count = state->max_processors_count;
 	struct cpuinfo_arm_linux_processor* processors = state->processors;
@@ -738,25 +685,25 @@ static bool parse_line(
 		processor = &processors[processor_index];
 	}
 
-	const size_t key_length = key_end - line_start;
+	const size_t key_length = key_end - key_start;
 	switch (key_length) {
 		case 6:
-			if (memcmp(line_start, "Serial", key_length) == 0) {
+			if (memcmp(key_start, "Serial", key_length) == 0) {
 				/* Usually contains just zeros, useless */
 #if CPUINFO_ARCH_ARM
-			} else if (memcmp(line_start, "I size", key_length) == 0) {
+			} else if (memcmp(key_start, "I size", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"instruction cache size", &processor->proc_cpuinfo_cache.i_size,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_ICACHE_SIZE);
-			} else if (memcmp(line_start, "I sets", key_length) == 0) {
+			} else if (memcmp(key_start, "I sets", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"instruction cache sets", &processor->proc_cpuinfo_cache.i_sets,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_ICACHE_SETS);
-			} else if (memcmp(line_start, "D size", key_length) == 0) {
+			} else if (memcmp(key_start, "D size", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"data cache size", &processor->proc_cpuinfo_cache.d_size,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_DCACHE_SIZE);
-			} else if (memcmp(line_start, "D sets", key_length) == 0) {
+			} else if (memcmp(key_start, "D sets", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"data cache sets", &processor->proc_cpuinfo_cache.d_sets,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_DCACHE_SETS);
@@ -767,11 +714,11 @@ static bool parse_line(
 			break;
 #if CPUINFO_ARCH_ARM
 		case 7:
-			if (memcmp(line_start, "I assoc", key_length) == 0) {
+			if (memcmp(key_start, "I assoc", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"instruction cache associativity", &processor->proc_cpuinfo_cache.i_assoc,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_ICACHE_WAYS);
-			} else if (memcmp(line_start, "D assoc", key_length) == 0) {
+			} else if (memcmp(key_start, "D assoc", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"data cache associativity", &processor->proc_cpuinfo_cache.d_assoc,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_DCACHE_WAYS);
@@ -781,13 +728,13 @@ static bool parse_line(
 			break;
 #endif /* CPUINFO_ARCH_ARM */
 		case 8:
-			if (memcmp(line_start, "CPU part", key_length) == 0) {
+			if (memcmp(key_start, "CPU part", key_length) == 0) {
 				parse_cpu_part(value_start, value_end, processor);
-			} else if (memcmp(line_start, "Features", key_length) == 0) {
+			} else if (memcmp(key_start, "Features", key_length) == 0) {
 				parse_features(value_start, value_end, processor);
-			} else if (memcmp(line_start, "BogoMIPS", key_length) == 0) {
+			} else if (memcmp(key_start, "BogoMIPS", key_length) == 0) {
 				/* BogoMIPS is useless, don't parse */
-			} else if (memcmp(line_start, "Hardware", key_length) == 0) {
+			} else if (memcmp(key_start, "Hardware", key_length) == 0) {
 				size_t value_length = value_end - value_start;
 				if (value_length > CPUINFO_HARDWARE_VALUE_MAX) {
 					cpuinfo_log_info(
@@ -799,7 +746,7 @@ static bool parse_line(
 				}
 				memcpy(state->hardware, value_start, value_length);
 				cpuinfo_log_debug("parsed /proc/cpuinfo Hardware = \"%.*s\"", (int) value_length, value_start);
-			} else if (memcmp(line_start, "Revision", key_length) == 0) {
+			} else if (memcmp(key_start, "Revision", key_length) == 0) {
 				size_t value_length = value_end - value_start;
 				if (value_length > CPUINFO_REVISION_VALUE_MAX) {
 					cpuinfo_log_info(
@@ -816,7 +763,7 @@ static bool parse_line(
 			}
 			break;
 		case 9:
-			if (memcmp(line_start, "processor", key_length) == 0) {
+			if (memcmp(key_start, "processor", key_length) == 0) {
 				const uint32_t new_processor_index = parse_processor_number(value_start, value_end);
 				if (new_processor_index < processor_index) {
 					/* Strange: decreasing processor number */
@@ -839,21 +786,21 @@ static bool parse_line(
 				}
 				state->processor_index = new_processor_index;
 				return true;
-			} else if (memcmp(line_start, "Processor", key_length) == 0) {
+			} else if (memcmp(key_start, "Processor", key_length) == 0) {
 				/* TODO: parse to fix misreported architecture, similar to Android's cpufeatures */
 			} else {
 				goto unknown;
 			}
 			break;
 		case 11:
-			if (memcmp(line_start, "CPU variant", key_length) == 0) {
+			if (memcmp(key_start, "CPU variant", key_length) == 0) {
 				parse_cpu_variant(value_start, value_end, processor);
 			} else {
 				goto unknown;
 			}
 			break;
 		case 12:
-			if (memcmp(line_start, "CPU revision", key_length) == 0) {
+			if (memcmp(key_start, "CPU revision", key_length) == 0) {
 				parse_cpu_revision(value_start, value_end, processor);
 			} else {
 				goto unknown;
@@ -861,11 +808,11 @@ static bool parse_line(
 			break;
 #if CPUINFO_ARCH_ARM
 		case 13:
-			if (memcmp(line_start, "I line length", key_length) == 0) {
+			if (memcmp(key_start, "I line length", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"instruction cache line size", &processor->proc_cpuinfo_cache.i_line_length,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_ICACHE_LINE);
-			} else if (memcmp(line_start, "D line length", key_length) == 0) {
+			} else if (memcmp(key_start, "D line length", key_length) == 0) {
 				parse_cache_number(value_start, value_end,
 					"data cache line size", &processor->proc_cpuinfo_cache.d_line_length,
 					&processor->flags, CPUINFO_ARM_LINUX_VALID_DCACHE_LINE);
@@ -875,16 +822,16 @@ static bool parse_line(
 			break;
 #endif /* CPUINFO_ARCH_ARM */
 		case 15:
-			if (memcmp(line_start, "CPU implementer", key_length) == 0) {
+			if (memcmp(key_start, "CPU implementer", key_length) == 0) {
 				parse_cpu_implementer(value_start, value_end, processor);
-			} else if (memcmp(line_start, "CPU implementor", key_length) == 0) {
+			} else if (memcmp(key_start, "CPU implementor", key_length) == 0) {
 				parse_cpu_implementer(value_start, value_end, processor);
 			} else {
 				goto unknown;
 			}
 			break;
 		case 16:
-			if (memcmp(line_start, "CPU architecture", key_length) == 0) {
+			if (memcmp(key_start, "CPU architecture", key_length) == 0) {
 				parse_cpu_architecture(value_start, value_end, processor);
 			} else {
 				goto unknown;
@@ -892,7 +839,7 @@ static bool parse_line(
 			break;
 		default:
 		unknown:
-			cpuinfo_log_debug("unknown /proc/cpuinfo key: %.*s", (int) key_length, line_start);
+			cpuinfo_log_debug("unknown /proc/cpuinfo key: %.*s", (int) key_length, key_start);
 
 	}
 	return true;
@@ -912,6 +859,6 @@ bool cpuinfo_arm_linux_parse_proc_cpuinfo(
 		.max_processors_count = max_processors_count,
 		.processors = processors,
 	};
-	return cpuinfo_linux_parse_multiline_file("/proc/cpuinfo", BUFFER_SIZE,
-		(cpuinfo_line_callback) parse_line, &state);
+	return cpuinfo_linux_parse_key_value_file("/proc/cpuinfo", BUFFER_SIZE, NULL,
+		(cpuinfo_key_value_callback) parse_line, &state);
 }
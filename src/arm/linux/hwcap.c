@@ -145,14 +145,15 @@
 #elif CPUINFO_ARCH_ARM64
 	void cpuinfo_arm_linux_hwcap_from_getauxval(
 		uint32_t hwcap[restrict static 1],
-		uint32_t hwcap2[restrict static 1])
+		uint64_t hwcap2[restrict static 1])
 	{
 		#if CPUINFO_MOCK
 			*hwcap  = mock_hwcap;
 			*hwcap2 = mock_hwcap2;
 		#else
 			*hwcap  = (uint32_t) getauxval(AT_HWCAP);
-			*hwcap2 = (uint32_t) getauxval(AT_HWCAP2);
+			/* AT_HWCAP2 on ARM64 has bits above 32 (e.g. SME2) */
+			*hwcap2 = (uint64_t) getauxval(AT_HWCAP2);
 			return ;
 		#endif
 	}
@@ -17,8 +17,6 @@
 
 struct cpuinfo_arm_isa cpuinfo_isa = { 0 };
 
-static struct cpuinfo_package package = { { 0 } };
-
 static inline bool bitmask_all(uint32_t bitfield, uint32_t mask) {
 	return (bitfield & mask) == mask;
 }
@@ -27,16 +25,102 @@ static inline uint32_t min(uint32_t a, uint32_t b) {
 	return a < b ? a : b;
 }
 
+static inline uint32_t max(uint32_t a, uint32_t b) {
+	return a > b ? a : b;
+}
+
 static inline int cmp(uint32_t a, uint32_t b) {
 	return (a > b) - (a < b);
 }
 
+/*
+ * Capacity of the processor scaled to CPUINFO_CAPACITY_SCALE for the highest-capacity processor: the capacity
+ * reported by the kernel if all processors report it, otherwise the maximum frequency relative to the highest one.
+ */
+static uint32_t get_normalized_capacity(
+	const struct cpuinfo_arm_linux_processor processor[restrict static 1],
+	uint32_t max_capacity,
+	uint32_t max_frequency)
+{
+	uint64_t capacity = CPUINFO_CAPACITY_SCALE;
+	if (max_capacity != 0) {
+		capacity = (uint64_t) processor->capacity * CPUINFO_CAPACITY_SCALE / max_capacity;
+	} else if (max_frequency != 0 && (processor->flags & CPUINFO_LINUX_FLAG_MAX_FREQUENCY)) {
+		capacity = (uint64_t) processor->max_frequency * CPUINFO_CAPACITY_SCALE / max_frequency;
+	}
+	return capacity != 0 ? (uint32_t) capacity : 1;
+}
+
+static void detect_frequency_and_package_id(
+	uint32_t processor,
+	struct cpuinfo_arm_linux_processor* processors)
+{
+	if (!bitmask_all(processors[processor].flags, CPUINFO_LINUX_FLAG_VALID)) {
+		return;
+	}
+
+	const uint32_t max_frequency = cpuinfo_linux_get_processor_max_frequency(processor);
+	if (max_frequency != 0) {
+		processors[processor].max_frequency = max_frequency;
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_MAX_FREQUENCY;
+	}
+
+	const uint32_t min_frequency = cpuinfo_linux_get_processor_min_frequency(processor);
+	if (min_frequency != 0) {
+		processors[processor].min_frequency = min_frequency;
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_MIN_FREQUENCY;
+	}
+
+	const uint32_t capacity = cpuinfo_linux_get_processor_capacity(processor);
+	if (capacity != 0) {
+		processors[processor].capacity = capacity;
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_CAPACITY;
+	}
+
+	if (cpuinfo_linux_get_processor_package_id(processor, &processors[processor].package_id)) {
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_PACKAGE_ID;
+	}
+
+	uint32_t cluster_id;
+	if (cpuinfo_linux_get_processor_cluster_id(processor, &cluster_id)) {
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_CLUSTER_ID;
+	}
+}
+
+/*
+ * Find the leader of the processor's package cluster. Package leader IDs form a disjoint-set forest while the lists of
+ * core siblings are parsed, and every tree is rooted at the processor with the smallest index in the cluster.
+ */
+static uint32_t find_package_leader(uint32_t processor, struct cpuinfo_arm_linux_processor* processors) {
+	while (processors[processor].package_leader_id != processor) {
+		/* Path halving keeps the trees shallow without recursion */
+		const uint32_t parent = processors[processor].package_leader_id;
+		processors[processor].package_leader_id = processors[parent].package_leader_id;
+		processor = processors[processor].package_leader_id;
+	}
+	return processor;
+}
+
+/* Merge the package clusters of a processor and its sibling */
+static void merge_package_clusters(
+	uint32_t processor, uint32_t sibling,
+	struct cpuinfo_arm_linux_processor* processors)
+{
+	const uint32_t package_leader_id = find_package_leader(processor, processors);
+	const uint32_t sibling_package_leader_id = find_package_leader(sibling, processors);
+	if (sibling_package_leader_id < package_leader_id) {
+		processors[package_leader_id].package_leader_id = sibling_package_leader_id;
+	} else {
+		processors[sibling_package_leader_id].package_leader_id = package_leader_id;
+	}
+	processors[sibling].flags |= CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER;
+}
+
 static bool cluster_siblings_parser(
 	uint32_t processor, uint32_t siblings_start, uint32_t siblings_end,
 	struct cpuinfo_arm_linux_processor* processors)
 {
 	processors[processor].flags |= CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER;
-	uint32_t package_leader_id = processors[processor].package_leader_id;
 
 	for (uint32_t sibling = siblings_start; sibling < siblings_end; sibling++) {
 		if (!bitmask_all(processors[sibling].flags, CPUINFO_LINUX_FLAG_VALID)) {
@@ -44,21 +128,219 @@ static bool cluster_siblings_parser(
 				sibling, processor);
 			continue;
 		}
+		merge_package_clusters(processor, sibling, processors);
+	}
 
-		const uint32_t sibling_package_leader_id = processors[sibling].package_leader_id;
-		if (sibling_package_leader_id < package_leader_id) {
-			package_leader_id = sibling_package_leader_id;
+	return true;
+}
+
+struct kernel_cluster_context {
+	struct cpuinfo_arm_linux_processor* processors;
+	/* Whether every processor is in the frequency domain of the processor whose cluster siblings are parsed */
+	bool* frequency_siblings;
+};
+
+static bool mark_frequency_siblings(
+	uint32_t processor, uint32_t siblings_start, uint32_t siblings_end,
+	bool* frequency_siblings)
+{
+	(void) processor;
+	for (uint32_t sibling = siblings_start; sibling < siblings_end; sibling++) {
+		frequency_siblings[sibling] = true;
+	}
+	return true;
+}
+
+/* Cluster siblings are clustered with the processor only if they share its frequency domain */
+static bool kernel_cluster_siblings_parser(
+	uint32_t processor, uint32_t siblings_start, uint32_t siblings_end,
+	struct kernel_cluster_context* context)
+{
+	struct cpuinfo_arm_linux_processor* processors = context->processors;
+	processors[processor].flags |= CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER;
+
+	for (uint32_t sibling = siblings_start; sibling < siblings_end; sibling++) {
+		if (bitmask_all(processors[sibling].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_CLUSTER_ID) &&
+			context->frequency_siblings[sibling])
+		{
+			merge_package_clusters(processor, sibling, processors);
 		}
+	}
+
+	return true;
+}
 
-		processors[sibling].package_leader_id = package_leader_id;
-		processors[sibling].flags |= CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER;
+/*
+ * Cluster processors by the clusters which kernels 5.16+ report in topology/cluster_cpus_list, split by cpufreq
+ * policies: firmware of DynamIQ SoCs often describes all cores as one cluster, while cores of different types
+ * have different policies. The policies are not used alone, as older kernels of some SoCs have a policy per core.
+ * Returns false if the kernel doesn't report clusters, and the processors must be clustered by other means.
+ */
+static bool detect_kernel_clusters(uint32_t processors_count, struct cpuinfo_arm_linux_processor* processors) {
+	bool has_cluster_ids = false;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		has_cluster_ids |= bitmask_all(processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_CLUSTER_ID);
+	}
+	if (!has_cluster_ids) {
+		return false;
+	}
+	bool* frequency_siblings = cpuinfo_allocate_temporary(processors_count, sizeof(bool));
+	if (frequency_siblings == NULL) {
+		return false;
+	}
+	struct kernel_cluster_context context = {
+		.processors = processors,
+		.frequency_siblings = frequency_siblings,
+	};
+	for (uint32_t i = 0; i < processors_count; i++) {
+		/* Lists of processors in the same cluster and frequency domain are identical: parse them once */
+		if (!bitmask_all(processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_CLUSTER_ID) ||
+			bitmask_all(processors[i].flags, CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER))
+		{
+			continue;
+		}
+		memset(frequency_siblings, 0, processors_count * sizeof(bool));
+		if (!cpuinfo_linux_detect_frequency_siblings(processors_count, i,
+			(cpuinfo_siblings_callback) mark_frequency_siblings, frequency_siblings))
+		{
+			/* Without cpufreq, all cluster siblings are clustered */
+			memset(frequency_siblings, 1, processors_count * sizeof(bool));
+		}
+		cpuinfo_linux_detect_cluster_siblings(processors_count, i,
+			(cpuinfo_siblings_callback) kernel_cluster_siblings_parser, &context);
 	}
+	cpuinfo_free_temporary(frequency_siblings);
+	return true;
+}
 
-	processors[processor].package_leader_id = package_leader_id;
+/* Level of a cache described in sysfs, or cpuinfo_cache_level_max if cpuinfo doesn't report such caches on ARM */
+static enum cpuinfo_cache_level get_sysfs_cache_level(const struct cpuinfo_linux_cache cache[restrict static 1]) {
+	if (cache->type == cpuinfo_linux_cache_type_instruction) {
+		return cache->level == 1 ? cpuinfo_cache_level_1i : cpuinfo_cache_level_max;
+	}
+	switch (cache->level) {
+		case 1:
+			return cpuinfo_cache_level_1d;
+		case 2:
+			return cpuinfo_cache_level_2;
+		case 3:
+			return cpuinfo_cache_level_3;
+		default:
+			return cpuinfo_cache_level_max;
+	}
+}
 
+struct cache_siblings_context {
+	uint32_t processors_count;
+	struct cpuinfo_arm_linux_processor* processors;
+	/* Index of the cache/indexK directory, and level and index plus one of the cache */
+	uint32_t sysfs_index;
+	enum cpuinfo_cache_level level;
+	uint32_t cache;
+};
+
+static bool set_cache_siblings(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+	const struct cache_siblings_context* siblings_context = (const struct cache_siblings_context*) context;
+	cpu_end = min(cpu_end, siblings_context->processors_count);
+	for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+		struct cpuinfo_arm_linux_processor* processor = &siblings_context->processors[cpu];
+		processor->sysfs_cache_indices |= UINT32_C(1) << siblings_context->sysfs_index;
+		if (processor->sysfs_cache[siblings_context->level] == 0) {
+			processor->sysfs_cache[siblings_context->level] = siblings_context->cache;
+		}
+	}
 	return true;
 }
 
+/*
+ * Detect caches of processors indexed by Linux processor ID from sysfs. On ARM64 the kernel derives them from
+ * ACPI PPTT or device tree, or else from CLIDR/CCSIDR registers, which are not accessible to user space.
+ * Every cache is parsed only on the first processor which shares it. Returns the number of caches.
+ */
+static uint32_t detect_sysfs_caches(
+	uint32_t linux_processors_count,
+	struct cpuinfo_arm_linux_processor linux_processors[restrict static linux_processors_count],
+	struct cpuinfo_cache caches[restrict static linux_processors_count * cpuinfo_cache_level_max])
+{
+	uint32_t caches_count = 0;
+	for (uint32_t cpu = 0; cpu < linux_processors_count; cpu++) {
+		if (!bitmask_all(linux_processors[cpu].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			continue;
+		}
+		for (uint32_t index = 0; index < CPUINFO_LINUX_MAX_CACHE_INDICES; index++) {
+			if (linux_processors[cpu].sysfs_cache_indices & (UINT32_C(1) << index)) {
+				continue;
+			}
+			struct cpuinfo_linux_cache linux_cache;
+			if (!cpuinfo_linux_get_processor_cache(cpu, index, &linux_cache)) {
+				break;
+			}
+			linux_processors[cpu].sysfs_cache_indices |= UINT32_C(1) << index;
+			const enum cpuinfo_cache_level level = get_sysfs_cache_level(&linux_cache);
+			if (level == cpuinfo_cache_level_max || linux_processors[cpu].sysfs_cache[level] != 0) {
+				continue;
+			}
+
+			if (linux_cache.sets == 0 && linux_cache.associativity != 0 && linux_cache.line_size != 0) {
+				linux_cache.sets = linux_cache.size / (linux_cache.associativity * linux_cache.line_size);
+			}
+			caches[caches_count++] = (struct cpuinfo_cache) {
+				.size = linux_cache.size,
+				.associativity = linux_cache.associativity,
+				.sets = linux_cache.sets,
+				.partitions = linux_cache.partitions != 0 ? linux_cache.partitions : 1,
+				.line_size = linux_cache.line_size,
+			};
+
+			struct cache_siblings_context context = {
+				.processors_count = linux_processors_count,
+				.processors = linux_processors,
+				.sysfs_index = index,
+				.level = level,
+				.cache = caches_count,
+			};
+			cpuinfo_linux_parse_processor_cache_siblings(cpu, index, set_cache_siblings, &context);
+			/* The processor itself may be missing from a malformed list */
+			set_cache_siblings(cpu, cpu + 1, &context);
+		}
+	}
+	return caches_count;
+}
+
+/*
+ * Assign table indices to L2 and L3 caches described in sysfs in order of the first processor which shares them,
+ * and count processors which share every cache. Processors must be sorted, and all of them must have sysfs caches.
+ */
+static void count_sysfs_caches(
+	uint32_t valid_processors,
+	const struct cpuinfo_arm_linux_processor processors[restrict static valid_processors],
+	struct cpuinfo_cache sysfs_caches[restrict static 1],
+	uint32_t sysfs_cache_indices[restrict static 1],
+	uint32_t l2_count_ptr[restrict static 1],
+	uint32_t l3_count_ptr[restrict static 1])
+{
+	uint32_t counts[cpuinfo_cache_level_max] = { 0 };
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		for (uint32_t level = cpuinfo_cache_level_2; level <= cpuinfo_cache_level_3; level++) {
+			const uint32_t sysfs_cache = processors[i].sysfs_cache[level];
+			if (sysfs_cache == 0) {
+				continue;
+			}
+			struct cpuinfo_cache* cache = &sysfs_caches[sysfs_cache - 1];
+			if (cache->processor_count == 0) {
+				sysfs_cache_indices[sysfs_cache - 1] = counts[level]++;
+				cache->processor_start = i;
+			} else if (cache->processor_start + cache->processor_count != i) {
+				cpuinfo_log_warning("processors sharing L%"PRIu32" cache with processor %"PRIu32" are not contiguous",
+					level, processors[i].system_processor_id);
+			}
+			cache->processor_count += 1;
+		}
+	}
+	*l2_count_ptr = counts[cpuinfo_cache_level_2];
+	*l3_count_ptr = counts[cpuinfo_cache_level_3];
+}
+
 static int cmp_arm_linux_processor(const void* ptr_a, const void* ptr_b) {
 	const struct cpuinfo_arm_linux_processor* processor_a = (const struct cpuinfo_arm_linux_processor*) ptr_a;
 	const struct cpuinfo_arm_linux_processor* processor_b = (const struct cpuinfo_arm_linux_processor*) ptr_b;
@@ -70,6 +352,13 @@ static int cmp_arm_linux_processor(const void* ptr_a, const void* ptr_b) {
 		return (int) usable_b - (int) usable_a;
 	}
 
+	/* Compare based on capacity reported by the kernel (e.g. Cortex-X1 < Cortex-A78 at the same frequency) */
+	const uint32_t capacity_a = processor_a->capacity;
+	const uint32_t capacity_b = processor_b->capacity;
+	if (capacity_a != capacity_b) {
+		return capacity_a > capacity_b ? -1 : 1;
+	}
+
 	/* Compare based on core type (e.g. Cortex-A57 < Cortex-A53) */
 	const uint32_t midr_a = processor_a->midr;
 	const uint32_t midr_b = processor_b->midr;
@@ -106,14 +395,22 @@ void cpuinfo_arm_linux_init(void) {
 	struct cpuinfo_processor* processors = NULL;
 	struct cpuinfo_core* cores = NULL;
 	struct cpuinfo_cluster* clusters = NULL;
+	struct cpuinfo_package* packages = NULL;
 	struct cpuinfo_uarch_info* uarchs = NULL;
+	struct cpuinfo_uarch_tlbs* uarch_tlbs = NULL;
 	struct cpuinfo_cache* l1i = NULL;
 	struct cpuinfo_cache* l1d = NULL;
 	struct cpuinfo_cache* l2 = NULL;
 	struct cpuinfo_cache* l3 = NULL;
+	struct cpuinfo_cache* l4 = NULL;
+	struct cpuinfo_cache* sysfs_caches = NULL;
+	uint32_t* sysfs_cache_indices = NULL;
+	uint32_t sysfs_caches_count = 0;
 	const struct cpuinfo_processor** linux_cpu_to_processor_map = NULL;
 	const struct cpuinfo_core** linux_cpu_to_core_map = NULL;
 	uint32_t* linux_cpu_to_uarch_index_map = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
+	uint64_t phase_start = cpuinfo_get_timestamp_ns();
 
 	const uint32_t max_processors_count = cpuinfo_linux_get_max_processors_count();
 	cpuinfo_log_debug("system maximum processors count: %"PRIu32, max_processors_count);
@@ -140,7 +437,8 @@ void cpuinfo_arm_linux_init(void) {
 		return;
 	}
 
-	arm_linux_processors = calloc(arm_linux_processors_count, sizeof(struct cpuinfo_arm_linux_processor));
+	arm_linux_processors = cpuinfo_allocate_temporary(
+		arm_linux_processors_count, sizeof(struct cpuinfo_arm_linux_processor));
 	if (arm_linux_processors == NULL) {
 		cpuinfo_log_error(
 			"failed to allocate %zu bytes for descriptions of %"PRIu32" ARM logical processors",
@@ -162,10 +460,12 @@ void cpuinfo_arm_linux_init(void) {
 			sizeof(struct cpuinfo_arm_linux_processor),
 			CPUINFO_LINUX_FLAG_PRESENT);
 	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_cpulists, &phase_start);
 
 #if defined(__ANDROID__)
 	struct cpuinfo_android_properties android_properties;
 	cpuinfo_arm_android_parse_properties(&android_properties);
+	cpuinfo_record_init_phase(cpuinfo_init_phase_chipset, &phase_start);
 #else
 	char proc_cpuinfo_hardware[CPUINFO_HARDWARE_VALUE_MAX];
 #endif
@@ -187,11 +487,27 @@ void cpuinfo_arm_linux_init(void) {
 	for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
 		if (bitmask_all(arm_linux_processors[i].flags, valid_processor_mask)) {
 			arm_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_VALID;
+			/*
+			 * Prefer MIDR from sysfs: unlike /proc/cpuinfo, it is reported for offline processors too, and doesn't
+			 * need the heuristics in midr.c to recover MIDR of processors missing from /proc/cpuinfo.
+			 */
+			uint32_t midr;
+			if (cpuinfo_linux_get_processor_midr(i, &midr)) {
+				arm_linux_processors[i].midr = midr;
+				arm_linux_processors[i].flags |= CPUINFO_ARM_LINUX_VALID_MIDR;
+			}
 			cpuinfo_log_debug("parsed processor %"PRIu32" MIDR 0x%08"PRIx32,
 				i, arm_linux_processors[i].midr);
 		}
 	}
 
+#if defined(__ANDROID__)
+	/* Chipset and MIDRs of all processors don't change until the system is updated to a different build */
+	struct cpuinfo_arm_chipset cached_chipset;
+	const bool chipset_cached = cpuinfo_arm_android_load_chipset_cache(
+		android_properties.ro_build_fingerprint, arm_linux_processors_count, arm_linux_processors, &cached_chipset);
+#endif
+
 	uint32_t valid_processors = 0, last_midr = 0;
 	#if CPUINFO_ARCH_ARM
 	uint32_t last_architecture_version = 0, last_architecture_flags = 0;
@@ -225,14 +541,16 @@ void cpuinfo_arm_linux_init(void) {
 			}
 		}
 	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_proc_cpuinfo, &phase_start);
 
 #if defined(__ANDROID__)
-	const struct cpuinfo_arm_chipset chipset =
+	const struct cpuinfo_arm_chipset chipset = chipset_cached ? cached_chipset :
 		cpuinfo_arm_android_decode_chipset(&android_properties, valid_processors, 0);
 #else
 	const struct cpuinfo_arm_chipset chipset =
 		cpuinfo_arm_linux_decode_chipset(proc_cpuinfo_hardware, proc_cpuinfo_revision, valid_processors, 0);
 #endif
+	cpuinfo_record_init_phase(cpuinfo_init_phase_chipset, &phase_start);
 
 	#if CPUINFO_ARCH_ARM
 		uint32_t isa_features = 0, isa_features2 = 0;
@@ -277,63 +595,70 @@ void cpuinfo_arm_linux_init(void) {
 			last_midr, last_architecture_version, last_architecture_flags,
 			&chipset, &cpuinfo_isa);
 	#elif CPUINFO_ARCH_ARM64
-		uint32_t isa_features = 0, isa_features2 = 0;
+		uint32_t isa_features = 0;
+		uint64_t isa_features2 = 0;
 		/* getauxval is always available on ARM64 Android */
 		cpuinfo_arm_linux_hwcap_from_getauxval(&isa_features, &isa_features2);
 		cpuinfo_arm64_linux_decode_isa_from_proc_cpuinfo(
 			isa_features, isa_features2, last_midr, &chipset, &cpuinfo_isa);
 	#endif
+	cpuinfo_record_init_phase(cpuinfo_init_phase_decode, &phase_start);
 
 	/* Detect min/max frequency and package ID */
-	for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
-		if (bitmask_all(arm_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
-			const uint32_t max_frequency = cpuinfo_linux_get_processor_max_frequency(i);
-			if (max_frequency != 0) {
-				arm_linux_processors[i].max_frequency = max_frequency;
-				arm_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_MAX_FREQUENCY;
-			}
-
-			const uint32_t min_frequency = cpuinfo_linux_get_processor_min_frequency(i);
-			if (min_frequency != 0) {
-				arm_linux_processors[i].min_frequency = min_frequency;
-				arm_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_MIN_FREQUENCY;
-			}
-
-			if (cpuinfo_linux_get_processor_package_id(i, &arm_linux_processors[i].package_id)) {
-				arm_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_PACKAGE_ID;
-			}
-		}
-	}
+	cpuinfo_linux_parallel_for_processors(arm_linux_processors_count,
+		(cpuinfo_processor_function) detect_frequency_and_package_id, arm_linux_processors);
 
 	/* Initialize topology group IDs */
 	for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
 		arm_linux_processors[i].package_leader_id = i;
 	}
 
-	/* Propagate topology group IDs among siblings */
-	for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
-		if (!bitmask_all(arm_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
-			continue;
-		}
+	/*
+	 * Propagate topology group IDs among siblings. Kernels which report clusters describe them exactly, and on
+	 * older kernels the package of a processor is its cluster.
+	 */
+	if (!detect_kernel_clusters(arm_linux_processors_count, arm_linux_processors)) {
+		for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
+			if (!bitmask_all(arm_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
+				continue;
+			}
 
-		if (arm_linux_processors[i].flags & CPUINFO_LINUX_FLAG_PACKAGE_ID) {
-			cpuinfo_linux_detect_core_siblings(
-				arm_linux_processors_count, i,
-				(cpuinfo_siblings_callback) cluster_siblings_parser,
-				arm_linux_processors);
+			/*
+			 * Siblings lists of processors in the same package are identical: parse the list only for the first
+			 * processor of every package to keep the work linear in the number of processors.
+			 */
+			if (bitmask_all(arm_linux_processors[i].flags, CPUINFO_LINUX_FLAG_PACKAGE_ID) &&
+				!bitmask_all(arm_linux_processors[i].flags, CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER))
+			{
+				cpuinfo_linux_detect_core_siblings(
+					arm_linux_processors_count, i,
+					(cpuinfo_siblings_callback) cluster_siblings_parser,
+					arm_linux_processors);
+			}
 		}
 	}
 
+	/* Caches in sysfs take priority over the per-uarch tables in cpuinfo_arm_decode_cache */
+	sysfs_caches = cpuinfo_allocate_temporary(
+		arm_linux_processors_count * cpuinfo_cache_level_max, sizeof(struct cpuinfo_cache));
+	sysfs_cache_indices = cpuinfo_allocate_temporary(
+		arm_linux_processors_count * cpuinfo_cache_level_max, sizeof(uint32_t));
+	if (sysfs_caches == NULL || sysfs_cache_indices == NULL) {
+		cpuinfo_log_warning("failed to allocate %zu bytes for descriptions of caches in sysfs: using default caches",
+			arm_linux_processors_count * cpuinfo_cache_level_max * (sizeof(struct cpuinfo_cache) + sizeof(uint32_t)));
+	} else {
+		sysfs_caches_count = detect_sysfs_caches(arm_linux_processors_count, arm_linux_processors, sysfs_caches);
+		cpuinfo_log_debug("detected %"PRIu32" caches in sysfs", sysfs_caches_count);
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_sysfs, &phase_start);
+
 	/* Propagate all cluster IDs */
 	uint32_t clustered_processors = 0;
 	for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
 		if (bitmask_all(arm_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER)) {
 			clustered_processors += 1;
 
-			const uint32_t package_leader_id = arm_linux_processors[i].package_leader_id;
-			if (package_leader_id < i) {
-				arm_linux_processors[i].package_leader_id = arm_linux_processors[package_leader_id].package_leader_id;
-			}
+			arm_linux_processors[i].package_leader_id = find_package_leader(i, arm_linux_processors);
 
 			cpuinfo_log_debug("processor %"PRIu32" clustered with processor %"PRIu32" as inferred from system siblings lists",
 				i, arm_linux_processors[i].package_leader_id);
@@ -378,6 +703,10 @@ void cpuinfo_arm_linux_init(void) {
 				/* Cluster non-leader: copy vendor, uarch, MIDR, and frequency from cluster leader */
 				arm_linux_processors[i].flags |= arm_linux_processors[cluster_leader].flags &
 					(CPUINFO_ARM_LINUX_VALID_MIDR | CPUINFO_LINUX_FLAG_MAX_FREQUENCY);
+				if (!(arm_linux_processors[i].flags & CPUINFO_LINUX_FLAG_CAPACITY)) {
+					arm_linux_processors[i].flags |= arm_linux_processors[cluster_leader].flags & CPUINFO_LINUX_FLAG_CAPACITY;
+					arm_linux_processors[i].capacity = arm_linux_processors[cluster_leader].capacity;
+				}
 				arm_linux_processors[i].midr = arm_linux_processors[cluster_leader].midr;
 				arm_linux_processors[i].vendor = arm_linux_processors[cluster_leader].vendor;
 				arm_linux_processors[i].uarch = arm_linux_processors[cluster_leader].uarch;
@@ -393,6 +722,13 @@ void cpuinfo_arm_linux_init(void) {
 		}
 	}
 
+#if defined(__ANDROID__)
+	if (!chipset_cached) {
+		cpuinfo_arm_android_save_chipset_cache(
+			android_properties.ro_build_fingerprint, arm_linux_processors_count, arm_linux_processors, &chipset);
+	}
+#endif
+
 	qsort(arm_linux_processors, arm_linux_processors_count,
 		sizeof(struct cpuinfo_arm_linux_processor), cmp_arm_linux_processor);
 
@@ -421,75 +757,118 @@ void cpuinfo_arm_linux_init(void) {
 	 * - Level 1 instruction and data caches are private to the core clusters.
 	 * - Level 2 and level 3 cache is shared between cores in the same cluster.
 	 */
+	struct cpuinfo_package package = { { 0 } };
 	cpuinfo_arm_chipset_to_string(&chipset, package.name);
 	package.processor_count = valid_processors;
 	package.core_count = valid_processors;
 	package.cluster_count = cluster_count;
 
-	processors = calloc(valid_processors, sizeof(struct cpuinfo_processor));
-	if (processors == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
-			valid_processors * sizeof(struct cpuinfo_processor), valid_processors);
-		goto cleanup;
-	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_decode, &phase_start);
 
-	cores = calloc(valid_processors, sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			valid_processors * sizeof(struct cpuinfo_core), valid_processors);
-		goto cleanup;
-	}
-
-	clusters = calloc(cluster_count, sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" core clusters",
-			cluster_count * sizeof(struct cpuinfo_cluster), cluster_count);
-		goto cleanup;
-	}
-
-	uarchs = calloc(uarchs_count, sizeof(struct cpuinfo_uarch_info));
-	if (uarchs == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" microarchitectures",
-			uarchs_count * sizeof(struct cpuinfo_uarch_info), uarchs_count);
-		goto cleanup;
-	}
-
-	linux_cpu_to_processor_map = calloc(arm_linux_processors_count, sizeof(struct cpuinfo_processor*));
-	if (linux_cpu_to_processor_map == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for %"PRIu32" logical processor mapping entries",
-			arm_linux_processors_count * sizeof(struct cpuinfo_processor*), arm_linux_processors_count);
-		goto cleanup;
-	}
-
-	linux_cpu_to_core_map = calloc(arm_linux_processors_count, sizeof(struct cpuinfo_core*));
-	if (linux_cpu_to_core_map == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for %"PRIu32" core mapping entries",
-			arm_linux_processors_count * sizeof(struct cpuinfo_core*), arm_linux_processors_count);
-		goto cleanup;
+	/* Count L2 and L3 caches to size the tables */
+	uint32_t l2_count = 0, l3_count = 0, big_l3_size = 0, cluster_id = UINT32_MAX;
+	/* Indication whether L3 (if it exists) is shared between all cores */
+	bool shared_l3 = true;
+	/* L2 and L3 in sysfs replace the defaults only if sysfs describes caches of every processor */
+	bool use_sysfs_caches = sysfs_caches_count != 0;
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		if (arm_linux_processors[i].sysfs_cache_indices == 0) {
+			use_sysfs_caches = false;
+		}
 	}
+	if (use_sysfs_caches) {
+		count_sysfs_caches(
+			valid_processors, arm_linux_processors, sysfs_caches, sysfs_cache_indices, &l2_count, &l3_count);
+	} else {
+		for (uint32_t i = 0; i < valid_processors; i++) {
+			if (arm_linux_processors[i].package_leader_id == arm_linux_processors[i].system_processor_id) {
+				cluster_id += 1;
+			}
 
-	if (uarchs_count > 1) {
-		linux_cpu_to_uarch_index_map = calloc(arm_linux_processors_count, sizeof(uint32_t));
-		if (linux_cpu_to_uarch_index_map == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for %"PRIu32" uarch index mapping entries",
-				arm_linux_processors_count * sizeof(uint32_t), arm_linux_processors_count);
-			goto cleanup;
+			struct cpuinfo_cache dummy_l1i, dummy_l1d, temp_l2 = { 0 }, temp_l3 = { 0 };
+			cpuinfo_arm_decode_cache(
+				arm_linux_processors[i].uarch,
+				arm_linux_processors[i].package_processor_count,
+				arm_linux_processors[i].midr,
+				&chipset,
+				cluster_id,
+				arm_linux_processors[i].architecture_version,
+				&dummy_l1i, &dummy_l1d, &temp_l2, &temp_l3);
+			if (temp_l3.size != 0) {
+				/*
+				 * Assumptions:
+				 * - L2 is private to each core
+				 * - L3 is shared by cores in the same cluster
+				 * - If cores in different clusters report the same L3, it is shared between all cores.
+				 */
+				l2_count += 1;
+				if (arm_linux_processors[i].package_leader_id == arm_linux_processors[i].system_processor_id) {
+					if (cluster_id == 0) {
+						big_l3_size = temp_l3.size;
+						l3_count = 1;
+					} else if (temp_l3.size != big_l3_size) {
+						/* If some cores have different L3 size, L3 is not shared between all cores */
+						shared_l3 = false;
+						l3_count += 1;
+					}
+				}
+			} else {
+				/* If some cores don't have L3 cache, L3 is not shared between all cores */
+				shared_l3 = false;
+				if (temp_l2.size != 0) {
+					/* Assume L2 is shared by cores in the same cluster */
+					if (arm_linux_processors[i].package_leader_id == arm_linux_processors[i].system_processor_id) {
+						l2_count += 1;
+					}
+				}
+			}
 		}
 	}
-
-	l1i = calloc(valid_processors, sizeof(struct cpuinfo_cache));
-	if (l1i == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1I caches",
-			valid_processors * sizeof(struct cpuinfo_cache), valid_processors);
+	/* The system-level cache of the SoC is behind L3, and is shared by all processors */
+	struct cpuinfo_cache system_cache;
+	cpuinfo_arm_decode_system_cache(&chipset, &system_cache);
+	const uint32_t l4_count = system_cache.size != 0 && l3_count != 0 ? 1 : 0;
+	cpuinfo_record_init_phase(cpuinfo_init_phase_caches, &phase_start);
+
+	const uint32_t uarch_index_map_count = uarchs_count > 1 ? arm_linux_processors_count : 0;
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_core));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, cluster_count, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset = cpuinfo_arena_reserve(&arena, 1, sizeof(struct cpuinfo_package));
+	const size_t uarchs_offset = cpuinfo_arena_reserve(&arena, uarchs_count, sizeof(struct cpuinfo_uarch_info));
+	const size_t uarch_tlbs_offset = cpuinfo_arena_reserve(&arena, uarchs_count, sizeof(struct cpuinfo_uarch_tlbs));
+	const size_t l1i_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_cache));
+	const size_t l1d_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_cache));
+	const size_t l2_offset = cpuinfo_arena_reserve(&arena, l2_count, sizeof(struct cpuinfo_cache));
+	const size_t l3_offset = cpuinfo_arena_reserve(&arena, l3_count, sizeof(struct cpuinfo_cache));
+	const size_t l4_offset = cpuinfo_arena_reserve(&arena, l4_count, sizeof(struct cpuinfo_cache));
+	const size_t linux_cpu_to_processor_map_offset =
+		cpuinfo_arena_reserve(&arena, arm_linux_processors_count, sizeof(struct cpuinfo_processor*));
+	const size_t linux_cpu_to_core_map_offset =
+		cpuinfo_arena_reserve(&arena, arm_linux_processors_count, sizeof(struct cpuinfo_core*));
+	const size_t linux_cpu_to_uarch_index_map_offset =
+		cpuinfo_arena_reserve(&arena, uarch_index_map_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
 		goto cleanup;
 	}
 
-	l1d = calloc(valid_processors, sizeof(struct cpuinfo_cache));
-	if (l1d == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1D caches",
-			valid_processors * sizeof(struct cpuinfo_cache), valid_processors);
-		goto cleanup;
-	}
+	processors = cpuinfo_arena_get(&arena, processors_offset, valid_processors);
+	cores = cpuinfo_arena_get(&arena, cores_offset, valid_processors);
+	clusters = cpuinfo_arena_get(&arena, clusters_offset, cluster_count);
+	packages = cpuinfo_arena_get(&arena, packages_offset, 1);
+	*packages = package;
+	uarchs = cpuinfo_arena_get(&arena, uarchs_offset, uarchs_count);
+	uarch_tlbs = cpuinfo_arena_get(&arena, uarch_tlbs_offset, uarchs_count);
+	l1i = cpuinfo_arena_get(&arena, l1i_offset, valid_processors);
+	l1d = cpuinfo_arena_get(&arena, l1d_offset, valid_processors);
+	l2 = cpuinfo_arena_get(&arena, l2_offset, l2_count);
+	l3 = cpuinfo_arena_get(&arena, l3_offset, l3_count);
+	l4 = cpuinfo_arena_get(&arena, l4_offset, l4_count);
+	linux_cpu_to_processor_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_processor_map_offset, arm_linux_processors_count);
+	linux_cpu_to_core_map = cpuinfo_arena_get(&arena, linux_cpu_to_core_map_offset, arm_linux_processors_count);
+	linux_cpu_to_uarch_index_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_uarch_index_map_offset, uarch_index_map_count);
 
 	uint32_t uarchs_index = 0;
 	for (uint32_t i = 0; i < arm_linux_processors_count; i++) {
@@ -500,6 +879,7 @@ void cpuinfo_arm_linux_init(void) {
 					.uarch = arm_linux_processors[i].uarch,
 					.midr = arm_linux_processors[i].midr,
 				};
+				cpuinfo_arm_decode_tlb(arm_linux_processors[i].uarch, &uarch_tlbs[uarchs_index]);
 				uarchs_index += 1;
 			}
 			uarchs[uarchs_index - 1].processor_count += 1;
@@ -507,10 +887,25 @@ void cpuinfo_arm_linux_init(void) {
 		}
 	}
 
-	uint32_t l2_count = 0, l3_count = 0, big_l3_size = 0, cluster_id = UINT32_MAX;
-	/* Indication whether L3 (if it exists) is shared between all cores */
-	bool shared_l3 = true;
+	/* Sorted valid processors precede invalid ones */
+	uint32_t max_capacity = 0, max_frequency = 0;
+	bool all_capacities = true;
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		if (arm_linux_processors[i].flags & CPUINFO_LINUX_FLAG_CAPACITY) {
+			max_capacity = max(max_capacity, arm_linux_processors[i].capacity);
+		} else {
+			all_capacities = false;
+		}
+		if (arm_linux_processors[i].flags & CPUINFO_LINUX_FLAG_MAX_FREQUENCY) {
+			max_frequency = max(max_frequency, arm_linux_processors[i].max_frequency);
+		}
+	}
+	if (!all_capacities) {
+		max_capacity = 0;
+	}
+
 	/* Populate cache information structures in l1i, l1d */
+	cluster_id = UINT32_MAX;
 	for (uint32_t i = 0; i < valid_processors; i++) {
 		if (arm_linux_processors[i].package_leader_id == arm_linux_processors[i].system_processor_id) {
 			cluster_id += 1;
@@ -520,17 +915,18 @@ void cpuinfo_arm_linux_init(void) {
 				.core_start = i,
 				.core_count = arm_linux_processors[i].package_processor_count,
 				.cluster_id = cluster_id,
-				.package = &package,
+				.package = packages,
 				.vendor = arm_linux_processors[i].vendor,
 				.uarch = arm_linux_processors[i].uarch,
 				.midr = arm_linux_processors[i].midr,
+				.capacity = get_normalized_capacity(&arm_linux_processors[i], max_capacity, max_frequency),
 			};
 		}
 
 		processors[i].smt_id = 0;
 		processors[i].core = cores + i;
 		processors[i].cluster = clusters + cluster_id;
-		processors[i].package = &package;
+		processors[i].package = packages;
 		processors[i].linux_id = (int) arm_linux_processors[i].system_processor_id;
 		processors[i].cache.l1i = l1i + i;
 		processors[i].cache.l1d = l1d + i;
@@ -540,10 +936,11 @@ void cpuinfo_arm_linux_init(void) {
 		cores[i].processor_count = 1;
 		cores[i].core_id = i;
 		cores[i].cluster = clusters + cluster_id;
-		cores[i].package = &package;
+		cores[i].package = packages;
 		cores[i].vendor = arm_linux_processors[i].vendor;
 		cores[i].uarch = arm_linux_processors[i].uarch;
 		cores[i].midr = arm_linux_processors[i].midr;
+		cores[i].capacity = get_normalized_capacity(&arm_linux_processors[i], max_capacity, max_frequency);
 		linux_cpu_to_core_map[arm_linux_processors[i].system_processor_id] = &cores[i];
 
 		if (linux_cpu_to_uarch_index_map != NULL) {
@@ -551,7 +948,7 @@ void cpuinfo_arm_linux_init(void) {
 				arm_linux_processors[i].uarch_index;
 		}
 
-		struct cpuinfo_cache temp_l2 = { 0 }, temp_l3 = { 0 };
+		struct cpuinfo_cache dummy_l2, dummy_l3;
 		cpuinfo_arm_decode_cache(
 			arm_linux_processors[i].uarch,
 			arm_linux_processors[i].package_processor_count,
@@ -559,9 +956,7 @@ void cpuinfo_arm_linux_init(void) {
 			&chipset,
 			cluster_id,
 			arm_linux_processors[i].architecture_version,
-			&l1i[i], &l1d[i], &temp_l2, &temp_l3);
-		l1i[i].processor_start = l1d[i].processor_start = i;
-		l1i[i].processor_count = l1d[i].processor_count = 1;
+			&l1i[i], &l1d[i], &dummy_l2, &dummy_l3);
 		#if CPUINFO_ARCH_ARM
 			/* L1I reported in /proc/cpuinfo overrides defaults */
 			if (bitmask_all(arm_linux_processors[i].flags, CPUINFO_ARM_LINUX_VALID_ICACHE)) {
@@ -584,53 +979,17 @@ void cpuinfo_arm_linux_init(void) {
 				};
 			}
 		#endif
-
-		if (temp_l3.size != 0) {
-			/*
-			 * Assumptions:
-			 * - L2 is private to each core
-			 * - L3 is shared by cores in the same cluster
-			 * - If cores in different clusters report the same L3, it is shared between all cores.
-			 */
-			l2_count += 1;
-			if (arm_linux_processors[i].package_leader_id == arm_linux_processors[i].system_processor_id) {
-				if (cluster_id == 0) {
-					big_l3_size = temp_l3.size;
-					l3_count = 1;
-				} else if (temp_l3.size != big_l3_size) {
-					/* If some cores have different L3 size, L3 is not shared between all cores */
-					shared_l3 = false;
-					l3_count += 1;
-				}
-			}
-		} else {
-			/* If some cores don't have L3 cache, L3 is not shared between all cores */
-			shared_l3 = false;
-			if (temp_l2.size != 0) {
-				/* Assume L2 is shared by cores in the same cluster */
-				if (arm_linux_processors[i].package_leader_id == arm_linux_processors[i].system_processor_id) {
-					l2_count += 1;
-				}
-			}
+		/* L1I and L1D reported in sysfs override both defaults and /proc/cpuinfo */
+		const uint32_t sysfs_l1i = arm_linux_processors[i].sysfs_cache[cpuinfo_cache_level_1i];
+		if (sysfs_l1i != 0) {
+			l1i[i] = sysfs_caches[sysfs_l1i - 1];
 		}
-	}
-
-	if (l2_count != 0) {
-		l2 = calloc(l2_count, sizeof(struct cpuinfo_cache));
-		if (l2 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L2 caches",
-				l2_count * sizeof(struct cpuinfo_cache), l2_count);
-			goto cleanup;
-		}
-
-		if (l3_count != 0) {
-			l3 = calloc(l3_count, sizeof(struct cpuinfo_cache));
-			if (l3 == NULL) {
-				cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L3 caches",
-					l3_count * sizeof(struct cpuinfo_cache), l3_count);
-				goto cleanup;
-			}
+		const uint32_t sysfs_l1d = arm_linux_processors[i].sysfs_cache[cpuinfo_cache_level_1d];
+		if (sysfs_l1d != 0) {
+			l1d[i] = sysfs_caches[sysfs_l1d - 1];
 		}
+		l1i[i].processor_start = l1d[i].processor_start = i;
+		l1i[i].processor_count = l1d[i].processor_count = 1;
 	}
 
 	cluster_id = UINT32_MAX;
@@ -650,6 +1009,25 @@ void cpuinfo_arm_linux_init(void) {
 			arm_linux_processors[i].architecture_version,
 			&dummy_l1i, &dummy_l1d, &temp_l2, &temp_l3);
 
+		if (use_sysfs_caches) {
+			/* sysfs doesn't report inclusiveness: copy flags from defaults */
+			const uint32_t sysfs_l2 = arm_linux_processors[i].sysfs_cache[cpuinfo_cache_level_2];
+			if (sysfs_l2 != 0) {
+				const uint32_t cache_index = sysfs_cache_indices[sysfs_l2 - 1];
+				l2[cache_index] = sysfs_caches[sysfs_l2 - 1];
+				l2[cache_index].flags = temp_l2.flags;
+				processors[i].cache.l2 = l2 + cache_index;
+			}
+			const uint32_t sysfs_l3 = arm_linux_processors[i].sysfs_cache[cpuinfo_cache_level_3];
+			if (sysfs_l3 != 0) {
+				const uint32_t cache_index = sysfs_cache_indices[sysfs_l3 - 1];
+				l3[cache_index] = sysfs_caches[sysfs_l3 - 1];
+				l3[cache_index].flags = temp_l3.flags;
+				processors[i].cache.l3 = l3 + cache_index;
+			}
+			continue;
+		}
+
 		if (temp_l3.size != 0) {
 			/*
 			 * Assumptions:
@@ -708,17 +1086,36 @@ void cpuinfo_arm_linux_init(void) {
 			processors[i].cache.l2 = l2 + l2_index;
 		}
 	}
+	if (l4_count != 0) {
+		*l4 = system_cache;
+		l4->processor_count = valid_processors;
+		for (uint32_t i = 0; i < valid_processors; i++) {
+			processors[i].cache.l4 = l4;
+		}
+	}
+
+	enum cpuinfo_linux_current_cpu_method current_cpu_method = cpuinfo_linux_current_cpu_method_syscall;
+	/* vDSO getcpu is also the fallback for threads without rseq area */
+	if (cpuinfo_linux_resolve_vdso_getcpu()) {
+		current_cpu_method = cpuinfo_linux_current_cpu_method_vdso;
+	}
+	if (cpuinfo_linux_rseq_is_registered()) {
+		current_cpu_method = cpuinfo_linux_current_cpu_method_rseq;
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_tables, &phase_start);
 
 	/* Commit */
 	cpuinfo_processors = processors;
 	cpuinfo_cores = cores;
 	cpuinfo_clusters = clusters;
-	cpuinfo_packages = &package;
+	cpuinfo_packages = packages;
 	cpuinfo_uarchs = uarchs;
+	cpuinfo_uarch_tlbs = uarch_tlbs;
 	cpuinfo_cache[cpuinfo_cache_level_1i] = l1i;
 	cpuinfo_cache[cpuinfo_cache_level_1d] = l1d;
 	cpuinfo_cache[cpuinfo_cache_level_2]  = l2;
 	cpuinfo_cache[cpuinfo_cache_level_3]  = l3;
+	cpuinfo_cache[cpuinfo_cache_level_4]  = l4;
 
 	cpuinfo_processors_count = valid_processors;
 	cpuinfo_cores_count = valid_processors;
@@ -729,37 +1126,28 @@ void cpuinfo_arm_linux_init(void) {
 	cpuinfo_cache_count[cpuinfo_cache_level_1d] = valid_processors;
 	cpuinfo_cache_count[cpuinfo_cache_level_2]  = l2_count;
 	cpuinfo_cache_count[cpuinfo_cache_level_3]  = l3_count;
+	cpuinfo_cache_count[cpuinfo_cache_level_4]  = l4_count;
 	cpuinfo_max_cache_size = cpuinfo_arm_compute_max_cache_size(&processors[0]);
+	cpuinfo_arm_linux_decode_accelerators(&chipset, &cpuinfo_integrated_gpu, &cpuinfo_npu);
 
 	cpuinfo_linux_cpu_max = arm_linux_processors_count;
+	cpuinfo_linux_current_cpu_method = current_cpu_method;
 	cpuinfo_linux_cpu_to_processor_map = linux_cpu_to_processor_map;
 	cpuinfo_linux_cpu_to_core_map = linux_cpu_to_core_map;
 	cpuinfo_linux_cpu_to_uarch_index_map = linux_cpu_to_uarch_index_map;
 
+	cpuinfo_arena_memory = arena.memory;
+
 	__sync_synchronize();
 
 	cpuinfo_is_initialized = true;
 
-	processors = NULL;
-	cores = NULL;
-	clusters = NULL;
-	uarchs = NULL;
-	l1i = l1d = l2 = l3 = NULL;
-	linux_cpu_to_processor_map = NULL;
-	linux_cpu_to_core_map = NULL;
-	linux_cpu_to_uarch_index_map = NULL;
+	arena.memory = NULL;
 
 cleanup:
-	free(arm_linux_processors);
-	free(processors);
-	free(cores);
-	free(clusters);
-	free(uarchs);
-	free(l1i);
-	free(l1d);
-	free(l2);
-	free(l3);
-	free(linux_cpu_to_processor_map);
-	free(linux_cpu_to_core_map);
-	free(linux_cpu_to_uarch_index_map);
+	cpuinfo_linux_release_sysfs();
+	cpuinfo_free_temporary(arm_linux_processors);
+	cpuinfo_free_temporary(sysfs_caches);
+	cpuinfo_free_temporary(sysfs_cache_indices);
+	cpuinfo_arena_free(arena.memory);
 }
@@ -28,6 +28,20 @@
 	#define CPUFAMILY_ARM_AVALANCHE_BLIZZARD 0xDA33D83D
 #endif
 
+/* Maximum number of performance levels (hw.nperflevels) */
+#define MAX_PERF_LEVELS 8
+
+/* Performance level of macOS 12+ and iOS 15+ from hw.perflevelN sysctls; level 0 has the highest performance */
+struct perf_level {
+	uint32_t physical_cpus;
+	uint32_t logical_cpus;
+	uint32_t l1i_cache_size;
+	uint32_t l1d_cache_size;
+	uint32_t l2_cache_size;
+	/* Number of logical processors sharing an L2 cache */
+	uint32_t cpus_per_l2;
+};
+
 struct cpuinfo_arm_isa cpuinfo_isa = {
 	.aes = true,
 	.sha1 = true,
@@ -98,6 +112,62 @@ static enum cpuinfo_uarch decode_uarch(uint32_t cpu_family, uint32_t core_index,
 	return cpuinfo_uarch_unknown;
 }
 
+/* Cores of level 0 are the big ones, which decode_uarch reports first; cores of other levels are the little ones */
+static enum cpuinfo_uarch decode_perf_level_uarch(uint32_t cpu_family, uint32_t perf_level, uint32_t core_count) {
+	return decode_uarch(cpu_family, perf_level == 0 ? 0 : core_count - 1, core_count);
+}
+
+static uint32_t get_perf_level_info(uint32_t perf_level, const char* name) {
+	char sysctl_name[64];
+	snprintf(sysctl_name, sizeof(sysctl_name), "hw.perflevel%"PRIu32".%s", perf_level, name);
+	return get_sys_info_by_name(sysctl_name);
+}
+
+/* Returns the number of performance levels, or 0 if the OS doesn't report them consistently with the topology */
+static uint32_t detect_perf_levels(
+	const struct cpuinfo_mach_topology topology[restrict static 1],
+	uint32_t threads_per_core,
+	struct perf_level perf_levels[restrict static MAX_PERF_LEVELS])
+{
+	const uint32_t perf_levels_count = get_sys_info_by_name("hw.nperflevels");
+	if (perf_levels_count == 0 || perf_levels_count > MAX_PERF_LEVELS) {
+		return 0;
+	}
+
+	uint32_t cores_count = 0, threads_count = 0;
+	for (uint32_t i = 0; i < perf_levels_count; i++) {
+		struct perf_level* perf_level = &perf_levels[i];
+		*perf_level = (struct perf_level) {
+			.physical_cpus = get_perf_level_info(i, "physicalcpu"),
+			.logical_cpus = get_perf_level_info(i, "logicalcpu"),
+			.l1i_cache_size = get_perf_level_info(i, "l1icachesize"),
+			.l1d_cache_size = get_perf_level_info(i, "l1dcachesize"),
+			.l2_cache_size = get_perf_level_info(i, "l2cachesize"),
+			.cpus_per_l2 = get_perf_level_info(i, "cpusperl2"),
+		};
+		if (perf_level->cpus_per_l2 == 0) {
+			perf_level->cpus_per_l2 = perf_level->logical_cpus;
+		}
+		if (perf_level->physical_cpus == 0 || perf_level->logical_cpus != perf_level->physical_cpus * threads_per_core ||
+			perf_level->cpus_per_l2 % threads_per_core != 0 || perf_level->logical_cpus % perf_level->cpus_per_l2 != 0)
+		{
+			cpuinfo_log_warning("ignoring inconsistent topology of performance level %"PRIu32": "
+				"%"PRIu32" cores, %"PRIu32" logical processors, %"PRIu32" logical processors per L2 cache",
+				i, perf_level->physical_cpus, perf_level->logical_cpus, perf_level->cpus_per_l2);
+			return 0;
+		}
+		cores_count += perf_level->physical_cpus;
+		threads_count += perf_level->logical_cpus;
+	}
+	if (cores_count != topology->cores || threads_count != topology->threads) {
+		cpuinfo_log_warning("ignoring performance levels with %"PRIu32" cores and %"PRIu32" logical processors: "
+			"expected %"PRIu32" cores and %"PRIu32" logical processors",
+			cores_count, threads_count, topology->cores, topology->threads);
+		return 0;
+	}
+	return perf_levels_count;
+}
+
 static void decode_package_name(char* package_name) {
 	size_t size;
 	if (sysctlbyname("hw.machine", NULL, &size, NULL, 0) != 0) {
@@ -223,51 +293,11 @@ static void decode_package_name(char* package_name) {
 }
 
 void cpuinfo_arm_mach_init(void) {
-	struct cpuinfo_processor* processors = NULL;
-	struct cpuinfo_core* cores = NULL;
-	struct cpuinfo_cluster* clusters = NULL;
-	struct cpuinfo_package* packages = NULL;
-	struct cpuinfo_uarch_info* uarchs = NULL;
-	struct cpuinfo_cache* l1i = NULL;
-	struct cpuinfo_cache* l1d = NULL;
-	struct cpuinfo_cache* l2 = NULL;
-	struct cpuinfo_cache* l3 = NULL;
-
 	struct cpuinfo_mach_topology mach_topology = cpuinfo_mach_detect_topology();
-	processors = calloc(mach_topology.threads, sizeof(struct cpuinfo_processor));
-	if (processors == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
-			mach_topology.threads * sizeof(struct cpuinfo_processor), mach_topology.threads);
-		goto cleanup;
-	}
-	cores = calloc(mach_topology.cores, sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			mach_topology.cores * sizeof(struct cpuinfo_core), mach_topology.cores);
-		goto cleanup;
-	}
-	packages = calloc(mach_topology.packages, sizeof(struct cpuinfo_package));
-	if (packages == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" packages",
-			mach_topology.packages * sizeof(struct cpuinfo_package), mach_topology.packages);
-		goto cleanup;
-	}
-
 	const uint32_t threads_per_core = mach_topology.threads / mach_topology.cores;
 	const uint32_t threads_per_package = mach_topology.threads / mach_topology.packages;
 	const uint32_t cores_per_package = mach_topology.cores / mach_topology.packages;
 
-	for (uint32_t i = 0; i < mach_topology.packages; i++) {
-		packages[i] = (struct cpuinfo_package) {
-			.processor_start = i * threads_per_package,
-			.processor_count = threads_per_package,
-			.core_start = i * cores_per_package,
-			.core_count = cores_per_package,
-		};
-		decode_package_name(packages[i].name);
-	}
-
-
 	const uint32_t cpu_family = get_sys_info_by_name("hw.cpufamily");
 
 	/*
@@ -288,6 +318,54 @@ void cpuinfo_arm_mach_init(void) {
 		}
 	}
 
+	const uint32_t has_feat_lse2 = get_sys_info_by_name("hw.optional.arm.FEAT_LSE2");
+	if (has_feat_lse2 != 0) {
+		cpuinfo_isa.lse2 = true;
+	}
+
+	const uint32_t has_feat_lse128 = get_sys_info_by_name("hw.optional.arm.FEAT_LSE128");
+	if (has_feat_lse128 != 0) {
+		cpuinfo_isa.lse128 = true;
+	}
+
+	const uint32_t has_feat_lrcpc = get_sys_info_by_name("hw.optional.arm.FEAT_LRCPC");
+	if (has_feat_lrcpc != 0) {
+		cpuinfo_isa.rcpc = true;
+	} else {
+		// Mandatory in ARMv8.3-A, list only cores released before iOS 15 / macOS 12
+		switch (cpu_family) {
+			case CPUFAMILY_ARM_VORTEX_TEMPEST:
+			case CPUFAMILY_ARM_LIGHTNING_THUNDER:
+			case CPUFAMILY_ARM_FIRESTORM_ICESTORM:
+				cpuinfo_isa.rcpc = true;
+		}
+	}
+
+	const uint32_t has_feat_lrcpc2 = get_sys_info_by_name("hw.optional.arm.FEAT_LRCPC2");
+	if (has_feat_lrcpc2 != 0) {
+		cpuinfo_isa.rcpc2 = true;
+	}
+
+	const uint32_t has_feat_lrcpc3 = get_sys_info_by_name("hw.optional.arm.FEAT_LRCPC3");
+	if (has_feat_lrcpc3 != 0) {
+		cpuinfo_isa.rcpc3 = true;
+	}
+
+	const uint32_t has_feat_wfxt = get_sys_info_by_name("hw.optional.arm.FEAT_WFxT");
+	if (has_feat_wfxt != 0) {
+		cpuinfo_isa.wfxt = true;
+	}
+
+	const uint32_t has_feat_pauth = get_sys_info_by_name("hw.optional.arm.FEAT_PAuth");
+	if (has_feat_pauth != 0) {
+		cpuinfo_isa.pauth = true;
+	}
+
+	const uint32_t has_feat_bti = get_sys_info_by_name("hw.optional.arm.FEAT_BTI");
+	if (has_feat_bti != 0) {
+		cpuinfo_isa.bti = true;
+	}
+
 	const uint32_t has_feat_rdm = get_sys_info_by_name("hw.optional.arm.FEAT_RDM");
 	if (has_feat_rdm != 0) {
 		cpuinfo_isa.rdm = true;
@@ -383,19 +461,179 @@ void cpuinfo_arm_mach_init(void) {
 		cpuinfo_isa.i8mm = true;
 	}
 
-	uint32_t num_clusters = 1;
-	for (uint32_t i = 0; i < mach_topology.cores; i++) {
-		cores[i] = (struct cpuinfo_core) {
-			.processor_start = i * threads_per_core,
-			.processor_count = threads_per_core,
-			.core_id = i % cores_per_package,
-			.package = packages + i / cores_per_package,
-			.vendor = cpuinfo_vendor_apple,
-			.uarch = decode_uarch(cpu_family, i, mach_topology.cores),
+	const uint32_t has_feat_sha3 = get_sys_info_by_name("hw.optional.arm.FEAT_SHA3");
+	if (has_feat_sha3 != 0) {
+		cpuinfo_isa.sha3 = true;
+	} else {
+		// Optional in ARMv8.2-A (implemented in Apple cores),
+		// list only cores released before iOS 15 / macOS 12
+		switch (cpu_family) {
+			case CPUFAMILY_ARM_LIGHTNING_THUNDER:
+			case CPUFAMILY_ARM_FIRESTORM_ICESTORM:
+				cpuinfo_isa.sha3 = true;
+		}
+	}
+
+	const uint32_t has_feat_sha512 = get_sys_info_by_name("hw.optional.arm.FEAT_SHA512");
+	if (has_feat_sha512 != 0) {
+		cpuinfo_isa.sha512 = true;
+	} else {
+		// Optional in ARMv8.2-A (implemented in Apple cores),
+		// list only cores released before iOS 15 / macOS 12
+		switch (cpu_family) {
+			case CPUFAMILY_ARM_LIGHTNING_THUNDER:
+			case CPUFAMILY_ARM_FIRESTORM_ICESTORM:
+				cpuinfo_isa.sha512 = true;
+		}
+	}
+
+	const uint32_t has_feat_rng = get_sys_info_by_name("hw.optional.arm.FEAT_RNG");
+	if (has_feat_rng != 0) {
+		cpuinfo_isa.rng = true;
+	}
+
+	const uint32_t has_feat_sme = get_sys_info_by_name("hw.optional.arm.FEAT_SME");
+	if (has_feat_sme != 0) {
+		cpuinfo_isa.sme = true;
+	}
+
+	const uint32_t has_feat_sme2 = get_sys_info_by_name("hw.optional.arm.FEAT_SME2");
+	if (has_feat_sme2 != 0) {
+		cpuinfo_isa.sme2 = true;
+	}
+
+	const uint32_t has_feat_sme_f64f64 = get_sys_info_by_name("hw.optional.arm.FEAT_SME_F64F64");
+	if (has_feat_sme_f64f64 != 0) {
+		cpuinfo_isa.sme_f64f64 = true;
+	}
+
+	const uint32_t has_feat_sme_i16i64 = get_sys_info_by_name("hw.optional.arm.FEAT_SME_I16I64");
+	if (has_feat_sme_i16i64 != 0) {
+		cpuinfo_isa.sme_i16i64 = true;
+	}
+
+	const uint32_t has_feat_sme_fa64 = get_sys_info_by_name("hw.optional.arm.FEAT_SME_FA64");
+	if (has_feat_sme_fa64 != 0) {
+		cpuinfo_isa.sme_fa64 = true;
+	}
+
+	struct perf_level perf_levels[MAX_PERF_LEVELS];
+	uint32_t perf_levels_count = detect_perf_levels(&mach_topology, threads_per_core, perf_levels);
+	const bool has_perf_levels = perf_levels_count != 0;
+	if (!has_perf_levels) {
+		/* A single level with the L2 cache shared between all cores */
+		perf_levels_count = 1;
+		perf_levels[0] = (struct perf_level) {
+			.physical_cpus = mach_topology.cores,
+			.logical_cpus = mach_topology.threads,
+			.l1i_cache_size = get_sys_info(HW_L1ICACHESIZE, "HW_L1ICACHESIZE"),
+			.l1d_cache_size = get_sys_info(HW_L1DCACHESIZE, "HW_L1DCACHESIZE"),
+			.l2_cache_size = get_sys_info(HW_L2CACHESIZE, "HW_L2CACHESIZE"),
+			.cpus_per_l2 = mach_topology.threads,
+		};
+	}
+	cpuinfo_log_debug("detected %"PRIu32" performance levels", perf_levels_count);
+
+	const uint32_t cacheline_size = get_sys_info(HW_CACHELINE, "HW_CACHELINE");
+	const uint32_t l3_cache_size = get_sys_info(HW_L3CACHESIZE, "HW_L3CACHESIZE");
+	const uint32_t l1_cache_associativity = 4;
+	const uint32_t l2_cache_associativity = 8;
+	const uint32_t l3_cache_associativity = 16;
+	const uint32_t cache_partitions = 1;
+	const uint32_t cache_flags = 0;
+
+	/* Assume L1 caches are private to each core */
+	bool has_l1i = false, has_l1d = false;
+	uint32_t l1_count = 0, l2_count = 0;
+	for (uint32_t level = 0; level < perf_levels_count; level++) {
+		has_l1i |= perf_levels[level].l1i_cache_size != 0;
+		has_l1d |= perf_levels[level].l1d_cache_size != 0;
+		if (perf_levels[level].l2_cache_size != 0) {
+			l2_count += perf_levels[level].logical_cpus / perf_levels[level].cpus_per_l2;
+		}
+	}
+	if (has_l1i || has_l1d) {
+		l1_count = mach_topology.threads;
+		cpuinfo_log_debug("detected %"PRIu32" L1 caches", l1_count);
+	}
+	if (l2_count != 0) {
+		cpuinfo_log_debug("detected %"PRIu32" L2 caches", l2_count);
+	}
+
+	uint32_t threads_per_l3 = 0, l3_count = 0;
+	if (l3_cache_size != 0) {
+		/* Assume L3 cache is shared between all cores */
+		threads_per_l3 = mach_topology.cores;
+		l3_count = 1;
+		cpuinfo_log_debug("detected %"PRIu32" L3 caches", l3_count);
+	}
+
+	struct cpuinfo_arena arena = { NULL, 0 };
+	const size_t processors_offset =
+		cpuinfo_arena_reserve(&arena, mach_topology.threads, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, mach_topology.cores, sizeof(struct cpuinfo_core));
+	/* Clusters and their uarchs are counted while cores are described: reserve one for every core */
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, mach_topology.cores, sizeof(struct cpuinfo_cluster));
+	const size_t uarchs_offset = cpuinfo_arena_reserve(&arena, mach_topology.cores, sizeof(struct cpuinfo_uarch_info));
+	const size_t packages_offset =
+		cpuinfo_arena_reserve(&arena, mach_topology.packages, sizeof(struct cpuinfo_package));
+	const uint32_t l1i_count = has_l1i ? l1_count : 0;
+	const uint32_t l1d_count = has_l1d ? l1_count : 0;
+	const size_t l1i_offset = cpuinfo_arena_reserve(&arena, l1i_count, sizeof(struct cpuinfo_cache));
+	const size_t l1d_offset = cpuinfo_arena_reserve(&arena, l1d_count, sizeof(struct cpuinfo_cache));
+	const size_t l2_offset = cpuinfo_arena_reserve(&arena, l2_count, sizeof(struct cpuinfo_cache));
+	const size_t l3_offset = cpuinfo_arena_reserve(&arena, l3_count, sizeof(struct cpuinfo_cache));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return;
+	}
+
+	struct cpuinfo_processor* processors = cpuinfo_arena_get(&arena, processors_offset, mach_topology.threads);
+	struct cpuinfo_core* cores = cpuinfo_arena_get(&arena, cores_offset, mach_topology.cores);
+	struct cpuinfo_cluster* clusters = cpuinfo_arena_get(&arena, clusters_offset, mach_topology.cores);
+	struct cpuinfo_uarch_info* uarchs = cpuinfo_arena_get(&arena, uarchs_offset, mach_topology.cores);
+	struct cpuinfo_package* packages = cpuinfo_arena_get(&arena, packages_offset, mach_topology.packages);
+	struct cpuinfo_cache* l1i = cpuinfo_arena_get(&arena, l1i_offset, l1i_count);
+	struct cpuinfo_cache* l1d = cpuinfo_arena_get(&arena, l1d_offset, l1d_count);
+	struct cpuinfo_cache* l2 = cpuinfo_arena_get(&arena, l2_offset, l2_count);
+	struct cpuinfo_cache* l3 = cpuinfo_arena_get(&arena, l3_offset, l3_count);
+
+	for (uint32_t i = 0; i < mach_topology.packages; i++) {
+		packages[i] = (struct cpuinfo_package) {
+			.processor_start = i * threads_per_package,
+			.processor_count = threads_per_package,
+			.core_start = i * cores_per_package,
+			.core_count = cores_per_package,
 		};
-		if (i != 0 && cores[i].uarch != cores[i - 1].uarch) {
-			num_clusters++;
+		decode_package_name(packages[i].name);
+	}
+
+	/*
+	 * Cores of every performance level are consecutive, from level 0. With performance levels, cores sharing an L2
+	 * cache form a cluster, e.g. on every die of Ultra parts; otherwise, consecutive cores of the same uarch do.
+	 */
+	bool* cluster_starts = (bool*) alloca(mach_topology.cores * sizeof(bool));
+	uint32_t num_clusters = 0;
+	for (uint32_t level = 0, level_core_start = 0; level < perf_levels_count; level++) {
+		const uint32_t cores_per_l2 = perf_levels[level].cpus_per_l2 / threads_per_core;
+		for (uint32_t i = level_core_start; i < level_core_start + perf_levels[level].physical_cpus; i++) {
+			cores[i] = (struct cpuinfo_core) {
+				.processor_start = i * threads_per_core,
+				.processor_count = threads_per_core,
+				.core_id = i % cores_per_package,
+				.package = packages + i / cores_per_package,
+				.vendor = cpuinfo_vendor_apple,
+				.uarch = has_perf_levels ?
+					decode_perf_level_uarch(cpu_family, level, mach_topology.cores) :
+					decode_uarch(cpu_family, i, mach_topology.cores),
+			};
+			if (has_perf_levels) {
+				cluster_starts[i] = (i - level_core_start) % cores_per_l2 == 0;
+			} else {
+				cluster_starts[i] = i == 0 || cores[i].uarch != cores[i - 1].uarch;
+			}
+			num_clusters += (uint32_t) cluster_starts[i];
 		}
+		level_core_start += perf_levels[level].physical_cpus;
 	}
 	for (uint32_t i = 0; i < mach_topology.threads; i++) {
 		const uint32_t smt_id = i % threads_per_core;
@@ -407,45 +645,36 @@ void cpuinfo_arm_mach_init(void) {
 		processors[i].package = &packages[package_id];
 	}
 
-	clusters = calloc(num_clusters, sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error(
-			"failed to allocate %zu bytes for descriptions of %"PRIu32" clusters",
-			num_clusters * sizeof(struct cpuinfo_cluster), num_clusters);
-		goto cleanup;
-	}
-	uarchs = calloc(num_clusters, sizeof(struct cpuinfo_uarch_info));
-	if (uarchs == NULL) {
-		cpuinfo_log_error(
-			"failed to allocate %zu bytes for descriptions of %"PRIu32" uarchs",
-			num_clusters * sizeof(enum cpuinfo_uarch), num_clusters);
-		goto cleanup;
-	}
+	/* Clusters of the same uarch, e.g. on different dies, share the uarch description */
+	uint32_t num_uarchs = 0;
 	uint32_t cluster_idx = UINT32_MAX;
+	uint32_t uarch_idx = UINT32_MAX;
 	for (uint32_t i = 0; i < mach_topology.cores; i++) {
-		if (i == 0 || cores[i].uarch != cores[i - 1].uarch) {
+		if (cluster_starts[i]) {
 			cluster_idx++;
-			uarchs[cluster_idx] = (struct cpuinfo_uarch_info) {
-				.uarch = cores[i].uarch,
-				.processor_count = 1,
-				.core_count = 1,
-			};
 			clusters[cluster_idx] = (struct cpuinfo_cluster) {
 				.processor_start = i * threads_per_core,
-				.processor_count = 1,
 				.core_start = i,
-				.core_count = 1,
 				.cluster_id = cluster_idx,
 				.package = cores[i].package,
 				.vendor = cores[i].vendor,
 				.uarch = cores[i].uarch,
 			};
-		} else {
-			uarchs[cluster_idx].processor_count++;
-			uarchs[cluster_idx].core_count++;
-			clusters[cluster_idx].processor_count++;
-			clusters[cluster_idx].core_count++;
+			for (uarch_idx = 0; uarch_idx < num_uarchs; uarch_idx++) {
+				if (uarchs[uarch_idx].uarch == cores[i].uarch) {
+					break;
+				}
+			}
+			if (uarch_idx == num_uarchs) {
+				uarchs[num_uarchs++] = (struct cpuinfo_uarch_info) {
+					.uarch = cores[i].uarch,
+				};
+			}
 		}
+		uarchs[uarch_idx].processor_count += threads_per_core;
+		uarchs[uarch_idx].core_count++;
+		clusters[cluster_idx].processor_count += threads_per_core;
+		clusters[cluster_idx].core_count++;
 		cores[i].cluster = &clusters[cluster_idx];
 	}
 
@@ -459,120 +688,72 @@ void cpuinfo_arm_mach_init(void) {
 		packages[i].cluster_count = num_clusters;
 	}
 
-	const uint32_t cacheline_size = get_sys_info(HW_CACHELINE, "HW_CACHELINE");
-	const uint32_t l1d_cache_size = get_sys_info(HW_L1DCACHESIZE, "HW_L1DCACHESIZE");
-	const uint32_t l1i_cache_size = get_sys_info(HW_L1ICACHESIZE, "HW_L1ICACHESIZE");
-	const uint32_t l2_cache_size = get_sys_info(HW_L2CACHESIZE, "HW_L2CACHESIZE");
-	const uint32_t l3_cache_size = get_sys_info(HW_L3CACHESIZE, "HW_L3CACHESIZE");
-	const uint32_t l1_cache_associativity = 4;
-	const uint32_t l2_cache_associativity = 8;
-	const uint32_t l3_cache_associativity = 16;
-	const uint32_t cache_partitions = 1;
-	const uint32_t cache_flags = 0;
-
-	uint32_t threads_per_l1 = 0, l1_count = 0;
-	if (l1i_cache_size != 0 || l1d_cache_size != 0) {
-		/* Assume L1 caches are private to each core */
-		threads_per_l1 = 1;
-		l1_count = mach_topology.threads / threads_per_l1;
-		cpuinfo_log_debug("detected %"PRIu32" L1 caches", l1_count);
-	}
-
-	uint32_t threads_per_l2 = 0, l2_count = 0;
-	if (l2_cache_size != 0) {
-		/* Assume L2 cache is shared between all cores */
-		threads_per_l2 = mach_topology.cores;
-		l2_count = 1;
-		cpuinfo_log_debug("detected %"PRIu32" L2 caches", l2_count);
-	}
-
-	uint32_t threads_per_l3 = 0, l3_count = 0;
-	if (l3_cache_size != 0) {
-		/* Assume L3 cache is shared between all cores */
-		threads_per_l3 = mach_topology.cores;
-		l3_count = 1;
-		cpuinfo_log_debug("detected %"PRIu32" L3 caches", l3_count);
-	}
-
-	if (l1i_cache_size != 0) {
-		l1i = calloc(l1_count, sizeof(struct cpuinfo_cache));
-		if (l1i == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1I caches",
-				l1_count * sizeof(struct cpuinfo_cache), l1_count);
-			goto cleanup;
-		}
-		for (uint32_t c = 0; c < l1_count; c++) {
-			l1i[c] = (struct cpuinfo_cache) {
-				.size            = l1i_cache_size,
-				.associativity   = l1_cache_associativity,
-				.sets            = l1i_cache_size / (l1_cache_associativity * cacheline_size),
-				.partitions      = cache_partitions,
-				.line_size       = cacheline_size,
-				.flags           = cache_flags,
-				.processor_start = c * threads_per_l1,
-				.processor_count = threads_per_l1,
-			};
-		}
-		for (uint32_t t = 0; t < mach_topology.threads; t++) {
-			processors[t].cache.l1i = &l1i[t / threads_per_l1];
+	if (has_l1i) {
+		for (uint32_t level = 0, t = 0; level < perf_levels_count; level++) {
+			const uint32_t l1i_cache_size = perf_levels[level].l1i_cache_size;
+			for (const uint32_t level_end = t + perf_levels[level].logical_cpus; t < level_end; t++) {
+				l1i[t] = (struct cpuinfo_cache) {
+					.size            = l1i_cache_size,
+					.associativity   = l1_cache_associativity,
+					.sets            = l1i_cache_size / (l1_cache_associativity * cacheline_size),
+					.partitions      = cache_partitions,
+					.line_size       = cacheline_size,
+					.flags           = cache_flags,
+					.processor_start = t,
+					.processor_count = 1,
+				};
+				processors[t].cache.l1i = &l1i[t];
+			}
 		}
 	}
 
-	if (l1d_cache_size != 0) {
-		l1d = calloc(l1_count, sizeof(struct cpuinfo_cache));
-		if (l1d == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1D caches",
-				l1_count * sizeof(struct cpuinfo_cache), l1_count);
-			goto cleanup;
-		}
-		for (uint32_t c = 0; c < l1_count; c++) {
-			l1d[c] = (struct cpuinfo_cache) {
-				.size            = l1d_cache_size,
-				.associativity   = l1_cache_associativity,
-				.sets            = l1d_cache_size / (l1_cache_associativity * cacheline_size),
-				.partitions      = cache_partitions,
-				.line_size       = cacheline_size,
-				.flags           = cache_flags,
-				.processor_start = c * threads_per_l1,
-				.processor_count = threads_per_l1,
-			};
-		}
-		for (uint32_t t = 0; t < mach_topology.threads; t++) {
-			processors[t].cache.l1d = &l1d[t / threads_per_l1];
+	if (has_l1d) {
+		for (uint32_t level = 0, t = 0; level < perf_levels_count; level++) {
+			const uint32_t l1d_cache_size = perf_levels[level].l1d_cache_size;
+			for (const uint32_t level_end = t + perf_levels[level].logical_cpus; t < level_end; t++) {
+				l1d[t] = (struct cpuinfo_cache) {
+					.size            = l1d_cache_size,
+					.associativity   = l1_cache_associativity,
+					.sets            = l1d_cache_size / (l1_cache_associativity * cacheline_size),
+					.partitions      = cache_partitions,
+					.line_size       = cacheline_size,
+					.flags           = cache_flags,
+					.processor_start = t,
+					.processor_count = 1,
+				};
+				processors[t].cache.l1d = &l1d[t];
+			}
 		}
 	}
 
 	if (l2_count != 0) {
-		l2 = calloc(l2_count, sizeof(struct cpuinfo_cache));
-		if (l2 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L2 caches",
-				l2_count * sizeof(struct cpuinfo_cache), l2_count);
-			goto cleanup;
-		}
-		for (uint32_t c = 0; c < l2_count; c++) {
-			l2[c] = (struct cpuinfo_cache) {
-				.size            = l2_cache_size,
-				.associativity   = l2_cache_associativity,
-				.sets            = l2_cache_size / (l2_cache_associativity * cacheline_size),
-				.partitions      = cache_partitions,
-				.line_size       = cacheline_size,
-				.flags           = cache_flags,
-				.processor_start = c * threads_per_l2,
-				.processor_count = threads_per_l2,
-			};
-		}
-		for (uint32_t t = 0; t < mach_topology.threads; t++) {
-			processors[t].cache.l2 = &l2[0];
+		/* Every performance level has its own L2 caches, each shared by cpusperl2 logical processors */
+		uint32_t c = 0;
+		for (uint32_t level = 0, level_start = 0; level < perf_levels_count; level++) {
+			const struct perf_level* perf_level = &perf_levels[level];
+			for (uint32_t l2_start = level_start; perf_level->l2_cache_size != 0 &&
+				l2_start < level_start + perf_level->logical_cpus; l2_start += perf_level->cpus_per_l2)
+			{
+				l2[c] = (struct cpuinfo_cache) {
+					.size            = perf_level->l2_cache_size,
+					.associativity   = l2_cache_associativity,
+					.sets            = perf_level->l2_cache_size / (l2_cache_associativity * cacheline_size),
+					.partitions      = cache_partitions,
+					.line_size       = cacheline_size,
+					.flags           = cache_flags,
+					.processor_start = l2_start,
+					.processor_count = perf_level->cpus_per_l2,
+				};
+				for (uint32_t t = l2_start; t < l2_start + perf_level->cpus_per_l2; t++) {
+					processors[t].cache.l2 = &l2[c];
+				}
+				c++;
+			}
+			level_start += perf_level->logical_cpus;
 		}
 	}
 
 	if (l3_count != 0) {
-		l3 = calloc(l3_count, sizeof(struct cpuinfo_cache));
-		if (l3 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L3 caches",
-												l3_count * sizeof(struct cpuinfo_cache), l3_count);
-			goto cleanup;
-		}
 		for (uint32_t c = 0; c < l3_count; c++) {
 			l3[c] = (struct cpuinfo_cache) {
 				.size            = l3_cache_size,
@@ -605,32 +786,16 @@ void cpuinfo_arm_mach_init(void) {
 	cpuinfo_cores_count = mach_topology.cores;
 	cpuinfo_clusters_count = num_clusters;
 	cpuinfo_packages_count = mach_topology.packages;
-	cpuinfo_uarchs_count = num_clusters;
+	cpuinfo_uarchs_count = num_uarchs;
 	cpuinfo_cache_count[cpuinfo_cache_level_1i] = l1_count;
 	cpuinfo_cache_count[cpuinfo_cache_level_1d] = l1_count;
 	cpuinfo_cache_count[cpuinfo_cache_level_2]  = l2_count;
 	cpuinfo_cache_count[cpuinfo_cache_level_3]  = l3_count;
 	cpuinfo_max_cache_size = cpuinfo_compute_max_cache_size(&processors[0]);
 
+	cpuinfo_arena_memory = arena.memory;
+
 	__sync_synchronize();
 
 	cpuinfo_is_initialized = true;
-
-	processors = NULL;
-	cores = NULL;
-	clusters = NULL;
-	packages = NULL;
-	uarchs = NULL;
-	l1i = l1d = l2 = l3 = NULL;
-
-cleanup:
-	free(processors);
-	free(cores);
-	free(clusters);
-	free(packages);
-	free(uarchs);
-	free(l1i);
-	free(l1d);
-	free(l2);
-	free(l3);
 }
@@ -2,6 +2,7 @@
 
 #include <arm/api.h>
 #include <arm/midr.h>
+#include <cpuinfo/internal-api.h>
 #include <cpuinfo/log.h>
 
 
@@ -13,6 +14,13 @@ void cpuinfo_arm_decode_vendor_uarch(
 	enum cpuinfo_vendor vendor[restrict static 1],
 	enum cpuinfo_uarch uarch[restrict static 1])
 {
+	const struct cpuinfo_uarch_table_entry* entry = cpuinfo_find_uarch_table_entry(midr);
+	if (entry != NULL) {
+		*vendor = entry->vendor;
+		*uarch = entry->uarch;
+		return;
+	}
+
 	switch (midr_get_implementer(midr)) {
 		case 'A':
 			*vendor = cpuinfo_vendor_arm;
@@ -121,6 +129,9 @@ void cpuinfo_arm_decode_vendor_uarch(
 				case 0xD4E: /* Cortex-X3 */
 					*uarch = cpuinfo_uarch_cortex_x3;
 					break;
+				case 0xD80: /* Cortex-A520 */
+					*uarch = cpuinfo_uarch_cortex_a520;
+					break;
 				default:
 					switch (midr_get_part(midr) >> 8) {
 #if CPUINFO_ARCH_ARM
@@ -377,3 +388,91 @@ void cpuinfo_arm_decode_vendor_uarch(
 				(char) midr_get_implementer(midr), midr_get_implementer(midr), midr_get_part(midr));
 	}
 }
+
+struct cpuinfo_uarch_streaming_hints cpuinfo_arm_decode_streaming_hints(enum cpuinfo_uarch uarch) {
+	switch (uarch) {
+		case cpuinfo_uarch_cortex_a5:
+		case cpuinfo_uarch_cortex_a7:
+		case cpuinfo_uarch_cortex_a32:
+		case cpuinfo_uarch_cortex_a35:
+		case cpuinfo_uarch_cortex_a53:
+		case cpuinfo_uarch_cortex_a55r0:
+		case cpuinfo_uarch_cortex_a55:
+		case cpuinfo_uarch_cortex_a510:
+		case cpuinfo_uarch_cortex_a520:
+		case cpuinfo_uarch_brahma_b53:
+			/* In-order cores stall on misses: prefetch a few lines ahead, and stream when half of LLC is filled */
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 256,
+				.llc_sixteenths = 8,
+			};
+		case cpuinfo_uarch_cortex_a76:
+		case cpuinfo_uarch_cortex_a77:
+		case cpuinfo_uarch_cortex_a78:
+		case cpuinfo_uarch_cortex_a710:
+		case cpuinfo_uarch_cortex_a715:
+		case cpuinfo_uarch_cortex_x1:
+		case cpuinfo_uarch_cortex_x2:
+		case cpuinfo_uarch_cortex_x3:
+		case cpuinfo_uarch_neoverse_n1:
+		case cpuinfo_uarch_neoverse_v1:
+		case cpuinfo_uarch_neoverse_n2:
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 512,
+				.llc_sixteenths = 12,
+			};
+		case cpuinfo_uarch_vortex:
+		case cpuinfo_uarch_lightning:
+		case cpuinfo_uarch_firestorm:
+		case cpuinfo_uarch_avalanche:
+			/* Apple performance cores have 128-byte cache lines and very deep reorder buffers */
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 1024,
+				.llc_sixteenths = 12,
+			};
+		default:
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 256,
+				.llc_sixteenths = 12,
+			};
+	}
+}
+
+void cpuinfo_arm_add_uarch_isa_features(
+	enum cpuinfo_uarch uarch,
+	struct cpuinfo_isa_features features[restrict static 1])
+{
+	/* Only NEON features: SVE and SME state is managed by the kernel, and traps unless all cores support it */
+	switch (uarch) {
+		case cpuinfo_uarch_cortex_a510:
+		case cpuinfo_uarch_cortex_a520:
+		case cpuinfo_uarch_cortex_a710:
+		case cpuinfo_uarch_cortex_a715:
+		case cpuinfo_uarch_cortex_x2:
+		case cpuinfo_uarch_cortex_x3:
+		case cpuinfo_uarch_neoverse_v1:
+		case cpuinfo_uarch_neoverse_n2:
+			cpuinfo_isa_features_add(features, cpuinfo_isa_feature_arm_fhm);
+			cpuinfo_isa_features_add(features, cpuinfo_isa_feature_arm_i8mm);
+			cpuinfo_isa_features_add(features, cpuinfo_isa_feature_arm_neon_bf16);
+			/* fallthrough */
+		case cpuinfo_uarch_cortex_a55r0:
+		case cpuinfo_uarch_cortex_a55:
+		case cpuinfo_uarch_cortex_a65:
+		case cpuinfo_uarch_cortex_a75:
+		case cpuinfo_uarch_cortex_a76:
+		case cpuinfo_uarch_cortex_a77:
+		case cpuinfo_uarch_cortex_a78:
+		case cpuinfo_uarch_cortex_x1:
+		case cpuinfo_uarch_neoverse_n1:
+		case cpuinfo_uarch_neoverse_e1:
+		case cpuinfo_uarch_exynos_m4:
+		case cpuinfo_uarch_exynos_m5:
+			cpuinfo_isa_features_add(features, cpuinfo_isa_feature_arm_neon_rdm);
+			cpuinfo_isa_features_add(features, cpuinfo_isa_feature_arm_neon_fp16_arith);
+			cpuinfo_isa_features_add(features, cpuinfo_isa_feature_arm_neon_dot);
+			break;
+		default:
+			break;
+	}
+}
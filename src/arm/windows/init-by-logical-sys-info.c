@@ -9,6 +9,7 @@
 #include <cpuinfo.h>
 #include <cpuinfo/internal-api.h>
 #include <cpuinfo/log.h>
+#include <windows/api.h>
 
 #include "windows-arm-init.h"
 
@@ -16,6 +17,7 @@
 
 /* Call chain:
  * cpu_info_init_by_logical_sys_info
+ * 		cpuinfo_windows_query_topology
  * 		read_packages_for_processors
  * 		read_cores_for_processors
  * 		read_caches_for_processors
@@ -25,19 +27,25 @@
  * 					store_core_info_per_processor
  * 				parse_relation_cache_info
  * 					store_cache_info_per_processor
+ * 		read_frequencies_for_cores
+ * 			get_processor_frequencies
+ * 		assign_clusters_to_processors
  */
 
 static uint32_t count_logical_processors(
+	const struct cpuinfo_windows_topology* topology,
 	const uint32_t max_group_count,
 	uint32_t* global_proc_index_per_group);
 
 static uint32_t read_packages_for_processors(
+	const struct cpuinfo_windows_topology* topology,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
 	const uint32_t* global_proc_index_per_group,
 	const struct woa_chip_info *chip_info);
 
 static uint32_t read_cores_for_processors(
+	const struct cpuinfo_windows_topology* topology,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
 	const uint32_t* global_proc_index_per_group,
@@ -45,6 +53,7 @@ static uint32_t read_cores_for_processors(
 	const struct woa_chip_info *chip_info);
 
 static uint32_t read_caches_for_processors(
+	const struct cpuinfo_windows_topology* topology,
 	struct cpuinfo_processor *processors,
 	const uint32_t number_of_processors,
 	struct cpuinfo_cache *caches,
@@ -53,6 +62,7 @@ static uint32_t read_caches_for_processors(
 	const struct woa_chip_info *chip_info);
 
 static uint32_t read_all_logical_processor_info_of_relation(
+	const struct cpuinfo_windows_topology* topology,
 	LOGICAL_PROCESSOR_RELATIONSHIP info_type,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
@@ -99,12 +109,21 @@ static void store_cache_info_per_processor(
 	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info,
 	struct cpuinfo_cache* current_cache);
 
+static bool read_frequencies_for_cores(
+	struct cpuinfo_processor* processors,
+	const uint32_t nr_of_processors);
+
+static uint32_t assign_clusters_to_processors(
+	struct cpuinfo_processor* processors,
+	const uint32_t nr_of_processors);
+
 static bool connect_packages_cores_clusters_by_processors(
 	struct cpuinfo_processor* processors,
 	const uint32_t nr_of_processors,
 	struct cpuinfo_package* packages,
 	const uint32_t nr_of_packages,
 	struct cpuinfo_cluster* clusters,
+	const uint32_t nr_of_clusters,
 	struct cpuinfo_core* cores,
 	const uint32_t nr_of_cores,
 	const struct woa_chip_info* chip_info,
@@ -123,8 +142,11 @@ bool cpu_info_init_by_logical_sys_info(
 	struct cpuinfo_core* cores = NULL;
 	struct cpuinfo_cache* caches = NULL;
 	struct cpuinfo_uarch_info* uarchs = NULL;
+	struct cpuinfo_processor* temporary_processors = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
 
 	uint32_t nr_of_packages = 0;
+	uint32_t nr_of_clusters = 0;
 	uint32_t nr_of_cores = 0;
 	uint32_t nr_of_all_caches = 0;
 	uint32_t numbers_of_caches[MAX_NR_OF_CACHES] = {0};
@@ -132,10 +154,18 @@ bool cpu_info_init_by_logical_sys_info(
 	uint32_t nr_of_uarchs = 0;
 	bool result = false;
 	
-	HANDLE heap = GetProcessHeap();
+	struct cpuinfo_windows_topology topology = { 0 };
+	uint32_t* global_proc_index_per_group = NULL;
+
 
-	/* 1. Count available logical processor groups and processors */
-	const uint32_t max_group_count = (uint32_t) GetMaximumProcessorGroupCount();
+	/* 1. Read topology information via MSDN API: groups, packages, cores and caches in a single query */
+	if (!cpuinfo_windows_query_topology(RelationAll, &topology)) {
+		cpuinfo_log_error("error in reading logical processor information");
+		goto clean_up;
+	}
+
+	/* Count available logical processor groups and processors */
+	const uint32_t max_group_count = cpuinfo_windows_get_max_group_count(&topology);
 	cpuinfo_log_debug("detected %"PRIu32" processor group(s)", max_group_count);
 	/* We need to store the absolute processor ID offsets for every groups, because
 	 *  1. We can't assume every processor groups include the same number of
@@ -144,8 +174,8 @@ bool cpu_info_init_by_logical_sys_info(
 	 *     the group, but not the global processor IDs.
 	 *  3. We need to list every logical processors by global IDs.
 	*/
-	uint32_t* global_proc_index_per_group =
-		(uint32_t*) HeapAlloc(heap, 0, max_group_count * sizeof(uint32_t));
+	global_proc_index_per_group =
+		(uint32_t*) cpuinfo_allocate_temporary(max_group_count, sizeof(uint32_t));
 	if (global_proc_index_per_group == NULL) {
 		cpuinfo_log_error(
 			"failed to allocate %zu bytes for descriptions of %"PRIu32" processor groups",
@@ -154,8 +184,10 @@ bool cpu_info_init_by_logical_sys_info(
 	}
 	
 	uint32_t nr_of_processors =
-		count_logical_processors(max_group_count, global_proc_index_per_group);
-	processors = HeapAlloc(heap, HEAP_ZERO_MEMORY, nr_of_processors * sizeof(struct cpuinfo_processor));
+		count_logical_processors(&topology, max_group_count, global_proc_index_per_group);
+	/* Until all tables are counted and allocated together, processors are described in a temporary array */
+	temporary_processors = cpuinfo_allocate_temporary(nr_of_processors, sizeof(struct cpuinfo_processor));
+	processors = temporary_processors;
 	if (processors == NULL) {
 		cpuinfo_log_error(
 			"failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
@@ -163,8 +195,9 @@ bool cpu_info_init_by_logical_sys_info(
 		goto clean_up;
 	}
 
-	/* 2. Read topology information via MSDN API: packages, cores and caches*/
+	/* 2. Parse topology information: packages, cores and caches */
 	nr_of_packages = read_packages_for_processors(
+						&topology,
 						processors, nr_of_processors,
 						global_proc_index_per_group,
 						chip_info);
@@ -179,6 +212,7 @@ bool cpu_info_init_by_logical_sys_info(
 	 * we will iterate again to read and store data to cpuinfo_core structures.
 	 */
 	nr_of_cores = read_cores_for_processors(
+					&topology,
 					processors, nr_of_processors,
 					global_proc_index_per_group, NULL,
 					chip_info);
@@ -193,6 +227,7 @@ bool cpu_info_init_by_logical_sys_info(
 		2. Read out cache data and store to allocated memory
 	 */
 	nr_of_all_caches = read_caches_for_processors(
+						&topology,
 						processors, nr_of_processors,
 						caches, numbers_of_caches,
 						global_proc_index_per_group, chip_info);
@@ -202,41 +237,35 @@ bool cpu_info_init_by_logical_sys_info(
 	}
 	cpuinfo_log_debug("detected %"PRIu32" processor cache(s)", nr_of_all_caches);
 
-	/* 3. Allocate memory for package, cluster, core and cache structures */
-	packages = HeapAlloc(heap, HEAP_ZERO_MEMORY, nr_of_packages * sizeof(struct cpuinfo_package));
-	if (packages == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" physical packages",
-			nr_of_packages * sizeof(struct cpuinfo_package), nr_of_packages);
-		goto clean_up;
-	}
-
-	/* We don't have cluster information so we explicitly set clusters to equal to cores. */
-	clusters = HeapAlloc(heap, HEAP_ZERO_MEMORY, nr_of_cores * sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" core clusters",
-			nr_of_cores * sizeof(struct cpuinfo_cluster), nr_of_cores);
-		goto clean_up;
-	}
-
-	cores = HeapAlloc(heap, HEAP_ZERO_MEMORY, nr_of_cores * sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			nr_of_cores * sizeof(struct cpuinfo_core), nr_of_cores);
+	/* 3. Allocate memory for processor, package, cluster, core, cache and uarch structures at once.
+	 *    We don't have cluster information, so we reserve for the worst case of one cluster per core,
+	 *    and uarchs are counted over cores later, so we reserve for the worst case of one uarch per core.
+	 *    We reserve one contiguous cache array for all caches, then use offsets per cache type.
+	 */
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, nr_of_processors, sizeof(struct cpuinfo_processor));
+	const size_t packages_offset = cpuinfo_arena_reserve(&arena, nr_of_packages, sizeof(struct cpuinfo_package));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, nr_of_cores, sizeof(struct cpuinfo_cluster));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, nr_of_cores, sizeof(struct cpuinfo_core));
+	const size_t caches_offset = cpuinfo_arena_reserve(&arena, nr_of_all_caches, sizeof(struct cpuinfo_cache));
+	const size_t uarchs_offset = cpuinfo_arena_reserve(&arena, nr_of_cores, sizeof(struct cpuinfo_uarch_info));
+	if (!cpuinfo_arena_allocate(&arena)) {
 		goto clean_up;
 	}
 
-	/* We allocate one contiguous cache array for all caches, then use offsets per cache type. */
-	caches = HeapAlloc(heap, HEAP_ZERO_MEMORY, nr_of_all_caches * sizeof(struct cpuinfo_cache));
-	if (caches == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" caches",
-			nr_of_all_caches * sizeof(struct cpuinfo_cache), nr_of_all_caches);
-		goto clean_up;
-	}
+	/* Package pointers of processors are still offsets, which the copy keeps */
+	processors = cpuinfo_arena_get(&arena, processors_offset, nr_of_processors);
+	memcpy(processors, temporary_processors, nr_of_processors * sizeof(struct cpuinfo_processor));
+	packages = cpuinfo_arena_get(&arena, packages_offset, nr_of_packages);
+	clusters = cpuinfo_arena_get(&arena, clusters_offset, nr_of_cores);
+	cores = cpuinfo_arena_get(&arena, cores_offset, nr_of_cores);
+	caches = cpuinfo_arena_get(&arena, caches_offset, nr_of_all_caches);
+	uarchs = cpuinfo_arena_get(&arena, uarchs_offset, nr_of_cores);
 
 	/* 4.Read missing topology information that can't be saved without counted
 	 *   allocate structures in the first round.
 	 */
 	nr_of_all_caches = read_caches_for_processors(
+						&topology,
 						processors, nr_of_processors,
 						caches, numbers_of_caches, global_proc_index_per_group, chip_info);
 	if (!nr_of_all_caches) {
@@ -245,6 +274,7 @@ bool cpu_info_init_by_logical_sys_info(
 	}
 
 	nr_of_cores = read_cores_for_processors(
+		&topology,
 		processors, nr_of_processors,
 		global_proc_index_per_group, cores,
 		chip_info);
@@ -253,13 +283,19 @@ bool cpu_info_init_by_logical_sys_info(
 		goto clean_up;
 	}
 
+	if (!read_frequencies_for_cores(processors, nr_of_processors)) {
+		goto clean_up;
+	}
+	nr_of_clusters = assign_clusters_to_processors(processors, nr_of_processors);
+	cpuinfo_log_debug("detected %"PRIu32" core cluster(s)", nr_of_clusters);
+
 	/* 5. Now that we read out everything from the system we can, fill the package, cluster
 	 *    and core structures respectively.
 	 */
 	result = connect_packages_cores_clusters_by_processors(
 				processors, nr_of_processors,
 				packages, nr_of_packages,
-				clusters,
+				clusters, nr_of_clusters,
 				cores, nr_of_cores,
 				chip_info,
 				vendor);
@@ -276,12 +312,6 @@ bool cpu_info_init_by_logical_sys_info(
 			prev_uarch = cores[i].uarch;
 		}
 	}
-	uarchs = HeapAlloc(heap, HEAP_ZERO_MEMORY, nr_of_uarchs * sizeof(struct cpuinfo_uarch_info));
-	if (uarchs == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" uarchs",
-			nr_of_uarchs * sizeof(struct cpuinfo_uarch_info), nr_of_uarchs);
-		goto clean_up;
-	}
 	prev_uarch = cpuinfo_uarch_unknown;
 	for (uint32_t i = 0, uarch_counter = 0; i < nr_of_cores; i++) {
 		if (prev_uarch != cores[i].uarch) {
@@ -296,6 +326,8 @@ bool cpu_info_init_by_logical_sys_info(
 		}
 	}
 
+	cpuinfo_windows_detect_cpu_sets(processors, nr_of_processors);
+
 	/* 7. Commit changes */
 	cpuinfo_processors = processors;
 	cpuinfo_packages = packages;
@@ -305,7 +337,7 @@ bool cpu_info_init_by_logical_sys_info(
 
 	cpuinfo_processors_count = nr_of_processors;
 	cpuinfo_packages_count = nr_of_packages;
-	cpuinfo_clusters_count = nr_of_cores;
+	cpuinfo_clusters_count = nr_of_clusters;
 	cpuinfo_cores_count = nr_of_cores;
 	cpuinfo_uarchs_count = nr_of_uarchs;
 
@@ -319,53 +351,35 @@ bool cpu_info_init_by_logical_sys_info(
 	cpuinfo_cache[cpuinfo_cache_level_4]  = cpuinfo_cache[cpuinfo_cache_level_3]  + cpuinfo_cache_count[cpuinfo_cache_level_3];
 	cpuinfo_max_cache_size = cpuinfo_compute_max_cache_size(&processors[0]);
 
+	cpuinfo_arena_memory = arena.memory;
+
 	result = true;
 	MemoryBarrier();
 
-	processors = NULL;
-	packages = NULL;
-	clusters = NULL;
-	cores = NULL;
-	caches = NULL;
-	uarchs = NULL;
+	arena.memory = NULL;
 
 clean_up:
-	/* The propagated pointers, shouldn't be freed, only in case of error
+	/* The arena is propagated to the tables, and shouldn't be freed, only in case of error
 	 * and unfinished init.
 	 */
-	if (processors != NULL) {
-		HeapFree(heap, 0, processors);
-	}
-	if (packages != NULL) {
-		HeapFree(heap, 0, packages);
-	}
-	if (clusters != NULL) {
-		HeapFree(heap, 0, clusters);
-	}
-	if (cores != NULL) {
-		HeapFree(heap, 0, cores);
-	}
-	if (caches != NULL) {
-		HeapFree(heap, 0, caches);
-	}
-	if (uarchs != NULL) {
-		HeapFree(heap, 0, uarchs);
-	}
+	cpuinfo_arena_free(arena.memory);
 
 	/* Free the locally used temporary pointers */
-	HeapFree(heap, 0, global_proc_index_per_group);
-	global_proc_index_per_group = NULL;
+	cpuinfo_windows_release_topology(&topology);
+	cpuinfo_free_temporary(temporary_processors);
+	cpuinfo_free_temporary(global_proc_index_per_group);
 	return result;
 }
 
 static uint32_t count_logical_processors(
+	const struct cpuinfo_windows_topology* topology,
 	const uint32_t max_group_count,
 	uint32_t* global_proc_index_per_group)
 {
 	uint32_t nr_of_processors = 0;
 
 	for (uint32_t i = 0; i < max_group_count; i++) {
-		uint32_t nr_of_processors_per_group = GetMaximumProcessorCount((WORD) i);
+		uint32_t nr_of_processors_per_group = cpuinfo_windows_get_group_processors_count(topology, i);
 		cpuinfo_log_debug("detected %"PRIu32" processor(s) in group %"PRIu32"",
 			nr_of_processors_per_group, i);
 		global_proc_index_per_group[i] = nr_of_processors;
@@ -375,12 +389,14 @@ static uint32_t count_logical_processors(
 }
 
 static uint32_t read_packages_for_processors(
+	const struct cpuinfo_windows_topology* topology,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
 	const uint32_t* global_proc_index_per_group,
 	const struct woa_chip_info *chip_info)
 {
 	return read_all_logical_processor_info_of_relation(
+		topology,
 		RelationProcessorPackage,
 		processors,
 		number_of_processors,
@@ -392,6 +408,7 @@ static uint32_t read_packages_for_processors(
 }
 
 uint32_t read_cores_for_processors(
+	const struct cpuinfo_windows_topology* topology,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
 	const uint32_t* global_proc_index_per_group,
@@ -399,6 +416,7 @@ uint32_t read_cores_for_processors(
 	const struct woa_chip_info *chip_info)
 {
 	return read_all_logical_processor_info_of_relation(
+		topology,
 		RelationProcessorCore,
 		processors,
 		number_of_processors,
@@ -410,6 +428,7 @@ uint32_t read_cores_for_processors(
 }
 
 static uint32_t read_caches_for_processors(
+	const struct cpuinfo_windows_topology* topology,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
 	struct cpuinfo_cache* caches,
@@ -429,6 +448,7 @@ static uint32_t read_caches_for_processors(
 	}
 
 	return read_all_logical_processor_info_of_relation(
+		topology,
 		RelationCache,
 		processors,
 		number_of_processors,
@@ -440,6 +460,7 @@ static uint32_t read_caches_for_processors(
 }
 
 static uint32_t read_all_logical_processor_info_of_relation(
+	const struct cpuinfo_windows_topology* topology,
 	LOGICAL_PROCESSOR_RELATIONSHIP info_type,
 	struct cpuinfo_processor* processors,
 	const uint32_t number_of_processors,
@@ -449,50 +470,35 @@ static uint32_t read_all_logical_processor_info_of_relation(
 	const uint32_t* global_proc_index_per_group,
 	const struct woa_chip_info* chip_info)
 {
-	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX infos = NULL;
 	uint32_t nr_of_structs = 0;
-	DWORD info_size = 0;
+	uint32_t nr_of_infos = 0;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* infos = NULL;
 	bool result = false;
-	HANDLE heap = GetProcessHeap();
 
-	/* 1. Query the size of the information structure first */
-	if (GetLogicalProcessorInformationEx(info_type, NULL, &info_size) == FALSE) {
-		const DWORD last_error = GetLastError();
-		if (last_error != ERROR_INSUFFICIENT_BUFFER) {
+	/* 1. Select the entries of the relation, already queried and indexed together with the others */
+	switch (info_type) {
+		case RelationProcessorPackage:
+			infos = topology->packages;
+			nr_of_infos = topology->packages_count;
+		break;
+		case RelationProcessorCore:
+			infos = topology->cores;
+			nr_of_infos = topology->cores_count;
+		break;
+		case RelationCache:
+			infos = topology->caches;
+			nr_of_infos = topology->caches_count;
+		break;
+		default:
 			cpuinfo_log_error(
-				"failed to query size of processor %"PRIu32" information information: error %"PRIu32"",
-				(uint32_t)info_type, (uint32_t) last_error);
-			goto clean_up;
-		}
-	}
-	/* 2. Allocate memory for the information structure */
-	infos = HeapAlloc(heap, 0, info_size);
-	if (infos == NULL) {
-		cpuinfo_log_error("failed to allocate %"PRIu32" bytes for logical processor information",
-			(uint32_t) info_size);
-		goto clean_up;
-	}
-	/* 3. Read the information structure */
-	if (GetLogicalProcessorInformationEx(info_type, infos, &info_size) == FALSE) {
-		cpuinfo_log_error("failed to query processor %"PRIu32" information: error %"PRIu32"",
-			(uint32_t)info_type, (uint32_t) GetLastError());
-		goto clean_up;
-	}
-
-	/* 4. Parse the structure and store relevant data */
-	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info_end =
-		(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) infos + info_size);
-	for (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = infos;
-		info < info_end;
-		info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) info + info->Size))
-	{
-		if (info->Relationship != info_type) {
-			cpuinfo_log_warning(
 				"unexpected processor info type (%"PRIu32") for processor information",
-				(uint32_t) info->Relationship);
-			continue;
-		}
+				(uint32_t) info_type);
+			return 0;
+	}
 
+	/* 2. Parse the structure and store relevant data */
+	for (uint32_t i = 0; i < nr_of_infos; i++) {
+		PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = infos[i];
 		const uint32_t info_id = nr_of_structs++;
 
 		switch(info_type) {
@@ -532,14 +538,9 @@ static uint32_t read_all_logical_processor_info_of_relation(
 			break;
 		}
 		if (!result) {
-			nr_of_structs = 0;
-			goto clean_up;
+			return 0;
 		}
 	}
-clean_up:
-	/* 5. Release dynamically allocated info structure. */
-	HeapFree(heap, 0, infos);
-	infos = NULL;
 	return nr_of_structs;
 }
 
@@ -741,17 +742,12 @@ void store_core_info_per_processor(
 	if (cores) {
 		processors[processor_global_index].core = cores + core_id;
 		cores[core_id].core_id = core_id;
+		cores[core_id].windows_efficiency_class = core_info->Processor.EfficiencyClass;
 		get_core_uarch_for_efficiency(
 			chip_info->chip_name, core_info->Processor.EfficiencyClass,
 			&(cores[core_id].uarch), &(cores[core_id].frequency));
 
-		/* We don't have cluster information, so we handle it as
-		 * fixed 1 to (cluster / cores).
-		 * Set the cluster offset ID now, as soon as we have the
-		 * cluster base address, we'll set the absolute address.
-		 */
-		processors[processor_global_index].cluster =
-			(const struct cpuinfo_cluster*) NULL + core_id;
+		/* Clusters are assigned once all cores are read, in assign_clusters_to_processors. */
 	}
 }
 
@@ -792,12 +788,88 @@ static void store_cache_info_per_processor(
 	}
 }
 
+static bool read_frequencies_for_cores(
+	struct cpuinfo_processor* processors,
+	const uint32_t nr_of_processors)
+{
+	uint64_t* frequencies = cpuinfo_allocate(2 * (size_t) nr_of_processors, sizeof(uint64_t));
+	if (frequencies == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for frequencies of %"PRIu32" logical processors",
+			2 * nr_of_processors * sizeof(uint64_t), nr_of_processors);
+		return false;
+	}
+	uint64_t* max_frequencies = frequencies + nr_of_processors;
+	get_processor_frequencies(processors, nr_of_processors, frequencies, max_frequencies);
+
+	/* Measured frequencies take precedence over the frequencies hard-coded by chip name */
+	for (uint32_t i = 0; i < nr_of_processors; i++) {
+		struct cpuinfo_core* core = (struct cpuinfo_core*) processors[i].core;
+		if (frequencies[i] != 0) {
+			core->frequency = frequencies[i];
+		}
+		if (max_frequencies[i] > core->max_turbo_frequency) {
+			core->max_turbo_frequency = max_frequencies[i];
+		}
+		cpuinfo_log_debug("processor %"PRIu32": %"PRIu64" MHz, max %"PRIu64" MHz",
+			i, frequencies[i] / UINT64_C(1000000), max_frequencies[i] / UINT64_C(1000000));
+	}
+	cpuinfo_deallocate(frequencies);
+	return true;
+}
+
+static bool is_l2_shared_between_cores(
+	const struct cpuinfo_processor* processors,
+	const struct cpuinfo_processor* processor)
+{
+	const struct cpuinfo_cache* l2 = processor->cache.l2;
+	return l2 != NULL && l2->processor_count != 0 &&
+		processors[l2->processor_start].core != processors[l2->processor_start + l2->processor_count - 1].core;
+}
+
+/*
+ * Windows doesn't report clusters, so we group neighbouring cores of the same efficiency class, uarch and
+ * frequencies, like Linux does with cores of the same MIDR and frequency. Where L2 caches are shared between
+ * cores, as on Snapdragon X, a cluster doesn't span more than one L2 cache.
+ * As we don't have the cluster base address yet, processors store cluster offset IDs.
+ */
+static uint32_t assign_clusters_to_processors(
+	struct cpuinfo_processor* processors,
+	const uint32_t nr_of_processors)
+{
+	uint32_t nr_of_clusters = 0;
+	const struct cpuinfo_processor* last_core_processor = NULL;
+	for (uint32_t i = 0; i < nr_of_processors; i++) {
+		const struct cpuinfo_processor* processor = processors + i;
+		if (last_core_processor == NULL || processor->core != last_core_processor->core) {
+			bool same_cluster = false;
+			if (last_core_processor != NULL) {
+				const struct cpuinfo_core* core = processor->core;
+				const struct cpuinfo_core* last_core = last_core_processor->core;
+				const bool l2_shared = is_l2_shared_between_cores(processors, processor);
+				same_cluster = core->windows_efficiency_class == last_core->windows_efficiency_class &&
+					core->uarch == last_core->uarch &&
+					core->frequency == last_core->frequency &&
+					core->max_turbo_frequency == last_core->max_turbo_frequency &&
+					l2_shared == is_l2_shared_between_cores(processors, last_core_processor) &&
+					(!l2_shared || processor->cache.l2 == last_core_processor->cache.l2);
+			}
+			if (!same_cluster) {
+				nr_of_clusters++;
+			}
+			last_core_processor = processor;
+		}
+		processors[i].cluster = (const struct cpuinfo_cluster*) NULL + (nr_of_clusters - 1);
+	}
+	return nr_of_clusters;
+}
+
 static bool connect_packages_cores_clusters_by_processors(
 	struct cpuinfo_processor* processors,
 	const uint32_t nr_of_processors,
 	struct cpuinfo_package* packages,
 	const uint32_t nr_of_packages,
 	struct cpuinfo_cluster* clusters,
+	const uint32_t nr_of_clusters,
 	struct cpuinfo_core* cores,
 	const uint32_t nr_of_cores,
 	const struct woa_chip_info* chip_info,
@@ -825,7 +897,7 @@ static bool connect_packages_cores_clusters_by_processors(
 		struct cpuinfo_cluster* cluster =
 			(struct cpuinfo_cluster*) ((uintptr_t) clusters + (uintptr_t) processor->cluster);
 		if (cluster < clusters ||
-			cluster >= (clusters + nr_of_cores)) {
+			cluster >= (clusters + nr_of_clusters)) {
 			cpuinfo_log_error("invalid cluster indexing");
 			return false;
 		}
@@ -878,14 +950,25 @@ static bool connect_packages_cores_clusters_by_processors(
 		cluster->core_count++;
 		package->core_start = global_core_id;
 		package->core_count++;
-		package->cluster_start = global_core_id;
-		package->cluster_count = package->core_count;
 
 		cluster->package = package;
 		cluster->vendor = cores[cluster->core_start].vendor;
 		cluster->uarch = cores[cluster->core_start].uarch;
 		cluster->frequency = cores[cluster->core_start].frequency;
 	}
+	/* Fill clusters */
+	for (uint32_t i = nr_of_clusters; i != 0; i--) {
+		const uint32_t global_cluster_id = i - 1;
+		struct cpuinfo_package* package = (struct cpuinfo_package*) clusters[global_cluster_id].package;
+
+		/* This can be overwritten by lower-index clusters on the same package. */
+		package->cluster_start = global_cluster_id;
+		package->cluster_count++;
+	}
+	for (uint32_t i = 0; i < nr_of_clusters; i++) {
+		struct cpuinfo_cluster* cluster = clusters + i;
+		cluster->cluster_id = i - cluster->package->cluster_start;
+	}
 	return true;
 }
 
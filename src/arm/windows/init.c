@@ -1,252 +1,367 @@
-#include <stdio.h>
-#include <stdint.h>
-#include <stdlib.h>
-#include <errno.h>
-
-#include <cpuinfo.h>
-#include <cpuinfo/internal-api.h>
-#include <cpuinfo/log.h>
-
-#include "windows-arm-init.h"
-
-/* Efficiency class = 0 means little core, while 1 means big core for now */
-#define MAX_WOA_VALID_EFFICIENCY_CLASSES		2
-
-struct cpuinfo_arm_isa cpuinfo_isa;
-
-static void set_cpuinfo_isa_fields(void);
-static bool get_system_info_from_registry(
-	struct woa_chip_info** chip_info);
-
-static struct woa_chip_info woa_chip_unknown = {
-	L"Unknown",
-	woa_chip_name_unknown,
-	{
-		{
-			cpuinfo_vendor_unknown,
-			cpuinfo_uarch_unknown,
-			0
-		}
-	}
-};
-
-/* Please add new SoC/chip info here! */
-static struct woa_chip_info woa_chips[] = {
-	/* Microsoft SQ1 Kryo 495 4 + 4 cores (3 GHz + 1.80 GHz) */
-	{
-		L"Microsoft SQ1",
-		woa_chip_name_microsoft_sq_1,
-		{
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_cortex_a55,
-				1800000000,
-			},
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_cortex_a76,
-				3000000000,
-			}
-		}
-	},
-	/* Microsoft SQ2 Kryo 495 4 + 4 cores (3.15 GHz + 2.42 GHz) */
-	{
-		L"Microsoft SQ2",
-		woa_chip_name_microsoft_sq_2,
-		{
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_cortex_a55,
-				2420000000,
-			},
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_cortex_a76,
-				3150000000
-			}
-		}
-	},
-	/* Microsoft Windows Dev Kit 2023 */
-	{
-		L"Snapdragon (TM) 8cx Gen 3 @ 3.0 GHz",
-		woa_chip_name_microsoft_sq_3,
-		{
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_cortex_a78,
-				2420000000,
-			},
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_cortex_x1,
-				3000000000
-			}
-		}
-	},
-	/* Ampere Altra */
-	{
-		L"Ampere(R) Altra(R) Processor",
-		woa_chip_name_ampere_altra,
-		{
-			{
-				cpuinfo_vendor_arm,
-				cpuinfo_uarch_neoverse_n1,
-				3000000000
-			}
-		}
-	}
-};
-
-BOOL CALLBACK cpuinfo_arm_windows_init(
-	PINIT_ONCE init_once, PVOID parameter, PVOID* context)
-{
-	struct woa_chip_info *chip_info = NULL;
-	enum cpuinfo_vendor vendor = cpuinfo_vendor_unknown;
-	
-	set_cpuinfo_isa_fields();
-
-	const bool system_result = get_system_info_from_registry(&chip_info);
-	if (!system_result) {
-		chip_info = &woa_chip_unknown;
-	}
-
-	cpuinfo_is_initialized = cpu_info_init_by_logical_sys_info(chip_info, chip_info->uarchs[0].vendor);
-
-	return (system_result && cpuinfo_is_initialized ? TRUE : FALSE);
-}
-
-bool get_core_uarch_for_efficiency(
-	enum woa_chip_name chip, BYTE EfficiencyClass,
-	enum cpuinfo_uarch* uarch, uint64_t* frequency)
-{
-	/* For currently supported WoA chips, the Efficiency class selects
-	 * the pre-defined little and big core.
-	 * Any further supported SoC's logic should be implemented here.
-	 */
-	if (uarch && frequency && chip < woa_chip_name_last &&
-		EfficiencyClass < MAX_WOA_VALID_EFFICIENCY_CLASSES) {
-		*uarch = woa_chips[chip].uarchs[EfficiencyClass].uarch;
-		*frequency = woa_chips[chip].uarchs[EfficiencyClass].frequency;
-		return true;
-	}
-	return false;
-}
-
-/* Static helper functions */
-
-static bool read_registry(
-	LPCWSTR subkey,
-	LPCWSTR value,
-	char** text_buffer)
-{
-	DWORD key_type = 0;
-	DWORD data_size = 0;
-	const DWORD flags = RRF_RT_REG_SZ; /* Only read strings (REG_SZ) */
-	LSTATUS result = 0;
-	HANDLE heap = GetProcessHeap();
-
-	result = RegGetValueW(
-		HKEY_LOCAL_MACHINE,
-		subkey,
-		value,
-		flags,
-		&key_type,
-		NULL, /* Request buffer size */
-		&data_size);
-	if (result != 0 || data_size == 0) {
-		cpuinfo_log_error("Registry entry size read error");
-		return false;
-	}
-
-	if (*text_buffer) {
-		HeapFree(heap, 0, *text_buffer);
-	}
-	*text_buffer = HeapAlloc(heap, HEAP_ZERO_MEMORY, data_size * sizeof(wchar_t));
-	if (*text_buffer == NULL) {
-		cpuinfo_log_error("Registry textbuffer allocation error");
-		return false;
-	}
-
-	result = RegGetValueW(
-		HKEY_LOCAL_MACHINE,
-		subkey,
-		value,
-		flags,
-		NULL,
-		*text_buffer, /* Write string in this destination buffer */
-		&data_size);
-	if (result != 0) {
-		cpuinfo_log_error("Registry read error");
-		return false;
-	}
-	return true;
-}
-
-static bool get_system_info_from_registry(
-	struct woa_chip_info** chip_info)
-{
-	bool result = false;
-	char* text_buffer = NULL;
-	LPCWSTR cpu0_subkey = L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0";
-	LPCWSTR chip_name_value = L"ProcessorNameString";
-
-	*chip_info = NULL;
-	HANDLE heap = GetProcessHeap();
-
-	/* Read processor model name from registry and find in the hard-coded list. */
-	if (!read_registry(cpu0_subkey, chip_name_value, &text_buffer)) {
-		cpuinfo_log_error("Registry read error");
-		goto cleanup;
-	}
-	for (uint32_t i = 0; i < (uint32_t) woa_chip_name_last; i++) {
-		size_t compare_length = wcsnlen(woa_chips[i].chip_name_string, CPUINFO_PACKAGE_NAME_MAX);
-		int compare_result = wcsncmp(text_buffer, woa_chips[i].chip_name_string, compare_length);
-		if (compare_result == 0) {
-			*chip_info = woa_chips+i;
-			break;
-		}
-	}
-	if (*chip_info == NULL) {
-		/* No match was found, so print a warning and assign the unknown case. */
-		cpuinfo_log_error("Unknown chip model name '%ls'.\nPlease add new Windows on Arm SoC/chip support to arm/windows/init.c!", text_buffer);
-		goto cleanup;
-	}
-	cpuinfo_log_debug("detected chip model name: %s", (**chip_info).chip_name_string);
-
-cleanup:
-	HeapFree(heap, 0, text_buffer);
-	text_buffer = NULL;
-	return result;
-}
-
-static void set_cpuinfo_isa_fields(void)
-{
-	cpuinfo_isa.atomics = IsProcessorFeaturePresent(PF_ARM_V81_ATOMIC_INSTRUCTIONS_AVAILABLE) != 0;
-
-	const bool dotprod = IsProcessorFeaturePresent(PF_ARM_V82_DP_INSTRUCTIONS_AVAILABLE) != 0;
-	cpuinfo_isa.dot = dotprod;
-
-	SYSTEM_INFO system_info;
-	GetSystemInfo(&system_info);
-	switch (system_info.wProcessorLevel) {
-		case 0x803:  // Kryo 385 Silver (Snapdragon 850)
-			cpuinfo_isa.fp16arith = dotprod;
-			cpuinfo_isa.rdm = dotprod;
-			break;
-		default:
-			// Assume that Dot Product support implies FP16 arithmetics and RDM support.
-			// ARM manuals don't guarantee that, but it holds in practice.
-			cpuinfo_isa.fp16arith = dotprod;
-			cpuinfo_isa.rdm = dotprod;
-			break;
-	}
-
-	/* Windows API reports all or nothing for cryptographic instructions. */
-	const bool crypto = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
-	cpuinfo_isa.aes = crypto;
-	cpuinfo_isa.sha1 = crypto;
-	cpuinfo_isa.sha2 = crypto;
-	cpuinfo_isa.pmull = crypto;
-
-	cpuinfo_isa.crc32 = IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0;
-}
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <wchar.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+#include "windows-arm-init.h"
+
+/* Processor features from winnt.h of recent Windows SDKs, which older SDKs lack */
+#ifndef PF_ARM_V83_LRCPC_INSTRUCTIONS_AVAILABLE
+	#define PF_ARM_V83_LRCPC_INSTRUCTIONS_AVAILABLE 45
+#endif
+#ifndef PF_ARM_LSE2_AVAILABLE
+	#define PF_ARM_LSE2_AVAILABLE 62
+#endif
+#ifndef PF_ARM_SHA3_INSTRUCTIONS_AVAILABLE
+	#define PF_ARM_SHA3_INSTRUCTIONS_AVAILABLE 64
+#endif
+#ifndef PF_ARM_SHA512_INSTRUCTIONS_AVAILABLE
+	#define PF_ARM_SHA512_INSTRUCTIONS_AVAILABLE 65
+#endif
+
+/* Efficiency class = 0 means little core, while 1 means big core for now */
+#define MAX_WOA_VALID_EFFICIENCY_CLASSES		2
+
+struct cpuinfo_arm_isa cpuinfo_isa;
+
+static void set_cpuinfo_isa_fields(void);
+static bool get_system_info_from_registry(
+	struct woa_chip_info** chip_info);
+
+static struct woa_chip_info woa_chip_unknown = {
+	L"Unknown",
+	woa_chip_name_unknown,
+	{
+		{
+			cpuinfo_vendor_unknown,
+			cpuinfo_uarch_unknown,
+			0
+		}
+	}
+};
+
+/* Please add new SoC/chip info here! */
+static struct woa_chip_info woa_chips[] = {
+	/* Microsoft SQ1 Kryo 495 4 + 4 cores (3 GHz + 1.80 GHz) */
+	{
+		L"Microsoft SQ1",
+		woa_chip_name_microsoft_sq_1,
+		{
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_cortex_a55,
+				1800000000,
+			},
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_cortex_a76,
+				3000000000,
+			}
+		}
+	},
+	/* Microsoft SQ2 Kryo 495 4 + 4 cores (3.15 GHz + 2.42 GHz) */
+	{
+		L"Microsoft SQ2",
+		woa_chip_name_microsoft_sq_2,
+		{
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_cortex_a55,
+				2420000000,
+			},
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_cortex_a76,
+				3150000000
+			}
+		}
+	},
+	/* Microsoft Windows Dev Kit 2023 */
+	{
+		L"Snapdragon (TM) 8cx Gen 3 @ 3.0 GHz",
+		woa_chip_name_microsoft_sq_3,
+		{
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_cortex_a78,
+				2420000000,
+			},
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_cortex_x1,
+				3000000000
+			}
+		}
+	},
+	/* Ampere Altra */
+	{
+		L"Ampere(R) Altra(R) Processor",
+		woa_chip_name_ampere_altra,
+		{
+			{
+				cpuinfo_vendor_arm,
+				cpuinfo_uarch_neoverse_n1,
+				3000000000
+			}
+		}
+	}
+};
+
+BOOL CALLBACK cpuinfo_arm_windows_init(
+	PINIT_ONCE init_once, PVOID parameter, PVOID* context)
+{
+	struct woa_chip_info *chip_info = NULL;
+	enum cpuinfo_vendor vendor = cpuinfo_vendor_unknown;
+	
+	set_cpuinfo_isa_fields();
+
+	const bool system_result = get_system_info_from_registry(&chip_info);
+	if (!system_result) {
+		chip_info = &woa_chip_unknown;
+	}
+
+	cpuinfo_is_initialized = cpu_info_init_by_logical_sys_info(chip_info, chip_info->uarchs[0].vendor);
+
+	return (system_result && cpuinfo_is_initialized ? TRUE : FALSE);
+}
+
+bool get_core_uarch_for_efficiency(
+	enum woa_chip_name chip, BYTE EfficiencyClass,
+	enum cpuinfo_uarch* uarch, uint64_t* frequency)
+{
+	/* For currently supported WoA chips, the Efficiency class selects
+	 * the pre-defined little and big core.
+	 * Any further supported SoC's logic should be implemented here.
+	 */
+	if (uarch && frequency && chip < woa_chip_name_last &&
+		EfficiencyClass < MAX_WOA_VALID_EFFICIENCY_CLASSES) {
+		*uarch = woa_chips[chip].uarchs[EfficiencyClass].uarch;
+		*frequency = woa_chips[chip].uarchs[EfficiencyClass].frequency;
+		return true;
+	}
+	return false;
+}
+
+/* PROCESSOR_POWER_INFORMATION of CallNtPowerInformation, which Windows SDK headers don't declare */
+struct processor_power_information {
+	ULONG number;
+	ULONG max_mhz;
+	ULONG current_mhz;
+	ULONG mhz_limit;
+	ULONG max_idle_state;
+	ULONG current_idle_state;
+};
+
+typedef LONG (WINAPI* call_nt_power_information_function)(int, PVOID, ULONG, PVOID, ULONG);
+
+static uint32_t read_registry_dword(LPCWSTR subkey, LPCWSTR value)
+{
+	DWORD data = 0;
+	DWORD data_size = sizeof(data);
+	const LSTATUS result = RegGetValueW(
+		HKEY_LOCAL_MACHINE,
+		subkey,
+		value,
+		RRF_RT_REG_DWORD,
+		NULL,
+		&data,
+		&data_size);
+	return result == ERROR_SUCCESS ? (uint32_t) data : 0;
+}
+
+/*
+ * Maximum frequencies come from CallNtPowerInformation, which is loaded from powrprof.dll on demand rather than
+ * linked. It reports the processors of the group of the calling thread, which is the only group of most systems.
+ */
+static void read_max_frequencies(
+	const struct cpuinfo_processor* processors, uint32_t nr_of_processors, uint64_t* max_frequencies)
+{
+	const HMODULE powrprof = LoadLibraryW(L"powrprof.dll");
+	if (powrprof == NULL) {
+		cpuinfo_log_debug("failed to load powrprof.dll: error %"PRIu32, (uint32_t) GetLastError());
+		return;
+	}
+	struct processor_power_information* power_information = NULL;
+	const call_nt_power_information_function call_nt_power_information =
+		(call_nt_power_information_function) GetProcAddress(powrprof, "CallNtPowerInformation");
+	if (call_nt_power_information == NULL) {
+		cpuinfo_log_debug("CallNtPowerInformation is not available");
+		goto cleanup;
+	}
+	power_information = cpuinfo_allocate(nr_of_processors, sizeof(struct processor_power_information));
+	if (power_information == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for power information of %"PRIu32" logical processors",
+			nr_of_processors * sizeof(struct processor_power_information), nr_of_processors);
+		goto cleanup;
+	}
+	const LONG status = call_nt_power_information(
+		ProcessorInformation, NULL, 0,
+		power_information, (ULONG) (nr_of_processors * sizeof(struct processor_power_information)));
+	if (status != 0) {
+		cpuinfo_log_debug("CallNtPowerInformation(ProcessorInformation) failed: status 0x%08"PRIx32,
+			(uint32_t) status);
+		goto cleanup;
+	}
+
+	PROCESSOR_NUMBER current_processor = { 0 };
+	GetCurrentProcessorNumberEx(&current_processor);
+	for (uint32_t i = 0; i < nr_of_processors; i++) {
+		const struct processor_power_information* entry = &power_information[i];
+		if (entry->max_mhz == 0) {
+			continue;
+		}
+		for (uint32_t j = 0; j < nr_of_processors; j++) {
+			if (processors[j].windows_group_id == current_processor.Group &&
+				processors[j].windows_processor_id == entry->number)
+			{
+				max_frequencies[j] = (uint64_t) entry->max_mhz * UINT64_C(1000000);
+				break;
+			}
+		}
+	}
+
+cleanup:
+	cpuinfo_deallocate(power_information);
+	FreeLibrary(powrprof);
+}
+
+void get_processor_frequencies(
+	const struct cpuinfo_processor* processors, uint32_t nr_of_processors,
+	uint64_t* frequencies, uint64_t* max_frequencies)
+{
+	/* Keys of CentralProcessor follow the global processor order, with groups one after another */
+	for (uint32_t i = 0; i < nr_of_processors; i++) {
+		wchar_t subkey[64];
+		swprintf(subkey, sizeof(subkey) / sizeof(subkey[0]),
+			L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\%u", (unsigned int) i);
+		frequencies[i] = (uint64_t) read_registry_dword(subkey, L"~MHz") * UINT64_C(1000000);
+	}
+	read_max_frequencies(processors, nr_of_processors, max_frequencies);
+}
+
+/* Static helper functions */
+
+static bool read_registry(
+	LPCWSTR subkey,
+	LPCWSTR value,
+	char** text_buffer)
+{
+	DWORD key_type = 0;
+	DWORD data_size = 0;
+	const DWORD flags = RRF_RT_REG_SZ; /* Only read strings (REG_SZ) */
+	LSTATUS result = 0;
+
+	result = RegGetValueW(
+		HKEY_LOCAL_MACHINE,
+		subkey,
+		value,
+		flags,
+		&key_type,
+		NULL, /* Request buffer size */
+		&data_size);
+	if (result != 0 || data_size == 0) {
+		cpuinfo_log_error("Registry entry size read error");
+		return false;
+	}
+
+	if (*text_buffer) {
+		cpuinfo_deallocate(*text_buffer);
+	}
+	*text_buffer = cpuinfo_allocate(data_size, sizeof(wchar_t));
+	if (*text_buffer == NULL) {
+		cpuinfo_log_error("Registry textbuffer allocation error");
+		return false;
+	}
+
+	result = RegGetValueW(
+		HKEY_LOCAL_MACHINE,
+		subkey,
+		value,
+		flags,
+		NULL,
+		*text_buffer, /* Write string in this destination buffer */
+		&data_size);
+	if (result != 0) {
+		cpuinfo_log_error("Registry read error");
+		return false;
+	}
+	return true;
+}
+
+static bool get_system_info_from_registry(
+	struct woa_chip_info** chip_info)
+{
+	bool result = false;
+	char* text_buffer = NULL;
+	LPCWSTR cpu0_subkey = L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0";
+	LPCWSTR chip_name_value = L"ProcessorNameString";
+
+	*chip_info = NULL;
+
+	/* Read processor model name from registry and find in the hard-coded list. */
+	if (!read_registry(cpu0_subkey, chip_name_value, &text_buffer)) {
+		cpuinfo_log_error("Registry read error");
+		goto cleanup;
+	}
+	for (uint32_t i = 0; i < (uint32_t) woa_chip_name_last; i++) {
+		size_t compare_length = wcsnlen(woa_chips[i].chip_name_string, CPUINFO_PACKAGE_NAME_MAX);
+		int compare_result = wcsncmp(text_buffer, woa_chips[i].chip_name_string, compare_length);
+		if (compare_result == 0) {
+			*chip_info = woa_chips+i;
+			break;
+		}
+	}
+	if (*chip_info == NULL) {
+		/* No match was found, so print a warning and assign the unknown case. */
+		cpuinfo_log_error("Unknown chip model name '%ls'.\nPlease add new Windows on Arm SoC/chip support to arm/windows/init.c!", text_buffer);
+		goto cleanup;
+	}
+	cpuinfo_log_debug("detected chip model name: %s", (**chip_info).chip_name_string);
+
+cleanup:
+	cpuinfo_deallocate(text_buffer);
+	text_buffer = NULL;
+	return result;
+}
+
+static void set_cpuinfo_isa_fields(void)
+{
+	cpuinfo_isa.atomics = IsProcessorFeaturePresent(PF_ARM_V81_ATOMIC_INSTRUCTIONS_AVAILABLE) != 0;
+	cpuinfo_isa.lse2 = IsProcessorFeaturePresent(PF_ARM_LSE2_AVAILABLE) != 0;
+	cpuinfo_isa.rcpc = IsProcessorFeaturePresent(PF_ARM_V83_LRCPC_INSTRUCTIONS_AVAILABLE) != 0;
+
+	const bool dotprod = IsProcessorFeaturePresent(PF_ARM_V82_DP_INSTRUCTIONS_AVAILABLE) != 0;
+	cpuinfo_isa.dot = dotprod;
+
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	switch (system_info.wProcessorLevel) {
+		case 0x803:  // Kryo 385 Silver (Snapdragon 850)
+			cpuinfo_isa.fp16arith = dotprod;
+			cpuinfo_isa.rdm = dotprod;
+			break;
+		default:
+			// Assume that Dot Product support implies FP16 arithmetics and RDM support.
+			// ARM manuals don't guarantee that, but it holds in practice.
+			cpuinfo_isa.fp16arith = dotprod;
+			cpuinfo_isa.rdm = dotprod;
+			break;
+	}
+
+	/* Windows API reports all or nothing for cryptographic instructions. */
+	const bool crypto = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+	cpuinfo_isa.aes = crypto;
+	cpuinfo_isa.sha1 = crypto;
+	cpuinfo_isa.sha2 = crypto;
+	cpuinfo_isa.pmull = crypto;
+
+	cpuinfo_isa.crc32 = IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0;
+	cpuinfo_isa.sha3 = IsProcessorFeaturePresent(PF_ARM_SHA3_INSTRUCTIONS_AVAILABLE) != 0;
+	cpuinfo_isa.sha512 = IsProcessorFeaturePresent(PF_ARM_SHA512_INSTRUCTIONS_AVAILABLE) != 0;
+}
@@ -30,6 +30,11 @@ bool get_core_uarch_for_efficiency(
 	enum woa_chip_name chip, BYTE EfficiencyClass,
 	enum cpuinfo_uarch* uarch, uint64_t* frequency);
 
+/* Read the current and maximum frequencies of logical processors, in Hz, leaving 0 where they are unknown */
+void get_processor_frequencies(
+	const struct cpuinfo_processor* processors, uint32_t nr_of_processors,
+	uint64_t* frequencies, uint64_t* max_frequencies);
+
 bool cpu_info_init_by_logical_sys_info(
 	const struct woa_chip_info *chip_info,
 	enum cpuinfo_vendor vendor);
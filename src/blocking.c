@@ -0,0 +1,101 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Associativity assumed for caches which don't report it */
+#define DEFAULT_ASSOCIATIVITY 8
+
+/* Capacity of the cache available to one logical processor, with one way reserved for streaming data */
+static uint64_t get_available_size(const struct cpuinfo_cache* cache) {
+	const uint32_t associativity = cache->associativity != 0 ? cache->associativity : DEFAULT_ASSOCIATIVITY;
+	const uint64_t way_size = cache->size / associativity;
+	const uint32_t processor_count = cache->processor_count != 0 ? cache->processor_count : 1;
+	return (uint64_t) (associativity - 1) * way_size / processor_count;
+}
+
+/* Round the size up to whole ways of the cache */
+static uint64_t round_up_to_ways(const struct cpuinfo_cache* cache, uint64_t size) {
+	const uint32_t associativity = cache->associativity != 0 ? cache->associativity : DEFAULT_ASSOCIATIVITY;
+	const uint64_t way_size = cache->size / associativity;
+	if (way_size == 0) {
+		return size;
+	}
+	return (size + way_size - 1) / way_size * way_size;
+}
+
+/* Round the number of elements down to a multiple of the tile size, but not below one tile */
+static uint32_t round_down_to_tile(uint64_t elements, uint32_t tile) {
+	const uint64_t rounded = elements / tile * tile;
+	if (rounded == 0) {
+		return tile;
+	}
+	return rounded > UINT32_MAX / tile * tile ? UINT32_MAX / tile * tile : (uint32_t) rounded;
+}
+
+bool CPUINFO_ABI cpuinfo_get_uarch_blocking_hint(uint32_t uarch_index, uint32_t element_size, uint32_t mr,
+	uint32_t nr, struct cpuinfo_blocking_hint* hint)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_blocking_hint");
+	if (element_size == 0 || mr == 0 || nr == 0 || hint == NULL) {
+		return false;
+	}
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if (processor == NULL) {
+		cpuinfo_log_debug("no processors with microarchitecture %"PRIu32" for blocking hint", uarch_index);
+		return false;
+	}
+	const struct cpuinfo_cache* l1d = processor->cache.l1d;
+	if (l1d == NULL || l1d->size == 0) {
+		return false;
+	}
+
+	/* Micro-panel of A takes the share mr / (mr + nr) of available L1 ways, and micro-panel of B the rest */
+	const uint64_t l1_size = get_available_size(l1d);
+	uint64_t kc = l1_size * mr / (mr + nr) / ((uint64_t) mr * element_size);
+	if (kc == 0) {
+		kc = 1;
+	} else if (kc > UINT32_MAX) {
+		kc = UINT32_MAX;
+	}
+	const uint64_t panel_size = kc * element_size;
+
+	uint32_t mc = 0;
+	const struct cpuinfo_cache* l2 = processor->cache.l2;
+	if (l2 != NULL && l2->size != 0) {
+		/* Block of A shares L2 with the micro-panel of B */
+		const uint64_t l2_size = get_available_size(l2);
+		const uint64_t b_size = round_up_to_ways(l2, panel_size * nr);
+		mc = round_down_to_tile(l2_size > b_size ? (l2_size - b_size) / panel_size : 0, mr);
+	}
+
+	uint32_t nc = 0;
+	const struct cpuinfo_cache* l3 = processor->cache.l3;
+	if (l3 != NULL && l3->size != 0) {
+		/* Inclusive L3 also holds the block of A */
+		const uint64_t l3_size = get_available_size(l3);
+		const uint64_t a_size =
+			(l3->flags & CPUINFO_CACHE_INCLUSIVE) ? round_up_to_ways(l3, panel_size * mc) : 0;
+		nc = round_down_to_tile(l3_size > a_size ? (l3_size - a_size) / panel_size : 0, nr);
+	}
+
+	*hint = (struct cpuinfo_blocking_hint) {
+		.kc = (uint32_t) kc,
+		.mc = mc,
+		.nc = nc,
+		.line_size = l1d->line_size,
+	};
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_get_blocking_hint(uint32_t element_size, uint32_t mr, uint32_t nr,
+	struct cpuinfo_blocking_hint* hint)
+{
+	return cpuinfo_get_uarch_blocking_hint(
+		cpuinfo_get_current_uarch_index_with_default(0), element_size, mr, nr, hint);
+}
@@ -1,7 +1,16 @@
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
 
 #include <cpuinfo.h>
 #include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+  #include <x86/api.h>
+#elif (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && !defined(_WIN32)
+  #include <arm/api.h>
+#endif
 
 
 uint32_t cpuinfo_compute_max_cache_size(const struct cpuinfo_processor* processor) {
@@ -16,3 +25,315 @@ uint32_t cpuinfo_compute_max_cache_size(const struct cpuinfo_processor* processo
   }
   return 0;
 }
+
+const struct cpuinfo_cache* cpuinfo_get_last_level_cache(const struct cpuinfo_processor* processor) {
+  if (processor->cache.l4 != NULL) {
+    return processor->cache.l4;
+  } else if (processor->cache.l3 != NULL) {
+    return processor->cache.l3;
+  } else if (processor->cache.l2 != NULL) {
+    return processor->cache.l2;
+  } else {
+    return processor->cache.l1d;
+  }
+}
+
+/* Check if only logical processors of the core share the cache */
+static bool is_private_cache(const struct cpuinfo_cache* cache, const struct cpuinfo_core* core) {
+  return cache != NULL && cache->processor_start >= core->processor_start &&
+    cache->processor_start + cache->processor_count <= core->processor_start + core->processor_count;
+}
+
+static uint32_t compute_processor_max_cache_size(const struct cpuinfo_tables* tables,
+  const struct cpuinfo_processor* processor)
+{
+  #if (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+    /* Detected caches of ARM cores may be smaller than actual ones: use the upper bound for the microarchitecture */
+    const uint32_t max_cache_size = cpuinfo_arm_compute_max_cache_size(processor);
+  #else
+    const uint32_t max_cache_size = cpuinfo_compute_max_cache_size(processor);
+  #endif
+  /* Platforms without cache information report only the global upper bound */
+  return max_cache_size != 0 ? max_cache_size : tables->max_cache_size;
+}
+
+static uint32_t compute_processor_private_cache_size(const struct cpuinfo_processor* processor) {
+  const struct cpuinfo_cache* caches[] = {
+    processor->cache.l4, processor->cache.l3, processor->cache.l2, processor->cache.l1d,
+  };
+  for (uint32_t i = 0; i < sizeof(caches) / sizeof(caches[0]); i++) {
+    if (is_private_cache(caches[i], processor->core)) {
+      return caches[i]->size;
+    }
+  }
+  return 0;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_processor_max_cache_size(const struct cpuinfo_processor* processor) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("processor_max_cache_size");
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  return compute_processor_max_cache_size(tables, processor);
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_processor_private_cache_size(const struct cpuinfo_processor* processor) {
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  return compute_processor_private_cache_size(processor);
+}
+
+static const struct cpuinfo_cache* get_data_cache(const struct cpuinfo_processor* processor, uint32_t level) {
+  switch (level) {
+    case 1:
+      return processor->cache.l1d;
+    case 2:
+      return processor->cache.l2;
+    case 3:
+      return processor->cache.l3;
+    case 4:
+      return processor->cache.l4;
+    default:
+      return NULL;
+  }
+}
+
+/* Count cores which share the cache: the first logical processor of every such core is in its processor range */
+static uint32_t count_sharing_cores(const struct cpuinfo_tables* tables, const struct cpuinfo_cache* cache) {
+  uint32_t cores_count = 0;
+  for (uint32_t i = 0; i < cache->processor_count; i++) {
+    const uint32_t processor_index = cache->processor_start + i;
+    if (processor_index < tables->processors_count &&
+      tables->processors[processor_index].core->processor_start == processor_index)
+    {
+      cores_count += 1;
+    }
+  }
+  return cores_count != 0 ? cores_count : 1;
+}
+
+static uint32_t compute_effective_cache_size(const struct cpuinfo_tables* tables,
+  const struct cpuinfo_processor* processor, uint32_t level)
+{
+  const struct cpuinfo_cache* cache = get_data_cache(processor, level);
+  if (cache == NULL) {
+    return 0;
+  }
+  uint32_t effective_size = cache->size / count_sharing_cores(tables, cache);
+  /* Exclusive caches don't duplicate lines of the level below, which adds to the capacity */
+  if (cache->flags & CPUINFO_CACHE_EXCLUSIVE) {
+    effective_size += compute_effective_cache_size(tables, processor, level - 1);
+  }
+  return effective_size;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_processor_effective_cache_size(const struct cpuinfo_processor* processor,
+  uint32_t level)
+{
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("processor_effective_cache_size");
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  return compute_effective_cache_size(tables, processor, level);
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_max_cache_size(uint32_t uarch_index) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_max_cache_size");
+  const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  return compute_processor_max_cache_size(tables, processor);
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_private_cache_size(uint32_t uarch_index) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_private_cache_size");
+  const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  return compute_processor_private_cache_size(processor);
+}
+
+static struct cpuinfo_uarch_streaming_hints decode_streaming_hints(enum cpuinfo_uarch uarch) {
+  #if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+    return cpuinfo_x86_decode_streaming_hints(uarch);
+  #elif (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && !defined(_WIN32)
+    return cpuinfo_arm_decode_streaming_hints(uarch);
+  #else
+    return (struct cpuinfo_uarch_streaming_hints) {
+      .prefetch_distance = 256,
+      .llc_sixteenths = 12,
+    };
+  #endif
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_non_temporal_threshold(uint32_t uarch_index) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_non_temporal_threshold");
+  const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  const struct cpuinfo_cache* llc = cpuinfo_get_last_level_cache(processor);
+  if (llc == NULL) {
+    return 0;
+  }
+  /* Capacity of the sharing domain, including the lower levels which an exclusive last level cache doesn't duplicate */
+  uint32_t level = 1;
+  if (llc == processor->cache.l4) {
+    level = 4;
+  } else if (llc == processor->cache.l3) {
+    level = 3;
+  } else if (llc == processor->cache.l2) {
+    level = 2;
+  }
+  const uint64_t domain_size =
+    (uint64_t) compute_effective_cache_size(tables, processor, level) * count_sharing_cores(tables, llc);
+  const struct cpuinfo_uarch_streaming_hints hints = decode_streaming_hints(processor->core->uarch);
+  const uint64_t threshold = domain_size * hints.llc_sixteenths / 16;
+  return threshold < UINT32_MAX ? (uint32_t) threshold : UINT32_MAX;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_prefetch_distance(uint32_t uarch_index) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_prefetch_distance");
+  const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    return 0;
+  }
+  uint32_t prefetch_distance = decode_streaming_hints(processor->core->uarch).prefetch_distance;
+  /* Without the L2 streamer running ahead, software prefetches alone must cover the latency of memory */
+  if (tables->prefetchers.source == cpuinfo_prefetchers_source_msr && !tables->prefetchers.l2_stream &&
+    cpuinfo_decode_default_prefetchers(processor->core).l2_stream)
+  {
+    prefetch_distance *= 2;
+  }
+  return prefetch_distance;
+}
+
+/*
+ * Intel cores since Core 2 and Pentium 4 have the L2 spatial prefetcher, which completes 128-byte aligned line pairs,
+ * unless firmware disabled it on all cores
+ */
+static bool has_spatial_prefetcher(const struct cpuinfo_tables* tables, const struct cpuinfo_core* core) {
+  if (!cpuinfo_decode_default_prefetchers(core).l2_adjacent_line) {
+    return false;
+  }
+  return tables->prefetchers.source != cpuinfo_prefetchers_source_msr || tables->prefetchers.l2_adjacent_line;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_destructive_interference_size(void) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("destructive_interference_size");
+  uint32_t interference_size = 0;
+  for (uint32_t i = 0; i < tables->processors_count; i++) {
+    const struct cpuinfo_processor* processor = &tables->processors[i];
+    uint32_t line_size = processor->cache.l1d != NULL ? processor->cache.l1d->line_size : 0;
+    if (processor->cache.l2 != NULL && processor->cache.l2->line_size > line_size) {
+      line_size = processor->cache.l2->line_size;
+    }
+    if (has_spatial_prefetcher(tables, processor->core)) {
+      line_size *= 2;
+    }
+    if (line_size > interference_size) {
+      interference_size = line_size;
+    }
+  }
+  return interference_size != 0 ? interference_size : CPUINFO_DESTRUCTIVE_INTERFERENCE_SIZE;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_constructive_interference_size(void) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("constructive_interference_size");
+  uint32_t interference_size = UINT32_MAX;
+  for (uint32_t i = 0; i < tables->processors_count; i++) {
+    const struct cpuinfo_cache* l1d = tables->processors[i].cache.l1d;
+    if (l1d != NULL && l1d->line_size != 0 && l1d->line_size < interference_size) {
+      interference_size = l1d->line_size;
+    }
+  }
+  return interference_size != UINT32_MAX ? interference_size : CPUINFO_CONSTRUCTIVE_INTERFERENCE_SIZE;
+}
+
+#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+  /* Linux enables EL0 reads of CTR_EL0, and emulates them with the system-wide value if cores differ */
+  static uint64_t read_cache_type_register(void) {
+    uint64_t ctr_el0;
+    __asm__ __volatile__("mrs %0, ctr_el0" : "=r" (ctr_el0));
+    return ctr_el0;
+  }
+#endif
+
+/* Smallest line sizes of L1 instruction and data caches of the processors, or 0 if unknown */
+static void compute_l1_line_sizes(const struct cpuinfo_processor* processors, uint32_t processors_count,
+  struct cpuinfo_code_cache_maintenance maintenance[restrict static 1])
+{
+  uint32_t icache_line_size = UINT32_MAX, dcache_line_size = UINT32_MAX;
+  for (uint32_t i = 0; i < processors_count; i++) {
+    const struct cpuinfo_cache* l1i = processors[i].cache.l1i;
+    const struct cpuinfo_cache* l1d = processors[i].cache.l1d;
+    if (l1i != NULL && l1i->line_size != 0 && l1i->line_size < icache_line_size) {
+      icache_line_size = l1i->line_size;
+    }
+    if (l1d != NULL && l1d->line_size != 0 && l1d->line_size < dcache_line_size) {
+      dcache_line_size = l1d->line_size;
+    }
+  }
+  maintenance->icache_line_size = icache_line_size != UINT32_MAX ? icache_line_size : 0;
+  maintenance->dcache_line_size = dcache_line_size != UINT32_MAX ? dcache_line_size : 0;
+}
+
+void cpuinfo_detect_code_cache_maintenance(struct cpuinfo_tables* tables) {
+  struct cpuinfo_code_cache_maintenance maintenance = { 0 };
+  compute_l1_line_sizes(tables->processors, tables->processors_count, &maintenance);
+  #if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+    /* Instruction caches snoop stores; a jump or a serializing instruction suffices after modifying code */
+    maintenance.icache_invalidation_not_required = true;
+    maintenance.dcache_clean_not_required = true;
+  #elif CPUINFO_ARCH_ARM64 && defined(__linux__)
+    /* Captures of other systems describe their caches, but not their CTR_EL0 */
+    if (!cpuinfo_replaying_capture) {
+      const uint64_t ctr_el0 = read_cache_type_register();
+      maintenance.cache_type_register = ctr_el0;
+      /* IminLine and DminLine are log2 of the number of 4-byte words */
+      maintenance.icache_line_size = UINT32_C(4) << (ctr_el0 & 0xF);
+      maintenance.dcache_line_size = UINT32_C(4) << ((ctr_el0 >> 16) & 0xF);
+      maintenance.dcache_clean_not_required = (ctr_el0 & (UINT64_C(1) << 28)) != 0;
+      maintenance.icache_invalidation_not_required = (ctr_el0 & (UINT64_C(1) << 29)) != 0;
+    }
+  #endif
+  tables->code_cache_maintenance = maintenance;
+  cpuinfo_log_debug("code cache maintenance: I-cache line %"PRIu32" bytes%s, D-cache line %"PRIu32" bytes%s",
+    maintenance.icache_line_size, maintenance.icache_invalidation_not_required ? " (DIC)" : "",
+    maintenance.dcache_line_size, maintenance.dcache_clean_not_required ? " (IDC)" : "");
+}
+
+void CPUINFO_ABI cpuinfo_get_code_cache_maintenance(struct cpuinfo_code_cache_maintenance* maintenance) {
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("code_cache_maintenance");
+  if CPUINFO_UNLIKELY(maintenance == NULL) {
+    return;
+  }
+  *maintenance = tables->code_cache_maintenance;
+}
+
+bool CPUINFO_ABI cpuinfo_get_uarch_code_cache_maintenance(uint32_t uarch_index,
+  struct cpuinfo_code_cache_maintenance* maintenance)
+{
+  const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_code_cache_maintenance");
+  if CPUINFO_UNLIKELY(maintenance == NULL) {
+    return false;
+  }
+  const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+  if CPUINFO_UNLIKELY(processor == NULL) {
+    *maintenance = (struct cpuinfo_code_cache_maintenance) { 0 };
+    return false;
+  }
+  *maintenance = tables->code_cache_maintenance;
+  struct cpuinfo_code_cache_maintenance uarch_maintenance;
+  compute_l1_line_sizes(processor, 1, &uarch_maintenance);
+  if (uarch_maintenance.icache_line_size != 0) {
+    maintenance->icache_line_size = uarch_maintenance.icache_line_size;
+  }
+  if (uarch_maintenance.dcache_line_size != 0) {
+    maintenance->dcache_line_size = uarch_maintenance.dcache_line_size;
+  }
+  return true;
+}
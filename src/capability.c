@@ -0,0 +1,361 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <unistd.h>
+	#include <sys/socket.h>
+	#include <linux/netlink.h>
+	#include <linux/genetlink.h>
+#endif
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	/*
+	 * Names and numbers of the thermal generic netlink family in the stable UAPI of linux/thermal.h, defined here
+	 * because kernel headers before Linux 5.18 lack the CPU capability events
+	 */
+	#define THERMAL_FAMILY_NAME "thermal"
+	#define THERMAL_EVENT_GROUP_NAME "event"
+	#define THERMAL_EVENT_CPU_CAPABILITY_CHANGE 15
+	#define THERMAL_ATTR_CPU_CAPABILITY 20
+	#define THERMAL_ATTR_CPU_CAPABILITY_ID 21
+	#define THERMAL_ATTR_CPU_CAPABILITY_PERFORMANCE 22
+	#define THERMAL_ATTR_CPU_CAPABILITY_EFFICIENCY 23
+
+	/* Large enough for a batch of capabilities of 16 processors, and for the description of the thermal family */
+	#define NETLINK_BUFFER_SIZE 8192
+
+	#if !defined(SOL_NETLINK)
+		#define SOL_NETLINK 270
+	#endif
+#endif
+
+struct cpuinfo_capability_monitor {
+	uint32_t cores_count;
+	/* Latest capabilities of every core */
+	struct cpuinfo_core_capability* capabilities;
+#if defined(__linux__)
+	/* Generic netlink socket subscribed to events of the thermal family */
+	int socket;
+	uint16_t family_id;
+	/* Index of the core of every Linux processor ID up to the maximum in the tables, or UINT32_MAX */
+	uint32_t* linux_id_cores;
+	uint32_t linux_ids_count;
+	char* buffer;
+#endif
+};
+
+#if defined(__linux__)
+	static inline const struct nlattr* first_attribute(const void* payload) {
+		return (const struct nlattr*) payload;
+	}
+
+	static inline bool attribute_fits(const struct nlattr* attribute, const char* end) {
+		return (const char*) attribute + NLA_HDRLEN <= end && attribute->nla_len >= NLA_HDRLEN &&
+			(const char*) attribute + attribute->nla_len <= end;
+	}
+
+	static inline const struct nlattr* next_attribute(const struct nlattr* attribute) {
+		return (const struct nlattr*) ((const char*) attribute + NLA_ALIGN(attribute->nla_len));
+	}
+
+	static inline const void* attribute_data(const struct nlattr* attribute) {
+		return (const char*) attribute + NLA_HDRLEN;
+	}
+
+	static inline uint32_t attribute_type(const struct nlattr* attribute) {
+		return attribute->nla_type & NLA_TYPE_MASK;
+	}
+
+	static uint32_t attribute_u32(const struct nlattr* attribute) {
+		uint32_t value = 0;
+		if (attribute->nla_len >= NLA_HDRLEN + sizeof(uint32_t)) {
+			memcpy(&value, attribute_data(attribute), sizeof(uint32_t));
+		}
+		return value;
+	}
+
+	/* Find the multicast group ID with the name in the CTRL_ATTR_MCAST_GROUPS attribute of the family description */
+	static uint32_t find_multicast_group(const struct nlattr* groups, const char* name) {
+		const char* groups_end = (const char*) groups + groups->nla_len;
+		for (const struct nlattr* group = first_attribute(attribute_data(groups));
+			attribute_fits(group, groups_end); group = next_attribute(group))
+		{
+			const char* group_end = (const char*) group + group->nla_len;
+			uint32_t group_id = 0;
+			bool name_matches = false;
+			for (const struct nlattr* attribute = first_attribute(attribute_data(group));
+				attribute_fits(attribute, group_end); attribute = next_attribute(attribute))
+			{
+				switch (attribute_type(attribute)) {
+					case CTRL_ATTR_MCAST_GRP_NAME:
+						name_matches = (size_t) (attribute->nla_len - NLA_HDRLEN) >= strlen(name) + 1 &&
+							strcmp((const char*) attribute_data(attribute), name) == 0;
+						break;
+					case CTRL_ATTR_MCAST_GRP_ID:
+						group_id = attribute_u32(attribute);
+						break;
+				}
+			}
+			if (name_matches) {
+				return group_id;
+			}
+		}
+		return 0;
+	}
+
+	/* Resolve the ID of the thermal family and of its event multicast group with a CTRL_CMD_GETFAMILY request */
+	static bool resolve_thermal_family(struct cpuinfo_capability_monitor monitor[restrict static 1],
+		uint32_t group_id[restrict static 1])
+	{
+		struct {
+			struct nlmsghdr header;
+			struct genlmsghdr genl_header;
+			struct nlattr name_header;
+			char name[NLA_ALIGN(sizeof(THERMAL_FAMILY_NAME))];
+		} request;
+		memset(&request, 0, sizeof(request));
+		request.header.nlmsg_len = sizeof(request);
+		request.header.nlmsg_type = GENL_ID_CTRL;
+		request.header.nlmsg_flags = NLM_F_REQUEST;
+		request.header.nlmsg_seq = 1;
+		request.genl_header.cmd = CTRL_CMD_GETFAMILY;
+		request.genl_header.version = 1;
+		request.name_header.nla_type = CTRL_ATTR_FAMILY_NAME;
+		request.name_header.nla_len = NLA_HDRLEN + sizeof(THERMAL_FAMILY_NAME);
+		memcpy(request.name, THERMAL_FAMILY_NAME, sizeof(THERMAL_FAMILY_NAME));
+		if (send(monitor->socket, &request, sizeof(request), 0) != (ssize_t) sizeof(request)) {
+			cpuinfo_log_warning("failed to request thermal netlink family: %s", strerror(errno));
+			return false;
+		}
+
+		const ssize_t bytes_received = recv(monitor->socket, monitor->buffer, NETLINK_BUFFER_SIZE, 0);
+		if (bytes_received < 0) {
+			cpuinfo_log_warning("failed to receive thermal netlink family: %s", strerror(errno));
+			return false;
+		}
+		const struct nlmsghdr* header = (const struct nlmsghdr*) monitor->buffer;
+		if (!NLMSG_OK(header, (size_t) bytes_received) || header->nlmsg_type != GENL_ID_CTRL) {
+			/* NLMSG_ERROR reply: thermal netlink is not enabled in the kernel */
+			cpuinfo_log_info("thermal netlink family is not available");
+			return false;
+		}
+
+		const char* message_end = (const char*) header + header->nlmsg_len;
+		for (const struct nlattr* attribute = first_attribute((const char*) NLMSG_DATA(header) + GENL_HDRLEN);
+			attribute_fits(attribute, message_end); attribute = next_attribute(attribute))
+		{
+			switch (attribute_type(attribute)) {
+				case CTRL_ATTR_FAMILY_ID:
+					if (attribute->nla_len >= NLA_HDRLEN + sizeof(uint16_t)) {
+						memcpy(&monitor->family_id, attribute_data(attribute), sizeof(uint16_t));
+					}
+					break;
+				case CTRL_ATTR_MCAST_GROUPS:
+					*group_id = find_multicast_group(attribute, THERMAL_EVENT_GROUP_NAME);
+					break;
+			}
+		}
+		return monitor->family_id != 0 && *group_id != 0;
+	}
+
+	/* Apply the flat list of ID, performance, and efficiency attributes of a CPU capability change event */
+	static uint32_t apply_capabilities(struct cpuinfo_capability_monitor monitor[restrict static 1],
+		const struct nlattr* capabilities)
+	{
+		const char* capabilities_end = (const char*) capabilities + capabilities->nla_len;
+		uint32_t updates_count = 0;
+		uint32_t core_index = UINT32_MAX;
+		struct cpuinfo_core_capability capability = { 0 };
+		for (const struct nlattr* attribute = first_attribute(attribute_data(capabilities));
+			attribute_fits(attribute, capabilities_end); attribute = next_attribute(attribute))
+		{
+			switch (attribute_type(attribute)) {
+				case THERMAL_ATTR_CPU_CAPABILITY_ID:
+				{
+					const uint32_t linux_id = attribute_u32(attribute);
+					core_index = linux_id < monitor->linux_ids_count ? monitor->linux_id_cores[linux_id] : UINT32_MAX;
+					break;
+				}
+				case THERMAL_ATTR_CPU_CAPABILITY_PERFORMANCE:
+					capability.performance = attribute_u32(attribute);
+					break;
+				case THERMAL_ATTR_CPU_CAPABILITY_EFFICIENCY:
+					/* Efficiency is the last attribute of a processor */
+					capability.efficiency = attribute_u32(attribute);
+					if (core_index != UINT32_MAX) {
+						capability.updates_count = monitor->capabilities[core_index].updates_count + 1;
+						monitor->capabilities[core_index] = capability;
+						updates_count += 1;
+					}
+					core_index = UINT32_MAX;
+					break;
+			}
+		}
+		return updates_count;
+	}
+
+	static uint32_t apply_message(struct cpuinfo_capability_monitor monitor[restrict static 1],
+		const struct nlmsghdr* header)
+	{
+		if (header->nlmsg_type != monitor->family_id || header->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+			return 0;
+		}
+		const struct genlmsghdr* genl_header = (const struct genlmsghdr*) NLMSG_DATA(header);
+		if (genl_header->cmd != THERMAL_EVENT_CPU_CAPABILITY_CHANGE) {
+			return 0;
+		}
+		uint32_t updates_count = 0;
+		const char* message_end = (const char*) header + header->nlmsg_len;
+		for (const struct nlattr* attribute = first_attribute((const char*) genl_header + GENL_HDRLEN);
+			attribute_fits(attribute, message_end); attribute = next_attribute(attribute))
+		{
+			if (attribute_type(attribute) == THERMAL_ATTR_CPU_CAPABILITY) {
+				updates_count += apply_capabilities(monitor, attribute);
+			}
+		}
+		return updates_count;
+	}
+#endif
+
+struct cpuinfo_capability_monitor* CPUINFO_ABI cpuinfo_create_capability_monitor(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("capability_monitor");
+	#if defined(__linux__)
+		struct cpuinfo_capability_monitor* monitor = calloc(1, sizeof(struct cpuinfo_capability_monitor));
+		if (monitor == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for capability monitor",
+				sizeof(struct cpuinfo_capability_monitor));
+			return NULL;
+		}
+		monitor->socket = -1;
+		monitor->cores_count = tables->cores_count;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			if (tables->processors[i].linux_id >= 0 &&
+				(uint32_t) tables->processors[i].linux_id >= monitor->linux_ids_count)
+			{
+				monitor->linux_ids_count = (uint32_t) tables->processors[i].linux_id + 1;
+			}
+		}
+		monitor->capabilities = calloc(monitor->cores_count, sizeof(struct cpuinfo_core_capability));
+		monitor->linux_id_cores = calloc(monitor->linux_ids_count, sizeof(uint32_t));
+		monitor->buffer = malloc(NETLINK_BUFFER_SIZE);
+		if (monitor->capabilities == NULL || monitor->linux_id_cores == NULL || monitor->buffer == NULL) {
+			cpuinfo_log_error("failed to allocate capability monitor of %"PRIu32" cores", monitor->cores_count);
+			cpuinfo_destroy_capability_monitor(monitor);
+			return NULL;
+		}
+		for (uint32_t i = 0; i < monitor->linux_ids_count; i++) {
+			monitor->linux_id_cores[i] = UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			if (processor->linux_id >= 0) {
+				monitor->linux_id_cores[processor->linux_id] = (uint32_t) (processor->core - tables->cores);
+			}
+		}
+
+		monitor->socket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+		if (monitor->socket == -1) {
+			cpuinfo_log_warning("failed to create generic netlink socket: %s", strerror(errno));
+			cpuinfo_destroy_capability_monitor(monitor);
+			return NULL;
+		}
+		uint32_t group_id = 0;
+		if (!resolve_thermal_family(monitor, &group_id)) {
+			cpuinfo_destroy_capability_monitor(monitor);
+			return NULL;
+		}
+		/* Some kernels admit only processes with CAP_NET_ADMIN to the thermal event group */
+		if (setsockopt(monitor->socket, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &group_id, sizeof(group_id)) != 0) {
+			cpuinfo_log_warning("failed to subscribe to thermal netlink events: %s", strerror(errno));
+			cpuinfo_destroy_capability_monitor(monitor);
+			return NULL;
+		}
+		return monitor;
+	#else
+		(void) tables;
+		return NULL;
+	#endif
+}
+
+void CPUINFO_ABI cpuinfo_destroy_capability_monitor(struct cpuinfo_capability_monitor* monitor) {
+	if (monitor == NULL) {
+		return;
+	}
+	#if defined(__linux__)
+		if (monitor->socket != -1) {
+			close(monitor->socket);
+		}
+		free(monitor->linux_id_cores);
+		free(monitor->buffer);
+	#endif
+	free(monitor->capabilities);
+	free(monitor);
+}
+
+int CPUINFO_ABI cpuinfo_get_capability_monitor_fd(const struct cpuinfo_capability_monitor* monitor) {
+	#if defined(__linux__)
+		return monitor != NULL ? monitor->socket : -1;
+	#else
+		(void) monitor;
+		return -1;
+	#endif
+}
+
+uint32_t CPUINFO_ABI cpuinfo_update_core_capabilities(struct cpuinfo_capability_monitor* monitor) {
+	if (monitor == NULL) {
+		return 0;
+	}
+	uint32_t updates_count = 0;
+	#if defined(__linux__)
+		for (;;) {
+			const ssize_t bytes_received = recv(monitor->socket, monitor->buffer, NETLINK_BUFFER_SIZE, MSG_DONTWAIT);
+			if (bytes_received < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno == ENOBUFS) {
+					/* The socket buffer overflowed: later events are still delivered, but some were lost */
+					cpuinfo_log_warning("lost thermal netlink events: socket buffer overflowed");
+					continue;
+				}
+				if (errno != EAGAIN && errno != EWOULDBLOCK) {
+					cpuinfo_log_warning("failed to receive thermal netlink events: %s", strerror(errno));
+				}
+				break;
+			}
+			size_t length = (size_t) bytes_received;
+			for (const struct nlmsghdr* header = (const struct nlmsghdr*) monitor->buffer;
+				NLMSG_OK(header, length); header = NLMSG_NEXT(header, length))
+			{
+				updates_count += apply_message(monitor, header);
+			}
+		}
+	#endif
+	return updates_count;
+}
+
+bool CPUINFO_ABI cpuinfo_get_core_capability(const struct cpuinfo_capability_monitor* monitor,
+	const struct cpuinfo_core* core, struct cpuinfo_core_capability* capability)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("core_capability");
+	if (monitor == NULL || core == NULL || capability == NULL) {
+		return false;
+	}
+	const uint32_t core_index = (uint32_t) (core - tables->cores);
+	if CPUINFO_UNLIKELY(core < tables->cores || core_index >= monitor->cores_count) {
+		return false;
+	}
+	*capability = monitor->capabilities[core_index];
+	return true;
+}
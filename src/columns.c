@@ -0,0 +1,80 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Index of the object in the table, or CPUINFO_COLUMN_INDEX_NONE if the object is NULL */
+static inline uint16_t get_column_index(const void* object, const void* table, size_t entry_size) {
+	if (object == NULL || table == NULL) {
+		return CPUINFO_COLUMN_INDEX_NONE;
+	}
+	return (uint16_t) (((uintptr_t) object - (uintptr_t) table) / entry_size);
+}
+
+bool cpuinfo_build_processor_columns(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	if (processors_count == 0) {
+		return true;
+	}
+	/* Every index, and CPUINFO_COLUMN_INDEX_NONE, must fit into 16 bits */
+	uint32_t max_count = processors_count;
+	const uint32_t counts[] = {
+		tables->cores_count, tables->clusters_count, tables->packages_count, tables->numa_nodes_count,
+		tables->frequency_domains_count, tables->llc_domains_count, tables->uarchs_count,
+		tables->cache_count[cpuinfo_cache_level_1i], tables->cache_count[cpuinfo_cache_level_1d],
+		tables->cache_count[cpuinfo_cache_level_2], tables->cache_count[cpuinfo_cache_level_3],
+		tables->cache_count[cpuinfo_cache_level_4],
+	};
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(counts); i++) {
+		if (counts[i] > max_count) {
+			max_count = counts[i];
+		}
+	}
+	if (max_count >= CPUINFO_COLUMN_INDEX_NONE) {
+		cpuinfo_log_warning("processor columns are not available: %"PRIu32" objects exceed the 16-bit index range",
+			max_count);
+		return true;
+	}
+
+	struct cpuinfo_arena arena = { 0 };
+	cpuinfo_arena_reserve(&arena, (size_t) cpuinfo_processor_column_max * processors_count, sizeof(uint16_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return false;
+	}
+	uint16_t* columns = arena.memory;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		uint16_t* column = &columns[i];
+		column[cpuinfo_processor_column_core * processors_count] =
+			get_column_index(processor->core, tables->cores, sizeof(struct cpuinfo_core));
+		column[cpuinfo_processor_column_cluster * processors_count] =
+			get_column_index(processor->cluster, tables->clusters, sizeof(struct cpuinfo_cluster));
+		column[cpuinfo_processor_column_package * processors_count] =
+			get_column_index(processor->package, tables->packages, sizeof(struct cpuinfo_package));
+		column[cpuinfo_processor_column_numa_node * processors_count] =
+			get_column_index(processor->numa_node, tables->numa_nodes, sizeof(struct cpuinfo_numa_node));
+		column[cpuinfo_processor_column_frequency_domain * processors_count] = get_column_index(
+			processor->frequency_domain, tables->frequency_domains, sizeof(struct cpuinfo_frequency_domain));
+		column[cpuinfo_processor_column_llc_domain * processors_count] = tables->processor_llc_domain_index != NULL ?
+			(uint16_t) tables->processor_llc_domain_index[i] : CPUINFO_COLUMN_INDEX_NONE;
+		column[cpuinfo_processor_column_uarch * processors_count] =
+			(uint16_t) cpuinfo_get_processor_uarch_index(tables, processor);
+		column[cpuinfo_processor_column_l1i * processors_count] = get_column_index(processor->cache.l1i,
+			tables->cache[cpuinfo_cache_level_1i], sizeof(struct cpuinfo_cache));
+		column[cpuinfo_processor_column_l1d * processors_count] = get_column_index(processor->cache.l1d,
+			tables->cache[cpuinfo_cache_level_1d], sizeof(struct cpuinfo_cache));
+		column[cpuinfo_processor_column_l2 * processors_count] = get_column_index(processor->cache.l2,
+			tables->cache[cpuinfo_cache_level_2], sizeof(struct cpuinfo_cache));
+		column[cpuinfo_processor_column_l3 * processors_count] = get_column_index(processor->cache.l3,
+			tables->cache[cpuinfo_cache_level_3], sizeof(struct cpuinfo_cache));
+		column[cpuinfo_processor_column_l4 * processors_count] = get_column_index(processor->cache.l4,
+			tables->cache[cpuinfo_cache_level_4], sizeof(struct cpuinfo_cache));
+	}
+	tables->processor_columns = columns;
+	return true;
+}
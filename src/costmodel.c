@@ -0,0 +1,81 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/common.h>
+
+
+#define COST_MODEL(uarch_, decode_, issue_, fma_, fma_latency_, pipes_, width_, loads_, stores_, rob_, l1d_) \
+	{ \
+		.uarch = cpuinfo_uarch_##uarch_, \
+		.decode_width = decode_, \
+		.issue_width = issue_, \
+		.fma_units = fma_, \
+		.fma_latency = fma_latency_, \
+		.vector_pipes = pipes_, \
+		.vector_pipe_width = width_, \
+		.load_ports = loads_, \
+		.store_ports = stores_, \
+		.rob_size = rob_, \
+		.l1d_latency = l1d_, \
+	}
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+/*
+ * Parameters of the cores, from optimization guides of Intel, AMD and Arm, and public microbenchmark results.
+ * Server and client variants of a microarchitecture share a row: e.g. the second 512-bit FMA pipe of Skylake-SP is
+ * not reflected. Values which the sources disagree on are left 0.
+ */
+static const struct cpuinfo_uarch_cost_model cost_models[] = {
+	/*          uarch           decode issue FMA lat pipes width loads stores ROB L1D */
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	COST_MODEL(nehalem,            4,   4,   0,  0,   3,  128,    1,    1, 128,  4),
+	COST_MODEL(sandy_bridge,       4,   4,   0,  0,   3,  256,    2,    1, 168,  4),
+	COST_MODEL(ivy_bridge,         4,   4,   0,  0,   3,  256,    2,    1, 168,  4),
+	COST_MODEL(haswell,            4,   4,   2,  5,   3,  256,    2,    1, 192,  4),
+	COST_MODEL(broadwell,          4,   4,   2,  5,   3,  256,    2,    1, 192,  4),
+	COST_MODEL(sky_lake,           4,   4,   2,  4,   3,  256,    2,    1, 224,  4),
+	COST_MODEL(sunny_cove,         4,   5,   2,  4,   3,  256,    2,    2, 352,  5),
+	COST_MODEL(golden_cove,        6,   6,   2,  4,   3,  256,    3,    2, 512,  5),
+	COST_MODEL(redwood_cove,       6,   6,   2,  4,   3,  256,    3,    2, 512,  5),
+	COST_MODEL(lion_cove,          8,   8,   2,  4,   4,  256,    3,    2, 576,  4),
+	COST_MODEL(gracemont,          6,   5,   2,  4,   3,  128,    2,    2, 256,  0),
+	COST_MODEL(knights_landing,    2,   2,   2,  6,   2,  512,    2,    1,  72,  5),
+	COST_MODEL(jaguar,             2,   2,   0,  0,   2,  128,    1,    1,  64,  3),
+	COST_MODEL(zen,                4,   6,   2,  5,   4,  128,    2,    1, 192,  4),
+	COST_MODEL(zen2,               4,   6,   2,  5,   4,  256,    2,    1, 224,  4),
+	COST_MODEL(zen3,               4,   6,   2,  4,   4,  256,    3,    2, 256,  4),
+	COST_MODEL(zen4,               4,   6,   2,  4,   4,  256,    3,    2, 320,  4),
+#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+	COST_MODEL(cortex_a53,         2,   2,   0,  0,   0,   64,    1,    1,   0,  3),
+	COST_MODEL(cortex_a55,         2,   2,   2,  4,   2,   64,    1,    1,   0,  3),
+	COST_MODEL(cortex_a57,         3,   3,   2, 10,   2,    0,    1,    1, 128,  4),
+	COST_MODEL(cortex_a72,         3,   3,   2,  7,   2,    0,    1,    1, 128,  4),
+	COST_MODEL(cortex_a76,         4,   4,   2,  4,   2,  128,    2,    1, 128,  4),
+	COST_MODEL(neoverse_n1,        4,   4,   2,  4,   2,  128,    2,    1, 128,  4),
+	COST_MODEL(cortex_a77,         4,   6,   2,  4,   2,  128,    2,    0, 160,  4),
+	COST_MODEL(cortex_a78,         4,   6,   2,  4,   2,  128,    3,    2, 160,  4),
+	COST_MODEL(cortex_x1,          5,   8,   4,  4,   4,  128,    3,    2, 224,  4),
+	COST_MODEL(neoverse_v1,        5,   8,   4,  4,   4,  128,    3,    2, 256,  4),
+	COST_MODEL(cortex_a510,        3,   3,   2,  4,   2,    0,    2,    1,   0,  3),
+	COST_MODEL(cortex_a710,        5,   5,   2,  4,   2,  128,    3,    2, 160,  4),
+	COST_MODEL(neoverse_n2,        5,   5,   2,  4,   2,  128,    3,    2, 160,  4),
+	COST_MODEL(cortex_x2,          5,   8,   4,  4,   4,  128,    3,    2, 288,  4),
+	COST_MODEL(cortex_x3,          6,   8,   4,  4,   4,  128,    3,    2, 320,  4),
+	COST_MODEL(firestorm,          8,   8,   4,  4,   4,  128,    3,    2, 630,  3),
+	COST_MODEL(icestorm,           4,   4,   2,  4,   2,  128,    2,    1,   0,  3),
+	COST_MODEL(avalanche,          8,   8,   4,  4,   4,  128,    3,    2,   0,  3),
+#endif
+};
+#endif
+
+const struct cpuinfo_uarch_cost_model* CPUINFO_ABI cpuinfo_get_uarch_cost_model(enum cpuinfo_uarch uarch) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		for (size_t i = 0; i < CPUINFO_COUNT_OF(cost_models); i++) {
+			if (cost_models[i].uarch == uarch) {
+				return &cost_models[i];
+			}
+		}
+	#endif
+	return NULL;
+}
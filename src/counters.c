@@ -0,0 +1,224 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <string.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+#endif
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#define COUNTER_SAMPLER_MAX_EVENTS 7
+#define COUNTER_SAMPLER_SUPPORTED_EVENTS \
+	(CPUINFO_PMU_EVENT_CYCLES | CPUINFO_PMU_EVENT_INSTRUCTIONS | CPUINFO_PMU_EVENT_REF_CYCLES | \
+		CPUINFO_PMU_EVENT_LLC_REFERENCES | CPUINFO_PMU_EVENT_LLC_MISSES | CPUINFO_PMU_EVENT_BRANCH_INSTRUCTIONS | \
+		CPUINFO_PMU_EVENT_BRANCH_MISSES)
+
+#if defined(__linux__)
+	/* Generic hardware events of perf_event, in the order of CPUINFO_PMU_EVENT_* flags */
+	static const uint64_t perf_hardware_events[COUNTER_SAMPLER_MAX_EVENTS] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_REF_CPU_CYCLES,
+		PERF_COUNT_HW_CACHE_REFERENCES,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+		PERF_COUNT_HW_BRANCH_MISSES,
+	};
+
+	/* Layout of a read of a group with PERF_FORMAT_GROUP and both PERF_FORMAT_TOTAL_TIME_* flags */
+	struct group_read_format {
+		uint64_t events_count;
+		uint64_t time_enabled;
+		uint64_t time_running;
+		uint64_t values[COUNTER_SAMPLER_MAX_EVENTS];
+	};
+
+	/* perf_event group of a logical processor: the leader file reads all events of the group */
+	struct processor_group {
+		int files[COUNTER_SAMPLER_MAX_EVENTS];
+		uint32_t files_count;
+		/* CPUINFO_PMU_EVENT_* flags of the opened events, in the order of values in reads of the group */
+		uint32_t events;
+	};
+#endif
+
+struct cpuinfo_counter_sampler {
+	uint32_t processor_start;
+	uint32_t processor_count;
+#if defined(__linux__)
+	struct processor_group* groups;
+#endif
+};
+
+#if defined(__linux__)
+	static uint64_t* get_event_count(struct cpuinfo_counter_sample sample[restrict static 1], uint32_t event_index) {
+		switch (event_index) {
+			case 0:
+				return &sample->cycles;
+			case 1:
+				return &sample->instructions;
+			case 2:
+				return &sample->ref_cycles;
+			case 3:
+				return &sample->llc_references;
+			case 4:
+				return &sample->llc_misses;
+			case 5:
+				return &sample->branch_instructions;
+			default:
+				return &sample->branch_misses;
+		}
+	}
+
+	static int open_event(uint64_t config, int linux_id, int group_file) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = config;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return (int) syscall(__NR_perf_event_open, &attr, -1 /* any process */, linux_id, group_file,
+			PERF_FLAG_FD_CLOEXEC);
+	}
+
+	/* Open the events as one group on the processor; events which the PMU doesn't support are skipped */
+	static void open_group(uint32_t events, int linux_id, struct processor_group group[restrict static 1]) {
+		for (uint32_t i = 0; i < COUNTER_SAMPLER_MAX_EVENTS; i++) {
+			const uint32_t event = UINT32_C(1) << i;
+			if ((events & event) == 0) {
+				continue;
+			}
+			const int group_file = group->files_count != 0 ? group->files[0] : -1;
+			const int file = open_event(perf_hardware_events[i], linux_id, group_file);
+			if (file == -1) {
+				cpuinfo_log_debug("failed to open perf_event hardware event %"PRIu64" on processor %d: %s",
+					perf_hardware_events[i], linux_id, strerror(errno));
+				continue;
+			}
+			group->files[group->files_count++] = file;
+			group->events |= event;
+		}
+	}
+#endif
+
+struct cpuinfo_counter_sampler* CPUINFO_ABI cpuinfo_create_counter_sampler(uint32_t events,
+	uint32_t processor_start, uint32_t processor_count)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("counter_sampler");
+	if (events == 0 || (events & ~COUNTER_SAMPLER_SUPPORTED_EVENTS) != 0 || processor_count == 0 ||
+		processor_start > tables->processors_count || processor_count > tables->processors_count - processor_start)
+	{
+		return NULL;
+	}
+	#if defined(__linux__)
+		struct cpuinfo_counter_sampler* sampler = calloc(1, sizeof(struct cpuinfo_counter_sampler));
+		if (sampler == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for counter sampler",
+				sizeof(struct cpuinfo_counter_sampler));
+			return NULL;
+		}
+		sampler->processor_start = processor_start;
+		sampler->processor_count = processor_count;
+		sampler->groups = calloc(processor_count, sizeof(struct processor_group));
+		if (sampler->groups == NULL) {
+			cpuinfo_log_error("failed to allocate counter groups of %"PRIu32" processors", processor_count);
+			cpuinfo_destroy_counter_sampler(sampler);
+			return NULL;
+		}
+
+		uint32_t opened_groups = 0;
+		for (uint32_t i = 0; i < processor_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[processor_start + i];
+			if (processor->usable) {
+				open_group(events, processor->linux_id, &sampler->groups[i]);
+				opened_groups += (uint32_t) (sampler->groups[i].files_count != 0);
+			}
+		}
+		if (opened_groups == 0) {
+			cpuinfo_log_warning("failed to open counters on processors %"PRIu32"-%"PRIu32,
+				processor_start, processor_start + processor_count - 1);
+			cpuinfo_destroy_counter_sampler(sampler);
+			return NULL;
+		}
+		return sampler;
+	#else
+		return NULL;
+	#endif
+}
+
+void CPUINFO_ABI cpuinfo_destroy_counter_sampler(struct cpuinfo_counter_sampler* sampler) {
+	if (sampler == NULL) {
+		return;
+	}
+	#if defined(__linux__)
+		if (sampler->groups != NULL) {
+			for (uint32_t i = 0; i < sampler->processor_count; i++) {
+				/* Members first: closing the leader would promote them to singleton groups */
+				for (uint32_t j = sampler->groups[i].files_count; j != 0; j--) {
+					close(sampler->groups[i].files[j - 1]);
+				}
+			}
+			free(sampler->groups);
+		}
+	#endif
+	free(sampler);
+}
+
+bool CPUINFO_ABI cpuinfo_sample_counters(struct cpuinfo_counter_sampler* sampler,
+	uint32_t processor_start, uint32_t processor_count, struct cpuinfo_counter_sample* sample)
+{
+	if (sampler == NULL || sample == NULL) {
+		return false;
+	}
+	*sample = (struct cpuinfo_counter_sample) { 0 };
+	#if defined(__linux__)
+		/* Intersect the range with the processors of the sampler */
+		const uint64_t range_end = (uint64_t) processor_start + (uint64_t) processor_count;
+		const uint64_t sampler_end = (uint64_t) sampler->processor_start + (uint64_t) sampler->processor_count;
+		const uint32_t start = processor_start > sampler->processor_start ? processor_start : sampler->processor_start;
+		const uint32_t end = (uint32_t) (range_end < sampler_end ? range_end : sampler_end);
+		for (uint32_t i = start; i < end; i++) {
+			const struct processor_group* group = &sampler->groups[i - sampler->processor_start];
+			if (group->files_count == 0) {
+				continue;
+			}
+			struct group_read_format data;
+			const size_t read_size =
+				offsetof(struct group_read_format, values) + group->files_count * sizeof(uint64_t);
+			if (read(group->files[0], &data, read_size) != (ssize_t) read_size ||
+				data.events_count != group->files_count)
+			{
+				continue;
+			}
+
+			uint32_t value_index = 0;
+			for (uint32_t j = 0; j < COUNTER_SAMPLER_MAX_EVENTS; j++) {
+				if ((group->events & (UINT32_C(1) << j)) == 0) {
+					continue;
+				}
+				uint64_t value = data.values[value_index++];
+				if (data.time_running != 0 && data.time_running < data.time_enabled) {
+					/* Counters were multiplexed: extrapolate to the whole time while the group was enabled */
+					value = (uint64_t) ((double) value * (double) data.time_enabled / (double) data.time_running);
+				}
+				*get_event_count(sample, j) += value;
+			}
+			sample->events |= group->events;
+			sample->processors_count += 1;
+			sample->time_enabled_ns += data.time_enabled;
+			sample->time_running_ns += data.time_running;
+		}
+	#endif
+	return sample->processors_count != 0;
+}
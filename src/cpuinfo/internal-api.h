@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -21,6 +22,65 @@ enum cpuinfo_cache_level {
 };
 
 extern CPUINFO_INTERNAL bool cpuinfo_is_initialized;
+extern CPUINFO_INTERNAL bool cpuinfo_isa_is_initialized;
+/* Set by CPUINFO_INIT_PARALLEL_PROBING flag to cpuinfo_initialize_ex */
+extern CPUINFO_INTERNAL bool cpuinfo_parallel_probing;
+/* Set by CPUINFO_INIT_WAIT_IN_GETTERS flag to cpuinfo_initialize_async */
+extern CPUINFO_INTERNAL bool cpuinfo_wait_in_getters;
+/* Set by CPUINFO_INIT_PER_PROCESSOR_CPUID flag to cpuinfo_initialize_ex or cpuinfo_initialize_async */
+extern CPUINFO_INTERNAL bool cpuinfo_per_processor_cpuid;
+/* Set by CPUINFO_INIT_RECLAIM_RETIRED_TABLES flag to cpuinfo_initialize_ex or cpuinfo_initialize_async */
+extern CPUINFO_INTERNAL bool cpuinfo_reclaim_retired_tables;
+/* Set while cpuinfo_initialize_from_capture publishes tables of another system */
+extern CPUINFO_INTERNAL bool cpuinfo_replaying_capture;
+/* Maximum length of the chipset cache directory, including the terminating null character */
+#define CPUINFO_CHIPSET_CACHE_DIRECTORY_MAX 1024
+/* Set by cpuinfo_set_chipset_cache_directory; empty if the decoded chipset is not cached */
+extern CPUINFO_INTERNAL char cpuinfo_chipset_cache_directory[CPUINFO_CHIPSET_CACHE_DIRECTORY_MAX];
+/* Entry of cpuinfo_register_uarch_table; caches have zero size if the entry uses the built-in cache parameters */
+struct cpuinfo_uarch_table_entry {
+	uint32_t midr;
+	uint32_t midr_mask;
+	enum cpuinfo_vendor vendor;
+	enum cpuinfo_uarch uarch;
+	struct cpuinfo_cache l1i;
+	struct cpuinfo_cache l1d;
+	struct cpuinfo_cache l2;
+	struct cpuinfo_cache l3;
+};
+/* Registered entry which matches the MIDR, or NULL if there is none */
+CPUINFO_INTERNAL const struct cpuinfo_uarch_table_entry* cpuinfo_find_uarch_table_entry(uint32_t midr);
+/* Entry of cpuinfo_register_x86_uarch_table, and of the built-in table of x86 microarchitectures */
+struct cpuinfo_x86_uarch_table_entry {
+	enum cpuinfo_vendor vendor;
+	uint32_t family;
+	uint32_t model_min;
+	uint32_t model_max;
+	uint32_t stepping_min;
+	uint32_t stepping_max;
+	enum cpuinfo_uarch uarch;
+};
+/* Registered entry which matches the processor, or NULL if there is none */
+CPUINFO_INTERNAL const struct cpuinfo_x86_uarch_table_entry* cpuinfo_find_x86_uarch_table_entry(
+	enum cpuinfo_vendor vendor,
+	uint32_t family,
+	uint32_t model,
+	uint32_t stepping);
+/* Maximum length of a platform identifier of cpuinfo_register_chipset_table, as of Android system properties */
+#define CPUINFO_CHIPSET_IDENTIFIER_MAX 92
+/* Entry of cpuinfo_register_chipset_table; both strings are null-terminated */
+struct cpuinfo_chipset_table_entry {
+	char identifier[CPUINFO_CHIPSET_IDENTIFIER_MAX];
+	char name[CPUINFO_PACKAGE_NAME_MAX];
+};
+/* Registered entry for the platform identifier, ignoring case, or NULL if there is none */
+CPUINFO_INTERNAL const struct cpuinfo_chipset_table_entry* cpuinfo_find_chipset_table_entry(
+	const char* identifier,
+	size_t length);
+/* Set by cpuinfo_set_allocator; callbacks are NULL for the default allocator */
+extern CPUINFO_INTERNAL struct cpuinfo_allocator cpuinfo_allocator;
+/* Set by cpuinfo_set_file_ops; callbacks are NULL for the system calls */
+extern CPUINFO_INTERNAL struct cpuinfo_file_ops cpuinfo_file_ops;
 
 extern CPUINFO_INTERNAL struct cpuinfo_processor* cpuinfo_processors;
 extern CPUINFO_INTERNAL struct cpuinfo_core* cpuinfo_cores;
@@ -34,33 +94,468 @@ extern CPUINFO_INTERNAL uint32_t cpuinfo_clusters_count;
 extern CPUINFO_INTERNAL uint32_t cpuinfo_packages_count;
 extern CPUINFO_INTERNAL uint32_t cpuinfo_cache_count[cpuinfo_cache_level_max];
 extern CPUINFO_INTERNAL uint32_t cpuinfo_max_cache_size;
+/* GPU and NPU of the SoC, with unknown families if the platform doesn't decode them */
+extern CPUINFO_INTERNAL struct cpuinfo_integrated_gpu cpuinfo_integrated_gpu;
+extern CPUINFO_INTERNAL struct cpuinfo_npu cpuinfo_npu;
 
-#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-	extern CPUINFO_INTERNAL struct cpuinfo_uarch_info* cpuinfo_uarchs;
-	extern CPUINFO_INTERNAL uint32_t cpuinfo_uarchs_count;
-#else
+/* Maximum number of TLBs for pages of different sizes at one level */
+#define CPUINFO_MAX_TLBS_PER_LEVEL 4
+
+/* TLBs of cores of a microarchitecture; unused entries have zero entries */
+struct cpuinfo_uarch_tlbs {
+	struct cpuinfo_tlb l1i[CPUINFO_MAX_TLBS_PER_LEVEL];
+	struct cpuinfo_tlb l1d[CPUINFO_MAX_TLBS_PER_LEVEL];
+	struct cpuinfo_tlb l2[CPUINFO_MAX_TLBS_PER_LEVEL];
+};
+
+/* Parameters of streaming copies and fills tuned for the microarchitecture */
+struct cpuinfo_uarch_streaming_hints {
+	/* Distance in bytes ahead of the current position for software prefetches */
+	uint32_t prefetch_distance;
+	/* Fraction of the last level cache, in sixteenths, above which non-temporal stores are faster */
+	uint32_t llc_sixteenths;
+};
+
+/* Tuning of vectorized kernels for the microarchitecture */
+struct cpuinfo_uarch_vector_hints {
+	/* Widest vectors, in bits, which run at full throughput without reducing core frequency much */
+	uint32_t preferred_width;
+	/* Reduction of core frequency, in percent, while heavy instructions on 512-bit vectors run */
+	uint32_t wide_vector_frequency_penalty;
+};
+
+extern CPUINFO_INTERNAL struct cpuinfo_uarch_info* cpuinfo_uarchs;
+extern CPUINFO_INTERNAL uint32_t cpuinfo_uarchs_count;
+/* TLBs of every microarchitecture in cpuinfo_uarchs, or NULL if unknown */
+extern CPUINFO_INTERNAL const struct cpuinfo_uarch_tlbs* cpuinfo_uarch_tlbs;
+#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+	/* Microarchitecture of all cores on platforms which leave cpuinfo_uarchs NULL */
 	extern CPUINFO_INTERNAL struct cpuinfo_uarch_info cpuinfo_global_uarch;
+	extern CPUINFO_INTERNAL struct cpuinfo_uarch_tlbs cpuinfo_global_uarch_tlbs;
 #endif
 
 #ifdef __linux__
 	extern CPUINFO_INTERNAL uint32_t cpuinfo_linux_cpu_max;
+	/* One of cpuinfo_linux_current_cpu_method values */
+	extern CPUINFO_INTERNAL uint32_t cpuinfo_linux_current_cpu_method;
 	extern CPUINFO_INTERNAL const struct cpuinfo_processor** cpuinfo_linux_cpu_to_processor_map;
 	extern CPUINFO_INTERNAL const struct cpuinfo_core** cpuinfo_linux_cpu_to_core_map;
+	extern CPUINFO_INTERNAL const uint32_t* cpuinfo_linux_cpu_to_uarch_index_map;
 #endif
 
+/* Location of a logical processor padded to a cache line, so that cpuinfo_get_current_location loads only one line */
+#define CPUINFO_LOCATION_RECORD_SIZE 64
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	/* Maximum number of logical processors in a processor group: bits in KAFFINITY */
+	#define CPUINFO_WINDOWS_GROUP_SIZE (sizeof(KAFFINITY) * 8)
+#endif
+
+/* A union rather than a structure with explicit padding, because the location fills the cache line on 64-bit systems */
+union cpuinfo_location_record {
+	struct cpuinfo_location location;
+	char padding[CPUINFO_LOCATION_RECORD_SIZE];
+};
+
+/* A union rather than a structure with explicit padding, as for the location record */
+union cpuinfo_hot_tables_record {
+	struct cpuinfo_hot_tables tables;
+	char padding[64];
+};
+
+/*
+ * Indices of the topology objects of a logical processor in their tables, or UINT32_MAX without the cache, so that
+ * distances between processors take a few comparisons within a cache line
+ */
+struct cpuinfo_processor_domains {
+	uint32_t core;
+	uint32_t l2;
+	uint32_t l3;
+	uint32_t cluster;
+	uint32_t numa_node;
+	uint32_t package;
+};
+
+/*
+ * Tables read by cpuinfo_get_* functions.
+ *
+ * Platform initialization functions fill the global variables above, and the tables are then published as a whole,
+ * so readers on other threads observe either the previous or the new tables, but never a mix of them.
+ * Published tables are never modified.
+ */
+struct cpuinfo_tables {
+	/* Header of inline accessors, in the first cache line of the tables, which the arena aligns on 64 bytes */
+	union cpuinfo_hot_tables_record hot;
+	struct cpuinfo_processor* processors;
+	struct cpuinfo_core* cores;
+	struct cpuinfo_cluster* clusters;
+	struct cpuinfo_package* packages;
+	struct cpuinfo_cache* cache[cpuinfo_cache_level_max];
+	uint32_t processors_count;
+	uint32_t cores_count;
+	uint32_t clusters_count;
+	uint32_t packages_count;
+	uint32_t cache_count[cpuinfo_cache_level_max];
+	uint32_t max_cache_size;
+	struct cpuinfo_integrated_gpu integrated_gpu;
+	struct cpuinfo_npu npu;
+	/* Frequency of the timestamp counter in Hz, or 0 if unknown, and whether the counter has constant rate */
+	uint64_t tsc_frequency;
+	bool tsc_invariant;
+	/* Hypervisor which runs the operating system, and whether the topology it presents may be synthetic */
+	enum cpuinfo_hypervisor hypervisor;
+	bool topology_synthetic;
+	/* Capabilities to allocate and monitor shared caches and memory bandwidth */
+	struct cpuinfo_resource_control resource_control;
+	/* Extended processor state enabled by the OS for XSAVE */
+	struct cpuinfo_x86_xsave_state xsave_state;
+	/* ISA features reported by cpuinfo_has_* functions, and their hash */
+	struct cpuinfo_isa_features isa_features;
+	uint64_t isa_fingerprint;
+	/* Hardware prefetchers enabled on any core with a known state */
+	struct cpuinfo_prefetchers prefetchers;
+	/* Cache maintenance parameters for code written at run time, common to all cores */
+	struct cpuinfo_code_cache_maintenance code_cache_maintenance;
+	/* Points to global_uarch and global_uarch_tlbs on platforms with a single microarchitecture */
+	const struct cpuinfo_uarch_info* uarchs;
+	uint32_t uarchs_count;
+	/* TLBs of every microarchitecture, or NULL if unknown */
+	const struct cpuinfo_uarch_tlbs* uarch_tlbs;
+#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+	struct cpuinfo_uarch_info global_uarch;
+	struct cpuinfo_uarch_tlbs global_uarch_tlbs;
+#endif
+#ifdef __linux__
+	uint32_t linux_cpu_max;
+	uint32_t linux_current_cpu_method;
+	const struct cpuinfo_processor** linux_cpu_to_processor_map;
+	const struct cpuinfo_core** linux_cpu_to_core_map;
+	const uint32_t* linux_cpu_to_uarch_index_map;
+#endif
+	/*
+	 * Locations of logical processors indexed by processor number of the operating system, aligned on
+	 * CPUINFO_LOCATION_RECORD_SIZE. Processor number is Linux processor ID on Linux,
+	 * group * CPUINFO_WINDOWS_GROUP_SIZE + processor number within the group on Windows, and XNU CPU number on Apple.
+	 */
+	union cpuinfo_location_record* current_location_map;
+	uint32_t current_location_count;
+	/* Number of last-level cache domains with usable processors, which have distinct slots in the location map */
+	uint32_t llc_slots_count;
+	/* Last-level cache domains, and domain index for every logical processor, in memory owned by llc_domain_memory */
+	struct cpuinfo_llc_domain* llc_domains;
+	uint32_t llc_domains_count;
+	uint32_t* processor_llc_domain_index;
+	/* Cache clusters, and cache cluster index for every logical processor, also in memory owned by llc_domain_memory */
+	struct cpuinfo_cache_cluster* cache_clusters;
+	uint32_t cache_clusters_count;
+	uint32_t* processor_cache_cluster_index;
+	void* llc_domain_memory;
+	/* Indices of the usable logical processors, and then of the isolated or nohz_full ones, allocated in an arena */
+	uint32_t* usable_processor_indices;
+	uint32_t usable_processors_count;
+	uint32_t* isolated_processor_indices;
+	uint32_t isolated_processors_count;
+	/* SMT control of the OS and whether any core has more than one online hardware thread, at initialization */
+	enum cpuinfo_smt_control smt_control;
+	bool smt_active;
+	/* Indices of the usable logical processors sorted by performance, allocated in an arena */
+	uint32_t* performance_processor_indices;
+	/* Number of usable logical processors, limited by the CPU bandwidth quota of the process */
+	uint32_t effective_parallelism;
+	/* NUMA nodes, their distance matrix and memory-side caches, in memory owned by numa_memory */
+	struct cpuinfo_numa_node* numa_nodes;
+	uint32_t numa_nodes_count;
+	uint32_t* numa_distances;
+	struct cpuinfo_memory_side_cache* memory_side_caches;
+	uint32_t memory_side_caches_count;
+	void* numa_memory;
+	/*
+	 * Pools of huge pages sorted by page size, and huge_page_pools_count pools of every NUMA node, or NULL if nodes
+	 * don't report their pools, in memory owned by huge_page_memory
+	 */
+	struct cpuinfo_huge_page_pool* huge_page_pools;
+	uint32_t huge_page_pools_count;
+	struct cpuinfo_huge_page_pool* numa_huge_page_pools;
+	void* huge_page_memory;
+	struct cpuinfo_transparent_huge_pages transparent_huge_pages;
+	/* Frequency domains, their available frequencies, and uncore domains, in memory owned by frequency_memory */
+	struct cpuinfo_frequency_domain* frequency_domains;
+	uint32_t frequency_domains_count;
+	struct cpuinfo_uncore_domain* uncore_domains;
+	uint32_t uncore_domains_count;
+	void* frequency_memory;
+	/* Affinities of topology objects, indexed as the corresponding tables, in memory owned by affinity_memory */
+	struct cpuinfo_affinity* processor_affinities;
+	struct cpuinfo_affinity* core_affinities;
+	struct cpuinfo_affinity* cluster_affinities;
+	struct cpuinfo_affinity* package_affinities;
+	struct cpuinfo_affinity* cache_affinities[cpuinfo_cache_level_max];
+	struct cpuinfo_affinity* uarch_affinities;
+	/* Number of 64-bit words in processor masks of the affinities */
+	uint32_t processor_mask_words;
+	void* affinity_memory;
+	/*
+	 * Index of the first SMT sibling of every core, indices of logical processors grouped by microarchitecture with
+	 * uarchs_count + 1 offsets of the groups, indices of logical processors of every cluster sorted by capacity,
+	 * topology domains of every logical processor, and steal orders of every logical processor in rows of
+	 * usable_processors_count entries, in memory owned by processor_list_memory
+	 */
+	uint32_t* core_primary_processor_indices;
+	uint32_t* uarch_processor_indices;
+	uint32_t* uarch_processor_offsets;
+	uint32_t* cluster_processor_indices;
+	struct cpuinfo_processor_domains* processor_domains;
+	uint32_t* steal_orders;
+	void* processor_list_memory;
+	/*
+	 * Structure-of-arrays view of logical processors: cpuinfo_processor_column_max columns of processors_count
+	 * entries, allocated in an arena, or NULL if 16-bit indices don't fit some table
+	 */
+	uint16_t* processor_columns;
+	/*
+	 * Measured performance of the memory hierarchy for every microarchitecture, or NULL before the probe, stored with
+	 * release semantics after the tables are published, in memory owned by memory_performance_memory, or in the
+	 * mapping of the snapshot file
+	 */
+	const struct cpuinfo_memory_performance* memory_performance;
+	void* memory_performance_memory;
+	/*
+	 * Measured latencies between cores as a cores_count x cores_count matrix in picoseconds, or NULL before the
+	 * probe, stored and owned like memory_performance
+	 */
+	const uint32_t* core_latencies;
+	void* core_latencies_memory;
+	/*
+	 * Measured instruction performance for every microarchitecture, or NULL before the probe, stored with release
+	 * semantics in memory owned by instruction_performance_memory
+	 */
+	const struct cpuinfo_instruction_performance* instruction_performance;
+	void* instruction_performance_memory;
+	/* Memory owned by these tables: arena with the tables, or mapping of the snapshot file */
+	void* arena_memory;
+	void* snapshot_mapping;
+	size_t snapshot_mapping_size;
+	/*
+	 * Tables replaced by cpuinfo_reinitialize: readers may still use them, so they are kept until deinitialization,
+	 * or with CPUINFO_INIT_RECLAIM_RETIRED_TABLES flag until no acquired snapshot refers to them
+	 */
+	struct cpuinfo_tables* retired;
+	/* Number of tables published before these tables, plus one */
+	uint64_t generation;
+	/* Public view of these tables returned by cpuinfo_snapshot_acquire */
+	struct cpuinfo_topology_snapshot topology_snapshot;
+};
+
+extern CPUINFO_INTERNAL struct cpuinfo_tables* cpuinfo_tables;
+
+/* Load the published tables with acquire semantics, so that contents of the tables are visible after the pointer */
+static inline struct cpuinfo_tables* cpuinfo_load_tables(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (struct cpuinfo_tables*) ReadPointerAcquire((PVOID volatile*) &cpuinfo_tables);
+#else
+	return __atomic_load_n(&cpuinfo_tables, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/* Store the published tables with release semantics, so that contents of the tables are visible before the pointer */
+static inline void cpuinfo_store_tables(struct cpuinfo_tables* tables) {
+	const struct cpuinfo_hot_tables* hot_tables = tables != NULL ? &tables->hot.tables : NULL;
+#if defined(_MSC_VER) && !defined(__clang__)
+	WritePointerRelease((PVOID volatile*) &cpuinfo_tables, tables);
+	WritePointerRelease((PVOID volatile*) &cpuinfo_published_hot_tables, (PVOID) hot_tables);
+#else
+	__atomic_store_n(&cpuinfo_tables, tables, __ATOMIC_RELEASE);
+	__atomic_store_n(&cpuinfo_published_hot_tables, hot_tables, __ATOMIC_RELEASE);
+#endif
+}
+
+/* Innermost level of the topology shared by two logical processors with the domains */
+static inline enum cpuinfo_distance_level cpuinfo_get_domains_distance_level(
+	const struct cpuinfo_processor_domains a[restrict static 1],
+	const struct cpuinfo_processor_domains b[restrict static 1])
+{
+	if (a->package != b->package) {
+		return cpuinfo_distance_level_remote;
+	} else if (a->numa_node != b->numa_node) {
+		return cpuinfo_distance_level_package;
+	} else if (a->core == b->core) {
+		return cpuinfo_distance_level_core;
+	} else if (a->l2 != UINT32_MAX && a->l2 == b->l2) {
+		return cpuinfo_distance_level_l2;
+	} else if (a->l3 != UINT32_MAX && a->l3 == b->l3) {
+		return cpuinfo_distance_level_l3;
+	} else if (a->cluster == b->cluster) {
+		return cpuinfo_distance_level_cluster;
+	} else {
+		return cpuinfo_distance_level_numa_node;
+	}
+}
+
+/* Compute the index of an object in a table, and check that the object is an entry of the table */
+static inline bool cpuinfo_get_table_index(const void* object, const void* table, uint32_t count, size_t entry_size,
+	uint32_t index[restrict static 1])
+{
+	if (object == NULL || table == NULL) {
+		return false;
+	}
+	const uintptr_t offset = (uintptr_t) object - (uintptr_t) table;
+	if (offset >= (uintptr_t) count * entry_size || offset % entry_size != 0) {
+		return false;
+	}
+	*index = (uint32_t) (offset / entry_size);
+	return true;
+}
+
+/* Publish the tables in global variables; must be called with initialization lock held */
+CPUINFO_PRIVATE bool cpuinfo_publish_tables(void);
+/* Release published and retired tables, and reset global variables; must be called with initialization lock held */
+CPUINFO_PRIVATE void cpuinfo_release_tables(void);
+/* Get the published tables, completing deferred initialization if needed; fatal if cpuinfo is not initialized */
+CPUINFO_PRIVATE const struct cpuinfo_tables* cpuinfo_get_tables(const char* getter_name);
+/* Detect NUMA nodes, and set the NUMA node of all logical processors in the tables */
+CPUINFO_PRIVATE bool cpuinfo_build_numa_nodes(struct cpuinfo_tables* tables);
+/* Detect pools of huge pages of the system and of every NUMA node, and transparent huge pages configuration */
+CPUINFO_PRIVATE bool cpuinfo_build_huge_pages(struct cpuinfo_tables* tables);
+/* Detect frequency domains and uncore domains, and set the frequency domain of all logical processors in the tables */
+CPUINFO_PRIVATE bool cpuinfo_build_frequency_domains(struct cpuinfo_tables* tables);
+/*
+ * Detect the logical processors usable by the process, and the isolated and nohz_full logical processors, and set
+ * the corresponding flags of all logical processors
+ */
+CPUINFO_PRIVATE bool cpuinfo_build_usable_processors(struct cpuinfo_tables* tables);
+/*
+ * Detect performance of all cores in the tables, sort the usable logical processors by performance, and set the
+ * default capacity of cores and clusters on platforms which do not report it
+ */
+CPUINFO_PRIVATE bool cpuinfo_build_performance_ranking(struct cpuinfo_tables* tables);
+/* Detect the frequency of the timestamp counter (TSC on x86, system counter on ARM64) */
+CPUINFO_PRIVATE void cpuinfo_detect_tsc(struct cpuinfo_tables* tables);
+/* Detect the hypervisor, and whether the topology in the tables may be synthetic */
+CPUINFO_PRIVATE void cpuinfo_detect_hypervisor(struct cpuinfo_tables* tables);
+/* Detect capabilities to allocate and monitor shared caches and memory bandwidth, and whether resctrl is mounted */
+CPUINFO_PRIVATE void cpuinfo_detect_resource_control(struct cpuinfo_tables* tables);
+/* Detect the XSAVE state components enabled by the OS, and their locations in the XSAVE area */
+CPUINFO_PRIVATE void cpuinfo_detect_xsave_state(struct cpuinfo_tables* tables);
+/* Collect the ISA features detected at initialization into a bitset, and compute its fingerprint */
+CPUINFO_PRIVATE void cpuinfo_detect_isa_features(struct cpuinfo_tables* tables);
+/* Detect the hardware prefetchers enabled on cores in the tables */
+CPUINFO_PRIVATE void cpuinfo_detect_prefetchers(struct cpuinfo_tables* tables);
+/* Detect cache maintenance parameters for code written at run time, from CTR_EL0 or from the L1 caches */
+CPUINFO_PRIVATE void cpuinfo_detect_code_cache_maintenance(struct cpuinfo_tables* tables);
+/* Return the documented default state of hardware prefetchers of the core */
+CPUINFO_PRIVATE struct cpuinfo_prefetchers cpuinfo_decode_default_prefetchers(const struct cpuinfo_core* core);
+/* Precompute affinities of all topology objects in the tables */
+CPUINFO_PRIVATE bool cpuinfo_build_affinities(struct cpuinfo_tables* tables);
+/* Precompute lists of logical processors of cores, microarchitectures, and clusters */
+CPUINFO_PRIVATE bool cpuinfo_build_processor_lists(struct cpuinfo_tables* tables);
+/* Return the first logical processor of the microarchitecture, or NULL if the index is invalid */
+CPUINFO_PRIVATE const struct cpuinfo_processor* cpuinfo_get_uarch_first_processor(const struct cpuinfo_tables* tables,
+	uint32_t uarch_index);
+/* Precompute the structure-of-arrays view of logical processors with 16-bit indices of related objects */
+CPUINFO_PRIVATE bool cpuinfo_build_processor_columns(struct cpuinfo_tables* tables);
+/* Unregister all topology callbacks, and stop the thread which monitors topology changes */
+CPUINFO_PRIVATE void cpuinfo_stop_topology_monitor(void);
+/*
+ * Announce the generation of the tables just stored in cpuinfo_tables to readers which acquire snapshots.
+ * Must be called with initialization lock held, after cpuinfo_store_tables.
+ */
+CPUINFO_PRIVATE void cpuinfo_publish_epoch(uint64_t generation);
+/*
+ * Return the oldest generation of tables which may be used by an acquired snapshot: tables of older generations can
+ * be released. Returns 0 if all tables may be in use, and UINT64_MAX if no snapshots are acquired.
+ */
+CPUINFO_PRIVATE uint64_t cpuinfo_get_min_pinned_generation(void);
+CPUINFO_PRIVATE void cpuinfo_lock_initialization(void);
+CPUINFO_PRIVATE void cpuinfo_unlock_initialization(void);
+
+/* Mapping of the snapshot file with the tables, owned by the next published tables */
+/* Memory performance restored from the snapshot file, with an entry for every microarchitecture, or NULL */
+extern CPUINFO_INTERNAL const struct cpuinfo_memory_performance* cpuinfo_memory_performance;
+/* Latencies between cores restored from the snapshot file, with cores_count x cores_count entries, or NULL */
+extern CPUINFO_INTERNAL const uint32_t* cpuinfo_core_latencies;
+extern CPUINFO_INTERNAL void* cpuinfo_snapshot_mapping;
+extern CPUINFO_INTERNAL size_t cpuinfo_snapshot_mapping_size;
+CPUINFO_PRIVATE void cpuinfo_unmap_snapshot(void* mapping, size_t size);
+
+/* Statistics of the current initialization, reset by cpuinfo_start_init_stats */
+extern CPUINFO_INTERNAL struct cpuinfo_init_stats cpuinfo_init_stats;
+extern CPUINFO_INTERNAL bool cpuinfo_init_stats_valid;
+
+/* Monotonic timestamp in nanoseconds */
+CPUINFO_PRIVATE uint64_t cpuinfo_get_timestamp_ns(void);
+/* Start and finish statistics of an initialization; must be called with initialization lock held */
+CPUINFO_PRIVATE void cpuinfo_start_init_stats(void);
+CPUINFO_PRIVATE void cpuinfo_finish_init_stats(void);
+/* Account the time since *phase_start to the phase, and reset *phase_start to the current time */
+CPUINFO_PRIVATE void cpuinfo_record_init_phase(enum cpuinfo_init_phase phase, uint64_t phase_start[restrict static 1]);
+
+CPUINFO_PRIVATE void cpuinfo_x86_init_isa(void);
 CPUINFO_PRIVATE void cpuinfo_x86_mach_init(void);
 CPUINFO_PRIVATE void cpuinfo_x86_linux_init(void);
+CPUINFO_PRIVATE void cpuinfo_x86_freebsd_init(void);
 #if defined(_WIN32) || defined(__CYGWIN__)
 	#if CPUINFO_ARCH_ARM64
 		CPUINFO_PRIVATE BOOL CALLBACK cpuinfo_arm_windows_init(PINIT_ONCE init_once, PVOID parameter, PVOID* context);
 	#else
 		CPUINFO_PRIVATE BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PVOID* context);
 	#endif
+	/* Set windows_cpu_set_id of logical processors from GetSystemCpuSetInformation, if the OS supports CPU sets */
+	CPUINFO_INTERNAL void cpuinfo_windows_detect_cpu_sets(struct cpuinfo_processor* processors,
+		uint32_t processors_count);
 #endif
 CPUINFO_PRIVATE void cpuinfo_arm_mach_init(void);
 CPUINFO_PRIVATE void cpuinfo_arm_linux_init(void);
+CPUINFO_PRIVATE void cpuinfo_riscv_linux_init(void);
+CPUINFO_PRIVATE void cpuinfo_loongarch_linux_init(void);
 CPUINFO_PRIVATE void cpuinfo_emscripten_init(void);
 
+CPUINFO_PRIVATE bool cpuinfo_initialize_deferred(void);
+
 CPUINFO_PRIVATE uint32_t cpuinfo_compute_max_cache_size(const struct cpuinfo_processor* processor);
+/* Return the cache of the highest level for the processor, or NULL if caches are unknown */
+CPUINFO_PRIVATE const struct cpuinfo_cache* cpuinfo_get_last_level_cache(const struct cpuinfo_processor* processor);
+/* Return the index of the microarchitecture of the logical processor in the uarchs table */
+CPUINFO_PRIVATE uint32_t cpuinfo_get_processor_uarch_index(const struct cpuinfo_tables* tables,
+	const struct cpuinfo_processor* processor);
+
+/*
+ * Single allocation for all tables produced by initialization.
+ * Space for every table is reserved in a counting pass, then the arena is allocated at once.
+ */
+struct cpuinfo_arena {
+	void* memory;
+	size_t size;
+};
+
+/* Reserve space for count entries of entry_size bytes, and return its offset in the arena */
+CPUINFO_PRIVATE size_t cpuinfo_arena_reserve(struct cpuinfo_arena arena[restrict static 1], size_t count, size_t entry_size);
+/* Allocate zero-initialized cache-line-aligned memory for all reserved space */
+CPUINFO_PRIVATE bool cpuinfo_arena_allocate(struct cpuinfo_arena arena[restrict static 1]);
+/* Return pointer to an allocated table, or NULL for an empty table */
+CPUINFO_PRIVATE void* cpuinfo_arena_get(const struct cpuinfo_arena arena[restrict static 1], size_t offset, size_t count);
+CPUINFO_PRIVATE void cpuinfo_arena_free(void* memory);
+
+/*
+ * Caller-provided memory for all allocations of initialization, as in cpuinfo_initialize_into. While a buffer is
+ * attached, arenas and temporary arrays are carved from it, and freeing them is a no-op. In measuring mode, memory
+ * comes from the heap, and detaching the buffer returns the size which initialization would need.
+ */
+CPUINFO_PRIVATE void cpuinfo_arena_attach_buffer(void* memory, size_t size);
+CPUINFO_PRIVATE void cpuinfo_arena_measure_buffer(void);
+/* Return the size of tables in the buffer, or the measured size of the buffer */
+CPUINFO_PRIVATE size_t cpuinfo_arena_detach_buffer(void);
+/* Release temporary arrays in the buffer at the end of initialization */
+CPUINFO_PRIVATE void cpuinfo_arena_release_temporary(void);
+/* Allocate a zero-initialized temporary array of initialization, from the buffer if it is attached */
+CPUINFO_PRIVATE void* cpuinfo_allocate_temporary(size_t count, size_t entry_size);
+CPUINFO_PRIVATE void cpuinfo_free_temporary(void* memory);
+/* Total size of temporary arrays allocated by the last completed initialization */
+CPUINFO_PRIVATE size_t cpuinfo_arena_get_transient_size(void);
+/* Allocate zero-initialized memory through the allocator of cpuinfo_set_allocator, or calloc by default */
+CPUINFO_PRIVATE void* cpuinfo_allocate(size_t count, size_t entry_size);
+CPUINFO_PRIVATE void cpuinfo_deallocate(void* memory);
+
+/* Arena with the tables of the current initialization, or NULL if tables are not allocated with an arena */
+extern CPUINFO_INTERNAL void* cpuinfo_arena_memory;
 
 typedef void (*cpuinfo_processor_callback)(uint32_t);
@@ -4,6 +4,8 @@
 #include <stdarg.h>
 #include <stdlib.h>
 
+#include <cpuinfo/common.h>
+
 #ifndef CPUINFO_LOG_LEVEL
 	#error "Undefined CPUINFO_LOG_LEVEL"
 #endif
@@ -24,6 +26,12 @@
 extern "C" {
 #endif
 
+/*
+ * Runtime log level, set by cpuinfo_set_log_level. Messages above it are dropped before formatting. CPUINFO_LOG_LEVEL
+ * remains the upper bound, since messages above it are not compiled in.
+ */
+extern CPUINFO_INTERNAL int cpuinfo_log_level_threshold;
+
 #if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_DEBUG
 	void cpuinfo_vlog_debug(const char* format, va_list args);
 #endif
@@ -58,46 +66,56 @@ extern "C" {
 
 CPUINFO_LOG_ARGUMENTS_FORMAT inline static void cpuinfo_log_debug(const char* format, ...) {
 	#if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_DEBUG
-		va_list args;
-		va_start(args, format);
-		cpuinfo_vlog_debug(format, args);
-		va_end(args);
+		if (cpuinfo_log_level_threshold >= CPUINFO_LOG_DEBUG) {
+			va_list args;
+			va_start(args, format);
+			cpuinfo_vlog_debug(format, args);
+			va_end(args);
+		}
 	#endif
 }
 
 CPUINFO_LOG_ARGUMENTS_FORMAT inline static void cpuinfo_log_info(const char* format, ...) {
 	#if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_INFO
-		va_list args;
-		va_start(args, format);
-		cpuinfo_vlog_info(format, args);
-		va_end(args);
+		if (cpuinfo_log_level_threshold >= CPUINFO_LOG_INFO) {
+			va_list args;
+			va_start(args, format);
+			cpuinfo_vlog_info(format, args);
+			va_end(args);
+		}
 	#endif
 }
 
 CPUINFO_LOG_ARGUMENTS_FORMAT inline static void cpuinfo_log_warning(const char* format, ...) {
 	#if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_WARNING
-		va_list args;
-		va_start(args, format);
-		cpuinfo_vlog_warning(format, args);
-		va_end(args);
+		if (cpuinfo_log_level_threshold >= CPUINFO_LOG_WARNING) {
+			va_list args;
+			va_start(args, format);
+			cpuinfo_vlog_warning(format, args);
+			va_end(args);
+		}
 	#endif
 }
 
 CPUINFO_LOG_ARGUMENTS_FORMAT inline static void cpuinfo_log_error(const char* format, ...) {
 	#if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_ERROR
-		va_list args;
-		va_start(args, format);
-		cpuinfo_vlog_error(format, args);
-		va_end(args);
+		if (cpuinfo_log_level_threshold >= CPUINFO_LOG_ERROR) {
+			va_list args;
+			va_start(args, format);
+			cpuinfo_vlog_error(format, args);
+			va_end(args);
+		}
 	#endif
 }
 
 CPUINFO_LOG_ARGUMENTS_FORMAT inline static void cpuinfo_log_fatal(const char* format, ...) {
 	#if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_FATAL
-		va_list args;
-		va_start(args, format);
-		cpuinfo_vlog_fatal(format, args);
-		va_end(args);
+		if (cpuinfo_log_level_threshold >= CPUINFO_LOG_FATAL) {
+			va_list args;
+			va_start(args, format);
+			cpuinfo_vlog_fatal(format, args);
+			va_end(args);
+		}
 	#endif
 	abort();
 }
\ No newline at end of file
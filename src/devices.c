@@ -0,0 +1,164 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if defined(__linux__)
+	#include <limits.h>
+	#include <stdio.h>
+	#include <string.h>
+
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define NUMA_NODE_FILESIZE 32
+
+	/* Directories of devices which are looked up by name, e.g. eth0, nvme0n1, mlx5_0, card0 or 0000:3b:00.0 */
+	static const char* const device_dirnames[] = {
+		"/sys/class/net",
+		"/sys/block",
+		"/sys/class/nvme",
+		"/sys/class/infiniband",
+		"/sys/class/drm",
+		"/sys/bus/pci/devices",
+	};
+
+	struct device_locality_context {
+		const struct cpuinfo_tables* tables;
+		struct cpuinfo_device_locality* locality;
+		/* Bit i is set if logical processor i of the tables is local to the device */
+		uint64_t* processor_mask;
+	};
+
+	static bool mark_local_processors(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+		const struct device_locality_context* locality_context = (const struct device_locality_context*) context;
+		const struct cpuinfo_tables* tables = locality_context->tables;
+		if (cpu_end > tables->linux_cpu_max) {
+			cpu_end = tables->linux_cpu_max;
+		}
+		for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+			const struct cpuinfo_processor* processor = tables->linux_cpu_to_processor_map[cpu];
+			if (processor != NULL) {
+				const uint32_t index = (uint32_t) (processor - tables->processors);
+				locality_context->processor_mask[index / 64] |= UINT64_C(1) << (index % 64);
+			}
+		}
+		return true;
+	}
+
+	/* numa_node holds -1 for devices which are not attached to a NUMA node */
+	static bool numa_node_parser(const char* text_start, const char* text_end, void* context) {
+		uint32_t node_id = 0;
+		const char* digit = text_start;
+		for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+			node_id = node_id * 10 + (uint32_t) (*digit - '0');
+		}
+		if (digit == text_start) {
+			return false;
+		}
+		*((uint32_t*) context) = node_id;
+		return true;
+	}
+
+	/*
+	 * Resolve the sysfs directory of a device, and walk up its parents to the nearest one with the locality
+	 * attributes: class and block devices, e.g. /sys/class/net/eth0 or /sys/block/nvme0n1, are children of their
+	 * PCI device in /sys/devices.
+	 */
+	static bool read_device_locality(const char* path, struct device_locality_context* context) {
+		char directory[PATH_MAX];
+		char filename[PATH_MAX + 16];
+		if (realpath(path, directory) == NULL) {
+			return false;
+		}
+		while (strcmp(directory, "/sys/devices") != 0) {
+			snprintf(filename, sizeof(filename), "%s/local_cpulist", directory);
+			if (cpuinfo_linux_parse_cpulist(filename, mark_local_processors, context)) {
+				uint32_t node_id = UINT32_MAX;
+				snprintf(filename, sizeof(filename), "%s/numa_node", directory);
+				cpuinfo_linux_parse_small_file(filename, NUMA_NODE_FILESIZE, numa_node_parser, &node_id);
+				const struct cpuinfo_tables* tables = context->tables;
+				for (uint32_t i = 0; i < tables->numa_nodes_count; i++) {
+					if (tables->numa_nodes[i].node_id == node_id) {
+						context->locality->numa_node = &tables->numa_nodes[i];
+					}
+				}
+				cpuinfo_log_debug("read locality of device %s from %s", path, directory);
+				return true;
+			}
+			char* separator = strrchr(directory, '/');
+			if (separator == NULL || separator == directory) {
+				break;
+			}
+			*separator = '\0';
+		}
+		return false;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_get_device_local_processors(const char* device, struct cpuinfo_device_locality* locality,
+	uint32_t max_count, uint32_t* processor_indices)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("device_local_processors");
+	if (locality == NULL) {
+		return false;
+	}
+	*locality = (struct cpuinfo_device_locality) { 0 };
+	if (device == NULL || *device == '\0' || (max_count != 0 && processor_indices == NULL)) {
+		return false;
+	}
+#if defined(__linux__)
+	if (tables->linux_cpu_to_processor_map == NULL || tables->processors_count == 0) {
+		return false;
+	}
+	const uint32_t mask_words = (tables->processors_count + 63) / 64;
+	struct device_locality_context context = {
+		.tables = tables,
+		.locality = locality,
+		.processor_mask = calloc(mask_words, sizeof(uint64_t)),
+	};
+	if (context.processor_mask == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for locality of device %s",
+			mask_words * sizeof(uint64_t), device);
+		return false;
+	}
+
+	bool found = false;
+	if (strchr(device, '/') != NULL) {
+		found = read_device_locality(device, &context);
+	} else {
+		char path[PATH_MAX];
+		for (size_t i = 0; !found && i < sizeof(device_dirnames) / sizeof(device_dirnames[0]); i++) {
+			if (snprintf(path, sizeof(path), "%s/%s", device_dirnames[i], device) < (int) sizeof(path)) {
+				found = read_device_locality(path, &context);
+			}
+		}
+	}
+	if (!found) {
+		cpuinfo_log_debug("no locality information for device %s", device);
+		free(context.processor_mask);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < tables->processors_count; i++) {
+		if (context.processor_mask[i / 64] & (UINT64_C(1) << (i % 64))) {
+			if (locality->processors_count < max_count) {
+				processor_indices[locality->processors_count] = i;
+			}
+			locality->processors_count += 1;
+			locality->usable_processors_count += (uint32_t) tables->processors[i].usable;
+		}
+	}
+	free(context.processor_mask);
+	return true;
+#else
+	(void) tables;
+	return false;
+#endif
+}
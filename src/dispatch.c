@@ -0,0 +1,278 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+bool CPUINFO_ABI cpuinfo_dispatch_table_add(
+	struct cpuinfo_dispatch_table* table,
+	cpuinfo_dispatch_function function,
+	const struct cpuinfo_isa_features* required,
+	enum cpuinfo_uarch preferred_uarch)
+{
+	if CPUINFO_UNLIKELY(table == NULL || function == NULL) {
+		return false;
+	}
+	if (table->candidates_count >= CPUINFO_DISPATCH_MAX_CANDIDATES) {
+		cpuinfo_log_warning("failed to add implementation to dispatch table: %d implementations already registered",
+			CPUINFO_DISPATCH_MAX_CANDIDATES);
+		return false;
+	}
+
+	table->candidates[table->candidates_count++] = (struct cpuinfo_dispatch_candidate) {
+		.function = function,
+		.required = required != NULL ? *required : (struct cpuinfo_isa_features) { { 0 } },
+		.preferred_uarch = preferred_uarch,
+	};
+	return true;
+}
+
+/*
+ * Pick the first supported candidate which is tuned for the microarchitecture, or else the first supported one
+ * without a preferred microarchitecture. Candidates tuned for other microarchitectures are never picked.
+ */
+static cpuinfo_dispatch_function select_candidate(const struct cpuinfo_dispatch_table* table,
+	const struct cpuinfo_isa_features* features, enum cpuinfo_uarch uarch)
+{
+	cpuinfo_dispatch_function generic_function = NULL;
+	for (uint32_t i = 0; i < table->candidates_count; i++) {
+		const struct cpuinfo_dispatch_candidate* candidate = &table->candidates[i];
+		if (!cpuinfo_isa_features_include(features, &candidate->required)) {
+			continue;
+		}
+		if (candidate->preferred_uarch == cpuinfo_uarch_unknown) {
+			if (generic_function == NULL) {
+				generic_function = candidate->function;
+			}
+		} else if (candidate->preferred_uarch == uarch && uarch != cpuinfo_uarch_unknown) {
+			return candidate->function;
+		}
+	}
+	return generic_function;
+}
+
+bool CPUINFO_ABI cpuinfo_dispatch_table_resolve(struct cpuinfo_dispatch_table* table) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("dispatch_table_resolve");
+	if CPUINFO_UNLIKELY(table == NULL) {
+		return false;
+	}
+
+	const uint32_t uarchs_count = tables->uarchs_count;
+	for (uint32_t i = 0; i < CPUINFO_DISPATCH_MAX_UARCHS; i++) {
+		table->uarch_functions[i] = NULL;
+		if (i >= uarchs_count) {
+			continue;
+		}
+		struct cpuinfo_isa_features uarch_features;
+		const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, i);
+		if (processor == NULL || !cpuinfo_get_uarch_isa_features(i, &uarch_features)) {
+			continue;
+		}
+		table->uarch_functions[i] = select_candidate(table, &uarch_features, processor->core->uarch);
+	}
+
+	/* Threads which may migrate between cores get tuning for the microarchitecture only if all cores share it */
+	enum cpuinfo_uarch common_uarch = cpuinfo_uarch_unknown;
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, 0);
+	if (uarchs_count == 1 && processor != NULL) {
+		common_uarch = processor->core->uarch;
+	}
+	table->function = select_candidate(table, &tables->isa_features, common_uarch);
+	if (table->function == NULL) {
+		cpuinfo_log_debug("none of %"PRIu32" implementations in dispatch table is supported on all cores",
+			table->candidates_count);
+		return false;
+	}
+	return true;
+}
+
+/* Key and value of a race winner in the tuning cache */
+#define RACE_KEY_FORMAT "cpuinfo.race/%s/%"PRIu32
+
+struct race_record {
+	uint32_t candidates_count;
+	uint32_t winner;
+};
+
+static bool format_race_key(char key[restrict static CPUINFO_TUNING_KEY_MAX], const char* name, uint32_t uarch_index) {
+	const int length = snprintf(key, CPUINFO_TUNING_KEY_MAX, RACE_KEY_FORMAT, name, uarch_index);
+	return length > 0 && length < CPUINFO_TUNING_KEY_MAX;
+}
+
+/* Usable logical processor of the first cluster of the microarchitecture, e.g. a big core of a big.LITTLE SoC */
+static const struct cpuinfo_processor* get_representative_processor(const struct cpuinfo_tables* tables,
+	uint32_t uarch_index)
+{
+	for (uint32_t i = 0; i < tables->clusters_count; i++) {
+		const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+		const struct cpuinfo_processor* first_processor = &tables->processors[cluster->processor_start];
+		if (cluster->processor_count == 0 ||
+			cpuinfo_get_processor_uarch_index(tables, first_processor) != uarch_index)
+		{
+			continue;
+		}
+		for (uint32_t j = 0; j < cluster->processor_count; j++) {
+			if (first_processor[j].usable) {
+				return &first_processor[j];
+			}
+		}
+	}
+	return NULL;
+}
+
+static int compare_u64(const void* a, const void* b) {
+	const uint64_t value_a = *((const uint64_t*) a);
+	const uint64_t value_b = *((const uint64_t*) b);
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+/* Benchmark supported candidates on the current thread, and return the index of the fastest one, or UINT32_MAX */
+static uint32_t race_candidates(const struct cpuinfo_dispatch_table* table,
+	const struct cpuinfo_isa_features* features, enum cpuinfo_uarch uarch,
+	cpuinfo_dispatch_race_function run, void* context, uint32_t iterations,
+	struct cpuinfo_dispatch_race_result result[restrict static 1])
+{
+	uint64_t samples[CPUINFO_DISPATCH_RACE_MAX_ITERATIONS];
+	uint32_t winner = UINT32_MAX;
+	for (uint32_t i = 0; i < table->candidates_count; i++) {
+		const struct cpuinfo_dispatch_candidate* candidate = &table->candidates[i];
+		if (!cpuinfo_isa_features_include(features, &candidate->required) ||
+			(candidate->preferred_uarch != cpuinfo_uarch_unknown && candidate->preferred_uarch != uarch))
+		{
+			continue;
+		}
+
+		run(candidate->function, context);
+		for (uint32_t j = 0; j < iterations; j++) {
+			const uint64_t start = cpuinfo_get_timestamp_ns();
+			run(candidate->function, context);
+			samples[j] = cpuinfo_get_timestamp_ns() - start;
+		}
+		qsort(samples, iterations, sizeof(uint64_t), compare_u64);
+		/* Zero is reserved for candidates which were not benchmarked */
+		result->median_ns[i] = samples[iterations / 2] | (samples[iterations / 2] == 0);
+		result->tail_ns[i] = samples[iterations * 9 / 10] | (samples[iterations * 9 / 10] == 0);
+		if (winner == UINT32_MAX || result->median_ns[i] < result->median_ns[winner]) {
+			winner = i;
+		}
+	}
+	return winner;
+}
+
+bool CPUINFO_ABI cpuinfo_dispatch_table_race(
+	struct cpuinfo_dispatch_table* table,
+	const char* name,
+	cpuinfo_dispatch_race_function run,
+	void* context,
+	uint32_t iterations,
+	struct cpuinfo_dispatch_race_result* results)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("dispatch_table_race");
+	if CPUINFO_UNLIKELY(table == NULL || run == NULL || iterations == 0) {
+		return false;
+	}
+	if (iterations > CPUINFO_DISPATCH_RACE_MAX_ITERATIONS) {
+		iterations = CPUINFO_DISPATCH_RACE_MAX_ITERATIONS;
+	}
+	if (!cpuinfo_dispatch_table_resolve(table)) {
+		return false;
+	}
+
+	struct cpuinfo_thread_affinity_state affinity;
+	const bool saved_affinity = cpuinfo_save_current_thread_affinity(&affinity);
+	bool status = true;
+	const uint32_t uarchs_count = tables->uarchs_count;
+	for (uint32_t i = 0; i < CPUINFO_DISPATCH_MAX_UARCHS; i++) {
+		struct cpuinfo_dispatch_race_result result = {
+			.winner = UINT32_MAX,
+			.processor_index = UINT32_MAX,
+		};
+		if (i < uarchs_count) {
+			struct cpuinfo_isa_features features;
+			const struct cpuinfo_processor* processor = get_representative_processor(tables, i);
+			if (processor == NULL || !cpuinfo_get_uarch_isa_features(i, &features)) {
+				cpuinfo_log_warning("no usable processor to benchmark microarchitecture %"PRIu32, i);
+				status = false;
+			} else if (!cpuinfo_pin_current_thread_to_processor(processor) && uarchs_count > 1) {
+				/* Without pinning, the benchmark could run on cores of any microarchitecture */
+				cpuinfo_log_warning("failed to pin thread to processor %"PRIu32" to benchmark microarchitecture %"PRIu32,
+					(uint32_t) (processor - tables->processors), i);
+				status = false;
+			} else {
+				result.processor_index = (uint32_t) (processor - tables->processors);
+				result.winner = race_candidates(table, &features, processor->core->uarch, run, context,
+					iterations, &result);
+			}
+		}
+		if (result.winner != UINT32_MAX) {
+			table->uarch_functions[i] = table->candidates[result.winner].function;
+			cpuinfo_log_debug("implementation %"PRIu32" won the race on microarchitecture %"PRIu32" in %"PRIu64" ns",
+				result.winner, i, result.median_ns[result.winner]);
+			char key[CPUINFO_TUNING_KEY_MAX];
+			const struct race_record record = {
+				.candidates_count = table->candidates_count,
+				.winner = result.winner,
+			};
+			if (name != NULL && (!format_race_key(key, name, i) || !cpuinfo_tuning_put(key, &record, sizeof(record)))) {
+				cpuinfo_log_debug("failed to record the winner of the race of %s", name);
+			}
+		}
+		if (results != NULL) {
+			results[i] = result;
+		}
+	}
+	if (saved_affinity) {
+		cpuinfo_restore_current_thread_affinity(&affinity);
+	}
+
+	/* Threads which may migrate take the winner only if there is one microarchitecture and all cores support it */
+	if (uarchs_count == 1 && table->uarch_functions[0] != NULL) {
+		for (uint32_t i = 0; i < table->candidates_count; i++) {
+			if (table->candidates[i].function == table->uarch_functions[0] &&
+				cpuinfo_isa_features_include(&tables->isa_features, &table->candidates[i].required))
+			{
+				table->function = table->uarch_functions[0];
+				break;
+			}
+		}
+	}
+	return status;
+}
+
+bool CPUINFO_ABI cpuinfo_dispatch_table_load_race(struct cpuinfo_dispatch_table* table, const char* name) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("dispatch_table_load_race");
+	if CPUINFO_UNLIKELY(name == NULL || !cpuinfo_dispatch_table_resolve(table)) {
+		return false;
+	}
+
+	bool status = true;
+	const uint32_t uarchs_count = tables->uarchs_count < CPUINFO_DISPATCH_MAX_UARCHS ?
+		tables->uarchs_count : CPUINFO_DISPATCH_MAX_UARCHS;
+	for (uint32_t i = 0; i < uarchs_count; i++) {
+		char key[CPUINFO_TUNING_KEY_MAX];
+		struct race_record record;
+		size_t size = sizeof(record);
+		struct cpuinfo_isa_features features;
+		if (!format_race_key(key, name, i) || !cpuinfo_tuning_get(key, &record, &size) || size != sizeof(record) ||
+			record.candidates_count != table->candidates_count || record.winner >= table->candidates_count ||
+			!cpuinfo_get_uarch_isa_features(i, &features) ||
+			!cpuinfo_isa_features_include(&features, &table->candidates[record.winner].required))
+		{
+			status = false;
+			continue;
+		}
+		table->uarch_functions[i] = table->candidates[record.winner].function;
+		if (uarchs_count == 1 && cpuinfo_isa_features_include(&tables->isa_features,
+			&table->candidates[record.winner].required))
+		{
+			table->function = table->uarch_functions[0];
+		}
+	}
+	return status;
+}
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <math.h>
 
+#include <emscripten.h>
 #include <emscripten/threading.h>
 
 #include <cpuinfo.h>
@@ -11,8 +12,67 @@
 #include <cpuinfo/log.h>
 
 
+#define CPUINFO_WASM_FEATURE_SIMD128      0x00000001
+#define CPUINFO_WASM_FEATURE_RELAXED_SIMD 0x00000002
+#define CPUINFO_WASM_FEATURE_THREADS      0x00000004
+#define CPUINFO_WASM_FEATURE_MEMORY64     0x00000008
+
+struct cpuinfo_wasm_isa cpuinfo_isa = { 0 };
+
 static const volatile float infinity = INFINITY;
 
+/*
+ * Validate minimal modules which use a feature to check if the engine supports it: validation neither compiles nor
+ * instantiates the module, so it is cheap. Threads also need SharedArrayBuffer, which browsers hide unless the page is
+ * cross-origin isolated.
+ */
+EM_JS(int, cpuinfo_emscripten_probe_wasm_features, (void), {
+	if (typeof WebAssembly !== "object" || typeof WebAssembly.validate !== "function") {
+		return 0;
+	}
+	function validate(bytes) {
+		try {
+			return WebAssembly.validate(new Uint8Array(bytes));
+		} catch (e) {
+			return false;
+		}
+	}
+	var header = [0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00];
+	/* Function () -> v128 with i32.const 0; i8x16.splat */
+	var simd128 = header.concat([
+		0x01, 0x05, 0x01, 0x60, 0x00, 0x01, 0x7B,
+		0x03, 0x02, 0x01, 0x00,
+		0x0A, 0x0A, 0x01, 0x08, 0x00, 0x41, 0x00, 0xFD, 0x0F, 0x0B]);
+	/* Function () -> v128 with two i8x16.splat and i8x16.relaxed_swizzle */
+	var relaxedSimd = header.concat([
+		0x01, 0x05, 0x01, 0x60, 0x00, 0x01, 0x7B,
+		0x03, 0x02, 0x01, 0x00,
+		0x0A, 0x0F, 0x01, 0x0D, 0x00, 0x41, 0x00, 0xFD, 0x0F, 0x41, 0x00, 0xFD, 0x0F, 0xFD, 0x80, 0x02, 0x0B]);
+	/* Shared memory of 1 page and a function () -> () with i32.atomic.load */
+	var threads = header.concat([
+		0x01, 0x04, 0x01, 0x60, 0x00, 0x00,
+		0x03, 0x02, 0x01, 0x00,
+		0x05, 0x04, 0x01, 0x03, 0x01, 0x01,
+		0x0A, 0x0B, 0x01, 0x09, 0x00, 0x41, 0x00, 0xFE, 0x10, 0x02, 0x00, 0x1A, 0x0B]);
+	/* Memory of 1 page with 64-bit addresses */
+	var memory64 = header.concat([0x05, 0x03, 0x01, 0x04, 0x01]);
+
+	var features = 0;
+	if (validate(simd128)) {
+		features |= 0x00000001;
+		if (validate(relaxedSimd)) {
+			features |= 0x00000002;
+		}
+	}
+	if (typeof SharedArrayBuffer !== "undefined" && validate(threads)) {
+		features |= 0x00000004;
+	}
+	if (validate(memory64)) {
+		features |= 0x00000008;
+	}
+	return features;
+});
+
 static struct cpuinfo_package static_package = { };
 
 static struct cpuinfo_cache static_x86_l3 = {
@@ -30,9 +90,19 @@ void cpuinfo_emscripten_init(void) {
 	struct cpuinfo_cache* l1i = NULL;
 	struct cpuinfo_cache* l1d = NULL;
 	struct cpuinfo_cache* l2 = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
 
 	const bool is_x86 = signbit(infinity - infinity);
 
+	const int wasm_features = cpuinfo_emscripten_probe_wasm_features();
+	cpuinfo_isa = (struct cpuinfo_wasm_isa) {
+		.simd128 = !!(wasm_features & CPUINFO_WASM_FEATURE_SIMD128),
+		.relaxed_simd = !!(wasm_features & CPUINFO_WASM_FEATURE_RELAXED_SIMD),
+		.threads = !!(wasm_features & CPUINFO_WASM_FEATURE_THREADS),
+		.memory64 = !!(wasm_features & CPUINFO_WASM_FEATURE_MEMORY64),
+	};
+	cpuinfo_log_debug("WebAssembly features 0x%08x", wasm_features);
+
 	int logical_cores_count = emscripten_num_logical_cores();
 	if (logical_cores_count <= 0) {
 		logical_cores_count = 1;
@@ -58,45 +128,21 @@ void cpuinfo_emscripten_init(void) {
 	}
 	uint32_t l2_count = is_x86 ? core_count : cluster_count;
 
-	processors = calloc(processor_count, sizeof(struct cpuinfo_processor));
-	if (processors == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
-			processor_count * sizeof(struct cpuinfo_processor), processor_count);
-		goto cleanup;
-	}
-	cores = calloc(processor_count, sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			processor_count * sizeof(struct cpuinfo_core), processor_count);
-		goto cleanup;
-	}
-	clusters = calloc(cluster_count, sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" clusters",
-			cluster_count * sizeof(struct cpuinfo_cluster), cluster_count);
-		goto cleanup;
-	}
-
-	l1i = calloc(core_count, sizeof(struct cpuinfo_cache));
-	if (l1i == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1I caches",
-			core_count * sizeof(struct cpuinfo_cache), core_count);
-		goto cleanup;
-	}
-
-	l1d = calloc(core_count, sizeof(struct cpuinfo_cache));
-	if (l1d == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1D caches",
-			core_count * sizeof(struct cpuinfo_cache), core_count);
-		goto cleanup;
-	}
-
-	l2 = calloc(l2_count, sizeof(struct cpuinfo_cache));
-	if (l2 == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L2 caches",
-			l2_count * sizeof(struct cpuinfo_cache), l2_count);
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, processor_count, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, processor_count, sizeof(struct cpuinfo_core));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, cluster_count, sizeof(struct cpuinfo_cluster));
+	const size_t l1i_offset = cpuinfo_arena_reserve(&arena, core_count, sizeof(struct cpuinfo_cache));
+	const size_t l1d_offset = cpuinfo_arena_reserve(&arena, core_count, sizeof(struct cpuinfo_cache));
+	const size_t l2_offset = cpuinfo_arena_reserve(&arena, l2_count, sizeof(struct cpuinfo_cache));
+	if (!cpuinfo_arena_allocate(&arena)) {
 		goto cleanup;
 	}
+	processors = cpuinfo_arena_get(&arena, processors_offset, processor_count);
+	cores = cpuinfo_arena_get(&arena, cores_offset, processor_count);
+	clusters = cpuinfo_arena_get(&arena, clusters_offset, cluster_count);
+	l1i = cpuinfo_arena_get(&arena, l1i_offset, core_count);
+	l1d = cpuinfo_arena_get(&arena, l1d_offset, core_count);
+	l2 = cpuinfo_arena_get(&arena, l2_offset, l2_count);
 
 	static_package.processor_count = processor_count;
 	static_package.core_count = core_count;
@@ -260,18 +306,13 @@ void cpuinfo_emscripten_init(void) {
 
 	cpuinfo_max_cache_size = is_x86 ? 128 * 1024 * 1024 : 8 * 1024 * 1024;
 
+	cpuinfo_arena_memory = arena.memory;
+	__sync_synchronize();
+
 	cpuinfo_is_initialized = true;
 
-	processors = NULL;
-	cores = NULL;
-	clusters = NULL;
-	l1i = l1d = l2 = NULL;
+	arena.memory = NULL;
 
 cleanup:
-	free(processors);
-	free(cores);
-	free(clusters);
-	free(l1i);
-	free(l1d);
-	free(l2);
+	cpuinfo_arena_free(arena.memory);
 }
@@ -0,0 +1,356 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <string.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+
+	#include <linux/api.h>
+#endif
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define POWERCAP_ZONE_FORMAT "/sys/class/powercap/intel-rapl:%"PRIu32
+	#define POWERCAP_SUBZONE_FORMAT "/sys/class/powercap/intel-rapl:%"PRIu32":%"PRIu32
+	#define POWER_PMU_PATH "/sys/bus/event_source/devices/power"
+	#define ENERGY_PATH_MAX 96
+	#define ENERGY_FILESIZE 64
+
+	#if !defined(O_CLOEXEC)
+		#define O_CLOEXEC 0
+	#endif
+
+	/* Names of powercap zones and of power PMU events, indexed by cpuinfo_energy_domain */
+	static const char* powercap_zone_names[cpuinfo_energy_domain_max] = {
+		[cpuinfo_energy_domain_package] = "package",
+		[cpuinfo_energy_domain_cores] = "core",
+		[cpuinfo_energy_domain_uncore] = "uncore",
+		[cpuinfo_energy_domain_dram] = "dram",
+	};
+	static const char* power_pmu_event_names[cpuinfo_energy_domain_max] = {
+		[cpuinfo_energy_domain_package] = "energy-pkg",
+		[cpuinfo_energy_domain_cores] = "energy-cores",
+		[cpuinfo_energy_domain_uncore] = "energy-gpu",
+		[cpuinfo_energy_domain_dram] = "energy-ram",
+	};
+#endif
+
+/* Energy counter of a domain of a package; packages with several dies have a counter for every die */
+struct energy_counter {
+	uint32_t package_index;
+	enum cpuinfo_energy_domain domain;
+	int file;
+	/* perf_event counter, which counts up in units of scale_uj; otherwise powercap energy_uj file */
+	bool perf;
+	double scale_uj;
+	/* Raw value at the previous read, and the value at which a powercap counter wraps around, or 0 if unknown */
+	uint64_t last_value;
+	uint64_t max_value;
+	/* Energy since the creation of the sampler */
+	uint64_t energy_uj;
+};
+
+struct cpuinfo_energy_sampler {
+	uint32_t packages_count;
+	struct energy_counter* counters;
+	uint32_t counters_count;
+};
+
+#if defined(__linux__)
+	static bool uint64_parser(const char* text_start, const char* text_end, void* context) {
+		uint64_t value = 0;
+		const char* position = text_start;
+		for (; position != text_end && *position >= '0' && *position <= '9'; position++) {
+			value = value * 10 + (uint64_t) (*position - '0');
+		}
+		if (position == text_start) {
+			return false;
+		}
+		*((uint64_t*) context) = value;
+		return true;
+	}
+
+	/* Copy the file contents as a NUL-terminated string without the trailing newline */
+	static bool string_parser(const char* text_start, const char* text_end, void* context) {
+		char* string = (char*) context;
+		size_t length = (size_t) (text_end - text_start);
+		while (length != 0 && (text_start[length - 1] == '\n' || text_start[length - 1] == ' ')) {
+			length--;
+		}
+		if (length >= ENERGY_FILESIZE) {
+			return false;
+		}
+		memcpy(string, text_start, length);
+		string[length] = '\0';
+		return true;
+	}
+
+	static bool read_string(const char* path, char string[restrict static ENERGY_FILESIZE]) {
+		return cpuinfo_linux_parse_small_file(path, ENERGY_FILESIZE, string_parser, string);
+	}
+
+	static bool add_counter(struct cpuinfo_energy_sampler sampler[restrict static 1], struct energy_counter counter) {
+		struct energy_counter* counters =
+			realloc(sampler->counters, (sampler->counters_count + 1) * sizeof(struct energy_counter));
+		if (counters == NULL) {
+			cpuinfo_log_error("failed to allocate %"PRIu32" energy counters", sampler->counters_count + 1);
+			close(counter.file);
+			return false;
+		}
+		counters[sampler->counters_count++] = counter;
+		sampler->counters = counters;
+		return true;
+	}
+
+	/* Read the raw value of the counter: a decimal number from the start of energy_uj, or a perf_event count */
+	static bool read_counter(
+		const struct energy_counter counter[restrict static 1],
+		uint64_t value[restrict static 1])
+	{
+		if (counter->perf) {
+			return read(counter->file, value, sizeof(uint64_t)) == (ssize_t) sizeof(uint64_t);
+		}
+		char buffer[32];
+		const ssize_t bytes_read = pread(counter->file, buffer, sizeof(buffer), 0);
+		return bytes_read > 0 && uint64_parser(buffer, buffer + bytes_read, value);
+	}
+
+	/* Open energy_uj of a powercap zone and take its initial value */
+	static bool add_powercap_counter(struct cpuinfo_energy_sampler sampler[restrict static 1], const char* zone_path,
+		uint32_t package_index, enum cpuinfo_energy_domain domain)
+	{
+		char path[ENERGY_PATH_MAX + sizeof("/max_energy_range_uj")];
+		snprintf(path, sizeof(path), "%s/energy_uj", zone_path);
+		struct energy_counter counter = {
+			.package_index = package_index,
+			.domain = domain,
+			.file = open(path, O_RDONLY | O_CLOEXEC),
+		};
+		if (counter.file == -1) {
+			/* Kernels since 5.10 allow only root to read energy_uj */
+			cpuinfo_log_debug("failed to open %s: %s", path, strerror(errno));
+			return false;
+		}
+		if (!read_counter(&counter, &counter.last_value)) {
+			cpuinfo_log_debug("failed to read %s", path);
+			close(counter.file);
+			return false;
+		}
+		snprintf(path, sizeof(path), "%s/max_energy_range_uj", zone_path);
+		cpuinfo_linux_parse_small_file(path, ENERGY_FILESIZE, uint64_parser, &counter.max_value);
+		return add_counter(sampler, counter);
+	}
+
+	/*
+	 * Add counters of powercap zones "package-K" or "package-K-die-D", and of their subzones, to the packages with
+	 * physical package ID K. Returns bit mask of packages with counters.
+	 */
+	static uint64_t add_powercap_counters(struct cpuinfo_energy_sampler sampler[restrict static 1],
+		const uint32_t* package_ids)
+	{
+		uint64_t packages_mask = 0;
+		char zone_path[ENERGY_PATH_MAX], path[ENERGY_PATH_MAX + sizeof("/name")], name[ENERGY_FILESIZE];
+		for (uint32_t zone = 0; ; zone++) {
+			snprintf(zone_path, sizeof(zone_path), POWERCAP_ZONE_FORMAT, zone);
+			snprintf(path, sizeof(path), "%s/name", zone_path);
+			if (!read_string(path, name)) {
+				break;
+			}
+			uint32_t package_id;
+			if (sscanf(name, "package-%"SCNu32, &package_id) != 1) {
+				/* Platform zones, e.g. psys, span all packages */
+				continue;
+			}
+			uint32_t package_index = 0;
+			while (package_index < sampler->packages_count && package_ids[package_index] != package_id) {
+				package_index++;
+			}
+			if (package_index == sampler->packages_count) {
+				cpuinfo_log_debug("powercap zone %s of unknown package %"PRIu32, name, package_id);
+				continue;
+			}
+			if (!add_powercap_counter(sampler, zone_path, package_index, cpuinfo_energy_domain_package)) {
+				continue;
+			}
+			if (package_index < 64) {
+				packages_mask |= UINT64_C(1) << package_index;
+			}
+			for (uint32_t subzone = 0; ; subzone++) {
+				snprintf(zone_path, sizeof(zone_path), POWERCAP_SUBZONE_FORMAT, zone, subzone);
+				snprintf(path, sizeof(path), "%s/name", zone_path);
+				if (!read_string(path, name)) {
+					break;
+				}
+				for (uint32_t domain = cpuinfo_energy_domain_cores; domain < cpuinfo_energy_domain_max; domain++) {
+					if (strcmp(name, powercap_zone_names[domain]) == 0) {
+						add_powercap_counter(sampler, zone_path, package_index, (enum cpuinfo_energy_domain) domain);
+					}
+				}
+			}
+		}
+		return packages_mask;
+	}
+
+	static bool config_parser(const char* text_start, const char* text_end, void* context) {
+		char string[ENERGY_FILESIZE];
+		if (!string_parser(text_start, text_end, string)) {
+			return false;
+		}
+		unsigned long long config;
+		if (sscanf(string, "event=%llx", &config) != 1) {
+			return false;
+		}
+		*((uint64_t*) context) = (uint64_t) config;
+		return true;
+	}
+
+	/* Open events of the power PMU of perf_event on a processor of every package without powercap counters */
+	static void add_power_pmu_counters(struct cpuinfo_energy_sampler sampler[restrict static 1],
+		const struct cpuinfo_tables tables[restrict static 1], uint64_t powercap_packages_mask)
+	{
+		uint64_t pmu_type = 0;
+		if (!cpuinfo_linux_parse_small_file(POWER_PMU_PATH "/type", ENERGY_FILESIZE, uint64_parser, &pmu_type)) {
+			cpuinfo_log_debug("no power PMU in perf_event");
+			return;
+		}
+		char path[ENERGY_PATH_MAX], scale[ENERGY_FILESIZE];
+		for (uint32_t domain = 0; domain < cpuinfo_energy_domain_max; domain++) {
+			uint64_t config = 0;
+			snprintf(path, sizeof(path), POWER_PMU_PATH "/events/%s", power_pmu_event_names[domain]);
+			if (!cpuinfo_linux_parse_small_file(path, ENERGY_FILESIZE, config_parser, &config)) {
+				continue;
+			}
+			/* Joules per count, e.g. 2.3283064365386962890625e-10 */
+			snprintf(path, sizeof(path), POWER_PMU_PATH "/events/%s.scale", power_pmu_event_names[domain]);
+			if (!read_string(path, scale)) {
+				continue;
+			}
+			const double scale_uj = strtod(scale, NULL) * 1.0e+6;
+			for (uint32_t package_index = 0; package_index < sampler->packages_count; package_index++) {
+				if (package_index < 64 && (powercap_packages_mask & (UINT64_C(1) << package_index)) != 0) {
+					continue;
+				}
+				const struct cpuinfo_package* package = &tables->packages[package_index];
+				const int linux_id = tables->processors[package->processor_start].linux_id;
+
+				struct perf_event_attr attr;
+				memset(&attr, 0, sizeof(attr));
+				attr.type = (uint32_t) pmu_type;
+				attr.size = sizeof(attr);
+				attr.config = config;
+				struct energy_counter counter = {
+					.package_index = package_index,
+					.domain = (enum cpuinfo_energy_domain) domain,
+					.file = (int) syscall(__NR_perf_event_open, &attr, -1 /* any process */, linux_id,
+						-1 /* no group */, PERF_FLAG_FD_CLOEXEC),
+					.perf = true,
+					.scale_uj = scale_uj,
+				};
+				if (counter.file == -1) {
+					cpuinfo_log_debug("failed to open perf_event %s on processor %d: %s",
+						power_pmu_event_names[domain], linux_id, strerror(errno));
+					continue;
+				}
+				if (!read_counter(&counter, &counter.last_value)) {
+					close(counter.file);
+					continue;
+				}
+				add_counter(sampler, counter);
+			}
+		}
+	}
+#endif
+
+struct cpuinfo_energy_sampler* CPUINFO_ABI cpuinfo_create_energy_sampler(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("energy_sampler");
+	#if defined(__linux__)
+		struct cpuinfo_energy_sampler* sampler = calloc(1, sizeof(struct cpuinfo_energy_sampler));
+		uint32_t* package_ids = calloc(tables->packages_count, sizeof(uint32_t));
+		if (sampler == NULL || package_ids == NULL) {
+			cpuinfo_log_error("failed to allocate energy sampler of %"PRIu32" packages", tables->packages_count);
+			free(package_ids);
+			free(sampler);
+			return NULL;
+		}
+		sampler->packages_count = tables->packages_count;
+		for (uint32_t i = 0; i < tables->packages_count; i++) {
+			const uint32_t linux_id = (uint32_t) tables->processors[tables->packages[i].processor_start].linux_id;
+			if (!cpuinfo_linux_get_processor_package_id(linux_id, &package_ids[i])) {
+				package_ids[i] = i;
+			}
+		}
+
+		const uint64_t powercap_packages_mask = add_powercap_counters(sampler, package_ids);
+		add_power_pmu_counters(sampler, tables, powercap_packages_mask);
+		free(package_ids);
+		if (sampler->counters_count == 0) {
+			cpuinfo_log_warning("no readable energy counters");
+			cpuinfo_destroy_energy_sampler(sampler);
+			return NULL;
+		}
+		return sampler;
+	#else
+		return NULL;
+	#endif
+}
+
+void CPUINFO_ABI cpuinfo_destroy_energy_sampler(struct cpuinfo_energy_sampler* sampler) {
+	if (sampler == NULL) {
+		return;
+	}
+	#if defined(__linux__)
+		for (uint32_t i = 0; i < sampler->counters_count; i++) {
+			close(sampler->counters[i].file);
+		}
+	#endif
+	free(sampler->counters);
+	free(sampler);
+}
+
+bool CPUINFO_ABI cpuinfo_sample_package_energy(struct cpuinfo_energy_sampler* sampler,
+	uint32_t package_index, struct cpuinfo_energy_sample* sample)
+{
+	if (sampler == NULL || sample == NULL) {
+		return false;
+	}
+	*sample = (struct cpuinfo_energy_sample) { 0 };
+	#if defined(__linux__)
+		for (uint32_t i = 0; i < sampler->counters_count; i++) {
+			struct energy_counter* counter = &sampler->counters[i];
+			uint64_t value;
+			if (counter->package_index != package_index || !read_counter(counter, &value)) {
+				continue;
+			}
+			if (counter->perf) {
+				counter->energy_uj = (uint64_t) ((double) (value - counter->last_value) * counter->scale_uj);
+			} else {
+				/* energy_uj restarts from 0 after max_energy_range_uj */
+				uint64_t delta = value - counter->last_value;
+				if (value < counter->last_value) {
+					delta = 0;
+					if (counter->max_value > counter->last_value) {
+						delta = counter->max_value - counter->last_value + value;
+					}
+				}
+				counter->energy_uj += delta;
+				counter->last_value = value;
+			}
+			sample->domains |= UINT32_C(1) << counter->domain;
+			sample->energy_uj[counter->domain] += counter->energy_uj;
+		}
+	#endif
+	return sample->domains != 0;
+}
@@ -0,0 +1,143 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/*
+ * Readers of snapshots pin the generation of their tables in one of the epoch slots, and re-initialization releases
+ * only retired tables older than every pinned generation. A slot with value 0 is free. When all slots are taken,
+ * readers increment the overflow counter instead, which pins all tables until they release their snapshots.
+ */
+#define EPOCH_SLOTS_COUNT 64
+
+static volatile uint64_t epoch_slots[EPOCH_SLOTS_COUNT];
+static volatile uint64_t epoch_overflow_count = 0;
+/* Generation of the last published tables, stored after the pointer to them */
+static volatile uint64_t published_generation = 0;
+
+static inline uint64_t load_epoch(volatile uint64_t* epoch) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (uint64_t) InterlockedCompareExchange64((volatile LONG64*) epoch, 0, 0);
+#else
+	return __atomic_load_n(epoch, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void store_epoch(volatile uint64_t* epoch, uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	InterlockedExchange64((volatile LONG64*) epoch, (LONG64) value);
+#else
+	__atomic_store_n(epoch, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline bool exchange_epoch(volatile uint64_t* epoch, uint64_t expected, uint64_t desired) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (uint64_t) InterlockedCompareExchange64((volatile LONG64*) epoch, (LONG64) desired, (LONG64) expected) ==
+		expected;
+#else
+	return __atomic_compare_exchange_n(epoch, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void add_epoch(volatile uint64_t* epoch, int64_t delta) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	InterlockedExchangeAdd64((volatile LONG64*) epoch, (LONG64) delta);
+#else
+	__atomic_fetch_add(epoch, (uint64_t) delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* Order the preceding stores before the following loads */
+static inline void full_fence(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	MemoryBarrier();
+#else
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+void cpuinfo_publish_epoch(uint64_t generation) {
+	store_epoch(&published_generation, generation);
+}
+
+uint64_t cpuinfo_get_min_pinned_generation(void) {
+	/* Pointer to the new tables must be visible to readers before the slots are checked */
+	full_fence();
+	if (load_epoch(&epoch_overflow_count) != 0) {
+		return 0;
+	}
+	uint64_t min_generation = UINT64_MAX;
+	for (uint32_t i = 0; i < EPOCH_SLOTS_COUNT; i++) {
+		const uint64_t generation = load_epoch(&epoch_slots[i]);
+		if (generation != 0 && generation < min_generation) {
+			min_generation = generation;
+		}
+	}
+	return min_generation;
+}
+
+/*
+ * Remove one pin of the generation. Pins are not owned by slots: readers of the same generation may release each
+ * other's slots, because re-initialization checks only which generations are pinned.
+ */
+static void unpin_generation(uint64_t generation) {
+	for (uint32_t i = 0; i < EPOCH_SLOTS_COUNT; i++) {
+		if (load_epoch(&epoch_slots[i]) == generation && exchange_epoch(&epoch_slots[i], generation, 0)) {
+			return;
+		}
+	}
+	add_epoch(&epoch_overflow_count, -1);
+}
+
+/* Pin the generation in a free slot; returns false if all slots are taken */
+static bool pin_generation(uint64_t generation) {
+	for (uint32_t i = 0; i < EPOCH_SLOTS_COUNT; i++) {
+		if (load_epoch(&epoch_slots[i]) == 0 && exchange_epoch(&epoch_slots[i], 0, generation)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+const struct cpuinfo_topology_snapshot* CPUINFO_ABI cpuinfo_snapshot_acquire(void) {
+	for (;;) {
+		/*
+		 * Re-initialization publishes the generation after the tables, so the pinned generation is not newer than
+		 * the tables loaded after it, and the tables are not released while the generation is pinned.
+		 */
+		const uint64_t generation = load_epoch(&published_generation);
+		if (generation == 0 || !pin_generation(generation)) {
+			add_epoch(&epoch_overflow_count, 1);
+			full_fence();
+			const struct cpuinfo_tables* tables = cpuinfo_load_tables();
+			if (tables == NULL) {
+				add_epoch(&epoch_overflow_count, -1);
+				return NULL;
+			}
+			return &tables->topology_snapshot;
+		}
+		full_fence();
+
+		const struct cpuinfo_tables* tables = cpuinfo_load_tables();
+		if (tables == NULL) {
+			unpin_generation(generation);
+			return NULL;
+		}
+		if (tables->generation == generation) {
+			return &tables->topology_snapshot;
+		}
+		/* Tables were re-initialized after the generation was loaded: pin the new generation instead */
+		unpin_generation(generation);
+	}
+}
+
+void CPUINFO_ABI cpuinfo_snapshot_release(const struct cpuinfo_topology_snapshot* snapshot) {
+	if (snapshot != NULL) {
+		unpin_generation(snapshot->generation);
+	}
+}
@@ -0,0 +1,462 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Maximum nesting of objects and arrays in the document */
+#define EXPORT_MAX_DEPTH 8
+
+/* Major types and simple values of CBOR (RFC 8949) */
+#define CBOR_MAJOR_UNSIGNED   0
+#define CBOR_MAJOR_TEXT       3
+#define CBOR_MAJOR_ARRAY      4
+#define CBOR_MAJOR_MAP        5
+#define CBOR_FALSE            UINT8_C(0xF4)
+#define CBOR_TRUE             UINT8_C(0xF5)
+#define CBOR_NULL             UINT8_C(0xF6)
+#define CBOR_INDEFINITE_ARRAY UINT8_C(0x9F)
+#define CBOR_INDEFINITE_MAP   UINT8_C(0xBF)
+#define CBOR_BREAK            UINT8_C(0xFF)
+
+static const char* const cache_level_names[cpuinfo_cache_level_max] = {
+	[cpuinfo_cache_level_1i] = "l1i",
+	[cpuinfo_cache_level_1d] = "l1d",
+	[cpuinfo_cache_level_2] = "l2",
+	[cpuinfo_cache_level_3] = "l3",
+	[cpuinfo_cache_level_4] = "l4",
+};
+
+/*
+ * Writer of the document: counts all bytes, and stores the ones which fit into the buffer. Objects and arrays are
+ * indefinite-length in CBOR, so that both formats are written in one pass without counting members in advance.
+ */
+struct writer {
+	enum cpuinfo_export_format format;
+	uint8_t* buffer;
+	size_t size;
+	size_t length;
+	uint32_t depth;
+	/* Whether the current object or array of every nesting level has no members yet, for separators in JSON */
+	bool empty[EXPORT_MAX_DEPTH];
+	/* Whether the next value follows a key of an object, and needs no separator */
+	bool after_key;
+};
+
+static void write_bytes(struct writer writer[restrict static 1], const void* data, size_t size) {
+	if (writer->length < writer->size) {
+		const size_t available = writer->size - writer->length;
+		memcpy(writer->buffer + writer->length, data, size < available ? size : available);
+	}
+	writer->length += size;
+}
+
+static void write_byte(struct writer writer[restrict static 1], uint8_t byte) {
+	write_bytes(writer, &byte, 1);
+}
+
+static void write_cbor_head(struct writer writer[restrict static 1], uint32_t major_type, uint64_t value) {
+	uint8_t head[9];
+	size_t size;
+	if (value < 24) {
+		head[0] = (uint8_t) ((major_type << 5) | value);
+		size = 1;
+	} else {
+		uint32_t additional_info;
+		if (value <= UINT8_MAX) {
+			additional_info = 24;
+			size = 2;
+		} else if (value <= UINT16_MAX) {
+			additional_info = 25;
+			size = 3;
+		} else if (value <= UINT32_MAX) {
+			additional_info = 26;
+			size = 5;
+		} else {
+			additional_info = 27;
+			size = 9;
+		}
+		head[0] = (uint8_t) ((major_type << 5) | additional_info);
+		/* Arguments are big-endian */
+		for (size_t i = size - 1; i != 0; i--) {
+			head[i] = (uint8_t) value;
+			value >>= 8;
+		}
+	}
+	write_bytes(writer, head, size);
+}
+
+/* Comma before every member of a JSON object or array but the first one */
+static void write_separator(struct writer writer[restrict static 1]) {
+	if (writer->after_key) {
+		writer->after_key = false;
+		return;
+	}
+	if (writer->depth != 0) {
+		if (!writer->empty[writer->depth - 1] && writer->format == cpuinfo_export_format_json) {
+			write_byte(writer, ',');
+		}
+		writer->empty[writer->depth - 1] = false;
+	}
+}
+
+static void write_string(struct writer writer[restrict static 1], const char* string) {
+	write_separator(writer);
+	const size_t length = strlen(string);
+	if (writer->format == cpuinfo_export_format_cbor) {
+		write_cbor_head(writer, CBOR_MAJOR_TEXT, length);
+		write_bytes(writer, string, length);
+		return;
+	}
+	write_byte(writer, '"');
+	for (size_t i = 0; i < length; i++) {
+		const char c = string[i];
+		if (c == '"' || c == '\\') {
+			write_byte(writer, '\\');
+			write_byte(writer, (uint8_t) c);
+		} else if ((unsigned char) c < 0x20) {
+			char escape[sizeof("\\u0000")];
+			snprintf(escape, sizeof(escape), "\\u%04x", (unsigned int) (unsigned char) c);
+			write_bytes(writer, escape, sizeof(escape) - 1);
+		} else {
+			write_byte(writer, (uint8_t) c);
+		}
+	}
+	write_byte(writer, '"');
+}
+
+static void write_uint(struct writer writer[restrict static 1], uint64_t value) {
+	write_separator(writer);
+	if (writer->format == cpuinfo_export_format_cbor) {
+		write_cbor_head(writer, CBOR_MAJOR_UNSIGNED, value);
+		return;
+	}
+	char text[sizeof("18446744073709551615")];
+	const int length = snprintf(text, sizeof(text), "%" PRIu64, value);
+	write_bytes(writer, text, (size_t) length);
+}
+
+static void write_bool(struct writer writer[restrict static 1], bool value) {
+	write_separator(writer);
+	if (writer->format == cpuinfo_export_format_cbor) {
+		write_byte(writer, value ? CBOR_TRUE : CBOR_FALSE);
+	} else if (value) {
+		write_bytes(writer, "true", sizeof("true") - 1);
+	} else {
+		write_bytes(writer, "false", sizeof("false") - 1);
+	}
+}
+
+static void write_null(struct writer writer[restrict static 1]) {
+	write_separator(writer);
+	if (writer->format == cpuinfo_export_format_cbor) {
+		write_byte(writer, CBOR_NULL);
+	} else {
+		write_bytes(writer, "null", sizeof("null") - 1);
+	}
+}
+
+/* 64-bit hashes are written as hexadecimal strings: JSON parsers often keep numbers in doubles */
+static void write_hash(struct writer writer[restrict static 1], uint64_t hash) {
+	char text[sizeof("0123456789ABCDEF")];
+	snprintf(text, sizeof(text), "%016" PRIx64, hash);
+	write_string(writer, text);
+}
+
+static void begin_container(struct writer writer[restrict static 1], char json_open, uint8_t cbor_open) {
+	write_separator(writer);
+	if (writer->format == cpuinfo_export_format_cbor) {
+		write_byte(writer, cbor_open);
+	} else {
+		write_byte(writer, (uint8_t) json_open);
+	}
+	writer->empty[writer->depth++] = true;
+}
+
+static void end_container(struct writer writer[restrict static 1], char json_close) {
+	writer->depth -= 1;
+	if (writer->format == cpuinfo_export_format_cbor) {
+		write_byte(writer, CBOR_BREAK);
+	} else {
+		write_byte(writer, (uint8_t) json_close);
+	}
+}
+
+static void begin_object(struct writer writer[restrict static 1]) {
+	begin_container(writer, '{', CBOR_INDEFINITE_MAP);
+}
+
+static void end_object(struct writer writer[restrict static 1]) {
+	end_container(writer, '}');
+}
+
+static void begin_array(struct writer writer[restrict static 1]) {
+	begin_container(writer, '[', CBOR_INDEFINITE_ARRAY);
+}
+
+static void end_array(struct writer writer[restrict static 1]) {
+	end_container(writer, ']');
+}
+
+static void write_key(struct writer writer[restrict static 1], const char* key) {
+	write_string(writer, key);
+	if (writer->format == cpuinfo_export_format_json) {
+		write_byte(writer, ':');
+	}
+	writer->after_key = true;
+}
+
+static void write_uint_member(struct writer writer[restrict static 1], const char* key, uint64_t value) {
+	write_key(writer, key);
+	write_uint(writer, value);
+}
+
+/* Index of the object in its table, or null if the processor has no such object */
+static void write_index_member(struct writer writer[restrict static 1], const char* key,
+	const void* object, const void* table, size_t entry_size)
+{
+	write_key(writer, key);
+	if (object == NULL || table == NULL) {
+		write_null(writer);
+	} else {
+		write_uint(writer, (uint64_t) (((uintptr_t) object - (uintptr_t) table) / entry_size));
+	}
+}
+
+static void write_packages(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_array(writer);
+	for (uint32_t i = 0; i < tables->packages_count; i++) {
+		const struct cpuinfo_package* package = &tables->packages[i];
+		begin_object(writer);
+		write_key(writer, "name");
+		write_string(writer, package->name);
+		write_uint_member(writer, "processor_start", package->processor_start);
+		write_uint_member(writer, "processor_count", package->processor_count);
+		write_uint_member(writer, "core_start", package->core_start);
+		write_uint_member(writer, "core_count", package->core_count);
+		write_uint_member(writer, "cluster_start", package->cluster_start);
+		write_uint_member(writer, "cluster_count", package->cluster_count);
+		end_object(writer);
+	}
+	end_array(writer);
+}
+
+static void write_clusters(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_array(writer);
+	for (uint32_t i = 0; i < tables->clusters_count; i++) {
+		const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+		begin_object(writer);
+		write_uint_member(writer, "processor_start", cluster->processor_start);
+		write_uint_member(writer, "processor_count", cluster->processor_count);
+		write_uint_member(writer, "core_start", cluster->core_start);
+		write_uint_member(writer, "core_count", cluster->core_count);
+		write_uint_member(writer, "cluster_id", cluster->cluster_id);
+		write_index_member(writer, "package", cluster->package, tables->packages, sizeof(struct cpuinfo_package));
+		write_uint_member(writer, "vendor", (uint64_t) cluster->vendor);
+		write_uint_member(writer, "uarch", (uint64_t) cluster->uarch);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			write_uint_member(writer, "cpuid", cluster->cpuid);
+		#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			write_uint_member(writer, "midr", cluster->midr);
+		#endif
+		write_uint_member(writer, "frequency", cluster->frequency);
+		write_uint_member(writer, "capacity", cluster->capacity);
+		end_object(writer);
+	}
+	end_array(writer);
+}
+
+static void write_cores(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_array(writer);
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		const struct cpuinfo_core* core = &tables->cores[i];
+		begin_object(writer);
+		write_uint_member(writer, "processor_start", core->processor_start);
+		write_uint_member(writer, "processor_count", core->processor_count);
+		write_uint_member(writer, "core_id", core->core_id);
+		write_index_member(writer, "cluster", core->cluster, tables->clusters, sizeof(struct cpuinfo_cluster));
+		write_index_member(writer, "package", core->package, tables->packages, sizeof(struct cpuinfo_package));
+		write_uint_member(writer, "vendor", (uint64_t) core->vendor);
+		write_uint_member(writer, "uarch", (uint64_t) core->uarch);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			write_uint_member(writer, "cpuid", core->cpuid);
+		#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			write_uint_member(writer, "midr", core->midr);
+		#endif
+		write_uint_member(writer, "frequency", core->frequency);
+		write_uint_member(writer, "max_turbo_frequency", core->max_turbo_frequency);
+		write_uint_member(writer, "performance", core->performance);
+		write_uint_member(writer, "capacity", core->capacity);
+		end_object(writer);
+	}
+	end_array(writer);
+}
+
+static void write_processors(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_array(writer);
+	for (uint32_t i = 0; i < tables->processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		const struct cpuinfo_cache* caches[cpuinfo_cache_level_max] = {
+			[cpuinfo_cache_level_1i] = processor->cache.l1i,
+			[cpuinfo_cache_level_1d] = processor->cache.l1d,
+			[cpuinfo_cache_level_2] = processor->cache.l2,
+			[cpuinfo_cache_level_3] = processor->cache.l3,
+			[cpuinfo_cache_level_4] = processor->cache.l4,
+		};
+		begin_object(writer);
+		write_uint_member(writer, "smt_id", processor->smt_id);
+		write_index_member(writer, "core", processor->core, tables->cores, sizeof(struct cpuinfo_core));
+		write_index_member(writer, "cluster", processor->cluster, tables->clusters, sizeof(struct cpuinfo_cluster));
+		write_index_member(writer, "package", processor->package, tables->packages, sizeof(struct cpuinfo_package));
+		write_index_member(writer, "frequency_domain", processor->frequency_domain, tables->frequency_domains,
+			sizeof(struct cpuinfo_frequency_domain));
+		#if defined(__linux__)
+			write_uint_member(writer, "linux_id", (uint64_t) processor->linux_id);
+		#endif
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			write_uint_member(writer, "apic_id", processor->apic_id);
+		#endif
+		write_key(writer, "caches");
+		begin_object(writer);
+		for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+			write_index_member(writer, cache_level_names[level], caches[level], tables->cache[level],
+				sizeof(struct cpuinfo_cache));
+		}
+		end_object(writer);
+		end_object(writer);
+	}
+	end_array(writer);
+}
+
+static void write_caches(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_object(writer);
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		write_key(writer, cache_level_names[level]);
+		begin_array(writer);
+		for (uint32_t i = 0; i < tables->cache_count[level]; i++) {
+			const struct cpuinfo_cache* cache = &tables->cache[level][i];
+			begin_object(writer);
+			write_uint_member(writer, "size", cache->size);
+			write_uint_member(writer, "associativity", cache->associativity);
+			write_uint_member(writer, "sets", cache->sets);
+			write_uint_member(writer, "partitions", cache->partitions);
+			write_uint_member(writer, "line_size", cache->line_size);
+			write_uint_member(writer, "flags", cache->flags);
+			write_uint_member(writer, "processor_start", cache->processor_start);
+			write_uint_member(writer, "processor_count", cache->processor_count);
+			end_object(writer);
+		}
+		end_array(writer);
+	}
+	end_object(writer);
+}
+
+static void write_uarchs(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_array(writer);
+	for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+		const struct cpuinfo_uarch_info* uarch_info = &tables->uarchs[i];
+		begin_object(writer);
+		write_uint_member(writer, "uarch", (uint64_t) uarch_info->uarch);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			write_uint_member(writer, "cpuid", uarch_info->cpuid);
+		#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			write_uint_member(writer, "midr", uarch_info->midr);
+		#endif
+		write_uint_member(writer, "processor_count", uarch_info->processor_count);
+		write_uint_member(writer, "core_count", uarch_info->core_count);
+		end_object(writer);
+	}
+	end_array(writer);
+}
+
+static void write_frequency_domains(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_array(writer);
+	for (uint32_t i = 0; i < tables->frequency_domains_count; i++) {
+		const struct cpuinfo_frequency_domain* domain = &tables->frequency_domains[i];
+		begin_object(writer);
+		write_uint_member(writer, "domain_id", domain->domain_id);
+		write_uint_member(writer, "processor_start", domain->processor_start);
+		write_uint_member(writer, "processor_count", domain->processor_count);
+		write_uint_member(writer, "min_frequency", domain->min_frequency);
+		write_uint_member(writer, "max_frequency", domain->max_frequency);
+		write_key(writer, "frequencies");
+		begin_array(writer);
+		for (uint32_t j = 0; j < domain->frequencies_count; j++) {
+			write_uint(writer, domain->frequencies[j]);
+		}
+		end_array(writer);
+		write_key(writer, "governor");
+		write_string(writer, domain->governor);
+		write_key(writer, "boost");
+		write_bool(writer, domain->boost);
+		write_key(writer, "driver");
+		write_string(writer, domain->driver);
+		write_uint_member(writer, "energy_performance_preference", (uint64_t) domain->energy_performance_preference);
+		write_uint_member(writer, "energy_performance_preferences", domain->energy_performance_preferences);
+		end_object(writer);
+	}
+	end_array(writer);
+}
+
+static void write_isa(struct writer writer[restrict static 1], const struct cpuinfo_tables* tables) {
+	begin_object(writer);
+	write_key(writer, "fingerprint");
+	write_hash(writer, tables->isa_fingerprint);
+	write_key(writer, "features");
+	begin_array(writer);
+	for (uint32_t i = 0; i < (uint32_t) cpuinfo_isa_feature_max; i++) {
+		if (cpuinfo_isa_features_contain(&tables->isa_features, (enum cpuinfo_isa_feature) i)) {
+			write_uint(writer, i);
+		}
+	}
+	end_array(writer);
+	end_object(writer);
+}
+
+size_t CPUINFO_ABI cpuinfo_export(enum cpuinfo_export_format format, void* buffer, size_t size) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("export");
+	if (format != cpuinfo_export_format_json && format != cpuinfo_export_format_cbor) {
+		cpuinfo_log_warning("unsupported export format %d", (int) format);
+		return 0;
+	}
+	struct writer writer = {
+		.format = format,
+		.buffer = (uint8_t*) buffer,
+		.size = buffer != NULL ? size : 0,
+	};
+	begin_object(&writer);
+	write_uint_member(&writer, "schema_version", CPUINFO_EXPORT_SCHEMA_VERSION);
+	write_key(&writer, "hardware_fingerprint");
+	write_hash(&writer, cpuinfo_hardware_fingerprint());
+	struct cpuinfo_topology_fingerprint topology_fingerprint;
+	cpuinfo_get_topology_fingerprint(&topology_fingerprint);
+	char topology_fingerprint_text[sizeof("0123456789ABCDEF0123456789ABCDEF")];
+	snprintf(topology_fingerprint_text, sizeof(topology_fingerprint_text), "%016" PRIx64 "%016" PRIx64,
+		topology_fingerprint.words[1], topology_fingerprint.words[0]);
+	write_key(&writer, "topology_fingerprint");
+	write_string(&writer, topology_fingerprint_text);
+	write_key(&writer, "packages");
+	write_packages(&writer, tables);
+	write_key(&writer, "clusters");
+	write_clusters(&writer, tables);
+	write_key(&writer, "cores");
+	write_cores(&writer, tables);
+	write_key(&writer, "processors");
+	write_processors(&writer, tables);
+	write_key(&writer, "caches");
+	write_caches(&writer, tables);
+	write_key(&writer, "uarchs");
+	write_uarchs(&writer, tables);
+	write_key(&writer, "frequency_domains");
+	write_frequency_domains(&writer, tables);
+	write_key(&writer, "isa");
+	write_isa(&writer, tables);
+	end_object(&writer);
+	return writer.length;
+}
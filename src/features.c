@@ -0,0 +1,248 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+	#include <arm/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Parameters of the 64-bit FNV-1a hash */
+#define FNV_OFFSET_BASIS UINT64_C(0xCBF29CE484222325)
+#define FNV_PRIME UINT64_C(0x00000100000001B3)
+
+static void set_feature(struct cpuinfo_isa_features* features, enum cpuinfo_isa_feature feature, bool supported) {
+	if (supported) {
+		cpuinfo_isa_features_add(features, feature);
+	}
+}
+
+static uint64_t hash_word(uint64_t hash, uint64_t word) {
+	for (uint32_t i = 0; i < 8; i++) {
+		hash = (hash ^ ((word >> (i * 8)) & UINT64_C(0xFF))) * FNV_PRIME;
+	}
+	return hash;
+}
+
+void cpuinfo_detect_isa_features(struct cpuinfo_tables* tables) {
+	struct cpuinfo_isa_features* features = &tables->isa_features;
+	*features = (struct cpuinfo_isa_features) { 0 };
+	set_feature(features, cpuinfo_isa_feature_x86_rdtsc, cpuinfo_has_x86_rdtsc());
+	set_feature(features, cpuinfo_isa_feature_x86_rdtscp, cpuinfo_has_x86_rdtscp());
+	set_feature(features, cpuinfo_isa_feature_x86_rdpid, cpuinfo_has_x86_rdpid());
+	set_feature(features, cpuinfo_isa_feature_x86_clzero, cpuinfo_has_x86_clzero());
+	set_feature(features, cpuinfo_isa_feature_x86_mwait, cpuinfo_has_x86_mwait());
+	set_feature(features, cpuinfo_isa_feature_x86_mwaitx, cpuinfo_has_x86_mwaitx());
+	set_feature(features, cpuinfo_isa_feature_x86_fxsave, cpuinfo_has_x86_fxsave());
+	set_feature(features, cpuinfo_isa_feature_x86_xsave, cpuinfo_has_x86_xsave());
+	set_feature(features, cpuinfo_isa_feature_x86_fpu, cpuinfo_has_x86_fpu());
+	set_feature(features, cpuinfo_isa_feature_x86_mmx, cpuinfo_has_x86_mmx());
+	set_feature(features, cpuinfo_isa_feature_x86_mmx_plus, cpuinfo_has_x86_mmx_plus());
+	set_feature(features, cpuinfo_isa_feature_x86_3dnow, cpuinfo_has_x86_3dnow());
+	set_feature(features, cpuinfo_isa_feature_x86_3dnow_plus, cpuinfo_has_x86_3dnow_plus());
+	set_feature(features, cpuinfo_isa_feature_x86_3dnow_geode, cpuinfo_has_x86_3dnow_geode());
+	set_feature(features, cpuinfo_isa_feature_x86_prefetch, cpuinfo_has_x86_prefetch());
+	set_feature(features, cpuinfo_isa_feature_x86_prefetchw, cpuinfo_has_x86_prefetchw());
+	set_feature(features, cpuinfo_isa_feature_x86_prefetchwt1, cpuinfo_has_x86_prefetchwt1());
+	set_feature(features, cpuinfo_isa_feature_x86_daz, cpuinfo_has_x86_daz());
+	set_feature(features, cpuinfo_isa_feature_x86_sse, cpuinfo_has_x86_sse());
+	set_feature(features, cpuinfo_isa_feature_x86_sse2, cpuinfo_has_x86_sse2());
+	set_feature(features, cpuinfo_isa_feature_x86_sse3, cpuinfo_has_x86_sse3());
+	set_feature(features, cpuinfo_isa_feature_x86_ssse3, cpuinfo_has_x86_ssse3());
+	set_feature(features, cpuinfo_isa_feature_x86_sse4_1, cpuinfo_has_x86_sse4_1());
+	set_feature(features, cpuinfo_isa_feature_x86_sse4_2, cpuinfo_has_x86_sse4_2());
+	set_feature(features, cpuinfo_isa_feature_x86_sse4a, cpuinfo_has_x86_sse4a());
+	set_feature(features, cpuinfo_isa_feature_x86_misaligned_sse, cpuinfo_has_x86_misaligned_sse());
+	set_feature(features, cpuinfo_isa_feature_x86_avx, cpuinfo_has_x86_avx());
+	set_feature(features, cpuinfo_isa_feature_x86_fma3, cpuinfo_has_x86_fma3());
+	set_feature(features, cpuinfo_isa_feature_x86_fma4, cpuinfo_has_x86_fma4());
+	set_feature(features, cpuinfo_isa_feature_x86_xop, cpuinfo_has_x86_xop());
+	set_feature(features, cpuinfo_isa_feature_x86_f16c, cpuinfo_has_x86_f16c());
+	set_feature(features, cpuinfo_isa_feature_x86_avx2, cpuinfo_has_x86_avx2());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512f, cpuinfo_has_x86_avx512f());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512pf, cpuinfo_has_x86_avx512pf());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512er, cpuinfo_has_x86_avx512er());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512cd, cpuinfo_has_x86_avx512cd());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512dq, cpuinfo_has_x86_avx512dq());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512bw, cpuinfo_has_x86_avx512bw());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512vl, cpuinfo_has_x86_avx512vl());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512ifma, cpuinfo_has_x86_avx512ifma());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512vbmi, cpuinfo_has_x86_avx512vbmi());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512vbmi2, cpuinfo_has_x86_avx512vbmi2());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512bitalg, cpuinfo_has_x86_avx512bitalg());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512vpopcntdq, cpuinfo_has_x86_avx512vpopcntdq());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512vnni, cpuinfo_has_x86_avx512vnni());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512bf16, cpuinfo_has_x86_avx512bf16());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512fp16, cpuinfo_has_x86_avx512fp16());
+	set_feature(features, cpuinfo_isa_feature_x86_apx, cpuinfo_has_x86_apx());
+	set_feature(features, cpuinfo_isa_feature_x86_amx_tile, cpuinfo_has_x86_amx_tile());
+	set_feature(features, cpuinfo_isa_feature_x86_amx_int8, cpuinfo_has_x86_amx_int8());
+	set_feature(features, cpuinfo_isa_feature_x86_amx_bf16, cpuinfo_has_x86_amx_bf16());
+	set_feature(features, cpuinfo_isa_feature_x86_amx_fp16, cpuinfo_has_x86_amx_fp16());
+	set_feature(features, cpuinfo_isa_feature_x86_amx_complex, cpuinfo_has_x86_amx_complex());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512vp2intersect, cpuinfo_has_x86_avx512vp2intersect());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512_4vnniw, cpuinfo_has_x86_avx512_4vnniw());
+	set_feature(features, cpuinfo_isa_feature_x86_avx512_4fmaps, cpuinfo_has_x86_avx512_4fmaps());
+	set_feature(features, cpuinfo_isa_feature_x86_hle, cpuinfo_has_x86_hle());
+	set_feature(features, cpuinfo_isa_feature_x86_rtm, cpuinfo_has_x86_rtm());
+	set_feature(features, cpuinfo_isa_feature_x86_xtest, cpuinfo_has_x86_xtest());
+	set_feature(features, cpuinfo_isa_feature_x86_mpx, cpuinfo_has_x86_mpx());
+	set_feature(features, cpuinfo_isa_feature_x86_cmov, cpuinfo_has_x86_cmov());
+	set_feature(features, cpuinfo_isa_feature_x86_cmpxchg8b, cpuinfo_has_x86_cmpxchg8b());
+	set_feature(features, cpuinfo_isa_feature_x86_cmpxchg16b, cpuinfo_has_x86_cmpxchg16b());
+	set_feature(features, cpuinfo_isa_feature_x86_clwb, cpuinfo_has_x86_clwb());
+	set_feature(features, cpuinfo_isa_feature_x86_movbe, cpuinfo_has_x86_movbe());
+	set_feature(features, cpuinfo_isa_feature_x86_erms, cpuinfo_has_x86_erms());
+	set_feature(features, cpuinfo_isa_feature_x86_fsrm, cpuinfo_has_x86_fsrm());
+	set_feature(features, cpuinfo_isa_feature_x86_fzrm, cpuinfo_has_x86_fzrm());
+	set_feature(features, cpuinfo_isa_feature_x86_fsrs, cpuinfo_has_x86_fsrs());
+	set_feature(features, cpuinfo_isa_feature_x86_fsrc, cpuinfo_has_x86_fsrc());
+	set_feature(features, cpuinfo_isa_feature_x86_lahf_sahf, cpuinfo_has_x86_lahf_sahf());
+	set_feature(features, cpuinfo_isa_feature_x86_lzcnt, cpuinfo_has_x86_lzcnt());
+	set_feature(features, cpuinfo_isa_feature_x86_popcnt, cpuinfo_has_x86_popcnt());
+	set_feature(features, cpuinfo_isa_feature_x86_tbm, cpuinfo_has_x86_tbm());
+	set_feature(features, cpuinfo_isa_feature_x86_bmi, cpuinfo_has_x86_bmi());
+	set_feature(features, cpuinfo_isa_feature_x86_bmi2, cpuinfo_has_x86_bmi2());
+	set_feature(features, cpuinfo_isa_feature_x86_adx, cpuinfo_has_x86_adx());
+	set_feature(features, cpuinfo_isa_feature_x86_aes, cpuinfo_has_x86_aes());
+	set_feature(features, cpuinfo_isa_feature_x86_vaes, cpuinfo_has_x86_vaes());
+	set_feature(features, cpuinfo_isa_feature_x86_pclmulqdq, cpuinfo_has_x86_pclmulqdq());
+	set_feature(features, cpuinfo_isa_feature_x86_vpclmulqdq, cpuinfo_has_x86_vpclmulqdq());
+	set_feature(features, cpuinfo_isa_feature_x86_gfni, cpuinfo_has_x86_gfni());
+	set_feature(features, cpuinfo_isa_feature_x86_rdrand, cpuinfo_has_x86_rdrand());
+	set_feature(features, cpuinfo_isa_feature_x86_rdseed, cpuinfo_has_x86_rdseed());
+	set_feature(features, cpuinfo_isa_feature_x86_sha, cpuinfo_has_x86_sha());
+	set_feature(features, cpuinfo_isa_feature_x86_avxvnni, cpuinfo_has_x86_avxvnni());
+	set_feature(features, cpuinfo_isa_feature_x86_avxvnniint8, cpuinfo_has_x86_avxvnniint8());
+	set_feature(features, cpuinfo_isa_feature_x86_avxvnniint16, cpuinfo_has_x86_avxvnniint16());
+	set_feature(features, cpuinfo_isa_feature_x86_avxifma, cpuinfo_has_x86_avxifma());
+	set_feature(features, cpuinfo_isa_feature_x86_avxneconvert, cpuinfo_has_x86_avxneconvert());
+	set_feature(features, cpuinfo_isa_feature_x86_waitpkg, cpuinfo_has_x86_waitpkg());
+	set_feature(features, cpuinfo_isa_feature_x86_cldemote, cpuinfo_has_x86_cldemote());
+	set_feature(features, cpuinfo_isa_feature_x86_movdiri, cpuinfo_has_x86_movdiri());
+	set_feature(features, cpuinfo_isa_feature_x86_movdir64b, cpuinfo_has_x86_movdir64b());
+	set_feature(features, cpuinfo_isa_feature_x86_enqcmd, cpuinfo_has_x86_enqcmd());
+	set_feature(features, cpuinfo_isa_feature_x86_serialize, cpuinfo_has_x86_serialize());
+	set_feature(features, cpuinfo_isa_feature_x86_hreset, cpuinfo_has_x86_hreset());
+	set_feature(features, cpuinfo_isa_feature_x86_uintr, cpuinfo_has_x86_uintr());
+	set_feature(features, cpuinfo_isa_feature_arm_thumb, cpuinfo_has_arm_thumb());
+	set_feature(features, cpuinfo_isa_feature_arm_thumb2, cpuinfo_has_arm_thumb2());
+	set_feature(features, cpuinfo_isa_feature_arm_v5e, cpuinfo_has_arm_v5e());
+	set_feature(features, cpuinfo_isa_feature_arm_v6, cpuinfo_has_arm_v6());
+	set_feature(features, cpuinfo_isa_feature_arm_v6k, cpuinfo_has_arm_v6k());
+	set_feature(features, cpuinfo_isa_feature_arm_v7, cpuinfo_has_arm_v7());
+	set_feature(features, cpuinfo_isa_feature_arm_v7mp, cpuinfo_has_arm_v7mp());
+	set_feature(features, cpuinfo_isa_feature_arm_v8, cpuinfo_has_arm_v8());
+	set_feature(features, cpuinfo_isa_feature_arm_idiv, cpuinfo_has_arm_idiv());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv2, cpuinfo_has_arm_vfpv2());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv3, cpuinfo_has_arm_vfpv3());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv3_d32, cpuinfo_has_arm_vfpv3_d32());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv3_fp16, cpuinfo_has_arm_vfpv3_fp16());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv3_fp16_d32, cpuinfo_has_arm_vfpv3_fp16_d32());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv4, cpuinfo_has_arm_vfpv4());
+	set_feature(features, cpuinfo_isa_feature_arm_vfpv4_d32, cpuinfo_has_arm_vfpv4_d32());
+	set_feature(features, cpuinfo_isa_feature_arm_fp16_arith, cpuinfo_has_arm_fp16_arith());
+	set_feature(features, cpuinfo_isa_feature_arm_bf16, cpuinfo_has_arm_bf16());
+	set_feature(features, cpuinfo_isa_feature_arm_wmmx, cpuinfo_has_arm_wmmx());
+	set_feature(features, cpuinfo_isa_feature_arm_wmmx2, cpuinfo_has_arm_wmmx2());
+	set_feature(features, cpuinfo_isa_feature_arm_neon, cpuinfo_has_arm_neon());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_fp16, cpuinfo_has_arm_neon_fp16());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_fma, cpuinfo_has_arm_neon_fma());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_v8, cpuinfo_has_arm_neon_v8());
+	set_feature(features, cpuinfo_isa_feature_arm_atomics, cpuinfo_has_arm_atomics());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_rdm, cpuinfo_has_arm_neon_rdm());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_fp16_arith, cpuinfo_has_arm_neon_fp16_arith());
+	set_feature(features, cpuinfo_isa_feature_arm_fhm, cpuinfo_has_arm_fhm());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_dot, cpuinfo_has_arm_neon_dot());
+	set_feature(features, cpuinfo_isa_feature_arm_neon_bf16, cpuinfo_has_arm_neon_bf16());
+	set_feature(features, cpuinfo_isa_feature_arm_jscvt, cpuinfo_has_arm_jscvt());
+	set_feature(features, cpuinfo_isa_feature_arm_fcma, cpuinfo_has_arm_fcma());
+	set_feature(features, cpuinfo_isa_feature_arm_i8mm, cpuinfo_has_arm_i8mm());
+	set_feature(features, cpuinfo_isa_feature_arm_aes, cpuinfo_has_arm_aes());
+	set_feature(features, cpuinfo_isa_feature_arm_sha1, cpuinfo_has_arm_sha1());
+	set_feature(features, cpuinfo_isa_feature_arm_sha2, cpuinfo_has_arm_sha2());
+	set_feature(features, cpuinfo_isa_feature_arm_pmull, cpuinfo_has_arm_pmull());
+	set_feature(features, cpuinfo_isa_feature_arm_crc32, cpuinfo_has_arm_crc32());
+	set_feature(features, cpuinfo_isa_feature_arm_sve, cpuinfo_has_arm_sve());
+	set_feature(features, cpuinfo_isa_feature_arm_sve_bf16, cpuinfo_has_arm_sve_bf16());
+	set_feature(features, cpuinfo_isa_feature_arm_sve2, cpuinfo_has_arm_sve2());
+	set_feature(features, cpuinfo_isa_feature_arm_sme, cpuinfo_has_arm_sme());
+	set_feature(features, cpuinfo_isa_feature_arm_sme2, cpuinfo_has_arm_sme2());
+	set_feature(features, cpuinfo_isa_feature_arm_sme_f64f64, cpuinfo_has_arm_sme_f64f64());
+	set_feature(features, cpuinfo_isa_feature_arm_sme_i16i64, cpuinfo_has_arm_sme_i16i64());
+	set_feature(features, cpuinfo_isa_feature_arm_sme_fa64, cpuinfo_has_arm_sme_fa64());
+	set_feature(features, cpuinfo_isa_feature_arm_lse2, cpuinfo_has_arm_lse2());
+	set_feature(features, cpuinfo_isa_feature_arm_lse128, cpuinfo_has_arm_lse128());
+	set_feature(features, cpuinfo_isa_feature_arm_rcpc, cpuinfo_has_arm_rcpc());
+	set_feature(features, cpuinfo_isa_feature_arm_rcpc2, cpuinfo_has_arm_rcpc2());
+	set_feature(features, cpuinfo_isa_feature_arm_rcpc3, cpuinfo_has_arm_rcpc3());
+	set_feature(features, cpuinfo_isa_feature_arm_wfxt, cpuinfo_has_arm_wfxt());
+	set_feature(features, cpuinfo_isa_feature_arm_sha3, cpuinfo_has_arm_sha3());
+	set_feature(features, cpuinfo_isa_feature_arm_sha512, cpuinfo_has_arm_sha512());
+	set_feature(features, cpuinfo_isa_feature_arm_sm3, cpuinfo_has_arm_sm3());
+	set_feature(features, cpuinfo_isa_feature_arm_sm4, cpuinfo_has_arm_sm4());
+	set_feature(features, cpuinfo_isa_feature_arm_rng, cpuinfo_has_arm_rng());
+	set_feature(features, cpuinfo_isa_feature_arm_mte, cpuinfo_has_arm_mte());
+	set_feature(features, cpuinfo_isa_feature_arm_mte2, cpuinfo_has_arm_mte2());
+	set_feature(features, cpuinfo_isa_feature_arm_mte3, cpuinfo_has_arm_mte3());
+	set_feature(features, cpuinfo_isa_feature_arm_pauth, cpuinfo_has_arm_pauth());
+	set_feature(features, cpuinfo_isa_feature_arm_bti, cpuinfo_has_arm_bti());
+
+	uint64_t fingerprint = FNV_OFFSET_BASIS;
+	for (uint32_t i = 0; i < CPUINFO_ISA_FEATURE_WORDS; i++) {
+		fingerprint = hash_word(fingerprint, features->words[i]);
+	}
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		fingerprint = hash_word(fingerprint,
+			((uint64_t) cpuinfo_get_x86_avx10_version() << 32) | cpuinfo_get_x86_avx10_max_vector_bits());
+	#endif
+	tables->isa_fingerprint = fingerprint;
+	cpuinfo_log_debug("ISA fingerprint 0x%016"PRIx64, fingerprint);
+}
+
+const struct cpuinfo_isa_features* CPUINFO_ABI cpuinfo_get_isa_features(void) {
+	return &cpuinfo_get_tables("isa_features")->isa_features;
+}
+
+bool CPUINFO_ABI cpuinfo_has_isa_features(const struct cpuinfo_isa_features* required) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("has_isa_features");
+	if CPUINFO_UNLIKELY(required == NULL) {
+		return false;
+	}
+	return cpuinfo_isa_features_include(&tables->isa_features, required);
+}
+
+uint64_t CPUINFO_ABI cpuinfo_isa_fingerprint(void) {
+	return cpuinfo_get_tables("isa_fingerprint")->isa_fingerprint;
+}
+
+bool CPUINFO_ABI cpuinfo_get_uarch_isa_features(uint32_t uarch_index, struct cpuinfo_isa_features* features) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_isa_features");
+	if CPUINFO_UNLIKELY(features == NULL) {
+		return false;
+	}
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if (processor == NULL) {
+		cpuinfo_log_debug("no processors with microarchitecture %"PRIu32" for ISA features", uarch_index);
+		return false;
+	}
+
+	*features = tables->isa_features;
+	#if (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+		/* Linux reports only features common to all cores in hwcaps: add the ones known from MIDR */
+		cpuinfo_arm_add_uarch_isa_features(processor->core->uarch, features);
+	#endif
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_has_uarch_isa_feature(uint32_t uarch_index, enum cpuinfo_isa_feature feature) {
+	struct cpuinfo_isa_features features;
+	if CPUINFO_UNLIKELY((uint32_t) feature >= (uint32_t) cpuinfo_isa_feature_max) {
+		return false;
+	}
+	return cpuinfo_get_uarch_isa_features(uarch_index, &features) && cpuinfo_isa_features_contain(&features, feature);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cpuinfo/common.h>
+
+#define CPUINFO_FREEBSD_MAX_CACHE_LEVELS 4
+/* Frequency levels beyond this limit are ignored */
+#define CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS 64
+
+
+struct cpuinfo_freebsd_topology {
+	uint32_t packages;
+	uint32_t cores;
+	uint32_t threads;
+	/* Number of logical processors sharing a cache of each level, or 0 if no topology group shares it */
+	uint32_t threads_per_cache[CPUINFO_FREEBSD_MAX_CACHE_LEVELS + 1];
+};
+
+
+/*
+ * Detect the topology from the kern.sched.topology_spec sysctl. FreeBSD numbers processors of a core, a cache, and a
+ * package consecutively, so the topology is described by the number of processors in each first group.
+ */
+CPUINFO_INTERNAL struct cpuinfo_freebsd_topology cpuinfo_freebsd_detect_topology(void);
+
+/*
+ * Read frequencies in Hz from the dev.cpu.N.freq_levels sysctl, which lists them in decreasing order.
+ * Returns the number of frequencies, or 0 if the processor has no cpufreq driver.
+ */
+CPUINFO_INTERNAL uint32_t cpuinfo_freebsd_get_frequency_levels(uint32_t cpu,
+	uint64_t frequencies[restrict static CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS]);
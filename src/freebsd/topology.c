@@ -0,0 +1,178 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <sys/types.h>
+#include <sys/sysctl.h>
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+#include <freebsd/api.h>
+
+/* Topology groups nest as system, package or NUMA domain, last-level cache, L2 cache, and core */
+#define MAX_GROUP_DEPTH 16
+
+
+static uint32_t get_sysctl_uint32(const char* name) {
+	int value = 0;
+	size_t size = sizeof(value);
+	if (sysctlbyname(name, &value, &size, NULL, 0) != 0) {
+		cpuinfo_log_info("sysctlbyname(\"%s\") failed: %s", name, strerror(errno));
+		return 0;
+	}
+	return value > 0 ? (uint32_t) value : 0;
+}
+
+/* Parse the value of a numeric XML attribute within the tag which starts at tag and ends before tag_end */
+static uint32_t parse_attribute(const char* tag, const char* tag_end, const char* attribute) {
+	const size_t attribute_length = strlen(attribute);
+	for (const char* position = tag; position + attribute_length + 2 < tag_end; position++) {
+		if (memcmp(position, attribute, attribute_length) == 0 && position[attribute_length] == '=' &&
+			position[attribute_length + 1] == '"')
+		{
+			return (uint32_t) strtoul(position + attribute_length + 2, NULL, 10);
+		}
+	}
+	return 0;
+}
+
+/*
+ * Parse the XML of kern.sched.topology_spec, e.g.
+ *   <groups>
+ *    <group level="1" cache-level="3">
+ *     <cpu count="8" mask="ff,0,0,0">0, 1, 2, 3, 4, 5, 6, 7</cpu>
+ *     <children>
+ *      <group level="2" cache-level="2">
+ *       <cpu count="2" mask="3,0,0,0">0, 1</cpu>
+ *       <flags><flag name="THREAD">THREAD group</flag><flag name="SMT">SMT group</flag></flags>
+ *      </group>
+ *      ...
+ * where cache-level is the level of the cache shared by processors of the group, or 0 if they don't share a cache.
+ */
+static void parse_topology_spec(const char* spec, struct cpuinfo_freebsd_topology topology[restrict static 1]) {
+	uint32_t group_counts[MAX_GROUP_DEPTH] = { 0 };
+	uint32_t group_cache_levels[MAX_GROUP_DEPTH] = { 0 };
+	uint32_t depth = 0, threads_per_core = 0, second_level_groups = 0;
+	for (const char* tag = strchr(spec, '<'); tag != NULL; tag = strchr(tag + 1, '<')) {
+		const char* tag_end = strchr(tag, '>');
+		if (tag_end == NULL) {
+			break;
+		}
+		if (strncmp(tag, "<group ", strlen("<group ")) == 0) {
+			depth += 1;
+			if (depth < MAX_GROUP_DEPTH) {
+				group_cache_levels[depth] = parse_attribute(tag, tag_end, "cache-level");
+				group_counts[depth] = 0;
+			}
+			if (depth == 2) {
+				second_level_groups += 1;
+			}
+		} else if (strncmp(tag, "</group>", strlen("</group>")) == 0) {
+			if (depth != 0) {
+				depth -= 1;
+			}
+		} else if (strncmp(tag, "<cpu ", strlen("<cpu ")) == 0 && depth != 0 && depth < MAX_GROUP_DEPTH) {
+			const uint32_t count = parse_attribute(tag, tag_end, "count");
+			group_counts[depth] = count;
+			if (depth == 1) {
+				topology->threads = count;
+			}
+			const uint32_t cache_level = group_cache_levels[depth];
+			if (cache_level != 0 && cache_level <= CPUINFO_FREEBSD_MAX_CACHE_LEVELS &&
+				topology->threads_per_cache[cache_level] == 0)
+			{
+				topology->threads_per_cache[cache_level] = count;
+			}
+		} else if ((strncmp(tag, "<flag name=\"THREAD\"", strlen("<flag name=\"THREAD\"")) == 0 ||
+			strncmp(tag, "<flag name=\"SMT\"", strlen("<flag name=\"SMT\"")) == 0) &&
+			depth != 0 && depth < MAX_GROUP_DEPTH && threads_per_core == 0)
+		{
+			threads_per_core = group_counts[depth];
+		}
+	}
+
+	if (threads_per_core != 0 && topology->threads % threads_per_core == 0) {
+		topology->cores = topology->threads / threads_per_core;
+	}
+	/* The kernel adds groups of packages without a shared cache only on systems with several packages */
+	if (group_cache_levels[1] == 0 && second_level_groups > 1 && topology->threads % second_level_groups == 0) {
+		topology->packages = second_level_groups;
+	}
+}
+
+struct cpuinfo_freebsd_topology cpuinfo_freebsd_detect_topology(void) {
+	struct cpuinfo_freebsd_topology topology = { 0 };
+	size_t spec_size = 0;
+	if (sysctlbyname("kern.sched.topology_spec", NULL, &spec_size, NULL, 0) != 0) {
+		cpuinfo_log_error("sysctlbyname(\"kern.sched.topology_spec\") failed: %s", strerror(errno));
+	} else {
+		char* spec = cpuinfo_allocate_temporary(spec_size + 1, sizeof(char));
+		if (spec == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for kern.sched.topology_spec", spec_size + 1);
+		} else {
+			if (sysctlbyname("kern.sched.topology_spec", spec, &spec_size, NULL, 0) != 0) {
+				cpuinfo_log_error("sysctlbyname(\"kern.sched.topology_spec\") failed: %s", strerror(errno));
+			} else {
+				spec[spec_size] = '\0';
+				parse_topology_spec(spec, &topology);
+			}
+			cpuinfo_free_temporary(spec);
+		}
+	}
+
+	/* Processors of the topology are the ones the scheduler knows about; kern.smp.cpus counts them too */
+	if (topology.threads == 0) {
+		topology.threads = get_sysctl_uint32("kern.smp.cpus");
+		if (topology.threads == 0) {
+			topology.threads = 1;
+		}
+	}
+	if (topology.cores == 0) {
+		const uint32_t threads_per_core = get_sysctl_uint32("kern.smp.threads_per_core");
+		topology.cores = threads_per_core != 0 && topology.threads % threads_per_core == 0 ?
+			topology.threads / threads_per_core : topology.threads;
+	}
+	if (topology.packages == 0 || topology.cores % topology.packages != 0) {
+		topology.packages = 1;
+	}
+	cpuinfo_log_debug("freebsd topology: packages = %"PRIu32", cores = %"PRIu32", threads = %"PRIu32,
+		topology.packages, topology.cores, topology.threads);
+	return topology;
+}
+
+uint32_t cpuinfo_freebsd_get_frequency_levels(uint32_t cpu,
+	uint64_t frequencies[restrict static CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS])
+{
+	char name[32];
+	snprintf(name, sizeof(name), "dev.cpu.%"PRIu32".freq_levels", cpu);
+	/* Space-separated levels as frequency in MHz and power in mW, e.g. "2401/35000 2400/35000 2200/31500" */
+	char levels[CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS * 16];
+	size_t levels_size = sizeof(levels) - 1;
+	if (sysctlbyname(name, levels, &levels_size, NULL, 0) != 0 && errno != ENOMEM) {
+		cpuinfo_log_debug("sysctlbyname(\"%s\") failed: %s", name, strerror(errno));
+		return 0;
+	}
+	levels[levels_size < sizeof(levels) ? levels_size : sizeof(levels) - 1] = '\0';
+
+	uint32_t levels_count = 0;
+	for (const char* level = levels; *level != '\0' && levels_count < CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS; ) {
+		char* level_end;
+		const unsigned long frequency = strtoul(level, &level_end, 10);
+		if (level_end == level) {
+			break;
+		}
+		if (frequency != 0) {
+			frequencies[levels_count++] = (uint64_t) frequency * UINT64_C(1000000);
+		}
+		/* Skip the power of the level */
+		level = strchr(level_end, ' ');
+		if (level == NULL) {
+			break;
+		}
+		level += 1;
+	}
+	return levels_count;
+}
@@ -0,0 +1,768 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <unistd.h>
+
+	#include <linux/api.h>
+#elif defined(__FreeBSD__)
+	#include <freebsd/api.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	/* Names of per-processor files, relative to /sys/devices/system/cpu/cpuN */
+	#define RELATED_CPUS_FILENAME "cpufreq/related_cpus"
+	#define AVAILABLE_FREQUENCIES_FILENAME "cpufreq/scaling_available_frequencies"
+	#define GOVERNOR_FILENAME "cpufreq/scaling_governor"
+	#define POLICY_BOOST_FILENAME "cpufreq/boost"
+	/* Boost switches of acpi-cpufreq and amd-pstate, and turbo switch of intel_pstate, for all policies */
+	#define GLOBAL_BOOST_FILENAME "/sys/devices/system/cpu/cpufreq/boost"
+	#define INTEL_PSTATE_NO_TURBO_FILENAME "/sys/devices/system/cpu/intel_pstate/no_turbo"
+	#define SCALING_MIN_FREQUENCY_FILENAME "cpufreq/scaling_min_freq"
+	#define SCALING_MAX_FREQUENCY_FILENAME "cpufreq/scaling_max_freq"
+	#define SCALING_DRIVER_FILENAME "cpufreq/scaling_driver"
+	#define ENERGY_PREFERENCE_FILENAME "cpufreq/energy_performance_preference"
+	#define AVAILABLE_ENERGY_PREFERENCES_FILENAME "cpufreq/energy_performance_available_preferences"
+	#define ENERGY_PREFERENCE_FILESIZE 32
+	/* Size of the absolute path of the energy-performance preference file of a processor with a 32-bit ID */
+	#define ENERGY_PREFERENCE_PATH_SIZE \
+		(sizeof("/sys/devices/system/cpu/cpu") + 10 + sizeof("/" ENERGY_PREFERENCE_FILENAME))
+	#define AVAILABLE_ENERGY_PREFERENCES_FILESIZE 128
+	#define FREQUENCY_FILESIZE 32
+	#define BOOST_FILESIZE 16
+	#define GOVERNOR_FILESIZE 32
+	#define AVAILABLE_FREQUENCIES_FILESIZE 4096
+	/* Value for processors which are not assigned to a frequency domain yet */
+	#define UNASSIGNED_DOMAIN UINT32_MAX
+#endif
+
+struct frequency_builder {
+	struct cpuinfo_tables* tables;
+	struct cpuinfo_frequency_domain* domains;
+	uint64_t* frequencies;
+	/* Index of the frequency domain for every logical processor */
+	uint32_t* processor_domains;
+	uint32_t domains_count;
+	uint32_t frequencies_count;
+};
+
+#if defined(__linux__)
+	struct related_cpus_context {
+		struct frequency_builder* builder;
+		uint32_t domain_index;
+		uint32_t domain_id;
+	};
+
+	static bool assign_related_processors(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+		struct related_cpus_context* related_context = (struct related_cpus_context*) context;
+		struct frequency_builder* builder = related_context->builder;
+		const struct cpuinfo_tables* tables = builder->tables;
+		if (cpu_end > tables->linux_cpu_max) {
+			cpu_end = tables->linux_cpu_max;
+		}
+		for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+			const struct cpuinfo_processor* processor = tables->linux_cpu_to_processor_map[cpu];
+			if (processor != NULL) {
+				const uint32_t processor_index = (uint32_t) (processor - tables->processors);
+				if (builder->processor_domains[processor_index] == UNASSIGNED_DOMAIN) {
+					builder->processor_domains[processor_index] = related_context->domain_index;
+				}
+			}
+			if (cpu < related_context->domain_id) {
+				related_context->domain_id = cpu;
+			}
+		}
+		return true;
+	}
+
+	/* Parse space-separated frequencies in KHz; count them if frequencies is NULL */
+	struct frequencies_context {
+		uint64_t* frequencies;
+		uint32_t frequencies_max;
+		uint32_t frequencies_count;
+	};
+
+	static bool parse_available_frequencies(const char* text_start, const char* text_end, void* context) {
+		struct frequencies_context* frequencies_context = (struct frequencies_context*) context;
+		const char* text = text_start;
+		while (text != text_end) {
+			if (*text < '0' || *text > '9') {
+				text++;
+				continue;
+			}
+			uint64_t frequency = 0;
+			for (; text != text_end && *text >= '0' && *text <= '9'; text++) {
+				frequency = frequency * 10 + (uint64_t) (*text - '0');
+			}
+			if (frequencies_context->frequencies != NULL) {
+				if (frequencies_context->frequencies_count == frequencies_context->frequencies_max) {
+					/* The list can only grow between the passes if the driver changes it concurrently */
+					break;
+				}
+				frequencies_context->frequencies[frequencies_context->frequencies_count] = frequency * UINT64_C(1000);
+			}
+			frequencies_context->frequencies_count += 1;
+		}
+		return true;
+	}
+
+	static bool parse_governor(const char* text_start, const char* text_end, void* context) {
+		char* governor = (char*) context;
+		size_t length = 0;
+		while (text_start + length != text_end && length < CPUINFO_GOVERNOR_NAME_MAX - 1 &&
+			text_start[length] != '\n' && text_start[length] != ' ')
+		{
+			length++;
+		}
+		memcpy(governor, text_start, length);
+		governor[length] = '\0';
+		return true;
+	}
+
+	/* Names of energy-performance preferences in sysfs, indexed by cpuinfo_energy_performance_preference */
+	static const char* const energy_preference_names[] = {
+		[cpuinfo_energy_performance_preference_default] = "default",
+		[cpuinfo_energy_performance_preference_performance] = "performance",
+		[cpuinfo_energy_performance_preference_balance_performance] = "balance_performance",
+		[cpuinfo_energy_performance_preference_balance_power] = "balance_power",
+		[cpuinfo_energy_performance_preference_power] = "power",
+	};
+
+	static enum cpuinfo_energy_performance_preference get_energy_preference(const char* name_start,
+		const char* name_end)
+	{
+		const size_t length = (size_t) (name_end - name_start);
+		for (uint32_t i = 0; i < CPUINFO_COUNT_OF(energy_preference_names); i++) {
+			const char* name = energy_preference_names[i];
+			if (name != NULL && strlen(name) == length && memcmp(name, name_start, length) == 0) {
+				return (enum cpuinfo_energy_performance_preference) i;
+			}
+		}
+		return cpuinfo_energy_performance_preference_custom;
+	}
+
+	/* The preference is a name, or a number if intel_pstate has a raw value which matches no name */
+	static bool parse_energy_preference(const char* text_start, const char* text_end, void* context) {
+		while (text_end != text_start && (text_end[-1] == '\n' || text_end[-1] == ' ')) {
+			text_end--;
+		}
+		if (text_start == text_end) {
+			return false;
+		}
+		*((enum cpuinfo_energy_performance_preference*) context) = get_energy_preference(text_start, text_end);
+		return true;
+	}
+
+	/* Available preferences are space-separated names */
+	static bool parse_available_energy_preferences(const char* text_start, const char* text_end, void* context) {
+		uint32_t* preferences = (uint32_t*) context;
+		const char* name_start = text_start;
+		while (name_start != text_end) {
+			const char* name_end = name_start;
+			while (name_end != text_end && *name_end != ' ' && *name_end != '\n') {
+				name_end++;
+			}
+			if (name_end != name_start) {
+				const enum cpuinfo_energy_performance_preference preference =
+					get_energy_preference(name_start, name_end);
+				if (preference != cpuinfo_energy_performance_preference_custom) {
+					*preferences |= UINT32_C(1) << preference;
+				}
+			}
+			name_start = name_end == text_end ? name_end : name_end + 1;
+		}
+		return true;
+	}
+
+	static bool parse_flag(const char* text_start, const char* text_end, void* context) {
+		if (text_start == text_end || (*text_start != '0' && *text_start != '1')) {
+			return false;
+		}
+		*((bool*) context) = *text_start == '1';
+		return true;
+	}
+
+	static bool parse_frequency(const char* text_start, const char* text_end, void* context) {
+		uint64_t frequency = 0;
+		const char* text = text_start;
+		for (; text != text_end && *text >= '0' && *text <= '9'; text++) {
+			frequency = frequency * 10 + (uint64_t) (*text - '0');
+		}
+		if (text == text_start) {
+			return false;
+		}
+		/* Frequencies are in KHz */
+		*((uint64_t*) context) = frequency * UINT64_C(1000);
+		return true;
+	}
+
+	/* acpi-cpufreq and amd-pstate report boost for all policies, intel_pstate reports disabled turbo instead */
+	static bool get_global_boost(void) {
+		bool global_boost = false, no_turbo = false;
+		if (!cpuinfo_linux_parse_small_file(GLOBAL_BOOST_FILENAME, BOOST_FILESIZE, parse_flag, &global_boost) &&
+			cpuinfo_linux_parse_small_file(INTEL_PSTATE_NO_TURBO_FILENAME, BOOST_FILESIZE, parse_flag, &no_turbo))
+		{
+			global_boost = !no_turbo;
+		}
+		return global_boost;
+	}
+
+	static uint32_t get_available_frequencies(uint32_t processor, uint64_t* frequencies, uint32_t frequencies_max) {
+		struct frequencies_context context = {
+			.frequencies = frequencies,
+			.frequencies_max = frequencies_max,
+		};
+		if (!cpuinfo_linux_parse_processor_small_file(processor, AVAILABLE_FREQUENCIES_FILENAME,
+				AVAILABLE_FREQUENCIES_FILESIZE, parse_available_frequencies, &context))
+		{
+			return 0;
+		}
+		return context.frequencies_count;
+	}
+
+	static int compare_frequencies(const void* a_ptr, const void* b_ptr) {
+		const uint64_t a = *((const uint64_t*) a_ptr);
+		const uint64_t b = *((const uint64_t*) b_ptr);
+		return (a > b) - (a < b);
+	}
+
+	/*
+	 * Assign logical processors to domains of their cpufreq policies, and count domains and available frequencies.
+	 * Logical processors without a cpufreq policy share a single domain.
+	 */
+	static uint32_t count_domains(struct frequency_builder builder[restrict static 1]) {
+		const struct cpuinfo_tables* tables = builder->tables;
+		uint32_t domains_count = 0, frequencies_count = 0;
+		uint32_t unknown_domain = UNASSIGNED_DOMAIN;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			if (builder->processor_domains[i] != UNASSIGNED_DOMAIN) {
+				continue;
+			}
+			const uint32_t linux_id = (uint32_t) tables->processors[i].linux_id;
+			struct related_cpus_context context = {
+				.builder = builder,
+				.domain_index = domains_count,
+				.domain_id = UINT32_MAX,
+			};
+			if (cpuinfo_linux_parse_processor_cpulist(linux_id, RELATED_CPUS_FILENAME,
+					assign_related_processors, &context) &&
+				builder->processor_domains[i] != UNASSIGNED_DOMAIN)
+			{
+				frequencies_count += get_available_frequencies(linux_id, NULL, 0);
+				domains_count += 1;
+			} else {
+				if (unknown_domain == UNASSIGNED_DOMAIN) {
+					unknown_domain = domains_count++;
+				}
+				builder->processor_domains[i] = unknown_domain;
+			}
+		}
+		builder->frequencies_count = frequencies_count;
+		return domains_count;
+	}
+
+	static void detect_domains(struct frequency_builder builder[restrict static 1]) {
+		const struct cpuinfo_tables* tables = builder->tables;
+
+		const bool global_boost = get_global_boost();
+
+		uint32_t frequencies_offset = 0;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			struct cpuinfo_frequency_domain* domain = &builder->domains[builder->processor_domains[i]];
+			if (domain->processor_count != 0) {
+				continue;
+			}
+			/* Mark the domain as detected; processor ranges are computed for all domains later */
+			domain->processor_count = 1;
+
+			const uint32_t linux_id = (uint32_t) tables->processors[i].linux_id;
+			struct related_cpus_context context = {
+				.builder = builder,
+				.domain_index = builder->processor_domains[i],
+				.domain_id = UINT32_MAX,
+			};
+			if (!cpuinfo_linux_parse_processor_cpulist(linux_id, RELATED_CPUS_FILENAME,
+					assign_related_processors, &context) || context.domain_id == UINT32_MAX)
+			{
+				/* Domain of logical processors without a cpufreq policy */
+				domain->domain_id = UINT32_MAX;
+				continue;
+			}
+			domain->domain_id = context.domain_id;
+			domain->min_frequency = (uint64_t) cpuinfo_linux_get_processor_min_frequency(linux_id) * UINT64_C(1000);
+			domain->max_frequency = (uint64_t) cpuinfo_linux_get_processor_max_frequency(linux_id) * UINT64_C(1000);
+
+			const uint32_t frequencies_max = builder->frequencies_count - frequencies_offset;
+			const uint32_t frequencies_count = get_available_frequencies(linux_id,
+				builder->frequencies + frequencies_offset, frequencies_max);
+			if (frequencies_count != 0 && frequencies_max != 0) {
+				domain->frequencies = builder->frequencies + frequencies_offset;
+				domain->frequencies_count = frequencies_count < frequencies_max ? frequencies_count : frequencies_max;
+				qsort(builder->frequencies + frequencies_offset, domain->frequencies_count, sizeof(uint64_t),
+					compare_frequencies);
+				frequencies_offset += domain->frequencies_count;
+			}
+
+			cpuinfo_linux_parse_processor_small_file(linux_id, GOVERNOR_FILENAME, GOVERNOR_FILESIZE,
+				parse_governor, domain->governor);
+			domain->boost = global_boost;
+			cpuinfo_linux_parse_processor_small_file(linux_id, POLICY_BOOST_FILENAME, BOOST_FILESIZE,
+				parse_flag, &domain->boost);
+			cpuinfo_linux_parse_processor_small_file(linux_id, SCALING_DRIVER_FILENAME, GOVERNOR_FILESIZE,
+				parse_governor, domain->driver);
+			/* Only drivers with hardware-controlled P-states have the preference files */
+			if (cpuinfo_linux_parse_processor_small_file(linux_id, ENERGY_PREFERENCE_FILENAME,
+					ENERGY_PREFERENCE_FILESIZE, parse_energy_preference, &domain->energy_performance_preference))
+			{
+				cpuinfo_linux_parse_processor_small_file(linux_id, AVAILABLE_ENERGY_PREFERENCES_FILENAME,
+					AVAILABLE_ENERGY_PREFERENCES_FILESIZE, parse_available_energy_preferences,
+					&domain->energy_performance_preferences);
+			}
+		}
+		/* Attributes were read after initialization released the cached sysfs directories */
+		cpuinfo_linux_release_sysfs();
+	}
+#elif defined(__FreeBSD__)
+	/* cpufreq of FreeBSD attaches to the first processor and changes the frequency of all processors together */
+	static uint32_t count_domains(struct frequency_builder builder[restrict static 1]) {
+		uint64_t frequencies[CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS];
+		builder->frequencies_count = cpuinfo_freebsd_get_frequency_levels(0, frequencies);
+		if (builder->frequencies_count == 0) {
+			return 0;
+		}
+		for (uint32_t i = 0; i < builder->tables->processors_count; i++) {
+			builder->processor_domains[i] = 0;
+		}
+		return 1;
+	}
+
+	static void detect_domains(struct frequency_builder builder[restrict static 1]) {
+		uint64_t frequencies[CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS];
+		uint32_t frequencies_count = cpuinfo_freebsd_get_frequency_levels(0, frequencies);
+		if (frequencies_count > builder->frequencies_count) {
+			frequencies_count = builder->frequencies_count;
+		}
+		struct cpuinfo_frequency_domain* domain = &builder->domains[0];
+		domain->domain_id = 0;
+		/* Levels are listed in decreasing order */
+		for (uint32_t i = 0; i < frequencies_count; i++) {
+			builder->frequencies[i] = frequencies[frequencies_count - 1 - i];
+		}
+		if (frequencies_count != 0) {
+			domain->frequencies = builder->frequencies;
+			domain->frequencies_count = frequencies_count;
+			domain->min_frequency = builder->frequencies[0];
+			domain->max_frequency = builder->frequencies[frequencies_count - 1];
+		}
+	}
+#else
+	static uint32_t count_domains(struct frequency_builder builder[restrict static 1]) {
+		return 0;
+	}
+
+	static void detect_domains(struct frequency_builder builder[restrict static 1]) {
+	}
+#endif
+
+#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+	#define UNCORE_FREQUENCY_DIRNAME "/sys/devices/system/cpu/intel_uncore_frequency"
+	#define UNCORE_FREQUENCY_FILENAME_SIZE \
+		(sizeof(UNCORE_FREQUENCY_DIRNAME "/package_4294967295_die_4294967295/initial_min_freq_khz"))
+	#define UNCORE_FREQUENCY_FILENAME_FORMAT UNCORE_FREQUENCY_DIRNAME "/package_%02"PRIu32"_die_%02"PRIu32"/%s"
+
+	/* Parse a decimal ID after the prefix, and advance past it */
+	static bool parse_uncore_id(const char* name[restrict static 1], const char* prefix,
+		uint32_t id[restrict static 1])
+	{
+		const size_t prefix_length = strlen(prefix);
+		if (strncmp(*name, prefix, prefix_length) != 0) {
+			return false;
+		}
+		const char* digits = *name + prefix_length;
+		uint64_t value = 0;
+		const char* text = digits;
+		for (; *text >= '0' && *text <= '9' && value <= UINT32_MAX; text++) {
+			value = value * 10 + (uint64_t) (*text - '0');
+		}
+		if (text == digits || value > UINT32_MAX) {
+			return false;
+		}
+		*id = (uint32_t) value;
+		*name = text;
+		return true;
+	}
+
+	/*
+	 * Directories of intel_uncore_frequency are named package_XX_die_YY. Directories uncoreXX of the TPMI interface
+	 * of newer processors are not reported.
+	 */
+	struct uncore_scan_context {
+		/* Domains to fill, or NULL to count the domains */
+		struct cpuinfo_uncore_domain* domains;
+		uint32_t domains_max;
+		uint32_t domains_count;
+	};
+
+	static bool add_uncore_domain(const char* name, void* context) {
+		struct uncore_scan_context* scan_context = (struct uncore_scan_context*) context;
+		uint32_t package_id, die_id;
+		if (!parse_uncore_id(&name, "package_", &package_id) || !parse_uncore_id(&name, "_die_", &die_id) ||
+			*name != '\0')
+		{
+			return true;
+		}
+		if (scan_context->domains != NULL) {
+			if (scan_context->domains_count == scan_context->domains_max) {
+				/* The directory can only grow between the scans if dies come online concurrently */
+				return false;
+			}
+			scan_context->domains[scan_context->domains_count] = (struct cpuinfo_uncore_domain) {
+				.package_id = package_id,
+				.die_id = die_id,
+			};
+		}
+		scan_context->domains_count += 1;
+		return true;
+	}
+
+	static uint32_t count_uncore_domains(void) {
+		struct uncore_scan_context context = { .domains = NULL };
+		cpuinfo_linux_scan_directory(UNCORE_FREQUENCY_DIRNAME, add_uncore_domain, &context);
+		return context.domains_count;
+	}
+
+	static void read_uncore_frequency(const struct cpuinfo_uncore_domain domain[restrict static 1], const char* name,
+		uint64_t frequency[restrict static 1])
+	{
+		char filename[UNCORE_FREQUENCY_FILENAME_SIZE];
+		snprintf(filename, sizeof(filename), UNCORE_FREQUENCY_FILENAME_FORMAT, domain->package_id, domain->die_id,
+			name);
+		cpuinfo_linux_parse_small_file(filename, FREQUENCY_FILESIZE, parse_frequency, frequency);
+	}
+
+	/* Domains of packages of the tables come first, in the order of packages, and dies within a package */
+	static int compare_uncore_domains(const void* a_ptr, const void* b_ptr) {
+		const struct cpuinfo_uncore_domain* a = (const struct cpuinfo_uncore_domain*) a_ptr;
+		const struct cpuinfo_uncore_domain* b = (const struct cpuinfo_uncore_domain*) b_ptr;
+		const uintptr_t a_package = a->package != NULL ? (uintptr_t) a->package : UINTPTR_MAX;
+		const uintptr_t b_package = b->package != NULL ? (uintptr_t) b->package : UINTPTR_MAX;
+		if (a_package != b_package) {
+			return (a_package > b_package) - (a_package < b_package);
+		}
+		if (a->package_id != b->package_id) {
+			return (a->package_id > b->package_id) - (a->package_id < b->package_id);
+		}
+		return (a->die_id > b->die_id) - (a->die_id < b->die_id);
+	}
+
+	static uint32_t detect_uncore_domains(const struct cpuinfo_tables* tables, struct cpuinfo_uncore_domain* domains,
+		uint32_t domains_max)
+	{
+		struct uncore_scan_context context = {
+			.domains = domains,
+			.domains_max = domains_max,
+		};
+		cpuinfo_linux_scan_directory(UNCORE_FREQUENCY_DIRNAME, add_uncore_domain, &context);
+
+		for (uint32_t i = 0; i < tables->packages_count; i++) {
+			const struct cpuinfo_package* package = &tables->packages[i];
+			if (package->processor_count == 0 || tables->processors[package->processor_start].linux_id < 0) {
+				continue;
+			}
+			uint32_t package_id;
+			if (!cpuinfo_linux_get_processor_package_id(
+					(uint32_t) tables->processors[package->processor_start].linux_id, &package_id))
+			{
+				continue;
+			}
+			for (uint32_t j = 0; j < context.domains_count; j++) {
+				if (domains[j].package_id == package_id) {
+					domains[j].package = package;
+				}
+			}
+		}
+		for (uint32_t i = 0; i < context.domains_count; i++) {
+			struct cpuinfo_uncore_domain* domain = &domains[i];
+			read_uncore_frequency(domain, "initial_min_freq_khz", &domain->min_frequency);
+			read_uncore_frequency(domain, "initial_max_freq_khz", &domain->max_frequency);
+			read_uncore_frequency(domain, "min_freq_khz", &domain->limit_min_frequency);
+			read_uncore_frequency(domain, "max_freq_khz", &domain->limit_max_frequency);
+		}
+		qsort(domains, context.domains_count, sizeof(struct cpuinfo_uncore_domain), compare_uncore_domains);
+		cpuinfo_log_debug("detected %"PRIu32" uncore frequency domains", context.domains_count);
+		return context.domains_count;
+	}
+#else
+	static uint32_t count_uncore_domains(void) {
+		return 0;
+	}
+
+	static uint32_t detect_uncore_domains(const struct cpuinfo_tables* tables, struct cpuinfo_uncore_domain* domains,
+		uint32_t domains_max)
+	{
+		return 0;
+	}
+#endif
+
+bool cpuinfo_build_frequency_domains(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		tables->processors[i].frequency_domain = NULL;
+	}
+
+	struct frequency_builder builder = { .tables = tables };
+	uint32_t domains_count = 0;
+	if (processors_count != 0) {
+		builder.processor_domains = cpuinfo_allocate_temporary(processors_count, sizeof(uint32_t));
+		if (builder.processor_domains == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for frequency domains of %"PRIu32" logical processors",
+				processors_count * sizeof(uint32_t), processors_count);
+			return false;
+		}
+		for (uint32_t i = 0; i < processors_count; i++) {
+			builder.processor_domains[i] = UINT32_MAX;
+		}
+		if (!cpuinfo_replaying_capture) {
+			domains_count = count_domains(&builder);
+		}
+	}
+
+	/* If the OS doesn't report frequency domains, all logical processors belong to a single domain */
+	const bool detected = domains_count != 0;
+	if (!detected) {
+		domains_count = 1;
+		builder.frequencies_count = 0;
+		for (uint32_t i = 0; i < processors_count; i++) {
+			builder.processor_domains[i] = 0;
+		}
+	}
+
+	const uint32_t uncore_domains_max = cpuinfo_replaying_capture ? 0 : count_uncore_domains();
+
+	struct cpuinfo_arena arena = { 0 };
+	const size_t domains_offset =
+		cpuinfo_arena_reserve(&arena, domains_count, sizeof(struct cpuinfo_frequency_domain));
+	const size_t frequencies_offset = cpuinfo_arena_reserve(&arena, builder.frequencies_count, sizeof(uint64_t));
+	const size_t uncore_domains_offset =
+		cpuinfo_arena_reserve(&arena, uncore_domains_max, sizeof(struct cpuinfo_uncore_domain));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		cpuinfo_free_temporary(builder.processor_domains);
+		return false;
+	}
+	builder.domains = cpuinfo_arena_get(&arena, domains_offset, domains_count);
+	builder.frequencies = cpuinfo_arena_get(&arena, frequencies_offset, builder.frequencies_count);
+	builder.domains_count = domains_count;
+	if (detected) {
+		detect_domains(&builder);
+	}
+
+	for (uint32_t i = 0; i < domains_count; i++) {
+		builder.domains[i].processor_start = UINT32_MAX;
+		builder.domains[i].processor_count = 0;
+	}
+	for (uint32_t i = 0; i < processors_count; i++) {
+		struct cpuinfo_frequency_domain* domain = &builder.domains[builder.processor_domains[i]];
+		if (domain->processor_start == UINT32_MAX) {
+			domain->processor_start = i;
+		}
+		domain->processor_count = i + 1 - domain->processor_start;
+		tables->processors[i].frequency_domain = domain;
+	}
+	for (uint32_t i = 0; i < domains_count; i++) {
+		if (builder.domains[i].processor_start == UINT32_MAX) {
+			builder.domains[i].processor_start = 0;
+		}
+	}
+	cpuinfo_free_temporary(builder.processor_domains);
+
+	struct cpuinfo_uncore_domain* uncore_domains =
+		cpuinfo_arena_get(&arena, uncore_domains_offset, uncore_domains_max);
+	const uint32_t uncore_domains_count =
+		uncore_domains_max != 0 ? detect_uncore_domains(tables, uncore_domains, uncore_domains_max) : 0;
+
+	tables->frequency_domains = builder.domains;
+	tables->frequency_domains_count = domains_count;
+	tables->uncore_domains = uncore_domains_count != 0 ? uncore_domains : NULL;
+	tables->uncore_domains_count = uncore_domains_count;
+	tables->frequency_memory = arena.memory;
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_check_benchmark_environment(struct cpuinfo_benchmark_environment* environment,
+	struct cpuinfo_frequency_domain_environment* domains)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("check_benchmark_environment");
+	if (environment == NULL) {
+		return false;
+	}
+	*environment = (struct cpuinfo_benchmark_environment) {
+		.isolated_processors_count = tables->isolated_processors_count,
+	};
+	if (environment->isolated_processors_count == 0) {
+		environment->warnings |= cpuinfo_environment_warning_no_isolated_processors;
+	}
+
+	#if defined(__linux__)
+		environment->smt_control = cpuinfo_linux_get_smt_control();
+		const bool global_boost = get_global_boost();
+	#else
+		const bool global_boost = false;
+	#endif
+	if (environment->smt_control == cpuinfo_smt_control_on) {
+		environment->warnings |= cpuinfo_environment_warning_smt;
+	}
+
+	for (uint32_t i = 0; i < tables->frequency_domains_count; i++) {
+		struct cpuinfo_frequency_domain_environment domain_environment = {
+			.boost = global_boost,
+		};
+		#if defined(__linux__)
+			const struct cpuinfo_frequency_domain* domain = &tables->frequency_domains[i];
+			const struct cpuinfo_processor* processor = &tables->processors[domain->processor_start];
+			if (domain->domain_id != UINT32_MAX && processor->linux_id >= 0) {
+				const uint32_t linux_id = (uint32_t) processor->linux_id;
+				cpuinfo_linux_parse_processor_small_file(linux_id, GOVERNOR_FILENAME, GOVERNOR_FILESIZE,
+					parse_governor, domain_environment.governor);
+				cpuinfo_linux_parse_processor_small_file(linux_id, POLICY_BOOST_FILENAME, BOOST_FILESIZE,
+					parse_flag, &domain_environment.boost);
+				cpuinfo_linux_parse_processor_small_file(linux_id, SCALING_MIN_FREQUENCY_FILENAME, FREQUENCY_FILESIZE,
+					parse_frequency, &domain_environment.min_frequency);
+				cpuinfo_linux_parse_processor_small_file(linux_id, SCALING_MAX_FREQUENCY_FILENAME, FREQUENCY_FILESIZE,
+					parse_frequency, &domain_environment.max_frequency);
+				cpuinfo_linux_parse_processor_small_file(linux_id, ENERGY_PREFERENCE_FILENAME,
+					ENERGY_PREFERENCE_FILESIZE, parse_energy_preference,
+					&domain_environment.energy_performance_preference);
+				/* intel_pstate lowers the hardware maximum when turbo is disabled, so the cap is checked against it */
+				domain_environment.hardware_max_frequency =
+					(uint64_t) cpuinfo_linux_get_processor_max_frequency(linux_id) * UINT64_C(1000);
+			}
+		#endif
+
+		if (domain_environment.governor[0] == '\0' || domain_environment.max_frequency == 0) {
+			domain_environment.warnings |= cpuinfo_environment_warning_unknown_frequency;
+		} else if (strcmp(domain_environment.governor, "performance") != 0) {
+			domain_environment.warnings |= cpuinfo_environment_warning_governor;
+		}
+		if (domain_environment.boost) {
+			domain_environment.warnings |= cpuinfo_environment_warning_boost;
+		}
+		if (domain_environment.energy_performance_preference != cpuinfo_energy_performance_preference_unknown &&
+			domain_environment.energy_performance_preference != cpuinfo_energy_performance_preference_performance)
+		{
+			domain_environment.warnings |= cpuinfo_environment_warning_energy_performance_preference;
+		}
+		if (domain_environment.max_frequency != 0 &&
+			domain_environment.max_frequency < domain_environment.hardware_max_frequency)
+		{
+			domain_environment.warnings |= cpuinfo_environment_warning_frequency_cap;
+		}
+		environment->warnings |= domain_environment.warnings;
+		if (domains != NULL) {
+			domains[i] = domain_environment;
+		}
+	}
+	#if defined(__linux__)
+		cpuinfo_linux_release_sysfs();
+	#endif
+	return true;
+}
+
+#if defined(__linux__)
+	/* First logical processor of the cpufreq policy of the domain, or false if the domain has no policy */
+	static bool get_policy_processor(const struct cpuinfo_tables* tables, const struct cpuinfo_frequency_domain* domain,
+		uint32_t linux_id[restrict static 1])
+	{
+		const struct cpuinfo_processor* processor = &tables->processors[domain->processor_start];
+		if (domain->domain_id == UINT32_MAX || processor->linux_id < 0) {
+			return false;
+		}
+		*linux_id = (uint32_t) processor->linux_id;
+		return true;
+	}
+#endif
+
+enum cpuinfo_energy_performance_preference CPUINFO_ABI cpuinfo_get_energy_performance_preference(
+	const struct cpuinfo_frequency_domain* domain)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("get_energy_performance_preference");
+	enum cpuinfo_energy_performance_preference preference = cpuinfo_energy_performance_preference_unknown;
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(domain, tables->frequency_domains, tables->frequency_domains_count,
+			sizeof(struct cpuinfo_frequency_domain), &index))
+	{
+		return preference;
+	}
+	#if defined(__linux__)
+		uint32_t linux_id;
+		if (get_policy_processor(tables, domain, &linux_id)) {
+			cpuinfo_linux_parse_processor_small_file(linux_id, ENERGY_PREFERENCE_FILENAME, ENERGY_PREFERENCE_FILESIZE,
+				parse_energy_preference, &preference);
+			cpuinfo_linux_release_sysfs();
+		}
+	#endif
+	return preference;
+}
+
+bool CPUINFO_ABI cpuinfo_set_energy_performance_preference(const struct cpuinfo_frequency_domain* domain,
+	enum cpuinfo_energy_performance_preference preference)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("set_energy_performance_preference");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(domain, tables->frequency_domains, tables->frequency_domains_count,
+			sizeof(struct cpuinfo_frequency_domain), &index))
+	{
+		return false;
+	}
+	if (preference < cpuinfo_energy_performance_preference_default ||
+		preference > cpuinfo_energy_performance_preference_power ||
+		(domain->energy_performance_preferences & (UINT32_C(1) << preference)) == 0)
+	{
+		cpuinfo_log_info("energy-performance preference %d is not available in frequency domain %"PRIu32,
+			(int) preference, index);
+		return false;
+	}
+	#if defined(__linux__)
+		uint32_t linux_id;
+		if (!get_policy_processor(tables, domain, &linux_id)) {
+			return false;
+		}
+		char filename[ENERGY_PREFERENCE_PATH_SIZE];
+		const int chars_formatted = snprintf(filename, sizeof(filename),
+			"/sys/devices/system/cpu/cpu%"PRIu32"/" ENERGY_PREFERENCE_FILENAME, linux_id);
+		if ((unsigned int) chars_formatted >= sizeof(filename)) {
+			cpuinfo_log_warning("failed to format filename for %s of processor %"PRIu32,
+				ENERGY_PREFERENCE_FILENAME, linux_id);
+			return false;
+		}
+		/* The mock filesystem is read-only, and rejects the open */
+		const int file = cpuinfo_linux_open_file(filename, O_WRONLY | O_CLOEXEC);
+		if (file == -1) {
+			cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
+			return false;
+		}
+		const char* name = energy_preference_names[preference];
+		const ssize_t bytes_written = write(file, name, strlen(name));
+		const int error = errno;
+		cpuinfo_linux_close_file(file);
+		if (bytes_written != (ssize_t) strlen(name)) {
+			cpuinfo_log_info("failed to set energy-performance preference %s in %s: %s", name, filename,
+				bytes_written < 0 ? strerror(error) : "short write");
+			return false;
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
@@ -0,0 +1,288 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <poll.h>
+	#include <pthread.h>
+	#include <unistd.h>
+	#include <sys/socket.h>
+	#include <linux/netlink.h>
+
+	#include <linux/api.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define ONLINE_CPULIST_FILENAME "/sys/devices/system/cpu/online"
+	#define ONLINE_CPULIST_FILESIZE 4096
+	/*
+	 * Uevents are not delivered into network namespaces other than the initial one, e.g. in most containers,
+	 * so the list of online processors is also checked periodically.
+	 */
+	#define ONLINE_POLL_INTERVAL_MS 1000
+	/* Processors are brought online or offline in bursts: wait for the burst to end before re-detection */
+	#define UEVENT_SETTLE_MS 100
+	#define UEVENT_BUFFER_SIZE 4096
+	#define FNV_OFFSET_BASIS UINT64_C(0xCBF29CE484222325)
+	#define FNV_PRIME UINT64_C(0x00000100000001B3)
+
+	struct topology_callback {
+		cpuinfo_topology_callback callback;
+		void* context;
+	};
+
+	static pthread_mutex_t monitor_mutex = PTHREAD_MUTEX_INITIALIZER;
+	static struct topology_callback callbacks[CPUINFO_MAX_TOPOLOGY_CALLBACKS];
+	static uint32_t callbacks_count = 0;
+	static bool monitor_running = false;
+	static pthread_t monitor_thread;
+	/* Pipe which wakes up the monitor thread to stop it: the thread polls the read end */
+	static int wakeup_pipe[2] = { -1, -1 };
+
+	static bool hash_online_parser(const char* text_start, const char* text_end, void* context) {
+		uint64_t hash = FNV_OFFSET_BASIS;
+		for (const char* char_ptr = text_start; char_ptr != text_end; char_ptr++) {
+			hash = (hash ^ (uint64_t) (uint8_t) *char_ptr) * FNV_PRIME;
+		}
+		*((uint64_t*) context) = hash;
+		return true;
+	}
+
+	static uint64_t hash_online_processors(void) {
+		uint64_t hash = 0;
+		cpuinfo_linux_parse_small_file(ONLINE_CPULIST_FILENAME, ONLINE_CPULIST_FILESIZE, hash_online_parser, &hash);
+		return hash;
+	}
+
+	static int open_uevent_socket(void) {
+		#if CPUINFO_MOCK
+			return -1;
+		#else
+			const int uevent_socket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+			if (uevent_socket == -1) {
+				cpuinfo_log_info("failed to open uevent socket: %s", strerror(errno));
+				return -1;
+			}
+			struct sockaddr_nl address;
+			memset(&address, 0, sizeof(address));
+			address.nl_family = AF_NETLINK;
+			/* Multicast group of kernel uevents */
+			address.nl_groups = 1;
+			if (bind(uevent_socket, (const struct sockaddr*) &address, sizeof(address)) != 0) {
+				cpuinfo_log_info("failed to bind uevent socket: %s", strerror(errno));
+				close(uevent_socket);
+				return -1;
+			}
+			return uevent_socket;
+		#endif
+	}
+
+	/* Check if a uevent message, a sequence of NUL-terminated strings, reports a change of a processor */
+	static bool is_cpu_uevent(const char* message, size_t length) {
+		bool cpu_subsystem = false;
+		for (const char* field = message; field < message + length; field += strlen(field) + 1) {
+			if (strcmp(field, "SUBSYSTEM=cpu") == 0) {
+				cpu_subsystem = true;
+			}
+		}
+		return cpu_subsystem;
+	}
+
+	/* Drain pending uevents, and return true if any of them reports a change of a processor */
+	static bool drain_uevents(int uevent_socket) {
+		bool cpu_event = false;
+		char buffer[UEVENT_BUFFER_SIZE + 1];
+		for (;;) {
+			const ssize_t bytes_received = recv(uevent_socket, buffer, UEVENT_BUFFER_SIZE, 0);
+			if (bytes_received <= 0) {
+				break;
+			}
+			buffer[bytes_received] = '\0';
+			cpu_event |= is_cpu_uevent(buffer, (size_t) bytes_received);
+		}
+		return cpu_event;
+	}
+
+	static void notify_callbacks(void) {
+		struct topology_callback notified_callbacks[CPUINFO_MAX_TOPOLOGY_CALLBACKS];
+		pthread_mutex_lock(&monitor_mutex);
+		const uint32_t notified_count = callbacks_count;
+		memcpy(notified_callbacks, callbacks, notified_count * sizeof(struct topology_callback));
+		pthread_mutex_unlock(&monitor_mutex);
+
+		const uint64_t generation = cpuinfo_get_topology_generation();
+		for (uint32_t i = 0; i < notified_count; i++) {
+			notified_callbacks[i].callback(generation, notified_callbacks[i].context);
+		}
+	}
+
+	static void* monitor_topology(void* parameter) {
+		const int wakeup_fd = (int) (intptr_t) parameter;
+		const int uevent_socket = open_uevent_socket();
+		uint64_t online_hash = hash_online_processors();
+		for (;;) {
+			struct pollfd poll_fds[2] = {
+				{ .fd = wakeup_fd, .events = POLLIN },
+				{ .fd = uevent_socket, .events = POLLIN },
+			};
+			const nfds_t poll_fds_count = uevent_socket != -1 ? 2 : 1;
+			if (poll(poll_fds, poll_fds_count, ONLINE_POLL_INTERVAL_MS) < 0 && errno != EINTR) {
+				cpuinfo_log_warning("failed to wait for topology changes: %s", strerror(errno));
+				break;
+			}
+			if (poll_fds[0].revents != 0) {
+				break;
+			}
+			if (poll_fds[1].revents & POLLIN) {
+				if (!drain_uevents(uevent_socket)) {
+					continue;
+				}
+				/* Let the burst of uevents settle */
+				do {
+					poll_fds[1].revents = 0;
+					poll(&poll_fds[1], 1, UEVENT_SETTLE_MS);
+				} while ((poll_fds[1].revents & POLLIN) && drain_uevents(uevent_socket));
+			}
+
+			/* Uevents of other processor attributes don't change the topology */
+			const uint64_t new_online_hash = hash_online_processors();
+			if (new_online_hash == online_hash) {
+				continue;
+			}
+			online_hash = new_online_hash;
+			cpuinfo_log_debug("online processors changed: re-detecting topology");
+			if (cpuinfo_reinitialize()) {
+				notify_callbacks();
+			} else {
+				cpuinfo_log_warning("failed to re-detect topology after online processors changed");
+			}
+		}
+		if (uevent_socket != -1) {
+			close(uevent_socket);
+		}
+		return NULL;
+	}
+
+	/* Must be called with monitor_mutex held */
+	static bool start_monitor(void) {
+		if (pipe2(wakeup_pipe, O_CLOEXEC) != 0) {
+			cpuinfo_log_error("failed to create wakeup pipe for topology monitor: %s", strerror(errno));
+			return false;
+		}
+		const int error =
+			pthread_create(&monitor_thread, NULL, monitor_topology, (void*) (intptr_t) wakeup_pipe[0]);
+		if (error != 0) {
+			cpuinfo_log_error("failed to create topology monitor thread: %s", strerror(error));
+			close(wakeup_pipe[0]);
+			close(wakeup_pipe[1]);
+			wakeup_pipe[0] = wakeup_pipe[1] = -1;
+			return false;
+		}
+		monitor_running = true;
+		return true;
+	}
+
+	struct monitor {
+		pthread_t thread;
+		int wakeup_pipe[2];
+	};
+
+	/* Detach the running monitor from the global state; must be called with monitor_mutex held */
+	static struct monitor detach_monitor(void) {
+		struct monitor monitor = {
+			.thread = monitor_thread,
+			.wakeup_pipe = { wakeup_pipe[0], wakeup_pipe[1] },
+		};
+		monitor_running = false;
+		wakeup_pipe[0] = wakeup_pipe[1] = -1;
+		return monitor;
+	}
+
+	/* Must be called without monitor_mutex held: the monitor thread takes it to notify callbacks */
+	static void stop_monitor(const struct monitor monitor[restrict static 1]) {
+		const char wakeup = 0;
+		if (write(monitor->wakeup_pipe[1], &wakeup, sizeof(wakeup)) != (ssize_t) sizeof(wakeup)) {
+			cpuinfo_log_warning("failed to wake up topology monitor thread: %s", strerror(errno));
+		}
+		pthread_join(monitor->thread, NULL);
+		close(monitor->wakeup_pipe[0]);
+		close(monitor->wakeup_pipe[1]);
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_register_topology_callback(cpuinfo_topology_callback callback, void* context) {
+	if (callback == NULL || !cpuinfo_is_ready()) {
+		return false;
+	}
+	#if defined(__linux__)
+		bool registered = false;
+		pthread_mutex_lock(&monitor_mutex);
+		if (callbacks_count == CPUINFO_MAX_TOPOLOGY_CALLBACKS) {
+			cpuinfo_log_error("failed to register topology callback: %d callbacks are already registered",
+				CPUINFO_MAX_TOPOLOGY_CALLBACKS);
+		} else if (monitor_running || start_monitor()) {
+			callbacks[callbacks_count++] = (struct topology_callback) { .callback = callback, .context = context };
+			registered = true;
+		}
+		pthread_mutex_unlock(&monitor_mutex);
+		return registered;
+	#else
+		(void) context;
+		cpuinfo_log_info("topology change notifications are not supported on this platform");
+		return false;
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_unregister_topology_callback(cpuinfo_topology_callback callback, void* context) {
+	#if defined(__linux__)
+		bool unregistered = false, stop = false;
+		struct monitor monitor;
+		pthread_mutex_lock(&monitor_mutex);
+		for (uint32_t i = 0; i < callbacks_count; i++) {
+			if (callbacks[i].callback == callback && callbacks[i].context == context) {
+				callbacks[i] = callbacks[--callbacks_count];
+				unregistered = true;
+				break;
+			}
+		}
+		if (unregistered && callbacks_count == 0 && monitor_running) {
+			monitor = detach_monitor();
+			stop = true;
+		}
+		pthread_mutex_unlock(&monitor_mutex);
+		if (stop) {
+			stop_monitor(&monitor);
+		}
+		return unregistered;
+	#else
+		(void) callback;
+		(void) context;
+		return false;
+	#endif
+}
+
+void cpuinfo_stop_topology_monitor(void) {
+	#if defined(__linux__)
+		bool stop = false;
+		struct monitor monitor;
+		pthread_mutex_lock(&monitor_mutex);
+		callbacks_count = 0;
+		if (monitor_running) {
+			monitor = detach_monitor();
+			stop = true;
+		}
+		pthread_mutex_unlock(&monitor_mutex);
+		if (stop) {
+			stop_monitor(&monitor);
+		}
+	#endif
+}
@@ -0,0 +1,288 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <stdio.h>
+
+	#include <linux/api.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define HUGEPAGES_DIRNAME "/sys/kernel/mm/hugepages"
+	#define HUGEPAGES_FILENAME_FORMAT "/sys/kernel/mm/hugepages/hugepages-%" PRIu64 "kB/%s"
+	#define NODE_HUGEPAGES_FILENAME_FORMAT \
+		"/sys/devices/system/node/node%" PRIu32 "/hugepages/hugepages-%" PRIu64 "kB/%s"
+	#define HUGEPAGES_FILENAME_SIZE \
+		(sizeof("/sys/devices/system/node/node4294967295/hugepages/hugepages-18446744073709551615kB/surplus_hugepages"))
+	#define THP_ENABLED_FILENAME "/sys/kernel/mm/transparent_hugepage/enabled"
+	#define THP_DEFRAG_FILENAME "/sys/kernel/mm/transparent_hugepage/defrag"
+	#define THP_PAGE_SIZE_FILENAME "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"
+	#define NUMBER_FILESIZE 32
+	#define THP_MODE_FILESIZE 128
+	/* Maximum number of huge page sizes: architectures support at most a few sizes */
+	#define MAX_HUGE_PAGE_SIZES 16
+
+	struct thp_mode_name {
+		const char* name;
+		uint32_t mode;
+	};
+
+	static const struct thp_mode_name thp_enabled_names[] = {
+		{ "always", cpuinfo_transparent_huge_pages_mode_always },
+		{ "madvise", cpuinfo_transparent_huge_pages_mode_madvise },
+		{ "never", cpuinfo_transparent_huge_pages_mode_never },
+	};
+
+	static const struct thp_mode_name thp_defrag_names[] = {
+		{ "always", cpuinfo_transparent_huge_pages_defrag_always },
+		{ "defer", cpuinfo_transparent_huge_pages_defrag_defer },
+		{ "defer+madvise", cpuinfo_transparent_huge_pages_defrag_defer_madvise },
+		{ "madvise", cpuinfo_transparent_huge_pages_defrag_madvise },
+		{ "never", cpuinfo_transparent_huge_pages_defrag_never },
+	};
+
+	struct thp_mode_context {
+		const struct thp_mode_name* names;
+		uint32_t names_count;
+		uint32_t mode;
+	};
+
+	/* Parse the selected mode, in brackets, as in "always [madvise] never" */
+	static bool thp_mode_parser(const char* text_start, const char* text_end, void* context) {
+		struct thp_mode_context* mode_context = (struct thp_mode_context*) context;
+		const char* selected_start = memchr(text_start, '[', (size_t) (text_end - text_start));
+		if (selected_start == NULL) {
+			return false;
+		}
+		selected_start++;
+		const char* selected_end = memchr(selected_start, ']', (size_t) (text_end - selected_start));
+		if (selected_end == NULL) {
+			return false;
+		}
+		const size_t selected_length = (size_t) (selected_end - selected_start);
+		for (uint32_t i = 0; i < mode_context->names_count; i++) {
+			const char* name = mode_context->names[i].name;
+			if (strlen(name) == selected_length && memcmp(name, selected_start, selected_length) == 0) {
+				mode_context->mode = mode_context->names[i].mode;
+				return true;
+			}
+		}
+		cpuinfo_log_info("unknown transparent huge pages mode \"%.*s\"", (int) selected_length, selected_start);
+		return false;
+	}
+
+	static uint32_t parse_thp_mode(const char* filename, const struct thp_mode_name* names, uint32_t names_count) {
+		struct thp_mode_context context = { .names = names, .names_count = names_count, .mode = 0 };
+		cpuinfo_linux_parse_small_file(filename, THP_MODE_FILESIZE, thp_mode_parser, &context);
+		return context.mode;
+	}
+
+	static bool uint64_parser(const char* text_start, const char* text_end, void* context) {
+		uint64_t value = 0;
+		const char* digit = text_start;
+		for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+			value = value * 10 + (uint64_t) (*digit - '0');
+		}
+		if (digit == text_start) {
+			return false;
+		}
+		*((uint64_t*) context) = value;
+		return true;
+	}
+
+	static bool read_number(const char* filename, uint64_t value[restrict static 1]) {
+		return cpuinfo_linux_parse_small_file(filename, NUMBER_FILESIZE, uint64_parser, value);
+	}
+
+	/* Read the numbers of pages of the system pool with the page size, or of its part on the NUMA node */
+	static bool read_pool(uint64_t page_size, uint32_t node_id, bool node,
+		struct cpuinfo_huge_page_pool pool[restrict static 1])
+	{
+		static const char* const filenames[] = { "nr_hugepages", "free_hugepages", "resv_hugepages" };
+		uint64_t* const values[] = { &pool->total_pages, &pool->free_pages, &pool->reserved_pages };
+		*pool = (struct cpuinfo_huge_page_pool) { .page_size = page_size };
+		/* Pools of NUMA nodes don't report reserved pages */
+		const uint32_t files_count = node ? 2 : 3;
+		for (uint32_t i = 0; i < files_count; i++) {
+			char filename[HUGEPAGES_FILENAME_SIZE];
+			if (node) {
+				snprintf(filename, HUGEPAGES_FILENAME_SIZE, NODE_HUGEPAGES_FILENAME_FORMAT,
+					node_id, page_size / 1024, filenames[i]);
+			} else {
+				snprintf(filename, HUGEPAGES_FILENAME_SIZE, HUGEPAGES_FILENAME_FORMAT, page_size / 1024, filenames[i]);
+			}
+			if (!read_number(filename, values[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	struct page_sizes_context {
+		uint64_t* page_sizes;
+		uint32_t page_sizes_count;
+	};
+
+	static bool add_page_size(const char* name, void* context) {
+		struct page_sizes_context* page_sizes_context = (struct page_sizes_context*) context;
+		uint64_t* page_sizes = page_sizes_context->page_sizes;
+		uint64_t page_size_kb = 0;
+		char suffix[3] = { 0 };
+		if (sscanf(name, "hugepages-%" SCNu64 "%2s", &page_size_kb, suffix) != 2 ||
+			strcmp(suffix, "kB") != 0 || page_size_kb == 0)
+		{
+			return true;
+		}
+		if (page_sizes_context->page_sizes_count == MAX_HUGE_PAGE_SIZES) {
+			cpuinfo_log_warning("too many huge page sizes in %s: only %d are reported",
+				HUGEPAGES_DIRNAME, MAX_HUGE_PAGE_SIZES);
+			return false;
+		}
+		/* Insertion sort: the list is short */
+		uint32_t i = page_sizes_context->page_sizes_count++;
+		for (; i != 0 && page_sizes[i - 1] > page_size_kb * 1024; i--) {
+			page_sizes[i] = page_sizes[i - 1];
+		}
+		page_sizes[i] = page_size_kb * 1024;
+		return true;
+	}
+
+	/* List sizes of huge pages from the names of hugepages-<size>kB directories, in increasing order */
+	static uint32_t detect_page_sizes(uint64_t page_sizes[restrict static MAX_HUGE_PAGE_SIZES]) {
+		struct page_sizes_context context = { .page_sizes = page_sizes };
+		if (!cpuinfo_linux_scan_directory(HUGEPAGES_DIRNAME, add_page_size, &context)) {
+			cpuinfo_log_debug("failed to open %s: huge pages are not supported", HUGEPAGES_DIRNAME);
+			return 0;
+		}
+		return context.page_sizes_count;
+	}
+
+	static void detect_transparent_huge_pages(struct cpuinfo_transparent_huge_pages thp[restrict static 1]) {
+		thp->mode = (enum cpuinfo_transparent_huge_pages_mode) parse_thp_mode(THP_ENABLED_FILENAME,
+			thp_enabled_names, CPUINFO_COUNT_OF(thp_enabled_names));
+		thp->defrag = (enum cpuinfo_transparent_huge_pages_defrag) parse_thp_mode(THP_DEFRAG_FILENAME,
+			thp_defrag_names, CPUINFO_COUNT_OF(thp_defrag_names));
+		uint64_t page_size = 0;
+		if (read_number(THP_PAGE_SIZE_FILENAME, &page_size)) {
+			thp->page_size = page_size;
+		}
+	}
+#endif
+
+bool cpuinfo_build_huge_pages(struct cpuinfo_tables* tables) {
+	tables->huge_page_pools = NULL;
+	tables->huge_page_pools_count = 0;
+	tables->numa_huge_page_pools = NULL;
+	tables->huge_page_memory = NULL;
+	tables->transparent_huge_pages = (struct cpuinfo_transparent_huge_pages) {
+		cpuinfo_transparent_huge_pages_mode_unknown
+	};
+	#if defined(__linux__)
+		detect_transparent_huge_pages(&tables->transparent_huge_pages);
+
+		uint64_t page_sizes[MAX_HUGE_PAGE_SIZES];
+		const uint32_t pools_count = detect_page_sizes(page_sizes);
+		if (pools_count == 0) {
+			return true;
+		}
+
+		const uint32_t nodes_count = tables->numa_nodes_count;
+		struct cpuinfo_arena arena = { 0 };
+		const size_t pools_offset = cpuinfo_arena_reserve(&arena, pools_count, sizeof(struct cpuinfo_huge_page_pool));
+		const size_t numa_pools_offset =
+			cpuinfo_arena_reserve(&arena, (size_t) nodes_count * pools_count, sizeof(struct cpuinfo_huge_page_pool));
+		if (!cpuinfo_arena_allocate(&arena)) {
+			return false;
+		}
+		struct cpuinfo_huge_page_pool* pools = cpuinfo_arena_get(&arena, pools_offset, pools_count);
+		struct cpuinfo_huge_page_pool* numa_pools =
+			cpuinfo_arena_get(&arena, numa_pools_offset, (size_t) nodes_count * pools_count);
+		for (uint32_t i = 0; i < pools_count; i++) {
+			if (!read_pool(page_sizes[i], 0, false, &pools[i])) {
+				cpuinfo_log_info("failed to read the pool of %"PRIu64" KB huge pages", page_sizes[i] / 1024);
+			}
+		}
+		/* Without NUMA support in the kernel, nodes don't report their pools */
+		bool numa_pools_valid = true;
+		for (uint32_t i = 0; i < nodes_count && numa_pools_valid; i++) {
+			for (uint32_t j = 0; j < pools_count && numa_pools_valid; j++) {
+				numa_pools_valid = read_pool(page_sizes[j], tables->numa_nodes[i].node_id, true,
+					&numa_pools[i * pools_count + j]);
+			}
+		}
+		if (!numa_pools_valid) {
+			cpuinfo_log_debug("NUMA nodes don't report pools of huge pages");
+		}
+
+		tables->huge_page_pools = pools;
+		tables->huge_page_pools_count = pools_count;
+		tables->numa_huge_page_pools = numa_pools_valid ? numa_pools : NULL;
+		tables->huge_page_memory = arena.memory;
+	#endif
+	return true;
+}
+
+const struct cpuinfo_huge_page_pool* CPUINFO_ABI cpuinfo_get_huge_page_pools(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("huge_page_pools");
+	return tables->huge_page_pools;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_huge_page_pools_count(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("huge_page_pools_count");
+	return tables->huge_page_pools_count;
+}
+
+const struct cpuinfo_huge_page_pool* CPUINFO_ABI cpuinfo_get_huge_page_pool(uint32_t index) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("huge_page_pool");
+	if CPUINFO_UNLIKELY(index >= tables->huge_page_pools_count) {
+		return NULL;
+	}
+	return &tables->huge_page_pools[index];
+}
+
+const struct cpuinfo_huge_page_pool* CPUINFO_ABI cpuinfo_get_numa_node_huge_page_pool(
+	uint32_t numa_node_index, uint32_t pool_index)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("numa_node_huge_page_pool");
+	if CPUINFO_UNLIKELY(tables->numa_huge_page_pools == NULL || numa_node_index >= tables->numa_nodes_count ||
+		pool_index >= tables->huge_page_pools_count)
+	{
+		return NULL;
+	}
+	return &tables->numa_huge_page_pools[numa_node_index * tables->huge_page_pools_count + pool_index];
+}
+
+bool CPUINFO_ABI cpuinfo_query_huge_page_pool(uint32_t pool_index, uint32_t numa_node_index,
+	struct cpuinfo_huge_page_pool* pool)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("query_huge_page_pool");
+	if (pool == NULL || pool_index >= tables->huge_page_pools_count) {
+		return false;
+	}
+	#if defined(__linux__)
+		const uint64_t page_size = tables->huge_page_pools[pool_index].page_size;
+		if (numa_node_index == UINT32_MAX) {
+			return read_pool(page_size, 0, false, pool);
+		}
+		if (numa_node_index >= tables->numa_nodes_count || tables->numa_huge_page_pools == NULL) {
+			return false;
+		}
+		return read_pool(page_size, tables->numa_nodes[numa_node_index].node_id, true, pool);
+	#else
+		(void) numa_node_index;
+		return false;
+	#endif
+}
+
+const struct cpuinfo_transparent_huge_pages* CPUINFO_ABI cpuinfo_get_transparent_huge_pages(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("transparent_huge_pages");
+	return &tables->transparent_huge_pages;
+}
@@ -0,0 +1,164 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#if defined(__linux__)
+	#include <linux/api.h>
+#elif defined(__MACH__) && defined(__APPLE__)
+	#include <sys/sysctl.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define DMI_FILESIZE 128
+	#define DEVICE_TREE_FILESIZE 1024
+	#define SYS_VENDOR_FILENAME "/sys/class/dmi/id/sys_vendor"
+	#define PRODUCT_NAME_FILENAME "/sys/class/dmi/id/product_name"
+	#define HYPERVISOR_TYPE_FILENAME "/sys/hypervisor/type"
+	#define DEVICE_TREE_HYPERVISOR_FILENAME "/proc/device-tree/hypervisor/compatible"
+	#define DEVICE_TREE_COMPATIBLE_FILENAME "/proc/device-tree/compatible"
+
+	struct dmi_hypervisor {
+		const char* sys_vendor;
+		/* NULL matches any product name */
+		const char* product_name;
+		enum cpuinfo_hypervisor hypervisor;
+	};
+
+	static const struct dmi_hypervisor dmi_hypervisors[] = {
+		{ "Amazon EC2", NULL, cpuinfo_hypervisor_nitro },
+		{ "Microsoft Corporation", "Virtual Machine", cpuinfo_hypervisor_hyperv },
+		{ "VMware, Inc.", NULL, cpuinfo_hypervisor_vmware },
+		{ "Xen", NULL, cpuinfo_hypervisor_xen },
+		{ "innotek GmbH", NULL, cpuinfo_hypervisor_virtualbox },
+		{ "Parallels Software International Inc.", NULL, cpuinfo_hypervisor_parallels },
+		{ "Parallels International GmbH.", NULL, cpuinfo_hypervisor_parallels },
+		{ "Google", "Google Compute Engine", cpuinfo_hypervisor_kvm },
+		{ "QEMU", NULL, cpuinfo_hypervisor_qemu },
+		{ NULL, "KVM", cpuinfo_hypervisor_kvm },
+		{ NULL, "BHYVE", cpuinfo_hypervisor_bhyve },
+	};
+
+	struct string_buffer {
+		char data[DEVICE_TREE_FILESIZE];
+		size_t length;
+	};
+
+	/* Keep the contents of a sysfs or device tree file without the trailing newline or NUL */
+	static bool string_parser(const char* text_start, const char* text_end, void* context) {
+		struct string_buffer* buffer = (struct string_buffer*) context;
+		while (text_end != text_start && (text_end[-1] == '\n' || text_end[-1] == '\0')) {
+			text_end--;
+		}
+		const size_t length = (size_t) (text_end - text_start);
+		if (length >= sizeof(buffer->data)) {
+			return false;
+		}
+		memcpy(buffer->data, text_start, length);
+		buffer->data[length] = '\0';
+		buffer->length = length;
+		return true;
+	}
+
+	static bool read_string(const char* filename, size_t file_size, struct string_buffer buffer[restrict static 1]) {
+		buffer->length = 0;
+		return cpuinfo_linux_parse_small_file(filename, file_size, string_parser, buffer);
+	}
+
+	/* Check if a device tree property, a list of NUL-separated strings, contains the string */
+	static bool has_compatible_string(const struct string_buffer buffer[restrict static 1], const char* compatible) {
+		for (size_t offset = 0; offset < buffer->length; offset += strlen(&buffer->data[offset]) + 1) {
+			if (strcmp(&buffer->data[offset], compatible) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool ends_with(const struct string_buffer buffer[restrict static 1], const char* suffix) {
+		const size_t suffix_length = strlen(suffix);
+		return buffer->length >= suffix_length &&
+			memcmp(&buffer->data[buffer->length - suffix_length], suffix, suffix_length) == 0;
+	}
+
+	static enum cpuinfo_hypervisor detect_linux_hypervisor(void) {
+		struct string_buffer sys_vendor, product_name, buffer;
+		const bool has_sys_vendor = read_string(SYS_VENDOR_FILENAME, DMI_FILESIZE, &sys_vendor);
+		const bool has_product_name = read_string(PRODUCT_NAME_FILENAME, DMI_FILESIZE, &product_name);
+		if (has_sys_vendor && has_product_name && strcmp(sys_vendor.data, "Amazon EC2") == 0 &&
+			ends_with(&product_name, ".metal"))
+		{
+			/* EC2 bare metal instances run without a hypervisor */
+			return cpuinfo_hypervisor_none;
+		}
+		for (size_t i = 0; i < CPUINFO_COUNT_OF(dmi_hypervisors); i++) {
+			const struct dmi_hypervisor* dmi_hypervisor = &dmi_hypervisors[i];
+			if (dmi_hypervisor->sys_vendor != NULL &&
+				!(has_sys_vendor && strcmp(sys_vendor.data, dmi_hypervisor->sys_vendor) == 0))
+			{
+				continue;
+			}
+			if (dmi_hypervisor->product_name != NULL &&
+				!(has_product_name && strcmp(product_name.data, dmi_hypervisor->product_name) == 0))
+			{
+				continue;
+			}
+			return dmi_hypervisor->hypervisor;
+		}
+
+		if (read_string(HYPERVISOR_TYPE_FILENAME, DMI_FILESIZE, &buffer) && strcmp(buffer.data, "xen") == 0) {
+			return cpuinfo_hypervisor_xen;
+		}
+		if (read_string(DEVICE_TREE_HYPERVISOR_FILENAME, DEVICE_TREE_FILESIZE, &buffer) &&
+			has_compatible_string(&buffer, "xen,xen"))
+		{
+			return cpuinfo_hypervisor_xen;
+		}
+		if (read_string(DEVICE_TREE_COMPATIBLE_FILENAME, DEVICE_TREE_FILESIZE, &buffer) &&
+			has_compatible_string(&buffer, "linux,dummy-virt"))
+		{
+			/* Machine "virt" of QEMU, with or without KVM */
+			return cpuinfo_hypervisor_qemu;
+		}
+		return cpuinfo_hypervisor_none;
+	}
+#endif
+
+void cpuinfo_detect_hypervisor(struct cpuinfo_tables* tables) {
+	enum cpuinfo_hypervisor hypervisor = cpuinfo_hypervisor_none;
+	bool root_partition = false;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		hypervisor = cpuinfo_x86_detect_hypervisor(&root_partition);
+	#endif
+	#if defined(__linux__)
+		/* DMI identifies hypervisors without a CPUID signature, and EC2 instances among KVM guests */
+		if (hypervisor == cpuinfo_hypervisor_none || hypervisor == cpuinfo_hypervisor_unknown ||
+			hypervisor == cpuinfo_hypervisor_kvm)
+		{
+			const enum cpuinfo_hypervisor linux_hypervisor = detect_linux_hypervisor();
+			if (linux_hypervisor != cpuinfo_hypervisor_none &&
+				(hypervisor != cpuinfo_hypervisor_kvm || linux_hypervisor == cpuinfo_hypervisor_nitro))
+			{
+				hypervisor = linux_hypervisor;
+			}
+		}
+	#elif defined(__MACH__) && defined(__APPLE__)
+		if (hypervisor == cpuinfo_hypervisor_none) {
+			int vmm_present = 0;
+			size_t vmm_present_size = sizeof(vmm_present);
+			if (sysctlbyname("kern.hv_vmm_present", &vmm_present, &vmm_present_size, NULL, 0) == 0 && vmm_present) {
+				hypervisor = cpuinfo_hypervisor_unknown;
+			}
+		}
+	#endif
+	tables->hypervisor = hypervisor;
+	tables->topology_synthetic = hypervisor != cpuinfo_hypervisor_none && !root_partition;
+	cpuinfo_log_debug("hypervisor %d%s", (int) hypervisor, root_partition ? " (root partition)" : "");
+}
@@ -3,10 +3,18 @@
 #elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
 	#include <pthread.h>
 #endif
+#include <inttypes.h>
+#include <string.h>
 
 #include <cpuinfo.h>
 #include <cpuinfo/internal-api.h>
 #include <cpuinfo/log.h>
+#if defined(__linux__)
+	#include <linux/api.h>
+#endif
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
 
 #ifdef __APPLE__
 	#include "TargetConditionals.h"
@@ -14,48 +22,368 @@
 
 
 #if defined(_WIN32) || defined(__CYGWIN__)
-	static INIT_ONCE init_guard = INIT_ONCE_STATIC_INIT;
+	static SRWLOCK init_lock = SRWLOCK_INIT;
 #elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
-	static pthread_once_t init_guard = PTHREAD_ONCE_INIT;
-#else
-	static bool init_guard = false;
+	static pthread_mutex_t init_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
-bool CPUINFO_ABI cpuinfo_initialize(void) {
+/* Whether platform initialization was attempted: failed initialization is not retried until cpuinfo_deinitialize */
+static bool init_attempted = false;
+/*
+ * Number of background threads of cpuinfo_initialize_async which did not take the initialization lock yet.
+ * cpuinfo_deinitialize cancels them, so that they don't initialize cpuinfo again after it.
+ */
+static uint32_t async_init_pending = 0;
+
+void cpuinfo_lock_initialization(void) {
+#if defined(_WIN32) || defined(__CYGWIN__)
+	AcquireSRWLockExclusive(&init_lock);
+#elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	pthread_mutex_lock(&init_mutex);
+#endif
+}
+
+void cpuinfo_unlock_initialization(void) {
+#if defined(_WIN32) || defined(__CYGWIN__)
+	ReleaseSRWLockExclusive(&init_lock);
+#elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	pthread_mutex_unlock(&init_mutex);
+#endif
+}
+
+/* Detect the tables into the global variables; must be called with initialization lock held */
+static void init_platform(void) {
+	init_attempted = true;
+	cpuinfo_start_init_stats();
+#if defined(__linux__)
+	cpuinfo_linux_begin_file_reads();
+#endif
 #if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* Leaves of the previous initialization may predate microcode updates */
+	cpuinfo_x86_reset_cpuid_table();
+	cpuinfo_x86_record_cpuid(true);
 	#if defined(__MACH__) && defined(__APPLE__)
-		pthread_once(&init_guard, &cpuinfo_x86_mach_init);
+		cpuinfo_x86_mach_init();
 	#elif defined(__linux__)
-		pthread_once(&init_guard, &cpuinfo_x86_linux_init);
+		cpuinfo_x86_linux_init();
 	#elif defined(_WIN32) || defined(__CYGWIN__)
-		InitOnceExecuteOnce(&init_guard, &cpuinfo_x86_windows_init, NULL, NULL);
+		cpuinfo_x86_windows_init(NULL, NULL, NULL);
+	#elif defined(__FreeBSD__)
+		cpuinfo_x86_freebsd_init();
 	#else
 		cpuinfo_log_error("operating system is not supported in cpuinfo");
 	#endif
 #elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
 	#if defined(__linux__)
-		pthread_once(&init_guard, &cpuinfo_arm_linux_init);
+		cpuinfo_arm_linux_init();
 	#elif defined(__MACH__) && defined(__APPLE__)
-		pthread_once(&init_guard, &cpuinfo_arm_mach_init);
+		cpuinfo_arm_mach_init();
 	#elif defined(_WIN32)
-		InitOnceExecuteOnce(&init_guard, &cpuinfo_arm_windows_init, NULL, NULL);
+		cpuinfo_arm_windows_init(NULL, NULL, NULL);
 	#else
 		cpuinfo_log_error("operating system is not supported in cpuinfo");
 	#endif
-#elif CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
-	#if defined(__EMSCRIPTEN_PTHREADS__)
-		pthread_once(&init_guard, &cpuinfo_emscripten_init);
+#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+	#if defined(__linux__)
+		cpuinfo_riscv_linux_init();
 	#else
-		if (!init_guard) {
-			cpuinfo_emscripten_init();
-		}
-		init_guard = true;
+		cpuinfo_log_error("operating system is not supported in cpuinfo");
+	#endif
+#elif CPUINFO_ARCH_LOONGARCH64
+	#if defined(__linux__)
+		cpuinfo_loongarch_linux_init();
+	#else
+		cpuinfo_log_error("operating system is not supported in cpuinfo");
 	#endif
+#elif CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+	cpuinfo_emscripten_init();
 #else
 	cpuinfo_log_error("processor architecture is not supported in cpuinfo");
 #endif
-	return cpuinfo_is_initialized;
+	cpuinfo_finish_init_stats();
+	if (cpuinfo_is_initialized && !cpuinfo_publish_tables()) {
+		cpuinfo_is_initialized = false;
+	}
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* Leaves queried after initialization describe the current processor, which may differ on hybrid systems */
+	cpuinfo_x86_record_cpuid(false);
+#endif
+#if defined(__linux__)
+	/* The read buffer is a temporary array of initialization, which is released next */
+	cpuinfo_linux_end_file_reads();
+#endif
+	cpuinfo_arena_release_temporary();
+}
+
+bool CPUINFO_ABI cpuinfo_initialize(void) {
+	if (cpuinfo_load_tables() != NULL) {
+		/* Already initialized, possibly from a snapshot via cpuinfo_initialize_from_snapshot */
+		return true;
+	}
+
+	cpuinfo_lock_initialization();
+	if (cpuinfo_tables == NULL && !init_attempted) {
+		init_platform();
+	}
+	const bool initialized = cpuinfo_tables != NULL;
+	cpuinfo_unlock_initialization();
+	return initialized;
+}
+
+#if defined(__linux__)
+	size_t CPUINFO_ABI cpuinfo_query_buffer_size(void) {
+		cpuinfo_lock_initialization();
+		size_t size = 0;
+		if (cpuinfo_tables != NULL) {
+			cpuinfo_log_warning("buffer size is not measured: cpuinfo is already initialized");
+		} else {
+			/* Measure one initialization on the heap, then discard its tables */
+			cpuinfo_arena_measure_buffer();
+			init_platform();
+			const bool initialized = cpuinfo_tables != NULL;
+			size = cpuinfo_arena_detach_buffer();
+			cpuinfo_release_tables();
+			init_attempted = false;
+			if (!initialized) {
+				size = 0;
+			}
+		}
+		cpuinfo_unlock_initialization();
+		return size;
+	}
+
+	bool CPUINFO_ABI cpuinfo_initialize_into(void* buffer, size_t size) {
+		cpuinfo_lock_initialization();
+		bool initialized = false;
+		if (cpuinfo_tables != NULL) {
+			cpuinfo_log_warning("buffer is ignored: cpuinfo is already initialized");
+		} else if (buffer != NULL) {
+			cpuinfo_arena_attach_buffer(buffer, size);
+			init_platform();
+			initialized = cpuinfo_tables != NULL;
+			if (!initialized) {
+				cpuinfo_release_tables();
+				cpuinfo_arena_detach_buffer();
+				init_attempted = false;
+			}
+		}
+		cpuinfo_unlock_initialization();
+		return initialized;
+	}
+#else
+	size_t CPUINFO_ABI cpuinfo_query_buffer_size(void) {
+		cpuinfo_log_error("initialization into a buffer is not supported on this operating system");
+		return 0;
+	}
+
+	bool CPUINFO_ABI cpuinfo_initialize_into(void* buffer, size_t size) {
+		cpuinfo_log_error("initialization into a buffer is not supported on this operating system");
+		return false;
+	}
+#endif
+
+/* Apply option flags of cpuinfo_initialize_ex and cpuinfo_initialize_async; must be called with initialization lock held */
+static void set_init_options(uint32_t flags) {
+	if (flags & CPUINFO_INIT_PARALLEL_PROBING) {
+		cpuinfo_parallel_probing = true;
+	}
+	if (flags & CPUINFO_INIT_PER_PROCESSOR_CPUID) {
+		cpuinfo_per_processor_cpuid = true;
+	}
+	if (flags & CPUINFO_INIT_RECLAIM_RETIRED_TABLES) {
+		cpuinfo_reclaim_retired_tables = true;
+	}
+	if (flags & CPUINFO_INIT_WAIT_IN_GETTERS) {
+		cpuinfo_wait_in_getters = true;
+	}
+}
+
+bool CPUINFO_ABI cpuinfo_initialize_ex(uint32_t flags) {
+	cpuinfo_lock_initialization();
+	set_init_options(flags & ~CPUINFO_INIT_WAIT_IN_GETTERS);
+	cpuinfo_unlock_initialization();
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	if ((flags & ~(CPUINFO_INIT_ISA | CPUINFO_INIT_PARALLEL_PROBING | CPUINFO_INIT_RECLAIM_RETIRED_TABLES)) == 0) {
+		/* ISA is decoded from CPUID alone and doesn't need any information from the OS */
+		cpuinfo_lock_initialization();
+		if (!cpuinfo_isa_is_initialized && !cpuinfo_is_initialized) {
+			cpuinfo_x86_reset_cpuid_table();
+			cpuinfo_x86_record_cpuid(true);
+			cpuinfo_x86_init_isa();
+			cpuinfo_x86_record_cpuid(false);
+		}
+		cpuinfo_unlock_initialization();
+		return cpuinfo_isa_is_initialized || cpuinfo_is_initialized;
+	}
+#endif
+	return cpuinfo_initialize();
+}
+
+bool cpuinfo_initialize_deferred(void) {
+	/*
+	 * Complete initialization only if the caller opted into partial initialization via cpuinfo_initialize_ex,
+	 * or into waiting for background initialization via cpuinfo_initialize_async.
+	 * Otherwise, calling cpuinfo_get_* functions before cpuinfo_initialize is a programming error.
+	 */
+	if (!cpuinfo_isa_is_initialized && !cpuinfo_wait_in_getters) {
+		return false;
+	}
+	return cpuinfo_initialize();
+}
+
+/* Initialize cpuinfo on the background thread, unless cpuinfo_deinitialize cancelled it */
+static void initialize_in_background(void) {
+	cpuinfo_lock_initialization();
+	if (async_init_pending != 0) {
+		async_init_pending -= 1;
+		if (cpuinfo_tables == NULL && !init_attempted) {
+			init_platform();
+		}
+	}
+	cpuinfo_unlock_initialization();
+}
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	static DWORD WINAPI initialize_thread(LPVOID parameter) {
+		initialize_in_background();
+		return 0;
+	}
+#elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	static void* initialize_thread(void* parameter) {
+		initialize_in_background();
+		return NULL;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_initialize_async(uint32_t flags) {
+	cpuinfo_lock_initialization();
+	set_init_options(flags);
+	const bool initialized = cpuinfo_tables != NULL;
+	if (!initialized) {
+		async_init_pending += 1;
+	}
+	cpuinfo_unlock_initialization();
+	if (initialized) {
+		return true;
+	}
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	HANDLE thread = CreateThread(NULL, 0, initialize_thread, NULL, 0, NULL);
+	if (thread != NULL) {
+		CloseHandle(thread);
+		return true;
+	}
+	cpuinfo_log_warning("failed to create initialization thread: error %"PRIu32, (uint32_t) GetLastError());
+#elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	pthread_t thread;
+	const int error = pthread_create(&thread, NULL, initialize_thread, NULL);
+	if (error == 0) {
+		pthread_detach(thread);
+		return true;
+	}
+	cpuinfo_log_warning("failed to create initialization thread: %s", strerror(error));
+#endif
+	/* No threads: initialize synchronously */
+	cpuinfo_lock_initialization();
+	if (async_init_pending != 0) {
+		async_init_pending -= 1;
+	}
+	cpuinfo_unlock_initialization();
+	return cpuinfo_initialize();
+}
+
+bool CPUINFO_ABI cpuinfo_is_ready(void) {
+	return cpuinfo_load_tables() != NULL;
+}
+
+bool CPUINFO_ABI cpuinfo_wait(void) {
+	/*
+	 * Background initialization holds the initialization lock until it completes, so cpuinfo_initialize blocks
+	 * until then. If the background thread did not take the lock yet, the calling thread initializes cpuinfo.
+	 */
+	return cpuinfo_initialize();
+}
+
+bool CPUINFO_ABI cpuinfo_reinitialize(void) {
+	cpuinfo_lock_initialization();
+	const bool was_initialized = cpuinfo_tables != NULL;
+	cpuinfo_is_initialized = false;
+	init_platform();
+	const bool reinitialized = cpuinfo_is_initialized;
+	if (!reinitialized) {
+		/* Platform initialization commits global variables only on success, so they still describe previous tables */
+		cpuinfo_is_initialized = was_initialized;
+	}
+	cpuinfo_unlock_initialization();
+	return reinitialized;
+}
+
+bool CPUINFO_ABI cpuinfo_set_chipset_cache_directory(const char* path) {
+	if (path == NULL) {
+		cpuinfo_chipset_cache_directory[0] = '\0';
+		return true;
+	}
+	const size_t length = strlen(path);
+	if (length == 0 || length >= CPUINFO_CHIPSET_CACHE_DIRECTORY_MAX) {
+		cpuinfo_log_warning("unsupported length %zu of chipset cache directory", length);
+		return false;
+	}
+	memcpy(cpuinfo_chipset_cache_directory, path, length + 1);
+	return true;
+}
+
+/*
+ * Whether cpuinfo is initialized, partially initialized by cpuinfo_initialize_ex, or has a pending background
+ * initialization; must be called with initialization lock held
+ */
+static bool is_initialization_started(void) {
+	return cpuinfo_tables != NULL || cpuinfo_isa_is_initialized || async_init_pending != 0;
+}
+
+bool CPUINFO_ABI cpuinfo_set_allocator(const struct cpuinfo_allocator* allocator) {
+	if (allocator != NULL && (allocator->allocate == NULL || allocator->deallocate == NULL)) {
+		cpuinfo_log_warning("allocator without allocate or deallocate callback is ignored");
+		return false;
+	}
+	cpuinfo_lock_initialization();
+	const bool started = is_initialization_started();
+	if (started) {
+		cpuinfo_log_warning("allocator is not changed: cpuinfo is already initialized or being initialized");
+	} else if (allocator == NULL) {
+		cpuinfo_allocator = (struct cpuinfo_allocator) { 0 };
+	} else {
+		cpuinfo_allocator = *allocator;
+	}
+	cpuinfo_unlock_initialization();
+	return !started;
+}
+
+bool CPUINFO_ABI cpuinfo_set_file_ops(const struct cpuinfo_file_ops* ops) {
+	if (ops != NULL && (ops->open == NULL || ops->read == NULL || ops->close == NULL)) {
+		cpuinfo_log_warning("file operations without open, read, or close callback are ignored");
+		return false;
+	}
+	cpuinfo_lock_initialization();
+	const bool started = is_initialization_started();
+	if (started) {
+		cpuinfo_log_warning("file operations are not changed: cpuinfo is already initialized or being initialized");
+	} else if (ops == NULL) {
+		cpuinfo_file_ops = (struct cpuinfo_file_ops) { 0 };
+	} else {
+		cpuinfo_file_ops = *ops;
+	}
+	cpuinfo_unlock_initialization();
+	return !started;
 }
 
 void CPUINFO_ABI cpuinfo_deinitialize(void) {
+	/* The monitor thread re-initializes cpuinfo under the initialization lock, so it is stopped before taking it */
+	cpuinfo_stop_topology_monitor();
+	cpuinfo_lock_initialization();
+	cpuinfo_release_tables();
+	cpuinfo_arena_detach_buffer();
+	init_attempted = false;
+	/* Background threads which did not start initialization yet exit without initializing */
+	async_init_pending = 0;
+	cpuinfo_unlock_initialization();
 }
@@ -0,0 +1,436 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <pthread.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+static inline const struct cpuinfo_instruction_performance* load_instruction_performance(
+	const struct cpuinfo_tables* tables)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (const struct cpuinfo_instruction_performance*)
+		ReadPointerAcquire((PVOID volatile*) &tables->instruction_performance);
+#else
+	return __atomic_load_n(&tables->instruction_performance, __ATOMIC_ACQUIRE);
+#endif
+}
+
+const struct cpuinfo_instruction_performance* CPUINFO_ABI cpuinfo_get_uarch_instruction_performance(
+	uint32_t uarch_index)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_instruction_performance");
+	if CPUINFO_UNLIKELY(uarch_index >= tables->uarchs_count) {
+		return NULL;
+	}
+	const struct cpuinfo_instruction_performance* instruction_performance = load_instruction_performance(tables);
+	if (instruction_performance == NULL) {
+		return NULL;
+	}
+	return &instruction_performance[uarch_index];
+}
+
+#if defined(__linux__) && defined(__GNUC__) && (CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM64)
+	/* Loop iterations in one measurement, and in the warm-up which brings the core to its steady clock frequency */
+	#define ITERATIONS (UINT64_C(1) << 17)
+	#define WARMUP_ITERATIONS (UINT64_C(1) << 22)
+	/* Every measurement is repeated, and the fastest repetition is reported */
+	#define REPETITIONS 3
+	/* Instructions in one loop iteration: a dependent chain in latency kernels, and independent ones otherwise */
+	#define LATENCY_CHAIN 8
+	#define THROUGHPUT_CHAINS 12
+	/* Key of measurements of a microarchitecture in the tuning cache, and version of their record */
+	#define TUNING_KEY_FORMAT "cpuinfo.instructions/%"PRIu32
+	#define RECORD_VERSION 1
+
+	struct instruction_record {
+		uint32_t version;
+		struct cpuinfo_instruction_performance performance;
+	};
+
+	/* Loop of instructions which runs the number of iterations, reading the data if the instructions load */
+	typedef void (*kernel_function)(uint64_t iterations, const void* data);
+
+	struct kernel_pair {
+		kernel_function latency;
+		kernel_function throughput;
+	};
+
+	#define REPEAT4(instruction) instruction instruction instruction instruction
+	#define REPEAT_LATENCY(instruction) REPEAT4(instruction) REPEAT4(instruction)
+	#define REPEAT_THROUGHPUT(instruction) \
+		instruction(0) instruction(1) instruction(2) instruction(3) instruction(4) instruction(5) \
+		instruction(6) instruction(7) instruction(8) instruction(9) instruction(10) instruction(11)
+
+	#if CPUINFO_ARCH_X86_64
+		#define KERNEL(name, setup, body, teardown) \
+			static void name(uint64_t iterations, const void* data) { \
+				__asm__ __volatile__( \
+					setup \
+					".p2align 5\n" \
+					"1:\n\t" \
+					body \
+					"dec %[iterations]\n\t" \
+					"jnz 1b\n\t" \
+					teardown \
+					: [iterations] "+r" (iterations) \
+					: [data] "r" (data) \
+					: "rax", "rcx", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "xmm8", "xmm9", \
+						"xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15", "cc", "memory"); \
+			}
+		#define VECTOR_KERNEL(name, setup, body) \
+			KERNEL(name, REPEAT_THROUGHPUT(ZERO) ZERO(12) ZERO(13) setup, body, "vzeroupper\n\t")
+
+		#define ZERO(d) "vpxor %%xmm" #d ", %%xmm" #d ", %%xmm" #d "\n\t"
+		#define LOAD(d) "vmovdqa " #d "*32(%[data]), %%ymm" #d "\n\t"
+		#define FMA(d) "vfmadd231ps %%ymm12, %%ymm13, %%ymm" #d "\n\t"
+		/* VPDPBUSD ymm(d), ymm12, ymm13 in VEX (AVX-VNNI) and EVEX (AVX512-VNNI) encodings, for older assemblers */
+		#define DOT_VEX(d) ".byte 0xC4, 0xC2 - ((" #d " >> 3) << 7), 0x1D, 0x50, 0xC5 + ((" #d " & 7) << 3)\n\t"
+		#define DOT_EVEX(d) \
+			".byte 0x62, 0xD2 - ((" #d " >> 3) << 7), 0x1D, 0x28, 0x50, 0xC5 + ((" #d " & 7) << 3)\n\t"
+		#define MADD(d) "vpmaddubsw %%ymm13, %%ymm12, %%ymm" #d "\n\t"
+		#define SHUFFLE(d) "vpshufb %%ymm12, %%ymm13, %%ymm" #d "\n\t"
+		/* Gathers need a mask of all ones, which they clear */
+		#define GATHER(d) \
+			"vpcmpeqd %%ymm15, %%ymm15, %%ymm15\n\t" \
+			"vpgatherdd %%ymm15, (%[data], %%ymm14, 4), %%ymm" #d "\n\t"
+
+		KERNEL(add_latency, "xor %%eax, %%eax\n\tmov $1, %%ecx\n\t", REPEAT_LATENCY("add %%rcx, %%rax\n\t"), "")
+		KERNEL(load_latency, "mov %[data], %%rax\n\t", REPEAT_LATENCY("mov (%%rax), %%rax\n\t"), "")
+		VECTOR_KERNEL(load_throughput, "", REPEAT_THROUGHPUT(LOAD))
+		VECTOR_KERNEL(fma_latency, "", REPEAT_LATENCY("vfmadd231ps %%ymm12, %%ymm13, %%ymm0\n\t"))
+		VECTOR_KERNEL(fma_throughput, "", REPEAT_THROUGHPUT(FMA))
+		VECTOR_KERNEL(dot_vex_latency, "", REPEAT_LATENCY(DOT_VEX(0)))
+		VECTOR_KERNEL(dot_vex_throughput, "", REPEAT_THROUGHPUT(DOT_VEX))
+		VECTOR_KERNEL(dot_evex_latency, "", REPEAT_LATENCY(DOT_EVEX(0)))
+		VECTOR_KERNEL(dot_evex_throughput, "", REPEAT_THROUGHPUT(DOT_EVEX))
+		VECTOR_KERNEL(madd_latency, "", REPEAT_LATENCY("vpmaddubsw %%ymm13, %%ymm0, %%ymm0\n\t"))
+		VECTOR_KERNEL(madd_throughput, "", REPEAT_THROUGHPUT(MADD))
+		VECTOR_KERNEL(shuffle_latency, "", REPEAT_LATENCY("vpshufb %%ymm12, %%ymm0, %%ymm0\n\t"))
+		VECTOR_KERNEL(shuffle_throughput, "", REPEAT_THROUGHPUT(SHUFFLE))
+		/* Every gather takes its indices from the result of the previous one, which equals the indices */
+		VECTOR_KERNEL(gather_latency, "vmovdqa (%[data]), %%ymm0\n\t", REPEAT4(
+			"vpcmpeqd %%ymm15, %%ymm15, %%ymm15\n\t"
+			"vpgatherdd %%ymm15, (%[data], %%ymm0, 4), %%ymm1\n\t"
+			"vpcmpeqd %%ymm15, %%ymm15, %%ymm15\n\t"
+			"vpgatherdd %%ymm15, (%[data], %%ymm1, 4), %%ymm0\n\t"))
+		VECTOR_KERNEL(gather_throughput, "vmovdqa (%[data]), %%ymm14\n\t", REPEAT_THROUGHPUT(GATHER))
+	#elif CPUINFO_ARCH_ARM64
+		#define KERNEL(name, setup, body) \
+			static void name(uint64_t iterations, const void* data) { \
+				__asm__ __volatile__( \
+					setup \
+					".p2align 5\n" \
+					"1:\n\t" \
+					body \
+					"subs %[iterations], %[iterations], #1\n\t" \
+					"b.ne 1b\n\t" \
+					: [iterations] "+r" (iterations) \
+					: [data] "r" (data) \
+					: "x9", "x10", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9", "v10", "v11", \
+						"v16", "v17", "cc", "memory"); \
+			}
+		#define VECTOR_KERNEL(name, body) KERNEL(name, REPEAT_THROUGHPUT(ZERO) ZERO(16) ZERO(17), body)
+
+		#define ZERO(d) "movi v" #d ".16b, #0\n\t"
+		#define LOAD(d) "ldr q" #d ", [%[data], #" #d "*16]\n\t"
+		#define FMA(d) "fmla v" #d ".4s, v16.4s, v17.4s\n\t"
+		/* SDOT v(d).4S, v16.16B, v17.16B, for assemblers without the dot product extension */
+		#define DOT(d) ".inst 0x4E919600 + " #d "\n\t"
+		#define MADD(d) "smlal v" #d ".8h, v16.8b, v17.8b\n\t"
+		#define SHUFFLE(d) "tbl v" #d ".16b, {v16.16b}, v17.16b\n\t"
+
+		KERNEL(add_latency, "mov x9, xzr\n\tmov x10, #1\n\t", REPEAT_LATENCY("add x9, x9, x10\n\t"))
+		KERNEL(load_latency, "mov x9, %[data]\n\t", REPEAT_LATENCY("ldr x9, [x9]\n\t"))
+		VECTOR_KERNEL(load_throughput, REPEAT_THROUGHPUT(LOAD))
+		VECTOR_KERNEL(fma_latency, REPEAT_LATENCY("fmla v0.4s, v16.4s, v17.4s\n\t"))
+		VECTOR_KERNEL(fma_throughput, REPEAT_THROUGHPUT(FMA))
+		VECTOR_KERNEL(dot_latency, REPEAT_LATENCY(DOT(0)))
+		VECTOR_KERNEL(dot_throughput, REPEAT_THROUGHPUT(DOT))
+		VECTOR_KERNEL(madd_latency, REPEAT_LATENCY("smlal v0.8h, v16.8b, v17.8b\n\t"))
+		VECTOR_KERNEL(madd_throughput, REPEAT_THROUGHPUT(MADD))
+		VECTOR_KERNEL(shuffle_latency, REPEAT_LATENCY("tbl v0.16b, {v0.16b}, v17.16b\n\t"))
+		VECTOR_KERNEL(shuffle_throughput, REPEAT_THROUGHPUT(SHUFFLE))
+	#endif
+
+	struct probe_context {
+		const struct cpuinfo_processor* processor;
+		struct kernel_pair fma;
+		struct kernel_pair int8_dot;
+		struct kernel_pair shuffle;
+		struct kernel_pair gather;
+		struct kernel_pair load;
+		struct cpuinfo_instruction_performance* performance;
+		bool status;
+	};
+
+	/* Time of the fastest repetition of the kernel, in nanoseconds */
+	static uint64_t time_kernel(kernel_function kernel, const void* data) {
+		/* Warm up caches and TLB */
+		kernel(ITERATIONS / 16, data);
+		uint64_t min_time = UINT64_MAX;
+		for (uint32_t repetition = 0; repetition < REPETITIONS; repetition++) {
+			const uint64_t start = cpuinfo_get_timestamp_ns();
+			kernel(ITERATIONS, data);
+			const uint64_t time = cpuinfo_get_timestamp_ns() - start;
+			if (time < min_time) {
+				min_time = time;
+			}
+		}
+		return min_time != 0 ? min_time : 1;
+	}
+
+	static uint32_t to_hundredths(double value) {
+		const double hundredths = value * 100.0 + 0.5;
+		return hundredths < (double) UINT32_MAX ? (uint32_t) hundredths : UINT32_MAX;
+	}
+
+	/* Latency and throughput of the kernels in cycles, given the duration of a cycle in nanoseconds */
+	static struct cpuinfo_instruction_timing measure_timing(const struct kernel_pair kernels[restrict static 1],
+		const void* data, double cycle_time)
+	{
+		if (kernels->latency == NULL) {
+			return (struct cpuinfo_instruction_timing) { 0 };
+		}
+		const double latency_time = (double) time_kernel(kernels->latency, data);
+		const double throughput_time = (double) time_kernel(kernels->throughput, data);
+		return (struct cpuinfo_instruction_timing) {
+			.latency = to_hundredths(latency_time / (double) (ITERATIONS * LATENCY_CHAIN) / cycle_time),
+			.throughput = to_hundredths((double) (ITERATIONS * THROUGHPUT_CHAINS) * cycle_time / throughput_time),
+		};
+	}
+
+	static void* probe_processor(void* parameter) {
+		struct probe_context* context = (struct probe_context*) parameter;
+		if (!cpuinfo_pin_current_thread_to_processor(context->processor)) {
+			cpuinfo_log_warning("failed to pin instruction probe thread to processor %d: "
+				"measurements may be skewed", context->processor->linux_id);
+		}
+
+		/* Loads chase the pointer at the start of the buffer to itself, and gathers take indices equal to elements */
+		void* buffer[64] __attribute__((__aligned__(64))) = { 0 };
+		buffer[0] = &buffer[0];
+		uint32_t indices[16] __attribute__((__aligned__(64)));
+		for (uint32_t i = 0; i < CPUINFO_COUNT_OF(indices); i++) {
+			indices[i] = i;
+		}
+
+		/*
+		 * Dependent additions take one cycle on every supported core, and measure the clock. Additions of registers
+		 * rather than immediates, because some cores fold chains of immediate additions at register renaming.
+		 */
+		add_latency(WARMUP_ITERATIONS, NULL);
+		const double cycle_time = (double) time_kernel(add_latency, NULL) / (double) (ITERATIONS * LATENCY_CHAIN);
+		struct cpuinfo_instruction_performance* performance = context->performance;
+		performance->frequency = (uint64_t) (1.0e+9 / cycle_time);
+		performance->fma = measure_timing(&context->fma, NULL, cycle_time);
+		performance->int8_dot = measure_timing(&context->int8_dot, NULL, cycle_time);
+		performance->shuffle = measure_timing(&context->shuffle, NULL, cycle_time);
+		performance->gather = measure_timing(&context->gather, indices, cycle_time);
+		performance->load = measure_timing(&context->load, buffer, cycle_time);
+		context->status = true;
+		return NULL;
+	}
+
+	/* Usable logical processor of the first cluster of the microarchitecture, e.g. a big core of a big.LITTLE SoC */
+	static const struct cpuinfo_processor* get_representative_processor(const struct cpuinfo_tables* tables,
+		uint32_t uarch_index)
+	{
+		for (uint32_t i = 0; i < tables->clusters_count; i++) {
+			const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+			const struct cpuinfo_processor* first_processor = &tables->processors[cluster->processor_start];
+			if (cluster->processor_count == 0 ||
+				cpuinfo_get_processor_uarch_index(tables, first_processor) != uarch_index)
+			{
+				continue;
+			}
+			for (uint32_t j = 0; j < cluster->processor_count; j++) {
+				if (first_processor[j].usable) {
+					return &first_processor[j];
+				}
+			}
+		}
+		return NULL;
+	}
+
+	/* Choose the kernels which cores of the microarchitecture can run, by their ISA features */
+	static void select_kernels(const struct cpuinfo_isa_features features[restrict static 1],
+		struct probe_context context[restrict static 1])
+	{
+		struct cpuinfo_instruction_performance* performance = context->performance;
+		#if CPUINFO_ARCH_X86_64
+			if (!cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx2)) {
+				return;
+			}
+			performance->vector_width = 256;
+			if (cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_fma3)) {
+				context->fma = (struct kernel_pair) { fma_latency, fma_throughput };
+			}
+			if (cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avxvnni)) {
+				context->int8_dot = (struct kernel_pair) { dot_vex_latency, dot_vex_throughput };
+				performance->native_int8_dot = true;
+			} else if (cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx512vnni) &&
+				cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx512vl))
+			{
+				context->int8_dot = (struct kernel_pair) { dot_evex_latency, dot_evex_throughput };
+				performance->native_int8_dot = true;
+			} else {
+				context->int8_dot = (struct kernel_pair) { madd_latency, madd_throughput };
+			}
+			context->shuffle = (struct kernel_pair) { shuffle_latency, shuffle_throughput };
+			context->gather = (struct kernel_pair) { gather_latency, gather_throughput };
+		#elif CPUINFO_ARCH_ARM64
+			/* NEON with vector FMA is a part of the base ARMv8 architecture */
+			performance->vector_width = 128;
+			context->fma = (struct kernel_pair) { fma_latency, fma_throughput };
+			if (cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_arm_neon_dot)) {
+				context->int8_dot = (struct kernel_pair) { dot_latency, dot_throughput };
+				performance->native_int8_dot = true;
+			} else {
+				context->int8_dot = (struct kernel_pair) { madd_latency, madd_throughput };
+			}
+			context->shuffle = (struct kernel_pair) { shuffle_latency, shuffle_throughput };
+		#endif
+		context->load = (struct kernel_pair) { load_latency, load_throughput };
+	}
+
+	/* Log measurements which disagree with the static cost model by more than half a cycle */
+	static void check_cost_model(uint32_t uarch_index, const char* parameter, uint32_t measured, uint32_t expected) {
+		if (measured != 0 && expected != 0 && (measured + 50) / 100 != expected) {
+			cpuinfo_log_info("measured %s of microarchitecture %"PRIu32" is %"PRIu32".%02"PRIu32", "
+				"but cost model has %"PRIu32, parameter, uarch_index, measured / 100, measured % 100, expected);
+		}
+	}
+
+	static bool probe_uarch(const struct cpuinfo_tables* tables, uint32_t uarch_index,
+		struct cpuinfo_instruction_performance performance[restrict static 1])
+	{
+		const struct cpuinfo_processor* processor = get_representative_processor(tables, uarch_index);
+		struct cpuinfo_isa_features features;
+		if (processor == NULL || !cpuinfo_get_uarch_isa_features(uarch_index, &features)) {
+			cpuinfo_log_warning("no usable processor to measure microarchitecture %"PRIu32, uarch_index);
+			return false;
+		}
+		struct probe_context context = {
+			.processor = processor,
+			.performance = performance,
+		};
+		select_kernels(&features, &context);
+
+		/* The measurement runs in a separate thread to keep the affinity of the calling thread */
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, probe_processor, &context) != 0) {
+			cpuinfo_log_error("failed to create instruction probe thread");
+			return false;
+		}
+		pthread_join(thread, NULL);
+		if (!context.status) {
+			return false;
+		}
+		cpuinfo_log_debug("uarch %"PRIu32" at %"PRIu64" MHz: latency/throughput in 1/100 cycles of "
+			"FMA %"PRIu32"/%"PRIu32", INT8 %"PRIu32"/%"PRIu32", shuffle %"PRIu32"/%"PRIu32", "
+			"gather %"PRIu32"/%"PRIu32", load %"PRIu32"/%"PRIu32,
+			uarch_index, performance->frequency / 1000000, performance->fma.latency, performance->fma.throughput,
+			performance->int8_dot.latency, performance->int8_dot.throughput,
+			performance->shuffle.latency, performance->shuffle.throughput,
+			performance->gather.latency, performance->gather.throughput,
+			performance->load.latency, performance->load.throughput);
+
+		const struct cpuinfo_uarch_cost_model* cost_model = cpuinfo_get_uarch_cost_model(processor->core->uarch);
+		if (cost_model != NULL) {
+			check_cost_model(uarch_index, "FMA latency", performance->fma.latency, cost_model->fma_latency);
+			check_cost_model(uarch_index, "L1D latency", performance->load.latency, cost_model->l1d_latency);
+			/* Vectors wider than the pipes are split, and take several pipes */
+			if (cost_model->vector_pipe_width >= performance->vector_width) {
+				check_cost_model(uarch_index, "FMA throughput", performance->fma.throughput, cost_model->fma_units);
+			}
+		}
+		return true;
+	}
+
+	static bool format_tuning_key(char key[restrict static CPUINFO_TUNING_KEY_MAX], uint32_t uarch_index) {
+		const int length = snprintf(key, CPUINFO_TUNING_KEY_MAX, TUNING_KEY_FORMAT, uarch_index);
+		return length > 0 && length < CPUINFO_TUNING_KEY_MAX;
+	}
+
+	static bool load_record(uint32_t uarch_index,
+		struct cpuinfo_instruction_performance performance[restrict static 1])
+	{
+		char key[CPUINFO_TUNING_KEY_MAX];
+		struct instruction_record record;
+		size_t size = sizeof(record);
+		if (!format_tuning_key(key, uarch_index) || !cpuinfo_tuning_get(key, &record, &size) ||
+			size != sizeof(record) || record.version != RECORD_VERSION)
+		{
+			return false;
+		}
+		*performance = record.performance;
+		return true;
+	}
+
+	static void store_record(uint32_t uarch_index, const struct cpuinfo_instruction_performance* performance) {
+		char key[CPUINFO_TUNING_KEY_MAX];
+		struct instruction_record record;
+		/* Padding bytes are written into the file too */
+		memset(&record, 0, sizeof(record));
+		record.version = RECORD_VERSION;
+		record.performance = *performance;
+		if (!format_tuning_key(key, uarch_index) || !cpuinfo_tuning_put(key, &record, sizeof(record))) {
+			cpuinfo_log_debug("failed to record instruction performance of microarchitecture %"PRIu32, uarch_index);
+		}
+	}
+
+	bool CPUINFO_ABI cpuinfo_probe_instruction_performance(void) {
+		cpuinfo_get_tables("probe_instruction_performance");
+		cpuinfo_lock_initialization();
+		struct cpuinfo_tables* tables = cpuinfo_load_tables();
+		bool status = tables != NULL && tables->instruction_performance != NULL;
+		if (tables != NULL && !status) {
+			if (cpuinfo_replaying_capture) {
+				cpuinfo_log_error("can't measure instruction performance of a replayed system");
+				goto unlock;
+			}
+			struct cpuinfo_instruction_performance* instruction_performance =
+				calloc(tables->uarchs_count, sizeof(struct cpuinfo_instruction_performance));
+			if (instruction_performance == NULL) {
+				cpuinfo_log_error("failed to allocate %zu bytes for instruction performance of %"PRIu32" "
+					"microarchitectures", tables->uarchs_count * sizeof(struct cpuinfo_instruction_performance),
+					tables->uarchs_count);
+				goto unlock;
+			}
+			for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+				if (load_record(i, &instruction_performance[i])) {
+					continue;
+				}
+				if (!probe_uarch(tables, i, &instruction_performance[i])) {
+					cpuinfo_log_error("failed to measure instruction performance of microarchitecture %"PRIu32, i);
+					free(instruction_performance);
+					goto unlock;
+				}
+				store_record(i, &instruction_performance[i]);
+			}
+			tables->instruction_performance_memory = instruction_performance;
+			__atomic_store_n(&tables->instruction_performance, instruction_performance, __ATOMIC_RELEASE);
+			status = true;
+		}
+	unlock:
+		cpuinfo_unlock_initialization();
+		return status;
+	}
+#else
+	bool CPUINFO_ABI cpuinfo_probe_instruction_performance(void) {
+		cpuinfo_get_tables("probe_instruction_performance");
+		cpuinfo_log_info("instruction performance probe is not supported on this platform");
+		return false;
+	}
+#endif
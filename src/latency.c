@@ -0,0 +1,199 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+const uint32_t* cpuinfo_core_latencies = NULL;
+
+static inline const uint32_t* load_core_latencies(const struct cpuinfo_tables* tables) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (const uint32_t*) ReadPointerAcquire((PVOID volatile*) &tables->core_latencies);
+#else
+	return __atomic_load_n(&tables->core_latencies, __ATOMIC_ACQUIRE);
+#endif
+}
+
+const uint32_t* CPUINFO_ABI cpuinfo_get_core_latencies(void) {
+	return load_core_latencies(cpuinfo_get_tables("core_latencies"));
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_processor_latency(const struct cpuinfo_processor* source,
+	const struct cpuinfo_processor* target)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("processor_latency");
+	if CPUINFO_UNLIKELY(source == NULL || target == NULL || source == target) {
+		return 0;
+	}
+	const uint32_t* core_latencies = load_core_latencies(tables);
+	if (core_latencies == NULL) {
+		return 0;
+	}
+	const uint32_t source_core = (uint32_t) (source->core - tables->cores);
+	const uint32_t target_core = (uint32_t) (target->core - tables->cores);
+	if CPUINFO_UNLIKELY(source_core >= tables->cores_count || target_core >= tables->cores_count) {
+		return 0;
+	}
+	return core_latencies[source_core * tables->cores_count + target_core];
+}
+
+#if defined(__linux__)
+	/* Number of round trips of the cache line in one measurement, after as many round trips of warm-up */
+	#define ROUND_TRIPS 1000
+	/* Every measurement is repeated, and the fastest repetition is reported */
+	#define REPETITIONS 3
+
+	struct bounce_state {
+		/* The cache line which bounces between the processors, aligned to avoid false sharing with the flags */
+		uint64_t counter __attribute__((__aligned__(128)));
+		uint32_t ready_count __attribute__((__aligned__(128)));
+		bool failed;
+	};
+
+	struct bounce_context {
+		const struct cpuinfo_processor* processor;
+		struct bounce_state* state;
+		/* Odd values are written by the initiator and even values by the responder */
+		uint64_t first_value;
+		uint64_t elapsed_ns;
+	};
+
+	static bool wait_for_partner(struct bounce_state* state) {
+		__atomic_fetch_add(&state->ready_count, 1, __ATOMIC_ACQ_REL);
+		while (__atomic_load_n(&state->ready_count, __ATOMIC_ACQUIRE) != 2) {
+			if (__atomic_load_n(&state->failed, __ATOMIC_ACQUIRE)) {
+				return false;
+			}
+			sched_yield();
+		}
+		return true;
+	}
+
+	static void bounce(struct bounce_state* state, uint64_t first_value, uint64_t round_trips) {
+		for (uint64_t value = first_value; value < first_value + 2 * round_trips; value += 2) {
+			while (__atomic_load_n(&state->counter, __ATOMIC_ACQUIRE) != value - 1) {
+				/* Spin on the watched line without hints: the measurement includes only the transfer */
+			}
+			__atomic_store_n(&state->counter, value, __ATOMIC_RELEASE);
+		}
+	}
+
+	static void* bounce_processor(void* parameter) {
+		struct bounce_context* context = (struct bounce_context*) parameter;
+		if (!cpuinfo_pin_current_thread_to_processor(context->processor)) {
+			__atomic_store_n(&context->state->failed, true, __ATOMIC_RELEASE);
+			return NULL;
+		}
+		if (!wait_for_partner(context->state)) {
+			return NULL;
+		}
+		bounce(context->state, context->first_value, ROUND_TRIPS);
+		const uint64_t start = cpuinfo_get_timestamp_ns();
+		bounce(context->state, context->first_value + 2 * ROUND_TRIPS, ROUND_TRIPS);
+		context->elapsed_ns = cpuinfo_get_timestamp_ns() - start;
+		return NULL;
+	}
+
+	/* One-way latency of a cache line transfer between two logical processors in picoseconds, or 0 on failure */
+	static uint32_t measure_latency(const struct cpuinfo_processor* initiator,
+		const struct cpuinfo_processor* responder)
+	{
+		uint32_t latency = 0;
+		for (uint32_t repetition = 0; repetition < REPETITIONS; repetition++) {
+			struct bounce_state state = { 0 };
+			/* The initiator stores 1 after seeing the initial 0, and the responder stores 2 after seeing 1 */
+			struct bounce_context contexts[2] = {
+				{ .processor = initiator, .state = &state, .first_value = 1 },
+				{ .processor = responder, .state = &state, .first_value = 2 },
+			};
+			pthread_t threads[2];
+			if (pthread_create(&threads[0], NULL, bounce_processor, &contexts[0]) != 0) {
+				cpuinfo_log_error("failed to create core latency probe thread");
+				return 0;
+			}
+			if (pthread_create(&threads[1], NULL, bounce_processor, &contexts[1]) != 0) {
+				cpuinfo_log_error("failed to create core latency probe thread");
+				__atomic_store_n(&state.failed, true, __ATOMIC_RELEASE);
+				pthread_join(threads[0], NULL);
+				return 0;
+			}
+			pthread_join(threads[0], NULL);
+			pthread_join(threads[1], NULL);
+			if (state.failed) {
+				cpuinfo_log_error("failed to pin core latency probe threads to processors %"PRIu32" and %"PRIu32,
+					initiator->linux_id, responder->linux_id);
+				return 0;
+			}
+			/* Every round trip consists of two one-way transfers */
+			const uint64_t picoseconds = contexts[0].elapsed_ns * UINT64_C(1000) / (2 * ROUND_TRIPS);
+			const uint32_t measurement = picoseconds > UINT32_MAX ? UINT32_MAX : (uint32_t) picoseconds;
+			if (latency == 0 || measurement < latency) {
+				latency = measurement;
+			}
+		}
+		/* 0 is reserved for the absent measurements */
+		return latency != 0 ? latency : 1;
+	}
+
+	bool CPUINFO_ABI cpuinfo_probe_core_latencies(void) {
+		cpuinfo_get_tables("probe_core_latencies");
+		cpuinfo_lock_initialization();
+		struct cpuinfo_tables* tables = cpuinfo_load_tables();
+		bool status = tables != NULL && tables->core_latencies != NULL;
+		if (tables != NULL && !status) {
+			const uint32_t cores_count = tables->cores_count;
+			uint32_t* core_latencies = calloc((size_t) cores_count * cores_count, sizeof(uint32_t));
+			if (core_latencies == NULL) {
+				cpuinfo_log_error("failed to allocate %zu bytes for latencies between %"PRIu32" cores",
+					(size_t) cores_count * cores_count * sizeof(uint32_t), cores_count);
+				goto unlock;
+			}
+			/* The first logical processor represents its core; the diagonal holds latencies between SMT siblings */
+			for (uint32_t i = 0; i < cores_count; i++) {
+				const struct cpuinfo_core* core = &tables->cores[i];
+				const struct cpuinfo_processor* processor = &tables->processors[core->processor_start];
+				for (uint32_t j = 0; j < cores_count; j++) {
+					const struct cpuinfo_processor* partner = &tables->processors[tables->cores[j].processor_start];
+					if (i == j) {
+						if (core->processor_count < 2) {
+							continue;
+						}
+						partner = processor + 1;
+					} else if (j < i) {
+						/* Transfers in both directions take the same path */
+						core_latencies[i * cores_count + j] = core_latencies[j * cores_count + i];
+						continue;
+					}
+					const uint32_t latency = measure_latency(processor, partner);
+					if (latency == 0) {
+						free(core_latencies);
+						goto unlock;
+					}
+					core_latencies[i * cores_count + j] = latency;
+				}
+			}
+			tables->core_latencies_memory = core_latencies;
+			__atomic_store_n(&tables->core_latencies, core_latencies, __ATOMIC_RELEASE);
+			status = true;
+		}
+	unlock:
+		cpuinfo_unlock_initialization();
+		return status;
+	}
+#else
+	bool CPUINFO_ABI cpuinfo_probe_core_latencies(void) {
+		cpuinfo_get_tables("probe_core_latencies");
+		cpuinfo_log_info("core latency probe is not supported on this platform");
+		return false;
+	}
+#endif
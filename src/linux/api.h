@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <sys/types.h>
+
 #include <cpuinfo.h>
 #include <cpuinfo/common.h>
 
@@ -21,6 +23,63 @@
 #define CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER    UINT32_C(0x00000400)
 #define CPUINFO_LINUX_FLAG_PROC_CPUINFO       UINT32_C(0x00000800)
 #define CPUINFO_LINUX_FLAG_VALID              UINT32_C(0x00001000)
+#define CPUINFO_LINUX_FLAG_CAPACITY           UINT32_C(0x00002000)
+#define CPUINFO_LINUX_FLAG_CLUSTER_ID         UINT32_C(0x00004000)
+
+/* Methods to identify the logical processor which executes the current thread */
+enum cpuinfo_linux_current_cpu_method {
+	/* getcpu system call */
+	cpuinfo_linux_current_cpu_method_syscall = 0,
+	/* RDPID instruction, which reads TSC_AUX MSR initialized by Linux */
+	cpuinfo_linux_current_cpu_method_rdpid = 1,
+	/* RDTSCP instruction, which reads TSC_AUX MSR initialized by Linux together with the timestamp counter */
+	cpuinfo_linux_current_cpu_method_rdtscp = 2,
+	/* cpu_id field of the restartable sequences area, which glibc 2.35+ registers for every thread */
+	cpuinfo_linux_current_cpu_method_rseq = 3,
+	/* getcpu function in the vDSO, which reads the processor number without entering the kernel */
+	cpuinfo_linux_current_cpu_method_vdso = 4,
+};
+
+/* Offset of cpu_id in struct rseq: the kernel updates it whenever the thread is scheduled on another processor */
+#define CPUINFO_LINUX_RSEQ_CPU_ID_OFFSET 4
+
+/* Location of struct rseq relative to the thread pointer and its size, exported by glibc 2.35+ */
+extern const ptrdiff_t __rseq_offset __attribute__((__weak__));
+extern const unsigned int __rseq_size __attribute__((__weak__));
+
+static inline const char* cpuinfo_linux_thread_pointer(void) {
+	const char* thread_pointer;
+	#if CPUINFO_ARCH_X86_64
+		__asm__("mov %%fs:0, %0" : "=r" (thread_pointer));
+	#elif CPUINFO_ARCH_X86
+		__asm__("mov %%gs:0, %0" : "=r" (thread_pointer));
+	#elif CPUINFO_ARCH_ARM64
+		__asm__("mrs %0, tpidr_el0" : "=r" (thread_pointer));
+	#elif CPUINFO_ARCH_ARM
+		__asm__("mrc p15, 0, %0, c13, c0, 3" : "=r" (thread_pointer));
+	#else
+		thread_pointer = (const char*) __builtin_thread_pointer();
+	#endif
+	return thread_pointer;
+}
+
+/*
+ * Read the processor number from the rseq area of the calling thread.
+ * Returns a negative value if rseq is not registered for this thread.
+ * Must be called only if cpuinfo_linux_rseq_is_registered returned true.
+ */
+static inline int32_t cpuinfo_linux_read_rseq_cpu_id(void) {
+	return *((const volatile int32_t*) (cpuinfo_linux_thread_pointer() + __rseq_offset + CPUINFO_LINUX_RSEQ_CPU_ID_OFFSET));
+}
+
+/* Check that the C library registered the rseq area for the calling thread */
+CPUINFO_INTERNAL bool cpuinfo_linux_rseq_is_registered(void);
+
+/* getcpu implementation in the vDSO, or NULL if cpuinfo_linux_resolve_vdso_getcpu did not find one */
+typedef int (*cpuinfo_getcpu_function)(unsigned*, unsigned*, void*);
+extern CPUINFO_INTERNAL cpuinfo_getcpu_function cpuinfo_linux_vdso_getcpu;
+/* Look up getcpu in the vDSO mapped by the kernel and store it in cpuinfo_linux_vdso_getcpu */
+CPUINFO_INTERNAL bool cpuinfo_linux_resolve_vdso_getcpu(void);
 
 
 typedef bool (*cpuinfo_cpulist_callback)(uint32_t, uint32_t, void*);
@@ -29,14 +88,136 @@ typedef bool (*cpuinfo_smallfile_callback)(const char*, const char*, void*);
 CPUINFO_INTERNAL bool cpuinfo_linux_parse_small_file(const char* filename, size_t buffer_size, cpuinfo_smallfile_callback, void* context);
 typedef bool (*cpuinfo_line_callback)(const char*, const char*, void*, uint64_t);
 CPUINFO_INTERNAL bool cpuinfo_linux_parse_multiline_file(const char* filename, size_t buffer_size, cpuinfo_line_callback, void* context);
+/* Lines with keys in NULL-terminated skip_keys list are neither split nor passed to the callback, and may exceed the buffer */
+typedef bool (*cpuinfo_key_value_callback)(const char*, const char*, const char*, const char*, void*, uint64_t);
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_key_value_file(const char* filename, size_t buffer_size,
+	const char* const* skip_keys, cpuinfo_key_value_callback callback, void* context);
+/*
+ * Open, read, and close procfs and sysfs files through the file operations of cpuinfo_set_file_ops, the mock
+ * filesystem in mock builds, or the system calls.
+ */
+CPUINFO_INTERNAL int cpuinfo_linux_open_file(const char* path, int flags);
+CPUINFO_INTERNAL ssize_t cpuinfo_linux_read_file(int file, void* buffer, size_t size);
+CPUINFO_INTERNAL void cpuinfo_linux_close_file(int file);
+/*
+ * Reuse one read buffer on the calling thread for all file reads until the matching end call, e.g. for an
+ * initialization. Scopes nest, and the buffer is freed when the outermost scope ends.
+ */
+CPUINFO_INTERNAL void cpuinfo_linux_begin_file_reads(void);
+CPUINFO_INTERNAL void cpuinfo_linux_end_file_reads(void);
+/* Acquire a buffer of at least size bytes for a file read, or NULL on allocation failure */
+CPUINFO_INTERNAL char* cpuinfo_linux_acquire_read_buffer(size_t size);
+CPUINFO_INTERNAL void cpuinfo_linux_release_read_buffer(char* buffer);
+/* Account a file opened by cpuinfo and the bytes read from it in statistics of a running initialization; thread-safe */
+CPUINFO_INTERNAL void cpuinfo_linux_record_file_read(size_t bytes_read);
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_cpulist_descriptor(int file, const char* filename, cpuinfo_cpulist_callback callback, void* context);
+/*
+ * With single_read, a read shorter than requested ends the file: sysfs produces an attribute with one show() call,
+ * and reading the end of file would cost another system call.
+ */
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_small_file_descriptor(int file, const char* filename, bool single_read,
+	char* buffer, size_t buffer_size, cpuinfo_smallfile_callback callback, void* context);
+
+#define CPUINFO_LINUX_CGROUP_PATH_MAX 4096
+#define CPUINFO_LINUX_CGROUP_CONTROLLER_MAX 32
+
+/* cgroup of the calling process with a controller, in a hierarchy mounted in /sys/fs/cgroup */
+struct cpuinfo_linux_cgroup {
+	/* Directory of the cgroup */
+	char path[CPUINFO_LINUX_CGROUP_PATH_MAX];
+	/* Length of the mount point of the hierarchy at the start of path */
+	uint32_t mount_length;
+	/* Whether the cgroup is in the unified (v2) hierarchy rather than in a v1 hierarchy of the controller */
+	bool unified;
+};
+
+/* Find the cgroup of the calling process with the controller via /proc/self/cgroup; v1 hierarchies take precedence */
+CPUINFO_INTERNAL bool cpuinfo_linux_find_cgroup(const char* controller, struct cpuinfo_linux_cgroup cgroup[restrict static 1]);
+/* Parse a file in the directory of the cgroup */
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_cgroup_small_file(const struct cpuinfo_linux_cgroup cgroup[restrict static 1],
+	const char* name, size_t buffer_size, cpuinfo_smallfile_callback callback, void* context);
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_cgroup_cpulist(const struct cpuinfo_linux_cgroup cgroup[restrict static 1],
+	const char* name, cpuinfo_cpulist_callback callback, void* context);
+
+/*
+ * Parse a file in /sys/devices/system/cpu/cpuN directory for processor N.
+ * Directory file descriptors are cached, and the files are opened relative to them.
+ * Cached descriptors are closed in cpuinfo_linux_release_sysfs.
+ */
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_processor_small_file(uint32_t processor, const char* name,
+	size_t buffer_size, cpuinfo_smallfile_callback callback, void* context);
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_processor_cpulist(uint32_t processor, const char* name,
+	cpuinfo_cpulist_callback callback, void* context);
+CPUINFO_INTERNAL void cpuinfo_linux_release_sysfs(void);
+/* List names of entries of a directory, without heap allocations of readdir; the callback returns false to stop */
+typedef bool (*cpuinfo_directory_callback)(const char*, void*);
+CPUINFO_INTERNAL bool cpuinfo_linux_scan_directory(const char* path, cpuinfo_directory_callback callback, void* context);
+
+/*
+ * Call function for every processor in [0, processors_count).
+ * If parallel probing is enabled, processors are distributed across a small pool of threads,
+ * so the function must not modify state shared between processors.
+ */
+typedef void (*cpuinfo_processor_function)(uint32_t, void*);
+CPUINFO_INTERNAL void cpuinfo_linux_parallel_for_processors(uint32_t processors_count,
+	cpuinfo_processor_function function, void* context);
 
 CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_max_processors_count(void);
 CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_max_possible_processor(uint32_t max_processors_count);
 CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_max_present_processor(uint32_t max_processors_count);
 CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_processor_min_frequency(uint32_t processor);
 CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_processor_max_frequency(uint32_t processor);
+/* Base (non-Turbo) frequency in KHz from cpufreq base_frequency or ACPI CPPC nominal_freq, or 0 if unknown */
+CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_processor_base_frequency(uint32_t processor);
+CPUINFO_INTERNAL uint32_t cpuinfo_linux_get_processor_capacity(uint32_t processor);
 CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_package_id(uint32_t processor, uint32_t package_id[restrict static 1]);
 CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_core_id(uint32_t processor, uint32_t core_id[restrict static 1]);
+/* Die ID within the package, or false on kernels without topology/die_id */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_die_id(uint32_t processor, uint32_t die_id[restrict static 1]);
+/* Parse the list of hardware threads of the core, from core_cpus_list or thread_siblings_list on older kernels */
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_processor_core_cpus(uint32_t processor,
+	cpuinfo_cpulist_callback callback, void* context);
+/* MIDR from sysfs, which reports it even for offline processors, or false if the kernel doesn't expose it */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_midr(uint32_t processor, uint32_t midr[restrict static 1]);
+/* Microcode revision from sysfs on x86, or false if the kernel doesn't expose it */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_microcode_revision(uint32_t processor,
+	uint32_t revision[restrict static 1]);
+
+enum cpuinfo_linux_cache_type {
+	cpuinfo_linux_cache_type_unknown = 0,
+	cpuinfo_linux_cache_type_data,
+	cpuinfo_linux_cache_type_instruction,
+	cpuinfo_linux_cache_type_unified,
+};
+
+/* Cache described in /sys/devices/system/cpu/cpuN/cache/indexK; parameters which Linux doesn't report are 0 */
+struct cpuinfo_linux_cache {
+	uint32_t level;
+	enum cpuinfo_linux_cache_type type;
+	uint32_t size;
+	uint32_t associativity;
+	uint32_t sets;
+	uint32_t partitions;
+	uint32_t line_size;
+};
+
+/* Maximum number of cache/indexK directories of a processor */
+#define CPUINFO_LINUX_MAX_CACHE_INDICES 8
+
+/* Returns false if processor has no cache with this index, i.e. it has caches with indices [0, index) */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_cache(uint32_t processor, uint32_t index,
+	struct cpuinfo_linux_cache cache[restrict static 1]);
+/* ID of the cache with this index among the caches of its level, from cache/indexK/id, as in resctrl domain names */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_cache_id(uint32_t processor, uint32_t index,
+	uint32_t cache_id[restrict static 1]);
+/* Parse the list of processors which share the cache with this index with the processor */
+CPUINFO_INTERNAL bool cpuinfo_linux_parse_processor_cache_siblings(uint32_t processor, uint32_t index,
+	cpuinfo_cpulist_callback callback, void* context);
+
+/* SMT control in /sys/devices/system/cpu/smt/control, or cpuinfo_smt_control_unknown if the kernel doesn't report it */
+CPUINFO_INTERNAL enum cpuinfo_smt_control cpuinfo_linux_get_smt_control(void);
+/* Whether SMT siblings are online, from /sys/devices/system/cpu/smt/active, or false if the kernel doesn't report it */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_smt_active(bool active_ptr[restrict static 1]);
 
 CPUINFO_INTERNAL bool cpuinfo_linux_detect_possible_processors(uint32_t max_processors_count,
 	uint32_t* processor0_flags, uint32_t processor_struct_size, uint32_t possible_flag);
@@ -54,6 +235,22 @@ CPUINFO_INTERNAL bool cpuinfo_linux_detect_thread_siblings(
 	uint32_t processor,
 	cpuinfo_siblings_callback callback,
 	void* context);
+/* Cluster ID from topology/cluster_id of kernels 5.16+, or false if firmware doesn't assign the processor a cluster */
+CPUINFO_INTERNAL bool cpuinfo_linux_get_processor_cluster_id(
+	uint32_t processor,
+	uint32_t cluster_id[restrict static 1]);
+/* Parse cluster siblings in topology/cluster_cpus_list */
+CPUINFO_INTERNAL bool cpuinfo_linux_detect_cluster_siblings(
+	uint32_t max_processors_count,
+	uint32_t processor,
+	cpuinfo_siblings_callback callback,
+	void* context);
+/* Parse processors of the same cpufreq policy in cpufreq/related_cpus */
+CPUINFO_INTERNAL bool cpuinfo_linux_detect_frequency_siblings(
+	uint32_t max_processors_count,
+	uint32_t processor,
+	cpuinfo_siblings_callback callback,
+	void* context);
 
 extern CPUINFO_INTERNAL const struct cpuinfo_processor** cpuinfo_linux_cpu_to_processor_map;
 extern CPUINFO_INTERNAL const struct cpuinfo_core** cpuinfo_linux_cpu_to_core_map;
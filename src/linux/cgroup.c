@@ -0,0 +1,177 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <linux/api.h>
+#include <cpuinfo/log.h>
+
+
+#define CGROUP_FILENAME "/proc/self/cgroup"
+#define CGROUP_MOUNT_ROOT "/sys/fs/cgroup"
+/* Lines of /proc/self/cgroup contain paths, and are at most PATH_MAX long */
+#define CGROUP_BUFFER_SIZE CPUINFO_LINUX_CGROUP_PATH_MAX
+
+struct cgroup_parser_context {
+	const char* controller;
+	size_t controller_length;
+	struct cpuinfo_linux_cgroup* cgroup;
+	bool found_v1;
+	bool found_v2;
+	/* Path of the cgroup in the unified hierarchy, used only if no v1 hierarchy has the controller */
+	char v2_path_buffer[CPUINFO_LINUX_CGROUP_PATH_MAX];
+};
+
+static inline bool has_controller(const char* controllers_start, const char* controllers_end,
+	const char* controller, size_t controller_length)
+{
+	/* Controllers of a cgroup v1 hierarchy are separated by commas, e.g. "cpu,cpuacct" */
+	const char* name_start = controllers_start;
+	while (name_start != controllers_end) {
+		const char* name_end = name_start;
+		while (name_end != controllers_end && *name_end != ',') {
+			name_end++;
+		}
+		if ((size_t) (name_end - name_start) == controller_length &&
+			memcmp(name_start, controller, controller_length) == 0)
+		{
+			return true;
+		}
+		name_start = name_end == controllers_end ? name_end : name_end + 1;
+	}
+	return false;
+}
+
+static bool set_cgroup_path(struct cpuinfo_linux_cgroup cgroup[restrict static 1],
+	const char* mount_start, size_t mount_length, const char* path_start, const char* path_end)
+{
+	const size_t path_length = (size_t) (path_end - path_start);
+	if (mount_length + path_length >= CPUINFO_LINUX_CGROUP_PATH_MAX) {
+		return false;
+	}
+	memcpy(cgroup->path, mount_start, mount_length);
+	memcpy(cgroup->path + mount_length, path_start, path_length);
+	/* Root cgroup is reported as "/": strip trailing slashes */
+	size_t length = mount_length + path_length;
+	while (length > mount_length && cgroup->path[length - 1] == '/') {
+		length--;
+	}
+	cgroup->path[length] = '\0';
+	cgroup->mount_length = (uint32_t) mount_length;
+	return true;
+}
+
+/* Lines look like "hierarchy-ID:controller-list:cgroup-path", with "0::cgroup-path" for the unified hierarchy */
+static bool parse_cgroup_line(const char* line_start, const char* line_end, void* context, uint64_t line_number) {
+	struct cgroup_parser_context* parser_context = (struct cgroup_parser_context*) context;
+	const char* controllers_start = memchr(line_start, ':', (size_t) (line_end - line_start));
+	if (controllers_start == NULL) {
+		return true;
+	}
+	controllers_start += 1;
+	const char* controllers_end = memchr(controllers_start, ':', (size_t) (line_end - controllers_start));
+	if (controllers_end == NULL) {
+		return true;
+	}
+	const char* path_start = controllers_end + 1;
+
+	if (controllers_start == controllers_end) {
+		/* Unified hierarchy */
+		if (controllers_start - line_start == 2 && line_start[0] == '0') {
+			const size_t path_length = (size_t) (line_end - path_start);
+			if (path_length < CPUINFO_LINUX_CGROUP_PATH_MAX) {
+				memcpy(parser_context->v2_path_buffer, path_start, path_length);
+				parser_context->v2_path_buffer[path_length] = '\0';
+				parser_context->found_v2 = true;
+			}
+		}
+		return true;
+	}
+
+	if (has_controller(controllers_start, controllers_end, parser_context->controller, parser_context->controller_length)) {
+		/* Hierarchy with the controller is mounted in /sys/fs/cgroup/<controller>, possibly as a symlink */
+		char mount[sizeof(CGROUP_MOUNT_ROOT "/") + CPUINFO_LINUX_CGROUP_CONTROLLER_MAX];
+		if (parser_context->controller_length >= CPUINFO_LINUX_CGROUP_CONTROLLER_MAX) {
+			return false;
+		}
+		memcpy(mount, CGROUP_MOUNT_ROOT "/", sizeof(CGROUP_MOUNT_ROOT "/") - 1);
+		memcpy(mount + sizeof(CGROUP_MOUNT_ROOT "/") - 1, parser_context->controller, parser_context->controller_length);
+		const size_t mount_length = sizeof(CGROUP_MOUNT_ROOT "/") - 1 + parser_context->controller_length;
+		if (set_cgroup_path(parser_context->cgroup, mount, mount_length, path_start, line_end)) {
+			parser_context->cgroup->unified = false;
+			parser_context->found_v1 = true;
+		}
+		/* Stop parsing: v1 hierarchy takes precedence over the unified hierarchy */
+		return false;
+	}
+	return true;
+}
+
+bool cpuinfo_linux_find_cgroup(const char* controller, struct cpuinfo_linux_cgroup cgroup[restrict static 1]) {
+	struct cgroup_parser_context context = {
+		.controller = controller,
+		.controller_length = strlen(controller),
+		.cgroup = cgroup,
+	};
+	cpuinfo_linux_parse_multiline_file(CGROUP_FILENAME, CGROUP_BUFFER_SIZE, parse_cgroup_line, &context);
+	if (!context.found_v1) {
+		if (!context.found_v2) {
+			cpuinfo_log_debug("no cgroup with %s controller found in %s", controller, CGROUP_FILENAME);
+			return false;
+		}
+		if (!set_cgroup_path(cgroup, CGROUP_MOUNT_ROOT, sizeof(CGROUP_MOUNT_ROOT) - 1,
+				context.v2_path_buffer, context.v2_path_buffer + strlen(context.v2_path_buffer)))
+		{
+			return false;
+		}
+		cgroup->unified = true;
+	}
+
+	#if !CPUINFO_MOCK
+		/*
+		 * Without a cgroup namespace, containers see the path of their cgroup in the host hierarchy, but have only
+		 * their own cgroup mounted: use the root of the mounted hierarchy in this case.
+		 */
+		if (access(cgroup->path, F_OK) != 0) {
+			cpuinfo_log_debug("cgroup directory %s is not accessible: using the root of the hierarchy", cgroup->path);
+			cgroup->path[cgroup->mount_length] = '\0';
+		}
+	#endif
+	cpuinfo_log_debug("%s controller of the calling process is in cgroup %s", controller, cgroup->path);
+	return true;
+}
+
+static bool format_cgroup_filename(const struct cpuinfo_linux_cgroup cgroup[restrict static 1], const char* name,
+	char filename[restrict static CPUINFO_LINUX_CGROUP_PATH_MAX])
+{
+	const size_t path_length = strlen(cgroup->path);
+	const size_t name_length = strlen(name);
+	if (path_length + 1 + name_length >= CPUINFO_LINUX_CGROUP_PATH_MAX) {
+		return false;
+	}
+	memcpy(filename, cgroup->path, path_length);
+	filename[path_length] = '/';
+	memcpy(filename + path_length + 1, name, name_length + 1);
+	return true;
+}
+
+bool cpuinfo_linux_parse_cgroup_small_file(const struct cpuinfo_linux_cgroup cgroup[restrict static 1],
+	const char* name, size_t buffer_size, cpuinfo_smallfile_callback callback, void* context)
+{
+	char filename[CPUINFO_LINUX_CGROUP_PATH_MAX];
+	if (!format_cgroup_filename(cgroup, name, filename)) {
+		return false;
+	}
+	return cpuinfo_linux_parse_small_file(filename, buffer_size, callback, context);
+}
+
+bool cpuinfo_linux_parse_cgroup_cpulist(const struct cpuinfo_linux_cgroup cgroup[restrict static 1],
+	const char* name, cpuinfo_cpulist_callback callback, void* context)
+{
+	char filename[CPUINFO_LINUX_CGROUP_PATH_MAX];
+	if (!format_cgroup_filename(cgroup, name, filename)) {
+		return false;
+	}
+	return cpuinfo_linux_parse_cpulist(filename, callback, context);
+}
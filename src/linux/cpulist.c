@@ -10,9 +10,6 @@
 #include <fcntl.h>
 #include <sched.h>
 
-#if CPUINFO_MOCK
-	#include <cpuinfo-mock.h>
-#endif
 #include <linux/api.h>
 #include <cpuinfo/log.h>
 
@@ -129,39 +126,20 @@ inline static bool parse_entry(const char* entry_start, const char* entry_end, c
 	return callback(first_cpu, last_cpu + 1, context);
 }
 
-bool cpuinfo_linux_parse_cpulist(const char* filename, cpuinfo_cpulist_callback callback, void* context) {
+bool cpuinfo_linux_parse_cpulist_descriptor(int file, const char* filename, cpuinfo_cpulist_callback callback, void* context) {
 	bool status = true;
-	int file = -1;
 	char buffer[BUFFER_SIZE];
-	#if CPUINFO_LOG_DEBUG_PARSERS
-		cpuinfo_log_debug("parsing cpu list from file %s", filename);
-	#endif
-
-#if CPUINFO_MOCK
-	file = cpuinfo_mock_open(filename, O_RDONLY);
-#else
-	file = open(filename, O_RDONLY);
-#endif
-	if (file == -1) {
-		cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
-		status = false;
-		goto cleanup;
-	}
 
 	size_t position = 0;
 	const char* buffer_end = &buffer[BUFFER_SIZE];
 	char* data_start = buffer;
 	ssize_t bytes_read;
 	do {
-#if CPUINFO_MOCK
-		bytes_read = cpuinfo_mock_read(file, data_start, (size_t) (buffer_end - data_start));
-#else
-		bytes_read = read(file, data_start, (size_t) (buffer_end - data_start));
-#endif
+		bytes_read = cpuinfo_linux_read_file(file, data_start, (size_t) (buffer_end - data_start));
 		if (bytes_read < 0) {
 			cpuinfo_log_info("failed to read file %s at position %zu: %s", filename, position, strerror(errno));
-			status = false;
-			goto cleanup;
+			cpuinfo_linux_record_file_read(position);
+			return false;
 		}
 
 		position += (size_t) bytes_read;
@@ -201,13 +179,29 @@ bool cpuinfo_linux_parse_cpulist(const char* filename, cpuinfo_cpulist_callback
 		}
 	} while (bytes_read != 0);
 
+	cpuinfo_linux_record_file_read(position);
+	return status;
+}
+
+bool cpuinfo_linux_parse_cpulist(const char* filename, cpuinfo_cpulist_callback callback, void* context) {
+	bool status = true;
+	int file = -1;
+	#if CPUINFO_LOG_DEBUG_PARSERS
+		cpuinfo_log_debug("parsing cpu list from file %s", filename);
+	#endif
+
+	file = cpuinfo_linux_open_file(filename, O_RDONLY);
+	if (file == -1) {
+		cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
+		status = false;
+		goto cleanup;
+	}
+
+	status = cpuinfo_linux_parse_cpulist_descriptor(file, filename, callback, context);
+
 cleanup:
 	if (file != -1) {
-#if CPUINFO_MOCK
-		cpuinfo_mock_close(file);
-#else
-		close(file);
-#endif
+		cpuinfo_linux_close_file(file);
 		file = -1;
 	}
 	return status;
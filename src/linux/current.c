@@ -0,0 +1,151 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if !CPUINFO_MOCK
+	#include <elf.h>
+	#include <link.h>
+	#include <sys/auxv.h>
+#endif
+
+#include <linux/api.h>
+#include <cpuinfo/log.h>
+
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#define VDSO_GETCPU_NAME "__vdso_getcpu"
+#elif CPUINFO_ARCH_ARM64
+	/* Mainline arm64 kernels do not implement getcpu in the vDSO, but some vendor kernels do */
+	#define VDSO_GETCPU_NAME "__kernel_getcpu"
+#endif
+
+cpuinfo_getcpu_function cpuinfo_linux_vdso_getcpu = NULL;
+
+
+bool cpuinfo_linux_rseq_is_registered(void) {
+#if CPUINFO_MOCK
+	/* Mock devices need their processor numbers from getcpu */
+	return false;
+#else
+	if (&__rseq_offset == NULL || &__rseq_size == NULL) {
+		cpuinfo_log_debug("C library does not export rseq area");
+		return false;
+	}
+	if (__rseq_size < CPUINFO_LINUX_RSEQ_CPU_ID_OFFSET + sizeof(int32_t)) {
+		/* glibc reports zero size if rseq registration is disabled or failed */
+		cpuinfo_log_debug("rseq area is not registered by C library");
+		return false;
+	}
+	const int32_t cpu_id = cpuinfo_linux_read_rseq_cpu_id();
+	if (cpu_id < 0) {
+		cpuinfo_log_debug("rseq area is not registered for the current thread: cpu_id = %"PRId32, cpu_id);
+		return false;
+	}
+	return true;
+#endif
+}
+
+#if !CPUINFO_MOCK && defined(VDSO_GETCPU_NAME)
+/* Find the address of a function in the vDSO image via its dynamic symbol table */
+static void* find_vdso_function(const ElfW(Ehdr)* vdso, const char* name) {
+	const char* vdso_image = (const char*) vdso;
+	if (memcmp(vdso->e_ident, ELFMAG, SELFMAG) != 0) {
+		cpuinfo_log_warning("vDSO image lacks ELF signature");
+		return NULL;
+	}
+
+	/* Load offset is the difference between the address where vDSO is mapped and its link address */
+	const ElfW(Phdr)* program_headers = (const ElfW(Phdr)*) (vdso_image + vdso->e_phoff);
+	const ElfW(Dyn)* dynamic = NULL;
+	uintptr_t load_offset = 0;
+	bool found_load = false;
+	for (uint32_t i = 0; i < vdso->e_phnum; i++) {
+		switch (program_headers[i].p_type) {
+			case PT_LOAD:
+				if (!found_load) {
+					load_offset = (uintptr_t) vdso_image + program_headers[i].p_offset - program_headers[i].p_vaddr;
+					found_load = true;
+				}
+				break;
+			case PT_DYNAMIC:
+				dynamic = (const ElfW(Dyn)*) (vdso_image + program_headers[i].p_offset);
+				break;
+		}
+	}
+	if (!found_load || dynamic == NULL) {
+		cpuinfo_log_warning("vDSO image lacks loadable or dynamic segment");
+		return NULL;
+	}
+
+	const char* strings = NULL;
+	const ElfW(Sym)* symbols = NULL;
+	const ElfW(Word)* hash = NULL;
+	for (; dynamic->d_tag != DT_NULL; dynamic++) {
+		switch (dynamic->d_tag) {
+			case DT_STRTAB:
+				strings = (const char*) (load_offset + dynamic->d_un.d_ptr);
+				break;
+			case DT_SYMTAB:
+				symbols = (const ElfW(Sym)*) (load_offset + dynamic->d_un.d_ptr);
+				break;
+			case DT_HASH:
+				hash = (const ElfW(Word)*) (load_offset + dynamic->d_un.d_ptr);
+				break;
+		}
+	}
+	if (strings == NULL || symbols == NULL || hash == NULL) {
+		cpuinfo_log_info("vDSO image lacks symbol table or SysV hash table");
+		return NULL;
+	}
+
+	/* The second word of SysV hash table is the number of symbols */
+	const ElfW(Word) symbols_count = hash[1];
+	for (ElfW(Word) i = 0; i < symbols_count; i++) {
+		const ElfW(Sym)* symbol = &symbols[i];
+		/* Symbol info encoding is the same in 32-bit and 64-bit ELF */
+		if (ELF32_ST_TYPE(symbol->st_info) != STT_FUNC || symbol->st_shndx == SHN_UNDEF) {
+			continue;
+		}
+		if (ELF32_ST_BIND(symbol->st_info) != STB_GLOBAL && ELF32_ST_BIND(symbol->st_info) != STB_WEAK) {
+			continue;
+		}
+		if (strcmp(strings + symbol->st_name, name) == 0) {
+			return (void*) (load_offset + symbol->st_value);
+		}
+	}
+	return NULL;
+}
+#endif
+
+bool cpuinfo_linux_resolve_vdso_getcpu(void) {
+#if CPUINFO_MOCK || !defined(VDSO_GETCPU_NAME)
+	return false;
+#else
+	if (cpuinfo_linux_vdso_getcpu != NULL) {
+		/* vDSO doesn't move during the lifetime of the process */
+		return true;
+	}
+
+	const ElfW(Ehdr)* vdso = (const ElfW(Ehdr)*) (uintptr_t) getauxval(AT_SYSINFO_EHDR);
+	if (vdso == NULL) {
+		cpuinfo_log_info("vDSO is not mapped into the process");
+		return false;
+	}
+	void* function = find_vdso_function(vdso, VDSO_GETCPU_NAME);
+	if (function == NULL) {
+		cpuinfo_log_info("vDSO does not implement %s", VDSO_GETCPU_NAME);
+		return false;
+	}
+
+	unsigned cpu = 0;
+	cpuinfo_getcpu_function getcpu = (cpuinfo_getcpu_function) function;
+	if (getcpu(&cpu, NULL, NULL) != 0) {
+		cpuinfo_log_warning("%s in vDSO failed", VDSO_GETCPU_NAME);
+		return false;
+	}
+	cpuinfo_linux_vdso_getcpu = getcpu;
+	return true;
+#endif
+}
@@ -0,0 +1,116 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#if CPUINFO_MOCK
+	#include <cpuinfo-mock.h>
+#endif
+#include <linux/api.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Read buffers grow in multiples of this size */
+#define READ_BUFFER_GRANULARITY 4096
+
+/*
+ * Buffer for reads of procfs and sysfs files on the calling thread. Within a scope of file reads, such as an
+ * initialization, the buffer grows on demand and is reused by all reads; outside of a scope, it is freed after
+ * every read. Buffers are freed with cpuinfo_free_temporary, which also frees memory from cpuinfo_allocate.
+ */
+static __thread struct {
+	char* memory;
+	size_t size;
+	uint32_t scope_depth;
+	bool in_use;
+} read_buffer;
+
+static char* allocate_read_buffer(size_t size) {
+	return read_buffer.scope_depth != 0 ?
+		cpuinfo_allocate_temporary(size, sizeof(char)) : cpuinfo_allocate(size, sizeof(char));
+}
+
+static void free_read_buffer(void) {
+	cpuinfo_free_temporary(read_buffer.memory);
+	read_buffer.memory = NULL;
+	read_buffer.size = 0;
+}
+
+void cpuinfo_linux_begin_file_reads(void) {
+	read_buffer.scope_depth += 1;
+}
+
+void cpuinfo_linux_end_file_reads(void) {
+	read_buffer.scope_depth -= 1;
+	if (read_buffer.scope_depth == 0 && !read_buffer.in_use) {
+		free_read_buffer();
+	}
+}
+
+char* cpuinfo_linux_acquire_read_buffer(size_t size) {
+	if (read_buffer.in_use) {
+		/* Nested read from a callback of another read: use a separate buffer */
+		return allocate_read_buffer(size);
+	}
+	if (size > read_buffer.size) {
+		free_read_buffer();
+		const size_t new_size = (size + (READ_BUFFER_GRANULARITY - 1)) & ~(size_t) (READ_BUFFER_GRANULARITY - 1);
+		read_buffer.memory = allocate_read_buffer(new_size);
+		if (read_buffer.memory == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for file reads", new_size);
+			return NULL;
+		}
+		read_buffer.size = new_size;
+	}
+	read_buffer.in_use = true;
+	return read_buffer.memory;
+}
+
+void cpuinfo_linux_release_read_buffer(char* buffer) {
+	if (buffer != read_buffer.memory) {
+		cpuinfo_free_temporary(buffer);
+		return;
+	}
+	read_buffer.in_use = false;
+	if (read_buffer.scope_depth == 0) {
+		free_read_buffer();
+	}
+}
+
+int cpuinfo_linux_open_file(const char* path, int flags) {
+	if (cpuinfo_file_ops.open != NULL) {
+		return cpuinfo_file_ops.open(cpuinfo_file_ops.context, path, flags);
+	}
+#if CPUINFO_MOCK
+	return cpuinfo_mock_open(path, flags);
+#else
+	return open(path, flags);
+#endif
+}
+
+ssize_t cpuinfo_linux_read_file(int file, void* buffer, size_t size) {
+	if (cpuinfo_file_ops.read != NULL) {
+		return (ssize_t) cpuinfo_file_ops.read(cpuinfo_file_ops.context, file, buffer, size);
+	}
+#if CPUINFO_MOCK
+	return cpuinfo_mock_read(file, buffer, size);
+#else
+	return read(file, buffer, size);
+#endif
+}
+
+void cpuinfo_linux_close_file(int file) {
+	if (cpuinfo_file_ops.close != NULL) {
+		cpuinfo_file_ops.close(cpuinfo_file_ops.context, file);
+		return;
+	}
+#if CPUINFO_MOCK
+	cpuinfo_mock_close(file);
+#else
+	close(file);
+#endif
+}
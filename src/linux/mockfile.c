@@ -23,6 +23,20 @@
 
 static struct cpuinfo_mock_file* cpuinfo_mock_files = NULL;
 static uint32_t cpuinfo_mock_file_count = 0;
+/* Indices of mock files sorted by path, used to look up files in logarithmic time on many-core mock systems */
+static uint32_t* cpuinfo_mock_file_order = NULL;
+static struct cpuinfo_mock_file_stats cpuinfo_mock_file_stats = { 0 };
+
+static int cmp_mock_file_order(const void* ptr_a, const void* ptr_b) {
+	const uint32_t index_a = *((const uint32_t*) ptr_a);
+	const uint32_t index_b = *((const uint32_t*) ptr_b);
+	const int order = strcmp(cpuinfo_mock_files[index_a].path, cpuinfo_mock_files[index_b].path);
+	if (order != 0) {
+		return order;
+	}
+	/* Keep the first of the files with duplicate paths first, it shadows the others */
+	return (index_a > index_b) - (index_a < index_b);
+}
 
 
 void CPUINFO_ABI cpuinfo_mock_filesystem(struct cpuinfo_mock_file* files) {
@@ -35,6 +49,43 @@ void CPUINFO_ABI cpuinfo_mock_filesystem(struct cpuinfo_mock_file* files) {
 	}
 	cpuinfo_mock_files = files;
 	cpuinfo_mock_file_count = file_count;
+	cpuinfo_mock_file_stats = (struct cpuinfo_mock_file_stats) { 0 };
+
+	free(cpuinfo_mock_file_order);
+	cpuinfo_mock_file_order = malloc(file_count * sizeof(uint32_t));
+	if (cpuinfo_mock_file_order != NULL) {
+		for (uint32_t i = 0; i < file_count; i++) {
+			cpuinfo_mock_file_order[i] = i;
+		}
+		qsort(cpuinfo_mock_file_order, file_count, sizeof(uint32_t), cmp_mock_file_order);
+	}
+}
+
+static int find_mock_file(const char* path) {
+	if (cpuinfo_mock_file_order == NULL) {
+		for (uint32_t i = 0; i < cpuinfo_mock_file_count; i++) {
+			if (strcmp(cpuinfo_mock_files[i].path, path) == 0) {
+				return (int) i;
+			}
+		}
+		return -1;
+	}
+
+	/* Find the first sorted file with path not less than the searched one */
+	uint32_t start = 0, end = cpuinfo_mock_file_count;
+	while (start != end) {
+		const uint32_t middle = start + (end - start) / 2;
+		if (strcmp(cpuinfo_mock_files[cpuinfo_mock_file_order[middle]].path, path) < 0) {
+			start = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	if (start == cpuinfo_mock_file_count) {
+		return -1;
+	}
+	const uint32_t i = cpuinfo_mock_file_order[start];
+	return strcmp(cpuinfo_mock_files[i].path, path) == 0 ? (int) i : -1;
 }
 
 int CPUINFO_ABI cpuinfo_mock_open(const char* path, int oflag) {
@@ -43,22 +94,22 @@ int CPUINFO_ABI cpuinfo_mock_open(const char* path, int oflag) {
 		return open(path, oflag);
 	}
 
-	for (uint32_t i = 0; i < cpuinfo_mock_file_count; i++) {
-		if (strcmp(cpuinfo_mock_files[i].path, path) == 0) {
-			if (oflag != O_RDONLY) {
-				errno = EACCES;
-				return -1;
-			}
-			if (cpuinfo_mock_files[i].offset != SIZE_MAX) {
-				errno = ENFILE;
-				return -1;
-			}
-			cpuinfo_mock_files[i].offset = 0;
-			return (int) i;
-		}
+	cpuinfo_mock_file_stats.opens += 1;
+	const int i = find_mock_file(path);
+	if (i < 0) {
+		errno = ENOENT;
+		return -1;
 	}
-	errno = ENOENT;
-	return -1;
+	if (oflag != O_RDONLY) {
+		errno = EACCES;
+		return -1;
+	}
+	if (cpuinfo_mock_files[i].offset != SIZE_MAX) {
+		errno = ENFILE;
+		return -1;
+	}
+	cpuinfo_mock_files[i].offset = 0;
+	return i;
 }
 
 int CPUINFO_ABI cpuinfo_mock_close(int fd) {
@@ -101,5 +152,11 @@ ssize_t CPUINFO_ABI cpuinfo_mock_read(int fd, void* buffer, size_t capacity) {
 	}
 	memcpy(buffer, (void*) cpuinfo_mock_files[fd].content + offset, count);
 	cpuinfo_mock_files[fd].offset += count;
+	cpuinfo_mock_file_stats.reads += 1;
+	cpuinfo_mock_file_stats.read_bytes += count;
 	return (ssize_t) count;
 }
+
+void CPUINFO_ABI cpuinfo_mock_get_file_stats(struct cpuinfo_mock_file_stats* stats) {
+	*stats = cpuinfo_mock_file_stats;
+}
@@ -0,0 +1,547 @@
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if !CPUINFO_MOCK
+	#error This file should be built only in mock mode
+#endif
+
+#include <cpuinfo-mock.h>
+#include <cpuinfo/log.h>
+
+
+/* Distances of ACPI SLIT between nodes in the same package, e.g. sub-NUMA clusters, and in different packages */
+#define SYNTHETIC_LOCAL_DISTANCE 10
+#define SYNTHETIC_PACKAGE_DISTANCE 12
+#define SYNTHETIC_REMOTE_DISTANCE 21
+
+/* Maximum length of the path, or of the one-line content, of a generated file */
+#define SYNTHETIC_PATH_MAX 128
+
+/* Growable text of a generated file */
+struct text {
+	char* data;
+	size_t length;
+	size_t capacity;
+	bool failed;
+};
+
+static void append(struct text text[restrict static 1], const char* format, ...) {
+	if (text->failed) {
+		return;
+	}
+	va_list args;
+	va_start(args, format);
+	va_list args_copy;
+	va_copy(args_copy, args);
+	const int length = vsnprintf(NULL, 0, format, args_copy);
+	va_end(args_copy);
+	if (length < 0) {
+		text->failed = true;
+		va_end(args);
+		return;
+	}
+	if (text->length + (size_t) length + 1 > text->capacity) {
+		size_t capacity = text->capacity != 0 ? text->capacity * 2 : 64;
+		while (capacity < text->length + (size_t) length + 1) {
+			capacity *= 2;
+		}
+		char* data = realloc(text->data, capacity);
+		if (data == NULL) {
+			text->failed = true;
+			va_end(args);
+			return;
+		}
+		text->data = data;
+		text->capacity = capacity;
+	}
+	vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+	va_end(args);
+	text->length += (size_t) length;
+}
+
+/* Encoder of a Linux CPU list, e.g. 0-3,8-11, from processors added in increasing order */
+struct cpulist {
+	struct text text;
+	uint32_t range_start;
+	uint32_t range_end;
+	bool has_range;
+};
+
+static void cpulist_flush(struct cpulist list[restrict static 1]) {
+	if (list->has_range) {
+		append(&list->text, list->text.length != 0 ? "," : "");
+		if (list->range_end - list->range_start > 1) {
+			append(&list->text, "%"PRIu32"-%"PRIu32, list->range_start, list->range_end - 1);
+		} else {
+			append(&list->text, "%"PRIu32, list->range_start);
+		}
+	}
+}
+
+static void cpulist_add(struct cpulist list[restrict static 1], uint32_t processor) {
+	if (list->has_range && list->range_end == processor) {
+		list->range_end = processor + 1;
+		return;
+	}
+	cpulist_flush(list);
+	list->range_start = processor;
+	list->range_end = processor + 1;
+	list->has_range = true;
+}
+
+/* Finish the list with a new line, and return its text, owned by the caller */
+static char* cpulist_finish(struct cpulist list[restrict static 1]) {
+	cpulist_flush(list);
+	append(&list->text, "\n");
+	if (list->text.failed) {
+		free(list->text.data);
+		return NULL;
+	}
+	return list->text.data;
+}
+
+/* Location of a logical processor of the synthetic system */
+struct synthetic_processor {
+	uint32_t package;
+	uint32_t node;
+	/* Cluster index over all packages */
+	uint32_t cluster;
+	/* Core index over all packages */
+	uint32_t core;
+	uint32_t core_in_package;
+	uint32_t core_in_cluster;
+	uint32_t thread;
+};
+
+struct builder {
+	struct cpuinfo_mock_file* files;
+	uint32_t files_count;
+	uint32_t files_capacity;
+	bool failed;
+};
+
+/* Add a file to the filesystem; the builder takes ownership of the content */
+static void add_file(struct builder builder[restrict static 1], const char* path, char* content) {
+	if (content == NULL) {
+		builder->failed = true;
+	}
+	/* Keep space for the terminating entry */
+	if (!builder->failed && builder->files_count + 2 > builder->files_capacity) {
+		const uint32_t capacity = builder->files_capacity != 0 ? builder->files_capacity * 2 : 256;
+		struct cpuinfo_mock_file* files = realloc(builder->files, capacity * sizeof(struct cpuinfo_mock_file));
+		if (files == NULL) {
+			builder->failed = true;
+		} else {
+			builder->files = files;
+			builder->files_capacity = capacity;
+		}
+	}
+	char* path_copy = builder->failed ? NULL : strdup(path);
+	if (path_copy == NULL) {
+		builder->failed = true;
+		free(content);
+		return;
+	}
+	builder->files[builder->files_count++] = (struct cpuinfo_mock_file) {
+		.path = path_copy,
+		.size = strlen(content),
+		.content = content,
+	};
+}
+
+/* Add a file with a copy of the CPU list of a group, e.g. the processors of a package */
+static void add_list_file(struct builder builder[restrict static 1], const char* path, const char* list) {
+	add_file(builder, path, strdup(list));
+}
+
+static void add_text_file(
+	struct builder builder[restrict static 1],
+	const char* path,
+	struct text text[restrict static 1])
+{
+	if (text->failed) {
+		free(text->data);
+		add_file(builder, path, NULL);
+	} else {
+		add_file(builder, path, text->data);
+	}
+}
+
+static void add_string_file(struct builder builder[restrict static 1], const char* path, const char* format, ...) {
+	char content[SYNTHETIC_PATH_MAX];
+	va_list args;
+	va_start(args, format);
+	const int length = vsnprintf(content, sizeof(content), format, args);
+	va_end(args);
+	add_file(builder, path, length >= 0 && (size_t) length < sizeof(content) ? strdup(content) : NULL);
+}
+
+/* Finish the CPU lists of groups; the texts are copied to the files of processors in the groups */
+static bool finish_lists(uint32_t count, struct cpulist* lists, char** texts) {
+	bool finished = true;
+	for (uint32_t i = 0; i < count; i++) {
+		texts[i] = cpulist_finish(&lists[i]);
+		finished &= texts[i] != NULL;
+	}
+	return finished;
+}
+
+static uint32_t bit_length(uint32_t count) {
+	uint32_t length = 0;
+	while ((UINT32_C(1) << length) < count) {
+		length++;
+	}
+	return length;
+}
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* Cache descriptor of CPUID leaf 4 */
+	static struct cpuinfo_mock_cpuid cache_leaf(
+		uint32_t subleaf, uint32_t type, uint32_t level,
+		uint32_t size, uint32_t associativity, uint32_t sharing_bits, uint32_t core_bits)
+	{
+		const uint32_t line_size = 64;
+		const uint32_t sets = size / (associativity * line_size);
+		const uint32_t max_sharing = (UINT32_C(1) << sharing_bits) - 1;
+		const uint32_t max_cores = (UINT32_C(1) << core_bits) - 1;
+		return (struct cpuinfo_mock_cpuid) {
+			.input_eax = 4,
+			.input_ecx = subleaf,
+			.eax = type | (level << 5) | UINT32_C(0x100) | ((max_sharing < 0xFFF ? max_sharing : 0xFFF) << 14) |
+				((max_cores < 0x3F ? max_cores : 0x3F) << 26),
+			.ebx = (line_size - 1) | ((associativity - 1) << 22),
+			.ecx = sets - 1,
+		};
+	}
+#endif
+
+static bool validate_topology(const struct cpuinfo_mock_topology topology[restrict static 1]) {
+	if (topology->packages == 0 || topology->packages > CPUINFO_MOCK_PACKAGES_MAX ||
+		topology->nodes_per_package == 0 || topology->clusters_count == 0 ||
+		topology->clusters_count > CPUINFO_MOCK_CLUSTERS_MAX)
+	{
+		return false;
+	}
+	uint32_t cores_per_package = 0, processors_per_package = 0;
+	for (uint32_t i = 0; i < topology->clusters_count; i++) {
+		const struct cpuinfo_mock_cluster* cluster = &topology->clusters[i];
+		if (cluster->cores == 0 || cluster->threads_per_core == 0 || cluster->threads_per_core > 4 ||
+			cluster->max_frequency == 0)
+		{
+			return false;
+		}
+		cores_per_package += cluster->cores;
+		processors_per_package += cluster->cores * cluster->threads_per_core;
+	}
+	return topology->nodes_per_package <= cores_per_package &&
+		processors_per_package * topology->packages <= CPUINFO_MOCK_PROCESSORS_MAX;
+}
+
+bool CPUINFO_ABI cpuinfo_mock_generate_system(
+	const struct cpuinfo_mock_topology* topology,
+	struct cpuinfo_mock_system* system)
+{
+	*system = (struct cpuinfo_mock_system) { 0 };
+	if (!validate_topology(topology)) {
+		cpuinfo_log_error("invalid synthetic topology");
+		return false;
+	}
+
+	uint32_t cores_per_package = 0, max_threads = 0;
+	for (uint32_t i = 0; i < topology->clusters_count; i++) {
+		cores_per_package += topology->clusters[i].cores;
+		if (topology->clusters[i].threads_per_core > max_threads) {
+			max_threads = topology->clusters[i].threads_per_core;
+		}
+	}
+	const uint32_t packages_count = topology->packages;
+	const uint32_t clusters_count = packages_count * topology->clusters_count;
+	const uint32_t cores_count = packages_count * cores_per_package;
+	const uint32_t nodes_count = packages_count * topology->nodes_per_package;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* Layout of APIC IDs: thread bits, then core bits, then package bits */
+		const uint32_t thread_bits = bit_length(max_threads);
+		const uint32_t core_bits = bit_length(cores_per_package);
+	#endif
+
+	/*
+	 * Number processors like Linux on x86 servers: the first threads of all cores, then the second threads of the
+	 * cores with several threads, and so on. Cores are numbered by package, and by cluster within a package.
+	 */
+	struct synthetic_processor* processors = calloc(cores_count * max_threads, sizeof(struct synthetic_processor));
+	uint32_t processors_count = 0;
+	if (processors == NULL) {
+		return false;
+	}
+	for (uint32_t thread = 0; thread < max_threads; thread++) {
+		uint32_t core = 0;
+		for (uint32_t package = 0; package < packages_count; package++) {
+			uint32_t core_in_package = 0;
+			for (uint32_t cluster = 0; cluster < topology->clusters_count; cluster++) {
+				const struct cpuinfo_mock_cluster* cluster_info = &topology->clusters[cluster];
+				for (uint32_t core_in_cluster = 0; core_in_cluster < cluster_info->cores; core_in_cluster++) {
+					if (thread < cluster_info->threads_per_core) {
+						processors[processors_count++] = (struct synthetic_processor) {
+							.package = package,
+							.node = package * topology->nodes_per_package +
+								core_in_package * topology->nodes_per_package / cores_per_package,
+							.cluster = package * topology->clusters_count + cluster,
+							.core = core,
+							.core_in_package = core_in_package,
+							.core_in_cluster = core_in_cluster,
+							.thread = thread,
+						};
+					}
+					core++;
+					core_in_package++;
+				}
+			}
+		}
+	}
+
+	struct builder builder = { 0 };
+	struct cpulist atom_list = { 0 }, core_type_list = { 0 };
+	const uint32_t lists_count = packages_count + clusters_count + cores_count + nodes_count;
+	struct cpulist* lists = calloc(lists_count, sizeof(struct cpulist));
+	char** texts = calloc(lists_count, sizeof(char*));
+	if (lists == NULL || texts == NULL) {
+		goto cleanup;
+	}
+	struct cpulist* package_lists = lists;
+	struct cpulist* cluster_lists = package_lists + packages_count;
+	struct cpulist* core_lists = cluster_lists + clusters_count;
+	struct cpulist* node_lists = core_lists + cores_count;
+	bool hybrid = false;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		cpulist_add(&package_lists[processors[i].package], i);
+		cpulist_add(&cluster_lists[processors[i].cluster], i);
+		cpulist_add(&core_lists[processors[i].core], i);
+		cpulist_add(&node_lists[processors[i].node], i);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			const struct cpuinfo_mock_cluster* cluster_info =
+				&topology->clusters[processors[i].cluster % topology->clusters_count];
+			cpulist_add(cluster_info->efficiency ? &atom_list : &core_type_list, i);
+			hybrid |= cluster_info->efficiency;
+		#endif
+	}
+	if (!finish_lists(lists_count, lists, texts)) {
+		free(core_type_list.text.data);
+		free(atom_list.text.data);
+		goto cleanup;
+	}
+	char** package_texts = texts;
+	char** cluster_texts = package_texts + packages_count;
+	char** core_texts = cluster_texts + clusters_count;
+	char** node_texts = core_texts + cores_count;
+
+	char path[SYNTHETIC_PATH_MAX];
+	add_string_file(&builder, "/sys/devices/system/cpu/kernel_max", "%"PRIu32"\n", processors_count - 1);
+	add_string_file(&builder, "/sys/devices/system/cpu/possible", "0-%"PRIu32"\n", processors_count - 1);
+	add_string_file(&builder, "/sys/devices/system/cpu/present", "0-%"PRIu32"\n", processors_count - 1);
+	add_string_file(&builder, "/sys/devices/system/cpu/online", "0-%"PRIu32"\n", processors_count - 1);
+	if (hybrid) {
+		add_file(&builder, "/sys/devices/cpu_core/cpus", cpulist_finish(&core_type_list));
+		add_file(&builder, "/sys/devices/cpu_atom/cpus", cpulist_finish(&atom_list));
+	} else {
+		free(core_type_list.text.data);
+		free(atom_list.text.data);
+	}
+
+	add_string_file(&builder, "/sys/devices/system/node/online", "0-%"PRIu32"\n", nodes_count - 1);
+	for (uint32_t node = 0; node < nodes_count; node++) {
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%"PRIu32"/cpulist", node);
+		add_list_file(&builder, path, node_texts[node]);
+		struct text distances = { 0 };
+		for (uint32_t other = 0; other < nodes_count; other++) {
+			uint32_t distance = SYNTHETIC_REMOTE_DISTANCE;
+			if (other == node) {
+				distance = SYNTHETIC_LOCAL_DISTANCE;
+			} else if (other / topology->nodes_per_package == node / topology->nodes_per_package) {
+				distance = SYNTHETIC_PACKAGE_DISTANCE;
+			}
+			append(&distances, "%s%"PRIu32, other != 0 ? " " : "", distance);
+		}
+		append(&distances, "\n");
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%"PRIu32"/distance", node);
+		add_text_file(&builder, path, &distances);
+	}
+
+	struct text cpuinfo = { 0 };
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct synthetic_processor* processor = &processors[i];
+		const struct cpuinfo_mock_cluster* cluster_info =
+			&topology->clusters[processor->cluster % topology->clusters_count];
+		append(&cpuinfo, "processor\t: %"PRIu32"\n", i);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			const uint32_t apic_id = (processor->package << (core_bits + thread_bits)) |
+				(processor->core_in_package << thread_bits) | processor->thread;
+			append(&cpuinfo,
+				"vendor_id\t: GenuineIntel\n"
+				"physical id\t: %"PRIu32"\n"
+				"core id\t\t: %"PRIu32"\n"
+				"cpu cores\t: %"PRIu32"\n"
+				"apicid\t\t: %"PRIu32"\n"
+				"initial apicid\t: %"PRIu32"\n\n",
+				processor->package, processor->core_in_package, cores_per_package, apic_id, apic_id);
+		#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			const uint32_t midr = cluster_info->midr;
+			append(&cpuinfo,
+				"BogoMIPS\t: 50.00\n"
+				"Features\t: fp asimd evtstrm aes pmull sha1 sha2 crc32 atomics fphp asimdhp cpuid asimdrdm "
+					"lrcpc dcpop asimddp\n"
+				"CPU implementer\t: 0x%02"PRIx32"\n"
+				"CPU architecture: 8\n"
+				"CPU variant\t: 0x%"PRIx32"\n"
+				"CPU part\t: 0x%03"PRIx32"\n"
+				"CPU revision\t: %"PRIu32"\n\n",
+				midr >> 24, (midr >> 20) & 0xF, (midr >> 4) & 0xFFF, midr & 0xF);
+		#endif
+
+		const char* topology_format = "/sys/devices/system/cpu/cpu%"PRIu32"/topology/%s";
+		snprintf(path, sizeof(path), topology_format, i, "physical_package_id");
+		add_string_file(&builder, path, "%"PRIu32"\n", processor->package);
+		snprintf(path, sizeof(path), topology_format, i, "die_id");
+		add_string_file(&builder, path, "0\n");
+		snprintf(path, sizeof(path), topology_format, i, "core_id");
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			/* Linux on x86 derives core ID from APIC ID */
+			add_string_file(&builder, path, "%"PRIu32"\n", processor->core_in_package);
+		#else
+			add_string_file(&builder, path, "%"PRIu32"\n", processor->core_in_cluster);
+		#endif
+		snprintf(path, sizeof(path), topology_format, i, "core_siblings_list");
+		add_list_file(&builder, path, package_texts[processor->package]);
+		snprintf(path, sizeof(path), topology_format, i, "package_cpus_list");
+		add_list_file(&builder, path, package_texts[processor->package]);
+		snprintf(path, sizeof(path), topology_format, i, "thread_siblings_list");
+		add_list_file(&builder, path, core_texts[processor->core]);
+		snprintf(path, sizeof(path), topology_format, i, "core_cpus_list");
+		add_list_file(&builder, path, core_texts[processor->core]);
+		#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			/* Like firmware of DynamIQ SoCs, describe all cores of a package as one cluster */
+			snprintf(path, sizeof(path), topology_format, i, "cluster_id");
+			add_string_file(&builder, path, "%"PRIu32"\n", processor->package);
+			snprintf(path, sizeof(path), topology_format, i, "cluster_cpus_list");
+			add_list_file(&builder, path, package_texts[processor->package]);
+		#endif
+
+		const char* cpufreq_format = "/sys/devices/system/cpu/cpu%"PRIu32"/cpufreq/%s";
+		snprintf(path, sizeof(path), cpufreq_format, i, "cpuinfo_max_freq");
+		add_string_file(&builder, path, "%"PRIu32"\n", cluster_info->max_frequency);
+		snprintf(path, sizeof(path), cpufreq_format, i, "cpuinfo_min_freq");
+		add_string_file(&builder, path, "%"PRIu32"\n", cluster_info->max_frequency / 4);
+		snprintf(path, sizeof(path), cpufreq_format, i, "related_cpus");
+		add_list_file(&builder, path, cluster_texts[processor->cluster]);
+		/* Energy-performance preferences of intel_pstate and amd-pstate in active mode */
+		snprintf(path, sizeof(path), cpufreq_format, i, "energy_performance_preference");
+		add_string_file(&builder, path, "balance_performance\n");
+		snprintf(path, sizeof(path), cpufreq_format, i, "energy_performance_available_preferences");
+		add_string_file(&builder, path, "default performance balance_performance balance_power power\n");
+	}
+	add_text_file(&builder, "/proc/cpuinfo", &cpuinfo);
+
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* CPUID of the initializing processor, the first thread of the first core of the first package */
+		const struct cpuinfo_mock_cluster* first_cluster = &topology->clusters[0];
+		const uint32_t package_bits = core_bits + thread_bits;
+		const uint32_t package_threads = UINT32_C(1) << package_bits;
+		/* Alder Lake-S for hybrid processors, and Sapphire Rapids otherwise */
+		const uint32_t signature = hybrid ? UINT32_C(0x00090672) : UINT32_C(0x000806F8);
+		const uint32_t l3_size = cores_per_package * 2 * 1024 * 1024;
+		const struct cpuinfo_mock_cpuid cpuid_dump[] = {
+			{ .input_eax = 0x00000000, .eax = 0x0000001A, .ebx = 0x756E6547, .ecx = 0x6C65746E, .edx = 0x49656E69 },
+			{
+				.input_eax = 0x00000001,
+				.eax = signature,
+				.ebx = UINT32_C(0x00000800) | ((package_threads < 0xFF ? package_threads : 0xFF) << 16),
+				.ecx = UINT32_C(0x7FFAFBFF),
+				.edx = UINT32_C(0xBFEBFBFF),
+			},
+			cache_leaf(0, 1, 1, 48 * 1024, 12, thread_bits, core_bits),
+			cache_leaf(1, 2, 1, 32 * 1024, 8, thread_bits, core_bits),
+			cache_leaf(2, 3, 2, 2 * 1024 * 1024, 16, thread_bits, core_bits),
+			cache_leaf(3, 3, 3, l3_size, 16, package_bits, core_bits),
+			{ .input_eax = 0x00000004, .input_ecx = 4 },
+			{
+				.input_eax = 0x00000007,
+				.ebx = UINT32_C(0x239CA7EB),
+				.ecx = UINT32_C(0x98C007BC),
+				.edx = hybrid ? UINT32_C(0xFC118410) : UINT32_C(0xFC100410),
+			},
+			{
+				.input_eax = 0x0000000B,
+				.input_ecx = 0,
+				.eax = thread_bits,
+				.ebx = first_cluster->threads_per_core,
+				.ecx = UINT32_C(0x00000100),
+			},
+			{
+				.input_eax = 0x0000000B,
+				.input_ecx = 1,
+				.eax = package_bits,
+				.ebx = processors_count / packages_count,
+				.ecx = UINT32_C(0x00000201),
+			},
+			{ .input_eax = 0x0000000B, .input_ecx = 2, .ecx = 2 },
+			/* Core type of the initializing processor: 0x40 for performance, 0x20 for efficiency cores */
+			{ .input_eax = 0x0000001A, .eax = hybrid ? (first_cluster->efficiency ? 0x20000000 : 0x40000000) : 0 },
+			{ .input_eax = 0x80000000, .eax = 0x80000001 },
+			{ .input_eax = 0x80000001, .ecx = UINT32_C(0x00000121), .edx = UINT32_C(0x2C100800) },
+		};
+		system->cpuid_dump = malloc(sizeof(cpuid_dump));
+		if (system->cpuid_dump == NULL) {
+			builder.failed = true;
+		} else {
+			memcpy(system->cpuid_dump, cpuid_dump, sizeof(cpuid_dump));
+			system->cpuid_entries = sizeof(cpuid_dump) / sizeof(struct cpuinfo_mock_cpuid);
+		}
+	#endif
+
+	if (!builder.failed) {
+		builder.files[builder.files_count] = (struct cpuinfo_mock_file) { 0 };
+		system->files = builder.files;
+		system->processors_count = processors_count;
+		builder.files = NULL;
+		builder.files_count = 0;
+	}
+
+cleanup:
+	for (uint32_t i = 0; i < builder.files_count; i++) {
+		free((void*) builder.files[i].path);
+		free((void*) builder.files[i].content);
+	}
+	free(builder.files);
+	if (texts != NULL) {
+		for (uint32_t i = 0; i < lists_count; i++) {
+			free(texts[i]);
+		}
+	}
+	free(texts);
+	free(lists);
+	free(processors);
+	if (system->files == NULL) {
+		cpuinfo_mock_release_system(system);
+		cpuinfo_log_error("failed to generate synthetic system");
+		return false;
+	}
+	return true;
+}
+
+void CPUINFO_ABI cpuinfo_mock_release_system(struct cpuinfo_mock_system* system) {
+	if (system->files != NULL) {
+		for (struct cpuinfo_mock_file* file = system->files; file->path != NULL; file++) {
+			free((void*) file->path);
+			free((void*) file->content);
+		}
+		free(system->files);
+	}
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		free(system->cpuid_dump);
+	#endif
+	*system = (struct cpuinfo_mock_system) { 0 };
+}
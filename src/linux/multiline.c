@@ -2,7 +2,6 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <alloca.h>
 #include <errno.h>
 
 #include <sys/types.h>
@@ -10,41 +9,97 @@
 #include <unistd.h>
 #include <fcntl.h>
 
-#if CPUINFO_MOCK
-	#include <cpuinfo-mock.h>
-#endif
 #include <linux/api.h>
 #include <cpuinfo/log.h>
 
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(__ARM_BIG_ENDIAN)
+	#include <arm_neon.h>
+	#define CPUINFO_MULTILINE_NEON 1
+#endif
+
 
-bool cpuinfo_linux_parse_multiline_file(const char* filename, size_t buffer_size, cpuinfo_line_callback callback, void* context)
+/* Find the first occurrence of character in the text, or return end of the text if it is not found */
+static inline const char* find_char(const char* start, const char* end, char c) {
+	const char* ptr = start;
+#if defined(__SSE2__)
+	const __m128i pattern = _mm_set1_epi8(c);
+	for (; (size_t) (end - ptr) >= 16; ptr += 16) {
+		const __m128i chunk = _mm_loadu_si128((const __m128i*) ptr);
+		const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+		if (mask != 0) {
+			return ptr + __builtin_ctz(mask);
+		}
+	}
+#elif defined(CPUINFO_MULTILINE_NEON)
+	const uint8x16_t pattern = vdupq_n_u8((uint8_t) c);
+	for (; (size_t) (end - ptr) >= 16; ptr += 16) {
+		const uint8x16_t matches = vceqq_u8(vld1q_u8((const uint8_t*) ptr), pattern);
+		/* Narrow 8-bit match results to 4 bits, so the 16 results form one 64-bit mask */
+		const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+		if (mask != 0) {
+			return ptr + (__builtin_ctzll(mask) >> 2);
+		}
+	}
+#endif
+	for (; ptr != end; ptr++) {
+		if (*ptr == c) {
+			break;
+		}
+	}
+	return ptr;
+}
+
+/*
+ * Check if the line (possibly incomplete) starts with one of the keys whose values are not needed.
+ * The key must be followed by whitespace or ':' separator, so that e.g. "flags" does not match "flagship".
+ */
+static bool is_skipped_line(const char* line_start, const char* line_end, const char* const* skip_keys) {
+	if (skip_keys == NULL) {
+		return false;
+	}
+	const size_t line_length = (size_t) (line_end - line_start);
+	for (; *skip_keys != NULL; skip_keys++) {
+		const size_t key_length = strlen(*skip_keys);
+		if (line_length > key_length && memcmp(line_start, *skip_keys, key_length) == 0) {
+			const char next = line_start[key_length];
+			if (next == ' ' || next == '\t' || next == ':') {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static bool parse_lines(const char* filename, size_t buffer_size, const char* const* skip_keys,
+	cpuinfo_line_callback callback, void* context)
 {
 	int file = -1;
 	bool status = false;
-	char* buffer = (char*) alloca(buffer_size);
+	char* buffer = NULL;
+	/* Only used for error reporting and statistics */
+	size_t position = 0;
 
-#if CPUINFO_MOCK
-	file = cpuinfo_mock_open(filename, O_RDONLY);
-#else
-	file = open(filename, O_RDONLY);
-#endif
+	file = cpuinfo_linux_open_file(filename, O_RDONLY);
 	if (file == -1) {
 		cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
 		goto cleanup;
 	}
+	buffer = cpuinfo_linux_acquire_read_buffer(buffer_size);
+	if (buffer == NULL) {
+		goto cleanup;
+	}
 
 	/* Only used for error reporting */
-	size_t position = 0;
 	uint64_t line_number = 1;
 	const char* buffer_end = &buffer[buffer_size];
 	char* data_start = buffer;
+	/* Indicates that the rest of a skipped line is discarded until the next newline character */
+	bool skipping_line = false;
 	ssize_t bytes_read;
 	do {
-#if CPUINFO_MOCK
-		bytes_read = cpuinfo_mock_read(file, data_start, (size_t) (buffer_end - data_start));
-#else
-		bytes_read = read(file, data_start, (size_t) (buffer_end - data_start));
-#endif
+		bytes_read = cpuinfo_linux_read_file(file, data_start, (size_t) (buffer_end - data_start));
 		if (bytes_read < 0) {
 			cpuinfo_log_info("failed to read file %s at position %zu: %s",
 				filename, position, strerror(errno));
@@ -58,35 +113,54 @@ bool cpuinfo_linux_parse_multiline_file(const char* filename, size_t buffer_size
 		if (bytes_read == 0) {
 			/* No more data in the file: process the remaining text in the buffer as a single entry */
 			const char* line_end = data_end;
-			if (!callback(line_start, line_end, context, line_number)) {
-				goto cleanup;
+			if (!skipping_line && !is_skipped_line(line_start, line_end, skip_keys)) {
+				if (!callback(line_start, line_end, context, line_number)) {
+					goto cleanup;
+				}
 			}
 		} else {
-			const char* line_end;
-			do {
-				/* Find the end of the entry, as indicated by newline character ('\n') */
-				for (line_end = line_start; line_end != data_end; line_end++) {
-					if (*line_end == '\n') {
-						break;
-					}
+			if (skipping_line) {
+				const char* line_end = find_char(line_start, data_end, '\n');
+				if (line_end == data_end) {
+					/* Newline not found yet: discard all data */
+					data_start = buffer;
+					continue;
 				}
+				skipping_line = false;
+				line_number++;
+				line_start = line_end + 1;
+			}
+
+			for (;;) {
+				/* Find the end of the entry, as indicated by newline character ('\n') */
+				const char* line_end = find_char(line_start, data_end, '\n');
 
 				/*
 				 * If we located separator at the end of the entry, parse it.
 				 * Otherwise, there may be more data at the end; read the file once again.
 				 */
-				if (line_end != data_end) {
-					if (!callback(line_start, line_end, context, line_number++)) {
+				if (line_end == data_end) {
+					break;
+				}
+				if (!is_skipped_line(line_start, line_end, skip_keys)) {
+					if (!callback(line_start, line_end, context, line_number)) {
 						goto cleanup;
 					}
-					line_start = line_end + 1;
 				}
-			} while (line_end != data_end);
+				line_number++;
+				line_start = line_end + 1;
+			}
 
-			/* Move remaining partial line data at the end to the beginning of the buffer */
-			const size_t line_length = (size_t) (line_end - line_start);
-			memmove(buffer, line_start, line_length);
-			data_start = &buffer[line_length];
+			if (is_skipped_line(line_start, data_end, skip_keys)) {
+				/* Partial data of a skipped line is not needed, even if the line does not fit into the buffer */
+				skipping_line = true;
+				data_start = buffer;
+			} else {
+				/* Move remaining partial line data at the end to the beginning of the buffer */
+				const size_t line_length = (size_t) (data_end - line_start);
+				memmove(buffer, line_start, line_length);
+				data_start = &buffer[line_length];
+			}
 		}
 	} while (bytes_read != 0);
 
@@ -94,13 +168,93 @@ bool cpuinfo_linux_parse_multiline_file(const char* filename, size_t buffer_size
 	status = true;
 
 cleanup:
+	cpuinfo_linux_release_read_buffer(buffer);
 	if (file != -1) {
-#if CPUINFO_MOCK
-		cpuinfo_mock_close(file);
-#else
-		close(file);
-#endif
+		cpuinfo_linux_record_file_read(position);
+		cpuinfo_linux_close_file(file);
 		file = -1;
 	}
 	return status;
 }
+
+bool cpuinfo_linux_parse_multiline_file(const char* filename, size_t buffer_size, cpuinfo_line_callback callback, void* context)
+{
+	return parse_lines(filename, buffer_size, NULL, callback, context);
+}
+
+struct key_value_parser_context {
+	const char* filename;
+	cpuinfo_key_value_callback callback;
+	void* context;
+};
+
+/*
+ *	Split a line into key and value parts.
+ *	Lines have format <words-with-spaces>[ ]*:[ ]<space-separated words>
+ */
+static bool parse_key_value_line(const char* line_start, const char* line_end, void* context, uint64_t line_number) {
+	const struct key_value_parser_context* parser_context = (const struct key_value_parser_context*) context;
+
+	/* Empty line. Skip. */
+	if (line_start == line_end) {
+		return true;
+	}
+
+	/* Search for ':' on the line. */
+	const char* separator = find_char(line_start, line_end, ':');
+	/* Skip line if no ':' separator was found. */
+	if (separator == line_end) {
+		cpuinfo_log_info("Line %.*s in %s is ignored: key/value separator ':' not found",
+			(int) (line_end - line_start), line_start, parser_context->filename);
+		return true;
+	}
+
+	/* Skip trailing spaces in key part. */
+	const char* key_end = separator;
+	for (; key_end != line_start; key_end--) {
+		if (key_end[-1] != ' ' && key_end[-1] != '\t') {
+			break;
+		}
+	}
+	/* Skip line if key contains nothing but spaces. */
+	if (key_end == line_start) {
+		cpuinfo_log_info("Line %.*s in %s is ignored: key contains only spaces",
+			(int) (line_end - line_start), line_start, parser_context->filename);
+		return true;
+	}
+
+	/* Skip leading spaces in value part. */
+	const char* value_start = separator + 1;
+	for (; value_start != line_end; value_start++) {
+		if (*value_start != ' ') {
+			break;
+		}
+	}
+	/* Value part contains nothing but spaces. Skip line. */
+	if (value_start == line_end) {
+		cpuinfo_log_info("Line %.*s in %s is ignored: value contains only spaces",
+			(int) (line_end - line_start), line_start, parser_context->filename);
+		return true;
+	}
+
+	/* Skip trailing spaces in value part (if any) */
+	const char* value_end = line_end;
+	for (; value_end != value_start; value_end--) {
+		if (value_end[-1] != ' ') {
+			break;
+		}
+	}
+
+	return parser_context->callback(line_start, key_end, value_start, value_end, parser_context->context, line_number);
+}
+
+bool cpuinfo_linux_parse_key_value_file(const char* filename, size_t buffer_size, const char* const* skip_keys,
+	cpuinfo_key_value_callback callback, void* context)
+{
+	struct key_value_parser_context parser_context = {
+		.filename = filename,
+		.callback = callback,
+		.context = context,
+	};
+	return parse_lines(filename, buffer_size, skip_keys, parse_key_value_line, &parser_context);
+}
@@ -16,28 +16,43 @@
 #include <cpuinfo/log.h>
 
 
-#define STRINGIFY(token) #token
-
 #define KERNEL_MAX_FILENAME "/sys/devices/system/cpu/kernel_max"
 #define KERNEL_MAX_FILESIZE 32
-#define FREQUENCY_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu" STRINGIFY(UINT32_MAX) "/cpufreq/cpuinfo_max_freq"))
-#define MAX_FREQUENCY_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/cpufreq/cpuinfo_max_freq"
-#define MIN_FREQUENCY_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/cpufreq/cpuinfo_min_freq"
+/* Names of per-processor files, relative to /sys/devices/system/cpu/cpuN */
+#define MAX_FREQUENCY_FILENAME "cpufreq/cpuinfo_max_freq"
+#define MIN_FREQUENCY_FILENAME "cpufreq/cpuinfo_min_freq"
+#define BASE_FREQUENCY_FILENAME "cpufreq/base_frequency"
+#define NOMINAL_FREQUENCY_FILENAME "acpi_cppc/nominal_freq"
 #define FREQUENCY_FILESIZE 32
-#define PACKAGE_ID_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu" STRINGIFY(UINT32_MAX) "/topology/physical_package_id"))
-#define PACKAGE_ID_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/topology/physical_package_id"
+#define CAPACITY_FILENAME "cpu_capacity"
+#define CAPACITY_FILESIZE 32
+#define PACKAGE_ID_FILENAME "topology/physical_package_id"
 #define PACKAGE_ID_FILESIZE 32
-#define CORE_ID_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu" STRINGIFY(UINT32_MAX) "/topology/core_id"))
-#define CORE_ID_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/topology/core_id"
+#define CORE_ID_FILENAME "topology/core_id"
 #define CORE_ID_FILESIZE 32
-
-#define CORE_SIBLINGS_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu" STRINGIFY(UINT32_MAX) "/topology/core_siblings_list"))
-#define CORE_SIBLINGS_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/topology/core_siblings_list"
-#define THREAD_SIBLINGS_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu" STRINGIFY(UINT32_MAX) "/topology/thread_siblings_list"))
-#define THREAD_SIBLINGS_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/topology/thread_siblings_list"
+#define DIE_ID_FILENAME "topology/die_id"
+#define DIE_ID_FILESIZE 32
+#define MIDR_FILENAME "regs/identification/midr_el1"
+#define MIDR_FILESIZE 32
+#define MICROCODE_FILENAME "microcode/version"
+#define MICROCODE_FILESIZE 32
+#define CACHE_FILENAME_SIZE (sizeof("cache/index4294967295/ways_of_associativity"))
+#define CACHE_FILENAME_FORMAT "cache/index%" PRIu32 "/%s"
+#define CACHE_FILESIZE 32
+
+#define CORE_SIBLINGS_FILENAME "topology/core_siblings_list"
+#define THREAD_SIBLINGS_FILENAME "topology/thread_siblings_list"
+#define CORE_CPUS_FILENAME "topology/core_cpus_list"
+#define CLUSTER_ID_FILENAME "topology/cluster_id"
+#define CLUSTER_ID_FILESIZE 32
+#define CLUSTER_CPUS_FILENAME "topology/cluster_cpus_list"
+#define RELATED_CPUS_FILENAME "cpufreq/related_cpus"
 
 #define POSSIBLE_CPULIST_FILENAME "/sys/devices/system/cpu/possible"
 #define PRESENT_CPULIST_FILENAME "/sys/devices/system/cpu/present"
+#define SMT_CONTROL_FILENAME "/sys/devices/system/cpu/smt/control"
+#define SMT_ACTIVE_FILENAME "/sys/devices/system/cpu/smt/active"
+#define SMT_FILESIZE 32
 
 
 inline static const char* parse_number(const char* start, const char* end, uint32_t number_ptr[restrict static 1]) {
@@ -126,39 +141,27 @@ uint32_t cpuinfo_linux_get_max_processors_count(void) {
 }
 
 uint32_t cpuinfo_linux_get_processor_max_frequency(uint32_t processor) {
-	char max_frequency_filename[FREQUENCY_FILENAME_SIZE];
-	const int chars_formatted = snprintf(
-		max_frequency_filename, FREQUENCY_FILENAME_SIZE, MAX_FREQUENCY_FILENAME_FORMAT, processor);
-	if ((unsigned int) chars_formatted >= FREQUENCY_FILENAME_SIZE) {
-		cpuinfo_log_warning("failed to format filename for max frequency of processor %"PRIu32, processor);
-		return 0;
-	}
-
 	uint32_t max_frequency;
-	if (cpuinfo_linux_parse_small_file(max_frequency_filename, FREQUENCY_FILESIZE, uint32_parser, &max_frequency)) {
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		MAX_FREQUENCY_FILENAME, FREQUENCY_FILESIZE, uint32_parser, &max_frequency))
+	{
 		cpuinfo_log_debug("parsed max frequency value of %"PRIu32" KHz for logical processor %"PRIu32" from %s",
-			max_frequency, processor, max_frequency_filename);
+			max_frequency, processor, MAX_FREQUENCY_FILENAME);
 		return max_frequency;
 	} else {
 		cpuinfo_log_warning("failed to parse max frequency for processor %"PRIu32" from %s",
-			processor, max_frequency_filename);
+			processor, MAX_FREQUENCY_FILENAME);
 		return 0;
 	}
 }
 
 uint32_t cpuinfo_linux_get_processor_min_frequency(uint32_t processor) {
-	char min_frequency_filename[FREQUENCY_FILENAME_SIZE];
-	const int chars_formatted = snprintf(
-		min_frequency_filename, FREQUENCY_FILENAME_SIZE, MIN_FREQUENCY_FILENAME_FORMAT, processor);
-	if ((unsigned int) chars_formatted >= FREQUENCY_FILENAME_SIZE) {
-		cpuinfo_log_warning("failed to format filename for min frequency of processor %"PRIu32, processor);
-		return 0;
-	}
-
 	uint32_t min_frequency;
-	if (cpuinfo_linux_parse_small_file(min_frequency_filename, FREQUENCY_FILESIZE, uint32_parser, &min_frequency)) {
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		MIN_FREQUENCY_FILENAME, FREQUENCY_FILESIZE, uint32_parser, &min_frequency))
+	{
 		cpuinfo_log_debug("parsed min frequency value of %"PRIu32" KHz for logical processor %"PRIu32" from %s",
-			min_frequency, processor, min_frequency_filename);
+			min_frequency, processor, MIN_FREQUENCY_FILENAME);
 		return min_frequency;
 	} else {
 		/*
@@ -166,55 +169,259 @@ uint32_t cpuinfo_linux_get_processor_min_frequency(uint32_t processor) {
 		 * while max frequency is also needed for peak FLOPS calculation.
 		 */
 		cpuinfo_log_info("failed to parse min frequency for processor %"PRIu32" from %s",
-			processor, min_frequency_filename);
+			processor, MIN_FREQUENCY_FILENAME);
 		return 0;
 	}
 }
 
-bool cpuinfo_linux_get_processor_core_id(uint32_t processor, uint32_t core_id_ptr[restrict static 1]) {
-	char core_id_filename[PACKAGE_ID_FILENAME_SIZE];
-	const int chars_formatted = snprintf(
-		core_id_filename, CORE_ID_FILENAME_SIZE, CORE_ID_FILENAME_FORMAT, processor);
-	if ((unsigned int) chars_formatted >= CORE_ID_FILENAME_SIZE) {
-		cpuinfo_log_warning("failed to format filename for core id of processor %"PRIu32, processor);
+uint32_t cpuinfo_linux_get_processor_base_frequency(uint32_t processor) {
+	uint32_t base_frequency;
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		BASE_FREQUENCY_FILENAME, FREQUENCY_FILESIZE, uint32_parser, &base_frequency))
+	{
+		cpuinfo_log_debug("parsed base frequency value of %"PRIu32" KHz for logical processor %"PRIu32" from %s",
+			base_frequency, processor, BASE_FREQUENCY_FILENAME);
+		return base_frequency;
+	}
+
+	/* Base frequency is reported only by intel_pstate; ACPI CPPC reports the nominal frequency in MHz */
+	uint32_t nominal_frequency;
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		NOMINAL_FREQUENCY_FILENAME, FREQUENCY_FILESIZE, uint32_parser, &nominal_frequency))
+	{
+		cpuinfo_log_debug("parsed nominal frequency value of %"PRIu32" MHz for logical processor %"PRIu32" from %s",
+			nominal_frequency, processor, NOMINAL_FREQUENCY_FILENAME);
+		return nominal_frequency * UINT32_C(1000);
+	}
+
+	cpuinfo_log_info("failed to parse base frequency for processor %"PRIu32" from %s or %s",
+		processor, BASE_FREQUENCY_FILENAME, NOMINAL_FREQUENCY_FILENAME);
+	return 0;
+}
+
+uint32_t cpuinfo_linux_get_processor_capacity(uint32_t processor) {
+	uint32_t capacity;
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		CAPACITY_FILENAME, CAPACITY_FILESIZE, uint32_parser, &capacity))
+	{
+		cpuinfo_log_debug("parsed capacity value of %"PRIu32" for logical processor %"PRIu32" from %s",
+			capacity, processor, CAPACITY_FILENAME);
+		return capacity;
+	} else {
+		/* Capacity is reported only by kernels with the arch_topology driver, i.e. on ARM and RISC-V */
+		cpuinfo_log_info("failed to parse capacity for processor %"PRIu32" from %s",
+			processor, CAPACITY_FILENAME);
 		return 0;
 	}
+}
 
+bool cpuinfo_linux_get_processor_core_id(uint32_t processor, uint32_t core_id_ptr[restrict static 1]) {
 	uint32_t core_id;
-	if (cpuinfo_linux_parse_small_file(core_id_filename, CORE_ID_FILESIZE, uint32_parser, &core_id)) {
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		CORE_ID_FILENAME, CORE_ID_FILESIZE, uint32_parser, &core_id))
+	{
 		cpuinfo_log_debug("parsed core id value of %"PRIu32" for logical processor %"PRIu32" from %s",
-			core_id, processor, core_id_filename);
+			core_id, processor, CORE_ID_FILENAME);
 		*core_id_ptr = core_id;
 		return true;
 	} else {
 		cpuinfo_log_info("failed to parse core id for processor %"PRIu32" from %s",
-			processor, core_id_filename);
+			processor, CORE_ID_FILENAME);
 		return false;
 	}
 }
 
-bool cpuinfo_linux_get_processor_package_id(uint32_t processor, uint32_t package_id_ptr[restrict static 1]) {
-	char package_id_filename[PACKAGE_ID_FILENAME_SIZE];
-	const int chars_formatted = snprintf(
-		package_id_filename, PACKAGE_ID_FILENAME_SIZE, PACKAGE_ID_FILENAME_FORMAT, processor);
-	if ((unsigned int) chars_formatted >= PACKAGE_ID_FILENAME_SIZE) {
-		cpuinfo_log_warning("failed to format filename for package id of processor %"PRIu32, processor);
-		return 0;
+bool cpuinfo_linux_get_processor_die_id(uint32_t processor, uint32_t die_id_ptr[restrict static 1]) {
+	uint32_t die_id;
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		DIE_ID_FILENAME, DIE_ID_FILESIZE, uint32_parser, &die_id))
+	{
+		cpuinfo_log_debug("parsed die id value of %"PRIu32" for logical processor %"PRIu32" from %s",
+			die_id, processor, DIE_ID_FILENAME);
+		*die_id_ptr = die_id;
+		return true;
+	} else {
+		/* Kernels before 5.2 don't report dies */
+		cpuinfo_log_debug("failed to parse die id for processor %"PRIu32" from %s",
+			processor, DIE_ID_FILENAME);
+		return false;
 	}
+}
 
+bool cpuinfo_linux_get_processor_package_id(uint32_t processor, uint32_t package_id_ptr[restrict static 1]) {
 	uint32_t package_id;
-	if (cpuinfo_linux_parse_small_file(package_id_filename, PACKAGE_ID_FILESIZE, uint32_parser, &package_id)) {
+	if (cpuinfo_linux_parse_processor_small_file(processor,
+		PACKAGE_ID_FILENAME, PACKAGE_ID_FILESIZE, uint32_parser, &package_id))
+	{
 		cpuinfo_log_debug("parsed package id value of %"PRIu32" for logical processor %"PRIu32" from %s",
-			package_id, processor, package_id_filename);
+			package_id, processor, PACKAGE_ID_FILENAME);
 		*package_id_ptr = package_id;
 		return true;
 	} else {
 		cpuinfo_log_info("failed to parse package id for processor %"PRIu32" from %s",
-			processor, package_id_filename);
+			processor, PACKAGE_ID_FILENAME);
+		return false;
+	}
+}
+
+/* Parse a hexadecimal value with 0x prefix, e.g. of MIDR_EL1 or microcode version, and keep its lower 32 bits */
+static bool hex_value_parser(const char* text_start, const char* text_end, void* context) {
+	const char* parsed = text_start;
+	if (text_end - text_start < 3 || parsed[0] != '0' || (parsed[1] != 'x' && parsed[1] != 'X')) {
+		cpuinfo_log_info("failed to parse hexadecimal value \"%.*s\": no 0x prefix",
+			(int) (text_end - text_start), text_start);
+		return false;
+	}
+	uint64_t value = 0;
+	for (parsed += 2; parsed != text_end && !is_whitespace(*parsed); parsed++) {
+		const char c = *parsed;
+		uint32_t digit;
+		if (c >= '0' && c <= '9') {
+			digit = (uint32_t) (c - '0');
+		} else if (c >= 'a' && c <= 'f') {
+			digit = (uint32_t) (c - 'a') + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			digit = (uint32_t) (c - 'A') + 10;
+		} else {
+			cpuinfo_log_info("failed to parse hexadecimal value \"%.*s\": invalid hexadecimal digit '%c'",
+				(int) (text_end - text_start), text_start, c);
+			return false;
+		}
+		value = (value << 4) | digit;
+	}
+
+	uint32_t* value_ptr = (uint32_t*) context;
+	/* Upper 32 bits of MIDR_EL1 are reserved */
+	*value_ptr = (uint32_t) value;
+	return true;
+}
+
+bool cpuinfo_linux_get_processor_midr(uint32_t processor, uint32_t midr_ptr[restrict static 1]) {
+	uint32_t midr = 0;
+	if (cpuinfo_linux_parse_processor_small_file(processor, MIDR_FILENAME, MIDR_FILESIZE, hex_value_parser, &midr) &&
+		midr != 0)
+	{
+		cpuinfo_log_debug("parsed MIDR value of 0x%08"PRIx32" for logical processor %"PRIu32" from %s",
+			midr, processor, MIDR_FILENAME);
+		*midr_ptr = midr;
+		return true;
+	} else {
+		/* Reported only by ARM64 kernels since Linux 4.11 */
+		cpuinfo_log_info("failed to parse MIDR for processor %"PRIu32" from %s", processor, MIDR_FILENAME);
 		return false;
 	}
 }
 
+bool cpuinfo_linux_get_processor_microcode_revision(uint32_t processor, uint32_t revision_ptr[restrict static 1]) {
+	uint32_t revision = 0;
+	if (cpuinfo_linux_parse_processor_small_file(processor, MICROCODE_FILENAME, MICROCODE_FILESIZE,
+		hex_value_parser, &revision))
+	{
+		cpuinfo_log_debug("parsed microcode revision 0x%"PRIx32" for logical processor %"PRIu32" from %s",
+			revision, processor, MICROCODE_FILENAME);
+		*revision_ptr = revision;
+		return true;
+	} else {
+		/* Reported only on x86 with the microcode loader, which hypervisors often lack */
+		cpuinfo_log_info("failed to parse microcode revision for processor %"PRIu32" from %s",
+			processor, MICROCODE_FILENAME);
+		return false;
+	}
+}
+
+/* Parse a cache size in bytes, printed with an optional K, M, or G suffix */
+static bool cache_size_parser(const char* text_start, const char* text_end, void* context) {
+	uint32_t size = 0;
+	const char* parsed_end = parse_number(text_start, text_end, &size);
+	if (parsed_end == text_start) {
+		return false;
+	}
+	if (parsed_end != text_end) {
+		switch (*parsed_end) {
+			case 'K':
+				size <<= 10;
+				break;
+			case 'M':
+				size <<= 20;
+				break;
+			case 'G':
+				size <<= 30;
+				break;
+		}
+	}
+	*((uint32_t*) context) = size;
+	return true;
+}
+
+static bool cache_type_parser(const char* text_start, const char* text_end, void* context) {
+	static const struct {
+		const char* name;
+		enum cpuinfo_linux_cache_type type;
+	} cache_types[] = {
+		{ "Data", cpuinfo_linux_cache_type_data },
+		{ "Instruction", cpuinfo_linux_cache_type_instruction },
+		{ "Unified", cpuinfo_linux_cache_type_unified },
+	};
+	while (text_end != text_start && is_whitespace(text_end[-1])) {
+		text_end--;
+	}
+	const size_t length = (size_t) (text_end - text_start);
+	for (size_t i = 0; i < sizeof(cache_types) / sizeof(cache_types[0]); i++) {
+		if (strlen(cache_types[i].name) == length && memcmp(cache_types[i].name, text_start, length) == 0) {
+			*((enum cpuinfo_linux_cache_type*) context) = cache_types[i].type;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_cache_file(uint32_t processor, uint32_t index, const char* name,
+	cpuinfo_smallfile_callback callback, void* context)
+{
+	char filename[CACHE_FILENAME_SIZE];
+	const int chars_formatted = snprintf(filename, CACHE_FILENAME_SIZE, CACHE_FILENAME_FORMAT, index, name);
+	if ((unsigned int) chars_formatted >= CACHE_FILENAME_SIZE) {
+		return false;
+	}
+	return cpuinfo_linux_parse_processor_small_file(processor, filename, CACHE_FILESIZE, callback, context);
+}
+
+bool cpuinfo_linux_get_processor_cache(uint32_t processor, uint32_t index,
+	struct cpuinfo_linux_cache cache[restrict static 1])
+{
+	struct cpuinfo_linux_cache linux_cache = { 0 };
+	if (!parse_cache_file(processor, index, "level", uint32_parser, &linux_cache.level) ||
+		!parse_cache_file(processor, index, "type", cache_type_parser, &linux_cache.type) ||
+		!parse_cache_file(processor, index, "size", cache_size_parser, &linux_cache.size))
+	{
+		return false;
+	}
+	/* Parameters other than size are missing for some caches, e.g. on kernels which describe them from ACPI PPTT */
+	parse_cache_file(processor, index, "ways_of_associativity", uint32_parser, &linux_cache.associativity);
+	parse_cache_file(processor, index, "number_of_sets", uint32_parser, &linux_cache.sets);
+	parse_cache_file(processor, index, "physical_line_partition", uint32_parser, &linux_cache.partitions);
+	parse_cache_file(processor, index, "coherency_line_size", uint32_parser, &linux_cache.line_size);
+	cpuinfo_log_debug("parsed L%"PRIu32" cache of %"PRIu32" bytes for logical processor %"PRIu32" from cache/index%"PRIu32,
+		linux_cache.level, linux_cache.size, processor, index);
+	*cache = linux_cache;
+	return true;
+}
+
+bool cpuinfo_linux_get_processor_cache_id(uint32_t processor, uint32_t index, uint32_t cache_id[restrict static 1]) {
+	return parse_cache_file(processor, index, "id", uint32_parser, cache_id);
+}
+
+bool cpuinfo_linux_parse_processor_cache_siblings(uint32_t processor, uint32_t index,
+	cpuinfo_cpulist_callback callback, void* context)
+{
+	char filename[CACHE_FILENAME_SIZE];
+	const int chars_formatted = snprintf(filename, CACHE_FILENAME_SIZE, CACHE_FILENAME_FORMAT, index, "shared_cpu_list");
+	if ((unsigned int) chars_formatted >= CACHE_FILENAME_SIZE) {
+		return false;
+	}
+	return cpuinfo_linux_parse_processor_cpulist(processor, filename, callback, context);
+}
+
 static bool max_processor_number_parser(uint32_t processor_list_start, uint32_t processor_list_end, void* context) {
 	uint32_t* processor_number_ptr = (uint32_t*) context;
 	const uint32_t processor_list_last = processor_list_end - 1;
@@ -346,14 +553,6 @@ bool cpuinfo_linux_detect_core_siblings(
 	cpuinfo_siblings_callback callback,
 	void* context)
 {
-	char core_siblings_filename[CORE_SIBLINGS_FILENAME_SIZE];
-	const int chars_formatted = snprintf(
-		core_siblings_filename, CORE_SIBLINGS_FILENAME_SIZE, CORE_SIBLINGS_FILENAME_FORMAT, processor);
-	if ((unsigned int) chars_formatted >= CORE_SIBLINGS_FILENAME_SIZE) {
-		cpuinfo_log_warning("failed to format filename for core siblings of processor %"PRIu32, processor);
-		return false;
-	}
-
 	struct siblings_context siblings_context = {
 		.group_name = "package",
 		.max_processors_count = max_processors_count,
@@ -361,31 +560,88 @@ bool cpuinfo_linux_detect_core_siblings(
 		.callback = callback,
 		.callback_context = context,
 	};
-	if (cpuinfo_linux_parse_cpulist(core_siblings_filename,
+	if (cpuinfo_linux_parse_processor_cpulist(processor, CORE_SIBLINGS_FILENAME,
 		(cpuinfo_cpulist_callback) siblings_parser, &siblings_context))
 	{
 		return true;
 	} else {
 		cpuinfo_log_info("failed to parse the list of core siblings for processor %"PRIu32" from %s",
-			processor, core_siblings_filename);
+			processor, CORE_SIBLINGS_FILENAME);
 		return false;
 	}
 }
 
-bool cpuinfo_linux_detect_thread_siblings(
+static bool cluster_id_parser(const char* text_start, const char* text_end, void* context) {
+	/* Kernels report -1 for processors which firmware doesn't assign to a cluster */
+	uint32_t cluster_id = 0;
+	const char* parsed_end = parse_number(text_start, text_end, &cluster_id);
+	if (parsed_end == text_start) {
+		return false;
+	}
+	*((uint32_t*) context) = cluster_id;
+	return true;
+}
+
+bool cpuinfo_linux_get_processor_cluster_id(uint32_t processor, uint32_t cluster_id_ptr[restrict static 1]) {
+	return cpuinfo_linux_parse_processor_small_file(processor,
+		CLUSTER_ID_FILENAME, CLUSTER_ID_FILESIZE, cluster_id_parser, cluster_id_ptr);
+}
+
+bool cpuinfo_linux_detect_cluster_siblings(
 	uint32_t max_processors_count,
 	uint32_t processor,
 	cpuinfo_siblings_callback callback,
 	void* context)
 {
-	char thread_siblings_filename[THREAD_SIBLINGS_FILENAME_SIZE];
-	const int chars_formatted = snprintf(
-		thread_siblings_filename, THREAD_SIBLINGS_FILENAME_SIZE, THREAD_SIBLINGS_FILENAME_FORMAT, processor);
-	if ((unsigned int) chars_formatted >= THREAD_SIBLINGS_FILENAME_SIZE) {
-		cpuinfo_log_warning("failed to format filename for thread siblings of processor %"PRIu32, processor);
+	struct siblings_context siblings_context = {
+		.group_name = "cluster",
+		.max_processors_count = max_processors_count,
+		.processor = processor,
+		.callback = callback,
+		.callback_context = context,
+	};
+	if (cpuinfo_linux_parse_processor_cpulist(processor, CLUSTER_CPUS_FILENAME,
+		(cpuinfo_cpulist_callback) siblings_parser, &siblings_context))
+	{
+		return true;
+	} else {
+		cpuinfo_log_info("failed to parse the list of cluster siblings for processor %"PRIu32" from %s",
+			processor, CLUSTER_CPUS_FILENAME);
 		return false;
 	}
+}
 
+bool cpuinfo_linux_detect_frequency_siblings(
+	uint32_t max_processors_count,
+	uint32_t processor,
+	cpuinfo_siblings_callback callback,
+	void* context)
+{
+	struct siblings_context siblings_context = {
+		.group_name = "frequency domain",
+		.max_processors_count = max_processors_count,
+		.processor = processor,
+		.callback = callback,
+		.callback_context = context,
+	};
+	return cpuinfo_linux_parse_processor_cpulist(processor, RELATED_CPUS_FILENAME,
+		(cpuinfo_cpulist_callback) siblings_parser, &siblings_context);
+}
+
+bool cpuinfo_linux_parse_processor_core_cpus(uint32_t processor, cpuinfo_cpulist_callback callback, void* context) {
+	if (cpuinfo_linux_parse_processor_cpulist(processor, CORE_CPUS_FILENAME, callback, context)) {
+		return true;
+	}
+	/* Kernels before 5.7 report the same list only as thread_siblings_list */
+	return cpuinfo_linux_parse_processor_cpulist(processor, THREAD_SIBLINGS_FILENAME, callback, context);
+}
+
+bool cpuinfo_linux_detect_thread_siblings(
+	uint32_t max_processors_count,
+	uint32_t processor,
+	cpuinfo_siblings_callback callback,
+	void* context)
+{
 	struct siblings_context siblings_context = {
 		.group_name = "core",
 		.max_processors_count = max_processors_count,
@@ -393,14 +649,57 @@ bool cpuinfo_linux_detect_thread_siblings(
 		.callback = callback,
 		.callback_context = context,
 	};
-	if (cpuinfo_linux_parse_cpulist(thread_siblings_filename,
+	if (cpuinfo_linux_parse_processor_cpulist(processor, THREAD_SIBLINGS_FILENAME,
 		(cpuinfo_cpulist_callback) siblings_parser, &siblings_context))
 	{
 		return true;
 	} else {
 		cpuinfo_log_info("failed to parse the list of thread siblings for processor %"PRIu32" from %s",
-			processor, thread_siblings_filename);
+			processor, THREAD_SIBLINGS_FILENAME);
 		return false;
 	}
 }
 
+
+static bool smt_control_parser(const char* text_start, const char* text_end, void* context) {
+	static const struct {
+		const char* name;
+		enum cpuinfo_smt_control control;
+	} controls[] = {
+		{ "on", cpuinfo_smt_control_on },
+		{ "off", cpuinfo_smt_control_off },
+		{ "forceoff", cpuinfo_smt_control_forceoff },
+		{ "notsupported", cpuinfo_smt_control_not_supported },
+		{ "notimplemented", cpuinfo_smt_control_not_implemented },
+	};
+	size_t length = 0;
+	while (text_start + length != text_end && !is_whitespace(text_start[length])) {
+		length++;
+	}
+	for (size_t i = 0; i < sizeof(controls) / sizeof(controls[0]); i++) {
+		if (strlen(controls[i].name) == length && memcmp(controls[i].name, text_start, length) == 0) {
+			*((enum cpuinfo_smt_control*) context) = controls[i].control;
+			return true;
+		}
+	}
+	cpuinfo_log_info("unknown SMT control \"%.*s\" in %s", (int) length, text_start, SMT_CONTROL_FILENAME);
+	return false;
+}
+
+enum cpuinfo_smt_control cpuinfo_linux_get_smt_control(void) {
+	enum cpuinfo_smt_control control = cpuinfo_smt_control_unknown;
+	cpuinfo_linux_parse_small_file(SMT_CONTROL_FILENAME, SMT_FILESIZE, smt_control_parser, &control);
+	return control;
+}
+
+static bool smt_active_parser(const char* text_start, const char* text_end, void* context) {
+	if (text_start == text_end || (*text_start != '0' && *text_start != '1')) {
+		return false;
+	}
+	*((bool*) context) = *text_start == '1';
+	return true;
+}
+
+bool cpuinfo_linux_get_smt_active(bool active_ptr[restrict static 1]) {
+	return cpuinfo_linux_parse_small_file(SMT_ACTIVE_FILENAME, SMT_FILESIZE, smt_active_parser, active_ptr);
+}
@@ -2,7 +2,6 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <alloca.h>
 #include <errno.h>
 
 #include <sys/types.h>
@@ -10,60 +9,67 @@
 #include <unistd.h>
 #include <fcntl.h>
 
-#if CPUINFO_MOCK
-	#include <cpuinfo-mock.h>
-#endif
 #include <linux/api.h>
+#include <cpuinfo/internal-api.h>
 #include <cpuinfo/log.h>
 
 
+bool cpuinfo_linux_parse_small_file_descriptor(int file, const char* filename, bool single_read,
+	char* buffer, size_t buffer_size, cpuinfo_smallfile_callback callback, void* context)
+{
+	size_t buffer_position = 0;
+	ssize_t bytes_read;
+	do {
+		const size_t bytes_requested = buffer_size - buffer_position;
+		bytes_read = cpuinfo_linux_read_file(file, &buffer[buffer_position], bytes_requested);
+		if (bytes_read < 0) {
+			cpuinfo_log_info("failed to read file %s at position %zu: %s", filename, buffer_position, strerror(errno));
+			cpuinfo_linux_record_file_read(buffer_position);
+			return false;
+		}
+		buffer_position += (size_t) bytes_read;
+		if (buffer_position >= buffer_size) {
+			cpuinfo_log_error("failed to read file %s: insufficient buffer of size %zu", filename, buffer_size);
+			cpuinfo_linux_record_file_read(buffer_position);
+			return false;
+		}
+		if (single_read && (size_t) bytes_read < bytes_requested) {
+			break;
+		}
+	} while (bytes_read != 0);
+	cpuinfo_linux_record_file_read(buffer_position);
+
+	return callback(buffer, &buffer[buffer_position], context);
+}
+
 bool cpuinfo_linux_parse_small_file(const char* filename, size_t buffer_size, cpuinfo_smallfile_callback callback, void* context) {
 	int file = -1;
 	bool status = false;
-	char* buffer = (char*) alloca(buffer_size);
+	char* buffer = NULL;
 
 	#if CPUINFO_LOG_DEBUG_PARSERS
 		cpuinfo_log_debug("parsing small file %s", filename);
 	#endif
 
-#if CPUINFO_MOCK
-	file = cpuinfo_mock_open(filename, O_RDONLY);
-#else
-	file = open(filename, O_RDONLY);
-#endif
+	file = cpuinfo_linux_open_file(filename, O_RDONLY);
 	if (file == -1) {
 		cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
 		goto cleanup;
 	}
+	buffer = cpuinfo_linux_acquire_read_buffer(buffer_size);
+	if (buffer == NULL) {
+		goto cleanup;
+	}
 
-	size_t buffer_position = 0;
-	ssize_t bytes_read;
-	do {
-#if CPUINFO_MOCK
-		bytes_read = cpuinfo_mock_read(file, &buffer[buffer_position], buffer_size - buffer_position);
-#else
-		bytes_read = read(file, &buffer[buffer_position], buffer_size - buffer_position);
-#endif
-		if (bytes_read < 0) {
-			cpuinfo_log_info("failed to read file %s at position %zu: %s", filename, buffer_position, strerror(errno));
-			goto cleanup;
-		}
-		buffer_position += (size_t) bytes_read;
-		if (buffer_position >= buffer_size) {
-			cpuinfo_log_error("failed to read file %s: insufficient buffer of size %zu", filename, buffer_size);
-			goto cleanup;
-		}
-	} while (bytes_read != 0);
-
-	status = callback(buffer, &buffer[buffer_position], context);
+	/* Caller-provided file operations may not follow the read semantics of sysfs */
+	const bool single_read = cpuinfo_file_ops.read == NULL && strncmp(filename, "/sys/", 5) == 0;
+	status = cpuinfo_linux_parse_small_file_descriptor(file, filename, single_read, buffer, buffer_size,
+		callback, context);
 
 cleanup:
+	cpuinfo_linux_release_read_buffer(buffer);
 	if (file != -1) {
-#if CPUINFO_MOCK
-		cpuinfo_mock_close(file);
-#else
-		close(file);
-#endif
+		cpuinfo_linux_close_file(file);
 		file = -1;
 	}
 	return status;
@@ -0,0 +1,271 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include <linux/api.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#define STRINGIFY(token) #token
+
+#define SYSFS_CPU_DIRECTORY "/sys/devices/system/cpu"
+#define PROCESSOR_DIRECTORY_NAME_SIZE (sizeof("cpu" STRINGIFY(UINT32_MAX)))
+#define PROCESSOR_DIRECTORY_NAME_FORMAT "cpu%" PRIu32
+/*
+ * Size of the buffer for sysfs attribute reads, reused by all reads on a thread.
+ * Single-value attributes and sibling lists of systems with several thousand processors fit into it.
+ */
+#define SYSFS_BUFFER_SIZE 4096
+/* Maximum number of threads, including the calling thread, used for parallel probing */
+#define MAX_PROBING_THREADS 8
+/* Minimum number of processors for each probing thread: for fewer processors thread creation overhead dominates */
+#define MIN_PROCESSORS_PER_THREAD 16
+/* Size of the buffer for directory entries returned by one getdents64 call */
+#define DIRECTORY_BUFFER_SIZE 2048
+
+#if !defined(O_CLOEXEC)
+	#define O_CLOEXEC 0
+#endif
+#if !defined(O_DIRECTORY)
+	#define O_DIRECTORY 0
+#endif
+
+#if !CPUINFO_MOCK
+	/* File descriptor of /sys/devices/system/cpu, or -1 if not opened yet */
+	static int cpu_directory = -1;
+	/* File descriptors of /sys/devices/system/cpu/cpuN directories, -1 for not yet opened ones */
+	static int* processor_directories = NULL;
+	static uint32_t processor_directories_count = 0;
+#endif
+/* Thread-local, because attributes may be read concurrently by cpuinfo_linux_parallel_for_processors */
+static __thread char sysfs_buffer[SYSFS_BUFFER_SIZE];
+
+
+#if !CPUINFO_MOCK
+static bool reserve_processor_directories(uint32_t count) {
+	if (count <= processor_directories_count) {
+		return true;
+	}
+
+	int* new_directories = cpuinfo_allocate_temporary(count, sizeof(int));
+	if (new_directories == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for sysfs directories of %"PRIu32" processors",
+			count * sizeof(int), count);
+		return false;
+	}
+	if (processor_directories_count != 0) {
+		memcpy(new_directories, processor_directories, processor_directories_count * sizeof(int));
+	}
+	for (uint32_t i = processor_directories_count; i < count; i++) {
+		new_directories[i] = -1;
+	}
+	cpuinfo_free_temporary(processor_directories);
+	processor_directories = new_directories;
+	processor_directories_count = count;
+	return true;
+}
+
+static bool open_cpu_directory(void) {
+	if (cpu_directory == -1) {
+		cpu_directory = open(SYSFS_CPU_DIRECTORY, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (cpu_directory == -1) {
+			cpuinfo_log_info("failed to open %s: %s", SYSFS_CPU_DIRECTORY, strerror(errno));
+			return false;
+		}
+	}
+	return true;
+}
+
+static int get_processor_directory(uint32_t processor) {
+	if (!open_cpu_directory() || !reserve_processor_directories(processor + 1)) {
+		return -1;
+	}
+
+	if (processor_directories[processor] == -1) {
+		char directory_name[PROCESSOR_DIRECTORY_NAME_SIZE];
+		snprintf(directory_name, PROCESSOR_DIRECTORY_NAME_SIZE, PROCESSOR_DIRECTORY_NAME_FORMAT, processor);
+		processor_directories[processor] = openat(cpu_directory, directory_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (processor_directories[processor] == -1) {
+			cpuinfo_log_info("failed to open %s/%s: %s", SYSFS_CPU_DIRECTORY, directory_name, strerror(errno));
+		}
+	}
+	return processor_directories[processor];
+}
+#endif
+
+static int open_processor_file(uint32_t processor, const char* name) {
+#if !CPUINFO_MOCK
+	if (cpuinfo_file_ops.open == NULL) {
+		const int directory = get_processor_directory(processor);
+		if (directory == -1) {
+			return -1;
+		}
+		return openat(directory, name, O_RDONLY | O_CLOEXEC);
+	}
+#endif
+	/* File operations of cpuinfo_set_file_ops and the mock filesystem are keyed by absolute paths */
+	char filename[sizeof(SYSFS_CPU_DIRECTORY "/") + PROCESSOR_DIRECTORY_NAME_SIZE + 64];
+	const int chars_formatted = snprintf(filename, sizeof(filename),
+		SYSFS_CPU_DIRECTORY "/" PROCESSOR_DIRECTORY_NAME_FORMAT "/%s", processor, name);
+	if ((unsigned int) chars_formatted >= sizeof(filename)) {
+		cpuinfo_log_warning("failed to format filename for %s of processor %"PRIu32, name, processor);
+		return -1;
+	}
+	return cpuinfo_linux_open_file(filename, O_RDONLY);
+}
+
+bool cpuinfo_linux_parse_processor_small_file(uint32_t processor, const char* name,
+	size_t buffer_size, cpuinfo_smallfile_callback callback, void* context)
+{
+	if (buffer_size > SYSFS_BUFFER_SIZE) {
+		buffer_size = SYSFS_BUFFER_SIZE;
+	}
+
+	const int file = open_processor_file(processor, name);
+	if (file == -1) {
+		cpuinfo_log_info("failed to open %s of processor %"PRIu32": %s", name, processor, strerror(errno));
+		return false;
+	}
+	const bool status = cpuinfo_linux_parse_small_file_descriptor(
+		file, name, cpuinfo_file_ops.read == NULL, sysfs_buffer, buffer_size, callback, context);
+	cpuinfo_linux_close_file(file);
+	return status;
+}
+
+bool cpuinfo_linux_parse_processor_cpulist(uint32_t processor, const char* name,
+	cpuinfo_cpulist_callback callback, void* context)
+{
+	const int file = open_processor_file(processor, name);
+	if (file == -1) {
+		cpuinfo_log_info("failed to open %s of processor %"PRIu32": %s", name, processor, strerror(errno));
+		return false;
+	}
+	const bool status = cpuinfo_linux_parse_cpulist_descriptor(file, name, callback, context);
+	cpuinfo_linux_close_file(file);
+	return status;
+}
+
+struct parallel_for_context {
+	cpuinfo_processor_function function;
+	void* function_context;
+	uint32_t processors_count;
+	/* Index of the next processor to be claimed by a thread */
+	uint32_t next_processor;
+};
+
+static void* parallel_for_worker(void* arg) {
+	struct parallel_for_context* context = (struct parallel_for_context*) arg;
+	for (;;) {
+		const uint32_t processor = __sync_fetch_and_add(&context->next_processor, 1);
+		if (processor >= context->processors_count) {
+			break;
+		}
+		context->function(processor, context->function_context);
+	}
+	return NULL;
+}
+
+void cpuinfo_linux_parallel_for_processors(uint32_t processors_count,
+	cpuinfo_processor_function function, void* context)
+{
+	uint32_t threads_count = 1;
+	if (cpuinfo_parallel_probing) {
+		threads_count = processors_count / MIN_PROCESSORS_PER_THREAD;
+		if (threads_count > MAX_PROBING_THREADS) {
+			threads_count = MAX_PROBING_THREADS;
+		}
+	}
+#if CPUINFO_MOCK
+	/* Mock filesystem is not thread-safe */
+	threads_count = 1;
+#else
+	/* Worker threads must not resize the cache of directory descriptors */
+	if (threads_count > 1 && !(open_cpu_directory() && reserve_processor_directories(processors_count))) {
+		threads_count = 1;
+	}
+#endif
+
+	struct parallel_for_context parallel_for_context = {
+		.function = function,
+		.function_context = context,
+		.processors_count = processors_count,
+		.next_processor = 0,
+	};
+	pthread_t threads[MAX_PROBING_THREADS - 1];
+	uint32_t threads_created = 0;
+	for (; threads_created + 1 < threads_count; threads_created++) {
+		if (pthread_create(&threads[threads_created], NULL, parallel_for_worker, &parallel_for_context) != 0) {
+			cpuinfo_log_info("failed to create probing thread %"PRIu32": continuing with %"PRIu32" threads",
+				threads_created + 1, threads_created + 1);
+			break;
+		}
+	}
+	/* The calling thread participates too, and completes all work if no threads could be created */
+	parallel_for_worker(&parallel_for_context);
+	for (uint32_t i = 0; i < threads_created; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+void cpuinfo_linux_release_sysfs(void) {
+#if !CPUINFO_MOCK
+	for (uint32_t i = 0; i < processor_directories_count; i++) {
+		if (processor_directories[i] != -1) {
+			close(processor_directories[i]);
+		}
+	}
+	cpuinfo_free_temporary(processor_directories);
+	processor_directories = NULL;
+	processor_directories_count = 0;
+
+	if (cpu_directory != -1) {
+		close(cpu_directory);
+		cpu_directory = -1;
+	}
+#endif
+}
+
+/* Layout of directory entries returned by getdents64 */
+struct linux_dirent64 {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+bool cpuinfo_linux_scan_directory(const char* path, cpuinfo_directory_callback callback, void* context) {
+	const int directory = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (directory == -1) {
+		return false;
+	}
+	_Alignas(struct linux_dirent64) char buffer[DIRECTORY_BUFFER_SIZE];
+	bool scanning = true;
+	while (scanning) {
+		const long bytes_read = syscall(SYS_getdents64, directory, buffer, sizeof(buffer));
+		if (bytes_read <= 0) {
+			if (bytes_read < 0 && errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		for (long offset = 0; scanning && offset < bytes_read;) {
+			const struct linux_dirent64* entry = (const struct linux_dirent64*) (buffer + offset);
+			scanning = callback(entry->d_name, context);
+			offset += entry->d_reclen;
+		}
+	}
+	close(directory);
+	return true;
+}
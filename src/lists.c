@@ -0,0 +1,260 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+struct cluster_entry {
+	uint32_t capacity;
+	uint32_t smt_id;
+	uint32_t processor_index;
+};
+
+static int compare_cluster_entries(const void* a_ptr, const void* b_ptr) {
+	const struct cluster_entry* a = (const struct cluster_entry*) a_ptr;
+	const struct cluster_entry* b = (const struct cluster_entry*) b_ptr;
+	if (a->capacity != b->capacity) {
+		return a->capacity > b->capacity ? -1 : 1;
+	}
+	if (a->smt_id != b->smt_id) {
+		return a->smt_id < b->smt_id ? -1 : 1;
+	}
+	return a->processor_index < b->processor_index ? -1 : a->processor_index > b->processor_index;
+}
+
+/* Sort logical processors of every cluster by decreasing capacity of their cores, first SMT siblings first */
+static bool sort_cluster_processors(const struct cpuinfo_tables* tables, uint32_t* cluster_indices) {
+	struct cluster_entry* entries = cpuinfo_allocate_temporary(tables->processors_count, sizeof(struct cluster_entry));
+	if (entries == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for sorting logical processors of %"PRIu32" clusters",
+			tables->processors_count * sizeof(struct cluster_entry), tables->clusters_count);
+		return false;
+	}
+	for (uint32_t i = 0; i < tables->clusters_count; i++) {
+		const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+		for (uint32_t j = 0; j < cluster->processor_count; j++) {
+			const struct cpuinfo_processor* processor = &tables->processors[cluster->processor_start + j];
+			entries[j] = (struct cluster_entry) {
+				.capacity = processor->core->capacity,
+				.smt_id = processor->smt_id,
+				.processor_index = cluster->processor_start + j,
+			};
+		}
+		qsort(entries, cluster->processor_count, sizeof(struct cluster_entry), compare_cluster_entries);
+		for (uint32_t j = 0; j < cluster->processor_count; j++) {
+			cluster_indices[cluster->processor_start + j] = entries[j].processor_index;
+		}
+	}
+	cpuinfo_free_temporary(entries);
+	return true;
+}
+
+/* Index of a topology object in its table, or UINT32_MAX if the processor doesn't have the object */
+static uint32_t get_domain_index(const void* object, const void* table, uint32_t count, size_t entry_size) {
+	uint32_t index = UINT32_MAX;
+	cpuinfo_get_table_index(object, table, count, entry_size, &index);
+	return index;
+}
+
+static void build_processor_domains(const struct cpuinfo_tables* tables, struct cpuinfo_processor_domains* domains) {
+	for (uint32_t i = 0; i < tables->processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		domains[i] = (struct cpuinfo_processor_domains) {
+			.core = get_domain_index(processor->core, tables->cores, tables->cores_count, sizeof(struct cpuinfo_core)),
+			.l2 = get_domain_index(processor->cache.l2, tables->cache[cpuinfo_cache_level_2],
+				tables->cache_count[cpuinfo_cache_level_2], sizeof(struct cpuinfo_cache)),
+			.l3 = get_domain_index(processor->cache.l3, tables->cache[cpuinfo_cache_level_3],
+				tables->cache_count[cpuinfo_cache_level_3], sizeof(struct cpuinfo_cache)),
+			.cluster = get_domain_index(processor->cluster, tables->clusters, tables->clusters_count,
+				sizeof(struct cpuinfo_cluster)),
+			.numa_node = get_domain_index(processor->numa_node, tables->numa_nodes, tables->numa_nodes_count,
+				sizeof(struct cpuinfo_numa_node)),
+			.package = get_domain_index(processor->package, tables->packages, tables->packages_count,
+				sizeof(struct cpuinfo_package)),
+		};
+	}
+}
+
+struct steal_entry {
+	uint32_t distance;
+	uint32_t rotation;
+	uint32_t processor_index;
+};
+
+static int compare_steal_entries(const void* a_ptr, const void* b_ptr) {
+	const struct steal_entry* a = (const struct steal_entry*) a_ptr;
+	const struct steal_entry* b = (const struct steal_entry*) b_ptr;
+	if (a->distance != b->distance) {
+		return a->distance < b->distance ? -1 : 1;
+	}
+	return a->rotation < b->rotation ? -1 : a->rotation > b->rotation;
+}
+
+/*
+ * Order victims on other NUMA nodes by the NUMA distance from the node of the thief, keeping the rotated order
+ * among victims at equal distance. With at most two nodes all such victims are at the same distance.
+ */
+static void sort_remote_victims(const struct cpuinfo_tables* tables, const struct cpuinfo_processor_domains* domains,
+	uint32_t thief_index, uint32_t* victims, uint32_t count, struct steal_entry* entries)
+{
+	const uint32_t* distances =
+		&tables->numa_distances[(size_t) domains[thief_index].numa_node * tables->numa_nodes_count];
+	for (uint32_t i = 0; i < count; i++) {
+		entries[i] = (struct steal_entry) {
+			.distance = distances[domains[victims[i]].numa_node],
+			.rotation = i,
+			.processor_index = victims[i],
+		};
+	}
+	qsort(entries, count, sizeof(struct steal_entry), compare_steal_entries);
+	for (uint32_t i = 0; i < count; i++) {
+		victims[i] = entries[i].processor_index;
+	}
+}
+
+/*
+ * Order the usable logical processors other than the thief by their distance level from it.
+ * Victims at the same level follow the thief in the rotated order of usable processors, so that thieves of a
+ * domain start their scans at different victims instead of all stealing from the first one.
+ */
+static bool build_steal_orders(const struct cpuinfo_tables* tables, const struct cpuinfo_processor_domains* domains,
+	uint32_t* steal_orders)
+{
+	const uint32_t usable_count = tables->usable_processors_count;
+	struct steal_entry* entries = NULL;
+	if (tables->numa_nodes_count > 2) {
+		entries = cpuinfo_allocate_temporary(usable_count, sizeof(struct steal_entry));
+		if (entries == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for sorting victims of %"PRIu32" logical processors",
+				usable_count * sizeof(struct steal_entry), tables->processors_count);
+			return false;
+		}
+	}
+
+	/* Position of the first usable processor after the thief in the list of usable processors */
+	uint32_t rotation_start = 0;
+	for (uint32_t i = 0; i < tables->processors_count; i++) {
+		while (rotation_start < usable_count && tables->usable_processor_indices[rotation_start] <= i) {
+			rotation_start++;
+		}
+		const struct cpuinfo_processor_domains* thief = &domains[i];
+		uint32_t* victims = &steal_orders[(size_t) i * usable_count];
+
+		/* Counting sort by level, visiting victims in the rotated order keeps it within every level */
+		uint32_t level_offsets[cpuinfo_distance_level_max + 1] = { 0 };
+		for (uint32_t j = 0; j < usable_count; j++) {
+			const uint32_t victim_index = tables->usable_processor_indices[j];
+			if (victim_index != i) {
+				level_offsets[cpuinfo_get_domains_distance_level(thief, &domains[victim_index]) + 1] += 1;
+			}
+		}
+		for (uint32_t level = 0; level < cpuinfo_distance_level_max; level++) {
+			level_offsets[level + 1] += level_offsets[level];
+		}
+		const uint32_t package_start = level_offsets[cpuinfo_distance_level_package];
+		const uint32_t victims_count = level_offsets[cpuinfo_distance_level_max];
+		for (uint32_t j = 0; j < usable_count; j++) {
+			const uint32_t victim_index = tables->usable_processor_indices[(rotation_start + j) % usable_count];
+			if (victim_index != i) {
+				const struct cpuinfo_processor_domains* victim = &domains[victim_index];
+				victims[level_offsets[cpuinfo_get_domains_distance_level(thief, victim)]++] = victim_index;
+			}
+		}
+		if (entries != NULL) {
+			sort_remote_victims(tables, domains, i, &victims[package_start], victims_count - package_start, entries);
+		}
+	}
+	cpuinfo_free_temporary(entries);
+	return true;
+}
+
+bool cpuinfo_build_processor_lists(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	if (processors_count == 0) {
+		return true;
+	}
+
+	struct cpuinfo_arena arena = { 0 };
+	const size_t core_indices_offset = cpuinfo_arena_reserve(&arena, tables->cores_count, sizeof(uint32_t));
+	const size_t uarch_indices_offset = cpuinfo_arena_reserve(&arena, processors_count, sizeof(uint32_t));
+	const size_t uarch_offsets_offset = cpuinfo_arena_reserve(&arena, tables->uarchs_count + 1, sizeof(uint32_t));
+	const size_t cluster_indices_offset = cpuinfo_arena_reserve(&arena, processors_count, sizeof(uint32_t));
+	const size_t domains_offset =
+		cpuinfo_arena_reserve(&arena, processors_count, sizeof(struct cpuinfo_processor_domains));
+	const size_t steal_orders_offset = cpuinfo_arena_reserve(&arena,
+		(size_t) processors_count * tables->usable_processors_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return false;
+	}
+	uint32_t* core_indices = cpuinfo_arena_get(&arena, core_indices_offset, tables->cores_count);
+	uint32_t* uarch_indices = cpuinfo_arena_get(&arena, uarch_indices_offset, processors_count);
+	uint32_t* uarch_offsets = cpuinfo_arena_get(&arena, uarch_offsets_offset, tables->uarchs_count + 1);
+	uint32_t* cluster_indices = cpuinfo_arena_get(&arena, cluster_indices_offset, processors_count);
+	struct cpuinfo_processor_domains* domains = cpuinfo_arena_get(&arena, domains_offset, processors_count);
+	uint32_t* steal_orders = cpuinfo_arena_get(&arena, steal_orders_offset,
+		(size_t) processors_count * tables->usable_processors_count);
+
+	/* The first SMT sibling of a core is the one with the lowest SMT ID */
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		const struct cpuinfo_core* core = &tables->cores[i];
+		uint32_t primary_index = core->processor_start;
+		for (uint32_t j = core->processor_start + 1; j < core->processor_start + core->processor_count; j++) {
+			if (tables->processors[j].smt_id < tables->processors[primary_index].smt_id) {
+				primary_index = j;
+			}
+		}
+		core_indices[i] = primary_index;
+	}
+
+	/* Group logical processors by microarchitecture with a counting sort, which keeps them in increasing order */
+	if (tables->uarchs_count != 0) {
+		for (uint32_t i = 0; i < processors_count; i++) {
+			uarch_offsets[cpuinfo_get_processor_uarch_index(tables, &tables->processors[i]) + 1] += 1;
+		}
+		for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+			uarch_offsets[i + 1] += uarch_offsets[i];
+		}
+		for (uint32_t i = 0; i < processors_count; i++) {
+			const uint32_t uarch_index = cpuinfo_get_processor_uarch_index(tables, &tables->processors[i]);
+			uarch_indices[uarch_offsets[uarch_index]++] = i;
+		}
+		/* Placement advanced every offset to the start of the next microarchitecture */
+		for (uint32_t i = tables->uarchs_count; i != 0; i--) {
+			uarch_offsets[i] = uarch_offsets[i - 1];
+		}
+		uarch_offsets[0] = 0;
+	}
+
+	build_processor_domains(tables, domains);
+	if (!sort_cluster_processors(tables, cluster_indices) || !build_steal_orders(tables, domains, steal_orders)) {
+		cpuinfo_arena_free(arena.memory);
+		return false;
+	}
+
+	tables->core_primary_processor_indices = core_indices;
+	tables->uarch_processor_indices = uarch_indices;
+	tables->uarch_processor_offsets = uarch_offsets;
+	tables->cluster_processor_indices = cluster_indices;
+	tables->processor_domains = domains;
+	tables->steal_orders = steal_orders;
+	tables->processor_list_memory = arena.memory;
+	return true;
+}
+
+const struct cpuinfo_processor* cpuinfo_get_uarch_first_processor(const struct cpuinfo_tables* tables,
+	uint32_t uarch_index)
+{
+	if (uarch_index >= tables->uarchs_count || tables->uarch_processor_offsets == NULL) {
+		return NULL;
+	}
+	const uint32_t start = tables->uarch_processor_offsets[uarch_index];
+	if (start == tables->uarch_processor_offsets[uarch_index + 1]) {
+		return NULL;
+	}
+	return &tables->processors[tables->uarch_processor_indices[start]];
+}
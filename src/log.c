@@ -23,6 +23,7 @@
   #endif
 #endif
 
+#include <cpuinfo.h>
 #include <cpuinfo/log.h>
 
 
@@ -46,6 +47,35 @@
   #define CPUINFO_LOG_STDOUT STDOUT_FILENO
 #endif
 
+int cpuinfo_log_level_threshold = CPUINFO_LOG_LEVEL;
+
+static cpuinfo_log_callback log_callback = NULL;
+static void* log_callback_context = NULL;
+
+bool CPUINFO_ABI cpuinfo_set_log_level(enum cpuinfo_log_level level) {
+  if ((unsigned int) level > (unsigned int) cpuinfo_log_level_debug) {
+    cpuinfo_log_warning("unsupported log level %d is ignored", (int) level);
+    return false;
+  }
+  cpuinfo_log_level_threshold = (int) level;
+  return true;
+}
+
+void CPUINFO_ABI cpuinfo_set_log_callback(cpuinfo_log_callback callback, void* context) {
+  log_callback = callback;
+  log_callback_context = context;
+}
+
+/* Deliver the unformatted message to the callback, if one is set, and return true if it was delivered */
+static inline bool cpuinfo_vlog_callback(enum cpuinfo_log_level level, const char* format, va_list args) {
+  const cpuinfo_log_callback callback = log_callback;
+  if (callback == NULL) {
+    return false;
+  }
+  callback(log_callback_context, level, format, args);
+  return true;
+}
+
 #if CPUINFO_LOG_TO_STDIO
 static void cpuinfo_vlog(int output_handle, const char* prefix, size_t prefix_length, const char* format, va_list args) {
   char stack_buffer[CPUINFO_LOG_STACK_BUFFER_SIZE];
@@ -118,6 +148,9 @@ cleanup:
 
 #if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_DEBUG
   void cpuinfo_vlog_debug(const char* format, va_list args) {
+    if (cpuinfo_vlog_callback(cpuinfo_log_level_debug, format, args)) {
+      return;
+    }
     #if CPUINFO_LOG_TO_STDIO
       static const char debug_prefix[17] = {
         'D', 'e', 'b', 'u', 'g', ' ', '(', 'c', 'p', 'u', 'i', 'n', 'f', 'o', ')', ':', ' '
@@ -133,6 +166,9 @@ cleanup:
 
 #if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_INFO
   void cpuinfo_vlog_info(const char* format, va_list args) {
+    if (cpuinfo_vlog_callback(cpuinfo_log_level_info, format, args)) {
+      return;
+    }
     #if CPUINFO_LOG_TO_STDIO
       static const char info_prefix[16] = {
         'N', 'o', 't', 'e', ' ', '(', 'c', 'p', 'u', 'i', 'n', 'f', 'o', ')', ':', ' '
@@ -148,6 +184,9 @@ cleanup:
 
 #if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_WARNING
   void cpuinfo_vlog_warning(const char* format, va_list args) {
+    if (cpuinfo_vlog_callback(cpuinfo_log_level_warning, format, args)) {
+      return;
+    }
     #if CPUINFO_LOG_TO_STDIO
       static const char warning_prefix[20] = {
         'W', 'a', 'r', 'n', 'i', 'n', 'g', ' ', 'i', 'n', ' ', 'c', 'p', 'u', 'i', 'n', 'f', 'o', ':', ' '
@@ -163,6 +202,9 @@ cleanup:
 
 #if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_ERROR
   void cpuinfo_vlog_error(const char* format, va_list args) {
+    if (cpuinfo_vlog_callback(cpuinfo_log_level_error, format, args)) {
+      return;
+    }
     #if CPUINFO_LOG_TO_STDIO
       static const char error_prefix[18] = {
         'E', 'r', 'r', 'o', 'r', ' ', 'i', 'n', ' ', 'c', 'p', 'u', 'i', 'n', 'f', 'o', ':', ' '
@@ -178,6 +220,9 @@ cleanup:
 
 #if CPUINFO_LOG_LEVEL >= CPUINFO_LOG_FATAL
   void cpuinfo_vlog_fatal(const char* format, va_list args) {
+    if (cpuinfo_vlog_callback(cpuinfo_log_level_fatal, format, args)) {
+      return;
+    }
     #if CPUINFO_LOG_TO_STDIO
       static const char fatal_prefix[24] = {
         'F', 'a', 't', 'a', 'l', ' ', 'e', 'r', 'r', 'o', 'r', ' ', 'i', 'n', ' ', 'c', 'p', 'u', 'i', 'n', 'f', 'o', ':', ' '
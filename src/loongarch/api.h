@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
+
+
+/* Configuration words of CPUCFG, from the LoongArch Reference Manual, Volume 1 */
+#define CPUINFO_LOONGARCH_CPUCFG_PRID     UINT32_C(0x00)
+#define CPUINFO_LOONGARCH_CPUCFG_ARCH     UINT32_C(0x01)
+#define CPUINFO_LOONGARCH_CPUCFG_FEATURES UINT32_C(0x02)
+#define CPUINFO_LOONGARCH_CPUCFG_CACHES   UINT32_C(0x10)
+/* Words 0x11-0x14 describe the L1 instruction or unified cache, the L1 data cache, the L2 and the L3 cache */
+#define CPUINFO_LOONGARCH_CPUCFG_CACHE_PARAMETERS       UINT32_C(0x11)
+#define CPUINFO_LOONGARCH_CPUCFG_CACHE_PARAMETERS_COUNT 4
+
+struct cpuinfo_loongarch_cpucfg {
+	uint32_t prid;
+	uint32_t arch;
+	uint32_t features;
+	uint32_t caches;
+	uint32_t cache_parameters[CPUINFO_LOONGARCH_CPUCFG_CACHE_PARAMETERS_COUNT];
+};
+
+CPUINFO_INTERNAL void cpuinfo_loongarch_decode_isa(
+	const struct cpuinfo_loongarch_cpucfg cpucfg[restrict static 1],
+	struct cpuinfo_loongarch_isa isa[restrict static 1]);
+
+/* Decode the vendor and microarchitecture from the processor ID in CPUCFG word 0 */
+CPUINFO_INTERNAL void cpuinfo_loongarch_decode_vendor_uarch(
+	uint32_t prid,
+	enum cpuinfo_vendor vendor[restrict static 1],
+	enum cpuinfo_uarch uarch[restrict static 1]);
+
+/*
+ * Decode parameters of caches from CPUCFG words 0x10-0x14 into caches indexed by cpuinfo_cache_level, with zero size
+ * for caches which the processor doesn't have. The processor_start and processor_count members are not set.
+ * Returns the bitmask of cache levels, (1 << level), where caches are private to a core.
+ */
+CPUINFO_INTERNAL uint32_t cpuinfo_loongarch_decode_caches(
+	const struct cpuinfo_loongarch_cpucfg cpucfg[restrict static 1],
+	struct cpuinfo_cache caches[restrict static cpuinfo_cache_level_max]);
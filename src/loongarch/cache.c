@@ -0,0 +1,86 @@
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <loongarch/api.h>
+#include <cpuinfo/log.h>
+
+
+/* Bits of CPUCFG word 0x10: IU are instruction or unified caches, and D are data caches */
+#define CPUCFG_CACHES_L1_IU_PRESENT   UINT32_C(0x00000001)
+#define CPUCFG_CACHES_L1_IU_UNIFIED   UINT32_C(0x00000002)
+#define CPUCFG_CACHES_L1_D_PRESENT    UINT32_C(0x00000004)
+#define CPUCFG_CACHES_L2_IU_PRESENT   UINT32_C(0x00000008)
+#define CPUCFG_CACHES_L2_IU_UNIFIED   UINT32_C(0x00000010)
+#define CPUCFG_CACHES_L2_IU_PRIVATE   UINT32_C(0x00000020)
+#define CPUCFG_CACHES_L2_IU_INCLUSIVE UINT32_C(0x00000040)
+#define CPUCFG_CACHES_L3_IU_PRESENT   UINT32_C(0x00000400)
+#define CPUCFG_CACHES_L3_IU_UNIFIED   UINT32_C(0x00000800)
+#define CPUCFG_CACHES_L3_IU_PRIVATE   UINT32_C(0x00001000)
+#define CPUCFG_CACHES_L3_IU_INCLUSIVE UINT32_C(0x00002000)
+
+/* Fields of CPUCFG words 0x11-0x14: associativity minus 1, log2 of the number of sets, and log2 of the line size */
+#define CPUCFG_CACHE_WAYS_MASK        UINT32_C(0x0000FFFF)
+#define CPUCFG_CACHE_SETS_LOG2_OFFSET 16
+#define CPUCFG_CACHE_SETS_LOG2_MASK   UINT32_C(0x000000FF)
+#define CPUCFG_CACHE_LINE_LOG2_OFFSET 24
+#define CPUCFG_CACHE_LINE_LOG2_MASK   UINT32_C(0x0000007F)
+
+static struct cpuinfo_cache decode_cache(uint32_t parameters, uint32_t flags) {
+	const uint32_t associativity = (parameters & CPUCFG_CACHE_WAYS_MASK) + 1;
+	const uint32_t sets_log2 = (parameters >> CPUCFG_CACHE_SETS_LOG2_OFFSET) & CPUCFG_CACHE_SETS_LOG2_MASK;
+	const uint32_t line_size_log2 = (parameters >> CPUCFG_CACHE_LINE_LOG2_OFFSET) & CPUCFG_CACHE_LINE_LOG2_MASK;
+	if (sets_log2 + line_size_log2 >= 32) {
+		cpuinfo_log_warning("ignored cache with invalid parameters 0x%08"PRIx32" in CPUCFG", parameters);
+		return (struct cpuinfo_cache) { 0 };
+	}
+	const uint32_t sets = UINT32_C(1) << sets_log2;
+	const uint32_t line_size = UINT32_C(1) << line_size_log2;
+	return (struct cpuinfo_cache) {
+		.size = associativity * sets * line_size,
+		.associativity = associativity,
+		.sets = sets,
+		.partitions = 1,
+		.line_size = line_size,
+		.flags = flags,
+	};
+}
+
+uint32_t cpuinfo_loongarch_decode_caches(
+	const struct cpuinfo_loongarch_cpucfg cpucfg[restrict static 1],
+	struct cpuinfo_cache caches[restrict static cpuinfo_cache_level_max])
+{
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		caches[level] = (struct cpuinfo_cache) { 0 };
+	}
+
+	/* L1 caches are always private to a core */
+	uint32_t private_levels = (UINT32_C(1) << cpuinfo_cache_level_1i) | (UINT32_C(1) << cpuinfo_cache_level_1d);
+	const uint32_t present = cpucfg->caches;
+	if (present & CPUCFG_CACHES_L1_IU_PRESENT) {
+		if (present & CPUCFG_CACHES_L1_IU_UNIFIED) {
+			caches[cpuinfo_cache_level_1d] = decode_cache(cpucfg->cache_parameters[0], CPUINFO_CACHE_UNIFIED);
+		} else {
+			caches[cpuinfo_cache_level_1i] = decode_cache(cpucfg->cache_parameters[0], 0);
+		}
+	}
+	if (present & CPUCFG_CACHES_L1_D_PRESENT) {
+		caches[cpuinfo_cache_level_1d] = decode_cache(cpucfg->cache_parameters[1], 0);
+	}
+	if (present & CPUCFG_CACHES_L2_IU_PRESENT) {
+		caches[cpuinfo_cache_level_2] = decode_cache(cpucfg->cache_parameters[2],
+			((present & CPUCFG_CACHES_L2_IU_UNIFIED) ? CPUINFO_CACHE_UNIFIED : 0) |
+			((present & CPUCFG_CACHES_L2_IU_INCLUSIVE) ? CPUINFO_CACHE_INCLUSIVE : 0));
+		if (present & CPUCFG_CACHES_L2_IU_PRIVATE) {
+			private_levels |= UINT32_C(1) << cpuinfo_cache_level_2;
+		}
+	}
+	if (present & CPUCFG_CACHES_L3_IU_PRESENT) {
+		caches[cpuinfo_cache_level_3] = decode_cache(cpucfg->cache_parameters[3],
+			((present & CPUCFG_CACHES_L3_IU_UNIFIED) ? CPUINFO_CACHE_UNIFIED : 0) |
+			((present & CPUCFG_CACHES_L3_IU_INCLUSIVE) ? CPUINFO_CACHE_INCLUSIVE : 0));
+		if (present & CPUCFG_CACHES_L3_IU_PRIVATE) {
+			private_levels |= UINT32_C(1) << cpuinfo_cache_level_3;
+		}
+	}
+	return private_levels;
+}
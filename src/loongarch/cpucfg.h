@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+
+#include <loongarch/api.h>
+
+
+/* CPUCFG is an unprivileged instruction, which reads a 32-bit configuration word of the processor */
+static inline uint32_t cpucfg(uint32_t word) {
+	uint32_t value;
+	__asm__ __volatile__("cpucfg %0, %1" : "=r" (value) : "r" (word));
+	return value;
+}
+
+static inline void cpuinfo_loongarch_read_cpucfg(struct cpuinfo_loongarch_cpucfg cpucfg_words[restrict static 1]) {
+	cpucfg_words->prid = cpucfg(CPUINFO_LOONGARCH_CPUCFG_PRID);
+	cpucfg_words->arch = cpucfg(CPUINFO_LOONGARCH_CPUCFG_ARCH);
+	cpucfg_words->features = cpucfg(CPUINFO_LOONGARCH_CPUCFG_FEATURES);
+	cpucfg_words->caches = cpucfg(CPUINFO_LOONGARCH_CPUCFG_CACHES);
+	for (uint32_t i = 0; i < CPUINFO_LOONGARCH_CPUCFG_CACHE_PARAMETERS_COUNT; i++) {
+		cpucfg_words->cache_parameters[i] = cpucfg(CPUINFO_LOONGARCH_CPUCFG_CACHE_PARAMETERS + i);
+	}
+}
@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <loongarch/api.h>
+#include <cpuinfo/log.h>
+
+
+/* Fields of CPUCFG word 1 */
+#define CPUCFG_ARCH_MASK  UINT32_C(0x00000003)
+#define CPUCFG_ARCH_LA64  UINT32_C(0x00000002)
+#define CPUCFG_ARCH_UAL   UINT32_C(0x00100000)
+#define CPUCFG_ARCH_CRC32 UINT32_C(0x02000000)
+
+/* Bits of CPUCFG word 2 */
+#define CPUCFG_FEATURES_FP       UINT32_C(0x00000001)
+#define CPUCFG_FEATURES_FP_SP    UINT32_C(0x00000002)
+#define CPUCFG_FEATURES_FP_DP    UINT32_C(0x00000004)
+#define CPUCFG_FEATURES_LSX      UINT32_C(0x00000040)
+#define CPUCFG_FEATURES_LASX     UINT32_C(0x00000080)
+#define CPUCFG_FEATURES_COMPLEX  UINT32_C(0x00000100)
+#define CPUCFG_FEATURES_CRYPTO   UINT32_C(0x00000200)
+#define CPUCFG_FEATURES_LBT_X86  UINT32_C(0x00040000)
+#define CPUCFG_FEATURES_LBT_ARM  UINT32_C(0x00080000)
+#define CPUCFG_FEATURES_LBT_MIPS UINT32_C(0x00100000)
+#define CPUCFG_FEATURES_LAM      UINT32_C(0x00400000)
+#define CPUCFG_FEATURES_FRECIPE  UINT32_C(0x02000000)
+#define CPUCFG_FEATURES_LAM_BH   UINT32_C(0x08000000)
+
+static inline bool bitmask_all(uint32_t bitfield, uint32_t mask) {
+	return (bitfield & mask) == mask;
+}
+
+void cpuinfo_loongarch_decode_isa(
+	const struct cpuinfo_loongarch_cpucfg cpucfg[restrict static 1],
+	struct cpuinfo_loongarch_isa isa[restrict static 1])
+{
+	const uint32_t arch = cpucfg->arch;
+	const uint32_t features = cpucfg->features;
+	if ((arch & CPUCFG_ARCH_MASK) != CPUCFG_ARCH_LA64) {
+		cpuinfo_log_warning("unexpected architecture %"PRIu32" in CPUCFG word 1", arch & CPUCFG_ARCH_MASK);
+	}
+
+	isa->fpu = bitmask_all(features, CPUCFG_FEATURES_FP | CPUCFG_FEATURES_FP_SP | CPUCFG_FEATURES_FP_DP);
+	/* LSX and LASX operate on floating-point registers, and LASX extends LSX registers */
+	isa->lsx = isa->fpu && (features & CPUCFG_FEATURES_LSX);
+	isa->lasx = isa->lsx && (features & CPUCFG_FEATURES_LASX);
+
+	isa->crc32 = !!(arch & CPUCFG_ARCH_CRC32);
+	isa->lam = !!(features & CPUCFG_FEATURES_LAM);
+	isa->lam_bh = isa->lam && (features & CPUCFG_FEATURES_LAM_BH);
+	isa->ual = !!(arch & CPUCFG_ARCH_UAL);
+
+	isa->complex = !!(features & CPUCFG_FEATURES_COMPLEX);
+	isa->crypto = !!(features & CPUCFG_FEATURES_CRYPTO);
+	isa->frecipe = isa->fpu && (features & CPUCFG_FEATURES_FRECIPE);
+
+	isa->lbt_x86 = !!(features & CPUCFG_FEATURES_LBT_X86);
+	isa->lbt_arm = !!(features & CPUCFG_FEATURES_LBT_ARM);
+	isa->lbt_mips = !!(features & CPUCFG_FEATURES_LBT_MIPS);
+}
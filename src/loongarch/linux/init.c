@@ -0,0 +1,400 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/auxv.h>
+
+#include <cpuinfo.h>
+#include <loongarch/api.h>
+#include <loongarch/cpucfg.h>
+#include <linux/api.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Bits of AT_HWCAP from <asm/hwcap.h> of Linux 6.1 */
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_CPUCFG   UINT32_C(0x00000001)
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_FPU      UINT32_C(0x00000008)
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_LSX      UINT32_C(0x00000010)
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_LASX     UINT32_C(0x00000020)
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_LBT_X86  UINT32_C(0x00000400)
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_LBT_ARM  UINT32_C(0x00000800)
+#define CPUINFO_LOONGARCH_LINUX_HWCAP_LBT_MIPS UINT32_C(0x00001000)
+
+struct cpuinfo_loongarch_isa cpuinfo_isa = { 0 };
+
+struct cpuinfo_loongarch_linux_processor {
+	uint32_t flags;
+	uint32_t system_processor_id;
+	uint32_t package_id;
+	uint32_t core_id;
+};
+
+static inline bool bitmask_all(uint32_t bitfield, uint32_t mask) {
+	return (bitfield & mask) == mask;
+}
+
+static inline uint32_t min(uint32_t a, uint32_t b) {
+	return a < b ? a : b;
+}
+
+static inline int cmp(uint32_t a, uint32_t b) {
+	return (a > b) - (a < b);
+}
+
+static void detect_topology_ids(
+	uint32_t processor,
+	struct cpuinfo_loongarch_linux_processor* processors)
+{
+	if (!bitmask_all(processors[processor].flags, CPUINFO_LINUX_FLAG_VALID)) {
+		return;
+	}
+
+	if (cpuinfo_linux_get_processor_package_id(processor, &processors[processor].package_id)) {
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_PACKAGE_ID;
+	}
+	if (cpuinfo_linux_get_processor_core_id(processor, &processors[processor].core_id)) {
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_CORE_ID;
+	}
+}
+
+/*
+ * CPUCFG reports the extensions which the hardware implements, but the kernel must also save and restore the
+ * registers of FPU, LSX, LASX and LBT extensions. AT_HWCAP reports the extensions which the kernel enabled.
+ */
+static void disable_unsupported_extensions(struct cpuinfo_loongarch_isa isa[restrict static 1]) {
+	const uint32_t hwcap = (uint32_t) getauxval(AT_HWCAP);
+	if (!(hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_CPUCFG)) {
+		cpuinfo_log_warning("AT_HWCAP 0x%08"PRIx32" doesn't report CPUCFG: extensions are reported as-is", hwcap);
+		return;
+	}
+
+	isa->fpu = isa->fpu && (hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_FPU);
+	isa->lsx = isa->lsx && (hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_LSX);
+	isa->lasx = isa->lasx && (hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_LASX);
+	isa->frecipe = isa->frecipe && isa->fpu;
+	isa->lbt_x86 = isa->lbt_x86 && (hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_LBT_X86);
+	isa->lbt_arm = isa->lbt_arm && (hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_LBT_ARM);
+	isa->lbt_mips = isa->lbt_mips && (hwcap & CPUINFO_LOONGARCH_LINUX_HWCAP_LBT_MIPS);
+}
+
+static int cmp_loongarch_linux_processor(const void* ptr_a, const void* ptr_b) {
+	const struct cpuinfo_loongarch_linux_processor* processor_a =
+		(const struct cpuinfo_loongarch_linux_processor*) ptr_a;
+	const struct cpuinfo_loongarch_linux_processor* processor_b =
+		(const struct cpuinfo_loongarch_linux_processor*) ptr_b;
+
+	/* Move usable processors towards the start of the array */
+	const bool usable_a = bitmask_all(processor_a->flags, CPUINFO_LINUX_FLAG_VALID);
+	const bool usable_b = bitmask_all(processor_b->flags, CPUINFO_LINUX_FLAG_VALID);
+	if (usable_a != usable_b) {
+		return (int) usable_b - (int) usable_a;
+	}
+
+	/* Compare based on package id, then on core id within the package, to keep SMT siblings together */
+	if (processor_a->package_id != processor_b->package_id) {
+		return cmp(processor_a->package_id, processor_b->package_id);
+	}
+	if (processor_a->core_id != processor_b->core_id) {
+		return cmp(processor_a->core_id, processor_b->core_id);
+	}
+
+	/* Compare based on system processor id (i.e. processor 0 < processor 1) */
+	return cmp(processor_a->system_processor_id, processor_b->system_processor_id);
+}
+
+void cpuinfo_loongarch_linux_init(void) {
+	struct cpuinfo_loongarch_linux_processor* loongarch_linux_processors = NULL;
+	struct cpuinfo_processor* processors = NULL;
+	struct cpuinfo_core* cores = NULL;
+	struct cpuinfo_cluster* clusters = NULL;
+	struct cpuinfo_package* packages = NULL;
+	struct cpuinfo_cache* caches[cpuinfo_cache_level_max] = { NULL };
+	const struct cpuinfo_processor** linux_cpu_to_processor_map = NULL;
+	const struct cpuinfo_core** linux_cpu_to_core_map = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
+	uint64_t phase_start = cpuinfo_get_timestamp_ns();
+
+	const uint32_t max_processors_count = cpuinfo_linux_get_max_processors_count();
+	cpuinfo_log_debug("system maximum processors count: %"PRIu32, max_processors_count);
+
+	const uint32_t max_possible_processors_count = 1 +
+		cpuinfo_linux_get_max_possible_processor(max_processors_count);
+	cpuinfo_log_debug("maximum possible processors count: %"PRIu32, max_possible_processors_count);
+	const uint32_t max_present_processors_count = 1 +
+		cpuinfo_linux_get_max_present_processor(max_processors_count);
+	cpuinfo_log_debug("maximum present processors count: %"PRIu32, max_present_processors_count);
+
+	uint32_t valid_processor_mask = 0;
+	uint32_t loongarch_linux_processors_count = max_processors_count;
+	if (max_present_processors_count != 0) {
+		loongarch_linux_processors_count = min(loongarch_linux_processors_count, max_present_processors_count);
+		valid_processor_mask = CPUINFO_LINUX_FLAG_PRESENT;
+	}
+	if (max_possible_processors_count != 0) {
+		loongarch_linux_processors_count = min(loongarch_linux_processors_count, max_possible_processors_count);
+		valid_processor_mask |= CPUINFO_LINUX_FLAG_POSSIBLE;
+	}
+	if ((max_present_processors_count | max_possible_processors_count) == 0) {
+		cpuinfo_log_error("failed to parse both lists of possible and present processors");
+		return;
+	}
+
+	loongarch_linux_processors =
+		cpuinfo_allocate_temporary(loongarch_linux_processors_count, sizeof(struct cpuinfo_loongarch_linux_processor));
+	if (loongarch_linux_processors == NULL) {
+		cpuinfo_log_error(
+			"failed to allocate %zu bytes for descriptions of %"PRIu32" LoongArch logical processors",
+			loongarch_linux_processors_count * sizeof(struct cpuinfo_loongarch_linux_processor),
+			loongarch_linux_processors_count);
+		return;
+	}
+
+	if (max_possible_processors_count) {
+		cpuinfo_linux_detect_possible_processors(
+			loongarch_linux_processors_count, &loongarch_linux_processors->flags,
+			sizeof(struct cpuinfo_loongarch_linux_processor),
+			CPUINFO_LINUX_FLAG_POSSIBLE);
+	}
+
+	if (max_present_processors_count) {
+		cpuinfo_linux_detect_present_processors(
+			loongarch_linux_processors_count, &loongarch_linux_processors->flags,
+			sizeof(struct cpuinfo_loongarch_linux_processor),
+			CPUINFO_LINUX_FLAG_PRESENT);
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_cpulists, &phase_start);
+
+	uint32_t valid_processors = 0;
+	for (uint32_t i = 0; i < loongarch_linux_processors_count; i++) {
+		loongarch_linux_processors[i].system_processor_id = i;
+		if (bitmask_all(loongarch_linux_processors[i].flags, valid_processor_mask)) {
+			loongarch_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_VALID;
+			valid_processors += 1;
+		}
+	}
+	if (valid_processors == 0) {
+		cpuinfo_log_error("no valid processors in the lists of possible and present processors");
+		goto cleanup;
+	}
+
+	/*
+	 * Assume that all cores are identical, as on all Loongson processors so far: CPUCFG on the calling processor
+	 * describes the extensions, the microarchitecture and the caches of every processor.
+	 */
+	struct cpuinfo_loongarch_cpucfg cpucfg_words;
+	cpuinfo_loongarch_read_cpucfg(&cpucfg_words);
+	cpuinfo_log_debug("CPUCFG PRID 0x%08"PRIx32", words 1-2 0x%08"PRIx32" 0x%08"PRIx32", caches 0x%08"PRIx32,
+		cpucfg_words.prid, cpucfg_words.arch, cpucfg_words.features, cpucfg_words.caches);
+
+	cpuinfo_loongarch_decode_isa(&cpucfg_words, &cpuinfo_isa);
+	disable_unsupported_extensions(&cpuinfo_isa);
+
+	enum cpuinfo_vendor vendor = cpuinfo_vendor_unknown;
+	enum cpuinfo_uarch uarch = cpuinfo_uarch_unknown;
+	cpuinfo_loongarch_decode_vendor_uarch(cpucfg_words.prid, &vendor, &uarch);
+
+	struct cpuinfo_cache cache_parameters[cpuinfo_cache_level_max];
+	const uint32_t private_cache_levels = cpuinfo_loongarch_decode_caches(&cpucfg_words, cache_parameters);
+	cpuinfo_record_init_phase(cpuinfo_init_phase_decode, &phase_start);
+
+	/* Detect package and core IDs */
+	cpuinfo_linux_parallel_for_processors(loongarch_linux_processors_count,
+		(cpuinfo_processor_function) detect_topology_ids, loongarch_linux_processors);
+
+	/* Processors without topology information in sysfs are assumed to be separate cores of package 0 */
+	for (uint32_t i = 0; i < loongarch_linux_processors_count; i++) {
+		if (!bitmask_all(loongarch_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			continue;
+		}
+		if (!bitmask_all(loongarch_linux_processors[i].flags, CPUINFO_LINUX_FLAG_PACKAGE_ID)) {
+			loongarch_linux_processors[i].package_id = 0;
+		}
+		if (!bitmask_all(loongarch_linux_processors[i].flags, CPUINFO_LINUX_FLAG_CORE_ID)) {
+			loongarch_linux_processors[i].core_id = i;
+		}
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_sysfs, &phase_start);
+
+	qsort(loongarch_linux_processors, loongarch_linux_processors_count,
+		sizeof(struct cpuinfo_loongarch_linux_processor), cmp_loongarch_linux_processor);
+
+	/* Sorted valid processors precede invalid ones */
+	uint32_t packages_count = 0, cores_count = 0;
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		const bool new_package = i == 0 ||
+			loongarch_linux_processors[i].package_id != loongarch_linux_processors[i - 1].package_id;
+		if (new_package) {
+			packages_count += 1;
+		}
+		if (new_package || loongarch_linux_processors[i].core_id != loongarch_linux_processors[i - 1].core_id) {
+			cores_count += 1;
+		}
+	}
+
+	/* Private caches are instantiated for every core, and shared caches for every package */
+	uint32_t cache_counts[cpuinfo_cache_level_max] = { 0 };
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		if (cache_parameters[level].size != 0) {
+			cache_counts[level] = (private_cache_levels & (UINT32_C(1) << level)) ? cores_count : packages_count;
+		}
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_caches, &phase_start);
+
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, cores_count, sizeof(struct cpuinfo_core));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, packages_count, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset = cpuinfo_arena_reserve(&arena, packages_count, sizeof(struct cpuinfo_package));
+	size_t cache_offsets[cpuinfo_cache_level_max];
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cache_offsets[level] = cpuinfo_arena_reserve(&arena, cache_counts[level], sizeof(struct cpuinfo_cache));
+	}
+	const size_t linux_cpu_to_processor_map_offset =
+		cpuinfo_arena_reserve(&arena, loongarch_linux_processors_count, sizeof(struct cpuinfo_processor*));
+	const size_t linux_cpu_to_core_map_offset =
+		cpuinfo_arena_reserve(&arena, loongarch_linux_processors_count, sizeof(struct cpuinfo_core*));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		goto cleanup;
+	}
+
+	processors = cpuinfo_arena_get(&arena, processors_offset, valid_processors);
+	cores = cpuinfo_arena_get(&arena, cores_offset, cores_count);
+	clusters = cpuinfo_arena_get(&arena, clusters_offset, packages_count);
+	packages = cpuinfo_arena_get(&arena, packages_offset, packages_count);
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		caches[level] = cpuinfo_arena_get(&arena, cache_offsets[level], cache_counts[level]);
+	}
+	linux_cpu_to_processor_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_processor_map_offset, loongarch_linux_processors_count);
+	linux_cpu_to_core_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_core_map_offset, loongarch_linux_processors_count);
+
+	/*
+	 * Assumptions:
+	 * - All cores in a package form a cluster.
+	 * - Processors with the same package and core IDs are SMT siblings of one core.
+	 */
+	uint32_t package_index = UINT32_MAX, core_index = UINT32_MAX;
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		const struct cpuinfo_loongarch_linux_processor* loongarch_processor = &loongarch_linux_processors[i];
+		const bool new_package = i == 0 || loongarch_processor->package_id != loongarch_processor[-1].package_id;
+		const bool new_core = new_package || loongarch_processor->core_id != loongarch_processor[-1].core_id;
+		if (new_package) {
+			package_index += 1;
+			packages[package_index] = (struct cpuinfo_package) {
+				.processor_start = i,
+				.core_start = core_index + 1,
+				.cluster_start = package_index,
+				.cluster_count = 1,
+			};
+			clusters[package_index] = (struct cpuinfo_cluster) {
+				.processor_start = i,
+				.core_start = core_index + 1,
+				.cluster_id = 0,
+				.package = packages + package_index,
+				.vendor = vendor,
+				.uarch = uarch,
+				.capacity = CPUINFO_CAPACITY_SCALE,
+			};
+		}
+		if (new_core) {
+			core_index += 1;
+			cores[core_index] = (struct cpuinfo_core) {
+				.processor_start = i,
+				.core_id = core_index - packages[package_index].core_start,
+				.cluster = clusters + package_index,
+				.package = packages + package_index,
+				.vendor = vendor,
+				.uarch = uarch,
+				.capacity = CPUINFO_CAPACITY_SCALE,
+			};
+			clusters[package_index].core_count += 1;
+			packages[package_index].core_count += 1;
+		}
+		clusters[package_index].processor_count += 1;
+		packages[package_index].processor_count += 1;
+
+		const struct cpuinfo_cache* processor_caches[cpuinfo_cache_level_max] = { NULL };
+		for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+			if (cache_counts[level] == 0) {
+				continue;
+			}
+			const bool private_cache = (private_cache_levels & (UINT32_C(1) << level)) != 0;
+			const uint32_t cache_index = private_cache ? core_index : package_index;
+			struct cpuinfo_cache* cache = &caches[level][cache_index];
+			if (cache->size == 0) {
+				*cache = cache_parameters[level];
+				cache->processor_start = i;
+			}
+			cache->processor_count += 1;
+			processor_caches[level] = cache;
+		}
+
+		processors[i] = (struct cpuinfo_processor) {
+			.smt_id = i - cores[core_index].processor_start,
+			.core = cores + core_index,
+			.cluster = clusters + package_index,
+			.package = packages + package_index,
+			.linux_id = (int) loongarch_processor->system_processor_id,
+			.cache = {
+				.l1i = processor_caches[cpuinfo_cache_level_1i],
+				.l1d = processor_caches[cpuinfo_cache_level_1d],
+				.l2 = processor_caches[cpuinfo_cache_level_2],
+				.l3 = processor_caches[cpuinfo_cache_level_3],
+				.l4 = processor_caches[cpuinfo_cache_level_4],
+			},
+		};
+		cores[core_index].processor_count += 1;
+		linux_cpu_to_processor_map[loongarch_processor->system_processor_id] = &processors[i];
+		linux_cpu_to_core_map[loongarch_processor->system_processor_id] = &cores[core_index];
+	}
+
+	enum cpuinfo_linux_current_cpu_method current_cpu_method = cpuinfo_linux_current_cpu_method_syscall;
+	if (cpuinfo_linux_rseq_is_registered()) {
+		current_cpu_method = cpuinfo_linux_current_cpu_method_rseq;
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_tables, &phase_start);
+
+	/* Commit */
+	cpuinfo_processors = processors;
+	cpuinfo_cores = cores;
+	cpuinfo_clusters = clusters;
+	cpuinfo_packages = packages;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache[level] = caches[level];
+	}
+
+	cpuinfo_processors_count = valid_processors;
+	cpuinfo_cores_count = cores_count;
+	cpuinfo_clusters_count = packages_count;
+	cpuinfo_packages_count = packages_count;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache_count[level] = cache_counts[level];
+	}
+	cpuinfo_max_cache_size = cpuinfo_compute_max_cache_size(&processors[0]);
+
+	cpuinfo_global_uarch = (struct cpuinfo_uarch_info) {
+		.uarch = uarch,
+		.processor_count = valid_processors,
+		.core_count = cores_count,
+	};
+
+	cpuinfo_linux_cpu_max = loongarch_linux_processors_count;
+	cpuinfo_linux_current_cpu_method = current_cpu_method;
+	cpuinfo_linux_cpu_to_processor_map = linux_cpu_to_processor_map;
+	cpuinfo_linux_cpu_to_core_map = linux_cpu_to_core_map;
+
+	cpuinfo_arena_memory = arena.memory;
+
+	__sync_synchronize();
+
+	cpuinfo_is_initialized = true;
+
+	arena.memory = NULL;
+
+cleanup:
+	cpuinfo_linux_release_sysfs();
+	cpuinfo_free_temporary(loongarch_linux_processors);
+	cpuinfo_arena_free(arena.memory);
+}
@@ -0,0 +1,46 @@
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <loongarch/api.h>
+#include <cpuinfo/log.h>
+
+
+/* Fields of the processor ID: company in bits 16-23, series of the core in bits 12-15, and revision in bits 0-7 */
+#define PRID_COMPANY_MASK     UINT32_C(0x00FF0000)
+#define PRID_COMPANY_LOONGSON UINT32_C(0x00140000)
+#define PRID_SERIES_MASK      UINT32_C(0x0000F000)
+#define PRID_SERIES_LA264     UINT32_C(0x0000A000)
+#define PRID_SERIES_LA364     UINT32_C(0x0000B000)
+#define PRID_SERIES_LA464     UINT32_C(0x0000C000)
+#define PRID_SERIES_LA664     UINT32_C(0x0000D000)
+
+void cpuinfo_loongarch_decode_vendor_uarch(
+	uint32_t prid,
+	enum cpuinfo_vendor vendor[restrict static 1],
+	enum cpuinfo_uarch uarch[restrict static 1])
+{
+	*vendor = cpuinfo_vendor_unknown;
+	*uarch = cpuinfo_uarch_unknown;
+	if ((prid & PRID_COMPANY_MASK) != PRID_COMPANY_LOONGSON) {
+		cpuinfo_log_warning("unknown LoongArch processor vendor in PRID 0x%08"PRIx32, prid);
+		return;
+	}
+
+	*vendor = cpuinfo_vendor_loongson;
+	switch (prid & PRID_SERIES_MASK) {
+		case PRID_SERIES_LA264:
+			*uarch = cpuinfo_uarch_loongson_la264;
+			break;
+		case PRID_SERIES_LA364:
+			*uarch = cpuinfo_uarch_loongson_la364;
+			break;
+		case PRID_SERIES_LA464:
+			*uarch = cpuinfo_uarch_loongson_la464;
+			break;
+		case PRID_SERIES_LA664:
+			*uarch = cpuinfo_uarch_loongson_la664;
+			break;
+		default:
+			cpuinfo_log_info("unknown Loongson core series in PRID 0x%08"PRIx32, prid);
+	}
+}
@@ -0,0 +1,78 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+	#include <sched.h>
+	#include <sys/prctl.h>
+
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+	/* Constants from <linux/prctl.h> of Linux 5.10, which older kernel headers lack */
+	#ifndef PR_GET_TAGGED_ADDR_CTRL
+		#define PR_GET_TAGGED_ADDR_CTRL 56
+	#endif
+	#ifndef PR_TAGGED_ADDR_ENABLE
+		#define PR_TAGGED_ADDR_ENABLE (1UL << 0)
+	#endif
+	#ifndef PR_MTE_TCF_SYNC
+		#define PR_MTE_TCF_SYNC (1UL << 1)
+	#endif
+	#ifndef PR_MTE_TCF_ASYNC
+		#define PR_MTE_TCF_ASYNC (1UL << 2)
+	#endif
+	#define MTE_TCF_PREFERRED_FILENAME "mte_tcf_preferred"
+	#define MTE_TCF_PREFERRED_FILESIZE 16
+
+	static bool parse_preferred_mode(const char* text_start, const char* text_end, void* context) {
+		enum cpuinfo_arm_mte_mode* mode = (enum cpuinfo_arm_mte_mode*) context;
+		const size_t length = (size_t) (text_end - text_start);
+		if (length >= 4 && memcmp(text_start, "sync", 4) == 0) {
+			*mode = cpuinfo_arm_mte_mode_sync;
+		} else if (length >= 5 && memcmp(text_start, "async", 5) == 0) {
+			*mode = cpuinfo_arm_mte_mode_async;
+		} else if (length >= 5 && memcmp(text_start, "asymm", 5) == 0) {
+			*mode = cpuinfo_arm_mte_mode_asymmetric;
+		}
+		return true;
+	}
+#endif
+
+enum cpuinfo_arm_mte_mode CPUINFO_ABI cpuinfo_get_arm_mte_mode(void) {
+	#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+		if (!cpuinfo_has_arm_mte2()) {
+			return cpuinfo_arm_mte_mode_unavailable;
+		}
+		const int control = prctl(PR_GET_TAGGED_ADDR_CTRL, 0, 0, 0, 0);
+		if (control < 0 || (control & PR_TAGGED_ADDR_ENABLE) == 0) {
+			return cpuinfo_arm_mte_mode_unavailable;
+		}
+		const bool sync = (control & PR_MTE_TCF_SYNC) != 0;
+		const bool async = (control & PR_MTE_TCF_ASYNC) != 0;
+		if (!sync && !async) {
+			return cpuinfo_arm_mte_mode_none;
+		} else if (!async) {
+			return cpuinfo_arm_mte_mode_sync;
+		} else if (!sync) {
+			return cpuinfo_arm_mte_mode_async;
+		}
+
+		/* The kernel applies the preferred mode of the processor, which defaults to asynchronous tag checks */
+		enum cpuinfo_arm_mte_mode mode = cpuinfo_arm_mte_mode_async;
+		const int cpu = sched_getcpu();
+		if (cpu >= 0) {
+			cpuinfo_linux_parse_processor_small_file((uint32_t) cpu, MTE_TCF_PREFERRED_FILENAME,
+				MTE_TCF_PREFERRED_FILESIZE, parse_preferred_mode, &mode);
+		}
+		return mode;
+	#else
+		return cpuinfo_arm_mte_mode_unavailable;
+	#endif
+}
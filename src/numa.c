@@ -0,0 +1,489 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	#include <windows.h>
+
+	#include <windows/api.h>
+#elif defined(__linux__)
+	#include <stdio.h>
+
+	#include <linux/api.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Distances of the ACPI System Locality Information Table for local and remote nodes, used if the OS reports none */
+#define NUMA_LOCAL_DISTANCE 10
+#define NUMA_REMOTE_DISTANCE 20
+/* Maximum number of memory-side cache levels of a NUMA node */
+#define NUMA_MAX_MEMORY_SIDE_CACHES 4
+
+#if defined(__linux__)
+	#define NUMA_ONLINE_FILENAME "/sys/devices/system/node/online"
+	#define NUMA_NODE_FILENAME_SIZE (sizeof("/sys/devices/system/node/node4294967295/distance"))
+	#define NUMA_NODE_CPULIST_FILENAME_FORMAT "/sys/devices/system/node/node%" PRIu32 "/cpulist"
+	#define NUMA_NODE_DISTANCE_FILENAME_FORMAT "/sys/devices/system/node/node%" PRIu32 "/distance"
+	#define NUMA_NODE_MEMINFO_FILENAME_FORMAT "/sys/devices/system/node/node%" PRIu32 "/meminfo"
+	#define NUMA_MEMORY_SIDE_CACHE_FILENAME_SIZE \
+		(sizeof("/sys/devices/system/node/node4294967295/memory_side_cache/index4294967295/write_policy"))
+	#define NUMA_MEMORY_SIDE_CACHE_FILENAME_FORMAT \
+		"/sys/devices/system/node/node%" PRIu32 "/memory_side_cache/index%" PRIu32 "/%s"
+	#define MEMORY_TIERING_DIRNAME "/sys/devices/virtual/memory_tiering"
+	#define MEMORY_TIER_NODELIST_FILENAME_SIZE (sizeof(MEMORY_TIERING_DIRNAME "/memory_tier4294967295/nodelist"))
+	#define MEMORY_TIER_NODELIST_FILENAME_FORMAT MEMORY_TIERING_DIRNAME "/memory_tier%" PRIu32 "/nodelist"
+	/* Every distance takes at most 3 digits and a separator */
+	#define NUMA_DISTANCE_CHARS 4
+	#define NUMA_MEMINFO_LINE_SIZE 256
+	#define NUMA_NUMBER_FILESIZE 32
+#endif
+
+struct numa_builder {
+	struct cpuinfo_tables* tables;
+	struct cpuinfo_numa_node* nodes;
+	uint32_t* distances;
+	struct cpuinfo_memory_side_cache* memory_side_caches;
+	uint32_t nodes_count;
+	uint32_t memory_side_caches_count;
+};
+
+static inline void init_default_distances(uint32_t* distances, uint32_t nodes_count, uint32_t node_index) {
+	for (uint32_t i = 0; i < nodes_count; i++) {
+		distances[i] = i == node_index ? NUMA_LOCAL_DISTANCE : NUMA_REMOTE_DISTANCE;
+	}
+}
+
+static inline void assign_processor(struct numa_builder builder[restrict static 1], uint32_t processor_index,
+	uint32_t node_index)
+{
+	struct cpuinfo_processor* processor = &builder->tables->processors[processor_index];
+	if (processor->numa_node == NULL) {
+		processor->numa_node = &builder->nodes[node_index];
+	}
+}
+
+#if defined(__linux__)
+	static bool count_online_nodes(uint32_t node_start, uint32_t node_end, void* context) {
+		uint32_t* nodes_count = (uint32_t*) context;
+		*nodes_count += node_end - node_start;
+		return true;
+	}
+
+	static bool list_online_nodes(uint32_t node_start, uint32_t node_end, void* context) {
+		struct numa_builder* builder = (struct numa_builder*) context;
+		for (uint32_t node_id = node_start; node_id < node_end; node_id++) {
+			/* The list can only change between the passes if nodes go online concurrently */
+			uint32_t index = 0;
+			while (index < builder->nodes_count && builder->nodes[index].node_id != UINT32_MAX) {
+				index++;
+			}
+			if (index == builder->nodes_count) {
+				return false;
+			}
+			builder->nodes[index].node_id = node_id;
+		}
+		return true;
+	}
+
+	struct node_cpulist_context {
+		struct numa_builder* builder;
+		uint32_t node_index;
+	};
+
+	static bool assign_node_processors(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+		const struct node_cpulist_context* cpulist_context = (const struct node_cpulist_context*) context;
+		struct numa_builder* builder = cpulist_context->builder;
+		const struct cpuinfo_tables* tables = builder->tables;
+		if (cpu_end > tables->linux_cpu_max) {
+			cpu_end = tables->linux_cpu_max;
+		}
+		for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+			const struct cpuinfo_processor* processor = tables->linux_cpu_to_processor_map[cpu];
+			if (processor != NULL) {
+				assign_processor(builder, (uint32_t) (processor - tables->processors), cpulist_context->node_index);
+			}
+		}
+		return true;
+	}
+
+	struct node_distance_context {
+		uint32_t* distances;
+		uint32_t nodes_count;
+	};
+
+	static bool parse_node_distances(const char* text_start, const char* text_end, void* context) {
+		const struct node_distance_context* distance_context = (const struct node_distance_context*) context;
+		uint32_t distances_count = 0;
+		const char* text = text_start;
+		while (text != text_end) {
+			if (*text == ' ' || *text == '\n') {
+				text++;
+				continue;
+			}
+			uint32_t distance = 0;
+			const char* digits_start = text;
+			for (; text != text_end && *text >= '0' && *text <= '9'; text++) {
+				distance = distance * 10 + (uint32_t) (*text - '0');
+			}
+			if (text == digits_start || distances_count == distance_context->nodes_count) {
+				cpuinfo_log_warning("failed to parse NUMA distances \"%.*s\"",
+					(int) (text_end - text_start), text_start);
+				return false;
+			}
+			distance_context->distances[distances_count++] = distance;
+		}
+		return distances_count == distance_context->nodes_count;
+	}
+
+	static bool parse_node_meminfo(const char* key_start, const char* key_end, const char* value_start,
+		const char* value_end, void* context, uint64_t line_number)
+	{
+		/* Lines look like "Node 0 MemTotal:       16310896 kB" */
+		static const char mem_total_key[] = "MemTotal";
+		const size_t key_length = (size_t) (key_end - key_start);
+		if (key_length < sizeof(mem_total_key) - 1 ||
+			memcmp(key_end - (sizeof(mem_total_key) - 1), mem_total_key, sizeof(mem_total_key) - 1) != 0)
+		{
+			return true;
+		}
+
+		uint64_t memory_kb = 0;
+		for (const char* digit = value_start; digit != value_end && *digit >= '0' && *digit <= '9'; digit++) {
+			memory_kb = memory_kb * 10 + (uint64_t) (*digit - '0');
+		}
+		*((uint64_t*) context) = memory_kb * UINT64_C(1024);
+		/* Stop parsing: other lines are not needed */
+		return false;
+	}
+
+	static bool parse_number(const char* text_start, const char* text_end, void* context) {
+		uint64_t value = 0;
+		const char* digit = text_start;
+		for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+			value = value * 10 + (uint64_t) (*digit - '0');
+		}
+		if (digit == text_start) {
+			return false;
+		}
+		*((uint64_t*) context) = value;
+		return true;
+	}
+
+	/* Read memory-side caches of the node from memory_side_cache/indexK directories, which Linux creates from HMAT */
+	static void detect_memory_side_caches(struct numa_builder builder[restrict static 1], uint32_t node_index) {
+		static const char* const filenames[] = { "size", "line_size", "indexing", "write_policy" };
+		struct cpuinfo_numa_node* node = &builder->nodes[node_index];
+		node->memory_side_cache_start = builder->memory_side_caches_count;
+		for (uint32_t level = 1; level <= NUMA_MAX_MEMORY_SIDE_CACHES; level++) {
+			uint64_t values[sizeof(filenames) / sizeof(filenames[0])] = { 0 };
+			for (uint32_t i = 0; i < sizeof(filenames) / sizeof(filenames[0]); i++) {
+				char filename[NUMA_MEMORY_SIDE_CACHE_FILENAME_SIZE];
+				snprintf(filename, NUMA_MEMORY_SIDE_CACHE_FILENAME_SIZE, NUMA_MEMORY_SIDE_CACHE_FILENAME_FORMAT,
+					node->node_id, level, filenames[i]);
+				if (!cpuinfo_linux_parse_small_file(filename, NUMA_NUMBER_FILESIZE, parse_number, &values[i])) {
+					/* Only the size is required: older kernels may not report other attributes */
+					if (i == 0) {
+						return;
+					}
+				}
+			}
+			cpuinfo_log_debug("NUMA node %"PRIu32" has level %"PRIu32" memory-side cache of %"PRIu64" bytes",
+				node->node_id, level, values[0]);
+			builder->memory_side_caches[builder->memory_side_caches_count++] = (struct cpuinfo_memory_side_cache) {
+				.size = values[0],
+				.level = level,
+				.line_size = (uint32_t) values[1],
+				/* Linux reports indexing 0 for direct-mapped caches, and write_policy 0 for write-back caches */
+				.flags = (values[2] != 0 ? CPUINFO_CACHE_COMPLEX_INDEXING : 0) |
+					(values[3] != 0 ? CPUINFO_CACHE_WRITE_THROUGH : 0),
+			};
+			node->memory_side_cache_count += 1;
+		}
+	}
+
+	struct memory_tier_context {
+		struct numa_builder* builder;
+		uint32_t tier;
+	};
+
+	static bool assign_memory_tier(uint32_t node_start, uint32_t node_end, void* context) {
+		const struct memory_tier_context* tier_context = (const struct memory_tier_context*) context;
+		struct numa_builder* builder = tier_context->builder;
+		for (uint32_t i = 0; i < builder->nodes_count; i++) {
+			if (builder->nodes[i].node_id >= node_start && builder->nodes[i].node_id < node_end) {
+				builder->nodes[i].memory_tier = tier_context->tier;
+			}
+		}
+		return true;
+	}
+
+	static bool parse_memory_tier(const char* name, void* context) {
+		struct memory_tier_context tier_context = { .builder = (struct numa_builder*) context };
+		char suffix = 0;
+		if (sscanf(name, "memory_tier%" SCNu32 "%c", &tier_context.tier, &suffix) != 1) {
+			return true;
+		}
+		char filename[MEMORY_TIER_NODELIST_FILENAME_SIZE];
+		snprintf(filename, MEMORY_TIER_NODELIST_FILENAME_SIZE, MEMORY_TIER_NODELIST_FILENAME_FORMAT,
+			tier_context.tier);
+		if (!cpuinfo_linux_parse_cpulist(filename, assign_memory_tier, &tier_context)) {
+			cpuinfo_log_info("failed to parse the list of NUMA nodes in memory tier %"PRIu32, tier_context.tier);
+		}
+		return true;
+	}
+
+	/* Assign nodes to memory tiers from the nodelist files of memory_tierN directories, on Linux 6.1 and newer */
+	static void detect_memory_tiers(struct numa_builder builder[restrict static 1]) {
+		if (!cpuinfo_linux_scan_directory(MEMORY_TIERING_DIRNAME, parse_memory_tier, builder)) {
+			cpuinfo_log_debug("failed to open %s: memory tiers are not supported", MEMORY_TIERING_DIRNAME);
+		}
+	}
+
+	static uint32_t detect_nodes_count(void) {
+		uint32_t nodes_count = 0;
+		if (!cpuinfo_linux_parse_cpulist(NUMA_ONLINE_FILENAME, count_online_nodes, &nodes_count)) {
+			cpuinfo_log_info("failed to parse the list of online NUMA nodes in %s", NUMA_ONLINE_FILENAME);
+			return 0;
+		}
+		return nodes_count;
+	}
+
+	static bool detect_nodes(struct numa_builder builder[restrict static 1]) {
+		for (uint32_t i = 0; i < builder->nodes_count; i++) {
+			builder->nodes[i].node_id = UINT32_MAX;
+		}
+		if (!cpuinfo_linux_parse_cpulist(NUMA_ONLINE_FILENAME, list_online_nodes, builder) ||
+			builder->nodes[builder->nodes_count - 1].node_id == UINT32_MAX)
+		{
+			cpuinfo_log_warning("list of online NUMA nodes in %s changed during initialization", NUMA_ONLINE_FILENAME);
+			return false;
+		}
+
+		for (uint32_t i = 0; i < builder->nodes_count; i++) {
+			struct cpuinfo_numa_node* node = &builder->nodes[i];
+			char filename[NUMA_NODE_FILENAME_SIZE];
+
+			snprintf(filename, NUMA_NODE_FILENAME_SIZE, NUMA_NODE_CPULIST_FILENAME_FORMAT, node->node_id);
+			struct node_cpulist_context cpulist_context = { .builder = builder, .node_index = i };
+			if (!cpuinfo_linux_parse_cpulist(filename, assign_node_processors, &cpulist_context)) {
+				cpuinfo_log_info("failed to parse the list of processors on NUMA node %"PRIu32, node->node_id);
+			}
+
+			snprintf(filename, NUMA_NODE_FILENAME_SIZE, NUMA_NODE_DISTANCE_FILENAME_FORMAT, node->node_id);
+			struct node_distance_context distance_context = {
+				.distances = &builder->distances[i * builder->nodes_count],
+				.nodes_count = builder->nodes_count,
+			};
+			if (!cpuinfo_linux_parse_small_file(filename, builder->nodes_count * NUMA_DISTANCE_CHARS + 1,
+					parse_node_distances, &distance_context))
+			{
+				cpuinfo_log_info("failed to parse distances of NUMA node %"PRIu32": using default distances",
+					node->node_id);
+				init_default_distances(distance_context.distances, builder->nodes_count, i);
+			}
+
+			snprintf(filename, NUMA_NODE_FILENAME_SIZE, NUMA_NODE_MEMINFO_FILENAME_FORMAT, node->node_id);
+			cpuinfo_linux_parse_key_value_file(filename, NUMA_MEMINFO_LINE_SIZE, NULL,
+				parse_node_meminfo, &node->memory_size);
+
+			detect_memory_side_caches(builder, i);
+		}
+		detect_memory_tiers(builder);
+		return true;
+	}
+#elif defined(_WIN32) || defined(__CYGWIN__)
+	static uint32_t detect_nodes_count(void) {
+		ULONG highest_node_number = 0;
+		if (!GetNumaHighestNodeNumber(&highest_node_number)) {
+			cpuinfo_log_info("failed to query the highest NUMA node number: error %"PRIu32,
+				(uint32_t) GetLastError());
+			return 0;
+		}
+		return (uint32_t) highest_node_number + 1;
+	}
+
+	static void assign_group_processors(struct numa_builder builder[restrict static 1],
+		const GROUP_AFFINITY group_affinity[restrict static 1], uint32_t node_index)
+	{
+		const struct cpuinfo_tables* tables = builder->tables;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			if (processor->windows_group_id == group_affinity->Group &&
+				(group_affinity->Mask & ((KAFFINITY) 1 << processor->windows_processor_id)) != 0)
+			{
+				assign_processor(builder, i, node_index);
+			}
+		}
+	}
+
+	/*
+	 * Assign logical processors of all groups of every NUMA node with a single query. RelationNumaNodeEx reports all
+	 * groups of a node, and RelationNumaNode on older Windows versions reports only the primary one.
+	 */
+	static bool assign_processors(struct numa_builder builder[restrict static 1]) {
+		struct cpuinfo_windows_topology topology;
+		if (!cpuinfo_windows_query_topology(CPUINFO_WINDOWS_RELATION_NUMA_NODE_EX, &topology) &&
+			!cpuinfo_windows_query_topology(RelationNumaNode, &topology))
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < topology.numa_nodes_count; i++) {
+			const struct cpuinfo_windows_numa_node_relationship* numa_node =
+				(const struct cpuinfo_windows_numa_node_relationship*) &topology.numa_nodes[i]->NumaNode;
+			if (numa_node->node_number >= builder->nodes_count) {
+				continue;
+			}
+			const uint32_t groups_count = numa_node->group_count != 0 ? numa_node->group_count : 1;
+			for (uint32_t j = 0; j < groups_count; j++) {
+				assign_group_processors(builder, &numa_node->group_masks[j], (uint32_t) numa_node->node_number);
+			}
+		}
+		cpuinfo_windows_release_topology(&topology);
+		return true;
+	}
+
+	static bool detect_nodes(struct numa_builder builder[restrict static 1]) {
+		const bool assigned = assign_processors(builder);
+		for (uint32_t i = 0; i < builder->nodes_count; i++) {
+			struct cpuinfo_numa_node* node = &builder->nodes[i];
+			node->node_id = i;
+
+			/* Windows doesn't expose the SLIT table */
+			init_default_distances(&builder->distances[i * builder->nodes_count], builder->nodes_count, i);
+
+			if (!assigned) {
+				/* Without logical processor information, only the primary group of every node is known */
+				GROUP_AFFINITY group_affinity;
+				if (GetNumaNodeProcessorMaskEx((USHORT) i, &group_affinity)) {
+					assign_group_processors(builder, &group_affinity, i);
+				} else {
+					cpuinfo_log_info("failed to query processors on NUMA node %"PRIu32": error %"PRIu32,
+						i, (uint32_t) GetLastError());
+				}
+			}
+
+			ULONGLONG available_memory = 0;
+			if (GetNumaAvailableMemoryNodeEx((USHORT) i, &available_memory)) {
+				node->memory_size = (uint64_t) available_memory;
+			}
+		}
+		return true;
+	}
+#else
+	static uint32_t detect_nodes_count(void) {
+		return 0;
+	}
+
+	static bool detect_nodes(struct numa_builder builder[restrict static 1]) {
+		return false;
+	}
+#endif
+
+/*
+ * Assign logical processors which the OS didn't report on any NUMA node to the node of another logical processor in
+ * the same package, or to the first node.
+ */
+static void assign_remaining_processors(struct numa_builder builder[restrict static 1]) {
+	struct cpuinfo_processor* processors = builder->tables->processors;
+	for (uint32_t i = 0; i < builder->tables->processors_count; i++) {
+		if (processors[i].numa_node != NULL) {
+			continue;
+		}
+		const struct cpuinfo_package* package = processors[i].package;
+		const uint32_t package_end = package->processor_start + package->processor_count;
+		for (uint32_t j = package->processor_start; j < package_end; j++) {
+			if (processors[j].numa_node != NULL) {
+				processors[i].numa_node = processors[j].numa_node;
+				break;
+			}
+		}
+		if (processors[i].numa_node == NULL) {
+			cpuinfo_log_debug("logical processor %"PRIu32" is not reported on any NUMA node", i);
+			processors[i].numa_node = &builder->nodes[0];
+		}
+	}
+}
+
+bool cpuinfo_build_numa_nodes(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		tables->processors[i].numa_node = NULL;
+	}
+
+	/* If the OS doesn't report NUMA nodes, all logical processors and memory belong to a single node */
+	uint32_t nodes_count = cpuinfo_replaying_capture ? 0 : detect_nodes_count();
+	const bool detected = nodes_count != 0;
+	if (!detected) {
+		nodes_count = 1;
+	}
+
+	struct cpuinfo_arena arena = { 0 };
+	const size_t nodes_offset = cpuinfo_arena_reserve(&arena, nodes_count, sizeof(struct cpuinfo_numa_node));
+	const size_t distances_offset = cpuinfo_arena_reserve(&arena, (size_t) nodes_count * nodes_count, sizeof(uint32_t));
+	const size_t memory_side_caches_offset = cpuinfo_arena_reserve(&arena,
+		(size_t) nodes_count * NUMA_MAX_MEMORY_SIDE_CACHES, sizeof(struct cpuinfo_memory_side_cache));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return false;
+	}
+
+	struct numa_builder builder = {
+		.tables = tables,
+		.nodes = cpuinfo_arena_get(&arena, nodes_offset, nodes_count),
+		.distances = cpuinfo_arena_get(&arena, distances_offset, (size_t) nodes_count * nodes_count),
+		.memory_side_caches = cpuinfo_arena_get(&arena, memory_side_caches_offset,
+			(size_t) nodes_count * NUMA_MAX_MEMORY_SIDE_CACHES),
+		.nodes_count = nodes_count,
+	};
+	for (uint32_t i = 0; i < nodes_count; i++) {
+		builder.nodes[i].memory_tier = UINT32_MAX;
+	}
+	if (!detected || !detect_nodes(&builder)) {
+		nodes_count = builder.nodes_count = 1;
+		builder.nodes[0] = (struct cpuinfo_numa_node) { .memory_tier = UINT32_MAX };
+		builder.distances[0] = NUMA_LOCAL_DISTANCE;
+		builder.memory_side_caches_count = 0;
+		for (uint32_t i = 0; i < processors_count; i++) {
+			tables->processors[i].numa_node = NULL;
+		}
+	}
+	if (processors_count != 0) {
+		assign_remaining_processors(&builder);
+	}
+
+	for (uint32_t i = 0; i < nodes_count; i++) {
+		builder.nodes[i].processor_start = UINT32_MAX;
+		builder.nodes[i].distances = &builder.distances[i * nodes_count];
+	}
+	for (uint32_t i = 0; i < processors_count; i++) {
+		struct cpuinfo_numa_node* node = &builder.nodes[tables->processors[i].numa_node - builder.nodes];
+		if (node->processor_start == UINT32_MAX) {
+			node->processor_start = i;
+		}
+		node->processor_count = i + 1 - node->processor_start;
+	}
+	for (uint32_t i = 0; i < nodes_count; i++) {
+		/* Memory-only nodes */
+		if (builder.nodes[i].processor_start == UINT32_MAX) {
+			builder.nodes[i].processor_start = 0;
+		}
+		const uint32_t memory_side_cache_end =
+			builder.nodes[i].memory_side_cache_start + builder.nodes[i].memory_side_cache_count;
+		for (uint32_t j = builder.nodes[i].memory_side_cache_start; j < memory_side_cache_end; j++) {
+			builder.memory_side_caches[j].numa_node = &builder.nodes[i];
+		}
+	}
+
+	tables->numa_nodes = builder.nodes;
+	tables->numa_nodes_count = nodes_count;
+	tables->numa_distances = builder.distances;
+	tables->memory_side_caches = builder.memory_side_caches;
+	tables->memory_side_caches_count = builder.memory_side_caches_count;
+	tables->numa_memory = arena.memory;
+	return true;
+}
@@ -0,0 +1,425 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if defined(__linux__)
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Shards occupy separate cache lines, so that updates on different processors don't contend */
+#define SHARD_SIZE 64
+
+/* Restartable sequences write memory operands of asm goto statements, which support output operands since GCC 11 */
+#if CPUINFO_ARCH_X86_64 && defined(__linux__) && !CPUINFO_MOCK && \
+	((defined(__clang__) && __clang_major__ >= 11) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 11))
+	#define CPUINFO_PERCPU_RSEQ 1
+
+	/* Prefix of struct rseq from <linux/rseq.h>: the kernel updates cpu_id, and restarts the critical section in rseq_cs */
+	struct rseq_area {
+		uint32_t cpu_id_start;
+		uint32_t cpu_id;
+		uint64_t rseq_cs;
+	};
+#else
+	#define CPUINFO_PERCPU_RSEQ 0
+#endif
+
+struct counter_shard {
+	int64_t value;
+	char padding[SHARD_SIZE - sizeof(int64_t)];
+};
+
+struct freelist_shard {
+	struct cpuinfo_percpu_freelist_node* head;
+	/* Spin lock of shards updated outside of restartable sequences */
+	volatile uint32_t lock;
+	char padding[SHARD_SIZE - sizeof(struct cpuinfo_percpu_freelist_node*) - sizeof(uint32_t)];
+};
+
+/*
+ * Shards of a per-processor data structure: one per usable processor, updated in restartable sequences, followed by
+ * one per last-level cache domain, updated atomically.
+ */
+struct percpu_shards {
+	void* memory;
+	char* shards;
+	/* Shard of every Linux processor number, or UINT32_MAX if the processor was not usable */
+	uint32_t* processor_shards;
+	uint32_t processors_count;
+	uint32_t restartable_shards_count;
+	uint32_t llc_shards_count;
+};
+
+struct cpuinfo_percpu_counter {
+	struct percpu_shards shards;
+};
+
+struct cpuinfo_percpu_freelist {
+	struct percpu_shards shards;
+};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	static inline void atomic_add(int64_t* value, int64_t delta) {
+		InterlockedExchangeAdd64((volatile LONG64*) value, (LONG64) delta);
+	}
+
+	static inline int64_t atomic_load(const int64_t* value) {
+		return (int64_t) InterlockedCompareExchange64((volatile LONG64*) value, 0, 0);
+	}
+
+	static inline void lock_shard(struct freelist_shard* shard) {
+		while (InterlockedExchange((volatile LONG*) &shard->lock, 1) != 0) {
+			YieldProcessor();
+		}
+	}
+
+	static inline void unlock_shard(struct freelist_shard* shard) {
+		InterlockedExchange((volatile LONG*) &shard->lock, 0);
+	}
+#else
+	static inline void atomic_add(int64_t* value, int64_t delta) {
+		__atomic_fetch_add(value, delta, __ATOMIC_RELAXED);
+	}
+
+	static inline int64_t atomic_load(const int64_t* value) {
+		return __atomic_load_n(value, __ATOMIC_RELAXED);
+	}
+
+	static inline void lock_shard(struct freelist_shard* shard) {
+		while (__atomic_exchange_n(&shard->lock, 1, __ATOMIC_ACQUIRE) != 0) {
+			while (__atomic_load_n(&shard->lock, __ATOMIC_RELAXED) != 0) {
+				#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+					__builtin_ia32_pause();
+				#endif
+			}
+		}
+	}
+
+	static inline void unlock_shard(struct freelist_shard* shard) {
+		__atomic_store_n(&shard->lock, 0, __ATOMIC_RELEASE);
+	}
+#endif
+
+static bool is_restartable(const struct cpuinfo_tables* tables) {
+	#if CPUINFO_PERCPU_RSEQ
+		/* Initialization chooses rseq only if the C library registered the rseq area, and it reports valid numbers */
+		return tables->linux_current_cpu_method == cpuinfo_linux_current_cpu_method_rseq &&
+			__rseq_size >= sizeof(struct rseq_area);
+	#else
+		(void) tables;
+		return false;
+	#endif
+}
+
+static bool create_shards(struct percpu_shards shards[restrict static 1]) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("percpu_shards");
+	const uint32_t llc_shards_count = tables->llc_slots_count != 0 ? tables->llc_slots_count : 1;
+	uint32_t processors_count = 0, restartable_shards_count = 0;
+	#if CPUINFO_PERCPU_RSEQ
+		if (is_restartable(tables)) {
+			processors_count = tables->linux_cpu_max;
+			restartable_shards_count = tables->usable_processors_count;
+		}
+	#endif
+
+	const size_t shards_size = (size_t) (restartable_shards_count + llc_shards_count) * SHARD_SIZE;
+	const size_t processor_shards_size = (size_t) processors_count * sizeof(uint32_t);
+	void* memory = calloc(1, shards_size + processor_shards_size + SHARD_SIZE - 1);
+	if (memory == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for %"PRIu32" per-processor shards",
+			shards_size + processor_shards_size + SHARD_SIZE - 1, restartable_shards_count + llc_shards_count);
+		return false;
+	}
+	char* shards_memory = (char*) (((uintptr_t) memory + SHARD_SIZE - 1) & ~(uintptr_t) (SHARD_SIZE - 1));
+	uint32_t* processor_shards = (uint32_t*) (shards_memory + shards_size);
+	for (uint32_t i = 0; i < processors_count; i++) {
+		processor_shards[i] = UINT32_MAX;
+	}
+	#if CPUINFO_PERCPU_RSEQ
+		for (uint32_t i = 0; i < restartable_shards_count; i++) {
+			const uint32_t linux_id = tables->processors[tables->usable_processor_indices[i]].linux_id;
+			if (linux_id < processors_count) {
+				processor_shards[linux_id] = i;
+			}
+		}
+	#endif
+
+	*shards = (struct percpu_shards) {
+		.memory = memory,
+		.shards = shards_memory,
+		.processor_shards = processor_shards,
+		.processors_count = processors_count,
+		.restartable_shards_count = restartable_shards_count,
+		.llc_shards_count = llc_shards_count,
+	};
+	cpuinfo_log_debug("created %"PRIu32" restartable and %"PRIu32" LLC shards",
+		restartable_shards_count, llc_shards_count);
+	return true;
+}
+
+static inline void* get_shard(const struct percpu_shards shards[restrict static 1], uint32_t index) {
+	return shards->shards + (size_t) index * SHARD_SIZE;
+}
+
+/* Shard of the last-level cache domain of the current processor, for updates outside of restartable sequences */
+static inline void* get_llc_shard(const struct percpu_shards shards[restrict static 1]) {
+	const uint32_t llc_slot = cpuinfo_get_current_llc_slot() % shards->llc_shards_count;
+	return get_shard(shards, shards->restartable_shards_count + llc_slot);
+}
+
+#if CPUINFO_PERCPU_RSEQ
+	static inline struct rseq_area* get_rseq_area(void) {
+		return (struct rseq_area*) (cpuinfo_linux_thread_pointer() + __rseq_offset);
+	}
+
+	/*
+	 * Restartable sequences follow the ABI of <linux/rseq.h>: the descriptor in section __rseq_cs gives the start and
+	 * the length of the critical section and the abort handler, which must follow the signature that glibc registered
+	 * (RSEQ_SIG, encoded in a UD1 instruction). The kernel moves a thread preempted, migrated or signaled within the
+	 * critical section to the abort handler, so the final store of the section commits it. A thread aborts itself if
+	 * its processor number differs from the one of the shard, i.e. it migrated before the section began.
+	 */
+	#define RSEQ_CRITICAL_SECTION_START \
+		".pushsection __rseq_cs, \"aw\"\n" \
+		".balign 32\n" \
+		"3:\n" \
+		".long 0x0, 0x0\n" \
+		".quad 1f, (2f - 1f), 4f\n" \
+		".popsection\n" \
+		"leaq 3b(%%rip), %%rax\n" \
+		"movq %%rax, %[rseq_cs]\n" \
+		"1:\n" \
+		"cmpl %[cpu], %[current_cpu]\n" \
+		"jnz %l[abort]\n"
+	#define RSEQ_CRITICAL_SECTION_END \
+		"2:\n" \
+		".pushsection __rseq_failure, \"ax\"\n" \
+		".byte 0x0f, 0xb9, 0x3d\n" \
+		".long 0x53053053\n" \
+		"4:\n" \
+		"jmp %l[abort]\n" \
+		".popsection\n"
+
+	static inline bool rseq_add(struct rseq_area* rseq, uint32_t cpu, int64_t* shard_value, int64_t value) {
+		__asm__ __volatile__ goto (
+			RSEQ_CRITICAL_SECTION_START
+			"addq %[value], %[shard_value]\n"
+			RSEQ_CRITICAL_SECTION_END
+			: [rseq_cs] "+m" (rseq->rseq_cs), [shard_value] "+m" (*shard_value)
+			: [cpu] "r" (cpu), [current_cpu] "m" (rseq->cpu_id), [value] "r" (value)
+			: "memory", "cc", "rax"
+			: abort);
+		return true;
+	abort:
+		return false;
+	}
+
+	static inline bool rseq_push(struct rseq_area* rseq, uint32_t cpu,
+		struct cpuinfo_percpu_freelist_node** head, struct cpuinfo_percpu_freelist_node* node)
+	{
+		__asm__ __volatile__ goto (
+			RSEQ_CRITICAL_SECTION_START
+			"movq %[head], %%rax\n"
+			"movq %%rax, (%[node])\n"
+			"movq %[node], %[head]\n"
+			RSEQ_CRITICAL_SECTION_END
+			: [rseq_cs] "+m" (rseq->rseq_cs), [head] "+m" (*head)
+			: [cpu] "r" (cpu), [current_cpu] "m" (rseq->cpu_id), [node] "r" (node)
+			: "memory", "cc", "rax"
+			: abort);
+		return true;
+	abort:
+		return false;
+	}
+
+	static inline bool rseq_pop(struct rseq_area* rseq, uint32_t cpu,
+		struct cpuinfo_percpu_freelist_node** head, struct cpuinfo_percpu_freelist_node** node)
+	{
+		__asm__ __volatile__ goto (
+			RSEQ_CRITICAL_SECTION_START
+			"movq %[head], %%rax\n"
+			"testq %%rax, %%rax\n"
+			"jz 2f\n"
+			"movq (%%rax), %%rdx\n"
+			"movq %%rdx, %[head]\n"
+			RSEQ_CRITICAL_SECTION_END
+			"movq %%rax, %[node]\n"
+			: [rseq_cs] "+m" (rseq->rseq_cs), [head] "+m" (*head), [node] "+m" (*node)
+			: [cpu] "r" (cpu), [current_cpu] "m" (rseq->cpu_id)
+			: "memory", "cc", "rax", "rdx"
+			: abort);
+		return true;
+	abort:
+		return false;
+	}
+
+	/*
+	 * Find the restartable shard of the processor that executes the current thread, or return UINT32_MAX if the
+	 * thread has no rseq area or the processor was not usable.
+	 */
+	static inline uint32_t get_restartable_shard(const struct percpu_shards shards[restrict static 1],
+		const struct rseq_area* rseq, uint32_t cpu_ptr[restrict static 1])
+	{
+		const int32_t cpu = *((const volatile int32_t*) &rseq->cpu_id);
+		if CPUINFO_UNLIKELY(cpu < 0 || (uint32_t) cpu >= shards->processors_count) {
+			return UINT32_MAX;
+		}
+		*cpu_ptr = (uint32_t) cpu;
+		return shards->processor_shards[cpu];
+	}
+#endif
+
+struct cpuinfo_percpu_counter* CPUINFO_ABI cpuinfo_create_percpu_counter(void) {
+	struct cpuinfo_percpu_counter* counter = calloc(1, sizeof(struct cpuinfo_percpu_counter));
+	if (counter == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for per-processor counter", sizeof(struct cpuinfo_percpu_counter));
+		return NULL;
+	}
+	if (!create_shards(&counter->shards)) {
+		free(counter);
+		return NULL;
+	}
+	return counter;
+}
+
+void CPUINFO_ABI cpuinfo_destroy_percpu_counter(struct cpuinfo_percpu_counter* counter) {
+	if (counter == NULL) {
+		return;
+	}
+	free(counter->shards.memory);
+	free(counter);
+}
+
+void CPUINFO_ABI cpuinfo_percpu_counter_add(struct cpuinfo_percpu_counter* counter, int64_t value) {
+	#if CPUINFO_PERCPU_RSEQ
+		if (counter->shards.restartable_shards_count != 0) {
+			struct rseq_area* rseq = get_rseq_area();
+			for (;;) {
+				uint32_t cpu = 0;
+				const uint32_t shard_index = get_restartable_shard(&counter->shards, rseq, &cpu);
+				if CPUINFO_UNLIKELY(shard_index == UINT32_MAX) {
+					break;
+				}
+				struct counter_shard* shard = get_shard(&counter->shards, shard_index);
+				if CPUINFO_LIKELY(rseq_add(rseq, cpu, &shard->value, value)) {
+					return;
+				}
+			}
+		}
+	#endif
+	struct counter_shard* shard = get_llc_shard(&counter->shards);
+	atomic_add(&shard->value, value);
+}
+
+int64_t CPUINFO_ABI cpuinfo_percpu_counter_read(const struct cpuinfo_percpu_counter* counter) {
+	const uint32_t shards_count = counter->shards.restartable_shards_count + counter->shards.llc_shards_count;
+	int64_t sum = 0;
+	for (uint32_t i = 0; i < shards_count; i++) {
+		const struct counter_shard* shard = get_shard(&counter->shards, i);
+		sum += atomic_load(&shard->value);
+	}
+	return sum;
+}
+
+struct cpuinfo_percpu_freelist* CPUINFO_ABI cpuinfo_create_percpu_freelist(void) {
+	struct cpuinfo_percpu_freelist* freelist = calloc(1, sizeof(struct cpuinfo_percpu_freelist));
+	if (freelist == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for per-processor free list",
+			sizeof(struct cpuinfo_percpu_freelist));
+		return NULL;
+	}
+	if (!create_shards(&freelist->shards)) {
+		free(freelist);
+		return NULL;
+	}
+	return freelist;
+}
+
+void CPUINFO_ABI cpuinfo_destroy_percpu_freelist(struct cpuinfo_percpu_freelist* freelist) {
+	if (freelist == NULL) {
+		return;
+	}
+	free(freelist->shards.memory);
+	free(freelist);
+}
+
+void CPUINFO_ABI cpuinfo_percpu_freelist_push(struct cpuinfo_percpu_freelist* freelist,
+	struct cpuinfo_percpu_freelist_node* node)
+{
+	#if CPUINFO_PERCPU_RSEQ
+		if (freelist->shards.restartable_shards_count != 0) {
+			struct rseq_area* rseq = get_rseq_area();
+			for (;;) {
+				uint32_t cpu = 0;
+				const uint32_t shard_index = get_restartable_shard(&freelist->shards, rseq, &cpu);
+				if CPUINFO_UNLIKELY(shard_index == UINT32_MAX) {
+					break;
+				}
+				struct freelist_shard* shard = get_shard(&freelist->shards, shard_index);
+				if CPUINFO_LIKELY(rseq_push(rseq, cpu, &shard->head, node)) {
+					return;
+				}
+			}
+		}
+	#endif
+	struct freelist_shard* shard = get_llc_shard(&freelist->shards);
+	lock_shard(shard);
+	node->next = shard->head;
+	shard->head = node;
+	unlock_shard(shard);
+}
+
+/* Pop a node from a shard of a last-level cache domain */
+static struct cpuinfo_percpu_freelist_node* pop_llc_shard(struct freelist_shard* shard) {
+	lock_shard(shard);
+	struct cpuinfo_percpu_freelist_node* node = shard->head;
+	if (node != NULL) {
+		shard->head = node->next;
+	}
+	unlock_shard(shard);
+	return node;
+}
+
+struct cpuinfo_percpu_freelist_node* CPUINFO_ABI cpuinfo_percpu_freelist_pop(struct cpuinfo_percpu_freelist* freelist) {
+	#if CPUINFO_PERCPU_RSEQ
+		if (freelist->shards.restartable_shards_count != 0) {
+			struct rseq_area* rseq = get_rseq_area();
+			for (;;) {
+				uint32_t cpu = 0;
+				const uint32_t shard_index = get_restartable_shard(&freelist->shards, rseq, &cpu);
+				if CPUINFO_UNLIKELY(shard_index == UINT32_MAX) {
+					break;
+				}
+				struct freelist_shard* shard = get_shard(&freelist->shards, shard_index);
+				struct cpuinfo_percpu_freelist_node* node = NULL;
+				if CPUINFO_LIKELY(rseq_pop(rseq, cpu, &shard->head, &node)) {
+					if CPUINFO_LIKELY(node != NULL) {
+						return node;
+					}
+					break;
+				}
+			}
+		}
+	#endif
+
+	/* Shards of last-level cache domains are locked, so nodes may come from other domains when the own one is empty */
+	struct freelist_shard* llc_shard = get_llc_shard(&freelist->shards);
+	struct cpuinfo_percpu_freelist_node* node = pop_llc_shard(llc_shard);
+	for (uint32_t i = 0; node == NULL && i < freelist->shards.llc_shards_count; i++) {
+		struct freelist_shard* shard = get_shard(&freelist->shards, freelist->shards.restartable_shards_count + i);
+		if (shard != llc_shard) {
+			node = pop_llc_shard(shard);
+		}
+	}
+	return node;
+}
+
+bool CPUINFO_ABI cpuinfo_percpu_is_restartable(void) {
+	return is_restartable(cpuinfo_get_tables("percpu_is_restartable"));
+}
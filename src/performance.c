@@ -0,0 +1,190 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <linux/api.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define PERFORMANCE_FILESIZE 32
+
+	/*
+	 * Per-processor sources of performance, relative to /sys/devices/system/cpu/cpuN, in the order of preference:
+	 * - amd_pstate with preferred core support reports the ranking of the core used by the scheduler; it may be
+	 *   updated at runtime by the platform firmware.
+	 * - ACPI CPPC reports the highest performance of the core in abstract units. Intel Turbo Boost Max 3.0 (ITMT)
+	 *   and AMD preferred cores report higher values for the favored cores.
+	 * - Without CPPC, intel_pstate reports the maximum turbo frequency of every core in cpuinfo_max_freq.
+	 */
+	static const char* const performance_filenames[] = {
+		"cpufreq/amd_pstate_prefcore_ranking",
+		"acpi_cppc/highest_perf",
+		"cpufreq/cpuinfo_max_freq",
+	};
+
+	static bool uint32_parser(const char* text_start, const char* text_end, void* context) {
+		uint32_t value = 0;
+		const char* digit = text_start;
+		for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+			value = value * 10 + (uint32_t) (*digit - '0');
+		}
+		if (digit == text_start) {
+			return false;
+		}
+		*((uint32_t*) context) = value;
+		return true;
+	}
+
+	static void detect_core_performance(struct cpuinfo_tables* tables) {
+		for (size_t source = 0; source < sizeof(performance_filenames) / sizeof(performance_filenames[0]); source++) {
+			const char* filename = performance_filenames[source];
+			uint32_t parsed_count = 0;
+			for (uint32_t i = 0; i < tables->processors_count; i++) {
+				const struct cpuinfo_processor* processor = &tables->processors[i];
+				uint32_t performance = 0;
+				if (!cpuinfo_linux_parse_processor_small_file((uint32_t) processor->linux_id, filename,
+						PERFORMANCE_FILESIZE, uint32_parser, &performance))
+				{
+					continue;
+				}
+				parsed_count += 1;
+				struct cpuinfo_core* core = (struct cpuinfo_core*) processor->core;
+				if (performance > core->performance) {
+					core->performance = performance;
+				}
+			}
+			if (parsed_count != 0) {
+				cpuinfo_log_debug("parsed performance of %"PRIu32" logical processors from %s",
+					parsed_count, filename);
+				break;
+			}
+		}
+		/* Attributes were read after initialization released the cached sysfs directories */
+		cpuinfo_linux_release_sysfs();
+	}
+#elif defined(_WIN32) || defined(__CYGWIN__)
+	/*
+	 * Windows doesn't report per-core performance, so the maximum frequency in KHz orders the cores if it is known for
+	 * all of them, and the efficiency class, which is the same for all cores of homogeneous systems, otherwise.
+	 */
+	static void detect_core_performance(struct cpuinfo_tables* tables) {
+		bool frequencies_known = tables->cores_count != 0;
+		for (uint32_t i = 0; i < tables->cores_count; i++) {
+			const struct cpuinfo_core* core = &tables->cores[i];
+			frequencies_known &= core->max_turbo_frequency != 0 || core->frequency != 0;
+		}
+		for (uint32_t i = 0; i < tables->cores_count; i++) {
+			struct cpuinfo_core* core = &tables->cores[i];
+			if (frequencies_known) {
+				const uint64_t frequency =
+					core->max_turbo_frequency > core->frequency ? core->max_turbo_frequency : core->frequency;
+				core->performance = (uint32_t) (frequency / UINT64_C(1000));
+			} else {
+				core->performance = (uint32_t) core->windows_efficiency_class + 1;
+			}
+		}
+	}
+#else
+	static void detect_core_performance(struct cpuinfo_tables* tables) {
+		(void) tables;
+	}
+#endif
+
+struct performance_entry {
+	uint32_t performance;
+	uint32_t smt_id;
+	uint32_t processor_index;
+};
+
+static int compare_performance_entries(const void* a_ptr, const void* b_ptr) {
+	const struct performance_entry* a = (const struct performance_entry*) a_ptr;
+	const struct performance_entry* b = (const struct performance_entry*) b_ptr;
+	if (a->performance != b->performance) {
+		return a->performance > b->performance ? -1 : 1;
+	}
+	if (a->smt_id != b->smt_id) {
+		return a->smt_id < b->smt_id ? -1 : 1;
+	}
+	return a->processor_index < b->processor_index ? -1 : a->processor_index > b->processor_index;
+}
+
+/* Cores of platforms which do not report capacity have the full capacity, and clusters the capacity of their cores */
+static void set_default_capacity(struct cpuinfo_tables* tables) {
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		struct cpuinfo_core* core = &tables->cores[i];
+		if (core->capacity == 0) {
+			core->capacity = CPUINFO_CAPACITY_SCALE;
+		}
+		struct cpuinfo_cluster* cluster = (struct cpuinfo_cluster*) core->cluster;
+		if (cluster != NULL && cluster->capacity < core->capacity) {
+			cluster->capacity = core->capacity;
+		}
+	}
+}
+
+bool cpuinfo_build_performance_ranking(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	if (processors_count == 0) {
+		return true;
+	}
+	set_default_capacity(tables);
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		tables->cores[i].performance = 0;
+		tables->cores[i].performance_rank = 0;
+	}
+	detect_core_performance(tables);
+
+	struct performance_entry* entries = cpuinfo_allocate_temporary(processors_count, sizeof(struct performance_entry));
+	if (entries == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for performance ranking of %"PRIu32" logical processors",
+			processors_count * sizeof(struct performance_entry), processors_count);
+		return false;
+	}
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		entries[i] = (struct performance_entry) {
+			.performance = processor->core->performance,
+			.smt_id = processor->smt_id,
+			.processor_index = i,
+		};
+	}
+	qsort(entries, processors_count, sizeof(struct performance_entry), compare_performance_entries);
+
+	/* Every distinct performance value, from the highest one, starts a new rank */
+	uint32_t rank = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		if (i != 0 && entries[i].performance != entries[i - 1].performance) {
+			rank += 1;
+		}
+		struct cpuinfo_core* core = (struct cpuinfo_core*) tables->processors[entries[i].processor_index].core;
+		core->performance_rank = rank;
+	}
+
+	struct cpuinfo_arena arena = { 0 };
+	cpuinfo_arena_reserve(&arena, tables->usable_processors_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		cpuinfo_free_temporary(entries);
+		return false;
+	}
+	uint32_t* performance_indices = arena.memory;
+	uint32_t performance_index = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const uint32_t processor_index = entries[i].processor_index;
+		if (tables->processors[processor_index].usable && performance_index < tables->usable_processors_count) {
+			performance_indices[performance_index++] = processor_index;
+		}
+	}
+	cpuinfo_free_temporary(entries);
+
+	tables->performance_processor_indices = performance_indices;
+	cpuinfo_log_debug("ranked %"PRIu32" cores into %"PRIu32" performance ranks", tables->cores_count, rank + 1);
+	return true;
+}
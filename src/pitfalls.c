@@ -0,0 +1,35 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+uint32_t CPUINFO_ABI cpuinfo_get_uarch_pitfalls(uint32_t uarch_index) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_pitfalls");
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if CPUINFO_UNLIKELY(processor == NULL) {
+		return 0;
+	}
+	uint32_t pitfalls = 0;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		pitfalls = cpuinfo_x86_decode_pitfalls(processor->core->uarch);
+		#if defined(__linux__)
+			/* Gathers on Intel cores are slow only after the microcode update which mitigates Downfall */
+			if ((pitfalls & CPUINFO_PITFALL_X86_SLOW_GATHER) && processor->core->vendor == cpuinfo_vendor_intel) {
+				struct cpuinfo_vulnerability_state gds_state;
+				if (cpuinfo_get_vulnerability_state(cpuinfo_vulnerability_gather_data_sampling, &gds_state) &&
+					!gds_state.microcode_mitigation)
+				{
+					pitfalls &= ~CPUINFO_PITFALL_X86_SLOW_GATHER;
+				}
+			}
+		#endif
+	#endif
+	return pitfalls;
+}
@@ -0,0 +1,769 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Key which identifies a group of logical processors for scatter policies */
+typedef const void* (*group_key_function)(const struct cpuinfo_processor*);
+
+static const void* get_llc_key(const struct cpuinfo_processor* processor) {
+	return cpuinfo_get_last_level_cache(processor);
+}
+
+static const void* get_package_key(const struct cpuinfo_processor* processor) {
+	return processor->package;
+}
+
+/*
+ * Order the logical processors within [start, start + count) so that physical cores come before their SMT siblings:
+ * first processors with SMT ID 0 of every core, then processors with SMT ID 1, and so on.
+ */
+static uint32_t order_physical_first(const struct cpuinfo_processor* processors, uint32_t start, uint32_t count,
+	const struct cpuinfo_processor** order)
+{
+	uint32_t max_smt_id = 0;
+	for (uint32_t i = start; i < start + count; i++) {
+		if (processors[i].smt_id > max_smt_id) {
+			max_smt_id = processors[i].smt_id;
+		}
+	}
+
+	uint32_t order_count = 0;
+	for (uint32_t smt_id = 0; smt_id <= max_smt_id; smt_id++) {
+		for (uint32_t i = start; i < start + count; i++) {
+			if (processors[i].smt_id == smt_id) {
+				order[order_count++] = &processors[i];
+			}
+		}
+	}
+	return order_count;
+}
+
+/*
+ * Order the logical processors round-robin across groups of consecutive processors with the same key,
+ * with physical cores before SMT siblings within every group.
+ */
+static bool order_scatter(const struct cpuinfo_tables* tables, group_key_function get_key,
+	const struct cpuinfo_processor** order)
+{
+	const struct cpuinfo_processor* processors = tables->processors;
+	const uint32_t processors_count = tables->processors_count;
+	const struct cpuinfo_processor** group_order = NULL;
+	uint32_t* group_starts = NULL;
+	bool status = false;
+
+	group_order = malloc(processors_count * sizeof(const struct cpuinfo_processor*));
+	if (group_order == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for ordering of %"PRIu32" processors",
+			processors_count * sizeof(const struct cpuinfo_processor*), processors_count);
+		goto cleanup;
+	}
+	/* One extra entry marks the end of the last group */
+	group_starts = malloc((processors_count + 1) * sizeof(uint32_t));
+	if (group_starts == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for groups of %"PRIu32" processors",
+			(processors_count + 1) * sizeof(uint32_t), processors_count);
+		goto cleanup;
+	}
+
+	uint32_t groups_count = 0;
+	uint32_t max_group_size = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		if (i == 0 || get_key(&processors[i]) != get_key(&processors[i - 1])) {
+			group_starts[groups_count++] = i;
+		}
+	}
+	group_starts[groups_count] = processors_count;
+	for (uint32_t group = 0; group < groups_count; group++) {
+		const uint32_t group_start = group_starts[group];
+		const uint32_t group_size = group_starts[group + 1] - group_start;
+		order_physical_first(processors, group_start, group_size, group_order + group_start);
+		if (group_size > max_group_size) {
+			max_group_size = group_size;
+		}
+	}
+
+	uint32_t order_count = 0;
+	for (uint32_t round = 0; round < max_group_size; round++) {
+		for (uint32_t group = 0; group < groups_count; group++) {
+			const uint32_t group_start = group_starts[group];
+			if (group_start + round < group_starts[group + 1]) {
+				order[order_count++] = group_order[group_start + round];
+			}
+		}
+	}
+	status = true;
+
+cleanup:
+	free(group_order);
+	free(group_starts);
+	return status;
+}
+
+/* Isolated and nohz_full processors are reserved for latency-critical threads */
+static inline bool is_isolated(const struct cpuinfo_processor* processor) {
+	return processor->isolated || processor->nohz_full;
+}
+
+static int cmp_big_cores_first(const void* ptr_a, const void* ptr_b) {
+	const struct cpuinfo_processor* processor_a = *((const struct cpuinfo_processor* const*) ptr_a);
+	const struct cpuinfo_processor* processor_b = *((const struct cpuinfo_processor* const*) ptr_b);
+
+	/* Higher frequency first */
+	const uint64_t frequency_a = processor_a->core->frequency;
+	const uint64_t frequency_b = processor_b->core->frequency;
+	if (frequency_a != frequency_b) {
+		return frequency_a > frequency_b ? -1 : 1;
+	}
+
+	/* Physical cores before SMT siblings */
+	if (processor_a->smt_id != processor_b->smt_id) {
+		return processor_a->smt_id < processor_b->smt_id ? -1 : 1;
+	}
+
+	/* Processor tables order: on ARM clusters are already sorted by performance */
+	return (processor_a > processor_b) - (processor_a < processor_b);
+}
+
+uint32_t CPUINFO_ABI cpuinfo_plan_workers(uint32_t workers_count, enum cpuinfo_worker_policy policy,
+	const struct cpuinfo_processor** processors)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("plan_workers");
+	if (workers_count == 0 || tables->processors_count == 0) {
+		return 0;
+	}
+
+	const struct cpuinfo_processor** order = malloc(tables->processors_count * sizeof(const struct cpuinfo_processor*));
+	if (order == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for ordering of %"PRIu32" processors",
+			tables->processors_count * sizeof(const struct cpuinfo_processor*), tables->processors_count);
+		return 0;
+	}
+
+	uint32_t order_count = 0;
+	switch (policy) {
+		case cpuinfo_worker_policy_compact:
+			for (uint32_t i = 0; i < tables->processors_count; i++) {
+				order[i] = &tables->processors[i];
+			}
+			order_count = tables->processors_count;
+			break;
+		case cpuinfo_worker_policy_scatter_llc:
+			if (order_scatter(tables, get_llc_key, order)) {
+				order_count = tables->processors_count;
+			}
+			break;
+		case cpuinfo_worker_policy_scatter_package:
+			if (order_scatter(tables, get_package_key, order)) {
+				order_count = tables->processors_count;
+			}
+			break;
+		case cpuinfo_worker_policy_physical_cores:
+			for (uint32_t i = 0; i < tables->cores_count; i++) {
+				if (tables->cores[i].processor_count != 0) {
+					order[order_count++] = &tables->processors[tables->cores[i].processor_start];
+				}
+			}
+			break;
+		case cpuinfo_worker_policy_big_cores_first:
+			for (uint32_t i = 0; i < tables->processors_count; i++) {
+				order[i] = &tables->processors[i];
+			}
+			qsort(order, tables->processors_count, sizeof(const struct cpuinfo_processor*), cmp_big_cores_first);
+			order_count = tables->processors_count;
+			break;
+		case cpuinfo_worker_policy_isolated:
+			for (uint32_t i = 0; i < tables->processors_count; i++) {
+				if (is_isolated(&tables->processors[i])) {
+					order[order_count++] = &tables->processors[i];
+				}
+			}
+			break;
+		default:
+			cpuinfo_log_warning("unsupported worker placement policy %d", (int) policy);
+			break;
+	}
+
+	/* Workers are placed only on processors which the process may use */
+	uint32_t usable_count = 0, shared_count = 0;
+	for (uint32_t i = 0; i < order_count; i++) {
+		if (order[i]->usable) {
+			order[usable_count++] = order[i];
+			shared_count += (uint32_t) !is_isolated(order[i]);
+		}
+	}
+	order_count = usable_count;
+
+	/* General-purpose policies leave isolated processors to latency-critical threads, unless no other remain */
+	if (policy != cpuinfo_worker_policy_isolated && shared_count != 0 && shared_count != order_count) {
+		uint32_t shared_index = 0;
+		for (uint32_t i = 0; i < order_count; i++) {
+			if (!is_isolated(order[i])) {
+				order[shared_index++] = order[i];
+			}
+		}
+		order_count = shared_count;
+	}
+
+	for (uint32_t i = 0; order_count != 0 && i < workers_count; i++) {
+		processors[i] = order[i % order_count];
+	}
+	free(order);
+	return workers_count < order_count ? workers_count : order_count;
+}
+
+/* Capacities of the cores of participating processors, by the first source in the order of cpuinfo_partition */
+static void get_core_capacities(uint32_t processors_count, const struct cpuinfo_processor** processors,
+	const struct cpuinfo_capability_monitor* monitor, uint64_t capacities[restrict static 1])
+{
+	bool hfi_known = monitor != NULL;
+	bool capacity_differs = false;
+	bool throughput_known = true;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct cpuinfo_core* core = processors[i]->core;
+		struct cpuinfo_core_capability capability;
+		hfi_known &= cpuinfo_get_core_capability(monitor, core, &capability) && capability.updates_count != 0;
+		capacity_differs |= core->capacity != processors[0]->core->capacity;
+		struct cpuinfo_peak_throughput throughput;
+		throughput_known &= cpuinfo_get_core_peak_throughput(core, &throughput) && throughput.fp32_ops_per_second != 0;
+	}
+
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct cpuinfo_core* core = processors[i]->core;
+		if (hfi_known) {
+			struct cpuinfo_core_capability capability;
+			cpuinfo_get_core_capability(monitor, core, &capability);
+			capacities[i] = capability.performance;
+		} else if (capacity_differs || !throughput_known) {
+			capacities[i] = core->capacity;
+		} else {
+			struct cpuinfo_peak_throughput throughput;
+			cpuinfo_get_core_peak_throughput(core, &throughput);
+			/* Operations per second divided by 2^20 keep the sum of capacities of all processors in 64 bits */
+			capacities[i] = (throughput.fp32_ops_per_second >> 20) + 1;
+		}
+	}
+	cpuinfo_log_debug("partition between %"PRIu32" processors by %s", processors_count,
+		hfi_known ? "HFI performance" : capacity_differs || !throughput_known ? "core capacity" : "peak throughput");
+}
+
+bool CPUINFO_ABI cpuinfo_partition(uint64_t range, uint32_t processors_count,
+	const struct cpuinfo_processor** processors, const struct cpuinfo_capability_monitor* monitor,
+	struct cpuinfo_partition_range* ranges)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("partition");
+	if (processors_count == 0 || processors == NULL || ranges == NULL) {
+		return false;
+	}
+	for (uint32_t i = 0; i < processors_count; i++) {
+		uint32_t index;
+		if (!cpuinfo_get_table_index(processors[i], tables->processors, tables->processors_count,
+				sizeof(struct cpuinfo_processor), &index))
+		{
+			cpuinfo_log_warning("processor %"PRIu32" of partition is not in the current tables", i);
+			return false;
+		}
+	}
+
+	uint64_t* weights = malloc(processors_count * sizeof(uint64_t));
+	uint32_t* core_processors = calloc(tables->cores_count, sizeof(uint32_t));
+	if (weights == NULL || core_processors == NULL) {
+		cpuinfo_log_error("failed to allocate weights of %"PRIu32" processors for partition", processors_count);
+		free(weights);
+		free(core_processors);
+		return false;
+	}
+	get_core_capacities(processors_count, processors, monitor, weights);
+
+	/* Logical processors of a core share its capacity */
+	for (uint32_t i = 0; i < processors_count; i++) {
+		core_processors[processors[i]->core - tables->cores] += 1;
+	}
+	uint64_t total_weight = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		weights[i] = weights[i] * CPUINFO_CAPACITY_SCALE / core_processors[processors[i]->core - tables->cores];
+		total_weight += weights[i];
+	}
+	if (total_weight == 0) {
+		for (uint32_t i = 0; i < processors_count; i++) {
+			weights[i] = 1;
+		}
+		total_weight = processors_count;
+	}
+
+	/* range * cumulative_weight / total_weight, split to avoid overflow of the product */
+	const uint64_t quotient = range / total_weight;
+	const uint64_t remainder = range % total_weight;
+	uint64_t cumulative_weight = 0;
+	uint64_t start = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		cumulative_weight += weights[i];
+		uint64_t end = range;
+		if (i + 1 != processors_count) {
+			end = quotient * cumulative_weight +
+				(uint64_t) ((double) remainder * (double) cumulative_weight / (double) total_weight);
+			if (end > range) {
+				end = range;
+			}
+		}
+		ranges[i] = (struct cpuinfo_partition_range) { .start = start, .end = end };
+		start = end;
+	}
+	free(weights);
+	free(core_processors);
+	return true;
+}
+
+/*
+ * Relative cost of a hand-off between stages on processors at each distance level: every level outwards roughly
+ * doubles the latency of a cache line transfer. Levels across NUMA nodes are further scaled by the NUMA distance.
+ */
+static const uint32_t pipeline_level_costs[cpuinfo_distance_level_max] = {
+	[cpuinfo_distance_level_processor] = 0,
+	[cpuinfo_distance_level_core] = 1,
+	[cpuinfo_distance_level_l2] = 2,
+	[cpuinfo_distance_level_l3] = 4,
+	[cpuinfo_distance_level_cluster] = 8,
+	[cpuinfo_distance_level_numa_node] = 16,
+	[cpuinfo_distance_level_package] = 32,
+	[cpuinfo_distance_level_remote] = 64,
+};
+
+struct pipeline_problem {
+	const struct cpuinfo_tables* tables;
+	uint32_t stage_count;
+	/* Symmetric weights of stage pairs, the sums of the weights of both directions */
+	uint64_t* weights;
+	/* Indices of candidate processors */
+	uint32_t* candidates;
+	uint32_t candidates_count;
+};
+
+static uint64_t get_pipeline_cost(const struct pipeline_problem* problem, uint32_t candidate,
+	uint32_t other_candidate)
+{
+	const struct cpuinfo_tables* tables = problem->tables;
+	const struct cpuinfo_processor_domains* domains = &tables->processor_domains[problem->candidates[candidate]];
+	const struct cpuinfo_processor_domains* other_domains =
+		&tables->processor_domains[problem->candidates[other_candidate]];
+	if (candidate == other_candidate) {
+		return pipeline_level_costs[cpuinfo_distance_level_processor];
+	}
+	const enum cpuinfo_distance_level level = cpuinfo_get_domains_distance_level(domains, other_domains);
+	uint64_t cost = pipeline_level_costs[level];
+	if (level >= cpuinfo_distance_level_package) {
+		const uint32_t numa_distance =
+			tables->numa_distances[(size_t) domains->numa_node * tables->numa_nodes_count + other_domains->numa_node];
+		if (numa_distance > 10) {
+			cost = cost * numa_distance / 10;
+		}
+	}
+	return cost;
+}
+
+/* Cost of the hand-offs of a stage on a candidate processor with the other placed stages */
+static uint64_t get_stage_cost(const struct pipeline_problem* problem, const uint32_t* placement, uint32_t stage,
+	uint32_t candidate)
+{
+	uint64_t cost = 0;
+	for (uint32_t other = 0; other < problem->stage_count; other++) {
+		const uint64_t weight = problem->weights[(size_t) stage * problem->stage_count + other];
+		if (other != stage && placement[other] != UINT32_MAX && weight != 0) {
+			cost += weight * get_pipeline_cost(problem, candidate, placement[other]);
+		}
+	}
+	return cost;
+}
+
+static uint64_t get_placement_cost(const struct pipeline_problem* problem, const uint32_t* placement) {
+	uint64_t cost = 0;
+	for (uint32_t stage = 0; stage < problem->stage_count; stage++) {
+		for (uint32_t other = stage + 1; other < problem->stage_count; other++) {
+			cost += problem->weights[(size_t) stage * problem->stage_count + other] *
+				get_pipeline_cost(problem, placement[stage], placement[other]);
+		}
+	}
+	return cost;
+}
+
+/*
+ * Greedily place the stages around a seed processor: the stage with the most traffic goes to the seed, and then the
+ * stage with the most traffic to the placed ones goes to the candidate with the cheapest hand-offs to them, or the
+ * nearest one to the seed among equally cheap candidates. Candidates which run fewer stages come first.
+ */
+static void place_from_seed(const struct pipeline_problem* problem, uint32_t seed, uint32_t* placement,
+	uint32_t* loads, uint64_t* connections)
+{
+	const uint32_t stage_count = problem->stage_count;
+	for (uint32_t stage = 0; stage < stage_count; stage++) {
+		placement[stage] = UINT32_MAX;
+		connections[stage] = 0;
+		for (uint32_t other = 0; other < stage_count; other++) {
+			connections[stage] += problem->weights[(size_t) stage * stage_count + other];
+		}
+	}
+	for (uint32_t i = 0; i < problem->candidates_count; i++) {
+		loads[i] = 0;
+	}
+
+	for (uint32_t placed = 0; placed < stage_count; placed++) {
+		uint32_t stage = UINT32_MAX;
+		for (uint32_t i = 0; i < stage_count; i++) {
+			if (placement[i] == UINT32_MAX && (stage == UINT32_MAX || connections[i] > connections[stage])) {
+				stage = i;
+			}
+		}
+
+		uint32_t best_candidate = seed;
+		if (placed != 0) {
+			uint32_t best_load = UINT32_MAX;
+			uint64_t best_cost = UINT64_MAX, best_seed_cost = UINT64_MAX;
+			for (uint32_t candidate = 0; candidate < problem->candidates_count; candidate++) {
+				/* Stages share a processor only when all candidates run as many stages */
+				const uint32_t load = loads[candidate];
+				if (load > best_load) {
+					continue;
+				}
+				const uint64_t cost = get_stage_cost(problem, placement, stage, candidate);
+				const uint64_t seed_cost = get_pipeline_cost(problem, candidate, seed);
+				if (load < best_load || cost < best_cost || (cost == best_cost && seed_cost < best_seed_cost)) {
+					best_candidate = candidate;
+					best_load = load;
+					best_cost = cost;
+					best_seed_cost = seed_cost;
+				}
+			}
+		}
+		placement[stage] = best_candidate;
+		loads[best_candidate] += 1;
+
+		/* After the first stage, the order follows the traffic to placed stages rather than the total traffic */
+		if (placed == 0) {
+			for (uint32_t i = 0; i < stage_count; i++) {
+				connections[i] = 0;
+			}
+		}
+		for (uint32_t i = 0; i < stage_count; i++) {
+			connections[i] += problem->weights[(size_t) i * stage_count + stage];
+		}
+	}
+}
+
+/* Improve a placement by swaps of two stages and moves of a stage to a candidate which runs fewer stages */
+static void refine_placement(const struct pipeline_problem* problem, uint32_t* placement, uint32_t* loads) {
+	const uint32_t stage_count = problem->stage_count;
+	for (uint32_t round = 0; round < stage_count; round++) {
+		bool improved = false;
+		for (uint32_t stage = 0; stage < stage_count; stage++) {
+			for (uint32_t other = stage + 1; other < stage_count; other++) {
+				const uint32_t candidate = placement[stage], other_candidate = placement[other];
+				if (candidate == other_candidate) {
+					continue;
+				}
+				const uint64_t cost = get_placement_cost(problem, placement);
+				placement[stage] = other_candidate;
+				placement[other] = candidate;
+				if (get_placement_cost(problem, placement) < cost) {
+					improved = true;
+				} else {
+					placement[stage] = candidate;
+					placement[other] = other_candidate;
+				}
+			}
+			uint32_t best_candidate = placement[stage];
+			uint64_t best_cost = get_stage_cost(problem, placement, stage, best_candidate);
+			for (uint32_t candidate = 0; candidate < problem->candidates_count; candidate++) {
+				if (loads[candidate] >= loads[placement[stage]]) {
+					continue;
+				}
+				const uint64_t cost = get_stage_cost(problem, placement, stage, candidate);
+				if (cost < best_cost) {
+					best_candidate = candidate;
+					best_cost = cost;
+				}
+			}
+			if (best_candidate != placement[stage]) {
+				loads[placement[stage]] -= 1;
+				loads[best_candidate] += 1;
+				placement[stage] = best_candidate;
+				improved = true;
+			}
+		}
+		if (!improved) {
+			break;
+		}
+	}
+}
+
+/*
+ * Candidates are the usable processors, without isolated and nohz_full ones unless no others remain, and with one
+ * processor per core if there are enough cores for all stages, as SMT siblings compete for the resources of a core.
+ */
+static uint32_t select_pipeline_candidates(const struct cpuinfo_tables* tables, uint32_t stage_count,
+	uint32_t* candidates, bool* core_used)
+{
+	uint32_t shared_count = 0;
+	for (uint32_t i = 0; i < tables->usable_processors_count; i++) {
+		shared_count += (uint32_t) !is_isolated(&tables->processors[tables->usable_processor_indices[i]]);
+	}
+	uint32_t candidates_count = 0, cores_count = 0;
+	for (uint32_t i = 0; i < tables->usable_processors_count; i++) {
+		const uint32_t processor_index = tables->usable_processor_indices[i];
+		const struct cpuinfo_processor* processor = &tables->processors[processor_index];
+		if (shared_count != 0 && is_isolated(processor)) {
+			continue;
+		}
+		candidates[candidates_count++] = processor_index;
+		const uint32_t core_index = tables->processor_domains[processor_index].core;
+		cores_count += (uint32_t) !core_used[core_index];
+		core_used[core_index] = true;
+	}
+	if (cores_count < stage_count || cores_count == candidates_count) {
+		return candidates_count;
+	}
+
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		core_used[i] = false;
+	}
+	uint32_t physical_count = 0;
+	for (uint32_t i = 0; i < candidates_count; i++) {
+		const uint32_t core_index = tables->processor_domains[candidates[i]].core;
+		if (!core_used[core_index]) {
+			core_used[core_index] = true;
+			candidates[physical_count++] = candidates[i];
+		}
+	}
+	return physical_count;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_place_pipeline(uint32_t stage_count, const uint32_t* edge_weights,
+	const struct cpuinfo_processor** processors)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("place_pipeline");
+	if (stage_count == 0 || edge_weights == NULL || processors == NULL ||
+		tables->usable_processors_count == 0 || tables->processor_domains == NULL)
+	{
+		return 0;
+	}
+
+	const size_t matrix_size = (size_t) stage_count * stage_count;
+	struct pipeline_problem problem = {
+		.tables = tables,
+		.stage_count = stage_count,
+		.weights = malloc(matrix_size * sizeof(uint64_t)),
+		.candidates = malloc(tables->usable_processors_count * sizeof(uint32_t)),
+	};
+	bool* core_used = calloc(tables->cores_count, sizeof(bool));
+	uint32_t* loads = malloc(tables->usable_processors_count * sizeof(uint32_t));
+	uint32_t* placement = malloc(2 * (size_t) stage_count * sizeof(uint32_t));
+	uint64_t* connections = malloc(stage_count * sizeof(uint64_t));
+	uint32_t distinct_count = 0;
+	if (problem.weights == NULL || problem.candidates == NULL || core_used == NULL || loads == NULL ||
+		placement == NULL || connections == NULL)
+	{
+		cpuinfo_log_error("failed to allocate placement of %"PRIu32" pipeline stages on %"PRIu32" processors",
+			stage_count, tables->usable_processors_count);
+		goto cleanup;
+	}
+	uint32_t* best_placement = placement + stage_count;
+
+	for (uint32_t stage = 0; stage < stage_count; stage++) {
+		for (uint32_t other = 0; other < stage_count; other++) {
+			problem.weights[(size_t) stage * stage_count + other] = stage == other ? 0 :
+				(uint64_t) edge_weights[(size_t) stage * stage_count + other] +
+				(uint64_t) edge_weights[(size_t) other * stage_count + stage];
+		}
+	}
+	problem.candidates_count = select_pipeline_candidates(tables, stage_count, problem.candidates, core_used);
+
+	/* Seeds are the first candidates of every group of candidates which share the L3 cache and the cluster */
+	uint64_t best_cost = UINT64_MAX;
+	for (uint32_t seed = 0; seed < problem.candidates_count; seed++) {
+		if (seed != 0) {
+			const struct cpuinfo_processor_domains* domains = &tables->processor_domains[problem.candidates[seed]];
+			const struct cpuinfo_processor_domains* previous_domains =
+				&tables->processor_domains[problem.candidates[seed - 1]];
+			if (domains->l3 == previous_domains->l3 && domains->cluster == previous_domains->cluster &&
+				domains->numa_node == previous_domains->numa_node && domains->package == previous_domains->package)
+			{
+				continue;
+			}
+		}
+		place_from_seed(&problem, seed, placement, loads, connections);
+		refine_placement(&problem, placement, loads);
+		const uint64_t cost = get_placement_cost(&problem, placement);
+		if (cost < best_cost) {
+			best_cost = cost;
+			for (uint32_t stage = 0; stage < stage_count; stage++) {
+				best_placement[stage] = placement[stage];
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < problem.candidates_count; i++) {
+		loads[i] = 0;
+	}
+	for (uint32_t stage = 0; stage < stage_count; stage++) {
+		processors[stage] = &tables->processors[problem.candidates[best_placement[stage]]];
+		distinct_count += (uint32_t) (loads[best_placement[stage]]++ == 0);
+	}
+	cpuinfo_log_debug("placed %"PRIu32" pipeline stages on %"PRIu32" processors with hand-off cost %"PRIu64,
+		stage_count, distinct_count, best_cost);
+
+cleanup:
+	free(problem.weights);
+	free(problem.candidates);
+	free(core_used);
+	free(loads);
+	free(placement);
+	free(connections);
+	return distinct_count;
+}
+
+struct tree_entry {
+	struct cpuinfo_processor_domains domains;
+	uint32_t processor_index;
+	uint32_t participant_index;
+};
+
+static int compare_tree_entries(const void* a_ptr, const void* b_ptr) {
+	const struct tree_entry* a = (const struct tree_entry*) a_ptr;
+	const struct tree_entry* b = (const struct tree_entry*) b_ptr;
+	/* Outer topology levels first, as in cpuinfo_distance_level, so that every domain is a run of entries */
+	const uint32_t a_keys[] = {
+		a->domains.package, a->domains.numa_node, a->domains.cluster, a->domains.l3, a->domains.l2, a->domains.core,
+		a->processor_index, a->participant_index,
+	};
+	const uint32_t b_keys[] = {
+		b->domains.package, b->domains.numa_node, b->domains.cluster, b->domains.l3, b->domains.l2, b->domains.core,
+		b->processor_index, b->participant_index,
+	};
+	for (size_t i = 0; i < sizeof(a_keys) / sizeof(a_keys[0]); i++) {
+		if (a_keys[i] != b_keys[i]) {
+			return a_keys[i] < b_keys[i] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+/* Whether two entries are in the same domain of the level: every outer level matches, and the level has the domain */
+static bool is_same_tree_domain(const struct tree_entry* a, const struct tree_entry* b,
+	enum cpuinfo_distance_level level)
+{
+	switch (level) {
+		case cpuinfo_distance_level_core:
+			if (a->domains.core != b->domains.core) {
+				return false;
+			}
+			/* fall through */
+		case cpuinfo_distance_level_l2:
+			if (a->domains.l2 != b->domains.l2 || (level == cpuinfo_distance_level_l2 && a->domains.l2 == UINT32_MAX)) {
+				return false;
+			}
+			/* fall through */
+		case cpuinfo_distance_level_l3:
+			if (a->domains.l3 != b->domains.l3 || (level == cpuinfo_distance_level_l3 && a->domains.l3 == UINT32_MAX)) {
+				return false;
+			}
+			/* fall through */
+		case cpuinfo_distance_level_cluster:
+			if (a->domains.cluster != b->domains.cluster) {
+				return false;
+			}
+			/* fall through */
+		case cpuinfo_distance_level_numa_node:
+			if (a->domains.numa_node != b->domains.numa_node) {
+				return false;
+			}
+			/* fall through */
+		case cpuinfo_distance_level_package:
+			return a->domains.package == b->domains.package;
+		default:
+			return true;
+	}
+}
+
+bool CPUINFO_ABI cpuinfo_build_reduction_tree(uint32_t participants_count,
+	const struct cpuinfo_processor** processors, enum cpuinfo_tree_fanout fanout, uint32_t* parents)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("build_reduction_tree");
+	if (participants_count == 0 || processors == NULL || parents == NULL || tables->processor_domains == NULL) {
+		return false;
+	}
+	uint32_t arity;
+	switch (fanout) {
+		case cpuinfo_tree_fanout_flat:
+			arity = UINT32_MAX;
+			break;
+		case cpuinfo_tree_fanout_binary:
+			arity = 2;
+			break;
+		case cpuinfo_tree_fanout_quaternary:
+			arity = 4;
+			break;
+		default:
+			cpuinfo_log_warning("unsupported reduction tree fanout %d", (int) fanout);
+			return false;
+	}
+
+	struct tree_entry* entries = malloc(participants_count * sizeof(struct tree_entry));
+	uint32_t* roots = malloc(participants_count * sizeof(uint32_t));
+	if (entries == NULL || roots == NULL) {
+		cpuinfo_log_error("failed to allocate reduction tree of %"PRIu32" participants", participants_count);
+		free(entries);
+		free(roots);
+		return false;
+	}
+	for (uint32_t i = 0; i < participants_count; i++) {
+		uint32_t processor_index;
+		if (!cpuinfo_get_table_index(processors[i], tables->processors, tables->processors_count,
+				sizeof(struct cpuinfo_processor), &processor_index))
+		{
+			cpuinfo_log_warning("processor of participant %"PRIu32" of reduction tree is not in the current tables", i);
+			free(entries);
+			free(roots);
+			return false;
+		}
+		entries[i] = (struct tree_entry) {
+			.domains = tables->processor_domains[processor_index],
+			.processor_index = processor_index,
+			.participant_index = i,
+		};
+	}
+	qsort(entries, participants_count, sizeof(struct tree_entry), compare_tree_entries);
+
+	/* Roots of the subtrees of the previous level, as indices of entries, which stay sorted by domains */
+	uint32_t roots_count = participants_count;
+	for (uint32_t i = 0; i < participants_count; i++) {
+		roots[i] = i;
+	}
+	for (int level = cpuinfo_distance_level_core; level < cpuinfo_distance_level_max; level++) {
+		uint32_t next_roots_count = 0;
+		for (uint32_t start = 0, end; start < roots_count; start = end) {
+			end = start + 1;
+			while (end < roots_count && is_same_tree_domain(&entries[roots[start]], &entries[roots[end]],
+				(enum cpuinfo_distance_level) level))
+			{
+				end++;
+			}
+			/* Subtrees of the domain hang below its first root, in the order of a heap of the arity */
+			for (uint32_t member = start + 1; member < end; member++) {
+				const uint32_t parent = arity == UINT32_MAX ? start : start + (member - start - 1) / arity;
+				parents[entries[roots[member]].participant_index] = entries[roots[parent]].participant_index;
+			}
+			roots[next_roots_count++] = roots[start];
+		}
+		roots_count = next_roots_count;
+	}
+	parents[entries[roots[0]].participant_index] = UINT32_MAX;
+
+	free(entries);
+	free(roots);
+	return true;
+}
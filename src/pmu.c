@@ -0,0 +1,422 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* Counters are decoded on the current processor, not from the CPUID leaves of the initializing processor */
+	#define CPUINFO_X86_CPUID_UNCACHED 1
+	#include <x86/cpuid.h>
+#endif
+#if defined(__linux__)
+	#include <unistd.h>
+
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#include <dirent.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <sys/syscall.h>
+		#include <linux/perf_event.h>
+	#endif
+
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define PERF_EVENT_PARANOID_FILENAME "/proc/sys/kernel/perf_event_paranoid"
+	#define PERF_EVENT_PARANOID_FILESIZE 32
+	#define PMU_DEVICES_DIRNAME "/sys/bus/event_source/devices"
+	#define PMU_FILENAME_SIZE 512
+	#define PMU_TYPE_FILESIZE 32
+
+	static bool int32_parser(const char* text_start, const char* text_end, void* context) {
+		const bool negative = text_start != text_end && *text_start == '-';
+		int32_t value = 0;
+		const char* digit = negative ? text_start + 1 : text_start;
+		const char* digits_start = digit;
+		for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+			value = value * 10 + (int32_t) (*digit - '0');
+		}
+		if (digit == digits_start) {
+			return false;
+		}
+		*((int32_t*) context) = negative ? -value : value;
+		return true;
+	}
+
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		static bool uint32_parser(const char* text_start, const char* text_end, void* context) {
+			uint32_t value = 0;
+			const char* digit = text_start;
+			for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+				value = value * 10 + (uint32_t) (*digit - '0');
+			}
+			if (digit == text_start) {
+				return false;
+			}
+			*((uint32_t*) context) = value;
+			return true;
+		}
+	#endif
+#endif
+
+#if (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+	/* PMUv3 has at most 31 general-purpose counters */
+	#define MAX_PROBED_COUNTERS 32
+	/* INST_RETIRED common event: architecturally required, and never counted by the dedicated cycle counter */
+	#define ARMV8_PMUV3_INST_RETIRED 0x08
+
+	struct pmu_event_name {
+		const char* name;
+		uint32_t flag;
+	};
+
+	/* Names of common events in sysfs, as in drivers/perf/arm_pmuv3.c of Linux */
+	static const struct pmu_event_name pmu_event_names[] = {
+		{ "cpu_cycles", CPUINFO_PMU_EVENT_CYCLES },
+		{ "inst_retired", CPUINFO_PMU_EVENT_INSTRUCTIONS },
+		{ "ll_cache_rd", CPUINFO_PMU_EVENT_LLC_REFERENCES },
+		{ "ll_cache_miss_rd", CPUINFO_PMU_EVENT_LLC_MISSES },
+		{ "br_retired", CPUINFO_PMU_EVENT_BRANCH_INSTRUCTIONS },
+		{ "br_mis_pred_retired", CPUINFO_PMU_EVENT_BRANCH_MISSES },
+		{ "stall_slot", CPUINFO_PMU_EVENT_TOPDOWN_SLOTS },
+	};
+
+	struct cpulist_search_context {
+		uint32_t linux_id;
+		bool found;
+	};
+
+	static bool cpulist_search_parser(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+		struct cpulist_search_context* search_context = (struct cpulist_search_context*) context;
+		if (search_context->linux_id >= cpu_start && search_context->linux_id < cpu_end) {
+			search_context->found = true;
+		}
+		return true;
+	}
+
+	/*
+	 * Find the PMU device with the name prefix which lists the processor in its cpulist file, and read its perf_event
+	 * type
+	 */
+	static bool find_arm_pmu(uint32_t linux_id, const char* prefix, const char* cpulist_name,
+		char directory[restrict static PMU_FILENAME_SIZE], uint32_t perf_type[restrict static 1])
+	{
+		DIR* devices = opendir(PMU_DEVICES_DIRNAME);
+		if (devices == NULL) {
+			cpuinfo_log_debug("failed to open %s: perf_event is not supported", PMU_DEVICES_DIRNAME);
+			return false;
+		}
+		bool found = false;
+		for (const struct dirent* entry = readdir(devices); entry != NULL && !found; entry = readdir(devices)) {
+			if (strncmp(entry->d_name, prefix, strlen(prefix)) != 0) {
+				continue;
+			}
+			char filename[PMU_FILENAME_SIZE];
+			snprintf(directory, PMU_FILENAME_SIZE, "%s/%s", PMU_DEVICES_DIRNAME, entry->d_name);
+			snprintf(filename, sizeof(filename), "%s/%s", directory, cpulist_name);
+			struct cpulist_search_context context = { .linux_id = linux_id };
+			if (!cpuinfo_linux_parse_cpulist(filename, cpulist_search_parser, &context) || !context.found) {
+				continue;
+			}
+			snprintf(filename, sizeof(filename), "%s/type", directory);
+			found = cpuinfo_linux_parse_small_file(filename, PMU_TYPE_FILESIZE, uint32_parser, perf_type);
+		}
+		closedir(devices);
+		return found;
+	}
+
+	/*
+	 * Count general-purpose counters as the size of the largest group of INST_RETIRED events which perf_event accepts:
+	 * the arm_pmu driver rejects groups which don't fit in the counters of the PMU when they are opened.
+	 */
+	static uint32_t count_arm_pmu_counters(uint32_t perf_type) {
+		int files[MAX_PROBED_COUNTERS];
+		uint32_t count = 0;
+		for (; count < MAX_PROBED_COUNTERS; count++) {
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = perf_type;
+			attr.size = sizeof(attr);
+			attr.config = ARMV8_PMUV3_INST_RETIRED;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			files[count] = (int) syscall(__NR_perf_event_open, &attr, 0 /* calling thread */, -1 /* any processor */,
+				count == 0 ? -1 : files[0], PERF_FLAG_FD_CLOEXEC);
+			if (files[count] == -1) {
+				break;
+			}
+		}
+		for (uint32_t i = 0; i < count; i++) {
+			close(files[i]);
+		}
+		return count;
+	}
+
+	static bool query_arm_pmu(const struct cpuinfo_processor* processor,
+		struct cpuinfo_pmu_info info[restrict static 1])
+	{
+		char directory[PMU_FILENAME_SIZE];
+		uint32_t perf_type = 0;
+		/* armv7_cortex_a7, armv8_pmuv3_0, armv8_cortex_a76, and other devices of the arm_pmu driver */
+		if (!find_arm_pmu((uint32_t) processor->linux_id, "armv", "cpus", directory, &perf_type)) {
+			cpuinfo_log_debug("no PMU device lists processor %d", processor->linux_id);
+			return false;
+		}
+
+		for (size_t i = 0; i < CPUINFO_COUNT_OF(pmu_event_names); i++) {
+			char filename[PMU_FILENAME_SIZE];
+			snprintf(filename, sizeof(filename), "%s/events/%s", directory, pmu_event_names[i].name);
+			if (access(filename, F_OK) == 0) {
+				info->architectural_events |= pmu_event_names[i].flag;
+			}
+		}
+		/* PMCCNTR_EL0 is a dedicated 64-bit cycle counter */
+		info->fixed_counters = 1;
+		info->fixed_counter_width = 64;
+		if (info->perf_event_allowed) {
+			info->general_counters = count_arm_pmu_counters(perf_type);
+		}
+		return true;
+	}
+
+	static void query_arm_trace(const struct cpuinfo_processor* processor,
+		struct cpuinfo_trace_info info[restrict static 1])
+	{
+		char directory[PMU_FILENAME_SIZE];
+		/* arm_spe_0, or a device for every group of cores with SPE on SoCs where only some cores have it */
+		if (find_arm_pmu((uint32_t) processor->linux_id, "arm_spe_", "cpumask", directory, &info->sampling_perf_type)) {
+			info->facilities |= CPUINFO_TRACE_ARM_SPE;
+		}
+		/* The cs_etm device links the tracers of processors as cpuN */
+		snprintf(directory, sizeof(directory), "%s/cs_etm/cpu%d", PMU_DEVICES_DIRNAME, processor->linux_id);
+		if (access(directory, F_OK) == 0 &&
+			cpuinfo_linux_parse_small_file(PMU_DEVICES_DIRNAME "/cs_etm/type", PMU_TYPE_FILESIZE, uint32_parser,
+				&info->trace_perf_type))
+		{
+			info->facilities |= CPUINFO_TRACE_ARM_ETE;
+		}
+	}
+#endif
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	static inline uint32_t popcount_u32(uint32_t value) {
+		uint32_t count = 0;
+		for (; value != 0; value &= value - 1) {
+			count++;
+		}
+		return count;
+	}
+
+	/* Decode CPUID of the current processor */
+	static void decode_x86_pmu(enum cpuinfo_vendor vendor, void* context) {
+		struct cpuinfo_pmu_info* info = (struct cpuinfo_pmu_info*) context;
+		const uint32_t max_base_index = cpuid(0).eax;
+		if (max_base_index >= 0xA) {
+			/* Architectural performance monitoring leaf: bits of EBX mark unavailable architectural events */
+			const struct cpuid_regs leaf0xA = cpuid(0xA);
+			info->version = leaf0xA.eax & 0xFF;
+			if (info->version != 0) {
+				info->general_counters = (leaf0xA.eax >> 8) & 0xFF;
+				info->general_counter_width = (leaf0xA.eax >> 16) & 0xFF;
+				const uint32_t events_length = (leaf0xA.eax >> 24) & 0xFF;
+				const uint32_t events_mask = events_length >= 32 ? UINT32_MAX : (UINT32_C(1) << events_length) - 1;
+				info->architectural_events = ~leaf0xA.ebx & events_mask & 0xFF;
+				if (info->version >= 2) {
+					const uint32_t fixed_counters = leaf0xA.edx & 0x1F;
+					/* Since version 5, ECX enumerates fixed counters in addition to the first EDX[4:0] ones */
+					const uint32_t fixed_mask = info->version >= 5 ? leaf0xA.ecx : 0;
+					for (uint32_t i = 0; i < 32; i++) {
+						if (i < fixed_counters || (fixed_mask & (UINT32_C(1) << i)) != 0) {
+							info->fixed_counters++;
+						}
+					}
+					info->fixed_counter_width = (leaf0xA.edx >> 5) & 0xFF;
+				}
+			}
+		}
+		if (max_base_index >= 0x23 && (cpuidex(7, 1).eax & UINT32_C(0x00000100)) != 0) {
+			/* Architectural performance monitoring extended leaf: bitmaps of the counters of this core type */
+			const uint32_t subleafs = cpuidex(0x23, 0).eax;
+			if ((subleafs & UINT32_C(0x00000002)) != 0) {
+				const struct cpuid_regs counters = cpuidex(0x23, 1);
+				info->general_counters = popcount_u32(counters.eax);
+				info->fixed_counters = popcount_u32(counters.ebx);
+			}
+			if ((subleafs & UINT32_C(0x00000008)) != 0) {
+				info->architectural_events = cpuidex(0x23, 3).eax & 0xFF;
+			}
+		}
+
+		if (info->version == 0 && (vendor == cpuinfo_vendor_amd || vendor == cpuinfo_vendor_hygon)) {
+			/* AMD counters are 48-bit; 4 legacy counters, or 6 with the core counter extension */
+			const uint32_t max_extended_index = cpuid(UINT32_C(0x80000000)).eax;
+			info->general_counters = 4;
+			info->general_counter_width = 48;
+			if (max_extended_index >= UINT32_C(0x80000001) &&
+				(cpuid(UINT32_C(0x80000001)).ecx & UINT32_C(0x00800000)) != 0)
+			{
+				info->general_counters = 6;
+			}
+			if (max_extended_index >= UINT32_C(0x80000022)) {
+				const struct cpuid_regs leaf0x80000022 = cpuid(UINT32_C(0x80000022));
+				/* PerfMonV2 enumerates the number of core counters */
+				if ((leaf0x80000022.eax & UINT32_C(0x00000001)) != 0 && (leaf0x80000022.ebx & 0xF) != 0) {
+					info->general_counters = leaf0x80000022.ebx & 0xF;
+				}
+			}
+		}
+	}
+
+	/* Decode CPUID of the current processor */
+	static void decode_x86_trace(enum cpuinfo_vendor vendor, void* context) {
+		struct cpuinfo_trace_info* info = (struct cpuinfo_trace_info*) context;
+		const uint32_t max_base_index = cpuid(0).eax;
+		if (max_base_index >= 7) {
+			const struct cpuid_regs leaf7 = cpuidex(7, 0);
+			if ((leaf7.ebx & UINT32_C(0x02000000)) != 0 && max_base_index >= 0x14) {
+				/* Processor trace leaf: EBX and ECX enumerate features and output schemes */
+				const struct cpuid_regs leaf0x14 = cpuidex(0x14, 0);
+				info->facilities |= CPUINFO_TRACE_INTEL_PT;
+				info->intel_pt_capabilities = (leaf0x14.ebx & UINT32_C(0x000001FF)) |
+					((leaf0x14.ecx & UINT32_C(0x00000007)) << 16);
+				if (leaf0x14.eax >= 1) {
+					info->intel_pt_address_ranges = cpuidex(0x14, 1).eax & 0x7;
+				}
+			}
+			if ((leaf7.edx & UINT32_C(0x00080000)) != 0 && max_base_index >= 0x1C) {
+				/* Bit N of EAX[7:0] of the architectural LBR leaf marks support for 8 * (N + 1) entries */
+				const uint32_t depths = cpuidex(0x1C, 0).eax & 0xFF;
+				for (uint32_t i = 0; i < 8; i++) {
+					if ((depths & (UINT32_C(1) << i)) != 0) {
+						info->branch_records = 8 * (i + 1);
+					}
+				}
+				if (info->branch_records != 0) {
+					info->facilities |= CPUINFO_TRACE_LBR | CPUINFO_TRACE_ARCHITECTURAL_LBR;
+				}
+			}
+		}
+		if (vendor == cpuinfo_vendor_amd || vendor == cpuinfo_vendor_hygon) {
+			const uint32_t max_extended_index = cpuid(UINT32_C(0x80000000)).eax;
+			if (max_extended_index >= UINT32_C(0x80000008) &&
+				(cpuid(UINT32_C(0x80000008)).ebx & UINT32_C(0x80000000)) != 0)
+			{
+				/* BRS samples the last 16 taken branches */
+				info->facilities |= CPUINFO_TRACE_AMD_BRS;
+				info->branch_records = 16;
+			}
+			if (max_extended_index >= UINT32_C(0x80000022)) {
+				const struct cpuid_regs leaf0x80000022 = cpuid(UINT32_C(0x80000022));
+				if ((leaf0x80000022.eax & UINT32_C(0x00000002)) != 0) {
+					info->facilities |= CPUINFO_TRACE_AMD_LBR_V2;
+					info->branch_records = (leaf0x80000022.ebx >> 4) & 0x3F;
+				}
+			}
+		}
+	}
+
+	/* Decode CPUID on a processor of the microarchitecture */
+	static bool query_x86(const struct cpuinfo_tables* tables, const struct cpuinfo_processor* processor,
+		void (*decode)(enum cpuinfo_vendor, void*), void* context)
+	{
+		if (tables->uarchs_count <= 1) {
+			decode(processor->core->vendor, context);
+			return true;
+		}
+
+		/* Hybrid processors report the facilities of the core type which executes CPUID */
+		struct cpuinfo_thread_affinity_state state;
+		if (!cpuinfo_save_current_thread_affinity(&state)) {
+			return false;
+		}
+		bool status = cpuinfo_pin_current_thread_to_processor(processor);
+		if (status) {
+			decode(processor->core->vendor, context);
+		} else {
+			cpuinfo_log_warning("failed to pin thread to processor %"PRIu32" to query its CPUID",
+				(uint32_t) (processor - tables->processors));
+		}
+		if (!cpuinfo_restore_current_thread_affinity(&state)) {
+			cpuinfo_log_warning("failed to restore thread affinity after query of CPUID");
+		}
+		return status;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_get_uarch_pmu_info(uint32_t uarch_index, struct cpuinfo_pmu_info* info) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_pmu_info");
+	if CPUINFO_UNLIKELY(info == NULL) {
+		return false;
+	}
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if (processor == NULL) {
+		cpuinfo_log_debug("no processors with microarchitecture %"PRIu32" for PMU query", uarch_index);
+		return false;
+	}
+
+	*info = (struct cpuinfo_pmu_info) {
+		.perf_event_paranoid = INT32_MAX,
+	};
+	#if defined(__linux__)
+		if (cpuinfo_linux_parse_small_file(PERF_EVENT_PARANOID_FILENAME, PERF_EVENT_PARANOID_FILESIZE,
+			int32_parser, &info->perf_event_paranoid))
+		{
+			info->perf_event_allowed = info->perf_event_paranoid <= 2;
+		}
+	#endif
+
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return query_x86(tables, processor, decode_x86_pmu, info);
+	#elif (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+		return query_arm_pmu(processor, info);
+	#else
+		return false;
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_get_uarch_trace_info(uint32_t uarch_index, struct cpuinfo_trace_info* info) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_trace_info");
+	if CPUINFO_UNLIKELY(info == NULL) {
+		return false;
+	}
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if (processor == NULL) {
+		cpuinfo_log_debug("no processors with microarchitecture %"PRIu32" for trace query", uarch_index);
+		return false;
+	}
+
+	*info = (struct cpuinfo_trace_info) {
+		.trace_perf_type = UINT32_MAX,
+		.sampling_perf_type = UINT32_MAX,
+	};
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		if (!query_x86(tables, processor, decode_x86_trace, info)) {
+			return false;
+		}
+		#if defined(__linux__)
+			if (info->facilities & CPUINFO_TRACE_INTEL_PT) {
+				cpuinfo_linux_parse_small_file(PMU_DEVICES_DIRNAME "/intel_pt/type", PMU_TYPE_FILESIZE, uint32_parser,
+					&info->trace_perf_type);
+			}
+			/* perf_event knows the depth of model-specific LBR of Intel cores from their model */
+			if (info->branch_records == 0 && processor->core->vendor == cpuinfo_vendor_intel &&
+				cpuinfo_linux_parse_small_file(PMU_DEVICES_DIRNAME "/cpu/caps/branches", PMU_TYPE_FILESIZE,
+					uint32_parser, &info->branch_records) && info->branch_records != 0)
+			{
+				info->facilities |= CPUINFO_TRACE_LBR;
+			}
+		#endif
+		return true;
+	#elif (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+		query_arm_trace(processor, info);
+		return true;
+	#else
+		return false;
+	#endif
+}
@@ -0,0 +1,190 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && !CPUINFO_MOCK
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && !CPUINFO_MOCK
+	#define CPUINFO_PREFETCHER_MSR 1
+
+	#define MSR_FILENAME_SIZE (sizeof("/dev/cpu/4294967295/msr"))
+	#define MSR_FILENAME_FORMAT "/dev/cpu/%" PRIu32 "/msr"
+
+	/* MISC_FEATURE_CONTROL of Intel cores since Nehalem: set bits disable the prefetchers */
+	#define MSR_INTEL_MISC_FEATURE_CONTROL UINT32_C(0x000001A4)
+	#define INTEL_DISABLE_L2_STREAM        UINT64_C(0x0000000000000001)
+	#define INTEL_DISABLE_L2_ADJACENT_LINE UINT64_C(0x0000000000000002)
+	#define INTEL_DISABLE_L1D_STREAM       UINT64_C(0x0000000000000004)
+	#define INTEL_DISABLE_L1D_STRIDE       UINT64_C(0x0000000000000008)
+
+	/* PrefetchControl of AMD Zen 4 cores: set bits disable the prefetchers */
+	#define MSR_AMD_PREFETCH_CONTROL UINT32_C(0xC0000108)
+	#define AMD_DISABLE_L1D_STREAM   UINT64_C(0x0000000000000001)
+	#define AMD_DISABLE_L1D_STRIDE   UINT64_C(0x0000000000000002)
+	#define AMD_DISABLE_L1D_REGION   UINT64_C(0x0000000000000004)
+	#define AMD_DISABLE_L2_STREAM    UINT64_C(0x0000000000000008)
+	#define AMD_DISABLE_L2_UP_DOWN   UINT64_C(0x0000000000000020)
+
+	#if !defined(O_CLOEXEC)
+		#define O_CLOEXEC 0
+	#endif
+#else
+	#define CPUINFO_PREFETCHER_MSR 0
+#endif
+
+struct cpuinfo_prefetchers cpuinfo_decode_default_prefetchers(const struct cpuinfo_core* core) {
+	switch (core->vendor) {
+		case cpuinfo_vendor_intel:
+			/* Intel cores since Core 2 and Pentium 4 ship with the L1 and L2 prefetchers enabled */
+			if ((core->uarch >= cpuinfo_uarch_conroe && core->uarch <= cpuinfo_uarch_lion_cove) ||
+				core->uarch == cpuinfo_uarch_willamette || core->uarch == cpuinfo_uarch_prescott)
+			{
+				return (struct cpuinfo_prefetchers) {
+					.source = cpuinfo_prefetchers_source_defaults,
+					.l2_stream = true,
+					.l2_adjacent_line = true,
+					.l1d_stream = true,
+					.l1d_stride = true,
+				};
+			}
+			break;
+		case cpuinfo_vendor_amd:
+			if (core->uarch >= cpuinfo_uarch_zen && core->uarch <= cpuinfo_uarch_zen4) {
+				return (struct cpuinfo_prefetchers) {
+					.source = cpuinfo_prefetchers_source_defaults,
+					.l2_stream = true,
+					.l2_up_down = true,
+					.l1d_stream = true,
+					.l1d_stride = true,
+					.l1d_region = true,
+				};
+			}
+			break;
+		default:
+			break;
+	}
+	return (struct cpuinfo_prefetchers) { .source = cpuinfo_prefetchers_source_unknown };
+}
+
+#if CPUINFO_PREFETCHER_MSR
+	static bool read_msr(uint32_t linux_id, uint32_t msr, uint64_t value[restrict static 1]) {
+		char filename[MSR_FILENAME_SIZE];
+		snprintf(filename, MSR_FILENAME_SIZE, MSR_FILENAME_FORMAT, linux_id);
+		const int file = open(filename, O_RDONLY | O_CLOEXEC);
+		if (file == -1) {
+			cpuinfo_log_debug("failed to open %s: %s", filename, strerror(errno));
+			return false;
+		}
+		const bool status = pread(file, value, sizeof(uint64_t), (off_t) msr) == sizeof(uint64_t);
+		if (!status) {
+			cpuinfo_log_debug("failed to read MSR 0x%08"PRIx32" from %s: %s", msr, filename, strerror(errno));
+		}
+		close(file);
+		return status;
+	}
+
+	/* Overwrite the defaults with the prefetcher controls of the core; returns false if they are not readable */
+	static bool read_prefetcher_controls(const struct cpuinfo_processor* processor,
+		struct cpuinfo_prefetchers prefetchers[restrict static 1])
+	{
+		const struct cpuinfo_core* core = processor->core;
+		uint64_t controls = 0;
+		if (core->vendor == cpuinfo_vendor_intel && core->uarch >= cpuinfo_uarch_nehalem &&
+			core->uarch <= cpuinfo_uarch_lion_cove)
+		{
+			if (!read_msr((uint32_t) processor->linux_id, MSR_INTEL_MISC_FEATURE_CONTROL, &controls)) {
+				return false;
+			}
+			prefetchers->l2_stream = !(controls & INTEL_DISABLE_L2_STREAM);
+			prefetchers->l2_adjacent_line = !(controls & INTEL_DISABLE_L2_ADJACENT_LINE);
+			prefetchers->l1d_stream = !(controls & INTEL_DISABLE_L1D_STREAM);
+			prefetchers->l1d_stride = !(controls & INTEL_DISABLE_L1D_STRIDE);
+		} else if (core->vendor == cpuinfo_vendor_amd && core->uarch == cpuinfo_uarch_zen4) {
+			if (!read_msr((uint32_t) processor->linux_id, MSR_AMD_PREFETCH_CONTROL, &controls)) {
+				return false;
+			}
+			prefetchers->l2_stream = !(controls & AMD_DISABLE_L2_STREAM);
+			prefetchers->l2_up_down = !(controls & AMD_DISABLE_L2_UP_DOWN);
+			prefetchers->l1d_stream = !(controls & AMD_DISABLE_L1D_STREAM);
+			prefetchers->l1d_stride = !(controls & AMD_DISABLE_L1D_STRIDE);
+			prefetchers->l1d_region = !(controls & AMD_DISABLE_L1D_REGION);
+		} else {
+			return false;
+		}
+		prefetchers->source = cpuinfo_prefetchers_source_msr;
+		return true;
+	}
+#endif
+
+void cpuinfo_detect_prefetchers(struct cpuinfo_tables* tables) {
+	struct cpuinfo_prefetchers system = { .source = cpuinfo_prefetchers_source_unknown };
+	#if CPUINFO_PREFETCHER_MSR
+		/* Without privileges the first open fails, and other cores are not tried */
+		bool msr_readable = true;
+	#endif
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		const struct cpuinfo_core* core = &tables->cores[i];
+		struct cpuinfo_prefetchers prefetchers = cpuinfo_decode_default_prefetchers(core);
+		if (prefetchers.source == cpuinfo_prefetchers_source_unknown) {
+			continue;
+		}
+		#if CPUINFO_PREFETCHER_MSR
+			if (msr_readable && core->processor_start < tables->processors_count) {
+				msr_readable = read_prefetcher_controls(&tables->processors[core->processor_start], &prefetchers);
+			}
+		#endif
+		if (system.source == cpuinfo_prefetchers_source_unknown || prefetchers.source < system.source) {
+			system.source = prefetchers.source;
+		}
+		system.l2_stream |= prefetchers.l2_stream;
+		system.l2_adjacent_line |= prefetchers.l2_adjacent_line;
+		system.l2_up_down |= prefetchers.l2_up_down;
+		system.l1d_stream |= prefetchers.l1d_stream;
+		system.l1d_stride |= prefetchers.l1d_stride;
+		system.l1d_region |= prefetchers.l1d_region;
+	}
+	tables->prefetchers = system;
+	cpuinfo_log_debug("prefetchers from %s: L2 stream %d, L2 adjacent line %d, L1D stream %d, L1D stride %d",
+		system.source == cpuinfo_prefetchers_source_msr ? "MSRs" : "defaults",
+		(int) system.l2_stream, (int) system.l2_adjacent_line, (int) system.l1d_stream, (int) system.l1d_stride);
+}
+
+bool CPUINFO_ABI cpuinfo_get_core_prefetchers(uint32_t core_index, struct cpuinfo_prefetchers* prefetchers) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("core_prefetchers");
+	if CPUINFO_UNLIKELY(prefetchers == NULL) {
+		return false;
+	}
+	if CPUINFO_UNLIKELY(core_index >= tables->cores_count) {
+		*prefetchers = (struct cpuinfo_prefetchers) { .source = cpuinfo_prefetchers_source_unknown };
+		return false;
+	}
+	const struct cpuinfo_core* core = &tables->cores[core_index];
+	*prefetchers = cpuinfo_decode_default_prefetchers(core);
+	#if CPUINFO_PREFETCHER_MSR
+		if (prefetchers->source != cpuinfo_prefetchers_source_unknown &&
+			core->processor_start < tables->processors_count)
+		{
+			read_prefetcher_controls(&tables->processors[core->processor_start], prefetchers);
+		}
+	#endif
+	return true;
+}
+
+void CPUINFO_ABI cpuinfo_get_prefetchers(struct cpuinfo_prefetchers* prefetchers) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("prefetchers");
+	if CPUINFO_UNLIKELY(prefetchers == NULL) {
+		return;
+	}
+	*prefetchers = tables->prefetchers;
+}
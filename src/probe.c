@@ -0,0 +1,581 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+const struct cpuinfo_memory_performance* cpuinfo_memory_performance = NULL;
+
+static inline const struct cpuinfo_memory_performance* load_memory_performance(const struct cpuinfo_tables* tables) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (const struct cpuinfo_memory_performance*) ReadPointerAcquire((PVOID volatile*) &tables->memory_performance);
+#else
+	return __atomic_load_n(&tables->memory_performance, __ATOMIC_ACQUIRE);
+#endif
+}
+
+const struct cpuinfo_memory_performance* CPUINFO_ABI cpuinfo_get_uarch_memory_performance(uint32_t uarch_index) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_memory_performance");
+	if CPUINFO_UNLIKELY(uarch_index >= tables->uarchs_count) {
+		return NULL;
+	}
+	const struct cpuinfo_memory_performance* memory_performance = load_memory_performance(tables);
+	if (memory_performance == NULL) {
+		return NULL;
+	}
+	return &memory_performance[uarch_index];
+}
+
+/* Parameters of bandwidth estimates without measurements, as documented for cpuinfo_bandwidth_hint */
+#define ESTIMATE_ROB_ENTRIES_PER_MISS 16
+#define ESTIMATE_MIN_OUTSTANDING_MISSES 8
+#define ESTIMATE_MAX_OUTSTANDING_MISSES 32
+#define ESTIMATE_MEMORY_LATENCY_NS 100
+#define ESTIMATE_CORES_PER_CHANNEL 4
+#define ESTIMATE_MIN_CHANNELS 2
+#define ESTIMATE_MAX_CHANNELS 12
+#define ESTIMATE_CHANNEL_BANDWIDTH UINT64_C(25600000000)
+
+/* Memory read bandwidth of one core by Little's law, in bytes per second */
+static uint64_t estimate_core_bandwidth(const struct cpuinfo_tables* tables, const struct cpuinfo_core* core) {
+	const struct cpuinfo_processor* processor = &tables->processors[core->processor_start];
+	uint32_t line_size = 64;
+	if (processor->cache.l1d != NULL && processor->cache.l1d->line_size != 0) {
+		line_size = processor->cache.l1d->line_size;
+	}
+	uint32_t outstanding_misses = ESTIMATE_MIN_OUTSTANDING_MISSES;
+	const struct cpuinfo_uarch_cost_model* cost_model = cpuinfo_get_uarch_cost_model(core->uarch);
+	if (cost_model != NULL && cost_model->rob_size / ESTIMATE_ROB_ENTRIES_PER_MISS > outstanding_misses) {
+		outstanding_misses = cost_model->rob_size / ESTIMATE_ROB_ENTRIES_PER_MISS;
+		if (outstanding_misses > ESTIMATE_MAX_OUTSTANDING_MISSES) {
+			outstanding_misses = ESTIMATE_MAX_OUTSTANDING_MISSES;
+		}
+	}
+	return (uint64_t) line_size * outstanding_misses * UINT64_C(1000000000) / ESTIMATE_MEMORY_LATENCY_NS;
+}
+
+/* Memory bandwidth of the package by the number of memory channels, in bytes per second */
+static uint64_t estimate_package_bandwidth(const struct cpuinfo_package* package) {
+	uint32_t channels = (package->core_count + ESTIMATE_CORES_PER_CHANNEL - 1) / ESTIMATE_CORES_PER_CHANNEL;
+	if (channels < ESTIMATE_MIN_CHANNELS) {
+		channels = ESTIMATE_MIN_CHANNELS;
+	} else if (channels > ESTIMATE_MAX_CHANNELS) {
+		channels = ESTIMATE_MAX_CHANNELS;
+	}
+	return channels * ESTIMATE_CHANNEL_BANDWIDTH;
+}
+
+/*
+ * Bandwidth hint for cores of logical processors in [processor_start, processor_start + processor_count) which are
+ * on the NUMA node, or in the package.
+ */
+static bool get_bandwidth_hint(const struct cpuinfo_tables* tables, uint32_t processor_start, uint32_t processor_count,
+	const struct cpuinfo_numa_node* numa_node, const struct cpuinfo_package* package,
+	struct cpuinfo_bandwidth_hint* hint)
+{
+	if CPUINFO_UNLIKELY(hint == NULL || processor_count == 0) {
+		return false;
+	}
+	uint32_t* uarch_cores = calloc(2 * (size_t) tables->uarchs_count, sizeof(uint32_t));
+	if (uarch_cores == NULL) {
+		cpuinfo_log_error("failed to allocate core counts of %"PRIu32" microarchitectures", tables->uarchs_count);
+		return false;
+	}
+	/* Cores of every microarchitecture in the domain, followed by cores of every microarchitecture in total */
+	uint32_t* total_uarch_cores = uarch_cores + tables->uarchs_count;
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[tables->cores[i].processor_start];
+		total_uarch_cores[cpuinfo_get_processor_uarch_index(tables, processor)] += 1;
+	}
+
+	uint32_t cores_count = 0;
+	uint64_t estimated_memory_bandwidth = 0, estimated_thread_bandwidth = 0;
+	for (uint32_t i = processor_start; i < processor_start + processor_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		const struct cpuinfo_core* core = processor->core;
+		if ((numa_node != NULL && processor->numa_node != numa_node) ||
+			(package != NULL && processor->package != package) ||
+			processor != &tables->processors[core->processor_start])
+		{
+			continue;
+		}
+		cores_count += 1;
+		uarch_cores[cpuinfo_get_processor_uarch_index(tables, processor)] += 1;
+		estimated_memory_bandwidth += estimate_package_bandwidth(processor->package) / processor->package->core_count;
+		estimated_thread_bandwidth += estimate_core_bandwidth(tables, core);
+	}
+	if (cores_count == 0) {
+		free(uarch_cores);
+		return false;
+	}
+
+	const struct cpuinfo_memory_performance* memory_performance = load_memory_performance(tables);
+	uint64_t memory_bandwidth = 0, thread_bandwidth = 0;
+	for (uint32_t i = 0; memory_performance != NULL && i < tables->uarchs_count; i++) {
+		if (uarch_cores[i] == 0) {
+			continue;
+		}
+		if (memory_performance[i].memory_bandwidth == 0 || memory_performance[i].all_cores_memory_bandwidth == 0) {
+			memory_performance = NULL;
+			break;
+		}
+		/* Cores of every microarchitecture can saturate memory on their own */
+		const uint64_t uarch_memory_bandwidth = (uint64_t) ((double) memory_performance[i].all_cores_memory_bandwidth *
+			(double) uarch_cores[i] / (double) total_uarch_cores[i]);
+		if (uarch_memory_bandwidth > memory_bandwidth) {
+			memory_bandwidth = uarch_memory_bandwidth;
+		}
+		thread_bandwidth += memory_performance[i].memory_bandwidth * uarch_cores[i];
+	}
+	if (memory_performance == NULL) {
+		memory_bandwidth = estimated_memory_bandwidth;
+		thread_bandwidth = estimated_thread_bandwidth;
+	}
+	thread_bandwidth /= cores_count;
+	free(uarch_cores);
+
+	uint64_t saturating_threads = (memory_bandwidth + thread_bandwidth - 1) / thread_bandwidth;
+	if (saturating_threads == 0) {
+		saturating_threads = 1;
+	} else if (saturating_threads > cores_count) {
+		saturating_threads = cores_count;
+	}
+	*hint = (struct cpuinfo_bandwidth_hint) {
+		.saturating_threads = (uint32_t) saturating_threads,
+		.cores_count = cores_count,
+		.memory_bandwidth = memory_bandwidth,
+		.thread_bandwidth = thread_bandwidth,
+		.measured = memory_performance != NULL,
+	};
+	cpuinfo_log_debug("%s memory bandwidth %"PRIu64" MB/s of %"PRIu32" cores, %"PRIu64" MB/s per thread: "
+		"%"PRIu32" threads saturate it", hint->measured ? "measured" : "estimated", memory_bandwidth / 1000000,
+		cores_count, thread_bandwidth / 1000000, hint->saturating_threads);
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_get_numa_node_bandwidth_hint(const struct cpuinfo_numa_node* numa_node,
+	struct cpuinfo_bandwidth_hint* hint)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("numa_node_bandwidth_hint");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(numa_node, tables->numa_nodes, tables->numa_nodes_count,
+			sizeof(struct cpuinfo_numa_node), &index))
+	{
+		return false;
+	}
+	return get_bandwidth_hint(tables, numa_node->processor_start, numa_node->processor_count, numa_node, NULL, hint);
+}
+
+bool CPUINFO_ABI cpuinfo_get_package_bandwidth_hint(const struct cpuinfo_package* package,
+	struct cpuinfo_bandwidth_hint* hint)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("package_bandwidth_hint");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(package, tables->packages, tables->packages_count,
+			sizeof(struct cpuinfo_package), &index))
+	{
+		return false;
+	}
+	return get_bandwidth_hint(tables, package->processor_start, package->processor_count, NULL, package, hint);
+}
+
+#if defined(__linux__)
+	#define SIZE_C(value) ((size_t) (value))
+	/* Number of dependent loads in one latency measurement from caches and from memory */
+	#define CACHE_LATENCY_LOADS (UINT32_C(1) << 20)
+	#define MEMORY_LATENCY_LOADS (UINT32_C(1) << 18)
+	/* Minimum number of bytes read in one bandwidth measurement */
+	#define BANDWIDTH_BYTES (UINT64_C(256) << 20)
+	/* Every measurement is repeated, and the fastest repetition is reported */
+	#define REPETITIONS 3
+	/* Working set for memory measurements is at least this size, and twice the size of the largest cache */
+	#define MIN_MEMORY_WORKING_SET (SIZE_C(32) << 20)
+	/* Working set of every thread in all-core bandwidth measurements is at least this size */
+	#define MIN_THREAD_WORKING_SET (SIZE_C(4) << 20)
+	#define DEFAULT_LINE_SIZE 64
+
+	enum memory_level {
+		memory_level_l1d = 0,
+		memory_level_l2 = 1,
+		memory_level_l3 = 2,
+		memory_level_memory = 3,
+		memory_level_max = 4,
+	};
+
+	/* Prevents the compiler from eliminating loads whose results are otherwise unused */
+	static volatile uintptr_t probe_sink;
+
+	static inline uint64_t xorshift64(uint64_t state[restrict static 1]) {
+		uint64_t x = *state;
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		return *state = x;
+	}
+
+	/* Link cache lines of the buffer into a single random cycle, with Sattolo's algorithm */
+	static void link_random_cycle(void* buffer, size_t size, size_t line_size, uint32_t* order) {
+		const uint32_t lines_count = (uint32_t) (size / line_size);
+		for (uint32_t i = 0; i < lines_count; i++) {
+			order[i] = i;
+		}
+		uint64_t state = UINT64_C(0x9E3779B97F4A7C15);
+		for (uint32_t i = lines_count - 1; i > 0; i--) {
+			const uint32_t j = (uint32_t) (xorshift64(&state) % i);
+			const uint32_t swap = order[i];
+			order[i] = order[j];
+			order[j] = swap;
+		}
+		char* base = (char*) buffer;
+		for (uint32_t i = 0; i < lines_count; i++) {
+			void** line = (void**) (base + (size_t) order[i] * line_size);
+			*line = base + (size_t) order[(i + 1) % lines_count] * line_size;
+		}
+	}
+
+	/* Average latency of dependent loads in the cycle, in picoseconds */
+	static uint32_t measure_latency(void* buffer, size_t size, size_t line_size, uint32_t loads) {
+		uint32_t* order = malloc((size / line_size) * sizeof(uint32_t));
+		if (order == NULL) {
+			cpuinfo_log_warning("failed to allocate %zu bytes for permutation of cache lines",
+				(size / line_size) * sizeof(uint32_t));
+			return 0;
+		}
+		link_random_cycle(buffer, size, line_size, order);
+		free(order);
+
+		void** pointer = (void**) buffer;
+		/* Warm up caches and TLB with one pass over the cycle */
+		for (size_t i = 0; i < size / line_size; i++) {
+			pointer = (void**) *pointer;
+		}
+		uint64_t min_time = UINT64_MAX;
+		for (uint32_t repetition = 0; repetition < REPETITIONS; repetition++) {
+			const uint64_t start = cpuinfo_get_timestamp_ns();
+			for (uint32_t i = 0; i < loads; i += 8) {
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+				pointer = (void**) *pointer;
+			}
+			const uint64_t time = cpuinfo_get_timestamp_ns() - start;
+			if (time < min_time) {
+				min_time = time;
+			}
+		}
+		probe_sink = (uintptr_t) pointer;
+		const uint64_t latency = min_time * UINT64_C(1000) / loads;
+		return latency > UINT32_MAX ? UINT32_MAX : (uint32_t) latency;
+	}
+
+	/* Read the buffer the number of times, and return the time in nanoseconds */
+	static uint64_t stream_buffer(const void* buffer, size_t size, uint64_t passes) {
+		const uint64_t* words = (const uint64_t*) buffer;
+		const size_t words_count = size / sizeof(uint64_t);
+		uint64_t sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+		const uint64_t start = cpuinfo_get_timestamp_ns();
+		for (uint64_t pass = 0; pass < passes; pass++) {
+			for (size_t i = 0; i + 4 <= words_count; i += 4) {
+				sum0 += words[i];
+				sum1 += words[i + 1];
+				sum2 += words[i + 2];
+				sum3 += words[i + 3];
+			}
+		}
+		const uint64_t time = cpuinfo_get_timestamp_ns() - start;
+		probe_sink = (uintptr_t) (sum0 + sum1 + sum2 + sum3);
+		return time != 0 ? time : 1;
+	}
+
+	static uint64_t get_passes(size_t size) {
+		const uint64_t passes = BANDWIDTH_BYTES / size;
+		return passes != 0 ? passes : 1;
+	}
+
+	/* Read bandwidth of the buffer, in bytes per second */
+	static uint64_t measure_bandwidth(const void* buffer, size_t size) {
+		const uint64_t passes = get_passes(size);
+		/* Warm up caches and TLB */
+		stream_buffer(buffer, size, 1);
+		uint64_t min_time = UINT64_MAX;
+		for (uint32_t repetition = 0; repetition < REPETITIONS; repetition++) {
+			const uint64_t time = stream_buffer(buffer, size, passes);
+			if (time < min_time) {
+				min_time = time;
+			}
+		}
+		return (uint64_t) ((double) size * (double) passes * 1.0e+9 / (double) min_time);
+	}
+
+	struct probe_context {
+		const struct cpuinfo_processor* processor;
+		/* Working set size for every memory level, or 0 if there is no such level */
+		size_t working_set_sizes[memory_level_max];
+		size_t line_size;
+		struct cpuinfo_memory_performance* performance;
+		bool status;
+	};
+
+	static void* probe_processor(void* parameter) {
+		struct probe_context* context = (struct probe_context*) parameter;
+		if (!cpuinfo_pin_current_thread_to_processor(context->processor)) {
+			cpuinfo_log_warning("failed to pin memory probe thread to processor %d: measurements may be skewed",
+				context->processor->linux_id);
+		}
+
+		const size_t buffer_size = context->working_set_sizes[memory_level_memory];
+		void* buffer = NULL;
+		if (posix_memalign(&buffer, 4096, buffer_size) != 0) {
+			cpuinfo_log_error("failed to allocate %zu bytes for memory probe", buffer_size);
+			return NULL;
+		}
+		/* Touch every page before measurements */
+		memset(buffer, 0, buffer_size);
+
+		uint32_t latencies[memory_level_max] = { 0 };
+		uint64_t bandwidths[memory_level_max] = { 0 };
+		for (uint32_t level = 0; level < memory_level_max; level++) {
+			const size_t size = context->working_set_sizes[level];
+			if (size == 0) {
+				continue;
+			}
+			bandwidths[level] = measure_bandwidth(buffer, size);
+			latencies[level] = measure_latency(buffer, size, context->line_size,
+				level == memory_level_memory ? MEMORY_LATENCY_LOADS : CACHE_LATENCY_LOADS);
+		}
+		free(buffer);
+
+		*context->performance = (struct cpuinfo_memory_performance) {
+			.l1d_latency = latencies[memory_level_l1d],
+			.l2_latency = latencies[memory_level_l2],
+			.l3_latency = latencies[memory_level_l3],
+			.memory_latency = latencies[memory_level_memory],
+			.l1d_bandwidth = bandwidths[memory_level_l1d],
+			.l2_bandwidth = bandwidths[memory_level_l2],
+			.l3_bandwidth = bandwidths[memory_level_l3],
+			.memory_bandwidth = bandwidths[memory_level_memory],
+		};
+		context->status = true;
+		return NULL;
+	}
+
+	/* Start of all-core streaming: threads report readiness, and start together when the flag is set */
+	struct stream_start {
+		uint32_t ready_count;
+		bool go;
+		bool cancel;
+	};
+
+	struct stream_context {
+		const struct cpuinfo_processor* processor;
+		struct stream_start* start_state;
+		size_t size;
+		uint64_t start;
+		uint64_t end;
+		bool status;
+	};
+
+	static void* stream_processor(void* parameter) {
+		struct stream_context* context = (struct stream_context*) parameter;
+		cpuinfo_pin_current_thread_to_processor(context->processor);
+		void* buffer = NULL;
+		if (posix_memalign(&buffer, 4096, context->size) == 0) {
+			memset(buffer, 0, context->size);
+			context->status = true;
+		}
+		__atomic_fetch_add(&context->start_state->ready_count, 1, __ATOMIC_RELEASE);
+		while (!__atomic_load_n(&context->start_state->go, __ATOMIC_ACQUIRE)) {
+			sched_yield();
+		}
+		if (context->status && !context->start_state->cancel) {
+			context->start = cpuinfo_get_timestamp_ns();
+			stream_buffer(buffer, context->size, get_passes(context->size));
+			context->end = cpuinfo_get_timestamp_ns();
+		} else {
+			context->status = false;
+		}
+		free(buffer);
+		return NULL;
+	}
+
+	/* Total memory read bandwidth of threads on the first logical processors of all cores of the microarchitecture */
+	static uint64_t measure_all_cores_bandwidth(const struct cpuinfo_tables* tables, uint32_t uarch_index,
+		size_t memory_size)
+	{
+		uint32_t threads_count = 0;
+		for (uint32_t i = 0; i < tables->cores_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[tables->cores[i].processor_start];
+			threads_count += (uint32_t) (cpuinfo_get_processor_uarch_index(tables, processor) == uarch_index);
+		}
+		if (threads_count == 0) {
+			return 0;
+		}
+		struct stream_context* contexts = calloc(threads_count, sizeof(struct stream_context));
+		pthread_t* threads = calloc(threads_count, sizeof(pthread_t));
+		if (contexts == NULL || threads == NULL) {
+			cpuinfo_log_error("failed to allocate contexts for %"PRIu32" memory probe threads", threads_count);
+			free(contexts);
+			free(threads);
+			return 0;
+		}
+
+		size_t thread_size = memory_size / threads_count;
+		if (thread_size < MIN_THREAD_WORKING_SET) {
+			thread_size = MIN_THREAD_WORKING_SET;
+		}
+		thread_size -= thread_size % (4 * sizeof(uint64_t));
+		struct stream_start start_state = { 0 };
+		uint32_t thread_index = 0;
+		for (uint32_t i = 0; i < tables->cores_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[tables->cores[i].processor_start];
+			if (cpuinfo_get_processor_uarch_index(tables, processor) == uarch_index) {
+				contexts[thread_index++] = (struct stream_context) {
+					.processor = processor,
+					.start_state = &start_state,
+					.size = thread_size,
+				};
+			}
+		}
+
+		uint32_t started_count = 0;
+		for (; started_count < threads_count; started_count++) {
+			if (pthread_create(&threads[started_count], NULL, stream_processor, &contexts[started_count]) != 0) {
+				cpuinfo_log_error("failed to create memory probe thread %"PRIu32, started_count);
+				start_state.cancel = true;
+				break;
+			}
+		}
+		/* Buffers of all threads are allocated before any thread starts streaming */
+		while (__atomic_load_n(&start_state.ready_count, __ATOMIC_ACQUIRE) != started_count) {
+			sched_yield();
+		}
+		__atomic_store_n(&start_state.go, true, __ATOMIC_RELEASE);
+		for (uint32_t i = 0; i < started_count; i++) {
+			pthread_join(threads[i], NULL);
+		}
+
+		uint64_t bandwidth = 0;
+		uint64_t start = UINT64_MAX, end = 0, bytes = 0;
+		for (uint32_t i = 0; i < started_count; i++) {
+			if (contexts[i].status) {
+				start = contexts[i].start < start ? contexts[i].start : start;
+				end = contexts[i].end > end ? contexts[i].end : end;
+				bytes += contexts[i].size * get_passes(contexts[i].size);
+			}
+		}
+		if (end > start) {
+			bandwidth = (uint64_t) ((double) bytes * 1.0e+9 / (double) (end - start));
+		}
+		free(contexts);
+		free(threads);
+		return bandwidth;
+	}
+
+	/* Measure the memory hierarchy from the first logical processor of the microarchitecture */
+	static bool probe_uarch(const struct cpuinfo_tables* tables, uint32_t uarch_index,
+		struct cpuinfo_memory_performance performance[restrict static 1])
+	{
+		const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+		if (processor == NULL) {
+			return false;
+		}
+		struct probe_context context = {
+			.processor = processor,
+			.line_size = DEFAULT_LINE_SIZE,
+			.performance = performance,
+		};
+		/* Working sets are halfway between capacities of adjacent levels */
+		const struct cpuinfo_cache* caches[memory_level_memory] = {
+			processor->cache.l1d, processor->cache.l2, processor->cache.l3
+		};
+		size_t previous_size = 0;
+		for (uint32_t level = 0; level < memory_level_memory; level++) {
+			if (caches[level] != NULL && caches[level]->size > previous_size) {
+				context.working_set_sizes[level] = (previous_size + caches[level]->size) / 2;
+				previous_size = caches[level]->size;
+			}
+		}
+		if (processor->cache.l1d != NULL && processor->cache.l1d->line_size != 0) {
+			context.line_size = processor->cache.l1d->line_size;
+		}
+		const struct cpuinfo_cache* last_level_cache = cpuinfo_get_last_level_cache(processor);
+		size_t memory_size = MIN_MEMORY_WORKING_SET;
+		if (last_level_cache != NULL && 2 * (size_t) last_level_cache->size > memory_size) {
+			memory_size = 2 * (size_t) last_level_cache->size;
+		}
+		context.working_set_sizes[memory_level_memory] = memory_size;
+		for (uint32_t level = 0; level < memory_level_max; level++) {
+			/* Whole cache lines, and whole groups of words for streaming */
+			context.working_set_sizes[level] -= context.working_set_sizes[level] % (context.line_size * 4);
+		}
+
+		/* The measurement runs in a separate thread to keep the affinity of the calling thread */
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, probe_processor, &context) != 0) {
+			cpuinfo_log_error("failed to create memory probe thread");
+			return false;
+		}
+		pthread_join(thread, NULL);
+		if (!context.status) {
+			return false;
+		}
+		performance->all_cores_memory_bandwidth = measure_all_cores_bandwidth(tables, uarch_index, memory_size);
+		cpuinfo_log_debug("uarch %"PRIu32": latency %"PRIu32"/%"PRIu32"/%"PRIu32"/%"PRIu32" ps, "
+			"bandwidth %"PRIu64"/%"PRIu64"/%"PRIu64"/%"PRIu64" MB/s, all cores %"PRIu64" MB/s",
+			uarch_index, performance->l1d_latency, performance->l2_latency, performance->l3_latency,
+			performance->memory_latency, performance->l1d_bandwidth / 1000000, performance->l2_bandwidth / 1000000,
+			performance->l3_bandwidth / 1000000, performance->memory_bandwidth / 1000000,
+			performance->all_cores_memory_bandwidth / 1000000);
+		return true;
+	}
+
+	bool CPUINFO_ABI cpuinfo_probe_memory_performance(void) {
+		cpuinfo_get_tables("probe_memory_performance");
+		cpuinfo_lock_initialization();
+		struct cpuinfo_tables* tables = cpuinfo_load_tables();
+		bool status = tables != NULL && tables->memory_performance != NULL;
+		if (tables != NULL && !status) {
+			struct cpuinfo_memory_performance* memory_performance =
+				calloc(tables->uarchs_count, sizeof(struct cpuinfo_memory_performance));
+			if (memory_performance == NULL) {
+				cpuinfo_log_error("failed to allocate %zu bytes for memory performance of %"PRIu32" microarchitectures",
+					tables->uarchs_count * sizeof(struct cpuinfo_memory_performance), tables->uarchs_count);
+				goto unlock;
+			}
+			for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+				if (!probe_uarch(tables, i, &memory_performance[i])) {
+					cpuinfo_log_error("failed to measure memory performance of microarchitecture %"PRIu32, i);
+					free(memory_performance);
+					goto unlock;
+				}
+			}
+			tables->memory_performance_memory = memory_performance;
+			__atomic_store_n(&tables->memory_performance, memory_performance, __ATOMIC_RELEASE);
+			status = true;
+		}
+	unlock:
+		cpuinfo_unlock_initialization();
+		return status;
+	}
+#else
+	bool CPUINFO_ABI cpuinfo_probe_memory_performance(void) {
+		cpuinfo_get_tables("probe_memory_performance");
+		cpuinfo_log_info("memory performance probe is not supported on this platform");
+		return false;
+	}
+#endif
@@ -0,0 +1,245 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <string.h>
+	#include <time.h>
+	#include <unistd.h>
+
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	/* Status of the last command to resctrl: the file exists only while resctrl is mounted */
+	#define RESCTRL_STATUS_FILENAME "/sys/fs/resctrl/info/last_cmd_status"
+	#define RESCTRL_STATUS_FILESIZE 256
+
+	static bool status_parser(const char* text_start, const char* text_end, void* context) {
+		return true;
+	}
+
+	#define RESCTRL_DIRNAME "/sys/fs/resctrl"
+	#define RESCTRL_PATH_MAX 256
+	#define MONITORING_FILESIZE 32
+
+	#if !defined(O_CLOEXEC)
+		#define O_CLOEXEC 0
+	#endif
+
+	/* Files in mon_data/mon_L3_XX, indexed by cpuinfo_llc_monitoring_event */
+	static const char* monitoring_event_filenames[cpuinfo_llc_monitoring_event_max] = {
+		[cpuinfo_llc_monitoring_event_occupancy] = "llc_occupancy",
+		[cpuinfo_llc_monitoring_event_total_bandwidth] = "mbm_total_bytes",
+		[cpuinfo_llc_monitoring_event_local_bandwidth] = "mbm_local_bytes",
+	};
+#endif
+
+/* Monitoring files of an L3 cache, and values of bandwidth counters at the previous sample */
+struct llc_monitoring_domain {
+	int files[cpuinfo_llc_monitoring_event_max];
+	uint64_t last_values[cpuinfo_llc_monitoring_event_max];
+	/* CLOCK_MONOTONIC time of the previous sample, in nanoseconds */
+	uint64_t last_timestamp;
+};
+
+struct cpuinfo_llc_monitoring_sampler {
+	uint32_t domains_count;
+	struct llc_monitoring_domain* domains;
+};
+
+#if defined(__linux__)
+	static uint64_t get_timestamp(void) {
+		struct timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		return (uint64_t) time.tv_sec * UINT64_C(1000000000) + (uint64_t) time.tv_nsec;
+	}
+
+	/* Counters read "Unavailable" while the RMID is not assigned, or "Error" if the hardware fails to read them */
+	static bool read_monitoring_value(int file, uint64_t value[restrict static 1]) {
+		char buffer[MONITORING_FILESIZE];
+		const ssize_t bytes_read = pread(file, buffer, sizeof(buffer), 0);
+		if (bytes_read <= 0 || buffer[0] < '0' || buffer[0] > '9') {
+			return false;
+		}
+		uint64_t parsed_value = 0;
+		for (ssize_t i = 0; i < bytes_read && buffer[i] >= '0' && buffer[i] <= '9'; i++) {
+			parsed_value = parsed_value * 10 + (uint64_t) (buffer[i] - '0');
+		}
+		*value = parsed_value;
+		return true;
+	}
+
+	/* The mon_L3_XX directories are named by the cache/indexK/id of the L3 cache which the first processor shares */
+	static bool get_l3_cache_id(const struct cpuinfo_tables tables[restrict static 1], const struct cpuinfo_cache* cache,
+		uint32_t cache_id[restrict static 1])
+	{
+		if (cache->processor_count == 0 || tables->processors[cache->processor_start].linux_id < 0) {
+			return false;
+		}
+		const uint32_t linux_id = (uint32_t) tables->processors[cache->processor_start].linux_id;
+		for (uint32_t index = 0; index < CPUINFO_LINUX_MAX_CACHE_INDICES; index++) {
+			struct cpuinfo_linux_cache linux_cache;
+			if (!cpuinfo_linux_get_processor_cache(linux_id, index, &linux_cache)) {
+				break;
+			}
+			if (linux_cache.level == 3) {
+				return cpuinfo_linux_get_processor_cache_id(linux_id, index, cache_id);
+			}
+		}
+		return false;
+	}
+#endif
+
+void cpuinfo_detect_resource_control(struct cpuinfo_tables* tables) {
+	struct cpuinfo_resource_control* resource_control = &tables->resource_control;
+	*resource_control = (struct cpuinfo_resource_control) { 0 };
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		cpuinfo_x86_detect_resource_control(resource_control);
+	#endif
+	#if defined(__linux__)
+		resource_control->resctrl_mounted =
+			cpuinfo_linux_parse_small_file(RESCTRL_STATUS_FILENAME, RESCTRL_STATUS_FILESIZE, status_parser, NULL);
+	#endif
+	cpuinfo_log_debug("resource control: %"PRIu32" L2 and %"PRIu32" L3 classes of service, "
+		"%"PRIu32" memory bandwidth classes of service, %"PRIu32" monitoring IDs, resctrl %s",
+		resource_control->l2_allocation.classes_count, resource_control->l3_allocation.classes_count,
+		resource_control->memory_bandwidth_classes_count, resource_control->monitoring_ids_count,
+		resource_control->resctrl_mounted ? "mounted" : "not mounted");
+}
+
+struct cpuinfo_llc_monitoring_sampler* CPUINFO_ABI cpuinfo_create_llc_monitoring_sampler(const char* group) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("llc_monitoring_sampler");
+	#if defined(__linux__)
+		if (!tables->resource_control.resctrl_mounted) {
+			cpuinfo_log_debug("resctrl is not mounted: LLC monitoring is not available");
+			return NULL;
+		}
+		const uint32_t l3_caches_count = tables->cache_count[cpuinfo_cache_level_3];
+		struct cpuinfo_llc_monitoring_sampler* sampler = calloc(1, sizeof(struct cpuinfo_llc_monitoring_sampler));
+		struct llc_monitoring_domain* domains = calloc(l3_caches_count, sizeof(struct llc_monitoring_domain));
+		if (sampler == NULL || (l3_caches_count != 0 && domains == NULL)) {
+			cpuinfo_log_error("failed to allocate LLC monitoring sampler of %"PRIu32" L3 caches", l3_caches_count);
+			free(domains);
+			free(sampler);
+			return NULL;
+		}
+		sampler->domains_count = l3_caches_count;
+		sampler->domains = domains;
+
+		const uint64_t timestamp = get_timestamp();
+		bool opened = false;
+		for (uint32_t i = 0; i < sampler->domains_count; i++) {
+			struct llc_monitoring_domain* domain = &sampler->domains[i];
+			for (uint32_t event = 0; event < cpuinfo_llc_monitoring_event_max; event++) {
+				domain->files[event] = -1;
+			}
+			uint32_t cache_id;
+			if (!get_l3_cache_id(tables, &tables->cache[cpuinfo_cache_level_3][i], &cache_id)) {
+				cpuinfo_log_debug("failed to get ID of L3 cache %"PRIu32, i);
+				continue;
+			}
+			for (uint32_t event = 0; event < cpuinfo_llc_monitoring_event_max; event++) {
+				char path[RESCTRL_PATH_MAX];
+				const int chars_formatted = snprintf(path, sizeof(path), "%s%s%s/mon_data/mon_L3_%02"PRIu32"/%s",
+					RESCTRL_DIRNAME, group != NULL ? "/" : "", group != NULL ? group : "", cache_id,
+					monitoring_event_filenames[event]);
+				if ((unsigned int) chars_formatted >= sizeof(path)) {
+					cpuinfo_log_warning("resctrl group path %s is too long", group);
+					continue;
+				}
+				domain->files[event] = open(path, O_RDONLY | O_CLOEXEC);
+				if (domain->files[event] == -1) {
+					/* Files of events which the processor doesn't support are absent */
+					cpuinfo_log_debug("failed to open %s: %s", path, strerror(errno));
+					continue;
+				}
+				opened = true;
+				/* Without the initial value, the first sample reports no traffic rather than the whole counter */
+				if (event != cpuinfo_llc_monitoring_event_occupancy &&
+					!read_monitoring_value(domain->files[event], &domain->last_values[event]))
+				{
+					domain->last_values[event] = UINT64_MAX;
+				}
+			}
+			domain->last_timestamp = timestamp;
+		}
+		if (!opened) {
+			cpuinfo_log_warning("no readable resctrl monitoring data of L3 caches");
+			cpuinfo_destroy_llc_monitoring_sampler(sampler);
+			return NULL;
+		}
+		return sampler;
+	#else
+		return NULL;
+	#endif
+}
+
+void CPUINFO_ABI cpuinfo_destroy_llc_monitoring_sampler(struct cpuinfo_llc_monitoring_sampler* sampler) {
+	if (sampler == NULL) {
+		return;
+	}
+	#if defined(__linux__)
+		for (uint32_t i = 0; i < sampler->domains_count; i++) {
+			for (uint32_t event = 0; event < cpuinfo_llc_monitoring_event_max; event++) {
+				if (sampler->domains[i].files[event] != -1) {
+					close(sampler->domains[i].files[event]);
+				}
+			}
+		}
+	#endif
+	free(sampler->domains);
+	free(sampler);
+}
+
+bool CPUINFO_ABI cpuinfo_sample_llc_monitoring(struct cpuinfo_llc_monitoring_sampler* sampler,
+	uint32_t l3_index, struct cpuinfo_llc_monitoring_sample* sample)
+{
+	if (sample == NULL) {
+		return false;
+	}
+	*sample = (struct cpuinfo_llc_monitoring_sample) { 0 };
+	if (sampler == NULL || l3_index >= sampler->domains_count) {
+		return false;
+	}
+	#if defined(__linux__)
+		struct llc_monitoring_domain* domain = &sampler->domains[l3_index];
+		const uint64_t timestamp = get_timestamp();
+		sample->interval_ns = timestamp - domain->last_timestamp;
+		domain->last_timestamp = timestamp;
+
+		uint64_t values[cpuinfo_llc_monitoring_event_max] = { 0 };
+		for (uint32_t event = 0; event < cpuinfo_llc_monitoring_event_max; event++) {
+			if (domain->files[event] == -1 || !read_monitoring_value(domain->files[event], &values[event])) {
+				continue;
+			}
+			sample->events |= UINT32_C(1) << event;
+			if (event != cpuinfo_llc_monitoring_event_occupancy) {
+				/* The kernel extends MBM counters to 64 bits; they restart only if the RMID is reassigned */
+				const uint64_t last_value = domain->last_values[event];
+				domain->last_values[event] = values[event];
+				values[event] = values[event] >= last_value ? values[event] - last_value : 0;
+			}
+		}
+		sample->occupancy = values[cpuinfo_llc_monitoring_event_occupancy];
+		sample->total_bytes = values[cpuinfo_llc_monitoring_event_total_bandwidth];
+		sample->local_bytes = values[cpuinfo_llc_monitoring_event_local_bandwidth];
+		if (sample->interval_ns != 0) {
+			sample->total_bandwidth = (uint64_t) ((double) sample->total_bytes * 1.0e+9 / (double) sample->interval_ns);
+			sample->local_bandwidth = (uint64_t) ((double) sample->local_bytes * 1.0e+9 / (double) sample->interval_ns);
+		}
+	#endif
+	return sample->events != 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/common.h>
+
+
+/* JEDEC manufacturer IDs in mvendorid: number of continuation codes in bits 7 and above, and offset in bits 0-6 */
+#define CPUINFO_RISCV_MVENDORID_SIFIVE UINT32_C(0x489)
+#define CPUINFO_RISCV_MVENDORID_THEAD  UINT32_C(0x5B7)
+
+/* Maximum length of the "uarch" value in /proc/cpuinfo, i.e. the compatible string of the CPU in the device tree */
+#define CPUINFO_RISCV_UARCH_NAME_MAX 64
+
+/*
+ * Decode the vendor and microarchitecture of a core from its mvendorid and marchid CSRs, or from the compatible string
+ * of the core in the device tree if the CSRs are zero, as on T-Head cores. The string may be empty.
+ */
+CPUINFO_INTERNAL void cpuinfo_riscv_decode_vendor_uarch(
+	uint32_t mvendorid,
+	uint64_t marchid,
+	const char uarch_name[restrict static CPUINFO_RISCV_UARCH_NAME_MAX],
+	enum cpuinfo_vendor vendor[restrict static 1],
+	enum cpuinfo_uarch uarch[restrict static 1]);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
+#include <riscv/api.h>
+#include <linux/api.h>
+
+
+/* Single-letter extensions: the same bits as in AT_HWCAP, i.e. bit (letter - 'a') */
+#define CPUINFO_RISCV_LINUX_FEATURE_A      UINT64_C(0x0000000000000001)
+#define CPUINFO_RISCV_LINUX_FEATURE_C      UINT64_C(0x0000000000000004)
+#define CPUINFO_RISCV_LINUX_FEATURE_D      UINT64_C(0x0000000000000008)
+#define CPUINFO_RISCV_LINUX_FEATURE_F      UINT64_C(0x0000000000000020)
+#define CPUINFO_RISCV_LINUX_FEATURE_I      UINT64_C(0x0000000000000100)
+#define CPUINFO_RISCV_LINUX_FEATURE_M      UINT64_C(0x0000000000001000)
+#define CPUINFO_RISCV_LINUX_FEATURE_V      UINT64_C(0x0000000000200000)
+#define CPUINFO_RISCV_LINUX_HWCAP_MASK     UINT64_C(0x0000000003FFFFFF)
+/* Multi-letter extensions, which AT_HWCAP doesn't report */
+#define CPUINFO_RISCV_LINUX_FEATURE_ZBA    UINT64_C(0x0000000100000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZBB    UINT64_C(0x0000000200000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZBC    UINT64_C(0x0000000400000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZBS    UINT64_C(0x0000000800000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZICBOZ UINT64_C(0x0000001000000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZICOND UINT64_C(0x0000002000000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZFH    UINT64_C(0x0000004000000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZFHMIN UINT64_C(0x0000008000000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZVBB   UINT64_C(0x0000010000000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZVBC   UINT64_C(0x0000020000000000)
+#define CPUINFO_RISCV_LINUX_FEATURE_ZVFH   UINT64_C(0x0000040000000000)
+
+#define CPUINFO_RISCV_LINUX_VALID_PROCESSOR  UINT32_C(0x00010000)
+#define CPUINFO_RISCV_LINUX_VALID_ISA        UINT32_C(0x00020000)
+#define CPUINFO_RISCV_LINUX_VALID_MVENDORID  UINT32_C(0x00040000)
+#define CPUINFO_RISCV_LINUX_VALID_MARCHID    UINT32_C(0x00080000)
+#define CPUINFO_RISCV_LINUX_VALID_UARCH_NAME UINT32_C(0x00100000)
+#define CPUINFO_RISCV_LINUX_VALID_IDS        UINT32_C(0x000C0000)
+
+struct cpuinfo_riscv_linux_processor {
+	uint32_t flags;
+	uint32_t system_processor_id;
+	/* Extensions listed in the "isa" line of /proc/cpuinfo, as CPUINFO_RISCV_LINUX_FEATURE_* bits */
+	uint64_t features;
+	uint32_t mvendorid;
+	uint64_t marchid;
+	/* Compatible string of the core in the device tree, from the "uarch" line of /proc/cpuinfo */
+	char uarch_name[CPUINFO_RISCV_UARCH_NAME_MAX];
+	enum cpuinfo_vendor vendor;
+	enum cpuinfo_uarch uarch;
+	uint32_t uarch_index;
+	/* ID of the physical package, and the processor with the smallest ID in the package */
+	uint32_t package_id;
+	uint32_t package_leader_id;
+	/* Bitmask of cache/indexK directories in sysfs which are already parsed for this processor */
+	uint32_t sysfs_cache_indices;
+	/* Index plus one of the cache described in sysfs for every cache level, or 0 if sysfs doesn't report it */
+	uint32_t sysfs_cache[cpuinfo_cache_level_max];
+};
+
+CPUINFO_INTERNAL bool cpuinfo_riscv_linux_parse_proc_cpuinfo(
+	uint32_t max_processors_count,
+	struct cpuinfo_riscv_linux_processor processors[restrict static max_processors_count]);
+
+/* Extensions supported by all processors according to the riscv_hwprobe syscall of Linux 6.4+ */
+CPUINFO_INTERNAL bool cpuinfo_riscv_linux_features_from_hwprobe(uint64_t features[restrict static 1]);
+/* mvendorid and marchid of an online processor according to the riscv_hwprobe syscall */
+CPUINFO_INTERNAL bool cpuinfo_riscv_linux_ids_from_hwprobe(
+	uint32_t processor,
+	uint32_t mvendorid[restrict static 1],
+	uint64_t marchid[restrict static 1]);
+/* Single-letter extensions supported by all processors according to AT_HWCAP */
+CPUINFO_INTERNAL bool cpuinfo_riscv_linux_features_from_hwcap(uint64_t features[restrict static 1]);
+
+CPUINFO_INTERNAL void cpuinfo_riscv_linux_decode_isa(
+	uint64_t features,
+	struct cpuinfo_riscv_isa isa[restrict static 1]);
@@ -0,0 +1,316 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <linux/api.h>
+#include <riscv/linux/api.h>
+#include <cpuinfo/log.h>
+
+/*
+ * Size, in chars, of the on-stack buffer used for parsing lines of /proc/cpuinfo.
+ * This is also the limit on the length of a single line.
+ */
+#define BUFFER_SIZE 2048
+
+/*
+ * Keys of /proc/cpuinfo with long values, which are not used: "hart isa" of Linux 6.8+ lists extensions of the hart
+ * including the ones which the kernel doesn't enable for user space, and "isa" is used instead.
+ */
+static const char* const skip_keys[] = { "hart isa", NULL };
+
+
+static uint32_t parse_processor_number(
+	const char* processor_start,
+	const char* processor_end)
+{
+	const size_t processor_length = (size_t) (processor_end - processor_start);
+
+	if (processor_length == 0) {
+		cpuinfo_log_warning("Processor number in /proc/cpuinfo is ignored: string is empty");
+		return 0;
+	}
+
+	uint32_t processor_number = 0;
+	for (const char* digit_ptr = processor_start; digit_ptr != processor_end; digit_ptr++) {
+		const uint32_t digit = (uint32_t) (*digit_ptr - '0');
+		if (digit >= 10) {
+			cpuinfo_log_warning("non-decimal suffix %.*s in /proc/cpuinfo processor number is ignored",
+				(int) (processor_end - digit_ptr), digit_ptr);
+			break;
+		}
+
+		processor_number = processor_number * 10 + digit;
+	}
+
+	return processor_number;
+}
+
+/*
+ * Decode a hexadecimal value with 0x prefix, such as mvendorid and marchid.
+ * Example of the values reported in /proc/cpuinfo:
+ *
+ *		mvendorid	: 0x489
+ *		marchid		: 0x8000000000000007
+ */
+static bool parse_hex(
+	const char* name,
+	const char* value_start,
+	const char* value_end,
+	uint64_t value[restrict static 1])
+{
+	const size_t value_length = (size_t) (value_end - value_start);
+	if (value_length < 3 || value_length > 18 || value_start[0] != '0' || value_start[1] != 'x') {
+		cpuinfo_log_warning("%s %.*s in /proc/cpuinfo is ignored due to unexpected format",
+			name, (int) value_length, value_start);
+		return false;
+	}
+
+	uint64_t result = 0;
+	for (const char* digit_ptr = value_start + 2; digit_ptr != value_end; digit_ptr++) {
+		const char digit_char = *digit_ptr;
+		uint32_t digit;
+		if (digit_char >= '0' && digit_char <= '9') {
+			digit = digit_char - '0';
+		} else if ((uint32_t) (digit_char - 'A') < 6) {
+			digit = 10 + (digit_char - 'A');
+		} else if ((uint32_t) (digit_char - 'a') < 6) {
+			digit = 10 + (digit_char - 'a');
+		} else {
+			cpuinfo_log_warning("%s %.*s in /proc/cpuinfo is ignored due to unexpected non-hex character %c at offset %zu",
+				name, (int) value_length, value_start, digit_char, (size_t) (digit_ptr - value_start));
+			return false;
+		}
+		result = result * 16 + digit;
+	}
+	*value = result;
+	return true;
+}
+
+static uint64_t decode_multi_letter_extension(const char* extension_start, const char* extension_end) {
+	static const struct {
+		const char* name;
+		uint64_t feature;
+	} extensions[] = {
+		{ "zba",    CPUINFO_RISCV_LINUX_FEATURE_ZBA },
+		{ "zbb",    CPUINFO_RISCV_LINUX_FEATURE_ZBB },
+		{ "zbc",    CPUINFO_RISCV_LINUX_FEATURE_ZBC },
+		{ "zbs",    CPUINFO_RISCV_LINUX_FEATURE_ZBS },
+		{ "zicboz", CPUINFO_RISCV_LINUX_FEATURE_ZICBOZ },
+		{ "zicond", CPUINFO_RISCV_LINUX_FEATURE_ZICOND },
+		{ "zfh",    CPUINFO_RISCV_LINUX_FEATURE_ZFH },
+		{ "zfhmin", CPUINFO_RISCV_LINUX_FEATURE_ZFHMIN },
+		{ "zvbb",   CPUINFO_RISCV_LINUX_FEATURE_ZVBB },
+		{ "zvbc",   CPUINFO_RISCV_LINUX_FEATURE_ZVBC },
+		{ "zvfh",   CPUINFO_RISCV_LINUX_FEATURE_ZVFH },
+	};
+
+	const size_t extension_length = (size_t) (extension_end - extension_start);
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(extensions); i++) {
+		if (strlen(extensions[i].name) == extension_length &&
+			memcmp(extension_start, extensions[i].name, extension_length) == 0)
+		{
+			return extensions[i].feature;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Decode the ISA string reported by Linux kernel for RISC-V architecture.
+ * Single-letter extensions follow the base ISA, and multi-letter extensions are separated by underscores:
+ *
+ *		isa		: rv64imafdcv_zicbom_zicboz_zicntr_zicsr_zifencei_zihintpause_zihpm_zba_zbb_zbs
+ */
+static void parse_isa(
+	const char* isa_start,
+	const char* isa_end,
+	struct cpuinfo_riscv_linux_processor processor[restrict static 1])
+{
+	const size_t isa_length = (size_t) (isa_end - isa_start);
+	if (isa_length < 5 || (memcmp(isa_start, "rv32", 4) != 0 && memcmp(isa_start, "rv64", 4) != 0)) {
+		cpuinfo_log_warning("ISA %.*s in /proc/cpuinfo is ignored due to unexpected base ISA",
+			(int) isa_length, isa_start);
+		return;
+	}
+
+	uint64_t features = 0;
+	const char* extension_ptr = isa_start + 4;
+	for (; extension_ptr != isa_end; extension_ptr++) {
+		const char extension = *extension_ptr;
+		if (extension == '_' || extension == 's' || extension == 'x' || extension == 'z') {
+			/* Start of multi-letter extensions */
+			break;
+		} else if (extension == 'g') {
+			/* G is a shorthand for IMAFD with Zicsr and Zifencei */
+			features |= CPUINFO_RISCV_LINUX_FEATURE_I | CPUINFO_RISCV_LINUX_FEATURE_M |
+				CPUINFO_RISCV_LINUX_FEATURE_A | CPUINFO_RISCV_LINUX_FEATURE_F | CPUINFO_RISCV_LINUX_FEATURE_D;
+		} else if (extension == 'p' && (uint32_t) (extension_ptr[-1] - '0') < 10) {
+			/* Separator of major and minor versions of an extension, e.g. i2p1 */
+		} else if ((uint32_t) (extension - 'a') < 26) {
+			features |= UINT64_C(1) << (extension - 'a');
+		}
+	}
+
+	while (extension_ptr != isa_end) {
+		if (*extension_ptr == '_') {
+			extension_ptr++;
+			continue;
+		}
+		const char* extension_end = extension_ptr;
+		while (extension_end != isa_end && *extension_end != '_') {
+			extension_end++;
+		}
+		features |= decode_multi_letter_extension(extension_ptr, extension_end);
+		extension_ptr = extension_end;
+	}
+
+	processor->features = features;
+	processor->flags |= CPUINFO_RISCV_LINUX_VALID_ISA | CPUINFO_RISCV_LINUX_VALID_PROCESSOR;
+}
+
+/*
+ * Decode the compatible string of the core in the device tree.
+ * Example of the value reported in /proc/cpuinfo:
+ *
+ *		uarch		: sifive,u74-mc
+ */
+static void parse_uarch(
+	const char* uarch_start,
+	const char* uarch_end,
+	struct cpuinfo_riscv_linux_processor processor[restrict static 1])
+{
+	size_t uarch_length = (size_t) (uarch_end - uarch_start);
+	if (uarch_length >= CPUINFO_RISCV_UARCH_NAME_MAX) {
+		cpuinfo_log_warning("uarch %.*s in /proc/cpuinfo is truncated to %d characters",
+			(int) uarch_length, uarch_start, CPUINFO_RISCV_UARCH_NAME_MAX - 1);
+		uarch_length = CPUINFO_RISCV_UARCH_NAME_MAX - 1;
+	}
+	memcpy(processor->uarch_name, uarch_start, uarch_length);
+	processor->uarch_name[uarch_length] = '\0';
+	processor->flags |= CPUINFO_RISCV_LINUX_VALID_UARCH_NAME | CPUINFO_RISCV_LINUX_VALID_PROCESSOR;
+}
+
+struct proc_cpuinfo_parser_state {
+	uint32_t processor_index;
+	uint32_t max_processors_count;
+	struct cpuinfo_riscv_linux_processor* processors;
+	struct cpuinfo_riscv_linux_processor dummy_processor;
+};
+
+/*
+ *	Decode a single key/value pair of /proc/cpuinfo information.
+ *	Lines have format <words-with-spaces>[ ]*:[ ]<space-separated words>
+ */
+static bool parse_line(
+	const char* key_start,
+	const char* key_end,
+	const char* value_start,
+	const char* value_end,
+	struct proc_cpuinfo_parser_state state[restrict static 1],
+	uint64_t line_number)
+{
+	const uint32_t processor_index      = state->processor_index;
+	const uint32_t max_processors_count = state->max_processors_count;
+	struct cpuinfo_riscv_linux_processor* processors = state->processors;
+	struct cpuinfo_riscv_linux_processor* processor  = &state->dummy_processor;
+	if (processor_index < max_processors_count) {
+		processor = &processors[processor_index];
+	}
+
+	uint64_t value;
+	const size_t key_length = key_end - key_start;
+	switch (key_length) {
+		case 3:
+			if (memcmp(key_start, "isa", key_length) == 0) {
+				parse_isa(value_start, value_end, processor);
+			} else if (memcmp(key_start, "mmu", key_length) == 0) {
+				/* Ignore */
+			} else {
+				goto unknown;
+			}
+			break;
+		case 4:
+			if (memcmp(key_start, "hart", key_length) == 0) {
+				/* Ignore: hart ID of the SBI, not the processor number of Linux */
+			} else {
+				goto unknown;
+			}
+			break;
+		case 5:
+			if (memcmp(key_start, "uarch", key_length) == 0) {
+				parse_uarch(value_start, value_end, processor);
+			} else {
+				goto unknown;
+			}
+			break;
+		case 6:
+			if (memcmp(key_start, "mimpid", key_length) == 0) {
+				/* Ignore */
+			} else {
+				goto unknown;
+			}
+			break;
+		case 7:
+			if (memcmp(key_start, "marchid", key_length) == 0) {
+				if (parse_hex("marchid", value_start, value_end, &value)) {
+					processor->marchid = value;
+					processor->flags |= CPUINFO_RISCV_LINUX_VALID_MARCHID | CPUINFO_RISCV_LINUX_VALID_PROCESSOR;
+				}
+			} else {
+				goto unknown;
+			}
+			break;
+		case 9:
+			if (memcmp(key_start, "mvendorid", key_length) == 0) {
+				if (parse_hex("mvendorid", value_start, value_end, &value)) {
+					processor->mvendorid = (uint32_t) value;
+					processor->flags |= CPUINFO_RISCV_LINUX_VALID_MVENDORID | CPUINFO_RISCV_LINUX_VALID_PROCESSOR;
+				}
+			} else if (memcmp(key_start, "processor", key_length) == 0) {
+				const uint32_t new_processor_index = parse_processor_number(value_start, value_end);
+				if (new_processor_index < processor_index) {
+					/* Strange: decreasing processor number */
+					cpuinfo_log_warning(
+						"unexpectedly low processor number %"PRIu32" following processor %"PRIu32" in /proc/cpuinfo",
+						new_processor_index, processor_index);
+				} else if (new_processor_index > processor_index + 1) {
+					/* Strange, but common: skipped processor $(processor_index + 1) */
+					cpuinfo_log_info(
+						"unexpectedly high processor number %"PRIu32" following processor %"PRIu32" in /proc/cpuinfo",
+						new_processor_index, processor_index);
+				}
+				if (new_processor_index >= max_processors_count) {
+					/* Log and ignore processor */
+					cpuinfo_log_warning("processor %"PRIu32" in /proc/cpuinfo is ignored: index exceeds system limit %"PRIu32,
+						new_processor_index, max_processors_count - 1);
+				} else {
+					processors[new_processor_index].flags |= CPUINFO_RISCV_LINUX_VALID_PROCESSOR;
+				}
+				state->processor_index = new_processor_index;
+				return true;
+			} else {
+				goto unknown;
+			}
+			break;
+		default:
+		unknown:
+			cpuinfo_log_debug("unknown /proc/cpuinfo key: %.*s", (int) key_length, key_start);
+
+	}
+	return true;
+}
+
+bool cpuinfo_riscv_linux_parse_proc_cpuinfo(
+	uint32_t max_processors_count,
+	struct cpuinfo_riscv_linux_processor processors[restrict static max_processors_count])
+{
+	struct proc_cpuinfo_parser_state state = {
+		.processor_index = 0,
+		.max_processors_count = max_processors_count,
+		.processors = processors,
+	};
+	return cpuinfo_linux_parse_key_value_file("/proc/cpuinfo", BUFFER_SIZE, skip_keys,
+		(cpuinfo_key_value_callback) parse_line, &state);
+}
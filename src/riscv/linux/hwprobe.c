@@ -0,0 +1,164 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#if !CPUINFO_MOCK
+	#include <errno.h>
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/auxv.h>
+	#include <sys/syscall.h>
+#endif
+
+#include <cpuinfo.h>
+#include <riscv/linux/api.h>
+#include <cpuinfo/log.h>
+
+
+/* Constants from <asm/unistd.h> and <asm/hwprobe.h> of Linux 6.8, which older kernel headers lack */
+#ifndef __NR_riscv_hwprobe
+	#define __NR_riscv_hwprobe 258
+#endif
+#define HWPROBE_KEY_MVENDORID     0
+#define HWPROBE_KEY_MARCHID       1
+#define HWPROBE_KEY_BASE_BEHAVIOR 3
+#define HWPROBE_KEY_IMA_EXT_0     4
+
+#define HWPROBE_BASE_BEHAVIOR_IMA UINT64_C(0x0000000000000001)
+
+#define HWPROBE_IMA_FD            UINT64_C(0x0000000000000001)
+#define HWPROBE_IMA_C             UINT64_C(0x0000000000000002)
+#define HWPROBE_IMA_V             UINT64_C(0x0000000000000004)
+#define HWPROBE_EXT_ZBA           UINT64_C(0x0000000000000008)
+#define HWPROBE_EXT_ZBB           UINT64_C(0x0000000000000010)
+#define HWPROBE_EXT_ZBS           UINT64_C(0x0000000000000020)
+#define HWPROBE_EXT_ZICBOZ        UINT64_C(0x0000000000000040)
+#define HWPROBE_EXT_ZBC           UINT64_C(0x0000000000000080)
+#define HWPROBE_EXT_ZVBB          UINT64_C(0x0000000000020000)
+#define HWPROBE_EXT_ZVBC          UINT64_C(0x0000000000040000)
+#define HWPROBE_EXT_ZFH           UINT64_C(0x0000000008000000)
+#define HWPROBE_EXT_ZFHMIN        UINT64_C(0x0000000010000000)
+#define HWPROBE_EXT_ZVFH          UINT64_C(0x0000000040000000)
+#define HWPROBE_EXT_ZICOND        UINT64_C(0x0000000800000000)
+
+/* Layout of struct riscv_hwprobe: the kernel sets key to -1 if it doesn't know the key */
+struct hwprobe_pair {
+	int64_t key;
+	uint64_t value;
+};
+
+bool cpuinfo_riscv_linux_features_from_hwprobe(uint64_t features[restrict static 1]) {
+	#if CPUINFO_MOCK
+		return false;
+	#else
+		struct hwprobe_pair pairs[] = {
+			{ .key = HWPROBE_KEY_BASE_BEHAVIOR },
+			{ .key = HWPROBE_KEY_IMA_EXT_0 },
+		};
+		/* Without a set of processors the kernel reports the values common to all online processors */
+		if (syscall(__NR_riscv_hwprobe, pairs, CPUINFO_COUNT_OF(pairs), 0, NULL, 0) != 0) {
+			cpuinfo_log_info("riscv_hwprobe syscall failed: %s", strerror(errno));
+			return false;
+		}
+		if (pairs[0].key < 0 || pairs[1].key < 0) {
+			cpuinfo_log_info("riscv_hwprobe syscall doesn't report base behavior and extensions");
+			return false;
+		}
+
+		uint64_t result = 0;
+		if (pairs[0].value & HWPROBE_BASE_BEHAVIOR_IMA) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_I | CPUINFO_RISCV_LINUX_FEATURE_M | CPUINFO_RISCV_LINUX_FEATURE_A;
+		}
+		const uint64_t extensions = pairs[1].value;
+		if (extensions & HWPROBE_IMA_FD) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_F | CPUINFO_RISCV_LINUX_FEATURE_D;
+		}
+		if (extensions & HWPROBE_IMA_C) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_C;
+		}
+		if (extensions & HWPROBE_IMA_V) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_V;
+		}
+		if (extensions & HWPROBE_EXT_ZBA) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZBA;
+		}
+		if (extensions & HWPROBE_EXT_ZBB) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZBB;
+		}
+		if (extensions & HWPROBE_EXT_ZBC) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZBC;
+		}
+		if (extensions & HWPROBE_EXT_ZBS) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZBS;
+		}
+		if (extensions & HWPROBE_EXT_ZICBOZ) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZICBOZ;
+		}
+		if (extensions & HWPROBE_EXT_ZICOND) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZICOND;
+		}
+		if (extensions & HWPROBE_EXT_ZFH) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZFH;
+		}
+		if (extensions & HWPROBE_EXT_ZFHMIN) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZFHMIN;
+		}
+		if (extensions & HWPROBE_EXT_ZVBB) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZVBB;
+		}
+		if (extensions & HWPROBE_EXT_ZVBC) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZVBC;
+		}
+		if (extensions & HWPROBE_EXT_ZVFH) {
+			result |= CPUINFO_RISCV_LINUX_FEATURE_ZVFH;
+		}
+		*features = result;
+		return true;
+	#endif
+}
+
+bool cpuinfo_riscv_linux_ids_from_hwprobe(
+	uint32_t processor,
+	uint32_t mvendorid[restrict static 1],
+	uint64_t marchid[restrict static 1])
+{
+	#if CPUINFO_MOCK
+		return false;
+	#else
+		if (processor >= CPU_SETSIZE) {
+			return false;
+		}
+		cpu_set_t processor_set;
+		CPU_ZERO(&processor_set);
+		CPU_SET(processor, &processor_set);
+		struct hwprobe_pair pairs[] = {
+			{ .key = HWPROBE_KEY_MVENDORID },
+			{ .key = HWPROBE_KEY_MARCHID },
+		};
+		if (syscall(__NR_riscv_hwprobe, pairs, CPUINFO_COUNT_OF(pairs), sizeof(processor_set), &processor_set, 0) != 0) {
+			cpuinfo_log_debug("riscv_hwprobe syscall failed for processor %"PRIu32": %s", processor, strerror(errno));
+			return false;
+		}
+		if (pairs[0].key < 0 || pairs[1].key < 0) {
+			return false;
+		}
+		*mvendorid = (uint32_t) pairs[0].value;
+		*marchid = pairs[1].value;
+		return true;
+	#endif
+}
+
+bool cpuinfo_riscv_linux_features_from_hwcap(uint64_t features[restrict static 1]) {
+	#if CPUINFO_MOCK
+		return false;
+	#else
+		/* AT_HWCAP is zero if the kernel doesn't report it: every RISC-V processor has at least I or E */
+		const uint64_t hwcap = (uint64_t) getauxval(AT_HWCAP) & CPUINFO_RISCV_LINUX_HWCAP_MASK;
+		if (hwcap == 0) {
+			return false;
+		}
+		*features = hwcap;
+		return true;
+	#endif
+}
@@ -0,0 +1,648 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#include <riscv/api.h>
+#include <riscv/linux/api.h>
+#include <linux/api.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+struct cpuinfo_riscv_isa cpuinfo_isa = { 0 };
+
+static inline bool bitmask_all(uint32_t bitfield, uint32_t mask) {
+	return (bitfield & mask) == mask;
+}
+
+static inline uint32_t min(uint32_t a, uint32_t b) {
+	return a < b ? a : b;
+}
+
+static inline int cmp(uint32_t a, uint32_t b) {
+	return (a > b) - (a < b);
+}
+
+static void detect_package_id(
+	uint32_t processor,
+	struct cpuinfo_riscv_linux_processor* processors)
+{
+	if (!bitmask_all(processors[processor].flags, CPUINFO_LINUX_FLAG_VALID)) {
+		return;
+	}
+
+	if (cpuinfo_linux_get_processor_package_id(processor, &processors[processor].package_id)) {
+		processors[processor].flags |= CPUINFO_LINUX_FLAG_PACKAGE_ID;
+	}
+}
+
+/*
+ * Find the leader of the processor's package. Package leader IDs form a disjoint-set forest while the lists of
+ * core siblings are parsed, and every tree is rooted at the processor with the smallest index in the package.
+ */
+static uint32_t find_package_leader(uint32_t processor, struct cpuinfo_riscv_linux_processor* processors) {
+	while (processors[processor].package_leader_id != processor) {
+		/* Path halving keeps the trees shallow without recursion */
+		const uint32_t parent = processors[processor].package_leader_id;
+		processors[processor].package_leader_id = processors[parent].package_leader_id;
+		processor = processors[processor].package_leader_id;
+	}
+	return processor;
+}
+
+static bool package_siblings_parser(
+	uint32_t processor, uint32_t siblings_start, uint32_t siblings_end,
+	struct cpuinfo_riscv_linux_processor* processors)
+{
+	processors[processor].flags |= CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER;
+	uint32_t package_leader_id = find_package_leader(processor, processors);
+
+	for (uint32_t sibling = siblings_start; sibling < siblings_end; sibling++) {
+		if (!bitmask_all(processors[sibling].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			cpuinfo_log_info("invalid processor %"PRIu32" reported as a sibling for processor %"PRIu32,
+				sibling, processor);
+			continue;
+		}
+
+		const uint32_t sibling_package_leader_id = find_package_leader(sibling, processors);
+		if (sibling_package_leader_id < package_leader_id) {
+			processors[package_leader_id].package_leader_id = sibling_package_leader_id;
+			package_leader_id = sibling_package_leader_id;
+		} else {
+			processors[sibling_package_leader_id].package_leader_id = package_leader_id;
+		}
+		processors[sibling].flags |= CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER;
+	}
+
+	return true;
+}
+
+/* Level of a cache described in sysfs, or cpuinfo_cache_level_max if cpuinfo doesn't report such caches */
+static enum cpuinfo_cache_level get_sysfs_cache_level(const struct cpuinfo_linux_cache cache[restrict static 1]) {
+	if (cache->type == cpuinfo_linux_cache_type_instruction) {
+		return cache->level == 1 ? cpuinfo_cache_level_1i : cpuinfo_cache_level_max;
+	}
+	switch (cache->level) {
+		case 1:
+			return cpuinfo_cache_level_1d;
+		case 2:
+			return cpuinfo_cache_level_2;
+		case 3:
+			return cpuinfo_cache_level_3;
+		case 4:
+			return cpuinfo_cache_level_4;
+		default:
+			return cpuinfo_cache_level_max;
+	}
+}
+
+struct cache_siblings_context {
+	uint32_t processors_count;
+	struct cpuinfo_riscv_linux_processor* processors;
+	/* Index of the cache/indexK directory, and level and index plus one of the cache */
+	uint32_t sysfs_index;
+	enum cpuinfo_cache_level level;
+	uint32_t cache;
+};
+
+static bool set_cache_siblings(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+	const struct cache_siblings_context* siblings_context = (const struct cache_siblings_context*) context;
+	cpu_end = min(cpu_end, siblings_context->processors_count);
+	for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+		struct cpuinfo_riscv_linux_processor* processor = &siblings_context->processors[cpu];
+		processor->sysfs_cache_indices |= UINT32_C(1) << siblings_context->sysfs_index;
+		if (processor->sysfs_cache[siblings_context->level] == 0) {
+			processor->sysfs_cache[siblings_context->level] = siblings_context->cache;
+		}
+	}
+	return true;
+}
+
+/*
+ * Detect caches of processors indexed by Linux processor ID from sysfs. On RISC-V the kernel derives them from the
+ * device tree or ACPI PPTT: there are no registers which describe caches.
+ * Every cache is parsed only on the first processor which shares it. Returns the number of caches.
+ */
+static uint32_t detect_sysfs_caches(
+	uint32_t linux_processors_count,
+	struct cpuinfo_riscv_linux_processor linux_processors[restrict static linux_processors_count],
+	struct cpuinfo_cache caches[restrict static linux_processors_count * cpuinfo_cache_level_max])
+{
+	uint32_t caches_count = 0;
+	for (uint32_t cpu = 0; cpu < linux_processors_count; cpu++) {
+		if (!bitmask_all(linux_processors[cpu].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			continue;
+		}
+		for (uint32_t index = 0; index < CPUINFO_LINUX_MAX_CACHE_INDICES; index++) {
+			if (linux_processors[cpu].sysfs_cache_indices & (UINT32_C(1) << index)) {
+				continue;
+			}
+			struct cpuinfo_linux_cache linux_cache;
+			if (!cpuinfo_linux_get_processor_cache(cpu, index, &linux_cache)) {
+				break;
+			}
+			linux_processors[cpu].sysfs_cache_indices |= UINT32_C(1) << index;
+			const enum cpuinfo_cache_level level = get_sysfs_cache_level(&linux_cache);
+			if (level == cpuinfo_cache_level_max || linux_processors[cpu].sysfs_cache[level] != 0) {
+				continue;
+			}
+
+			if (linux_cache.sets == 0 && linux_cache.associativity != 0 && linux_cache.line_size != 0) {
+				linux_cache.sets = linux_cache.size / (linux_cache.associativity * linux_cache.line_size);
+			}
+			caches[caches_count++] = (struct cpuinfo_cache) {
+				.size = linux_cache.size,
+				.associativity = linux_cache.associativity,
+				.sets = linux_cache.sets,
+				.partitions = linux_cache.partitions != 0 ? linux_cache.partitions : 1,
+				.line_size = linux_cache.line_size,
+				.flags = linux_cache.type == cpuinfo_linux_cache_type_unified ? CPUINFO_CACHE_UNIFIED : 0,
+			};
+
+			struct cache_siblings_context context = {
+				.processors_count = linux_processors_count,
+				.processors = linux_processors,
+				.sysfs_index = index,
+				.level = level,
+				.cache = caches_count,
+			};
+			cpuinfo_linux_parse_processor_cache_siblings(cpu, index, set_cache_siblings, &context);
+			/* The processor itself may be missing from a malformed list */
+			set_cache_siblings(cpu, cpu + 1, &context);
+		}
+	}
+	return caches_count;
+}
+
+static int cmp_riscv_linux_processor(const void* ptr_a, const void* ptr_b) {
+	const struct cpuinfo_riscv_linux_processor* processor_a = (const struct cpuinfo_riscv_linux_processor*) ptr_a;
+	const struct cpuinfo_riscv_linux_processor* processor_b = (const struct cpuinfo_riscv_linux_processor*) ptr_b;
+
+	/* Move usable processors towards the start of the array */
+	const bool usable_a = bitmask_all(processor_a->flags, CPUINFO_LINUX_FLAG_VALID);
+	const bool usable_b = bitmask_all(processor_b->flags, CPUINFO_LINUX_FLAG_VALID);
+	if (usable_a != usable_b) {
+		return (int) usable_b - (int) usable_a;
+	}
+
+	/* Compare based on package leader id (i.e. package 0 < package 1) */
+	const uint32_t package_a = processor_a->package_leader_id;
+	const uint32_t package_b = processor_b->package_leader_id;
+	if (package_a != package_b) {
+		return cmp(package_a, package_b);
+	}
+
+	/* Group cores of the same microarchitecture into clusters */
+	const uint32_t uarch_a = (uint32_t) processor_a->uarch;
+	const uint32_t uarch_b = (uint32_t) processor_b->uarch;
+	if (uarch_a != uarch_b) {
+		return cmp(uarch_a, uarch_b);
+	}
+
+	/* Compare based on system processor id (i.e. processor 0 < processor 1) */
+	return cmp(processor_a->system_processor_id, processor_b->system_processor_id);
+}
+
+void cpuinfo_riscv_linux_init(void) {
+	struct cpuinfo_riscv_linux_processor* riscv_linux_processors = NULL;
+	struct cpuinfo_processor* processors = NULL;
+	struct cpuinfo_core* cores = NULL;
+	struct cpuinfo_cluster* clusters = NULL;
+	struct cpuinfo_package* packages = NULL;
+	struct cpuinfo_uarch_info* uarchs = NULL;
+	struct cpuinfo_cache* caches[cpuinfo_cache_level_max] = { NULL };
+	struct cpuinfo_cache* sysfs_caches = NULL;
+	uint32_t* sysfs_cache_indices = NULL;
+	uint32_t sysfs_caches_count = 0;
+	enum cpuinfo_uarch* uarchs_list = NULL;
+	const struct cpuinfo_processor** linux_cpu_to_processor_map = NULL;
+	const struct cpuinfo_core** linux_cpu_to_core_map = NULL;
+	uint32_t* linux_cpu_to_uarch_index_map = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
+	uint64_t phase_start = cpuinfo_get_timestamp_ns();
+
+	const uint32_t max_processors_count = cpuinfo_linux_get_max_processors_count();
+	cpuinfo_log_debug("system maximum processors count: %"PRIu32, max_processors_count);
+
+	const uint32_t max_possible_processors_count = 1 +
+		cpuinfo_linux_get_max_possible_processor(max_processors_count);
+	cpuinfo_log_debug("maximum possible processors count: %"PRIu32, max_possible_processors_count);
+	const uint32_t max_present_processors_count = 1 +
+		cpuinfo_linux_get_max_present_processor(max_processors_count);
+	cpuinfo_log_debug("maximum present processors count: %"PRIu32, max_present_processors_count);
+
+	uint32_t valid_processor_mask = 0;
+	uint32_t riscv_linux_processors_count = max_processors_count;
+	if (max_present_processors_count != 0) {
+		riscv_linux_processors_count = min(riscv_linux_processors_count, max_present_processors_count);
+		valid_processor_mask = CPUINFO_LINUX_FLAG_PRESENT;
+	}
+	if (max_possible_processors_count != 0) {
+		riscv_linux_processors_count = min(riscv_linux_processors_count, max_possible_processors_count);
+		valid_processor_mask |= CPUINFO_LINUX_FLAG_POSSIBLE;
+	}
+	if ((max_present_processors_count | max_possible_processors_count) == 0) {
+		cpuinfo_log_error("failed to parse both lists of possible and present processors");
+		return;
+	}
+
+	riscv_linux_processors = cpuinfo_allocate_temporary(
+		riscv_linux_processors_count, sizeof(struct cpuinfo_riscv_linux_processor));
+	if (riscv_linux_processors == NULL) {
+		cpuinfo_log_error(
+			"failed to allocate %zu bytes for descriptions of %"PRIu32" RISC-V logical processors",
+			riscv_linux_processors_count * sizeof(struct cpuinfo_riscv_linux_processor),
+			riscv_linux_processors_count);
+		return;
+	}
+
+	if (max_possible_processors_count) {
+		cpuinfo_linux_detect_possible_processors(
+			riscv_linux_processors_count, &riscv_linux_processors->flags,
+			sizeof(struct cpuinfo_riscv_linux_processor),
+			CPUINFO_LINUX_FLAG_POSSIBLE);
+	}
+
+	if (max_present_processors_count) {
+		cpuinfo_linux_detect_present_processors(
+			riscv_linux_processors_count, &riscv_linux_processors->flags,
+			sizeof(struct cpuinfo_riscv_linux_processor),
+			CPUINFO_LINUX_FLAG_PRESENT);
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_cpulists, &phase_start);
+
+	if (!cpuinfo_riscv_linux_parse_proc_cpuinfo(riscv_linux_processors_count, riscv_linux_processors)) {
+		cpuinfo_log_error("failed to parse processor information from /proc/cpuinfo");
+		goto cleanup;
+	}
+
+	uint32_t valid_processors = 0;
+	for (uint32_t i = 0; i < riscv_linux_processors_count; i++) {
+		riscv_linux_processors[i].system_processor_id = i;
+		riscv_linux_processors[i].package_leader_id = i;
+		if (bitmask_all(riscv_linux_processors[i].flags, valid_processor_mask)) {
+			riscv_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_VALID;
+			valid_processors += 1;
+
+			if (!(riscv_linux_processors[i].flags & CPUINFO_RISCV_LINUX_VALID_PROCESSOR)) {
+				/*
+				 * Processor is in possible and present lists, but not reported in /proc/cpuinfo.
+				 * This is fairly common: high-index processors can be not reported if they are offline.
+				 */
+				cpuinfo_log_info("processor %"PRIu32" is not listed in /proc/cpuinfo", i);
+			}
+
+			/* Kernels before 6.1 don't report mvendorid and marchid in /proc/cpuinfo */
+			if (!bitmask_all(riscv_linux_processors[i].flags, CPUINFO_RISCV_LINUX_VALID_IDS) &&
+				cpuinfo_riscv_linux_ids_from_hwprobe(
+					i, &riscv_linux_processors[i].mvendorid, &riscv_linux_processors[i].marchid))
+			{
+				riscv_linux_processors[i].flags |= CPUINFO_RISCV_LINUX_VALID_IDS;
+			}
+			cpuinfo_log_debug("parsed processor %"PRIu32" mvendorid 0x%"PRIx32" marchid 0x%"PRIx64" uarch \"%s\"",
+				i, riscv_linux_processors[i].mvendorid, riscv_linux_processors[i].marchid,
+				riscv_linux_processors[i].uarch_name);
+		} else {
+			/* Processor reported in /proc/cpuinfo, but not in possible and/or present lists: log and ignore */
+			if (riscv_linux_processors[i].flags & CPUINFO_RISCV_LINUX_VALID_PROCESSOR) {
+				cpuinfo_log_warning("invalid processor %"PRIu32" reported in /proc/cpuinfo", i);
+			}
+		}
+	}
+	if (valid_processors == 0) {
+		cpuinfo_log_error("no valid processors in the lists of possible and present processors");
+		goto cleanup;
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_proc_cpuinfo, &phase_start);
+
+	/*
+	 * riscv_hwprobe reports both single-letter and multi-letter extensions which the kernel enabled. Older kernels
+	 * report only single-letter extensions in AT_HWCAP, and multi-letter extensions come from the ISA strings in
+	 * /proc/cpuinfo. If different processors report different ISA strings, take the intersection.
+	 */
+	uint64_t isa_features = 0;
+	if (!cpuinfo_riscv_linux_features_from_hwprobe(&isa_features)) {
+		uint64_t proc_cpuinfo_features = 0;
+		uint32_t processors_with_features = 0;
+		for (uint32_t i = 0; i < riscv_linux_processors_count; i++) {
+			if (bitmask_all(riscv_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_RISCV_LINUX_VALID_ISA)) {
+				if (processors_with_features == 0) {
+					proc_cpuinfo_features = riscv_linux_processors[i].features;
+				} else {
+					proc_cpuinfo_features &= riscv_linux_processors[i].features;
+				}
+				processors_with_features += 1;
+			}
+		}
+
+		uint64_t hwcap_features = 0;
+		if (cpuinfo_riscv_linux_features_from_hwcap(&hwcap_features)) {
+			isa_features = hwcap_features | (proc_cpuinfo_features & ~CPUINFO_RISCV_LINUX_HWCAP_MASK);
+		} else {
+			isa_features = proc_cpuinfo_features;
+		}
+	}
+	cpuinfo_riscv_linux_decode_isa(isa_features, &cpuinfo_isa);
+	cpuinfo_record_init_phase(cpuinfo_init_phase_decode, &phase_start);
+
+	/* Detect package ID */
+	cpuinfo_linux_parallel_for_processors(riscv_linux_processors_count,
+		(cpuinfo_processor_function) detect_package_id, riscv_linux_processors);
+
+	/* Propagate package leader IDs among siblings */
+	for (uint32_t i = 0; i < riscv_linux_processors_count; i++) {
+		/*
+		 * Siblings lists of processors in the same package are identical: parse the list only for the first
+		 * processor of every package to keep the work linear in the number of processors.
+		 */
+		if (bitmask_all(riscv_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_PACKAGE_ID) &&
+			!bitmask_all(riscv_linux_processors[i].flags, CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER))
+		{
+			cpuinfo_linux_detect_core_siblings(
+				riscv_linux_processors_count, i,
+				(cpuinfo_siblings_callback) package_siblings_parser,
+				riscv_linux_processors);
+		}
+	}
+
+	/* Processors without topology information in sysfs are assumed to be in the package of the first processor */
+	uint32_t first_valid_processor = UINT32_MAX;
+	for (uint32_t i = 0; i < riscv_linux_processors_count; i++) {
+		if (!bitmask_all(riscv_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			continue;
+		}
+		if (first_valid_processor == UINT32_MAX) {
+			first_valid_processor = i;
+		}
+		if (bitmask_all(riscv_linux_processors[i].flags, CPUINFO_LINUX_FLAG_PACKAGE_CLUSTER)) {
+			riscv_linux_processors[i].package_leader_id = find_package_leader(i, riscv_linux_processors);
+		} else {
+			riscv_linux_processors[i].package_leader_id = first_valid_processor;
+		}
+	}
+
+	/* Decode vendor and uarch, or copy them from the package leader if the processor is not in /proc/cpuinfo */
+	for (uint32_t i = 0; i < riscv_linux_processors_count; i++) {
+		struct cpuinfo_riscv_linux_processor* processor = &riscv_linux_processors[i];
+		if (!bitmask_all(processor->flags, CPUINFO_LINUX_FLAG_VALID)) {
+			continue;
+		}
+		const struct cpuinfo_riscv_linux_processor* leader = &riscv_linux_processors[processor->package_leader_id];
+		if (!(processor->flags & (CPUINFO_RISCV_LINUX_VALID_IDS | CPUINFO_RISCV_LINUX_VALID_UARCH_NAME)) &&
+			leader != processor)
+		{
+			processor->vendor = leader->vendor;
+			processor->uarch = leader->uarch;
+		} else {
+			cpuinfo_riscv_decode_vendor_uarch(
+				processor->mvendorid, processor->marchid, processor->uarch_name,
+				&processor->vendor, &processor->uarch);
+		}
+	}
+
+	/* Caches are known only from sysfs */
+	sysfs_caches = cpuinfo_allocate_temporary(
+		riscv_linux_processors_count * cpuinfo_cache_level_max, sizeof(struct cpuinfo_cache));
+	sysfs_cache_indices = cpuinfo_allocate_temporary(
+		riscv_linux_processors_count * cpuinfo_cache_level_max, sizeof(uint32_t));
+	if (sysfs_caches == NULL || sysfs_cache_indices == NULL) {
+		cpuinfo_log_warning("failed to allocate %zu bytes for descriptions of caches in sysfs: caches are unknown",
+			riscv_linux_processors_count * cpuinfo_cache_level_max * (sizeof(struct cpuinfo_cache) + sizeof(uint32_t)));
+	} else {
+		sysfs_caches_count = detect_sysfs_caches(riscv_linux_processors_count, riscv_linux_processors, sysfs_caches);
+		cpuinfo_log_debug("detected %"PRIu32" caches in sysfs", sysfs_caches_count);
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_sysfs, &phase_start);
+
+	qsort(riscv_linux_processors, riscv_linux_processors_count,
+		sizeof(struct cpuinfo_riscv_linux_processor), cmp_riscv_linux_processor);
+
+	/* Sorted valid processors precede invalid ones */
+	uarchs_list = cpuinfo_allocate_temporary(valid_processors, sizeof(enum cpuinfo_uarch));
+	if (uarchs_list == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for the list of microarchitectures",
+			valid_processors * sizeof(enum cpuinfo_uarch));
+		goto cleanup;
+	}
+	uint32_t packages_count = 0, clusters_count = 0, uarchs_count = 0;
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		const bool new_package = i == 0 ||
+			riscv_linux_processors[i].package_leader_id != riscv_linux_processors[i - 1].package_leader_id;
+		if (new_package) {
+			packages_count += 1;
+		}
+		if (new_package || riscv_linux_processors[i].uarch != riscv_linux_processors[i - 1].uarch) {
+			clusters_count += 1;
+		}
+
+		uint32_t uarch_index = 0;
+		while (uarch_index < uarchs_count && uarchs_list[uarch_index] != riscv_linux_processors[i].uarch) {
+			uarch_index++;
+		}
+		if (uarch_index == uarchs_count) {
+			uarchs_list[uarchs_count++] = riscv_linux_processors[i].uarch;
+		}
+		riscv_linux_processors[i].uarch_index = uarch_index;
+	}
+
+	/*
+	 * Assign table indices to caches in order of the first processor which shares them, and count processors which
+	 * share every cache.
+	 */
+	uint32_t cache_counts[cpuinfo_cache_level_max] = { 0 };
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+			const uint32_t sysfs_cache = riscv_linux_processors[i].sysfs_cache[level];
+			if (sysfs_cache == 0) {
+				continue;
+			}
+			struct cpuinfo_cache* cache = &sysfs_caches[sysfs_cache - 1];
+			if (cache->processor_count == 0) {
+				sysfs_cache_indices[sysfs_cache - 1] = cache_counts[level]++;
+				cache->processor_start = i;
+			} else if (cache->processor_start + cache->processor_count != i) {
+				cpuinfo_log_warning("processors sharing cache of level %"PRIu32" with processor %"PRIu32" are not contiguous",
+					level, riscv_linux_processors[i].system_processor_id);
+			}
+			cache->processor_count += 1;
+		}
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_caches, &phase_start);
+
+	/* Processors with a single microarchitecture describe it in cpuinfo_global_uarch */
+	const uint32_t uarch_index_map_count = uarchs_count > 1 ? riscv_linux_processors_count : 0;
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, valid_processors, sizeof(struct cpuinfo_core));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, clusters_count, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset = cpuinfo_arena_reserve(&arena, packages_count, sizeof(struct cpuinfo_package));
+	size_t cache_offsets[cpuinfo_cache_level_max];
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cache_offsets[level] = cpuinfo_arena_reserve(&arena, cache_counts[level], sizeof(struct cpuinfo_cache));
+	}
+	const size_t linux_cpu_to_processor_map_offset =
+		cpuinfo_arena_reserve(&arena, riscv_linux_processors_count, sizeof(struct cpuinfo_processor*));
+	const size_t linux_cpu_to_core_map_offset =
+		cpuinfo_arena_reserve(&arena, riscv_linux_processors_count, sizeof(struct cpuinfo_core*));
+	const size_t uarchs_offset =
+		cpuinfo_arena_reserve(&arena, uarch_index_map_count != 0 ? uarchs_count : 0, sizeof(struct cpuinfo_uarch_info));
+	const size_t linux_cpu_to_uarch_index_map_offset =
+		cpuinfo_arena_reserve(&arena, uarch_index_map_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		goto cleanup;
+	}
+
+	processors = cpuinfo_arena_get(&arena, processors_offset, valid_processors);
+	cores = cpuinfo_arena_get(&arena, cores_offset, valid_processors);
+	clusters = cpuinfo_arena_get(&arena, clusters_offset, clusters_count);
+	packages = cpuinfo_arena_get(&arena, packages_offset, packages_count);
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		caches[level] = cpuinfo_arena_get(&arena, cache_offsets[level], cache_counts[level]);
+	}
+	linux_cpu_to_processor_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_processor_map_offset, riscv_linux_processors_count);
+	linux_cpu_to_core_map = cpuinfo_arena_get(&arena, linux_cpu_to_core_map_offset, riscv_linux_processors_count);
+	if (uarch_index_map_count != 0) {
+		uarchs = cpuinfo_arena_get(&arena, uarchs_offset, uarchs_count);
+		linux_cpu_to_uarch_index_map =
+			cpuinfo_arena_get(&arena, linux_cpu_to_uarch_index_map_offset, uarch_index_map_count);
+		for (uint32_t i = 0; i < uarchs_count; i++) {
+			uarchs[i].uarch = uarchs_list[i];
+		}
+	}
+
+	/*
+	 * Assumptions:
+	 * - No SMT (i.e. each core supports only one hardware thread).
+	 * - Cores of the same microarchitecture in a package form a cluster.
+	 */
+	uint32_t package_index = UINT32_MAX, cluster_index = UINT32_MAX;
+	for (uint32_t i = 0; i < valid_processors; i++) {
+		const struct cpuinfo_riscv_linux_processor* riscv_processor = &riscv_linux_processors[i];
+		const bool new_package = i == 0 || riscv_processor->package_leader_id != riscv_processor[-1].package_leader_id;
+		if (new_package) {
+			package_index += 1;
+			packages[package_index].processor_start = i;
+			packages[package_index].core_start = i;
+			packages[package_index].cluster_start = cluster_index + 1;
+		}
+		if (new_package || riscv_processor->uarch != riscv_processor[-1].uarch) {
+			cluster_index += 1;
+			clusters[cluster_index] = (struct cpuinfo_cluster) {
+				.processor_start = i,
+				.core_start = i,
+				.cluster_id = cluster_index - packages[package_index].cluster_start,
+				.package = packages + package_index,
+				.vendor = riscv_processor->vendor,
+				.uarch = riscv_processor->uarch,
+				.capacity = CPUINFO_CAPACITY_SCALE,
+			};
+			packages[package_index].cluster_count += 1;
+		}
+		clusters[cluster_index].processor_count += 1;
+		clusters[cluster_index].core_count += 1;
+		packages[package_index].processor_count += 1;
+		packages[package_index].core_count += 1;
+
+		const struct cpuinfo_cache* processor_caches[cpuinfo_cache_level_max] = { NULL };
+		for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+			const uint32_t sysfs_cache = riscv_processor->sysfs_cache[level];
+			if (sysfs_cache != 0) {
+				const uint32_t cache_index = sysfs_cache_indices[sysfs_cache - 1];
+				caches[level][cache_index] = sysfs_caches[sysfs_cache - 1];
+				processor_caches[level] = &caches[level][cache_index];
+			}
+		}
+
+		processors[i] = (struct cpuinfo_processor) {
+			.smt_id = 0,
+			.core = cores + i,
+			.cluster = clusters + cluster_index,
+			.package = packages + package_index,
+			.linux_id = (int) riscv_processor->system_processor_id,
+			.cache = {
+				.l1i = processor_caches[cpuinfo_cache_level_1i],
+				.l1d = processor_caches[cpuinfo_cache_level_1d],
+				.l2 = processor_caches[cpuinfo_cache_level_2],
+				.l3 = processor_caches[cpuinfo_cache_level_3],
+				.l4 = processor_caches[cpuinfo_cache_level_4],
+			},
+		};
+		linux_cpu_to_processor_map[riscv_processor->system_processor_id] = &processors[i];
+
+		cores[i] = (struct cpuinfo_core) {
+			.processor_start = i,
+			.processor_count = 1,
+			.core_id = i - packages[package_index].core_start,
+			.cluster = clusters + cluster_index,
+			.package = packages + package_index,
+			.vendor = riscv_processor->vendor,
+			.uarch = riscv_processor->uarch,
+			.capacity = CPUINFO_CAPACITY_SCALE,
+		};
+		linux_cpu_to_core_map[riscv_processor->system_processor_id] = &cores[i];
+
+		if (uarchs != NULL) {
+			uarchs[riscv_processor->uarch_index].processor_count += 1;
+			uarchs[riscv_processor->uarch_index].core_count += 1;
+			linux_cpu_to_uarch_index_map[riscv_processor->system_processor_id] = riscv_processor->uarch_index;
+		}
+	}
+
+	enum cpuinfo_linux_current_cpu_method current_cpu_method = cpuinfo_linux_current_cpu_method_syscall;
+	if (cpuinfo_linux_rseq_is_registered()) {
+		current_cpu_method = cpuinfo_linux_current_cpu_method_rseq;
+	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_tables, &phase_start);
+
+	/* Commit */
+	cpuinfo_processors = processors;
+	cpuinfo_cores = cores;
+	cpuinfo_clusters = clusters;
+	cpuinfo_packages = packages;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache[level] = caches[level];
+	}
+
+	cpuinfo_processors_count = valid_processors;
+	cpuinfo_cores_count = valid_processors;
+	cpuinfo_clusters_count = clusters_count;
+	cpuinfo_packages_count = packages_count;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache_count[level] = cache_counts[level];
+	}
+	cpuinfo_max_cache_size = cpuinfo_compute_max_cache_size(&processors[0]);
+
+	cpuinfo_global_uarch = (struct cpuinfo_uarch_info) {
+		.uarch = riscv_linux_processors[0].uarch,
+		.processor_count = valid_processors,
+		.core_count = valid_processors,
+	};
+
+	cpuinfo_linux_cpu_max = riscv_linux_processors_count;
+	cpuinfo_linux_current_cpu_method = current_cpu_method;
+	cpuinfo_linux_cpu_to_processor_map = linux_cpu_to_processor_map;
+	cpuinfo_linux_cpu_to_core_map = linux_cpu_to_core_map;
+	if (uarchs != NULL) {
+		cpuinfo_uarchs = uarchs;
+		cpuinfo_uarchs_count = uarchs_count;
+		cpuinfo_linux_cpu_to_uarch_index_map = linux_cpu_to_uarch_index_map;
+	}
+
+	cpuinfo_arena_memory = arena.memory;
+
+	__sync_synchronize();
+
+	cpuinfo_is_initialized = true;
+
+	arena.memory = NULL;
+
+cleanup:
+	cpuinfo_linux_release_sysfs();
+	cpuinfo_free_temporary(riscv_linux_processors);
+	cpuinfo_free_temporary(sysfs_caches);
+	cpuinfo_free_temporary(sysfs_cache_indices);
+	cpuinfo_free_temporary(uarchs_list);
+	cpuinfo_arena_free(arena.memory);
+}
@@ -0,0 +1,38 @@
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <riscv/linux/api.h>
+#include <cpuinfo/log.h>
+
+
+void cpuinfo_riscv_linux_decode_isa(
+	uint64_t features,
+	struct cpuinfo_riscv_isa isa[restrict static 1])
+{
+	isa->i = !!(features & CPUINFO_RISCV_LINUX_FEATURE_I);
+	isa->m = !!(features & CPUINFO_RISCV_LINUX_FEATURE_M);
+	isa->a = !!(features & CPUINFO_RISCV_LINUX_FEATURE_A);
+	isa->f = !!(features & CPUINFO_RISCV_LINUX_FEATURE_F);
+	isa->d = !!(features & CPUINFO_RISCV_LINUX_FEATURE_D);
+	isa->c = !!(features & CPUINFO_RISCV_LINUX_FEATURE_C);
+	isa->v = !!(features & CPUINFO_RISCV_LINUX_FEATURE_V);
+
+	isa->zba = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZBA);
+	isa->zbb = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZBB);
+	isa->zbc = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZBC);
+	isa->zbs = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZBS);
+	isa->zicboz = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZICBOZ);
+	isa->zicond = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZICOND);
+
+	isa->zfh = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZFH);
+	/* Zfh includes all instructions of Zfhmin */
+	isa->zfhmin = !!(features & (CPUINFO_RISCV_LINUX_FEATURE_ZFH | CPUINFO_RISCV_LINUX_FEATURE_ZFHMIN));
+
+	/* Vector crypto and half-precision extensions depend on the V extension, which the kernel may leave disabled */
+	if (isa->v) {
+		isa->zvbb = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZVBB);
+		isa->zvbc = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZVBC);
+		isa->zvfh = !!(features & CPUINFO_RISCV_LINUX_FEATURE_ZVFH);
+	}
+	cpuinfo_log_debug("decoded RISC-V extensions 0x%016"PRIx64, features);
+}
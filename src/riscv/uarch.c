@@ -0,0 +1,66 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <riscv/api.h>
+#include <cpuinfo/log.h>
+
+
+/* Prefixes of device tree compatible strings of cores, e.g. "sifive,u74-mc" */
+static const struct {
+	const char* prefix;
+	enum cpuinfo_vendor vendor;
+	enum cpuinfo_uarch uarch;
+} uarch_names[] = {
+	{ "sifive,u54",  cpuinfo_vendor_sifive, cpuinfo_uarch_sifive_u54 },
+	{ "sifive,u74",  cpuinfo_vendor_sifive, cpuinfo_uarch_sifive_u74 },
+	{ "sifive,p550", cpuinfo_vendor_sifive, cpuinfo_uarch_sifive_p550 },
+	{ "sifive,x280", cpuinfo_vendor_sifive, cpuinfo_uarch_sifive_x280 },
+	{ "thead,c906",  cpuinfo_vendor_thead,  cpuinfo_uarch_thead_c906 },
+	{ "thead,c910",  cpuinfo_vendor_thead,  cpuinfo_uarch_thead_c910 },
+	{ "thead,c920",  cpuinfo_vendor_thead,  cpuinfo_uarch_thead_c920 },
+};
+
+void cpuinfo_riscv_decode_vendor_uarch(
+	uint32_t mvendorid,
+	uint64_t marchid,
+	const char uarch_name[restrict static CPUINFO_RISCV_UARCH_NAME_MAX],
+	enum cpuinfo_vendor vendor[restrict static 1],
+	enum cpuinfo_uarch uarch[restrict static 1])
+{
+	*vendor = cpuinfo_vendor_unknown;
+	*uarch = cpuinfo_uarch_unknown;
+	switch (mvendorid) {
+		case CPUINFO_RISCV_MVENDORID_SIFIVE:
+			*vendor = cpuinfo_vendor_sifive;
+			/* Bit 63 of marchid is set for proprietary implementations */
+			switch (marchid) {
+				case UINT64_C(0x8000000000000007):
+					*uarch = cpuinfo_uarch_sifive_u74;
+					break;
+				case UINT64_C(0x8000000000000008):
+					*uarch = cpuinfo_uarch_sifive_p550;
+					break;
+			}
+			break;
+		case CPUINFO_RISCV_MVENDORID_THEAD:
+			/* XuanTie cores report zero marchid and mimpid */
+			*vendor = cpuinfo_vendor_thead;
+			break;
+	}
+	if (*uarch != cpuinfo_uarch_unknown) {
+		return;
+	}
+
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(uarch_names); i++) {
+		const size_t prefix_length = strlen(uarch_names[i].prefix);
+		if (strncmp(uarch_name, uarch_names[i].prefix, prefix_length) == 0) {
+			*vendor = uarch_names[i].vendor;
+			*uarch = uarch_names[i].uarch;
+			return;
+		}
+	}
+	cpuinfo_log_info("unknown RISC-V core with mvendorid 0x%"PRIx32", marchid 0x%"PRIx64", and uarch \"%.*s\"",
+		mvendorid, marchid, CPUINFO_RISCV_UARCH_NAME_MAX, uarch_name);
+}
@@ -0,0 +1,712 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+#if defined(__linux__)
+	#include <dirent.h>
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <time.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#include <linux/perf_event.h>
+	#endif
+
+	#include <linux/api.h>
+#endif
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define CUR_FREQUENCY_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu4294967295/cpufreq/scaling_cur_freq"))
+	#define CUR_FREQUENCY_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/cpufreq/scaling_cur_freq"
+	#define CUR_FREQUENCY_FILESIZE 32
+	#define MAX_FREQUENCY_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu4294967295/cpufreq/scaling_max_freq"))
+	#define MAX_FREQUENCY_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/cpufreq/scaling_max_freq"
+	#define ONLINE_CPULIST_FILENAME "/sys/devices/system/cpu/online"
+
+	/* Cooling devices of the thermal framework; cpufreq cooling devices have type "cpufreq-cpuN" */
+	#define THERMAL_DIRNAME "/sys/class/thermal"
+	#define COOLING_DEVICE_PREFIX "cooling_device"
+	#define COOLING_DEVICE_FILENAME_SIZE (sizeof("/sys/class/thermal/cooling_device4294967295/max_state"))
+	#define COOLING_DEVICE_FILENAME_FORMAT "/sys/class/thermal/%s/%s"
+	#define COOLING_DEVICE_TYPE_PREFIX "cpufreq-cpu"
+	#define COOLING_DEVICE_FILESIZE 32
+
+	#if !defined(O_CLOEXEC)
+		#define O_CLOEXEC 0
+	#endif
+#endif
+
+#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+	#define MSR_FILENAME_SIZE (sizeof("/dev/cpu/4294967295/msr"))
+	#define MSR_FILENAME_FORMAT "/dev/cpu/%" PRIu32 "/msr"
+	#define MSR_IA32_TIME_STAMP_COUNTER UINT32_C(0x00000010)
+	#define MSR_IA32_MPERF UINT32_C(0x000000E7)
+	#define MSR_IA32_APERF UINT32_C(0x000000E8)
+
+	/* Type of the msr PMU of perf_event, and configs of its events, as in the kernel arch/x86/events/msr.c */
+	#define PERF_MSR_TYPE_FILENAME "/sys/bus/event_source/devices/msr/type"
+	#define PERF_MSR_TYPE_FILESIZE 16
+	#define PERF_MSR_TSC   0
+	#define PERF_MSR_APERF 1
+	#define PERF_MSR_MPERF 2
+
+	#define UNCORE_FREQUENCY_FILENAME_SIZE \
+		(sizeof("/sys/devices/system/cpu/intel_uncore_frequency/package_4294967295_die_4294967295/current_freq_khz"))
+	#define UNCORE_FREQUENCY_FILENAME_FORMAT \
+		"/sys/devices/system/cpu/intel_uncore_frequency/package_%02" PRIu32 "_die_%02" PRIu32 "/current_freq_khz"
+
+	enum counter_method {
+		counter_method_none = 0,
+		/* pread of /dev/cpu/N/msr: requires CAP_SYS_RAWIO and the msr driver */
+		counter_method_msr_device = 1,
+		/* perf_event msr PMU: requires CAP_PERFMON or a permissive perf_event_paranoid */
+		counter_method_perf_event = 2,
+	};
+
+	/* Counters of a core at a sample */
+	struct core_counters {
+		uint64_t tsc;
+		uint64_t aperf;
+		uint64_t mperf;
+		/* CLOCK_MONOTONIC time of the sample, in nanoseconds */
+		uint64_t timestamp;
+	};
+
+	/* Open files of a core: MSR device, or perf_event files for TSC, APERF, MPERF */
+	struct core_files {
+		int files[3];
+	};
+#endif
+
+/* Parameters of a cluster at creation of the sampler */
+struct cluster_info {
+	uint32_t processor_count;
+	/* Index of the frequency domain of the first processor, or UINT32_MAX */
+	uint32_t domain_index;
+	/* Maximum frequency supported by the hardware, in Hz, or 0 if unknown */
+	uint64_t max_frequency;
+};
+
+#if defined(__linux__)
+	/* Cooling device of the thermal framework which caps the frequency of a frequency domain */
+	struct cooling_device {
+		/* cur_state file, or -1 */
+		int file;
+		uint32_t max_state;
+	};
+#endif
+
+struct cpuinfo_frequency_sampler {
+	uint32_t domains_count;
+	uint32_t uncore_domains_count;
+	uint32_t cores_count;
+	uint32_t clusters_count;
+	struct cluster_info* clusters;
+#if defined(__linux__)
+	/* scaling_cur_freq file of every frequency domain, or -1 */
+	int* domain_files;
+	/* scaling_max_freq file of every frequency domain, or -1 */
+	int* domain_max_files;
+	struct cooling_device* domain_cooling_devices;
+	/* Index of the cluster of every Linux processor ID up to the maximum in the tables, or UINT32_MAX */
+	uint32_t* linux_id_clusters;
+	uint32_t linux_ids_count;
+#endif
+#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+	enum counter_method counter_method;
+	struct core_files* core_files;
+	/* Counters of every core at its previous sample; all zeroes before the first sample */
+	struct core_counters* core_counters;
+	/* current_freq_khz file of every uncore domain, or -1 */
+	int* uncore_files;
+#endif
+};
+
+#if defined(__linux__)
+	/* Parse a decimal number at the start of the buffer */
+	static uint64_t parse_uint64(const char* text, size_t length) {
+		uint64_t value = 0;
+		for (size_t i = 0; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+			value = value * 10 + (uint64_t) (text[i] - '0');
+		}
+		return value;
+	}
+
+	static uint64_t read_cur_frequency(int file) {
+		char buffer[CUR_FREQUENCY_FILESIZE];
+		/* sysfs attributes are regenerated on every read from offset 0 */
+		const ssize_t bytes_read = pread(file, buffer, sizeof(buffer), 0);
+		if (bytes_read <= 0) {
+			return 0;
+		}
+		return parse_uint64(buffer, (size_t) bytes_read) * UINT64_C(1000);
+	}
+
+	/* Format the path of a file of a cooling device, or return false if it doesn't fit */
+	static bool format_cooling_device_filename(char filename[restrict static COOLING_DEVICE_FILENAME_SIZE],
+		const char* device, const char* name)
+	{
+		const int chars_formatted = snprintf(filename, COOLING_DEVICE_FILENAME_SIZE, COOLING_DEVICE_FILENAME_FORMAT,
+			device, name);
+		return (unsigned int) chars_formatted < COOLING_DEVICE_FILENAME_SIZE;
+	}
+
+	static bool parse_cooling_device_type(const char* text_start, const char* text_end, void* context) {
+		const size_t prefix_length = sizeof(COOLING_DEVICE_TYPE_PREFIX) - 1;
+		const size_t length = (size_t) (text_end - text_start);
+		if (length <= prefix_length || memcmp(text_start, COOLING_DEVICE_TYPE_PREFIX, prefix_length) != 0 ||
+			text_start[prefix_length] < '0' || text_start[prefix_length] > '9')
+		{
+			return false;
+		}
+		*((uint32_t*) context) = (uint32_t) parse_uint64(text_start + prefix_length, length - prefix_length);
+		return true;
+	}
+
+	static bool parse_cooling_device_state(const char* text_start, const char* text_end, void* context) {
+		*((uint32_t*) context) = (uint32_t) parse_uint64(text_start, (size_t) (text_end - text_start));
+		return text_start != text_end;
+	}
+
+	/*
+	 * Open cur_state of cpufreq cooling devices: "cpufreq-cpuN" device caps the frequency of the policy of processor N,
+	 * which is the domain_id of the frequency domain.
+	 */
+	static void open_cooling_devices(struct cpuinfo_frequency_sampler sampler[restrict static 1],
+		const struct cpuinfo_tables* tables)
+	{
+		DIR* directory = opendir(THERMAL_DIRNAME);
+		if (directory == NULL) {
+			cpuinfo_log_debug("failed to open %s: %s", THERMAL_DIRNAME, strerror(errno));
+			return;
+		}
+		struct dirent* entry;
+		while ((entry = readdir(directory)) != NULL) {
+			if (strncmp(entry->d_name, COOLING_DEVICE_PREFIX, sizeof(COOLING_DEVICE_PREFIX) - 1) != 0) {
+				continue;
+			}
+			char filename[COOLING_DEVICE_FILENAME_SIZE];
+			uint32_t linux_id = UINT32_MAX;
+			if (!format_cooling_device_filename(filename, entry->d_name, "type") ||
+				!cpuinfo_linux_parse_small_file(filename, COOLING_DEVICE_FILESIZE,
+					parse_cooling_device_type, &linux_id))
+			{
+				continue;
+			}
+			for (uint32_t i = 0; i < sampler->domains_count; i++) {
+				struct cooling_device* device = &sampler->domain_cooling_devices[i];
+				if (tables->frequency_domains[i].domain_id != linux_id || device->file != -1) {
+					continue;
+				}
+				if (!format_cooling_device_filename(filename, entry->d_name, "max_state") ||
+					!cpuinfo_linux_parse_small_file(filename, COOLING_DEVICE_FILESIZE,
+						parse_cooling_device_state, &device->max_state) ||
+					!format_cooling_device_filename(filename, entry->d_name, "cur_state"))
+				{
+					break;
+				}
+				device->file = open(filename, O_RDONLY | O_CLOEXEC);
+				if (device->file == -1) {
+					cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
+				}
+				break;
+			}
+		}
+		closedir(directory);
+	}
+
+	static uint32_t read_cooling_state(int file) {
+		char buffer[COOLING_DEVICE_FILESIZE];
+		const ssize_t bytes_read = pread(file, buffer, sizeof(buffer), 0);
+		if (bytes_read <= 0) {
+			return UINT32_MAX;
+		}
+		return (uint32_t) parse_uint64(buffer, (size_t) bytes_read);
+	}
+
+	struct online_processors_context {
+		const struct cpuinfo_frequency_sampler* sampler;
+		struct cpuinfo_cluster_capacity* capacities;
+		uint32_t cluster_start;
+		uint32_t cluster_count;
+	};
+
+	static bool count_online_processors(uint32_t linux_id_start, uint32_t linux_id_end, void* context) {
+		const struct online_processors_context* online_context = context;
+		const struct cpuinfo_frequency_sampler* sampler = online_context->sampler;
+		if (linux_id_end > sampler->linux_ids_count) {
+			linux_id_end = sampler->linux_ids_count;
+		}
+		for (uint32_t linux_id = linux_id_start; linux_id < linux_id_end; linux_id++) {
+			const uint32_t cluster_index = sampler->linux_id_clusters[linux_id];
+			if (cluster_index - online_context->cluster_start < online_context->cluster_count) {
+				online_context->capacities[cluster_index - online_context->cluster_start].online_processors += 1;
+			}
+		}
+		return true;
+	}
+#endif
+
+#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+	static bool read_core_counters(enum counter_method method, const struct core_files* files,
+		struct core_counters counters[restrict static 1])
+	{
+		switch (method) {
+			case counter_method_msr_device:
+				return pread(files->files[0], &counters->tsc, sizeof(uint64_t), MSR_IA32_TIME_STAMP_COUNTER) == sizeof(uint64_t) &&
+					pread(files->files[0], &counters->aperf, sizeof(uint64_t), MSR_IA32_APERF) == sizeof(uint64_t) &&
+					pread(files->files[0], &counters->mperf, sizeof(uint64_t), MSR_IA32_MPERF) == sizeof(uint64_t);
+			case counter_method_perf_event:
+				return read(files->files[0], &counters->tsc, sizeof(uint64_t)) == sizeof(uint64_t) &&
+					read(files->files[1], &counters->aperf, sizeof(uint64_t)) == sizeof(uint64_t) &&
+					read(files->files[2], &counters->mperf, sizeof(uint64_t)) == sizeof(uint64_t);
+			default:
+				return false;
+		}
+	}
+
+	static void close_core_files(enum counter_method method, struct core_files files[restrict static 1]) {
+		const uint32_t files_count = method == counter_method_perf_event ? 3 : 1;
+		for (uint32_t i = 0; i < files_count; i++) {
+			if (files->files[i] != -1) {
+				close(files->files[i]);
+				files->files[i] = -1;
+			}
+		}
+	}
+
+	static bool open_msr_device(uint32_t linux_id, struct core_files files[restrict static 1]) {
+		char filename[MSR_FILENAME_SIZE];
+		snprintf(filename, MSR_FILENAME_SIZE, MSR_FILENAME_FORMAT, linux_id);
+		files->files[0] = open(filename, O_RDONLY | O_CLOEXEC);
+		if (files->files[0] == -1) {
+			cpuinfo_log_debug("failed to open %s: %s", filename, strerror(errno));
+			return false;
+		}
+		struct core_counters counters;
+		if (!read_core_counters(counter_method_msr_device, files, &counters)) {
+			cpuinfo_log_debug("failed to read APERF/MPERF from %s: %s", filename, strerror(errno));
+			close_core_files(counter_method_msr_device, files);
+			return false;
+		}
+		return true;
+	}
+
+	static bool parse_perf_type(const char* text_start, const char* text_end, void* context) {
+		*((uint32_t*) context) = (uint32_t) parse_uint64(text_start, (size_t) (text_end - text_start));
+		return text_start != text_end;
+	}
+
+	static bool open_perf_events(uint32_t perf_type, uint32_t linux_id, struct core_files files[restrict static 1]) {
+		static const uint64_t configs[3] = { PERF_MSR_TSC, PERF_MSR_APERF, PERF_MSR_MPERF };
+		for (uint32_t i = 0; i < 3; i++) {
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = perf_type;
+			attr.size = sizeof(attr);
+			attr.config = configs[i];
+			files->files[i] = (int) syscall(__NR_perf_event_open, &attr, -1 /* any process */, (int) linux_id,
+				-1 /* no group */, PERF_FLAG_FD_CLOEXEC);
+			if (files->files[i] == -1) {
+				cpuinfo_log_debug("failed to open perf_event msr counter %"PRIu64" on processor %"PRIu32": %s",
+					configs[i], linux_id, strerror(errno));
+				close_core_files(counter_method_perf_event, files);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/* Open APERF/MPERF counters of all cores with the first method which works for the first core */
+	static void open_core_counters(struct cpuinfo_frequency_sampler sampler[restrict static 1],
+		const struct cpuinfo_tables* tables)
+	{
+		for (uint32_t i = 0; i < sampler->cores_count; i++) {
+			for (uint32_t j = 0; j < 3; j++) {
+				sampler->core_files[i].files[j] = -1;
+			}
+		}
+
+		uint32_t perf_type = UINT32_MAX;
+		if (!cpuinfo_linux_parse_small_file(PERF_MSR_TYPE_FILENAME, PERF_MSR_TYPE_FILESIZE, parse_perf_type, &perf_type)) {
+			perf_type = UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < sampler->cores_count; i++) {
+			const struct cpuinfo_core* core = &tables->cores[i];
+			const uint32_t linux_id = (uint32_t) tables->processors[core->processor_start].linux_id;
+			struct core_files* files = &sampler->core_files[i];
+			switch (sampler->counter_method) {
+				case counter_method_none:
+					if (i != 0) {
+						return;
+					}
+					if (open_msr_device(linux_id, files)) {
+						sampler->counter_method = counter_method_msr_device;
+					} else if (perf_type != UINT32_MAX && open_perf_events(perf_type, linux_id, files)) {
+						sampler->counter_method = counter_method_perf_event;
+					} else {
+						cpuinfo_log_info("APERF/MPERF counters are not accessible: effective frequency is unknown");
+						return;
+					}
+					break;
+				case counter_method_msr_device:
+					open_msr_device(linux_id, files);
+					break;
+				case counter_method_perf_event:
+					open_perf_events(perf_type, linux_id, files);
+					break;
+			}
+		}
+	}
+#endif
+
+struct cpuinfo_frequency_sampler* CPUINFO_ABI cpuinfo_create_frequency_sampler(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("frequency_sampler");
+	struct cpuinfo_frequency_sampler* sampler = calloc(1, sizeof(struct cpuinfo_frequency_sampler));
+	if (sampler == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for frequency sampler", sizeof(struct cpuinfo_frequency_sampler));
+		return NULL;
+	}
+	sampler->domains_count = tables->frequency_domains_count;
+	sampler->cores_count = tables->cores_count;
+	sampler->clusters_count = tables->clusters_count;
+
+	sampler->clusters = calloc(sampler->clusters_count, sizeof(struct cluster_info));
+	if (sampler->clusters_count != 0 && sampler->clusters == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for %"PRIu32" clusters",
+			sampler->clusters_count * sizeof(struct cluster_info), sampler->clusters_count);
+		goto failure;
+	}
+	for (uint32_t i = 0; i < sampler->clusters_count; i++) {
+		const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+		struct cluster_info* info = &sampler->clusters[i];
+		info->processor_count = cluster->processor_count;
+		info->domain_index = UINT32_MAX;
+		const struct cpuinfo_frequency_domain* domain = cluster->processor_count != 0 ?
+			tables->processors[cluster->processor_start].frequency_domain : NULL;
+		if (domain != NULL) {
+			info->domain_index = (uint32_t) (domain - tables->frequency_domains);
+			info->max_frequency = domain->max_frequency;
+		}
+	}
+
+	#if defined(__linux__)
+		sampler->domain_files = malloc(sampler->domains_count * sizeof(int));
+		sampler->domain_max_files = malloc(sampler->domains_count * sizeof(int));
+		sampler->domain_cooling_devices = malloc(sampler->domains_count * sizeof(struct cooling_device));
+		if (sampler->domains_count != 0 && (sampler->domain_files == NULL || sampler->domain_max_files == NULL ||
+			sampler->domain_cooling_devices == NULL))
+		{
+			cpuinfo_log_error("failed to allocate files of %"PRIu32" frequency domains", sampler->domains_count);
+			goto failure;
+		}
+		for (uint32_t i = 0; i < sampler->domains_count; i++) {
+			const struct cpuinfo_frequency_domain* domain = &tables->frequency_domains[i];
+			sampler->domain_files[i] = -1;
+			sampler->domain_max_files[i] = -1;
+			sampler->domain_cooling_devices[i] = (struct cooling_device) { .file = -1 };
+			if (domain->domain_id == UINT32_MAX || domain->processor_count == 0) {
+				continue;
+			}
+			const uint32_t linux_id = (uint32_t) tables->processors[domain->processor_start].linux_id;
+			char filename[CUR_FREQUENCY_FILENAME_SIZE];
+			snprintf(filename, CUR_FREQUENCY_FILENAME_SIZE, CUR_FREQUENCY_FILENAME_FORMAT, linux_id);
+			sampler->domain_files[i] = open(filename, O_RDONLY | O_CLOEXEC);
+			if (sampler->domain_files[i] == -1) {
+				cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
+			}
+			char max_filename[MAX_FREQUENCY_FILENAME_SIZE];
+			snprintf(max_filename, MAX_FREQUENCY_FILENAME_SIZE, MAX_FREQUENCY_FILENAME_FORMAT, linux_id);
+			sampler->domain_max_files[i] = open(max_filename, O_RDONLY | O_CLOEXEC);
+			if (sampler->domain_max_files[i] == -1) {
+				cpuinfo_log_info("failed to open %s: %s", max_filename, strerror(errno));
+			}
+		}
+		open_cooling_devices(sampler, tables);
+
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const uint32_t linux_id = (uint32_t) tables->processors[i].linux_id;
+			if (linux_id >= sampler->linux_ids_count) {
+				sampler->linux_ids_count = linux_id + 1;
+			}
+		}
+		sampler->linux_id_clusters = malloc(sampler->linux_ids_count * sizeof(uint32_t));
+		if (sampler->linux_ids_count != 0 && sampler->linux_id_clusters == NULL) {
+			cpuinfo_log_error("failed to allocate clusters of %"PRIu32" Linux processor IDs", sampler->linux_ids_count);
+			goto failure;
+		}
+		for (uint32_t i = 0; i < sampler->linux_ids_count; i++) {
+			sampler->linux_id_clusters[i] = UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			if (processor->cluster != NULL) {
+				sampler->linux_id_clusters[processor->linux_id] = (uint32_t) (processor->cluster - tables->clusters);
+			}
+		}
+	#endif
+	#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+		sampler->core_files = malloc(sampler->cores_count * sizeof(struct core_files));
+		sampler->core_counters = calloc(sampler->cores_count, sizeof(struct core_counters));
+		if (sampler->cores_count != 0 && (sampler->core_files == NULL || sampler->core_counters == NULL)) {
+			cpuinfo_log_error("failed to allocate counters of %"PRIu32" cores", sampler->cores_count);
+			goto failure;
+		}
+		open_core_counters(sampler, tables);
+
+		sampler->uncore_domains_count = tables->uncore_domains_count;
+		sampler->uncore_files = malloc(sampler->uncore_domains_count * sizeof(int));
+		if (sampler->uncore_domains_count != 0 && sampler->uncore_files == NULL) {
+			cpuinfo_log_error("failed to allocate files of %"PRIu32" uncore domains", sampler->uncore_domains_count);
+			goto failure;
+		}
+		for (uint32_t i = 0; i < sampler->uncore_domains_count; i++) {
+			const struct cpuinfo_uncore_domain* domain = &tables->uncore_domains[i];
+			char filename[UNCORE_FREQUENCY_FILENAME_SIZE];
+			snprintf(filename, UNCORE_FREQUENCY_FILENAME_SIZE, UNCORE_FREQUENCY_FILENAME_FORMAT,
+				domain->package_id, domain->die_id);
+			sampler->uncore_files[i] = open(filename, O_RDONLY | O_CLOEXEC);
+			if (sampler->uncore_files[i] == -1) {
+				cpuinfo_log_info("failed to open %s: %s", filename, strerror(errno));
+			}
+		}
+	#endif
+	return sampler;
+
+failure:
+	cpuinfo_destroy_frequency_sampler(sampler);
+	return NULL;
+}
+
+void CPUINFO_ABI cpuinfo_destroy_frequency_sampler(struct cpuinfo_frequency_sampler* sampler) {
+	if (sampler == NULL) {
+		return;
+	}
+	#if defined(__linux__)
+		if (sampler->domain_files != NULL) {
+			for (uint32_t i = 0; i < sampler->domains_count; i++) {
+				if (sampler->domain_files[i] != -1) {
+					close(sampler->domain_files[i]);
+				}
+			}
+			free(sampler->domain_files);
+		}
+		if (sampler->domain_max_files != NULL) {
+			for (uint32_t i = 0; i < sampler->domains_count; i++) {
+				if (sampler->domain_max_files[i] != -1) {
+					close(sampler->domain_max_files[i]);
+				}
+			}
+			free(sampler->domain_max_files);
+		}
+		if (sampler->domain_cooling_devices != NULL) {
+			for (uint32_t i = 0; i < sampler->domains_count; i++) {
+				if (sampler->domain_cooling_devices[i].file != -1) {
+					close(sampler->domain_cooling_devices[i].file);
+				}
+			}
+			free(sampler->domain_cooling_devices);
+		}
+		free(sampler->linux_id_clusters);
+	#endif
+	#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+		if (sampler->core_files != NULL) {
+			if (sampler->counter_method != counter_method_none) {
+				for (uint32_t i = 0; i < sampler->cores_count; i++) {
+					close_core_files(sampler->counter_method, &sampler->core_files[i]);
+				}
+			}
+			free(sampler->core_files);
+		}
+		free(sampler->core_counters);
+		if (sampler->uncore_files != NULL) {
+			for (uint32_t i = 0; i < sampler->uncore_domains_count; i++) {
+				if (sampler->uncore_files[i] != -1) {
+					close(sampler->uncore_files[i]);
+				}
+			}
+			free(sampler->uncore_files);
+		}
+	#endif
+	free(sampler->clusters);
+	free(sampler);
+}
+
+bool CPUINFO_ABI cpuinfo_sample_domain_frequencies(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t domain_start,
+	uint32_t domain_count,
+	uint64_t* frequencies)
+{
+	if (sampler == NULL || domain_start > sampler->domains_count || domain_count > sampler->domains_count - domain_start) {
+		return false;
+	}
+	bool sampled = false;
+	for (uint32_t i = 0; i < domain_count; i++) {
+		frequencies[i] = 0;
+		#if defined(__linux__)
+			const int file = sampler->domain_files[domain_start + i];
+			if (file != -1) {
+				frequencies[i] = read_cur_frequency(file);
+				sampled |= frequencies[i] != 0;
+			}
+		#endif
+	}
+	return sampled;
+}
+
+bool CPUINFO_ABI cpuinfo_sample_uncore_frequencies(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t domain_start,
+	uint32_t domain_count,
+	uint64_t* frequencies)
+{
+	if (sampler == NULL || domain_start > sampler->uncore_domains_count ||
+		domain_count > sampler->uncore_domains_count - domain_start)
+	{
+		return false;
+	}
+	bool sampled = false;
+	for (uint32_t i = 0; i < domain_count; i++) {
+		frequencies[i] = 0;
+		#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+			const int file = sampler->uncore_files[domain_start + i];
+			if (file != -1) {
+				frequencies[i] = read_cur_frequency(file);
+				sampled |= frequencies[i] != 0;
+			}
+		#endif
+	}
+	return sampled;
+}
+
+bool CPUINFO_ABI cpuinfo_sample_core_frequencies(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t core_start,
+	uint32_t core_count,
+	uint64_t* frequencies)
+{
+	if (sampler == NULL || core_start > sampler->cores_count || core_count > sampler->cores_count - core_start) {
+		return false;
+	}
+	for (uint32_t i = 0; i < core_count; i++) {
+		frequencies[i] = 0;
+	}
+	#if defined(__linux__) && (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+		if (sampler->counter_method == counter_method_none) {
+			return false;
+		}
+		struct timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		const uint64_t timestamp = (uint64_t) time.tv_sec * UINT64_C(1000000000) + (uint64_t) time.tv_nsec;
+		for (uint32_t i = 0; i < core_count; i++) {
+			const uint32_t core_index = core_start + i;
+			struct core_counters counters;
+			if (sampler->core_files[core_index].files[0] == -1 ||
+				!read_core_counters(sampler->counter_method, &sampler->core_files[core_index], &counters))
+			{
+				continue;
+			}
+
+			/*
+			 * MPERF counts at the TSC rate, and APERF at the actual clock rate, while the core is not halted: the ratio
+			 * of APERF and MPERF increments scales TSC rate to the average clock rate of the core while it was busy.
+			 * TSC rate is estimated from TSC increments over monotonic time between samples.
+			 */
+			counters.timestamp = timestamp;
+			struct core_counters* previous = &sampler->core_counters[core_index];
+			if (previous->timestamp != 0 && timestamp > previous->timestamp &&
+				counters.tsc > previous->tsc && counters.mperf > previous->mperf)
+			{
+				const double tsc_rate = (double) (counters.tsc - previous->tsc) * 1.0e+9 /
+					(double) (timestamp - previous->timestamp);
+				frequencies[i] = (uint64_t) (tsc_rate *
+					(double) (counters.aperf - previous->aperf) / (double) (counters.mperf - previous->mperf));
+			}
+			*previous = counters;
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_sample_cluster_capacities(
+	struct cpuinfo_frequency_sampler* sampler,
+	uint32_t cluster_start,
+	uint32_t cluster_count,
+	struct cpuinfo_cluster_capacity* capacities)
+{
+	if (sampler == NULL || cluster_start > sampler->clusters_count ||
+		cluster_count > sampler->clusters_count - cluster_start)
+	{
+		return false;
+	}
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		capacities[i] = (struct cpuinfo_cluster_capacity) {
+			.online_processors = sampler->clusters[cluster_start + i].processor_count,
+			.capacity_scale = CPUINFO_CAPACITY_SCALE,
+		};
+	}
+	#if defined(__linux__)
+		bool sampled = false;
+		for (uint32_t i = 0; i < cluster_count; i++) {
+			capacities[i].online_processors = 0;
+		}
+		struct online_processors_context context = {
+			.sampler = sampler,
+			.capacities = capacities,
+			.cluster_start = cluster_start,
+			.cluster_count = cluster_count,
+		};
+		if (cpuinfo_linux_parse_cpulist(ONLINE_CPULIST_FILENAME, count_online_processors, &context)) {
+			sampled = true;
+		} else {
+			for (uint32_t i = 0; i < cluster_count; i++) {
+				capacities[i].online_processors = sampler->clusters[cluster_start + i].processor_count;
+			}
+		}
+
+		for (uint32_t i = 0; i < cluster_count; i++) {
+			const struct cluster_info* info = &sampler->clusters[cluster_start + i];
+			struct cpuinfo_cluster_capacity* capacity = &capacities[i];
+			if (info->domain_index != UINT32_MAX) {
+				const int max_file = sampler->domain_max_files[info->domain_index];
+				if (max_file != -1) {
+					capacity->max_frequency = read_cur_frequency(max_file);
+					sampled |= capacity->max_frequency != 0;
+				}
+				const struct cooling_device* device = &sampler->domain_cooling_devices[info->domain_index];
+				if (device->file != -1) {
+					const uint32_t state = read_cooling_state(device->file);
+					if (state != UINT32_MAX) {
+						capacity->cooling_state = state;
+						capacity->max_cooling_state = device->max_state;
+						sampled = true;
+					}
+				}
+			}
+
+			uint64_t scale = info->processor_count != 0 ?
+				(uint64_t) CPUINFO_CAPACITY_SCALE * capacity->online_processors / info->processor_count : 0;
+			if (capacity->max_frequency != 0 && capacity->max_frequency < info->max_frequency) {
+				scale = scale * capacity->max_frequency / info->max_frequency;
+			}
+			capacity->capacity_scale = (uint32_t) scale;
+		}
+		return sampled;
+	#else
+		return false;
+	#endif
+}
@@ -0,0 +1,1040 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <time.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/types.h>
+
+	#include <linux/api.h>
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* Fingerprints describe the current hardware, and must not come from the recorded CPUID leaves */
+		#define CPUINFO_X86_CPUID_UNCACHED 1
+		#include <x86/cpuid.h>
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		#include <arm/linux/api.h>
+	#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		#include <riscv/linux/api.h>
+	#elif CPUINFO_ARCH_LOONGARCH64
+		#include <sys/auxv.h>
+
+		#include <loongarch/cpucfg.h>
+	#endif
+#endif
+
+
+#if defined(__linux__)
+
+#define SNAPSHOT_VERSION 10
+#define SNAPSHOT_ALIGNMENT 64
+
+#define BOOT_ID_FILENAME "/proc/sys/kernel/random/boot_id"
+#define BOOT_ID_FILESIZE 64
+#define POSSIBLE_CPULIST_FILENAME "/sys/devices/system/cpu/possible"
+#define PRESENT_CPULIST_FILENAME "/sys/devices/system/cpu/present"
+#define CPULIST_FILESIZE 4096
+#define MIDR_FILENAME_SIZE (sizeof("/sys/devices/system/cpu/cpu4294967295/regs/identification/midr_el1"))
+#define MIDR_FILENAME_FORMAT "/sys/devices/system/cpu/cpu%" PRIu32 "/regs/identification/midr_el1"
+#define MIDR_FILESIZE 32
+
+#define FNV_OFFSET_BASIS UINT64_C(0xCBF29CE484222325)
+#define FNV_PRIME        UINT64_C(0x00000100000001B3)
+
+static const char snapshot_magic[8] = { 'C', 'P', 'U', 'I', 'N', 'F', 'O', 'S' };
+
+struct snapshot_table {
+	/* Offset of the table from the start of the file */
+	uint64_t offset;
+	/* Number of entries in the table */
+	uint32_t count;
+	/* Size of a table entry, used to reject snapshots produced by an ABI-incompatible build */
+	uint32_t entry_size;
+};
+
+struct snapshot_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	uint64_t file_size;
+	/* Hash of the system properties the snapshot is valid for */
+	uint64_t fingerprint;
+	/* Hash of the snapshot contents, excluding the magic and the checksum itself */
+	uint64_t checksum;
+	/*
+	 * Address the snapshot is laid out for, or 0 if references between tables are encoded as entry indices plus one.
+	 * Shared snapshots store absolute references, so processes which map them at the same address don't modify them.
+	 */
+	uint64_t base_address;
+	struct snapshot_table processors;
+	struct snapshot_table cores;
+	struct snapshot_table clusters;
+	struct snapshot_table packages;
+	struct snapshot_table uarchs;
+	/* TLBs of every microarchitecture, or an empty table if they are unknown */
+	struct snapshot_table uarch_tlbs;
+	struct snapshot_table cache[cpuinfo_cache_level_max];
+	struct snapshot_table isa;
+	struct snapshot_table linux_cpu_to_processor_map;
+	struct snapshot_table linux_cpu_to_core_map;
+	struct snapshot_table linux_cpu_to_uarch_index_map;
+	/* Measured memory performance of every microarchitecture, or an empty table if the probe didn't run */
+	struct snapshot_table memory_performance;
+	/* Measured latencies between cores, or an empty table if the probe didn't run */
+	struct snapshot_table core_latencies;
+	/* CPUID leaves of the initializing processor (x86 only), which answer CPUID queries of table publication */
+	struct snapshot_table cpuid_leaves;
+	uint32_t max_cache_size;
+	uint32_t linux_cpu_max;
+	struct cpuinfo_integrated_gpu integrated_gpu;
+	struct cpuinfo_npu npu;
+};
+
+void* cpuinfo_snapshot_mapping = NULL;
+size_t cpuinfo_snapshot_mapping_size = 0;
+
+static inline size_t align_offset(size_t offset) {
+	return (offset + (SNAPSHOT_ALIGNMENT - 1)) & ~(size_t) (SNAPSHOT_ALIGNMENT - 1);
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+	const uint8_t* bytes = (const uint8_t*) data;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ (uint64_t) bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+static bool hash_file_parser(const char* text_start, const char* text_end, void* context) {
+	uint64_t* hash_ptr = (uint64_t*) context;
+	*hash_ptr = hash_bytes(*hash_ptr, text_start, (size_t) (text_end - text_start));
+	return true;
+}
+
+static uint64_t compute_checksum(const void* snapshot, size_t size) {
+	struct snapshot_header header;
+	memcpy(&header, snapshot, sizeof(header));
+	memset(header.magic, 0, sizeof(header.magic));
+	header.checksum = 0;
+	const uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, &header, sizeof(header));
+
+	/* Tables are hashed by 64-bit words: byte-wise hashing would dominate attaching to a large snapshot */
+	const uint64_t* words = (const uint64_t*) ((uintptr_t) snapshot + sizeof(header));
+	const size_t words_count = (size - sizeof(header)) / sizeof(uint64_t);
+	uint64_t word_hash = hash;
+	for (size_t i = 0; i < words_count; i++) {
+		word_hash = (word_hash ^ words[i]) * FNV_PRIME;
+	}
+	return word_hash;
+}
+
+/*
+ * Compute a fingerprint of the properties which invalidate a snapshot when changed:
+ * - Kernel boot ID changes after every reboot, and thus covers kernel and firmware updates.
+ * - Lists of possible and present processors cover the set of processors visible to the kernel.
+ * - CPUID signature (x86) or MIDR values (ARM) cover moving the snapshot to a different processor model.
+ */
+static uint64_t compute_fingerprint(uint32_t linux_cpu_max) {
+	uint64_t hash = FNV_OFFSET_BASIS;
+	hash = hash_bytes(hash, &linux_cpu_max, sizeof(linux_cpu_max));
+	if (!cpuinfo_linux_parse_small_file(BOOT_ID_FILENAME, BOOT_ID_FILESIZE, hash_file_parser, &hash)) {
+		cpuinfo_log_warning("failed to read kernel boot ID from %s: snapshot may outlive a reboot", BOOT_ID_FILENAME);
+	}
+	cpuinfo_linux_parse_small_file(POSSIBLE_CPULIST_FILENAME, CPULIST_FILESIZE, hash_file_parser, &hash);
+	cpuinfo_linux_parse_small_file(PRESENT_CPULIST_FILENAME, CPULIST_FILESIZE, hash_file_parser, &hash);
+
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		const struct cpuid_regs leaf0 = cpuid(0);
+		hash = hash_bytes(hash, &leaf0, sizeof(leaf0));
+		if (leaf0.eax >= 1) {
+			/* EBX of leaf 1 includes the APIC ID of the current processor, and must be excluded */
+			const struct cpuid_regs leaf1 = cpuid(1);
+			const uint32_t signature[3] = { leaf1.eax, leaf1.ecx, leaf1.edx };
+			hash = hash_bytes(hash, signature, sizeof(signature));
+		}
+		if (leaf0.eax >= 7) {
+			const struct cpuid_regs leaf7 = cpuidex(7, 0);
+			hash = hash_bytes(hash, &leaf7, sizeof(leaf7));
+		}
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		uint32_t hwcap = 0;
+		#if CPUINFO_ARCH_ARM64
+			uint64_t hwcap2 = 0;
+		#else
+			uint32_t hwcap2 = 0;
+		#endif
+		cpuinfo_arm_linux_hwcap_from_getauxval(&hwcap, &hwcap2);
+		hash = hash_bytes(hash, &hwcap, sizeof(hwcap));
+		hash = hash_bytes(hash, &hwcap2, sizeof(hwcap2));
+		#if CPUINFO_ARCH_ARM64
+			for (uint32_t i = 0; i < linux_cpu_max; i++) {
+				char midr_filename[MIDR_FILENAME_SIZE];
+				const int chars_formatted = snprintf(midr_filename, MIDR_FILENAME_SIZE, MIDR_FILENAME_FORMAT, i);
+				if ((unsigned int) chars_formatted < MIDR_FILENAME_SIZE) {
+					cpuinfo_linux_parse_small_file(midr_filename, MIDR_FILESIZE, hash_file_parser, &hash);
+				}
+			}
+		#endif
+	#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		uint64_t features = 0;
+		if (!cpuinfo_riscv_linux_features_from_hwprobe(&features)) {
+			cpuinfo_riscv_linux_features_from_hwcap(&features);
+		}
+		hash = hash_bytes(hash, &features, sizeof(features));
+	#elif CPUINFO_ARCH_LOONGARCH64
+		struct cpuinfo_loongarch_cpucfg cpucfg_words;
+		cpuinfo_loongarch_read_cpucfg(&cpucfg_words);
+		const unsigned long hwcap = getauxval(AT_HWCAP);
+		hash = hash_bytes(hash, &cpucfg_words, sizeof(cpucfg_words));
+		hash = hash_bytes(hash, &hwcap, sizeof(hwcap));
+	#endif
+	return hash;
+}
+
+static uintptr_t encode_pointer(const void* pointer, const void* table, size_t entry_size) {
+	if (pointer == NULL) {
+		return 0;
+	}
+	return ((uintptr_t) pointer - (uintptr_t) table) / entry_size + 1;
+}
+
+/*
+ * Decode a reference stored in a snapshot laid out for stored_base into a pointer into the snapshot mapped at base.
+ * References which already point to the right entry are not written, so that their pages remain shared.
+ */
+static bool decode_pointer(const void** pointer, void* base, uint64_t stored_base, const struct snapshot_table* table) {
+	const uintptr_t stored = (uintptr_t) *pointer;
+	if (stored == 0) {
+		return true;
+	}
+	uintptr_t index = stored - 1;
+	if (stored_base != 0) {
+		const uintptr_t stored_table = (uintptr_t) stored_base + (uintptr_t) table->offset;
+		if (table->count == 0 || stored < stored_table || (stored - stored_table) % table->entry_size != 0) {
+			return false;
+		}
+		index = (stored - stored_table) / table->entry_size;
+	}
+	if (index >= table->count) {
+		return false;
+	}
+	const void* decoded = (const void*) ((uintptr_t) base + (uintptr_t) table->offset + index * table->entry_size);
+	if (decoded != *pointer) {
+		*pointer = decoded;
+	}
+	return true;
+}
+
+static void* table_address(void* base, const struct snapshot_table* table) {
+	if (table->count == 0) {
+		return NULL;
+	}
+	return (void*) ((uintptr_t) base + (uintptr_t) table->offset);
+}
+
+static bool validate_table(const struct snapshot_table* table, size_t entry_size, size_t file_size) {
+	if (table->count != 0 && table->entry_size != entry_size) {
+		return false;
+	}
+	if (table->offset % SNAPSHOT_ALIGNMENT != 0 || table->offset > file_size) {
+		return false;
+	}
+	return (uint64_t) table->count * entry_size <= file_size - table->offset;
+}
+
+static size_t layout_table(struct snapshot_table* table, size_t offset, uint32_t count, size_t entry_size) {
+	offset = align_offset(offset);
+	*table = (struct snapshot_table) {
+		.offset = offset,
+		.count = count,
+		.entry_size = (uint32_t) entry_size,
+	};
+	return offset + count * entry_size;
+}
+
+/* Build the snapshot of the current tables with references encoded as entry indices, and return it in a new buffer */
+static char* build_snapshot(size_t snapshot_size[restrict static 1]) {
+	const struct cpuinfo_uarch_info* uarchs = cpuinfo_uarchs;
+	uint32_t uarchs_count = cpuinfo_uarchs_count;
+	const struct cpuinfo_uarch_tlbs* uarch_tlbs = cpuinfo_uarch_tlbs;
+	#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64)
+		if (uarchs == NULL) {
+			uarchs = &cpuinfo_global_uarch;
+			uarchs_count = 1;
+			uarch_tlbs = &cpuinfo_global_uarch_tlbs;
+		}
+	#endif
+	const uint32_t uarch_tlbs_count = uarch_tlbs != NULL ? uarchs_count : 0;
+	const uint32_t uarch_index_map_count = cpuinfo_linux_cpu_to_uarch_index_map != NULL ? cpuinfo_linux_cpu_max : 0;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		const uint32_t isa_count = 1;
+	#else
+		const uint32_t isa_count = 0;
+	#endif
+	const struct cpuinfo_tables* tables = cpuinfo_load_tables();
+	const struct cpuinfo_memory_performance* memory_performance =
+		tables != NULL ? __atomic_load_n(&tables->memory_performance, __ATOMIC_ACQUIRE) : NULL;
+	const uint32_t memory_performance_count = memory_performance != NULL ? uarchs_count : 0;
+	const uint32_t* core_latencies =
+		tables != NULL ? __atomic_load_n(&tables->core_latencies, __ATOMIC_ACQUIRE) : NULL;
+	const uint32_t core_latencies_count = core_latencies != NULL ? cpuinfo_cores_count * cpuinfo_cores_count : 0;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		const uint32_t cpuid_leaves_count = cpuinfo_x86_cpuid_table.count;
+		const size_t cpuid_leaf_size = sizeof(struct cpuinfo_x86_cpuid_leaf);
+	#else
+		const uint32_t cpuid_leaves_count = 0;
+		const size_t cpuid_leaf_size = 0;
+	#endif
+
+	struct snapshot_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+	header.version = SNAPSHOT_VERSION;
+	header.header_size = sizeof(struct snapshot_header);
+	header.fingerprint = compute_fingerprint(cpuinfo_linux_cpu_max);
+	header.max_cache_size = cpuinfo_max_cache_size;
+	header.integrated_gpu = cpuinfo_integrated_gpu;
+	header.npu = cpuinfo_npu;
+	header.linux_cpu_max = cpuinfo_linux_cpu_max;
+
+	size_t offset = sizeof(struct snapshot_header);
+	offset = layout_table(&header.processors, offset, cpuinfo_processors_count, sizeof(struct cpuinfo_processor));
+	offset = layout_table(&header.cores, offset, cpuinfo_cores_count, sizeof(struct cpuinfo_core));
+	offset = layout_table(&header.clusters, offset, cpuinfo_clusters_count, sizeof(struct cpuinfo_cluster));
+	offset = layout_table(&header.packages, offset, cpuinfo_packages_count, sizeof(struct cpuinfo_package));
+	offset = layout_table(&header.uarchs, offset, uarchs_count, sizeof(struct cpuinfo_uarch_info));
+	offset = layout_table(&header.uarch_tlbs, offset, uarch_tlbs_count, sizeof(struct cpuinfo_uarch_tlbs));
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		offset = layout_table(&header.cache[level], offset, cpuinfo_cache_count[level], sizeof(struct cpuinfo_cache));
+	}
+	offset = layout_table(&header.isa, offset, isa_count, sizeof(cpuinfo_isa));
+	offset = layout_table(&header.linux_cpu_to_processor_map, offset, cpuinfo_linux_cpu_max, sizeof(uint64_t));
+	offset = layout_table(&header.linux_cpu_to_core_map, offset, cpuinfo_linux_cpu_max, sizeof(uint64_t));
+	offset = layout_table(&header.linux_cpu_to_uarch_index_map, offset, uarch_index_map_count, sizeof(uint32_t));
+	offset = layout_table(&header.memory_performance, offset, memory_performance_count,
+		sizeof(struct cpuinfo_memory_performance));
+	offset = layout_table(&header.core_latencies, offset, core_latencies_count, sizeof(uint32_t));
+	offset = layout_table(&header.cpuid_leaves, offset, cpuid_leaves_count, cpuid_leaf_size);
+	const size_t file_size = align_offset(offset);
+	header.file_size = file_size;
+
+	char* buffer = calloc(1, file_size);
+	if (buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for cpuinfo snapshot", file_size);
+		return NULL;
+	}
+	memcpy(buffer, &header, sizeof(header));
+
+	struct cpuinfo_processor* processors = (struct cpuinfo_processor*) (buffer + header.processors.offset);
+	memcpy(processors, cpuinfo_processors, cpuinfo_processors_count * sizeof(struct cpuinfo_processor));
+	for (uint32_t i = 0; i < cpuinfo_processors_count; i++) {
+		processors[i].core = (const struct cpuinfo_core*)
+			encode_pointer(processors[i].core, cpuinfo_cores, sizeof(struct cpuinfo_core));
+		processors[i].cluster = (const struct cpuinfo_cluster*)
+			encode_pointer(processors[i].cluster, cpuinfo_clusters, sizeof(struct cpuinfo_cluster));
+		processors[i].package = (const struct cpuinfo_package*)
+			encode_pointer(processors[i].package, cpuinfo_packages, sizeof(struct cpuinfo_package));
+		/*
+		 * NUMA nodes, frequency domains, and usable processors are not part of the snapshot, and are detected when
+		 * it is published
+		 */
+		processors[i].numa_node = NULL;
+		processors[i].frequency_domain = NULL;
+		processors[i].cache.l1i = (const struct cpuinfo_cache*) encode_pointer(
+			processors[i].cache.l1i, cpuinfo_cache[cpuinfo_cache_level_1i], sizeof(struct cpuinfo_cache));
+		processors[i].cache.l1d = (const struct cpuinfo_cache*) encode_pointer(
+			processors[i].cache.l1d, cpuinfo_cache[cpuinfo_cache_level_1d], sizeof(struct cpuinfo_cache));
+		processors[i].cache.l2 = (const struct cpuinfo_cache*) encode_pointer(
+			processors[i].cache.l2, cpuinfo_cache[cpuinfo_cache_level_2], sizeof(struct cpuinfo_cache));
+		processors[i].cache.l3 = (const struct cpuinfo_cache*) encode_pointer(
+			processors[i].cache.l3, cpuinfo_cache[cpuinfo_cache_level_3], sizeof(struct cpuinfo_cache));
+		processors[i].cache.l4 = (const struct cpuinfo_cache*) encode_pointer(
+			processors[i].cache.l4, cpuinfo_cache[cpuinfo_cache_level_4], sizeof(struct cpuinfo_cache));
+	}
+
+	struct cpuinfo_core* cores = (struct cpuinfo_core*) (buffer + header.cores.offset);
+	memcpy(cores, cpuinfo_cores, cpuinfo_cores_count * sizeof(struct cpuinfo_core));
+	for (uint32_t i = 0; i < cpuinfo_cores_count; i++) {
+		cores[i].cluster = (const struct cpuinfo_cluster*)
+			encode_pointer(cores[i].cluster, cpuinfo_clusters, sizeof(struct cpuinfo_cluster));
+		cores[i].package = (const struct cpuinfo_package*)
+			encode_pointer(cores[i].package, cpuinfo_packages, sizeof(struct cpuinfo_package));
+	}
+
+	struct cpuinfo_cluster* clusters = (struct cpuinfo_cluster*) (buffer + header.clusters.offset);
+	memcpy(clusters, cpuinfo_clusters, cpuinfo_clusters_count * sizeof(struct cpuinfo_cluster));
+	for (uint32_t i = 0; i < cpuinfo_clusters_count; i++) {
+		clusters[i].package = (const struct cpuinfo_package*)
+			encode_pointer(clusters[i].package, cpuinfo_packages, sizeof(struct cpuinfo_package));
+	}
+
+	memcpy(buffer + header.packages.offset, cpuinfo_packages, cpuinfo_packages_count * sizeof(struct cpuinfo_package));
+	memcpy(buffer + header.uarchs.offset, uarchs, uarchs_count * sizeof(struct cpuinfo_uarch_info));
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		if (cpuinfo_cache_count[level] != 0) {
+			memcpy(buffer + header.cache[level].offset, cpuinfo_cache[level],
+				cpuinfo_cache_count[level] * sizeof(struct cpuinfo_cache));
+		}
+	}
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		memcpy(buffer + header.isa.offset, &cpuinfo_isa, sizeof(cpuinfo_isa));
+	#endif
+
+	uint64_t* linux_cpu_to_processor_map = (uint64_t*) (buffer + header.linux_cpu_to_processor_map.offset);
+	uint64_t* linux_cpu_to_core_map = (uint64_t*) (buffer + header.linux_cpu_to_core_map.offset);
+	for (uint32_t i = 0; i < cpuinfo_linux_cpu_max; i++) {
+		linux_cpu_to_processor_map[i] = (uint64_t)
+			encode_pointer(cpuinfo_linux_cpu_to_processor_map[i], cpuinfo_processors, sizeof(struct cpuinfo_processor));
+		linux_cpu_to_core_map[i] = (uint64_t)
+			encode_pointer(cpuinfo_linux_cpu_to_core_map[i], cpuinfo_cores, sizeof(struct cpuinfo_core));
+	}
+	if (uarch_index_map_count != 0) {
+		memcpy(buffer + header.linux_cpu_to_uarch_index_map.offset, cpuinfo_linux_cpu_to_uarch_index_map,
+			uarch_index_map_count * sizeof(uint32_t));
+	}
+	if (uarch_tlbs_count != 0) {
+		memcpy(buffer + header.uarch_tlbs.offset, uarch_tlbs, uarch_tlbs_count * sizeof(struct cpuinfo_uarch_tlbs));
+	}
+	if (memory_performance_count != 0) {
+		memcpy(buffer + header.memory_performance.offset, memory_performance,
+			memory_performance_count * sizeof(struct cpuinfo_memory_performance));
+	}
+	if (core_latencies_count != 0) {
+		memcpy(buffer + header.core_latencies.offset, core_latencies, core_latencies_count * sizeof(uint32_t));
+	}
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		memcpy(buffer + header.cpuid_leaves.offset, cpuinfo_x86_cpuid_table.leaves,
+			cpuid_leaves_count * cpuid_leaf_size);
+	#endif
+
+	((struct snapshot_header*) buffer)->checksum = compute_checksum(buffer, file_size);
+	*snapshot_size = file_size;
+	return buffer;
+}
+
+bool CPUINFO_ABI cpuinfo_save_snapshot(const char* path) {
+	if CPUINFO_UNLIKELY(cpuinfo_tables == NULL && !cpuinfo_initialize_deferred()) {
+		cpuinfo_log_fatal("cpuinfo_%s called before cpuinfo is initialized", "save_snapshot");
+	}
+
+	size_t file_size = 0;
+	char* buffer = build_snapshot(&file_size);
+	if (buffer == NULL) {
+		return false;
+	}
+
+	/* Write into a temporary file and rename it, so that concurrent readers never observe a partial snapshot */
+	bool status = false;
+	const size_t path_length = strlen(path);
+	char* temp_path = malloc(path_length + sizeof(".XXXXXX"));
+	if (temp_path == NULL) {
+		cpuinfo_log_error("failed to allocate memory for temporary snapshot file name");
+		goto cleanup;
+	}
+	memcpy(temp_path, path, path_length);
+	memcpy(temp_path + path_length, ".XXXXXX", sizeof(".XXXXXX"));
+	const int file = mkstemp(temp_path);
+	if (file == -1) {
+		cpuinfo_log_error("failed to create temporary snapshot file %s: %s", temp_path, strerror(errno));
+		goto cleanup;
+	}
+	size_t bytes_written = 0;
+	while (bytes_written < file_size) {
+		const ssize_t result = write(file, buffer + bytes_written, file_size - bytes_written);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			cpuinfo_log_error("failed to write snapshot file %s: %s", temp_path, strerror(errno));
+			close(file);
+			unlink(temp_path);
+			goto cleanup;
+		}
+		bytes_written += (size_t) result;
+	}
+	/* mkstemp creates files only accessible to the owner, but snapshots are meant to be shared */
+	fchmod(file, 0644);
+	close(file);
+	if (rename(temp_path, path) != 0) {
+		cpuinfo_log_error("failed to rename snapshot file %s to %s: %s", temp_path, path, strerror(errno));
+		unlink(temp_path);
+		goto cleanup;
+	}
+	status = true;
+
+cleanup:
+	free(temp_path);
+	free(buffer);
+	return status;
+}
+
+/*
+ * Decode references between the tables of a snapshot laid out for stored_base, and check that they refer to entries
+ * of the right tables; path is used only in messages.
+ */
+static bool decode_tables(void* snapshot, uint64_t stored_base, const char* path) {
+	const struct snapshot_header* header = (const struct snapshot_header*) snapshot;
+	const struct snapshot_table* cache = header->cache;
+	struct cpuinfo_processor* processors = table_address(snapshot, &header->processors);
+	for (uint32_t i = 0; i < header->processors.count; i++) {
+		if (!decode_pointer((const void**) &processors[i].core, snapshot, stored_base, &header->cores) ||
+			!decode_pointer((const void**) &processors[i].cluster, snapshot, stored_base, &header->clusters) ||
+			!decode_pointer((const void**) &processors[i].package, snapshot, stored_base, &header->packages) ||
+			!decode_pointer((const void**) &processors[i].cache.l1i, snapshot, stored_base,
+				&cache[cpuinfo_cache_level_1i]) ||
+			!decode_pointer((const void**) &processors[i].cache.l1d, snapshot, stored_base,
+				&cache[cpuinfo_cache_level_1d]) ||
+			!decode_pointer((const void**) &processors[i].cache.l2, snapshot, stored_base,
+				&cache[cpuinfo_cache_level_2]) ||
+			!decode_pointer((const void**) &processors[i].cache.l3, snapshot, stored_base,
+				&cache[cpuinfo_cache_level_3]) ||
+			!decode_pointer((const void**) &processors[i].cache.l4, snapshot, stored_base,
+				&cache[cpuinfo_cache_level_4]))
+		{
+			cpuinfo_log_warning("snapshot file %s is ignored: invalid reference in processor %"PRIu32, path, i);
+			return false;
+		}
+	}
+	struct cpuinfo_core* cores = table_address(snapshot, &header->cores);
+	for (uint32_t i = 0; i < header->cores.count; i++) {
+		if (!decode_pointer((const void**) &cores[i].cluster, snapshot, stored_base, &header->clusters) ||
+			!decode_pointer((const void**) &cores[i].package, snapshot, stored_base, &header->packages))
+		{
+			cpuinfo_log_warning("snapshot file %s is ignored: invalid reference in core %"PRIu32, path, i);
+			return false;
+		}
+	}
+	struct cpuinfo_cluster* clusters = table_address(snapshot, &header->clusters);
+	for (uint32_t i = 0; i < header->clusters.count; i++) {
+		if (!decode_pointer((const void**) &clusters[i].package, snapshot, stored_base, &header->packages)) {
+			cpuinfo_log_warning("snapshot file %s is ignored: invalid reference in cluster %"PRIu32, path, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Load the snapshot from an open file, which is closed afterwards; path is used only in messages. Snapshots of other
+ * systems are accepted only if check_fingerprint is false. On failure, sets incompatible if the snapshot describes
+ * another format, version or system, or is corrupted, rather than failing for lack of resources.
+ */
+static bool load_snapshot(int file, const char* path, bool check_fingerprint, bool incompatible[restrict static 1]) {
+	void* mapping = MAP_FAILED;
+	size_t file_size = 0;
+	struct cpuinfo_arena arena = { NULL, 0 };
+	*incompatible = false;
+
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0) {
+		cpuinfo_log_info("failed to query size of snapshot file %s: %s", path, strerror(errno));
+		goto failure;
+	}
+	file_size = (size_t) file_stat.st_size;
+	if (file_size < sizeof(struct snapshot_header)) {
+		cpuinfo_log_warning("snapshot file %s is ignored: file is too small", path);
+		*incompatible = true;
+		goto failure;
+	}
+
+	/*
+	 * Snapshots with absolute references are mapped at the address they are laid out for when it is free, and then
+	 * need no pointer fix-ups. Otherwise, the address is only a hint, and the references are relocated.
+	 */
+	struct snapshot_header stored_header;
+	void* address_hint = NULL;
+	if (pread(file, &stored_header, sizeof(stored_header), 0) == (ssize_t) sizeof(stored_header) &&
+		memcmp(stored_header.magic, snapshot_magic, sizeof(snapshot_magic)) == 0)
+	{
+		address_hint = (void*) (uintptr_t) stored_header.base_address;
+	}
+
+	/*
+	 * Private writable mapping: pointer fix-ups and per-process properties detected when the tables are published
+	 * copy only the pages they touch, and never reach the file. Other pages remain shared with the page cache.
+	 */
+	mapping = mmap(address_hint, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	if (mapping == MAP_FAILED) {
+		cpuinfo_log_info("failed to map snapshot file %s: %s", path, strerror(errno));
+		goto failure;
+	}
+	close(file);
+	file = -1;
+
+	const struct snapshot_header* header = (const struct snapshot_header*) mapping;
+	if (memcmp(header->magic, snapshot_magic, sizeof(snapshot_magic)) != 0 ||
+		header->version != SNAPSHOT_VERSION ||
+		header->header_size != sizeof(struct snapshot_header) ||
+		header->file_size != file_size)
+	{
+		cpuinfo_log_warning("snapshot file %s is ignored: incompatible format", path);
+		*incompatible = true;
+		goto failure;
+	}
+	if (header->checksum != compute_checksum(mapping, file_size)) {
+		cpuinfo_log_warning("snapshot file %s is ignored: checksum mismatch", path);
+		*incompatible = true;
+		goto failure;
+	}
+	const uint64_t stored_base = header->base_address;
+
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		const size_t isa_size = sizeof(cpuinfo_isa);
+	#else
+		const size_t isa_size = 0;
+	#endif
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		const size_t cpuid_leaf_size = sizeof(struct cpuinfo_x86_cpuid_leaf);
+		const uint32_t max_cpuid_leaves = CPUINFO_X86_CPUID_TABLE_CAPACITY;
+	#else
+		const size_t cpuid_leaf_size = 0;
+		const uint32_t max_cpuid_leaves = 0;
+	#endif
+	bool valid_tables =
+		validate_table(&header->processors, sizeof(struct cpuinfo_processor), file_size) &&
+		validate_table(&header->cores, sizeof(struct cpuinfo_core), file_size) &&
+		validate_table(&header->clusters, sizeof(struct cpuinfo_cluster), file_size) &&
+		validate_table(&header->packages, sizeof(struct cpuinfo_package), file_size) &&
+		validate_table(&header->uarchs, sizeof(struct cpuinfo_uarch_info), file_size) &&
+		validate_table(&header->uarch_tlbs, sizeof(struct cpuinfo_uarch_tlbs), file_size) &&
+		validate_table(&header->isa, isa_size, file_size) &&
+		validate_table(&header->linux_cpu_to_processor_map, sizeof(uint64_t), file_size) &&
+		validate_table(&header->linux_cpu_to_core_map, sizeof(uint64_t), file_size) &&
+		validate_table(&header->linux_cpu_to_uarch_index_map, sizeof(uint32_t), file_size) &&
+		validate_table(&header->memory_performance, sizeof(struct cpuinfo_memory_performance), file_size) &&
+		validate_table(&header->core_latencies, sizeof(uint32_t), file_size) &&
+		validate_table(&header->cpuid_leaves, cpuid_leaf_size, file_size);
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		valid_tables &= validate_table(&header->cache[level], sizeof(struct cpuinfo_cache), file_size);
+	}
+	if (!valid_tables || header->processors.count == 0 || header->uarchs.count == 0 ||
+		header->linux_cpu_to_processor_map.count != header->linux_cpu_max ||
+		header->linux_cpu_to_core_map.count != header->linux_cpu_max ||
+		(header->linux_cpu_to_uarch_index_map.count != 0 &&
+			header->linux_cpu_to_uarch_index_map.count != header->linux_cpu_max) ||
+		(header->uarch_tlbs.count != 0 && header->uarch_tlbs.count != header->uarchs.count) ||
+		(header->memory_performance.count != 0 && header->memory_performance.count != header->uarchs.count) ||
+		(header->core_latencies.count != 0 &&
+			(uint64_t) header->core_latencies.count != (uint64_t) header->cores.count * header->cores.count) ||
+		header->cpuid_leaves.count > max_cpuid_leaves)
+	{
+		cpuinfo_log_warning("snapshot file %s is ignored: inconsistent tables", path);
+		*incompatible = true;
+		goto failure;
+	}
+	if (check_fingerprint && header->fingerprint != compute_fingerprint(header->linux_cpu_max)) {
+		cpuinfo_log_info("snapshot file %s is ignored: system fingerprint changed", path);
+		*incompatible = true;
+		goto failure;
+	}
+
+	if (!decode_tables(mapping, stored_base, path)) {
+		*incompatible = true;
+		goto failure;
+	}
+	struct cpuinfo_processor* processors = table_address(mapping, &header->processors);
+	struct cpuinfo_core* cores = table_address(mapping, &header->cores);
+	struct cpuinfo_cluster* clusters = table_address(mapping, &header->clusters);
+	/* Linux processor IDs index the Linux processor maps, and the map entries index the uarchs */
+	for (uint32_t i = 0; i < header->processors.count; i++) {
+		if (processors[i].linux_id < 0 || (uint32_t) processors[i].linux_id >= header->linux_cpu_max) {
+			cpuinfo_log_warning("snapshot file %s is ignored: invalid Linux ID of processor %"PRIu32, path, i);
+			*incompatible = true;
+			goto failure;
+		}
+	}
+	const uint32_t* linux_cpu_to_uarch_index_map = table_address(mapping, &header->linux_cpu_to_uarch_index_map);
+	for (uint32_t i = 0; i < header->linux_cpu_to_uarch_index_map.count; i++) {
+		if (linux_cpu_to_uarch_index_map[i] >= header->uarchs.count) {
+			cpuinfo_log_warning("snapshot file %s is ignored: invalid uarch index for Linux processor %"PRIu32,
+				path, i);
+			*incompatible = true;
+			goto failure;
+		}
+	}
+	/* Linux processor maps are stored as 64-bit indices regardless of pointer width, and are decoded into an arena */
+	const size_t linux_cpu_to_processor_map_offset =
+		cpuinfo_arena_reserve(&arena, header->linux_cpu_max, sizeof(struct cpuinfo_processor*));
+	const size_t linux_cpu_to_core_map_offset =
+		cpuinfo_arena_reserve(&arena, header->linux_cpu_max, sizeof(struct cpuinfo_core*));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		goto failure;
+	}
+	const struct cpuinfo_processor** linux_cpu_to_processor_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_processor_map_offset, header->linux_cpu_max);
+	const struct cpuinfo_core** linux_cpu_to_core_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_core_map_offset, header->linux_cpu_max);
+	const uint64_t* encoded_processor_map = table_address(mapping, &header->linux_cpu_to_processor_map);
+	const uint64_t* encoded_core_map = table_address(mapping, &header->linux_cpu_to_core_map);
+	for (uint32_t i = 0; i < header->linux_cpu_max; i++) {
+		linux_cpu_to_processor_map[i] = (const struct cpuinfo_processor*) (uintptr_t) encoded_processor_map[i];
+		linux_cpu_to_core_map[i] = (const struct cpuinfo_core*) (uintptr_t) encoded_core_map[i];
+		if (!decode_pointer((const void**) &linux_cpu_to_processor_map[i], mapping, stored_base, &header->processors) ||
+			!decode_pointer((const void**) &linux_cpu_to_core_map[i], mapping, stored_base, &header->cores))
+		{
+			cpuinfo_log_warning("snapshot file %s is ignored: invalid reference for Linux processor %"PRIu32, path, i);
+			*incompatible = true;
+			goto failure;
+		}
+	}
+
+	/* Commit changes */
+	cpuinfo_processors = processors;
+	cpuinfo_cores = cores;
+	cpuinfo_clusters = clusters;
+	cpuinfo_packages = table_address(mapping, &header->packages);
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache[level] = table_address(mapping, &header->cache[level]);
+		cpuinfo_cache_count[level] = header->cache[level].count;
+	}
+
+	cpuinfo_processors_count = header->processors.count;
+	cpuinfo_cores_count = header->cores.count;
+	cpuinfo_clusters_count = header->clusters.count;
+	cpuinfo_packages_count = header->packages.count;
+	cpuinfo_max_cache_size = header->max_cache_size;
+	cpuinfo_integrated_gpu = header->integrated_gpu;
+	cpuinfo_npu = header->npu;
+
+	#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		cpuinfo_uarchs = table_address(mapping, &header->uarchs);
+		cpuinfo_uarchs_count = header->uarchs.count;
+		cpuinfo_uarch_tlbs = table_address(mapping, &header->uarch_tlbs);
+	#else
+		if (header->uarchs.count > 1) {
+			cpuinfo_uarchs = table_address(mapping, &header->uarchs);
+			cpuinfo_uarchs_count = header->uarchs.count;
+			cpuinfo_uarch_tlbs = table_address(mapping, &header->uarch_tlbs);
+		} else {
+			memcpy(&cpuinfo_global_uarch, table_address(mapping, &header->uarchs), sizeof(struct cpuinfo_uarch_info));
+			if (header->uarch_tlbs.count != 0) {
+				memcpy(&cpuinfo_global_uarch_tlbs, table_address(mapping, &header->uarch_tlbs),
+					sizeof(struct cpuinfo_uarch_tlbs));
+			}
+		}
+	#endif
+	cpuinfo_linux_cpu_to_uarch_index_map = table_address(mapping, &header->linux_cpu_to_uarch_index_map);
+	cpuinfo_memory_performance = table_address(mapping, &header->memory_performance);
+	cpuinfo_core_latencies = table_address(mapping, &header->core_latencies);
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		memcpy(&cpuinfo_isa, table_address(mapping, &header->isa), sizeof(cpuinfo_isa));
+	#endif
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* Leaves of another system must not answer CPUID queries on this one */
+		cpuinfo_x86_reset_cpuid_table();
+		if (check_fingerprint && header->cpuid_leaves.count != 0) {
+			memcpy(cpuinfo_x86_cpuid_table.leaves, table_address(mapping, &header->cpuid_leaves),
+				header->cpuid_leaves.count * cpuid_leaf_size);
+			cpuinfo_x86_cpuid_table.count = header->cpuid_leaves.count;
+		}
+	#endif
+
+	cpuinfo_linux_cpu_max = header->linux_cpu_max;
+	cpuinfo_linux_cpu_to_processor_map = linux_cpu_to_processor_map;
+	cpuinfo_linux_cpu_to_core_map = linux_cpu_to_core_map;
+
+	cpuinfo_arena_memory = arena.memory;
+	cpuinfo_snapshot_mapping = mapping;
+	cpuinfo_snapshot_mapping_size = file_size;
+
+	cpuinfo_is_initialized = true;
+	return true;
+
+failure:
+	cpuinfo_arena_free(arena.memory);
+	if (mapping != MAP_FAILED) {
+		munmap(mapping, file_size);
+	}
+	if (file != -1) {
+		close(file);
+	}
+	return false;
+}
+
+void cpuinfo_unmap_snapshot(void* mapping, size_t size) {
+	if (mapping != NULL) {
+		munmap(mapping, size);
+	}
+}
+
+/* Publish the tables of a snapshot of this system, answering CPUID queries from the leaves recorded in the snapshot */
+static bool publish_snapshot_tables(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* Statistics describe the last detection of the system, and don't count CPUID queries of snapshot loads */
+		const struct cpuinfo_init_stats init_stats = cpuinfo_init_stats;
+		cpuinfo_x86_record_cpuid(true);
+		const bool published = cpuinfo_publish_tables();
+		cpuinfo_x86_record_cpuid(false);
+		cpuinfo_init_stats = init_stats;
+		return published;
+	#else
+		return cpuinfo_publish_tables();
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_initialize_from_snapshot(const char* path) {
+	cpuinfo_lock_initialization();
+	bool loaded = cpuinfo_tables != NULL;
+	if (!loaded) {
+		const int file = open(path, O_RDONLY | O_CLOEXEC);
+		bool incompatible;
+		if (file == -1) {
+			cpuinfo_log_info("failed to open snapshot file %s: %s", path, strerror(errno));
+		} else if (load_snapshot(file, path, true, &incompatible)) {
+			loaded = publish_snapshot_tables();
+			if (!loaded) {
+				cpuinfo_release_tables();
+			}
+		}
+	}
+	cpuinfo_unlock_initialization();
+	if (!loaded) {
+		return cpuinfo_initialize();
+	}
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_initialize_from_capture(const char* path) {
+	cpuinfo_lock_initialization();
+	bool loaded = false;
+	if (cpuinfo_tables != NULL) {
+		cpuinfo_log_warning("capture %s is ignored: cpuinfo is already initialized", path);
+	} else {
+		const int file = open(path, O_RDONLY | O_CLOEXEC);
+		bool incompatible;
+		if (file == -1) {
+			cpuinfo_log_error("failed to open capture %s: %s", path, strerror(errno));
+		} else if (load_snapshot(file, path, false, &incompatible)) {
+			/* Processors of the captured system don't exist here: skip detection of their per-process properties */
+			cpuinfo_replaying_capture = true;
+			loaded = cpuinfo_publish_tables();
+			cpuinfo_replaying_capture = false;
+			if (!loaded) {
+				cpuinfo_release_tables();
+			}
+		}
+	}
+	cpuinfo_unlock_initialization();
+	return loaded;
+}
+
+#if defined(__ANDROID__)
+	/* Bionic doesn't implement POSIX shared memory */
+	bool CPUINFO_ABI cpuinfo_initialize_shared(const char* name) {
+		cpuinfo_log_info("shared topology snapshots are not supported on Android");
+		return cpuinfo_initialize();
+	}
+#else
+	/* Attempts to attach to a segment which another process is still publishing, and the interval between them */
+	#define SHARED_SNAPSHOT_RETRIES 100
+	#define SHARED_SNAPSHOT_RETRY_INTERVAL_NS 1000000
+	/*
+	 * Time after the last modification of an unpublished segment when its publisher is considered dead. Publishing
+	 * takes milliseconds, because the snapshot is built before the segment is created.
+	 */
+	#define SHARED_SNAPSHOT_ABANDON_TIMEOUT_S 10
+
+	enum segment_state {
+		/* Created by another process, which is still sizing or filling it */
+		segment_state_publishing,
+		/* Completely published, with the magic stored */
+		segment_state_published,
+		/* Left unpublished by a process which died or failed while publishing it */
+		segment_state_abandoned,
+	};
+
+	/*
+	 * Check whether a shared snapshot segment is completely published: the publisher creates it empty, and stores the
+	 * magic only after sizing and filling it. Returns the inode of the segment to identify it for replacement.
+	 */
+	static enum segment_state get_segment_state(int segment, ino_t inode[restrict static 1]) {
+		struct stat segment_stat;
+		if (fstat(segment, &segment_stat) != 0) {
+			return segment_state_publishing;
+		}
+		*inode = segment_stat.st_ino;
+		struct snapshot_header header;
+		if ((size_t) segment_stat.st_size >= sizeof(header) &&
+			pread(segment, &header, sizeof(header), 0) == (ssize_t) sizeof(header) &&
+			memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) == 0)
+		{
+			return segment_state_published;
+		}
+		/* Creation, ftruncate, and stores through the mapping of the publisher update the modification time */
+		struct timespec now;
+		if (clock_gettime(CLOCK_REALTIME, &now) == 0 &&
+			now.tv_sec - segment_stat.st_mtime > SHARED_SNAPSHOT_ABANDON_TIMEOUT_S)
+		{
+			return segment_state_abandoned;
+		}
+		return segment_state_publishing;
+	}
+
+	/*
+	 * Remove the incompatible or abandoned segment, unless another process has already replaced it with a segment it
+	 * may still be publishing. Processes which attached to the incompatible segment keep using their mappings of it.
+	 */
+	static void unlink_replaced_segment(const char* name, ino_t replaced_inode) {
+		const int segment = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+		if (segment == -1) {
+			return;
+		}
+		struct stat segment_stat;
+		if (fstat(segment, &segment_stat) == 0 && segment_stat.st_ino == replaced_inode) {
+			shm_unlink(name);
+		}
+		close(segment);
+	}
+
+	/*
+	 * Publish the snapshot of the current tables in a new shared memory segment, replacing the incompatible or
+	 * abandoned segment if requested. The snapshot is laid out for the address of the mapping in this process, so
+	 * that processes which map it at the same address share all its pages.
+	 */
+	static void publish_shared_snapshot(const char* name, bool replace, ino_t replaced_inode) {
+		size_t snapshot_size = 0;
+		char* snapshot = build_snapshot(&snapshot_size);
+		if (snapshot == NULL) {
+			return;
+		}
+		if (replace) {
+			unlink_replaced_segment(name, replaced_inode);
+		}
+		const int segment = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+		if (segment == -1) {
+			if (errno == EEXIST) {
+				cpuinfo_log_debug("shared snapshot %s was published by another process", name);
+			} else {
+				cpuinfo_log_warning("failed to create shared snapshot %s: %s", name, strerror(errno));
+			}
+			goto cleanup;
+		}
+		void* mapping = MAP_FAILED;
+		if (ftruncate(segment, (off_t) snapshot_size) != 0 ||
+			(mapping = mmap(NULL, snapshot_size, PROT_READ | PROT_WRITE, MAP_SHARED, segment, 0)) == MAP_FAILED)
+		{
+			cpuinfo_log_warning("failed to allocate shared snapshot %s: %s", name, strerror(errno));
+			shm_unlink(name);
+			close(segment);
+			goto cleanup;
+		}
+		close(segment);
+
+		/* Snapshot is incomplete until the magic is stored */
+		memcpy(mapping, snapshot, snapshot_size);
+		struct snapshot_header* header = (struct snapshot_header*) mapping;
+		memset(header->magic, 0, sizeof(header->magic));
+		decode_tables(mapping, 0, name);
+		uint64_t* linux_cpu_to_processor_map = table_address(mapping, &header->linux_cpu_to_processor_map);
+		uint64_t* linux_cpu_to_core_map = table_address(mapping, &header->linux_cpu_to_core_map);
+		for (uint32_t i = 0; i < header->linux_cpu_max; i++) {
+			const void* processor = (const void*) (uintptr_t) linux_cpu_to_processor_map[i];
+			const void* core = (const void*) (uintptr_t) linux_cpu_to_core_map[i];
+			decode_pointer(&processor, mapping, 0, &header->processors);
+			decode_pointer(&core, mapping, 0, &header->cores);
+			linux_cpu_to_processor_map[i] = (uint64_t) (uintptr_t) processor;
+			linux_cpu_to_core_map[i] = (uint64_t) (uintptr_t) core;
+		}
+		header->base_address = (uint64_t) (uintptr_t) mapping;
+		header->checksum = compute_checksum(mapping, snapshot_size);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		memcpy(header->magic, snapshot_magic, sizeof(snapshot_magic));
+		munmap(mapping, snapshot_size);
+		cpuinfo_log_debug("published shared snapshot %s of %zu bytes", name, snapshot_size);
+
+	cleanup:
+		free(snapshot);
+	}
+
+	bool CPUINFO_ABI cpuinfo_initialize_shared(const char* name) {
+		cpuinfo_lock_initialization();
+		bool loaded = cpuinfo_tables != NULL;
+		/* A published segment of another format, version or system, and an abandoned segment, are replaced */
+		bool replace = false;
+		ino_t inode = 0;
+		/* A segment which another process is still publishing is neither loaded nor replaced */
+		bool publishing = false;
+		for (uint32_t attempt = 0; !loaded; attempt++) {
+			const int segment = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+			if (segment == -1) {
+				cpuinfo_log_debug("failed to open shared snapshot %s: %s", name, strerror(errno));
+				break;
+			}
+			const enum segment_state state = get_segment_state(segment, &inode);
+			if (state == segment_state_published) {
+				if (load_snapshot(segment, name, true, &replace)) {
+					loaded = publish_snapshot_tables();
+					if (!loaded) {
+						cpuinfo_release_tables();
+					}
+				}
+				break;
+			}
+			close(segment);
+			if (state == segment_state_abandoned) {
+				cpuinfo_log_info("shared snapshot %s was abandoned by its publisher: replacing it", name);
+				replace = true;
+				break;
+			}
+			if (attempt == SHARED_SNAPSHOT_RETRIES) {
+				cpuinfo_log_info("shared snapshot %s is not published in time: initializing privately", name);
+				publishing = true;
+				break;
+			}
+			const struct timespec retry_interval = { 0, SHARED_SNAPSHOT_RETRY_INTERVAL_NS };
+			nanosleep(&retry_interval, NULL);
+		}
+		cpuinfo_unlock_initialization();
+		if (loaded) {
+			return true;
+		}
+
+		if (!cpuinfo_initialize()) {
+			return false;
+		}
+		if (!publishing) {
+			publish_shared_snapshot(name, replace, inode);
+		}
+		return true;
+	}
+#endif
+
+#else /* !defined(__linux__) */
+
+void* cpuinfo_snapshot_mapping = NULL;
+size_t cpuinfo_snapshot_mapping_size = 0;
+
+void cpuinfo_unmap_snapshot(void* mapping, size_t size) {
+}
+
+bool CPUINFO_ABI cpuinfo_save_snapshot(const char* path) {
+	cpuinfo_log_info("topology snapshots are not supported on this operating system");
+	return false;
+}
+
+bool CPUINFO_ABI cpuinfo_initialize_from_snapshot(const char* path) {
+	return cpuinfo_initialize();
+}
+
+bool CPUINFO_ABI cpuinfo_initialize_shared(const char* name) {
+	return cpuinfo_initialize();
+}
+
+bool CPUINFO_ABI cpuinfo_initialize_from_capture(const char* path) {
+	cpuinfo_log_error("topology captures are not supported on this operating system");
+	return false;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+/* Approximate latencies of the spin-loop hint instruction in cycles for the latency classes */
+#define SHORT_PAUSE_CYCLES 10
+#define LONG_PAUSE_CYCLES 140
+/* Cycles of a spin loop without the hint: load of the watched variable, compare, and branch */
+#define SPIN_LOOP_OVERHEAD_CYCLES 10
+/* Cycles to spin before yielding: about the cost of a futex wait and wake, which spinning tries to avoid */
+#define SPIN_BUDGET_CYCLES 4000
+
+bool CPUINFO_ABI cpuinfo_get_uarch_spin_wait_hint(uint32_t uarch_index, struct cpuinfo_spin_wait_hint* hint) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_spin_wait_hint");
+	if (hint == NULL) {
+		return false;
+	}
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if CPUINFO_UNLIKELY(processor == NULL) {
+		return false;
+	}
+
+	*hint = (struct cpuinfo_spin_wait_hint) { 0 };
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		hint->pause_latency = cpuinfo_x86_decode_pause_latency(processor->core->vendor, processor->core->uarch);
+		switch (hint->pause_latency) {
+			case cpuinfo_pause_latency_short:
+				hint->pause_cycles = SHORT_PAUSE_CYCLES;
+				break;
+			case cpuinfo_pause_latency_long:
+				hint->pause_cycles = LONG_PAUSE_CYCLES;
+				break;
+			default:
+				break;
+		}
+		hint->x86_waitpkg = cpuinfo_has_x86_waitpkg();
+		hint->x86_mwaitx = cpuinfo_has_x86_mwaitx();
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		/* YIELD is a hint without a delay on ARM cores, so spin loops cost only their loads */
+		hint->pause_latency = cpuinfo_pause_latency_short;
+		hint->pause_cycles = 1;
+		/* Operating systems don't trap WFE in user mode, and the event stream bounds waits without events */
+		hint->arm_wfe = true;
+		hint->arm_wfet = cpuinfo_has_arm_wfxt();
+	#endif
+	/* With unknown latency, assume the long one: spinning then ends early rather than late */
+	const uint32_t iteration_cycles = SPIN_LOOP_OVERHEAD_CYCLES +
+		(hint->pause_latency != cpuinfo_pause_latency_unknown ? hint->pause_cycles : LONG_PAUSE_CYCLES);
+	hint->spin_iterations = SPIN_BUDGET_CYCLES / iteration_cycles;
+	return true;
+}
@@ -0,0 +1,82 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#if defined(__linux__)
+	#include <linux/api.h>
+#endif
+
+
+struct cpuinfo_init_stats cpuinfo_init_stats = { { 0 } };
+bool cpuinfo_init_stats_valid = false;
+
+/* Timestamp of the start of the current initialization */
+static uint64_t init_start_ns = 0;
+/* Whether an initialization is running, so that file reads are accounted; reads after initialization are not */
+static bool init_stats_recording = false;
+
+uint64_t cpuinfo_get_timestamp_ns(void) {
+#if defined(_WIN32) || defined(__CYGWIN__)
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	/* Split the conversion to avoid overflow of counter * 10^9 */
+	const uint64_t seconds = (uint64_t) counter.QuadPart / (uint64_t) frequency.QuadPart;
+	const uint64_t remainder = (uint64_t) counter.QuadPart % (uint64_t) frequency.QuadPart;
+	return seconds * UINT64_C(1000000000) + remainder * UINT64_C(1000000000) / (uint64_t) frequency.QuadPart;
+#else
+	struct timespec timestamp;
+	if (clock_gettime(CLOCK_MONOTONIC, &timestamp) != 0) {
+		return 0;
+	}
+	return (uint64_t) timestamp.tv_sec * UINT64_C(1000000000) + (uint64_t) timestamp.tv_nsec;
+#endif
+}
+
+void cpuinfo_start_init_stats(void) {
+	memset(&cpuinfo_init_stats, 0, sizeof(cpuinfo_init_stats));
+	cpuinfo_init_stats_valid = false;
+	init_start_ns = cpuinfo_get_timestamp_ns();
+	__atomic_store_n(&init_stats_recording, true, __ATOMIC_RELAXED);
+}
+
+void cpuinfo_finish_init_stats(void) {
+	__atomic_store_n(&init_stats_recording, false, __ATOMIC_RELAXED);
+	cpuinfo_init_stats.total_time_ns = cpuinfo_get_timestamp_ns() - init_start_ns;
+	cpuinfo_init_stats_valid = true;
+}
+
+void cpuinfo_record_init_phase(enum cpuinfo_init_phase phase, uint64_t phase_start[restrict static 1]) {
+	const uint64_t now = cpuinfo_get_timestamp_ns();
+	cpuinfo_init_stats.phase_time_ns[phase] += now - *phase_start;
+	*phase_start = now;
+}
+
+#if defined(__linux__)
+void cpuinfo_linux_record_file_read(size_t bytes_read) {
+	if (!__atomic_load_n(&init_stats_recording, __ATOMIC_RELAXED)) {
+		return;
+	}
+	__sync_fetch_and_add(&cpuinfo_init_stats.files_opened, 1);
+	__sync_fetch_and_add(&cpuinfo_init_stats.bytes_read, (uint64_t) bytes_read);
+}
+#endif
+
+bool CPUINFO_ABI cpuinfo_get_init_stats(struct cpuinfo_init_stats* stats) {
+	cpuinfo_lock_initialization();
+	const bool valid = cpuinfo_init_stats_valid;
+	if (valid) {
+		*stats = cpuinfo_init_stats;
+	}
+	cpuinfo_unlock_initialization();
+	return valid;
+}
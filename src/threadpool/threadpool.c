@@ -0,0 +1,384 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo-threadpool.h>
+
+
+/* Chunks per thread without a cache-sized chunk, so that faster workers can take the chunks of slower ones */
+#define CHUNKS_PER_THREAD 4
+
+/* Run queues are padded to two cache lines, so that claims in one queue don't invalidate lines of another */
+#define RUN_QUEUE_SIZE 128
+
+#define QUEUE_NONE UINT32_MAX
+
+/* Chunks [next_chunk, end_chunk) of the current loop assigned to the workers of a last-level cache domain */
+struct run_queue {
+	/* Next chunk to claim; claims increment it past end_chunk when the queue is drained */
+	size_t next_chunk;
+	size_t end_chunk;
+	uint32_t workers_count;
+	/* Microarchitecture of the first worker of the queue, for cache-sized chunks */
+	uint32_t uarch_index;
+};
+
+union run_queue_slot {
+	struct run_queue queue;
+	char padding[RUN_QUEUE_SIZE];
+};
+
+struct worker {
+	struct cpuinfo_threadpool* threadpool;
+	/* Logical processor the worker is pinned to; worker 0 is the calling thread, which is not pinned */
+	const struct cpuinfo_processor* processor;
+	uint32_t queue;
+	/* Other queues in the order of stealing, i.e. of their distance from the processor of the worker */
+	uint32_t* victims;
+	uint32_t victims_count;
+	pthread_t thread;
+};
+
+struct cpuinfo_threadpool {
+	/* Serializes calls of cpuinfo_threadpool_parallel_for */
+	pthread_mutex_t call_mutex;
+	/* Protects generation, active_workers, and stop */
+	pthread_mutex_t mutex;
+	pthread_cond_t job_condition;
+	pthread_cond_t done_condition;
+	/* Incremented for every loop, which wakes up the workers */
+	uint64_t generation;
+	/* Number of worker threads which didn't finish the current loop yet */
+	uint32_t active_workers;
+	bool stop;
+
+	cpuinfo_threadpool_task task;
+	void* context;
+	size_t range;
+	size_t chunk_size;
+
+	uint32_t threads_count;
+	/* Number of worker threads which were started, i.e. need to be joined */
+	uint32_t started_threads_count;
+	uint32_t queues_count;
+	struct worker* workers;
+	union run_queue_slot* queues;
+	uint32_t* victims;
+};
+
+static inline size_t divide_round_up(size_t dividend, size_t divisor) {
+	return dividend / divisor + (size_t) (dividend % divisor != 0);
+}
+
+static bool claim_chunk(struct run_queue* queue, size_t chunk[restrict static 1]) {
+	if (__atomic_load_n(&queue->next_chunk, __ATOMIC_RELAXED) >= queue->end_chunk) {
+		return false;
+	}
+	*chunk = __atomic_fetch_add(&queue->next_chunk, 1, __ATOMIC_RELAXED);
+	return *chunk < queue->end_chunk;
+}
+
+static void run_queue_chunks(struct cpuinfo_threadpool* threadpool, uint32_t queue_index) {
+	struct run_queue* queue = &threadpool->queues[queue_index].queue;
+	const size_t range = threadpool->range;
+	const size_t chunk_size = threadpool->chunk_size;
+	size_t chunk;
+	while (claim_chunk(queue, &chunk)) {
+		const size_t start = chunk * chunk_size;
+		const size_t end = range - start > chunk_size ? start + chunk_size : range;
+		threadpool->task(threadpool->context, start, end);
+	}
+}
+
+/* Drain the queue of the worker, and then steal chunks from other queues in topology order */
+static void run_chunks(struct worker* worker) {
+	struct cpuinfo_threadpool* threadpool = worker->threadpool;
+	run_queue_chunks(threadpool, worker->queue);
+	for (uint32_t i = 0; i < worker->victims_count; i++) {
+		run_queue_chunks(threadpool, worker->victims[i]);
+	}
+}
+
+static void* worker_thread(void* argument) {
+	struct worker* worker = (struct worker*) argument;
+	struct cpuinfo_threadpool* threadpool = worker->threadpool;
+	/* Workers which can't be pinned run wherever the OS schedules them */
+	cpuinfo_pin_current_thread_to_processor(worker->processor);
+
+	uint64_t generation = 0;
+	pthread_mutex_lock(&threadpool->mutex);
+	for (;;) {
+		while (!threadpool->stop && threadpool->generation == generation) {
+			pthread_cond_wait(&threadpool->job_condition, &threadpool->mutex);
+		}
+		if (threadpool->stop) {
+			break;
+		}
+		generation = threadpool->generation;
+		pthread_mutex_unlock(&threadpool->mutex);
+
+		run_chunks(worker);
+
+		pthread_mutex_lock(&threadpool->mutex);
+		if (--threadpool->active_workers == 0) {
+			pthread_cond_signal(&threadpool->done_condition);
+		}
+	}
+	pthread_mutex_unlock(&threadpool->mutex);
+	return NULL;
+}
+
+/* Assign queues to the last-level cache domains of workers, in the order of domains, and steal orders to workers */
+static bool init_queues(struct cpuinfo_threadpool* threadpool) {
+	const uint32_t domains_count = cpuinfo_get_llc_domains_count();
+	const uint16_t* uarch_column = cpuinfo_get_processor_column(cpuinfo_processor_column_uarch);
+	const struct cpuinfo_processor* processors = cpuinfo_get_processors();
+	uint32_t* domain_queues = malloc((domains_count != 0 ? domains_count : 1) * sizeof(uint32_t));
+	if (domain_queues == NULL) {
+		return false;
+	}
+	for (uint32_t i = 0; i < domains_count; i++) {
+		domain_queues[i] = QUEUE_NONE;
+	}
+	for (uint32_t i = 0; i < threadpool->threads_count; i++) {
+		const uint32_t domain = cpuinfo_get_processor_llc_domain_index(threadpool->workers[i].processor);
+		if (domain < domains_count) {
+			domain_queues[domain] = 0;
+		}
+	}
+	uint32_t queues_count = 0;
+	for (uint32_t i = 0; i < domains_count; i++) {
+		if (domain_queues[i] != QUEUE_NONE) {
+			domain_queues[i] = queues_count++;
+		}
+	}
+	/* Processors outside of the domains, which cpuinfo doesn't report, share one queue */
+	const uint32_t fallback_queue = queues_count;
+	for (uint32_t i = 0; i < threadpool->threads_count; i++) {
+		const uint32_t domain = cpuinfo_get_processor_llc_domain_index(threadpool->workers[i].processor);
+		if (domain >= domains_count) {
+			queues_count = fallback_queue + 1;
+		}
+	}
+
+	threadpool->queues = calloc(queues_count, sizeof(union run_queue_slot));
+	threadpool->victims = calloc((size_t) threadpool->threads_count * queues_count, sizeof(uint32_t));
+	bool* stolen = calloc(queues_count, sizeof(bool));
+	if (threadpool->queues == NULL || threadpool->victims == NULL || stolen == NULL) {
+		free(stolen);
+		free(domain_queues);
+		return false;
+	}
+	threadpool->queues_count = queues_count;
+
+	for (uint32_t i = 0; i < threadpool->threads_count; i++) {
+		struct worker* worker = &threadpool->workers[i];
+		const uint32_t domain = cpuinfo_get_processor_llc_domain_index(worker->processor);
+		worker->queue = domain < domains_count ? domain_queues[domain] : fallback_queue;
+		struct run_queue* queue = &threadpool->queues[worker->queue].queue;
+		if (queue->workers_count++ == 0) {
+			const uint32_t processor_index = (uint32_t) (worker->processor - processors);
+			queue->uarch_index = uarch_column != NULL ? uarch_column[processor_index] : 0;
+		}
+	}
+
+	for (uint32_t i = 0; i < threadpool->threads_count; i++) {
+		struct worker* worker = &threadpool->workers[i];
+		worker->victims = &threadpool->victims[(size_t) i * queues_count];
+		for (uint32_t q = 0; q < queues_count; q++) {
+			stolen[q] = q == worker->queue;
+		}
+
+		uint32_t steal_order_count = 0;
+		const uint32_t* steal_order =
+			cpuinfo_get_steal_order((uint32_t) (worker->processor - processors), &steal_order_count);
+		for (uint32_t v = 0; v < steal_order_count; v++) {
+			const uint32_t domain = cpuinfo_get_processor_llc_domain_index(cpuinfo_get_processor(steal_order[v]));
+			const uint32_t queue = domain < domains_count ? domain_queues[domain] : fallback_queue;
+			if (queue < queues_count && !stolen[queue]) {
+				stolen[queue] = true;
+				worker->victims[worker->victims_count++] = queue;
+			}
+		}
+		/* Queues of processors which are not in the steal order, e.g. unusable ones, are stolen from last */
+		for (uint32_t q = 0; q < queues_count; q++) {
+			if (!stolen[q]) {
+				worker->victims[worker->victims_count++] = q;
+			}
+		}
+	}
+	free(stolen);
+	free(domain_queues);
+	return true;
+}
+
+static void stop_workers(struct cpuinfo_threadpool* threadpool) {
+	pthread_mutex_lock(&threadpool->mutex);
+	threadpool->stop = true;
+	pthread_cond_broadcast(&threadpool->job_condition);
+	pthread_mutex_unlock(&threadpool->mutex);
+	/* Worker 0 is the calling thread */
+	for (uint32_t i = 1; i < threadpool->started_threads_count; i++) {
+		pthread_join(threadpool->workers[i].thread, NULL);
+	}
+	threadpool->started_threads_count = 0;
+}
+
+struct cpuinfo_threadpool* CPUINFO_ABI cpuinfo_threadpool_create(uint32_t threads_count,
+	enum cpuinfo_worker_policy policy)
+{
+	if (!cpuinfo_initialize()) {
+		return NULL;
+	}
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	const uint32_t plan_count = threads_count != 0 ? threads_count : processors_count;
+	const struct cpuinfo_processor** plan = calloc(plan_count, sizeof(const struct cpuinfo_processor*));
+	if (plan == NULL) {
+		return NULL;
+	}
+	const uint32_t distinct_count = cpuinfo_plan_workers(plan_count, policy, plan);
+	if (distinct_count == 0) {
+		free(plan);
+		return NULL;
+	}
+	if (threads_count == 0) {
+		/* The plan wraps around after the distinct processors */
+		threads_count = distinct_count;
+	}
+
+	struct cpuinfo_threadpool* threadpool = calloc(1, sizeof(struct cpuinfo_threadpool));
+	if (threadpool == NULL) {
+		free(plan);
+		return NULL;
+	}
+	pthread_mutex_init(&threadpool->call_mutex, NULL);
+	pthread_mutex_init(&threadpool->mutex, NULL);
+	pthread_cond_init(&threadpool->job_condition, NULL);
+	pthread_cond_init(&threadpool->done_condition, NULL);
+	threadpool->threads_count = threads_count;
+	threadpool->workers = calloc(threads_count, sizeof(struct worker));
+	if (threadpool->workers == NULL) {
+		free(plan);
+		cpuinfo_threadpool_destroy(threadpool);
+		return NULL;
+	}
+	for (uint32_t i = 0; i < threads_count; i++) {
+		threadpool->workers[i].threadpool = threadpool;
+		threadpool->workers[i].processor = plan[i];
+	}
+	free(plan);
+	if (!init_queues(threadpool)) {
+		cpuinfo_threadpool_destroy(threadpool);
+		return NULL;
+	}
+
+	threadpool->started_threads_count = 1;
+	for (uint32_t i = 1; i < threads_count; i++) {
+		if (pthread_create(&threadpool->workers[i].thread, NULL, worker_thread, &threadpool->workers[i]) != 0) {
+			cpuinfo_threadpool_destroy(threadpool);
+			return NULL;
+		}
+		threadpool->started_threads_count = i + 1;
+	}
+	return threadpool;
+}
+
+void CPUINFO_ABI cpuinfo_threadpool_destroy(struct cpuinfo_threadpool* threadpool) {
+	if (threadpool == NULL) {
+		return;
+	}
+	stop_workers(threadpool);
+	pthread_cond_destroy(&threadpool->done_condition);
+	pthread_cond_destroy(&threadpool->job_condition);
+	pthread_mutex_destroy(&threadpool->mutex);
+	pthread_mutex_destroy(&threadpool->call_mutex);
+	free(threadpool->victims);
+	free(threadpool->queues);
+	free(threadpool->workers);
+	free(threadpool);
+}
+
+uint32_t CPUINFO_ABI cpuinfo_threadpool_get_threads_count(const struct cpuinfo_threadpool* threadpool) {
+	return threadpool->threads_count;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_threadpool_get_queues_count(const struct cpuinfo_threadpool* threadpool) {
+	return threadpool->queues_count;
+}
+
+size_t CPUINFO_ABI cpuinfo_threadpool_get_chunk_size(const struct cpuinfo_threadpool* threadpool, size_t range,
+	size_t item_size)
+{
+	if (range == 0) {
+		return 0;
+	}
+	size_t chunk_size = divide_round_up(range, (size_t) threadpool->threads_count * CHUNKS_PER_THREAD);
+	if (item_size != 0) {
+		/* Block of A in L2 cache for 1 x 1 micro-tiles: kc x mc items, which share L2 with a micro-panel of B */
+		const uint32_t element_size = item_size < UINT32_MAX ? (uint32_t) item_size : UINT32_MAX;
+		size_t block_size = 0;
+		for (uint32_t i = 0; i < threadpool->queues_count; i++) {
+			struct cpuinfo_blocking_hint hint;
+			if (cpuinfo_get_uarch_blocking_hint(threadpool->queues[i].queue.uarch_index, element_size, 1, 1, &hint)) {
+				const size_t items = (size_t) hint.kc * (hint.mc != 0 ? hint.mc : 1);
+				if (block_size == 0 || items < block_size) {
+					block_size = items;
+				}
+			}
+		}
+		if (block_size != 0) {
+			chunk_size = block_size;
+		}
+	}
+	const size_t worker_share = divide_round_up(range, threadpool->threads_count);
+	if (chunk_size > worker_share) {
+		chunk_size = worker_share;
+	}
+	return chunk_size != 0 ? chunk_size : 1;
+}
+
+void CPUINFO_ABI cpuinfo_threadpool_parallel_for(struct cpuinfo_threadpool* threadpool, cpuinfo_threadpool_task task,
+	void* context, size_t range, size_t item_size)
+{
+	if (range == 0) {
+		return;
+	}
+	pthread_mutex_lock(&threadpool->call_mutex);
+	const size_t chunk_size = cpuinfo_threadpool_get_chunk_size(threadpool, range, item_size);
+	const size_t chunks_count = divide_round_up(range, chunk_size);
+
+	/* Contiguous chunks in proportion to the workers of every queue */
+	size_t chunk_start = 0;
+	uint64_t assigned_workers = 0;
+	for (uint32_t i = 0; i < threadpool->queues_count; i++) {
+		struct run_queue* queue = &threadpool->queues[i].queue;
+		assigned_workers += queue->workers_count;
+		const size_t chunk_end = (size_t) (chunks_count * assigned_workers / threadpool->threads_count);
+		queue->next_chunk = chunk_start;
+		queue->end_chunk = chunk_end;
+		chunk_start = chunk_end;
+	}
+
+	pthread_mutex_lock(&threadpool->mutex);
+	threadpool->task = task;
+	threadpool->context = context;
+	threadpool->range = range;
+	threadpool->chunk_size = chunk_size;
+	threadpool->active_workers = threadpool->threads_count - 1;
+	threadpool->generation += 1;
+	pthread_cond_broadcast(&threadpool->job_condition);
+	pthread_mutex_unlock(&threadpool->mutex);
+
+	run_chunks(&threadpool->workers[0]);
+
+	pthread_mutex_lock(&threadpool->mutex);
+	while (threadpool->active_workers != 0) {
+		pthread_cond_wait(&threadpool->done_condition, &threadpool->mutex);
+	}
+	pthread_mutex_unlock(&threadpool->mutex);
+	pthread_mutex_unlock(&threadpool->call_mutex);
+}
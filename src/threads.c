@@ -0,0 +1,450 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+#if defined(__linux__)
+	#include <dirent.h>
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <unistd.h>
+#endif
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define TASK_PATH_MAX 64
+	/* "run_ns wait_ns timeslices" with 64-bit counters */
+	#define SCHEDSTAT_BUFFER_SIZE 128
+	/* /proc/PID/task/TID/stat has 52 fields, and the thread name in it has at most 64 bytes */
+	#define STAT_BUFFER_SIZE 1024
+	/* Number of the processor field in /proc/PID/task/TID/stat, counted from 1 */
+	#define STAT_PROCESSOR_FIELD 39
+
+	#if !defined(O_CLOEXEC)
+		#define O_CLOEXEC 0
+	#endif
+#endif
+
+struct thread_state {
+	struct cpuinfo_thread_schedule schedule;
+	/* Run time since the sampler found the thread attributed to every core of the tables, in nanoseconds */
+	uint64_t* core_run_ns;
+#if defined(__linux__)
+	/* Open schedstat and stat files of the thread, read from the start at every sample */
+	int schedstat_file;
+	int stat_file;
+	/* Counters of schedstat at the previous sample */
+	uint64_t last_run_ns;
+	uint64_t last_wait_ns;
+	uint64_t last_timeslices;
+	/* Linux ID of the processor which ran the thread last at the previous sample, or UINT32_MAX */
+	uint32_t last_linux_id;
+	/* Whether the scan of the task directory of the current sample found the thread */
+	bool found;
+#endif
+};
+
+struct cpuinfo_thread_schedule_sampler {
+	uint32_t threads_count;
+	uint32_t threads_capacity;
+	struct thread_state* threads;
+	uint32_t cores_count;
+	uint32_t uarchs_count;
+	/* Index of the microarchitecture of every core */
+	uint32_t* core_uarchs;
+#if defined(__linux__)
+	/* Open task directory of the process, rescanned at every sample */
+	DIR* task_directory;
+	/* Index of the logical processor of every Linux processor ID up to the maximum in the tables, or UINT32_MAX */
+	uint32_t* linux_id_processors;
+	/* Index of the core of every logical processor */
+	uint32_t* processor_cores;
+	uint32_t linux_ids_count;
+#endif
+};
+
+#if defined(__linux__)
+	/* Parse a decimal number, and advance the text past it and the following spaces */
+	static uint64_t parse_number(const char* restrict text[restrict static 1], const char* text_end) {
+		const char* position = *text;
+		uint64_t value = 0;
+		for (; position != text_end && *position >= '0' && *position <= '9'; position++) {
+			value = value * 10 + (uint64_t) (*position - '0');
+		}
+		while (position != text_end && *position == ' ') {
+			position++;
+		}
+		*text = position;
+		return value;
+	}
+
+	static ssize_t read_file(int file, char* buffer, size_t buffer_size) {
+		ssize_t bytes_read;
+		do {
+			bytes_read = pread(file, buffer, buffer_size, 0);
+		} while (bytes_read < 0 && errno == EINTR);
+		return bytes_read;
+	}
+
+	static void close_thread_files(struct thread_state thread[restrict static 1]) {
+		if (thread->schedstat_file != -1) {
+			close(thread->schedstat_file);
+			thread->schedstat_file = -1;
+		}
+		if (thread->stat_file != -1) {
+			close(thread->stat_file);
+			thread->stat_file = -1;
+		}
+	}
+
+	/* Read the counters of schedstat and the processor field of stat; both fail after the thread exited */
+	static bool read_thread_files(const struct thread_state thread[restrict static 1],
+		uint64_t run_ns[restrict static 1], uint64_t wait_ns[restrict static 1], uint64_t timeslices[restrict static 1],
+		uint32_t linux_id[restrict static 1])
+	{
+		char buffer[STAT_BUFFER_SIZE];
+		ssize_t bytes_read = read_file(thread->schedstat_file, buffer, SCHEDSTAT_BUFFER_SIZE);
+		if (bytes_read <= 0) {
+			return false;
+		}
+		const char* position = buffer;
+		const char* buffer_end = buffer + bytes_read;
+		*run_ns = parse_number(&position, buffer_end);
+		*wait_ns = parse_number(&position, buffer_end);
+		*timeslices = parse_number(&position, buffer_end);
+
+		bytes_read = read_file(thread->stat_file, buffer, sizeof(buffer));
+		if (bytes_read <= 0) {
+			return false;
+		}
+		/* The thread name in the second field may contain spaces and parentheses: fields follow the last ')' */
+		buffer_end = buffer + bytes_read;
+		position = buffer_end;
+		while (position != buffer && position[-1] != ')') {
+			position--;
+		}
+		if (position == buffer) {
+			return false;
+		}
+		*linux_id = UINT32_MAX;
+		for (uint32_t field = 3; position != buffer_end; field++) {
+			while (position != buffer_end && *position == ' ') {
+				position++;
+			}
+			if (field == STAT_PROCESSOR_FIELD) {
+				if (position != buffer_end && *position >= '0' && *position <= '9') {
+					*linux_id = (uint32_t) parse_number(&position, buffer_end);
+				}
+				break;
+			}
+			while (position != buffer_end && *position != ' ') {
+				position++;
+			}
+		}
+		return true;
+	}
+
+	static struct thread_state* add_thread(struct cpuinfo_thread_schedule_sampler sampler[restrict static 1],
+		uint32_t thread_id)
+	{
+		if (sampler->threads_count == sampler->threads_capacity) {
+			const uint32_t capacity = sampler->threads_capacity != 0 ? sampler->threads_capacity * 2 : 16;
+			struct thread_state* threads = realloc(sampler->threads, capacity * sizeof(struct thread_state));
+			if (threads == NULL) {
+				cpuinfo_log_error("failed to allocate %zu bytes for scheduling of %"PRIu32" threads",
+					capacity * sizeof(struct thread_state), capacity);
+				return NULL;
+			}
+			sampler->threads = threads;
+			sampler->threads_capacity = capacity;
+		}
+
+		struct thread_state* thread = &sampler->threads[sampler->threads_count];
+		*thread = (struct thread_state) {
+			.schedule = { .thread_id = thread_id },
+			.core_run_ns = calloc(sampler->cores_count, sizeof(uint64_t)),
+			.schedstat_file = -1,
+			.stat_file = -1,
+			.last_linux_id = UINT32_MAX,
+		};
+		if (thread->core_run_ns == NULL && sampler->cores_count != 0) {
+			cpuinfo_log_error("failed to allocate %zu bytes for scheduling of thread %"PRIu32,
+				sampler->cores_count * sizeof(uint64_t), thread_id);
+			return NULL;
+		}
+
+		const int task_directory = dirfd(sampler->task_directory);
+		char path[TASK_PATH_MAX];
+		snprintf(path, sizeof(path), "%"PRIu32"/schedstat", thread_id);
+		thread->schedstat_file = openat(task_directory, path, O_RDONLY | O_CLOEXEC);
+		snprintf(path, sizeof(path), "%"PRIu32"/stat", thread_id);
+		thread->stat_file = openat(task_directory, path, O_RDONLY | O_CLOEXEC);
+		if (thread->schedstat_file == -1 || thread->stat_file == -1) {
+			/* The thread exited after the scan found it */
+			close_thread_files(thread);
+			free(thread->core_run_ns);
+			return NULL;
+		}
+
+		snprintf(path, sizeof(path), "%"PRIu32"/comm", thread_id);
+		const int comm_file = openat(task_directory, path, O_RDONLY | O_CLOEXEC);
+		if (comm_file != -1) {
+			const ssize_t bytes_read = read_file(comm_file, thread->schedule.name, CPUINFO_THREAD_NAME_MAX - 1);
+			for (ssize_t i = 0; i < bytes_read; i++) {
+				if (thread->schedule.name[i] == '\n') {
+					thread->schedule.name[i] = '\0';
+					break;
+				}
+			}
+			close(comm_file);
+		}
+		sampler->threads_count += 1;
+		return thread;
+	}
+
+	/* Find threads in the task directory which the sampler doesn't have yet, and open their files */
+	static bool scan_threads(struct cpuinfo_thread_schedule_sampler sampler[restrict static 1]) {
+		for (uint32_t i = 0; i < sampler->threads_count; i++) {
+			sampler->threads[i].found = false;
+		}
+		rewinddir(sampler->task_directory);
+		for (;;) {
+			errno = 0;
+			const struct dirent* entry = readdir(sampler->task_directory);
+			if (entry == NULL) {
+				if (errno != 0) {
+					cpuinfo_log_warning("failed to read task directory: %s", strerror(errno));
+					return false;
+				}
+				return true;
+			}
+			if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+				continue;
+			}
+			const uint32_t thread_id = (uint32_t) strtoul(entry->d_name, NULL, 10);
+			/* Threads which are not alive were removed before the scan, so a reused thread ID is a new thread */
+			uint32_t index = 0;
+			while (index < sampler->threads_count && sampler->threads[index].schedule.thread_id != thread_id) {
+				index++;
+			}
+			if (index != sampler->threads_count) {
+				sampler->threads[index].found = true;
+				continue;
+			}
+			struct thread_state* thread = add_thread(sampler, thread_id);
+			if (thread != NULL) {
+				thread->found = true;
+				thread->schedule.alive = read_thread_files(thread,
+					&thread->last_run_ns, &thread->last_wait_ns, &thread->last_timeslices, &thread->last_linux_id);
+			}
+		}
+	}
+
+	/* Attribute the run time of the thread between the two latest samples, and follow its processor */
+	static void update_thread(struct cpuinfo_thread_schedule_sampler sampler[restrict static 1],
+		struct thread_state thread[restrict static 1])
+	{
+		struct cpuinfo_thread_schedule* schedule = &thread->schedule;
+		uint64_t run_ns, wait_ns, timeslices;
+		uint32_t linux_id;
+		if (!thread->found || !read_thread_files(thread, &run_ns, &wait_ns, &timeslices, &linux_id)) {
+			close_thread_files(thread);
+			schedule->alive = false;
+			schedule->run_ns = schedule->wait_ns = schedule->timeslices = 0;
+			return;
+		}
+		schedule->run_ns = run_ns > thread->last_run_ns ? run_ns - thread->last_run_ns : 0;
+		schedule->wait_ns = wait_ns > thread->last_wait_ns ? wait_ns - thread->last_wait_ns : 0;
+		schedule->timeslices = timeslices > thread->last_timeslices ? timeslices - thread->last_timeslices : 0;
+		schedule->total_run_ns += schedule->run_ns;
+		schedule->total_wait_ns += schedule->wait_ns;
+		if (thread->last_linux_id != UINT32_MAX && linux_id != thread->last_linux_id) {
+			schedule->migrations += 1;
+		}
+		thread->last_run_ns = run_ns;
+		thread->last_wait_ns = wait_ns;
+		thread->last_timeslices = timeslices;
+		thread->last_linux_id = linux_id;
+
+		const uint32_t processor_index =
+			linux_id < sampler->linux_ids_count ? sampler->linux_id_processors[linux_id] : UINT32_MAX;
+		schedule->processor = processor_index != UINT32_MAX ? cpuinfo_get_processor(processor_index) : NULL;
+		if (processor_index != UINT32_MAX) {
+			thread->core_run_ns[sampler->processor_cores[processor_index]] += schedule->run_ns;
+		}
+	}
+#endif
+
+struct cpuinfo_thread_schedule_sampler* CPUINFO_ABI cpuinfo_create_thread_schedule_sampler(uint32_t process_id) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("thread_schedule_sampler");
+	#if defined(__linux__)
+		struct cpuinfo_thread_schedule_sampler* sampler = calloc(1, sizeof(struct cpuinfo_thread_schedule_sampler));
+		if (sampler == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for thread schedule sampler",
+				sizeof(struct cpuinfo_thread_schedule_sampler));
+			return NULL;
+		}
+		sampler->cores_count = tables->cores_count;
+		sampler->uarchs_count = tables->uarchs_count;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			if (tables->processors[i].linux_id >= 0 &&
+				(uint32_t) tables->processors[i].linux_id >= sampler->linux_ids_count)
+			{
+				sampler->linux_ids_count = (uint32_t) tables->processors[i].linux_id + 1;
+			}
+		}
+		sampler->core_uarchs = calloc(tables->cores_count, sizeof(uint32_t));
+		sampler->linux_id_processors = calloc(sampler->linux_ids_count, sizeof(uint32_t));
+		sampler->processor_cores = calloc(tables->processors_count, sizeof(uint32_t));
+		if ((sampler->core_uarchs == NULL && tables->cores_count != 0) ||
+			(sampler->linux_id_processors == NULL && sampler->linux_ids_count != 0) ||
+			(sampler->processor_cores == NULL && tables->processors_count != 0))
+		{
+			cpuinfo_log_error("failed to allocate thread schedule sampler of %"PRIu32" processors",
+				tables->processors_count);
+			cpuinfo_destroy_thread_schedule_sampler(sampler);
+			return NULL;
+		}
+		for (uint32_t i = 0; i < sampler->linux_ids_count; i++) {
+			sampler->linux_id_processors[i] = UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			const uint32_t core_index = (uint32_t) (processor->core - tables->cores);
+			if (processor->linux_id >= 0) {
+				sampler->linux_id_processors[processor->linux_id] = i;
+			}
+			sampler->processor_cores[i] = core_index;
+			sampler->core_uarchs[core_index] = cpuinfo_get_processor_uarch_index(tables, processor);
+		}
+
+		char path[TASK_PATH_MAX];
+		if (process_id == 0) {
+			snprintf(path, sizeof(path), "/proc/self/task");
+		} else {
+			snprintf(path, sizeof(path), "/proc/%"PRIu32"/task", process_id);
+		}
+		sampler->task_directory = opendir(path);
+		if (sampler->task_directory == NULL) {
+			cpuinfo_log_warning("failed to open %s: %s", path, strerror(errno));
+			cpuinfo_destroy_thread_schedule_sampler(sampler);
+			return NULL;
+		}
+		/* Take the initial sample, so that the first cpuinfo_sample_thread_schedules reports times since the creation */
+		if (!cpuinfo_sample_thread_schedules(sampler)) {
+			cpuinfo_destroy_thread_schedule_sampler(sampler);
+			return NULL;
+		}
+		return sampler;
+	#else
+		(void) tables;
+		(void) process_id;
+		return NULL;
+	#endif
+}
+
+void CPUINFO_ABI cpuinfo_destroy_thread_schedule_sampler(struct cpuinfo_thread_schedule_sampler* sampler) {
+	if (sampler == NULL) {
+		return;
+	}
+	for (uint32_t i = 0; i < sampler->threads_count; i++) {
+		#if defined(__linux__)
+			close_thread_files(&sampler->threads[i]);
+		#endif
+		free(sampler->threads[i].core_run_ns);
+	}
+	#if defined(__linux__)
+		if (sampler->task_directory != NULL) {
+			closedir(sampler->task_directory);
+		}
+		free(sampler->linux_id_processors);
+		free(sampler->processor_cores);
+	#endif
+	free(sampler->threads);
+	free(sampler->core_uarchs);
+	free(sampler);
+}
+
+bool CPUINFO_ABI cpuinfo_sample_thread_schedules(struct cpuinfo_thread_schedule_sampler* sampler) {
+	if (sampler == NULL) {
+		return false;
+	}
+	#if defined(__linux__)
+		/* Threads reported as exited at the previous sample are removed */
+		uint32_t alive_count = 0;
+		for (uint32_t i = 0; i < sampler->threads_count; i++) {
+			if (sampler->threads[i].schedule.alive) {
+				sampler->threads[alive_count++] = sampler->threads[i];
+			} else {
+				free(sampler->threads[i].core_run_ns);
+			}
+		}
+		sampler->threads_count = alive_count;
+
+		const uint32_t known_count = sampler->threads_count;
+		if (!scan_threads(sampler)) {
+			return false;
+		}
+		/* Threads found by this scan start with the counters of this sample */
+		for (uint32_t i = 0; i < known_count; i++) {
+			update_thread(sampler, &sampler->threads[i]);
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_thread_schedules_count(const struct cpuinfo_thread_schedule_sampler* sampler) {
+	return sampler != NULL ? sampler->threads_count : 0;
+}
+
+const struct cpuinfo_thread_schedule* CPUINFO_ABI cpuinfo_get_thread_schedule(
+	const struct cpuinfo_thread_schedule_sampler* sampler, uint32_t thread_index)
+{
+	if (sampler == NULL || thread_index >= sampler->threads_count) {
+		return NULL;
+	}
+	return &sampler->threads[thread_index].schedule;
+}
+
+uint64_t CPUINFO_ABI cpuinfo_get_thread_cores_run_time(const struct cpuinfo_thread_schedule_sampler* sampler,
+	uint32_t thread_index, uint32_t core_start, uint32_t core_count)
+{
+	if (sampler == NULL || thread_index >= sampler->threads_count || core_start >= sampler->cores_count) {
+		return 0;
+	}
+	if (core_count > sampler->cores_count - core_start) {
+		core_count = sampler->cores_count - core_start;
+	}
+	const uint64_t* core_run_ns = sampler->threads[thread_index].core_run_ns;
+	uint64_t run_ns = 0;
+	for (uint32_t i = core_start; i < core_start + core_count; i++) {
+		run_ns += core_run_ns[i];
+	}
+	return run_ns;
+}
+
+uint64_t CPUINFO_ABI cpuinfo_get_thread_uarch_run_time(const struct cpuinfo_thread_schedule_sampler* sampler,
+	uint32_t thread_index, uint32_t uarch_index)
+{
+	if (sampler == NULL || thread_index >= sampler->threads_count || uarch_index >= sampler->uarchs_count) {
+		return 0;
+	}
+	const uint64_t* core_run_ns = sampler->threads[thread_index].core_run_ns;
+	uint64_t run_ns = 0;
+	for (uint32_t i = 0; i < sampler->cores_count; i++) {
+		if (sampler->core_uarchs[i] == uarch_index) {
+			run_ns += core_run_ns[i];
+		}
+	}
+	return run_ns;
+}
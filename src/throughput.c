@@ -0,0 +1,177 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+struct ops_per_cycle {
+	uint32_t fp32;
+	uint32_t fp16;
+	uint32_t int8;
+};
+
+static inline uint32_t min_u32(uint32_t a, uint32_t b) {
+	return a < b ? a : b;
+}
+
+/* Peak operations per cycle of one core without a cost model, from the measurements of the instruction probe */
+static struct ops_per_cycle measure_ops_per_cycle(uint32_t uarch_index) {
+	struct ops_per_cycle ops = { 0 };
+	const struct cpuinfo_instruction_performance* performance = cpuinfo_get_uarch_instruction_performance(uarch_index);
+	struct cpuinfo_isa_features features;
+	if (performance == NULL || !cpuinfo_get_uarch_isa_features(uarch_index, &features)) {
+		return ops;
+	}
+	/* Throughputs are in instructions per 100 cycles */
+	const uint32_t width = performance->vector_width;
+	ops.fp32 = performance->fma.throughput * (width / 32) * 2 / 100;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avx512fp16)) {
+			ops.fp16 = ops.fp32 * 2;
+		}
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_fp16_arith)) {
+			ops.fp16 = ops.fp32 * 2;
+		}
+	#endif
+	if (performance->native_int8_dot) {
+		ops.int8 = performance->int8_dot.throughput * (width / 32) * 8 / 100;
+	} else {
+		ops.int8 = performance->int8_dot.throughput * (width / 16) * 2 / 100;
+	}
+	return ops;
+}
+
+/* Peak operations per cycle of one core, from the cost model of its microarchitecture and its ISA features */
+static struct ops_per_cycle compute_ops_per_cycle(const struct cpuinfo_tables* tables,
+	const struct cpuinfo_core* core)
+{
+	struct ops_per_cycle ops = { 0 };
+	const uint32_t uarch_index = cpuinfo_get_processor_uarch_index(tables, &tables->processors[core->processor_start]);
+	const struct cpuinfo_uarch_cost_model* cost_model = cpuinfo_get_uarch_cost_model(core->uarch);
+	if (cost_model == NULL) {
+		return measure_ops_per_cycle(uarch_index);
+	}
+	if (cost_model->vector_pipe_width == 0 || cost_model->vector_pipes == 0) {
+		return ops;
+	}
+
+	struct cpuinfo_isa_features features;
+	struct cpuinfo_vector_hint hint;
+	if (!cpuinfo_get_uarch_isa_features(uarch_index, &features) || !cpuinfo_get_uarch_vector_hint(uarch_index, &hint)) {
+		return ops;
+	}
+
+	/* Instructions wider than the pipes are split, and narrower ISA leave part of the pipes unused */
+	const uint32_t width = min_u32(cost_model->vector_pipe_width, hint.max_width);
+	uint32_t dot_width = width;
+	bool has_fma = false, has_fp16_arith = false, has_int8_dot = false, has_int8_matmul = false;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		has_fma = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_fma3);
+		has_fp16_arith = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avx512fp16);
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avx512vnni)) {
+			has_int8_dot = true;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avxvnni)) {
+			/* AVX-VNNI has only 128- and 256-bit forms */
+			has_int8_dot = true;
+			dot_width = min_u32(width, 256);
+		}
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		has_fma = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_fma);
+		has_fp16_arith = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_fp16_arith);
+		has_int8_dot = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_dot);
+		has_int8_matmul = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_i8mm);
+	#endif
+
+	/* Without FMA, peak needs a multiplication and an addition in different pipes every cycle */
+	const uint32_t multiply_pipes = cost_model->fma_units != 0 ?
+		cost_model->fma_units : min_u32(cost_model->vector_pipes, 2);
+	if (has_fma && cost_model->fma_units != 0) {
+		ops.fp32 = cost_model->fma_units * (width / 32) * 2;
+	} else {
+		ops.fp32 = min_u32(cost_model->vector_pipes, 2) * (width / 32);
+	}
+	if (has_fp16_arith) {
+		ops.fp16 = ops.fp32 * 2;
+	}
+	if (has_int8_dot) {
+		/* Dot product accumulates 4 products in every 32-bit lane; 8-bit matrix multiplication doubles that */
+		ops.int8 = multiply_pipes * (dot_width / 32) * 8 * (has_int8_matmul ? 2 : 1);
+	} else {
+		/* Widening multiply-accumulate produces one 16-bit sum of products per 16-bit lane */
+		ops.int8 = multiply_pipes * (width / 16) * 2;
+	}
+	return ops;
+}
+
+static void add_core_throughput(const struct cpuinfo_tables* tables, const struct cpuinfo_core* core,
+	struct cpuinfo_peak_throughput throughput[restrict static 1])
+{
+	const struct ops_per_cycle ops = compute_ops_per_cycle(tables, core);
+	const uint64_t frequency = core->max_turbo_frequency != 0 ? core->max_turbo_frequency : core->frequency;
+	throughput->fp32_ops_per_cycle += ops.fp32;
+	throughput->fp16_ops_per_cycle += ops.fp16;
+	throughput->int8_ops_per_cycle += ops.int8;
+	throughput->fp32_ops_per_second += (uint64_t) ops.fp32 * frequency;
+	throughput->fp16_ops_per_second += (uint64_t) ops.fp16 * frequency;
+	throughput->int8_ops_per_second += (uint64_t) ops.int8 * frequency;
+}
+
+static bool get_cores_peak_throughput(const struct cpuinfo_tables* tables, uint32_t core_start, uint32_t core_count,
+	struct cpuinfo_peak_throughput* throughput)
+{
+	if CPUINFO_UNLIKELY(throughput == NULL) {
+		return false;
+	}
+	*throughput = (struct cpuinfo_peak_throughput) { 0 };
+	for (uint32_t i = core_start; i < core_start + core_count; i++) {
+		add_core_throughput(tables, &tables->cores[i], throughput);
+	}
+	cpuinfo_log_debug("peak throughput of cores %"PRIu32"-%"PRIu32": %"PRIu32" FP32, %"PRIu32" FP16, %"PRIu32" INT8 "
+		"operations per cycle", core_start, core_start + core_count - 1,
+		throughput->fp32_ops_per_cycle, throughput->fp16_ops_per_cycle, throughput->int8_ops_per_cycle);
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_get_core_peak_throughput(const struct cpuinfo_core* core,
+	struct cpuinfo_peak_throughput* throughput)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("core_peak_throughput");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(core, tables->cores, tables->cores_count,
+			sizeof(struct cpuinfo_core), &index))
+	{
+		return false;
+	}
+	return get_cores_peak_throughput(tables, index, 1, throughput);
+}
+
+bool CPUINFO_ABI cpuinfo_get_cluster_peak_throughput(const struct cpuinfo_cluster* cluster,
+	struct cpuinfo_peak_throughput* throughput)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("cluster_peak_throughput");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(cluster, tables->clusters, tables->clusters_count,
+			sizeof(struct cpuinfo_cluster), &index))
+	{
+		return false;
+	}
+	return get_cores_peak_throughput(tables, cluster->core_start, cluster->core_count, throughput);
+}
+
+bool CPUINFO_ABI cpuinfo_get_package_peak_throughput(const struct cpuinfo_package* package,
+	struct cpuinfo_peak_throughput* throughput)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("package_peak_throughput");
+	uint32_t index;
+	if CPUINFO_UNLIKELY(!cpuinfo_get_table_index(package, tables->packages, tables->packages_count,
+			sizeof(struct cpuinfo_package), &index))
+	{
+		return false;
+	}
+	return get_cores_peak_throughput(tables, package->core_start, package->core_count, throughput);
+}
@@ -0,0 +1,41 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+
+
+static const struct cpuinfo_uarch_tlbs* get_uarch_tlbs(const struct cpuinfo_tables* tables, uint32_t uarch_index) {
+	if CPUINFO_UNLIKELY(uarch_index >= tables->uarchs_count || tables->uarch_tlbs == NULL) {
+		return NULL;
+	}
+	return &tables->uarch_tlbs[uarch_index];
+}
+
+/* Find the TLB which caches pages of the size, or NULL if there is none */
+static const struct cpuinfo_tlb* find_tlb(const struct cpuinfo_tlb tlbs[restrict static CPUINFO_MAX_TLBS_PER_LEVEL],
+	uint64_t page_size)
+{
+	for (uint32_t i = 0; i < CPUINFO_MAX_TLBS_PER_LEVEL; i++) {
+		if (tlbs[i].entries != 0 && (tlbs[i].pages & page_size) != 0) {
+			return &tlbs[i];
+		}
+	}
+	return NULL;
+}
+
+const struct cpuinfo_tlb* CPUINFO_ABI cpuinfo_get_l1i_tlb(uint32_t uarch_index, uint64_t page_size) {
+	const struct cpuinfo_uarch_tlbs* uarch_tlbs = get_uarch_tlbs(cpuinfo_get_tables("l1i_tlb"), uarch_index);
+	return uarch_tlbs != NULL ? find_tlb(uarch_tlbs->l1i, page_size) : NULL;
+}
+
+const struct cpuinfo_tlb* CPUINFO_ABI cpuinfo_get_l1d_tlb(uint32_t uarch_index, uint64_t page_size) {
+	const struct cpuinfo_uarch_tlbs* uarch_tlbs = get_uarch_tlbs(cpuinfo_get_tables("l1d_tlb"), uarch_index);
+	return uarch_tlbs != NULL ? find_tlb(uarch_tlbs->l1d, page_size) : NULL;
+}
+
+const struct cpuinfo_tlb* CPUINFO_ABI cpuinfo_get_l2_tlb(uint32_t uarch_index, uint64_t page_size) {
+	const struct cpuinfo_uarch_tlbs* uarch_tlbs = get_uarch_tlbs(cpuinfo_get_tables("l2_tlb"), uarch_index);
+	return uarch_tlbs != NULL ? find_tlb(uarch_tlbs->l2, page_size) : NULL;
+}
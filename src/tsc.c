@@ -0,0 +1,159 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+#if defined(_WIN32)
+	#include <windows.h>
+#elif defined(__APPLE__)
+	#include <mach/mach_time.h>
+#else
+	#include <time.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+uint32_t cpuinfo_selected_timestamp_source = cpuinfo_timestamp_source_os_clock;
+/* Frequency of the timestamp counter in Hz, published before the selection of the counter as the source */
+static uint64_t timestamp_frequency = 0;
+
+
+#if CPUINFO_ARCH_ARM64
+	/* Frequency of the system counter in Hz, readable at EL0 whenever the virtual counter is */
+	static inline uint64_t read_cntfrq(void) {
+		#if defined(_MSC_VER)
+			return (uint64_t) _ReadStatusReg(ARM64_SYSREG(3, 3, 14, 0, 0));
+		#else
+			uint64_t cntfrq;
+			__asm__ __volatile__("mrs %0, cntfrq_el0" : "=r" (cntfrq));
+			return cntfrq;
+		#endif
+	}
+#endif
+
+static uint64_t get_os_clock_frequency(void) {
+	#if defined(_WIN32)
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		return (uint64_t) frequency.QuadPart;
+	#elif defined(__APPLE__)
+		/* mach_absolute_time ticks are numer / denom nanoseconds */
+		mach_timebase_info_data_t timebase;
+		if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.numer == 0) {
+			return UINT64_C(1000000000);
+		}
+		return UINT64_C(1000000000) * timebase.denom / timebase.numer;
+	#else
+		/* Timestamps of clock_gettime are in nanoseconds */
+		return UINT64_C(1000000000);
+	#endif
+}
+
+/* Select the timestamp source after the detection of the timestamp counter */
+static void select_timestamp_source(const struct cpuinfo_tables* tables) {
+	enum cpuinfo_timestamp_source source = cpuinfo_timestamp_source_os_clock;
+	/* Counters of captures describe other systems */
+	if (!cpuinfo_replaying_capture && tables->tsc_invariant && tables->tsc_frequency != 0) {
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			if (cpuinfo_has_x86_rdtsc()) {
+				source = cpuinfo_has_x86_rdtscp() ?
+					cpuinfo_timestamp_source_x86_rdtscp : cpuinfo_timestamp_source_x86_rdtsc;
+			}
+		#elif CPUINFO_ARCH_ARM64
+			source = cpuinfo_timestamp_source_arm64_cntvct;
+		#endif
+	}
+	if (source != cpuinfo_timestamp_source_os_clock) {
+		timestamp_frequency = tables->tsc_frequency;
+	}
+	#if defined(__GNUC__)
+		__atomic_store_n(&cpuinfo_selected_timestamp_source, (uint32_t) source, __ATOMIC_RELEASE);
+	#else
+		cpuinfo_selected_timestamp_source = (uint32_t) source;
+	#endif
+	cpuinfo_log_debug("timestamp source %d at %"PRIu64" Hz", (int) source, cpuinfo_get_timestamp_frequency());
+}
+
+void cpuinfo_detect_tsc(struct cpuinfo_tables* tables) {
+	tables->tsc_frequency = 0;
+	tables->tsc_invariant = false;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		cpuinfo_x86_detect_tsc(&tables->tsc_frequency, &tables->tsc_invariant);
+	#elif CPUINFO_ARCH_ARM64
+		/* The system counter has a constant frequency by the architecture */
+		tables->tsc_frequency = read_cntfrq();
+		tables->tsc_invariant = true;
+	#endif
+	cpuinfo_log_debug("%s TSC frequency: %"PRIu64" Hz",
+		tables->tsc_invariant ? "invariant" : "non-invariant", tables->tsc_frequency);
+	select_timestamp_source(tables);
+}
+
+enum cpuinfo_timestamp_source CPUINFO_ABI cpuinfo_get_timestamp_source(void) {
+	return (enum cpuinfo_timestamp_source) cpuinfo_selected_timestamp_source;
+}
+
+uint64_t CPUINFO_ABI cpuinfo_get_timestamp_frequency(void) {
+	#if defined(__GNUC__)
+		const uint32_t source = __atomic_load_n(&cpuinfo_selected_timestamp_source, __ATOMIC_ACQUIRE);
+	#else
+		const uint32_t source = cpuinfo_selected_timestamp_source;
+	#endif
+	if (source == cpuinfo_timestamp_source_os_clock) {
+		return get_os_clock_frequency();
+	}
+	return timestamp_frequency;
+}
+
+uint64_t CPUINFO_ABI cpuinfo_read_os_timestamp(void) {
+	#if defined(_WIN32)
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		return (uint64_t) counter.QuadPart;
+	#elif defined(__APPLE__)
+		return mach_absolute_time();
+	#else
+		struct timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		return (uint64_t) time.tv_sec * UINT64_C(1000000000) + (uint64_t) time.tv_nsec;
+	#endif
+}
+
+uint64_t CPUINFO_ABI cpuinfo_read_timestamp_uninlined(bool ordered) {
+	#if CPUINFO_INLINE_TIMESTAMP
+		return ordered ? cpuinfo_read_timestamp_ordered() : cpuinfo_read_timestamp();
+	#elif (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && defined(_MSC_VER)
+		switch (cpuinfo_selected_timestamp_source) {
+			case cpuinfo_timestamp_source_x86_rdtscp:
+				if (ordered) {
+					unsigned int aux;
+					return (uint64_t) __rdtscp(&aux);
+				}
+				return (uint64_t) __rdtsc();
+			case cpuinfo_timestamp_source_x86_rdtsc:
+				if (ordered) {
+					_mm_lfence();
+				}
+				return (uint64_t) __rdtsc();
+			default:
+				return cpuinfo_read_os_timestamp();
+		}
+	#elif CPUINFO_ARCH_ARM64 && defined(_MSC_VER)
+		if (cpuinfo_selected_timestamp_source == cpuinfo_timestamp_source_arm64_cntvct) {
+			if (ordered) {
+				__isb(_ARM64_BARRIER_SY);
+			}
+			return (uint64_t) _ReadStatusReg(ARM64_CNTVCT);
+		}
+		return cpuinfo_read_os_timestamp();
+	#else
+		return cpuinfo_read_os_timestamp();
+	#endif
+}
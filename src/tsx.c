@@ -0,0 +1,142 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* TSX state is queried at runtime, and may change with microcode updates after initialization */
+	#define CPUINFO_X86_CPUID_UNCACHED 1
+	#include <x86/cpuid.h>
+#endif
+#if defined(__linux__)
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* Probe transactions are attempted several times, because interrupts and page faults abort transactions too */
+	#define RTM_PROBE_ATTEMPTS 16
+	/* Status of XBEGIN when the transaction started, as _XBEGIN_STARTED in <immintrin.h> */
+	#define RTM_STARTED UINT32_C(0xFFFFFFFF)
+
+	#if defined(__linux__)
+		#define KERNEL_COMMAND_LINE_FILENAME "/proc/cmdline"
+		#define KERNEL_COMMAND_LINE_FILESIZE 4096
+
+		static bool has_token(const char* text_start, const char* text_end, const char* token) {
+			const size_t length = strlen(token);
+			return (size_t) (text_end - text_start) == length && memcmp(text_start, token, length) == 0;
+		}
+
+		/* Parse the last tsx= parameter of the kernel command line, which takes effect if it is repeated */
+		static bool parse_tsx_mode(const char* text_start, const char* text_end, void* context) {
+			enum cpuinfo_x86_tsx_mode* mode = (enum cpuinfo_x86_tsx_mode*) context;
+			const char* parameter_start = text_start;
+			while (parameter_start != text_end) {
+				const char* parameter_end = parameter_start;
+				while (parameter_end != text_end && *parameter_end != ' ' && *parameter_end != '\n') {
+					parameter_end++;
+				}
+				if (parameter_end - parameter_start > 4 && memcmp(parameter_start, "tsx=", 4) == 0) {
+					const char* value_start = parameter_start + 4;
+					if (has_token(value_start, parameter_end, "on")) {
+						*mode = cpuinfo_x86_tsx_mode_on;
+					} else if (has_token(value_start, parameter_end, "off")) {
+						*mode = cpuinfo_x86_tsx_mode_off;
+					} else if (has_token(value_start, parameter_end, "auto")) {
+						*mode = cpuinfo_x86_tsx_mode_auto;
+					}
+				}
+				parameter_start = parameter_end != text_end ? parameter_end + 1 : text_end;
+			}
+			return true;
+		}
+	#endif
+
+	#if !CPUINFO_MOCK && (defined(__GNUC__) || defined(_MSC_VER))
+		#define CPUINFO_RTM_PROBE 1
+		#if defined(_MSC_VER) && !defined(__clang__)
+			#include <immintrin.h>
+		#endif
+
+		/* Execute an empty transaction, and return the status of XBEGIN: RTM_STARTED if it committed */
+		static uint32_t execute_empty_transaction(void) {
+			#if defined(_MSC_VER) && !defined(__clang__)
+				const uint32_t status = _xbegin();
+				if (status == RTM_STARTED) {
+					_xend();
+				}
+				return status;
+			#else
+				/* Encodings of XBEGIN and XEND, which assemble without -mrtm */
+				uint32_t status = RTM_STARTED;
+				__asm__ __volatile__ (
+					".byte 0xC7, 0xF8\n"
+					".long 1f - 0f\n"
+					"0:\n"
+					".byte 0x0F, 0x01, 0xD5\n"
+					"1:\n"
+					: "+a" (status)
+					:
+					: "memory");
+				return status;
+			#endif
+		}
+	#else
+		#define CPUINFO_RTM_PROBE 0
+	#endif
+#endif
+
+bool CPUINFO_ABI cpuinfo_get_x86_tsx_state(bool probe, struct cpuinfo_x86_tsx_state* state) {
+	if CPUINFO_UNLIKELY(state == NULL) {
+		return false;
+	}
+	*state = (struct cpuinfo_x86_tsx_state) { .rtm_status = cpuinfo_x86_rtm_status_unsupported };
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		#if defined(__linux__)
+			cpuinfo_linux_parse_small_file(KERNEL_COMMAND_LINE_FILENAME, KERNEL_COMMAND_LINE_FILESIZE,
+				parse_tsx_mode, &state->kernel_mode);
+			struct cpuinfo_vulnerability_state taa_state;
+			if (cpuinfo_get_vulnerability_state(cpuinfo_vulnerability_tsx_async_abort, &taa_state)) {
+				state->taa_status = taa_state.status;
+				state->taa_tsx_disabled = strstr(taa_state.description, "TSX disabled") != NULL;
+			}
+		#endif
+		if (!cpuinfo_has_x86_rtm()) {
+			return true;
+		}
+
+		/* RTM_ALWAYS_ABORT: CPUID leaf 7, subleaf 0, EDX bit 11 */
+		if (cpuid(0).eax >= 7) {
+			state->rtm_always_abort = !!(cpuidex(7, 0).edx & UINT32_C(0x00000800));
+		}
+		state->rtm_status = state->rtm_always_abort || state->taa_tsx_disabled ?
+			cpuinfo_x86_rtm_status_always_aborts : cpuinfo_x86_rtm_status_usable;
+		#if CPUINFO_RTM_PROBE
+			if (probe && state->rtm_status == cpuinfo_x86_rtm_status_usable) {
+				state->probed = true;
+				uint32_t status = 0;
+				for (uint32_t i = 0; i < RTM_PROBE_ATTEMPTS && !state->probe_committed; i++) {
+					status = execute_empty_transaction();
+					state->probe_committed = status == RTM_STARTED;
+				}
+				if (!state->probe_committed) {
+					cpuinfo_log_info("RTM transactions abort although CPUID reports RTM: last abort status 0x%08"PRIx32,
+						status);
+					state->rtm_status = cpuinfo_x86_rtm_status_always_aborts;
+				}
+			}
+		#else
+			(void) probe;
+		#endif
+		state->hle_usable = cpuinfo_has_x86_hle() && state->rtm_status == cpuinfo_x86_rtm_status_usable;
+		return true;
+	#else
+		(void) probe;
+		return false;
+	#endif
+}
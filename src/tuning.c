@@ -0,0 +1,512 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+#if defined(__linux__) || (defined(__MACH__) && defined(__APPLE__))
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <stdio.h>
+	#include <unistd.h>
+	#include <sys/stat.h>
+	#include <sys/types.h>
+#endif
+
+
+/* Parameters of the 64-bit FNV-1a hash */
+#define FNV_OFFSET_BASIS UINT64_C(0xCBF29CE484222325)
+#define FNV_PRIME UINT64_C(0x00000100000001B3)
+/* Parameters of the second lane of topology fingerprints */
+#define TOPOLOGY_HASH_OFFSET_BASIS UINT64_C(0x6C62272E07BB0142)
+#define TOPOLOGY_HASH_MULTIPLIER UINT64_C(0x9E3779B97F4A7C15)
+
+#define TUNING_VERSION 1
+/* Maximum length of the cache directory, including the terminating null character */
+#define TUNING_DIRECTORY_MAX 1024
+/* Cache files larger than this are considered corrupted, and replaced on the next write */
+#define TUNING_FILE_SIZE_MAX (16 * 1024 * 1024)
+
+/*
+ * Layout of a cache file: header, followed by records of key length, value size, key bytes without the null
+ * character, and value bytes. Records are unaligned and unordered, and keys are unique.
+ */
+struct tuning_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t records_count;
+	uint64_t fingerprint;
+};
+
+struct tuning_record_header {
+	uint32_t key_length;
+	uint32_t value_size;
+};
+
+static char tuning_directory[TUNING_DIRECTORY_MAX];
+
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+	const uint8_t* bytes = (const uint8_t*) data;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ (uint64_t) bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+static uint64_t hash_u32(uint64_t hash, uint32_t value) {
+	return hash_bytes(hash, &value, sizeof(value));
+}
+
+uint64_t CPUINFO_ABI cpuinfo_hardware_fingerprint(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("hardware_fingerprint");
+	uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, &tables->isa_fingerprint, sizeof(tables->isa_fingerprint));
+	for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+		const struct cpuinfo_uarch_info* uarch_info = &tables->uarchs[i];
+		hash = hash_u32(hash, (uint32_t) uarch_info->uarch);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			hash = hash_u32(hash, uarch_info->cpuid);
+		#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			hash = hash_u32(hash, uarch_info->midr);
+		#endif
+		hash = hash_u32(hash, uarch_info->core_count);
+	}
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		hash = hash_u32(hash, tables->cache_count[level]);
+		for (uint32_t i = 0; i < tables->cache_count[level]; i++) {
+			hash = hash_u32(hash, tables->cache[level][i].size);
+			hash = hash_u32(hash, tables->cache[level][i].associativity);
+		}
+	}
+	for (uint32_t i = 0; i < tables->packages_count; i++) {
+		const char* name = tables->packages[i].name;
+		hash = hash_bytes(hash, name, strnlen(name, CPUINFO_PACKAGE_NAME_MAX));
+	}
+	return hash;
+}
+
+/*
+ * 128-bit hash of the topology: two FNV-1a lanes with different offset bases and multipliers, each finalized with
+ * the 64-bit finalizer of MurmurHash3, so that a collision in one lane doesn't imply a collision in the other.
+ */
+struct topology_hash {
+	uint64_t lanes[2];
+};
+
+static void topology_hash_u32(struct topology_hash hash[restrict static 1], uint32_t value) {
+	for (uint32_t i = 0; i < 4; i++) {
+		const uint64_t byte = (uint64_t) ((value >> (i * 8)) & UINT32_C(0xFF));
+		hash->lanes[0] = (hash->lanes[0] ^ byte) * FNV_PRIME;
+		hash->lanes[1] = (hash->lanes[1] ^ byte) * TOPOLOGY_HASH_MULTIPLIER;
+	}
+}
+
+static void topology_hash_u64(struct topology_hash hash[restrict static 1], uint64_t value) {
+	topology_hash_u32(hash, (uint32_t) value);
+	topology_hash_u32(hash, (uint32_t) (value >> 32));
+}
+
+/* Index of the object in its table, or UINT32_MAX if the object is NULL */
+static uint32_t get_table_index(const void* object, const void* table, size_t entry_size) {
+	if (object == NULL || table == NULL) {
+		return UINT32_MAX;
+	}
+	return (uint32_t) (((uintptr_t) object - (uintptr_t) table) / entry_size);
+}
+
+static uint64_t finalize_lane(uint64_t lane) {
+	lane ^= lane >> 33;
+	lane *= UINT64_C(0xFF51AFD7ED558CCD);
+	lane ^= lane >> 33;
+	lane *= UINT64_C(0xC4CEB9FE1A85EC53);
+	lane ^= lane >> 33;
+	return lane;
+}
+
+bool CPUINFO_ABI cpuinfo_get_topology_fingerprint(struct cpuinfo_topology_fingerprint* fingerprint) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("topology_fingerprint");
+	if CPUINFO_UNLIKELY(fingerprint == NULL) {
+		return false;
+	}
+	struct topology_hash hash = { { FNV_OFFSET_BASIS, TOPOLOGY_HASH_OFFSET_BASIS } };
+	topology_hash_u32(&hash, tables->packages_count);
+	for (uint32_t i = 0; i < tables->packages_count; i++) {
+		const struct cpuinfo_package* package = &tables->packages[i];
+		topology_hash_u32(&hash, package->processor_count);
+		topology_hash_u32(&hash, package->core_count);
+		topology_hash_u32(&hash, package->cluster_count);
+	}
+	topology_hash_u32(&hash, tables->clusters_count);
+	for (uint32_t i = 0; i < tables->clusters_count; i++) {
+		const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+		topology_hash_u32(&hash, cluster->processor_count);
+		topology_hash_u32(&hash, cluster->core_count);
+		topology_hash_u32(&hash, (uint32_t) cluster->vendor);
+		topology_hash_u32(&hash, (uint32_t) cluster->uarch);
+	}
+	topology_hash_u32(&hash, tables->cores_count);
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		const struct cpuinfo_core* core = &tables->cores[i];
+		topology_hash_u32(&hash, core->processor_count);
+		topology_hash_u32(&hash, get_table_index(core->cluster, tables->clusters, sizeof(struct cpuinfo_cluster)));
+		topology_hash_u32(&hash, (uint32_t) core->uarch);
+	}
+	topology_hash_u32(&hash, tables->processors_count);
+	for (uint32_t i = 0; i < tables->processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		topology_hash_u32(&hash, get_table_index(processor->core, tables->cores, sizeof(struct cpuinfo_core)));
+		topology_hash_u32(&hash, processor->smt_id);
+	}
+	topology_hash_u32(&hash, tables->uarchs_count);
+	for (uint32_t i = 0; i < tables->uarchs_count; i++) {
+		const struct cpuinfo_uarch_info* uarch_info = &tables->uarchs[i];
+		topology_hash_u32(&hash, (uint32_t) uarch_info->uarch);
+		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+			topology_hash_u32(&hash, uarch_info->cpuid);
+		#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+			topology_hash_u32(&hash, uarch_info->midr);
+		#endif
+		topology_hash_u32(&hash, uarch_info->core_count);
+	}
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		topology_hash_u32(&hash, tables->cache_count[level]);
+		for (uint32_t i = 0; i < tables->cache_count[level]; i++) {
+			const struct cpuinfo_cache* cache = &tables->cache[level][i];
+			topology_hash_u32(&hash, cache->size);
+			topology_hash_u32(&hash, cache->associativity);
+			topology_hash_u32(&hash, cache->sets);
+			topology_hash_u32(&hash, cache->partitions);
+			topology_hash_u32(&hash, cache->line_size);
+			topology_hash_u32(&hash, cache->flags);
+			topology_hash_u32(&hash, cache->processor_start);
+			topology_hash_u32(&hash, cache->processor_count);
+		}
+	}
+	for (uint32_t i = 0; i < CPUINFO_ISA_FEATURE_WORDS; i++) {
+		topology_hash_u64(&hash, tables->isa_features.words[i]);
+	}
+
+	fingerprint->words[0] = finalize_lane(hash.lanes[0]);
+	fingerprint->words[1] = finalize_lane(hash.lanes[1]);
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_set_tuning_cache_directory(const char* path) {
+	if (path == NULL) {
+		tuning_directory[0] = '\0';
+		return true;
+	}
+	const size_t length = strlen(path);
+	if (length == 0 || length >= TUNING_DIRECTORY_MAX) {
+		cpuinfo_log_warning("unsupported length %zu of tuning cache directory", length);
+		return false;
+	}
+	memcpy(tuning_directory, path, length + 1);
+	return true;
+}
+
+#if defined(__linux__) || (defined(__MACH__) && defined(__APPLE__))
+
+static const char tuning_magic[8] = { 'C', 'P', 'U', 'I', 'N', 'F', 'O', 'T' };
+
+static bool validate_key(const char* key, uint32_t length[restrict static 1]) {
+	if (key == NULL) {
+		return false;
+	}
+	const size_t key_length = strnlen(key, CPUINFO_TUNING_KEY_MAX);
+	if (key_length == 0 || key_length >= CPUINFO_TUNING_KEY_MAX) {
+		cpuinfo_log_warning("unsupported length of tuning key");
+		return false;
+	}
+	*length = (uint32_t) key_length;
+	return true;
+}
+
+/* Find the record with the key in the records of a cache file, and return its offset, or 0 if not found */
+static size_t find_record(const char* file, const char* key, uint32_t key_length) {
+	struct tuning_header header;
+	memcpy(&header, file, sizeof(header));
+	size_t offset = sizeof(header);
+	for (uint32_t i = 0; i < header.records_count; i++) {
+		struct tuning_record_header record;
+		memcpy(&record, file + offset, sizeof(record));
+		if (record.key_length == key_length && memcmp(file + offset + sizeof(record), key, key_length) == 0) {
+			return offset;
+		}
+		offset += sizeof(record) + record.key_length + record.value_size;
+	}
+	return 0;
+}
+
+/* Compute the path of the cache file for the fingerprint, and optionally create its directory */
+static bool get_cache_path(uint64_t fingerprint, bool create_directory, char path[restrict static 1], size_t size) {
+	char directory[TUNING_DIRECTORY_MAX];
+	if (tuning_directory[0] != '\0') {
+		memcpy(directory, tuning_directory, sizeof(directory));
+	} else {
+		const char* cache_home = getenv("XDG_CACHE_HOME");
+		const char* home = getenv("HOME");
+		int length = -1;
+		if (cache_home != NULL && cache_home[0] == '/') {
+			length = snprintf(directory, sizeof(directory), "%s/cpuinfo", cache_home);
+		} else if (home != NULL && home[0] != '\0') {
+			if (create_directory) {
+				char cache_directory[TUNING_DIRECTORY_MAX];
+				const int cache_length = snprintf(cache_directory, sizeof(cache_directory), "%s/.cache", home);
+				if (cache_length > 0 && (size_t) cache_length < sizeof(cache_directory)) {
+					mkdir(cache_directory, 0700);
+				}
+			}
+			length = snprintf(directory, sizeof(directory), "%s/.cache/cpuinfo", home);
+		}
+		if (length < 0 || (size_t) length >= sizeof(directory)) {
+			cpuinfo_log_debug("no cache directory for tuning results");
+			return false;
+		}
+	}
+	if (create_directory && mkdir(directory, 0700) != 0 && errno != EEXIST) {
+		cpuinfo_log_warning("failed to create tuning cache directory %s: %s", directory, strerror(errno));
+		return false;
+	}
+	const int length = snprintf(path, size, "%s/tuning-%016"PRIx64".bin", directory, fingerprint);
+	return length > 0 && (size_t) length < size;
+}
+
+/* Read and validate the cache file; returns NULL if the file is missing or invalid */
+static char* read_cache_file(const char* path, uint64_t fingerprint, size_t file_size[restrict static 1]) {
+	const int file = open(path, O_RDONLY | O_CLOEXEC);
+	if (file == -1) {
+		return NULL;
+	}
+	char* buffer = NULL;
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0 || file_stat.st_size < (off_t) sizeof(struct tuning_header) ||
+		file_stat.st_size > TUNING_FILE_SIZE_MAX)
+	{
+		cpuinfo_log_warning("ignoring tuning cache file %s of unexpected size", path);
+		goto cleanup;
+	}
+	const size_t size = (size_t) file_stat.st_size;
+	buffer = malloc(size);
+	if (buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for tuning cache file %s", size, path);
+		goto cleanup;
+	}
+	size_t bytes_read = 0;
+	while (bytes_read < size) {
+		const ssize_t result = read(file, buffer + bytes_read, size - bytes_read);
+		if (result <= 0) {
+			if (result < 0 && errno == EINTR) {
+				continue;
+			}
+			cpuinfo_log_warning("failed to read tuning cache file %s", path);
+			goto invalid;
+		}
+		bytes_read += (size_t) result;
+	}
+
+	struct tuning_header header;
+	memcpy(&header, buffer, sizeof(header));
+	if (memcmp(header.magic, tuning_magic, sizeof(tuning_magic)) != 0 || header.version != TUNING_VERSION ||
+		header.fingerprint != fingerprint)
+	{
+		cpuinfo_log_warning("ignoring tuning cache file %s with unexpected header", path);
+		goto invalid;
+	}
+	/* Check that all records are within the file, so that lookups don't need to */
+	size_t offset = sizeof(header);
+	for (uint32_t i = 0; i < header.records_count; i++) {
+		struct tuning_record_header record;
+		if (size - offset < sizeof(record)) {
+			goto corrupted;
+		}
+		memcpy(&record, buffer + offset, sizeof(record));
+		offset += sizeof(record);
+		if (record.key_length >= CPUINFO_TUNING_KEY_MAX || record.value_size > CPUINFO_TUNING_VALUE_MAX ||
+			size - offset < (size_t) record.key_length + record.value_size)
+		{
+			goto corrupted;
+		}
+		offset += (size_t) record.key_length + record.value_size;
+	}
+	*file_size = offset;
+	goto cleanup;
+
+corrupted:
+	cpuinfo_log_warning("ignoring corrupted tuning cache file %s", path);
+invalid:
+	free(buffer);
+	buffer = NULL;
+cleanup:
+	close(file);
+	return buffer;
+}
+
+bool CPUINFO_ABI cpuinfo_tuning_get(const char* key, void* value, size_t* size) {
+	uint32_t key_length;
+	if (!validate_key(key, &key_length) || size == NULL) {
+		return false;
+	}
+	char path[TUNING_DIRECTORY_MAX + sizeof("/tuning-0123456789ABCDEF.bin")];
+	const uint64_t fingerprint = cpuinfo_hardware_fingerprint();
+	if (!get_cache_path(fingerprint, false, path, sizeof(path))) {
+		return false;
+	}
+	size_t file_size = 0;
+	char* file = read_cache_file(path, fingerprint, &file_size);
+	if (file == NULL) {
+		return false;
+	}
+
+	bool status = false;
+	const size_t offset = find_record(file, key, key_length);
+	if (offset != 0) {
+		struct tuning_record_header record;
+		memcpy(&record, file + offset, sizeof(record));
+		const size_t capacity = *size;
+		*size = record.value_size;
+		if (value != NULL && capacity >= record.value_size) {
+			memcpy(value, file + offset + sizeof(record) + key_length, record.value_size);
+			status = true;
+		}
+	}
+	free(file);
+	return status;
+}
+
+bool CPUINFO_ABI cpuinfo_tuning_put(const char* key, const void* value, size_t size) {
+	uint32_t key_length;
+	if (!validate_key(key, &key_length) || (value == NULL && size != 0)) {
+		return false;
+	}
+	if (size > CPUINFO_TUNING_VALUE_MAX) {
+		cpuinfo_log_warning("tuning result of %zu bytes exceeds the maximum size of %d bytes",
+			size, CPUINFO_TUNING_VALUE_MAX);
+		return false;
+	}
+	char path[TUNING_DIRECTORY_MAX + sizeof("/tuning-0123456789ABCDEF.bin")];
+	const uint64_t fingerprint = cpuinfo_hardware_fingerprint();
+	if (!get_cache_path(fingerprint, true, path, sizeof(path))) {
+		return false;
+	}
+
+	/* Copy records with other keys from the old file, and append the new record */
+	size_t old_size = 0;
+	char* old_file = read_cache_file(path, fingerprint, &old_size);
+	struct tuning_header header = {
+		.version = TUNING_VERSION,
+		.fingerprint = fingerprint,
+	};
+	memcpy(header.magic, tuning_magic, sizeof(tuning_magic));
+	size_t old_offset = 0, old_record_size = 0;
+	if (old_file != NULL) {
+		memcpy(&header.records_count, old_file + offsetof(struct tuning_header, records_count), sizeof(uint32_t));
+		old_offset = find_record(old_file, key, key_length);
+		if (old_offset != 0) {
+			struct tuning_record_header record;
+			memcpy(&record, old_file + old_offset, sizeof(record));
+			old_record_size = sizeof(record) + record.key_length + record.value_size;
+			header.records_count -= 1;
+		}
+	}
+	const size_t old_records_size = old_file != NULL ? old_size - sizeof(header) - old_record_size : 0;
+	const size_t new_size = sizeof(header) + old_records_size + sizeof(struct tuning_record_header) + key_length + size;
+	if (new_size > TUNING_FILE_SIZE_MAX) {
+		cpuinfo_log_warning("tuning cache file %s would exceed the maximum size", path);
+		free(old_file);
+		return false;
+	}
+
+	bool status = false;
+	char* temp_path = NULL;
+	char* buffer = malloc(new_size);
+	if (buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for tuning cache file %s", new_size, path);
+		goto cleanup;
+	}
+	header.records_count += 1;
+	memcpy(buffer, &header, sizeof(header));
+	size_t offset = sizeof(header);
+	if (old_file != NULL) {
+		if (old_offset != 0) {
+			memcpy(buffer + offset, old_file + sizeof(header), old_offset - sizeof(header));
+			offset += old_offset - sizeof(header);
+			const size_t tail_offset = old_offset + old_record_size;
+			memcpy(buffer + offset, old_file + tail_offset, old_size - tail_offset);
+			offset += old_size - tail_offset;
+		} else {
+			memcpy(buffer + offset, old_file + sizeof(header), old_size - sizeof(header));
+			offset += old_size - sizeof(header);
+		}
+	}
+	const struct tuning_record_header record = {
+		.key_length = key_length,
+		.value_size = (uint32_t) size,
+	};
+	memcpy(buffer + offset, &record, sizeof(record));
+	offset += sizeof(record);
+	memcpy(buffer + offset, key, key_length);
+	offset += key_length;
+	if (size != 0) {
+		memcpy(buffer + offset, value, size);
+	}
+
+	/* Write into a temporary file and rename it, so that concurrent readers never observe a partial file */
+	const size_t path_length = strlen(path);
+	temp_path = malloc(path_length + sizeof(".XXXXXX"));
+	if (temp_path == NULL) {
+		cpuinfo_log_error("failed to allocate memory for temporary tuning cache file name");
+		goto cleanup;
+	}
+	memcpy(temp_path, path, path_length);
+	memcpy(temp_path + path_length, ".XXXXXX", sizeof(".XXXXXX"));
+	const int file = mkstemp(temp_path);
+	if (file == -1) {
+		cpuinfo_log_error("failed to create temporary tuning cache file %s: %s", temp_path, strerror(errno));
+		goto cleanup;
+	}
+	size_t bytes_written = 0;
+	while (bytes_written < new_size) {
+		const ssize_t result = write(file, buffer + bytes_written, new_size - bytes_written);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			cpuinfo_log_error("failed to write tuning cache file %s: %s", temp_path, strerror(errno));
+			close(file);
+			unlink(temp_path);
+			goto cleanup;
+		}
+		bytes_written += (size_t) result;
+	}
+	close(file);
+	if (rename(temp_path, path) != 0) {
+		cpuinfo_log_error("failed to rename tuning cache file %s to %s: %s", temp_path, path, strerror(errno));
+		unlink(temp_path);
+		goto cleanup;
+	}
+	status = true;
+
+cleanup:
+	free(temp_path);
+	free(buffer);
+	free(old_file);
+	return status;
+}
+
+#else
+
+bool CPUINFO_ABI cpuinfo_tuning_get(const char* key, void* value, size_t* size) {
+	return false;
+}
+
+bool CPUINFO_ABI cpuinfo_tuning_put(const char* key, const void* value, size_t size) {
+	cpuinfo_log_info("persistent tuning cache is not supported on this operating system");
+	return false;
+}
+
+#endif
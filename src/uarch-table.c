@@ -0,0 +1,497 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+#if (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+	#include <arm/api.h>
+#endif
+
+
+/* Maximum length of a line of the table, including the terminating null character */
+#define UARCH_TABLE_LINE_MAX 256
+/* Table files larger than this are rejected */
+#define UARCH_TABLE_FILE_SIZE_MAX (64 * 1024)
+
+static struct cpuinfo_uarch_table_entry uarch_table[CPUINFO_UARCH_TABLE_MAX];
+static uint32_t uarch_table_count = 0;
+static struct cpuinfo_x86_uarch_table_entry x86_uarch_table[CPUINFO_UARCH_TABLE_MAX];
+static uint32_t x86_uarch_table_count = 0;
+static struct cpuinfo_chipset_table_entry chipset_table[CPUINFO_CHIPSET_TABLE_MAX];
+static uint32_t chipset_table_count = 0;
+
+static bool is_space(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* Parse the next number of the line and advance past it; returns false if there is no number */
+static bool parse_number(const char* text[restrict static 1], uint32_t number[restrict static 1]) {
+	const char* start = *text;
+	char* end;
+	const unsigned long long value = strtoull(start, &end, 0);
+	if (end == start || *start == '-' || *start == '+' || value > UINT32_MAX) {
+		return false;
+	}
+	*number = (uint32_t) value;
+	*text = end;
+	return true;
+}
+
+static void skip_spaces(const char* text[restrict static 1]) {
+	while (is_space(**text)) {
+		*text += 1;
+	}
+}
+
+/* Parse size/associativity/line size, or - for no cache */
+static bool parse_cache(const char* text[restrict static 1], struct cpuinfo_cache cache[restrict static 1]) {
+	*cache = (struct cpuinfo_cache) { 0 };
+	if (**text == '-') {
+		*text += 1;
+		return true;
+	}
+	uint32_t size, associativity, line_size;
+	if (!parse_number(text, &size)) {
+		return false;
+	}
+	uint32_t multiplier = 1;
+	if (**text == 'K') {
+		multiplier = 1024;
+		*text += 1;
+	} else if (**text == 'M') {
+		multiplier = 1024 * 1024;
+		*text += 1;
+	}
+	if (size > UINT32_MAX / multiplier || **text != '/') {
+		return false;
+	}
+	*text += 1;
+	if (!parse_number(text, &associativity) || **text != '/') {
+		return false;
+	}
+	*text += 1;
+	if (!parse_number(text, &line_size)) {
+		return false;
+	}
+	size *= multiplier;
+	/* Line size must be a power of 2, and the size a whole number of sets */
+	if (associativity == 0 || line_size == 0 || (line_size & (line_size - 1)) != 0 ||
+		associativity > UINT32_MAX / line_size || size % (associativity * line_size) != 0 || size == 0)
+	{
+		return false;
+	}
+	*cache = (struct cpuinfo_cache) {
+		.size = size,
+		.associativity = associativity,
+		.sets = size / (associativity * line_size),
+		.partitions = 1,
+		.line_size = line_size,
+	};
+	return true;
+}
+
+/*
+ * Parse a line of the table into the entry; returns false if the line is malformed. Lines without an entry, i.e.
+ * empty or with only a comment, are parsed successfully, and set *has_entry to false.
+ */
+static bool parse_line(
+	const char* line,
+	struct cpuinfo_uarch_table_entry entry[restrict static 1],
+	bool has_entry[restrict static 1])
+{
+	*has_entry = false;
+	skip_spaces(&line);
+	if (*line == '\0' || *line == '#') {
+		return true;
+	}
+
+	uint32_t midr, midr_mask, vendor, uarch;
+	if (!parse_number(&line, &midr) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_number(&line, &midr_mask) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_number(&line, &vendor) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_number(&line, &uarch) || uarch == cpuinfo_uarch_unknown) {
+		return false;
+	}
+	*entry = (struct cpuinfo_uarch_table_entry) {
+		.midr = midr & midr_mask,
+		.midr_mask = midr_mask,
+		.vendor = (enum cpuinfo_vendor) vendor,
+		.uarch = (enum cpuinfo_uarch) uarch,
+	};
+
+	skip_spaces(&line);
+	if (*line != '\0' && *line != '#') {
+		struct cpuinfo_cache* caches[4] = { &entry->l1i, &entry->l1d, &entry->l2, &entry->l3 };
+		for (uint32_t i = 0; i < 4; i++) {
+			skip_spaces(&line);
+			if (!parse_cache(&line, caches[i]) || (*line != '\0' && *line != '#' && !is_space(*line))) {
+				return false;
+			}
+		}
+		/* As in the built-in tables, cores have L1 caches, and L3 cache only behind L2 cache */
+		if (entry->l1i.size == 0 || entry->l1d.size == 0 || (entry->l2.size == 0 && entry->l3.size != 0)) {
+			return false;
+		}
+		skip_spaces(&line);
+		if (*line != '\0' && *line != '#') {
+			return false;
+		}
+	}
+	*has_entry = true;
+	return true;
+}
+
+/* Parse a number, or a range of numbers separated by -, and advance past it */
+static bool parse_range(
+	const char* text[restrict static 1],
+	uint32_t first[restrict static 1],
+	uint32_t last[restrict static 1])
+{
+	if (!parse_number(text, first)) {
+		return false;
+	}
+	*last = *first;
+	if (**text == '-') {
+		*text += 1;
+		if (!parse_number(text, last) || *last < *first) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Parse a line of the x86 table into the entry, as parse_line does for the ARM table */
+static bool parse_x86_line(
+	const char* line,
+	struct cpuinfo_x86_uarch_table_entry entry[restrict static 1],
+	bool has_entry[restrict static 1])
+{
+	*has_entry = false;
+	skip_spaces(&line);
+	if (*line == '\0' || *line == '#') {
+		return true;
+	}
+
+	uint32_t vendor, family, model_min, model_max, stepping_min, stepping_max, uarch;
+	if (!parse_number(&line, &vendor) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_number(&line, &family) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_range(&line, &model_min, &model_max) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_range(&line, &stepping_min, &stepping_max) || !is_space(*line)) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (!parse_number(&line, &uarch) || uarch == cpuinfo_uarch_unknown) {
+		return false;
+	}
+	skip_spaces(&line);
+	if (*line != '\0' && *line != '#') {
+		return false;
+	}
+	*entry = (struct cpuinfo_x86_uarch_table_entry) {
+		.vendor = (enum cpuinfo_vendor) vendor,
+		.family = family,
+		.model_min = model_min,
+		.model_max = model_max,
+		.stepping_min = stepping_min,
+		.stepping_max = stepping_max,
+		.uarch = (enum cpuinfo_uarch) uarch,
+	};
+	*has_entry = true;
+	return true;
+}
+
+/* Parse a line of the chipset table into the entry, as parse_line does for the ARM table */
+static bool parse_chipset_line(
+	const char* line,
+	struct cpuinfo_chipset_table_entry entry[restrict static 1],
+	bool has_entry[restrict static 1])
+{
+	*has_entry = false;
+	skip_spaces(&line);
+	if (*line == '\0' || *line == '#') {
+		return true;
+	}
+
+	const char* identifier = line;
+	while (*line != '\0' && *line != '#' && !is_space(*line)) {
+		line += 1;
+	}
+	const size_t identifier_length = (size_t) (line - identifier);
+	if (!is_space(*line) || identifier_length >= CPUINFO_CHIPSET_IDENTIFIER_MAX) {
+		return false;
+	}
+	skip_spaces(&line);
+
+	/* The name extends to the comment or the end of the line, without trailing spaces */
+	const char* name = line;
+	const char* name_end = name + strcspn(name, "#");
+	while (name_end != name && is_space(name_end[-1])) {
+		name_end -= 1;
+	}
+	const size_t name_length = (size_t) (name_end - name);
+	if (name_length == 0 || name_length >= CPUINFO_PACKAGE_NAME_MAX) {
+		return false;
+	}
+	#if (CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) && defined(__linux__)
+		struct cpuinfo_arm_chipset chipset;
+		if (!cpuinfo_arm_chipset_from_string(name, name_length, &chipset)) {
+			return false;
+		}
+	#endif
+
+	memset(entry, 0, sizeof(struct cpuinfo_chipset_table_entry));
+	memcpy(entry->identifier, identifier, identifier_length);
+	memcpy(entry->name, name, name_length);
+	*has_entry = true;
+	return true;
+}
+
+/* Copy the line at the offset into the buffer, and advance the offset to the next line */
+static bool get_line(
+	const char* table, size_t size,
+	size_t offset[restrict static 1],
+	uint32_t line_number[restrict static 1],
+	char line[restrict static UARCH_TABLE_LINE_MAX])
+{
+	const char* line_start = table + *offset;
+	const char* line_end = memchr(line_start, '\n', size - *offset);
+	const size_t length = line_end != NULL ? (size_t) (line_end - line_start) : size - *offset;
+	*offset += length + 1;
+	*line_number += 1;
+	if (length >= UARCH_TABLE_LINE_MAX) {
+		cpuinfo_log_warning("line %"PRIu32" of uarch table is too long", *line_number);
+		return false;
+	}
+	memcpy(line, line_start, length);
+	line[length] = '\0';
+	return true;
+}
+
+/* Read the whole file into a buffer allocated with malloc, or return NULL on failure */
+static char* read_table_file(const char* path, size_t size[restrict static 1]) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		cpuinfo_log_warning("failed to open uarch table file %s", path);
+		return NULL;
+	}
+	const size_t capacity = UARCH_TABLE_FILE_SIZE_MAX;
+	char* buffer = malloc(capacity);
+	if (buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %zu bytes for uarch table file %s", capacity, path);
+		fclose(file);
+		return NULL;
+	}
+	*size = fread(buffer, 1, capacity, file);
+	const bool failed = *size == capacity || ferror(file);
+	fclose(file);
+	if (failed) {
+		cpuinfo_log_warning("failed to read uarch table file %s, or it is larger than %zu bytes", path, capacity - 1);
+		free(buffer);
+		return NULL;
+	}
+	return buffer;
+}
+
+bool CPUINFO_ABI cpuinfo_register_uarch_table(const char* table, size_t size) {
+	if (table == NULL) {
+		uarch_table_count = 0;
+		return true;
+	}
+
+	/* Parse after the registered entries, and commit them only if the whole table is valid */
+	uint32_t count = uarch_table_count;
+	uint32_t line_number = 0;
+	for (size_t offset = 0; offset < size;) {
+		char line[UARCH_TABLE_LINE_MAX];
+		if (!get_line(table, size, &offset, &line_number, line)) {
+			return false;
+		}
+		struct cpuinfo_uarch_table_entry entry;
+		bool has_entry;
+		if (!parse_line(line, &entry, &has_entry)) {
+			cpuinfo_log_warning("failed to parse line %"PRIu32" of uarch table: %s", line_number, line);
+			return false;
+		}
+		if (has_entry) {
+			if (count == CPUINFO_UARCH_TABLE_MAX) {
+				cpuinfo_log_warning("uarch table exceeds %d entries", CPUINFO_UARCH_TABLE_MAX);
+				return false;
+			}
+			uarch_table[count++] = entry;
+		}
+	}
+	uarch_table_count = count;
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_register_uarch_table_file(const char* path) {
+	size_t size;
+	char* buffer = read_table_file(path, &size);
+	if (buffer == NULL) {
+		return false;
+	}
+	const bool registered = cpuinfo_register_uarch_table(buffer, size);
+	free(buffer);
+	return registered;
+}
+
+bool CPUINFO_ABI cpuinfo_register_x86_uarch_table(const char* table, size_t size) {
+	if (table == NULL) {
+		x86_uarch_table_count = 0;
+		return true;
+	}
+
+	uint32_t count = x86_uarch_table_count;
+	uint32_t line_number = 0;
+	for (size_t offset = 0; offset < size;) {
+		char line[UARCH_TABLE_LINE_MAX];
+		if (!get_line(table, size, &offset, &line_number, line)) {
+			return false;
+		}
+		struct cpuinfo_x86_uarch_table_entry entry;
+		bool has_entry;
+		if (!parse_x86_line(line, &entry, &has_entry)) {
+			cpuinfo_log_warning("failed to parse line %"PRIu32" of x86 uarch table: %s", line_number, line);
+			return false;
+		}
+		if (has_entry) {
+			if (count == CPUINFO_UARCH_TABLE_MAX) {
+				cpuinfo_log_warning("x86 uarch table exceeds %d entries", CPUINFO_UARCH_TABLE_MAX);
+				return false;
+			}
+			x86_uarch_table[count++] = entry;
+		}
+	}
+	x86_uarch_table_count = count;
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_register_x86_uarch_table_file(const char* path) {
+	size_t size;
+	char* buffer = read_table_file(path, &size);
+	if (buffer == NULL) {
+		return false;
+	}
+	const bool registered = cpuinfo_register_x86_uarch_table(buffer, size);
+	free(buffer);
+	return registered;
+}
+
+bool CPUINFO_ABI cpuinfo_register_chipset_table(const char* table, size_t size) {
+	if (table == NULL) {
+		chipset_table_count = 0;
+		return true;
+	}
+
+	uint32_t count = chipset_table_count;
+	uint32_t line_number = 0;
+	for (size_t offset = 0; offset < size;) {
+		char line[UARCH_TABLE_LINE_MAX];
+		if (!get_line(table, size, &offset, &line_number, line)) {
+			return false;
+		}
+		struct cpuinfo_chipset_table_entry entry;
+		bool has_entry;
+		if (!parse_chipset_line(line, &entry, &has_entry)) {
+			cpuinfo_log_warning("failed to parse line %"PRIu32" of chipset table: %s", line_number, line);
+			return false;
+		}
+		if (has_entry) {
+			if (count == CPUINFO_CHIPSET_TABLE_MAX) {
+				cpuinfo_log_warning("chipset table exceeds %d entries", CPUINFO_CHIPSET_TABLE_MAX);
+				return false;
+			}
+			chipset_table[count++] = entry;
+		}
+	}
+	chipset_table_count = count;
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_register_chipset_table_file(const char* path) {
+	size_t size;
+	char* buffer = read_table_file(path, &size);
+	if (buffer == NULL) {
+		return false;
+	}
+	const bool registered = cpuinfo_register_chipset_table(buffer, size);
+	free(buffer);
+	return registered;
+}
+
+const struct cpuinfo_uarch_table_entry* cpuinfo_find_uarch_table_entry(uint32_t midr) {
+	/* Later entries take priority */
+	for (uint32_t i = uarch_table_count; i != 0; i--) {
+		const struct cpuinfo_uarch_table_entry* entry = &uarch_table[i - 1];
+		if ((midr & entry->midr_mask) == entry->midr) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+const struct cpuinfo_x86_uarch_table_entry* cpuinfo_find_x86_uarch_table_entry(
+	enum cpuinfo_vendor vendor,
+	uint32_t family,
+	uint32_t model,
+	uint32_t stepping)
+{
+	for (uint32_t i = x86_uarch_table_count; i != 0; i--) {
+		const struct cpuinfo_x86_uarch_table_entry* entry = &x86_uarch_table[i - 1];
+		if (entry->vendor == vendor && entry->family == family &&
+			entry->model_min <= model && model <= entry->model_max &&
+			entry->stepping_min <= stepping && stepping <= entry->stepping_max)
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static char to_lower(char c) {
+	return c >= 'A' && c <= 'Z' ? (char) (c - 'A' + 'a') : c;
+}
+
+const struct cpuinfo_chipset_table_entry* cpuinfo_find_chipset_table_entry(const char* identifier, size_t length) {
+	if (length >= CPUINFO_CHIPSET_IDENTIFIER_MAX) {
+		return NULL;
+	}
+	for (uint32_t i = chipset_table_count; i != 0; i--) {
+		const struct cpuinfo_chipset_table_entry* entry = &chipset_table[i - 1];
+		if (entry->identifier[length] != '\0') {
+			continue;
+		}
+		size_t j = 0;
+		while (j < length && to_lower(entry->identifier[j]) == to_lower(identifier[j])) {
+			j++;
+		}
+		if (j == length) {
+			return entry;
+		}
+	}
+	return NULL;
+}
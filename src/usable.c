@@ -0,0 +1,526 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <sched.h>
+
+	#include <linux/api.h>
+#elif defined(__FreeBSD__)
+	#include <sys/param.h>
+	#include <sys/cpuset.h>
+#endif
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define CPU_QUOTA_FILESIZE 64
+	#define ONLINE_CPULIST_FILENAME "/sys/devices/system/cpu/online"
+	#define ISOLATED_CPULIST_FILENAME "/sys/devices/system/cpu/isolated"
+	#define NOHZ_FULL_CPULIST_FILENAME "/sys/devices/system/cpu/nohz_full"
+	#define ANDROID_CPUSET_FILENAME "/proc/self/cpuset"
+	/* Android mounts the cpuset hierarchy in /dev/cpuset with the noprefix option: files have no "cpuset." prefix */
+	#define ANDROID_CPUSET_MOUNT "/dev/cpuset"
+
+	struct cpuset_context {
+		cpu_set_t* cpu_set;
+		size_t cpu_set_size;
+		uint32_t linux_cpu_max;
+	};
+
+	static bool add_cpuset_processors(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+		const struct cpuset_context* cpuset_context = (const struct cpuset_context*) context;
+		if (cpu_end > cpuset_context->linux_cpu_max) {
+			cpu_end = cpuset_context->linux_cpu_max;
+		}
+		for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+			CPU_SET_S(cpu, cpuset_context->cpu_set_size, cpuset_context->cpu_set);
+		}
+		return true;
+	}
+
+	static void restrict_to_cpu_set(struct cpuinfo_tables* tables, const cpu_set_t* cpu_set, size_t cpu_set_size) {
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			struct cpuinfo_processor* processor = &tables->processors[i];
+			if (!CPU_ISSET_S((size_t) processor->linux_id, cpu_set_size, cpu_set)) {
+				processor->usable = false;
+			}
+		}
+	}
+
+	/* /proc/self/cpuset contains the path of the cpuset of the process, e.g. "/top-app", followed by a newline */
+	static bool parse_cpuset_path(const char* text_start, const char* text_end, void* context) {
+		char* path = (char*) context;
+		while (text_end != text_start && (text_end[-1] == '\n' || text_end[-1] == ' ')) {
+			text_end--;
+		}
+		const size_t length = (size_t) (text_end - text_start);
+		if (length == 0 || length >= CPUINFO_ANDROID_CPUSET_PATH_MAX || text_start[0] != '/') {
+			return false;
+		}
+		memcpy(path, text_start, length);
+		path[length] = '\0';
+		return true;
+	}
+
+	/* Read the cpuset path of the process, and add the cpus of the group in the Android hierarchy to the set */
+	static bool read_android_cpuset(char path[restrict static CPUINFO_ANDROID_CPUSET_PATH_MAX],
+		struct cpuset_context context[restrict static 1])
+	{
+		if (!cpuinfo_linux_parse_small_file(ANDROID_CPUSET_FILENAME, CPUINFO_ANDROID_CPUSET_PATH_MAX + 1,
+				parse_cpuset_path, path))
+		{
+			return false;
+		}
+		char filename[sizeof(ANDROID_CPUSET_MOUNT) + CPUINFO_ANDROID_CPUSET_PATH_MAX + sizeof("/cpus")];
+		snprintf(filename, sizeof(filename), ANDROID_CPUSET_MOUNT "%s/cpus", strcmp(path, "/") == 0 ? "" : path);
+		return cpuinfo_linux_parse_cpulist(filename, add_cpuset_processors, context) &&
+			CPU_COUNT_S(context->cpu_set_size, context->cpu_set) != 0;
+	}
+
+	/*
+	 * Restrict the usable processors to the affinity mask of the initializing thread, as nproc does, and to the
+	 * effective CPUs of the cpuset cgroup. The kernel keeps affinity masks within the cpuset, so the cpuset matters
+	 * only if the affinity mask is not available.
+	 */
+	static void detect_usable_processors(struct cpuinfo_tables* tables) {
+		if (tables->linux_cpu_max == 0) {
+			return;
+		}
+		cpu_set_t* cpu_set = cpuinfo_allocate_temporary(1, CPU_ALLOC_SIZE(tables->linux_cpu_max));
+		if (cpu_set == NULL) {
+			cpuinfo_log_warning("failed to allocate CPU set for %"PRIu32" processors", tables->linux_cpu_max);
+			return;
+		}
+		const size_t cpu_set_size = CPU_ALLOC_SIZE(tables->linux_cpu_max);
+
+		#if !CPUINFO_MOCK
+			CPU_ZERO_S(cpu_set_size, cpu_set);
+			if (sched_getaffinity(0, cpu_set_size, cpu_set) == 0) {
+				restrict_to_cpu_set(tables, cpu_set, cpu_set_size);
+			} else {
+				cpuinfo_log_info("failed to query affinity of the calling thread: all processors are usable");
+			}
+		#endif
+
+		struct cpuset_context context = {
+			.cpu_set = cpu_set,
+			.cpu_set_size = cpu_set_size,
+			.linux_cpu_max = tables->linux_cpu_max,
+		};
+		struct cpuinfo_linux_cgroup cgroup;
+		if (cpuinfo_linux_find_cgroup("cpuset", &cgroup)) {
+			CPU_ZERO_S(cpu_set_size, cpu_set);
+			/* Effective CPUs of the cpuset have different file names in cgroup v1 and v2 */
+			const char* effective_cpus_name = cgroup.unified ? "cpuset.cpus.effective" : "cpuset.effective_cpus";
+			if (cpuinfo_linux_parse_cgroup_cpulist(&cgroup, effective_cpus_name, add_cpuset_processors, &context) &&
+				CPU_COUNT_S(cpu_set_size, cpu_set) != 0)
+			{
+				restrict_to_cpu_set(tables, cpu_set, cpu_set_size);
+			}
+		}
+
+		/* On Android the cpuset hierarchy is outside of /sys/fs/cgroup, and the group changes with importance */
+		char android_cpuset_path[CPUINFO_ANDROID_CPUSET_PATH_MAX];
+		CPU_ZERO_S(cpu_set_size, cpu_set);
+		if (read_android_cpuset(android_cpuset_path, &context)) {
+			cpuinfo_log_debug("processes of Android cpuset %s may use %d processors",
+				android_cpuset_path, CPU_COUNT_S(cpu_set_size, cpu_set));
+			restrict_to_cpu_set(tables, cpu_set, cpu_set_size);
+		}
+		cpuinfo_free_temporary(cpu_set);
+	}
+
+	/*
+	 * Siblings turned off by the SMT control, or taken offline individually, stay present, and keep their places in
+	 * the topology, but are not online. All processors are online if the kernel doesn't list them.
+	 */
+	static void detect_online_processors(struct cpuinfo_tables* tables) {
+		tables->smt_control = cpuinfo_linux_get_smt_control();
+		if (tables->linux_cpu_max == 0) {
+			return;
+		}
+		cpu_set_t* online_set = cpuinfo_allocate_temporary(1, CPU_ALLOC_SIZE(tables->linux_cpu_max));
+		if (online_set == NULL) {
+			cpuinfo_log_warning("failed to allocate CPU set for %"PRIu32" processors", tables->linux_cpu_max);
+			return;
+		}
+		const size_t cpu_set_size = CPU_ALLOC_SIZE(tables->linux_cpu_max);
+		CPU_ZERO_S(cpu_set_size, online_set);
+		struct cpuset_context context = {
+			.cpu_set = online_set,
+			.cpu_set_size = cpu_set_size,
+			.linux_cpu_max = tables->linux_cpu_max,
+		};
+		if (cpuinfo_linux_parse_cpulist(ONLINE_CPULIST_FILENAME, add_cpuset_processors, &context) &&
+			CPU_COUNT_S(cpu_set_size, online_set) != 0)
+		{
+			for (uint32_t i = 0; i < tables->processors_count; i++) {
+				struct cpuinfo_processor* processor = &tables->processors[i];
+				if (!CPU_ISSET_S((size_t) processor->linux_id, cpu_set_size, online_set)) {
+					processor->online = false;
+					processor->usable = false;
+				}
+			}
+		}
+		cpuinfo_free_temporary(online_set);
+	}
+
+	/*
+	 * Both lists are empty if the kernel isolates no processors; nohz_full contains "(null)" on kernels built
+	 * without CONFIG_NO_HZ_FULL, which fails to parse and leaves the flags unset.
+	 */
+	static void detect_isolated_processors(struct cpuinfo_tables* tables) {
+		if (tables->linux_cpu_max == 0) {
+			return;
+		}
+		cpu_set_t* isolated_set = cpuinfo_allocate_temporary(1, CPU_ALLOC_SIZE(tables->linux_cpu_max));
+		cpu_set_t* nohz_full_set = cpuinfo_allocate_temporary(1, CPU_ALLOC_SIZE(tables->linux_cpu_max));
+		if (isolated_set == NULL || nohz_full_set == NULL) {
+			cpuinfo_log_warning("failed to allocate CPU sets for %"PRIu32" processors", tables->linux_cpu_max);
+			cpuinfo_free_temporary(isolated_set);
+			cpuinfo_free_temporary(nohz_full_set);
+			return;
+		}
+		const size_t cpu_set_size = CPU_ALLOC_SIZE(tables->linux_cpu_max);
+		CPU_ZERO_S(cpu_set_size, isolated_set);
+		CPU_ZERO_S(cpu_set_size, nohz_full_set);
+
+		struct cpuset_context context = {
+			.cpu_set = isolated_set,
+			.cpu_set_size = cpu_set_size,
+			.linux_cpu_max = tables->linux_cpu_max,
+		};
+		if (!cpuinfo_linux_parse_cpulist(ISOLATED_CPULIST_FILENAME, add_cpuset_processors, &context)) {
+			CPU_ZERO_S(cpu_set_size, isolated_set);
+		}
+		context.cpu_set = nohz_full_set;
+		if (!cpuinfo_linux_parse_cpulist(NOHZ_FULL_CPULIST_FILENAME, add_cpuset_processors, &context)) {
+			CPU_ZERO_S(cpu_set_size, nohz_full_set);
+		}
+
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			struct cpuinfo_processor* processor = &tables->processors[i];
+			processor->isolated = CPU_ISSET_S((size_t) processor->linux_id, cpu_set_size, isolated_set);
+			processor->nohz_full = CPU_ISSET_S((size_t) processor->linux_id, cpu_set_size, nohz_full_set);
+		}
+		cpuinfo_free_temporary(isolated_set);
+		cpuinfo_free_temporary(nohz_full_set);
+	}
+
+	struct cpu_quota {
+		/* Quota and period of CPU bandwidth, in microseconds; quota of 0 means no limit */
+		uint64_t quota;
+		uint64_t period;
+	};
+
+	/* Parse a decimal number at the start of the text, and return the end of the digits */
+	static const char* parse_decimal(const char* text_start, const char* text_end, uint64_t value[restrict static 1]) {
+		uint64_t number = 0;
+		const char* digit = text_start;
+		for (; digit != text_end && *digit >= '0' && *digit <= '9'; digit++) {
+			number = number * 10 + (uint64_t) (*digit - '0');
+		}
+		*value = number;
+		return digit;
+	}
+
+	/* cgroup v2 cpu.max contains quota and period, e.g. "400000 100000", or "max 100000" if unlimited */
+	static bool parse_cpu_max(const char* text_start, const char* text_end, void* context) {
+		struct cpu_quota* quota = (struct cpu_quota*) context;
+		if ((size_t) (text_end - text_start) >= 3 && memcmp(text_start, "max", 3) == 0) {
+			return true;
+		}
+		const char* quota_end = parse_decimal(text_start, text_end, &quota->quota);
+		if (quota_end == text_start || quota_end == text_end || *quota_end != ' ') {
+			quota->quota = 0;
+			return false;
+		}
+		parse_decimal(quota_end + 1, text_end, &quota->period);
+		return true;
+	}
+
+	/* cgroup v1 cpu.cfs_quota_us contains -1 if unlimited, and cpu.cfs_period_us contains a single number */
+	static bool parse_cfs_value(const char* text_start, const char* text_end, void* context) {
+		uint64_t* value = (uint64_t*) context;
+		if (text_start != text_end && *text_start == '-') {
+			return true;
+		}
+		return parse_decimal(text_start, text_end, value) != text_start;
+	}
+
+	/*
+	 * Detect the CPU bandwidth limit of the cgroup, in processors rounded up, or 0 if there is no limit.
+	 * Limits of the parent cgroups apply too, so the hierarchy is walked up to its mount point.
+	 */
+	static uint32_t detect_cpu_quota_limit(void) {
+		struct cpuinfo_linux_cgroup cgroup;
+		if (!cpuinfo_linux_find_cgroup("cpu", &cgroup)) {
+			return 0;
+		}
+
+		uint32_t limit = 0;
+		size_t path_length = strlen(cgroup.path);
+		for (;;) {
+			struct cpu_quota quota = { 0 };
+			if (cgroup.unified) {
+				cpuinfo_linux_parse_cgroup_small_file(&cgroup, "cpu.max", CPU_QUOTA_FILESIZE, parse_cpu_max, &quota);
+			} else if (cpuinfo_linux_parse_cgroup_small_file(&cgroup, "cpu.cfs_quota_us", CPU_QUOTA_FILESIZE,
+					parse_cfs_value, &quota.quota) && quota.quota != 0)
+			{
+				cpuinfo_linux_parse_cgroup_small_file(&cgroup, "cpu.cfs_period_us", CPU_QUOTA_FILESIZE,
+					parse_cfs_value, &quota.period);
+			}
+			if (quota.quota != 0 && quota.period != 0) {
+				const uint64_t quota_limit = (quota.quota + quota.period - 1) / quota.period;
+				const uint32_t cgroup_limit = quota_limit < UINT32_MAX ? (uint32_t) quota_limit : UINT32_MAX;
+				cpuinfo_log_debug("CPU bandwidth of cgroup %s is limited to %"PRIu64"/%"PRIu64" us",
+					cgroup.path, quota.quota, quota.period);
+				if (limit == 0 || cgroup_limit < limit) {
+					limit = cgroup_limit;
+				}
+			}
+
+			/* Move to the parent cgroup */
+			if (path_length <= cgroup.mount_length) {
+				break;
+			}
+			while (path_length > cgroup.mount_length && cgroup.path[path_length - 1] != '/') {
+				path_length--;
+			}
+			if (path_length > cgroup.mount_length) {
+				/* Strip the separator */
+				path_length--;
+			}
+			cgroup.path[path_length] = '\0';
+		}
+		return limit;
+	}
+#elif defined(_WIN32) || defined(__CYGWIN__)
+	/* Restrict the usable processors in the group of the calling thread to the affinity mask of the process */
+	static void detect_usable_processors(struct cpuinfo_tables* tables) {
+		DWORD_PTR process_mask = 0, system_mask = 0;
+		if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+			cpuinfo_log_info("failed to query affinity of the process: error %"PRIu32, (uint32_t) GetLastError());
+			return;
+		}
+		/* Processes with threads in multiple groups have zero masks, and may use processors in all groups */
+		GROUP_AFFINITY thread_affinity;
+		if (process_mask == 0 || !GetThreadGroupAffinity(GetCurrentThread(), &thread_affinity)) {
+			return;
+		}
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			struct cpuinfo_processor* processor = &tables->processors[i];
+			if (processor->windows_group_id == thread_affinity.Group &&
+				(process_mask & ((DWORD_PTR) 1 << processor->windows_processor_id)) == 0)
+			{
+				processor->usable = false;
+			}
+		}
+	}
+#elif defined(__FreeBSD__)
+	/* Restrict the usable processors to the cpuset of the calling thread; processor indices are FreeBSD CPU IDs */
+	static void detect_usable_processors(struct cpuinfo_tables* tables) {
+		cpuset_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		if (cpuset_getaffinity(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof(cpu_set), &cpu_set) != 0) {
+			cpuinfo_log_info("failed to query affinity of the calling thread: all processors are usable");
+			return;
+		}
+		for (uint32_t i = 0; i < tables->processors_count && i < CPU_SETSIZE; i++) {
+			if (!CPU_ISSET(i, &cpu_set)) {
+				tables->processors[i].usable = false;
+			}
+		}
+	}
+#else
+	static void detect_usable_processors(struct cpuinfo_tables* tables) {
+		(void) tables;
+	}
+#endif
+
+#if !defined(__linux__)
+	static void detect_online_processors(struct cpuinfo_tables* tables) {
+		(void) tables;
+	}
+
+	static void detect_isolated_processors(struct cpuinfo_tables* tables) {
+		(void) tables;
+	}
+
+	static uint32_t detect_cpu_quota_limit(void) {
+		return 0;
+	}
+#endif
+
+bool cpuinfo_build_usable_processors(struct cpuinfo_tables* tables) {
+	const uint32_t processors_count = tables->processors_count;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		tables->processors[i].usable = true;
+		tables->processors[i].isolated = false;
+		tables->processors[i].nohz_full = false;
+		tables->processors[i].online = true;
+	}
+	tables->smt_control = cpuinfo_smt_control_unknown;
+	if (!cpuinfo_replaying_capture) {
+		detect_online_processors(tables);
+		detect_usable_processors(tables);
+		detect_isolated_processors(tables);
+	}
+
+	uint32_t usable_count = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		usable_count += (uint32_t) tables->processors[i].usable;
+	}
+	if (usable_count == 0 && processors_count != 0) {
+		cpuinfo_log_warning("none of %"PRIu32" processors is usable by the process: all processors are usable",
+			processors_count);
+		for (uint32_t i = 0; i < processors_count; i++) {
+			tables->processors[i].usable = true;
+		}
+		usable_count = processors_count;
+	}
+
+	/* Online siblings determine whether SMT is active, and usable siblings the hardware threads for workers */
+	bool smt_active = false;
+	for (uint32_t i = 0; i < tables->cores_count; i++) {
+		struct cpuinfo_core* core = &tables->cores[i];
+		uint32_t online_count = 0, core_usable_count = 0;
+		for (uint32_t j = 0; j < core->processor_count; j++) {
+			const struct cpuinfo_processor* processor = &tables->processors[core->processor_start + j];
+			online_count += (uint32_t) processor->online;
+			core_usable_count += (uint32_t) processor->usable;
+		}
+		core->usable_processor_count = core_usable_count;
+		smt_active |= online_count > 1;
+	}
+	tables->smt_active = smt_active;
+	#if defined(__linux__)
+		if (!cpuinfo_replaying_capture) {
+			cpuinfo_linux_get_smt_active(&tables->smt_active);
+		}
+	#endif
+	if (usable_count == 0) {
+		return true;
+	}
+
+	const uint32_t quota_limit = cpuinfo_replaying_capture ? 0 : detect_cpu_quota_limit();
+	tables->effective_parallelism = quota_limit != 0 && quota_limit < usable_count ? quota_limit : usable_count;
+
+	uint32_t isolated_count = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		isolated_count += (uint32_t) (tables->processors[i].isolated || tables->processors[i].nohz_full);
+	}
+
+	struct cpuinfo_arena arena = { 0 };
+	const size_t usable_indices_offset = cpuinfo_arena_reserve(&arena, usable_count, sizeof(uint32_t));
+	const size_t isolated_indices_offset = cpuinfo_arena_reserve(&arena, isolated_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return false;
+	}
+	uint32_t* usable_indices = cpuinfo_arena_get(&arena, usable_indices_offset, usable_count);
+	uint32_t* isolated_indices = cpuinfo_arena_get(&arena, isolated_indices_offset, isolated_count);
+	uint32_t usable_index = 0, isolated_index = 0;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const struct cpuinfo_processor* processor = &tables->processors[i];
+		if (processor->usable) {
+			usable_indices[usable_index++] = i;
+		}
+		if (processor->isolated || processor->nohz_full) {
+			isolated_indices[isolated_index++] = i;
+		}
+	}
+	if (isolated_count != 0) {
+		cpuinfo_log_debug("%"PRIu32" of %"PRIu32" processors are isolated or nohz_full", isolated_count, processors_count);
+	}
+
+	/* Usable indices start the arena, and own it */
+	tables->usable_processor_indices = usable_indices;
+	tables->usable_processors_count = usable_count;
+	tables->isolated_processor_indices = isolated_indices;
+	tables->isolated_processors_count = isolated_count;
+	return true;
+}
+
+#if defined(__linux__)
+	static enum cpuinfo_android_cpuset_group get_android_cpuset_group(const char* path) {
+		static const struct {
+			const char* path;
+			enum cpuinfo_android_cpuset_group group;
+		} groups[] = {
+			{ "/", cpuinfo_android_cpuset_group_root },
+			{ "/top-app", cpuinfo_android_cpuset_group_top_app },
+			{ "/foreground", cpuinfo_android_cpuset_group_foreground },
+			{ "/background", cpuinfo_android_cpuset_group_background },
+			{ "/system-background", cpuinfo_android_cpuset_group_system_background },
+			{ "/restricted", cpuinfo_android_cpuset_group_restricted },
+		};
+		for (size_t i = 0; i < CPUINFO_COUNT_OF(groups); i++) {
+			if (strcmp(path, groups[i].path) == 0) {
+				return groups[i].group;
+			}
+		}
+		return cpuinfo_android_cpuset_group_other;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_get_android_cpuset(struct cpuinfo_android_cpuset* cpuset,
+	const struct cpuinfo_cluster** clusters)
+{
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("android_cpuset");
+	#if defined(__linux__)
+		if CPUINFO_UNLIKELY(cpuset == NULL || tables->linux_cpu_max == 0) {
+			return false;
+		}
+		const size_t cpu_set_size = CPU_ALLOC_SIZE(tables->linux_cpu_max);
+		cpu_set_t* cpu_set = calloc(1, cpu_set_size);
+		if (cpu_set == NULL) {
+			cpuinfo_log_error("failed to allocate CPU set for %"PRIu32" processors", tables->linux_cpu_max);
+			return false;
+		}
+		struct cpuset_context context = {
+			.cpu_set = cpu_set,
+			.cpu_set_size = cpu_set_size,
+			.linux_cpu_max = tables->linux_cpu_max,
+		};
+		struct cpuinfo_android_cpuset result = { .processors_count = 0 };
+		if (!read_android_cpuset(result.path, &context)) {
+			free(cpu_set);
+			return false;
+		}
+		result.group = get_android_cpuset_group(result.path);
+		for (uint32_t i = 0; i < tables->clusters_count; i++) {
+			const struct cpuinfo_cluster* cluster = &tables->clusters[i];
+			uint32_t cluster_processors_count = 0;
+			for (uint32_t j = cluster->processor_start; j < cluster->processor_start + cluster->processor_count; j++) {
+				const struct cpuinfo_processor* processor = &tables->processors[j];
+				cluster_processors_count +=
+					(uint32_t) (processor->online && CPU_ISSET_S((size_t) processor->linux_id, cpu_set_size, cpu_set));
+			}
+			if (cluster_processors_count != 0) {
+				if (clusters != NULL) {
+					clusters[result.clusters_count] = cluster;
+				}
+				result.clusters_count += 1;
+				result.processors_count += cluster_processors_count;
+			}
+		}
+		free(cpu_set);
+		*cpuset = result;
+		return true;
+	#else
+		(void) tables;
+		(void) cpuset;
+		(void) clusters;
+		return false;
+	#endif
+}
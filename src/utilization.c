@@ -0,0 +1,338 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define PROC_STAT_FILENAME "/proc/stat"
+	/* Large enough for several lines of /proc/stat: a cpuN line with 10 64-bit counters fits in 256 bytes */
+	#define PROC_STAT_BUFFER_SIZE 4096
+
+	#if !defined(O_CLOEXEC)
+		#define O_CLOEXEC 0
+	#endif
+#endif
+
+/* Times of a logical processor, in clock ticks of /proc/stat */
+struct processor_times {
+	/* user, nice, system, irq, and softirq times; user and nice include guest times */
+	uint64_t busy;
+	/* idle and iowait times */
+	uint64_t idle;
+	/* Time while the hypervisor ran other virtual processors */
+	uint64_t steal;
+	/* Whether the processor had a cpuN line in the sample */
+	bool present;
+};
+
+struct cpuinfo_utilization_sampler {
+	uint32_t processors_count;
+	/* Index of the NUMA node of every logical processor, or UINT32_MAX */
+	uint32_t* processor_numa_nodes;
+	/* Times of every logical processor at the previous sample */
+	struct processor_times* times;
+	/* Differences of times of every logical processor between the two latest samples */
+	struct processor_times* deltas;
+#if defined(__linux__)
+	/* Open /proc/stat file, read from the start at every sample */
+	int file;
+	/* Index of the logical processor of every Linux processor ID up to the maximum in the tables, or UINT32_MAX */
+	uint32_t* linux_id_processors;
+	uint32_t linux_ids_count;
+	/* Nanoseconds per clock tick of /proc/stat */
+	uint64_t tick_ns;
+	char* buffer;
+#endif
+};
+
+#if defined(__linux__)
+	/* Parse a decimal number, and advance the text past it and the following spaces */
+	static uint64_t parse_number(const char* restrict text[restrict static 1], const char* text_end) {
+		const char* position = *text;
+		uint64_t value = 0;
+		for (; position != text_end && *position >= '0' && *position <= '9'; position++) {
+			value = value * 10 + (uint64_t) (*position - '0');
+		}
+		while (position != text_end && *position == ' ') {
+			position++;
+		}
+		*text = position;
+		return value;
+	}
+
+	/*
+	 * Parse a "cpuN user nice system idle iowait irq softirq steal guest guest_nice" line into the times of its
+	 * logical processor. Counters missing on older kernels, such as steal, are 0.
+	 */
+	static void parse_cpu_line(struct cpuinfo_utilization_sampler sampler[restrict static 1],
+		const char* line_start, const char* line_end)
+	{
+		const char* position = line_start + strlen("cpu");
+		if (position == line_end || *position < '0' || *position > '9') {
+			/* Aggregate "cpu" line of all processors */
+			return;
+		}
+		const uint64_t linux_id = parse_number(&position, line_end);
+		if (linux_id >= sampler->linux_ids_count) {
+			return;
+		}
+		const uint32_t processor_index = sampler->linux_id_processors[linux_id];
+		if (processor_index == UINT32_MAX) {
+			return;
+		}
+
+		uint64_t values[8] = { 0 };
+		for (uint32_t i = 0; i < 8 && position != line_end; i++) {
+			values[i] = parse_number(&position, line_end);
+		}
+		sampler->deltas[processor_index] = (struct processor_times) {
+			.busy = values[0] + values[1] + values[2] + values[5] + values[6],
+			.idle = values[3] + values[4],
+			.steal = values[7],
+			.present = true,
+		};
+	}
+
+	/*
+	 * Read the cpuN lines at the start of /proc/stat into the deltas array, and stop at the first other line, so that
+	 * the long intr and softirq lines are never read.
+	 */
+	static bool read_proc_stat(struct cpuinfo_utilization_sampler sampler[restrict static 1]) {
+		if (lseek(sampler->file, 0, SEEK_SET) != 0) {
+			cpuinfo_log_warning("failed to rewind %s: %s", PROC_STAT_FILENAME, strerror(errno));
+			return false;
+		}
+		char* buffer = sampler->buffer;
+		size_t buffer_length = 0;
+		bool parsed = false;
+		for (;;) {
+			const ssize_t bytes_read =
+				read(sampler->file, buffer + buffer_length, PROC_STAT_BUFFER_SIZE - buffer_length);
+			if (bytes_read < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				cpuinfo_log_warning("failed to read %s: %s", PROC_STAT_FILENAME, strerror(errno));
+				return false;
+			}
+			buffer_length += (size_t) bytes_read;
+			const char* line_start = buffer;
+			const char* buffer_end = buffer + buffer_length;
+			for (;;) {
+				const size_t remaining = (size_t) (buffer_end - line_start);
+				if (remaining >= 3 && memcmp(line_start, "cpu", 3) != 0) {
+					return parsed;
+				}
+				const char* line_end = memchr(line_start, '\n', remaining);
+				if (line_end == NULL) {
+					break;
+				}
+				parse_cpu_line(sampler, line_start, line_end);
+				parsed = true;
+				line_start = line_end + 1;
+			}
+			if (bytes_read == 0) {
+				/* End of file: an incomplete last line is ignored */
+				return parsed;
+			}
+			/* Move the incomplete line to the start of the buffer */
+			buffer_length = (size_t) (buffer_end - line_start);
+			if (buffer_length == PROC_STAT_BUFFER_SIZE) {
+				cpuinfo_log_warning("line of %s doesn't fit into %d bytes", PROC_STAT_FILENAME, PROC_STAT_BUFFER_SIZE);
+				return false;
+			}
+			memmove(buffer, line_start, buffer_length);
+		}
+	}
+
+	/* Add the times of the logical processor between the two latest samples, if it was present in both */
+	static void add_processor_times(const struct cpuinfo_utilization_sampler sampler[restrict static 1],
+		uint32_t processor_index, struct cpuinfo_utilization utilization[restrict static 1])
+	{
+		const struct processor_times* delta = &sampler->deltas[processor_index];
+		if (delta->present) {
+			utilization->processors_count += 1;
+			utilization->busy_ns += delta->busy * sampler->tick_ns;
+			utilization->idle_ns += delta->idle * sampler->tick_ns;
+			utilization->steal_ns += delta->steal * sampler->tick_ns;
+		}
+	}
+
+	static inline uint64_t difference(uint64_t current, uint64_t previous) {
+		/* Idle time of nohz processors may go slightly backwards */
+		return current > previous ? current - previous : 0;
+	}
+#endif
+
+struct cpuinfo_utilization_sampler* CPUINFO_ABI cpuinfo_create_utilization_sampler(void) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("utilization_sampler");
+	#if defined(__linux__)
+		struct cpuinfo_utilization_sampler* sampler = calloc(1, sizeof(struct cpuinfo_utilization_sampler));
+		if (sampler == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for utilization sampler",
+				sizeof(struct cpuinfo_utilization_sampler));
+			return NULL;
+		}
+		sampler->file = -1;
+		sampler->processors_count = tables->processors_count;
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			if (tables->processors[i].linux_id >= 0 &&
+				(uint32_t) tables->processors[i].linux_id >= sampler->linux_ids_count)
+			{
+				sampler->linux_ids_count = (uint32_t) tables->processors[i].linux_id + 1;
+			}
+		}
+		sampler->processor_numa_nodes = calloc(sampler->processors_count, sizeof(uint32_t));
+		sampler->times = calloc(sampler->processors_count, sizeof(struct processor_times));
+		sampler->deltas = calloc(sampler->processors_count, sizeof(struct processor_times));
+		sampler->linux_id_processors = calloc(sampler->linux_ids_count, sizeof(uint32_t));
+		sampler->buffer = malloc(PROC_STAT_BUFFER_SIZE);
+		if (sampler->processor_numa_nodes == NULL || sampler->times == NULL || sampler->deltas == NULL ||
+			sampler->linux_id_processors == NULL || sampler->buffer == NULL)
+		{
+			cpuinfo_log_error("failed to allocate utilization sampler of %"PRIu32" processors",
+				sampler->processors_count);
+			cpuinfo_destroy_utilization_sampler(sampler);
+			return NULL;
+		}
+		for (uint32_t i = 0; i < sampler->linux_ids_count; i++) {
+			sampler->linux_id_processors[i] = UINT32_MAX;
+		}
+		for (uint32_t i = 0; i < tables->processors_count; i++) {
+			const struct cpuinfo_processor* processor = &tables->processors[i];
+			if (processor->linux_id >= 0) {
+				sampler->linux_id_processors[processor->linux_id] = i;
+			}
+			sampler->processor_numa_nodes[i] = processor->numa_node != NULL ?
+				(uint32_t) (processor->numa_node - tables->numa_nodes) : UINT32_MAX;
+		}
+
+		const long ticks_per_second = sysconf(_SC_CLK_TCK);
+		sampler->tick_ns = UINT64_C(1000000000) / (uint64_t) (ticks_per_second > 0 ? ticks_per_second : 100);
+		sampler->file = open(PROC_STAT_FILENAME, O_RDONLY | O_CLOEXEC);
+		if (sampler->file == -1) {
+			cpuinfo_log_warning("failed to open %s: %s", PROC_STAT_FILENAME, strerror(errno));
+			cpuinfo_destroy_utilization_sampler(sampler);
+			return NULL;
+		}
+		/* Take the initial sample, so that the first cpuinfo_sample_utilization reports times since the creation */
+		if (!cpuinfo_sample_utilization(sampler)) {
+			cpuinfo_destroy_utilization_sampler(sampler);
+			return NULL;
+		}
+		return sampler;
+	#else
+		(void) tables;
+		return NULL;
+	#endif
+}
+
+void CPUINFO_ABI cpuinfo_destroy_utilization_sampler(struct cpuinfo_utilization_sampler* sampler) {
+	if (sampler == NULL) {
+		return;
+	}
+	#if defined(__linux__)
+		if (sampler->file != -1) {
+			close(sampler->file);
+		}
+		free(sampler->linux_id_processors);
+		free(sampler->buffer);
+	#endif
+	free(sampler->processor_numa_nodes);
+	free(sampler->times);
+	free(sampler->deltas);
+	free(sampler);
+}
+
+bool CPUINFO_ABI cpuinfo_sample_utilization(struct cpuinfo_utilization_sampler* sampler) {
+	if (sampler == NULL) {
+		return false;
+	}
+	#if defined(__linux__)
+		/* Parse current times into deltas, then replace them by differences from the previous times */
+		memset(sampler->deltas, 0, sampler->processors_count * sizeof(struct processor_times));
+		if (!read_proc_stat(sampler)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < sampler->processors_count; i++) {
+			const struct processor_times current = sampler->deltas[i];
+			const struct processor_times previous = sampler->times[i];
+			sampler->deltas[i] = (struct processor_times) {
+				.busy = difference(current.busy, previous.busy),
+				.idle = difference(current.idle, previous.idle),
+				.steal = difference(current.steal, previous.steal),
+				.present = current.present && previous.present,
+			};
+			sampler->times[i] = current;
+		}
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_get_processors_utilization(const struct cpuinfo_utilization_sampler* sampler,
+	uint32_t processor_start, uint32_t processor_count, struct cpuinfo_utilization* utilization)
+{
+	if (sampler == NULL || utilization == NULL) {
+		return false;
+	}
+	*utilization = (struct cpuinfo_utilization) { 0 };
+	if (processor_start >= sampler->processors_count) {
+		return false;
+	}
+	if (processor_count > sampler->processors_count - processor_start) {
+		processor_count = sampler->processors_count - processor_start;
+	}
+	#if defined(__linux__)
+		for (uint32_t i = processor_start; i < processor_start + processor_count; i++) {
+			add_processor_times(sampler, i, utilization);
+		}
+	#endif
+	return utilization->processors_count != 0;
+}
+
+bool CPUINFO_ABI cpuinfo_get_llc_domain_utilization(const struct cpuinfo_utilization_sampler* sampler,
+	uint32_t llc_domain_index, struct cpuinfo_utilization* utilization)
+{
+	const struct cpuinfo_llc_domain* domain = cpuinfo_get_llc_domain(llc_domain_index);
+	if (domain == NULL) {
+		if (utilization != NULL) {
+			*utilization = (struct cpuinfo_utilization) { 0 };
+		}
+		return false;
+	}
+	return cpuinfo_get_processors_utilization(sampler, domain->processor_start, domain->processor_count, utilization);
+}
+
+bool CPUINFO_ABI cpuinfo_get_numa_node_utilization(const struct cpuinfo_utilization_sampler* sampler,
+	uint32_t numa_node_index, struct cpuinfo_utilization* utilization)
+{
+	if (sampler == NULL || utilization == NULL) {
+		return false;
+	}
+	*utilization = (struct cpuinfo_utilization) { 0 };
+	#if defined(__linux__)
+		/* NUMA nodes may interleave within a package, so processors are selected by node rather than by range */
+		for (uint32_t i = 0; i < sampler->processors_count; i++) {
+			if (sampler->processor_numa_nodes[i] == numa_node_index) {
+				add_processor_times(sampler, i, utilization);
+			}
+		}
+	#endif
+	return utilization->processors_count != 0;
+}
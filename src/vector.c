@@ -0,0 +1,381 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+	#include <errno.h>
+	#include <string.h>
+	#include <sys/prctl.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+	/* Constants from <linux/prctl.h> of Linux 4.15, which older kernel headers lack */
+	#ifndef PR_SVE_SET_VL
+		#define PR_SVE_SET_VL 50
+	#endif
+	#ifndef PR_SVE_GET_VL
+		#define PR_SVE_GET_VL 51
+	#endif
+	#ifndef PR_SVE_VL_LEN_MASK
+		#define PR_SVE_VL_LEN_MASK 0xFFFF
+	#endif
+	/* Constants from <linux/prctl.h> of Linux 5.19 */
+	#ifndef PR_SME_GET_VL
+		#define PR_SME_GET_VL 64
+	#endif
+	#ifndef PR_SME_VL_LEN_MASK
+		#define PR_SME_VL_LEN_MASK 0xFFFF
+	#endif
+#endif
+
+/* Widest vectors, in bits, which the ISA and the OS support, or 0 if there are no vector instructions */
+static uint32_t get_max_vector_width(void) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		if (cpuinfo_get_x86_avx10_max_vector_bits() != 0) {
+			return cpuinfo_get_x86_avx10_max_vector_bits();
+		} else if (cpuinfo_has_x86_avx512f()) {
+			return 512;
+		} else if (cpuinfo_has_x86_avx()) {
+			return 256;
+		} else if (cpuinfo_has_x86_sse()) {
+			return 128;
+		}
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		if (cpuinfo_has_arm_neon()) {
+			return 128;
+		}
+	#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		return cpuinfo_get_riscv_vector_length() * 8;
+	#elif CPUINFO_ARCH_LOONGARCH64
+		if (cpuinfo_has_loongarch_lasx()) {
+			return 256;
+		} else if (cpuinfo_has_loongarch_lsx()) {
+			return 128;
+		}
+	#elif CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+		if (cpuinfo_has_wasm_simd128()) {
+			return 128;
+		}
+	#endif
+	return 0;
+}
+
+static struct cpuinfo_uarch_vector_hints decode_vector_hints(enum cpuinfo_uarch uarch) {
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		return cpuinfo_x86_decode_vector_hints(uarch);
+	#else
+		return (struct cpuinfo_uarch_vector_hints) {
+			.preferred_width = 128,
+			.wide_vector_frequency_penalty = 0,
+		};
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_get_uarch_vector_hint(uint32_t uarch_index, struct cpuinfo_vector_hint* hint) {
+	const struct cpuinfo_tables* tables = cpuinfo_get_tables("uarch_vector_hint");
+	if (hint == NULL) {
+		return false;
+	}
+	const struct cpuinfo_processor* processor = cpuinfo_get_uarch_first_processor(tables, uarch_index);
+	if (processor == NULL) {
+		cpuinfo_log_debug("no processors with microarchitecture %"PRIu32" for vector hint", uarch_index);
+		return false;
+	}
+	const uint32_t max_width = get_max_vector_width();
+	if (max_width == 0) {
+		return false;
+	}
+
+	const struct cpuinfo_uarch_vector_hints hints = decode_vector_hints(processor->core->uarch);
+	*hint = (struct cpuinfo_vector_hint) {
+		.max_width = max_width,
+		.preferred_width = hints.preferred_width < max_width ? hints.preferred_width : max_width,
+		.wide_vector_frequency_penalty = max_width >= 512 ? hints.wide_vector_frequency_penalty : 0,
+	};
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_get_vector_info(uint32_t uarch_index, struct cpuinfo_vector_info* info) {
+	if (info == NULL) {
+		return false;
+	}
+	struct cpuinfo_vector_hint hint;
+	if (!cpuinfo_get_uarch_vector_hint(uarch_index, &hint)) {
+		return false;
+	}
+	*info = (struct cpuinfo_vector_info) {
+		.preferred_bits = hint.preferred_width,
+		.max_bits = hint.max_width,
+		.wide_vector_frequency_penalty = hint.wide_vector_frequency_penalty,
+	};
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		/* EVEX encodings of AVX-512 and AVX10 add 16 vector registers in 64-bit mode, and 8 opmask registers */
+		const bool evex = cpuinfo_has_x86_avx512f() || cpuinfo_get_x86_avx10_max_vector_bits() != 0;
+		#if CPUINFO_ARCH_X86_64
+			info->registers_count = evex ? 32 : 16;
+		#else
+			info->registers_count = 8;
+		#endif
+		if (evex) {
+			info->predicate_registers_count = 8;
+			info->predication = true;
+		}
+	#elif CPUINFO_ARCH_ARM64
+		info->registers_count = 32;
+		const uint32_t sve_bits = cpuinfo_get_arm_sve_vector_length() * 8;
+		if (sve_bits != 0) {
+			/* Code for SVE uses the vector length which the thread runs with */
+			info->preferred_bits = sve_bits;
+			if (sve_bits > info->max_bits) {
+				info->max_bits = sve_bits;
+			}
+			info->predicate_registers_count = 16;
+			info->predication = true;
+			info->scalable = true;
+		}
+	#elif CPUINFO_ARCH_ARM
+		/* 16 quadword registers, which alias 32 doubleword registers */
+		info->registers_count = 16;
+	#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		info->registers_count = 32;
+		info->preferred_bits = info->max_bits;
+		info->predication = true;
+		info->scalable = true;
+	#elif CPUINFO_ARCH_LOONGARCH64
+		info->registers_count = 32;
+	#endif
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_get_ml_capabilities(uint32_t uarch_index, struct cpuinfo_ml_capabilities* capabilities) {
+	if (capabilities == NULL) {
+		return false;
+	}
+	*capabilities = (struct cpuinfo_ml_capabilities) {
+		.int8 = cpuinfo_ml_tier_none,
+		.bf16 = cpuinfo_ml_tier_none,
+		.fp16 = cpuinfo_ml_tier_none,
+	};
+	struct cpuinfo_isa_features features;
+	if (!cpuinfo_get_uarch_isa_features(uarch_index, &features)) {
+		return false;
+	}
+	struct cpuinfo_vector_info info;
+	if (!cpuinfo_get_vector_info(uarch_index, &info)) {
+		return true;
+	}
+	capabilities->vector_bits = info.preferred_bits;
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_amx_int8)) {
+			capabilities->int8 = cpuinfo_ml_tier_matrix;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avx512vnni) ||
+			cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avxvnni))
+		{
+			capabilities->int8 = cpuinfo_ml_tier_arithmetic;
+		}
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_amx_bf16)) {
+			capabilities->bf16 = cpuinfo_ml_tier_matrix;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avx512bf16)) {
+			capabilities->bf16 = cpuinfo_ml_tier_arithmetic;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avxneconvert)) {
+			capabilities->bf16 = cpuinfo_ml_tier_convert;
+		}
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_amx_fp16)) {
+			capabilities->fp16 = cpuinfo_ml_tier_matrix;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_avx512fp16)) {
+			capabilities->fp16 = cpuinfo_ml_tier_arithmetic;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_f16c)) {
+			capabilities->fp16 = cpuinfo_ml_tier_convert;
+		}
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		/* SME includes outer products of INT8, BF16 and FP16 inputs with 32-bit accumulators */
+		const bool sme = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_sme);
+		if (sme) {
+			capabilities->int8 = cpuinfo_ml_tier_matrix;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_i8mm)) {
+			capabilities->int8 = cpuinfo_ml_tier_vector_matmul;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_dot)) {
+			capabilities->int8 = cpuinfo_ml_tier_arithmetic;
+		}
+		if (sme) {
+			capabilities->bf16 = cpuinfo_ml_tier_matrix;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_bf16) ||
+			cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_sve_bf16))
+		{
+			capabilities->bf16 = cpuinfo_ml_tier_vector_matmul;
+		}
+		if (sme) {
+			capabilities->fp16 = cpuinfo_ml_tier_matrix;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_fp16_arith)) {
+			capabilities->fp16 = cpuinfo_ml_tier_arithmetic;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_neon_fp16)) {
+			capabilities->fp16 = cpuinfo_ml_tier_convert;
+		}
+	#elif CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+		if (cpuinfo_has_riscv_zvfh() || cpuinfo_has_riscv_zfh()) {
+			capabilities->fp16 = cpuinfo_ml_tier_arithmetic;
+		} else if (cpuinfo_has_riscv_zfhmin()) {
+			capabilities->fp16 = cpuinfo_ml_tier_convert;
+		}
+	#endif
+	return true;
+}
+
+bool CPUINFO_ABI cpuinfo_get_checksum_capabilities(uint32_t uarch_index,
+	struct cpuinfo_checksum_capabilities* capabilities)
+{
+	if (capabilities == NULL) {
+		return false;
+	}
+	*capabilities = (struct cpuinfo_checksum_capabilities) {
+		.crc32c = cpuinfo_checksum_method_software,
+		.crc32 = cpuinfo_checksum_method_software,
+		.crc64 = cpuinfo_checksum_method_software,
+	};
+	struct cpuinfo_isa_features features;
+	if (!cpuinfo_get_uarch_isa_features(uarch_index, &features)) {
+		return false;
+	}
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		struct cpuinfo_vector_hint hint;
+		uint32_t vector_bits = cpuinfo_get_uarch_vector_hint(uarch_index, &hint) ? hint.preferred_width : 0;
+		if (cpuinfo_get_uarch_pitfalls(uarch_index) & CPUINFO_PITFALL_X86_SPLIT_256BIT) {
+			vector_bits = vector_bits < 128 ? vector_bits : 128;
+		}
+		const bool has_crc = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_sse4_2);
+		const bool has_clmul = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_pclmulqdq);
+		/* VPCLMULQDQ and VAES only have 256- and 512-bit forms */
+		const bool vector_clmul =
+			vector_bits >= 256 && cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_vpclmulqdq);
+		const bool vector_aes =
+			vector_bits >= 256 && cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_vaes);
+		if (vector_clmul) {
+			capabilities->crc32c = cpuinfo_checksum_method_vector_clmul;
+			capabilities->crc32 = cpuinfo_checksum_method_vector_clmul;
+			capabilities->crc64 = cpuinfo_checksum_method_vector_clmul;
+			capabilities->clmul_bits = vector_bits;
+		} else if (has_clmul) {
+			capabilities->crc32c = cpuinfo_checksum_method_clmul;
+			capabilities->crc32 = cpuinfo_checksum_method_clmul;
+			capabilities->crc64 = cpuinfo_checksum_method_clmul;
+			capabilities->clmul_bits = 128;
+		} else if (has_crc) {
+			capabilities->crc32c = cpuinfo_checksum_method_crc_instruction;
+		}
+		if (vector_aes) {
+			capabilities->aes_bits = vector_bits;
+		} else if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_x86_aes)) {
+			capabilities->aes_bits = 128;
+		}
+	#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+		const bool has_crc = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_crc32);
+		enum cpuinfo_checksum_method clmul_method = cpuinfo_checksum_method_software;
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_pmull)) {
+			clmul_method = cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_sha3) ?
+				cpuinfo_checksum_method_clmul_eor3 : cpuinfo_checksum_method_clmul;
+			capabilities->clmul_bits = 128;
+		}
+		if (clmul_method != cpuinfo_checksum_method_software) {
+			capabilities->crc32c = clmul_method;
+			capabilities->crc32 = clmul_method;
+			capabilities->crc64 = clmul_method;
+		} else if (has_crc) {
+			capabilities->crc32c = cpuinfo_checksum_method_crc_instruction;
+			capabilities->crc32 = cpuinfo_checksum_method_crc_instruction;
+		}
+		if (cpuinfo_isa_features_contain(&features, cpuinfo_isa_feature_arm_aes)) {
+			capabilities->aes_bits = 128;
+		}
+	#endif
+	return true;
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_arm_sve_vector_length(void) {
+	#if CPUINFO_ARCH_ARM64
+		if (!cpuinfo_has_arm_sve()) {
+			return 0;
+		}
+		#if defined(__linux__)
+			const int status = prctl(PR_SVE_GET_VL, 0, 0, 0, 0);
+			if (status < 0) {
+				cpuinfo_log_warning("failed to query SVE vector length: %s", strerror(errno));
+				return 0;
+			}
+			return (uint32_t) status & PR_SVE_VL_LEN_MASK;
+		#elif defined(__GNUC__)
+			/* RDVL X0, #1: read the vector length in bytes; encoded to build without SVE support in the compiler */
+			uint64_t vector_length;
+			__asm__ __volatile__(".inst 0x04BF5020\n\tmov %0, x0" : "=r" (vector_length) : : "x0");
+			return (uint32_t) vector_length;
+		#else
+			return 0;
+		#endif
+	#else
+		return 0;
+	#endif
+}
+
+bool CPUINFO_ABI cpuinfo_set_arm_sve_vector_length(uint32_t vector_length) {
+	#if CPUINFO_ARCH_ARM64 && defined(__linux__)
+		if (!cpuinfo_has_arm_sve() || vector_length == 0 || vector_length > PR_SVE_VL_LEN_MASK) {
+			return false;
+		}
+		/* The kernel rounds the length down to a supported one, and returns the new length */
+		const int status = prctl(PR_SVE_SET_VL, (unsigned long) vector_length, 0, 0, 0);
+		if (status < 0) {
+			cpuinfo_log_warning("failed to set SVE vector length to %"PRIu32" bytes: %s",
+				vector_length, strerror(errno));
+			return false;
+		}
+		return ((uint32_t) status & PR_SVE_VL_LEN_MASK) == vector_length;
+	#else
+		return false;
+	#endif
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_arm_sme_vector_length(void) {
+	#if CPUINFO_ARCH_ARM64
+		if (!cpuinfo_has_arm_sme()) {
+			return 0;
+		}
+		#if defined(__linux__)
+			const int status = prctl(PR_SME_GET_VL, 0, 0, 0, 0);
+			if (status < 0) {
+				cpuinfo_log_warning("failed to query SME streaming vector length: %s", strerror(errno));
+				return 0;
+			}
+			return (uint32_t) status & PR_SME_VL_LEN_MASK;
+		#elif defined(__GNUC__)
+			/* RDSVL X0, #1: read the streaming vector length in bytes; valid outside of streaming mode */
+			uint64_t vector_length;
+			__asm__ __volatile__(".inst 0x04BF5820\n\tmov %0, x0" : "=r" (vector_length) : : "x0");
+			return (uint32_t) vector_length;
+		#else
+			return 0;
+		#endif
+	#else
+		return 0;
+	#endif
+}
+
+uint32_t CPUINFO_ABI cpuinfo_get_riscv_vector_length(void) {
+	#if (CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64) && defined(__GNUC__)
+		if (!cpuinfo_has_riscv_v()) {
+			return 0;
+		}
+		/* CSRR of vlenb (CSR 0xC22) by number, for assemblers which do not know the vector extension */
+		unsigned long vlenb;
+		__asm__ __volatile__("csrr %0, 0xC22" : "=r" (vlenb));
+		return (uint32_t) vlenb;
+	#else
+		return 0;
+	#endif
+}
@@ -0,0 +1,87 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+#if defined(__linux__)
+	#include <linux/api.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if defined(__linux__)
+	#define VULNERABILITIES_DIRECTORY "/sys/devices/system/cpu/vulnerabilities/"
+	#define VULNERABILITY_FILESIZE 512
+
+	static const char* const vulnerability_filenames[cpuinfo_vulnerability_max] = {
+		[cpuinfo_vulnerability_spectre_v1] = VULNERABILITIES_DIRECTORY "spectre_v1",
+		[cpuinfo_vulnerability_spectre_v2] = VULNERABILITIES_DIRECTORY "spectre_v2",
+		[cpuinfo_vulnerability_meltdown] = VULNERABILITIES_DIRECTORY "meltdown",
+		[cpuinfo_vulnerability_spec_store_bypass] = VULNERABILITIES_DIRECTORY "spec_store_bypass",
+		[cpuinfo_vulnerability_l1tf] = VULNERABILITIES_DIRECTORY "l1tf",
+		[cpuinfo_vulnerability_mds] = VULNERABILITIES_DIRECTORY "mds",
+		[cpuinfo_vulnerability_tsx_async_abort] = VULNERABILITIES_DIRECTORY "tsx_async_abort",
+		[cpuinfo_vulnerability_itlb_multihit] = VULNERABILITIES_DIRECTORY "itlb_multihit",
+		[cpuinfo_vulnerability_srbds] = VULNERABILITIES_DIRECTORY "srbds",
+		[cpuinfo_vulnerability_mmio_stale_data] = VULNERABILITIES_DIRECTORY "mmio_stale_data",
+		[cpuinfo_vulnerability_retbleed] = VULNERABILITIES_DIRECTORY "retbleed",
+		[cpuinfo_vulnerability_gather_data_sampling] = VULNERABILITIES_DIRECTORY "gather_data_sampling",
+		[cpuinfo_vulnerability_spec_rstack_overflow] = VULNERABILITIES_DIRECTORY "spec_rstack_overflow",
+		[cpuinfo_vulnerability_reg_file_data_sampling] = VULNERABILITIES_DIRECTORY "reg_file_data_sampling",
+	};
+
+	static bool has_prefix(const char* text_start, size_t length, const char* prefix) {
+		const size_t prefix_length = strlen(prefix);
+		return length >= prefix_length && memcmp(text_start, prefix, prefix_length) == 0;
+	}
+
+	/*
+	 * Parse the status of a vulnerability, e.g.
+	 *   Not affected
+	 *   Vulnerable: Clear CPU buffers attempted, no microcode; SMT vulnerable
+	 *   Mitigation: Microcode
+	 *   Unknown: Dependent on hypervisor status
+	 */
+	static bool parse_vulnerability_status(const char* text_start, const char* text_end, void* context) {
+		struct cpuinfo_vulnerability_state* state = (struct cpuinfo_vulnerability_state*) context;
+		while (text_end != text_start && (text_end[-1] == '\n' || text_end[-1] == ' ')) {
+			text_end--;
+		}
+		size_t length = (size_t) (text_end - text_start);
+		if (has_prefix(text_start, length, "Not affected")) {
+			state->status = cpuinfo_vulnerability_status_not_affected;
+		} else if (has_prefix(text_start, length, "Vulnerable")) {
+			state->status = cpuinfo_vulnerability_status_vulnerable;
+		} else if (has_prefix(text_start, length, "Mitigation")) {
+			state->status = cpuinfo_vulnerability_status_mitigated;
+			state->microcode_mitigation = has_prefix(text_start, length, "Mitigation: Microcode");
+		}
+
+		if (length >= CPUINFO_VULNERABILITY_DESCRIPTION_MAX) {
+			length = CPUINFO_VULNERABILITY_DESCRIPTION_MAX - 1;
+		}
+		memcpy(state->description, text_start, length);
+		state->description[length] = '\0';
+		return true;
+	}
+#endif
+
+bool CPUINFO_ABI cpuinfo_get_vulnerability_state(enum cpuinfo_vulnerability vulnerability,
+	struct cpuinfo_vulnerability_state* state)
+{
+	if CPUINFO_UNLIKELY(state == NULL) {
+		return false;
+	}
+	*state = (struct cpuinfo_vulnerability_state) { .status = cpuinfo_vulnerability_status_unknown };
+	if CPUINFO_UNLIKELY((uint32_t) vulnerability >= (uint32_t) cpuinfo_vulnerability_max) {
+		return false;
+	}
+	#if defined(__linux__)
+		return cpuinfo_linux_parse_small_file(vulnerability_filenames[vulnerability], VULNERABILITY_FILESIZE,
+			parse_vulnerability_status, state);
+	#else
+		return false;
+	#endif
+}
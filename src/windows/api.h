@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/common.h>
+
+
+/* RelationNumaNodeEx of Windows 11 and Windows Server 2022: NUMA nodes with all their processor groups */
+#define CPUINFO_WINDOWS_RELATION_NUMA_NODE_EX ((LOGICAL_PROCESSOR_RELATIONSHIP) 6)
+
+/* Layout of NUMA_NODE_RELATIONSHIP with GroupCount, which SDK headers before Windows 11 declare as reserved */
+struct cpuinfo_windows_numa_node_relationship {
+	DWORD node_number;
+	BYTE reserved[18];
+	/* Number of entries in group_masks, or 0 before Windows 11 and Windows Server 2022, which report only one */
+	WORD group_count;
+	GROUP_AFFINITY group_masks[ANYSIZE_ARRAY];
+};
+
+/* Entries of a GetLogicalProcessorInformationEx query, indexed by relation in the order reported by Windows */
+struct cpuinfo_windows_topology {
+	/* Buffer filled by GetLogicalProcessorInformationEx */
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX buffer;
+	/* Storage for pointers to the entries of all relations */
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* entries;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* cores;
+	uint32_t cores_count;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* packages;
+	uint32_t packages_count;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* caches;
+	uint32_t caches_count;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* numa_nodes;
+	uint32_t numa_nodes_count;
+	/* Entry of the processor groups, or NULL if the query didn't include RelationGroup */
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX groups;
+};
+
+/*
+ * Query logical processor information of a relation, e.g. RelationAll, with one GetLogicalProcessorInformationEx call,
+ * and index the entries by relation in one pass. Memory is allocated on the process heap.
+ */
+CPUINFO_INTERNAL bool cpuinfo_windows_query_topology(LOGICAL_PROCESSOR_RELATIONSHIP relation,
+	struct cpuinfo_windows_topology topology[restrict static 1]);
+CPUINFO_INTERNAL void cpuinfo_windows_release_topology(struct cpuinfo_windows_topology topology[restrict static 1]);
+
+/* Maximum number of processor groups, as GetMaximumProcessorGroupCount */
+static inline uint32_t cpuinfo_windows_get_max_group_count(
+	const struct cpuinfo_windows_topology topology[restrict static 1])
+{
+	return topology->groups != NULL ? (uint32_t) topology->groups->Group.MaximumGroupCount : 0;
+}
+
+/* Maximum number of logical processors in a processor group, as GetMaximumProcessorCount, or 0 if it is inactive */
+static inline uint32_t cpuinfo_windows_get_group_processors_count(
+	const struct cpuinfo_windows_topology topology[restrict static 1], uint32_t group)
+{
+	if (topology->groups == NULL || group >= topology->groups->Group.ActiveGroupCount) {
+		return 0;
+	}
+	return (uint32_t) topology->groups->Group.GroupInfo[group].MaximumProcessorCount;
+}
@@ -0,0 +1,125 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <windows.h>
+
+#include <cpuinfo.h>
+#include <windows/api.h>
+#include <cpuinfo/log.h>
+
+
+static inline PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX next_info(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info) {
+	return (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) info + info->Size);
+}
+
+bool cpuinfo_windows_query_topology(
+	LOGICAL_PROCESSOR_RELATIONSHIP relation,
+	struct cpuinfo_windows_topology topology[restrict static 1])
+{
+	HANDLE heap = GetProcessHeap();
+	ZeroMemory(topology, sizeof(struct cpuinfo_windows_topology));
+
+	DWORD info_size = 0;
+	if (GetLogicalProcessorInformationEx(relation, NULL, &info_size) == FALSE) {
+		const DWORD last_error = GetLastError();
+		if (last_error != ERROR_INSUFFICIENT_BUFFER) {
+			cpuinfo_log_debug("failed to query size of logical processor information of relation %"PRIu32
+				": error %"PRIu32, (uint32_t) relation, (uint32_t) last_error);
+			return false;
+		}
+	}
+
+	topology->buffer = HeapAlloc(heap, 0, info_size);
+	if (topology->buffer == NULL) {
+		cpuinfo_log_error("failed to allocate %"PRIu32" bytes for logical processor information",
+			(uint32_t) info_size);
+		return false;
+	}
+	if (GetLogicalProcessorInformationEx(relation, topology->buffer, &info_size) == FALSE) {
+		cpuinfo_log_error("failed to query logical processor information of relation %"PRIu32": error %"PRIu32,
+			(uint32_t) relation, (uint32_t) GetLastError());
+		goto error;
+	}
+
+	/* Count entries of every relation, so that a single allocation holds the pointers to all of them */
+	const PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info_end =
+		(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) topology->buffer + info_size);
+	uint32_t entries_count = 0;
+	for (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = topology->buffer; info < info_end; info = next_info(info)) {
+		switch (info->Relationship) {
+			case RelationProcessorCore:
+				topology->cores_count += 1;
+				break;
+			case RelationProcessorPackage:
+				topology->packages_count += 1;
+				break;
+			case RelationCache:
+				topology->caches_count += 1;
+				break;
+			case RelationNumaNode:
+			case CPUINFO_WINDOWS_RELATION_NUMA_NODE_EX:
+				topology->numa_nodes_count += 1;
+				break;
+			case RelationGroup:
+				topology->groups = info;
+				continue;
+			default:
+				continue;
+		}
+		entries_count += 1;
+	}
+
+	if (entries_count != 0) {
+		topology->entries = HeapAlloc(heap, 0, entries_count * sizeof(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX));
+		if (topology->entries == NULL) {
+			cpuinfo_log_error("failed to allocate %zu bytes for %"PRIu32" logical processor information entries",
+				entries_count * sizeof(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX), entries_count);
+			goto error;
+		}
+	}
+	topology->cores = topology->entries;
+	topology->packages = topology->cores + topology->cores_count;
+	topology->caches = topology->packages + topology->packages_count;
+	topology->numa_nodes = topology->caches + topology->caches_count;
+
+	/* Relations keep the order in which Windows reports their entries */
+	uint32_t cores_count = 0, packages_count = 0, caches_count = 0, numa_nodes_count = 0;
+	for (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = topology->buffer; info < info_end; info = next_info(info)) {
+		switch (info->Relationship) {
+			case RelationProcessorCore:
+				topology->cores[cores_count++] = info;
+				break;
+			case RelationProcessorPackage:
+				topology->packages[packages_count++] = info;
+				break;
+			case RelationCache:
+				topology->caches[caches_count++] = info;
+				break;
+			case RelationNumaNode:
+			case CPUINFO_WINDOWS_RELATION_NUMA_NODE_EX:
+				topology->numa_nodes[numa_nodes_count++] = info;
+				break;
+			default:
+				break;
+		}
+	}
+	cpuinfo_log_debug("detected %"PRIu32" cores, %"PRIu32" packages, %"PRIu32" caches, %"PRIu32" NUMA nodes",
+		topology->cores_count, topology->packages_count, topology->caches_count, topology->numa_nodes_count);
+	return true;
+
+error:
+	cpuinfo_windows_release_topology(topology);
+	return false;
+}
+
+void cpuinfo_windows_release_topology(struct cpuinfo_windows_topology topology[restrict static 1]) {
+	HANDLE heap = GetProcessHeap();
+	if (topology->entries != NULL) {
+		HeapFree(heap, 0, topology->entries);
+	}
+	if (topology->buffer != NULL) {
+		HeapFree(heap, 0, topology->buffer);
+	}
+	ZeroMemory(topology, sizeof(struct cpuinfo_windows_topology));
+}
@@ -5,6 +5,7 @@
 
 #include <cpuinfo.h>
 #include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
 
 
 struct cpuid_regs {
@@ -46,41 +47,117 @@ struct cpuinfo_x86_model_info {
 	uint32_t processor_type;
 };
 
+/* Core types reported in bits 24-31 of EAX in CPUID leaf 0x1A on hybrid processors */
+#define CPUINFO_X86_CORE_TYPE_ATOM UINT32_C(0x20)
+#define CPUINFO_X86_CORE_TYPE_CORE UINT32_C(0x40)
+
+#define CPUINFO_X86_CPUID_SIGNATURE_CACHE_LEVELS 8
+#define CPUINFO_X86_CPUID_SIGNATURE_TOPOLOGY_LEVELS 6
+
+/*
+ * Raw CPUID values which determine decoded microarchitecture, caches, topology, and ISA, without the fields which
+ * identify the logical processor (APIC IDs). Logical processors with equal signatures decode to the same information.
+ */
+struct cpuinfo_x86_cpuid_signature {
+	struct cpuid_regs leaf1;
+	struct cpuid_regs leaf7[2];
+	struct cpuid_regs leaf0x1A;
+	/* Subleafs of deterministic cache parameters leaf 4 */
+	struct cpuid_regs leaf4[CPUINFO_X86_CPUID_SIGNATURE_CACHE_LEVELS];
+	/* Subleafs of V2 extended topology leaf 0x1F if supported, or extended topology leaf 0xB otherwise */
+	struct cpuid_regs topology[CPUINFO_X86_CPUID_SIGNATURE_TOPOLOGY_LEVELS];
+	struct cpuid_regs leaf0x80000001;
+	/*
+	 * Subleafs of AMD cache properties leaf 0x8000001D if topology extensions are supported: core complexes with and
+	 * without 3D V-Cache differ only in the size of L3 cache
+	 */
+	struct cpuid_regs leaf0x8000001D[CPUINFO_X86_CPUID_SIGNATURE_CACHE_LEVELS];
+};
+
+/* CPUID leaf and its values, in the layout of struct cpuinfo_mock_cpuid */
+struct cpuinfo_x86_cpuid_leaf {
+	uint32_t input_eax;
+	uint32_t input_ecx;
+	uint32_t eax;
+	uint32_t ebx;
+	uint32_t ecx;
+	uint32_t edx;
+};
+
+#define CPUINFO_X86_CPUID_TABLE_CAPACITY 128
+
+/*
+ * Leaves which CPUID returned on the initializing processor. CPUID exits to the hypervisor, or raises #VE in
+ * confidential VMs, at a cost of microseconds, and detection queries many leaves repeatedly. While the table is
+ * recording, cpuid and cpuidex return repeated leaves from the table, and append other leaves to it.
+ */
+struct cpuinfo_x86_cpuid_table {
+	bool recording;
+	uint32_t count;
+	struct cpuinfo_x86_cpuid_leaf leaves[CPUINFO_X86_CPUID_TABLE_CAPACITY];
+};
+
 struct cpuinfo_x86_topology {
 	uint32_t apic_id;
 	uint32_t thread_bits_offset;
 	uint32_t thread_bits_length;
+	/* Core ID bits identify the core within the package, and include module, tile, and die ID bits */
 	uint32_t core_bits_offset;
 	uint32_t core_bits_length;
+	/* Module (e.g. Intel E-cores sharing L2, AMD CCX), tile, and die (e.g. AMD CCD) ID bits, if reported */
+	uint32_t module_bits_offset;
+	uint32_t module_bits_length;
+	uint32_t tile_bits_offset;
+	uint32_t tile_bits_length;
+	uint32_t die_bits_offset;
+	uint32_t die_bits_length;
+};
+
+/* TLBs by page size: DTLB0 is the first-level data TLB on processors which also have a second-level DTLB */
+struct cpuinfo_x86_tlbs {
+	struct cpuinfo_tlb itlb_4KB;
+	struct cpuinfo_tlb itlb_2MB;
+	struct cpuinfo_tlb itlb_4MB;
+	struct cpuinfo_tlb dtlb0_4KB;
+	struct cpuinfo_tlb dtlb0_2MB;
+	struct cpuinfo_tlb dtlb0_4MB;
+	struct cpuinfo_tlb dtlb_4KB;
+	struct cpuinfo_tlb dtlb_2MB;
+	struct cpuinfo_tlb dtlb_4MB;
+	struct cpuinfo_tlb dtlb_1GB;
+	struct cpuinfo_tlb stlb2_4KB;
+	struct cpuinfo_tlb stlb2_2MB;
+	struct cpuinfo_tlb stlb2_1GB;
 };
 
 struct cpuinfo_x86_processor {
 	uint32_t cpuid;
 	enum cpuinfo_vendor vendor;
 	enum cpuinfo_uarch uarch;
+	struct cpuinfo_x86_model_info model_info;
+	/* Core type of the initializing processor on hybrid processors, 0 otherwise */
+	uint32_t core_type;
 #ifdef __linux__
 	int linux_id;
 #endif
 	struct cpuinfo_x86_caches cache;
-	struct {
-		struct cpuinfo_tlb itlb_4KB;
-		struct cpuinfo_tlb itlb_2MB;
-		struct cpuinfo_tlb itlb_4MB;
-		struct cpuinfo_tlb dtlb0_4KB;
-		struct cpuinfo_tlb dtlb0_2MB;
-		struct cpuinfo_tlb dtlb0_4MB;
-		struct cpuinfo_tlb dtlb_4KB;
-		struct cpuinfo_tlb dtlb_2MB;
-		struct cpuinfo_tlb dtlb_4MB;
-		struct cpuinfo_tlb dtlb_1GB;
-		struct cpuinfo_tlb stlb2_4KB;
-		struct cpuinfo_tlb stlb2_2MB;
-		struct cpuinfo_tlb stlb2_1GB;
-	} tlb;
+	struct cpuinfo_x86_tlbs tlb;
 	struct cpuinfo_x86_topology topology;
+	/* Base (non-Turbo) and maximum frequencies from CPUID leaf 0x16, in Hz, or 0 if not reported */
+	uint64_t base_frequency;
+	uint64_t max_frequency;
 	char brand_string[CPUINFO_PACKAGE_NAME_MAX];
 };
 
+extern CPUINFO_INTERNAL struct cpuinfo_x86_cpuid_table cpuinfo_x86_cpuid_table;
+
+/* Discard recorded leaves, e.g. before re-initialization, which must observe microcode and hypervisor updates */
+CPUINFO_INTERNAL void cpuinfo_x86_reset_cpuid_table(void);
+/* Start or stop recording of CPUID leaves; returns the previous state, to restore it after a suspension */
+CPUINFO_INTERNAL bool cpuinfo_x86_record_cpuid(bool recording);
+/* Return the recorded values of a leaf, or execute CPUID and record them; used by cpuid and cpuidex */
+CPUINFO_INTERNAL struct cpuid_regs cpuinfo_x86_cached_cpuid(uint32_t eax, uint32_t ecx);
+
 CPUINFO_INTERNAL void cpuinfo_x86_init_processor(struct cpuinfo_x86_processor* processor);
 
 CPUINFO_INTERNAL enum cpuinfo_vendor cpuinfo_x86_decode_vendor(uint32_t ebx, uint32_t ecx, uint32_t edx);
@@ -88,6 +165,37 @@ CPUINFO_INTERNAL struct cpuinfo_x86_model_info cpuinfo_x86_decode_model_info(uin
 CPUINFO_INTERNAL enum cpuinfo_uarch cpuinfo_x86_decode_uarch(
 	enum cpuinfo_vendor vendor,
 	const struct cpuinfo_x86_model_info* model_info);
+CPUINFO_INTERNAL enum cpuinfo_uarch cpuinfo_x86_decode_hybrid_uarch(
+	enum cpuinfo_vendor vendor,
+	const struct cpuinfo_x86_model_info* model_info,
+	uint32_t core_type);
+CPUINFO_INTERNAL uint32_t cpuinfo_x86_detect_core_type(uint32_t max_base_index);
+CPUINFO_INTERNAL struct cpuinfo_uarch_streaming_hints cpuinfo_x86_decode_streaming_hints(enum cpuinfo_uarch uarch);
+CPUINFO_INTERNAL struct cpuinfo_uarch_vector_hints cpuinfo_x86_decode_vector_hints(enum cpuinfo_uarch uarch);
+/* Decode CPUINFO_PITFALL_X86_* flags of the microarchitecture, including gather slowdown by Downfall mitigations */
+CPUINFO_INTERNAL uint32_t cpuinfo_x86_decode_pitfalls(enum cpuinfo_uarch uarch);
+/* Decode the latency class of the PAUSE instruction on the microarchitecture */
+CPUINFO_INTERNAL enum cpuinfo_pause_latency cpuinfo_x86_decode_pause_latency(
+	enum cpuinfo_vendor vendor, enum cpuinfo_uarch uarch);
+/*
+ * Detect if TSC is invariant, and its frequency in Hz from the hypervisor, CPUID leaf 0x15 (TSC/crystal clock ratio),
+ * or CPUID leaf 0x16 (base frequency). The frequency is 0 if the processor does not report it, e.g. on AMD processors.
+ */
+CPUINFO_INTERNAL void cpuinfo_x86_detect_tsc(uint64_t tsc_frequency[restrict static 1], bool tsc_invariant[restrict static 1]);
+/*
+ * Detect the hypervisor from the signature in CPUID leaf 0x40000000, and whether the process runs in the Hyper-V root
+ * partition. Returns cpuinfo_hypervisor_none if CPUID does not report a hypervisor.
+ */
+CPUINFO_INTERNAL enum cpuinfo_hypervisor cpuinfo_x86_detect_hypervisor(bool root_partition[restrict static 1]);
+/* Describe the XSAVE state components enabled in XCR0 from CPUID leaf 0xD, or leave the state empty without XSAVE */
+CPUINFO_INTERNAL void cpuinfo_x86_detect_xsave_state(struct cpuinfo_x86_xsave_state xsave_state[restrict static 1]);
+/*
+ * Detect cache allocation, memory bandwidth allocation, and L3 monitoring capabilities from CPUID leaves 0x7, 0xF,
+ * 0x10, and 0x80000020 on AMD.
+ */
+CPUINFO_INTERNAL void cpuinfo_x86_detect_resource_control(
+	struct cpuinfo_resource_control resource_control[restrict static 1]);
+CPUINFO_INTERNAL void cpuinfo_x86_read_cpuid_signature(struct cpuinfo_x86_cpuid_signature signature[restrict static 1]);
 
 CPUINFO_INTERNAL struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	const struct cpuid_regs basic_info, const struct cpuid_regs extended_info,
@@ -149,10 +257,37 @@ CPUINFO_INTERNAL bool cpuinfo_x86_decode_cache_properties(
 	struct cpuid_regs regs,
 	struct cpuinfo_x86_caches* cache);
 
+/* Detect TLBs reported by deterministic address translation parameters leaf 0x18 or by AMD leafs */
+CPUINFO_INTERNAL void cpuinfo_x86_detect_tlb(
+	uint32_t max_base_index, uint32_t max_extended_index,
+	enum cpuinfo_vendor vendor,
+	struct cpuinfo_x86_tlbs* tlb);
+
+CPUINFO_INTERNAL bool cpuinfo_x86_decode_deterministic_tlb_parameters(
+	struct cpuid_regs regs,
+	struct cpuinfo_x86_tlbs* tlb);
+
+CPUINFO_INTERNAL void cpuinfo_x86_decode_amd_tlb_info(
+	struct cpuid_regs leaf0x80000005,
+	struct cpuid_regs leaf0x80000006,
+	struct cpuinfo_x86_tlbs* tlb);
+
+CPUINFO_INTERNAL void cpuinfo_x86_decode_amd_1gb_tlb_info(
+	struct cpuid_regs leaf0x80000019,
+	struct cpuinfo_x86_tlbs* tlb);
+
+/* Group the TLBs of the processor by level of the TLB hierarchy */
+CPUINFO_INTERNAL void cpuinfo_x86_group_tlbs(
+	const struct cpuinfo_x86_tlbs* tlb,
+	struct cpuinfo_uarch_tlbs* uarch_tlbs);
+
 CPUINFO_INTERNAL uint32_t cpuinfo_x86_normalize_brand_string(
 	const char raw_name[48],
 	char normalized_name[48]);
 
+/* Returns the frequency at the end of the brand string, e.g. 3.2 GHz in "... CPU @ 3.20GHz", in Hz, or 0 */
+CPUINFO_INTERNAL uint64_t cpuinfo_x86_parse_brand_string_frequency(const char raw_name[48]);
+
 CPUINFO_INTERNAL uint32_t cpuinfo_x86_format_package_name(
 	enum cpuinfo_vendor vendor,
 	const char normalized_brand_string[48],
@@ -101,6 +101,10 @@ bool cpuinfo_x86_decode_deterministic_cache_parameters(
 			}
 			break;
 		case 3:
+			/* Non-inclusive L3 caches of Intel server processors since Skylake-SP are filled with L2 victims */
+			if (!(flags & CPUINFO_CACHE_INCLUSIVE)) {
+				flags |= CPUINFO_CACHE_EXCLUSIVE;
+			}
 			switch (type) {
 				case cache_type_instruction:
 					cpuinfo_log_warning("unexpected L3 instruction cache reported in leaf 0x00000004 is ignored");
@@ -230,6 +234,10 @@ bool cpuinfo_x86_decode_cache_properties(
 			}
 			break;
 		case 3:
+			/* L3 caches of AMD Zen processors are victim caches, which are filled with lines evicted from L2 */
+			if (!(flags & CPUINFO_CACHE_INCLUSIVE)) {
+				flags |= CPUINFO_CACHE_EXCLUSIVE;
+			}
 			switch (type) {
 				case cache_type_instruction:
 					cpuinfo_log_warning("unexpected L3 instruction cache reported in leaf 0x8000001D is ignored");
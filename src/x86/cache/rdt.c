@@ -0,0 +1,84 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <x86/cpuid.h>
+
+
+/* Decode capabilities of L3 (subleaf 1) or L2 (subleaf 2) cache allocation in CPUID leaf 0x10 */
+static struct cpuinfo_cache_allocation decode_cache_allocation(struct cpuid_regs regs) {
+	return (struct cpuinfo_cache_allocation) {
+		/* edx[bits 0-15]: highest class of service number */
+		.classes_count = (regs.edx & UINT32_C(0x0000FFFF)) + 1,
+		/* eax[bits 0-4]: length of capacity bitmask minus one */
+		.capacity_mask_length = (regs.eax & UINT32_C(0x0000001F)) + 1,
+		/* ebx: bitmask of capacity units shared with other entities */
+		.shared_mask = regs.ebx,
+		/* ecx[bit 2]: code and data prioritization */
+		.code_data_prioritization = !!(regs.ecx & UINT32_C(0x00000004)),
+		/* ecx[bit 3]: non-contiguous capacity bitmasks */
+		.noncontiguous_masks = !!(regs.ecx & UINT32_C(0x00000008)),
+	};
+}
+
+void cpuinfo_x86_detect_resource_control(struct cpuinfo_resource_control resource_control[restrict static 1]) {
+	const struct cpuid_regs leaf0 = cpuid(0);
+	const uint32_t max_base_index = leaf0.eax;
+	const enum cpuinfo_vendor vendor = cpuinfo_x86_decode_vendor(leaf0.ebx, leaf0.ecx, leaf0.edx);
+	if (max_base_index < 7) {
+		return;
+	}
+
+	const struct cpuid_regs leaf7 = cpuidex(7, 0);
+	/* Resource monitoring: ebx[bit 12] in structured extended feature flags */
+	if ((leaf7.ebx & UINT32_C(0x00001000)) && max_base_index >= UINT32_C(0xF)) {
+		/* L3 monitoring: edx[bit 1] in subleaf 0 */
+		if (cpuidex(UINT32_C(0xF), 0).edx & UINT32_C(0x00000002)) {
+			const struct cpuid_regs l3_monitoring = cpuidex(UINT32_C(0xF), 1);
+			/* ecx: highest resource monitoring ID */
+			resource_control->monitoring_ids_count = l3_monitoring.ecx + 1;
+			/* ebx: conversion factor from counter values to bytes */
+			resource_control->monitoring_scale = l3_monitoring.ebx;
+			/* edx[bits 0-2]: occupancy, total memory bandwidth, and local memory bandwidth monitoring */
+			resource_control->l3_occupancy_monitoring = !!(l3_monitoring.edx & UINT32_C(0x00000001));
+			resource_control->total_memory_bandwidth_monitoring = !!(l3_monitoring.edx & UINT32_C(0x00000002));
+			resource_control->local_memory_bandwidth_monitoring = !!(l3_monitoring.edx & UINT32_C(0x00000004));
+		}
+	}
+
+	/* Resource allocation: ebx[bit 15] in structured extended feature flags */
+	if ((leaf7.ebx & UINT32_C(0x00008000)) && max_base_index >= UINT32_C(0x10)) {
+		/* ebx[bits 1-3] in subleaf 0: L3 cache allocation, L2 cache allocation, and memory bandwidth allocation */
+		const uint32_t resources = cpuidex(UINT32_C(0x10), 0).ebx;
+		if (resources & UINT32_C(0x00000002)) {
+			resource_control->l3_allocation = decode_cache_allocation(cpuidex(UINT32_C(0x10), 1));
+		}
+		if (resources & UINT32_C(0x00000004)) {
+			resource_control->l2_allocation = decode_cache_allocation(cpuidex(UINT32_C(0x10), 2));
+		}
+		if (resources & UINT32_C(0x00000008)) {
+			const struct cpuid_regs memory_bandwidth_allocation = cpuidex(UINT32_C(0x10), 3);
+			/* edx[bits 0-15]: highest class of service number */
+			resource_control->memory_bandwidth_classes_count =
+				(memory_bandwidth_allocation.edx & UINT32_C(0x0000FFFF)) + 1;
+			/* eax[bits 0-11]: maximum throttling value minus one */
+			resource_control->memory_bandwidth_max_throttling =
+				(memory_bandwidth_allocation.eax & UINT32_C(0x00000FFF)) + 1;
+			/* ecx[bit 2]: linear response of throttling values */
+			resource_control->memory_bandwidth_linear = !!(memory_bandwidth_allocation.ecx & UINT32_C(0x00000004));
+		}
+	}
+
+	/* AMD reports memory bandwidth enforcement in extended leaf 0x80000020 instead of leaf 0x10 */
+	if (vendor == cpuinfo_vendor_amd || vendor == cpuinfo_vendor_hygon) {
+		const uint32_t max_extended_index = cpuid(UINT32_C(0x80000000)).eax;
+		/* L3 memory bandwidth enforcement: ebx[bit 1] in subleaf 0 */
+		if (max_extended_index >= UINT32_C(0x80000020) &&
+			(cpuidex(UINT32_C(0x80000020), 0).ebx & UINT32_C(0x00000002)))
+		{
+			/* edx: highest class of service number; limits are in 1/8 GB/s units, and throttling is linear */
+			resource_control->memory_bandwidth_classes_count = cpuidex(UINT32_C(0x80000020), 1).edx + 1;
+			resource_control->memory_bandwidth_linear = true;
+		}
+	}
+}
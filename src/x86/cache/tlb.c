@@ -0,0 +1,275 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+#include <x86/cpuid.h>
+#include <x86/api.h>
+
+
+enum tlb_type {
+	tlb_type_none = 0,
+	tlb_type_data = 1,
+	tlb_type_instruction = 2,
+	tlb_type_unified = 3,
+	tlb_type_load = 4,
+	tlb_type_store = 5,
+};
+
+void cpuinfo_x86_detect_tlb(
+	uint32_t max_base_index, uint32_t max_extended_index,
+	enum cpuinfo_vendor vendor,
+	struct cpuinfo_x86_tlbs* tlb)
+{
+	if (vendor == cpuinfo_vendor_amd || vendor == cpuinfo_vendor_hygon) {
+		if (max_extended_index >= UINT32_C(0x80000006)) {
+			cpuinfo_x86_decode_amd_tlb_info(cpuid(UINT32_C(0x80000005)), cpuid(UINT32_C(0x80000006)), tlb);
+		}
+		if (max_extended_index >= UINT32_C(0x80000019)) {
+			cpuinfo_x86_decode_amd_1gb_tlb_info(cpuid(UINT32_C(0x80000019)), tlb);
+		}
+	} else if (max_base_index >= UINT32_C(0x18)) {
+		/* Leaf 0x18 describes all TLBs, and supersedes TLB descriptors of leaf 2 */
+		struct cpuinfo_x86_tlbs deterministic_tlb;
+		memset(&deterministic_tlb, 0, sizeof(deterministic_tlb));
+		const struct cpuid_regs leaf0x18 = cpuidex(UINT32_C(0x18), 0);
+		bool valid = cpuinfo_x86_decode_deterministic_tlb_parameters(leaf0x18, &deterministic_tlb);
+		const uint32_t max_subleaf = leaf0x18.eax;
+		for (uint32_t subleaf = 1; subleaf <= max_subleaf; subleaf++) {
+			valid |= cpuinfo_x86_decode_deterministic_tlb_parameters(
+				cpuidex(UINT32_C(0x18), subleaf), &deterministic_tlb);
+		}
+		if (valid) {
+			*tlb = deterministic_tlb;
+		}
+	}
+}
+
+bool cpuinfo_x86_decode_deterministic_tlb_parameters(
+	struct cpuid_regs regs,
+	struct cpuinfo_x86_tlbs* tlb)
+{
+	/* Subleafs without a TLB have type 0, but are followed by valid subleafs */
+	const uint32_t type = regs.edx & UINT32_C(0x1F);
+	if (type == tlb_type_none) {
+		return false;
+	}
+
+	const uint32_t level = (regs.edx >> 5) & UINT32_C(0x7);
+	const bool fully_associative = !!(regs.edx & UINT32_C(0x00000100));
+	const uint32_t ways = regs.ebx >> 16;
+	const uint32_t sets = regs.ecx;
+	const uint32_t entries = ways * sets;
+
+	uint64_t pages = 0;
+	if (regs.ebx & UINT32_C(0x00000001)) {
+		pages |= CPUINFO_PAGE_SIZE_4KB;
+	}
+	if (regs.ebx & UINT32_C(0x00000002)) {
+		pages |= CPUINFO_PAGE_SIZE_2MB;
+	}
+	if (regs.ebx & UINT32_C(0x00000004)) {
+		pages |= CPUINFO_PAGE_SIZE_4MB;
+	}
+	if (regs.ebx & UINT32_C(0x00000008)) {
+		pages |= CPUINFO_PAGE_SIZE_1GB;
+	}
+	const struct cpuinfo_tlb description = {
+		.entries = entries,
+		.associativity = fully_associative ? entries : ways,
+		.pages = pages,
+	};
+
+	switch (level) {
+		case 1:
+			switch (type) {
+				case tlb_type_instruction:
+					if (pages & CPUINFO_PAGE_SIZE_4KB) {
+						tlb->itlb_4KB = description;
+					}
+					if (pages & CPUINFO_PAGE_SIZE_2MB) {
+						tlb->itlb_2MB = description;
+					}
+					if (pages & CPUINFO_PAGE_SIZE_4MB) {
+						tlb->itlb_4MB = description;
+					}
+					break;
+				case tlb_type_data:
+				case tlb_type_unified:
+				case tlb_type_load:
+					/* Processors with split load and store TLBs report the load TLB, which serves more accesses */
+					if (pages & CPUINFO_PAGE_SIZE_4KB) {
+						tlb->dtlb_4KB = description;
+					}
+					if (pages & CPUINFO_PAGE_SIZE_2MB) {
+						tlb->dtlb_2MB = description;
+					}
+					if (pages & CPUINFO_PAGE_SIZE_4MB) {
+						tlb->dtlb_4MB = description;
+					}
+					if (pages & CPUINFO_PAGE_SIZE_1GB) {
+						tlb->dtlb_1GB = description;
+					}
+					break;
+				case tlb_type_store:
+					break;
+				default:
+					cpuinfo_log_warning("unexpected TLB type %"PRIu32" in deterministic address translation parameters",
+						type);
+					break;
+			}
+			break;
+		case 2:
+			if (type == tlb_type_unified || type == tlb_type_data) {
+				if (pages & CPUINFO_PAGE_SIZE_4KB) {
+					tlb->stlb2_4KB = description;
+				}
+				if (pages & CPUINFO_PAGE_SIZE_2MB) {
+					tlb->stlb2_2MB = description;
+				}
+				if (pages & CPUINFO_PAGE_SIZE_1GB) {
+					tlb->stlb2_1GB = description;
+				}
+			}
+			break;
+		default:
+			cpuinfo_log_warning("unexpected TLB level %"PRIu32" in deterministic address translation parameters",
+				level);
+			break;
+	}
+	return true;
+}
+
+/* Decode associativity of L1 TLBs in AMD leaf 0x80000005: number of ways, or 0xFF for fully-associative TLBs */
+static struct cpuinfo_tlb decode_amd_l1_tlb(uint32_t associativity, uint32_t entries, uint64_t pages) {
+	if (entries == 0) {
+		return (struct cpuinfo_tlb) { 0 };
+	}
+	return (struct cpuinfo_tlb) {
+		.entries = entries,
+		.associativity = associativity == UINT32_C(0xFF) ? entries : associativity,
+		.pages = pages,
+	};
+}
+
+/* Decode associativity of L2 TLBs in AMD leafs 0x80000006 and 0x80000019, encoded as in the L2 cache description */
+static struct cpuinfo_tlb decode_amd_l2_tlb(uint32_t associativity, uint32_t entries, uint64_t pages) {
+	static const uint8_t ways[16] = {
+		[0x1] = 1,
+		[0x2] = 2,
+		[0x3] = 3,
+		[0x4] = 4,
+		[0x5] = 6,
+		[0x6] = 8,
+		[0x8] = 16,
+		[0xA] = 32,
+		[0xB] = 48,
+		[0xC] = 64,
+		[0xD] = 96,
+		[0xE] = 128,
+	};
+	if (entries == 0 || associativity == 0) {
+		/* TLB is disabled or not present */
+		return (struct cpuinfo_tlb) { 0 };
+	}
+	return (struct cpuinfo_tlb) {
+		.entries = entries,
+		.associativity = associativity == UINT32_C(0xF) ? entries : ways[associativity],
+		.pages = pages,
+	};
+}
+
+void cpuinfo_x86_decode_amd_tlb_info(
+	struct cpuid_regs leaf0x80000005,
+	struct cpuid_regs leaf0x80000006,
+	struct cpuinfo_x86_tlbs* tlb)
+{
+	/*
+	 * AMD64 Architecture Programmer's Manual, Volume 3: CPUID Fn8000_0005 and Fn8000_0006.
+	 * TLBs for 2 MB pages also cache 4 MB pages, with two entries for every 4 MB page.
+	 */
+	const uint32_t l1_dtlb_2MB_entries = (leaf0x80000005.eax >> 16) & UINT32_C(0xFF);
+	const uint32_t l1_itlb_2MB_entries = leaf0x80000005.eax & UINT32_C(0xFF);
+	tlb->dtlb_4KB = decode_amd_l1_tlb(leaf0x80000005.ebx >> 24, (leaf0x80000005.ebx >> 16) & UINT32_C(0xFF),
+		CPUINFO_PAGE_SIZE_4KB);
+	tlb->dtlb_2MB = decode_amd_l1_tlb(leaf0x80000005.eax >> 24, l1_dtlb_2MB_entries, CPUINFO_PAGE_SIZE_2MB);
+	tlb->dtlb_4MB = decode_amd_l1_tlb(leaf0x80000005.eax >> 24, l1_dtlb_2MB_entries / 2, CPUINFO_PAGE_SIZE_4MB);
+	tlb->itlb_4KB = decode_amd_l1_tlb((leaf0x80000005.ebx >> 8) & UINT32_C(0xFF), leaf0x80000005.ebx & UINT32_C(0xFF),
+		CPUINFO_PAGE_SIZE_4KB);
+	tlb->itlb_2MB = decode_amd_l1_tlb((leaf0x80000005.eax >> 8) & UINT32_C(0xFF), l1_itlb_2MB_entries,
+		CPUINFO_PAGE_SIZE_2MB);
+	tlb->itlb_4MB = decode_amd_l1_tlb((leaf0x80000005.eax >> 8) & UINT32_C(0xFF), l1_itlb_2MB_entries / 2,
+		CPUINFO_PAGE_SIZE_4MB);
+
+	/* L2 TLBs are split into data and instruction TLBs: L2 data TLB serves as the second-level TLB */
+	tlb->stlb2_4KB = decode_amd_l2_tlb(leaf0x80000006.ebx >> 28, (leaf0x80000006.ebx >> 16) & UINT32_C(0x0FFF),
+		CPUINFO_PAGE_SIZE_4KB);
+	tlb->stlb2_2MB = decode_amd_l2_tlb(leaf0x80000006.eax >> 28, (leaf0x80000006.eax >> 16) & UINT32_C(0x0FFF),
+		CPUINFO_PAGE_SIZE_2MB);
+}
+
+void cpuinfo_x86_decode_amd_1gb_tlb_info(
+	struct cpuid_regs leaf0x80000019,
+	struct cpuinfo_x86_tlbs* tlb)
+{
+	/* AMD64 Architecture Programmer's Manual, Volume 3: CPUID Fn8000_0019, with associativity as in Fn8000_0006 */
+	const struct cpuinfo_tlb l1_dtlb_1GB = decode_amd_l2_tlb(leaf0x80000019.eax >> 28,
+		(leaf0x80000019.eax >> 16) & UINT32_C(0x0FFF), CPUINFO_PAGE_SIZE_1GB);
+	if (l1_dtlb_1GB.entries != 0) {
+		tlb->dtlb_1GB = l1_dtlb_1GB;
+	}
+	const struct cpuinfo_tlb l2_dtlb_1GB = decode_amd_l2_tlb(leaf0x80000019.ebx >> 28,
+		(leaf0x80000019.ebx >> 16) & UINT32_C(0x0FFF), CPUINFO_PAGE_SIZE_1GB);
+	if (l2_dtlb_1GB.entries != 0) {
+		tlb->stlb2_1GB = l2_dtlb_1GB;
+	}
+}
+
+/* Add the TLB to the list of TLBs at one level, unless it is empty or already listed for other page sizes */
+static void add_tlb(struct cpuinfo_tlb tlbs[restrict static CPUINFO_MAX_TLBS_PER_LEVEL],
+	const struct cpuinfo_tlb tlb[restrict static 1])
+{
+	if (tlb->entries == 0) {
+		return;
+	}
+	for (uint32_t i = 0; i < CPUINFO_MAX_TLBS_PER_LEVEL; i++) {
+		if (tlbs[i].entries == 0) {
+			tlbs[i] = *tlb;
+			return;
+		}
+		if (memcmp(&tlbs[i], tlb, sizeof(struct cpuinfo_tlb)) == 0) {
+			return;
+		}
+	}
+}
+
+void cpuinfo_x86_group_tlbs(
+	const struct cpuinfo_x86_tlbs* tlb,
+	struct cpuinfo_uarch_tlbs* uarch_tlbs)
+{
+	memset(uarch_tlbs, 0, sizeof(struct cpuinfo_uarch_tlbs));
+	add_tlb(uarch_tlbs->l1i, &tlb->itlb_4KB);
+	add_tlb(uarch_tlbs->l1i, &tlb->itlb_2MB);
+	add_tlb(uarch_tlbs->l1i, &tlb->itlb_4MB);
+
+	/* Processors with DTLB0 have it as the first-level data TLB, backed by DTLB */
+	const bool has_dtlb0 = (tlb->dtlb0_4KB.entries | tlb->dtlb0_2MB.entries | tlb->dtlb0_4MB.entries) != 0;
+	struct cpuinfo_tlb* dtlb_level = uarch_tlbs->l1d;
+	if (has_dtlb0) {
+		add_tlb(uarch_tlbs->l1d, &tlb->dtlb0_4KB);
+		add_tlb(uarch_tlbs->l1d, &tlb->dtlb0_2MB);
+		add_tlb(uarch_tlbs->l1d, &tlb->dtlb0_4MB);
+		dtlb_level = uarch_tlbs->l2;
+	}
+	add_tlb(dtlb_level, &tlb->dtlb_4KB);
+	add_tlb(dtlb_level, &tlb->dtlb_2MB);
+	add_tlb(dtlb_level, &tlb->dtlb_4MB);
+	add_tlb(dtlb_level, &tlb->dtlb_1GB);
+
+	add_tlb(uarch_tlbs->l2, &tlb->stlb2_4KB);
+	add_tlb(uarch_tlbs->l2, &tlb->stlb2_2MB);
+	add_tlb(uarch_tlbs->l2, &tlb->stlb2_1GB);
+}
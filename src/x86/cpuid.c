@@ -0,0 +1,51 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cpuinfo.h>
+#include <x86/cpuid.h>
+#include <x86/api.h>
+#include <cpuinfo/internal-api.h>
+
+
+struct cpuinfo_x86_cpuid_table cpuinfo_x86_cpuid_table = { 0 };
+
+void cpuinfo_x86_reset_cpuid_table(void) {
+	cpuinfo_x86_cpuid_table.count = 0;
+}
+
+bool cpuinfo_x86_record_cpuid(bool recording) {
+	const bool previous = cpuinfo_x86_cpuid_table.recording;
+	cpuinfo_x86_cpuid_table.recording = recording;
+	return previous;
+}
+
+struct cpuid_regs cpuinfo_x86_cached_cpuid(uint32_t eax, uint32_t ecx) {
+	struct cpuinfo_x86_cpuid_table* table = &cpuinfo_x86_cpuid_table;
+	for (uint32_t i = 0; i < table->count; i++) {
+		const struct cpuinfo_x86_cpuid_leaf* leaf = &table->leaves[i];
+		if (leaf->input_eax == eax && leaf->input_ecx == ecx) {
+			cpuinfo_init_stats.cpuid_cached += 1;
+			return (struct cpuid_regs) {
+				.eax = leaf->eax,
+				.ebx = leaf->ebx,
+				.ecx = leaf->ecx,
+				.edx = leaf->edx,
+			};
+		}
+	}
+
+	const struct cpuid_regs regs = cpuinfo_x86_execute_cpuid(eax, ecx);
+	cpuinfo_init_stats.cpuid_executed += 1;
+	/* Descriptors of leaf 2 may take several executions of the leaf, each returning the next descriptors */
+	if (eax != 2 && table->count < CPUINFO_X86_CPUID_TABLE_CAPACITY) {
+		table->leaves[table->count++] = (struct cpuinfo_x86_cpuid_leaf) {
+			.input_eax = eax,
+			.input_ecx = ecx,
+			.eax = regs.eax,
+			.ebx = regs.ebx,
+			.ecx = regs.ecx,
+			.edx = regs.edx,
+		};
+	}
+	return regs;
+}
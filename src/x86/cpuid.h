@@ -14,6 +14,22 @@
 
 
 #if defined(__GNUC__) || defined(_MSC_VER)
+	/* Execute CPUID on the current processor, bypassing the table of recorded leaves */
+	static inline struct cpuid_regs cpuinfo_x86_execute_cpuid(uint32_t eax, uint32_t ecx) {
+		struct cpuid_regs regs;
+		#if defined(__GNUC__)
+			__cpuid_count(eax, ecx, regs.eax, regs.ebx, regs.ecx, regs.edx);
+		#else
+			int regs_array[4];
+			__cpuidex(regs_array, (int) eax, (int) ecx);
+			regs.eax = regs_array[0];
+			regs.ebx = regs_array[1];
+			regs.ecx = regs_array[2];
+			regs.edx = regs_array[3];
+		#endif
+		return regs;
+	}
+
 	static inline struct cpuid_regs cpuid(uint32_t eax) {
 		#if CPUINFO_MOCK
 			uint32_t regs_array[4];
@@ -25,6 +41,12 @@
 				.edx = regs_array[3],
 			};
 		#else
+			#if !defined(CPUINFO_X86_CPUID_UNCACHED)
+				/* Leaves are recorded as sub-leaf 0; CPUID ignores ECX for leaves without sub-leaves */
+				if CPUINFO_UNLIKELY(cpuinfo_x86_cpuid_table.recording) {
+					return cpuinfo_x86_cached_cpuid(eax, 0);
+				}
+			#endif
 			struct cpuid_regs regs;
 			#if defined(__GNUC__)
 				__cpuid(eax, regs.eax, regs.ebx, regs.ecx, regs.edx);
@@ -51,18 +73,12 @@
 				.edx = regs_array[3],
 			};
 		#else
-			struct cpuid_regs regs;
-			#if defined(__GNUC__)
-				__cpuid_count(eax, ecx, regs.eax, regs.ebx, regs.ecx, regs.edx);
-			#else
-				int regs_array[4];
-				__cpuidex(regs_array, (int) eax, (int) ecx);
-				regs.eax = regs_array[0];
-				regs.ebx = regs_array[1];
-				regs.ecx = regs_array[2];
-				regs.edx = regs_array[3];
+			#if !defined(CPUINFO_X86_CPUID_UNCACHED)
+				if CPUINFO_UNLIKELY(cpuinfo_x86_cpuid_table.recording) {
+					return cpuinfo_x86_cached_cpuid(eax, ecx);
+				}
 			#endif
-			return regs;
+			return cpuinfo_x86_execute_cpuid(eax, ecx);
 		#endif
 	}
 #endif
@@ -0,0 +1,371 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/types.h>
+#include <sys/sysctl.h>
+
+#include <cpuinfo.h>
+#include <x86/api.h>
+#include <x86/cpuid.h>
+#include <freebsd/api.h>
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+static inline uint32_t max(uint32_t a, uint32_t b) {
+	return a > b ? a : b;
+}
+
+static inline uint32_t bit_mask(uint32_t bits) {
+	return (UINT32_C(1) << bits) - UINT32_C(1);
+}
+
+static uint64_t get_sysctl_uint64(const char* name) {
+	/* Some of the sysctls are 32-bit on older kernels: they fill the low half of the value on little-endian x86 */
+	uint64_t value = 0;
+	size_t size = sizeof(value);
+	if (sysctlbyname(name, &value, &size, NULL, 0) != 0) {
+		cpuinfo_log_info("sysctlbyname(\"%s\") failed: %s", name, strerror(errno));
+		return 0;
+	}
+	return value;
+}
+
+/*
+ * Number of logical processors in a package per CPUID extended topology leaf 0xB, or 0 if not reported. The kernel
+ * topology doesn't distinguish packages from last-level caches, e.g. on AMD processors with an L3 cache per CCX.
+ */
+static uint32_t get_cpuid_threads_per_package(void) {
+	if (cpuid(0).eax < UINT32_C(0xB)) {
+		return 0;
+	}
+	for (uint32_t level = 0; level < 8; level++) {
+		const struct cpuid_regs regs = cpuidex(UINT32_C(0xB), level);
+		const uint32_t type = (regs.ecx >> 8) & UINT32_C(0x000000FF);
+		if (type == 0) {
+			break;
+		}
+		/* Core level reports the number of logical processors in the package */
+		if (type == 2) {
+			return regs.ebx & UINT32_C(0x0000FFFF);
+		}
+	}
+	return 0;
+}
+
+/* Number of logical processors sharing a cache level per kern.sched.topology_spec, or 0 if unknown or inconsistent */
+static uint32_t get_threads_per_cache(
+	const struct cpuinfo_freebsd_topology topology[restrict static 1],
+	uint32_t level)
+{
+	const uint32_t threads_per_cache = topology->threads_per_cache[level];
+	if (threads_per_cache == 0 || threads_per_cache > topology->threads || topology->threads % threads_per_cache != 0) {
+		return 0;
+	}
+	return threads_per_cache;
+}
+
+void cpuinfo_x86_freebsd_init(void) {
+	struct cpuinfo_freebsd_topology freebsd_topology = cpuinfo_freebsd_detect_topology();
+	const uint32_t cpuid_threads_per_package = get_cpuid_threads_per_package();
+	if (cpuid_threads_per_package != 0 && freebsd_topology.threads % cpuid_threads_per_package == 0 &&
+		freebsd_topology.cores % (freebsd_topology.threads / cpuid_threads_per_package) == 0)
+	{
+		freebsd_topology.packages = freebsd_topology.threads / cpuid_threads_per_package;
+	}
+
+	struct cpuinfo_x86_processor x86_processor;
+	memset(&x86_processor, 0, sizeof(x86_processor));
+	cpuinfo_x86_init_processor(&x86_processor);
+	char brand_string[48];
+	cpuinfo_x86_normalize_brand_string(x86_processor.brand_string, brand_string);
+
+	/* TSC runs at the nominal frequency on processors with invariant TSC; cpufreq lists the highest frequency first */
+	const uint64_t frequency = get_sysctl_uint64("machdep.tsc_freq");
+	uint64_t frequency_levels[CPUINFO_FREEBSD_MAX_FREQUENCY_LEVELS];
+	const uint64_t max_frequency =
+		cpuinfo_freebsd_get_frequency_levels(0, frequency_levels) != 0 ? frequency_levels[0] : 0;
+
+	uint32_t threads_per_l1 = 0, l1_count = 0;
+	if (x86_processor.cache.l1i.size != 0 || x86_processor.cache.l1d.size != 0) {
+		threads_per_l1 = get_threads_per_cache(&freebsd_topology, 1);
+		if (threads_per_l1 == 0) {
+			/* Assume that threads on the same core share L1 */
+			threads_per_l1 = freebsd_topology.threads / freebsd_topology.cores;
+			cpuinfo_log_warning("FreeBSD did not report valid number of threads sharing L1 cache; assume %"PRIu32,
+				threads_per_l1);
+		}
+		l1_count = freebsd_topology.threads / threads_per_l1;
+		cpuinfo_log_debug("detected %"PRIu32" L1 caches", l1_count);
+	}
+
+	uint32_t threads_per_l2 = 0, l2_count = 0;
+	if (x86_processor.cache.l2.size != 0) {
+		threads_per_l2 = get_threads_per_cache(&freebsd_topology, 2);
+		if (threads_per_l2 == 0) {
+			if (x86_processor.cache.l3.size != 0) {
+				/* This is not a last-level cache; assume that threads on the same core share L2 */
+				threads_per_l2 = freebsd_topology.threads / freebsd_topology.cores;
+			} else {
+				/* This is a last-level cache; assume that threads on the same package share L2 */
+				threads_per_l2 = freebsd_topology.threads / freebsd_topology.packages;
+			}
+			cpuinfo_log_warning("FreeBSD did not report valid number of threads sharing L2 cache; assume %"PRIu32,
+				threads_per_l2);
+		}
+		l2_count = freebsd_topology.threads / threads_per_l2;
+		cpuinfo_log_debug("detected %"PRIu32" L2 caches", l2_count);
+	}
+
+	uint32_t threads_per_l3 = 0, l3_count = 0;
+	if (x86_processor.cache.l3.size != 0) {
+		threads_per_l3 = get_threads_per_cache(&freebsd_topology, 3);
+		if (threads_per_l3 == 0) {
+			/*
+			 * Assume that threads on the same package share L3.
+			 * However, is it not necessarily the last-level cache (there may be L4 cache as well)
+			 */
+			threads_per_l3 = freebsd_topology.threads / freebsd_topology.packages;
+			cpuinfo_log_warning("FreeBSD did not report valid number of threads sharing L3 cache; assume %"PRIu32,
+				threads_per_l3);
+		}
+		l3_count = freebsd_topology.threads / threads_per_l3;
+		cpuinfo_log_debug("detected %"PRIu32" L3 caches", l3_count);
+	}
+
+	uint32_t threads_per_l4 = 0, l4_count = 0;
+	if (x86_processor.cache.l4.size != 0) {
+		threads_per_l4 = get_threads_per_cache(&freebsd_topology, 4);
+		if (threads_per_l4 == 0) {
+			/*
+			 * Assume that all threads share this L4.
+			 * As of now, L4 cache exists only on notebook x86 CPUs, which are single-package,
+			 * but multi-socket systems could have shared L4 (like on IBM POWER8).
+			 */
+			threads_per_l4 = freebsd_topology.threads;
+			cpuinfo_log_warning("FreeBSD did not report valid number of threads sharing L4 cache; assume %"PRIu32,
+				threads_per_l4);
+		}
+		l4_count = freebsd_topology.threads / threads_per_l4;
+		cpuinfo_log_debug("detected %"PRIu32" L4 caches", l4_count);
+	}
+
+	struct cpuinfo_arena arena = { NULL, 0 };
+	const size_t processors_offset =
+		cpuinfo_arena_reserve(&arena, freebsd_topology.threads, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, freebsd_topology.cores, sizeof(struct cpuinfo_core));
+	/* On x86 cluster of cores is a physical package */
+	const size_t clusters_offset =
+		cpuinfo_arena_reserve(&arena, freebsd_topology.packages, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset =
+		cpuinfo_arena_reserve(&arena, freebsd_topology.packages, sizeof(struct cpuinfo_package));
+	const uint32_t l1i_count = x86_processor.cache.l1i.size != 0 ? l1_count : 0;
+	const uint32_t l1d_count = x86_processor.cache.l1d.size != 0 ? l1_count : 0;
+	const size_t l1i_offset = cpuinfo_arena_reserve(&arena, l1i_count, sizeof(struct cpuinfo_cache));
+	const size_t l1d_offset = cpuinfo_arena_reserve(&arena, l1d_count, sizeof(struct cpuinfo_cache));
+	const size_t l2_offset = cpuinfo_arena_reserve(&arena, l2_count, sizeof(struct cpuinfo_cache));
+	const size_t l3_offset = cpuinfo_arena_reserve(&arena, l3_count, sizeof(struct cpuinfo_cache));
+	const size_t l4_offset = cpuinfo_arena_reserve(&arena, l4_count, sizeof(struct cpuinfo_cache));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return;
+	}
+
+	struct cpuinfo_processor* processors = cpuinfo_arena_get(&arena, processors_offset, freebsd_topology.threads);
+	struct cpuinfo_core* cores = cpuinfo_arena_get(&arena, cores_offset, freebsd_topology.cores);
+	struct cpuinfo_cluster* clusters = cpuinfo_arena_get(&arena, clusters_offset, freebsd_topology.packages);
+	struct cpuinfo_package* packages = cpuinfo_arena_get(&arena, packages_offset, freebsd_topology.packages);
+	struct cpuinfo_cache* l1i = cpuinfo_arena_get(&arena, l1i_offset, l1i_count);
+	struct cpuinfo_cache* l1d = cpuinfo_arena_get(&arena, l1d_offset, l1d_count);
+	struct cpuinfo_cache* l2 = cpuinfo_arena_get(&arena, l2_offset, l2_count);
+	struct cpuinfo_cache* l3 = cpuinfo_arena_get(&arena, l3_offset, l3_count);
+	struct cpuinfo_cache* l4 = cpuinfo_arena_get(&arena, l4_offset, l4_count);
+
+	const uint32_t threads_per_core = freebsd_topology.threads / freebsd_topology.cores;
+	const uint32_t threads_per_package = freebsd_topology.threads / freebsd_topology.packages;
+	const uint32_t cores_per_package = freebsd_topology.cores / freebsd_topology.packages;
+	for (uint32_t i = 0; i < freebsd_topology.packages; i++) {
+		clusters[i] = (struct cpuinfo_cluster) {
+			.processor_start = i * threads_per_package,
+			.processor_count = threads_per_package,
+			.core_start = i * cores_per_package,
+			.core_count = cores_per_package,
+			.cluster_id = 0,
+			.package = packages + i,
+			.vendor = x86_processor.vendor,
+			.uarch = x86_processor.uarch,
+			.cpuid = x86_processor.cpuid,
+			.frequency = frequency,
+		};
+		packages[i].processor_start = i * threads_per_package;
+		packages[i].processor_count = threads_per_package;
+		packages[i].core_start = i * cores_per_package;
+		packages[i].core_count = cores_per_package;
+		packages[i].cluster_start = i;
+		packages[i].cluster_count = 1;
+		cpuinfo_x86_format_package_name(x86_processor.vendor, brand_string, packages[i].name);
+	}
+	for (uint32_t i = 0; i < freebsd_topology.cores; i++) {
+		cores[i] = (struct cpuinfo_core) {
+			.processor_start = i * threads_per_core,
+			.processor_count = threads_per_core,
+			.core_id = i % cores_per_package,
+			.cluster = clusters + i / cores_per_package,
+			.package = packages + i / cores_per_package,
+			.vendor = x86_processor.vendor,
+			.uarch = x86_processor.uarch,
+			.cpuid = x86_processor.cpuid,
+			.frequency = frequency,
+			.max_turbo_frequency = max_frequency > frequency ? max_frequency : 0,
+		};
+	}
+	for (uint32_t i = 0; i < freebsd_topology.threads; i++) {
+		const uint32_t smt_id = i % threads_per_core;
+		const uint32_t core_id = i / threads_per_core;
+		const uint32_t package_id = i / threads_per_package;
+
+		/* Reconstruct APIC IDs from topology components */
+		const uint32_t thread_bits_mask = bit_mask(x86_processor.topology.thread_bits_length);
+		const uint32_t core_bits_mask   = bit_mask(x86_processor.topology.core_bits_length);
+		const uint32_t package_bits_offset = max(
+			x86_processor.topology.thread_bits_offset + x86_processor.topology.thread_bits_length,
+			x86_processor.topology.core_bits_offset + x86_processor.topology.core_bits_length);
+		const uint32_t apic_id =
+			((smt_id & thread_bits_mask) << x86_processor.topology.thread_bits_offset) |
+			((core_id & core_bits_mask) << x86_processor.topology.core_bits_offset) |
+			(package_id << package_bits_offset);
+		cpuinfo_log_debug("reconstructed APIC ID 0x%08"PRIx32" for thread %"PRIu32, apic_id, i);
+
+		processors[i].smt_id = smt_id;
+		processors[i].core = cores + i / threads_per_core;
+		processors[i].cluster = clusters + i / threads_per_package;
+		processors[i].package = packages + i / threads_per_package;
+		processors[i].apic_id = apic_id;
+	}
+
+	if (x86_processor.cache.l1i.size != 0) {
+		for (uint32_t c = 0; c < l1_count; c++) {
+			l1i[c] = (struct cpuinfo_cache) {
+				.size            = x86_processor.cache.l1i.size,
+				.associativity   = x86_processor.cache.l1i.associativity,
+				.sets            = x86_processor.cache.l1i.sets,
+				.partitions      = x86_processor.cache.l1i.partitions,
+				.line_size       = x86_processor.cache.l1i.line_size,
+				.flags           = x86_processor.cache.l1i.flags,
+				.processor_start = c * threads_per_l1,
+				.processor_count = threads_per_l1,
+			};
+		}
+		for (uint32_t t = 0; t < freebsd_topology.threads; t++) {
+			processors[t].cache.l1i = &l1i[t / threads_per_l1];
+		}
+	}
+
+	if (x86_processor.cache.l1d.size != 0) {
+		for (uint32_t c = 0; c < l1_count; c++) {
+			l1d[c] = (struct cpuinfo_cache) {
+				.size            = x86_processor.cache.l1d.size,
+				.associativity   = x86_processor.cache.l1d.associativity,
+				.sets            = x86_processor.cache.l1d.sets,
+				.partitions      = x86_processor.cache.l1d.partitions,
+				.line_size       = x86_processor.cache.l1d.line_size,
+				.flags           = x86_processor.cache.l1d.flags,
+				.processor_start = c * threads_per_l1,
+				.processor_count = threads_per_l1,
+			};
+		}
+		for (uint32_t t = 0; t < freebsd_topology.threads; t++) {
+			processors[t].cache.l1d = &l1d[t / threads_per_l1];
+		}
+	}
+
+	if (l2_count != 0) {
+		for (uint32_t c = 0; c < l2_count; c++) {
+			l2[c] = (struct cpuinfo_cache) {
+				.size            = x86_processor.cache.l2.size,
+				.associativity   = x86_processor.cache.l2.associativity,
+				.sets            = x86_processor.cache.l2.sets,
+				.partitions      = x86_processor.cache.l2.partitions,
+				.line_size       = x86_processor.cache.l2.line_size,
+				.flags           = x86_processor.cache.l2.flags,
+				.processor_start = c * threads_per_l2,
+				.processor_count = threads_per_l2,
+			};
+		}
+		for (uint32_t t = 0; t < freebsd_topology.threads; t++) {
+			processors[t].cache.l2 = &l2[t / threads_per_l2];
+		}
+	}
+
+	if (l3_count != 0) {
+		for (uint32_t c = 0; c < l3_count; c++) {
+			l3[c] = (struct cpuinfo_cache) {
+				.size            = x86_processor.cache.l3.size,
+				.associativity   = x86_processor.cache.l3.associativity,
+				.sets            = x86_processor.cache.l3.sets,
+				.partitions      = x86_processor.cache.l3.partitions,
+				.line_size       = x86_processor.cache.l3.line_size,
+				.flags           = x86_processor.cache.l3.flags,
+				.processor_start = c * threads_per_l3,
+				.processor_count = threads_per_l3,
+			};
+		}
+		for (uint32_t t = 0; t < freebsd_topology.threads; t++) {
+			processors[t].cache.l3 = &l3[t / threads_per_l3];
+		}
+	}
+
+	if (l4_count != 0) {
+		for (uint32_t c = 0; c < l4_count; c++) {
+			l4[c] = (struct cpuinfo_cache) {
+				.size            = x86_processor.cache.l4.size,
+				.associativity   = x86_processor.cache.l4.associativity,
+				.sets            = x86_processor.cache.l4.sets,
+				.partitions      = x86_processor.cache.l4.partitions,
+				.line_size       = x86_processor.cache.l4.line_size,
+				.flags           = x86_processor.cache.l4.flags,
+				.processor_start = c * threads_per_l4,
+				.processor_count = threads_per_l4,
+			};
+		}
+		for (uint32_t t = 0; t < freebsd_topology.threads; t++) {
+			processors[t].cache.l4 = &l4[t / threads_per_l4];
+		}
+	}
+
+	/* Commit changes */
+	cpuinfo_processors = processors;
+	cpuinfo_cores = cores;
+	cpuinfo_clusters = clusters;
+	cpuinfo_packages = packages;
+	cpuinfo_cache[cpuinfo_cache_level_1i] = l1i;
+	cpuinfo_cache[cpuinfo_cache_level_1d] = l1d;
+	cpuinfo_cache[cpuinfo_cache_level_2]  = l2;
+	cpuinfo_cache[cpuinfo_cache_level_3]  = l3;
+	cpuinfo_cache[cpuinfo_cache_level_4]  = l4;
+
+	cpuinfo_processors_count = freebsd_topology.threads;
+	cpuinfo_cores_count = freebsd_topology.cores;
+	cpuinfo_clusters_count = freebsd_topology.packages;
+	cpuinfo_packages_count = freebsd_topology.packages;
+	cpuinfo_cache_count[cpuinfo_cache_level_1i] = l1_count;
+	cpuinfo_cache_count[cpuinfo_cache_level_1d] = l1_count;
+	cpuinfo_cache_count[cpuinfo_cache_level_2]  = l2_count;
+	cpuinfo_cache_count[cpuinfo_cache_level_3]  = l3_count;
+	cpuinfo_cache_count[cpuinfo_cache_level_4]  = l4_count;
+	cpuinfo_max_cache_size = cpuinfo_compute_max_cache_size(&processors[0]);
+
+	cpuinfo_global_uarch = (struct cpuinfo_uarch_info) {
+		.uarch = x86_processor.uarch,
+		.cpuid = x86_processor.cpuid,
+		.processor_count = freebsd_topology.threads,
+		.core_count = freebsd_topology.cores,
+	};
+	cpuinfo_x86_group_tlbs(&x86_processor.tlb, &cpuinfo_global_uarch_tlbs);
+
+	cpuinfo_arena_memory = arena.memory;
+	__sync_synchronize();
+
+	cpuinfo_is_initialized = true;
+}
@@ -7,6 +7,7 @@
 #include <cpuinfo/utils.h>
 #include <cpuinfo/log.h>
 #include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
 
 
 struct cpuinfo_x86_isa cpuinfo_isa = { 0 };
@@ -29,9 +30,11 @@ void cpuinfo_x86_init_processor(struct cpuinfo_x86_processor* processor) {
 		const struct cpuid_regs leaf1 = cpuid(1);
 		processor->cpuid = leaf1.eax;
 
-		const struct cpuinfo_x86_model_info model_info = cpuinfo_x86_decode_model_info(leaf1.eax);
+		const struct cpuinfo_x86_model_info model_info = processor->model_info =
+			cpuinfo_x86_decode_model_info(leaf1.eax);
+		processor->core_type = cpuinfo_x86_detect_core_type(max_base_index);
 		const enum cpuinfo_uarch uarch = processor->uarch =
-			cpuinfo_x86_decode_uarch(vendor, &model_info);
+			cpuinfo_x86_decode_hybrid_uarch(vendor, &model_info, processor->core_type);
 
 		cpuinfo_x86_clflush_size = ((leaf1.ebx >> 8) & UINT32_C(0x000000FF)) * 8;
 
@@ -58,12 +61,19 @@ void cpuinfo_x86_init_processor(struct cpuinfo_x86_processor* processor) {
 			&processor->tlb.stlb2_2MB,
 			&processor->tlb.stlb2_1GB,
 			&processor->topology.core_bits_length);
+		cpuinfo_x86_detect_tlb(max_base_index, max_extended_index, vendor, &processor->tlb);
 
 		cpuinfo_x86_detect_topology(max_base_index, max_extended_index, leaf1, &processor->topology);
 
 		cpuinfo_isa = cpuinfo_x86_detect_isa(leaf1, leaf0x80000001,
 			max_base_index, max_extended_index, vendor, uarch);
 	}
+	if (max_base_index >= UINT32_C(0x16)) {
+		/* Processor frequency information: base and maximum frequencies in MHz in bits 0-15 of eax and ebx */
+		const struct cpuid_regs leaf0x16 = cpuid(UINT32_C(0x16));
+		processor->base_frequency = (uint64_t) (leaf0x16.eax & UINT32_C(0x0000FFFF)) * UINT64_C(1000000);
+		processor->max_frequency = (uint64_t) (leaf0x16.ebx & UINT32_C(0x0000FFFF)) * UINT64_C(1000000);
+	}
 	if (max_extended_index >= UINT32_C(0x80000004)) {
 		struct cpuid_regs brand_string[3];
 		for (uint32_t i = 0; i < 3; i++) {
@@ -73,3 +83,222 @@ void cpuinfo_x86_init_processor(struct cpuinfo_x86_processor* processor) {
 		cpuinfo_log_debug("raw CPUID brand string: \"%48s\"", processor->brand_string);
 	}
 }
+
+uint32_t cpuinfo_x86_detect_core_type(uint32_t max_base_index) {
+	if (max_base_index < UINT32_C(0x1A)) {
+		return 0;
+	}
+	/* Hybrid flag: edx[bit 15] in structured feature info */
+	const struct cpuid_regs leaf7 = cpuidex(7, 0);
+	if (!(leaf7.edx & UINT32_C(0x00008000))) {
+		return 0;
+	}
+	/* Core type: bits 24-31 of eax in native model ID enumeration leaf */
+	return cpuid(UINT32_C(0x1A)).eax >> 24;
+}
+
+void cpuinfo_x86_read_cpuid_signature(struct cpuinfo_x86_cpuid_signature signature[restrict static 1]) {
+	memset(signature, 0, sizeof(struct cpuinfo_x86_cpuid_signature));
+	const uint32_t max_base_index = cpuid(0).eax;
+	const uint32_t max_extended_index = cpuid(UINT32_C(0x80000000)).eax;
+	if (max_base_index >= 1) {
+		signature->leaf1 = cpuid(1);
+		/* Initial APIC ID: bits 24-31 of ebx */
+		signature->leaf1.ebx &= UINT32_C(0x00FFFFFF);
+	}
+	if (max_base_index >= 4) {
+		for (uint32_t i = 0; i < CPUINFO_X86_CPUID_SIGNATURE_CACHE_LEVELS; i++) {
+			signature->leaf4[i] = cpuidex(4, i);
+			/* Cache type: bits 0-4 of eax, 0 means no more caches */
+			if ((signature->leaf4[i].eax & UINT32_C(0x1F)) == 0) {
+				break;
+			}
+		}
+	}
+	if (max_base_index >= 7) {
+		signature->leaf7[0] = cpuidex(7, 0);
+		signature->leaf7[1] = cpuidex(7, 1);
+	}
+	const uint32_t topology_leaf = max_base_index >= UINT32_C(0x1F) ? UINT32_C(0x1F) : UINT32_C(0xB);
+	if (max_base_index >= topology_leaf) {
+		for (uint32_t i = 0; i < CPUINFO_X86_CPUID_SIGNATURE_TOPOLOGY_LEVELS; i++) {
+			signature->topology[i] = cpuidex(topology_leaf, i);
+			/* x2APIC ID of the logical processor */
+			signature->topology[i].edx = 0;
+			/* Level type: bits 8-15 of ecx, 0 means no more levels */
+			if ((signature->topology[i].ecx & UINT32_C(0x0000FF00)) == 0) {
+				break;
+			}
+		}
+	}
+	if (max_base_index >= UINT32_C(0x1A)) {
+		signature->leaf0x1A = cpuid(UINT32_C(0x1A));
+	}
+	if (max_extended_index >= UINT32_C(0x80000001)) {
+		signature->leaf0x80000001 = cpuid(UINT32_C(0x80000001));
+	}
+	/* AMD topology extensions: bit 22 of ecx in leaf 0x80000001 */
+	if (max_extended_index >= UINT32_C(0x8000001D) && (signature->leaf0x80000001.ecx & UINT32_C(0x00400000))) {
+		for (uint32_t i = 0; i < CPUINFO_X86_CPUID_SIGNATURE_CACHE_LEVELS; i++) {
+			signature->leaf0x8000001D[i] = cpuidex(UINT32_C(0x8000001D), i);
+			/* Cache type: bits 0-4 of eax, 0 means no more caches */
+			if ((signature->leaf0x8000001D[i].eax & UINT32_C(0x1F)) == 0) {
+				break;
+			}
+		}
+	}
+}
+
+void cpuinfo_x86_init_isa(void) {
+	const struct cpuid_regs leaf0 = cpuid(0);
+	const uint32_t max_base_index = leaf0.eax;
+	const enum cpuinfo_vendor vendor = cpuinfo_x86_decode_vendor(leaf0.ebx, leaf0.ecx, leaf0.edx);
+
+	const struct cpuid_regs leaf0x80000000 = cpuid(UINT32_C(0x80000000));
+	const uint32_t max_extended_index =
+		leaf0x80000000.eax >= UINT32_C(0x80000000) ? leaf0x80000000.eax : 0;
+
+	const struct cpuid_regs leaf0x80000001 = max_extended_index >= UINT32_C(0x80000001) ?
+		cpuid(UINT32_C(0x80000001)) : (struct cpuid_regs) { 0, 0, 0, 0 };
+
+	if (max_base_index >= 1) {
+		const struct cpuid_regs leaf1 = cpuid(1);
+		const struct cpuinfo_x86_model_info model_info = cpuinfo_x86_decode_model_info(leaf1.eax);
+		const enum cpuinfo_uarch uarch = cpuinfo_x86_decode_uarch(vendor, &model_info);
+
+		cpuinfo_x86_clflush_size = ((leaf1.ebx >> 8) & UINT32_C(0x000000FF)) * 8;
+
+		cpuinfo_isa = cpuinfo_x86_detect_isa(leaf1, leaf0x80000001,
+			max_base_index, max_extended_index, vendor, uarch);
+	}
+
+	cpuinfo_isa_is_initialized = true;
+}
+
+void cpuinfo_x86_detect_tsc(uint64_t tsc_frequency[restrict static 1], bool tsc_invariant[restrict static 1]) {
+	*tsc_frequency = 0;
+	*tsc_invariant = false;
+
+	const struct cpuid_regs leaf0 = cpuid(0);
+	const uint32_t max_base_index = leaf0.eax;
+	const enum cpuinfo_vendor vendor = cpuinfo_x86_decode_vendor(leaf0.ebx, leaf0.ecx, leaf0.edx);
+	const uint32_t max_extended_index = cpuid(UINT32_C(0x80000000)).eax;
+	if (max_extended_index >= UINT32_C(0x80000007)) {
+		/* Invariant TSC: edx[bit 8] in advanced power management information */
+		*tsc_invariant = !!(cpuid(UINT32_C(0x80000007)).edx & UINT32_C(0x00000100));
+	}
+	if (max_base_index < 1) {
+		return;
+	}
+
+	const struct cpuid_regs leaf1 = cpuid(1);
+	/* Hypervisor present: ecx[bit 31] in basic info */
+	if (leaf1.ecx & UINT32_C(0x80000000)) {
+		/*
+		 * VMware and KVM with the tsc_khz extension report the frequency of the guest TSC in kHz in eax of leaf
+		 * 0x40000010. It is authoritative when the hypervisor scales TSC, and leaves 0x15 and 0x16 are not.
+		 */
+		const uint32_t max_hypervisor_index = cpuid(UINT32_C(0x40000000)).eax;
+		if (max_hypervisor_index >= UINT32_C(0x40000010)) {
+			const uint32_t tsc_khz = cpuid(UINT32_C(0x40000010)).eax;
+			if (tsc_khz != 0) {
+				*tsc_frequency = (uint64_t) tsc_khz * UINT64_C(1000);
+				return;
+			}
+		}
+	}
+
+	uint32_t base_frequency_mhz = 0;
+	if (max_base_index >= UINT32_C(0x16)) {
+		/* Processor base frequency in MHz: bits 0-15 of eax */
+		base_frequency_mhz = cpuid(UINT32_C(0x16)).eax & UINT32_C(0x0000FFFF);
+	}
+	if (max_base_index >= UINT32_C(0x15)) {
+		/* TSC/crystal clock ratio: eax is the denominator, ebx is the numerator, ecx is the crystal clock in Hz */
+		const struct cpuid_regs leaf0x15 = cpuid(UINT32_C(0x15));
+		if (leaf0x15.eax != 0 && leaf0x15.ebx != 0) {
+			uint64_t crystal_frequency = leaf0x15.ecx;
+			if (crystal_frequency == 0) {
+				const struct cpuinfo_x86_model_info model_info = cpuinfo_x86_decode_model_info(leaf1.eax);
+				if (vendor == cpuinfo_vendor_intel && model_info.family == 0x06 && model_info.model == 0x5F) {
+					/* Denverton does not enumerate its 25 MHz crystal clock */
+					crystal_frequency = UINT64_C(25000000);
+				} else if (base_frequency_mhz != 0) {
+					/* Derive the crystal clock from the base frequency, which is the TSC frequency */
+					crystal_frequency =
+						(uint64_t) base_frequency_mhz * UINT64_C(1000000) * leaf0x15.eax / leaf0x15.ebx;
+				}
+			}
+			if (crystal_frequency != 0) {
+				*tsc_frequency = crystal_frequency * leaf0x15.ebx / leaf0x15.eax;
+				return;
+			}
+		}
+	}
+	if (vendor == cpuinfo_vendor_intel && *tsc_invariant) {
+		/* Invariant TSC on Intel processors ticks at the base frequency */
+		*tsc_frequency = (uint64_t) base_frequency_mhz * UINT64_C(1000000);
+	}
+}
+
+struct hypervisor_signature {
+	/* 12 characters from ebx, ecx, and edx, and the terminating NUL */
+	char signature[13];
+	enum cpuinfo_hypervisor hypervisor;
+};
+
+static const struct hypervisor_signature hypervisor_signatures[] = {
+	{ "KVMKVMKVM\0\0\0", cpuinfo_hypervisor_kvm },
+	{ "Linux KVM Hv", cpuinfo_hypervisor_kvm },
+	{ "Microsoft Hv", cpuinfo_hypervisor_hyperv },
+	{ "VMwareVMware", cpuinfo_hypervisor_vmware },
+	{ "XenVMMXenVMM", cpuinfo_hypervisor_xen },
+	{ "TCGTCGTCGTCG", cpuinfo_hypervisor_qemu },
+	{ "VBoxVBoxVBox", cpuinfo_hypervisor_virtualbox },
+	{ " lrpepyh  vr", cpuinfo_hypervisor_parallels },
+	{ "prl hyperv  ", cpuinfo_hypervisor_parallels },
+	{ "ACRNACRNACRN", cpuinfo_hypervisor_acrn },
+	{ "bhyve bhyve ", cpuinfo_hypervisor_bhyve },
+};
+
+static enum cpuinfo_hypervisor decode_hypervisor_signature(const struct cpuid_regs leaf) {
+	char signature[12];
+	memcpy(&signature[0], &leaf.ebx, sizeof(leaf.ebx));
+	memcpy(&signature[4], &leaf.ecx, sizeof(leaf.ecx));
+	memcpy(&signature[8], &leaf.edx, sizeof(leaf.edx));
+	for (size_t i = 0; i < CPUINFO_COUNT_OF(hypervisor_signatures); i++) {
+		if (memcmp(signature, hypervisor_signatures[i].signature, sizeof(signature)) == 0) {
+			return hypervisor_signatures[i].hypervisor;
+		}
+	}
+	return cpuinfo_hypervisor_unknown;
+}
+
+enum cpuinfo_hypervisor cpuinfo_x86_detect_hypervisor(bool root_partition[restrict static 1]) {
+	*root_partition = false;
+	if (cpuid(0).eax < 1) {
+		return cpuinfo_hypervisor_none;
+	}
+	/* Hypervisor present: ecx[bit 31] in basic info */
+	if (!(cpuid(1).ecx & UINT32_C(0x80000000))) {
+		return cpuinfo_hypervisor_none;
+	}
+
+	const struct cpuid_regs hypervisor_info = cpuid(UINT32_C(0x40000000));
+	enum cpuinfo_hypervisor hypervisor = decode_hypervisor_signature(hypervisor_info);
+	if (hypervisor == cpuinfo_hypervisor_hyperv) {
+		/* KVM and Xen with Hyper-V enlightenments report their own signature in leaf 0x40000100 */
+		const enum cpuinfo_hypervisor native_hypervisor = decode_hypervisor_signature(cpuid(UINT32_C(0x40000100)));
+		if (native_hypervisor == cpuinfo_hypervisor_kvm || native_hypervisor == cpuinfo_hypervisor_xen) {
+			return native_hypervisor;
+		}
+		if (hypervisor_info.eax >= UINT32_C(0x40000003)) {
+			/*
+			 * CreatePartitions privilege: ebx[bit 0] in leaf 0x40000003 is set only in the root partition, e.g. on
+			 * Windows with virtualization-based security, where virtual processors run on their own logical processors.
+			 */
+			*root_partition = !!(cpuid(UINT32_C(0x40000003)).ebx & UINT32_C(0x00000001));
+		}
+	}
+	return hypervisor;
+}
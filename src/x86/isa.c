@@ -35,6 +35,47 @@
 #endif
 
 
+/*
+ * Determine the x86-64 microarchitecture level from the x86-64 psABI. AVX and AVX-512 features in the isa structure
+ * already account for the OS-enabled state of YMM, opmask and ZMM registers in XCR0.
+ */
+static uint32_t detect_x86_64_level(const struct cpuinfo_x86_isa isa[restrict static 1],
+	const struct cpuid_regs extended_info)
+{
+#if CPUINFO_ARCH_X86
+	/*
+	 * Baseline: Long Mode (AMD: edx[bit 29] in extended info), CMOV, CMPXCHG8B, x87 FPU, FXSAVE, MMX, SSE, SSE2.
+	 * These features are architectural on x86-64, and need checking only in 32-bit processes.
+	 */
+	const bool long_mode = !!(extended_info.edx & UINT32_C(0x20000000));
+	if (!long_mode || !isa->cmov || !isa->cmpxchg8b || !isa->fpu || !isa->fxsave || !isa->mmx || !isa->sse ||
+		!isa->sse2)
+	{
+		return 0;
+	}
+#endif
+
+	/* x86-64-v2: CMPXCHG16B, LAHF/SAHF (ecx[bit 0] in extended info), POPCNT, SSE3, SSSE3, SSE4.1, SSE4.2 */
+	const bool lahf_sahf = !!(extended_info.ecx & UINT32_C(0x00000001));
+	if (!isa->cmpxchg16b || !lahf_sahf || !isa->popcnt || !isa->sse3 || !isa->ssse3 || !isa->sse4_1 || !isa->sse4_2) {
+		return 1;
+	}
+
+	/* x86-64-v3: AVX, AVX2, BMI1, BMI2, F16C, FMA, LZCNT, MOVBE, and OS support for YMM registers (OSXSAVE) */
+	if (!isa->avx || !isa->avx2 || !isa->bmi || !isa->bmi2 || !isa->f16c || !isa->fma3 || !isa->lzcnt ||
+		!isa->movbe)
+	{
+		return 2;
+	}
+
+	/* x86-64-v4: AVX512F, AVX512BW, AVX512CD, AVX512DQ, AVX512VL, and OS support for opmask and ZMM registers */
+	if (!isa->avx512f || !isa->avx512bw || !isa->avx512cd || !isa->avx512dq || !isa->avx512vl) {
+		return 3;
+	}
+
+	return 4;
+}
+
 struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	const struct cpuid_regs basic_info, const struct cpuid_regs extended_info,
 	uint32_t max_base_index, uint32_t max_extended_index,
@@ -52,7 +93,7 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 		(max_extended_index >= processor_capacity_info_index) ?
 			cpuid(processor_capacity_info_index) : (struct cpuid_regs) { 0, 0, 0, 0 };
 
-	bool avx_regs = false, avx512_regs = false, mpx_regs = false;
+	bool avx_regs = false, avx512_regs = false, mpx_regs = false, amx_regs = false, apx_regs = false;
 	/*
 	 * OSXSAVE: Operating system enabled XSAVE instructions for application use:
 	 * - Intel, AMD: ecx[bit 26] in basic info = XSAVE/XRSTOR instructions supported by a chip.
@@ -100,6 +141,26 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 		if ((xcr0_valid_bits & mpx_regs_mask) == mpx_regs_mask) {
 			mpx_regs = (xfeature_enabled_mask & mpx_regs_mask) == mpx_regs_mask;
 		}
+
+		/*
+		 * AMX registers:
+		 * - Intel: XFEATURE_ENABLED_MASK[bit 17] for XTILECFG
+		 * - Intel: XFEATURE_ENABLED_MASK[bit 18] for XTILEDATA
+		 * Linux sets these bits, but traps the first use of tile data through XFD until the process requests it.
+		 */
+		const uint64_t amx_regs_mask = UINT64_C(0x0000000000060000);
+		if ((xcr0_valid_bits & amx_regs_mask) == amx_regs_mask) {
+			amx_regs = (xfeature_enabled_mask & amx_regs_mask) == amx_regs_mask;
+		}
+
+		/*
+		 * APX registers:
+		 * - Intel: XFEATURE_ENABLED_MASK[bit 19] for extended general-purpose registers r16-r31
+		 */
+		const uint64_t apx_regs_mask = UINT64_C(0x0000000000080000);
+		if ((xcr0_valid_bits & apx_regs_mask) == apx_regs_mask) {
+			apx_regs = (xfeature_enabled_mask & apx_regs_mask) == apx_regs_mask;
+		}
 	}
 
 #if CPUINFO_ARCH_X86
@@ -162,6 +223,12 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	 */
 	isa.mwaitx = !!(extended_info.ecx & UINT32_C(0x20000000));
 
+	/*
+	 * UMONITOR/UMWAIT/TPAUSE instructions:
+	 * - Intel: ecx[bit 5] in structured feature info (ecx = 0).
+	 */
+	isa.waitpkg = !!(structured_feature_info0.ecx & UINT32_C(0x00000020));
+
 	/*
 	 * FXSAVE/FXRSTOR instructions:
 	 * - Intel, AMD: edx[bit 24] in basic info.
@@ -394,6 +461,36 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	 */
 	isa.avx2 = avx_regs && !!(structured_feature_info0.ebx & UINT32_C(0x00000020));
 
+	/*
+	 * AVX-VNNI instructions:
+	 * - Intel: eax[bit 4] in structured feature info (ecx = 1).
+	 */
+	isa.avxvnni = avx_regs && !!(structured_feature_info1.eax & UINT32_C(0x00000010));
+
+	/*
+	 * AVX-VNNI-INT8 instructions:
+	 * - Intel: edx[bit 4] in structured feature info (ecx = 1).
+	 */
+	isa.avxvnniint8 = avx_regs && !!(structured_feature_info1.edx & UINT32_C(0x00000010));
+
+	/*
+	 * AVX-VNNI-INT16 instructions:
+	 * - Intel: edx[bit 10] in structured feature info (ecx = 1).
+	 */
+	isa.avxvnniint16 = avx_regs && !!(structured_feature_info1.edx & UINT32_C(0x00000400));
+
+	/*
+	 * AVX-IFMA instructions:
+	 * - Intel: eax[bit 23] in structured feature info (ecx = 1).
+	 */
+	isa.avxifma = avx_regs && !!(structured_feature_info1.eax & UINT32_C(0x00800000));
+
+	/*
+	 * AVX-NE-CONVERT instructions:
+	 * - Intel: edx[bit 5] in structured feature info (ecx = 1).
+	 */
+	isa.avxneconvert = avx_regs && !!(structured_feature_info1.edx & UINT32_C(0x00000020));
+
 	/*
 	 * AVX512F instructions:
 	 * - Intel: ebx[bit 16] in structured feature info (ecx = 0).
@@ -502,6 +599,44 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	 */
 	isa.avx512bf16 = avx512_regs && !!(structured_feature_info1.eax & UINT32_C(0x00000020));
 
+#if CPUINFO_ARCH_X86_64
+	/*
+	 * AMX-TILE instructions:
+	 * - Intel: edx[bit 24] in structured feature info (ecx = 0).
+	 */
+	isa.amx_tile = amx_regs && !!(structured_feature_info0.edx & UINT32_C(0x01000000));
+
+	/*
+	 * AMX-INT8 instructions:
+	 * - Intel: edx[bit 25] in structured feature info (ecx = 0).
+	 */
+	isa.amx_int8 = amx_regs && !!(structured_feature_info0.edx & UINT32_C(0x02000000));
+
+	/*
+	 * AMX-BF16 instructions:
+	 * - Intel: edx[bit 22] in structured feature info (ecx = 0).
+	 */
+	isa.amx_bf16 = amx_regs && !!(structured_feature_info0.edx & UINT32_C(0x00400000));
+
+	/*
+	 * AMX-FP16 instructions:
+	 * - Intel: eax[bit 21] in structured feature info (ecx = 1).
+	 */
+	isa.amx_fp16 = amx_regs && !!(structured_feature_info1.eax & UINT32_C(0x00200000));
+
+	/*
+	 * AMX-COMPLEX instructions:
+	 * - Intel: edx[bit 8] in structured feature info (ecx = 1).
+	 */
+	isa.amx_complex = amx_regs && !!(structured_feature_info1.edx & UINT32_C(0x00000100));
+
+	/*
+	 * APX extended general-purpose registers and instructions:
+	 * - Intel: edx[bit 21] in structured feature info (ecx = 1).
+	 */
+	isa.apx = apx_regs && !!(structured_feature_info1.edx & UINT32_C(0x00200000));
+#endif
+
 	/*
 	 * HLE instructions:
 	 * - Intel: ebx[bit 4] in structured feature info (ecx = 0).
@@ -554,12 +689,84 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	 */
 	isa.clwb = !!(structured_feature_info0.ebx & UINT32_C(0x01000000));
 
+	/*
+	 * CLDEMOTE instruction:
+	 * - Intel: ecx[bit 25] in structured feature info (ecx = 0).
+	 */
+	isa.cldemote = !!(structured_feature_info0.ecx & UINT32_C(0x02000000));
+
+	/*
+	 * MOVDIRI instruction:
+	 * - Intel: ecx[bit 27] in structured feature info (ecx = 0).
+	 */
+	isa.movdiri = !!(structured_feature_info0.ecx & UINT32_C(0x08000000));
+
+	/*
+	 * MOVDIR64B instruction:
+	 * - Intel: ecx[bit 28] in structured feature info (ecx = 0).
+	 */
+	isa.movdir64b = !!(structured_feature_info0.ecx & UINT32_C(0x10000000));
+
+	/*
+	 * ENQCMD/ENQCMDS instructions:
+	 * - Intel: ecx[bit 29] in structured feature info (ecx = 0).
+	 */
+	isa.enqcmd = !!(structured_feature_info0.ecx & UINT32_C(0x20000000));
+
+	/*
+	 * SERIALIZE instruction:
+	 * - Intel: edx[bit 14] in structured feature info (ecx = 0).
+	 */
+	isa.serialize = !!(structured_feature_info0.edx & UINT32_C(0x00004000));
+
+	/*
+	 * HRESET instruction:
+	 * - Intel: eax[bit 22] in structured feature info (ecx = 1).
+	 */
+	isa.hreset = !!(structured_feature_info1.eax & UINT32_C(0x00400000));
+
+	/*
+	 * User interrupts (UIRET, TESTUI, CLUI, STUI, SENDUIPI):
+	 * - Intel: edx[bit 5] in structured feature info (ecx = 0).
+	 */
+	isa.uintr = !!(structured_feature_info0.edx & UINT32_C(0x00000020));
+
 	/*
 	 * MOVBE instruction:
 	 * - Intel: ecx[bit 22] in basic info.
 	 */
 	isa.movbe = !!(basic_info.ecx & UINT32_C(0x00400000));
 
+	/*
+	 * Enhanced REP MOVSB/STOSB:
+	 * - Intel, AMD: ebx[bit 9] in structured feature info (ecx = 0).
+	 */
+	isa.erms = !!(structured_feature_info0.ebx & UINT32_C(0x00000200));
+
+	/*
+	 * Fast short REP MOV:
+	 * - Intel, AMD: edx[bit 4] in structured feature info (ecx = 0).
+	 */
+	isa.fsrm = !!(structured_feature_info0.edx & UINT32_C(0x00000010));
+
+	/*
+	 * Fast zero-length REP MOVSB:
+	 * - Intel: eax[bit 10] in structured feature info (ecx = 1).
+	 */
+	isa.fzrm = !!(structured_feature_info1.eax & UINT32_C(0x00000400));
+
+	/*
+	 * Fast short REP STOSB:
+	 * - Intel: eax[bit 11] in structured feature info (ecx = 1).
+	 */
+	isa.fsrs = !!(structured_feature_info1.eax & UINT32_C(0x00000800));
+
+	/*
+	 * Fast short REP CMPSB and REP SCASB:
+	 * - Intel: eax[bit 12] in structured feature info (ecx = 1).
+	 */
+	isa.fsrc = !!(structured_feature_info1.eax & UINT32_C(0x00001000));
+
 #if CPUINFO_ARCH_X86_64
 	/*
 	 * Some early x86-64 CPUs lack LAHF & SAHF instructions.
@@ -726,5 +933,143 @@ struct cpuinfo_x86_isa cpuinfo_x86_detect_isa(
 	 */
 	isa.rdpid = !!(structured_feature_info0.ecx & UINT32_C(0x00400000));
 
+	/*
+	 * AVX10 converged vector ISA:
+	 * - Intel: edx[bit 19] in structured feature info (ecx = 1).
+	 * - Intel: ebx[bits 0-7] in AVX10 info (eax = 0x24, ecx = 0) = AVX10 version.
+	 * - Intel: ebx[bits 16-18] in AVX10 info = support for 128-bit, 256-bit, and 512-bit vectors.
+	 * AVX10 needs the same OS support for opmask and ZMM registers as AVX512.
+	 */
+	if (avx512_regs && (structured_feature_info1.edx & UINT32_C(0x00080000)) && max_base_index >= 0x24) {
+		const struct cpuid_regs avx10_info = cpuidex(0x24, 0);
+		isa.avx10_version = avx10_info.ebx & UINT32_C(0x000000FF);
+		if (avx10_info.ebx & UINT32_C(0x00040000)) {
+			isa.avx10_max_vector_bits = 512;
+		} else if (avx10_info.ebx & UINT32_C(0x00020000)) {
+			isa.avx10_max_vector_bits = 256;
+		} else if (avx10_info.ebx & UINT32_C(0x00010000)) {
+			isa.avx10_max_vector_bits = 128;
+		}
+		if (isa.avx10_version != 0) {
+			/*
+			 * AVX10.1 implies AVX512 subsets of Sapphire Rapids. Legacy AVX512 features promise 512-bit vectors, so
+			 * report them only if AVX10 supports 512-bit vectors, and never on AVX10/256 processors.
+			 */
+			const bool avx10_512 = isa.avx10_max_vector_bits >= 512;
+			isa.avx512f = avx10_512;
+			isa.avx512cd = avx10_512;
+			isa.avx512dq = avx10_512;
+			isa.avx512bw = avx10_512;
+			isa.avx512vl = avx10_512;
+			isa.avx512ifma = avx10_512;
+			isa.avx512vbmi = avx10_512;
+			isa.avx512vbmi2 = avx10_512;
+			isa.avx512bitalg = avx10_512;
+			isa.avx512vpopcntdq = avx10_512;
+			isa.avx512vnni = avx10_512;
+			isa.avx512bf16 = avx10_512;
+			isa.avx512fp16 = avx10_512;
+		}
+	}
+
+	isa.x86_64_level = detect_x86_64_level(&isa, extended_info);
+
 	return isa;
 }
+
+static void detect_vector_extensions(const struct cpuid_regs basic_info, uint32_t max_base_index,
+	struct cpuinfo_x86_xsave_state xsave_state[restrict static 1])
+{
+	const struct cpuid_regs structured_feature_info0 =
+		(max_base_index >= 7) ? cpuidex(7, 0) : (struct cpuid_regs) { 0, 0, 0, 0};
+	const struct cpuid_regs structured_feature_info1 =
+		(max_base_index >= 7) ? cpuidex(7, 1) : (struct cpuid_regs) { 0, 0, 0, 0};
+
+	struct cpuinfo_x86_vector_extension_state* extensions = xsave_state->extensions;
+	/* AVX: ecx[bit 28] in basic info; state components 1-2 */
+	extensions[cpuinfo_x86_vector_extension_avx].supported = !!(basic_info.ecx & UINT32_C(0x10000000));
+	extensions[cpuinfo_x86_vector_extension_avx].state_components = UINT64_C(0x0000000000000006);
+	/* AVX-512: AVX512F in ebx[bit 16] of leaf 7 subleaf 0, or AVX10 in edx[bit 19] of subleaf 1; components 1-2, 5-7 */
+	extensions[cpuinfo_x86_vector_extension_avx512].supported =
+		!!(structured_feature_info0.ebx & UINT32_C(0x00010000)) ||
+		!!(structured_feature_info1.edx & UINT32_C(0x00080000));
+	extensions[cpuinfo_x86_vector_extension_avx512].state_components = UINT64_C(0x00000000000000E6);
+	/* AMX: AMX-TILE in edx[bit 24] of leaf 7 subleaf 0; state components 17-18 */
+	extensions[cpuinfo_x86_vector_extension_amx].supported = !!(structured_feature_info0.edx & UINT32_C(0x01000000));
+	extensions[cpuinfo_x86_vector_extension_amx].state_components = UINT64_C(0x0000000000060000);
+	/* APX: APX_F in edx[bit 21] of leaf 7 subleaf 1; state component 19 */
+	extensions[cpuinfo_x86_vector_extension_apx].supported = !!(structured_feature_info1.edx & UINT32_C(0x00200000));
+	extensions[cpuinfo_x86_vector_extension_apx].state_components = UINT64_C(0x0000000000080000);
+
+	/* XCR0 has bit 0 for x87 state always set once the OS enabled XSAVE */
+	const bool osxsave = xsave_state->features != 0;
+	uint64_t xcr0_valid_bits = 0;
+	if (osxsave) {
+		const struct cpuid_regs regs = cpuidex(0xD, 0);
+		xcr0_valid_bits = ((uint64_t) regs.edx << 32) | regs.eax;
+	}
+	for (uint32_t i = 0; i < cpuinfo_x86_vector_extension_max; i++) {
+		const uint64_t state_components = extensions[i].state_components;
+		if (!extensions[i].supported) {
+			extensions[i].reason = cpuinfo_x86_vector_extension_reason_unsupported;
+		} else if (!osxsave) {
+			extensions[i].reason = cpuinfo_x86_vector_extension_reason_xsave_disabled;
+		} else if ((xcr0_valid_bits & state_components) != state_components) {
+			extensions[i].reason = cpuinfo_x86_vector_extension_reason_state_unsupported;
+		} else if ((xsave_state->features & state_components) != state_components) {
+			extensions[i].reason = cpuinfo_x86_vector_extension_reason_state_disabled;
+		} else {
+			extensions[i].reason = cpuinfo_x86_vector_extension_reason_enabled;
+			extensions[i].enabled = true;
+		}
+	}
+}
+
+void cpuinfo_x86_detect_xsave_state(struct cpuinfo_x86_xsave_state xsave_state[restrict static 1]) {
+	const uint32_t max_base_index = cpuid(0).eax;
+	const struct cpuid_regs basic_info = max_base_index >= 1 ? cpuid(1) : (struct cpuid_regs) { 0, 0, 0, 0 };
+
+	/* OSXSAVE: ecx[bits 26-27] in basic info = XSAVE supported by the chip and enabled by the OS */
+	const uint32_t osxsave_mask = UINT32_C(0x0C000000);
+	if (max_base_index >= 0xD && (basic_info.ecx & osxsave_mask) == osxsave_mask) {
+		xsave_state->features = xgetbv(0);
+	}
+	detect_vector_extensions(basic_info, max_base_index, xsave_state);
+	if (xsave_state->features == 0) {
+		return;
+	}
+
+	/* ebx in subleaf 0 of leaf 0xD = size of XSAVE area for the features enabled in XCR0 */
+	xsave_state->size = cpuidex(0xD, 0).ebx;
+	for (uint32_t i = 0; i < CPUINFO_X86_XSAVE_COMPONENTS_MAX; i++) {
+		if (!(xsave_state->features & (UINT64_C(1) << i))) {
+			continue;
+		}
+		switch (i) {
+			case 0:
+				/* x87 state in the legacy region */
+				xsave_state->components[i] = (struct cpuinfo_x86_xsave_component) {
+					.offset = 0,
+					.size = 160,
+				};
+				break;
+			case 1:
+				/* SSE state in the legacy region */
+				xsave_state->components[i] = (struct cpuinfo_x86_xsave_component) {
+					.offset = 160,
+					.size = 256,
+				};
+				break;
+			default:
+			{
+				/* eax = size and ebx = offset of the component in subleaf i of leaf 0xD */
+				const struct cpuid_regs component_info = cpuidex(0xD, i);
+				xsave_state->components[i] = (struct cpuinfo_x86_xsave_component) {
+					.offset = component_info.ebx,
+					.size = component_info.eax,
+				};
+				break;
+			}
+		}
+	}
+}
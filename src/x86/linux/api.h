@@ -5,6 +5,7 @@
 
 #include <cpuinfo.h>
 #include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
 #include <x86/api.h>
 #include <linux/api.h>
 
@@ -13,8 +14,39 @@ struct cpuinfo_x86_linux_processor {
 	uint32_t apic_id;
 	uint32_t linux_id;
 	uint32_t flags;
+	/* Core type from CPUID leaf 0x1A on hybrid processors, 0 otherwise */
+	uint32_t core_type;
+	/* Index of the record with CPUID information decoded on a processor with the same CPUID signature */
+	uint32_t cpuid_record;
+	/* Bitmask of cache/indexK directories in sysfs which are already parsed for this processor */
+	uint32_t sysfs_cache_indices;
+	/* Index plus one of the cache described in sysfs for every cache level, or 0 if sysfs doesn't report it */
+	uint32_t sysfs_cache[cpuinfo_cache_level_max];
+	/* IDs in sysfs topology, and the index of the processor among hardware threads of its core */
+	uint32_t package_id;
+	uint32_t die_id;
+	uint32_t core_id;
+	uint32_t thread_index;
+	/* Microcode revision from /proc/cpuinfo, or 0 if unknown */
+	uint32_t microcode_revision;
 };
 
+/* Linux initializes TSC_AUX MSR to (NUMA node << 12) | processor */
+#define CPUINFO_X86_LINUX_TSC_AUX_CPU_MASK UINT32_C(0x00000FFF)
+
+static inline uint32_t cpuinfo_x86_linux_read_tsc_aux_rdpid(void) {
+	uintptr_t tsc_aux;
+	/* RDPID %eax/%rax, encoded directly for assemblers which do not know the instruction */
+	__asm__ __volatile__(".byte 0xF3, 0x0F, 0xC7, 0xF8" : "=a" (tsc_aux));
+	return (uint32_t) tsc_aux;
+}
+
+static inline uint32_t cpuinfo_x86_linux_read_tsc_aux_rdtscp(void) {
+	uint32_t tsc_low, tsc_high, tsc_aux;
+	__asm__ __volatile__("rdtscp" : "=a" (tsc_low), "=d" (tsc_high), "=c" (tsc_aux));
+	return tsc_aux;
+}
+
 CPUINFO_INTERNAL bool cpuinfo_x86_linux_parse_proc_cpuinfo(
 	uint32_t max_processors_count,
 	struct cpuinfo_x86_linux_processor processors[restrict static max_processors_count]);
@@ -14,6 +14,12 @@
  */
 #define BUFFER_SIZE 2048
 
+/*
+ * Keys of /proc/cpuinfo with long values, which are not used: ISA is detected with CPUID instead.
+ * Lines with these keys are not tokenized and may be longer than the buffer.
+ */
+static const char* const skip_keys[] = { "flags", "vmx flags", "bugs", "power management", NULL };
+
 
 static uint32_t parse_processor_number(
 	const char* processor_start,
@@ -69,6 +75,46 @@ static void parse_apic_id(
 	processor->flags |= CPUINFO_LINUX_FLAG_APIC_ID;
 }
 
+/*
+ * Decode microcode revision reported by Linux kernel for x86/x86-64 architecture.
+ * Example of microcode revision reported in /proc/cpuinfo:
+ *
+ *		microcode	: 0x2b000571
+ */
+static void parse_microcode_revision(
+	const char* microcode_start,
+	const char* microcode_end,
+	struct cpuinfo_x86_linux_processor processor[restrict static 1])
+{
+	const char* digit_ptr = microcode_start;
+	if (microcode_end - microcode_start > 2 && digit_ptr[0] == '0' && (digit_ptr[1] == 'x' || digit_ptr[1] == 'X')) {
+		digit_ptr += 2;
+	}
+
+	uint32_t microcode_revision = 0;
+	for (; digit_ptr != microcode_end; digit_ptr++) {
+		const char character = *digit_ptr;
+		uint32_t digit;
+		if (character >= '0' && character <= '9') {
+			digit = (uint32_t) (character - '0');
+		} else if (character >= 'a' && character <= 'f') {
+			digit = (uint32_t) (character - 'a') + 10;
+		} else if (character >= 'A' && character <= 'F') {
+			digit = (uint32_t) (character - 'A') + 10;
+		} else {
+			cpuinfo_log_warning("microcode revision %.*s in /proc/cpuinfo is ignored due to unexpected non-hex "
+				"character '%c' at offset %zu",
+				(int) (microcode_end - microcode_start), microcode_start,
+				character, (size_t) (digit_ptr - microcode_start));
+			return;
+		}
+
+		microcode_revision = microcode_revision * 16 + digit;
+	}
+
+	processor->microcode_revision = microcode_revision;
+}
+
 struct proc_cpuinfo_parser_state {
 	uint32_t processor_index;
 	uint32_t max_processors_count;
@@ -77,70 +123,17 @@ struct proc_cpuinfo_parser_state {
 };
 
 /*
- *	Decode a single line of /proc/cpuinfo information.
+ *	Decode a single key/value pair of /proc/cpuinfo information.
  *	Lines have format <words-with-spaces>[ ]*:[ ]<space-separated words>
  */
 static bool parse_line(
-	const char* line_start,
-	const char* line_end,
+	const char* key_start,
+	const char* key_end,
+	const char* value_start,
+	const char* value_end,
 	struct proc_cpuinfo_parser_state state[restrict static 1],
 	uint64_t line_number)
 {
-	/* Empty line. Skip. */
-	if (line_start == line_end) {
-		return true;
-	}
-
-	/* Search for ':' on the line. */
-	const char* separator = line_start;
-	for (; separator != line_end; separator++) {
-		if (*separator == ':') {
-			break;
-		}
-	}
-	/* Skip line if no ':' separator was found. */
-	if (separator == line_end) {
-		cpuinfo_log_info("Line %.*s in /proc/cpuinfo is ignored: key/value separator ':' not found",
-			(int) (line_end - line_start), line_start);
-		return true;
-	}
-
-	/* Skip trailing spaces in key part. */
-	const char* key_end = separator;
-	for (; key_end != line_start; key_end--) {
-		if (key_end[-1] != ' ' && key_end[-1] != '\t') {
-			break;
-		}
-	}
-	/* Skip line if key contains nothing but spaces. */
-	if (key_end == line_start) {
-		cpuinfo_log_info("Line %.*s in /proc/cpuinfo is ignored: key contains only spaces",
-			(int) (line_end - line_start), line_start);
-		return true;
-	}
-
-	/* Skip leading spaces in value part. */
-	const char* value_start = separator + 1;
-	for (; value_start != line_end; value_start++) {
-		if (*value_start != ' ') {
-			break;
-		}
-	}
-	/* Value part contains nothing but spaces. Skip line. */
-	if (value_start == line_end) {
-		cpuinfo_log_info("Line %.*s in /proc/cpuinfo is ignored: value contains only spaces",
-			(int) (line_end - line_start), line_start);
-		return true;
-	}
-
-	/* Skip trailing spaces in value part (if any) */
-	const char* value_end = line_end;
-	for (; value_end != value_start; value_end--) {
-		if (value_end[-1] != ' ') {
-			break;
-		}
-	}
-
 	const uint32_t processor_index      = state->processor_index;
 	const uint32_t max_processors_count = state->max_processors_count;
 	struct cpuinfo_x86_linux_processor* processors = state->processors;
@@ -149,17 +142,17 @@ static bool parse_line(
 		processor = &processors[processor_index];
 	}
 
-	const size_t key_length = key_end - line_start;
+	const size_t key_length = key_end - key_start;
 	switch (key_length) {
 		case 6:
-			if (memcmp(line_start, "apicid", key_length) == 0) {
+			if (memcmp(key_start, "apicid", key_length) == 0) {
 				parse_apic_id(value_start, value_end, processor);
 			} else {
 				goto unknown;
 			}
 			break;
 		case 9:
-			if (memcmp(line_start, "processor", key_length) == 0) {
+			if (memcmp(key_start, "processor", key_length) == 0) {
 				const uint32_t new_processor_index = parse_processor_number(value_start, value_end);
 				if (new_processor_index < processor_index) {
 					/* Strange: decreasing processor number */
@@ -181,13 +174,15 @@ static bool parse_line(
 				}
 				state->processor_index = new_processor_index;
 				return true;
+			} else if (memcmp(key_start, "microcode", key_length) == 0) {
+				parse_microcode_revision(value_start, value_end, processor);
 			} else {
 				goto unknown;
 			}
 			break;
 		default:
 		unknown:
-			cpuinfo_log_debug("unknown /proc/cpuinfo key: %.*s", (int) key_length, line_start);
+			cpuinfo_log_debug("unknown /proc/cpuinfo key: %.*s", (int) key_length, key_start);
 
 	}
 	return true;
@@ -202,6 +197,6 @@ bool cpuinfo_x86_linux_parse_proc_cpuinfo(
 		.max_processors_count = max_processors_count,
 		.processors = processors,
 	};
-	return cpuinfo_linux_parse_multiline_file("/proc/cpuinfo", BUFFER_SIZE,
-		(cpuinfo_line_callback) parse_line, &state);
+	return cpuinfo_linux_parse_key_value_file("/proc/cpuinfo", BUFFER_SIZE, skip_keys,
+		(cpuinfo_key_value_callback) parse_line, &state);
 }
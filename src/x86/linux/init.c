@@ -3,8 +3,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !CPUINFO_MOCK
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#if !defined(__NR_getcpu)
+		#include <asm-generic/unistd.h>
+	#endif
+#endif
+
 #include <cpuinfo.h>
 #include <x86/api.h>
+#include <x86/cpuid.h>
 #include <x86/linux/api.h>
 #include <linux/api.h>
 #include <cpuinfo/internal-api.h>
@@ -23,10 +33,624 @@ static inline uint32_t min(uint32_t a, uint32_t b) {
 	return a < b ? a : b;
 }
 
+static inline uint32_t max(uint32_t a, uint32_t b) {
+	return a > b ? a : b;
+}
+
 static inline int cmp(uint32_t a, uint32_t b) {
 	return (a > b) - (a < b);
 }
 
+#if !CPUINFO_MOCK
+/* Number of attempts to sample TSC_AUX without migration of the thread to another processor */
+#define TSC_AUX_CALIBRATION_ATTEMPTS 16
+
+static uint32_t read_tsc_aux(enum cpuinfo_linux_current_cpu_method method) {
+	if (method == cpuinfo_linux_current_cpu_method_rdpid) {
+		return cpuinfo_x86_linux_read_tsc_aux_rdpid();
+	} else {
+		return cpuinfo_x86_linux_read_tsc_aux_rdtscp();
+	}
+}
+
+/*
+ * Check that TSC_AUX identifies the current processor on the processors in the affinity mask of the thread.
+ * Hypervisors may expose RDPID and RDTSCP without initializing TSC_AUX, so it can't be trusted without checking.
+ */
+static bool check_tsc_aux(enum cpuinfo_linux_current_cpu_method method) {
+	for (uint32_t attempt = 0; attempt < TSC_AUX_CALIBRATION_ATTEMPTS; attempt++) {
+		unsigned cpu_before = 0, cpu_after = 0;
+		if (syscall(__NR_getcpu, &cpu_before, NULL, NULL) != 0) {
+			return false;
+		}
+		const uint32_t tsc_aux_cpu = read_tsc_aux(method) & CPUINFO_X86_LINUX_TSC_AUX_CPU_MASK;
+		if (syscall(__NR_getcpu, &cpu_after, NULL, NULL) != 0) {
+			return false;
+		}
+		if (cpu_before == cpu_after) {
+			return tsc_aux_cpu == cpu_before;
+		}
+	}
+	/* The thread migrates all the time: no conclusion */
+	return false;
+}
+
+/*
+ * Detect if RDPID or RDTSCP can identify the current processor without a system call.
+ * The check is done on a processor other than 0, because TSC_AUX which is not initialized reads as 0.
+ * Returns cpuinfo_linux_current_cpu_method_syscall if neither instruction can be used.
+ */
+static enum cpuinfo_linux_current_cpu_method detect_tsc_aux_method(uint32_t linux_cpu_max) {
+	enum cpuinfo_linux_current_cpu_method method;
+	if (cpuinfo_isa.rdpid) {
+		method = cpuinfo_linux_current_cpu_method_rdpid;
+	} else if (cpuinfo_isa.rdtscp) {
+		method = cpuinfo_linux_current_cpu_method_rdtscp;
+	} else {
+		return cpuinfo_linux_current_cpu_method_syscall;
+	}
+	if (linux_cpu_max > CPUINFO_X86_LINUX_TSC_AUX_CPU_MASK + 1) {
+		/* Processor numbers don't fit into TSC_AUX */
+		return cpuinfo_linux_current_cpu_method_syscall;
+	}
+	if (linux_cpu_max <= 1) {
+		/* TSC_AUX can't identify the processor incorrectly */
+		return check_tsc_aux(method) ? method : cpuinfo_linux_current_cpu_method_syscall;
+	}
+
+	cpu_set_t original_affinity;
+	if (sched_getaffinity(0, sizeof(original_affinity), &original_affinity) != 0) {
+		return cpuinfo_linux_current_cpu_method_syscall;
+	}
+	uint32_t check_cpu = 0;
+	for (uint32_t cpu = 1; cpu < linux_cpu_max && cpu < CPU_SETSIZE; cpu++) {
+		if (CPU_ISSET(cpu, &original_affinity)) {
+			check_cpu = cpu;
+			break;
+		}
+	}
+	if (check_cpu == 0) {
+		/* The thread can run only on processor 0: TSC_AUX can't be checked */
+		return cpuinfo_linux_current_cpu_method_syscall;
+	}
+
+	cpu_set_t check_affinity;
+	CPU_ZERO(&check_affinity);
+	CPU_SET(check_cpu, &check_affinity);
+	if (sched_setaffinity(0, sizeof(check_affinity), &check_affinity) != 0) {
+		return cpuinfo_linux_current_cpu_method_syscall;
+	}
+	const bool valid = check_tsc_aux(method);
+	if (sched_setaffinity(0, sizeof(original_affinity), &original_affinity) != 0) {
+		cpuinfo_log_warning("failed to restore thread affinity after TSC_AUX calibration");
+	}
+	cpuinfo_log_debug("TSC_AUX %s identify the current processor", valid ? "can" : "can not");
+	return valid ? method : cpuinfo_linux_current_cpu_method_syscall;
+}
+
+static enum cpuinfo_linux_current_cpu_method detect_current_cpu_method(uint32_t linux_cpu_max) {
+	/* vDSO getcpu is also the fallback for threads without rseq area */
+	const bool has_vdso_getcpu = cpuinfo_linux_resolve_vdso_getcpu();
+	if (cpuinfo_linux_rseq_is_registered()) {
+		/* A load from the thread's rseq area is cheaper than RDPID and RDTSCP */
+		return cpuinfo_linux_current_cpu_method_rseq;
+	}
+	const enum cpuinfo_linux_current_cpu_method tsc_aux_method = detect_tsc_aux_method(linux_cpu_max);
+	if (tsc_aux_method != cpuinfo_linux_current_cpu_method_syscall) {
+		return tsc_aux_method;
+	}
+	return has_vdso_getcpu ? cpuinfo_linux_current_cpu_method_vdso : cpuinfo_linux_current_cpu_method_syscall;
+}
+#endif
+
+/* Processors with more distinct microarchitectures and CPUID signatures describe the extra ones as the first one */
+#define CPUINFO_X86_LINUX_MAX_UARCHS 8
+
+/* Linux lists processors of each core type of hybrid Intel processors as a separate PMU device */
+#define CPUINFO_X86_LINUX_CORE_CPUS_FILENAME "/sys/devices/cpu_core/cpus"
+#define CPUINFO_X86_LINUX_ATOM_CPUS_FILENAME "/sys/devices/cpu_atom/cpus"
+
+struct core_type_context {
+	uint32_t core_type;
+	uint32_t processors_count;
+	struct cpuinfo_x86_linux_processor* processors;
+};
+
+static bool set_core_type(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+	const struct core_type_context* core_type_context = (const struct core_type_context*) context;
+	cpu_end = min(cpu_end, core_type_context->processors_count);
+	for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+		core_type_context->processors[cpu].core_type = core_type_context->core_type;
+	}
+	return true;
+}
+
+/* Processors with more distinct CPUID signatures than this are described by the signature of the first processor */
+#define CPUINFO_X86_LINUX_MAX_CPUID_RECORDS 8
+
+/* Information decoded from CPUID on one of the logical processors with the same CPUID signature */
+struct cpuid_record {
+	struct cpuinfo_x86_cpuid_signature signature;
+	struct cpuinfo_x86_processor processor;
+	struct cpuinfo_x86_isa isa;
+};
+
+static void init_cpuid_record(struct cpuid_record record[restrict static 1]) {
+	cpuinfo_x86_read_cpuid_signature(&record->signature);
+	memset(&record->processor, 0, sizeof(record->processor));
+	cpuinfo_x86_init_processor(&record->processor);
+	/* cpuinfo_x86_init_processor detects ISA into the global variable */
+	record->isa = cpuinfo_isa;
+}
+
+#if !CPUINFO_MOCK
+/*
+ * Read CPUID signature on each valid processor by binding the calling thread to it, and decode CPUID only on the first
+ * processor with each distinct signature. The first record describes the initializing processor, and must be filled.
+ * Returns the number of records.
+ */
+static uint32_t collect_cpuid_records(
+	uint32_t linux_processors_count,
+	struct cpuinfo_x86_linux_processor linux_processors[restrict static linux_processors_count],
+	struct cpuid_record records[restrict static CPUINFO_X86_LINUX_MAX_CPUID_RECORDS])
+{
+	uint32_t records_count = 1;
+	/* Recorded leaves describe the initializing processor, and must not answer CPUID on other processors */
+	const bool recording = cpuinfo_x86_record_cpuid(false);
+	const size_t cpu_set_size = CPU_ALLOC_SIZE(linux_processors_count);
+	cpu_set_t* original_affinity = cpuinfo_allocate_temporary(1, CPU_ALLOC_SIZE(linux_processors_count));
+	cpu_set_t* cpu_affinity = cpuinfo_allocate_temporary(1, CPU_ALLOC_SIZE(linux_processors_count));
+	if (original_affinity == NULL || cpu_affinity == NULL ||
+		sched_getaffinity(0, cpu_set_size, original_affinity) != 0)
+	{
+		cpuinfo_log_warning("failed to query thread affinity: CPUID of the initializing processor describes all processors");
+		goto cleanup;
+	}
+	for (uint32_t cpu = 0; cpu < linux_processors_count; cpu++) {
+		if (!bitmask_all(linux_processors[cpu].flags, CPUINFO_LINUX_FLAG_VALID) ||
+			!CPU_ISSET_S(cpu, cpu_set_size, original_affinity))
+		{
+			continue;
+		}
+		CPU_ZERO_S(cpu_set_size, cpu_affinity);
+		CPU_SET_S(cpu, cpu_set_size, cpu_affinity);
+		if (sched_setaffinity(0, cpu_set_size, cpu_affinity) != 0) {
+			continue;
+		}
+
+		struct cpuinfo_x86_cpuid_signature signature;
+		cpuinfo_x86_read_cpuid_signature(&signature);
+		uint32_t record_index = 0;
+		while (record_index < records_count &&
+			memcmp(&records[record_index].signature, &signature, sizeof(signature)) != 0)
+		{
+			record_index++;
+		}
+		if (record_index == records_count) {
+			if (records_count < CPUINFO_X86_LINUX_MAX_CPUID_RECORDS) {
+				init_cpuid_record(&records[records_count++]);
+				cpuinfo_log_debug("processor %"PRIu32" has a new CPUID signature (leaf 1 eax 0x%08"PRIx32")",
+					cpu, signature.leaf1.eax);
+			} else {
+				cpuinfo_log_warning("processor %"PRIu32" has too many distinct CPUID signatures: "
+					"described by CPUID of the initializing processor", cpu);
+				record_index = 0;
+			}
+		}
+		linux_processors[cpu].cpuid_record = record_index;
+	}
+	if (sched_setaffinity(0, cpu_set_size, original_affinity) != 0) {
+		cpuinfo_log_warning("failed to restore thread affinity after collection of CPUID");
+	}
+
+cleanup:
+	if (original_affinity != NULL) {
+		cpuinfo_free_temporary(original_affinity);
+	}
+	if (cpu_affinity != NULL) {
+		cpuinfo_free_temporary(cpu_affinity);
+	}
+	cpuinfo_x86_record_cpuid(recording);
+	return records_count;
+}
+#endif
+
+/*
+ * Detect core types of processors indexed by Linux processor ID. Processors which are not listed in sysfs get the core
+ * type from their CPUID record, and processors with unrecognized core type get the core type of the initializing
+ * processor.
+ */
+static void detect_core_types(
+	uint32_t linux_processors_count,
+	struct cpuinfo_x86_linux_processor linux_processors[restrict static linux_processors_count],
+	const struct cpuid_record records[restrict static 1])
+{
+	struct core_type_context context = {
+		.core_type = CPUINFO_X86_CORE_TYPE_CORE,
+		.processors_count = linux_processors_count,
+		.processors = linux_processors,
+	};
+	cpuinfo_linux_parse_cpulist(CPUINFO_X86_LINUX_CORE_CPUS_FILENAME, set_core_type, &context);
+	context.core_type = CPUINFO_X86_CORE_TYPE_ATOM;
+	cpuinfo_linux_parse_cpulist(CPUINFO_X86_LINUX_ATOM_CPUS_FILENAME, set_core_type, &context);
+
+	for (uint32_t i = 0; i < linux_processors_count; i++) {
+		/* Kernels before 5.13 do not expose PMU devices for core types: use core type from CPUID */
+		if (linux_processors[i].core_type == 0) {
+			linux_processors[i].core_type = records[linux_processors[i].cpuid_record].processor.core_type;
+		}
+		const uint32_t core_type = linux_processors[i].core_type;
+		if (core_type != CPUINFO_X86_CORE_TYPE_ATOM && core_type != CPUINFO_X86_CORE_TYPE_CORE) {
+			linux_processors[i].core_type = records[0].processor.core_type;
+		}
+		cpuinfo_log_debug("processor %"PRIu32": core type 0x%02"PRIx32, i, linux_processors[i].core_type);
+	}
+}
+
+/* Report only instructions supported on all processors */
+struct thread_index_context {
+	uint32_t processor;
+	uint32_t thread_index;
+};
+
+/* Count hardware threads of the core which precede the processor, i.e. the processor's SMT ID within the core */
+static bool count_preceding_threads(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+	struct thread_index_context* thread_index_context = (struct thread_index_context*) context;
+	cpu_end = min(cpu_end, thread_index_context->processor);
+	if (cpu_start < cpu_end) {
+		thread_index_context->thread_index += cpu_end - cpu_start;
+	}
+	return true;
+}
+
+/* Read IDs of sysfs topology; called concurrently for distinct processors, so it modifies only their descriptions */
+static void detect_sysfs_topology_ids(uint32_t cpu, struct cpuinfo_x86_linux_processor* linux_processors) {
+	struct cpuinfo_x86_linux_processor* linux_processor = &linux_processors[cpu];
+	if (!bitmask_all(linux_processor->flags, CPUINFO_LINUX_FLAG_VALID)) {
+		return;
+	}
+	struct thread_index_context context = { .processor = cpu };
+	if (!cpuinfo_linux_get_processor_package_id(cpu, &linux_processor->package_id) ||
+		!cpuinfo_linux_get_processor_core_id(cpu, &linux_processor->core_id) ||
+		!cpuinfo_linux_parse_processor_core_cpus(cpu, count_preceding_threads, &context))
+	{
+		return;
+	}
+	if (!cpuinfo_linux_get_processor_die_id(cpu, &linux_processor->die_id)) {
+		linux_processor->die_id = 0;
+	}
+	linux_processor->thread_index = context.thread_index;
+	linux_processor->flags |= CPUINFO_LINUX_FLAG_PACKAGE_ID | CPUINFO_LINUX_FLAG_CORE_ID | CPUINFO_LINUX_FLAG_SMT_ID;
+}
+
+/* Positions of the fields of APIC ID which sysfs topology IDs describe */
+struct apic_id_layout {
+	uint32_t thread_bits_offset;
+	uint32_t thread_bits_length;
+	uint32_t core_bits_offset;
+	uint32_t core_bits_length;
+	/* The lowest of module, tile, and die ID bits, which kernels before 6.9 report as die ID */
+	uint32_t die_bits_offset;
+};
+
+static struct apic_id_layout get_apic_id_layout(const struct cpuinfo_x86_topology topology[restrict static 1]) {
+	const uint32_t thread_bits_end = topology->thread_bits_offset + topology->thread_bits_length;
+	const uint32_t core_bits_offset = topology->core_bits_length != 0 ? topology->core_bits_offset : thread_bits_end;
+	uint32_t die_bits_offset = core_bits_offset + topology->core_bits_length;
+	if (topology->module_bits_length != 0 && topology->module_bits_offset > thread_bits_end) {
+		die_bits_offset = min(die_bits_offset, topology->module_bits_offset);
+	}
+	if (topology->tile_bits_length != 0) {
+		die_bits_offset = min(die_bits_offset, topology->tile_bits_offset);
+	}
+	if (topology->die_bits_length != 0) {
+		die_bits_offset = min(die_bits_offset, topology->die_bits_offset);
+	}
+	return (struct apic_id_layout) {
+		.thread_bits_offset = topology->thread_bits_offset,
+		.thread_bits_length = topology->thread_bits_length,
+		.core_bits_offset = core_bits_offset,
+		.core_bits_length = topology->core_bits_length,
+		.die_bits_offset = max(die_bits_offset, core_bits_offset),
+	};
+}
+
+/*
+ * Compose APIC ID from sysfs topology IDs, or return UINT64_MAX if they don't fit the layout. Linux derives these IDs
+ * from APIC IDs: kernels since 6.9 report ID of the core within the package, including module, tile, and die bits,
+ * while older kernels report ID of the core within the die, and report the other bits as die ID.
+ */
+static uint64_t compose_apic_id(
+	const struct cpuinfo_x86_linux_processor linux_processor[restrict static 1],
+	const struct apic_id_layout layout[restrict static 1])
+{
+	const uint32_t die_shift = layout->die_bits_offset - layout->core_bits_offset;
+	uint64_t core_bits = linux_processor->core_id;
+	if ((core_bits >> die_shift) == 0) {
+		core_bits |= (uint64_t) linux_processor->die_id << die_shift;
+	}
+	if ((linux_processor->thread_index >> layout->thread_bits_length) != 0 ||
+		(core_bits >> layout->core_bits_length) != 0)
+	{
+		return UINT64_MAX;
+	}
+	const uint32_t package_bits_offset = layout->core_bits_offset + layout->core_bits_length;
+	const uint64_t apic_id = ((uint64_t) linux_processor->package_id << package_bits_offset) |
+		(core_bits << layout->core_bits_offset) |
+		((uint64_t) linux_processor->thread_index << layout->thread_bits_offset);
+	return apic_id <= UINT32_MAX ? apic_id : UINT64_MAX;
+}
+
+static int cmp_apic_id(const void* ptr_a, const void* ptr_b) {
+	return cmp(*((const uint32_t*) ptr_a), *((const uint32_t*) ptr_b));
+}
+
+/*
+ * Reconstruct APIC IDs from sysfs topology and the layout of APIC ID in CPUID of the initializing processor, so that
+ * topology doesn't need /proc/cpuinfo, which is large on systems with hundreds of processors, and reading which
+ * makes the kernel query the frequency of every processor. Like /proc/cpuinfo, sysfs has no topology of offline
+ * processors. Returns false if the IDs don't fit the layout, are not unique, or don't include the APIC ID of the
+ * initializing processor: then APIC IDs must be parsed from /proc/cpuinfo.
+ */
+static bool reconstruct_apic_ids(
+	uint32_t linux_processors_count,
+	struct cpuinfo_x86_linux_processor linux_processors[restrict static linux_processors_count],
+	const struct cpuinfo_x86_topology topology[restrict static 1])
+{
+	cpuinfo_linux_parallel_for_processors(linux_processors_count,
+		(cpuinfo_processor_function) detect_sysfs_topology_ids, linux_processors);
+
+	const struct apic_id_layout layout = get_apic_id_layout(topology);
+	uint32_t* apic_ids = cpuinfo_allocate_temporary(linux_processors_count, sizeof(uint32_t));
+	if (apic_ids == NULL) {
+		return false;
+	}
+	bool valid = true, has_initializing_processor = false;
+	uint32_t apic_ids_count = 0;
+	for (uint32_t i = 0; i < linux_processors_count && valid; i++) {
+		if (bitmask_all(linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_CORE_ID)) {
+			const uint64_t apic_id = compose_apic_id(&linux_processors[i], &layout);
+			valid = apic_id != UINT64_MAX;
+			has_initializing_processor |= apic_id == topology->apic_id;
+			apic_ids[apic_ids_count++] = (uint32_t) apic_id;
+		}
+	}
+	if (valid) {
+		qsort(apic_ids, apic_ids_count, sizeof(uint32_t), cmp_apic_id);
+		for (uint32_t i = 1; i < apic_ids_count; i++) {
+			valid &= apic_ids[i] != apic_ids[i - 1];
+		}
+	}
+	cpuinfo_free_temporary(apic_ids);
+	if (!valid || !has_initializing_processor) {
+		cpuinfo_log_info("sysfs topology doesn't match the layout of APIC IDs: parsing APIC IDs from /proc/cpuinfo");
+		return false;
+	}
+
+	for (uint32_t i = 0; i < linux_processors_count; i++) {
+		if (bitmask_all(linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID | CPUINFO_LINUX_FLAG_CORE_ID)) {
+			linux_processors[i].apic_id = (uint32_t) compose_apic_id(&linux_processors[i], &layout);
+			linux_processors[i].flags |= CPUINFO_LINUX_FLAG_APIC_ID;
+		}
+	}
+	return true;
+}
+
+static void intersect_isa(struct cpuinfo_x86_isa isa[restrict static 1], const struct cpuinfo_x86_isa other[restrict static 1]) {
+	/* All members of struct cpuinfo_x86_isa are bool flags */
+	bool* isa_flags = (bool*) isa;
+	const bool* other_flags = (const bool*) other;
+	for (size_t i = 0; i < sizeof(struct cpuinfo_x86_isa) / sizeof(bool); i++) {
+		isa_flags[i] = isa_flags[i] && other_flags[i];
+	}
+}
+
+static uint32_t find_uarch_index(
+	uint32_t uarchs_count,
+	const struct cpuinfo_uarch_info uarchs[restrict static uarchs_count],
+	enum cpuinfo_uarch uarch,
+	uint32_t cpuid)
+{
+	for (uint32_t i = 0; i < uarchs_count; i++) {
+		if (uarchs[i].uarch == uarch && uarchs[i].cpuid == cpuid) {
+			return i;
+		}
+	}
+	return uarchs_count;
+}
+
+static const char* const cache_level_names[cpuinfo_cache_level_max] = {
+	[cpuinfo_cache_level_1i] = "L1I",
+	[cpuinfo_cache_level_1d] = "L1D",
+	[cpuinfo_cache_level_2]  = "L2",
+	[cpuinfo_cache_level_3]  = "L3",
+	[cpuinfo_cache_level_4]  = "L4",
+};
+
+static const struct cpuinfo_x86_cache* get_cpuid_cache(
+	const struct cpuinfo_x86_processor processor[restrict static 1],
+	enum cpuinfo_cache_level level)
+{
+	switch (level) {
+		case cpuinfo_cache_level_1i:
+			return &processor->cache.l1i;
+		case cpuinfo_cache_level_1d:
+			return &processor->cache.l1d;
+		case cpuinfo_cache_level_2:
+			return &processor->cache.l2;
+		case cpuinfo_cache_level_3:
+			return &processor->cache.l3;
+		default:
+			return &processor->cache.l4;
+	}
+}
+
+static void set_processor_cache(
+	struct cpuinfo_processor processor[restrict static 1],
+	enum cpuinfo_cache_level level,
+	const struct cpuinfo_cache* cache)
+{
+	switch (level) {
+		case cpuinfo_cache_level_1i:
+			processor->cache.l1i = cache;
+			break;
+		case cpuinfo_cache_level_1d:
+			processor->cache.l1d = cache;
+			break;
+		case cpuinfo_cache_level_2:
+			processor->cache.l2 = cache;
+			break;
+		case cpuinfo_cache_level_3:
+			processor->cache.l3 = cache;
+			break;
+		default:
+			processor->cache.l4 = cache;
+			break;
+	}
+}
+
+/* Level of a cache described in sysfs, or cpuinfo_cache_level_max if cpuinfo doesn't report such caches */
+static enum cpuinfo_cache_level get_sysfs_cache_level(const struct cpuinfo_linux_cache cache[restrict static 1]) {
+	if (cache->type == cpuinfo_linux_cache_type_instruction) {
+		return cache->level == 1 ? cpuinfo_cache_level_1i : cpuinfo_cache_level_max;
+	}
+	switch (cache->level) {
+		case 1:
+			return cpuinfo_cache_level_1d;
+		case 2:
+			return cpuinfo_cache_level_2;
+		case 3:
+			return cpuinfo_cache_level_3;
+		case 4:
+			return cpuinfo_cache_level_4;
+		default:
+			return cpuinfo_cache_level_max;
+	}
+}
+
+struct cache_siblings_context {
+	uint32_t processors_count;
+	struct cpuinfo_x86_linux_processor* processors;
+	/* Index of the cache/indexK directory, and level and index plus one of the cache */
+	uint32_t sysfs_index;
+	enum cpuinfo_cache_level level;
+	uint32_t cache;
+};
+
+static bool set_cache_siblings(uint32_t cpu_start, uint32_t cpu_end, void* context) {
+	const struct cache_siblings_context* siblings_context = (const struct cache_siblings_context*) context;
+	cpu_end = min(cpu_end, siblings_context->processors_count);
+	for (uint32_t cpu = cpu_start; cpu < cpu_end; cpu++) {
+		struct cpuinfo_x86_linux_processor* processor = &siblings_context->processors[cpu];
+		processor->sysfs_cache_indices |= UINT32_C(1) << siblings_context->sysfs_index;
+		if (processor->sysfs_cache[siblings_context->level] == 0) {
+			processor->sysfs_cache[siblings_context->level] = siblings_context->cache;
+		}
+	}
+	return true;
+}
+
+/*
+ * Detect caches of processors indexed by Linux processor ID from sysfs, which describes caches of every processor
+ * even when CPUID is decoded on only one of them. Every cache is parsed only on the first processor which shares it,
+ * and gets flags, which sysfs doesn't report, from CPUID. Returns the number of caches.
+ */
+static uint32_t detect_sysfs_caches(
+	uint32_t linux_processors_count,
+	struct cpuinfo_x86_linux_processor linux_processors[restrict static linux_processors_count],
+	const struct cpuid_record records[restrict static 1],
+	struct cpuinfo_x86_cache caches[restrict static linux_processors_count * cpuinfo_cache_level_max])
+{
+	uint32_t caches_count = 0;
+	for (uint32_t cpu = 0; cpu < linux_processors_count; cpu++) {
+		if (!bitmask_all(linux_processors[cpu].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			continue;
+		}
+		for (uint32_t index = 0; index < CPUINFO_LINUX_MAX_CACHE_INDICES; index++) {
+			if (linux_processors[cpu].sysfs_cache_indices & (UINT32_C(1) << index)) {
+				continue;
+			}
+			struct cpuinfo_linux_cache linux_cache;
+			if (!cpuinfo_linux_get_processor_cache(cpu, index, &linux_cache)) {
+				break;
+			}
+			linux_processors[cpu].sysfs_cache_indices |= UINT32_C(1) << index;
+			const enum cpuinfo_cache_level level = get_sysfs_cache_level(&linux_cache);
+			if (level == cpuinfo_cache_level_max || linux_processors[cpu].sysfs_cache[level] != 0) {
+				continue;
+			}
+
+			if (linux_cache.sets == 0 && linux_cache.associativity != 0 && linux_cache.line_size != 0) {
+				linux_cache.sets = linux_cache.size / (linux_cache.associativity * linux_cache.line_size);
+			}
+			const struct cpuinfo_x86_cache* cpuid_cache =
+				get_cpuid_cache(&records[linux_processors[cpu].cpuid_record].processor, level);
+			caches[caches_count] = (struct cpuinfo_x86_cache) {
+				.size = linux_cache.size,
+				.associativity = linux_cache.associativity,
+				.sets = linux_cache.sets,
+				.partitions = linux_cache.partitions != 0 ? linux_cache.partitions : 1,
+				.line_size = linux_cache.line_size,
+				.flags = cpuid_cache->flags,
+			};
+			if (cpuid_cache->size != linux_cache.size || cpuid_cache->associativity != linux_cache.associativity ||
+				cpuid_cache->line_size != linux_cache.line_size)
+			{
+				cpuinfo_log_debug("processor %"PRIu32": L%"PRIu32" cache of %"PRIu32" bytes, %"PRIu32"-way, "
+					"%"PRIu32"-byte lines in sysfs, but of %"PRIu32" bytes, %"PRIu32"-way, %"PRIu32"-byte lines in CPUID",
+					cpu, linux_cache.level, linux_cache.size, linux_cache.associativity, linux_cache.line_size,
+					cpuid_cache->size, cpuid_cache->associativity, cpuid_cache->line_size);
+			}
+			caches_count++;
+
+			struct cache_siblings_context context = {
+				.processors_count = linux_processors_count,
+				.processors = linux_processors,
+				.sysfs_index = index,
+				.level = level,
+				.cache = caches_count,
+			};
+			cpuinfo_linux_parse_processor_cache_siblings(cpu, index, set_cache_siblings, &context);
+			/* The processor itself may be missing from a malformed list */
+			set_cache_siblings(cpu, cpu + 1, &context);
+		}
+	}
+	return caches_count;
+}
+
+/*
+ * Parameters of the processor's cache at the level, and an ID which is the same only for processors which share the
+ * cache. Caches come from sysfs if it describes any cache of the processor, and from CPUID otherwise.
+ * Returns false if the processor has no cache at the level.
+ */
+static bool get_processor_cache(
+	const struct cpuinfo_x86_linux_processor linux_processor[restrict static 1],
+	const struct cpuinfo_x86_processor cpuid_processor[restrict static 1],
+	const struct cpuinfo_x86_cache* sysfs_caches,
+	enum cpuinfo_cache_level level,
+	struct cpuinfo_x86_cache cache[restrict static 1],
+	uint64_t cache_id[restrict static 1])
+{
+	if (linux_processor->sysfs_cache_indices != 0) {
+		const uint32_t sysfs_cache = linux_processor->sysfs_cache[level];
+		if (sysfs_cache == 0) {
+			return false;
+		}
+		*cache = sysfs_caches[sysfs_cache - 1];
+		/* Distinct from IDs of caches described by CPUID, which are masked 32-bit APIC IDs */
+		*cache_id = (UINT64_C(1) << 32) | (uint64_t) sysfs_cache;
+		return true;
+	}
+
+	const struct cpuinfo_x86_cache* cpuid_cache = get_cpuid_cache(cpuid_processor, level);
+	if (cpuid_cache->size == 0) {
+		return false;
+	}
+	*cache = *cpuid_cache;
+	*cache_id = (uint64_t) (linux_processor->apic_id & ~bit_mask(cpuid_cache->apic_bits));
+	return true;
+}
+
 static int cmp_x86_linux_processor(const void* ptr_a, const void* ptr_b) {
 	const struct cpuinfo_x86_linux_processor* processor_a = (const struct cpuinfo_x86_linux_processor*) ptr_a;
 	const struct cpuinfo_x86_linux_processor* processor_b = (const struct cpuinfo_x86_linux_processor*) ptr_b;
@@ -44,89 +668,145 @@ static int cmp_x86_linux_processor(const void* ptr_a, const void* ptr_b) {
 	return cmp(id_a, id_b);
 }
 
+/* All bits of APIC ID except thread ID mask */
+/*
+ * Base frequency of a core in Hz: from CPUID leaf 0x16 of the core type, else from cpufreq (only intel_pstate
+ * reports it) or ACPI CPPC, else from the brand string. Hypervisors often expose none of these.
+ */
+static uint64_t get_base_frequency(
+	const struct cpuinfo_x86_processor processor[restrict static 1],
+	uint32_t linux_id,
+	uint64_t brand_string_frequency)
+{
+	if (processor->base_frequency != 0) {
+		return processor->base_frequency;
+	}
+	const uint32_t base_frequency_khz = cpuinfo_linux_get_processor_base_frequency(linux_id);
+	if (base_frequency_khz != 0) {
+		return (uint64_t) base_frequency_khz * UINT64_C(1000);
+	}
+	return brand_string_frequency;
+}
+
+/* Maximum Turbo frequency of a core in Hz: from CPUID leaf 0x16 of the core type, else from cpufreq */
+static uint64_t get_max_turbo_frequency(const struct cpuinfo_x86_processor processor[restrict static 1], uint32_t linux_id) {
+	if (processor->max_frequency != 0) {
+		return processor->max_frequency;
+	}
+	return (uint64_t) cpuinfo_linux_get_processor_max_frequency(linux_id) * UINT64_C(1000);
+}
+
+/*
+ * Microcode revision of a core: from /proc/cpuinfo if it was parsed, else from sysfs, which reports it only with the
+ * microcode loader. Hypervisors often report a fake revision, or none; then sysfs is not probed again for other cores.
+ */
+static uint32_t get_microcode_revision(
+	const struct cpuinfo_x86_linux_processor processor[restrict static 1],
+	bool has_sysfs_microcode[restrict static 1])
+{
+	if (processor->microcode_revision != 0) {
+		return processor->microcode_revision;
+	}
+	uint32_t microcode_revision = 0;
+	if (*has_sysfs_microcode) {
+		*has_sysfs_microcode =
+			cpuinfo_linux_get_processor_microcode_revision(processor->linux_id, &microcode_revision);
+	}
+	return microcode_revision;
+}
+
+static inline uint32_t get_core_apic_mask(const struct cpuinfo_x86_processor processor[restrict static 1]) {
+	return ~(bit_mask(processor->topology.thread_bits_length) << processor->topology.thread_bits_offset);
+}
+
+/* All bits of APIC ID except thread ID and core ID masks */
+static inline uint32_t get_package_apic_mask(const struct cpuinfo_x86_processor processor[restrict static 1]) {
+	return get_core_apic_mask(processor) &
+		~(bit_mask(processor->topology.core_bits_length) << processor->topology.core_bits_offset);
+}
+
+/*
+ * Bits of APIC ID which are part of either LLC, die, tile, or package ID mask, or of module ID mask if modules have
+ * multiple cores.
+ */
+static inline uint32_t get_cluster_apic_mask(const struct cpuinfo_x86_processor processor[restrict static 1]) {
+	uint32_t cluster_apic_bits = 0;
+	if (processor->cache.l4.size != 0) {
+		cluster_apic_bits = processor->cache.l4.apic_bits;
+	} else if (processor->cache.l3.size != 0) {
+		cluster_apic_bits = processor->cache.l3.apic_bits;
+	} else if (processor->cache.l2.size != 0) {
+		cluster_apic_bits = processor->cache.l2.apic_bits;
+	} else if (processor->cache.l1d.size != 0) {
+		cluster_apic_bits = processor->cache.l1d.apic_bits;
+	}
+	const struct cpuinfo_x86_topology* topology = &processor->topology;
+	if (topology->die_bits_length != 0) {
+		cluster_apic_bits = min(cluster_apic_bits, topology->die_bits_offset);
+	}
+	if (topology->tile_bits_length != 0) {
+		cluster_apic_bits = min(cluster_apic_bits, topology->tile_bits_offset);
+	}
+	if (topology->module_bits_length != 0 &&
+		topology->module_bits_offset > topology->thread_bits_offset + topology->thread_bits_length)
+	{
+		cluster_apic_bits = min(cluster_apic_bits, topology->module_bits_offset);
+	}
+	return get_package_apic_mask(processor) | ~bit_mask(cluster_apic_bits);
+}
+
 static void cpuinfo_x86_count_objects(
 	uint32_t linux_processors_count,
 	const struct cpuinfo_x86_linux_processor linux_processors[restrict static linux_processors_count],
-	const struct cpuinfo_x86_processor processor[restrict static 1],
+	const struct cpuid_record cpuid_records[restrict static 1],
+	const struct cpuinfo_x86_cache* sysfs_caches,
 	uint32_t valid_processor_mask,
-	uint32_t llc_apic_bits,
 	uint32_t cores_count_ptr[restrict static 1],
 	uint32_t clusters_count_ptr[restrict static 1],
 	uint32_t packages_count_ptr[restrict static 1],
-	uint32_t l1i_count_ptr[restrict static 1],
-	uint32_t l1d_count_ptr[restrict static 1],
-	uint32_t l2_count_ptr[restrict static 1],
-	uint32_t l3_count_ptr[restrict static 1],
-	uint32_t l4_count_ptr[restrict static 1])
+	uint32_t cache_counts[restrict static cpuinfo_cache_level_max])
 {
-	const uint32_t core_apic_mask =
-		~(bit_mask(processor->topology.thread_bits_length) << processor->topology.thread_bits_offset);
-	const uint32_t package_apic_mask =
-		core_apic_mask & ~(bit_mask(processor->topology.core_bits_length) << processor->topology.core_bits_offset);
-	const uint32_t llc_apic_mask = ~bit_mask(llc_apic_bits);
-	const uint32_t cluster_apic_mask = package_apic_mask | llc_apic_mask;
-
 	uint32_t cores_count = 0, clusters_count = 0, packages_count = 0;
-	uint32_t l1i_count = 0, l1d_count = 0, l2_count = 0, l3_count = 0, l4_count = 0;
 	uint32_t last_core_id = UINT32_MAX, last_cluster_id = UINT32_MAX, last_package_id = UINT32_MAX;
-	uint32_t last_l1i_id = UINT32_MAX, last_l1d_id = UINT32_MAX;
-	uint32_t last_l2_id = UINT32_MAX, last_l3_id = UINT32_MAX, last_l4_id = UINT32_MAX;
+	uint32_t last_cluster_core_type = UINT32_MAX;
+	uint64_t last_cache_ids[cpuinfo_cache_level_max];
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cache_counts[level] = 0;
+		last_cache_ids[level] = UINT64_MAX;
+	}
 	for (uint32_t i = 0; i < linux_processors_count; i++) {
 		if (bitmask_all(linux_processors[i].flags, valid_processor_mask)) {
 			const uint32_t apic_id = linux_processors[i].apic_id;
+			const uint32_t core_type = linux_processors[i].core_type;
+			const struct cpuinfo_x86_processor* processor = &cpuid_records[linux_processors[i].cpuid_record].processor;
 			cpuinfo_log_debug("APID ID %"PRIu32": system processor %"PRIu32, apic_id, linux_processors[i].linux_id);
 
-			/* All bits of APIC ID except thread ID mask */
-			const uint32_t core_id = apic_id & core_apic_mask;
+			const uint32_t core_id = apic_id & get_core_apic_mask(processor);
 			if (core_id != last_core_id) {
 				last_core_id = core_id;
 				cores_count++;
 			}
-			/* All bits of APIC ID except thread ID and core ID masks */
-			const uint32_t package_id = apic_id & package_apic_mask;
+			const uint32_t package_id = apic_id & get_package_apic_mask(processor);
 			if (package_id != last_package_id) {
 				last_package_id = package_id;
 				packages_count++;
 			}
-			/* Bits of APIC ID which are part of either LLC or package ID mask */
-			const uint32_t cluster_id = apic_id & cluster_apic_mask;
-			if (cluster_id != last_cluster_id) {
+			/* Cores of a cluster have the same type */
+			const uint32_t cluster_id = apic_id & get_cluster_apic_mask(processor);
+			if (cluster_id != last_cluster_id || core_type != last_cluster_core_type) {
 				last_cluster_id = cluster_id;
+				last_cluster_core_type = core_type;
 				clusters_count++;
 			}
-			if (processor->cache.l1i.size != 0) {
-				const uint32_t l1i_id = apic_id & ~bit_mask(processor->cache.l1i.apic_bits);
-				if (l1i_id != last_l1i_id) {
-					last_l1i_id = l1i_id;
-					l1i_count++;
-				}
-			}
-			if (processor->cache.l1d.size != 0) {
-				const uint32_t l1d_id = apic_id & ~bit_mask(processor->cache.l1d.apic_bits);
-				if (l1d_id != last_l1d_id) {
-					last_l1d_id = l1d_id;
-					l1d_count++;
-				}
-			}
-			if (processor->cache.l2.size != 0) {
-				const uint32_t l2_id = apic_id & ~bit_mask(processor->cache.l2.apic_bits);
-				if (l2_id != last_l2_id) {
-					last_l2_id = l2_id;
-					l2_count++;
-				}
-			}
-			if (processor->cache.l3.size != 0) {
-				const uint32_t l3_id = apic_id & ~bit_mask(processor->cache.l3.apic_bits);
-				if (l3_id != last_l3_id) {
-					last_l3_id = l3_id;
-					l3_count++;
-				}
-			}
-			if (processor->cache.l4.size != 0) {
-				const uint32_t l4_id = apic_id & ~bit_mask(processor->cache.l4.apic_bits);
-				if (l4_id != last_l4_id) {
-					last_l4_id = l4_id;
-					l4_count++;
+			for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+				struct cpuinfo_x86_cache cache;
+				uint64_t cache_id;
+				if (!get_processor_cache(&linux_processors[i], processor, sysfs_caches, level, &cache, &cache_id)) {
+					/* Must match the reset of cache ID in cpuinfo_x86_linux_init */
+					last_cache_ids[level] = UINT64_MAX;
+				} else if (cache_id != last_cache_ids[level]) {
+					last_cache_ids[level] = cache_id;
+					cache_counts[level]++;
 				}
 			}
 		}
@@ -134,11 +814,6 @@ static void cpuinfo_x86_count_objects(
 	*cores_count_ptr = cores_count;
 	*clusters_count_ptr = clusters_count;
 	*packages_count_ptr = packages_count;
-	*l1i_count_ptr = l1i_count;
-	*l1d_count_ptr = l1d_count;
-	*l2_count_ptr  = l2_count;
-	*l3_count_ptr  = l3_count;
-	*l4_count_ptr  = l4_count;
 }
 
 void cpuinfo_x86_linux_init(void) {
@@ -149,11 +824,13 @@ void cpuinfo_x86_linux_init(void) {
 	struct cpuinfo_package* packages = NULL;
 	const struct cpuinfo_processor** linux_cpu_to_processor_map = NULL;
 	const struct cpuinfo_core** linux_cpu_to_core_map = NULL;
-	struct cpuinfo_cache* l1i = NULL;
-	struct cpuinfo_cache* l1d = NULL;
-	struct cpuinfo_cache* l2 = NULL;
-	struct cpuinfo_cache* l3 = NULL;
-	struct cpuinfo_cache* l4 = NULL;
+	struct cpuinfo_uarch_info* uarchs = NULL;
+	struct cpuinfo_uarch_tlbs* uarch_tlbs = NULL;
+	uint32_t* linux_cpu_to_uarch_index_map = NULL;
+	struct cpuinfo_cache* caches[cpuinfo_cache_level_max] = { NULL };
+	struct cpuinfo_x86_cache* sysfs_caches = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
+	uint64_t phase_start = cpuinfo_get_timestamp_ns();
 
 	const uint32_t max_processors_count = cpuinfo_linux_get_max_processors_count();
 	cpuinfo_log_debug("system maximum processors count: %"PRIu32, max_processors_count);
@@ -178,7 +855,8 @@ void cpuinfo_x86_linux_init(void) {
 		valid_processor_mask |= CPUINFO_LINUX_FLAG_POSSIBLE;
 	}
 
-	x86_linux_processors = calloc(x86_linux_processors_count, sizeof(struct cpuinfo_x86_linux_processor));
+	x86_linux_processors = cpuinfo_allocate_temporary(
+		x86_linux_processors_count, sizeof(struct cpuinfo_x86_linux_processor));
 	if (x86_linux_processors == NULL) {
 		cpuinfo_log_error(
 			"failed to allocate %zu bytes for descriptions of %"PRIu32" x86 logical processors",
@@ -200,23 +878,42 @@ void cpuinfo_x86_linux_init(void) {
 			sizeof(struct cpuinfo_x86_linux_processor),
 			CPUINFO_LINUX_FLAG_PRESENT);
 	}
+	cpuinfo_record_init_phase(cpuinfo_init_phase_cpulists, &phase_start);
 
-	if (!cpuinfo_x86_linux_parse_proc_cpuinfo(x86_linux_processors_count, x86_linux_processors)) {
-		cpuinfo_log_error("failed to parse processor information from /proc/cpuinfo");
-		return;
-	}
+	struct cpuid_record cpuid_records[CPUINFO_X86_LINUX_MAX_CPUID_RECORDS];
+	init_cpuid_record(&cpuid_records[0]);
+	const struct cpuinfo_x86_processor* x86_processor = &cpuid_records[0].processor;
+	cpuinfo_record_init_phase(cpuinfo_init_phase_decode, &phase_start);
 
-	for (uint32_t i = 0; i < x86_linux_processors_count; i++) {
-		if (bitmask_all(x86_linux_processors[i].flags, valid_processor_mask)) {
-			x86_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_VALID;
+	/* Without the list of present processors, valid processors are those listed in /proc/cpuinfo */
+	bool has_apic_ids = false;
+	if (max_present_processors_count != 0) {
+		for (uint32_t i = 0; i < x86_linux_processors_count; i++) {
+			if (bitmask_all(x86_linux_processors[i].flags, valid_processor_mask)) {
+				x86_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_VALID;
+			}
 		}
+		has_apic_ids = reconstruct_apic_ids(x86_linux_processors_count, x86_linux_processors, &x86_processor->topology);
+		cpuinfo_record_init_phase(cpuinfo_init_phase_sysfs, &phase_start);
 	}
+	if (!has_apic_ids) {
+		if (!cpuinfo_x86_linux_parse_proc_cpuinfo(x86_linux_processors_count, x86_linux_processors)) {
+			cpuinfo_log_error("failed to parse processor information from /proc/cpuinfo");
+			return;
+		}
 
-	struct cpuinfo_x86_processor x86_processor;
-	memset(&x86_processor, 0, sizeof(x86_processor));
-	cpuinfo_x86_init_processor(&x86_processor);
+		for (uint32_t i = 0; i < x86_linux_processors_count; i++) {
+			if (bitmask_all(x86_linux_processors[i].flags, valid_processor_mask)) {
+				x86_linux_processors[i].flags |= CPUINFO_LINUX_FLAG_VALID;
+			}
+		}
+		cpuinfo_record_init_phase(cpuinfo_init_phase_proc_cpuinfo, &phase_start);
+	}
 	char brand_string[48];
-	cpuinfo_x86_normalize_brand_string(x86_processor.brand_string, brand_string);
+	cpuinfo_x86_normalize_brand_string(x86_processor->brand_string, brand_string);
+	const uint64_t brand_string_frequency = cpuinfo_x86_parse_brand_string_frequency(x86_processor->brand_string);
+	/* Cache parameters are decoded from CPUID together with vendor and microarchitecture */
+	cpuinfo_record_init_phase(cpuinfo_init_phase_decode, &phase_start);
 
 	uint32_t processors_count = 0;
 	for (uint32_t i = 0; i < x86_linux_processors_count; i++) {
@@ -225,154 +922,159 @@ void cpuinfo_x86_linux_init(void) {
 			processors_count++;
 		}
 	}
+	uint32_t cpuid_records_count = 1;
+	#if !CPUINFO_MOCK
+		/* Hybrid processors have different CPUID on different core types */
+		if (cpuinfo_per_processor_cpuid || x86_processor->core_type != 0) {
+			cpuid_records_count = collect_cpuid_records(x86_linux_processors_count, x86_linux_processors, cpuid_records);
+		}
+	#endif
+	cpuinfo_log_debug("detected %"PRIu32" distinct CPUID signatures", cpuid_records_count);
+	for (uint32_t i = 1; i < cpuid_records_count; i++) {
+		intersect_isa(&cpuid_records[0].isa, &cpuid_records[i].isa);
+	}
+	cpuinfo_isa = cpuid_records[0].isa;
+	if (x86_processor->core_type != 0) {
+		detect_core_types(x86_linux_processors_count, x86_linux_processors, cpuid_records);
+	}
 
-	qsort(x86_linux_processors, x86_linux_processors_count, sizeof(struct cpuinfo_x86_linux_processor),
-		cmp_x86_linux_processor);
-
-	processors = calloc(processors_count, sizeof(struct cpuinfo_processor));
-	if (processors == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
-			processors_count * sizeof(struct cpuinfo_processor), processors_count);
-		goto cleanup;
+	/* Caches in sysfs take priority over CPUID, which is decoded only on one processor of every type */
+	sysfs_caches = cpuinfo_allocate_temporary(
+		x86_linux_processors_count * cpuinfo_cache_level_max, sizeof(struct cpuinfo_x86_cache));
+	if (sysfs_caches == NULL) {
+		cpuinfo_log_warning("failed to allocate %zu bytes for descriptions of caches in sysfs: using CPUID descriptions",
+			x86_linux_processors_count * cpuinfo_cache_level_max * sizeof(struct cpuinfo_x86_cache));
+	} else {
+		const uint32_t sysfs_caches_count =
+			detect_sysfs_caches(x86_linux_processors_count, x86_linux_processors, cpuid_records, sysfs_caches);
+		cpuinfo_log_debug("detected %"PRIu32" caches in sysfs", sysfs_caches_count);
 	}
 
-	uint32_t llc_apic_bits = 0;
-	if (x86_processor.cache.l4.size != 0) {
-		llc_apic_bits = x86_processor.cache.l4.apic_bits;
-	} else if (x86_processor.cache.l3.size != 0) {
-		llc_apic_bits = x86_processor.cache.l3.apic_bits;
-	} else if (x86_processor.cache.l2.size != 0) {
-		llc_apic_bits = x86_processor.cache.l2.apic_bits;
-	} else if (x86_processor.cache.l1d.size != 0) {
-		llc_apic_bits = x86_processor.cache.l1d.apic_bits;
+	/* Microarchitectures in order of Linux processor ID, i.e. P-cores before E-cores */
+	struct cpuinfo_uarch_info uarchs_list[CPUINFO_X86_LINUX_MAX_UARCHS];
+	/* CPUID record of the first processor of every microarchitecture, with its TLB descriptions */
+	uint32_t uarch_cpuid_records[CPUINFO_X86_LINUX_MAX_UARCHS];
+	uint32_t uarchs_count = 0;
+	for (uint32_t i = 0; i < x86_linux_processors_count; i++) {
+		if (bitmask_all(x86_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
+			const struct cpuinfo_x86_processor* cpuid_processor =
+				&cpuid_records[x86_linux_processors[i].cpuid_record].processor;
+			const enum cpuinfo_uarch uarch = cpuinfo_x86_decode_hybrid_uarch(
+				cpuid_processor->vendor, &cpuid_processor->model_info, x86_linux_processors[i].core_type);
+			if (find_uarch_index(uarchs_count, uarchs_list, uarch, cpuid_processor->cpuid) == uarchs_count &&
+				uarchs_count < CPUINFO_X86_LINUX_MAX_UARCHS)
+			{
+				uarch_cpuid_records[uarchs_count] = x86_linux_processors[i].cpuid_record;
+				uarchs_list[uarchs_count++] = (struct cpuinfo_uarch_info) {
+					.uarch = uarch,
+					.cpuid = cpuid_processor->cpuid,
+				};
+			}
+		}
 	}
+	/* Processors with a single microarchitecture describe it in cpuinfo_global_uarch */
+	const uint32_t uarch_index_map_count = uarchs_count > 1 ? x86_linux_processors_count : 0;
+	cpuinfo_log_debug("detected %"PRIu32" microarchitectures", uarchs_count);
+
+	qsort(x86_linux_processors, x86_linux_processors_count, sizeof(struct cpuinfo_x86_linux_processor),
+		cmp_x86_linux_processor);
+
 	uint32_t packages_count = 0, clusters_count = 0, cores_count = 0;
-	uint32_t l1i_count = 0, l1d_count = 0, l2_count = 0, l3_count = 0, l4_count = 0;
+	uint32_t cache_counts[cpuinfo_cache_level_max];
 	cpuinfo_x86_count_objects(
-		x86_linux_processors_count, x86_linux_processors, &x86_processor, valid_processor_mask, llc_apic_bits,
-		&cores_count, &clusters_count, &packages_count, &l1i_count, &l1d_count, &l2_count, &l3_count, &l4_count);
+		x86_linux_processors_count, x86_linux_processors, cpuid_records, sysfs_caches, valid_processor_mask,
+		&cores_count, &clusters_count, &packages_count, cache_counts);
 
 	cpuinfo_log_debug("detected %"PRIu32" cores", cores_count);
 	cpuinfo_log_debug("detected %"PRIu32" clusters", clusters_count);
 	cpuinfo_log_debug("detected %"PRIu32" packages", packages_count);
-	cpuinfo_log_debug("detected %"PRIu32" L1I caches", l1i_count);
-	cpuinfo_log_debug("detected %"PRIu32" L1D caches", l1d_count);
-	cpuinfo_log_debug("detected %"PRIu32" L2 caches", l2_count);
-	cpuinfo_log_debug("detected %"PRIu32" L3 caches", l3_count);
-	cpuinfo_log_debug("detected %"PRIu32" L4 caches", l4_count);
-
-	linux_cpu_to_processor_map = calloc(x86_linux_processors_count, sizeof(struct cpuinfo_processor*));
-	if (linux_cpu_to_processor_map == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for mapping entries of %"PRIu32" logical processors",
-			x86_linux_processors_count * sizeof(struct cpuinfo_processor*),
-			x86_linux_processors_count);
-		goto cleanup;
-	}
+	cpuinfo_log_debug("detected %"PRIu32" L1I caches", cache_counts[cpuinfo_cache_level_1i]);
+	cpuinfo_log_debug("detected %"PRIu32" L1D caches", cache_counts[cpuinfo_cache_level_1d]);
+	cpuinfo_log_debug("detected %"PRIu32" L2 caches", cache_counts[cpuinfo_cache_level_2]);
+	cpuinfo_log_debug("detected %"PRIu32" L3 caches", cache_counts[cpuinfo_cache_level_3]);
+	cpuinfo_log_debug("detected %"PRIu32" L4 caches", cache_counts[cpuinfo_cache_level_4]);
 
-	linux_cpu_to_core_map = calloc(x86_linux_processors_count, sizeof(struct cpuinfo_core*));
-	if (linux_cpu_to_core_map == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for mapping entries of %"PRIu32" cores",
-			x86_linux_processors_count * sizeof(struct cpuinfo_core*),
-			x86_linux_processors_count);
-		goto cleanup;
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, processors_count, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, cores_count, sizeof(struct cpuinfo_core));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, clusters_count, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset = cpuinfo_arena_reserve(&arena, packages_count, sizeof(struct cpuinfo_package));
+	size_t cache_offsets[cpuinfo_cache_level_max];
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cache_offsets[level] = cpuinfo_arena_reserve(&arena, cache_counts[level], sizeof(struct cpuinfo_cache));
 	}
-
-	cores = calloc(cores_count, sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			cores_count * sizeof(struct cpuinfo_core), cores_count);
+	const size_t linux_cpu_to_processor_map_offset =
+		cpuinfo_arena_reserve(&arena, x86_linux_processors_count, sizeof(struct cpuinfo_processor*));
+	const size_t linux_cpu_to_core_map_offset =
+		cpuinfo_arena_reserve(&arena, x86_linux_processors_count, sizeof(struct cpuinfo_core*));
+	const size_t uarchs_offset =
+		cpuinfo_arena_reserve(&arena, uarch_index_map_count != 0 ? uarchs_count : 0, sizeof(struct cpuinfo_uarch_info));
+	const size_t uarch_tlbs_offset =
+		cpuinfo_arena_reserve(&arena, uarch_index_map_count != 0 ? uarchs_count : 0, sizeof(struct cpuinfo_uarch_tlbs));
+	const size_t linux_cpu_to_uarch_index_map_offset =
+		cpuinfo_arena_reserve(&arena, uarch_index_map_count, sizeof(uint32_t));
+	if (!cpuinfo_arena_allocate(&arena)) {
 		goto cleanup;
 	}
 
-	clusters = calloc(clusters_count, sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" core clusters",
-			clusters_count * sizeof(struct cpuinfo_cluster), clusters_count);
-		goto cleanup;
-	}
-
-	packages = calloc(packages_count, sizeof(struct cpuinfo_package));
-	if (packages == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" physical packages",
-			packages_count * sizeof(struct cpuinfo_package), packages_count);
-		goto cleanup;
-	}
-
-	if (l1i_count != 0) {
-		l1i = calloc(l1i_count, sizeof(struct cpuinfo_cache));
-		if (l1i == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1I caches",
-				l1i_count * sizeof(struct cpuinfo_cache), l1i_count);
-			goto cleanup;
-		}
-	}
-	if (l1d_count != 0) {
-		l1d = calloc(l1d_count, sizeof(struct cpuinfo_cache));
-		if (l1d == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1D caches",
-				l1d_count * sizeof(struct cpuinfo_cache), l1d_count);
-			goto cleanup;
-		}
+	processors = cpuinfo_arena_get(&arena, processors_offset, processors_count);
+	cores = cpuinfo_arena_get(&arena, cores_offset, cores_count);
+	clusters = cpuinfo_arena_get(&arena, clusters_offset, clusters_count);
+	packages = cpuinfo_arena_get(&arena, packages_offset, packages_count);
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		caches[level] = cpuinfo_arena_get(&arena, cache_offsets[level], cache_counts[level]);
 	}
-	if (l2_count != 0) {
-		l2 = calloc(l2_count, sizeof(struct cpuinfo_cache));
-		if (l2 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L2 caches",
-				l2_count * sizeof(struct cpuinfo_cache), l2_count);
-			goto cleanup;
-		}
-	}
-	if (l3_count != 0) {
-		l3 = calloc(l3_count, sizeof(struct cpuinfo_cache));
-		if (l3 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L3 caches",
-				l3_count * sizeof(struct cpuinfo_cache), l3_count);
-			goto cleanup;
-		}
-	}
-	if (l4_count != 0) {
-		l4 = calloc(l4_count, sizeof(struct cpuinfo_cache));
-		if (l4 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L4 caches",
-				l4_count * sizeof(struct cpuinfo_cache), l4_count);
-			goto cleanup;
+	linux_cpu_to_processor_map =
+		cpuinfo_arena_get(&arena, linux_cpu_to_processor_map_offset, x86_linux_processors_count);
+	linux_cpu_to_core_map = cpuinfo_arena_get(&arena, linux_cpu_to_core_map_offset, x86_linux_processors_count);
+	if (uarch_index_map_count != 0) {
+		uarchs = cpuinfo_arena_get(&arena, uarchs_offset, uarchs_count);
+		linux_cpu_to_uarch_index_map =
+			cpuinfo_arena_get(&arena, linux_cpu_to_uarch_index_map_offset, uarch_index_map_count);
+		memcpy(uarchs, uarchs_list, uarchs_count * sizeof(struct cpuinfo_uarch_info));
+		uarch_tlbs = cpuinfo_arena_get(&arena, uarch_tlbs_offset, uarchs_count);
+		for (uint32_t i = 0; i < uarchs_count; i++) {
+			cpuinfo_x86_group_tlbs(&cpuid_records[uarch_cpuid_records[i]].processor.tlb, &uarch_tlbs[i]);
 		}
 	}
 
-	const uint32_t core_apic_mask =
-		~(bit_mask(x86_processor.topology.thread_bits_length) << x86_processor.topology.thread_bits_offset);
-	const uint32_t package_apic_mask =
-		core_apic_mask & ~(bit_mask(x86_processor.topology.core_bits_length) << x86_processor.topology.core_bits_offset);
-	const uint32_t llc_apic_mask = ~bit_mask(llc_apic_bits);
-	const uint32_t cluster_apic_mask = package_apic_mask | llc_apic_mask;
-
 	uint32_t processor_index = UINT32_MAX, core_index = UINT32_MAX, cluster_index = UINT32_MAX, package_index = UINT32_MAX;
-	uint32_t l1i_index = UINT32_MAX, l1d_index = UINT32_MAX, l2_index = UINT32_MAX, l3_index = UINT32_MAX, l4_index = UINT32_MAX;
+	uint32_t cache_indices[cpuinfo_cache_level_max];
+	/* IDs of the last caches, and of the last caches in CPUID to cross-validate sharing of caches from sysfs */
+	uint64_t last_cache_ids[cpuinfo_cache_level_max], last_cpuid_cache_ids[cpuinfo_cache_level_max];
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cache_indices[level] = UINT32_MAX;
+		last_cache_ids[level] = last_cpuid_cache_ids[level] = UINT64_MAX;
+	}
 	uint32_t cluster_id = 0, core_id = 0, smt_id = 0;
 	uint32_t last_apic_core_id = UINT32_MAX, last_apic_cluster_id = UINT32_MAX, last_apic_package_id = UINT32_MAX;
-	uint32_t last_l1i_id = UINT32_MAX, last_l1d_id = UINT32_MAX;
-	uint32_t last_l2_id = UINT32_MAX, last_l3_id = UINT32_MAX, last_l4_id = UINT32_MAX;
+	uint32_t last_cluster_core_type = UINT32_MAX;
+	bool has_sysfs_microcode = true;
 	for (uint32_t i = 0; i < x86_linux_processors_count; i++) {
 		if (bitmask_all(x86_linux_processors[i].flags, CPUINFO_LINUX_FLAG_VALID)) {
 			const uint32_t apic_id = x86_linux_processors[i].apic_id;
+			const uint32_t core_type = x86_linux_processors[i].core_type;
+			const struct cpuinfo_x86_processor* cpuid_processor =
+				&cpuid_records[x86_linux_processors[i].cpuid_record].processor;
+			const enum cpuinfo_uarch uarch =
+				cpuinfo_x86_decode_hybrid_uarch(cpuid_processor->vendor, &cpuid_processor->model_info, core_type);
 			processor_index++;
 			smt_id++;
 
-			/* All bits of APIC ID except thread ID mask */
-			const uint32_t apid_core_id = apic_id & core_apic_mask;
+			const uint32_t apid_core_id = apic_id & get_core_apic_mask(cpuid_processor);
 			if (apid_core_id != last_apic_core_id) {
 				core_index++;
 				core_id++;
 				smt_id = 0;
 			}
-			/* Bits of APIC ID which are part of either LLC or package ID mask */
-			const uint32_t apic_cluster_id = apic_id & cluster_apic_mask;
-			if (apic_cluster_id != last_apic_cluster_id) {
+			/* Cores of a cluster have the same type */
+			const uint32_t apic_cluster_id = apic_id & get_cluster_apic_mask(cpuid_processor);
+			const bool new_cluster = apic_cluster_id != last_apic_cluster_id || core_type != last_cluster_core_type;
+			if (new_cluster) {
 				cluster_index++;
 				cluster_id++;
 			}
 			/* All bits of APIC ID except thread ID and core ID masks */
-			const uint32_t apic_package_id = apic_id & package_apic_mask;
+			const uint32_t apic_package_id = apic_id & get_package_apic_mask(cpuid_processor);
 			if (apic_package_id != last_apic_package_id) {
 				package_index++;
 				core_id = 0;
@@ -395,9 +1097,13 @@ void cpuinfo_x86_linux_init(void) {
 					.core_id = core_id,
 					.cluster = clusters + cluster_index,
 					.package = packages + package_index,
-					.vendor = x86_processor.vendor,
-					.uarch = x86_processor.uarch,
-					.cpuid = x86_processor.cpuid,
+					.vendor = cpuid_processor->vendor,
+					.uarch = uarch,
+					.cpuid = cpuid_processor->cpuid,
+					.microcode_revision = get_microcode_revision(&x86_linux_processors[i], &has_sysfs_microcode),
+					.frequency =
+						get_base_frequency(cpuid_processor, x86_linux_processors[i].linux_id, brand_string_frequency),
+					.max_turbo_frequency = get_max_turbo_frequency(cpuid_processor, x86_linux_processors[i].linux_id),
 				};
 				clusters[cluster_index].core_count += 1;
 				packages[package_index].core_count += 1;
@@ -407,18 +1113,20 @@ void cpuinfo_x86_linux_init(void) {
 				cores[core_index].processor_count++;
 			}
 
-			if (apic_cluster_id != last_apic_cluster_id) {
+			if (new_cluster) {
 				/* new cluster */
 				clusters[cluster_index].processor_start = processor_index;
 				clusters[cluster_index].processor_count = 1;
 				clusters[cluster_index].core_start = core_index;
 				clusters[cluster_index].cluster_id = cluster_id;
 				clusters[cluster_index].package = packages + package_index;
-				clusters[cluster_index].vendor = x86_processor.vendor;
-				clusters[cluster_index].uarch = x86_processor.uarch;
-				clusters[cluster_index].cpuid = x86_processor.cpuid;
+				clusters[cluster_index].vendor = cpuid_processor->vendor;
+				clusters[cluster_index].uarch = uarch;
+				clusters[cluster_index].frequency = cores[core_index].frequency;
+				clusters[cluster_index].cpuid = cpuid_processor->cpuid;
 				packages[package_index].cluster_count += 1;
 				last_apic_cluster_id = apic_cluster_id;
+				last_cluster_core_type = core_type;
 			} else {
 				/* another logical processor on the same cluster */
 				clusters[cluster_index].processor_count++;
@@ -430,7 +1138,7 @@ void cpuinfo_x86_linux_init(void) {
 				packages[package_index].processor_count = 1;
 				packages[package_index].core_start = core_index;
 				packages[package_index].cluster_start = cluster_index;
-				cpuinfo_x86_format_package_name(x86_processor.vendor, brand_string, packages[package_index].name);
+				cpuinfo_x86_format_package_name(x86_processor->vendor, brand_string, packages[package_index].name);
 				last_apic_package_id = apic_package_id;
 			} else {
 				/* another logical processor on the same package */
@@ -439,191 +1147,121 @@ void cpuinfo_x86_linux_init(void) {
 
 			linux_cpu_to_processor_map[x86_linux_processors[i].linux_id] = processors + processor_index;
 			linux_cpu_to_core_map[x86_linux_processors[i].linux_id] = cores + core_index;
-
-			if (x86_processor.cache.l1i.size != 0) {
-				const uint32_t l1i_id = apic_id & ~bit_mask(x86_processor.cache.l1i.apic_bits);
-				processors[i].cache.l1i = &l1i[l1i_index];
-				if (l1i_id != last_l1i_id) {
-					/* new cache */
-					last_l1i_id = l1i_id;
-					l1i[++l1i_index] = (struct cpuinfo_cache) {
-						.size            = x86_processor.cache.l1i.size,
-						.associativity   = x86_processor.cache.l1i.associativity,
-						.sets            = x86_processor.cache.l1i.sets,
-						.partitions      = x86_processor.cache.l1i.partitions,
-						.line_size       = x86_processor.cache.l1i.line_size,
-						.flags           = x86_processor.cache.l1i.flags,
-						.processor_start = processor_index,
-						.processor_count = 1,
-					};
-				} else {
-					/* another processor sharing the same cache */
-					l1i[l1i_index].processor_count += 1;
+			if (uarchs != NULL) {
+				uint32_t uarch_index = find_uarch_index(uarchs_count, uarchs_list, uarch, cpuid_processor->cpuid);
+				if (uarch_index == uarchs_count) {
+					uarch_index = 0;
 				}
-				processors[i].cache.l1i = &l1i[l1i_index];
-			} else {
-				/* reset cache id */
-				last_l1i_id = UINT32_MAX;
+				uarchs[uarch_index].processor_count += 1;
+				uarchs[uarch_index].core_count += (uint32_t) (cores[core_index].processor_start == processor_index);
+				linux_cpu_to_uarch_index_map[x86_linux_processors[i].linux_id] = uarch_index;
 			}
-			if (x86_processor.cache.l1d.size != 0) {
-				const uint32_t l1d_id = apic_id & ~bit_mask(x86_processor.cache.l1d.apic_bits);
-				processors[i].cache.l1d = &l1d[l1d_index];
-				if (l1d_id != last_l1d_id) {
-					/* new cache */
-					last_l1d_id = l1d_id;
-					l1d[++l1d_index] = (struct cpuinfo_cache) {
-						.size            = x86_processor.cache.l1d.size,
-						.associativity   = x86_processor.cache.l1d.associativity,
-						.sets            = x86_processor.cache.l1d.sets,
-						.partitions      = x86_processor.cache.l1d.partitions,
-						.line_size       = x86_processor.cache.l1d.line_size,
-						.flags           = x86_processor.cache.l1d.flags,
-						.processor_start = processor_index,
-						.processor_count = 1,
-					};
-				} else {
-					/* another processor sharing the same cache */
-					l1d[l1d_index].processor_count += 1;
-				}
-				processors[i].cache.l1d = &l1d[l1d_index];
-			} else {
-				/* reset cache id */
-				last_l1d_id = UINT32_MAX;
-			}
-			if (x86_processor.cache.l2.size != 0) {
-				const uint32_t l2_id = apic_id & ~bit_mask(x86_processor.cache.l2.apic_bits);
-				processors[i].cache.l2 = &l2[l2_index];
-				if (l2_id != last_l2_id) {
-					/* new cache */
-					last_l2_id = l2_id;
-					l2[++l2_index] = (struct cpuinfo_cache) {
-						.size            = x86_processor.cache.l2.size,
-						.associativity   = x86_processor.cache.l2.associativity,
-						.sets            = x86_processor.cache.l2.sets,
-						.partitions      = x86_processor.cache.l2.partitions,
-						.line_size       = x86_processor.cache.l2.line_size,
-						.flags           = x86_processor.cache.l2.flags,
-						.processor_start = processor_index,
-						.processor_count = 1,
-					};
-				} else {
-					/* another processor sharing the same cache */
-					l2[l2_index].processor_count += 1;
+
+			for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+				struct cpuinfo_x86_cache cache;
+				uint64_t cache_id;
+				if (!get_processor_cache(
+					&x86_linux_processors[i], cpuid_processor, sysfs_caches, level, &cache, &cache_id))
+				{
+					/* reset cache id */
+					last_cache_ids[level] = UINT64_MAX;
+					continue;
 				}
-				processors[i].cache.l2 = &l2[l2_index];
-			} else {
-				/* reset cache id */
-				last_l2_id = UINT32_MAX;
-			}
-			if (x86_processor.cache.l3.size != 0) {
-				const uint32_t l3_id = apic_id & ~bit_mask(x86_processor.cache.l3.apic_bits);
-				processors[i].cache.l3 = &l3[l3_index];
-				if (l3_id != last_l3_id) {
-					/* new cache */
-					last_l3_id = l3_id;
-					l3[++l3_index] = (struct cpuinfo_cache) {
-						.size            = x86_processor.cache.l3.size,
-						.associativity   = x86_processor.cache.l3.associativity,
-						.sets            = x86_processor.cache.l3.sets,
-						.partitions      = x86_processor.cache.l3.partitions,
-						.line_size       = x86_processor.cache.l3.line_size,
-						.flags           = x86_processor.cache.l3.flags,
+				const bool new_cache = cache_id != last_cache_ids[level];
+				if (new_cache) {
+					last_cache_ids[level] = cache_id;
+					caches[level][++cache_indices[level]] = (struct cpuinfo_cache) {
+						.size            = cache.size,
+						.associativity   = cache.associativity,
+						.sets            = cache.sets,
+						.partitions      = cache.partitions,
+						.line_size       = cache.line_size,
+						.flags           = cache.flags,
 						.processor_start = processor_index,
 						.processor_count = 1,
 					};
 				} else {
-					/* another processor sharing the same cache */
-					l3[l3_index].processor_count += 1;
+					caches[level][cache_indices[level]].processor_count += 1;
 				}
-				processors[i].cache.l3 = &l3[l3_index];
-			} else {
-				/* reset cache id */
-				last_l3_id = UINT32_MAX;
-			}
-			if (x86_processor.cache.l4.size != 0) {
-				const uint32_t l4_id = apic_id & ~bit_mask(x86_processor.cache.l4.apic_bits);
-				processors[i].cache.l4 = &l4[l4_index];
-				if (l4_id != last_l4_id) {
-					/* new cache */
-					last_l4_id = l4_id;
-					l4[++l4_index] = (struct cpuinfo_cache) {
-						.size            = x86_processor.cache.l4.size,
-						.associativity   = x86_processor.cache.l4.associativity,
-						.sets            = x86_processor.cache.l4.sets,
-						.partitions      = x86_processor.cache.l4.partitions,
-						.line_size       = x86_processor.cache.l4.line_size,
-						.flags           = x86_processor.cache.l4.flags,
-						.processor_start = processor_index,
-						.processor_count = 1,
-					};
-				} else {
-					/* another processor sharing the same cache */
-					l4[l4_index].processor_count += 1;
+				set_processor_cache(&processors[processor_index], level, &caches[level][cache_indices[level]]);
+
+				const struct cpuinfo_x86_cache* cpuid_cache = get_cpuid_cache(cpuid_processor, level);
+				if (x86_linux_processors[i].sysfs_cache_indices != 0 && cpuid_cache->size != 0) {
+					const uint64_t cpuid_cache_id = (uint64_t) (apic_id & ~bit_mask(cpuid_cache->apic_bits));
+					if (new_cache != (cpuid_cache_id != last_cpuid_cache_ids[level])) {
+						cpuinfo_log_debug("processor %"PRIu32": sysfs and CPUID report different sharing of %s cache",
+							x86_linux_processors[i].linux_id, cache_level_names[level]);
+					}
+					last_cpuid_cache_ids[level] = cpuid_cache_id;
 				}
-				processors[i].cache.l4 = &l4[l4_index];
-			} else {
-				/* reset cache id */
-				last_l4_id = UINT32_MAX;
 			}
 		}
 	}
 
+	for (uint32_t i = 1; i < cores_count; i++) {
+		if (cores[i].microcode_revision != cores[0].microcode_revision) {
+			cpuinfo_log_warning("mixed microcode revisions: core %"PRIu32" has 0x%"PRIx32", core 0 has 0x%"PRIx32,
+				i, cores[i].microcode_revision, cores[0].microcode_revision);
+			break;
+		}
+	}
+
+	#if CPUINFO_MOCK
+		const enum cpuinfo_linux_current_cpu_method current_cpu_method = cpuinfo_linux_current_cpu_method_syscall;
+	#else
+		const enum cpuinfo_linux_current_cpu_method current_cpu_method =
+			detect_current_cpu_method(x86_linux_processors_count);
+	#endif
+	cpuinfo_record_init_phase(cpuinfo_init_phase_tables, &phase_start);
+
 	/* Commit changes */
 	cpuinfo_processors = processors;
 	cpuinfo_cores = cores;
 	cpuinfo_clusters = clusters;
 	cpuinfo_packages = packages;
-	cpuinfo_cache[cpuinfo_cache_level_1i] = l1i;
-	cpuinfo_cache[cpuinfo_cache_level_1d] = l1d;
-	cpuinfo_cache[cpuinfo_cache_level_2]  = l2;
-	cpuinfo_cache[cpuinfo_cache_level_3]  = l3;
-	cpuinfo_cache[cpuinfo_cache_level_4]  = l4;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache[level] = caches[level];
+	}
 
 	cpuinfo_processors_count = processors_count;
 	cpuinfo_cores_count = cores_count;
 	cpuinfo_clusters_count = clusters_count;
 	cpuinfo_packages_count = packages_count;
-	cpuinfo_cache_count[cpuinfo_cache_level_1i] = l1i_count;
-	cpuinfo_cache_count[cpuinfo_cache_level_1d] = l1d_count;
-	cpuinfo_cache_count[cpuinfo_cache_level_2]  = l2_count;
-	cpuinfo_cache_count[cpuinfo_cache_level_3]  = l3_count;
-	cpuinfo_cache_count[cpuinfo_cache_level_4]  = l4_count;
+	for (uint32_t level = 0; level < cpuinfo_cache_level_max; level++) {
+		cpuinfo_cache_count[level] = cache_counts[level];
+	}
 	cpuinfo_max_cache_size = cpuinfo_compute_max_cache_size(&processors[0]);
 
 	cpuinfo_global_uarch = (struct cpuinfo_uarch_info) {
-		.uarch = x86_processor.uarch,
-		.cpuid = x86_processor.cpuid,
+		.uarch = x86_processor->uarch,
+		.cpuid = x86_processor->cpuid,
 		.processor_count = processors_count,
 		.core_count = cores_count,
 	};
+	cpuinfo_x86_group_tlbs(&x86_processor->tlb, &cpuinfo_global_uarch_tlbs);
 
 	cpuinfo_linux_cpu_max = x86_linux_processors_count;
+	cpuinfo_linux_current_cpu_method = current_cpu_method;
 	cpuinfo_linux_cpu_to_processor_map = linux_cpu_to_processor_map;
 	cpuinfo_linux_cpu_to_core_map = linux_cpu_to_core_map;
+	if (uarchs != NULL) {
+		cpuinfo_uarchs = uarchs;
+		cpuinfo_uarchs_count = uarchs_count;
+		cpuinfo_uarch_tlbs = uarch_tlbs;
+		cpuinfo_linux_cpu_to_uarch_index_map = linux_cpu_to_uarch_index_map;
+	}
+
+	cpuinfo_arena_memory = arena.memory;
 
 	__sync_synchronize();
 
 	cpuinfo_is_initialized = true;
 
-	processors = NULL;
-	cores = NULL;
-	clusters = NULL;
-	packages = NULL;
-	l1i = l1d = l2 = l3 = l4 = NULL;
-	linux_cpu_to_processor_map = NULL;
-	linux_cpu_to_core_map = NULL;
+	arena.memory = NULL;
 
 cleanup:
-	free(x86_linux_processors);
-	free(processors);
-	free(cores);
-	free(clusters);
-	free(packages);
-	free(l1i);
-	free(l1d);
-	free(l2);
-	free(l3);
-	free(l4);
-	free(linux_cpu_to_processor_map);
-	free(linux_cpu_to_core_map);
+	cpuinfo_linux_release_sysfs();
+	cpuinfo_free_temporary(x86_linux_processors);
+	cpuinfo_free_temporary(sysfs_caches);
+	cpuinfo_arena_free(arena.memory);
 }
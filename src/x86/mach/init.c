@@ -1,6 +1,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+
+#include <sys/types.h>
+#include <sys/sysctl.h>
 
 #include <cpuinfo.h>
 #include <x86/api.h>
@@ -17,43 +21,47 @@ static inline uint32_t bit_mask(uint32_t bits) {
 	return (UINT32_C(1) << bits) - UINT32_C(1);
 }
 
-void cpuinfo_x86_mach_init(void) {
-	struct cpuinfo_processor* processors = NULL;
-	struct cpuinfo_core* cores = NULL;
-	struct cpuinfo_cluster* clusters = NULL;
-	struct cpuinfo_package* packages = NULL;
-	struct cpuinfo_cache* l1i = NULL;
-	struct cpuinfo_cache* l1d = NULL;
-	struct cpuinfo_cache* l2 = NULL;
-	struct cpuinfo_cache* l3 = NULL;
-	struct cpuinfo_cache* l4 = NULL;
+static uint64_t get_sysctl_uint64(const char* name) {
+	/* Some of the sysctls are 32-bit on older kernels: they fill the low half of the value on little-endian x86 */
+	uint64_t value = 0;
+	size_t size = sizeof(value);
+	if (sysctlbyname(name, &value, &size, NULL, 0) != 0) {
+		cpuinfo_log_info("sysctlbyname(\"%s\") failed: %s", name, strerror(errno));
+		return 0;
+	}
+	return value;
+}
 
-	struct cpuinfo_mach_topology mach_topology = cpuinfo_mach_detect_topology();
-	processors = calloc(mach_topology.threads, sizeof(struct cpuinfo_processor));
-	if (processors == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
-			mach_topology.threads * sizeof(struct cpuinfo_processor), mach_topology.threads);
-		goto cleanup;
+/* Prefer the cache size of the kernel, e.g. when a hypervisor reports a different or no cache in CPUID */
+static void correct_cache_size(struct cpuinfo_x86_cache* cache, uint64_t size, uint32_t line_size, const char* name) {
+	if (size == 0 || size > UINT32_MAX || size == cache->size) {
+		return;
 	}
-	cores = calloc(mach_topology.cores, sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			mach_topology.cores * sizeof(struct cpuinfo_core), mach_topology.cores);
-		goto cleanup;
+	cpuinfo_log_debug("using %s of %"PRIu64" bytes instead of %"PRIu32" bytes reported in CPUID",
+		name, size, cache->size);
+	cache->size = (uint32_t) size;
+	if (cache->line_size == 0) {
+		cache->line_size = line_size;
 	}
-	/* On x86 cluster of cores is a physical package */
-	clusters = calloc(mach_topology.packages, sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" core clusters",
-			mach_topology.packages * sizeof(struct cpuinfo_cluster), mach_topology.packages);
-		goto cleanup;
+	if (cache->partitions == 0) {
+		cache->partitions = 1;
+	}
+	if (cache->associativity != 0 && cache->line_size != 0) {
+		cache->sets = cache->size / (cache->associativity * cache->line_size * cache->partitions);
 	}
-	packages = calloc(mach_topology.packages, sizeof(struct cpuinfo_package));
-	if (packages == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" physical packages",
-			mach_topology.packages * sizeof(struct cpuinfo_package), mach_topology.packages);
-		goto cleanup;
+}
+
+/* Number of logical processors sharing a cache level per hw.cacheconfig, or 0 if it is unknown or inconsistent */
+static uint32_t get_threads_per_cache(const struct cpuinfo_mach_topology topology[restrict static 1], uint32_t level) {
+	const uint32_t threads_per_cache = topology->threads_per_cache[level];
+	if (threads_per_cache == 0 || threads_per_cache > topology->threads || topology->threads % threads_per_cache != 0) {
+		return 0;
 	}
+	return threads_per_cache;
+}
+
+void cpuinfo_x86_mach_init(void) {
+	struct cpuinfo_mach_topology mach_topology = cpuinfo_mach_detect_topology();
 
 	struct cpuinfo_x86_processor x86_processor;
 	memset(&x86_processor, 0, sizeof(x86_processor));
@@ -61,6 +69,108 @@ void cpuinfo_x86_mach_init(void) {
 	char brand_string[48];
 	cpuinfo_x86_normalize_brand_string(x86_processor.brand_string, brand_string);
 
+	/* CPUID describes only the processor which runs the initialization; the kernel reports the whole system */
+	const uint32_t cacheline_size = (uint32_t) get_sysctl_uint64("hw.cachelinesize");
+	correct_cache_size(&x86_processor.cache.l2, get_sysctl_uint64("hw.l2cachesize"), cacheline_size, "hw.l2cachesize");
+	correct_cache_size(&x86_processor.cache.l3, get_sysctl_uint64("hw.l3cachesize"), cacheline_size, "hw.l3cachesize");
+	const uint64_t frequency = get_sysctl_uint64("hw.cpufrequency");
+	/* Intel Macs report the nominal frequency as the maximum one unless the kernel knows the Turbo frequency */
+	const uint64_t max_frequency = get_sysctl_uint64("hw.cpufrequency_max");
+
+	uint32_t threads_per_l1 = 0, l1_count = 0;
+	if (x86_processor.cache.l1i.size != 0 || x86_processor.cache.l1d.size != 0) {
+		threads_per_l1 = get_threads_per_cache(&mach_topology, 1);
+		if (threads_per_l1 == 0) {
+			/* Assume that threads on the same core share L1 */
+			threads_per_l1 = mach_topology.threads / mach_topology.cores;
+			cpuinfo_log_warning("Mach kernel did not report valid number of threads sharing L1 cache; assume %"PRIu32,
+				threads_per_l1);
+		}
+		l1_count = mach_topology.threads / threads_per_l1;
+		cpuinfo_log_debug("detected %"PRIu32" L1 caches", l1_count);
+	}
+
+	uint32_t threads_per_l2 = 0, l2_count = 0;
+	if (x86_processor.cache.l2.size != 0) {
+		threads_per_l2 = get_threads_per_cache(&mach_topology, 2);
+		if (threads_per_l2 == 0) {
+			if (x86_processor.cache.l3.size != 0) {
+				/* This is not a last-level cache; assume that threads on the same core share L2 */
+				threads_per_l2 = mach_topology.threads / mach_topology.cores;
+			} else {
+				/* This is a last-level cache; assume that threads on the same package share L2 */
+				threads_per_l2 = mach_topology.threads / mach_topology.packages;
+			}
+			cpuinfo_log_warning("Mach kernel did not report valid number of threads sharing L2 cache; assume %"PRIu32,
+				threads_per_l2);
+		}
+		l2_count = mach_topology.threads / threads_per_l2;
+		cpuinfo_log_debug("detected %"PRIu32" L2 caches", l2_count);
+	}
+
+	uint32_t threads_per_l3 = 0, l3_count = 0;
+	if (x86_processor.cache.l3.size != 0) {
+		threads_per_l3 = get_threads_per_cache(&mach_topology, 3);
+		if (threads_per_l3 == 0) {
+			/*
+			 * Assume that threads on the same package share L3.
+			 * However, is it not necessarily the last-level cache (there may be L4 cache as well)
+			 */
+			threads_per_l3 = mach_topology.threads / mach_topology.packages;
+			cpuinfo_log_warning("Mach kernel did not report valid number of threads sharing L3 cache; assume %"PRIu32,
+				threads_per_l3);
+		}
+		l3_count = mach_topology.threads / threads_per_l3;
+		cpuinfo_log_debug("detected %"PRIu32" L3 caches", l3_count);
+	}
+
+	uint32_t threads_per_l4 = 0, l4_count = 0;
+	if (x86_processor.cache.l4.size != 0) {
+		threads_per_l4 = get_threads_per_cache(&mach_topology, 4);
+		if (threads_per_l4 == 0) {
+			/*
+			 * Assume that all threads share this L4.
+			 * As of now, L4 cache exists only on notebook x86 CPUs, which are single-package,
+			 * but multi-socket systems could have shared L4 (like on IBM POWER8).
+			 */
+			threads_per_l4 = mach_topology.threads;
+			cpuinfo_log_warning("Mach kernel did not report valid number of threads sharing L4 cache; assume %"PRIu32,
+				threads_per_l4);
+		}
+		l4_count = mach_topology.threads / threads_per_l4;
+		cpuinfo_log_debug("detected %"PRIu32" L4 caches", l4_count);
+	}
+
+	struct cpuinfo_arena arena = { NULL, 0 };
+	const size_t processors_offset =
+		cpuinfo_arena_reserve(&arena, mach_topology.threads, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, mach_topology.cores, sizeof(struct cpuinfo_core));
+	/* On x86 cluster of cores is a physical package */
+	const size_t clusters_offset =
+		cpuinfo_arena_reserve(&arena, mach_topology.packages, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset =
+		cpuinfo_arena_reserve(&arena, mach_topology.packages, sizeof(struct cpuinfo_package));
+	const uint32_t l1i_count = x86_processor.cache.l1i.size != 0 ? l1_count : 0;
+	const uint32_t l1d_count = x86_processor.cache.l1d.size != 0 ? l1_count : 0;
+	const size_t l1i_offset = cpuinfo_arena_reserve(&arena, l1i_count, sizeof(struct cpuinfo_cache));
+	const size_t l1d_offset = cpuinfo_arena_reserve(&arena, l1d_count, sizeof(struct cpuinfo_cache));
+	const size_t l2_offset = cpuinfo_arena_reserve(&arena, l2_count, sizeof(struct cpuinfo_cache));
+	const size_t l3_offset = cpuinfo_arena_reserve(&arena, l3_count, sizeof(struct cpuinfo_cache));
+	const size_t l4_offset = cpuinfo_arena_reserve(&arena, l4_count, sizeof(struct cpuinfo_cache));
+	if (!cpuinfo_arena_allocate(&arena)) {
+		return;
+	}
+
+	struct cpuinfo_processor* processors = cpuinfo_arena_get(&arena, processors_offset, mach_topology.threads);
+	struct cpuinfo_core* cores = cpuinfo_arena_get(&arena, cores_offset, mach_topology.cores);
+	struct cpuinfo_cluster* clusters = cpuinfo_arena_get(&arena, clusters_offset, mach_topology.packages);
+	struct cpuinfo_package* packages = cpuinfo_arena_get(&arena, packages_offset, mach_topology.packages);
+	struct cpuinfo_cache* l1i = cpuinfo_arena_get(&arena, l1i_offset, l1i_count);
+	struct cpuinfo_cache* l1d = cpuinfo_arena_get(&arena, l1d_offset, l1d_count);
+	struct cpuinfo_cache* l2 = cpuinfo_arena_get(&arena, l2_offset, l2_count);
+	struct cpuinfo_cache* l3 = cpuinfo_arena_get(&arena, l3_offset, l3_count);
+	struct cpuinfo_cache* l4 = cpuinfo_arena_get(&arena, l4_offset, l4_count);
+
 	const uint32_t threads_per_core = mach_topology.threads / mach_topology.cores;
 	const uint32_t threads_per_package = mach_topology.threads / mach_topology.packages;
 	const uint32_t cores_per_package = mach_topology.cores / mach_topology.packages;
@@ -75,6 +185,7 @@ void cpuinfo_x86_mach_init(void) {
 			.vendor = x86_processor.vendor,
 			.uarch = x86_processor.uarch,
 			.cpuid = x86_processor.cpuid,
+			.frequency = frequency,
 		};
 		packages[i].processor_start = i * threads_per_package;
 		packages[i].processor_count = threads_per_package;
@@ -94,6 +205,8 @@ void cpuinfo_x86_mach_init(void) {
 			.vendor = x86_processor.vendor,
 			.uarch = x86_processor.uarch,
 			.cpuid = x86_processor.cpuid,
+			.frequency = frequency,
+			.max_turbo_frequency = max_frequency > frequency ? max_frequency : 0,
 		};
 	}
 	for (uint32_t i = 0; i < mach_topology.threads; i++) {
@@ -120,77 +233,7 @@ void cpuinfo_x86_mach_init(void) {
 		processors[i].apic_id = apic_id;
 	}
 
-	uint32_t threads_per_l1 = 0, l1_count = 0;
-	if (x86_processor.cache.l1i.size != 0 || x86_processor.cache.l1d.size != 0) {
-		threads_per_l1 = mach_topology.threads_per_cache[1];
-		if (threads_per_l1 == 0) {
-			/* Assume that threads on the same core share L1 */
-			threads_per_l1 = mach_topology.threads / mach_topology.cores;
-			cpuinfo_log_warning("Mach kernel did not report number of threads sharing L1 cache; assume %"PRIu32,
-				threads_per_l1);
-		}
-		l1_count = mach_topology.threads / threads_per_l1;
-		cpuinfo_log_debug("detected %"PRIu32" L1 caches", l1_count);
-	}
-
-	uint32_t threads_per_l2 = 0, l2_count = 0;
-	if (x86_processor.cache.l2.size != 0) {
-		threads_per_l2 = mach_topology.threads_per_cache[2];
-		if (threads_per_l2 == 0) {
-			if (x86_processor.cache.l3.size != 0) {
-				/* This is not a last-level cache; assume that threads on the same core share L2 */
-				threads_per_l2 = mach_topology.threads / mach_topology.cores;
-			} else {
-				/* This is a last-level cache; assume that threads on the same package share L2 */
-				threads_per_l2 = mach_topology.threads / mach_topology.packages;
-			}
-			cpuinfo_log_warning("Mach kernel did not report number of threads sharing L2 cache; assume %"PRIu32,
-				threads_per_l2);
-		}
-		l2_count = mach_topology.threads / threads_per_l2;
-		cpuinfo_log_debug("detected %"PRIu32" L2 caches", l2_count);
-	}
-
-	uint32_t threads_per_l3 = 0, l3_count = 0;
-	if (x86_processor.cache.l3.size != 0) {
-		threads_per_l3 = mach_topology.threads_per_cache[3];
-		if (threads_per_l3 == 0) {
-			/*
-			 * Assume that threads on the same package share L3.
-			 * However, is it not necessarily the last-level cache (there may be L4 cache as well)
-			 */
-			threads_per_l3 = mach_topology.threads / mach_topology.packages;
-			cpuinfo_log_warning("Mach kernel did not report number of threads sharing L3 cache; assume %"PRIu32,
-				threads_per_l3);
-		}
-		l3_count = mach_topology.threads / threads_per_l3;
-		cpuinfo_log_debug("detected %"PRIu32" L3 caches", l3_count);
-	}
-
-	uint32_t threads_per_l4 = 0, l4_count = 0;
-	if (x86_processor.cache.l4.size != 0) {
-		threads_per_l4 = mach_topology.threads_per_cache[4];
-		if (threads_per_l4 == 0) {
-			/*
-			 * Assume that all threads share this L4.
-			 * As of now, L4 cache exists only on notebook x86 CPUs, which are single-package,
-			 * but multi-socket systems could have shared L4 (like on IBM POWER8).
-			 */
-			threads_per_l4 = mach_topology.threads;
-			cpuinfo_log_warning("Mach kernel did not report number of threads sharing L4 cache; assume %"PRIu32,
-				threads_per_l4);
-		}
-		l4_count = mach_topology.threads / threads_per_l4;
-		cpuinfo_log_debug("detected %"PRIu32" L4 caches", l4_count);
-	}
-
 	if (x86_processor.cache.l1i.size != 0) {
-		l1i = calloc(l1_count, sizeof(struct cpuinfo_cache));
-		if (l1i == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1I caches",
-				l1_count * sizeof(struct cpuinfo_cache), l1_count);
-			return;
-		}
 		for (uint32_t c = 0; c < l1_count; c++) {
 			l1i[c] = (struct cpuinfo_cache) {
 				.size            = x86_processor.cache.l1i.size,
@@ -209,12 +252,6 @@ void cpuinfo_x86_mach_init(void) {
 	}
 
 	if (x86_processor.cache.l1d.size != 0) {
-		l1d = calloc(l1_count, sizeof(struct cpuinfo_cache));
-		if (l1d == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1D caches",
-				l1_count * sizeof(struct cpuinfo_cache), l1_count);
-			return;
-		}
 		for (uint32_t c = 0; c < l1_count; c++) {
 			l1d[c] = (struct cpuinfo_cache) {
 				.size            = x86_processor.cache.l1d.size,
@@ -233,12 +270,6 @@ void cpuinfo_x86_mach_init(void) {
 	}
 
 	if (l2_count != 0) {
-		l2 = calloc(l2_count, sizeof(struct cpuinfo_cache));
-		if (l2 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L2 caches",
-				l2_count * sizeof(struct cpuinfo_cache), l2_count);
-			return;
-		}
 		for (uint32_t c = 0; c < l2_count; c++) {
 			l2[c] = (struct cpuinfo_cache) {
 				.size            = x86_processor.cache.l2.size,
@@ -257,12 +288,6 @@ void cpuinfo_x86_mach_init(void) {
 	}
 
 	if (l3_count != 0) {
-		l3 = calloc(l3_count, sizeof(struct cpuinfo_cache));
-		if (l3 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L3 caches",
-				l3_count * sizeof(struct cpuinfo_cache), l3_count);
-			return;
-		}
 		for (uint32_t c = 0; c < l3_count; c++) {
 			l3[c] = (struct cpuinfo_cache) {
 				.size            = x86_processor.cache.l3.size,
@@ -281,12 +306,6 @@ void cpuinfo_x86_mach_init(void) {
 	}
 
 	if (l4_count != 0) {
-		l4 = calloc(l4_count, sizeof(struct cpuinfo_cache));
-		if (l4 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L4 caches",
-				l4_count * sizeof(struct cpuinfo_cache), l4_count);
-			return;
-		}
 		for (uint32_t c = 0; c < l4_count; c++) {
 			l4[c] = (struct cpuinfo_cache) {
 				.size            = x86_processor.cache.l4.size,
@@ -332,25 +351,11 @@ void cpuinfo_x86_mach_init(void) {
 		.processor_count = mach_topology.threads,
 		.core_count = mach_topology.cores,
 	};
+	cpuinfo_x86_group_tlbs(&x86_processor.tlb, &cpuinfo_global_uarch_tlbs);
+
+	cpuinfo_arena_memory = arena.memory;
 
 	__sync_synchronize();
 
 	cpuinfo_is_initialized = true;
-
-	processors = NULL;
-	cores = NULL;
-	clusters = NULL;
-	packages = NULL;
-	l1i = l1d = l2 = l3 = l4 = NULL;
-
-cleanup:
-	free(processors);
-	free(cores);
-	free(clusters);
-	free(packages);
-	free(l1i);
-	free(l1d);
-	free(l2);
-	free(l3);
-	free(l4);
 }
@@ -706,3 +706,55 @@ uint32_t cpuinfo_x86_format_package_name(
 		return (uint32_t) strlen(vendor_string) + 1;
 	}
 }
+
+uint64_t cpuinfo_x86_parse_brand_string_frequency(const char raw_name[48]) {
+	/* Frequency is the last token in the brand string, e.g. "Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz" */
+	const char* name_end = &raw_name[48];
+	while (name_end != raw_name && (name_end[-1] == '\0' || name_end[-1] == ' ')) {
+		name_end--;
+	}
+	const char* token_start = name_end;
+	while (token_start != raw_name && token_start[-1] != ' ' && token_start[-1] != '@') {
+		token_start--;
+	}
+	if (!is_frequency(token_start, name_end)) {
+		return 0;
+	}
+
+	uint64_t multiplier;
+	switch (name_end[-3]) {
+		case 'K':
+			multiplier = UINT64_C(1000);
+			break;
+		case 'M':
+			multiplier = UINT64_C(1000000);
+			break;
+		default:
+			multiplier = UINT64_C(1000000000);
+			break;
+	}
+
+	/* Decimal number with an optional fractional part, e.g. "3.20" */
+	uint64_t mantissa = 0, divisor = 1;
+	bool fraction = false, digits = false;
+	for (const char* char_ptr = token_start; char_ptr != name_end - 3; char_ptr++) {
+		if (is_digit(*char_ptr)) {
+			if (mantissa > UINT64_MAX / 10 / multiplier) {
+				return 0;
+			}
+			mantissa = mantissa * 10 + (uint64_t) (*char_ptr - '0');
+			digits = true;
+			if (fraction) {
+				divisor *= 10;
+			}
+		} else if (*char_ptr == '.' && !fraction) {
+			fraction = true;
+		} else {
+			return 0;
+		}
+	}
+	if (!digits) {
+		return 0;
+	}
+	return mantissa * multiplier / divisor;
+}
@@ -8,12 +8,111 @@
 #include <x86/cpuid.h>
 
 
+/* Level types in extended topology leafs 0xB and 0x1F */
 enum topology_type {
-	topology_type_invalid = 0,
-	topology_type_smt     = 1,
-	topology_type_core    = 2,
+	topology_type_invalid   = 0,
+	topology_type_smt       = 1,
+	topology_type_core      = 2,
+	topology_type_module    = 3,
+	topology_type_tile      = 4,
+	topology_type_die       = 5,
+	topology_type_die_group = 6,
 };
 
+/* Level types in AMD extended CPU topology leaf 0x80000026 */
+enum amd_topology_type {
+	amd_topology_type_invalid = 0,
+	amd_topology_type_core    = 1,
+	amd_topology_type_complex = 2,
+	amd_topology_type_die     = 3,
+	amd_topology_type_socket  = 4,
+};
+
+/* Topology leafs have a few levels, and the loop over levels must terminate even if CPUID is bogus */
+#define MAX_TOPOLOGY_LEVELS 8
+
+/*
+ * Decode topology leaf 0xB, 0x1F, or 0x80000026. In all of them, the shift of a level is the number of low bits in
+ * x2APIC ID which identify the logical processor within the next level, and the APIC ID bits between the shifts of
+ * two consecutive levels identify the upper level within the lower one. Intel leafs name the lower level (e.g. SMT
+ * level carries the shift to core ID), while AMD leaf 0x80000026 names the upper level (e.g. core level carries the
+ * shift to core ID), so AMD level types are decoded as the next Intel level type.
+ * Returns false if the leaf reports no valid levels.
+ */
+static bool decode_topology_leaf(uint32_t leaf, bool amd_levels, struct cpuinfo_x86_topology* topology) {
+	uint32_t level = 0;
+	uint32_t last_shift = 0;
+	uint32_t apic_id = 0;
+	for (; level < MAX_TOPOLOGY_LEVELS; level++) {
+		const struct cpuid_regs regs = cpuidex(leaf, level);
+		uint32_t type = (regs.ecx >> 8) & UINT32_C(0x000000FF);
+		if (type == topology_type_invalid) {
+			break;
+		}
+		if (amd_levels) {
+			switch (type) {
+				case amd_topology_type_core:
+					type = topology_type_smt;
+					break;
+				case amd_topology_type_complex:
+					type = topology_type_core;
+					break;
+				case amd_topology_type_die:
+					type = topology_type_module;
+					break;
+				case amd_topology_type_socket:
+					type = topology_type_die;
+					break;
+			}
+		}
+		const uint32_t shift = regs.eax & UINT32_C(0x0000001F);
+		const uint32_t offset = last_shift;
+		const uint32_t length = shift > last_shift ? shift - last_shift : 0;
+		apic_id = regs.edx;
+		cpuinfo_log_debug("leaf 0x%08"PRIx32" level %"PRIu32": x2APIC ID = %08"PRIx32", type %"PRIu32", shift %"PRIu32,
+			leaf, level, apic_id, type, shift);
+		switch (type) {
+			case topology_type_smt:
+				topology->thread_bits_offset = offset;
+				topology->thread_bits_length = length;
+				break;
+			case topology_type_core:
+				/* Bits of higher levels within the package are added to the core bits below */
+				break;
+			case topology_type_module:
+				topology->module_bits_offset = offset;
+				topology->module_bits_length = length;
+				break;
+			case topology_type_tile:
+				topology->tile_bits_offset = offset;
+				topology->tile_bits_length = length;
+				break;
+			case topology_type_die:
+			case topology_type_die_group:
+				/* Die groups are reported as a part of the die ID */
+				if (topology->die_bits_length == 0) {
+					topology->die_bits_offset = offset;
+				}
+				topology->die_bits_length += length;
+				break;
+			default:
+				cpuinfo_log_warning("unexpected topology type %"PRIu32" (offset %"PRIu32", length %"PRIu32") "
+					"reported in leaf 0x%08"PRIx32" is ignored", type, offset, length, leaf);
+				break;
+		}
+		last_shift = shift > last_shift ? shift : last_shift;
+	}
+	if (level == 0) {
+		return false;
+	}
+
+	/* Core ID within a package spans all levels between threads and the package */
+	topology->core_bits_offset = topology->thread_bits_offset + topology->thread_bits_length;
+	topology->core_bits_length = last_shift - topology->core_bits_offset;
+	topology->apic_id = apic_id;
+	return true;
+}
+
 void cpuinfo_x86_detect_topology(
 	uint32_t max_base_index,
 	uint32_t max_extended_index,
@@ -80,48 +179,42 @@ void cpuinfo_x86_detect_topology(
 	 * - Intel: ecx[bit 21] in basic info (reserved bit on AMD CPUs).
 	 */
 	const bool x2apic = !!(leaf1.ecx & UINT32_C(0x00200000));
-	if (x2apic && (max_base_index >= UINT32_C(0xB))) {
-		uint32_t level = 0;
-		uint32_t type;
-		uint32_t total_shift = 0;
-		topology->thread_bits_offset = topology->thread_bits_length  = 0;
-		topology->core_bits_offset   = topology->core_bits_length = 0;
-		do {
-			const struct cpuid_regs leafB = cpuidex(UINT32_C(0xB), level);
-			type = (leafB.ecx >> 8) & UINT32_C(0x000000FF);
-			const uint32_t level_shift = leafB.eax & UINT32_C(0x0000001F);
-			const uint32_t x2apic_id   = leafB.edx;
-			apic_id = x2apic_id;
-			switch (type) {
-				case topology_type_invalid:
-					break;
-				case topology_type_smt:
-					cpuinfo_log_debug("x2 level %"PRIu32": APIC ID = %08"PRIx32", "
-						"type SMT, shift %"PRIu32", total shift %"PRIu32,
-						level, apic_id, level_shift, total_shift);
-					topology->thread_bits_offset = total_shift;
-					topology->thread_bits_length = level_shift;
-					break;
-				case topology_type_core:
-					cpuinfo_log_debug("x2 level %"PRIu32": APIC ID = %08"PRIx32", "
-						"type core, shift %"PRIu32", total shift %"PRIu32,
-						level, apic_id, level_shift, total_shift);
-					topology->core_bits_offset = total_shift;
-					topology->core_bits_length = level_shift;
-					break;
-				default:
-					cpuinfo_log_warning("unexpected topology type %"PRIu32" (offset %"PRIu32", length %"PRIu32") "
-						"reported in leaf 0x0000000B is ignored", type, total_shift, level_shift);
-					break;
-			}
-			total_shift += level_shift;
-			level += 1;
-		} while (type != 0);
-		cpuinfo_log_debug("x2APIC ID 0x%08"PRIx32", "
-			"SMT offset %"PRIu32" length %"PRIu32", core offset %"PRIu32" length %"PRIu32, apic_id,
-			topology->thread_bits_offset, topology->thread_bits_length,
-			topology->core_bits_offset, topology->core_bits_length);
+	topology->apic_id = apic_id;
+	struct cpuinfo_x86_topology extended_topology = { 0 };
+	if (x2apic && max_base_index >= UINT32_C(0x1F) && decode_topology_leaf(UINT32_C(0x1F), false, &extended_topology)) {
+		*topology = extended_topology;
+	} else if (max_extended_index >= UINT32_C(0x80000026) &&
+		decode_topology_leaf(UINT32_C(0x80000026), true, &extended_topology))
+	{
+		*topology = extended_topology;
+	} else if (x2apic && max_base_index >= UINT32_C(0xB) && decode_topology_leaf(UINT32_C(0xB), false, &extended_topology)) {
+		*topology = extended_topology;
 	}
 
-	topology->apic_id = apic_id;
-}
+	if (topology->die_bits_length == 0 && max_extended_index >= UINT32_C(0x8000001E)) {
+		/*
+		 * TopologyExtensions: indicates support for leaf 0x8000001E.
+		 * - AMD: ecx[bit 22] in extended info (reserved bit on Intel CPUs).
+		 */
+		const bool topology_extensions = !!(cpuid(UINT32_C(0x80000001)).ecx & UINT32_C(0x00400000));
+		if (topology_extensions) {
+			/*
+			 * NodesPerProcessor: number of nodes (dies) in the processor - 1.
+			 * - AMD: ecx[bits 8-10] in leaf 0x8000001E.
+			 * Node ID occupies the highest bits of the core ID within the package.
+			 */
+			const uint32_t nodes_per_processor = 1 + ((cpuid(UINT32_C(0x8000001E)).ecx >> 8) & UINT32_C(0x00000007));
+			const uint32_t die_bits_length = bit_length(nodes_per_processor);
+			if (nodes_per_processor > 1 && die_bits_length <= topology->core_bits_length) {
+				topology->die_bits_length = die_bits_length;
+				topology->die_bits_offset = topology->core_bits_offset + topology->core_bits_length - die_bits_length;
+			}
+		}
+	}
+	cpuinfo_log_debug("APIC ID 0x%08"PRIx32", SMT offset %"PRIu32" length %"PRIu32", core offset %"PRIu32" length %"PRIu32", "
+		"module offset %"PRIu32" length %"PRIu32", die offset %"PRIu32" length %"PRIu32, topology->apic_id,
+		topology->thread_bits_offset, topology->thread_bits_length,
+		topology->core_bits_offset, topology->core_bits_length,
+		topology->module_bits_offset, topology->module_bits_length,
+		topology->die_bits_offset, topology->die_bits_length);
+}
\ No newline at end of file
@@ -1,243 +1,386 @@
 #include <stdint.h>
 
 #include <cpuinfo.h>
+#include <cpuinfo/common.h>
+#include <cpuinfo/internal-api.h>
 #include <x86/api.h>
 
 
-enum cpuinfo_uarch cpuinfo_x86_decode_uarch(
-	enum cpuinfo_vendor vendor,
-	const struct cpuinfo_x86_model_info* model_info)
-{
-	switch (vendor) {
-		case cpuinfo_vendor_intel:
-			switch (model_info->family) {
+/*
+ * Microarchitectures of x86 processors by vendor, family, and ranges of models and steppings. Entries are sorted by
+ * vendor, family, and model, and model ranges of the same vendor and family don't overlap.
+ */
+static const struct cpuinfo_x86_uarch_table_entry uarch_table[] = {
 #if CPUINFO_ARCH_X86
-				case 0x05:
-					switch (model_info->model) {
-						case 0x01: // Pentium (60, 66)
-						case 0x02: // Pentium (75, 90, 100, 120, 133, 150, 166, 200)
-						case 0x03: // Pentium OverDrive for Intel486-based systems
-						case 0x04: // Pentium MMX
-							return cpuinfo_uarch_p5;
-						case 0x09:
-							return cpuinfo_uarch_quark;
-					}
-					break;
+	{ cpuinfo_vendor_intel, 0x05, 0x01, 0x04, 0x0, 0xF, cpuinfo_uarch_p5 }, // Pentium, Pentium OverDrive, Pentium MMX
+	{ cpuinfo_vendor_intel, 0x05, 0x09, 0x09, 0x0, 0xF, cpuinfo_uarch_quark },
 #endif /* CPUINFO_ARCH_X86 */
-				case 0x06:
-					switch (model_info->model) {
-						/* Mainstream cores */
 #if CPUINFO_ARCH_X86
-						case 0x01: // Pentium Pro
-						case 0x03: // Pentium II (Klamath) and Pentium II Overdrive
-						case 0x05: // Pentium II (Deschutes, Tonga), Pentium II Celeron (Covington), Pentium II Xeon (Drake)
-						case 0x06: // Pentium II (Dixon), Pentium II Celeron (Mendocino)
-						case 0x07: // Pentium III (Katmai), Pentium III Xeon (Tanner)
-						case 0x08: // Pentium III (Coppermine), Pentium II Celeron (Coppermine-128), Pentium III Xeon (Cascades)
-						case 0x0A: // Pentium III Xeon (Cascades-2MB)
-						case 0x0B: // Pentium III (Tualatin), Pentium III Celeron (Tualatin-256)
-							return cpuinfo_uarch_p6;
-						case 0x09: // Pentium M (Banias), Pentium M Celeron (Banias-0, Banias-512)
-						case 0x0D: // Pentium M (Dothan), Pentium M Celeron (Dothan-512, Dothan-1024)
-						case 0x15: // Intel 80579 (Tolapai)
-							return cpuinfo_uarch_dothan;
-						case 0x0E: // Core Solo/Duo (Yonah), Pentium Dual-Core T2xxx (Yonah), Celeron M (Yonah-512, Yonah-1024), Dual-Core Xeon (Sossaman)
-							return cpuinfo_uarch_yonah;
+	{ cpuinfo_vendor_intel, 0x06, 0x01, 0x01, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium Pro
+	{ cpuinfo_vendor_intel, 0x06, 0x03, 0x03, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium II (Klamath) and Pentium II Overdrive
+	{ cpuinfo_vendor_intel, 0x06, 0x05, 0x05, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium II (Deschutes, Tonga), Pentium II Celeron (Covington), Pentium II Xeon (Drake)
+	{ cpuinfo_vendor_intel, 0x06, 0x06, 0x06, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium II (Dixon), Pentium II Celeron (Mendocino)
+	{ cpuinfo_vendor_intel, 0x06, 0x07, 0x07, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium III (Katmai), Pentium III Xeon (Tanner)
+	{ cpuinfo_vendor_intel, 0x06, 0x08, 0x08, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium III (Coppermine), Pentium II Celeron (Coppermine-128), Pentium III Xeon (Cascades)
+	{ cpuinfo_vendor_intel, 0x06, 0x09, 0x09, 0x0, 0xF, cpuinfo_uarch_dothan }, // Pentium M (Banias), Pentium M Celeron (Banias-0, Banias-512)
+	{ cpuinfo_vendor_intel, 0x06, 0x0A, 0x0A, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium III Xeon (Cascades-2MB)
+	{ cpuinfo_vendor_intel, 0x06, 0x0B, 0x0B, 0x0, 0xF, cpuinfo_uarch_p6 }, // Pentium III (Tualatin), Pentium III Celeron (Tualatin-256)
+	{ cpuinfo_vendor_intel, 0x06, 0x0D, 0x0D, 0x0, 0xF, cpuinfo_uarch_dothan }, // Pentium M (Dothan), Pentium M Celeron (Dothan-512, Dothan-1024)
+	{ cpuinfo_vendor_intel, 0x06, 0x0E, 0x0E, 0x0, 0xF, cpuinfo_uarch_yonah }, // Core Solo/Duo (Yonah), Pentium Dual-Core T2xxx (Yonah), Celeron M (Yonah-512, Yonah-1024), Dual-Core Xeon (Sossaman)
 #endif /* CPUINFO_ARCH_X86 */
-						case 0x0F: // Core 2 Duo (Conroe, Conroe-2M, Merom), Core 2 Quad (Tigerton), Xeon (Woodcrest, Clovertown, Kentsfield)
-						case 0x16: // Celeron (Conroe-L, Merom-L), Core 2 Duo (Merom)
-							return cpuinfo_uarch_conroe;
-						case 0x17: // Core 2 Duo (Penryn-3M), Core 2 Quad (Yorkfield), Core 2 Extreme (Yorkfield), Xeon (Harpertown), Pentium Dual-Core (Penryn)
-						case 0x1D: // Xeon (Dunnington)
-							return cpuinfo_uarch_penryn;
-						case 0x1A: // Core iX (Bloomfield), Xeon (Gainestown)
-						case 0x1E: // Core iX (Lynnfield, Clarksfield)
-						case 0x1F: // Core iX (Havendale)
-						case 0x2E: // Xeon (Beckton)
-						case 0x25: // Core iX (Clarkdale)
-						case 0x2C: // Core iX (Gulftown), Xeon (Gulftown)
-						case 0x2F: // Xeon (Eagleton)
-							return cpuinfo_uarch_nehalem;
-						case 0x2A: // Core iX (Sandy Bridge)
-						case 0x2D: // Core iX (Sandy Bridge-E), Xeon (Sandy Bridge EP/EX)
-							return cpuinfo_uarch_sandy_bridge;
-						case 0x3A: // Core iX (Ivy Bridge)
-						case 0x3E: // Ivy Bridge-E
-							return cpuinfo_uarch_ivy_bridge;
-						case 0x3C:
-						case 0x3F: // Haswell-E
-						case 0x45: // Haswell ULT
-						case 0x46: // Haswell with eDRAM
-							return cpuinfo_uarch_haswell;
-						case 0x3D: // Broadwell-U
-						case 0x47: // Broadwell-H
-						case 0x4F: // Broadwell-E
-						case 0x56: // Broadwell-DE
-							return cpuinfo_uarch_broadwell;
-						case 0x4E: // Sky Lake Client Y/U
-						case 0x55: // Sky/Cascade/Cooper Lake Server
-						case 0x5E: // Sky Lake Client DT/H/S
-						case 0x8E: // Kaby/Whiskey/Amber/Comet Lake Y/U
-						case 0x9E: // Kaby/Coffee Lake DT/H/S
-						case 0xA5: // Comet Lake H/S
-						case 0xA6: // Comet Lake U/Y
-							return cpuinfo_uarch_sky_lake;
-						case 0x66: // Cannon Lake (Core i3-8121U)
-							return cpuinfo_uarch_palm_cove;
-						case 0x6A: // Ice Lake-DE
-						case 0x6C: // Ice Lake-SP
-						case 0x7D: // Ice Lake-Y
-						case 0x7E: // Ice Lake-U
-							return cpuinfo_uarch_sunny_cove;
-
-						/* Low-power cores */
-						case 0x1C: // Diamondville, Silverthorne, Pineview
-						case 0x26: // Tunnel Creek
-							return cpuinfo_uarch_bonnell;
-						case 0x27: // Medfield
-						case 0x35: // Cloverview
-						case 0x36: // Cedarview, Centerton
-							return cpuinfo_uarch_saltwell;
-						case 0x37: // Bay Trail
-						case 0x4A: // Merrifield
-						case 0x4D: // Avoton, Rangeley
-						case 0x5A: // Moorefield
-						case 0x5D: // SoFIA
-							return cpuinfo_uarch_silvermont;
-						case 0x4C: // Braswell, Cherry Trail
-						case 0x75: // Spreadtrum SC9853I-IA
-							return cpuinfo_uarch_airmont;
-						case 0x5C: // Apollo Lake
-						case 0x5F: // Denverton
-							return cpuinfo_uarch_goldmont;
-						case 0x7A: // Gemini Lake
-							return cpuinfo_uarch_goldmont_plus;
-
-						/* Knights-series cores */
-						case 0x57:
-							return cpuinfo_uarch_knights_landing;
-						case 0x85:
-							return cpuinfo_uarch_knights_mill;
-					}
-					break;
-				case 0x0F:
-					switch (model_info->model) {
-						case 0x00: // Pentium 4 Xeon (Foster)
-						case 0x01: // Pentium 4 Celeron (Willamette-128), Pentium 4 Xeon (Foster, Foster MP)
-						case 0x02: // Pentium 4 (Northwood), Pentium 4 EE (Gallatin), Pentium 4 Celeron (Northwood-128, Northwood-256), Pentium 4 Xeon (Gallatin DP, Prestonia)
-							return cpuinfo_uarch_willamette;
-							break;
-						case 0x03: // Pentium 4 (Prescott), Pentium 4 Xeon (Nocona)
-						case 0x04: // Pentium 4 (Prescott-2M), Pentium 4 EE (Prescott-2M), Pentium D (Smithfield), Celeron D (Prescott-256), Pentium 4 Xeon (Cranford, Irwindale, Paxville)
-						case 0x06: // Pentium 4 (Cedar Mill), Pentium D EE (Presler), Celeron D (Cedar Mill), Pentium 4 Xeon (Dempsey, Tulsa)
-							return cpuinfo_uarch_prescott;
-					}
-					break;
-			}
-			break;
-		case cpuinfo_vendor_amd:
-			switch (model_info->family) {
+	{ cpuinfo_vendor_intel, 0x06, 0x0F, 0x0F, 0x0, 0xF, cpuinfo_uarch_conroe }, // Core 2 Duo (Conroe, Conroe-2M, Merom), Core 2 Quad (Tigerton), Xeon (Woodcrest, Clovertown, Kentsfield)
 #if CPUINFO_ARCH_X86
-				case 0x5:
-					switch (model_info->model) {
-						case 0x00:
-						case 0x01:
-						case 0x02:
-							return cpuinfo_uarch_k5;
-						case 0x06:
-						case 0x07:
-						case 0x08:
-						case 0x0D:
-							return cpuinfo_uarch_k6;
-						case 0x0A:
-							return cpuinfo_uarch_geode;
-					}
-					break;
-				case 0x6:
-					return cpuinfo_uarch_k7;
+	{ cpuinfo_vendor_intel, 0x06, 0x15, 0x15, 0x0, 0xF, cpuinfo_uarch_dothan }, // Intel 80579 (Tolapai)
 #endif /* CPUINFO_ARCH_X86 */
-				case 0xF: // Opteron, Athlon 64, Sempron
-				case 0x11: // Turion
-					return cpuinfo_uarch_k8;
-				case 0x10: // Opteron, Phenom, Athlon, Sempron
-				case 0x12: // Llano APU
-					return cpuinfo_uarch_k10;
-				case 0x14:
-					return cpuinfo_uarch_bobcat;
-				case 0x15:
-					switch (model_info->model) {
-						case 0x00: // Engineering samples
-						case 0x01: // Zambezi, Interlagos
-							return cpuinfo_uarch_bulldozer;
-						case 0x02: // Vishera
-						case 0x10: // Trinity
-						case 0x13: // Richland
-							return cpuinfo_uarch_piledriver;
-						case 0x38: // Godavari
-						case 0x30: // Kaveri
-							return cpuinfo_uarch_steamroller;
-						case 0x60: // Carrizo
-						case 0x65: // Bristol Ridge
-						case 0x70: // Stoney Ridge
-							return cpuinfo_uarch_excavator;
-						default:
-							switch (model_info->extended_model) {
-								case 0x0:
-									return cpuinfo_uarch_bulldozer;
-								case 0x1: // No L3 cache
-								case 0x2: // With L3 cache
-									return cpuinfo_uarch_piledriver;
-								case 0x3: // With L3 cache
-								case 0x4: // No L3 cache
-									return cpuinfo_uarch_steamroller;
-							}
-							break;
-					}
-					break;
-				case 0x16:
-					if (model_info->extended_model >= 0x03) {
-						return cpuinfo_uarch_puma;
-					} else {
-						return cpuinfo_uarch_jaguar;
-					}
-				case 0x17:
-					switch (model_info->extended_model) {
-						case 0x0: // model 01h -> 14 nm Naples/Whitehaven/Summit Ridge/Snowy Owl, model 08h -> 12 nm Colfax/Pinnacle Ridge
-						case 0x1: // model 11h -> 14 nm Raven Ridge/Great Horned Owl, model 18h -> 14 nm Banded Kestrel / 12 nm Picasso
-							return cpuinfo_uarch_zen;
-						case 0x3: // model 31h -> Rome/Castle Peak
-						case 0x4: // model 47h -> Xbox Series X
-						case 0x6: // model 60h -> Renoir/Grey Hawk, model 68h -> Lucienne
-						case 0x7: // model 71h -> Matisse
-						case 0x9: // model 90h -> Van Gogh, model 98h -> Mero
-							return cpuinfo_uarch_zen2;
-					}
-					break;
-				case 0x19:
-					switch (model_info->extended_model) {
-						case 0x0: // model 00h -> Genesis, model 01h -> Milan, model 08h -> Chagall
-						case 0x2: // model 21h -> Vermeer
-						case 0x3: // model 30h -> Badami, Trento
-						case 0x4: // model 40h -> Rembrandt
-						case 0x5: // model 50h -> Cezanne
-							return cpuinfo_uarch_zen3;
-						case 0x1: // model 10h..1Fh -> Stones
-						case 0x6: // model 60h..6Fh -> Raphael
-						case 0x7: // model 70h..77h -> Phoenix/Hawkpoint1, model 78h..7Fh -> Phoenix 2/Hawkpoint2
-						case 0xA: // model A0h..AFh -> Stones-Dense
-							return cpuinfo_uarch_zen4;
-					}
-					break;
-			}
-			break;
-		case cpuinfo_vendor_hygon:
-			switch (model_info->family) {
-				case 0x00:
-					return cpuinfo_uarch_dhyana;
-			}
-			break;
-		default:
-			break;
+	{ cpuinfo_vendor_intel, 0x06, 0x16, 0x16, 0x0, 0xF, cpuinfo_uarch_conroe }, // Celeron (Conroe-L, Merom-L), Core 2 Duo (Merom)
+	{ cpuinfo_vendor_intel, 0x06, 0x17, 0x17, 0x0, 0xF, cpuinfo_uarch_penryn }, // Core 2 Duo (Penryn-3M), Core 2 Quad (Yorkfield), Core 2 Extreme (Yorkfield), Xeon (Harpertown), Pentium Dual-Core (Penryn)
+	{ cpuinfo_vendor_intel, 0x06, 0x1A, 0x1A, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Core iX (Bloomfield), Xeon (Gainestown)
+	{ cpuinfo_vendor_intel, 0x06, 0x1C, 0x1C, 0x0, 0xF, cpuinfo_uarch_bonnell }, // Diamondville, Silverthorne, Pineview
+	{ cpuinfo_vendor_intel, 0x06, 0x1D, 0x1D, 0x0, 0xF, cpuinfo_uarch_penryn }, // Xeon (Dunnington)
+	{ cpuinfo_vendor_intel, 0x06, 0x1E, 0x1E, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Core iX (Lynnfield, Clarksfield)
+	{ cpuinfo_vendor_intel, 0x06, 0x1F, 0x1F, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Core iX (Havendale)
+	{ cpuinfo_vendor_intel, 0x06, 0x25, 0x25, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Core iX (Clarkdale)
+	{ cpuinfo_vendor_intel, 0x06, 0x26, 0x26, 0x0, 0xF, cpuinfo_uarch_bonnell }, // Tunnel Creek
+	{ cpuinfo_vendor_intel, 0x06, 0x27, 0x27, 0x0, 0xF, cpuinfo_uarch_saltwell }, // Medfield
+	{ cpuinfo_vendor_intel, 0x06, 0x2A, 0x2A, 0x0, 0xF, cpuinfo_uarch_sandy_bridge }, // Core iX (Sandy Bridge)
+	{ cpuinfo_vendor_intel, 0x06, 0x2C, 0x2C, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Core iX (Gulftown), Xeon (Gulftown)
+	{ cpuinfo_vendor_intel, 0x06, 0x2D, 0x2D, 0x0, 0xF, cpuinfo_uarch_sandy_bridge }, // Core iX (Sandy Bridge-E), Xeon (Sandy Bridge EP/EX)
+	{ cpuinfo_vendor_intel, 0x06, 0x2E, 0x2E, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Xeon (Beckton)
+	{ cpuinfo_vendor_intel, 0x06, 0x2F, 0x2F, 0x0, 0xF, cpuinfo_uarch_nehalem }, // Xeon (Eagleton)
+	{ cpuinfo_vendor_intel, 0x06, 0x35, 0x35, 0x0, 0xF, cpuinfo_uarch_saltwell }, // Cloverview
+	{ cpuinfo_vendor_intel, 0x06, 0x36, 0x36, 0x0, 0xF, cpuinfo_uarch_saltwell }, // Cedarview, Centerton
+	{ cpuinfo_vendor_intel, 0x06, 0x37, 0x37, 0x0, 0xF, cpuinfo_uarch_silvermont }, // Bay Trail
+	{ cpuinfo_vendor_intel, 0x06, 0x3A, 0x3A, 0x0, 0xF, cpuinfo_uarch_ivy_bridge }, // Core iX (Ivy Bridge)
+	{ cpuinfo_vendor_intel, 0x06, 0x3C, 0x3C, 0x0, 0xF, cpuinfo_uarch_haswell },
+	{ cpuinfo_vendor_intel, 0x06, 0x3D, 0x3D, 0x0, 0xF, cpuinfo_uarch_broadwell }, // Broadwell-U
+	{ cpuinfo_vendor_intel, 0x06, 0x3E, 0x3E, 0x0, 0xF, cpuinfo_uarch_ivy_bridge }, // Ivy Bridge-E
+	{ cpuinfo_vendor_intel, 0x06, 0x3F, 0x3F, 0x0, 0xF, cpuinfo_uarch_haswell }, // Haswell-E
+	{ cpuinfo_vendor_intel, 0x06, 0x45, 0x45, 0x0, 0xF, cpuinfo_uarch_haswell }, // Haswell ULT
+	{ cpuinfo_vendor_intel, 0x06, 0x46, 0x46, 0x0, 0xF, cpuinfo_uarch_haswell }, // Haswell with eDRAM
+	{ cpuinfo_vendor_intel, 0x06, 0x47, 0x47, 0x0, 0xF, cpuinfo_uarch_broadwell }, // Broadwell-H
+	{ cpuinfo_vendor_intel, 0x06, 0x4A, 0x4A, 0x0, 0xF, cpuinfo_uarch_silvermont }, // Merrifield
+	{ cpuinfo_vendor_intel, 0x06, 0x4C, 0x4C, 0x0, 0xF, cpuinfo_uarch_airmont }, // Braswell, Cherry Trail
+	{ cpuinfo_vendor_intel, 0x06, 0x4D, 0x4D, 0x0, 0xF, cpuinfo_uarch_silvermont }, // Avoton, Rangeley
+	{ cpuinfo_vendor_intel, 0x06, 0x4E, 0x4E, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Sky Lake Client Y/U
+	{ cpuinfo_vendor_intel, 0x06, 0x4F, 0x4F, 0x0, 0xF, cpuinfo_uarch_broadwell }, // Broadwell-E
+	{ cpuinfo_vendor_intel, 0x06, 0x55, 0x55, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Sky/Cascade/Cooper Lake Server
+	{ cpuinfo_vendor_intel, 0x06, 0x56, 0x56, 0x0, 0xF, cpuinfo_uarch_broadwell }, // Broadwell-DE
+	{ cpuinfo_vendor_intel, 0x06, 0x57, 0x57, 0x0, 0xF, cpuinfo_uarch_knights_landing },
+	{ cpuinfo_vendor_intel, 0x06, 0x5A, 0x5A, 0x0, 0xF, cpuinfo_uarch_silvermont }, // Moorefield
+	{ cpuinfo_vendor_intel, 0x06, 0x5C, 0x5C, 0x0, 0xF, cpuinfo_uarch_goldmont }, // Apollo Lake
+	{ cpuinfo_vendor_intel, 0x06, 0x5D, 0x5D, 0x0, 0xF, cpuinfo_uarch_silvermont }, // SoFIA
+	{ cpuinfo_vendor_intel, 0x06, 0x5E, 0x5E, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Sky Lake Client DT/H/S
+	{ cpuinfo_vendor_intel, 0x06, 0x5F, 0x5F, 0x0, 0xF, cpuinfo_uarch_goldmont }, // Denverton
+	{ cpuinfo_vendor_intel, 0x06, 0x66, 0x66, 0x0, 0xF, cpuinfo_uarch_palm_cove }, // Cannon Lake (Core i3-8121U)
+	{ cpuinfo_vendor_intel, 0x06, 0x6A, 0x6A, 0x0, 0xF, cpuinfo_uarch_sunny_cove }, // Ice Lake-DE
+	{ cpuinfo_vendor_intel, 0x06, 0x6C, 0x6C, 0x0, 0xF, cpuinfo_uarch_sunny_cove }, // Ice Lake-SP
+	{ cpuinfo_vendor_intel, 0x06, 0x75, 0x75, 0x0, 0xF, cpuinfo_uarch_airmont }, // Spreadtrum SC9853I-IA
+	{ cpuinfo_vendor_intel, 0x06, 0x7A, 0x7A, 0x0, 0xF, cpuinfo_uarch_goldmont_plus }, // Gemini Lake
+	{ cpuinfo_vendor_intel, 0x06, 0x7D, 0x7D, 0x0, 0xF, cpuinfo_uarch_sunny_cove }, // Ice Lake-Y
+	{ cpuinfo_vendor_intel, 0x06, 0x7E, 0x7E, 0x0, 0xF, cpuinfo_uarch_sunny_cove }, // Ice Lake-U
+	{ cpuinfo_vendor_intel, 0x06, 0x85, 0x85, 0x0, 0xF, cpuinfo_uarch_knights_mill },
+	{ cpuinfo_vendor_intel, 0x06, 0x86, 0x86, 0x0, 0xF, cpuinfo_uarch_tremont }, // Snow Ridge, Jasper Lake
+	{ cpuinfo_vendor_intel, 0x06, 0x8A, 0x8A, 0x0, 0xF, cpuinfo_uarch_tremont }, // Lakefield (hybrid with Sunny Cove, reported as Tremont)
+	{ cpuinfo_vendor_intel, 0x06, 0x8E, 0x8E, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Kaby/Whiskey/Amber/Comet Lake Y/U
+	{ cpuinfo_vendor_intel, 0x06, 0x8F, 0x8F, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Sapphire Rapids
+	{ cpuinfo_vendor_intel, 0x06, 0x96, 0x96, 0x0, 0xF, cpuinfo_uarch_tremont }, // Elkhart Lake
+	{ cpuinfo_vendor_intel, 0x06, 0x97, 0x97, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Alder Lake-S (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0x9A, 0x9A, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Alder Lake-P (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0x9C, 0x9C, 0x0, 0xF, cpuinfo_uarch_tremont }, // Jasper Lake
+	{ cpuinfo_vendor_intel, 0x06, 0x9E, 0x9E, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Kaby/Coffee Lake DT/H/S
+	{ cpuinfo_vendor_intel, 0x06, 0xA5, 0xA5, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Comet Lake H/S
+	{ cpuinfo_vendor_intel, 0x06, 0xA6, 0xA6, 0x0, 0xF, cpuinfo_uarch_sky_lake }, // Comet Lake U/Y
+	{ cpuinfo_vendor_intel, 0x06, 0xAA, 0xAA, 0x0, 0xF, cpuinfo_uarch_redwood_cove }, // Meteor Lake-H/U (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xAC, 0xAC, 0x0, 0xF, cpuinfo_uarch_redwood_cove }, // Meteor Lake-S (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xAD, 0xAD, 0x0, 0xF, cpuinfo_uarch_redwood_cove }, // Granite Rapids
+	{ cpuinfo_vendor_intel, 0x06, 0xAE, 0xAE, 0x0, 0xF, cpuinfo_uarch_redwood_cove }, // Granite Rapids-D
+	{ cpuinfo_vendor_intel, 0x06, 0xAF, 0xAF, 0x0, 0xF, cpuinfo_uarch_crestmont }, // Sierra Forest
+	{ cpuinfo_vendor_intel, 0x06, 0xB5, 0xB5, 0x0, 0xF, cpuinfo_uarch_redwood_cove }, // Arrow Lake-U (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xB6, 0xB6, 0x0, 0xF, cpuinfo_uarch_crestmont }, // Grand Ridge
+	{ cpuinfo_vendor_intel, 0x06, 0xB7, 0xB7, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Raptor Lake-S (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xBA, 0xBA, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Raptor Lake-P (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xBD, 0xBD, 0x0, 0xF, cpuinfo_uarch_lion_cove }, // Lunar Lake (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xBE, 0xBE, 0x0, 0xF, cpuinfo_uarch_gracemont }, // Alder Lake-N, Twin Lake
+	{ cpuinfo_vendor_intel, 0x06, 0xBF, 0xBF, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Raptor Lake-S refresh (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xC5, 0xC5, 0x0, 0xF, cpuinfo_uarch_lion_cove }, // Arrow Lake-H (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xC6, 0xC6, 0x0, 0xF, cpuinfo_uarch_lion_cove }, // Arrow Lake-S (hybrid)
+	{ cpuinfo_vendor_intel, 0x06, 0xCF, 0xCF, 0x0, 0xF, cpuinfo_uarch_golden_cove }, // Emerald Rapids
+	{ cpuinfo_vendor_intel, 0x06, 0xDD, 0xDD, 0x0, 0xF, cpuinfo_uarch_skymont }, // Clearwater Forest
+	{ cpuinfo_vendor_intel, 0x0F, 0x00, 0x02, 0x0, 0xF, cpuinfo_uarch_willamette }, // Pentium 4 (Willamette, Northwood), Pentium 4 Xeon (Foster, Gallatin, Prestonia)
+	{ cpuinfo_vendor_intel, 0x0F, 0x03, 0x04, 0x0, 0xF, cpuinfo_uarch_prescott }, // Pentium 4 (Prescott), Pentium D (Smithfield), Pentium 4 Xeon (Nocona, Irwindale, Paxville)
+	{ cpuinfo_vendor_intel, 0x0F, 0x06, 0x06, 0x0, 0xF, cpuinfo_uarch_prescott }, // Pentium 4 (Cedar Mill), Pentium D EE (Presler), Pentium 4 Xeon (Dempsey, Tulsa)
+#if CPUINFO_ARCH_X86
+	{ cpuinfo_vendor_amd, 0x05, 0x00, 0x02, 0x0, 0xF, cpuinfo_uarch_k5 },
+	{ cpuinfo_vendor_amd, 0x05, 0x06, 0x08, 0x0, 0xF, cpuinfo_uarch_k6 },
+	{ cpuinfo_vendor_amd, 0x05, 0x0A, 0x0A, 0x0, 0xF, cpuinfo_uarch_geode },
+	{ cpuinfo_vendor_amd, 0x05, 0x0D, 0x0D, 0x0, 0xF, cpuinfo_uarch_k6 },
+	{ cpuinfo_vendor_amd, 0x06, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_k7 },
+#endif /* CPUINFO_ARCH_X86 */
+	{ cpuinfo_vendor_amd, 0x0F, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_k8 }, // Opteron, Athlon 64, Sempron
+	{ cpuinfo_vendor_amd, 0x10, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_k10 }, // Opteron, Phenom, Athlon, Sempron
+	{ cpuinfo_vendor_amd, 0x11, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_k8 }, // Turion
+	{ cpuinfo_vendor_amd, 0x12, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_k10 }, // Llano APU
+	{ cpuinfo_vendor_amd, 0x14, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_bobcat },
+	{ cpuinfo_vendor_amd, 0x15, 0x00, 0x01, 0x0, 0xF, cpuinfo_uarch_bulldozer }, // Engineering samples, Zambezi, Interlagos
+	{ cpuinfo_vendor_amd, 0x15, 0x02, 0x02, 0x0, 0xF, cpuinfo_uarch_piledriver }, // Vishera
+	{ cpuinfo_vendor_amd, 0x15, 0x03, 0x0F, 0x0, 0xF, cpuinfo_uarch_bulldozer },
+	{ cpuinfo_vendor_amd, 0x15, 0x10, 0x2F, 0x0, 0xF, cpuinfo_uarch_piledriver }, // Trinity, Richland
+	{ cpuinfo_vendor_amd, 0x15, 0x30, 0x4F, 0x0, 0xF, cpuinfo_uarch_steamroller }, // Kaveri, Godavari
+	{ cpuinfo_vendor_amd, 0x15, 0x60, 0x60, 0x0, 0xF, cpuinfo_uarch_excavator }, // Carrizo
+	{ cpuinfo_vendor_amd, 0x15, 0x65, 0x65, 0x0, 0xF, cpuinfo_uarch_excavator }, // Bristol Ridge
+	{ cpuinfo_vendor_amd, 0x15, 0x70, 0x70, 0x0, 0xF, cpuinfo_uarch_excavator }, // Stoney Ridge
+	{ cpuinfo_vendor_amd, 0x16, 0x00, 0x2F, 0x0, 0xF, cpuinfo_uarch_jaguar },
+	{ cpuinfo_vendor_amd, 0x16, 0x30, 0xFF, 0x0, 0xF, cpuinfo_uarch_puma },
+	{ cpuinfo_vendor_amd, 0x17, 0x00, 0x1F, 0x0, 0xF, cpuinfo_uarch_zen }, // Naples, Summit Ridge, Pinnacle Ridge, Raven Ridge, Picasso
+	{ cpuinfo_vendor_amd, 0x17, 0x30, 0x4F, 0x0, 0xF, cpuinfo_uarch_zen2 }, // Rome, Castle Peak, Xbox Series X
+	{ cpuinfo_vendor_amd, 0x17, 0x60, 0x7F, 0x0, 0xF, cpuinfo_uarch_zen2 }, // Renoir, Lucienne, Matisse
+	{ cpuinfo_vendor_amd, 0x17, 0x90, 0x9F, 0x0, 0xF, cpuinfo_uarch_zen2 }, // Van Gogh, Mero
+	{ cpuinfo_vendor_amd, 0x19, 0x00, 0x0F, 0x0, 0xF, cpuinfo_uarch_zen3 }, // Genesis, Milan, Chagall
+	{ cpuinfo_vendor_amd, 0x19, 0x10, 0x1F, 0x0, 0xF, cpuinfo_uarch_zen4 }, // Stones
+	{ cpuinfo_vendor_amd, 0x19, 0x20, 0x5F, 0x0, 0xF, cpuinfo_uarch_zen3 }, // Vermeer, Badami, Trento, Rembrandt, Cezanne
+	{ cpuinfo_vendor_amd, 0x19, 0x60, 0x7F, 0x0, 0xF, cpuinfo_uarch_zen4 }, // Raphael, Phoenix, Hawkpoint
+	{ cpuinfo_vendor_amd, 0x19, 0xA0, 0xAF, 0x0, 0xF, cpuinfo_uarch_zen4 }, // Stones-Dense
+	{ cpuinfo_vendor_hygon, 0x00, 0x00, 0xFF, 0x0, 0xF, cpuinfo_uarch_dhyana },
+};
+
+enum cpuinfo_uarch cpuinfo_x86_decode_uarch(
+	enum cpuinfo_vendor vendor,
+	const struct cpuinfo_x86_model_info* model_info)
+{
+	const uint32_t family = model_info->family;
+	const uint32_t model = model_info->model;
+	const struct cpuinfo_x86_uarch_table_entry* entry =
+		cpuinfo_find_x86_uarch_table_entry(vendor, family, model, model_info->stepping);
+	if (entry != NULL) {
+		return entry->uarch;
+	}
+
+	/* Binary search for the first entry which doesn't end before the model */
+	uint32_t low = 0, high = CPUINFO_COUNT_OF(uarch_table);
+	while (low < high) {
+		const uint32_t middle = low + (high - low) / 2;
+		const struct cpuinfo_x86_uarch_table_entry* middle_entry = &uarch_table[middle];
+		if (middle_entry->vendor < vendor || (middle_entry->vendor == vendor && (middle_entry->family < family ||
+			(middle_entry->family == family && middle_entry->model_max < model))))
+		{
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	if (low != CPUINFO_COUNT_OF(uarch_table)) {
+		entry = &uarch_table[low];
+		if (entry->vendor == vendor && entry->family == family && entry->model_min <= model &&
+			entry->stepping_min <= model_info->stepping && model_info->stepping <= entry->stepping_max)
+		{
+			return entry->uarch;
+		}
 	}
 	return cpuinfo_uarch_unknown;
 }
+
+enum cpuinfo_uarch cpuinfo_x86_decode_hybrid_uarch(
+	enum cpuinfo_vendor vendor,
+	const struct cpuinfo_x86_model_info* model_info,
+	uint32_t core_type)
+{
+	if (vendor == cpuinfo_vendor_intel && model_info->family == 0x06) {
+		switch (core_type) {
+			case CPUINFO_X86_CORE_TYPE_ATOM:
+				switch (model_info->model) {
+					case 0x8A: // Lakefield
+						return cpuinfo_uarch_tremont;
+					case 0x97: // Alder Lake-S
+					case 0x9A: // Alder Lake-P
+					case 0xB7: // Raptor Lake-S
+					case 0xBA: // Raptor Lake-P
+					case 0xBF: // Raptor Lake-S refresh
+						return cpuinfo_uarch_gracemont;
+					case 0xAA: // Meteor Lake-H/U
+					case 0xAC: // Meteor Lake-S
+					case 0xB5: // Arrow Lake-U
+						return cpuinfo_uarch_crestmont;
+					case 0xBD: // Lunar Lake
+					case 0xC5: // Arrow Lake-H
+					case 0xC6: // Arrow Lake-S
+						return cpuinfo_uarch_skymont;
+				}
+				break;
+			case CPUINFO_X86_CORE_TYPE_CORE:
+				switch (model_info->model) {
+					case 0x8A: // Lakefield
+						return cpuinfo_uarch_sunny_cove;
+				}
+				break;
+		}
+	}
+	return cpuinfo_x86_decode_uarch(vendor, model_info);
+}
+
+struct cpuinfo_uarch_streaming_hints cpuinfo_x86_decode_streaming_hints(enum cpuinfo_uarch uarch) {
+	switch (uarch) {
+		case cpuinfo_uarch_conroe:
+		case cpuinfo_uarch_penryn:
+		case cpuinfo_uarch_nehalem:
+		case cpuinfo_uarch_sandy_bridge:
+		case cpuinfo_uarch_ivy_bridge:
+		case cpuinfo_uarch_haswell:
+		case cpuinfo_uarch_broadwell:
+		case cpuinfo_uarch_sky_lake:
+		case cpuinfo_uarch_palm_cove:
+		case cpuinfo_uarch_sunny_cove:
+		case cpuinfo_uarch_golden_cove:
+		case cpuinfo_uarch_redwood_cove:
+		case cpuinfo_uarch_lion_cove:
+		case cpuinfo_uarch_zen:
+		case cpuinfo_uarch_zen2:
+		case cpuinfo_uarch_zen3:
+		case cpuinfo_uarch_zen4:
+			/* Deep out-of-order cores with L2 stream prefetchers: stay 8 lines ahead, switch at 3/4 of LLC */
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 512,
+				.llc_sixteenths = 12,
+			};
+		case cpuinfo_uarch_knights_landing:
+		case cpuinfo_uarch_knights_mill:
+			/* High memory latency and no L3 cache: prefetch far ahead, and switch at half of L2 */
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 1024,
+				.llc_sixteenths = 8,
+			};
+		case cpuinfo_uarch_bonnell:
+		case cpuinfo_uarch_saltwell:
+		case cpuinfo_uarch_silvermont:
+		case cpuinfo_uarch_airmont:
+		case cpuinfo_uarch_goldmont:
+		case cpuinfo_uarch_goldmont_plus:
+		case cpuinfo_uarch_tremont:
+		case cpuinfo_uarch_gracemont:
+		case cpuinfo_uarch_crestmont:
+		case cpuinfo_uarch_skymont:
+		case cpuinfo_uarch_bobcat:
+		case cpuinfo_uarch_jaguar:
+		case cpuinfo_uarch_puma:
+			/* Low-power cores track fewer outstanding misses, and share L2 cache in modules */
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 256,
+				.llc_sixteenths = 8,
+			};
+		default:
+			return (struct cpuinfo_uarch_streaming_hints) {
+				.prefetch_distance = 256,
+				.llc_sixteenths = 12,
+			};
+	}
+}
+
+struct cpuinfo_uarch_vector_hints cpuinfo_x86_decode_vector_hints(enum cpuinfo_uarch uarch) {
+	switch (uarch) {
+		case cpuinfo_uarch_sky_lake:
+		case cpuinfo_uarch_palm_cove:
+			/* Skylake-SP, Cascade Lake and Cannon Lake drop to the AVX-512 heavy frequency license */
+			return (struct cpuinfo_uarch_vector_hints) {
+				.preferred_width = 256,
+				.wide_vector_frequency_penalty = 20,
+			};
+		case cpuinfo_uarch_sunny_cove:
+			/* Ice Lake lowers frequency much less than Skylake-SP on 512-bit vectors */
+			return (struct cpuinfo_uarch_vector_hints) {
+				.preferred_width = 512,
+				.wide_vector_frequency_penalty = 5,
+			};
+		case cpuinfo_uarch_golden_cove:
+		case cpuinfo_uarch_redwood_cove:
+		case cpuinfo_uarch_lion_cove:
+			return (struct cpuinfo_uarch_vector_hints) {
+				.preferred_width = 512,
+				.wide_vector_frequency_penalty = 2,
+			};
+		case cpuinfo_uarch_knights_landing:
+		case cpuinfo_uarch_knights_mill:
+		case cpuinfo_uarch_zen4:
+			/* Zen 4 executes 512-bit instructions as two 256-bit halves and keeps its frequency */
+			return (struct cpuinfo_uarch_vector_hints) {
+				.preferred_width = 512,
+				.wide_vector_frequency_penalty = 0,
+			};
+		case cpuinfo_uarch_zen:
+		case cpuinfo_uarch_bulldozer:
+		case cpuinfo_uarch_piledriver:
+		case cpuinfo_uarch_steamroller:
+		case cpuinfo_uarch_excavator:
+		case cpuinfo_uarch_jaguar:
+		case cpuinfo_uarch_puma:
+			/* 128-bit vector units split 256-bit instructions in two */
+			return (struct cpuinfo_uarch_vector_hints) {
+				.preferred_width = 128,
+				.wide_vector_frequency_penalty = 0,
+			};
+		default:
+			return (struct cpuinfo_uarch_vector_hints) {
+				.preferred_width = 256,
+				.wide_vector_frequency_penalty = 0,
+			};
+	}
+}
+
+uint32_t cpuinfo_x86_decode_pitfalls(enum cpuinfo_uarch uarch) {
+	switch (uarch) {
+		case cpuinfo_uarch_sandy_bridge:
+		case cpuinfo_uarch_ivy_bridge:
+		case cpuinfo_uarch_haswell:
+		case cpuinfo_uarch_broadwell:
+		case cpuinfo_uarch_golden_cove:
+		case cpuinfo_uarch_redwood_cove:
+		case cpuinfo_uarch_lion_cove:
+			return CPUINFO_PITFALL_X86_AVX_SSE_TRANSITION;
+		case cpuinfo_uarch_sky_lake:
+		case cpuinfo_uarch_palm_cove:
+		case cpuinfo_uarch_sunny_cove:
+			/* Microcode mitigations of Gather Data Sampling (Downfall) serialize VPGATHER instructions */
+			return CPUINFO_PITFALL_X86_AVX_SSE_TRANSITION | CPUINFO_PITFALL_X86_SLOW_GATHER;
+		case cpuinfo_uarch_knights_landing:
+		case cpuinfo_uarch_knights_mill:
+			return CPUINFO_PITFALL_X86_SLOW_VZEROUPPER;
+		case cpuinfo_uarch_zen:
+			/* PDEP and PEXT are microcoded with latency proportional to the number of set bits in the mask */
+			return CPUINFO_PITFALL_X86_SLOW_PDEP_PEXT | CPUINFO_PITFALL_X86_SLOW_GATHER |
+				CPUINFO_PITFALL_X86_SPLIT_256BIT;
+		case cpuinfo_uarch_zen2:
+			return CPUINFO_PITFALL_X86_SLOW_PDEP_PEXT | CPUINFO_PITFALL_X86_SLOW_GATHER;
+		case cpuinfo_uarch_excavator:
+			return CPUINFO_PITFALL_X86_SLOW_PDEP_PEXT | CPUINFO_PITFALL_X86_SPLIT_256BIT;
+		case cpuinfo_uarch_bulldozer:
+		case cpuinfo_uarch_piledriver:
+		case cpuinfo_uarch_steamroller:
+		case cpuinfo_uarch_jaguar:
+		case cpuinfo_uarch_puma:
+			return CPUINFO_PITFALL_X86_SPLIT_256BIT;
+		default:
+			return 0;
+	}
+}
+
+enum cpuinfo_pause_latency cpuinfo_x86_decode_pause_latency(enum cpuinfo_vendor vendor, enum cpuinfo_uarch uarch) {
+	switch (uarch) {
+		case cpuinfo_uarch_sky_lake:
+		case cpuinfo_uarch_palm_cove:
+		case cpuinfo_uarch_sunny_cove:
+		case cpuinfo_uarch_golden_cove:
+		case cpuinfo_uarch_redwood_cove:
+		case cpuinfo_uarch_lion_cove:
+			/* Sky Lake raised PAUSE latency from about 10 to about 140 cycles, and later big cores kept it */
+			return cpuinfo_pause_latency_long;
+		case cpuinfo_uarch_unknown:
+			return cpuinfo_pause_latency_unknown;
+		default:
+			switch (vendor) {
+				case cpuinfo_vendor_intel:
+				case cpuinfo_vendor_amd:
+				case cpuinfo_vendor_hygon:
+					return cpuinfo_pause_latency_short;
+				default:
+					return cpuinfo_pause_latency_unknown;
+			}
+	}
+}
@@ -5,6 +5,7 @@
 
 #include <cpuinfo.h>
 #include <x86/api.h>
+#include <windows/api.h>
 #include <cpuinfo/internal-api.h>
 #include <cpuinfo/log.h>
 
@@ -35,6 +36,22 @@ static inline uint32_t low_index_from_kaffinity(KAFFINITY kaffinity) {
 	#endif
 }
 
+/* Bits of APIC ID which are shared by all processors in a cluster: the last-level cache within a package */
+static inline uint32_t get_cluster_apic_bits(
+	const struct cpuinfo_x86_processor* x86_processor,
+	uint32_t package_bits_offset)
+{
+	uint32_t cluster_apic_bits = package_bits_offset;
+	if (x86_processor->cache.l4.size != 0) {
+		cluster_apic_bits = x86_processor->cache.l4.apic_bits;
+	} else if (x86_processor->cache.l3.size != 0) {
+		cluster_apic_bits = x86_processor->cache.l3.apic_bits;
+	} else if (x86_processor->cache.l2.size != 0) {
+		cluster_apic_bits = x86_processor->cache.l2.apic_bits;
+	}
+	return min(cluster_apic_bits, package_bits_offset);
+}
+
 static void cpuinfo_x86_count_caches(
 	uint32_t processors_count,
 	const struct cpuinfo_processor* processors,
@@ -97,17 +114,10 @@ static void cpuinfo_x86_count_caches(
 
 BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PVOID* context) {
 	struct cpuinfo_processor* processors = NULL;
-	struct cpuinfo_core* cores = NULL;
-	struct cpuinfo_cluster* clusters = NULL;
-	struct cpuinfo_package* packages = NULL;
-	struct cpuinfo_cache* l1i = NULL;
-	struct cpuinfo_cache* l1d = NULL;
-	struct cpuinfo_cache* l2 = NULL;
-	struct cpuinfo_cache* l3 = NULL;
-	struct cpuinfo_cache* l4 = NULL;
-	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX processor_infos = NULL;
-
-	HANDLE heap = GetProcessHeap();
+	struct cpuinfo_processor* temporary_processors = NULL;
+	struct cpuinfo_arena arena = { NULL, 0 };
+	struct cpuinfo_windows_topology topology = { 0 };
+
 
 	struct cpuinfo_x86_processor x86_processor;
 	ZeroMemory(&x86_processor, sizeof(x86_processor));
@@ -121,13 +131,19 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		x86_processor.topology.thread_bits_offset + x86_processor.topology.thread_bits_length,
 		x86_processor.topology.core_bits_offset + x86_processor.topology.core_bits_length);
 
-	const uint32_t max_group_count = (uint32_t) GetMaximumProcessorGroupCount();
+	/* Processor groups, packages, caches and cores are all enumerated with a single query */
+	if (!cpuinfo_windows_query_topology(RelationAll, &topology)) {
+		cpuinfo_log_error("failed to query logical processor information");
+		goto cleanup;
+	}
+
+	const uint32_t max_group_count = cpuinfo_windows_get_max_group_count(&topology);
 	cpuinfo_log_debug("detected %"PRIu32" processor groups", max_group_count);
 
 	uint32_t processors_count = 0;
 	uint32_t* processors_per_group = (uint32_t*) CPUINFO_ALLOCA(max_group_count * sizeof(uint32_t));
 	for (uint32_t i = 0; i < max_group_count; i++) {
-		processors_per_group[i] = GetMaximumProcessorCount((WORD) i);
+		processors_per_group[i] = cpuinfo_windows_get_group_processors_count(&topology, i);
 		cpuinfo_log_debug("detected %"PRIu32" processors in group %"PRIu32,
 			processors_per_group[i], i);
 		processors_count += processors_per_group[i];
@@ -141,61 +157,18 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		count += processors_per_group[i];
 	}
 
-	processors = HeapAlloc(heap, HEAP_ZERO_MEMORY, processors_count * sizeof(struct cpuinfo_processor));
+	/* Tables are allocated together once all of them are counted: until then, processors are in a temporary array */
+	temporary_processors = cpuinfo_allocate_temporary(processors_count, sizeof(struct cpuinfo_processor));
+	processors = temporary_processors;
 	if (processors == NULL) {
 		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" logical processors",
 			processors_count * sizeof(struct cpuinfo_processor), processors_count);
 		goto cleanup;
 	}
 
-	DWORD cores_info_size = 0;
-	if (GetLogicalProcessorInformationEx(RelationProcessorCore, NULL, &cores_info_size) == FALSE) {
-		const DWORD last_error = GetLastError();
-		if (last_error != ERROR_INSUFFICIENT_BUFFER) {
-			cpuinfo_log_error("failed to query size of processor cores information: error %"PRIu32,
-				(uint32_t) last_error);
-			goto cleanup;
-		}
-	}
-
-	DWORD packages_info_size = 0;
-	if (GetLogicalProcessorInformationEx(RelationProcessorPackage, NULL, &packages_info_size) == FALSE) {
-		const DWORD last_error = GetLastError();
-		if (last_error != ERROR_INSUFFICIENT_BUFFER) {
-			cpuinfo_log_error("failed to query size of processor packages information: error %"PRIu32,
-				(uint32_t) last_error);
-			goto cleanup;
-		}
-	}
-
-	DWORD max_info_size = max(cores_info_size, packages_info_size);
-
-	processor_infos = HeapAlloc(heap, 0, max_info_size);
-	if (processor_infos == NULL) {
-		cpuinfo_log_error("failed to allocate %"PRIu32" bytes for logical processor information",
-			(uint32_t) max_info_size);
-		goto cleanup;
-	}
-
-	if (GetLogicalProcessorInformationEx(RelationProcessorPackage, processor_infos, &max_info_size) == FALSE) {
-		cpuinfo_log_error("failed to query processor packages information: error %"PRIu32,
-			(uint32_t) GetLastError());
-		goto cleanup;
-	}
-
 	uint32_t packages_count = 0;
-	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX packages_info_end =
-		(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) processor_infos + packages_info_size);
-	for (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX package_info = processor_infos;
-		package_info < packages_info_end;
-		package_info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) package_info + package_info->Size))
-	{
-		if (package_info->Relationship != RelationProcessorPackage) {
-			cpuinfo_log_warning("unexpected processor info type (%"PRIu32") for processor package information",
-				(uint32_t) package_info->Relationship);
-			continue;
-		}
-
+	for (uint32_t package_index = 0; package_index < topology.packages_count; package_index++) {
+		const PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX package_info = topology.packages[package_index];
 		/* We assume that packages are reported in APIC order */
 		const uint32_t package_id = packages_count++;
 		/* Reconstruct package part of APIC ID */
@@ -221,34 +194,81 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		}
 	}
 
-	max_info_size = max(cores_info_size, packages_info_size);
-	if (GetLogicalProcessorInformationEx(RelationProcessorCore, processor_infos, &max_info_size) == FALSE) {
-		cpuinfo_log_error("failed to query processor cores information: error %"PRIu32,
-			(uint32_t) GetLastError());
-		goto cleanup;
+	/*
+	 * Windows reports consecutive core numbers, but on processors with several L3 caches per package, e.g. AMD core
+	 * complexes, each L3 cache starts at an APIC ID aligned to the number of logical processors sharing it. Record
+	 * which L3 cache each processor belongs to, so that the reconstructed APIC IDs follow the same layout.
+	 */
+	/* Efficiency class of the core of every logical processor, as reported with the cores */
+	BYTE* processors_efficiency_class = (BYTE*) CPUINFO_ALLOCA(processors_count * sizeof(BYTE));
+	ZeroMemory(processors_efficiency_class, processors_count * sizeof(BYTE));
+
+	uint32_t* processors_l3_id = (uint32_t*) CPUINFO_ALLOCA(processors_count * sizeof(uint32_t));
+	for (uint32_t i = 0; i < processors_count; i++) {
+		processors_l3_id[i] = UINT32_MAX;
+	}
+	/*
+	 * CPUID describes caches of the initializing processor only, but L3 caches of core complexes may differ in size,
+	 * e.g. on AMD processors with 3D V-Cache on some of the core complexes. Windows reports the size of every cache.
+	 */
+	uint32_t* processors_l3_size = (uint32_t*) CPUINFO_ALLOCA(processors_count * sizeof(uint32_t));
+	ZeroMemory(processors_l3_size, processors_count * sizeof(uint32_t));
+	for (uint32_t cache_index = 0; cache_index < topology.caches_count; cache_index++) {
+		const PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX cache_info = topology.caches[cache_index];
+		if (cache_info->Cache.Level != 3) {
+			continue;
+		}
+
+		const uint32_t group_processors_start = processors_before_group[cache_info->Cache.GroupMask.Group];
+		KAFFINITY group_processors_mask = cache_info->Cache.GroupMask.Mask;
+		while (group_processors_mask != 0) {
+			const uint32_t group_processor_id = low_index_from_kaffinity(group_processors_mask);
+			processors_l3_size[group_processors_start + group_processor_id] = (uint32_t) cache_info->Cache.CacheSize;
+
+			/* Reset the lowest bit in affinity mask */
+			group_processors_mask &= (group_processors_mask - 1);
+		}
+	}
+
+	uint32_t l3_core_bits = 0;
+	if (x86_processor.cache.l3.size != 0 && x86_processor.cache.l3.apic_bits > x86_processor.topology.core_bits_offset) {
+		l3_core_bits = x86_processor.cache.l3.apic_bits - x86_processor.topology.core_bits_offset;
+	}
+	if (l3_core_bits != 0) {
+		uint32_t l3_count = 0;
+		for (uint32_t cache_index = 0; cache_index < topology.caches_count; cache_index++) {
+			const PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX cache_info = topology.caches[cache_index];
+			if (cache_info->Cache.Level != 3) {
+				continue;
+			}
+
+			const uint32_t l3_id = l3_count++;
+			const uint32_t group_id = cache_info->Cache.GroupMask.Group;
+			const uint32_t group_processors_start = processors_before_group[group_id];
+			KAFFINITY group_processors_mask = cache_info->Cache.GroupMask.Mask;
+			while (group_processors_mask != 0) {
+				const uint32_t group_processor_id = low_index_from_kaffinity(group_processors_mask);
+				processors_l3_id[group_processors_start + group_processor_id] = l3_id;
+
+				/* Reset the lowest bit in affinity mask */
+				group_processors_mask &= (group_processors_mask - 1);
+			}
+		}
 	}
 
 	uint32_t cores_count = 0;
 	/* Index (among all cores) of the the first core on the current package */
 	uint32_t package_core_start = 0;
 	uint32_t current_package_apic_id = 0;
-	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX cores_info_end =
-		(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) processor_infos + cores_info_size);
-	for (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX core_info = processor_infos;
-		core_info < cores_info_end;
-		core_info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) ((uintptr_t) core_info + core_info->Size))
-	{
-		if (core_info->Relationship != RelationProcessorCore) {
-			cpuinfo_log_warning("unexpected processor info type (%"PRIu32") for processor core information",
-				(uint32_t) core_info->Relationship);
-			continue;
-		}
-
+	/* Index (among all cores) of the first core on the current L3 cache, and index of the L3 cache in the package */
+	uint32_t l3_core_start = 0;
+	uint32_t package_l3_index = 0;
+	uint32_t current_l3_id = UINT32_MAX;
+	for (uint32_t core_index = 0; core_index < topology.cores_count; core_index++) {
+		const PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX core_info = topology.cores[core_index];
 		/* We assume that cores and logical processors are reported in APIC order */
 		const uint32_t core_id = cores_count++;
 		uint32_t smt_id = 0;
-		/* Reconstruct core part of APIC ID */
-		const uint32_t core_apic_id = (core_id & core_bits_mask) << x86_processor.topology.core_bits_offset;
 		/* Iterate processor groups and set the core & SMT parts of APIC ID */
 		for (uint32_t i = 0; i < core_info->Processor.GroupCount; i++) {
 			const uint32_t group_id = core_info->Processor.GroupMask[i].Group;
@@ -261,12 +281,20 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 				const uint32_t processor_id = group_processors_start + group_processor_id;
 
 				/* Check if this is the first core on a new package */
-				if (processors[processor_id].apic_id != current_package_apic_id) {
+				if (core_id == 0 || processors[processor_id].apic_id != current_package_apic_id) {
 					package_core_start = core_id;
 					current_package_apic_id = processors[processor_id].apic_id;
+					l3_core_start = core_id;
+					package_l3_index = 0;
+					current_l3_id = processors_l3_id[processor_id];
+				} else if (processors_l3_id[processor_id] != current_l3_id) {
+					/* First core on a new L3 cache in the same package */
+					l3_core_start = core_id;
+					package_l3_index += 1;
+					current_l3_id = processors_l3_id[processor_id];
 				}
 				/* Core ID w.r.t package */
-				const uint32_t package_core_id = core_id - package_core_start;
+				const uint32_t package_core_id = (package_l3_index << l3_core_bits) + (core_id - l3_core_start);
 
 				/* Update APIC ID with core and SMT parts */
 				processors[processor_id].apic_id |=
@@ -278,6 +306,7 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 				/* Set SMT ID (assume logical processors within the core are reported in APIC order) */
 				processors[processor_id].smt_id = smt_id++;
 				processors[processor_id].core = (const struct cpuinfo_core*) NULL + core_id;
+				processors_efficiency_class[processor_id] = core_info->Processor.EfficiencyClass;
 
 				/* Reset the lowest bit in affinity mask */
 				group_processors_mask &= (group_processors_mask - 1);
@@ -285,27 +314,49 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		}
 	}
 
-	cores = HeapAlloc(heap, HEAP_ZERO_MEMORY, cores_count * sizeof(struct cpuinfo_core));
-	if (cores == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" cores",
-			cores_count * sizeof(struct cpuinfo_core), cores_count);
-		goto cleanup;
+	/* Assign logical processors to clusters of processors sharing the last-level cache */
+	const uint32_t cluster_apic_bits = get_cluster_apic_bits(&x86_processor, package_bits_offset);
+	uint32_t clusters_count = 0;
+	uint32_t last_cluster_apic_id = UINT32_MAX;
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const uint32_t cluster_apic_id = processors[i].apic_id & ~bit_mask(cluster_apic_bits);
+		if (cluster_apic_id != last_cluster_apic_id) {
+			last_cluster_apic_id = cluster_apic_id;
+			clusters_count++;
+		}
+		processors[i].cluster = (const struct cpuinfo_cluster*) NULL + (clusters_count - 1);
 	}
 
-	clusters = HeapAlloc(heap, HEAP_ZERO_MEMORY, packages_count * sizeof(struct cpuinfo_cluster));
-	if (clusters == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" core clusters",
-			packages_count * sizeof(struct cpuinfo_cluster), packages_count);
-		goto cleanup;
-	}
+	/* Count caches */
+	uint32_t l1i_count, l1d_count, l2_count, l3_count, l4_count;
+	cpuinfo_x86_count_caches(processors_count, processors, &x86_processor,
+		&l1i_count, &l1d_count, &l2_count, &l3_count, &l4_count);
 
-	packages = HeapAlloc(heap, HEAP_ZERO_MEMORY, packages_count * sizeof(struct cpuinfo_package));
-	if (packages == NULL) {
-		cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" physical packages",
-			packages_count * sizeof(struct cpuinfo_package), packages_count);
+	const size_t processors_offset = cpuinfo_arena_reserve(&arena, processors_count, sizeof(struct cpuinfo_processor));
+	const size_t cores_offset = cpuinfo_arena_reserve(&arena, cores_count, sizeof(struct cpuinfo_core));
+	const size_t clusters_offset = cpuinfo_arena_reserve(&arena, clusters_count, sizeof(struct cpuinfo_cluster));
+	const size_t packages_offset = cpuinfo_arena_reserve(&arena, packages_count, sizeof(struct cpuinfo_package));
+	const size_t l1i_offset = cpuinfo_arena_reserve(&arena, l1i_count, sizeof(struct cpuinfo_cache));
+	const size_t l1d_offset = cpuinfo_arena_reserve(&arena, l1d_count, sizeof(struct cpuinfo_cache));
+	const size_t l2_offset = cpuinfo_arena_reserve(&arena, l2_count, sizeof(struct cpuinfo_cache));
+	const size_t l3_offset = cpuinfo_arena_reserve(&arena, l3_count, sizeof(struct cpuinfo_cache));
+	const size_t l4_offset = cpuinfo_arena_reserve(&arena, l4_count, sizeof(struct cpuinfo_cache));
+	if (!cpuinfo_arena_allocate(&arena)) {
 		goto cleanup;
 	}
 
+	/* Core, cluster, and package pointers of processors are still relative to the start of their tables */
+	processors = cpuinfo_arena_get(&arena, processors_offset, processors_count);
+	CopyMemory(processors, temporary_processors, processors_count * sizeof(struct cpuinfo_processor));
+	struct cpuinfo_core* cores = cpuinfo_arena_get(&arena, cores_offset, cores_count);
+	struct cpuinfo_cluster* clusters = cpuinfo_arena_get(&arena, clusters_offset, clusters_count);
+	struct cpuinfo_package* packages = cpuinfo_arena_get(&arena, packages_offset, packages_count);
+	struct cpuinfo_cache* l1i = cpuinfo_arena_get(&arena, l1i_offset, l1i_count);
+	struct cpuinfo_cache* l1d = cpuinfo_arena_get(&arena, l1d_offset, l1d_count);
+	struct cpuinfo_cache* l2 = cpuinfo_arena_get(&arena, l2_offset, l2_count);
+	struct cpuinfo_cache* l3 = cpuinfo_arena_get(&arena, l3_offset, l3_count);
+	struct cpuinfo_cache* l4 = cpuinfo_arena_get(&arena, l4_offset, l4_count);
+
 	for (uint32_t i = processors_count; i != 0; i--) {
 		const uint32_t processor_id = i - 1;
 		struct cpuinfo_processor* processor = processors + processor_id;
@@ -349,6 +400,7 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		core->vendor = x86_processor.vendor;
 		core->uarch  = x86_processor.uarch;
 		core->cpuid  = x86_processor.cpuid;
+		core->windows_efficiency_class = processors_efficiency_class[core->processor_start];
 
 		/* This can be overwritten by lower-index cores on the same cluster/package */
 		cluster->core_start = global_core_id;
@@ -357,64 +409,27 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		package->core_count += 1;
 	}
 
-	for (uint32_t i = 0; i < packages_count; i++) {
-		struct cpuinfo_package* package = packages + i;
-		struct cpuinfo_cluster* cluster = clusters + i;
+	for (uint32_t i = clusters_count; i != 0; i--) {
+		const uint32_t cluster_index = i - 1;
+		struct cpuinfo_cluster* cluster = clusters + cluster_index;
+		struct cpuinfo_package* package = (struct cpuinfo_package*) cores[cluster->core_start].package;
 
 		cluster->package = package;
 		cluster->vendor = cores[cluster->core_start].vendor;
 		cluster->uarch = cores[cluster->core_start].uarch;
 		cluster->cpuid = cores[cluster->core_start].cpuid;
-		package->cluster_start = i;
-		package->cluster_count = 1;
-		cpuinfo_x86_format_package_name(x86_processor.vendor, brand_string, package->name);
-	}
-
-	/* Count caches */
-	uint32_t l1i_count, l1d_count, l2_count, l3_count, l4_count;
-	cpuinfo_x86_count_caches(processors_count, processors, &x86_processor,
-		&l1i_count, &l1d_count, &l2_count, &l3_count, &l4_count);
 
-	/* Allocate cache descriptions */
-	if (l1i_count != 0) {
-		l1i = HeapAlloc(heap, HEAP_ZERO_MEMORY, l1i_count * sizeof(struct cpuinfo_cache));
-		if (l1i == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1I caches",
-				l1i_count * sizeof(struct cpuinfo_cache), l1i_count);
-			goto cleanup;
-		}
-	}
-	if (l1d_count != 0) {
-		l1d = HeapAlloc(heap, HEAP_ZERO_MEMORY, l1d_count * sizeof(struct cpuinfo_cache));
-		if (l1d == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L1D caches",
-				l1d_count * sizeof(struct cpuinfo_cache), l1d_count);
-			goto cleanup;
-		}
+		/* This can be overwritten by lower-index clusters on the same package */
+		package->cluster_start = cluster_index;
+		package->cluster_count += 1;
 	}
-	if (l2_count != 0) {
-		l2 = HeapAlloc(heap, HEAP_ZERO_MEMORY, l2_count * sizeof(struct cpuinfo_cache));
-		if (l2 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L2 caches",
-				l2_count * sizeof(struct cpuinfo_cache), l2_count);
-			goto cleanup;
-		}
-	}
-	if (l3_count != 0) {
-		l3 = HeapAlloc(heap, HEAP_ZERO_MEMORY, l3_count * sizeof(struct cpuinfo_cache));
-		if (l3 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L3 caches",
-				l3_count * sizeof(struct cpuinfo_cache), l3_count);
-			goto cleanup;
-		}
-	}
-	if (l4_count != 0) {
-		l4 = HeapAlloc(heap, HEAP_ZERO_MEMORY, l4_count * sizeof(struct cpuinfo_cache));
-		if (l4 == NULL) {
-			cpuinfo_log_error("failed to allocate %zu bytes for descriptions of %"PRIu32" L4 caches",
-				l4_count * sizeof(struct cpuinfo_cache), l4_count);
-			goto cleanup;
+
+	for (uint32_t i = 0; i < packages_count; i++) {
+		struct cpuinfo_package* package = packages + i;
+		for (uint32_t j = 0; j < package->cluster_count; j++) {
+			clusters[package->cluster_start + j].cluster_id = j;
 		}
+		cpuinfo_x86_format_package_name(x86_processor.vendor, brand_string, package->name);
 	}
 
 	/* Set cache information */
@@ -515,6 +530,14 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 					.processor_start = i,
 					.processor_count = 1,
 				};
+				/* Caches of other sizes have more sets of the same associativity */
+				const uint32_t l3_size = processors_l3_size[i];
+				const uint32_t l3_set_size =
+					l3[l3_index].associativity * l3[l3_index].partitions * l3[l3_index].line_size;
+				if (l3_size != 0 && l3_size != l3[l3_index].size && l3_set_size != 0) {
+					l3[l3_index].size = l3_size;
+					l3[l3_index].sets = l3_size / l3_set_size;
+				}
 			} else {
 				/* another processor sharing the same cache */
 				l3[l3_index].processor_count += 1;
@@ -551,6 +574,7 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		}
 	}
 
+	cpuinfo_windows_detect_cpu_sets(processors, processors_count);
 
 	/* Commit changes */
 	cpuinfo_processors = processors;
@@ -565,7 +589,7 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 
 	cpuinfo_processors_count = processors_count;
 	cpuinfo_cores_count = cores_count;
-	cpuinfo_clusters_count = packages_count;
+	cpuinfo_clusters_count = clusters_count;
 	cpuinfo_packages_count = packages_count;
 	cpuinfo_cache_count[cpuinfo_cache_level_1i] = l1i_count;
 	cpuinfo_cache_count[cpuinfo_cache_level_1d] = l1d_count;
@@ -580,44 +604,19 @@ BOOL CALLBACK cpuinfo_x86_windows_init(PINIT_ONCE init_once, PVOID parameter, PV
 		.processor_count = processors_count,
 		.core_count = cores_count,
 	};
+	cpuinfo_x86_group_tlbs(&x86_processor.tlb, &cpuinfo_global_uarch_tlbs);
+
+	cpuinfo_arena_memory = arena.memory;
 
 	MemoryBarrier();
 
 	cpuinfo_is_initialized = true;
 
-	processors = NULL;
-	cores = NULL;
-	clusters = NULL;
-	packages = NULL;
-	l1i = l1d = l2 = l3 = l4 = NULL;
+	arena.memory = NULL;
 
 cleanup:
-	if (processors != NULL) {
-		HeapFree(heap, 0, processors);
-	}
-	if (cores != NULL) {
-		HeapFree(heap, 0, cores);
-	}
-	if (clusters != NULL) {
-		HeapFree(heap, 0, clusters);
-	}
-	if (packages != NULL) {
-		HeapFree(heap, 0, packages);
-	}
-	if (l1i != NULL) {
-		HeapFree(heap, 0, l1i);
-	}
-	if (l1d != NULL) {
-		HeapFree(heap, 0, l1d);
-	}
-	if (l2 != NULL) {
-		HeapFree(heap, 0, l2);
-	}
-	if (l3 != NULL) {
-		HeapFree(heap, 0, l3);
-	}
-	if (l4 != NULL) {
-		HeapFree(heap, 0, l4);
-	}
+	cpuinfo_windows_release_topology(&topology);
+	cpuinfo_free_temporary(temporary_processors);
+	cpuinfo_arena_free(arena.memory);
 	return TRUE;
 }
@@ -0,0 +1,75 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	#include <x86/api.h>
+#endif
+#if CPUINFO_ARCH_X86_64 && defined(__linux__)
+	#include <errno.h>
+	#include <string.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+#endif
+#include <cpuinfo/internal-api.h>
+#include <cpuinfo/log.h>
+
+
+#if CPUINFO_ARCH_X86_64 && defined(__linux__)
+	/* Constants from <asm/prctl.h> of Linux 5.16, which older kernel headers lack */
+	#ifndef ARCH_GET_XCOMP_PERM
+		#define ARCH_GET_XCOMP_PERM 0x1022
+	#endif
+	#ifndef ARCH_REQ_XCOMP_PERM
+		#define ARCH_REQ_XCOMP_PERM 0x1023
+	#endif
+	#define XFEATURE_XTILEDATA 18
+#endif
+
+bool CPUINFO_ABI cpuinfo_request_x86_amx_permission(void) {
+	#if CPUINFO_ARCH_X86_64
+		if (!cpuinfo_has_x86_amx_tile()) {
+			return false;
+		}
+		#if defined(__linux__)
+			uint64_t permitted_features = 0;
+			if (syscall(SYS_arch_prctl, ARCH_GET_XCOMP_PERM, &permitted_features) == 0 &&
+				(permitted_features & (UINT64_C(1) << XFEATURE_XTILEDATA)) != 0)
+			{
+				return true;
+			}
+			if (syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) != 0) {
+				cpuinfo_log_warning("failed to request permission for AMX tile data: %s", strerror(errno));
+				return false;
+			}
+			cpuinfo_log_debug("granted permission for AMX tile data");
+		#endif
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+void cpuinfo_detect_xsave_state(struct cpuinfo_tables* tables) {
+	tables->xsave_state = (struct cpuinfo_x86_xsave_state) { 0 };
+	for (uint32_t i = 0; i < cpuinfo_x86_vector_extension_max; i++) {
+		tables->xsave_state.extensions[i].reason = cpuinfo_x86_vector_extension_reason_unsupported;
+	}
+	#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		cpuinfo_x86_detect_xsave_state(&tables->xsave_state);
+	#endif
+	cpuinfo_log_debug("XSAVE features 0x%016"PRIx64", XSAVE area size %"PRIu32" bytes",
+		tables->xsave_state.features, tables->xsave_state.size);
+	for (uint32_t i = 0; i < cpuinfo_x86_vector_extension_max; i++) {
+		const struct cpuinfo_x86_vector_extension_state* extension = &tables->xsave_state.extensions[i];
+		if (extension->supported && !extension->enabled) {
+			cpuinfo_log_info("vector extension %"PRIu32" is supported by the processor, but disabled (reason %d)",
+				i, (int) extension->reason);
+		}
+	}
+}
+
+const struct cpuinfo_x86_xsave_state* CPUINFO_ABI cpuinfo_get_x86_xsave_state(void) {
+	return &cpuinfo_get_tables("x86_xsave_state")->xsave_state;
+}
@@ -1,7 +1,2775 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <cpuinfo.h>
+#include <cpuinfo.hpp>
+
+#if defined(__linux__)
+	#include <dirent.h>
+	#include <fcntl.h>
+	#include <sched.h>
+	#include <stdlib.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/wait.h>
+#endif
+
+
+/* Must run before any test that calls cpuinfo_initialize to exercise deferred initialization */
+TEST(INITIALIZE_EX, isa_then_topology) {
+	ASSERT_TRUE(cpuinfo_initialize_ex(CPUINFO_INIT_ISA));
+	EXPECT_NE(0, cpuinfo_get_processors_count());
+	EXPECT_TRUE(cpuinfo_get_processors());
+	cpuinfo_deinitialize();
+}
+
+#if defined(__linux__)
+TEST(SNAPSHOT, save_and_load) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	char path[] = "/tmp/cpuinfo-snapshot-test-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	EXPECT_TRUE(cpuinfo_save_snapshot(path));
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	const uint32_t cores_count = cpuinfo_get_cores_count();
+	cpuinfo_deinitialize();
+
+	EXPECT_TRUE(cpuinfo_initialize_from_snapshot(path));
+	EXPECT_EQ(processors_count, cpuinfo_get_processors_count());
+	EXPECT_EQ(cores_count, cpuinfo_get_cores_count());
+	unlink(path);
+	cpuinfo_deinitialize();
+}
+
+TEST(CAPTURE, save_and_replay) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	char path[] = "/tmp/cpuinfo-capture-test-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	EXPECT_TRUE(cpuinfo_save_snapshot(path));
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	const uint32_t l1d_caches_count = cpuinfo_get_l1d_caches_count();
+	EXPECT_FALSE(cpuinfo_initialize_from_capture(path));
+	cpuinfo_deinitialize();
+
+	ASSERT_TRUE(cpuinfo_initialize_from_capture(path));
+	EXPECT_EQ(processors_count, cpuinfo_get_processors_count());
+	EXPECT_EQ(l1d_caches_count, cpuinfo_get_l1d_caches_count());
+	EXPECT_EQ(processors_count, cpuinfo_get_usable_processors_count());
+	EXPECT_EQ(1, cpuinfo_get_numa_nodes_count());
+	EXPECT_EQ(1, cpuinfo_get_frequency_domains_count());
+	unlink(path);
+	cpuinfo_deinitialize();
+	EXPECT_FALSE(cpuinfo_initialize_from_capture(path));
+}
+
+TEST(INITIALIZE_INTO, caller_buffer) {
+	cpuinfo_deinitialize();
+	const size_t size = cpuinfo_query_buffer_size();
+	ASSERT_NE(0, size);
+	EXPECT_FALSE(cpuinfo_is_ready());
+
+	std::vector<char> buffer(size);
+	ASSERT_TRUE(cpuinfo_initialize_into(buffer.data(), buffer.size()));
+	const char* processors = reinterpret_cast<const char*>(cpuinfo_get_processors());
+	EXPECT_GE(processors, buffer.data());
+	EXPECT_LT(processors, buffer.data() + buffer.size());
+	EXPECT_NE(0, cpuinfo_get_processors_count());
+	EXPECT_FALSE(cpuinfo_initialize_into(buffer.data(), buffer.size()));
+	cpuinfo_deinitialize();
+
+	char small_buffer[64];
+	EXPECT_FALSE(cpuinfo_initialize_into(small_buffer, sizeof(small_buffer)));
+	cpuinfo_deinitialize();
+}
+
+struct hook_counters {
+	uint32_t allocations;
+	uint32_t deallocations;
+	uint32_t opens;
+	uint32_t closes;
+};
+
+static void* counting_allocate(void* context, size_t size, size_t alignment) {
+	void* memory = nullptr;
+	if (posix_memalign(&memory, alignment < sizeof(void*) ? sizeof(void*) : alignment, size == 0 ? 1 : size) != 0) {
+		return nullptr;
+	}
+	static_cast<hook_counters*>(context)->allocations += 1;
+	return memory;
+}
+
+static void counting_deallocate(void* context, void* memory) {
+	static_cast<hook_counters*>(context)->deallocations += 1;
+	free(memory);
+}
+
+static int counting_open(void* context, const char* path, int flags) {
+	const int file = open(path, flags);
+	if (file != -1) {
+		static_cast<hook_counters*>(context)->opens += 1;
+	}
+	return file;
+}
+
+static ptrdiff_t counting_read(void* context, int file, void* buffer, size_t size) {
+	return read(file, buffer, size);
+}
+
+static void counting_close(void* context, int file) {
+	static_cast<hook_counters*>(context)->closes += 1;
+	close(file);
+}
+
+TEST(HOOKS, allocator_and_file_ops) {
+	cpuinfo_deinitialize();
+	hook_counters counters = { 0 };
+	const cpuinfo_allocator allocator = { counting_allocate, counting_deallocate, &counters };
+	const cpuinfo_file_ops file_ops = { counting_open, counting_read, counting_close, &counters };
+	ASSERT_TRUE(cpuinfo_set_allocator(&allocator));
+	ASSERT_TRUE(cpuinfo_set_file_ops(&file_ops));
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_NE(0, cpuinfo_get_processors_count());
+	EXPECT_NE(0, counters.allocations);
+	EXPECT_NE(0, counters.opens);
+	EXPECT_EQ(counters.opens, counters.closes);
+	EXPECT_FALSE(cpuinfo_set_allocator(nullptr));
+	EXPECT_FALSE(cpuinfo_set_file_ops(nullptr));
+	cpuinfo_deinitialize();
+	EXPECT_EQ(counters.allocations, counters.deallocations);
+
+	const cpuinfo_file_ops incomplete_ops = { counting_open, nullptr, counting_close, &counters };
+	EXPECT_FALSE(cpuinfo_set_file_ops(&incomplete_ops));
+	EXPECT_TRUE(cpuinfo_set_allocator(nullptr));
+	EXPECT_TRUE(cpuinfo_set_file_ops(nullptr));
+
+	/* Hooks are fixed from the start of background initialization, even before its thread runs */
+	const uint32_t opens = counters.opens;
+	ASSERT_TRUE(cpuinfo_initialize_async(0));
+	EXPECT_FALSE(cpuinfo_set_allocator(&allocator));
+	EXPECT_FALSE(cpuinfo_set_file_ops(&file_ops));
+	ASSERT_TRUE(cpuinfo_wait());
+	cpuinfo_deinitialize();
+	EXPECT_EQ(opens, counters.opens);
+}
+
+struct log_counters {
+	uint32_t messages;
+	cpuinfo_log_level max_level;
+};
+
+static void counting_log(void* context, cpuinfo_log_level level, const char* format, va_list args) {
+	log_counters* counters = static_cast<log_counters*>(context);
+	counters->messages += 1;
+	counters->max_level = std::max(counters->max_level, level);
+}
+
+TEST(LOG, level_and_callback) {
+	cpuinfo_deinitialize();
+	log_counters counters = { 0, cpuinfo_log_level_none };
+	cpuinfo_set_log_callback(counting_log, &counters);
+	char small_buffer[64];
+
+	ASSERT_TRUE(cpuinfo_set_log_level(cpuinfo_log_level_none));
+	EXPECT_FALSE(cpuinfo_initialize_into(small_buffer, sizeof(small_buffer)));
+	EXPECT_EQ(0, counters.messages);
+
+	ASSERT_TRUE(cpuinfo_set_log_level(cpuinfo_log_level_error));
+	EXPECT_FALSE(cpuinfo_initialize_into(small_buffer, sizeof(small_buffer)));
+	EXPECT_NE(0, counters.messages);
+	EXPECT_LE(counters.max_level, cpuinfo_log_level_error);
+
+	EXPECT_FALSE(cpuinfo_set_log_level(static_cast<cpuinfo_log_level>(cpuinfo_log_level_debug + 1)));
+	cpuinfo_set_log_callback(nullptr, nullptr);
+	cpuinfo_deinitialize();
+}
+
+TEST(MEMORY_USAGE, tables_and_transient) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_memory_usage usage;
+	cpuinfo_get_memory_usage(&usage);
+	EXPECT_EQ(cpuinfo_get_processors_count() * sizeof(cpuinfo_processor), usage.processors);
+	EXPECT_EQ(cpuinfo_get_cores_count() * sizeof(cpuinfo_core), usage.cores);
+	EXPECT_NE(0, usage.linux_cpu_maps);
+	EXPECT_EQ(usage.processors + usage.cores + usage.clusters + usage.packages + usage.caches + usage.uarchs +
+		usage.linux_cpu_maps + usage.processor_columns, usage.total);
+	EXPECT_NE(0, usage.transient);
+}
+
+TEST(UTILIZATION_SAMPLER, sample) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_utilization_sampler* sampler = cpuinfo_create_utilization_sampler();
+	ASSERT_TRUE(sampler);
+	usleep(50000);
+	ASSERT_TRUE(cpuinfo_sample_utilization(sampler));
+	cpuinfo_utilization utilization;
+	ASSERT_TRUE(cpuinfo_get_processors_utilization(sampler, 0, cpuinfo_get_processors_count(), &utilization));
+	EXPECT_NE(0, utilization.processors_count);
+	EXPECT_LE(utilization.processors_count, cpuinfo_get_processors_count());
+	EXPECT_NE(0, utilization.busy_ns + utilization.idle_ns + utilization.steal_ns);
+
+	cpuinfo_utilization domain_utilization;
+	EXPECT_TRUE(cpuinfo_get_llc_domain_utilization(sampler, 0, &domain_utilization));
+	EXPECT_FALSE(cpuinfo_get_llc_domain_utilization(sampler, cpuinfo_get_llc_domains_count(), &domain_utilization));
+	EXPECT_FALSE(cpuinfo_get_processors_utilization(sampler, cpuinfo_get_processors_count(), 1, &utilization));
+	cpuinfo_destroy_utilization_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(THREAD_SCHEDULE_SAMPLER, current_thread) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_thread_schedule_sampler* sampler = cpuinfo_create_thread_schedule_sampler(0);
+	ASSERT_TRUE(sampler);
+	/* Spin, so that the thread has run time to attribute */
+	volatile uint64_t counter = 0;
+	for (uint32_t i = 0; i < 20000000; i++) {
+		counter = counter + i;
+	}
+	ASSERT_TRUE(cpuinfo_sample_thread_schedules(sampler));
+	const uint32_t thread_id = (uint32_t) gettid();
+	const cpuinfo_thread_schedule* current = nullptr;
+	uint32_t current_index = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_thread_schedules_count(sampler); i++) {
+		const cpuinfo_thread_schedule* schedule = cpuinfo_get_thread_schedule(sampler, i);
+		ASSERT_TRUE(schedule);
+		if (schedule->thread_id == thread_id) {
+			current = schedule;
+			current_index = i;
+		}
+	}
+	ASSERT_TRUE(current);
+	EXPECT_TRUE(current->alive);
+	EXPECT_NE(0, current->run_ns);
+	EXPECT_EQ(current->run_ns, current->total_run_ns);
+	ASSERT_TRUE(current->processor);
+	EXPECT_EQ(current->total_run_ns,
+		cpuinfo_get_thread_cores_run_time(sampler, current_index, 0, cpuinfo_get_cores_count()));
+	uint64_t uarchs_run_ns = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		uarchs_run_ns += cpuinfo_get_thread_uarch_run_time(sampler, current_index, i);
+	}
+	EXPECT_EQ(current->total_run_ns, uarchs_run_ns);
+	EXPECT_FALSE(cpuinfo_get_thread_schedule(sampler, cpuinfo_get_thread_schedules_count(sampler)));
+	cpuinfo_destroy_thread_schedule_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(ENERGY_SAMPLER, monotonic) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* RAPL may be missing in virtual machines, and energy_uj is readable only by root on recent kernels */
+	cpuinfo_energy_sampler* sampler = cpuinfo_create_energy_sampler();
+	cpuinfo_energy_sample first, second;
+	if (sampler != nullptr) {
+		ASSERT_TRUE(cpuinfo_sample_package_energy(sampler, 0, &first));
+		usleep(10000);
+		ASSERT_TRUE(cpuinfo_sample_package_energy(sampler, 0, &second));
+		EXPECT_EQ(first.domains, second.domains);
+		EXPECT_GE(second.energy_uj[cpuinfo_energy_domain_package], first.energy_uj[cpuinfo_energy_domain_package]);
+		EXPECT_FALSE(cpuinfo_sample_package_energy(sampler, cpuinfo_get_packages_count(), &second));
+		EXPECT_EQ(0, second.domains);
+	}
+	EXPECT_FALSE(cpuinfo_sample_package_energy(nullptr, 0, &first));
+	cpuinfo_destroy_energy_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(LLC_MONITORING_SAMPLER, l3_caches) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* resctrl is mounted only on systems which partition or monitor shared caches */
+	cpuinfo_llc_monitoring_sampler* sampler = cpuinfo_create_llc_monitoring_sampler(nullptr);
+	cpuinfo_llc_monitoring_sample sample;
+	if (sampler != nullptr) {
+		for (uint32_t i = 0; i < cpuinfo_get_l3_caches_count(); i++) {
+			if (cpuinfo_sample_llc_monitoring(sampler, i, &sample) &&
+				(sample.events & (UINT32_C(1) << cpuinfo_llc_monitoring_event_occupancy)) != 0)
+			{
+				EXPECT_LE(sample.occupancy, cpuinfo_get_l3_cache(i)->size);
+			}
+		}
+		EXPECT_FALSE(cpuinfo_sample_llc_monitoring(sampler, cpuinfo_get_l3_caches_count(), &sample));
+		EXPECT_EQ(0, sample.events);
+	}
+	EXPECT_FALSE(cpuinfo_create_llc_monitoring_sampler("nonexistent-group"));
+	EXPECT_FALSE(cpuinfo_sample_llc_monitoring(nullptr, 0, &sample));
+	cpuinfo_destroy_llc_monitoring_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(PERCPU_COUNTER, sum) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_percpu_counter* counter = cpuinfo_create_percpu_counter();
+	ASSERT_TRUE(counter);
+	EXPECT_EQ(0, cpuinfo_percpu_counter_read(counter));
+	for (int64_t i = 1; i <= 1000; i++) {
+		cpuinfo_percpu_counter_add(counter, i);
+	}
+	cpuinfo_percpu_counter_add(counter, -500);
+	EXPECT_EQ(500000, cpuinfo_percpu_counter_read(counter));
+	cpuinfo_destroy_percpu_counter(counter);
+	cpuinfo_deinitialize();
+}
+
+TEST(PERCPU_FREELIST, push_pop) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_percpu_freelist* freelist = cpuinfo_create_percpu_freelist();
+	ASSERT_TRUE(freelist);
+	EXPECT_FALSE(cpuinfo_percpu_freelist_pop(freelist));
+	std::vector<cpuinfo_percpu_freelist_node> nodes(16);
+	for (cpuinfo_percpu_freelist_node& node : nodes) {
+		cpuinfo_percpu_freelist_push(freelist, &node);
+	}
+	/* The thread may migrate between operations, and pop only from the shards of its current processor */
+	std::set<const cpuinfo_percpu_freelist_node*> popped;
+	while (cpuinfo_percpu_freelist_node* node = cpuinfo_percpu_freelist_pop(freelist)) {
+		EXPECT_TRUE(popped.insert(node).second);
+		EXPECT_GE(node, nodes.data());
+		EXPECT_LT(node, nodes.data() + nodes.size());
+	}
+	if (!cpuinfo_percpu_is_restartable()) {
+		EXPECT_EQ(nodes.size(), popped.size());
+	}
+	cpuinfo_destroy_percpu_freelist(freelist);
+	cpuinfo_deinitialize();
+}
+
+TEST(PERCPU_COUNTER, concurrent_add) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_percpu_counter* counter = cpuinfo_create_percpu_counter();
+	ASSERT_TRUE(counter);
+	const int64_t threads_count = 8;
+	const int64_t iterations = 100000;
+	std::vector<std::thread> threads;
+	for (int64_t t = 0; t < threads_count; t++) {
+		threads.emplace_back([counter, iterations]() {
+			for (int64_t i = 0; i < iterations; i++) {
+				cpuinfo_percpu_counter_add(counter, 1);
+				/* Yield now and then so that threads migrate between processors mid-run */
+				if (i % 1024 == 0) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(threads_count * iterations, cpuinfo_percpu_counter_read(counter));
+	cpuinfo_destroy_percpu_counter(counter);
+	cpuinfo_deinitialize();
+}
+
+/* The node comes first, so that popped nodes convert back to the tracked object */
+struct tracked_node {
+	cpuinfo_percpu_freelist_node node;
+	std::atomic<bool> in_list;
+};
+
+TEST(PERCPU_FREELIST, concurrent_push_pop) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_percpu_freelist* freelist = cpuinfo_create_percpu_freelist();
+	ASSERT_TRUE(freelist);
+	const size_t threads_count = 8;
+	const size_t nodes_per_thread = 64;
+	const size_t iterations = 20000;
+	std::vector<tracked_node> nodes(threads_count * nodes_per_thread);
+	std::atomic<size_t> double_pops(0);
+	std::atomic<size_t> foreign_pops(0);
+	std::vector<std::vector<tracked_node*>> held(threads_count);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < threads_count; t++) {
+		threads.emplace_back([&, t]() {
+			std::vector<tracked_node*>& own = held[t];
+			for (size_t n = 0; n < nodes_per_thread; n++) {
+				own.push_back(&nodes[t * nodes_per_thread + n]);
+			}
+			for (size_t i = 0; i < iterations; i++) {
+				/* Alternate bursts of pushes and pops, so that shards fill up and drain while threads migrate */
+				if (!own.empty() && (i / 16) % 2 == 0) {
+					tracked_node* node = own.back();
+					own.pop_back();
+					node->in_list = true;
+					cpuinfo_percpu_freelist_push(freelist, &node->node);
+				} else if (cpuinfo_percpu_freelist_node* popped = cpuinfo_percpu_freelist_pop(freelist)) {
+					tracked_node* node = reinterpret_cast<tracked_node*>(popped);
+					if (node < nodes.data() || node >= nodes.data() + nodes.size()) {
+						foreign_pops++;
+						continue;
+					}
+					/* A node which two threads popped, or which was popped without being pushed, is already out of the list */
+					if (!node->in_list.exchange(false)) {
+						double_pops++;
+					}
+					own.push_back(node);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(0, foreign_pops.load());
+	EXPECT_EQ(0, double_pops.load());
+
+	std::set<const tracked_node*> seen;
+	for (const std::vector<tracked_node*>& own : held) {
+		for (const tracked_node* node : own) {
+			EXPECT_FALSE(node->in_list.load());
+			EXPECT_TRUE(seen.insert(node).second);
+		}
+	}
+	/* Drain the list, visiting every processor when nodes may remain in the shards of other processors */
+	std::vector<cpuinfo_percpu_freelist_node*> drained;
+	while (cpuinfo_percpu_freelist_node* node = cpuinfo_percpu_freelist_pop(freelist)) {
+		drained.push_back(node);
+	}
+#if defined(__linux__)
+	if (cpuinfo_percpu_is_restartable()) {
+		cpu_set_t original_affinity;
+		ASSERT_EQ(0, sched_getaffinity(0, sizeof(original_affinity), &original_affinity));
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (!CPU_ISSET(cpu, &original_affinity)) {
+				continue;
+			}
+			cpu_set_t affinity;
+			CPU_ZERO(&affinity);
+			CPU_SET(cpu, &affinity);
+			if (sched_setaffinity(0, sizeof(affinity), &affinity) != 0) {
+				continue;
+			}
+			while (cpuinfo_percpu_freelist_node* node = cpuinfo_percpu_freelist_pop(freelist)) {
+				drained.push_back(node);
+			}
+		}
+		EXPECT_EQ(0, sched_setaffinity(0, sizeof(original_affinity), &original_affinity));
+	}
+#endif
+	for (cpuinfo_percpu_freelist_node* popped : drained) {
+		const tracked_node* node = reinterpret_cast<const tracked_node*>(popped);
+		ASSERT_GE(node, nodes.data());
+		ASSERT_LT(node, nodes.data() + nodes.size());
+		EXPECT_TRUE(node->in_list.load());
+		EXPECT_TRUE(seen.insert(node).second);
+	}
+	EXPECT_EQ(nodes.size(), seen.size());
+	cpuinfo_destroy_percpu_freelist(freelist);
+	cpuinfo_deinitialize();
+}
+
+TEST(CAPABILITY_MONITOR, update) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* Thermal netlink events may be unavailable or require privileges */
+	cpuinfo_capability_monitor* monitor = cpuinfo_create_capability_monitor();
+	if (monitor != nullptr) {
+		EXPECT_NE(-1, cpuinfo_get_capability_monitor_fd(monitor));
+		cpuinfo_update_core_capabilities(monitor);
+		cpuinfo_core_capability capability;
+		EXPECT_TRUE(cpuinfo_get_core_capability(monitor, cpuinfo_get_core(0), &capability));
+		EXPECT_FALSE(cpuinfo_get_core_capability(monitor, nullptr, &capability));
+	}
+	EXPECT_EQ(0, cpuinfo_update_core_capabilities(nullptr));
+	EXPECT_EQ(-1, cpuinfo_get_capability_monitor_fd(nullptr));
+	cpuinfo_destroy_capability_monitor(monitor);
+	cpuinfo_deinitialize();
+}
+
+TEST(MEMORY_PERFORMANCE, probe_and_restore) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_FALSE(cpuinfo_get_uarch_memory_performance(0));
+	ASSERT_TRUE(cpuinfo_probe_memory_performance());
+	const cpuinfo_memory_performance* performance = cpuinfo_get_uarch_memory_performance(0);
+	ASSERT_TRUE(performance);
+	EXPECT_NE(0, performance->memory_latency);
+	EXPECT_NE(0, performance->memory_bandwidth);
+	EXPECT_NE(0, performance->all_cores_memory_bandwidth);
+	if (performance->l1d_latency != 0) {
+		EXPECT_LT(performance->l1d_latency, performance->memory_latency);
+	}
+	EXPECT_FALSE(cpuinfo_get_uarch_memory_performance(cpuinfo_get_uarchs_count()));
+	const uint32_t memory_latency = performance->memory_latency;
+
+	char path[] = "/tmp/cpuinfo-snapshot-test-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	EXPECT_TRUE(cpuinfo_save_snapshot(path));
+	cpuinfo_deinitialize();
+
+	EXPECT_TRUE(cpuinfo_initialize_from_snapshot(path));
+	performance = cpuinfo_get_uarch_memory_performance(0);
+	ASSERT_TRUE(performance);
+	EXPECT_EQ(memory_latency, performance->memory_latency);
+	unlink(path);
+	cpuinfo_deinitialize();
+}
+
+TEST(CORE_LATENCIES, probe_and_restore) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_FALSE(cpuinfo_get_core_latencies());
+	ASSERT_TRUE(cpuinfo_probe_core_latencies());
+	const uint32_t* latencies = cpuinfo_get_core_latencies();
+	ASSERT_TRUE(latencies);
+	const uint32_t cores_count = cpuinfo_get_cores_count();
+	for (uint32_t i = 0; i < cores_count; i++) {
+		for (uint32_t j = 0; j < cores_count; j++) {
+			if (i != j) {
+				EXPECT_NE(0, latencies[i * cores_count + j]);
+				EXPECT_EQ(latencies[i * cores_count + j], latencies[j * cores_count + i]);
+			}
+		}
+	}
+	EXPECT_EQ(0, cpuinfo_get_processor_latency(cpuinfo_get_processor(0), cpuinfo_get_processor(0)));
+	if (cores_count > 1) {
+		EXPECT_EQ(latencies[1], cpuinfo_get_processor_latency(cpuinfo_get_processor(0),
+			cpuinfo_get_core(1)->processor_start + cpuinfo_get_processor(0)));
+	}
+
+	char path[] = "/tmp/cpuinfo-snapshot-test-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	EXPECT_TRUE(cpuinfo_save_snapshot(path));
+	const uint32_t latency = cores_count > 1 ? latencies[1] : 0;
+	cpuinfo_deinitialize();
+
+	EXPECT_TRUE(cpuinfo_initialize_from_snapshot(path));
+	latencies = cpuinfo_get_core_latencies();
+	ASSERT_TRUE(latencies);
+	if (cores_count > 1) {
+		EXPECT_EQ(latency, latencies[1]);
+	}
+	unlink(path);
+	cpuinfo_deinitialize();
+}
+
+#if CPUINFO_ARCH_X86_64 || CPUINFO_ARCH_ARM64
+TEST(INSTRUCTION_PERFORMANCE, probe_and_cache) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	char directory[] = "/tmp/cpuinfo-tuning-XXXXXX";
+	ASSERT_TRUE(mkdtemp(directory));
+	ASSERT_TRUE(cpuinfo_set_tuning_cache_directory(directory));
+	EXPECT_FALSE(cpuinfo_get_uarch_instruction_performance(0));
+	ASSERT_TRUE(cpuinfo_probe_instruction_performance());
+	const cpuinfo_instruction_performance* performance = cpuinfo_get_uarch_instruction_performance(0);
+	ASSERT_TRUE(performance);
+	EXPECT_NE(0, performance->frequency);
+	EXPECT_NE(0, performance->load.latency);
+	if (performance->vector_width != 0) {
+		EXPECT_NE(0, performance->load.throughput);
+		EXPECT_NE(0, performance->shuffle.throughput);
+	}
+	EXPECT_FALSE(cpuinfo_get_uarch_instruction_performance(cpuinfo_get_uarchs_count()));
+	const uint64_t frequency = performance->frequency;
+	const uint32_t load_latency = performance->load.latency;
+	cpuinfo_deinitialize();
+
+	/* The second probe takes the measurements from the tuning cache */
+	ASSERT_TRUE(cpuinfo_initialize());
+	ASSERT_TRUE(cpuinfo_probe_instruction_performance());
+	performance = cpuinfo_get_uarch_instruction_performance(0);
+	ASSERT_TRUE(performance);
+	EXPECT_EQ(frequency, performance->frequency);
+	EXPECT_EQ(load_latency, performance->load.latency);
+
+	char path[sizeof(directory) + 64];
+	snprintf(path, sizeof(path), "%s/tuning-%016llx.bin", directory,
+		(unsigned long long) cpuinfo_hardware_fingerprint());
+	EXPECT_EQ(0, unlink(path));
+	EXPECT_EQ(0, rmdir(directory));
+	EXPECT_TRUE(cpuinfo_set_tuning_cache_directory(nullptr));
+	cpuinfo_deinitialize();
+}
+#endif
+#endif
+
+#if defined(__linux__) && !defined(__ANDROID__)
+TEST(SHARED_SNAPSHOT, publish_and_attach) {
+	const std::string name = "/cpuinfo-shared-test-" + std::to_string(getpid());
+	shm_unlink(name.c_str());
+	ASSERT_TRUE(cpuinfo_initialize_shared(name.c_str()));
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	const uint32_t cores_count = cpuinfo_get_cores_count();
+	const uint32_t l1d_caches_count = cpuinfo_get_l1d_caches_count();
+	cpuinfo_deinitialize();
+
+	/* The first initialization published the segment, and the second one attaches to it */
+	const int segment = shm_open(name.c_str(), O_RDONLY, 0);
+	ASSERT_NE(-1, segment);
+	close(segment);
+	ASSERT_TRUE(cpuinfo_initialize_shared(name.c_str()));
+	EXPECT_EQ(processors_count, cpuinfo_get_processors_count());
+	EXPECT_EQ(cores_count, cpuinfo_get_cores_count());
+	EXPECT_EQ(l1d_caches_count, cpuinfo_get_l1d_caches_count());
+	EXPECT_EQ(cpuinfo_get_core(0), cpuinfo_get_processor(0)->core);
+	EXPECT_EQ(cpuinfo_get_l1d_cache(0), cpuinfo_get_processor(0)->cache.l1d);
+	cpuinfo_deinitialize();
+	shm_unlink(name.c_str());
+}
+
+/*
+ * Start processes which initialize from the shared snapshot at the same time, and return the inodes of the segments
+ * they see after initialization, or 0 for the processes which failed.
+ */
+static std::vector<ino_t> initialize_shared_concurrently(const std::string& name, uint32_t processes_count) {
+	int start_pipe[2], result_pipe[2];
+	if (pipe(start_pipe) != 0 || pipe(result_pipe) != 0) {
+		return {};
+	}
+	for (uint32_t i = 0; i < processes_count; i++) {
+		if (fork() == 0) {
+			close(start_pipe[1]);
+			char start;
+			ino_t inode = 0;
+			if (read(start_pipe[0], &start, 1) == 0 && cpuinfo_initialize_shared(name.c_str())) {
+				const int segment = shm_open(name.c_str(), O_RDONLY, 0);
+				struct stat segment_stat;
+				if (segment != -1 && fstat(segment, &segment_stat) == 0) {
+					inode = segment_stat.st_ino;
+				}
+			}
+			_exit(write(result_pipe[1], &inode, sizeof(inode)) == (ssize_t) sizeof(inode) ? 0 : 1);
+		}
+	}
+	close(result_pipe[1]);
+	/* Closing the write end releases all processes at once */
+	close(start_pipe[1]);
+	close(start_pipe[0]);
+	std::vector<ino_t> inodes(processes_count);
+	for (ino_t& inode : inodes) {
+		if (read(result_pipe[0], &inode, sizeof(inode)) != (ssize_t) sizeof(inode)) {
+			inode = 0;
+		}
+	}
+	close(result_pipe[0]);
+	while (wait(nullptr) > 0) {
+	}
+	return inodes;
+}
+
+TEST(SHARED_SNAPSHOT, concurrent_publishers) {
+	const std::string name = "/cpuinfo-shared-race-test-" + std::to_string(getpid());
+	shm_unlink(name.c_str());
+
+	/* Processes which race to publish the segment attach to the same one */
+	const std::vector<ino_t> inodes = initialize_shared_concurrently(name, 4);
+	ASSERT_EQ(4, inodes.size());
+	struct stat segment_stat;
+	int segment = shm_open(name.c_str(), O_RDONLY, 0);
+	ASSERT_NE(-1, segment);
+	ASSERT_EQ(0, fstat(segment, &segment_stat));
+	close(segment);
+	for (ino_t inode : inodes) {
+		EXPECT_EQ(segment_stat.st_ino, inode);
+	}
+	ASSERT_TRUE(cpuinfo_initialize_shared(name.c_str()));
+	EXPECT_NE(0, cpuinfo_get_processors_count());
+	cpuinfo_deinitialize();
+	shm_unlink(name.c_str());
+
+	/* A segment which another process is still publishing is not replaced */
+	segment = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	ASSERT_NE(-1, segment);
+	ASSERT_EQ(0, fstat(segment, &segment_stat));
+	for (ino_t inode : initialize_shared_concurrently(name, 2)) {
+		EXPECT_EQ(segment_stat.st_ino, inode);
+	}
+
+	/* A segment which stays unpublished long after its last modification is replaced */
+	const struct timespec abandoned_times[2] = { { 0, UTIME_OMIT }, { time(nullptr) - 3600, 0 } };
+	ASSERT_EQ(0, futimens(segment, abandoned_times));
+	close(segment);
+	ASSERT_TRUE(cpuinfo_initialize_shared(name.c_str()));
+	cpuinfo_deinitialize();
+	segment = shm_open(name.c_str(), O_RDONLY, 0);
+	ASSERT_NE(-1, segment);
+	struct stat replaced_stat;
+	ASSERT_EQ(0, fstat(segment, &replaced_stat));
+	close(segment);
+	EXPECT_NE(segment_stat.st_ino, replaced_stat.st_ino);
+	EXPECT_NE(0, replaced_stat.st_size);
+	shm_unlink(name.c_str());
+}
+#endif
+
+TEST(REINITIALIZE, keeps_previous_tables) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const struct cpuinfo_processor* processors = cpuinfo_get_processors();
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	ASSERT_TRUE(cpuinfo_reinitialize());
+	EXPECT_EQ(processors_count, cpuinfo_get_processors_count());
+	EXPECT_NE(processors, cpuinfo_get_processors());
+	/* Tables replaced by re-initialization remain valid until deinitialization */
+	EXPECT_EQ(processors[0].core->processor_start, cpuinfo_get_processors()[0].core->processor_start);
+	cpuinfo_deinitialize();
+
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_EQ(processors_count, cpuinfo_get_processors_count());
+	cpuinfo_deinitialize();
+}
+
+TEST(REINITIALIZE, increases_generation) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint64_t generation = cpuinfo_get_topology_generation();
+	ASSERT_TRUE(cpuinfo_reinitialize());
+	EXPECT_LT(generation, cpuinfo_get_topology_generation());
+	cpuinfo_deinitialize();
+}
+
+TEST(SNAPSHOT, survives_reinitialize) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const struct cpuinfo_topology_snapshot* snapshot = cpuinfo_snapshot_acquire();
+	ASSERT_TRUE(snapshot);
+	EXPECT_EQ(cpuinfo_get_topology_generation(), snapshot->generation);
+	EXPECT_EQ(cpuinfo_get_processors_count(), snapshot->processors_count);
+	EXPECT_EQ(cpuinfo_get_processors(), snapshot->processors);
+	ASSERT_TRUE(cpuinfo_reinitialize());
+	EXPECT_LT(snapshot->generation, cpuinfo_get_topology_generation());
+	EXPECT_EQ(cpuinfo_get_processors_count(), snapshot->processors_count);
+	EXPECT_EQ(snapshot->processors[0].core->processor_start, cpuinfo_get_processors()[0].core->processor_start);
+	cpuinfo_snapshot_release(snapshot);
+	cpuinfo_deinitialize();
+	EXPECT_FALSE(cpuinfo_snapshot_acquire());
+}
+
+#if defined(__linux__)
+static void count_topology_change(uint64_t, void* context) {
+	*static_cast<uint32_t*>(context) += 1;
+}
+
+TEST(TOPOLOGY_CALLBACK, register_unregister) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	uint32_t changes = 0;
+	ASSERT_TRUE(cpuinfo_register_topology_callback(count_topology_change, &changes));
+	EXPECT_TRUE(cpuinfo_unregister_topology_callback(count_topology_change, &changes));
+	EXPECT_FALSE(cpuinfo_unregister_topology_callback(count_topology_change, &changes));
+	ASSERT_TRUE(cpuinfo_register_topology_callback(count_topology_change, &changes));
+	/* Deinitialization unregisters the callback and stops the monitor thread */
+	cpuinfo_deinitialize();
+	EXPECT_EQ(0, changes);
+}
+#endif
+
+TEST(UARCH_TABLE, register) {
+	const std::string table =
+		"# Cortex-X925 as Cortex-X3 with its caches\n"
+		"0x410FD850 0xFF0FFFF0 3 0x00300503 64K/4/64 64K/4/64 2M/8/64 -\n"
+		"\n"
+		"0x410FD870 0xFF0FFFF0 3 0x00300503  # built-in caches of the uarch\n";
+	EXPECT_TRUE(cpuinfo_register_uarch_table(table.data(), table.size()));
+	const std::string malformed[] = {
+		"0x410FD850 0xFF0FFFF0 3\n",
+		"0x410FD850 0xFF0FFFF0 3 0\n",
+		"0x410FD850 0xFF0FFFF0 3 0x00300503 64K/4/64\n",
+		"0x410FD850 0xFF0FFFF0 3 0x00300503 64K/4/48 64K/4/64 - -\n",
+		"0x410FD850 0xFF0FFFF0 3 0x00300503 64K/4/64 64K/4/64 - 8M/16/64\n",
+		/* Associativity times line size overflows 32 bits */
+		"0x410FD400 0xFF0FFFF0 1 1 4096/65536/65536 64K/4/64 - -\n",
+		"0x410FD400 0xFF0FFFF0 1 1 64K/65537/65536 64K/4/64 - -\n",
+	};
+	for (const std::string& line : malformed) {
+		EXPECT_FALSE(cpuinfo_register_uarch_table(line.data(), line.size())) << line;
+	}
+	std::string large;
+	for (uint32_t i = 0; i < CPUINFO_UARCH_TABLE_MAX; i++) {
+		large += "0x410FD850 0xFF0FFFF0 3 0x00300503\n";
+	}
+	EXPECT_FALSE(cpuinfo_register_uarch_table(large.data(), large.size()));
+	EXPECT_TRUE(cpuinfo_register_uarch_table(nullptr, 0));
+	EXPECT_TRUE(cpuinfo_register_uarch_table(large.data(), large.size()));
+	EXPECT_FALSE(cpuinfo_register_uarch_table_file("/nonexistent/uarch-table.txt"));
+	EXPECT_TRUE(cpuinfo_register_uarch_table(nullptr, 0));
+}
+
+TEST(UARCH_TABLE, register_x86) {
+	const std::string table =
+		"1 0x06 0xCC 0-15 0x0010020F  # Panther Lake as Lion Cove\n"
+		"2 0x1A 0x00-0x1F 0x0-0xF 0x0020010B\n";
+	EXPECT_TRUE(cpuinfo_register_x86_uarch_table(table.data(), table.size()));
+	const std::string malformed[] = {
+		"1 0x06 0xCC 0x0010020F\n",
+		"1 0x06 0xCC-0xCB 0-15 0x0010020F\n",
+		"1 0x06 0xCC 0-15 0\n",
+		"1 0x06 0xCC 0-15 0x0010020F 1\n",
+	};
+	for (const std::string& line : malformed) {
+		EXPECT_FALSE(cpuinfo_register_x86_uarch_table(line.data(), line.size())) << line;
+	}
+	EXPECT_TRUE(cpuinfo_register_x86_uarch_table(nullptr, 0));
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	/* Registered entries take priority over the built-in table */
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t cpuid = cpuinfo_get_core(0)->cpuid;
+	const enum cpuinfo_vendor vendor = cpuinfo_get_core(0)->vendor;
+	const enum cpuinfo_uarch uarch = cpuinfo_get_core(0)->uarch;
+	cpuinfo_deinitialize();
+	const uint32_t family = ((cpuid >> 8) & 0xF) + ((cpuid >> 20) & 0xFF);
+	const uint32_t model = ((cpuid >> 4) & 0xF) | ((cpuid >> 12) & 0xF0);
+	const enum cpuinfo_uarch registered =
+		uarch == cpuinfo_uarch_knights_mill ? cpuinfo_uarch_knights_landing : cpuinfo_uarch_knights_mill;
+	char entry[128];
+	snprintf(entry, sizeof(entry), "%d %" PRIu32 " %" PRIu32 " 0-15 %d\n", (int) vendor, family, model,
+		(int) registered);
+	ASSERT_TRUE(cpuinfo_register_x86_uarch_table(entry, strlen(entry)));
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_EQ(registered, cpuinfo_get_core(0)->uarch);
+	cpuinfo_deinitialize();
+	EXPECT_TRUE(cpuinfo_register_x86_uarch_table(nullptr, 0));
+#endif
+}
+
+TEST(CHIPSET_TABLE, register) {
+	const std::string table =
+		"# SM8750 by its board platform\n"
+		"sun Qualcomm Snapdragon 8750\n"
+		"\n"
+		"mt6797 MediaTek MT6797X  # Helio X27\n";
+	EXPECT_TRUE(cpuinfo_register_chipset_table(table.data(), table.size()));
+	const std::string malformed[] = {
+		"sun\n",
+		"sun # Qualcomm Snapdragon 8750\n",
+		std::string(92, 'x') + " Qualcomm Snapdragon 8750\n",
+		"sun " + std::string(48, 'x') + "\n",
+	};
+	for (const std::string& line : malformed) {
+		EXPECT_FALSE(cpuinfo_register_chipset_table(line.data(), line.size())) << line;
+	}
+	std::string large;
+	for (uint32_t i = 0; i < CPUINFO_CHIPSET_TABLE_MAX; i++) {
+		large += "sun Qualcomm Snapdragon 8750\n";
+	}
+	EXPECT_FALSE(cpuinfo_register_chipset_table(large.data(), large.size()));
+	EXPECT_TRUE(cpuinfo_register_chipset_table(nullptr, 0));
+	EXPECT_TRUE(cpuinfo_register_chipset_table(large.data(), large.size()));
+	EXPECT_FALSE(cpuinfo_register_chipset_table_file("/nonexistent/chipset-table.txt"));
+	EXPECT_TRUE(cpuinfo_register_chipset_table(nullptr, 0));
+}
+
+TEST(INITIALIZE_ASYNC, wait) {
+	ASSERT_TRUE(cpuinfo_initialize_async(0));
+	ASSERT_TRUE(cpuinfo_wait());
+	EXPECT_TRUE(cpuinfo_is_ready());
+	EXPECT_NE(0, cpuinfo_get_processors_count());
+	cpuinfo_deinitialize();
+	EXPECT_FALSE(cpuinfo_is_ready());
+}
+
+#if defined(__linux__)
+TEST(INITIALIZE_ASYNC, deinitialize_cancels_pending) {
+	for (uint32_t attempt = 0; attempt < 16; attempt++) {
+		ASSERT_TRUE(cpuinfo_initialize_async(0));
+		ASSERT_TRUE(cpuinfo_wait());
+		cpuinfo_deinitialize();
+		/* The background thread may start only now, and must not initialize cpuinfo again */
+		usleep(10000);
+		EXPECT_FALSE(cpuinfo_is_ready());
+		cpuinfo_deinitialize();
+	}
+}
+#endif
+
+TEST(INITIALIZE_ASYNC, wait_in_getters) {
+	ASSERT_TRUE(cpuinfo_initialize_async(CPUINFO_INIT_WAIT_IN_GETTERS));
+	EXPECT_NE(0, cpuinfo_get_processors_count());
+	EXPECT_TRUE(cpuinfo_is_ready());
+	cpuinfo_deinitialize();
+}
+
+TEST(INIT_STATS, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	struct cpuinfo_init_stats stats;
+	ASSERT_TRUE(cpuinfo_get_init_stats(&stats));
+	uint64_t phases_time_ns = 0;
+	for (uint32_t i = 0; i < cpuinfo_init_phase_max; i++) {
+		phases_time_ns += stats.phase_time_ns[i];
+	}
+	EXPECT_LE(phases_time_ns, stats.total_time_ns);
+#if defined(__linux__)
+	EXPECT_NE(0, stats.files_opened);
+	EXPECT_NE(0, stats.bytes_read);
+#endif
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	EXPECT_NE(0, stats.cpuid_executed);
+	/* Vendor and maximum leaf in leaf 0 are queried by several detectors, and executed once */
+	EXPECT_NE(0, stats.cpuid_cached);
+#endif
+	cpuinfo_deinitialize();
+}
+
+TEST(INIT_STATS, exclude_reads_after_initialization) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	struct cpuinfo_init_stats stats_before;
+	ASSERT_TRUE(cpuinfo_get_init_stats(&stats_before));
+	/* The sampler reads the list of online processors */
+	cpuinfo_frequency_sampler* sampler = cpuinfo_create_frequency_sampler();
+	if (sampler != nullptr) {
+		std::vector<cpuinfo_cluster_capacity> capacities(cpuinfo_get_clusters_count());
+		cpuinfo_sample_cluster_capacities(sampler, 0, cpuinfo_get_clusters_count(), capacities.data());
+		cpuinfo_destroy_frequency_sampler(sampler);
+	}
+	struct cpuinfo_init_stats stats_after;
+	ASSERT_TRUE(cpuinfo_get_init_stats(&stats_after));
+	EXPECT_EQ(stats_before.files_opened, stats_after.files_opened);
+	EXPECT_EQ(stats_before.bytes_read, stats_after.bytes_read);
+	cpuinfo_deinitialize();
+}
+
+#if defined(__linux__)
+TEST(CURRENT_PROCESSOR, matches_sched_getcpu) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t attempt = 0; attempt < 16; attempt++) {
+		const int cpu_before = sched_getcpu();
+		const cpuinfo_processor* current_processor = cpuinfo_get_current_processor();
+		const int cpu_after = sched_getcpu();
+		ASSERT_TRUE(current_processor);
+		if (cpu_before == cpu_after) {
+			EXPECT_EQ(cpu_before, current_processor->linux_id);
+			break;
+		}
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(CURRENT_LOCATION, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	struct cpuinfo_location location;
+	ASSERT_TRUE(cpuinfo_get_current_location(&location));
+	ASSERT_TRUE(location.processor);
+	EXPECT_EQ(location.processor->core, location.core);
+	EXPECT_EQ(location.processor->cluster, location.cluster);
+	EXPECT_EQ(location.processor->package, location.package);
+	EXPECT_LT(location.uarch_index, cpuinfo_get_uarchs_count());
+	if (location.last_level_cache != NULL) {
+		EXPECT_LE(location.last_level_cache->processor_start, location.processor - cpuinfo_get_processors());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(CURRENT_SLOT, dense) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_LT(cpuinfo_get_current_slot(), cpuinfo_get_usable_processors_count());
+	EXPECT_NE(0, cpuinfo_get_llc_slots_count());
+	EXPECT_LE(cpuinfo_get_llc_slots_count(), cpuinfo_get_llc_domains_count());
+	EXPECT_LT(cpuinfo_get_current_llc_slot(), cpuinfo_get_llc_slots_count());
+
+	struct cpuinfo_location location;
+	ASSERT_TRUE(cpuinfo_get_current_location(&location));
+	if (location.processor->usable) {
+		EXPECT_EQ(location.processor, cpuinfo_get_usable_processor(location.slot));
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(MIGRATION_GUARD, stable_uarch) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	struct cpuinfo_migration_guard guard;
+	const uint32_t uarch_index = cpuinfo_migration_guard_enter(&guard);
+	EXPECT_EQ(uarch_index, guard.uarch_index);
+	EXPECT_LT(uarch_index, cpuinfo_get_uarchs_count());
+	for (uint32_t i = 0; i < 100; i++) {
+		const uint32_t previous_uarch_index = guard.uarch_index;
+		if (cpuinfo_migration_guard_check(&guard)) {
+			EXPECT_NE(previous_uarch_index, guard.uarch_index);
+		} else {
+			EXPECT_EQ(previous_uarch_index, guard.uarch_index);
+		}
+		EXPECT_LT(guard.uarch_index, cpuinfo_get_uarchs_count());
+	}
+	if (cpuinfo_get_uarchs_count() == 1) {
+		EXPECT_FALSE(cpuinfo_migration_guard_check(&guard));
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(AFFINITY, pin_current_thread) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpu_set_t original_affinity;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(original_affinity), &original_affinity));
+
+	const cpuinfo_processor* processor = cpuinfo_get_processor(0);
+	const cpuinfo_affinity* affinity = cpuinfo_get_processor_affinity(processor);
+	ASSERT_TRUE(affinity);
+	EXPECT_EQ(0, affinity->processor_start);
+	EXPECT_EQ(1, affinity->processor_count);
+	if (CPU_ISSET(processor->linux_id, &original_affinity)) {
+		EXPECT_TRUE(cpuinfo_pin_current_thread_to_processor(processor));
+		EXPECT_EQ(processor->linux_id, sched_getcpu());
+		EXPECT_TRUE(cpuinfo_pin_current_thread_to_package(processor->package));
+	}
+	EXPECT_FALSE(cpuinfo_get_core_affinity(NULL));
+	EXPECT_EQ(0, sched_setaffinity(0, sizeof(original_affinity), &original_affinity));
+	cpuinfo_deinitialize();
+}
+
+TEST(AFFINITY, thread_pin_guard) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpu_set_t original_affinity;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(original_affinity), &original_affinity));
+
+	const cpuinfo_processor& processor = cpuinfo::processors()[0];
+	if (CPU_ISSET(processor.linux_id, &original_affinity)) {
+		{
+			cpuinfo::thread_pin_guard guard(processor);
+			EXPECT_TRUE(guard.pinned());
+			EXPECT_EQ(processor.linux_id, sched_getcpu());
+		}
+		cpu_set_t restored_affinity;
+		ASSERT_EQ(0, sched_getaffinity(0, sizeof(restored_affinity), &restored_affinity));
+		EXPECT_TRUE(CPU_EQUAL(&original_affinity, &restored_affinity));
+	}
+	cpuinfo::thread_pin_guard invalid_guard(static_cast<const cpuinfo_affinity*>(nullptr));
+	EXPECT_FALSE(invalid_guard.pinned());
+	cpuinfo_thread_affinity_state state = {};
+	EXPECT_FALSE(cpuinfo_restore_current_thread_affinity(&state));
+	cpuinfo_deinitialize();
+}
+
+TEST(AFFINITY, core_preference) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpu_set_t original_affinity;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(original_affinity), &original_affinity));
+
+	EXPECT_FALSE(cpuinfo_set_current_thread_core_preference(static_cast<cpuinfo_core_preference>(3)));
+	if (CPU_COUNT(&original_affinity) == (int) cpuinfo_get_processors_count()) {
+		EXPECT_TRUE(cpuinfo_set_current_thread_core_preference(cpuinfo_core_preference_performance));
+		EXPECT_TRUE(cpuinfo_set_current_thread_core_preference(cpuinfo_core_preference_none));
+		cpu_set_t cleared_affinity;
+		ASSERT_EQ(0, sched_getaffinity(0, sizeof(cleared_affinity), &cleared_affinity));
+		EXPECT_EQ(CPU_COUNT(&original_affinity), CPU_COUNT(&cleared_affinity));
+	}
+	EXPECT_EQ(0, sched_setaffinity(0, sizeof(original_affinity), &original_affinity));
+	cpuinfo_deinitialize();
+}
+
+TEST(EXPORT, json_and_cbor) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const size_t json_size = cpuinfo_export(cpuinfo_export_format_json, NULL, 0);
+	ASSERT_LT(2, json_size);
+	std::vector<char> json(json_size + 1, '*');
+	EXPECT_EQ(json_size, cpuinfo_export(cpuinfo_export_format_json, json.data(), json_size));
+	EXPECT_EQ('{', json.front());
+	EXPECT_EQ('}', json[json_size - 1]);
+	EXPECT_EQ('*', json[json_size]);
+	EXPECT_EQ(std::count(json.begin(), json.end(), '['), std::count(json.begin(), json.end(), ']'));
+
+	const size_t cbor_size = cpuinfo_export(cpuinfo_export_format_cbor, NULL, 0);
+	ASSERT_LT(2, cbor_size);
+	EXPECT_GT(json_size, cbor_size);
+	std::vector<uint8_t> cbor(cbor_size);
+	EXPECT_EQ(cbor_size, cpuinfo_export(cpuinfo_export_format_cbor, cbor.data(), 1));
+	EXPECT_EQ(0xBF, cbor.front());
+	EXPECT_EQ(0, cbor.back());
+	EXPECT_EQ(0, cpuinfo_export(static_cast<cpuinfo_export_format>(0), NULL, 0));
+	cpuinfo_deinitialize();
+}
+
+TEST(TOPOLOGY_FINGERPRINT, stable) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_topology_fingerprint fingerprint, other_fingerprint;
+	ASSERT_TRUE(cpuinfo_get_topology_fingerprint(&fingerprint));
+	EXPECT_NE(fingerprint.words[0], fingerprint.words[1]);
+	cpuinfo_deinitialize();
+	ASSERT_TRUE(cpuinfo_initialize());
+	ASSERT_TRUE(cpuinfo_get_topology_fingerprint(&other_fingerprint));
+	EXPECT_EQ(fingerprint.words[0], other_fingerprint.words[0]);
+	EXPECT_EQ(fingerprint.words[1], other_fingerprint.words[1]);
+	EXPECT_FALSE(cpuinfo_get_topology_fingerprint(NULL));
+	cpuinfo_deinitialize();
+}
+
+TEST(TUNING_CACHE, put_get) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_EQ(cpuinfo_hardware_fingerprint(), cpuinfo_hardware_fingerprint());
+	char directory[] = "/tmp/cpuinfo-tuning-XXXXXX";
+	ASSERT_TRUE(mkdtemp(directory));
+	ASSERT_TRUE(cpuinfo_set_tuning_cache_directory(directory));
+
+	size_t size = 0;
+	EXPECT_FALSE(cpuinfo_tuning_get("gemm/tile", nullptr, &size));
+	const uint32_t tile[2] = { 8, 12 };
+	ASSERT_TRUE(cpuinfo_tuning_put("gemm/tile", tile, sizeof(tile)));
+	ASSERT_TRUE(cpuinfo_tuning_put("conv/tile", tile, sizeof(tile[0])));
+	EXPECT_FALSE(cpuinfo_tuning_get("gemm/tile", nullptr, &size));
+	EXPECT_EQ(sizeof(tile), size);
+	uint32_t loaded[2] = { 0, 0 };
+	size = sizeof(loaded);
+	ASSERT_TRUE(cpuinfo_tuning_get("gemm/tile", loaded, &size));
+	EXPECT_EQ(8, loaded[0]);
+	EXPECT_EQ(12, loaded[1]);
+
+	/* Replacing a result keeps the other ones */
+	const uint32_t new_tile = 16;
+	ASSERT_TRUE(cpuinfo_tuning_put("gemm/tile", &new_tile, sizeof(new_tile)));
+	size = sizeof(loaded);
+	ASSERT_TRUE(cpuinfo_tuning_get("gemm/tile", loaded, &size));
+	EXPECT_EQ(sizeof(new_tile), size);
+	EXPECT_EQ(16, loaded[0]);
+	size = sizeof(loaded);
+	ASSERT_TRUE(cpuinfo_tuning_get("conv/tile", loaded, &size));
+	EXPECT_EQ(8, loaded[0]);
+
+	const std::string long_key(CPUINFO_TUNING_KEY_MAX, 'k');
+	EXPECT_FALSE(cpuinfo_tuning_put(long_key.c_str(), tile, sizeof(tile)));
+	EXPECT_FALSE(cpuinfo_tuning_put("", tile, sizeof(tile)));
+
+	char path[sizeof(directory) + 64];
+	snprintf(path, sizeof(path), "%s/tuning-%016llx.bin", directory,
+		(unsigned long long) cpuinfo_hardware_fingerprint());
+	EXPECT_EQ(0, unlink(path));
+	EXPECT_EQ(0, rmdir(directory));
+	EXPECT_TRUE(cpuinfo_set_tuning_cache_directory(nullptr));
+	cpuinfo_deinitialize();
+}
+
+static void race_slow(uint32_t* counter) {
+	for (volatile uint32_t i = 0; i < 100000; i++) {
+		*counter += 1;
+	}
+}
+
+static void race_fast(uint32_t* counter) {
+	*counter += 1;
+}
+
+static void race_run(cpuinfo_dispatch_function implementation, void* context) {
+	((void (*)(uint32_t*)) implementation)(static_cast<uint32_t*>(context));
+}
+
+TEST(DISPATCH_TABLE, race) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	char directory[] = "/tmp/cpuinfo-race-XXXXXX";
+	ASSERT_TRUE(mkdtemp(directory));
+	ASSERT_TRUE(cpuinfo_set_tuning_cache_directory(directory));
+
+	/* Resolution alone prefers the first registered implementation */
+	cpuinfo_dispatch_table table = {};
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&table, (cpuinfo_dispatch_function) race_slow, nullptr,
+		cpuinfo_uarch_unknown));
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&table, (cpuinfo_dispatch_function) race_fast, nullptr,
+		cpuinfo_uarch_unknown));
+	EXPECT_FALSE(cpuinfo_dispatch_table_load_race(&table, "test"));
+	EXPECT_EQ((cpuinfo_dispatch_function) race_slow, table.function);
+
+	uint32_t counter = 0;
+	cpuinfo_dispatch_race_result results[CPUINFO_DISPATCH_MAX_UARCHS];
+	ASSERT_TRUE(cpuinfo_dispatch_table_race(&table, "test", race_run, &counter, 15, results));
+	EXPECT_NE(0, counter);
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count() && i < CPUINFO_DISPATCH_MAX_UARCHS; i++) {
+		EXPECT_EQ(1, results[i].winner);
+		EXPECT_LT(results[i].processor_index, cpuinfo_get_processors_count());
+		EXPECT_LE(results[i].median_ns[1], results[i].median_ns[0]);
+		EXPECT_LE(results[i].median_ns[0], results[i].tail_ns[0]);
+		EXPECT_EQ((cpuinfo_dispatch_function) race_fast, cpuinfo_dispatch_table_get(&table, i));
+	}
+
+	/* Another table with the same candidates applies the recorded winners */
+	cpuinfo_dispatch_table loaded_table = {};
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&loaded_table, (cpuinfo_dispatch_function) race_slow, nullptr,
+		cpuinfo_uarch_unknown));
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&loaded_table, (cpuinfo_dispatch_function) race_fast, nullptr,
+		cpuinfo_uarch_unknown));
+	EXPECT_EQ(cpuinfo_get_uarchs_count() <= CPUINFO_DISPATCH_MAX_UARCHS,
+		cpuinfo_dispatch_table_load_race(&loaded_table, "test"));
+	EXPECT_EQ((cpuinfo_dispatch_function) race_fast, cpuinfo_dispatch_table_get(&loaded_table, 0));
+
+	char path[sizeof(directory) + 64];
+	snprintf(path, sizeof(path), "%s/tuning-%016llx.bin", directory,
+		(unsigned long long) cpuinfo_hardware_fingerprint());
+	EXPECT_EQ(0, unlink(path));
+	EXPECT_EQ(0, rmdir(directory));
+	EXPECT_TRUE(cpuinfo_set_tuning_cache_directory(nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(AFFINITY, processor_masks) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t words = cpuinfo_get_processor_mask_words();
+	EXPECT_EQ((cpuinfo_get_processors_count() + 63) / 64, words);
+	const cpuinfo_affinity* package_affinity = cpuinfo_get_package_affinity(cpuinfo_get_package(0));
+	ASSERT_TRUE(package_affinity);
+	EXPECT_EQ(words, package_affinity->processor_mask_words);
+	uint32_t uarch_processors = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		const cpuinfo_affinity* uarch_affinity = cpuinfo_get_uarch_affinity(i);
+		ASSERT_TRUE(uarch_affinity);
+		EXPECT_EQ(cpuinfo_get_uarch(i)->processor_count, uarch_affinity->processor_count);
+		uarch_processors += uarch_affinity->processor_count;
+	}
+	EXPECT_EQ(cpuinfo_get_processors_count(), uarch_processors);
+	EXPECT_FALSE(cpuinfo_get_uarch_affinity(cpuinfo_get_uarchs_count()));
+
+	/* Processors of the first core are in the masks of the core and its package */
+	const cpuinfo_core* core = cpuinfo_get_core(0);
+	const cpuinfo_affinity* core_affinity = cpuinfo_get_core_affinity(core);
+	std::vector<uint64_t> mask(words);
+	for (uint32_t w = 0; w < words; w++) {
+		mask[w] = core_affinity->processor_mask[w] & package_affinity->processor_mask[w];
+	}
+	for (uint32_t i = 0; i < core->processor_count; i++) {
+		const uint32_t index = core->processor_start + i;
+		EXPECT_TRUE((mask[index / 64] >> (index % 64)) & 1);
+	}
+	std::vector<unsigned long> cpu_set(core_affinity->linux_cpu_set_size / sizeof(unsigned long));
+	ASSERT_TRUE(cpuinfo_processor_mask_to_linux_cpu_set(mask.data(), cpu_set.data(), core_affinity->linux_cpu_set_size));
+	EXPECT_TRUE(std::equal(cpu_set.begin(), cpu_set.end(), core_affinity->linux_cpu_set));
+	cpuinfo_deinitialize();
+}
+
+TEST(HYPERVISOR, synthetic_topology) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	if (cpuinfo_get_hypervisor() == cpuinfo_hypervisor_none) {
+		EXPECT_FALSE(cpuinfo_is_topology_synthetic());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(PROCESSOR_LISTS, cover_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t* core_indices = cpuinfo_get_core_primary_processor_indices();
+	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+		EXPECT_EQ(cpuinfo_get_core(i), cpuinfo_get_processor(core_indices[i])->core);
+	}
+	std::set<uint32_t> uarch_processors;
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		uint32_t count = 0;
+		const uint32_t* indices = cpuinfo_get_uarch_processor_indices(i, &count);
+		EXPECT_EQ(cpuinfo_get_uarch(i)->processor_count, count);
+		uarch_processors.insert(indices, indices + count);
+	}
+	EXPECT_EQ(cpuinfo_get_processors_count(), uarch_processors.size());
+	for (uint32_t i = 0; i < cpuinfo_get_clusters_count(); i++) {
+		uint32_t count = 0;
+		const uint32_t* indices = cpuinfo_get_cluster_processor_indices(i, &count);
+		EXPECT_EQ(cpuinfo_get_cluster(i)->processor_count, count);
+		for (uint32_t j = 0; j < count; j++) {
+			EXPECT_EQ(cpuinfo_get_cluster(i), cpuinfo_get_processor(indices[j])->cluster);
+		}
+	}
+	uint32_t count = 1;
+	EXPECT_FALSE(cpuinfo_get_cluster_processor_indices(cpuinfo_get_clusters_count(), &count));
+	EXPECT_EQ(0, count);
+	cpuinfo_deinitialize();
+}
+
+TEST(PROCESSOR_DISTANCE, symmetric) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	for (uint32_t i = 0; i < processors_count; i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_processor(i);
+		uint32_t numa_distance = 0;
+		EXPECT_EQ(cpuinfo_distance_level_processor, cpuinfo_get_processor_distance(i, i, &numa_distance));
+		EXPECT_EQ(processor->numa_node->distances[processor->numa_node - cpuinfo_get_numa_nodes()], numa_distance);
+		for (uint32_t j = 0; j < processors_count; j++) {
+			const cpuinfo_processor* other = cpuinfo_get_processor(j);
+			const cpuinfo_distance_level level = cpuinfo_get_processor_distance(i, j, NULL);
+			EXPECT_EQ(level, cpuinfo_get_processor_distance(j, i, NULL));
+			EXPECT_EQ(i != j && processor->core == other->core, level == cpuinfo_distance_level_core);
+			EXPECT_EQ(processor->package != other->package, level == cpuinfo_distance_level_remote);
+		}
+	}
+	uint32_t numa_distance = 1;
+	EXPECT_EQ(cpuinfo_distance_level_max, cpuinfo_get_processor_distance(0, processors_count, &numa_distance));
+	EXPECT_EQ(0, numa_distance);
+	cpuinfo_deinitialize();
+}
+
+TEST(STEAL_ORDER, nearest_first) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* thief = cpuinfo_get_processor(i);
+		uint32_t count = 0;
+		const uint32_t* victims = cpuinfo_get_steal_order(i, &count);
+		EXPECT_EQ(cpuinfo_get_usable_processors_count() - (thief->usable ? 1 : 0), count);
+		std::set<uint32_t> unique_victims(victims, victims + count);
+		EXPECT_EQ(count, unique_victims.size());
+		EXPECT_EQ(0, unique_victims.count(i));
+		/* SMT siblings precede processors of other cores, and processors of the package precede remote ones */
+		bool other_core = false, other_package = false;
+		for (uint32_t j = 0; j < count; j++) {
+			const cpuinfo_processor* victim = cpuinfo_get_processor(victims[j]);
+			EXPECT_TRUE(victim->usable);
+			if (victim->core == thief->core) {
+				EXPECT_FALSE(other_core);
+			} else {
+				other_core = true;
+			}
+			if (victim->package == thief->package) {
+				EXPECT_FALSE(other_package);
+			} else {
+				other_package = true;
+			}
+		}
+	}
+	uint32_t count = 1;
+	EXPECT_FALSE(cpuinfo_get_steal_order(cpuinfo_get_processors_count(), &count));
+	EXPECT_EQ(0, count);
+	cpuinfo_deinitialize();
+}
+
+TEST(PROCESSOR_COLUMNS, match_pointers) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint16_t* core_column = cpuinfo_get_processor_column(cpuinfo_processor_column_core);
+	const uint16_t* l1d_column = cpuinfo_get_processor_column(cpuinfo_processor_column_l1d);
+	ASSERT_TRUE(core_column);
+	ASSERT_TRUE(l1d_column);
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_processor(i);
+		EXPECT_EQ(processor->core, cpuinfo_get_core(core_column[i]));
+		if (processor->cache.l1d != NULL) {
+			EXPECT_EQ(processor->cache.l1d, cpuinfo_get_l1d_cache(l1d_column[i]));
+		} else {
+			EXPECT_EQ(CPUINFO_COLUMN_INDEX_NONE, l1d_column[i]);
+		}
+	}
+	uint32_t size = 0;
+	const void* columns = cpuinfo_get_processor_columns(&size);
+	EXPECT_EQ(static_cast<const void*>(core_column), columns);
+	EXPECT_EQ(cpuinfo_processor_column_max * cpuinfo_get_processors_count() * sizeof(uint16_t), size);
+	EXPECT_FALSE(cpuinfo_get_processor_column(cpuinfo_processor_column_max));
+	cpuinfo_deinitialize();
+}
+
+TEST(USABLE_PROCESSORS, match_affinity) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpu_set_t affinity;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(affinity), &affinity));
+	EXPECT_EQ(CPU_COUNT(&affinity), cpuinfo_get_usable_processors_count());
+	const uint32_t* indices = cpuinfo_get_usable_processor_indices();
+	ASSERT_TRUE(indices);
+	for (uint32_t i = 0; i < cpuinfo_get_usable_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_usable_processor(i);
+		ASSERT_TRUE(processor);
+		EXPECT_EQ(cpuinfo_get_processor(indices[i]), processor);
+		EXPECT_TRUE(processor->usable);
+		EXPECT_TRUE(CPU_ISSET(processor->linux_id, &affinity));
+	}
+	EXPECT_FALSE(cpuinfo_get_usable_processor(cpuinfo_get_usable_processors_count()));
+	cpuinfo_deinitialize();
+}
+#endif
+
+TEST(USABLE_PROCESSORS, usable_siblings) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	uint32_t usable_count = 0;
+	bool smt_online = false;
+	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+		const cpuinfo_core* core = cpuinfo_get_core(i);
+		uint32_t core_usable_count = 0, core_online_count = 0;
+		for (uint32_t j = 0; j < core->processor_count; j++) {
+			const cpuinfo_processor* processor = cpuinfo_get_processor(core->processor_start + j);
+			EXPECT_TRUE(processor->online || !processor->usable);
+			core_usable_count += processor->usable;
+			core_online_count += processor->online;
+		}
+		EXPECT_EQ(core_usable_count, core->usable_processor_count);
+		usable_count += core->usable_processor_count;
+		smt_online |= core_online_count > 1;
+	}
+	EXPECT_EQ(cpuinfo_get_usable_processors_count(), usable_count);
+	if (cpuinfo_get_smt_control() == cpuinfo_smt_control_off ||
+		cpuinfo_get_smt_control() == cpuinfo_smt_control_forceoff)
+	{
+		EXPECT_FALSE(smt_online);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(EFFECTIVE_PARALLELISM, within_usable_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_LE(1, cpuinfo_get_effective_parallelism());
+	EXPECT_GE(cpuinfo_get_usable_processors_count(), cpuinfo_get_effective_parallelism());
+	cpuinfo_deinitialize();
+}
+
+TEST(ANDROID_CPUSET, valid_clusters) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_FALSE(cpuinfo_get_android_cpuset(nullptr, nullptr));
+	cpuinfo_android_cpuset cpuset;
+	std::vector<const cpuinfo_cluster*> clusters(cpuinfo_get_clusters_count());
+	if (cpuinfo_get_android_cpuset(&cpuset, clusters.data())) {
+		EXPECT_EQ('/', cpuset.path[0]);
+		EXPECT_NE(0, cpuset.processors_count);
+		EXPECT_LE(cpuset.processors_count, cpuinfo_get_processors_count());
+		EXPECT_NE(0, cpuset.clusters_count);
+		EXPECT_LE(cpuset.clusters_count, cpuinfo_get_clusters_count());
+		for (uint32_t i = 0; i < cpuset.clusters_count; i++) {
+			ASSERT_TRUE(clusters[i]);
+			EXPECT_LT(clusters[i] - cpuinfo_get_clusters(), cpuinfo_get_clusters_count());
+		}
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(PERFORMANCE_RANKING, sorted_by_performance) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t* indices = cpuinfo_get_usable_processor_indices_by_performance();
+	ASSERT_TRUE(indices);
+	for (uint32_t i = 0; i < cpuinfo_get_usable_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_usable_processor_by_performance(i);
+		ASSERT_TRUE(processor);
+		EXPECT_EQ(cpuinfo_get_processor(indices[i]), processor);
+		EXPECT_TRUE(processor->usable);
+		if (i != 0) {
+			const cpuinfo_core* previous_core = cpuinfo_get_processor(indices[i - 1])->core;
+			EXPECT_GE(previous_core->performance, processor->core->performance);
+			EXPECT_LE(previous_core->performance_rank, processor->core->performance_rank);
+		}
+	}
+	EXPECT_FALSE(cpuinfo_get_usable_processor_by_performance(cpuinfo_get_usable_processors_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(FREQUENCY_DOMAINS, cover_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	ASSERT_NE(0, cpuinfo_get_frequency_domains_count());
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_processor(i);
+		const cpuinfo_frequency_domain* domain = processor->frequency_domain;
+		ASSERT_TRUE(domain);
+		EXPECT_LE(domain->processor_start, i);
+		EXPECT_LT(i, domain->processor_start + domain->processor_count);
+	}
+	for (uint32_t i = 0; i < cpuinfo_get_frequency_domains_count(); i++) {
+		const cpuinfo_frequency_domain* domain = cpuinfo_get_frequency_domain(i);
+		ASSERT_TRUE(domain);
+		EXPECT_EQ(domain, cpuinfo_get_processor(domain->processor_start)->frequency_domain);
+		for (uint32_t j = 1; j < domain->frequencies_count; j++) {
+			EXPECT_LE(domain->frequencies[j - 1], domain->frequencies[j]);
+		}
+	}
+	EXPECT_FALSE(cpuinfo_get_frequency_domain(cpuinfo_get_frequency_domains_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(FREQUENCY_DOMAINS, energy_performance_preference) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_frequency_domains_count(); i++) {
+		const cpuinfo_frequency_domain* domain = cpuinfo_get_frequency_domain(i);
+		if (domain->energy_performance_preference == cpuinfo_energy_performance_preference_unknown) {
+			EXPECT_EQ(0, domain->energy_performance_preferences);
+		}
+		EXPECT_LE(cpuinfo_get_energy_performance_preference(domain), cpuinfo_energy_performance_preference_custom);
+		EXPECT_FALSE(cpuinfo_set_energy_performance_preference(domain, cpuinfo_energy_performance_preference_custom));
+	}
+	EXPECT_EQ(cpuinfo_energy_performance_preference_unknown, cpuinfo_get_energy_performance_preference(nullptr));
+	EXPECT_FALSE(cpuinfo_set_energy_performance_preference(nullptr, cpuinfo_energy_performance_preference_performance));
+	cpuinfo_deinitialize();
+}
+
+TEST(UNCORE_DOMAINS, packages) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t domains_count = cpuinfo_get_uncore_domains_count();
+	EXPECT_EQ(domains_count != 0, cpuinfo_get_uncore_domains() != nullptr);
+	for (uint32_t i = 0; i < domains_count; i++) {
+		const cpuinfo_uncore_domain* domain = cpuinfo_get_uncore_domain(i);
+		ASSERT_TRUE(domain);
+		EXPECT_LE(domain->min_frequency, domain->max_frequency);
+		EXPECT_LE(domain->limit_min_frequency, domain->limit_max_frequency);
+	}
+	uint32_t package_domains_total = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_packages_count(); i++) {
+		uint32_t count = 0;
+		const cpuinfo_uncore_domain* domains = cpuinfo_get_package_uncore_domains(cpuinfo_get_package(i), &count);
+		EXPECT_EQ(count != 0, domains != nullptr);
+		for (uint32_t j = 0; j < count; j++) {
+			EXPECT_EQ(cpuinfo_get_package(i), domains[j].package);
+		}
+		package_domains_total += count;
+	}
+	EXPECT_LE(package_domains_total, domains_count);
+	EXPECT_FALSE(cpuinfo_get_uncore_domain(domains_count));
+	EXPECT_FALSE(cpuinfo_get_package_uncore_domains(nullptr, nullptr));
+
+	cpuinfo_frequency_sampler* sampler = cpuinfo_create_frequency_sampler();
+	ASSERT_TRUE(sampler);
+	std::vector<uint64_t> frequencies(domains_count);
+	cpuinfo_sample_uncore_frequencies(sampler, 0, domains_count, frequencies.data());
+	EXPECT_FALSE(cpuinfo_sample_uncore_frequencies(sampler, domains_count, 1, frequencies.data()));
+	cpuinfo_destroy_frequency_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(BENCHMARK_ENVIRONMENT, check) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_FALSE(cpuinfo_check_benchmark_environment(nullptr, nullptr));
+	cpuinfo_benchmark_environment environment;
+	std::vector<cpuinfo_frequency_domain_environment> domains(cpuinfo_get_frequency_domains_count());
+	ASSERT_TRUE(cpuinfo_check_benchmark_environment(&environment, domains.data()));
+	EXPECT_EQ(cpuinfo_get_isolated_processors_count(), environment.isolated_processors_count);
+	for (const cpuinfo_frequency_domain_environment& domain : domains) {
+		EXPECT_EQ(domain.warnings, domain.warnings & environment.warnings);
+		EXPECT_LE(domain.min_frequency, domain.max_frequency);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(TSC, frequency) {
+	ASSERT_TRUE(cpuinfo_initialize());
+#if CPUINFO_ARCH_ARM64
+	EXPECT_NE(0, cpuinfo_get_tsc_frequency());
+	EXPECT_TRUE(cpuinfo_has_invariant_tsc());
+#elif !(CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64)
+	EXPECT_EQ(0, cpuinfo_get_tsc_frequency());
+#endif
+	cpuinfo_deinitialize();
+}
+
+TEST(TIMESTAMP, advances) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint64_t frequency = cpuinfo_get_timestamp_frequency();
+	ASSERT_NE(0, frequency);
+	if (cpuinfo_get_timestamp_source() != cpuinfo_timestamp_source_os_clock) {
+		EXPECT_EQ(cpuinfo_get_tsc_frequency(), frequency);
+	}
+	const uint64_t start = cpuinfo_read_timestamp();
+	usleep(10000);
+	const uint64_t end = cpuinfo_read_timestamp_ordered();
+	ASSERT_GT(end, start);
+	/* At least 10 ms passed, up to the precision of the frequency */
+	EXPECT_GE((double) (end - start) / (double) frequency, 0.009);
+	EXPECT_LE(start, cpuinfo_read_timestamp_uninlined(false));
+	cpuinfo_deinitialize();
+}
+
+TEST(FREQUENCY_SAMPLER, sample) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_frequency_sampler* sampler = cpuinfo_create_frequency_sampler();
+	ASSERT_TRUE(sampler);
+	std::vector<uint64_t> domain_frequencies(cpuinfo_get_frequency_domains_count());
+	if (cpuinfo_sample_domain_frequencies(sampler, 0, cpuinfo_get_frequency_domains_count(), domain_frequencies.data())) {
+		EXPECT_NE(domain_frequencies.end(),
+			std::find_if(domain_frequencies.begin(), domain_frequencies.end(), [](uint64_t f) { return f != 0; }));
+	}
+	uint64_t core_frequency = 0;
+	EXPECT_FALSE(cpuinfo_sample_core_frequencies(sampler, cpuinfo_get_cores_count(), 1, &core_frequency));
+	cpuinfo_destroy_frequency_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(FREQUENCY_SAMPLER, cluster_capacities) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_frequency_sampler* sampler = cpuinfo_create_frequency_sampler();
+	ASSERT_TRUE(sampler);
+	std::vector<cpuinfo_cluster_capacity> capacities(cpuinfo_get_clusters_count());
+	cpuinfo_sample_cluster_capacities(sampler, 0, cpuinfo_get_clusters_count(), capacities.data());
+	for (uint32_t i = 0; i < cpuinfo_get_clusters_count(); i++) {
+		EXPECT_GE(cpuinfo_get_cluster(i)->processor_count, capacities[i].online_processors);
+		EXPECT_GE(CPUINFO_CAPACITY_SCALE, capacities[i].capacity_scale);
+		EXPECT_GE(capacities[i].max_cooling_state, capacities[i].cooling_state);
+	}
+	cpuinfo_cluster_capacity capacity;
+	EXPECT_FALSE(cpuinfo_sample_cluster_capacities(sampler, cpuinfo_get_clusters_count(), 1, &capacity));
+	cpuinfo_destroy_frequency_sampler(sampler);
+	cpuinfo_deinitialize();
+}
+
+TEST(CAPACITY, normalized) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	uint32_t max_capacity = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+		const cpuinfo_core* core = cpuinfo_get_core(i);
+		EXPECT_LT(0, core->capacity);
+		EXPECT_GE(CPUINFO_CAPACITY_SCALE, core->capacity);
+		EXPECT_GE(core->cluster->capacity, core->capacity);
+		max_capacity = std::max(max_capacity, core->capacity);
+	}
+	EXPECT_EQ(CPUINFO_CAPACITY_SCALE, max_capacity);
+	cpuinfo_deinitialize();
+}
+
+TEST(LLC_DOMAINS, partition_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	ASSERT_NE(0, cpuinfo_get_llc_domains_count());
+	uint32_t processor_start = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_llc_domains_count(); i++) {
+		const cpuinfo_llc_domain* domain = cpuinfo_get_llc_domain(i);
+		ASSERT_TRUE(domain);
+		EXPECT_EQ(processor_start, domain->processor_start);
+		EXPECT_NE(0, domain->processor_count);
+		EXPECT_NE(0, domain->core_count);
+		for (uint32_t j = domain->processor_start; j < domain->processor_start + domain->processor_count; j++) {
+			EXPECT_EQ(i, cpuinfo_get_processor_llc_domain_index(cpuinfo_get_processor(j)));
+		}
+		processor_start += domain->processor_count;
+	}
+	EXPECT_EQ(cpuinfo_get_processors_count(), processor_start);
+#if defined(__linux__)
+	EXPECT_TRUE(cpuinfo_get_current_llc_domain());
+#endif
+	cpuinfo_deinitialize();
+}
+
+TEST(CACHE_CLUSTERS, partition_clusters) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	ASSERT_NE(0, cpuinfo_get_cache_clusters_count());
+	uint32_t processor_start = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_cache_clusters_count(); i++) {
+		const cpuinfo_cache_cluster* cache_cluster = cpuinfo_get_cache_cluster(i);
+		ASSERT_TRUE(cache_cluster);
+		EXPECT_EQ(processor_start, cache_cluster->processor_start);
+		EXPECT_NE(0, cache_cluster->processor_count);
+		EXPECT_NE(0, cache_cluster->cluster_count);
+		for (uint32_t j = cache_cluster->processor_start;
+			j < cache_cluster->processor_start + cache_cluster->processor_count; j++)
+		{
+			const cpuinfo_processor* processor = cpuinfo_get_processor(j);
+			EXPECT_EQ(i, cpuinfo_get_processor_cache_cluster_index(processor));
+			EXPECT_EQ(cache_cluster->l3, processor->cache.l3);
+			const uint32_t cluster_index = (uint32_t) (processor->cluster - cpuinfo_get_clusters());
+			EXPECT_LE(cache_cluster->cluster_start, cluster_index);
+			EXPECT_GT(cache_cluster->cluster_start + cache_cluster->cluster_count, cluster_index);
+		}
+		processor_start += cache_cluster->processor_count;
+	}
+	EXPECT_EQ(cpuinfo_get_processors_count(), processor_start);
+	EXPECT_FALSE(cpuinfo_get_cache_cluster(cpuinfo_get_cache_clusters_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(CACHE_CLUSTERS, asymmetric_flags) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	bool all_large_l3 = true, all_high_frequency = true;
+	for (uint32_t i = 0; i < cpuinfo_get_cache_clusters_count(); i++) {
+		const cpuinfo_cache_cluster* cache_cluster = cpuinfo_get_cache_cluster(i);
+		all_large_l3 &= cache_cluster->large_l3;
+		all_high_frequency &= cache_cluster->high_frequency;
+		if (cache_cluster->large_l3) {
+			ASSERT_TRUE(cache_cluster->l3);
+			for (uint32_t j = 0; j < cpuinfo_get_cache_clusters_count(); j++) {
+				const cpuinfo_cache* l3 = cpuinfo_get_cache_cluster(j)->l3;
+				EXPECT_LE(l3 != nullptr ? l3->size : 0, cache_cluster->l3->size);
+			}
+		}
+	}
+	/* Flags mark only some of asymmetric cache clusters */
+	EXPECT_FALSE(all_large_l3);
+	EXPECT_FALSE(all_high_frequency);
+	cpuinfo_deinitialize();
+}
+
+TEST(VECTOR_UNIT_GROUP, contains_core) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+		const cpuinfo_core* core = cpuinfo_get_core(i);
+		uint32_t core_start = UINT32_MAX, core_count = 0;
+		ASSERT_TRUE(cpuinfo_get_core_vector_unit_group(core, &core_start, &core_count));
+		EXPECT_LE(core_start, i);
+		EXPECT_GT(core_start + core_count, i);
+		if (core_count == 1) {
+			EXPECT_EQ(i, core_start);
+		} else {
+			ASSERT_EQ(2, core_count);
+			const cpuinfo_core* first_core = cpuinfo_get_core(core_start);
+			const cpuinfo_core* second_core = cpuinfo_get_core(core_start + 1);
+			EXPECT_EQ(first_core->uarch, second_core->uarch);
+			EXPECT_EQ(cpuinfo_get_processor(first_core->processor_start)->cache.l2,
+				cpuinfo_get_processor(second_core->processor_start)->cache.l2);
+		}
+	}
+	uint32_t core_start, core_count;
+	EXPECT_FALSE(cpuinfo_get_core_vector_unit_group(nullptr, &core_start, &core_count));
+	EXPECT_FALSE(cpuinfo_get_core_vector_unit_group(cpuinfo_get_core(0), nullptr, &core_count));
+	cpuinfo_deinitialize();
+}
+
+TEST(INTEGRATED_GPU, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_integrated_gpu* gpu = cpuinfo_get_integrated_gpu();
+#if !(CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64) || !defined(__linux__)
+	ASSERT_FALSE(gpu);
+	ASSERT_FALSE(cpuinfo_get_npu());
+#endif
+	if (gpu != nullptr) {
+		ASSERT_NE(cpuinfo_gpu_family_unknown, gpu->family);
+		ASSERT_NE(0, gpu->model);
+		ASSERT_NE('\0', gpu->name[0]);
+		uint32_t leading_digit = gpu->model;
+		while (leading_digit >= 10) {
+			leading_digit /= 10;
+		}
+		ASSERT_EQ(leading_digit, gpu->series);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(NUMA_NODES, contain_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t nodes_count = cpuinfo_get_numa_nodes_count();
+	ASSERT_NE(0, nodes_count);
+	const uint32_t* distances = cpuinfo_get_numa_distances();
+	ASSERT_TRUE(distances);
+	for (uint32_t i = 0; i < nodes_count; i++) {
+		const cpuinfo_numa_node* node = cpuinfo_get_numa_node(i);
+		ASSERT_TRUE(node);
+		EXPECT_EQ(distances + i * nodes_count, node->distances);
+		EXPECT_EQ(10, node->distances[i]);
+		if (i != 0) {
+			EXPECT_LT(cpuinfo_get_numa_node(i - 1)->node_id, node->node_id);
+		}
+	}
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_numa_node* node = cpuinfo_get_processor(i)->numa_node;
+		ASSERT_TRUE(node);
+		EXPECT_LT(node - cpuinfo_get_numa_nodes(), nodes_count);
+		EXPECT_GE(i, node->processor_start);
+		EXPECT_LT(i, node->processor_start + node->processor_count);
+	}
+#if defined(__linux__)
+	EXPECT_TRUE(cpuinfo_get_current_numa_node());
+#endif
+	cpuinfo_deinitialize();
+}
+
+#if defined(__linux__)
+TEST(DEVICE_LOCALITY, pci_devices) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_device_locality locality;
+	EXPECT_FALSE(cpuinfo_get_device_local_processors("lo", &locality, 0, nullptr));
+	EXPECT_FALSE(cpuinfo_get_device_local_processors("cpuinfo-no-such-device", &locality, 0, nullptr));
+	DIR* directory = opendir("/sys/bus/pci/devices");
+	if (directory != nullptr) {
+		std::vector<uint32_t> processor_indices(cpuinfo_get_processors_count());
+		while (const dirent* entry = readdir(directory)) {
+			if (entry->d_name[0] == '.' || !cpuinfo_get_device_local_processors(entry->d_name, &locality,
+					processor_indices.size(), processor_indices.data()))
+			{
+				continue;
+			}
+			EXPECT_LE(locality.usable_processors_count, locality.processors_count);
+			EXPECT_LE(locality.processors_count, cpuinfo_get_processors_count());
+			for (uint32_t i = 0; i < locality.processors_count; i++) {
+				EXPECT_LT(processor_indices[i], cpuinfo_get_processors_count());
+				if (i != 0) {
+					EXPECT_LT(processor_indices[i - 1], processor_indices[i]);
+				}
+			}
+		}
+		closedir(directory);
+	}
+	cpuinfo_deinitialize();
+}
+#endif
+
+TEST(NUMA_NODES, memory_side_caches) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	uint32_t memory_side_cache_start = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_numa_nodes_count(); i++) {
+		const cpuinfo_numa_node* node = cpuinfo_get_numa_node(i);
+		EXPECT_EQ(memory_side_cache_start, node->memory_side_cache_start);
+		for (uint32_t j = 0; j < node->memory_side_cache_count; j++) {
+			const cpuinfo_memory_side_cache* cache = cpuinfo_get_memory_side_cache(node->memory_side_cache_start + j);
+			ASSERT_TRUE(cache);
+			EXPECT_EQ(node, cache->numa_node);
+			EXPECT_EQ(j + 1, cache->level);
+			EXPECT_NE(0, cache->size);
+		}
+		memory_side_cache_start += node->memory_side_cache_count;
+	}
+	EXPECT_EQ(memory_side_cache_start, cpuinfo_get_memory_side_caches_count());
+	EXPECT_FALSE(cpuinfo_get_memory_side_cache(cpuinfo_get_memory_side_caches_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(PLAN_WORKERS, valid_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t workers_count = cpuinfo_get_processors_count() * 2;
+	std::vector<const cpuinfo_processor*> workers(workers_count);
+	const cpuinfo_worker_policy policies[] = {
+		cpuinfo_worker_policy_compact,
+		cpuinfo_worker_policy_scatter_llc,
+		cpuinfo_worker_policy_scatter_package,
+		cpuinfo_worker_policy_physical_cores,
+		cpuinfo_worker_policy_big_cores_first,
+	};
+	for (cpuinfo_worker_policy policy : policies) {
+		const uint32_t planned_count = cpuinfo_plan_workers(workers_count, policy, workers.data());
+		EXPECT_NE(0, planned_count);
+		EXPECT_LE(planned_count, cpuinfo_get_processors_count());
+		std::set<const cpuinfo_processor*> distinct_processors;
+		for (const cpuinfo_processor* processor : workers) {
+			ASSERT_TRUE(processor);
+			EXPECT_LT(processor - cpuinfo_get_processors(), cpuinfo_get_processors_count());
+			distinct_processors.insert(processor);
+		}
+		EXPECT_EQ(planned_count, distinct_processors.size());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(PLAN_WORKERS, isolated) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	uint32_t usable_isolated_count = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_isolated_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_isolated_processor(i);
+		ASSERT_TRUE(processor);
+		EXPECT_TRUE(processor->isolated || processor->nohz_full);
+		usable_isolated_count += processor->usable;
+	}
+	EXPECT_FALSE(cpuinfo_get_isolated_processor(cpuinfo_get_isolated_processors_count()));
+	std::vector<const cpuinfo_processor*> workers(cpuinfo_get_processors_count());
+	EXPECT_EQ(usable_isolated_count,
+		cpuinfo_plan_workers(cpuinfo_get_processors_count(), cpuinfo_worker_policy_isolated, workers.data()));
+	cpuinfo_deinitialize();
+}
+
+TEST(PLAN_WORKERS, physical_cores) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	std::vector<const cpuinfo_processor*> workers(cpuinfo_get_cores_count());
+	ASSERT_EQ(cpuinfo_get_cores_count(),
+		cpuinfo_plan_workers(cpuinfo_get_cores_count(), cpuinfo_worker_policy_physical_cores, workers.data()));
+	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+		EXPECT_EQ(cpuinfo_get_core(i), workers[i]->core);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(PLACE_PIPELINE, adjacent_stages) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t stage_count = 4;
+	std::vector<uint32_t> edge_weights(stage_count * stage_count);
+	for (uint32_t i = 0; i + 1 < stage_count; i++) {
+		edge_weights[i * stage_count + i + 1] = 100;
+	}
+	std::vector<const cpuinfo_processor*> stages(stage_count);
+	const uint32_t placed_count = cpuinfo_place_pipeline(stage_count, edge_weights.data(), stages.data());
+	ASSERT_NE(0, placed_count);
+	std::set<const cpuinfo_processor*> distinct_processors;
+	for (const cpuinfo_processor* processor : stages) {
+		ASSERT_TRUE(processor);
+		EXPECT_TRUE(processor->usable);
+		distinct_processors.insert(processor);
+	}
+	EXPECT_EQ(placed_count, distinct_processors.size());
+	EXPECT_LE(placed_count, std::min<uint32_t>(stage_count, cpuinfo_get_usable_processors_count()));
+	for (uint32_t i = 0; i + 1 < stage_count; i++) {
+		EXPECT_NE(cpuinfo_distance_level_max, cpuinfo_get_processor_distance(
+			stages[i] - cpuinfo_get_processors(), stages[i + 1] - cpuinfo_get_processors(), nullptr));
+	}
+	EXPECT_EQ(0, cpuinfo_place_pipeline(0, edge_weights.data(), stages.data()));
+	cpuinfo_deinitialize();
+}
+
+TEST(PARTITION, covers_range) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	std::vector<const cpuinfo_processor*> processors;
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		processors.push_back(cpuinfo_get_processor(i));
+	}
+	std::vector<cpuinfo_partition_range> ranges(processors.size());
+	for (uint64_t range : {UINT64_C(0), UINT64_C(1), UINT64_C(1000003), UINT64_MAX}) {
+		ASSERT_TRUE(cpuinfo_partition(range, processors.size(), processors.data(), nullptr, ranges.data()));
+		uint64_t start = 0;
+		for (const cpuinfo_partition_range& partition_range : ranges) {
+			EXPECT_EQ(start, partition_range.start);
+			EXPECT_LE(partition_range.start, partition_range.end);
+			start = partition_range.end;
+		}
+		EXPECT_EQ(range, start);
+	}
+	const cpuinfo_processor* foreign_processor = nullptr;
+	EXPECT_FALSE(cpuinfo_partition(1, 1, &foreign_processor, nullptr, ranges.data()));
+	EXPECT_FALSE(cpuinfo_partition(1, 0, processors.data(), nullptr, ranges.data()));
+	cpuinfo_deinitialize();
+}
+
+TEST(REDUCTION_TREE, single_root) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* Two participants on every processor, so the leaves of the tree also group participants of one processor */
+	std::vector<const cpuinfo_processor*> processors;
+	for (uint32_t i = 0; i < 2 * cpuinfo_get_processors_count(); i++) {
+		processors.push_back(cpuinfo_get_processor(i % cpuinfo_get_processors_count()));
+	}
+	std::vector<uint32_t> parents(processors.size());
+	for (cpuinfo_tree_fanout fanout :
+		{cpuinfo_tree_fanout_flat, cpuinfo_tree_fanout_binary, cpuinfo_tree_fanout_quaternary})
+	{
+		ASSERT_TRUE(cpuinfo_build_reduction_tree(processors.size(), processors.data(), fanout, parents.data()));
+		EXPECT_EQ(1, std::count(parents.begin(), parents.end(), UINT32_MAX));
+		for (uint32_t i = 0; i < parents.size(); i++) {
+			uint32_t participant = i;
+			for (uint32_t depth = 0; parents[participant] != UINT32_MAX; depth++) {
+				ASSERT_LT(depth, parents.size());
+				ASSERT_LT(parents[participant], parents.size());
+				participant = parents[participant];
+			}
+		}
+	}
+	const cpuinfo_processor* foreign_processor = nullptr;
+	EXPECT_FALSE(cpuinfo_build_reduction_tree(1, &foreign_processor, cpuinfo_tree_fanout_flat, parents.data()));
+	EXPECT_FALSE(cpuinfo_build_reduction_tree(0, processors.data(), cpuinfo_tree_fanout_flat, parents.data()));
+	EXPECT_FALSE(cpuinfo_build_reduction_tree(1, processors.data(), cpuinfo_tree_fanout_flat, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(BANDWIDTH_HINT, within_bounds) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_bandwidth_hint hint;
+	for (uint32_t i = 0; i < cpuinfo_get_packages_count(); i++) {
+		ASSERT_TRUE(cpuinfo_get_package_bandwidth_hint(cpuinfo_get_package(i), &hint));
+		EXPECT_EQ(cpuinfo_get_package(i)->core_count, hint.cores_count);
+		EXPECT_GE(hint.saturating_threads, 1);
+		EXPECT_LE(hint.saturating_threads, hint.cores_count);
+		EXPECT_NE(0, hint.memory_bandwidth);
+		EXPECT_NE(0, hint.thread_bandwidth);
+	}
+	for (uint32_t i = 0; i < cpuinfo_get_numa_nodes_count(); i++) {
+		const cpuinfo_numa_node* numa_node = cpuinfo_get_numa_node(i);
+		if (numa_node->processor_count != 0) {
+			ASSERT_TRUE(cpuinfo_get_numa_node_bandwidth_hint(numa_node, &hint));
+			EXPECT_GE(hint.saturating_threads, 1);
+			EXPECT_LE(hint.saturating_threads, hint.cores_count);
+		}
+	}
+	EXPECT_FALSE(cpuinfo_get_package_bandwidth_hint(nullptr, &hint));
+	EXPECT_FALSE(cpuinfo_get_numa_node_bandwidth_hint(nullptr, &hint));
+	cpuinfo_deinitialize();
+}
+
+TEST(BLOCKING_HINT, fits_caches) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t element_size = 4, mr = 6, nr = 16;
+	cpuinfo_blocking_hint hint;
+	ASSERT_TRUE(cpuinfo_get_uarch_blocking_hint(0, element_size, mr, nr, &hint));
+	const cpuinfo_processor* processor = cpuinfo_get_processor(0);
+	EXPECT_NE(0, hint.kc);
+	EXPECT_LE(uint64_t(hint.kc) * (mr + nr) * element_size, processor->cache.l1d->size);
+	EXPECT_EQ(processor->cache.l1d->line_size, hint.line_size);
+	if (processor->cache.l2 != nullptr) {
+		EXPECT_EQ(0, hint.mc % mr);
+		EXPECT_LE(uint64_t(hint.mc) * hint.kc * element_size, processor->cache.l2->size);
+	}
+	if (processor->cache.l3 != nullptr) {
+		EXPECT_EQ(0, hint.nc % nr);
+		EXPECT_LE(uint64_t(hint.nc) * hint.kc * element_size, processor->cache.l3->size);
+	}
+	EXPECT_FALSE(cpuinfo_get_uarch_blocking_hint(cpuinfo_get_uarchs_count(), element_size, mr, nr, &hint));
+	EXPECT_FALSE(cpuinfo_get_blocking_hint(0, mr, nr, &hint));
+	EXPECT_TRUE(cpuinfo_get_blocking_hint(element_size, mr, nr, &hint));
+	cpuinfo_deinitialize();
+}
+
+TEST(TLB, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint64_t page_sizes[] = { CPUINFO_PAGE_SIZE_4KB, CPUINFO_PAGE_SIZE_2MB, CPUINFO_PAGE_SIZE_1GB };
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		for (uint64_t page_size : page_sizes) {
+			for (const cpuinfo_tlb* tlb : { cpuinfo_get_l1i_tlb(i, page_size), cpuinfo_get_l1d_tlb(i, page_size),
+				cpuinfo_get_l2_tlb(i, page_size) })
+			{
+				if (tlb != nullptr) {
+					EXPECT_NE(0, tlb->entries);
+					EXPECT_NE(0, tlb->associativity);
+					EXPECT_LE(tlb->associativity, tlb->entries);
+					EXPECT_NE(0, tlb->pages & page_size);
+				}
+			}
+		}
+	}
+	EXPECT_FALSE(cpuinfo_get_l1d_tlb(cpuinfo_get_uarchs_count(), CPUINFO_PAGE_SIZE_4KB));
+	cpuinfo_deinitialize();
+}
+
+TEST(HUGE_PAGES, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t pools_count = cpuinfo_get_huge_page_pools_count();
+	for (uint32_t i = 0; i < pools_count; i++) {
+		const cpuinfo_huge_page_pool* pool = cpuinfo_get_huge_page_pool(i);
+		ASSERT_TRUE(pool);
+		EXPECT_NE(0, pool->page_size);
+		EXPECT_LE(pool->free_pages, pool->total_pages);
+		if (i != 0) {
+			EXPECT_LT(cpuinfo_get_huge_page_pool(i - 1)->page_size, pool->page_size);
+		}
+
+		struct cpuinfo_huge_page_pool live;
+		ASSERT_TRUE(cpuinfo_query_huge_page_pool(i, UINT32_MAX, &live));
+		EXPECT_EQ(pool->page_size, live.page_size);
+	}
+	EXPECT_FALSE(cpuinfo_get_huge_page_pool(pools_count));
+	struct cpuinfo_huge_page_pool pool;
+	EXPECT_FALSE(cpuinfo_query_huge_page_pool(pools_count, UINT32_MAX, &pool));
+	EXPECT_TRUE(cpuinfo_get_transparent_huge_pages());
+	cpuinfo_deinitialize();
+}
+
+TEST(CODE_CACHE_MAINTENANCE, line_sizes) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_code_cache_maintenance system, uarch;
+	cpuinfo_get_code_cache_maintenance(&system);
+	for (uint32_t line_size : { system.icache_line_size, system.dcache_line_size }) {
+		EXPECT_EQ(0, line_size & (line_size - 1));
+	}
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		ASSERT_TRUE(cpuinfo_get_uarch_code_cache_maintenance(i, &uarch));
+		EXPECT_GE(uarch.icache_line_size, system.icache_line_size);
+		EXPECT_GE(uarch.dcache_line_size, system.dcache_line_size);
+		EXPECT_EQ(system.icache_invalidation_not_required, uarch.icache_invalidation_not_required);
+		EXPECT_EQ(system.dcache_clean_not_required, uarch.dcache_clean_not_required);
+	}
+	EXPECT_FALSE(cpuinfo_get_uarch_code_cache_maintenance(cpuinfo_get_uarchs_count(), &uarch));
+	cpuinfo_deinitialize();
+}
+
+TEST(RESOURCE_CONTROL, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_resource_control* resource_control = cpuinfo_get_resource_control();
+	ASSERT_TRUE(resource_control);
+	for (const cpuinfo_cache_allocation* allocation :
+		{ &resource_control->l2_allocation, &resource_control->l3_allocation })
+	{
+		if (allocation->classes_count != 0) {
+			EXPECT_NE(0, allocation->capacity_mask_length);
+			EXPECT_LE(allocation->capacity_mask_length, 32);
+		}
+	}
+	for (uint32_t i = 0; i < cpuinfo_get_l3_caches_count(); i++) {
+		const cpuinfo_cache_allocation* allocation = cpuinfo_get_cache_allocation(cpuinfo_get_l3_cache(i));
+		if (resource_control->l3_allocation.classes_count != 0) {
+			EXPECT_EQ(&resource_control->l3_allocation, allocation);
+		} else {
+			EXPECT_FALSE(allocation);
+		}
+	}
+	if (cpuinfo_get_l1d_caches_count() != 0) {
+		EXPECT_FALSE(cpuinfo_get_cache_allocation(cpuinfo_get_l1d_cache(0)));
+	}
+	EXPECT_FALSE(cpuinfo_get_cache_allocation(nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(MAX_CACHE_SIZE, per_processor) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_processor(i);
+		const uint32_t max_cache_size = cpuinfo_get_processor_max_cache_size(processor);
+		EXPECT_NE(0, max_cache_size);
+		EXPECT_LE(cpuinfo_get_processor_private_cache_size(processor), max_cache_size);
+		if (processor->cache.l1d != nullptr) {
+			EXPECT_GE(cpuinfo_get_processor_private_cache_size(processor), processor->cache.l1d->size);
+		}
+	}
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		EXPECT_NE(0, cpuinfo_get_uarch_max_cache_size(i));
+		EXPECT_LE(cpuinfo_get_uarch_private_cache_size(i), cpuinfo_get_uarch_max_cache_size(i));
+	}
+	EXPECT_EQ(0, cpuinfo_get_uarch_max_cache_size(cpuinfo_get_uarchs_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(EFFECTIVE_CACHE_SIZE, per_core) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_processor(i);
+		const cpuinfo_cache* caches[] = {
+			processor->cache.l1d, processor->cache.l2, processor->cache.l3, processor->cache.l4};
+		for (uint32_t level = 1; level <= 4; level++) {
+			const cpuinfo_cache* cache = caches[level - 1];
+			const uint32_t effective_size = cpuinfo_get_processor_effective_cache_size(processor, level);
+			if (cache == nullptr) {
+				EXPECT_EQ(0, effective_size);
+			} else if (!(cache->flags & CPUINFO_CACHE_EXCLUSIVE)) {
+				EXPECT_NE(0, effective_size);
+				EXPECT_LE(effective_size, cache->size);
+			}
+			if (cache != nullptr) {
+				EXPECT_FALSE((cache->flags & CPUINFO_CACHE_INCLUSIVE) && (cache->flags & CPUINFO_CACHE_EXCLUSIVE));
+			}
+		}
+		EXPECT_EQ(0, cpuinfo_get_processor_effective_cache_size(processor, 0));
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(STREAMING_HINTS, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		EXPECT_NE(0, cpuinfo_get_uarch_prefetch_distance(i));
+		EXPECT_LE(cpuinfo_get_uarch_non_temporal_threshold(i), cpuinfo_get_uarch_max_cache_size(i) * 4);
+	}
+	EXPECT_EQ(0, cpuinfo_get_uarch_prefetch_distance(cpuinfo_get_uarchs_count()));
+	EXPECT_EQ(0, cpuinfo_get_uarch_non_temporal_threshold(cpuinfo_get_uarchs_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(INTERFERENCE_SIZE, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t constructive_size = cpuinfo_get_constructive_interference_size();
+	const uint32_t destructive_size = cpuinfo_get_destructive_interference_size();
+	EXPECT_NE(0, constructive_size);
+	EXPECT_EQ(0, constructive_size & (constructive_size - 1));
+	EXPECT_EQ(0, destructive_size & (destructive_size - 1));
+	EXPECT_LE(constructive_size, destructive_size);
+	for (uint32_t i = 0; i < cpuinfo_get_l1d_caches_count(); i++) {
+		EXPECT_LE(cpuinfo_get_l1d_cache(i)->line_size, destructive_size);
+	}
+	static_assert(CPUINFO_CONSTRUCTIVE_INTERFERENCE_SIZE <= CPUINFO_DESTRUCTIVE_INTERFERENCE_SIZE,
+		"constructive interference size exceeds destructive interference size");
+	cpuinfo_deinitialize();
+}
+
+TEST(VECTOR_HINT, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_vector_hint hint;
+		if (cpuinfo_get_uarch_vector_hint(i, &hint)) {
+			EXPECT_GE(hint.max_width, 128);
+			EXPECT_LE(hint.preferred_width, hint.max_width);
+			EXPECT_NE(0, hint.preferred_width);
+			EXPECT_LT(hint.wide_vector_frequency_penalty, 100);
+			if (hint.max_width < 512) {
+				EXPECT_EQ(0, hint.wide_vector_frequency_penalty);
+			}
+		}
+	}
+	cpuinfo_vector_hint hint;
+	EXPECT_FALSE(cpuinfo_get_uarch_vector_hint(cpuinfo_get_uarchs_count(), &hint));
+	EXPECT_FALSE(cpuinfo_get_uarch_vector_hint(0, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(VECTOR_INFO, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_vector_hint hint;
+		cpuinfo_vector_info info;
+		ASSERT_EQ(cpuinfo_get_uarch_vector_hint(i, &hint), cpuinfo_get_vector_info(i, &info));
+		if (cpuinfo_get_vector_info(i, &info)) {
+			EXPECT_GE(info.max_bits, hint.max_width);
+			EXPECT_LE(info.preferred_bits, info.max_bits);
+			EXPECT_NE(0, info.preferred_bits);
+			EXPECT_EQ(hint.wide_vector_frequency_penalty, info.wide_vector_frequency_penalty);
+			if (info.predicate_registers_count != 0) {
+				EXPECT_TRUE(info.predication);
+			}
+#if CPUINFO_ARCH_X86_64
+			EXPECT_EQ(cpuinfo_has_x86_avx512f() ? 32 : 16, info.registers_count);
+			EXPECT_FALSE(info.scalable);
+#endif
+		}
+	}
+	cpuinfo_vector_info info;
+	EXPECT_FALSE(cpuinfo_get_vector_info(cpuinfo_get_uarchs_count(), &info));
+	EXPECT_FALSE(cpuinfo_get_vector_info(0, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(ML_CAPABILITIES, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_ml_capabilities capabilities;
+		ASSERT_TRUE(cpuinfo_get_ml_capabilities(i, &capabilities));
+		EXPECT_NE(cpuinfo_ml_tier_convert, capabilities.int8);
+		EXPECT_LE(capabilities.int8, cpuinfo_ml_tier_matrix);
+		EXPECT_LE(capabilities.bf16, cpuinfo_ml_tier_matrix);
+		EXPECT_LE(capabilities.fp16, cpuinfo_ml_tier_matrix);
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		EXPECT_EQ(cpuinfo_has_x86_avx512vnni() || cpuinfo_has_x86_avxvnni() || cpuinfo_has_x86_amx_int8(),
+			capabilities.int8 != cpuinfo_ml_tier_none);
+		EXPECT_EQ(cpuinfo_has_x86_amx_bf16(), capabilities.bf16 == cpuinfo_ml_tier_matrix);
+#endif
+	}
+	cpuinfo_ml_capabilities capabilities;
+	EXPECT_FALSE(cpuinfo_get_ml_capabilities(cpuinfo_get_uarchs_count(), &capabilities));
+	EXPECT_FALSE(cpuinfo_get_ml_capabilities(0, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(PITFALLS, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t valid_pitfalls = CPUINFO_PITFALL_X86_SLOW_PDEP_PEXT | CPUINFO_PITFALL_X86_SLOW_GATHER |
+		CPUINFO_PITFALL_X86_AVX_SSE_TRANSITION | CPUINFO_PITFALL_X86_SLOW_VZEROUPPER | CPUINFO_PITFALL_X86_SPLIT_256BIT;
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		const uint32_t pitfalls = cpuinfo_get_uarch_pitfalls(i);
+		EXPECT_EQ(0, pitfalls & ~valid_pitfalls);
+		EXPECT_NE(CPUINFO_PITFALL_X86_AVX_SSE_TRANSITION | CPUINFO_PITFALL_X86_SLOW_VZEROUPPER,
+			pitfalls & (CPUINFO_PITFALL_X86_AVX_SSE_TRANSITION | CPUINFO_PITFALL_X86_SLOW_VZEROUPPER));
+	}
+	EXPECT_EQ(0, cpuinfo_get_uarch_pitfalls(cpuinfo_get_uarchs_count()));
+	cpuinfo_deinitialize();
+}
+
+TEST(SPIN_WAIT_HINT, uarchs) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_spin_wait_hint hint;
+		ASSERT_TRUE(cpuinfo_get_uarch_spin_wait_hint(i, &hint));
+		EXPECT_NE(0, hint.spin_iterations);
+		EXPECT_EQ(hint.pause_latency == cpuinfo_pause_latency_unknown, hint.pause_cycles == 0);
+		EXPECT_EQ(cpuinfo_has_x86_waitpkg(), hint.x86_waitpkg);
+		EXPECT_EQ(cpuinfo_has_x86_mwaitx(), hint.x86_mwaitx);
+		if (hint.pause_latency == cpuinfo_pause_latency_long) {
+			EXPECT_GT(100, hint.spin_iterations);
+		}
+	}
+	cpuinfo_spin_wait_hint hint;
+	EXPECT_FALSE(cpuinfo_get_uarch_spin_wait_hint(cpuinfo_get_uarchs_count(), &hint));
+	cpuinfo_deinitialize();
+}
+
+TEST(ISA_FEATURES, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_isa_features* features = cpuinfo_get_isa_features();
+	ASSERT_TRUE(features);
+	cpuinfo_isa_features required = {};
+	EXPECT_TRUE(cpuinfo_has_isa_features(&required));
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	EXPECT_EQ(cpuinfo_has_x86_sse2(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_sse2));
+	EXPECT_EQ(cpuinfo_has_x86_avx2(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx2));
+	EXPECT_EQ(cpuinfo_has_x86_avxvnni(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avxvnni));
+	EXPECT_EQ(cpuinfo_has_x86_movdir64b(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_movdir64b));
+	EXPECT_EQ(cpuinfo_has_x86_uintr(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_uintr));
+	cpuinfo_isa_features_add(&required, cpuinfo_isa_feature_x86_avx2);
+	cpuinfo_isa_features_add(&required, cpuinfo_isa_feature_x86_fma3);
+	EXPECT_EQ(cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3(), cpuinfo_has_isa_features(&required));
+#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+	EXPECT_EQ(cpuinfo_has_arm_neon(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_arm_neon));
+#endif
+	EXPECT_FALSE(cpuinfo_has_isa_features(nullptr));
+	EXPECT_EQ(cpuinfo_isa_fingerprint(), cpuinfo_isa_fingerprint());
+	cpuinfo_deinitialize();
+}
+
+TEST(COMPILE_TIME_ISA, detected) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* This code runs, so the processor supports the features which the compiler targets */
+	const cpuinfo_isa_features* features = cpuinfo_get_isa_features();
+#if defined(__AVX__)
+	EXPECT_TRUE(cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx));
+#endif
+#if defined(__AVX2__)
+	EXPECT_TRUE(cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx2));
+#endif
+#if defined(__AVX512F__)
+	EXPECT_TRUE(cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx512f));
+#endif
+#if defined(__ARM_FEATURE_DOTPROD)
+	EXPECT_TRUE(cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_arm_neon_dot));
+#endif
+#if defined(__ARM_FEATURE_SVE)
+	EXPECT_TRUE(cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_arm_sve));
+#endif
+	EXPECT_EQ(cpuinfo_has_x86_avx2(), cpuinfo_isa_features_contain(features, cpuinfo_isa_feature_x86_avx2));
+	cpuinfo_deinitialize();
+}
+
+TEST(ARM_ATOMICS, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	if (cpuinfo_has_arm_lse128()) {
+		EXPECT_TRUE(cpuinfo_has_arm_atomics());
+	}
+	if (cpuinfo_has_arm_rcpc3()) {
+		EXPECT_TRUE(cpuinfo_has_arm_rcpc2());
+	}
+	if (cpuinfo_has_arm_rcpc2()) {
+		EXPECT_TRUE(cpuinfo_has_arm_rcpc());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(ARM_CRYPTO, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	if (cpuinfo_has_arm_sha512()) {
+		EXPECT_TRUE(cpuinfo_has_arm_sha2());
+	}
+	if (cpuinfo_has_arm_sha3()) {
+		EXPECT_TRUE(cpuinfo_has_arm_neon());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(UARCH_ISA_FEATURES, superset) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		struct cpuinfo_isa_features features;
+		ASSERT_TRUE(cpuinfo_get_uarch_isa_features(i, &features));
+		EXPECT_TRUE(cpuinfo_isa_features_include(&features, cpuinfo_get_isa_features()));
+		if (cpuinfo_has_arm_neon_dot()) {
+			EXPECT_TRUE(cpuinfo_has_arm_neon_dot_on_uarch(i));
+		}
+	}
+	struct cpuinfo_isa_features features;
+	EXPECT_FALSE(cpuinfo_get_uarch_isa_features(cpuinfo_get_uarchs_count(), &features));
+	EXPECT_FALSE(cpuinfo_has_uarch_isa_feature(0, cpuinfo_isa_feature_max));
+	cpuinfo_deinitialize();
+}
+
+static void dispatch_portable(void) {}
+static void dispatch_unsupported(void) {}
+static void dispatch_tuned(void) {}
+
+TEST(DISPATCH_TABLE, resolve) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_dispatch_table table = {};
+	EXPECT_FALSE(cpuinfo_dispatch_table_resolve(&table));
+	EXPECT_FALSE(cpuinfo_dispatch_table_add(&table, nullptr, nullptr, cpuinfo_uarch_unknown));
+
+	/* An implementation which needs a feature the system lacks, e.g. an ARM feature on x86 */
+	cpuinfo_isa_features missing = {};
+	for (uint32_t i = 0; i < cpuinfo_isa_feature_max; i++) {
+		if (!cpuinfo_isa_features_contain(cpuinfo_get_isa_features(), (cpuinfo_isa_feature) i)) {
+			cpuinfo_isa_features_add(&missing, (cpuinfo_isa_feature) i);
+			break;
+		}
+	}
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&table, dispatch_unsupported, &missing, cpuinfo_uarch_unknown));
+	/* Tuned for a microarchitecture which is not present on the system */
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&table, dispatch_tuned, nullptr, cpuinfo_uarch_sifive_x280));
+	ASSERT_TRUE(cpuinfo_dispatch_table_add(&table, dispatch_portable, nullptr, cpuinfo_uarch_unknown));
+	ASSERT_TRUE(cpuinfo_dispatch_table_resolve(&table));
+	EXPECT_EQ(dispatch_portable, table.function);
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count() && i < CPUINFO_DISPATCH_MAX_UARCHS; i++) {
+		EXPECT_EQ(dispatch_portable, cpuinfo_dispatch_table_get(&table, i));
+	}
+	EXPECT_EQ(dispatch_portable, cpuinfo_dispatch_table_get(&table, CPUINFO_DISPATCH_MAX_UARCHS));
+	EXPECT_EQ(dispatch_portable, cpuinfo_dispatch_table_get_current(&table));
+
+	while (table.candidates_count < CPUINFO_DISPATCH_MAX_CANDIDATES) {
+		ASSERT_TRUE(cpuinfo_dispatch_table_add(&table, dispatch_portable, nullptr, cpuinfo_uarch_unknown));
+	}
+	EXPECT_FALSE(cpuinfo_dispatch_table_add(&table, dispatch_portable, nullptr, cpuinfo_uarch_unknown));
+	cpuinfo_deinitialize();
+}
+
+TEST(UARCH_COST_MODEL, consistent) {
+	EXPECT_FALSE(cpuinfo_get_uarch_cost_model(cpuinfo_uarch_unknown));
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		const cpuinfo_uarch_cost_model* cost_model = cpuinfo_get_uarch_cost_model(cpuinfo_get_uarch(i)->uarch);
+		if (cost_model != nullptr) {
+			EXPECT_EQ(cpuinfo_get_uarch(i)->uarch, cost_model->uarch);
+			EXPECT_NE(0, cost_model->decode_width);
+			EXPECT_LE(cost_model->fma_units, cost_model->vector_pipes);
+			EXPECT_EQ(cost_model->fma_units == 0, cost_model->fma_latency == 0);
+		}
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(PEAK_THROUGHPUT, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_peak_throughput package_throughput;
+	ASSERT_TRUE(cpuinfo_get_package_peak_throughput(cpuinfo_get_package(0), &package_throughput));
+	uint64_t fp32_ops_per_cycle = 0;
+	uint64_t int8_ops_per_second = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_clusters_count(); i++) {
+		const cpuinfo_cluster* cluster = cpuinfo_get_cluster(i);
+		cpuinfo_peak_throughput cluster_throughput;
+		ASSERT_TRUE(cpuinfo_get_cluster_peak_throughput(cluster, &cluster_throughput));
+		cpuinfo_peak_throughput core_throughput;
+		ASSERT_TRUE(cpuinfo_get_core_peak_throughput(cpuinfo_get_core(cluster->core_start), &core_throughput));
+		EXPECT_LE(core_throughput.fp32_ops_per_cycle, cluster_throughput.fp32_ops_per_cycle);
+		if (cluster->package == cpuinfo_get_package(0)) {
+			fp32_ops_per_cycle += cluster_throughput.fp32_ops_per_cycle;
+			int8_ops_per_second += cluster_throughput.int8_ops_per_second;
+		}
+	}
+	EXPECT_EQ(fp32_ops_per_cycle, package_throughput.fp32_ops_per_cycle);
+	EXPECT_EQ(int8_ops_per_second, package_throughput.int8_ops_per_second);
+
+	cpuinfo_package foreign_package = *cpuinfo_get_package(0);
+	EXPECT_FALSE(cpuinfo_get_package_peak_throughput(&foreign_package, &package_throughput));
+	EXPECT_FALSE(cpuinfo_get_cluster_peak_throughput(nullptr, &package_throughput));
+	EXPECT_FALSE(cpuinfo_get_core_peak_throughput(cpuinfo_get_core(0), nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(PMU_INFO, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_pmu_info pmu;
+		if (!cpuinfo_get_uarch_pmu_info(i, &pmu)) {
+			continue;
+		}
+		EXPECT_EQ(pmu.perf_event_allowed, pmu.perf_event_paranoid <= 2);
+		EXPECT_LE(pmu.fixed_counters, 32);
+		EXPECT_EQ(0, pmu.architectural_events & ~UINT32_C(0xFF));
+		if (pmu.general_counters != 0 && pmu.general_counter_width != 0) {
+			EXPECT_LE(pmu.general_counter_width, 64);
+		}
+	}
+	cpuinfo_pmu_info pmu;
+	EXPECT_FALSE(cpuinfo_get_uarch_pmu_info(cpuinfo_get_uarchs_count(), &pmu));
+	EXPECT_FALSE(cpuinfo_get_uarch_pmu_info(0, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(TRACE_INFO, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_trace_info trace;
+		if (!cpuinfo_get_uarch_trace_info(i, &trace)) {
+			continue;
+		}
+		if (trace.facilities & CPUINFO_TRACE_ARCHITECTURAL_LBR) {
+			EXPECT_TRUE(trace.facilities & CPUINFO_TRACE_LBR);
+		}
+		if (trace.facilities & (CPUINFO_TRACE_LBR | CPUINFO_TRACE_AMD_LBR_V2 | CPUINFO_TRACE_AMD_BRS)) {
+			EXPECT_NE(0, trace.branch_records);
+		}
+		if (!(trace.facilities & CPUINFO_TRACE_INTEL_PT)) {
+			EXPECT_EQ(0, trace.intel_pt_capabilities);
+			EXPECT_EQ(0, trace.intel_pt_address_ranges);
+		}
+		if (!(trace.facilities & CPUINFO_TRACE_ARM_SPE)) {
+			EXPECT_EQ(UINT32_MAX, trace.sampling_perf_type);
+		}
+	}
+	cpuinfo_trace_info trace;
+	EXPECT_FALSE(cpuinfo_get_uarch_trace_info(cpuinfo_get_uarchs_count(), &trace));
+	EXPECT_FALSE(cpuinfo_get_uarch_trace_info(0, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(COUNTER_SAMPLER, aggregates_clusters) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_package* package = cpuinfo_get_package(0);
+	EXPECT_EQ(nullptr, cpuinfo_create_counter_sampler(0, package->processor_start, package->processor_count));
+	EXPECT_EQ(nullptr, cpuinfo_create_counter_sampler(CPUINFO_PMU_EVENT_TOPDOWN_SLOTS, 0, 1));
+	EXPECT_EQ(nullptr, cpuinfo_create_counter_sampler(CPUINFO_PMU_EVENT_CYCLES, cpuinfo_get_processors_count(), 1));
+
+	const uint32_t events = CPUINFO_PMU_EVENT_CYCLES | CPUINFO_PMU_EVENT_INSTRUCTIONS | CPUINFO_PMU_EVENT_LLC_MISSES;
+	cpuinfo_counter_sampler* sampler =
+		cpuinfo_create_counter_sampler(events, package->processor_start, package->processor_count);
+	/* Counting all processes requires CAP_PERFMON or permissive perf_event_paranoid */
+	if (sampler != nullptr) {
+		cpuinfo_counter_sample total;
+		ASSERT_TRUE(cpuinfo_sample_counters(sampler, 0, cpuinfo_get_processors_count(), &total));
+		EXPECT_LE(total.processors_count, package->processor_count);
+		EXPECT_EQ(0, total.events & ~events);
+		uint32_t processors_count = 0;
+		for (uint32_t i = package->cluster_start; i < package->cluster_start + package->cluster_count; i++) {
+			const cpuinfo_cluster* cluster = cpuinfo_get_cluster(i);
+			cpuinfo_counter_sample sample = {};
+			cpuinfo_sample_counters(sampler, cluster->processor_start, cluster->processor_count, &sample);
+			EXPECT_LE(sample.processors_count, cluster->processor_count);
+			processors_count += sample.processors_count;
+		}
+		EXPECT_EQ(total.processors_count, processors_count);
+		EXPECT_FALSE(cpuinfo_sample_counters(sampler, 0, 0, &total));
+		cpuinfo_destroy_counter_sampler(sampler);
+	}
+	cpuinfo_deinitialize();
+}
+
+#if defined(_WIN32)
+TEST(WINDOWS_CPU_SETS, state_and_selection) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_processor* processor = cpuinfo_get_processor(0);
+	cpuinfo_windows_cpu_set_state state;
+	/* CPU sets are supported since Windows 10 */
+	if (processor->windows_cpu_set_id != 0) {
+		ASSERT_TRUE(cpuinfo_get_windows_cpu_set_state(processor, &state));
+		EXPECT_EQ(processor->core->windows_efficiency_class, state.efficiency_class);
+		EXPECT_TRUE(cpuinfo_select_current_thread_cpu_sets(cpuinfo_get_core_affinity(processor->core)));
+		EXPECT_TRUE(cpuinfo_select_current_thread_cpu_sets(nullptr));
+	}
+	cpuinfo_processor foreign_processor = *processor;
+	EXPECT_FALSE(cpuinfo_get_windows_cpu_set_state(&foreign_processor, &state));
+	cpuinfo_deinitialize();
+}
+#endif
+
+TEST(CPP_API, views) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_EQ(cpuinfo_get_processors_count(), cpuinfo::processors().size());
+	EXPECT_EQ(cpuinfo_get_processors(), cpuinfo::processors().data());
+	EXPECT_EQ(cpuinfo_get_cores_count(), cpuinfo::cores().size());
+	EXPECT_EQ(cpuinfo_get_l1d_caches_count(), cpuinfo::l1d_caches().size());
+	for (const cpuinfo_cluster& cluster : cpuinfo::clusters()) {
+		uint32_t processors_count = 0;
+		for (const cpuinfo_processor& processor : cpuinfo::processors_of(cluster)) {
+			EXPECT_EQ(&cluster, processor.cluster);
+			processors_count++;
+		}
+		EXPECT_EQ(cluster.processor_count, processors_count);
+		for (const cpuinfo_core& core : cpuinfo::cores_of(cluster)) {
+			EXPECT_EQ(&cluster, core.cluster);
+		}
+	}
+	for (const cpuinfo_cache& cache : cpuinfo::l1d_caches()) {
+		for (const cpuinfo_processor& processor : cpuinfo::sharing(cache)) {
+			EXPECT_EQ(&cache, processor.cache.l1d);
+		}
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(CPP_API, isa_requirement) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	constexpr cpuinfo::isa_requirement none;
+	static_assert(none.empty(), "default requirement must be empty");
+	constexpr cpuinfo::isa_requirement sse2_avx{cpuinfo_isa_feature_x86_sse2, cpuinfo_isa_feature_x86_avx};
+	static_assert(sse2_avx.contains(cpuinfo_isa_feature_x86_avx), "requirement must contain its features");
+	static_assert(!sse2_avx.contains(cpuinfo_isa_feature_arm_neon), "requirement must not contain other features");
+	constexpr cpuinfo::isa_requirement neon = cpuinfo::isa_requirement() | cpuinfo_isa_feature_arm_neon;
+	static_assert((sse2_avx | neon).contains(cpuinfo_isa_feature_arm_neon), "union must contain features of both");
+
+	EXPECT_TRUE(none.supported());
+	const cpuinfo_isa_features features = sse2_avx.features();
+	EXPECT_EQ(cpuinfo_has_isa_features(&features), sse2_avx.supported());
+	EXPECT_FALSE((sse2_avx | neon).supported());
+	cpuinfo_deinitialize();
+}
+
+TEST(SVE_VECTOR_LENGTH, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t vector_length = cpuinfo_get_arm_sve_vector_length();
+	if (cpuinfo_has_arm_sve()) {
+		EXPECT_NE(0, vector_length);
+		EXPECT_EQ(0, vector_length % 16);
+		EXPECT_LE(vector_length, 256);
+	} else {
+		EXPECT_EQ(0, vector_length);
+		EXPECT_FALSE(cpuinfo_set_arm_sve_vector_length(16));
+	}
+	EXPECT_FALSE(cpuinfo_set_arm_sve_vector_length(0));
+	cpuinfo_deinitialize();
+}
+
+TEST(SME_VECTOR_LENGTH, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t vector_length = cpuinfo_get_arm_sme_vector_length();
+	if (cpuinfo_has_arm_sme()) {
+		EXPECT_NE(0, vector_length);
+		EXPECT_EQ(0, vector_length % 16);
+		EXPECT_LE(vector_length, 256);
+	} else {
+		EXPECT_EQ(0, vector_length);
+		EXPECT_FALSE(cpuinfo_has_arm_sme2());
+		EXPECT_FALSE(cpuinfo_has_arm_sme_fa64());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(MTE, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* Each version of MTE extends the previous one */
+	if (cpuinfo_has_arm_mte3()) {
+		EXPECT_TRUE(cpuinfo_has_arm_mte2());
+	}
+	if (cpuinfo_has_arm_mte2()) {
+		EXPECT_TRUE(cpuinfo_has_arm_mte());
+	}
+	const cpuinfo_arm_mte_mode mode = cpuinfo_get_arm_mte_mode();
+	if (!cpuinfo_has_arm_mte2()) {
+		EXPECT_EQ(cpuinfo_arm_mte_mode_unavailable, mode);
+	}
+	if (!cpuinfo_has_arm_mte3()) {
+		EXPECT_NE(cpuinfo_arm_mte_mode_asymmetric, mode);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(RISCV_VECTOR_LENGTH, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t vector_length = cpuinfo_get_riscv_vector_length();
+	if (cpuinfo_has_riscv_v()) {
+		/* The V extension requires VLEN of at least 128 bits, and VLEN is a power of 2 */
+		EXPECT_GE(vector_length, 16);
+		EXPECT_EQ(0, vector_length & (vector_length - 1));
+	} else {
+		EXPECT_EQ(0, vector_length);
+		EXPECT_FALSE(cpuinfo_has_riscv_zvbb());
+		EXPECT_FALSE(cpuinfo_has_riscv_zvfh());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(LOONGARCH_ISA, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	/* LASX extends LSX registers, LSX registers extend floating-point registers */
+	if (cpuinfo_has_loongarch_lasx()) {
+		EXPECT_TRUE(cpuinfo_has_loongarch_lsx());
+	}
+	if (cpuinfo_has_loongarch_lsx()) {
+		EXPECT_TRUE(cpuinfo_has_loongarch_fpu());
+	}
+	if (cpuinfo_has_loongarch_lam_bh()) {
+		EXPECT_TRUE(cpuinfo_has_loongarch_lam());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(WASM_ISA, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	if (cpuinfo_has_wasm_relaxed_simd()) {
+		EXPECT_TRUE(cpuinfo_has_wasm_simd128());
+	}
+	#if CPUINFO_ARCH_WASMSIMD
+		/* The module itself uses SIMD128, so the engine which runs it must support it */
+		EXPECT_TRUE(cpuinfo_has_wasm_simd128());
+	#endif
+	cpuinfo_deinitialize();
+}
+
+TEST(AVX10, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t max_vector_bits = cpuinfo_get_x86_avx10_max_vector_bits();
+	if (cpuinfo_get_x86_avx10_version() == 0) {
+		EXPECT_EQ(0, max_vector_bits);
+	} else {
+		EXPECT_TRUE(max_vector_bits == 128 || max_vector_bits == 256 || max_vector_bits == 512);
+		EXPECT_EQ(max_vector_bits == 512, cpuinfo_has_x86_avx512f());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(AMX, permission) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_EQ(cpuinfo_has_x86_amx_tile(), cpuinfo_request_x86_amx_permission());
+	if (!cpuinfo_has_x86_amx_tile()) {
+		EXPECT_FALSE(cpuinfo_has_x86_amx_int8());
+		EXPECT_FALSE(cpuinfo_has_x86_amx_bf16());
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(XSAVE_STATE, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_x86_xsave_state* xsave_state = cpuinfo_get_x86_xsave_state();
+	ASSERT_TRUE(xsave_state);
+	for (uint32_t i = 0; i < CPUINFO_X86_XSAVE_COMPONENTS_MAX; i++) {
+		const cpuinfo_x86_xsave_component& component = xsave_state->components[i];
+		EXPECT_EQ((xsave_state->features >> i) & 1, component.size != 0 ? 1 : 0);
+		EXPECT_LE(component.offset + component.size, xsave_state->size);
+	}
+	if (xsave_state->size == 0) {
+		EXPECT_EQ(0, xsave_state->features);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(XSAVE_STATE, vector_extensions) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_x86_xsave_state* xsave_state = cpuinfo_get_x86_xsave_state();
+	ASSERT_TRUE(xsave_state);
+	for (uint32_t i = 0; i < cpuinfo_x86_vector_extension_max; i++) {
+		const cpuinfo_x86_vector_extension_state& extension = xsave_state->extensions[i];
+		EXPECT_EQ(extension.enabled, extension.reason == cpuinfo_x86_vector_extension_reason_enabled);
+		EXPECT_EQ(extension.supported, extension.reason != cpuinfo_x86_vector_extension_reason_unsupported);
+		if (extension.enabled) {
+			EXPECT_EQ(extension.state_components, xsave_state->features & extension.state_components);
+		}
+	}
+	const cpuinfo_x86_vector_extension_state* extensions = xsave_state->extensions;
+	EXPECT_EQ(cpuinfo_has_x86_avx(), extensions[cpuinfo_x86_vector_extension_avx].enabled);
+	EXPECT_EQ(cpuinfo_has_x86_amx_tile(), extensions[cpuinfo_x86_vector_extension_amx].enabled);
+	EXPECT_EQ(cpuinfo_has_x86_apx(), extensions[cpuinfo_x86_vector_extension_apx].enabled);
+	if (cpuinfo_has_x86_avx512f()) {
+		EXPECT_TRUE(extensions[cpuinfo_x86_vector_extension_avx512].enabled);
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(CHECKSUM_CAPABILITIES, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		cpuinfo_checksum_capabilities capabilities;
+		ASSERT_TRUE(cpuinfo_get_checksum_capabilities(i, &capabilities));
+		EXPECT_NE(cpuinfo_checksum_method_crc_instruction, capabilities.crc64);
+		EXPECT_EQ(capabilities.crc64 != cpuinfo_checksum_method_software, capabilities.clmul_bits != 0);
+		EXPECT_GE(capabilities.crc32c, capabilities.crc32);
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		EXPECT_EQ(cpuinfo_has_x86_aes(), capabilities.aes_bits != 0);
+		EXPECT_EQ(cpuinfo_has_x86_pclmulqdq(), capabilities.clmul_bits != 0);
+		if (cpuinfo_has_x86_sse4_2()) {
+			EXPECT_NE(cpuinfo_checksum_method_software, capabilities.crc32c);
+		}
+#endif
+	}
+	cpuinfo_checksum_capabilities capabilities;
+	EXPECT_FALSE(cpuinfo_get_checksum_capabilities(cpuinfo_get_uarchs_count(), &capabilities));
+	EXPECT_FALSE(cpuinfo_get_checksum_capabilities(0, nullptr));
+	cpuinfo_deinitialize();
+}
+
+TEST(VULNERABILITY_STATE, consistent) {
+	for (uint32_t i = 0; i < cpuinfo_vulnerability_max; i++) {
+		cpuinfo_vulnerability_state state;
+		if (cpuinfo_get_vulnerability_state((cpuinfo_vulnerability) i, &state)) {
+			EXPECT_NE('\0', state.description[0]);
+		} else {
+			EXPECT_EQ(cpuinfo_vulnerability_status_unknown, state.status);
+		}
+		if (state.microcode_mitigation) {
+			EXPECT_EQ(cpuinfo_vulnerability_status_mitigated, state.status);
+		}
+	}
+	cpuinfo_vulnerability_state state;
+	EXPECT_FALSE(cpuinfo_get_vulnerability_state(cpuinfo_vulnerability_max, &state));
+	EXPECT_FALSE(cpuinfo_get_vulnerability_state(cpuinfo_vulnerability_spectre_v1, NULL));
+}
+
+TEST(PREFETCHERS, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_prefetchers system;
+	cpuinfo_get_prefetchers(&system);
+	bool any_known = false;
+	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
+		cpuinfo_prefetchers prefetchers;
+		ASSERT_TRUE(cpuinfo_get_core_prefetchers(i, &prefetchers));
+		if (prefetchers.source == cpuinfo_prefetchers_source_unknown) {
+			EXPECT_FALSE(prefetchers.l2_stream || prefetchers.l2_adjacent_line || prefetchers.l1d_stream);
+		} else {
+			any_known = true;
+			EXPECT_NE(cpuinfo_prefetchers_source_unknown, system.source);
+		}
+	}
+	if (!any_known) {
+		EXPECT_EQ(cpuinfo_prefetchers_source_unknown, system.source);
+	}
+	cpuinfo_prefetchers prefetchers;
+	EXPECT_FALSE(cpuinfo_get_core_prefetchers(cpuinfo_get_cores_count(), &prefetchers));
+	EXPECT_EQ(cpuinfo_prefetchers_source_unknown, prefetchers.source);
+	cpuinfo_deinitialize();
+}
+
+TEST(X86_TSX_STATE, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	cpuinfo_x86_tsx_state state;
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	ASSERT_TRUE(cpuinfo_get_x86_tsx_state(true, &state));
+	EXPECT_EQ(cpuinfo_has_x86_rtm(), state.rtm_status != cpuinfo_x86_rtm_status_unsupported);
+	if (state.hle_usable) {
+		EXPECT_EQ(cpuinfo_x86_rtm_status_usable, state.rtm_status);
+	}
+	if (state.rtm_always_abort && cpuinfo_has_x86_rtm()) {
+		EXPECT_EQ(cpuinfo_x86_rtm_status_always_aborts, state.rtm_status);
+	}
+	if (state.probed && !state.probe_committed) {
+		EXPECT_EQ(cpuinfo_x86_rtm_status_always_aborts, state.rtm_status);
+	}
+#else
+	EXPECT_FALSE(cpuinfo_get_x86_tsx_state(true, &state));
+	EXPECT_EQ(cpuinfo_x86_rtm_status_unsupported, state.rtm_status);
+#endif
+	EXPECT_FALSE(cpuinfo_get_x86_tsx_state(false, NULL));
+	cpuinfo_deinitialize();
+}
 
+TEST(X86_64_LEVEL, consistent) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const uint32_t level = cpuinfo_get_x86_64_level();
+	EXPECT_LE(level, 4);
+	EXPECT_FALSE(cpuinfo_has_x86_64_level(0));
+	for (uint32_t i = 1; i <= 4; i++) {
+		EXPECT_EQ(i <= level, cpuinfo_has_x86_64_level(i));
+	}
+#if CPUINFO_ARCH_X86_64
+	EXPECT_NE(0, level);
+	EXPECT_EQ(level >= 3, cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3() && cpuinfo_has_x86_movbe() && level >= 2);
+	EXPECT_EQ(level >= 4, cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_avx512bw() && level >= 3);
+#endif
+	cpuinfo_deinitialize();
+}
 
 TEST(PROCESSORS_COUNT, non_zero) {
 	ASSERT_TRUE(cpuinfo_initialize());
@@ -503,6 +3271,32 @@ TEST(CLUSTER, consistent_cpuid) {
 	}
 	cpuinfo_deinitialize();
 }
+
+#if defined(__linux__)
+TEST(PROCESSOR, apic_id_matches_proc_cpuinfo) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	FILE* file = fopen("/proc/cpuinfo", "r");
+	ASSERT_TRUE(file);
+	char line[4096];
+	uint32_t linux_id = UINT32_MAX, apic_id = 0;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (sscanf(line, "processor : %" SCNu32, &linux_id) != 1 &&
+			sscanf(line, "apicid : %" SCNu32, &apic_id) == 1)
+		{
+			const cpuinfo_processor* processor = nullptr;
+			for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+				if (cpuinfo_get_processor(i)->linux_id == (int) linux_id) {
+					processor = cpuinfo_get_processor(i);
+				}
+			}
+			ASSERT_TRUE(processor);
+			EXPECT_EQ(apic_id, processor->apic_id) << "processor " << linux_id;
+		}
+	}
+	fclose(file);
+	cpuinfo_deinitialize();
+}
+#endif
 #endif /* CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64 */
 
 #if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
@@ -744,6 +3538,19 @@ TEST(UARCH, valid_cores) {
 	cpuinfo_deinitialize();
 }
 
+TEST(UARCH, cover_processors) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	uint32_t processors_count = 0;
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		const cpuinfo_uarch_info* uarch = cpuinfo_get_uarch(i);
+		ASSERT_TRUE(uarch);
+
+		processors_count += uarch->processor_count;
+	}
+	EXPECT_EQ(cpuinfo_get_processors_count(), processors_count);
+	cpuinfo_deinitialize();
+}
+
 TEST(L1I_CACHES_COUNT, within_bounds) {
 	ASSERT_TRUE(cpuinfo_initialize());
 	EXPECT_NE(0, cpuinfo_get_l1i_caches_count());
@@ -1329,7 +4136,8 @@ TEST(L3_CACHE, reasonable_line_size) {
 TEST(L3_CACHE, valid_flags) {
 	ASSERT_TRUE(cpuinfo_initialize());
 
-	const uint32_t valid_flags = CPUINFO_CACHE_UNIFIED | CPUINFO_CACHE_INCLUSIVE | CPUINFO_CACHE_COMPLEX_INDEXING;
+	const uint32_t valid_flags = CPUINFO_CACHE_UNIFIED | CPUINFO_CACHE_INCLUSIVE | CPUINFO_CACHE_EXCLUSIVE |
+		CPUINFO_CACHE_COMPLEX_INDEXING;
 	for (uint32_t i = 0; i < cpuinfo_get_l3_caches_count(); i++) {
 		const cpuinfo_cache* cache = cpuinfo_get_l3_cache(i);
 		ASSERT_TRUE(cache);
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#define CPUINFO_INLINE_ACCESSORS 1
+#include <cpuinfo.h>
+
+
+/* Parentheses around the function names suppress the function-like macros of the inline accessors */
+TEST(INLINE_ACCESSORS, match_library) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	EXPECT_EQ((cpuinfo_get_processors_count)(), cpuinfo_get_processors_count());
+	EXPECT_EQ((cpuinfo_get_cores_count)(), cpuinfo_get_cores_count());
+	EXPECT_EQ((cpuinfo_get_clusters_count)(), cpuinfo_get_clusters_count());
+	EXPECT_EQ((cpuinfo_get_packages_count)(), cpuinfo_get_packages_count());
+	EXPECT_EQ((cpuinfo_get_uarchs_count)(), cpuinfo_get_uarchs_count());
+	EXPECT_EQ((cpuinfo_get_processors)(), cpuinfo_get_processors());
+	EXPECT_EQ((cpuinfo_get_cores)(), cpuinfo_get_cores());
+	EXPECT_EQ((cpuinfo_get_clusters)(), cpuinfo_get_clusters());
+	EXPECT_EQ((cpuinfo_get_packages)(), cpuinfo_get_packages());
+	EXPECT_EQ((cpuinfo_get_uarchs)(), cpuinfo_get_uarchs());
+	for (uint32_t i = 0; i <= cpuinfo_get_processors_count(); i++) {
+		EXPECT_EQ((cpuinfo_get_processor)(i), cpuinfo_get_processor(i));
+	}
+	for (uint32_t i = 0; i <= cpuinfo_get_cores_count(); i++) {
+		EXPECT_EQ((cpuinfo_get_core)(i), cpuinfo_get_core(i));
+	}
+	for (uint32_t i = 0; i <= cpuinfo_get_clusters_count(); i++) {
+		EXPECT_EQ((cpuinfo_get_cluster)(i), cpuinfo_get_cluster(i));
+	}
+	for (uint32_t i = 0; i <= cpuinfo_get_packages_count(); i++) {
+		EXPECT_EQ((cpuinfo_get_package)(i), cpuinfo_get_package(i));
+	}
+	for (uint32_t i = 0; i <= cpuinfo_get_uarchs_count(); i++) {
+		EXPECT_EQ((cpuinfo_get_uarch)(i), cpuinfo_get_uarch(i));
+	}
+	cpuinfo_deinitialize();
+}
+
+TEST(INLINE_ACCESSORS, follow_reinitialization) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	const cpuinfo_hot_tables* hot_tables = cpuinfo_published_hot_tables;
+	ASSERT_TRUE(hot_tables);
+	EXPECT_EQ(0, (uintptr_t) hot_tables % 64);
+	ASSERT_TRUE(cpuinfo_reinitialize());
+	EXPECT_EQ((cpuinfo_get_processors)(), cpuinfo_get_processors());
+	EXPECT_EQ((cpuinfo_get_processors_count)(), cpuinfo_get_processors_count());
+	cpuinfo_deinitialize();
+	EXPECT_FALSE(cpuinfo_published_hot_tables);
+}
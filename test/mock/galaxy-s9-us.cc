@@ -94,7 +94,7 @@ TEST(PROCESSORS, l3) {
 
 TEST(PROCESSORS, l4) {
 	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
-		ASSERT_FALSE(cpuinfo_get_processor(i)->cache.l4);
+		ASSERT_EQ(cpuinfo_get_l4_cache(0), cpuinfo_get_processor(i)->cache.l4);
 	}
 }
 
@@ -785,7 +785,7 @@ TEST(L3, line_size) {
 
 TEST(L3, flags) {
 	for (uint32_t i = 0; i < cpuinfo_get_l3_caches_count(); i++) {
-		ASSERT_EQ(0, cpuinfo_get_l3_cache(i)->flags);
+		ASSERT_EQ(CPUINFO_CACHE_EXCLUSIVE, cpuinfo_get_l3_cache(i)->flags);
 	}
 }
 
@@ -796,9 +796,56 @@ TEST(L3, processors) {
 	}
 }
 
-TEST(L4, none) {
-	ASSERT_EQ(0, cpuinfo_get_l4_caches_count());
-	ASSERT_FALSE(cpuinfo_get_l4_caches());
+TEST(L4, count) {
+	ASSERT_EQ(1, cpuinfo_get_l4_caches_count());
+}
+
+TEST(L4, non_null) {
+	ASSERT_TRUE(cpuinfo_get_l4_caches());
+}
+
+TEST(L4, size) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(3 * 1024 * 1024, cpuinfo_get_l4_cache(i)->size);
+	}
+}
+
+TEST(L4, associativity) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(12, cpuinfo_get_l4_cache(i)->associativity);
+	}
+}
+
+TEST(L4, sets) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(cpuinfo_get_l4_cache(i)->size,
+			cpuinfo_get_l4_cache(i)->sets * cpuinfo_get_l4_cache(i)->line_size * cpuinfo_get_l4_cache(i)->partitions * cpuinfo_get_l4_cache(i)->associativity);
+	}
+}
+
+TEST(L4, partitions) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(1, cpuinfo_get_l4_cache(i)->partitions);
+	}
+}
+
+TEST(L4, line_size) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(64, cpuinfo_get_l4_cache(i)->line_size);
+	}
+}
+
+TEST(L4, flags) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(0, cpuinfo_get_l4_cache(i)->flags);
+	}
+}
+
+TEST(L4, processors) {
+	for (uint32_t i = 0; i < cpuinfo_get_l4_caches_count(); i++) {
+		ASSERT_EQ(0, cpuinfo_get_l4_cache(i)->processor_start);
+		ASSERT_EQ(8, cpuinfo_get_l4_cache(i)->processor_count);
+	}
 }
 
 #include <galaxy-s9-us.h>
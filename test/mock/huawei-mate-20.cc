@@ -824,7 +824,7 @@ TEST(L3, line_size) {
 
 TEST(L3, flags) {
 	for (uint32_t i = 0; i < cpuinfo_get_l3_caches_count(); i++) {
-		ASSERT_EQ(0, cpuinfo_get_l3_cache(i)->flags);
+		ASSERT_EQ(CPUINFO_CACHE_EXCLUSIVE, cpuinfo_get_l3_cache(i)->flags);
 	}
 }
 
@@ -340,6 +340,18 @@ TEST(PACKAGES, name) {
 	}
 }
 
+TEST(INTEGRATED_GPU, name) {
+	const cpuinfo_integrated_gpu* gpu = cpuinfo_get_integrated_gpu();
+	ASSERT_TRUE(gpu);
+	ASSERT_EQ(cpuinfo_gpu_family_adreno, gpu->family);
+	ASSERT_EQ(540, gpu->model);
+	ASSERT_EQ("Adreno 540", std::string(gpu->name, strnlen(gpu->name, CPUINFO_GPU_NAME_MAX)));
+}
+
+TEST(NPU, none) {
+	ASSERT_FALSE(cpuinfo_get_npu());
+}
+
 TEST(PACKAGES, processor_start) {
 	for (uint32_t i = 0; i < cpuinfo_get_packages_count(); i++) {
 		ASSERT_EQ(0, cpuinfo_get_package(i)->processor_start);
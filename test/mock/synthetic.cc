@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+
+#include <string>
+
+#include <cpuinfo.h>
+#include <cpuinfo-mock.h>
+
+
+/* Initialize cpuinfo on a synthetic system, which stays mocked until the end of the test */
+class SyntheticSystem {
+public:
+	explicit SyntheticSystem(const cpuinfo_mock_topology& topology) {
+		EXPECT_TRUE(cpuinfo_mock_generate_system(&topology, &system_));
+		cpuinfo_mock_filesystem(system_.files);
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		cpuinfo_mock_set_cpuid(system_.cpuid_dump, system_.cpuid_entries);
+#endif
+		EXPECT_TRUE(cpuinfo_initialize());
+	}
+
+	~SyntheticSystem() {
+		cpuinfo_deinitialize();
+		cpuinfo_mock_release_system(&system_);
+	}
+
+private:
+	cpuinfo_mock_system system_;
+};
+
+TEST(SYNTHETIC, invalid_topology) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = CPUINFO_MOCK_PACKAGES_MAX + 1;
+	topology.nodes_per_package = 1;
+	topology.clusters_count = 1;
+	topology.clusters[0].cores = 1;
+	topology.clusters[0].threads_per_core = 1;
+	topology.clusters[0].max_frequency = 1000000;
+	cpuinfo_mock_system system;
+	EXPECT_FALSE(cpuinfo_mock_generate_system(&topology, &system));
+	EXPECT_FALSE(system.files);
+}
+
+TEST(SYNTHETIC, sub_numa_clusters) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = 2;
+	topology.nodes_per_package = 4;
+	topology.clusters_count = 1;
+	topology.clusters[0].cores = 56;
+	topology.clusters[0].threads_per_core = 2;
+	topology.clusters[0].max_frequency = 3800000;
+	topology.clusters[0].midr = UINT32_C(0x410FD0C1);
+	SyntheticSystem system(topology);
+
+	ASSERT_EQ(2 * 56 * 2, cpuinfo_get_processors_count());
+	ASSERT_EQ(2 * 56, cpuinfo_get_cores_count());
+	ASSERT_EQ(2, cpuinfo_get_packages_count());
+	ASSERT_EQ(8, cpuinfo_get_numa_nodes_count());
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* processor = cpuinfo_get_processor(i);
+		ASSERT_EQ(processor->package, processor->core->package);
+		ASSERT_EQ(processor->core->processor_count, 2);
+	}
+	/* Nodes of the same package are closer than nodes of the other package */
+	const uint32_t* distances = cpuinfo_get_numa_distances();
+	if (distances != NULL) {
+		EXPECT_LT(distances[1], distances[4]);
+	}
+
+	/* Processors of other nodes of the package are nearer than processors of the other package */
+	const cpuinfo_processor* processor = cpuinfo_get_processor(0);
+	for (uint32_t i = 1; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* other = cpuinfo_get_processor(i);
+		uint32_t numa_distance = 0;
+		const cpuinfo_distance_level level = cpuinfo_get_processor_distance(0, i, &numa_distance);
+		if (other->package != processor->package) {
+			EXPECT_EQ(cpuinfo_distance_level_remote, level);
+		} else if (other->numa_node != processor->numa_node) {
+			EXPECT_EQ(cpuinfo_distance_level_package, level);
+		} else {
+			EXPECT_LT(level, cpuinfo_distance_level_package);
+		}
+		if (distances != NULL) {
+			EXPECT_EQ(distances[other->numa_node - cpuinfo_get_numa_nodes()], numa_distance);
+		}
+	}
+}
+
+TEST(SYNTHETIC, steal_order) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = 2;
+	topology.nodes_per_package = 2;
+	topology.clusters_count = 1;
+	topology.clusters[0].cores = 8;
+	topology.clusters[0].threads_per_core = 2;
+	topology.clusters[0].max_frequency = 3800000;
+	topology.clusters[0].midr = UINT32_C(0x410FD0C1);
+	SyntheticSystem system(topology);
+
+	/* Every thief steals from the SMT sibling, then its NUMA node, then its package, and then the other package */
+	for (uint32_t i = 0; i < cpuinfo_get_processors_count(); i++) {
+		const cpuinfo_processor* thief = cpuinfo_get_processor(i);
+		uint32_t count = 0;
+		const uint32_t* victims = cpuinfo_get_steal_order(i, &count);
+		ASSERT_EQ(cpuinfo_get_processors_count() - 1, count);
+		uint32_t level = 0;
+		for (uint32_t j = 0; j < count; j++) {
+			const cpuinfo_processor* victim = cpuinfo_get_processor(victims[j]);
+			const uint32_t victim_level = victim->core == thief->core ? 0 :
+				victim->numa_node == thief->numa_node ? 1 : victim->package == thief->package ? 2 : 3;
+			EXPECT_LE(level, victim_level);
+			level = victim_level;
+		}
+		EXPECT_EQ(thief->core, cpuinfo_get_processor(victims[0])->core);
+	}
+}
+
+TEST(SYNTHETIC, max_processors) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = CPUINFO_MOCK_PACKAGES_MAX;
+	topology.nodes_per_package = 1;
+	topology.clusters_count = 1;
+	topology.clusters[0].cores = CPUINFO_MOCK_PROCESSORS_MAX / CPUINFO_MOCK_PACKAGES_MAX / 2;
+	topology.clusters[0].threads_per_core = 2;
+	topology.clusters[0].max_frequency = 3500000;
+	topology.clusters[0].midr = UINT32_C(0x410FD0C1);
+	SyntheticSystem system(topology);
+
+	ASSERT_EQ(CPUINFO_MOCK_PROCESSORS_MAX, cpuinfo_get_processors_count());
+	ASSERT_EQ(CPUINFO_MOCK_PROCESSORS_MAX / 2, cpuinfo_get_cores_count());
+	ASSERT_EQ(CPUINFO_MOCK_PACKAGES_MAX, cpuinfo_get_packages_count());
+}
+
+/* File operations which forward to the mock filesystem, and record the path of the last file opened for writing */
+static int recording_open(void* context, const char* path, int flags) {
+	if ((flags & O_ACCMODE) != O_RDONLY) {
+		*static_cast<std::string*>(context) = path;
+	}
+	return cpuinfo_mock_open(path, flags);
+}
+
+static ptrdiff_t recording_read(void* context, int file, void* buffer, size_t size) {
+	return cpuinfo_mock_read(file, buffer, size);
+}
+
+static void recording_close(void* context, int file) {
+	cpuinfo_mock_close(file);
+}
+
+TEST(SYNTHETIC, energy_performance_preference_path) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = 1;
+	topology.nodes_per_package = 1;
+	topology.clusters_count = 1;
+	topology.clusters[0].cores = 12;
+	topology.clusters[0].threads_per_core = 1;
+	topology.clusters[0].max_frequency = 3000000;
+	topology.clusters[0].midr = UINT32_C(0x410FD0C1);
+	std::string written_path;
+	const cpuinfo_file_ops file_ops = { recording_open, recording_read, recording_close, &written_path };
+	ASSERT_TRUE(cpuinfo_set_file_ops(&file_ops));
+	{
+		SyntheticSystem system(topology);
+		ASSERT_NE(0, cpuinfo_get_frequency_domains_count());
+		const cpuinfo_frequency_domain* domain = cpuinfo_get_frequency_domain(0);
+		ASSERT_EQ(cpuinfo_energy_performance_preference_balance_performance, domain->energy_performance_preference);
+		const cpuinfo_processor* processor = cpuinfo_get_processor(domain->processor_start);
+
+		/* The mock filesystem is read-only, so the preference is not set, but the file is opened by its full path */
+		EXPECT_FALSE(cpuinfo_set_energy_performance_preference(domain, cpuinfo_energy_performance_preference_power));
+		EXPECT_EQ("/sys/devices/system/cpu/cpu" + std::to_string(processor->linux_id) +
+			"/cpufreq/energy_performance_preference", written_path);
+	}
+	EXPECT_TRUE(cpuinfo_set_file_ops(nullptr));
+}
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+TEST(SYNTHETIC, hybrid) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = 1;
+	topology.nodes_per_package = 1;
+	topology.clusters_count = 2;
+	topology.clusters[0].cores = 8;
+	topology.clusters[0].threads_per_core = 2;
+	topology.clusters[0].max_frequency = 5200000;
+	topology.clusters[1].cores = 16;
+	topology.clusters[1].threads_per_core = 1;
+	topology.clusters[1].max_frequency = 3900000;
+	topology.clusters[1].efficiency = true;
+	SyntheticSystem system(topology);
+
+	ASSERT_EQ(32, cpuinfo_get_processors_count());
+	ASSERT_EQ(24, cpuinfo_get_cores_count());
+	ASSERT_EQ(2, cpuinfo_get_uarchs_count());
+}
+#endif
+
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+TEST(SYNTHETIC, tri_cluster) {
+	cpuinfo_mock_topology topology = { };
+	topology.packages = 1;
+	topology.nodes_per_package = 1;
+	topology.clusters_count = 3;
+	topology.clusters[0] = { 1, 1, 3000000, UINT32_C(0x411FD441), false };
+	topology.clusters[1] = { 3, 1, 2400000, UINT32_C(0x411FD411), false };
+	topology.clusters[2] = { 4, 1, 1800000, UINT32_C(0x412FD050), false };
+	SyntheticSystem system(topology);
+
+	ASSERT_EQ(8, cpuinfo_get_processors_count());
+	ASSERT_EQ(3, cpuinfo_get_clusters_count());
+	ASSERT_EQ(3, cpuinfo_get_uarchs_count());
+	ASSERT_EQ(1, cpuinfo_get_packages_count());
+}
+#endif
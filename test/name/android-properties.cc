@@ -5,6 +5,8 @@
 
 #include <string>
 
+#include <cpuinfo.h>
+
 #define CPUINFO_HARDWARE_VALUE_MAX 64
 #define CPUINFO_BUILD_PROP_VALUE_MAX 92
 #define CPUINFO_ARM_CHIPSET_NAME_MAX 48
@@ -145,3 +147,20 @@ TEST(ANDROID_PROPERTIES, unambiguous_chipset) {
 	EXPECT_EQ("MediaTek MT6737T",
 		parse_chipset("Samsung GrandPrimePlus LTE CIS rev04 board based on MT6737T", "MT6737T", "mt6737t", "MT6737T", "", "MT6737T"));
 }
+
+TEST(ANDROID_PROPERTIES, registered_chipset) {
+	const std::string table =
+		"sun Qualcomm Snapdragon 8750\n"
+		"mt6797 MediaTek MT6797X\n";
+	ASSERT_TRUE(cpuinfo_register_chipset_table(table.data(), table.size()));
+	EXPECT_EQ("Qualcomm Snapdragon 8750",
+		parse_chipset("", "", "sun", "", "", ""));
+	EXPECT_EQ("Qualcomm Snapdragon 8750",
+		parse_chipset("Qualcomm Technologies, Inc SUN", "", "", "", "", ""));
+	/* Registered chipsets take priority over the built-in signatures */
+	EXPECT_EQ("MediaTek MT6797X",
+		parse_chipset("MT6797", "", "mt6797", "", "", ""));
+	const std::string unknown_series = "sun Qualcomm XYZ8750\n";
+	EXPECT_FALSE(cpuinfo_register_chipset_table(unknown_series.data(), unknown_series.size()));
+	EXPECT_TRUE(cpuinfo_register_chipset_table(nullptr, 0));
+}
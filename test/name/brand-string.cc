@@ -7,6 +7,7 @@
 
 extern "C" uint32_t cpuinfo_x86_normalize_brand_string(
 	const char* raw_name, char* normalized_name);
+extern "C" uint64_t cpuinfo_x86_parse_brand_string_frequency(const char* raw_name);
 
 
 inline std::string normalize_brand_string(const char name[48]) {
@@ -592,3 +593,18 @@ TEST(BRAND_STRING, other) {
 	EXPECT_EQ("WinChip 2-3D",
 		normalize_brand_string("IDT WinChip 2-3D\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"));
 }
+
+TEST(BRAND_STRING, frequency) {
+	EXPECT_EQ(UINT64_C(3200000000),
+		cpuinfo_x86_parse_brand_string_frequency("Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz\0\0\0\0\0\0\0\0\0"));
+	EXPECT_EQ(UINT64_C(2330000000),
+		cpuinfo_x86_parse_brand_string_frequency("Genuine Intel(R) CPU                  @ 2.33GHz\0"));
+	EXPECT_EQ(UINT64_C(3000000000),
+		cpuinfo_x86_parse_brand_string_frequency("                   Genuine Intel(R) CPU 3.00GHz\0"));
+	EXPECT_EQ(UINT64_C(800000000),
+		cpuinfo_x86_parse_brand_string_frequency("Genuine Intel(R) processor               800MHz\0"));
+	EXPECT_EQ(UINT64_C(0),
+		cpuinfo_x86_parse_brand_string_frequency("AMD Ryzen 9 5950X 16-Core Processor            \0"));
+	EXPECT_EQ(UINT64_C(0),
+		cpuinfo_x86_parse_brand_string_frequency("Quad-Core Processor (up to 1.4GHz)             \0"));
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cpuinfo.h>
+#include <cpuinfo-threadpool.h>
+
+
+static void count_items(void* context, size_t start, size_t end) {
+	std::vector<std::atomic<uint32_t>>& counts = *static_cast<std::vector<std::atomic<uint32_t>>*>(context);
+	for (size_t i = start; i < end; i++) {
+		counts[i].fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+TEST(THREADPOOL, default_threads_count) {
+	struct cpuinfo_threadpool* threadpool = cpuinfo_threadpool_create(0, cpuinfo_worker_policy_compact);
+	ASSERT_TRUE(threadpool);
+	EXPECT_NE(0, cpuinfo_threadpool_get_threads_count(threadpool));
+	EXPECT_LE(cpuinfo_threadpool_get_threads_count(threadpool), cpuinfo_get_processors_count());
+	EXPECT_NE(0, cpuinfo_threadpool_get_queues_count(threadpool));
+	EXPECT_LE(cpuinfo_threadpool_get_queues_count(threadpool), cpuinfo_get_llc_domains_count());
+	cpuinfo_threadpool_destroy(threadpool);
+}
+
+TEST(THREADPOOL, chunk_size) {
+	struct cpuinfo_threadpool* threadpool = cpuinfo_threadpool_create(4, cpuinfo_worker_policy_scatter_llc);
+	ASSERT_TRUE(threadpool);
+	EXPECT_EQ(0, cpuinfo_threadpool_get_chunk_size(threadpool, 0, 0));
+	EXPECT_EQ(1, cpuinfo_threadpool_get_chunk_size(threadpool, 1, 64));
+	for (size_t item_size : {0, 1, 64, 4096, 1 << 20}) {
+		const size_t range = 1000000;
+		const size_t chunk_size = cpuinfo_threadpool_get_chunk_size(threadpool, range, item_size);
+		EXPECT_GE(chunk_size, 1);
+		/* Every worker gets a chunk */
+		EXPECT_LE(chunk_size, range / 4);
+	}
+	cpuinfo_threadpool_destroy(threadpool);
+}
+
+TEST(THREADPOOL, parallel_for_covers_range) {
+	struct cpuinfo_threadpool* threadpool = cpuinfo_threadpool_create(4, cpuinfo_worker_policy_compact);
+	ASSERT_TRUE(threadpool);
+	for (size_t range : {1, 3, 4, 1000, 123457}) {
+		for (size_t item_size : {0, 8, 256}) {
+			std::vector<std::atomic<uint32_t>> counts(range);
+			cpuinfo_threadpool_parallel_for(threadpool, count_items, &counts, range, item_size);
+			for (size_t i = 0; i < range; i++) {
+				ASSERT_EQ(1, counts[i].load()) << "item " << i << " of " << range;
+			}
+		}
+	}
+	cpuinfo_threadpool_destroy(threadpool);
+}
@@ -55,6 +55,20 @@ void report_cache(
 	}
 }
 
+/* Caches of a level may differ in size, e.g. L3 caches of AMD core complexes with and without 3D V-Cache */
+static void report_caches(
+	uint32_t count, const struct cpuinfo_cache* caches,
+	uint32_t level, const char* nonunified_type)
+{
+	for (uint32_t start = 0, end = 0; start < count; start = end) {
+		end = start + 1;
+		while (end < count && caches[end].size == caches[start].size) {
+			end++;
+		}
+		report_cache(end - start, &caches[start], level, nonunified_type);
+	}
+}
+
 int main(int argc, char** argv) {
 	if (!cpuinfo_initialize()) {
 		fprintf(stderr, "failed to initialize CPU information\n");
@@ -69,12 +83,26 @@ int main(int argc, char** argv) {
 		report_cache(cpuinfo_get_l1d_caches_count(), cpuinfo_get_l1d_cache(0), 1, "data");
 	}
 	if (cpuinfo_get_l2_caches_count() != 0) {
-		report_cache(cpuinfo_get_l2_caches_count(), cpuinfo_get_l2_cache(0), 2, "data");
+		report_caches(cpuinfo_get_l2_caches_count(), cpuinfo_get_l2_caches(), 2, "data");
 	}
 	if (cpuinfo_get_l3_caches_count() != 0) {
-		report_cache(cpuinfo_get_l3_caches_count(), cpuinfo_get_l3_cache(0), 3, "data");
+		report_caches(cpuinfo_get_l3_caches_count(), cpuinfo_get_l3_caches(), 3, "data");
 	}
 	if (cpuinfo_get_l4_caches_count() != 0) {
-		report_cache(cpuinfo_get_l4_caches_count(), cpuinfo_get_l4_cache(0), 4, "data");
+		report_caches(cpuinfo_get_l4_caches_count(), cpuinfo_get_l4_caches(), 4, "data");
+	}
+
+	struct cpuinfo_prefetchers prefetchers;
+	cpuinfo_get_prefetchers(&prefetchers);
+	if (prefetchers.source != cpuinfo_prefetchers_source_unknown) {
+		printf("Hardware prefetchers (%s):",
+			prefetchers.source == cpuinfo_prefetchers_source_msr ? "from MSRs" : "defaults");
+		printf("%s%s%s%s%s%s\n",
+			prefetchers.l1d_stream ? " L1D-stream" : "",
+			prefetchers.l1d_stride ? " L1D-stride" : "",
+			prefetchers.l1d_region ? " L1D-region" : "",
+			prefetchers.l2_stream ? " L2-stream" : "",
+			prefetchers.l2_adjacent_line ? " L2-adjacent-line" : "",
+			prefetchers.l2_up_down ? " L2-up-down" : "");
 	}
 }
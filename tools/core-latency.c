@@ -0,0 +1,47 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+
+int main(int argc, char** argv) {
+	/* Measurements are restored from the snapshot file if it exists, and saved into it otherwise */
+	const char* snapshot_path = argc > 1 ? argv[1] : NULL;
+	if (snapshot_path == NULL || !cpuinfo_initialize_from_snapshot(snapshot_path)) {
+		if (!cpuinfo_initialize()) {
+			fprintf(stderr, "failed to initialize CPU information\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	const bool restored = cpuinfo_get_core_latencies() != NULL;
+	if (!cpuinfo_probe_core_latencies()) {
+		fprintf(stderr, "failed to measure latencies between cores\n");
+		exit(EXIT_FAILURE);
+	}
+	if (snapshot_path != NULL && !restored && !cpuinfo_save_snapshot(snapshot_path)) {
+		fprintf(stderr, "failed to save measurements into snapshot file %s\n", snapshot_path);
+	}
+
+	/* Latencies in nanoseconds, with the core in the row writing and the core in the column reading */
+	const uint32_t cores_count = cpuinfo_get_cores_count();
+	const uint32_t* latencies = cpuinfo_get_core_latencies();
+	printf("Core");
+	for (uint32_t j = 0; j < cores_count; j++) {
+		printf("\t%"PRIu32, j);
+	}
+	printf("\n");
+	for (uint32_t i = 0; i < cores_count; i++) {
+		printf("%"PRIu32, i);
+		for (uint32_t j = 0; j < cores_count; j++) {
+			const uint32_t latency = latencies[i * cores_count + j];
+			if (latency != 0) {
+				printf("\t%"PRIu32".%01"PRIu32, latency / 1000, latency % 1000 / 100);
+			} else {
+				printf("\t-");
+			}
+		}
+		printf("\n");
+	}
+}
@@ -42,6 +42,97 @@ static const char* vendor_to_string(enum cpuinfo_vendor vendor) {
 			return "Broadcom";
 		case cpuinfo_vendor_apm:
 			return "Applied Micro";
+		case cpuinfo_vendor_sifive:
+			return "SiFive";
+		case cpuinfo_vendor_thead:
+			return "T-Head";
+		case cpuinfo_vendor_loongson:
+			return "Loongson";
+		default:
+			return NULL;
+	}
+}
+
+static const char* hypervisor_to_string(enum cpuinfo_hypervisor hypervisor) {
+	switch (hypervisor) {
+		case cpuinfo_hypervisor_none:
+			return "none";
+		case cpuinfo_hypervisor_unknown:
+			return "unknown";
+		case cpuinfo_hypervisor_kvm:
+			return "KVM";
+		case cpuinfo_hypervisor_hyperv:
+			return "Hyper-V";
+		case cpuinfo_hypervisor_vmware:
+			return "VMware";
+		case cpuinfo_hypervisor_xen:
+			return "Xen";
+		case cpuinfo_hypervisor_qemu:
+			return "QEMU";
+		case cpuinfo_hypervisor_virtualbox:
+			return "VirtualBox";
+		case cpuinfo_hypervisor_parallels:
+			return "Parallels";
+		case cpuinfo_hypervisor_acrn:
+			return "ACRN";
+		case cpuinfo_hypervisor_bhyve:
+			return "bhyve";
+		case cpuinfo_hypervisor_nitro:
+			return "AWS Nitro";
+		default:
+			return NULL;
+	}
+}
+
+static const char* vulnerability_to_string(enum cpuinfo_vulnerability vulnerability) {
+	switch (vulnerability) {
+		case cpuinfo_vulnerability_spectre_v1:
+			return "spectre_v1";
+		case cpuinfo_vulnerability_spectre_v2:
+			return "spectre_v2";
+		case cpuinfo_vulnerability_meltdown:
+			return "meltdown";
+		case cpuinfo_vulnerability_spec_store_bypass:
+			return "spec_store_bypass";
+		case cpuinfo_vulnerability_l1tf:
+			return "l1tf";
+		case cpuinfo_vulnerability_mds:
+			return "mds";
+		case cpuinfo_vulnerability_tsx_async_abort:
+			return "tsx_async_abort";
+		case cpuinfo_vulnerability_itlb_multihit:
+			return "itlb_multihit";
+		case cpuinfo_vulnerability_srbds:
+			return "srbds";
+		case cpuinfo_vulnerability_mmio_stale_data:
+			return "mmio_stale_data";
+		case cpuinfo_vulnerability_retbleed:
+			return "retbleed";
+		case cpuinfo_vulnerability_gather_data_sampling:
+			return "gather_data_sampling";
+		case cpuinfo_vulnerability_spec_rstack_overflow:
+			return "spec_rstack_overflow";
+		case cpuinfo_vulnerability_reg_file_data_sampling:
+			return "reg_file_data_sampling";
+		default:
+			return NULL;
+	}
+}
+
+static const char* energy_performance_preference_to_string(enum cpuinfo_energy_performance_preference preference) {
+	switch (preference) {
+		case cpuinfo_energy_performance_preference_default:
+			return "default";
+		case cpuinfo_energy_performance_preference_performance:
+			return "performance";
+		case cpuinfo_energy_performance_preference_balance_performance:
+			return "balance_performance";
+		case cpuinfo_energy_performance_preference_balance_power:
+			return "balance_power";
+		case cpuinfo_energy_performance_preference_power:
+			return "power";
+		case cpuinfo_energy_performance_preference_custom:
+			return "custom";
 		default:
 			return NULL;
 	}
@@ -81,6 +172,12 @@ static const char* uarch_to_string(enum cpuinfo_uarch uarch) {
 			return "Palm Cove";
 		case cpuinfo_uarch_sunny_cove:
 			return "Sunny Cove";
+		case cpuinfo_uarch_golden_cove:
+			return "Golden Cove";
+		case cpuinfo_uarch_redwood_cove:
+			return "Redwood Cove";
+		case cpuinfo_uarch_lion_cove:
+			return "Lion Cove";
 		case cpuinfo_uarch_willamette:
 			return "Willamette";
 		case cpuinfo_uarch_prescott:
@@ -97,6 +194,14 @@ static const char* uarch_to_string(enum cpuinfo_uarch uarch) {
 			return "Goldmont";
 		case cpuinfo_uarch_goldmont_plus:
 			return "Goldmont Plus";
+		case cpuinfo_uarch_tremont:
+			return "Tremont";
+		case cpuinfo_uarch_gracemont:
+			return "Gracemont";
+		case cpuinfo_uarch_crestmont:
+			return "Crestmont";
+		case cpuinfo_uarch_skymont:
+			return "Skymont";
 		case cpuinfo_uarch_knights_ferry:
 			return "Knights Ferry";
 		case cpuinfo_uarch_knights_corner:
@@ -191,6 +296,8 @@ static const char* uarch_to_string(enum cpuinfo_uarch uarch) {
 			return "Cortex-A78";
 		case cpuinfo_uarch_cortex_a510:
 			return "Cortex-A510";
+		case cpuinfo_uarch_cortex_a520:
+			return "Cortex-A520";
 		case cpuinfo_uarch_cortex_a710:
 			return "Cortex-A710";
 		case cpuinfo_uarch_cortex_a715:
@@ -279,6 +386,28 @@ static const char* uarch_to_string(enum cpuinfo_uarch uarch) {
 			return "Dhyana";
 		case cpuinfo_uarch_taishan_v110:
 			return "TaiShan v110";
+		case cpuinfo_uarch_sifive_u54:
+			return "U54";
+		case cpuinfo_uarch_sifive_u74:
+			return "U74";
+		case cpuinfo_uarch_sifive_p550:
+			return "P550";
+		case cpuinfo_uarch_sifive_x280:
+			return "X280";
+		case cpuinfo_uarch_thead_c906:
+			return "C906";
+		case cpuinfo_uarch_thead_c910:
+			return "C910";
+		case cpuinfo_uarch_thead_c920:
+			return "C920";
+		case cpuinfo_uarch_loongson_la264:
+			return "LA264";
+		case cpuinfo_uarch_loongson_la364:
+			return "LA364";
+		case cpuinfo_uarch_loongson_la464:
+			return "LA464";
+		case cpuinfo_uarch_loongson_la664:
+			return "LA664";
 		default:
 			return NULL;
 	}
@@ -297,6 +426,14 @@ int main(int argc, char** argv) {
 			printf("\t%"PRIu32": %s\n", i, cpuinfo_get_package(i)->name);
 		}
 	#endif
+	const struct cpuinfo_integrated_gpu* integrated_gpu = cpuinfo_get_integrated_gpu();
+	if (integrated_gpu != NULL) {
+		printf("Integrated GPU: %s\n", integrated_gpu->name);
+	}
+	const struct cpuinfo_npu* npu = cpuinfo_get_npu();
+	if (npu != NULL) {
+		printf("NPU: %s\n", npu->name);
+	}
 	printf("Microarchitectures:\n");
 	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
 		const struct cpuinfo_uarch_info* uarch_info = cpuinfo_get_uarch(i);
@@ -307,6 +444,15 @@ int main(int argc, char** argv) {
 		} else {
 			printf("\t%"PRIu32"x %s\n", uarch_info->core_count, uarch_string);
 		}
+		const struct cpuinfo_uarch_cost_model* cost_model = cpuinfo_get_uarch_cost_model(uarch_info->uarch);
+		if (cost_model != NULL) {
+			printf("\t\tdecode %"PRIu32", issue %"PRIu32", %"PRIu32" FMA (latency %"PRIu32"), "
+				"%"PRIu32"x%"PRIu32"-bit vector pipes, %"PRIu32" loads, %"PRIu32" stores, "
+				"ROB %"PRIu32", L1D latency %"PRIu32"\n",
+				cost_model->decode_width, cost_model->issue_width, cost_model->fma_units, cost_model->fma_latency,
+				cost_model->vector_pipes, cost_model->vector_pipe_width, cost_model->load_ports,
+				cost_model->store_ports, cost_model->rob_size, cost_model->l1d_latency);
+		}
 	}
 	printf("Cores:\n");
 	for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
@@ -320,17 +466,148 @@ int main(int argc, char** argv) {
 		const char* vendor_string = vendor_to_string(core->vendor);
 		const char* uarch_string = uarch_to_string(core->uarch);
 		if (vendor_string == NULL) {
-			printf(", vendor 0x%08"PRIx32" uarch 0x%08"PRIx32"\n",
+			printf(", vendor 0x%08"PRIx32" uarch 0x%08"PRIx32,
 				(uint32_t) core->vendor, (uint32_t) core->uarch);
 		}
 		else if (uarch_string == NULL) {
-			printf(", %s uarch 0x%08"PRIx32"\n",
+			printf(", %s uarch 0x%08"PRIx32,
 				vendor_string, (uint32_t) core->uarch);
 		}
 		else {
-			printf(", %s %s\n", vendor_string, uarch_string);
+			printf(", %s %s", vendor_string, uarch_string);
+		}
+		if (core->frequency != 0) {
+			printf(", %"PRIu64" MHz", core->frequency / UINT64_C(1000000));
+		}
+		if (core->max_turbo_frequency != 0) {
+			printf(" (turbo %"PRIu64" MHz)", core->max_turbo_frequency / UINT64_C(1000000));
+		}
+		if (core->performance != 0) {
+			printf(", performance %"PRIu32" (rank %"PRIu32")", core->performance, core->performance_rank);
+		}
+		if (core->capacity != CPUINFO_CAPACITY_SCALE) {
+			printf(", capacity %"PRIu32"/%d", core->capacity, CPUINFO_CAPACITY_SCALE);
+		}
+		uint32_t vector_core_start, vector_core_count;
+		if (cpuinfo_get_core_vector_unit_group(core, &vector_core_start, &vector_core_count) && vector_core_count > 1) {
+			printf(", vector units shared by cores %"PRIu32"-%"PRIu32,
+				vector_core_start, vector_core_start + vector_core_count - 1);
+		}
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+		if (core->microcode_revision != 0) {
+			printf(", microcode 0x%"PRIx32, core->microcode_revision);
+		}
+#endif
+		printf("\n");
+	}
+	printf("NUMA nodes:\n");
+	for (uint32_t i = 0; i < cpuinfo_get_numa_nodes_count(); i++) {
+		const struct cpuinfo_numa_node* node = cpuinfo_get_numa_node(i);
+		printf("\t%"PRIu32": node %"PRIu32, i, node->node_id);
+		if (node->processor_count != 0) {
+			printf(", processors %"PRIu32"-%"PRIu32,
+				node->processor_start, node->processor_start + node->processor_count - 1);
+		}
+		if (node->memory_size != 0) {
+			printf(", %"PRIu64" MB", node->memory_size >> 20);
+		}
+		printf(", distances");
+		for (uint32_t j = 0; j < cpuinfo_get_numa_nodes_count(); j++) {
+			printf(" %"PRIu32, node->distances[j]);
+		}
+		printf("\n");
+	}
+	printf("Frequency domains:\n");
+	for (uint32_t i = 0; i < cpuinfo_get_frequency_domains_count(); i++) {
+		const struct cpuinfo_frequency_domain* domain = cpuinfo_get_frequency_domain(i);
+		printf("\t%"PRIu32":", i);
+		if (domain->domain_id != UINT32_MAX) {
+			printf(" policy %"PRIu32",", domain->domain_id);
+		}
+		printf(" processors %"PRIu32"-%"PRIu32,
+			domain->processor_start, domain->processor_start + domain->processor_count - 1);
+		if (domain->max_frequency != 0) {
+			printf(", %"PRIu64"-%"PRIu64" MHz",
+				domain->min_frequency / UINT64_C(1000000), domain->max_frequency / UINT64_C(1000000));
+		}
+		if (domain->frequencies_count != 0) {
+			printf(", %"PRIu32" frequencies", domain->frequencies_count);
+		}
+		if (domain->governor[0] != '\0') {
+			printf(", %s governor", domain->governor);
+		}
+		if (domain->boost) {
+			printf(", boost");
+		}
+		if (domain->driver[0] != '\0') {
+			printf(", %s driver", domain->driver);
+		}
+		const char* preference = energy_performance_preference_to_string(domain->energy_performance_preference);
+		if (preference != NULL) {
+			printf(", %s EPP", preference);
+		}
+		printf("\n");
+	}
+	if (cpuinfo_get_uncore_domains_count() != 0) {
+		printf("Uncore domains:\n");
+		for (uint32_t i = 0; i < cpuinfo_get_uncore_domains_count(); i++) {
+			const struct cpuinfo_uncore_domain* domain = cpuinfo_get_uncore_domain(i);
+			printf("\t%"PRIu32": package %"PRIu32" die %"PRIu32, i, domain->package_id, domain->die_id);
+			printf(", %"PRIu64"-%"PRIu64" MHz, limits %"PRIu64"-%"PRIu64" MHz\n",
+				domain->min_frequency / UINT64_C(1000000), domain->max_frequency / UINT64_C(1000000),
+				domain->limit_min_frequency / UINT64_C(1000000), domain->limit_max_frequency / UINT64_C(1000000));
 		}
 	}
+	printf("Peak throughput:\n");
+	for (uint32_t i = 0; i < cpuinfo_get_clusters_count(); i++) {
+		struct cpuinfo_peak_throughput throughput;
+		if (cpuinfo_get_cluster_peak_throughput(cpuinfo_get_cluster(i), &throughput)) {
+			printf("\tcluster %"PRIu32": %"PRIu32" FP32, %"PRIu32" FP16, %"PRIu32" INT8 ops/cycle, "
+				"%"PRIu64" FP32 GFLOPS\n", i, throughput.fp32_ops_per_cycle, throughput.fp16_ops_per_cycle,
+				throughput.int8_ops_per_cycle, throughput.fp32_ops_per_second / UINT64_C(1000000000));
+		}
+	}
+	printf("Performance monitoring:\n");
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		struct cpuinfo_pmu_info pmu;
+		if (cpuinfo_get_uarch_pmu_info(i, &pmu)) {
+			printf("\tuarch %"PRIu32": %"PRIu32" general-purpose, %"PRIu32" fixed counters, events 0x%02"PRIx32", "
+				"perf_event %s\n", i, pmu.general_counters, pmu.fixed_counters, pmu.architectural_events,
+				pmu.perf_event_allowed ? "allowed" : "not allowed");
+		}
+	}
+	printf("Trace facilities:\n");
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		struct cpuinfo_trace_info trace;
+		if (cpuinfo_get_uarch_trace_info(i, &trace)) {
+			printf("\tuarch %"PRIu32": facilities 0x%02"PRIx32", %"PRIu32" branch records, Intel PT 0x%05"PRIx32"\n",
+				i, trace.facilities, trace.branch_records, trace.intel_pt_capabilities);
+		}
+	}
+	printf("Vulnerabilities:\n");
+	for (uint32_t i = 0; i < cpuinfo_vulnerability_max; i++) {
+		struct cpuinfo_vulnerability_state state;
+		if (cpuinfo_get_vulnerability_state((enum cpuinfo_vulnerability) i, &state)) {
+			printf("\t%s: %s\n", vulnerability_to_string((enum cpuinfo_vulnerability) i), state.description);
+		}
+	}
+	printf("Hypervisor: %s%s\n", hypervisor_to_string(cpuinfo_get_hypervisor()),
+		cpuinfo_is_topology_synthetic() ? " (synthetic topology)" : "");
+	printf("Timestamp counter: ");
+	if (cpuinfo_get_tsc_frequency() != 0) {
+		printf("%"PRIu64" Hz", cpuinfo_get_tsc_frequency());
+	} else {
+		printf("unknown frequency");
+	}
+	printf("%s\n", cpuinfo_has_invariant_tsc() ? ", invariant" : "");
+	static const char* timestamp_sources[] = {
+		[cpuinfo_timestamp_source_os_clock] = "OS clock",
+		[cpuinfo_timestamp_source_x86_rdtsc] = "RDTSC",
+		[cpuinfo_timestamp_source_x86_rdtscp] = "RDTSC and RDTSCP",
+		[cpuinfo_timestamp_source_arm64_cntvct] = "CNTVCT_EL0",
+	};
+	printf("Timestamps: %s, %"PRIu64" Hz\n", timestamp_sources[cpuinfo_get_timestamp_source()],
+		cpuinfo_get_timestamp_frequency());
 	printf("Logical processors");
 	#if defined(__linux__)
 		printf(" (System ID)");
@@ -345,9 +622,14 @@ int main(int argc, char** argv) {
 		#endif
 
 		#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
-			printf(": APIC ID 0x%08"PRIx32"\n", processor->apic_id);
-		#else
-			printf("\n");
+			printf(": APIC ID 0x%08"PRIx32, processor->apic_id);
 		#endif
+		if (processor->isolated) {
+			printf(", isolated");
+		}
+		if (processor->nohz_full) {
+			printf(", nohz_full");
+		}
+		printf("\n");
 	}
 }
@@ -3,6 +3,8 @@
 #include <inttypes.h>
 #include <string.h>
 
+/* Dump raw CPUID values, without the table of recorded leaves in the cpuinfo library */
+#define CPUINFO_X86_CPUID_UNCACHED 1
 #include <x86/cpuid.h>
 
 static void print_cpuid(struct cpuid_regs regs, uint32_t eax) {
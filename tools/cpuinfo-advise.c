@@ -0,0 +1,162 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+
+enum advise_policy {
+	advise_policy_physical_cores,
+	advise_policy_llc,
+	advise_policy_big_cores,
+};
+
+enum advise_format {
+	/* Shell assignments of OpenMP variables, for eval in launch scripts */
+	advise_format_env,
+	/* Linux CPU list for taskset -c, cgroup cpusets, and thread pools which take an affinity mask, e.g. TBB */
+	advise_format_cpulist,
+};
+
+/* ID of the logical processor in the numbering of the OS, as used by affinity settings */
+static uint32_t os_processor_id(const struct cpuinfo_processor* processor) {
+#if defined(__linux__)
+	return (uint32_t) processor->linux_id;
+#else
+	return (uint32_t) (processor - cpuinfo_get_processors());
+#endif
+}
+
+static int cmp_uint32(const void* ptr_a, const void* ptr_b) {
+	const uint32_t a = *((const uint32_t*) ptr_a);
+	const uint32_t b = *((const uint32_t*) ptr_b);
+	return (a > b) - (a < b);
+}
+
+/* Logical processors for the policy, one worker per processor, in the order of workers */
+static uint32_t plan(enum advise_policy policy, const struct cpuinfo_processor** processors) {
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	switch (policy) {
+		case advise_policy_physical_cores:
+			return cpuinfo_plan_workers(cpuinfo_get_cores_count(), cpuinfo_worker_policy_physical_cores, processors);
+		case advise_policy_llc:
+			/* Scatter across LLC domains places the first worker of every domain on a physical core */
+			return cpuinfo_plan_workers(cpuinfo_get_llc_domains_count(), cpuinfo_worker_policy_scatter_llc, processors);
+		case advise_policy_big_cores:
+		{
+			/* Processors on cores of the same microarchitecture and frequency as the first one are the big cores */
+			const uint32_t count =
+				cpuinfo_plan_workers(processors_count, cpuinfo_worker_policy_big_cores_first, processors);
+			uint32_t big_count = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				if (processors[i]->core->uarch == processors[0]->core->uarch &&
+					processors[i]->core->frequency == processors[0]->core->frequency)
+				{
+					processors[big_count++] = processors[i];
+				}
+			}
+			return big_count;
+		}
+	}
+	return 0;
+}
+
+static void print_cpulist(const uint32_t* ids, uint32_t count) {
+	for (uint32_t i = 0; i < count;) {
+		uint32_t end = i + 1;
+		while (end < count && ids[end] == ids[end - 1] + 1) {
+			end++;
+		}
+		printf("%s%"PRIu32, i != 0 ? "," : "", ids[i]);
+		if (end - i > 1) {
+			printf("-%"PRIu32, ids[end - 1]);
+		}
+		i = end;
+	}
+}
+
+static void print_list(const uint32_t* ids, uint32_t count, const char* prefix, const char* separator,
+	const char* suffix)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		printf("%s%s%"PRIu32"%s", i != 0 ? separator : "", prefix, ids[i], suffix);
+	}
+}
+
+static void print_usage(const char* program) {
+	fprintf(stderr, "usage: %s --policy=physical-cores|llc|big-cores [--format=env|cpulist]\n", program);
+}
+
+int main(int argc, char** argv) {
+	enum advise_policy policy = advise_policy_physical_cores;
+	enum advise_format format = advise_format_env;
+	bool has_policy = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--policy=physical-cores") == 0) {
+			policy = advise_policy_physical_cores;
+			has_policy = true;
+		} else if (strcmp(argv[i], "--policy=llc") == 0) {
+			policy = advise_policy_llc;
+			has_policy = true;
+		} else if (strcmp(argv[i], "--policy=big-cores") == 0) {
+			policy = advise_policy_big_cores;
+			has_policy = true;
+		} else if (strcmp(argv[i], "--format=env") == 0) {
+			format = advise_format_env;
+		} else if (strcmp(argv[i], "--format=cpulist") == 0) {
+			format = advise_format_cpulist;
+		} else {
+			print_usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (!has_policy) {
+		print_usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	if (!cpuinfo_initialize()) {
+		fprintf(stderr, "failed to initialize CPU information\n");
+		exit(EXIT_FAILURE);
+	}
+
+	const uint32_t processors_count = cpuinfo_get_processors_count();
+	const struct cpuinfo_processor** processors = calloc(processors_count, sizeof(const struct cpuinfo_processor*));
+	uint32_t* ids = calloc(processors_count, sizeof(uint32_t));
+	if (processors == NULL || ids == NULL) {
+		fprintf(stderr, "failed to allocate memory for %"PRIu32" processors\n", processors_count);
+		exit(EXIT_FAILURE);
+	}
+	/* The plan includes only processors usable by the process, e.g. within the cpuset of its cgroup */
+	const uint32_t count = plan(policy, processors);
+	if (count == 0) {
+		fprintf(stderr, "no usable processors for the policy\n");
+		exit(EXIT_FAILURE);
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		ids[i] = os_processor_id(processors[i]);
+	}
+
+	switch (format) {
+		case advise_format_env:
+			/* Every worker gets its own place, in the order of the plan */
+			printf("OMP_NUM_THREADS=%"PRIu32"\n", count);
+			printf("OMP_PLACES=\"");
+			print_list(ids, count, "{", ",", "}");
+			printf("\"\nOMP_PROC_BIND=close\nGOMP_CPU_AFFINITY=\"");
+			print_list(ids, count, "", " ", "");
+			printf("\"\nKMP_AFFINITY=\"granularity=fine,explicit,proclist=[");
+			print_list(ids, count, "", ",", "");
+			printf("]\"\n");
+			break;
+		case advise_format_cpulist:
+			qsort(ids, count, sizeof(uint32_t), cmp_uint32);
+			print_cpulist(ids, count);
+			printf("\n");
+			break;
+	}
+	free(processors);
+	free(ids);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+
+static void report_instruction(const char* name, struct cpuinfo_instruction_timing timing, uint32_t expected_latency) {
+	if (timing.latency == 0) {
+		return;
+	}
+	printf("\t%s: latency %"PRIu32".%02"PRIu32" cycles, throughput %"PRIu32".%02"PRIu32" per cycle",
+		name, timing.latency / 100, timing.latency % 100, timing.throughput / 100, timing.throughput % 100);
+	if (expected_latency != 0) {
+		printf(" (cost model: latency %"PRIu32" cycles)", expected_latency);
+	}
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+	/* Measurements are taken from the tuning cache in the directory if it is given */
+	if (!cpuinfo_initialize()) {
+		fprintf(stderr, "failed to initialize CPU information\n");
+		exit(EXIT_FAILURE);
+	}
+	if (argc > 1 && !cpuinfo_set_tuning_cache_directory(argv[1])) {
+		fprintf(stderr, "unsupported tuning cache directory %s\n", argv[1]);
+		exit(EXIT_FAILURE);
+	}
+	if (!cpuinfo_probe_instruction_performance()) {
+		fprintf(stderr, "failed to measure instruction performance\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		const struct cpuinfo_uarch_info* uarch_info = cpuinfo_get_uarch(i);
+		const struct cpuinfo_instruction_performance* performance = cpuinfo_get_uarch_instruction_performance(i);
+		const struct cpuinfo_uarch_cost_model* cost_model = cpuinfo_get_uarch_cost_model(uarch_info->uarch);
+		printf("Microarchitecture %"PRIu32" (%"PRIu32" cores) at %"PRIu64" MHz, %"PRIu32"-bit vectors:\n",
+			i, uarch_info->core_count, performance->frequency / 1000000, performance->vector_width);
+		report_instruction("FMA", performance->fma, cost_model != NULL ? cost_model->fma_latency : 0);
+		report_instruction(performance->native_int8_dot ? "INT8 dot product" : "INT8 multiply-add",
+			performance->int8_dot, 0);
+		report_instruction("Shuffle", performance->shuffle, 0);
+		report_instruction("Gather", performance->gather, 0);
+		report_instruction("Load", performance->load, cost_model != NULL ? cost_model->l1d_latency : 0);
+	}
+}
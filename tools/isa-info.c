@@ -1,3 +1,4 @@
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -11,12 +12,15 @@ int main(int argc, char** argv) {
 
 #if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
 
+	printf("x86-64 microarchitecture level: %"PRIu32"\n", cpuinfo_get_x86_64_level());
+
 	printf("Scalar instructions:\n");
 #if CPUINFO_ARCH_X86
 		printf("\tx87 FPU: %s\n", cpuinfo_has_x86_fpu() ? "yes" : "no");
 		printf("\tCMOV: %s\n", cpuinfo_has_x86_cmov() ? "yes" : "no");
 #endif
 		printf("\tLAHF/SAHF: %s\n", cpuinfo_has_x86_lahf_sahf() ? "yes" : "no");
+		printf("\tAPX: %s\n", cpuinfo_has_x86_apx() ? "yes" : "no");
 		printf("\tLZCNT: %s\n", cpuinfo_has_x86_lzcnt() ? "yes" : "no");
 		printf("\tPOPCNT: %s\n", cpuinfo_has_x86_popcnt() ? "yes" : "no");
 		printf("\tTBM: %s\n", cpuinfo_has_x86_tbm() ? "yes" : "no");
@@ -27,6 +31,11 @@ int main(int argc, char** argv) {
 
 	printf("Memory instructions:\n");
 		printf("\tMOVBE: %s\n", cpuinfo_has_x86_movbe() ? "yes" : "no");
+		printf("\tERMS: %s\n", cpuinfo_has_x86_erms() ? "yes" : "no");
+		printf("\tFSRM: %s\n", cpuinfo_has_x86_fsrm() ? "yes" : "no");
+		printf("\tFZRM: %s\n", cpuinfo_has_x86_fzrm() ? "yes" : "no");
+		printf("\tFSRS: %s\n", cpuinfo_has_x86_fsrs() ? "yes" : "no");
+		printf("\tFSRC: %s\n", cpuinfo_has_x86_fsrc() ? "yes" : "no");
 		printf("\tPREFETCH: %s\n", cpuinfo_has_x86_prefetch() ? "yes" : "no");
 		printf("\tPREFETCHW: %s\n", cpuinfo_has_x86_prefetchw() ? "yes" : "no");
 		printf("\tPREFETCHWT1: %s\n", cpuinfo_has_x86_prefetchwt1() ? "yes" : "no");
@@ -54,6 +63,11 @@ int main(int argc, char** argv) {
 		printf("\tXOP: %s\n", cpuinfo_has_x86_xop() ? "yes" : "no");
 		printf("\tF16C: %s\n", cpuinfo_has_x86_f16c() ? "yes" : "no");
 		printf("\tAVX2: %s\n", cpuinfo_has_x86_avx2() ? "yes" : "no");
+		printf("\tAVX-VNNI: %s\n", cpuinfo_has_x86_avxvnni() ? "yes" : "no");
+		printf("\tAVX-VNNI-INT8: %s\n", cpuinfo_has_x86_avxvnniint8() ? "yes" : "no");
+		printf("\tAVX-VNNI-INT16: %s\n", cpuinfo_has_x86_avxvnniint16() ? "yes" : "no");
+		printf("\tAVX-IFMA: %s\n", cpuinfo_has_x86_avxifma() ? "yes" : "no");
+		printf("\tAVX-NE-CONVERT: %s\n", cpuinfo_has_x86_avxneconvert() ? "yes" : "no");
 		printf("\tAVX512F: %s\n", cpuinfo_has_x86_avx512f() ? "yes" : "no");
 		printf("\tAVX512PF: %s\n", cpuinfo_has_x86_avx512pf() ? "yes" : "no");
 		printf("\tAVX512ER: %s\n", cpuinfo_has_x86_avx512er() ? "yes" : "no");
@@ -69,20 +83,66 @@ int main(int argc, char** argv) {
 		printf("\tAVX512VNNI: %s\n", cpuinfo_has_x86_avx512vnni() ? "yes" : "no");
 		printf("\tAVX512BF16: %s\n", cpuinfo_has_x86_avx512bf16() ? "yes" : "no");
 		printf("\tAVX512FP16: %s\n", cpuinfo_has_x86_avx512fp16() ? "yes" : "no");
+		printf("\tAVX10 version: %"PRIu32"\n", cpuinfo_get_x86_avx10_version());
+		printf("\tAVX10 max vector width: %"PRIu32" bits\n", cpuinfo_get_x86_avx10_max_vector_bits());
+		printf("\tAMX-TILE: %s\n", cpuinfo_has_x86_amx_tile() ? "yes" : "no");
+		printf("\tAMX-INT8: %s\n", cpuinfo_has_x86_amx_int8() ? "yes" : "no");
+		printf("\tAMX-BF16: %s\n", cpuinfo_has_x86_amx_bf16() ? "yes" : "no");
+		printf("\tAMX-FP16: %s\n", cpuinfo_has_x86_amx_fp16() ? "yes" : "no");
+		printf("\tAMX-COMPLEX: %s\n", cpuinfo_has_x86_amx_complex() ? "yes" : "no");
 		printf("\tAVX512VP2INTERSECT: %s\n", cpuinfo_has_x86_avx512vp2intersect() ? "yes" : "no");
 		printf("\tAVX512_4VNNIW: %s\n", cpuinfo_has_x86_avx512_4vnniw() ? "yes" : "no");
 		printf("\tAVX512_4FMAPS: %s\n", cpuinfo_has_x86_avx512_4fmaps() ? "yes" : "no");
 
+	printf("Vector extension state:\n");
+	{
+		static const char* extension_names[cpuinfo_x86_vector_extension_max] = {
+			[cpuinfo_x86_vector_extension_avx] = "AVX",
+			[cpuinfo_x86_vector_extension_avx512] = "AVX-512",
+			[cpuinfo_x86_vector_extension_amx] = "AMX",
+			[cpuinfo_x86_vector_extension_apx] = "APX",
+		};
+		static const char* reason_descriptions[] = {
+			[cpuinfo_x86_vector_extension_reason_enabled] = "enabled",
+			[cpuinfo_x86_vector_extension_reason_unsupported] = "not supported by the processor",
+			[cpuinfo_x86_vector_extension_reason_xsave_disabled] = "XSAVE disabled by the OS",
+			[cpuinfo_x86_vector_extension_reason_state_unsupported] = "state not supported by the processor",
+			[cpuinfo_x86_vector_extension_reason_state_disabled] = "state disabled in XCR0 by the OS",
+		};
+		const struct cpuinfo_x86_xsave_state* xsave_state = cpuinfo_get_x86_xsave_state();
+		for (uint32_t i = 0; i < cpuinfo_x86_vector_extension_max; i++) {
+			printf("\t%s: %s\n", extension_names[i], reason_descriptions[xsave_state->extensions[i].reason]);
+		}
+	}
 
 	printf("Multi-threading extensions:\n");
 		printf("\tMONITOR/MWAIT: %s\n", cpuinfo_has_x86_mwait() ? "yes" : "no");
 		printf("\tMONITORX/MWAITX: %s\n", cpuinfo_has_x86_mwaitx() ? "yes" : "no");
+		printf("\tUMONITOR/UMWAIT/TPAUSE: %s\n", cpuinfo_has_x86_waitpkg() ? "yes" : "no");
 #if CPUINFO_ARCH_X86
 		printf("\tCMPXCHG8B: %s\n", cpuinfo_has_x86_cmpxchg8b() ? "yes" : "no");
 #endif
 		printf("\tCMPXCHG16B: %s\n", cpuinfo_has_x86_cmpxchg16b() ? "yes" : "no");
 		printf("\tHLE: %s\n", cpuinfo_has_x86_hle() ? "yes" : "no");
 		printf("\tRTM: %s\n", cpuinfo_has_x86_rtm() ? "yes" : "no");
+		{
+			struct cpuinfo_x86_tsx_state tsx_state;
+			if (cpuinfo_get_x86_tsx_state(true, &tsx_state)) {
+				const char* rtm_status = "no";
+				switch (tsx_state.rtm_status) {
+					case cpuinfo_x86_rtm_status_usable:
+						rtm_status = "yes";
+						break;
+					case cpuinfo_x86_rtm_status_always_aborts:
+						rtm_status = "no, transactions always abort";
+						break;
+					default:
+						break;
+				}
+				printf("\tRTM usable: %s\n", rtm_status);
+				printf("\tHLE lock elision usable: %s\n", tsx_state.hle_usable ? "yes" : "no");
+			}
+		}
 		printf("\tXTEST: %s\n", cpuinfo_has_x86_xtest() ? "yes" : "no");
 		printf("\tRDPID: %s\n", cpuinfo_has_x86_rdpid() ? "yes" : "no");
 
@@ -108,6 +168,13 @@ int main(int argc, char** argv) {
 
 	printf("System instructions:\n");
 		printf("\tCLWB: %s\n", cpuinfo_has_x86_clwb() ? "yes" : "no");
+		printf("\tCLDEMOTE: %s\n", cpuinfo_has_x86_cldemote() ? "yes" : "no");
+		printf("\tMOVDIRI: %s\n", cpuinfo_has_x86_movdiri() ? "yes" : "no");
+		printf("\tMOVDIR64B: %s\n", cpuinfo_has_x86_movdir64b() ? "yes" : "no");
+		printf("\tENQCMD/ENQCMDS: %s\n", cpuinfo_has_x86_enqcmd() ? "yes" : "no");
+		printf("\tSERIALIZE: %s\n", cpuinfo_has_x86_serialize() ? "yes" : "no");
+		printf("\tHRESET: %s\n", cpuinfo_has_x86_hreset() ? "yes" : "no");
+		printf("\tUINTR: %s\n", cpuinfo_has_x86_uintr() ? "yes" : "no");
 		printf("\tFXSAVE/FXSTOR: %s\n", cpuinfo_has_x86_fxsave() ? "yes" : "no");
 		printf("\tXSAVE/XSTOR: %s\n", cpuinfo_has_x86_xsave() ? "yes" : "no");
 
@@ -157,6 +224,17 @@ int main(int argc, char** argv) {
 #if CPUINFO_ARCH_ARM64
 	printf("Instruction sets:\n");
 		printf("\tARM v8.1 atomics: %s\n", cpuinfo_has_arm_atomics() ? "yes" : "no");
+		printf("\tARM v8.4 LSE2: %s\n", cpuinfo_has_arm_lse2() ? "yes" : "no");
+		printf("\tARM v9.4 LSE128: %s\n", cpuinfo_has_arm_lse128() ? "yes" : "no");
+		printf("\tARM v8.3 RCpc: %s\n", cpuinfo_has_arm_rcpc() ? "yes" : "no");
+		printf("\tARM v8.4 RCpc 2: %s\n", cpuinfo_has_arm_rcpc2() ? "yes" : "no");
+		printf("\tARM v8.9 RCpc 3: %s\n", cpuinfo_has_arm_rcpc3() ? "yes" : "no");
+		printf("\tARM v8.7 WFxT: %s\n", cpuinfo_has_arm_wfxt() ? "yes" : "no");
+		printf("\tARM v8.3 PAuth: %s\n", cpuinfo_has_arm_pauth() ? "yes" : "no");
+		printf("\tARM v8.5 BTI: %s\n", cpuinfo_has_arm_bti() ? "yes" : "no");
+		printf("\tARM v8.5 MTE: %s\n", cpuinfo_has_arm_mte() ? "yes" : "no");
+		printf("\tARM v8.5 MTE 2: %s\n", cpuinfo_has_arm_mte2() ? "yes" : "no");
+		printf("\tARM v8.7 MTE 3: %s\n", cpuinfo_has_arm_mte3() ? "yes" : "no");
 		printf("\tARM v8.1 SQRDMLxH: %s\n", cpuinfo_has_arm_neon_rdm() ? "yes" : "no");
 		printf("\tARM v8.2 FP16 arithmetics: %s\n", cpuinfo_has_arm_fp16_arith() ? "yes" : "no");
 		printf("\tARM v8.2 FHM: %s\n", cpuinfo_has_arm_fhm() ? "yes" : "no");
@@ -169,6 +247,13 @@ int main(int argc, char** argv) {
 	printf("SIMD extensions:\n");
 		printf("\tARM SVE: %s\n", cpuinfo_has_arm_sve() ? "yes" : "no");
 		printf("\tARM SVE 2: %s\n", cpuinfo_has_arm_sve2() ? "yes" : "no");
+		printf("\tARM SVE vector length: %"PRIu32" bytes\n", cpuinfo_get_arm_sve_vector_length());
+		printf("\tARM SME: %s\n", cpuinfo_has_arm_sme() ? "yes" : "no");
+		printf("\tARM SME 2: %s\n", cpuinfo_has_arm_sme2() ? "yes" : "no");
+		printf("\tARM SME F64F64: %s\n", cpuinfo_has_arm_sme_f64f64() ? "yes" : "no");
+		printf("\tARM SME I16I64: %s\n", cpuinfo_has_arm_sme_i16i64() ? "yes" : "no");
+		printf("\tARM SME FA64: %s\n", cpuinfo_has_arm_sme_fa64() ? "yes" : "no");
+		printf("\tARM SME streaming vector length: %"PRIu32" bytes\n", cpuinfo_get_arm_sme_vector_length());
 
 	printf("Cryptography extensions:\n");
 		printf("\tAES: %s\n", cpuinfo_has_arm_aes() ? "yes" : "no");
@@ -176,6 +261,64 @@ int main(int argc, char** argv) {
 		printf("\tSHA2: %s\n", cpuinfo_has_arm_sha2() ? "yes" : "no");
 		printf("\tPMULL: %s\n", cpuinfo_has_arm_pmull() ? "yes" : "no");
 		printf("\tCRC32: %s\n", cpuinfo_has_arm_crc32() ? "yes" : "no");
+		printf("\tSHA3 (EOR3/RAX1/XAR/BCAX): %s\n", cpuinfo_has_arm_sha3() ? "yes" : "no");
+		printf("\tSHA512: %s\n", cpuinfo_has_arm_sha512() ? "yes" : "no");
+		printf("\tSM3: %s\n", cpuinfo_has_arm_sm3() ? "yes" : "no");
+		printf("\tSM4: %s\n", cpuinfo_has_arm_sm4() ? "yes" : "no");
+		printf("\tRNDR/RNDRRS: %s\n", cpuinfo_has_arm_rng() ? "yes" : "no");
+#endif
+#if CPUINFO_ARCH_RISCV32 || CPUINFO_ARCH_RISCV64
+	printf("Instruction sets:\n");
+		printf("\tI: %s\n", cpuinfo_has_riscv_i() ? "yes" : "no");
+		printf("\tM: %s\n", cpuinfo_has_riscv_m() ? "yes" : "no");
+		printf("\tA: %s\n", cpuinfo_has_riscv_a() ? "yes" : "no");
+		printf("\tF: %s\n", cpuinfo_has_riscv_f() ? "yes" : "no");
+		printf("\tD: %s\n", cpuinfo_has_riscv_d() ? "yes" : "no");
+		printf("\tC: %s\n", cpuinfo_has_riscv_c() ? "yes" : "no");
+		printf("\tZba: %s\n", cpuinfo_has_riscv_zba() ? "yes" : "no");
+		printf("\tZbb: %s\n", cpuinfo_has_riscv_zbb() ? "yes" : "no");
+		printf("\tZbc: %s\n", cpuinfo_has_riscv_zbc() ? "yes" : "no");
+		printf("\tZbs: %s\n", cpuinfo_has_riscv_zbs() ? "yes" : "no");
+		printf("\tZicboz: %s\n", cpuinfo_has_riscv_zicboz() ? "yes" : "no");
+		printf("\tZicond: %s\n", cpuinfo_has_riscv_zicond() ? "yes" : "no");
+		printf("\tZfh: %s\n", cpuinfo_has_riscv_zfh() ? "yes" : "no");
+		printf("\tZfhmin: %s\n", cpuinfo_has_riscv_zfhmin() ? "yes" : "no");
+
+	printf("Vector extensions:\n");
+		printf("\tV: %s\n", cpuinfo_has_riscv_v() ? "yes" : "no");
+		printf("\tZvbb: %s\n", cpuinfo_has_riscv_zvbb() ? "yes" : "no");
+		printf("\tZvbc: %s\n", cpuinfo_has_riscv_zvbc() ? "yes" : "no");
+		printf("\tZvfh: %s\n", cpuinfo_has_riscv_zvfh() ? "yes" : "no");
+		printf("\tVector length: %"PRIu32" bytes\n", cpuinfo_get_riscv_vector_length());
+#endif
+#if CPUINFO_ARCH_LOONGARCH64
+	printf("Instruction sets:\n");
+		printf("\tFPU: %s\n", cpuinfo_has_loongarch_fpu() ? "yes" : "no");
+		printf("\tCRC32: %s\n", cpuinfo_has_loongarch_crc32() ? "yes" : "no");
+		printf("\tUnaligned access: %s\n", cpuinfo_has_loongarch_ual() ? "yes" : "no");
+
+	printf("Atomic operations:\n");
+		printf("\tLAM: %s\n", cpuinfo_has_loongarch_lam() ? "yes" : "no");
+		printf("\tLAM byte and halfword: %s\n", cpuinfo_has_loongarch_lam_bh() ? "yes" : "no");
+
+	printf("Floating-point and vector extensions:\n");
+		printf("\tLSX: %s\n", cpuinfo_has_loongarch_lsx() ? "yes" : "no");
+		printf("\tLASX: %s\n", cpuinfo_has_loongarch_lasx() ? "yes" : "no");
+		printf("\tComplex: %s\n", cpuinfo_has_loongarch_complex() ? "yes" : "no");
+		printf("\tCrypto: %s\n", cpuinfo_has_loongarch_crypto() ? "yes" : "no");
+		printf("\tFRECIPE: %s\n", cpuinfo_has_loongarch_frecipe() ? "yes" : "no");
+
+	printf("Binary translation:\n");
+		printf("\tLBT x86: %s\n", cpuinfo_has_loongarch_lbt_x86() ? "yes" : "no");
+		printf("\tLBT ARM: %s\n", cpuinfo_has_loongarch_lbt_arm() ? "yes" : "no");
+		printf("\tLBT MIPS: %s\n", cpuinfo_has_loongarch_lbt_mips() ? "yes" : "no");
+#endif
+#if CPUINFO_ARCH_ASMJS || CPUINFO_ARCH_WASM || CPUINFO_ARCH_WASMSIMD
+	printf("WebAssembly extensions:\n");
+		printf("\tSIMD128: %s\n", cpuinfo_has_wasm_simd128() ? "yes" : "no");
+		printf("\tRelaxed SIMD: %s\n", cpuinfo_has_wasm_relaxed_simd() ? "yes" : "no");
+		printf("\tThreads: %s\n", cpuinfo_has_wasm_threads() ? "yes" : "no");
+		printf("\tMemory64: %s\n", cpuinfo_has_wasm_memory64() ? "yes" : "no");
 #endif
 
 }
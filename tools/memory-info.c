@@ -0,0 +1,44 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <cpuinfo.h>
+
+
+static void report_level(const char* name, uint32_t latency, uint64_t bandwidth) {
+	if (latency != 0) {
+		printf("\t%s: %"PRIu32".%01"PRIu32" ns latency, %"PRIu64" MB/s\n",
+			name, latency / 1000, latency % 1000 / 100, bandwidth / 1000000);
+	}
+}
+
+int main(int argc, char** argv) {
+	/* Measurements are restored from the snapshot file if it exists, and saved into it otherwise */
+	const char* snapshot_path = argc > 1 ? argv[1] : NULL;
+	if (snapshot_path == NULL || !cpuinfo_initialize_from_snapshot(snapshot_path)) {
+		if (!cpuinfo_initialize()) {
+			fprintf(stderr, "failed to initialize CPU information\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	const bool restored = cpuinfo_get_uarch_memory_performance(0) != NULL;
+	if (!cpuinfo_probe_memory_performance()) {
+		fprintf(stderr, "failed to measure memory performance\n");
+		exit(EXIT_FAILURE);
+	}
+	if (snapshot_path != NULL && !restored && !cpuinfo_save_snapshot(snapshot_path)) {
+		fprintf(stderr, "failed to save measurements into snapshot file %s\n", snapshot_path);
+	}
+
+	for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+		const struct cpuinfo_uarch_info* uarch_info = cpuinfo_get_uarch(i);
+		const struct cpuinfo_memory_performance* performance = cpuinfo_get_uarch_memory_performance(i);
+		printf("Microarchitecture %"PRIu32" (%"PRIu32" cores):\n", i, uarch_info->core_count);
+		report_level("L1D", performance->l1d_latency, performance->l1d_bandwidth);
+		report_level("L2", performance->l2_latency, performance->l2_bandwidth);
+		report_level("L3", performance->l3_latency, performance->l3_bandwidth);
+		report_level("Memory", performance->memory_latency, performance->memory_bandwidth);
+		printf("\tMemory, all cores: %"PRIu64" MB/s\n", performance->all_cores_memory_bandwidth / 1000000);
+	}
+}
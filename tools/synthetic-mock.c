@@ -0,0 +1,105 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cpuinfo-mock.h>
+
+
+/* Print file content as C string literals, one literal per line like in headers of recorded devices */
+static void print_content(const char* content, size_t size) {
+	printf("\t\t.content =\n\t\t\t\"");
+	for (size_t i = 0; i < size; i++) {
+		switch (content[i]) {
+			case '\n':
+				printf(i + 1 != size ? "\\n\"\n\t\t\t\"" : "\\n");
+				break;
+			case '\t':
+				printf("\\t");
+				break;
+			case '"':
+			case '\\':
+				printf("\\%c", content[i]);
+				break;
+			default:
+				putchar(content[i]);
+		}
+	}
+	printf("\",\n");
+}
+
+/* Parse a cluster as CORESxTHREADS@KHZ, optionally followed by :MIDR in hexadecimal, or by :efficiency */
+static bool parse_cluster(const char* text, struct cpuinfo_mock_cluster* cluster) {
+	char* end;
+	cluster->cores = (uint32_t) strtoul(text, &end, 10);
+	if (*end != 'x') {
+		return false;
+	}
+	cluster->threads_per_core = (uint32_t) strtoul(end + 1, &end, 10);
+	if (*end != '@') {
+		return false;
+	}
+	cluster->max_frequency = (uint32_t) strtoul(end + 1, &end, 10);
+	if (strcmp(end, ":efficiency") == 0) {
+		cluster->efficiency = true;
+		return true;
+	} else if (*end == ':') {
+		cluster->midr = (uint32_t) strtoul(end + 1, &end, 16);
+	}
+	return *end == '\0';
+}
+
+static void print_usage(const char* program) {
+	fprintf(stderr,
+		"usage: %s --packages=N [--nodes-per-package=N] --cluster=CORESxTHREADS@KHZ[:MIDR|:efficiency]...\n"
+		"prints the mock filesystem and CPUID dump of a synthetic system as a header for test/mock\n", program);
+}
+
+int main(int argc, char** argv) {
+	struct cpuinfo_mock_topology topology = { .packages = 1, .nodes_per_package = 1 };
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--packages=", strlen("--packages=")) == 0) {
+			topology.packages = (uint32_t) strtoul(argv[i] + strlen("--packages="), NULL, 10);
+		} else if (strncmp(argv[i], "--nodes-per-package=", strlen("--nodes-per-package=")) == 0) {
+			topology.nodes_per_package = (uint32_t) strtoul(argv[i] + strlen("--nodes-per-package="), NULL, 10);
+		} else if (strncmp(argv[i], "--cluster=", strlen("--cluster=")) == 0 &&
+			topology.clusters_count < CPUINFO_MOCK_CLUSTERS_MAX &&
+			parse_cluster(argv[i] + strlen("--cluster="), &topology.clusters[topology.clusters_count]))
+		{
+			topology.clusters_count += 1;
+		} else {
+			print_usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	struct cpuinfo_mock_system system;
+	if (!cpuinfo_mock_generate_system(&topology, &system)) {
+		fprintf(stderr, "failed to generate the synthetic system: check the limits of the topology\n");
+		exit(EXIT_FAILURE);
+	}
+
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+	printf("struct cpuinfo_mock_cpuid cpuid_dump[] = {\n");
+	for (size_t i = 0; i < system.cpuid_entries; i++) {
+		const struct cpuinfo_mock_cpuid* entry = &system.cpuid_dump[i];
+		printf("\t{\n\t\t.input_eax = 0x%08"PRIX32",\n", entry->input_eax);
+		if (entry->input_eax == 4 || entry->input_eax == 7 || entry->input_eax == 0xB) {
+			printf("\t\t.input_ecx = 0x%08"PRIX32",\n", entry->input_ecx);
+		}
+		printf("\t\t.eax = 0x%08"PRIX32",\n\t\t.ebx = 0x%08"PRIX32",\n\t\t.ecx = 0x%08"PRIX32",\n"
+			"\t\t.edx = 0x%08"PRIX32",\n\t},\n", entry->eax, entry->ebx, entry->ecx, entry->edx);
+	}
+	printf("};\n");
+#endif
+	printf("struct cpuinfo_mock_file filesystem[] = {\n");
+	for (const struct cpuinfo_mock_file* file = system.files; file->path != NULL; file++) {
+		printf("\t{\n\t\t.path = \"%s\",\n\t\t.size = %zu,\n", file->path, file->size);
+		print_content(file->content, file->size);
+		printf("\t},\n");
+	}
+	printf("\t{ NULL },\n};\n");
+	cpuinfo_mock_release_system(&system);
+	return EXIT_SUCCESS;
+}
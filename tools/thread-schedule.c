@@ -0,0 +1,116 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+	/* nanosleep in strict C99 mode */
+	#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+#include <cpuinfo.h>
+
+
+static void sleep_milliseconds(uint32_t milliseconds) {
+#if defined(_WIN32)
+	Sleep(milliseconds);
+#else
+	const struct timespec interval = {
+		.tv_sec = milliseconds / 1000,
+		.tv_nsec = (long) (milliseconds % 1000) * 1000000L,
+	};
+	nanosleep(&interval, NULL);
+#endif
+}
+
+static void print_usage(const char* program) {
+	fprintf(stderr, "usage: %s [--pid=PID] [--interval=MILLISECONDS] [--samples=COUNT]\n", program);
+}
+
+static uint32_t percent(uint64_t part, uint64_t whole) {
+	return whole != 0 ? (uint32_t) (part * 100 / whole) : 0;
+}
+
+/* Shares of the run time of the thread on every microarchitecture, or on every cluster of homogeneous systems */
+static void print_run_time_shares(const struct cpuinfo_thread_schedule_sampler* sampler, uint32_t thread_index,
+	uint64_t total_run_ns)
+{
+	if (cpuinfo_get_uarchs_count() > 1) {
+		for (uint32_t i = 0; i < cpuinfo_get_uarchs_count(); i++) {
+			printf(" uarch%"PRIu32":%3"PRIu32"%%", i,
+				percent(cpuinfo_get_thread_uarch_run_time(sampler, thread_index, i), total_run_ns));
+		}
+	} else if (cpuinfo_get_clusters_count() > 1) {
+		for (uint32_t i = 0; i < cpuinfo_get_clusters_count(); i++) {
+			const struct cpuinfo_cluster* cluster = cpuinfo_get_cluster(i);
+			const uint64_t run_ns =
+				cpuinfo_get_thread_cores_run_time(sampler, thread_index, cluster->core_start, cluster->core_count);
+			printf(" cluster%"PRIu32":%3"PRIu32"%%", i, percent(run_ns, total_run_ns));
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	uint32_t process_id = 0;
+	uint32_t interval = 1000;
+	uint32_t samples = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--pid=", strlen("--pid=")) == 0) {
+			process_id = (uint32_t) strtoul(argv[i] + strlen("--pid="), NULL, 10);
+		} else if (strncmp(argv[i], "--interval=", strlen("--interval=")) == 0) {
+			interval = (uint32_t) strtoul(argv[i] + strlen("--interval="), NULL, 10);
+		} else if (strncmp(argv[i], "--samples=", strlen("--samples=")) == 0) {
+			samples = (uint32_t) strtoul(argv[i] + strlen("--samples="), NULL, 10);
+		} else {
+			print_usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (!cpuinfo_initialize()) {
+		fprintf(stderr, "failed to initialize CPU information\n");
+		exit(EXIT_FAILURE);
+	}
+	struct cpuinfo_thread_schedule_sampler* sampler = cpuinfo_create_thread_schedule_sampler(process_id);
+	if (sampler == NULL) {
+		fprintf(stderr, "failed to sample threads of process %"PRIu32"\n", process_id);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Every sample prints the threads with their times over the interval, and shares of run time since the start */
+	for (uint32_t sample = 0; samples == 0 || sample < samples; sample++) {
+		sleep_milliseconds(interval);
+		if (!cpuinfo_sample_thread_schedules(sampler)) {
+			fprintf(stderr, "failed to sample threads of process %"PRIu32"\n", process_id);
+			break;
+		}
+		const uint64_t interval_ns = (uint64_t) interval * UINT64_C(1000000);
+		printf("%8s %-16s %5s %5s %10s %9s\n", "TID", "NAME", "RUN%", "WAIT%", "MIGRATIONS", "PROCESSOR");
+		for (uint32_t i = 0; i < cpuinfo_get_thread_schedules_count(sampler); i++) {
+			const struct cpuinfo_thread_schedule* schedule = cpuinfo_get_thread_schedule(sampler, i);
+			if (!schedule->alive) {
+				continue;
+			}
+			printf("%8"PRIu32" %-16s %5"PRIu32" %5"PRIu32" %10"PRIu32, schedule->thread_id, schedule->name,
+				percent(schedule->run_ns, interval_ns), percent(schedule->wait_ns, interval_ns), schedule->migrations);
+			if (schedule->processor != NULL) {
+				printf(" %9"PRIu32, (uint32_t) (schedule->processor - cpuinfo_get_processors()));
+			} else {
+				printf(" %9s", "-");
+			}
+			print_run_time_shares(sampler, i, schedule->total_run_ns);
+			printf("\n");
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+	cpuinfo_destroy_thread_schedule_sampler(sampler);
+	cpuinfo_deinitialize();
+}
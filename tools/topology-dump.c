@@ -0,0 +1,38 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cpuinfo.h>
+
+
+int main(int argc, char** argv) {
+	enum cpuinfo_export_format format = cpuinfo_export_format_json;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--format=json") == 0) {
+			format = cpuinfo_export_format_json;
+		} else if (strcmp(argv[i], "--format=cbor") == 0) {
+			format = cpuinfo_export_format_cbor;
+		} else {
+			fprintf(stderr, "usage: %s [--format=json|cbor]\n", argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (!cpuinfo_initialize()) {
+		fprintf(stderr, "failed to initialize CPU information\n");
+		exit(EXIT_FAILURE);
+	}
+
+	const size_t size = cpuinfo_export(format, NULL, 0);
+	void* document = malloc(size);
+	if (document == NULL) {
+		fprintf(stderr, "failed to allocate %zu bytes for the document\n", size);
+		exit(EXIT_FAILURE);
+	}
+	cpuinfo_export(format, document, size);
+	fwrite(document, 1, size, stdout);
+	if (format == cpuinfo_export_format_json) {
+		putchar('\n');
+	}
+	free(document);
+	return EXIT_SUCCESS;
+}